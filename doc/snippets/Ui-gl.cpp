@@ -28,16 +28,20 @@
 #include <Magnum/PixelFormat.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureArray.h>
+#include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/DistanceFieldGlyphCacheGL.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "Magnum/Ui/BaseLayerGL.h"
 #include "Magnum/Ui/BaseLayerAnimator.h"
+#include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/EventLayer.h"
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/LineLayerGL.h"
+#include "Magnum/Ui/NodeFlags.h"
 #include "Magnum/Ui/RendererGL.h"
 #include "Magnum/Ui/Style.h"
 #include "Magnum/Ui/TextLayerGL.h"
@@ -413,4 +417,101 @@ ui.setRendererInstance(Containers::pointer<Ui::RendererGL>());
 /* [RendererGL-setup] */
 }
 
+{
+Ui::UserInterfaceGL ui{NoCreate};
+/* [RendererGL-layer-profiling] */
+ui.setRendererInstance(Containers::pointer<Ui::RendererGL>(
+    Ui::RendererGL::Flag::LayerProfiling));
+DOXYGEN_ELLIPSIS()
+
+ui.draw();
+
+const Ui::RendererGL& renderer = ui.renderer<Ui::RendererGL>();
+Debug{} << "Base layer:" << renderer.layerGpuDuration(ui.baseLayer().handle())
+    << "ns in" << renderer.layerDrawCount(ui.baseLayer().handle()) << "draws";
+Debug{} << "Text layer:" << renderer.layerGpuDuration(ui.textLayer().handle())
+    << "ns in" << renderer.layerDrawCount(ui.textLayer().handle()) << "draws";
+/* [RendererGL-layer-profiling] */
+}
+
+{
+Ui::UserInterfaceGL ui{NoCreate};
+/* [RendererGL-depth-buffer] */
+ui.setRendererInstance(Containers::pointer<Ui::RendererGL>(
+    Ui::RendererGL::Flag::CompositingFramebuffer|
+    Ui::RendererGL::Flag::DepthBuffer));
+
+Ui::BaseLayerGL::Shared baseLayerShared{
+    Ui::BaseLayer::Shared::Configuration{DOXYGEN_ELLIPSIS(3)}
+        .addFlags(Ui::BaseLayerSharedFlag::OpaqueDepthPrepass)
+};
+ui.setBaseLayerInstance(
+    Containers::pointer<Ui::BaseLayerGL>(ui.createLayer(), baseLayerShared));
+/* [RendererGL-depth-buffer] */
+}
+
+{
+Ui::UserInterfaceGL ui{NoCreate};
+/* [RendererGL-draw-cache] */
+ui.setRendererInstance(Containers::pointer<Ui::RendererGL>(
+    Ui::RendererGL::Flag::CompositingFramebuffer|
+    Ui::RendererGL::Flag::DrawCache));
+
+/* A toolbar full of labels that changes only rarely */
+Ui::NodeHandle toolbar = ui.createNode({}, {640, 32}, Ui::NodeFlag::Cached);
+/* [RendererGL-draw-cache] */
+static_cast<void>(toolbar);
+}
+
+{
+Ui::UserInterfaceGL ui{NoCreate};
+/* [RendererGL-dynamic-resolution] */
+Ui::RendererGL& renderer = ui.setRendererInstance(
+    Containers::pointer<Ui::RendererGL>(
+        Ui::RendererGL::Flag::CompositingFramebuffer|
+        Ui::RendererGL::Flag::LayerProfiling|
+        Ui::RendererGL::Flag::DynamicResolution));
+DOXYGEN_ELLIPSIS()
+
+/* Keep the UI under 6 ms of GPU time, with text always sharp */
+renderer
+    .setDynamicResolutionBudget(6000000)
+    .setNativeResolutionLayers({ui.textLayer().handle()});
+/* [RendererGL-dynamic-resolution] */
+}
+
+{
+Ui::UserInterfaceGL ui{NoCreate};
+/* [RendererGL-render-target] */
+GL::Texture2D panelTexture;
+panelTexture.setStorage(1, GL::TextureFormat::RGBA8, {512, 512});
+
+Ui::RendererGL& renderer = ui.setRendererInstance(
+    Containers::pointer<Ui::RendererGL>(
+        Ui::RendererGL::Flag::RetainedFramebuffer));
+renderer.setRenderTargetTexture(panelTexture);
+ui.setSize({512, 512});
+DOXYGEN_ELLIPSIS()
+
+/* Every frame, redraw the panel only if anything in it changed */
+if(ui.state() >= Ui::UserInterfaceState::NeedsAnimationAdvance)
+    ui.advanceAnimations(DOXYGEN_ELLIPSIS({}));
+if(ui.needsDraw())
+    ui.draw();
+
+/* Draw the scene with panelTexture applied on the panel */
+DOXYGEN_ELLIPSIS()
+/* [RendererGL-render-target] */
+
+Vector2 hitTextureCoordinates;
+Ui::PointerEvent event{{}, Ui::PointerEventSource::Mouse, Ui::Pointer::MouseLeft, true, 0};
+/* [RendererGL-render-target-events] */
+/* Texture coordinates of the point where a ray from the mouse cursor hit the
+   panel */
+DOXYGEN_ELLIPSIS(hitTextureCoordinates = {};)
+ui.pointerPressEvent(Ui::RendererGL::globalPositionFromTextureCoordinates(
+    ui, hitTextureCoordinates), event);
+/* [RendererGL-render-target-events] */
+}
+
 }
@@ -251,3 +251,38 @@ void MyApplication::drawEvent() {
 /* [RendererGL-compositing-framebuffer-draw] */
 
 }
+
+namespace E {
+
+/* [AbstractUserInterface-application-animation-idle] */
+class MyApplication: public Platform::Application {
+    DOXYGEN_ELLIPSIS(void drawEvent() override;
+    Nanoseconds now() const;
+    void redrawAt(Nanoseconds);)
+
+    private:
+        Ui::UserInterfaceGL _ui;
+};
+
+void MyApplication::drawEvent() {
+    GL::defaultFramebuffer.clear(GL::FramebufferClear::Color);
+
+    _ui.advanceAnimations(now());
+    _ui.draw();
+
+    swapBuffers();
+
+    /* Redraw right away only if there's something actually animating, or if
+       the UI has to be redrawn for other reasons */
+    const Nanoseconds next = _ui.nextAnimationAdvanceTime();
+    if(next == _ui.animationTime() ||
+       _ui.state() & ~Ui::UserInterfaceStates{Ui::UserInterfaceState::NeedsAnimationAdvance})
+        redraw();
+    /* Otherwise, if there are scheduled animations, wake up just when the
+       first of them starts */
+    else if(next != Nanoseconds::max())
+        redrawAt(next);
+}
+/* [AbstractUserInterface-application-animation-idle] */
+
+}
@@ -24,6 +24,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/Function.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
@@ -1424,4 +1425,37 @@ animator.create([&baseLayer, from, to](Ui::DataHandle progressbar, Float factor)
 }, Animation::Easing::cubicIn, now, 0.5_sec, progressbar);
 /* [GenericDataAnimator-create] */
 }
+
+{
+Ui::AbstractUserInterface ui{{100, 100}};
+/* [GenericBatchAnimator-setup] */
+Ui::BaseLayer& baseLayer = DOXYGEN_ELLIPSIS(ui.layer<Ui::BaseLayer>({}));
+struct Progressbar {
+    Ui::LayerDataHandle data;
+    Float from, to;
+};
+Containers::Array<Progressbar> progressbars;
+
+Ui::GenericBatchAnimator& animator = ui.setGenericAnimatorInstance(
+    Containers::pointer<Ui::GenericBatchAnimator>(ui.createAnimator(),
+        [&](Containers::BitArrayView active,
+            const Containers::StridedArrayView1D<const Float>& factors,
+            const Containers::StridedArrayView1D<const UnsignedInt>& payloads) {
+            for(std::size_t i = 0; i != active.size(); ++i) {
+                if(!active[i])
+                    continue;
+                const Progressbar& progressbar = progressbars[payloads[i]];
+                baseLayer.setPadding(progressbar.data, {
+                    Math::lerp(progressbar.from, progressbar.to, factors[i]),
+                    0.0f, 0.0f, 0.0f});
+            }
+        }));
+/* [GenericBatchAnimator-setup] */
+
+Nanoseconds now;
+/* [GenericBatchAnimator-create] */
+UnsignedInt progressbarId = DOXYGEN_ELLIPSIS(0);
+animator.create(now, 0.5_sec, progressbarId);
+/* [GenericBatchAnimator-create] */
+}
 }
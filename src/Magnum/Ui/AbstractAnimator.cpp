@@ -37,6 +37,8 @@
 
 #include "Magnum/Ui/AbstractLayer.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 
 namespace Magnum { namespace Ui {
 
@@ -206,8 +208,9 @@ static_assert(
 struct AbstractAnimator::State {
     AnimatorHandle handle;
     AnimatorStates state;
-
-    /* 1 byte free */
+    /* Whether `nextAdvanceTime` is up-to-date. Reset by all operations that
+       can make the next advance time earlier, set again in update(). */
+    bool nextAdvanceTimeValid = true;
 
     /* Used only if AnimatorFeature::DataAttachment is supported. Combined with
        `layerData` to form DataHandles. */
@@ -220,6 +223,20 @@ struct AbstractAnimator::State {
        there's no (first/next/last) free animation. */
     UnsignedInt firstFree = ~UnsignedInt{};
     UnsignedInt lastFree = ~UnsignedInt{};
+    /* If non-zero, the animation storage is reserved for exactly this many
+       items and create() never grows it past that */
+    UnsignedInt fixedCapacity = 0;
+
+    /* IDs of animations that update() has to look at, in no particular
+       order. That's all animations that are scheduled, playing or paused at
+       `time`, and stopped animations without AnimationFlag::KeepOncePlayed
+       that are waiting to be removed. Stopped animations with
+       AnimationFlag::KeepOncePlayed and free animations aren't here,
+       update() would do nothing for them anyway. */
+    Containers::Array<UnsignedInt> activeAnimations;
+    /* Position of each animation in `activeAnimations` or ~UnsignedInt{} if
+       it's not there, has the same size as `animations` */
+    Containers::Array<UnsignedInt> activeAnimationPositions;
 
     /* Used only if AnimatorFeature::NodeAttachment is supported, has the same
        size as `animations` */
@@ -230,6 +247,11 @@ struct AbstractAnimator::State {
     Containers::Array<LayerDataHandle> layerData;
 
     Nanoseconds time{Math::ZeroInit};
+    /* Calculated in update() alongside the other processing. Removing
+       animations doesn't cause this value to be invalidated, as it can only
+       make the time later, and if the time is earlier than needed the next
+       update() recalculates it back. */
+    Nanoseconds nextAdvanceTime = Nanoseconds::max();
 };
 
 AbstractAnimator::AbstractAnimator(const AnimatorHandle handle): _state{InPlaceInit} {
@@ -289,6 +311,57 @@ std::size_t AbstractAnimator::usedCount() const {
     return state.animations.size() - free;
 }
 
+MemoryUsage AbstractAnimator::memoryUsage() const {
+    const State& state = *_state;
+    MemoryUsage out = doMemoryUsage();
+    Implementation::addArrayMemoryUsage(out, state.animations);
+    Implementation::addArrayMemoryUsage(out, state.activeAnimations);
+    Implementation::addArrayMemoryUsage(out, state.activeAnimationPositions);
+    Implementation::addArrayMemoryUsage(out, state.nodes);
+    Implementation::addArrayMemoryUsage(out, state.layerData);
+    out.cpuUnused += (state.animations.size() - usedCount())*sizeof(Animation);
+    return out;
+}
+
+MemoryUsage AbstractAnimator::doMemoryUsage() const { return {}; }
+
+void AbstractAnimator::reserve(const std::size_t capacity) {
+    CORRADE_ASSERT(capacity <= 1 << Implementation::AnimatorDataHandleIdBits,
+        "Ui::AbstractAnimator::reserve(): can only have at most" << (1 << Implementation::AnimatorDataHandleIdBits) << "animations but got" << capacity, );
+    State& state = *_state;
+    arrayReserve(state.animations, capacity);
+    arrayReserve(state.activeAnimations, capacity);
+    arrayReserve(state.activeAnimationPositions, capacity);
+    if(features() & AnimatorFeature::NodeAttachment)
+        arrayReserve(state.nodes, capacity);
+    if(features() & AnimatorFeature::DataAttachment)
+        arrayReserve(state.layerData, capacity);
+    doReserve(capacity);
+}
+
+std::size_t AbstractAnimator::fixedCapacity() const {
+    return _state->fixedCapacity;
+}
+
+void AbstractAnimator::setFixedCapacity(const std::size_t capacity) {
+    State& state = *_state;
+    CORRADE_ASSERT(capacity <= 1 << Implementation::AnimatorDataHandleIdBits,
+        "Ui::AbstractAnimator::setFixedCapacity(): can only have at most" << (1 << Implementation::AnimatorDataHandleIdBits) << "animations but got" << capacity, );
+    CORRADE_ASSERT(!capacity || capacity >= state.animations.size(),
+        "Ui::AbstractAnimator::setFixedCapacity(): capacity" << capacity << "is less than current capacity" << state.animations.size(), );
+    reserve(capacity);
+    state.fixedCapacity = capacity;
+}
+
+bool AbstractAnimator::isFull() const {
+    const State& state = *_state;
+    return state.fixedCapacity &&
+           state.firstFree == ~UnsignedInt{} &&
+           state.animations.size() == state.fixedCapacity;
+}
+
+void AbstractAnimator::doReserve(std::size_t) {}
+
 bool AbstractAnimator::isHandleValid(const AnimatorDataHandle handle) const {
     if(handle == AnimatorDataHandle::Null)
         return false;
@@ -350,6 +423,31 @@ AnimationState animationState(const Animation& animation, const Nanoseconds time
     return AnimationState::Stopped;
 }
 
+/* Adds the animation to the list of active animations or removes it from
+   there. The removal swaps the last item into its place, so it's O(1). */
+void setAnimationActive(Containers::Array<UnsignedInt>& activeAnimations, const Containers::ArrayView<UnsignedInt> activeAnimationPositions, const UnsignedInt id, const bool active) {
+    UnsignedInt& position = activeAnimationPositions[id];
+    if(active) {
+        if(position == ~UnsignedInt{}) {
+            position = activeAnimations.size();
+            arrayAppend(activeAnimations, id);
+        }
+    } else if(position != ~UnsignedInt{}) {
+        const UnsignedInt last = activeAnimations.back();
+        activeAnimations[position] = last;
+        activeAnimationPositions[last] = position;
+        arrayRemoveSuffix(activeAnimations, 1);
+        position = ~UnsignedInt{};
+    }
+}
+
+/* Stopped state is final, i.e. a stopped animation stays stopped for any
+   later time until its properties are changed, and if it's meant to be kept,
+   update() has nothing to do with it */
+bool isAnimationActive(const Animation& animation, const Nanoseconds time) {
+    return !(animation.used.flags & AnimationFlag::KeepOncePlayed) || animationState(animation, time) != AnimationState::Stopped;
+}
+
 }
 
 AnimationHandle AbstractAnimator::create(const Nanoseconds played, const Nanoseconds duration, const UnsignedInt repeatCount, const AnimationFlags flags) {
@@ -375,7 +473,10 @@ AnimationHandle AbstractAnimator::create(const Nanoseconds played, const Nanosec
     } else {
         CORRADE_ASSERT(state.animations.size() < 1 << Implementation::AnimatorDataHandleIdBits,
             "Ui::AbstractAnimator::create(): can only have at most" << (1 << Implementation::AnimatorDataHandleIdBits) << "animations", {});
+        CORRADE_ASSERT(!state.fixedCapacity || state.animations.size() < state.fixedCapacity,
+            "Ui::AbstractAnimator::create(): fixed capacity of" << state.fixedCapacity << "exhausted", {});
         animation = &arrayAppend(state.animations, InPlaceInit);
+        arrayAppend(state.activeAnimationPositions, ~UnsignedInt{});
         if(features() & AnimatorFeature::NodeAttachment) {
             CORRADE_INTERNAL_ASSERT(state.nodes.size() == state.animations.size() - 1);
             arrayAppend(state.nodes, NoInit, 1);
@@ -410,8 +511,11 @@ AnimationHandle AbstractAnimator::create(const Nanoseconds played, const Nanosec
     CORRADE_INTERNAL_ASSERT(animationState != AnimationState::Paused);
     if(animationState == AnimationState::Scheduled ||
        animationState == AnimationState::Playing ||
-      (animationState == AnimationState::Stopped && !(flags & AnimationFlag::KeepOncePlayed)))
+      (animationState == AnimationState::Stopped && !(flags & AnimationFlag::KeepOncePlayed))) {
         state.state |= AnimatorState::NeedsAdvance;
+        state.nextAdvanceTimeValid = false;
+        setAnimationActive(state.activeAnimations, state.activeAnimationPositions, id, true);
+    }
 
     return animationHandle(state.handle, id, animation->used.generation);
 }
@@ -493,6 +597,9 @@ void AbstractAnimator::removeInternal(const UnsignedInt id) {
        as used when directly iterating the list */
     animation.used.duration = 0_nsec;
 
+    /* Free animations aren't processed in update() */
+    setAnimationActive(state.activeAnimations, state.activeAnimationPositions, id, false);
+
     /* Clear the node attachment to have null handles in the nodes() list for
        freed animations */
     if(features() & AnimatorFeature::NodeAttachment)
@@ -547,16 +654,26 @@ UnsignedInt AbstractAnimator::repeatCount(const AnimatorDataHandle handle) const
 void AbstractAnimator::setRepeatCount(const AnimationHandle handle, const UnsignedInt count) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractAnimator::setRepeatCount(): invalid handle" << handle, );
-    _state->animations[animationHandleId(handle)].used.repeatCount = count;
-    /* No AnimatorState needs to be updated, it doesn't cause any
-       already-stopped animations to start playing */
+    setRepeatCountInternal(animationHandleId(handle), count);
 }
 
 void AbstractAnimator::setRepeatCount(const AnimatorDataHandle handle, const UnsignedInt count) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractAnimator::setRepeatCount(): invalid handle" << handle, );
-    _state->animations[animatorDataHandleId(handle)].used.repeatCount = count;
-    /* No AnimatorState needs to be updated */
+    setRepeatCountInternal(animatorDataHandleId(handle), count);
+}
+
+void AbstractAnimator::setRepeatCountInternal(const UnsignedInt id, const UnsignedInt count) {
+    State& state = *_state;
+    Animation& animation = state.animations[id];
+    animation.used.repeatCount = count;
+    /* No AnimatorState needs to be updated, it doesn't cause any
+       already-stopped animations to start playing. A stopped animation may
+       however become playing again in the eyes of update() if there are now
+       more repeats, so the active list has to be updated, and the next advance
+       time as well. */
+    state.nextAdvanceTimeValid = false;
+    setAnimationActive(state.activeAnimations, state.activeAnimationPositions, id, isAnimationActive(animation, state.time));
 }
 
 AnimationFlags AbstractAnimator::flags(const AnimationHandle handle) const {
@@ -612,7 +729,13 @@ void AbstractAnimator::clearFlags(const AnimatorDataHandle handle, const Animati
 }
 
 void AbstractAnimator::setFlagsInternal(const UnsignedInt id, const AnimationFlags flags) {
-    _state->animations[id].used.flags = flags;
+    State& state = *_state;
+    Animation& animation = state.animations[id];
+    animation.used.flags = flags;
+    /* Clearing AnimationFlag::KeepOncePlayed on a stopped animation makes it
+       scheduled for removal in the next update() */
+    state.nextAdvanceTimeValid = false;
+    setAnimationActive(state.activeAnimations, state.activeAnimationPositions, id, isAnimationActive(animation, state.time));
 }
 
 Nanoseconds AbstractAnimator::played(const AnimationHandle handle) const {
@@ -787,6 +910,42 @@ AnimationState AbstractAnimator::state(const AnimatorDataHandle handle) const {
     return animationState(state.animations[animatorDataHandleId(handle)], state.time);
 }
 
+Nanoseconds AbstractAnimator::nextAdvanceTime() const {
+    const State& state = *_state;
+    Nanoseconds out = Nanoseconds::max();
+    if(!(state.state >= AnimatorState::NeedsAdvance))
+        return out;
+
+    /* If nothing that could make the time earlier happened since the last
+       update(), return the value calculated there */
+    if(state.nextAdvanceTimeValid)
+        return state.nextAdvanceTime;
+
+    /* Otherwise go through the active animations, as only those can change
+       state in the next update() */
+    for(const UnsignedInt id: state.activeAnimations) {
+        const Animation& animation = state.animations[id];
+        switch(animationState(animation, state.time)) {
+            /* Playing animations need to be advanced every frame, stopped
+               animations that are still in the list are waiting to be
+               removed, so in both cases the advance is needed right away */
+            case AnimationState::Playing:
+            case AnimationState::Stopped:
+                return state.time;
+            /* Scheduled animations need to be advanced once they start
+               playing, paused animations once they get stopped, if ever */
+            case AnimationState::Scheduled:
+                out = Math::min(out, animation.used.played);
+                break;
+            case AnimationState::Paused:
+                out = Math::min(out, animation.used.stopped);
+                break;
+        }
+    }
+
+    return out;
+}
+
 namespace {
 
 inline Float animationFactor(const Nanoseconds duration, const Nanoseconds played, const Nanoseconds time) {
@@ -880,6 +1039,8 @@ void AbstractAnimator::playInternal(const UnsignedInt id, const Nanoseconds time
     if(animationStateAfter == AnimationState::Scheduled ||
         animationStateAfter == AnimationState::Playing)
         state.state |= AnimatorState::NeedsAdvance;
+    state.nextAdvanceTimeValid = false;
+    setAnimationActive(state.activeAnimations, state.activeAnimationPositions, id, isAnimationActive(animation, state.time));
 }
 
 void AbstractAnimator::pause(const AnimationHandle handle, const Nanoseconds time) {
@@ -901,6 +1062,8 @@ void AbstractAnimator::pauseInternal(const UnsignedInt id, const Nanoseconds tim
     const AnimationState stateBefore = animationState(animation, state.time);
     #endif
     animation.used.paused = time;
+    state.nextAdvanceTimeValid = false;
+    setAnimationActive(state.activeAnimations, state.activeAnimationPositions, id, isAnimationActive(animation, state.time));
 
     #ifndef CORRADE_NO_ASSERT
     /* If the animation was scheduled, playing or paused before, it should be
@@ -931,6 +1094,8 @@ void AbstractAnimator::stopInternal(const UnsignedInt id, const Nanoseconds time
     const AnimationState stateBefore = animationState(animation, state.time);
     #endif
     animation.used.stopped = time;
+    state.nextAdvanceTimeValid = false;
+    setAnimationActive(state.activeAnimations, state.activeAnimationPositions, id, isAnimationActive(animation, state.time));
 
     #ifndef CORRADE_NO_ASSERT
     /* If the animation was stopped before, it should be now as well, i.e. no
@@ -959,10 +1124,9 @@ void AbstractAnimator::clean(const Containers::BitArrayView animationIdsToRemove
        still have node / data attachments for the implementation to use */
     doClean(animationIdsToRemove);
 
-    /** @todo some way to efficiently iterate set bits */
-    for(std::size_t i = 0; i != animationIdsToRemove.size(); ++i) {
-        if(animationIdsToRemove[i]) removeInternal(i);
-    }
+    Implementation::forEachSetBit(animationIdsToRemove, [&](const std::size_t i) {
+        removeInternal(i);
+    });
 }
 
 void AbstractAnimator::doClean(Containers::BitArrayView) {}
@@ -1026,11 +1190,13 @@ void AbstractAnimator::cleanData(const Containers::StridedArrayView1D<const Unsi
         /* For used & attached animations compare the generation of the data
            they're attached to. If it differs, remove the animation and mark
            the corresponding index so the implementation can do its own cleanup
-           in doClean(). */
-        /** @todo check that the ID is in bounds and if it's not, remove as
-            well? to avoid OOB access if the animation is accidentally attached
-            to a LayerDataHandle from a different layer that has more data */
-        if(layerDataHandleGeneration(data) != dataHandleGenerations[layerDataHandleId(data)]) {
+           in doClean(). Data with IDs out of bounds were dropped by
+           AbstractLayer::trim() and thus are removed as well. That also
+           avoids OOB access if the animation is accidentally attached to a
+           LayerDataHandle from a different layer that has more data. */
+        const UnsignedInt dataId = layerDataHandleId(data);
+        if(dataId >= dataHandleGenerations.size() ||
+           layerDataHandleGeneration(data) != dataHandleGenerations[dataId]) {
             removeInternal(i);
             animationIdsToRemove.set(i);
         }
@@ -1056,7 +1222,10 @@ Containers::Pair<bool, bool> AbstractAnimator::update(const Nanoseconds time, co
 
     /* Zero both bitmasks. AbstractUserInterface::advanceAnimations()
        repeatedly reuses this memory, so without this it'd have to do an
-       explicit clear in each case there otherwise. */
+       explicit clear in each case there otherwise. The memory comes from the
+       caller, so it's not possible to clear just the bits set by the previous
+       update(), however for the sizes involved it's a plain memset() that's
+       negligible compared to looking at each animation. */
     active.resetAll();
     remove.resetAll();
 
@@ -1064,11 +1233,16 @@ Containers::Pair<bool, bool> AbstractAnimator::update(const Nanoseconds time, co
     bool cleanNeeded = false;
     bool advanceNeeded = false;
     bool anotherAdvanceNeeded = false;
-    for(std::size_t i = 0; i != state.animations.size(); ++i) {
-        /* Animations with zero duration are freed items, skip */
+    Nanoseconds nextAdvanceTime = Nanoseconds::max();
+    /* Go only through the active animations instead of all of them. The
+       index is incremented at the end of the loop only if the animation
+       stays in the list, otherwise the last item gets swapped in its place
+       and is processed next. */
+    for(std::size_t activeIndex = 0; activeIndex != state.activeAnimations.size(); ) {
+        /* Free animations are never in the list */
+        const UnsignedInt i = state.activeAnimations[activeIndex];
         const Animation& animation = state.animations[i];
-        if(animation.used.duration == 0_nsec)
-            continue;
+        CORRADE_INTERNAL_ASSERT(animation.used.duration != 0_nsec);
 
         const AnimationState stateBefore = animationState(animation, timeBefore);
         const AnimationState stateAfter = animationState(animation, time);
@@ -1118,16 +1292,36 @@ Containers::Pair<bool, bool> AbstractAnimator::update(const Nanoseconds time, co
             cleanNeeded = true;
         }
 
-        /* If the animation is still active, request another advance() */
+        /* If the animation is still active, request another advance() and
+           calculate when it's needed, the same as in nextAdvanceTime().
+           Stopped animations are either kept and thus not needed anymore, or
+           scheduled for removal above, which the caller is responsible for
+           and which doesn't need the time to be recalculated. */
         if(stateAfter == AnimationState::Scheduled ||
            stateAfter == AnimationState::Playing ||
-           stateAfter == AnimationState::Paused)
+           stateAfter == AnimationState::Paused) {
             anotherAdvanceNeeded = true;
+            nextAdvanceTime = Math::min(nextAdvanceTime,
+                stateAfter == AnimationState::Scheduled ? animation.used.played :
+                stateAfter == AnimationState::Paused ? animation.used.stopped :
+                time);
+        }
+
+        /* If the animation stopped and is kept, no further update() needs
+           to look at it anymore */
+        else if(animation.used.flags & AnimationFlag::KeepOncePlayed) {
+            setAnimationActive(state.activeAnimations, state.activeAnimationPositions, i, false);
+            continue;
+        }
+
+        ++activeIndex;
     }
 
     /* Update current time, mark the animator as needing an advance() call only
        if there are any actually active animations left */
     state.time = time;
+    state.nextAdvanceTime = nextAdvanceTime;
+    state.nextAdvanceTimeValid = true;
     if(anotherAdvanceNeeded)
         state.state |= AnimatorState::NeedsAdvance;
     else
@@ -33,6 +33,7 @@
 
 #include <Corrade/Containers/Pointer.h>
 
+#include "Magnum/Ui/MemoryUsage.h"
 #include "Magnum/Ui/Ui.h"
 #include "Magnum/Ui/visibility.h"
 
@@ -344,6 +345,36 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          */
         Nanoseconds time() const;
 
+        /**
+         * @brief Time at which the animator needs to be advanced next
+         * @m_since_latest
+         *
+         * If @ref state() doesn't contain @ref AnimatorState::NeedsAdvance,
+         * returns @ref Nanoseconds::max(). Otherwise, if there's any animation
+         * that's @ref AnimationState::Playing at @ref time() or any
+         * @ref AnimationState::Stopped animation that's waiting to be removed,
+         * returns @ref time(), meaning the animator should be advanced right
+         * for the next frame. Otherwise returns the earliest time at which a
+         * @ref AnimationState::Scheduled animation starts playing or a
+         * @ref AnimationState::Paused animation gets stopped, or
+         * @ref Nanoseconds::max() if there are just paused animations without
+         * a stop time. Until then, calling @ref update() wouldn't result in
+         * anything being advanced, so an application can for example idle
+         * until the returned time instead of redrawing every frame.
+         *
+         * The value is calculated as a side effect of @ref update() and
+         * removing animations doesn't invalidate it, so the common case of
+         * querying it after @ref AbstractUserInterface::advanceAnimations()
+         * is @f$ \mathcal{O}(1) @f$. If animations were created, played,
+         * paused or stopped or their repeat count or flags were changed since
+         * the last @ref update(), complexity is @f$ \mathcal{O}(n) @f$ in the
+         * count of scheduled, playing, paused and stopped animations waiting
+         * to be removed. Removing an animation can cause the returned value
+         * to be earlier than necessary until the next @ref update().
+         * @see @ref AbstractUserInterface::nextAnimationAdvanceTime()
+         */
+        Nanoseconds nextAdvanceTime() const;
+
         /**
          * @brief Current capacity of the data storage
          *
@@ -362,6 +393,70 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          */
         std::size_t usedCount() const;
 
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * Sum of the memory used by the internal animation storage and what's
+         * returned from @ref doMemoryUsage(). Free slots of the animation
+         * storage are counted in @ref MemoryUsage::cpuUnused. The operation is
+         * done with a @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is
+         * @ref capacity().
+         * @see @ref AbstractUserInterface::memoryUsage()
+         */
+        MemoryUsage memoryUsage() const;
+
+        /**
+         * @brief Reserve the animation storage
+         * @m_since_latest
+         *
+         * Reserves memory for the internal animation storage to fit at least
+         * @p capacity items without reallocation and delegates to
+         * @ref doReserve(), where the implementation is expected to reserve
+         * its own storage as well. Expects that @p capacity is at most
+         * 1048576. Doesn't change @ref capacity(), which grows only when
+         * animations are actually created. Useful before creating a large
+         * amount of animations at once so the storage is allocated only once.
+         * @see @ref setFixedCapacity()
+         */
+        void reserve(std::size_t capacity);
+
+        /**
+         * @brief Fixed animation capacity
+         * @m_since_latest
+         *
+         * If @cpp 0 @ce, the animation storage grows as needed.
+         * @see @ref setFixedCapacity()
+         */
+        std::size_t fixedCapacity() const;
+
+        /**
+         * @brief Set a fixed animation capacity
+         * @m_since_latest
+         *
+         * Reserves the animation storage for @p capacity items with
+         * @ref reserve() and makes @ref create() never grow it past that.
+         * Creating an animation when the storage is full is an error, check
+         * @ref isFull() to handle the condition gracefully. Expects that
+         * @p capacity is at most 1048576 and not less than @ref capacity().
+         * Passing @cpp 0 @ce makes the storage grow as needed again.
+         * @see @ref AbstractUserInterface::setFixedNodeCapacity(),
+         *      @ref AbstractLayer::setFixedCapacity()
+         */
+        void setFixedCapacity(std::size_t capacity);
+
+        /**
+         * @brief Whether the animation storage is full
+         * @m_since_latest
+         *
+         * Returns @cpp true @ce if @ref setFixedCapacity() is set, all
+         * animations up to it are created and there are no free slots to
+         * reuse, i.e. @ref create() would fail. Unlike @ref usedCount(), the
+         * operation is done in a @f$ \mathcal{O}(1) @f$ complexity. Always
+         * returns @cpp false @ce if the capacity isn't fixed.
+         */
+        bool isFull() const;
+
         /**
          * @brief Whether an animation handle is valid
          *
@@ -1033,8 +1128,10 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          * that @p dataHandleGenerations contains handle generation counters
          * for all data in layer matching @ref layer() const, where the index
          * is implicitly the handle ID. They're used to decide about data
-         * attachment validity, animations with invalid data attachments are
-         * then removed. Delegates to @ref clean() and subsequently
+         * attachment validity, animations with invalid data attachments or
+         * attachments with IDs out of range of @p dataHandleGenerations,
+         * such as after @ref AbstractLayer::trim(), are then removed.
+         * Delegates to @ref clean() and subsequently
          * @ref doClean(), see their documentation for more information.
          */
         void cleanData(const Containers::StridedArrayView1D<const UnsignedShort>& dataHandleGenerations);
@@ -1257,6 +1354,33 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
         /** @brief Implementation for @ref features() */
         virtual AnimatorFeatures doFeatures() const = 0;
 
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * Implementation for @ref memoryUsage(). The implementation is
+         * expected to report memory used by its own internal state, the
+         * internal animation storage of the base class is already accounted
+         * for.
+         *
+         * Default implementation returns all values zero.
+         */
+        virtual MemoryUsage doMemoryUsage() const;
+
+        /**
+         * @brief Reserve the animation storage
+         * @param capacity      Capacity to reserve
+         * @m_since_latest
+         *
+         * Implementation for @ref reserve(), called after the internal
+         * animation storage of the base class is reserved. The implementation
+         * is expected to reserve its own storage indexed by animation IDs to
+         * fit at least @p capacity items.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doReserve(std::size_t capacity);
+
         /**
          * @brief Clean no longer valid animations
          * @param animationIdsToRemove Animation IDs to remove
@@ -1300,6 +1424,7 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
         /* Common implementations for foo(AnimationHandle) and
            foo(AnimatorDataHandle) */
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
+        MAGNUM_UI_LOCAL void setRepeatCountInternal(UnsignedInt id, UnsignedInt count);
         MAGNUM_UI_LOCAL void setFlagsInternal(UnsignedInt id, AnimationFlags flags);
         MAGNUM_UI_LOCAL void attachInternal(UnsignedInt id, NodeHandle node);
         MAGNUM_UI_LOCAL NodeHandle nodeInternal(UnsignedInt id) const;
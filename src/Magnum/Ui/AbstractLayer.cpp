@@ -37,6 +37,8 @@
 #include "Magnum/Ui/AbstractAnimator.h"
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
+#include "Magnum/Ui/Implementation/trace.h"
 
 namespace Magnum { namespace Ui {
 
@@ -44,7 +46,7 @@ Debug& operator<<(Debug& debug, const LayerFeature value) {
     /* Special case coming from the LayerFeatures printer. As both flags are a
        superset of Draw, printing just one would result in
        `LayerFeature::DrawUsesBlending|LayerFeature(0x04)` in the output. */
-    if(value == LayerFeature(UnsignedByte(LayerFeature::DrawUsesBlending|LayerFeature::DrawUsesScissor)))
+    if(value == LayerFeature(UnsignedShort(LayerFeature::DrawUsesBlending|LayerFeature::DrawUsesScissor)))
         return debug << LayerFeature::DrawUsesBlending << Debug::nospace << "|" << Debug::nospace << LayerFeature::DrawUsesScissor;
 
     debug << "Ui::LayerFeature" << Debug::nospace;
@@ -59,11 +61,15 @@ Debug& operator<<(Debug& debug, const LayerFeature value) {
         _c(Event)
         _c(AnimateData)
         _c(AnimateStyles)
+        _c(NodeTranslation)
+        _c(ConcurrentUpdate)
+        _c(DrawOpaque)
+        _c(EventBatch)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
 
-    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedShort(value) << Debug::nospace << ")";
 }
 
 Debug& operator<<(Debug& debug, const LayerFeatures value) {
@@ -72,14 +78,48 @@ Debug& operator<<(Debug& debug, const LayerFeatures value) {
            would result in `LayerFeature::DrawUsesBlending|LayerFeature(0x04)`
            in the output. So we pass both and let the LayerFeature printer deal
            with that. */
-        LayerFeature(UnsignedByte(LayerFeature::DrawUsesBlending|LayerFeature::DrawUsesScissor)),
+        LayerFeature(UnsignedShort(LayerFeature::DrawUsesBlending|LayerFeature::DrawUsesScissor)),
         LayerFeature::DrawUsesBlending, /* superset of Draw */
         LayerFeature::DrawUsesScissor, /* superset of Draw */
         LayerFeature::Composite, /* superset of Draw */
         LayerFeature::Draw,
+        LayerFeature::EventBatch, /* superset of Event */
         LayerFeature::Event,
         LayerFeature::AnimateData,
-        LayerFeature::AnimateStyles
+        LayerFeature::AnimateStyles,
+        LayerFeature::NodeTranslation,
+        LayerFeature::ConcurrentUpdate,
+        LayerFeature::DrawOpaque
+    });
+}
+
+Debug& operator<<(Debug& debug, const LayerEvent value) {
+    debug << "Ui::LayerEvent" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case LayerEvent::value: return debug << "::" #value;
+        _c(Pointer)
+        _c(PointerMove)
+        _c(Scroll)
+        _c(Focus)
+        _c(Key)
+        _c(TextInput)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+}
+
+Debug& operator<<(Debug& debug, const LayerEvents value) {
+    return Containers::enumSetDebugOutput(debug, value, "Ui::LayerEvents{}", {
+        LayerEvent::Pointer,
+        LayerEvent::PointerMove,
+        LayerEvent::Scroll,
+        LayerEvent::Focus,
+        LayerEvent::Key,
+        LayerEvent::TextInput
     });
 }
 
@@ -105,6 +145,8 @@ Debug& operator<<(Debug& debug, const LayerState value) {
         _c(NeedsSharedDataUpdate)
         _c(NeedsCompositeOffsetSizeUpdate)
         _c(NeedsDataClean)
+        _c(NeedsNodeTranslationUpdate)
+        _c(NeedsDataStyleUpdate)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -132,7 +174,9 @@ Debug& operator<<(Debug& debug, const LayerStates value) {
         LayerState::NeedsCommonDataUpdate,
         LayerState::NeedsSharedDataUpdate,
         LayerState::NeedsCompositeOffsetSizeUpdate,
-        LayerState::NeedsDataClean
+        LayerState::NeedsDataClean,
+        LayerState::NeedsNodeTranslationUpdate,
+        LayerState::NeedsDataStyleUpdate
     });
 }
 
@@ -201,6 +245,23 @@ struct AbstractLayer::State {
        (first/next/last) free data. */
     UnsignedInt firstFree = ~UnsignedInt{};
     UnsignedInt lastFree = ~UnsignedInt{};
+    /* Generation newly allocated data start at. Raised by trim() to be larger
+       than generation of any data it dropped from the end of the `data`
+       array, so handles pointing to them don't become valid again once new
+       data get allocated at the same IDs. */
+    UnsignedShort initialGeneration = 1;
+    /* If non-zero, the data storage is reserved for exactly this many items
+       and create() never grows it past that */
+    UnsignedInt fixedCapacity = 0;
+
+    /* Bytes reported via addUploadedSize() since the last update() call */
+    std::size_t uploadedSize = 0;
+
+    /* Storage for cleanNodes(), kept across calls to avoid allocating each
+       time. The bits are reset back to zero after use, the list is
+       repopulated every time. */
+    Containers::BitArray cleanDataIdsToRemove;
+    Containers::Array<UnsignedInt> cleanDataIds;
 };
 
 AbstractLayer::AbstractLayer(const LayerHandle handle): _state{InPlaceInit} {
@@ -219,6 +280,16 @@ LayerHandle AbstractLayer::handle() const {
     return _state->handle;
 }
 
+LayerEvents AbstractLayer::events() const {
+    CORRADE_ASSERT(features() & LayerFeature::Event,
+        "Ui::AbstractLayer::events(): feature not supported", {});
+    return doEvents();
+}
+
+LayerEvents AbstractLayer::doEvents() const {
+    return LayerEvent::Pointer|LayerEvent::PointerMove|LayerEvent::Scroll|LayerEvent::Focus|LayerEvent::Key|LayerEvent::TextInput;
+}
+
 LayerStates AbstractLayer::state() const {
     const LayerStates state = doState();
     #ifndef CORRADE_NO_ASSERT
@@ -235,7 +306,7 @@ LayerStates AbstractLayer::doState() const { return {}; }
 
 void AbstractLayer::setNeedsUpdate(const LayerStates state) {
     #ifndef CORRADE_NO_ASSERT
-    LayerStates expectedStates = LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate;
+    LayerStates expectedStates = LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate|LayerState::NeedsDataStyleUpdate;
     if(features() >= LayerFeature::Composite)
         expectedStates |= LayerState::NeedsCompositeOffsetSizeUpdate;
     #endif
@@ -263,6 +334,114 @@ std::size_t AbstractLayer::usedCount() const {
     return state.data.size() - free;
 }
 
+MemoryUsage AbstractLayer::memoryUsage() const {
+    const State& state = *_state;
+    MemoryUsage out = doMemoryUsage();
+    Implementation::addArrayMemoryUsage(out, state.data);
+    Implementation::addArrayMemoryUsage(out, state.cleanDataIds);
+    const std::size_t cleanDataIdsToRemoveSize = (state.cleanDataIdsToRemove.size() + 7)/8;
+    out.cpuUsed += cleanDataIdsToRemoveSize;
+    out.cpuReserved += cleanDataIdsToRemoveSize;
+    out.cpuUnused += (state.data.size() - usedCount())*sizeof(Data);
+    return out;
+}
+
+MemoryUsage AbstractLayer::doMemoryUsage() const { return {}; }
+
+std::size_t AbstractLayer::uploadedSize() const {
+    return _state->uploadedSize;
+}
+
+void AbstractLayer::addUploadedSize(const std::size_t size) {
+    _state->uploadedSize += size;
+}
+
+void AbstractLayer::trim() {
+    State& state = *_state;
+
+    /* With a fixed capacity the storage is meant to stay allocated */
+    if(state.fixedCapacity)
+        return;
+
+    /* Mark free data by walking the free list. Disabled data aren't in the
+       free list and thus are treated as used, which means they're never
+       dropped. That's desired, as recycling their IDs would need a
+       generation counter that doesn't fit. */
+    Containers::BitArray free{ValueInit, state.data.size()};
+    for(UnsignedInt index = state.firstFree; index != ~UnsignedInt{}; index = state.data[index].free.next)
+        free.set(index);
+
+    /* Find one past the last used data */
+    std::size_t capacity = state.data.size();
+    while(capacity && free[capacity - 1])
+        --capacity;
+
+    if(capacity != state.data.size()) {
+        /* Remember the largest generation of the dropped data so recreated
+           data don't alias existing handles. The free data have it already
+           incremented past the last handle returned for them. */
+        for(std::size_t i = capacity; i != state.data.size(); ++i)
+            state.initialGeneration = Math::max(state.initialGeneration, state.data[i].free.generation);
+
+        /* Rebuild the free list without the dropped data, preserving the
+           order */
+        UnsignedInt firstFree = ~UnsignedInt{};
+        UnsignedInt lastFree = ~UnsignedInt{};
+        for(UnsignedInt index = state.firstFree; index != ~UnsignedInt{}; index = state.data[index].free.next) {
+            if(index >= capacity)
+                continue;
+            if(lastFree == ~UnsignedInt{})
+                firstFree = index;
+            else
+                state.data[lastFree].free.next = index;
+            lastFree = index;
+        }
+        if(lastFree != ~UnsignedInt{})
+            state.data[lastFree].free.next = ~UnsignedInt{};
+        state.firstFree = firstFree;
+        state.lastFree = lastFree;
+
+        arrayResize(state.data, NoInit, capacity);
+        state.state |= LayerState::NeedsDataUpdate;
+    }
+
+    arrayShrink(state.data);
+
+    doTrim(capacity);
+}
+
+void AbstractLayer::doTrim(std::size_t) {}
+
+void AbstractLayer::reserve(const std::size_t capacity) {
+    CORRADE_ASSERT(capacity <= 1 << Implementation::LayerDataHandleIdBits,
+        "Ui::AbstractLayer::reserve(): can only have at most" << (1 << Implementation::LayerDataHandleIdBits) << "data but got" << capacity, );
+    arrayReserve(_state->data, capacity);
+    doReserve(capacity);
+}
+
+void AbstractLayer::doReserve(std::size_t) {}
+
+std::size_t AbstractLayer::fixedCapacity() const {
+    return _state->fixedCapacity;
+}
+
+void AbstractLayer::setFixedCapacity(const std::size_t capacity) {
+    State& state = *_state;
+    CORRADE_ASSERT(capacity <= 1 << Implementation::LayerDataHandleIdBits,
+        "Ui::AbstractLayer::setFixedCapacity(): can only have at most" << (1 << Implementation::LayerDataHandleIdBits) << "data but got" << capacity, );
+    CORRADE_ASSERT(!capacity || capacity >= state.data.size(),
+        "Ui::AbstractLayer::setFixedCapacity(): capacity" << capacity << "is less than current capacity" << state.data.size(), );
+    reserve(capacity);
+    state.fixedCapacity = capacity;
+}
+
+bool AbstractLayer::isFull() const {
+    const State& state = *_state;
+    return state.fixedCapacity &&
+           state.firstFree == ~UnsignedInt{} &&
+           state.data.size() == state.fixedCapacity;
+}
+
 bool AbstractLayer::isHandleValid(const LayerDataHandle handle) const {
     if(handle == LayerDataHandle::Null)
         return false;
@@ -307,7 +486,10 @@ DataHandle AbstractLayer::create(const NodeHandle node) {
     } else {
         CORRADE_ASSERT(state.data.size() < 1 << Implementation::LayerDataHandleIdBits,
             "Ui::AbstractLayer::create(): can only have at most" << (1 << Implementation::LayerDataHandleIdBits) << "data", {});
+        CORRADE_ASSERT(!state.fixedCapacity || state.data.size() < state.fixedCapacity,
+            "Ui::AbstractLayer::create(): fixed capacity of" << state.fixedCapacity << "exhausted", {});
         data = &arrayAppend(state.data, InPlaceInit);
+        data->used.generation = state.initialGeneration;
     }
 
     /* Fill the data. In both above cases the generation is already set
@@ -484,8 +666,13 @@ void AbstractLayer::doSetSize(const Vector2&, const Vector2i&) {}
 
 void AbstractLayer::cleanNodes(const Containers::StridedArrayView1D<const UnsignedShort>& nodeHandleGenerations) {
     State& state = *_state;
-    /** @todo have some bump allocator for this */
-    Containers::BitArray dataIdsToRemove{ValueInit, state.data.size()};
+    /* The bit storage is zeroed after every use below, so it needs to be
+       reallocated only if the capacity changed */
+    if(state.cleanDataIdsToRemove.size() != state.data.size())
+        state.cleanDataIdsToRemove = Containers::BitArray{ValueInit, state.data.size()};
+    Containers::MutableBitArrayView dataIdsToRemove = state.cleanDataIdsToRemove;
+    Containers::Array<UnsignedInt>& dataIds = state.cleanDataIds;
+    arrayResize(dataIds, 0);
 
     for(std::size_t i = 0; i != state.data.size(); ++i) {
         const Data& data = state.data[i];
@@ -504,14 +691,24 @@ void AbstractLayer::cleanNodes(const Containers::StridedArrayView1D<const Unsign
         if(nodeHandleGeneration(data.used.node) != nodeHandleGenerations[nodeHandleId(data.used.node)]) {
             removeInternal(i);
             dataIdsToRemove.set(i);
+            arrayAppend(dataIds, UnsignedInt(i));
         }
     }
 
-    doClean(dataIdsToRemove);
+    doCleanSparse(dataIdsToRemove, dataIds);
+
+    /* Reset the bits for the next time, which is again proportional only to
+       the count of removed data */
+    for(const UnsignedInt i: dataIds)
+        dataIdsToRemove.reset(i);
 }
 
 void AbstractLayer::doClean(Containers::BitArrayView) {}
 
+void AbstractLayer::doCleanSparse(const Containers::BitArrayView dataIdsToRemove, Containers::ArrayView<const UnsignedInt>) {
+    doClean(dataIdsToRemove);
+}
+
 void AbstractLayer::cleanData(const Containers::Iterable<AbstractAnimator>& animators) {
     State& state = *_state;
     const Containers::StridedArrayView1D<const UnsignedShort> dataGenerations = stridedArrayView(state.data).slice(&Data::used).slice(&Data::Used::generation);
@@ -589,10 +786,13 @@ void AbstractLayer::doAdvanceAnimations(Nanoseconds, Containers::MutableBitArray
 }
 
 void AbstractLayer::update(const LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractLayer::update()");
     #ifndef CORRADE_NO_ASSERT
-    LayerStates expectedStates = LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsNodeOpacityUpdate|LayerState::NeedsNodeOrderUpdate|LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate|LayerState::NeedsAttachmentUpdate;
+    LayerStates expectedStates = LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsNodeOpacityUpdate|LayerState::NeedsNodeOrderUpdate|LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate|LayerState::NeedsDataStyleUpdate|LayerState::NeedsAttachmentUpdate;
     if(features() >= LayerFeature::Composite)
         expectedStates |= LayerState::NeedsCompositeOffsetSizeUpdate;
+    if(features() >= LayerFeature::NodeTranslation)
+        expectedStates |= LayerState::NeedsNodeTranslationUpdate;
     #endif
     CORRADE_ASSERT(states && states <= expectedStates,
         "Ui::AbstractLayer::update(): expected a non-empty subset of" << expectedStates << "but got" << states, );
@@ -611,6 +811,7 @@ void AbstractLayer::update(const LayerStates states, const Containers::StridedAr
     auto& state = *_state;
     CORRADE_ASSERT(!(features() >= LayerFeature::Draw) || state.setSizeCalled,
         "Ui::AbstractLayer::update(): user interface size wasn't set", );
+    state.uploadedSize = 0;
     /* Don't pass the NeedsAttachmentUpdate bit to the implementation as it
        shouldn't need that, just NeedsNodeOpacityUpdate NeedsNodeOrderUpdate
        that's a subset of it */
@@ -620,7 +821,19 @@ void AbstractLayer::update(const LayerStates states, const Containers::StridedAr
 
 void AbstractLayer::doUpdate(LayerStates, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) {}
 
+void AbstractLayer::postUpdate(const LayerStates states) {
+    CORRADE_ASSERT(features() >= LayerFeature::ConcurrentUpdate,
+        "Ui::AbstractLayer::postUpdate(): feature not supported", );
+    CORRADE_ASSERT(states,
+        "Ui::AbstractLayer::postUpdate(): expected a non-empty set of states", );
+    /* Filter the states the same way as in update() */
+    doPostUpdate(states & ~(LayerState::NeedsAttachmentUpdate & ~(LayerState::NeedsNodeOpacityUpdate|LayerState::NeedsNodeOrderUpdate)));
+}
+
+void AbstractLayer::doPostUpdate(LayerStates) {}
+
 void AbstractLayer::composite(AbstractRenderer& renderer, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes, const std::size_t offset, const std::size_t count) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractLayer::composite()");
     CORRADE_ASSERT(features() & LayerFeature::Composite,
         "Ui::AbstractLayer::composite(): feature not supported", );
     CORRADE_ASSERT(compositeRectOffsets.size() == compositeRectSizes.size(),
@@ -635,6 +848,7 @@ void AbstractLayer::doComposite(AbstractRenderer&, const Containers::StridedArra
 }
 
 void AbstractLayer::draw(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const std::size_t offset, const std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const std::size_t clipRectOffset, const std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractLayer::draw()");
     CORRADE_ASSERT(features() & LayerFeature::Draw,
         "Ui::AbstractLayer::draw(): feature not supported", );
     CORRADE_ASSERT(offset + count <= dataIds.size(),
@@ -656,6 +870,29 @@ void AbstractLayer::doDraw(const Containers::StridedArrayView1D<const UnsignedIn
     CORRADE_ASSERT_UNREACHABLE("Ui::AbstractLayer::draw(): feature advertised but not implemented", );
 }
 
+void AbstractLayer::drawOpaque(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const std::size_t offset, const std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const std::size_t clipRectOffset, const std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractLayer::drawOpaque()");
+    CORRADE_ASSERT(features() & LayerFeature::DrawOpaque,
+        "Ui::AbstractLayer::drawOpaque(): feature not supported", );
+    CORRADE_ASSERT(offset + count <= dataIds.size(),
+        "Ui::AbstractLayer::drawOpaque(): offset" << offset << "and count" << count << "out of range for" << dataIds.size() << "items", );
+    CORRADE_ASSERT(clipRectIds.size() == clipRectDataCounts.size(),
+        "Ui::AbstractLayer::drawOpaque(): expected clip rect ID and data count views to have the same size but got" << clipRectIds.size() << "and" << clipRectDataCounts.size(), );
+    CORRADE_ASSERT(clipRectOffset + clipRectCount <= clipRectIds.size(),
+        "Ui::AbstractLayer::drawOpaque(): clip rect offset" << clipRectOffset << "and count" << clipRectCount << "out of range for" << clipRectIds.size() << "items", );
+    CORRADE_ASSERT(nodeOffsets.size() == nodeSizes.size() &&
+                   nodeOpacities.size() == nodeSizes.size() &&
+                   nodesEnabled.size() == nodeSizes.size(),
+        "Ui::AbstractLayer::drawOpaque(): expected node offset, size, opacity and enabled views to have the same size but got" << nodeOffsets.size() << Debug::nospace << "," << nodeSizes.size() << Debug::nospace << "," << nodeOpacities.size() << "and" << nodesEnabled.size(), );
+    CORRADE_ASSERT(clipRectOffsets.size() == clipRectSizes.size(),
+        "Ui::AbstractLayer::drawOpaque(): expected clip rect offset and size views to have the same size but got" << clipRectOffsets.size() << "and" << clipRectSizes.size(), );
+    doDrawOpaque(dataIds, offset, count, clipRectIds, clipRectDataCounts, clipRectOffset, clipRectCount, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes);
+}
+
+void AbstractLayer::doDrawOpaque(const Containers::StridedArrayView1D<const UnsignedInt>&, std::size_t, std::size_t, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, std::size_t, std::size_t, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) {
+    CORRADE_ASSERT_UNREACHABLE("Ui::AbstractLayer::drawOpaque(): feature advertised but not implemented", );
+}
+
 void AbstractLayer::pointerPressEvent(const UnsignedInt dataId, PointerEvent& event) {
     CORRADE_ASSERT(features() & LayerFeature::Event,
         "Ui::AbstractLayer::pointerPressEvent(): feature not supported", );
@@ -857,4 +1094,174 @@ void AbstractLayer::visibilityLostEvent(const UnsignedInt dataId, VisibilityLost
 
 void AbstractLayer::doVisibilityLostEvent(UnsignedInt, VisibilityLostEvent&) {}
 
+namespace {
+
+/* Used by the default doPointerPressEvents() etc. implementations */
+template<class Event> void callEventOnData(AbstractLayer& layer, void(AbstractLayer::*function)(UnsignedInt, Event&), const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, Event& event) {
+    bool acceptedByAnyData = false;
+    for(const UnsignedInt dataId: dataIds) {
+        event.setAccepted(false);
+        (layer.*function)(dataId, event);
+        if(event.isAccepted())
+            acceptedByAnyData = true;
+    }
+    event.setAccepted(acceptedByAnyData);
+}
+
+}
+
+void AbstractLayer::pointerPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) {
+    CORRADE_ASSERT(features() & LayerFeature::Event,
+        "Ui::AbstractLayer::pointerPressEvents(): feature not supported", );
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = *_state;
+    for(std::size_t i = 0; i != dataIds.size(); ++i)
+        CORRADE_ASSERT(dataIds[i] < state.data.size(),
+            "Ui::AbstractLayer::pointerPressEvents(): index" << dataIds[i] << "at position" << i << "out of range for" << state.data.size() << "data", );
+    #endif
+    CORRADE_ASSERT(!event.isAccepted(),
+        "Ui::AbstractLayer::pointerPressEvents(): event already accepted", );
+    return doPointerPressEvents(dataIds, event);
+}
+
+void AbstractLayer::doPointerPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) {
+    callEventOnData(*this, &AbstractLayer::doPointerPressEvent, dataIds, event);
+}
+
+void AbstractLayer::pointerReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) {
+    CORRADE_ASSERT(features() & LayerFeature::Event,
+        "Ui::AbstractLayer::pointerReleaseEvents(): feature not supported", );
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = *_state;
+    for(std::size_t i = 0; i != dataIds.size(); ++i)
+        CORRADE_ASSERT(dataIds[i] < state.data.size(),
+            "Ui::AbstractLayer::pointerReleaseEvents(): index" << dataIds[i] << "at position" << i << "out of range for" << state.data.size() << "data", );
+    #endif
+    CORRADE_ASSERT(!event.isAccepted(),
+        "Ui::AbstractLayer::pointerReleaseEvents(): event already accepted", );
+    return doPointerReleaseEvents(dataIds, event);
+}
+
+void AbstractLayer::doPointerReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) {
+    callEventOnData(*this, &AbstractLayer::doPointerReleaseEvent, dataIds, event);
+}
+
+void AbstractLayer::pointerMoveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) {
+    CORRADE_ASSERT(features() & LayerFeature::Event,
+        "Ui::AbstractLayer::pointerMoveEvents(): feature not supported", );
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = *_state;
+    for(std::size_t i = 0; i != dataIds.size(); ++i)
+        CORRADE_ASSERT(dataIds[i] < state.data.size(),
+            "Ui::AbstractLayer::pointerMoveEvents(): index" << dataIds[i] << "at position" << i << "out of range for" << state.data.size() << "data", );
+    #endif
+    CORRADE_ASSERT(!event.isAccepted(),
+        "Ui::AbstractLayer::pointerMoveEvents(): event already accepted", );
+    return doPointerMoveEvents(dataIds, event);
+}
+
+void AbstractLayer::doPointerMoveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) {
+    callEventOnData(*this, &AbstractLayer::doPointerMoveEvent, dataIds, event);
+}
+
+void AbstractLayer::pointerEnterEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) {
+    CORRADE_ASSERT(features() & LayerFeature::Event,
+        "Ui::AbstractLayer::pointerEnterEvents(): feature not supported", );
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = *_state;
+    for(std::size_t i = 0; i != dataIds.size(); ++i)
+        CORRADE_ASSERT(dataIds[i] < state.data.size(),
+            "Ui::AbstractLayer::pointerEnterEvents(): index" << dataIds[i] << "at position" << i << "out of range for" << state.data.size() << "data", );
+    #endif
+    CORRADE_ASSERT(event.isPrimary(),
+        "Ui::AbstractLayer::pointerEnterEvents(): event not primary", );
+    CORRADE_ASSERT(!event.isAccepted(),
+        "Ui::AbstractLayer::pointerEnterEvents(): event already accepted", );
+    /* This isn't triggerable from public code so can be an internal assert,
+       verifying just that the UserInterface internals don't mess up */
+    CORRADE_INTERNAL_ASSERT(event.relativePosition().isZero());
+    return doPointerEnterEvents(dataIds, event);
+}
+
+void AbstractLayer::doPointerEnterEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) {
+    callEventOnData(*this, &AbstractLayer::doPointerEnterEvent, dataIds, event);
+}
+
+void AbstractLayer::pointerLeaveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) {
+    CORRADE_ASSERT(features() & LayerFeature::Event,
+        "Ui::AbstractLayer::pointerLeaveEvents(): feature not supported", );
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = *_state;
+    for(std::size_t i = 0; i != dataIds.size(); ++i)
+        CORRADE_ASSERT(dataIds[i] < state.data.size(),
+            "Ui::AbstractLayer::pointerLeaveEvents(): index" << dataIds[i] << "at position" << i << "out of range for" << state.data.size() << "data", );
+    #endif
+    CORRADE_ASSERT(event.isPrimary(),
+        "Ui::AbstractLayer::pointerLeaveEvents(): event not primary", );
+    CORRADE_ASSERT(!event.isAccepted(),
+        "Ui::AbstractLayer::pointerLeaveEvents(): event already accepted", );
+    /* This isn't triggerable from public code so can be an internal assert,
+       verifying just that the UserInterface internals don't mess up */
+    CORRADE_INTERNAL_ASSERT(event.relativePosition().isZero());
+    return doPointerLeaveEvents(dataIds, event);
+}
+
+void AbstractLayer::doPointerLeaveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) {
+    callEventOnData(*this, &AbstractLayer::doPointerLeaveEvent, dataIds, event);
+}
+
+void AbstractLayer::scrollEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, ScrollEvent& event) {
+    CORRADE_ASSERT(features() & LayerFeature::Event,
+        "Ui::AbstractLayer::scrollEvents(): feature not supported", );
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = *_state;
+    for(std::size_t i = 0; i != dataIds.size(); ++i)
+        CORRADE_ASSERT(dataIds[i] < state.data.size(),
+            "Ui::AbstractLayer::scrollEvents(): index" << dataIds[i] << "at position" << i << "out of range for" << state.data.size() << "data", );
+    #endif
+    CORRADE_ASSERT(!event.isAccepted(),
+        "Ui::AbstractLayer::scrollEvents(): event already accepted", );
+    return doScrollEvents(dataIds, event);
+}
+
+void AbstractLayer::doScrollEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, ScrollEvent& event) {
+    callEventOnData(*this, &AbstractLayer::doScrollEvent, dataIds, event);
+}
+
+void AbstractLayer::keyPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event) {
+    CORRADE_ASSERT(features() & LayerFeature::Event,
+        "Ui::AbstractLayer::keyPressEvents(): feature not supported", );
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = *_state;
+    for(std::size_t i = 0; i != dataIds.size(); ++i)
+        CORRADE_ASSERT(dataIds[i] < state.data.size(),
+            "Ui::AbstractLayer::keyPressEvents(): index" << dataIds[i] << "at position" << i << "out of range for" << state.data.size() << "data", );
+    #endif
+    CORRADE_ASSERT(!event.isAccepted(),
+        "Ui::AbstractLayer::keyPressEvents(): event already accepted", );
+    return doKeyPressEvents(dataIds, event);
+}
+
+void AbstractLayer::doKeyPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event) {
+    callEventOnData(*this, &AbstractLayer::doKeyPressEvent, dataIds, event);
+}
+
+void AbstractLayer::keyReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event) {
+    CORRADE_ASSERT(features() & LayerFeature::Event,
+        "Ui::AbstractLayer::keyReleaseEvents(): feature not supported", );
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = *_state;
+    for(std::size_t i = 0; i != dataIds.size(); ++i)
+        CORRADE_ASSERT(dataIds[i] < state.data.size(),
+            "Ui::AbstractLayer::keyReleaseEvents(): index" << dataIds[i] << "at position" << i << "out of range for" << state.data.size() << "data", );
+    #endif
+    CORRADE_ASSERT(!event.isAccepted(),
+        "Ui::AbstractLayer::keyReleaseEvents(): event already accepted", );
+    return doKeyReleaseEvents(dataIds, event);
+}
+
+void AbstractLayer::doKeyReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event) {
+    callEventOnData(*this, &AbstractLayer::doKeyReleaseEvent, dataIds, event);
+}
+
 }}
@@ -35,6 +35,7 @@
 #include <Corrade/Containers/Pointer.h>
 #include <Magnum/Magnum.h>
 
+#include "Magnum/Ui/MemoryUsage.h"
 #include "Magnum/Ui/Ui.h"
 #include "Magnum/Ui/visibility.h"
 
@@ -46,7 +47,7 @@ namespace Magnum { namespace Ui {
 
 @see @ref LayerFeatures, @ref AbstractLayer::features()
 */
-enum class LayerFeature: UnsignedByte {
+enum class LayerFeature: UnsignedShort {
     /** Drawing using @ref AbstractLayer::draw() */
     Draw = 1 << 0,
 
@@ -97,6 +98,61 @@ enum class LayerFeature: UnsignedByte {
      * animating styles using @ref AbstractLayer::advanceAnimations(Nanoseconds, Containers::MutableBitArrayView, const Containers::StridedArrayView1D<Float>&, Containers::MutableBitArrayView, const Containers::Iterable<AbstractStyleAnimator>&).
      */
     AnimateStyles = 1 << 6,
+
+    /**
+     * Updating data positions after their nodes were only translated. If
+     * advertised, @ref AbstractLayer::update() gets
+     * @ref LayerState::NeedsNodeTranslationUpdate instead of
+     * @ref LayerState::NeedsNodeOffsetSizeUpdate if node offsets changed but
+     * node sizes, the set of visible nodes and clip rectangles stayed the
+     * same, such as when scrolling or moving node hierarchies around, and the
+     * layer itself doesn't have @ref LayerState::NeedsNodeOffsetSizeUpdate
+     * set. If additionally the node order and node flags stayed the same,
+     * @ref LayerState::NeedsNodeOrderUpdate and
+     * @ref LayerState::NeedsNodeEnabledUpdate aren't passed either.
+     */
+    NodeTranslation = 1 << 7,
+
+    /**
+     * The CPU-side part of @ref AbstractLayer::update() can be executed
+     * concurrently with updates of other layers that advertise this feature.
+     * If advertised and @ref AbstractUserInterface::setUpdateExecutor() is
+     * set, @ref AbstractLayer::update() may get called from a different
+     * thread than the one the user interface is updated on, and
+     * @ref AbstractLayer::postUpdate() then gets called on the user interface
+     * thread after updates of all such layers finish, in the layer order.
+     * The implementation is thus expected to only modify its own internal
+     * state in @ref AbstractLayer::doUpdate(), treat any state shared with
+     * other layers as read-only, and defer any GPU uploads to
+     * @ref AbstractLayer::doPostUpdate().
+     */
+    ConcurrentUpdate = 1 << 8,
+
+    /**
+     * Drawing depth of opaque parts of layer data. Has an effect only if
+     * advertised together with @ref LayerFeature::Draw and if the renderer
+     * supports @ref RendererFeature::DepthBuffer, in which case
+     * @ref AbstractLayer::drawOpaque() gets called front-to-back with
+     * @ref RendererDrawState::DepthPrepass before the regular
+     * @ref AbstractLayer::draw() calls, allowing the renderer to reject
+     * content hidden behind opaque parts of later top-level nodes.
+     * @see @ref AbstractLayer::doDrawOpaque()
+     */
+    DrawOpaque = 1 << 9,
+
+    /**
+     * Handling pointer press, release, move, enter and leave, scroll and key
+     * press and release events for all data attached to the same node in a
+     * single call. If advertised, @ref AbstractUserInterface calls
+     * @ref AbstractLayer::pointerPressEvents() and other batched variants
+     * once for every node with all its data from this layer instead of
+     * calling @ref AbstractLayer::pointerPressEvent() etc. once for every
+     * data. The pointer event capture state is then reset only if the event
+     * isn't accepted by any data in the batch. Implies
+     * @ref LayerFeature::Event.
+     * @see @ref AbstractLayer::doPointerPressEvents()
+     */
+    EventBatch = Event|(1 << 10),
 };
 
 /**
@@ -121,6 +177,70 @@ MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, LayerFeatures value);
 
 CORRADE_ENUMSET_OPERATORS(LayerFeatures)
 
+/**
+@brief Event handled by a layer
+@m_since_latest
+
+@see @ref LayerEvents, @ref AbstractLayer::events()
+*/
+enum class LayerEvent: UnsignedByte {
+    /**
+     * Handling @ref AbstractLayer::pointerPressEvent() and
+     * @relativeref{AbstractLayer,pointerReleaseEvent()}.
+     */
+    Pointer = 1 << 0,
+
+    /**
+     * Handling @ref AbstractLayer::pointerMoveEvent(),
+     * @relativeref{AbstractLayer,pointerEnterEvent()} and
+     * @relativeref{AbstractLayer,pointerLeaveEvent()}. Note that a node
+     * becomes hovered only if a pointer move event is accepted on it, so a
+     * layer that needs pointer enter and leave events has to accept the move
+     * events as well.
+     */
+    PointerMove = 1 << 1,
+
+    /** Handling @ref AbstractLayer::scrollEvent() */
+    Scroll = 1 << 2,
+
+    /**
+     * Handling @ref AbstractLayer::focusEvent() and
+     * @relativeref{AbstractLayer,blurEvent()}.
+     */
+    Focus = 1 << 3,
+
+    /**
+     * Handling @ref AbstractLayer::keyPressEvent() and
+     * @relativeref{AbstractLayer,keyReleaseEvent()}.
+     */
+    Key = 1 << 4,
+
+    /** Handling @ref AbstractLayer::textInputEvent() */
+    TextInput = 1 << 5,
+};
+
+/**
+@debugoperatorenum{LayerEvent}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, LayerEvent value);
+
+/**
+@brief Set of events handled by a layer
+@m_since_latest
+
+@see @ref AbstractLayer::events()
+*/
+typedef Containers::EnumSet<LayerEvent> LayerEvents;
+
+/**
+@debugoperatorenum{LayerEvents}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, LayerEvents value);
+
+CORRADE_ENUMSET_OPERATORS(LayerEvents)
+
 /**
 @brief Layer state
 @m_since_latest
@@ -318,7 +438,44 @@ enum class LayerState: UnsignedShort {
      * If set on a layer, causes @ref UserInterfaceState::NeedsDataClean
      * to be set on the user interface.
      */
-    NeedsDataClean = 1 << 9
+    NeedsDataClean = 1 << 9,
+
+    /**
+     * @ref AbstractLayer::update() (which is called from
+     * @ref AbstractUserInterface::update()) needs to be called to translate
+     * position-related state after offsets of nodes the data are attached to
+     * changed, with node sizes, the set of visible nodes and clip rectangles
+     * staying the same. The layer can thus for example apply a per-node
+     * difference to existing vertex positions instead of regenerating them
+     * from scratch.
+     *
+     * Gets passed to @ref AbstractLayer::update() instead of
+     * @ref LayerState::NeedsNodeOffsetSizeUpdate only if the layer advertises
+     * @ref LayerFeature::NodeTranslation and doesn't have
+     * @ref LayerState::NeedsNodeOffsetSizeUpdate set itself. Is never
+     * returned by @ref AbstractLayer::state().
+     */
+    NeedsNodeTranslationUpdate = 1 << 10,
+
+    /**
+     * @ref AbstractLayer::update() (which is called from
+     * @ref AbstractUserInterface::update()) needs to be called to update
+     * style-related state of a subset of data after their style assignment
+     * changed, such as on a style transition in response to an event, with
+     * everything else staying the same. The layer implementation is
+     * responsible for tracking which data are affected and can thus patch
+     * just those instead of regenerating everything from scratch. Can be
+     * explicitly set by the layer implementation using
+     * @ref AbstractLayer::setNeedsUpdate(), is reset next time
+     * @ref AbstractLayer::update() is called with this flag present.
+     *
+     * If set on a layer, causes @ref UserInterfaceState::NeedsDataUpdate to
+     * be set on the user interface. Gets passed to @ref AbstractLayer::update()
+     * only if the layer itself has it set. If passed together with
+     * @ref LayerState::NeedsDataUpdate, the layer is expected to update
+     * everything anyway.
+     */
+    NeedsDataStyleUpdate = 1 << 11
 };
 
 /**
@@ -385,6 +542,22 @@ class MAGNUM_UI_EXPORT AbstractLayer {
         /** @brief Features exposed by a layer */
         LayerFeatures features() const { return doFeatures(); }
 
+        /**
+         * @brief Events handled by a layer
+         * @m_since_latest
+         *
+         * Expects that the layer supports @ref LayerFeature::Event. Queried
+         * by @ref AbstractUserInterface::setLayerInstance(), which then calls
+         * the event handlers only on data of layers that advertise given
+         * event. In particular, pointer move, enter and leave events, which
+         * happen the most often, are dispatched from a dedicated list of data
+         * that excludes layers without @ref LayerEvent::PointerMove. The
+         * @ref pointerCancelEvent() and @ref visibilityLostEvent() are called
+         * on all event data regardless of what's returned here. Delegates to
+         * @ref doEvents(), see its documentation for more information.
+         */
+        LayerEvents events() const;
+
         /**
          * @brief Layer state
          *
@@ -426,6 +599,108 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         std::size_t usedCount() const;
 
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * Sum of the memory used by the internal data storage and what's
+         * returned from @ref doMemoryUsage(). Free slots of the data storage
+         * are counted in @ref MemoryUsage::cpuUnused. The operation is done
+         * with a @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is
+         * @ref capacity().
+         * @see @ref AbstractUserInterface::memoryUsage()
+         */
+        MemoryUsage memoryUsage() const;
+
+        /**
+         * @brief Size of data uploaded to the GPU in the last update
+         * @m_since_latest
+         *
+         * Count of bytes the implementation reported via
+         * @ref addUploadedSize() since the last @ref update() call started,
+         * i.e. in the last @ref doUpdate() and the subsequent
+         * @ref doPostUpdate(). Zero initially and for layers that don't
+         * upload anything. Collected in
+         * @ref UserInterfaceUpdateStatistics::layerUploadedSizes if enabled.
+         */
+        std::size_t uploadedSize() const;
+
+        /**
+         * @brief Trim the data storage
+         * @m_since_latest
+         *
+         * Drops free slots at the end of the data storage, reducing
+         * @ref capacity() to one past the last used item, and releases
+         * memory reserved for future growth. Delegates to @ref doTrim() with
+         * the new capacity, where the implementation is expected to shrink
+         * its own storage as well. If the capacity changed,
+         * @ref LayerState::NeedsDataUpdate is set so the implementation can
+         * recreate data sized to the capacity.
+         *
+         * Free slots in the middle of the storage are kept, as compacting
+         * them would change IDs of existing handles. Handles pointing to the
+         * dropped slots stay invalid, slots created in their place later
+         * have a generation counter larger than any handle ever returned for
+         * them. Useful after a large amount of data was removed, such as
+         * when a big view got closed. The operation is done with a
+         * @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is
+         * @ref capacity().
+         * @see @ref AbstractUserInterface::trim()
+         */
+        void trim();
+
+        /**
+         * @brief Reserve the data storage
+         * @m_since_latest
+         *
+         * Reserves memory for the internal data storage to fit at least
+         * @p capacity items without reallocation and delegates to
+         * @ref doReserve(), where the implementation is expected to reserve
+         * its own storage as well. Expects that @p capacity is at most
+         * 1048576. Doesn't change @ref capacity(), which grows only when
+         * data are actually created. Useful before creating a large amount of
+         * data at once so the storage is allocated only once.
+         * @see @ref AbstractUserInterface::reserveNodes(),
+         *      @ref setFixedCapacity()
+         */
+        void reserve(std::size_t capacity);
+
+        /**
+         * @brief Fixed data capacity
+         * @m_since_latest
+         *
+         * If @cpp 0 @ce, the data storage grows as needed.
+         * @see @ref setFixedCapacity()
+         */
+        std::size_t fixedCapacity() const;
+
+        /**
+         * @brief Set a fixed data capacity
+         * @m_since_latest
+         *
+         * Reserves the data storage for @p capacity items with
+         * @ref reserve() and makes @ref create() never grow it past that.
+         * Creating data when the storage is full is an error, check
+         * @ref isFull() to handle the condition gracefully. While the
+         * capacity is fixed, @ref trim() does nothing. Expects that
+         * @p capacity is at most 1048576 and not less than @ref capacity().
+         * Passing @cpp 0 @ce makes the storage grow as needed again.
+         * @see @ref AbstractUserInterface::setFixedNodeCapacity()
+         */
+        void setFixedCapacity(std::size_t capacity);
+
+        /**
+         * @brief Whether the data storage is full
+         * @m_since_latest
+         *
+         * Returns @cpp true @ce if @ref setFixedCapacity() is set, all data
+         * up to it are created and there are no free slots to reuse, i.e.
+         * @ref create() would fail. Unlike @ref usedCount(), the operation is
+         * done in a @f$ \mathcal{O}(1) @f$ complexity. Always returns
+         * @cpp false @ce if the capacity isn't fixed.
+         */
+        bool isFull() const;
+
         /**
          * @brief Whether a data handle is valid
          *
@@ -556,7 +831,8 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          * @p nodeHandleGenerations contains handle generation counters for all
          * nodes, where the index is implicitly the handle ID. They're used to
          * decide about node attachment validity, data with invalid node
-         * attachments are then removed. Delegates to @ref doClean(), see its
+         * attachments are then removed. Delegates to @ref doCleanSparse(),
+         * which by default delegates to @ref doClean(), see their
          * documentation for more information about the arguments.
          */
         void cleanNodes(const Containers::StridedArrayView1D<const UnsignedShort>& nodeHandleGenerations);
@@ -658,6 +934,20 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         void update(LayerStates state, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes);
 
+        /**
+         * @brief Finish an update of visible layer data
+         *
+         * Used internally from @ref AbstractUserInterface::update(). Exposed
+         * just for testing purposes, there should be no need to call this
+         * function directly. Expects that the layer supports
+         * @ref LayerFeature::ConcurrentUpdate and that @p state isn't
+         * empty. The @p state is expected to be the same as passed to the
+         * preceding @ref update() call. Delegates to @ref doPostUpdate(), see
+         * its documentation for more information.
+         * @see @ref features()
+         */
+        void postUpdate(LayerStates state);
+
         /**
          * @brief Composite previously rendered contents
          *
@@ -691,6 +981,19 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         void draw(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t offset, std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, std::size_t clipRectOffset, std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes);
 
+        /**
+         * @brief Draw depth of opaque parts of a sub-range of visible layer data
+         *
+         * Used internally from @ref AbstractUserInterface::draw(). Exposed
+         * just for testing purposes, there should be no need to call this
+         * function directly. Expects that the layer supports
+         * @ref LayerFeature::DrawOpaque and the arguments satisfy the same
+         * constraints as in @ref draw(). Delegates to @ref doDrawOpaque(),
+         * see its documentation for more information about the arguments.
+         * @see @ref features()
+         */
+        void drawOpaque(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t offset, std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, std::size_t clipRectOffset, std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes);
+
         /**
          * @brief Handle a pointer press event
          *
@@ -902,6 +1205,147 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         void visibilityLostEvent(UnsignedInt dataId, VisibilityLostEvent& event);
 
+        /**
+         * @brief Handle a pointer press event on multiple data
+         * @m_since_latest
+         *
+         * Used internally from @ref AbstractUserInterface::pointerPressEvent()
+         * if the layer advertises @ref LayerFeature::EventBatch. Exposed just
+         * for testing purposes, there should be no need to call this function
+         * directly. Expects that the layer supports @ref LayerFeature::Event
+         * and all @p dataIds are less than @ref capacity(), with the
+         * assumption that the IDs point to valid data attached to the same
+         * node and @ref PointerEvent::position() is relative to that node. The
+         * event is expected to not be accepted yet. Delegates to
+         * @ref doPointerPressEvents(), see its documentation for more
+         * information.
+         * @see @ref pointerPressEvent()
+         */
+        void pointerPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event);
+
+        /**
+         * @brief Handle a pointer release event on multiple data
+         * @m_since_latest
+         *
+         * Used internally from
+         * @ref AbstractUserInterface::pointerReleaseEvent() if the layer
+         * advertises @ref LayerFeature::EventBatch. Exposed just for testing
+         * purposes, there should be no need to call this function directly.
+         * Expects that the layer supports @ref LayerFeature::Event and all
+         * @p dataIds are less than @ref capacity(), with the assumption that
+         * the IDs point to valid data attached to the same node and
+         * @ref PointerEvent::position() is relative to that node. The event is
+         * expected to not be accepted yet. Delegates to
+         * @ref doPointerReleaseEvents(), see its documentation for more
+         * information.
+         * @see @ref pointerReleaseEvent()
+         */
+        void pointerReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event);
+
+        /**
+         * @brief Handle a pointer move event on multiple data
+         * @m_since_latest
+         *
+         * Used internally from @ref AbstractUserInterface::pointerMoveEvent()
+         * if the layer advertises @ref LayerFeature::EventBatch. Exposed just
+         * for testing purposes, there should be no need to call this function
+         * directly. Expects that the layer supports @ref LayerFeature::Event
+         * and all @p dataIds are less than @ref capacity(), with the
+         * assumption that the IDs point to valid data attached to the same
+         * node and @ref PointerMoveEvent::position() is relative to that node.
+         * The event is expected to not be accepted yet. Delegates to
+         * @ref doPointerMoveEvents(), see its documentation for more
+         * information.
+         * @see @ref pointerMoveEvent()
+         */
+        void pointerMoveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event);
+
+        /**
+         * @brief Handle a pointer enter event on multiple data
+         * @m_since_latest
+         *
+         * Used internally from @ref AbstractUserInterface::pointerMoveEvent()
+         * if the layer advertises @ref LayerFeature::EventBatch. Exposed just
+         * for testing purposes, there should be no need to call this function
+         * directly. Expects that the layer supports @ref LayerFeature::Event
+         * and all @p dataIds are less than @ref capacity(), with the
+         * assumption that the IDs point to valid data attached to the same
+         * node and @ref PointerMoveEvent::position() is relative to that node.
+         * The event is expected to not be accepted yet. Delegates to
+         * @ref doPointerEnterEvents(), see its documentation for more
+         * information.
+         * @see @ref pointerEnterEvent()
+         */
+        void pointerEnterEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event);
+
+        /**
+         * @brief Handle a pointer leave event on multiple data
+         * @m_since_latest
+         *
+         * Used internally from @ref AbstractUserInterface::pointerMoveEvent()
+         * if the layer advertises @ref LayerFeature::EventBatch. Exposed just
+         * for testing purposes, there should be no need to call this function
+         * directly. Expects that the layer supports @ref LayerFeature::Event
+         * and all @p dataIds are less than @ref capacity(), with the
+         * assumption that the IDs point to valid data attached to the same
+         * node and @ref PointerMoveEvent::position() is relative to that node.
+         * The event is expected to not be accepted yet. Delegates to
+         * @ref doPointerLeaveEvents(), see its documentation for more
+         * information.
+         * @see @ref pointerLeaveEvent()
+         */
+        void pointerLeaveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event);
+
+        /**
+         * @brief Handle a scroll event on multiple data
+         * @m_since_latest
+         *
+         * Used internally from @ref AbstractUserInterface::scrollEvent() if
+         * the layer advertises @ref LayerFeature::EventBatch. Exposed just for
+         * testing purposes, there should be no need to call this function
+         * directly. Expects that the layer supports @ref LayerFeature::Event
+         * and all @p dataIds are less than @ref capacity(), with the
+         * assumption that the IDs point to valid data attached to the same
+         * node and @ref ScrollEvent::position() is relative to that node. The
+         * event is expected to not be accepted yet. Delegates to
+         * @ref doScrollEvents(), see its documentation for more information.
+         * @see @ref scrollEvent()
+         */
+        void scrollEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, ScrollEvent& event);
+
+        /**
+         * @brief Handle a key press event on multiple data
+         * @m_since_latest
+         *
+         * Used internally from @ref AbstractUserInterface::keyPressEvent() if
+         * the layer advertises @ref LayerFeature::EventBatch. Exposed just for
+         * testing purposes, there should be no need to call this function
+         * directly. Expects that the layer supports @ref LayerFeature::Event
+         * and all @p dataIds are less than @ref capacity(), with the
+         * assumption that the IDs point to valid data attached to the same
+         * node. The event is expected to not be accepted yet. Delegates to
+         * @ref doKeyPressEvents(), see its documentation for more information.
+         * @see @ref keyPressEvent()
+         */
+        void keyPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event);
+
+        /**
+         * @brief Handle a key release event on multiple data
+         * @m_since_latest
+         *
+         * Used internally from @ref AbstractUserInterface::keyReleaseEvent()
+         * if the layer advertises @ref LayerFeature::EventBatch. Exposed just
+         * for testing purposes, there should be no need to call this function
+         * directly. Expects that the layer supports @ref LayerFeature::Event
+         * and all @p dataIds are less than @ref capacity(), with the
+         * assumption that the IDs point to valid data attached to the same
+         * node. The event is expected to not be accepted yet. Delegates to
+         * @ref doKeyReleaseEvents(), see its documentation for more
+         * information.
+         * @see @ref keyReleaseEvent()
+         */
+        void keyReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event);
+
     protected:
         /**
          * @brief Create a data
@@ -1028,10 +1472,31 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         void assignAnimator(AbstractStyleAnimator& animator) const;
 
+        /**
+         * @brief Add to the size of data uploaded to the GPU
+         * @m_since_latest
+         *
+         * Meant to be called by implementations from @ref doUpdate() or
+         * @ref doPostUpdate() with the amount of bytes they sent to the GPU.
+         * Accumulated into @ref uploadedSize(), which is reset at the start
+         * of every @ref update().
+         */
+        void addUploadedSize(std::size_t size);
+
     private:
         /** @brief Implementation for @ref features() */
         virtual LayerFeatures doFeatures() const = 0;
 
+        /**
+         * @brief Implementation for @ref events()
+         * @m_since_latest
+         *
+         * Called only if @ref LayerFeature::Event is supported. The returned
+         * value is expected to stay the same for the whole layer lifetime.
+         * Default implementation returns all @ref LayerEvent values.
+         */
+        virtual LayerEvents doEvents() const;
+
         /**
          * @brief Query layer state
          *
@@ -1049,6 +1514,56 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         virtual LayerStates doState() const;
 
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * Implementation for @ref memoryUsage(). The implementation is
+         * expected to report memory used by its own internal state, the
+         * internal data storage of the base class is already accounted for.
+         * Implementations that are further subclassed are expected to make
+         * this function protected so the subclasses can add their own usage
+         * to it.
+         *
+         * Default implementation returns all values zero.
+         */
+        virtual MemoryUsage doMemoryUsage() const;
+
+        /**
+         * @brief Trim the data storage
+         * @param capacity      New capacity
+         * @m_since_latest
+         *
+         * Implementation for @ref trim(), called after the internal data
+         * storage of the base class is shrunk. The @p capacity is the new
+         * value of @ref capacity() and is guaranteed to be not larger than
+         * the capacity before, with all data IDs at and after @p capacity
+         * being free. The implementation is expected to shrink its own
+         * storage indexed by data IDs to at most @p capacity items and
+         * release any memory reserved for future growth. Implementations
+         * that are further subclassed are expected to make this function
+         * protected so the subclasses can chain to it.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doTrim(std::size_t capacity);
+
+        /**
+         * @brief Reserve the data storage
+         * @param capacity      Capacity to reserve
+         * @m_since_latest
+         *
+         * Implementation for @ref reserve(), called after the internal data
+         * storage of the base class is reserved. The implementation is
+         * expected to reserve its own storage indexed by data IDs to fit at
+         * least @p capacity items. Implementations that are further
+         * subclassed are expected to make this function protected so the
+         * subclasses can chain to it.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doReserve(std::size_t capacity);
+
         /**
          * @brief Set user interface size
          * @param size              Size of the user interface to which
@@ -1087,10 +1602,32 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          * This function may get also called with @p dataIdsToRemove having all
          * bits zero.
          *
-         * Default implementation does nothing.
+         * Called from the default implementation of @ref doCleanSparse(),
+         * not called at all if @ref doCleanSparse() is overridden. Default
+         * implementation does nothing.
          */
         virtual void doClean(Containers::BitArrayView dataIdsToRemove);
 
+        /**
+         * @brief Clean no longer valid layer data, with a list of their IDs
+         * @param dataIdsToRemove   Data IDs to remove
+         * @param dataIds           The same data IDs in a compact list
+         * @m_since_latest
+         *
+         * Implementation for @ref cleanNodes(). The @p dataIdsToRemove view
+         * is the same as in @ref doClean(), @p dataIds contains the data IDs
+         * that have a bit set in @p dataIdsToRemove, in an ascending order.
+         * Compared to going through all bits of @p dataIdsToRemove, the cost
+         * of iterating @p dataIds is proportional only to the count of
+         * actually removed data, which makes a difference for layers with a
+         * large @ref capacity() when just a few nodes get removed.
+         *
+         * This function may get also called with @p dataIds being empty.
+         *
+         * Default implementation delegates to @ref doClean().
+         */
+        virtual void doCleanSparse(Containers::BitArrayView dataIdsToRemove, Containers::ArrayView<const UnsignedInt> dataIds);
+
         /**
          * @brief Advance data animations in animators assigned to this layer
          * @param[in] time                  Time to which to advance
@@ -1207,6 +1744,8 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          *
          * The @p state is guaranteed to be a subset of
          * @ref LayerState::NeedsNodeOffsetSizeUpdate,
+         * @relativeref{LayerState,NeedsNodeTranslationUpdate} (if
+         * @ref LayerFeature::NodeTranslation is supported),
          * @relativeref{LayerState,NeedsNodeOrderUpdate},
          * @relativeref{LayerState,NeedsNodeEnabledUpdate},
          * @relativeref{LayerState,NeedsDataUpdate},
@@ -1269,6 +1808,25 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         virtual void doUpdate(LayerStates state, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes);
 
+        /**
+         * @brief Finish an update of visible layer data
+         * @param state             Same state as was passed to the preceding
+         *      @ref doUpdate() call
+         *
+         * Implementation for @ref postUpdate(), which is called from
+         * @ref AbstractUserInterface::update(). Called only if
+         * @ref LayerFeature::ConcurrentUpdate is supported, always after
+         * @ref doUpdate() and always on the thread the user interface is
+         * updated on, even if @ref doUpdate() was called from a different
+         * thread. Meant to be used for uploading data calculated in
+         * @ref doUpdate() to the GPU or for other operations that cannot be
+         * done concurrently. The @ref LayerState::NeedsAttachmentUpdate flag
+         * isn't passed through, same as with @ref doUpdate().
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doPostUpdate(LayerStates state);
+
         /**
          * @brief Composite previously rendered contents
          * @param renderer          Renderer instance containing the previously
@@ -1365,6 +1923,38 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         virtual void doDraw(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t offset, std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, std::size_t clipRectOffset, std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes);
 
+        /**
+         * @brief Draw depth of opaque parts of a sub-range of visible layer data
+         *
+         * Implementation for @ref drawOpaque(), which is called from
+         * @ref AbstractUserInterface::draw(). Called only if
+         * @ref LayerFeature::DrawOpaque is supported and the renderer
+         * supports @ref RendererFeature::DepthBuffer, with the arguments
+         * having the same meaning and guarantees as in @ref doDraw(). The
+         * implementation is expected to draw only areas that are guaranteed
+         * to be fully covered by opaque content in the subsequent
+         * @ref doDraw() call with the same arguments, such as interiors of
+         * rectangles without translucent pixels. No color is written, only
+         * depth, which is supplied by the renderer. Anything drawn here that
+         * isn't opaque in @ref doDraw() would hide contents underneath. The
+         * renderer is transitioned to @ref RendererDrawState::DepthTest and
+         * @relativeref{RendererDrawState,DepthPrepass} alone regardless of
+         * whether the layer advertises @ref LayerFeature::DrawUsesBlending or
+         * @relativeref{LayerFeature,DrawUsesScissor}, so the implementation
+         * is expected to restrict the drawn areas to @p clipRectOffsets and
+         * @p clipRectSizes on its own.
+         *
+         * For each top-level node, this function is called *before* all
+         * @ref doDraw() calls, with top-level nodes visited front-to-back,
+         * i.e. in reverse order compared to @ref doDraw(). If any layer
+         * advertises @ref LayerFeature::Composite, the front-to-back pass
+         * covers only draws until the next compositing layer draw, so the
+         * compositing operation always sees everything that was drawn before
+         * it. Default implementation asserts as the feature is expected to be
+         * implemented if advertised.
+         */
+        virtual void doDrawOpaque(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t offset, std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, std::size_t clipRectOffset, std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes);
+
         /**
          * @brief Handle a pointer press event
          * @param dataId            Data ID the event happens on. Guaranteed to
@@ -1713,6 +2303,102 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         virtual void doVisibilityLostEvent(UnsignedInt dataId, VisibilityLostEvent& event);
 
+        /**
+         * @brief Handle a pointer press event on multiple data
+         * @param dataIds           Data IDs the event happens on, all
+         *      attached to the same node. Guaranteed to be less than
+         *      @ref capacity() and point to valid data.
+         * @param event             Event data, with
+         *      @ref PointerEvent::position() relative to the node to which the
+         *      data are attached.
+         * @m_since_latest
+         *
+         * Implementation for @ref pointerPressEvents(), which is called from
+         * @ref AbstractUserInterface::pointerPressEvent() instead of
+         * @ref pointerPressEvent() if the layer advertises
+         * @ref LayerFeature::EventBatch. The @p event is treated as accepted
+         * if it's accepted by any of the data, see @ref doPointerPressEvent()
+         * for more information about the event semantics.
+         *
+         * Default implementation calls @ref doPointerPressEvent() for each
+         * item in @p dataIds, resetting the accept status before each call,
+         * and marks the @p event as accepted at the end if any of the calls
+         * accepted it. Unlike with the per-data dispatch done by
+         * @ref AbstractUserInterface, pointer capture changes from calls that
+         * didn't accept the event are not reset.
+         */
+        virtual void doPointerPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event);
+
+        /**
+         * @brief Handle a pointer release event on multiple data
+         * @m_since_latest
+         *
+         * Implementation for @ref pointerReleaseEvents(). Default
+         * implementation calls @ref doPointerReleaseEvent() for each item in
+         * @p dataIds, see @ref doPointerPressEvents() for more information.
+         */
+        virtual void doPointerReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event);
+
+        /**
+         * @brief Handle a pointer move event on multiple data
+         * @m_since_latest
+         *
+         * Implementation for @ref pointerMoveEvents(). Default implementation
+         * calls @ref doPointerMoveEvent() for each item in @p dataIds, see
+         * @ref doPointerPressEvents() for more information.
+         */
+        virtual void doPointerMoveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event);
+
+        /**
+         * @brief Handle a pointer enter event on multiple data
+         * @m_since_latest
+         *
+         * Implementation for @ref pointerEnterEvents(). Default implementation
+         * calls @ref doPointerEnterEvent() for each item in @p dataIds, see
+         * @ref doPointerPressEvents() for more information.
+         */
+        virtual void doPointerEnterEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event);
+
+        /**
+         * @brief Handle a pointer leave event on multiple data
+         * @m_since_latest
+         *
+         * Implementation for @ref pointerLeaveEvents(). Default implementation
+         * calls @ref doPointerLeaveEvent() for each item in @p dataIds, see
+         * @ref doPointerPressEvents() for more information.
+         */
+        virtual void doPointerLeaveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event);
+
+        /**
+         * @brief Handle a scroll event on multiple data
+         * @m_since_latest
+         *
+         * Implementation for @ref scrollEvents(). Default implementation calls
+         * @ref doScrollEvent() for each item in @p dataIds, see
+         * @ref doPointerPressEvents() for more information.
+         */
+        virtual void doScrollEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, ScrollEvent& event);
+
+        /**
+         * @brief Handle a key press event on multiple data
+         * @m_since_latest
+         *
+         * Implementation for @ref keyPressEvents(). Default implementation
+         * calls @ref doKeyPressEvent() for each item in @p dataIds, see
+         * @ref doPointerPressEvents() for more information.
+         */
+        virtual void doKeyPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event);
+
+        /**
+         * @brief Handle a key release event on multiple data
+         * @m_since_latest
+         *
+         * Implementation for @ref keyReleaseEvents(). Default implementation
+         * calls @ref doKeyReleaseEvent() for each item in @p dataIds, see
+         * @ref doPointerPressEvents() for more information.
+         */
+        virtual void doKeyReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event);
+
         /* Common implementations for foo(DataHandle, ...) and
            foo(LayerDataHandle, ...) */
         MAGNUM_UI_LOCAL void attachInternal(UnsignedInt id, NodeHandle node);
@@ -34,6 +34,8 @@
 #include <Magnum/Math/Vector2.h>
 
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
+#include "Magnum/Ui/Implementation/trace.h"
 
 namespace Magnum { namespace Ui {
 
@@ -60,6 +62,26 @@ Debug& operator<<(Debug& debug, const LayouterStates value) {
     });
 }
 
+Debug& operator<<(Debug& debug, const LayouterFeature value) {
+    debug << "Ui::LayouterFeature" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case LayouterFeature::value: return debug << "::" #value;
+        _c(ConcurrentUpdate)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+}
+
+Debug& operator<<(Debug& debug, const LayouterFeatures value) {
+    return Containers::enumSetDebugOutput(debug, value, "Ui::LayouterFeatures{}", {
+        LayouterFeature::ConcurrentUpdate
+    });
+}
+
 namespace {
 
 union Layout {
@@ -143,6 +165,8 @@ LayouterHandle AbstractLayouter::handle() const {
     return _state->handle;
 }
 
+LayouterFeatures AbstractLayouter::doFeatures() const { return {}; }
+
 LayouterStates AbstractLayouter::state() const {
     return _state->state;
 }
@@ -168,6 +192,16 @@ std::size_t AbstractLayouter::usedCount() const {
     return state.layouts.size() - free;
 }
 
+MemoryUsage AbstractLayouter::memoryUsage() const {
+    const State& state = *_state;
+    MemoryUsage out = doMemoryUsage();
+    Implementation::addArrayMemoryUsage(out, state.layouts);
+    out.cpuUnused += (state.layouts.size() - usedCount())*sizeof(Layout);
+    return out;
+}
+
+MemoryUsage AbstractLayouter::doMemoryUsage() const { return {}; }
+
 bool AbstractLayouter::isHandleValid(const LayouterDataHandle handle) const {
     if(handle == LayouterDataHandle::Null)
         return false;
@@ -346,6 +380,7 @@ void AbstractLayouter::cleanNodes(const Containers::StridedArrayView1D<const Uns
 void AbstractLayouter::doClean(Containers::BitArrayView) {}
 
 void AbstractLayouter::update(const Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>& topLevelLayoutIds, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractLayouter::update()");
     CORRADE_ASSERT(layoutIdsToUpdate.size() == capacity(),
         "Ui::AbstractLayouter::update(): expected layoutIdsToUpdate to have" << capacity() << "bits but got" << layoutIdsToUpdate.size(), );
     CORRADE_ASSERT(nodeOffsets.size() == nodeParents.size() && nodeSizes.size() == nodeParents.size(),
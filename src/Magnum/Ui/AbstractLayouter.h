@@ -34,6 +34,7 @@
 #include <Corrade/Containers/Pointer.h>
 #include <Magnum/Magnum.h>
 
+#include "Magnum/Ui/MemoryUsage.h"
 #include "Magnum/Ui/Ui.h"
 #include "Magnum/Ui/visibility.h"
 
@@ -100,6 +101,54 @@ MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, LayouterStates value);
 
 CORRADE_ENUMSET_OPERATORS(LayouterStates)
 
+/**
+@brief Features supported by a layouter
+@m_since_latest
+
+@see @ref LayouterFeatures, @ref AbstractLayouter::features()
+*/
+enum class LayouterFeature: UnsignedByte {
+    /**
+     * @ref AbstractLayouter::update() can be executed concurrently with
+     * updates of other layouters that advertise this feature. If advertised
+     * and @ref AbstractUserInterface::setUpdateExecutor() is set,
+     * @ref AbstractLayouter::update() may get called from a different thread
+     * than the one the user interface is updated on, in parallel with updates
+     * of other layouters that calculate layouts of the same dependency level.
+     * The node sets passed to such concurrent calls are disjoint, the
+     * implementation is however expected to only modify its own internal
+     * state and the offsets and sizes of nodes in the passed layout
+     * hierarchies in @ref AbstractLayouter::doUpdate(), and treat any state
+     * shared with other layouters as read-only.
+     *
+     * A single layouter instance is never updated from more than one thread
+     * at a time.
+     */
+    ConcurrentUpdate = 1 << 0,
+};
+
+/**
+@debugoperatorenum{LayouterFeature}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, LayouterFeature value);
+
+/**
+@brief Set of features supported by a layouter
+@m_since_latest
+
+@see @ref AbstractLayouter::features()
+*/
+typedef Containers::EnumSet<LayouterFeature> LayouterFeatures;
+
+/**
+@debugoperatorenum{LayouterFeatures}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, LayouterFeatures value);
+
+CORRADE_ENUMSET_OPERATORS(LayouterFeatures)
+
 /**
 @brief Base for layouters
 @m_since_latest
@@ -139,6 +188,16 @@ class MAGNUM_UI_EXPORT AbstractLayouter {
          */
         LayouterHandle handle() const;
 
+        /**
+         * @brief Features supported by a layouter
+         * @m_since_latest
+         *
+         * Delegates to @ref doFeatures(). The returned set is queried only
+         * once in @ref AbstractUserInterface::setLayouterInstance() and is
+         * expected to stay the same for the whole layouter lifetime.
+         */
+        LayouterFeatures features() const { return doFeatures(); }
+
         /**
          * @brief Layouter state
          *
@@ -174,6 +233,19 @@ class MAGNUM_UI_EXPORT AbstractLayouter {
          */
         std::size_t usedCount() const;
 
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * Sum of the memory used by the internal layout storage and what's
+         * returned from @ref doMemoryUsage(). Free slots of the layout storage
+         * are counted in @ref MemoryUsage::cpuUnused. The operation is done
+         * with a @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is
+         * @ref capacity().
+         * @see @ref AbstractUserInterface::memoryUsage()
+         */
+        MemoryUsage memoryUsage() const;
+
         /**
          * @brief Whether a layout handle is valid
          *
@@ -358,6 +430,26 @@ class MAGNUM_UI_EXPORT AbstractLayouter {
         void remove(LayouterDataHandle handle);
 
     private:
+        /**
+         * @brief Implementation for @ref features()
+         * @m_since_latest
+         *
+         * Default implementation returns an empty set.
+         */
+        virtual LayouterFeatures doFeatures() const;
+
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * Implementation for @ref memoryUsage(). The implementation is
+         * expected to report memory used by its own internal state, the
+         * internal layout storage of the base class is already accounted for.
+         *
+         * Default implementation returns all values zero.
+         */
+        virtual MemoryUsage doMemoryUsage() const;
+
         /**
          * @brief Set user interface size
          * @param size              Size of the user interface to which
@@ -462,6 +554,18 @@ class MAGNUM_UI_EXPORT AbstractLayouter {
          * @p topLevelLayoutIds being empty, for example when
          * @ref setNeedsUpdate() was called but the layouter doesn't have any
          * layouts currently visible.
+         *
+         * @m_since_latest If only offsets or sizes of non-root nodes changed
+         * since the last update and the layouter itself doesn't have
+         * @ref LayouterState::NeedsUpdate set, @p layoutIdsToUpdate and
+         * @p topLevelLayoutIds contain only layouts assigned to nodes in
+         * hierarchies of the root nodes that contain the changed nodes.
+         *
+         * @attention This is a contract that layouter implementations have to
+         *      follow --- a layout is expected to be calculated only from
+         *      nodes in the same root node hierarchy. A layout that depends on
+         *      nodes from a different root node hierarchy may not get updated
+         *      when those change.
          */
         virtual void doUpdate(Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>& topLevelLayoutIds, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) = 0;
 
@@ -28,7 +28,9 @@
 
 #include <Corrade/Containers/EnumSet.hpp>
 #include <Corrade/Utility/Assert.h>
-#include <Magnum/Math/Vector2.h>
+#include <Magnum/Math/Range.h>
+
+#include "Magnum/Ui/Handle.h"
 
 namespace Magnum { namespace Ui {
 
@@ -39,6 +41,10 @@ Debug& operator<<(Debug& debug, const RendererFeature value) {
         /* LCOV_EXCL_START */
         #define _c(value) case RendererFeature::value: return debug << "::" #value;
         _c(Composite)
+        _c(PartialRedraw)
+        _c(LayerProfiling)
+        _c(DepthBuffer)
+        _c(DrawCache)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -48,7 +54,11 @@ Debug& operator<<(Debug& debug, const RendererFeature value) {
 
 Debug& operator<<(Debug& debug, const RendererFeatures value) {
     return Containers::enumSetDebugOutput(debug, value, "Ui::RendererFeatures{}", {
-        RendererFeature::Composite
+        RendererFeature::Composite,
+        RendererFeature::PartialRedraw,
+        RendererFeature::LayerProfiling,
+        RendererFeature::DepthBuffer,
+        RendererFeature::DrawCache
     });
 }
 
@@ -77,6 +87,8 @@ Debug& operator<<(Debug& debug, const RendererDrawState value) {
         #define _c(value) case RendererDrawState::value: return debug << "::" #value;
         _c(Blending)
         _c(Scissor)
+        _c(DepthTest)
+        _c(DepthPrepass)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -87,14 +99,20 @@ Debug& operator<<(Debug& debug, const RendererDrawState value) {
 Debug& operator<<(Debug& debug, const RendererDrawStates value) {
     return Containers::enumSetDebugOutput(debug, value, "Ui::RendererDrawStates{}", {
         RendererDrawState::Blending,
-        RendererDrawState::Scissor
+        RendererDrawState::Scissor,
+        RendererDrawState::DepthTest,
+        RendererDrawState::DepthPrepass
     });
 }
 
 struct AbstractRenderer::State {
     Vector2i framebufferSize;
+    Range2Di redrawRect;
     RendererTargetState currentTargetState = RendererTargetState::Initial;
     RendererDrawStates currentDrawStates;
+    LayerHandle currentProfiledLayer = LayerHandle::Null;
+    Float drawDepth = 1.0f;
+    UnsignedInt currentCache = ~UnsignedInt{};
 };
 
 AbstractRenderer::AbstractRenderer(): _state{InPlaceInit} {}
@@ -117,6 +135,21 @@ RendererDrawStates AbstractRenderer::currentDrawStates() const {
     return _state->currentDrawStates;
 }
 
+Range2Di AbstractRenderer::redrawRect() const {
+    return _state->redrawRect;
+}
+
+void AbstractRenderer::setRedrawRect(const Range2Di& rect) {
+    State& state = *_state;
+    CORRADE_ASSERT(features() & RendererFeature::PartialRedraw,
+        "Ui::AbstractRenderer::setRedrawRect(): partial redraw not supported", );
+    CORRADE_ASSERT(state.currentTargetState == RendererTargetState::Initial,
+        "Ui::AbstractRenderer::setRedrawRect(): not allowed to be called in" << state.currentTargetState, );
+    CORRADE_ASSERT((rect.min() >= Vector2i{}).all() && (rect.max() <= state.framebufferSize).all() && (rect.min() <= rect.max()).all(),
+        "Ui::AbstractRenderer::setRedrawRect():" << Debug::packed << rect << "out of range for a framebuffer of size" << Debug::packed << state.framebufferSize, );
+    state.redrawRect = rect;
+}
+
 void AbstractRenderer::setupFramebuffers(const Vector2i& size) {
     State& state = *_state;
     CORRADE_ASSERT(size.product(),
@@ -124,6 +157,7 @@ void AbstractRenderer::setupFramebuffers(const Vector2i& size) {
     CORRADE_ASSERT(state.currentTargetState == RendererTargetState::Initial || state.currentTargetState == RendererTargetState::Final,
         "Ui::AbstractRenderer::setupFramebuffers(): not allowed to be called in" << state.currentTargetState, );
     state.framebufferSize = size;
+    state.redrawRect = {{}, size};
     doSetupFramebuffers(size);
 }
 
@@ -147,6 +181,21 @@ void AbstractRenderer::transition(RendererTargetState targetState, RendererDrawS
         "Ui::AbstractRenderer::transition(): invalid transition from" << state.currentTargetState << "to" << targetState, );
     CORRADE_ASSERT((targetState != RendererTargetState::Initial && targetState != RendererTargetState::Composite && targetState != RendererTargetState::Final) || !drawStates,
         "Ui::AbstractRenderer::transition(): invalid" << drawStates << "in a transition to" << targetState, );
+    CORRADE_ASSERT(!(drawStates & (RendererDrawState::DepthTest|RendererDrawState::DepthPrepass)) || features() & RendererFeature::DepthBuffer,
+        "Ui::AbstractRenderer::transition():" << (drawStates & (RendererDrawState::DepthTest|RendererDrawState::DepthPrepass)) << "not supported", );
+    CORRADE_ASSERT(!(drawStates & RendererDrawState::DepthPrepass) || drawStates & RendererDrawState::DepthTest,
+        "Ui::AbstractRenderer::transition():" << RendererDrawState::DepthPrepass << "expected to be used together with" << RendererDrawState::DepthTest, );
+    CORRADE_ASSERT(state.currentProfiledLayer == LayerHandle::Null,
+        "Ui::AbstractRenderer::transition(): not allowed to be called while" << state.currentProfiledLayer << "is being profiled", );
+    CORRADE_ASSERT(state.currentCache == ~UnsignedInt{} || targetState == RendererTargetState::Draw,
+        "Ui::AbstractRenderer::transition(): transition to" << targetState << "not allowed while rendering cache" << state.currentCache, );
+
+    /* Each draw starts with the whole framebuffer being redrawn, unless
+       restricted by setRedrawRect() again */
+    if(targetState == RendererTargetState::Initial) {
+        state.redrawRect = {{}, state.framebufferSize};
+        state.drawDepth = 1.0f;
+    }
 
     if(targetState != state.currentTargetState ||
        drawStates != state.currentDrawStates) {
@@ -156,4 +205,122 @@ void AbstractRenderer::transition(RendererTargetState targetState, RendererDrawS
     }
 }
 
+Float AbstractRenderer::drawDepth() const {
+    return _state->drawDepth;
+}
+
+void AbstractRenderer::setDrawDepth(const Float depth) {
+    State& state = *_state;
+    CORRADE_ASSERT(features() & RendererFeature::DepthBuffer,
+        "Ui::AbstractRenderer::setDrawDepth(): depth buffer not supported", );
+    CORRADE_ASSERT(state.currentTargetState == RendererTargetState::Draw,
+        "Ui::AbstractRenderer::setDrawDepth(): not allowed to be called in" << state.currentTargetState, );
+    CORRADE_ASSERT(depth >= 0.0f && depth <= 1.0f,
+        "Ui::AbstractRenderer::setDrawDepth(): expected a value in the [0, 1] range, got" << depth, );
+    state.drawDepth = depth;
+    doSetDrawDepth(depth);
+}
+
+void AbstractRenderer::doSetDrawDepth(Float) {
+    CORRADE_ASSERT_UNREACHABLE("Ui::AbstractRenderer::setDrawDepth(): feature advertised but not implemented", );
+}
+
+LayerHandle AbstractRenderer::currentProfiledLayer() const {
+    return _state->currentProfiledLayer;
+}
+
+void AbstractRenderer::beginLayerProfile(const LayerHandle layer) {
+    State& state = *_state;
+    CORRADE_ASSERT(features() & RendererFeature::LayerProfiling,
+        "Ui::AbstractRenderer::beginLayerProfile(): layer profiling not supported", );
+    CORRADE_ASSERT(layer != LayerHandle::Null,
+        "Ui::AbstractRenderer::beginLayerProfile(): expected a non-null layer", );
+    CORRADE_ASSERT(state.currentTargetState == RendererTargetState::Draw || state.currentTargetState == RendererTargetState::Composite,
+        "Ui::AbstractRenderer::beginLayerProfile(): not allowed to be called in" << state.currentTargetState, );
+    CORRADE_ASSERT(state.currentProfiledLayer == LayerHandle::Null,
+        "Ui::AbstractRenderer::beginLayerProfile():" << state.currentProfiledLayer << "is already being profiled", );
+    state.currentProfiledLayer = layer;
+    doBeginLayerProfile(layer);
+}
+
+void AbstractRenderer::doBeginLayerProfile(LayerHandle) {
+    CORRADE_ASSERT_UNREACHABLE("Ui::AbstractRenderer::beginLayerProfile(): feature advertised but not implemented", );
+}
+
+void AbstractRenderer::endLayerProfile() {
+    State& state = *_state;
+    CORRADE_ASSERT(state.currentProfiledLayer != LayerHandle::Null,
+        "Ui::AbstractRenderer::endLayerProfile(): no layer is being profiled", );
+    const LayerHandle layer = state.currentProfiledLayer;
+    state.currentProfiledLayer = LayerHandle::Null;
+    doEndLayerProfile(layer);
+}
+
+void AbstractRenderer::doEndLayerProfile(LayerHandle) {
+    CORRADE_ASSERT_UNREACHABLE("Ui::AbstractRenderer::endLayerProfile(): feature advertised but not implemented", );
+}
+
+UnsignedInt AbstractRenderer::currentCache() const {
+    return _state->currentCache;
+}
+
+void AbstractRenderer::beginCache(const UnsignedInt id, const Range2Di& rect) {
+    State& state = *_state;
+    CORRADE_ASSERT(features() & RendererFeature::DrawCache,
+        "Ui::AbstractRenderer::beginCache(): draw cache not supported", );
+    CORRADE_ASSERT(state.currentTargetState == RendererTargetState::Draw,
+        "Ui::AbstractRenderer::beginCache(): not allowed to be called in" << state.currentTargetState, );
+    CORRADE_ASSERT(state.currentCache == ~UnsignedInt{},
+        "Ui::AbstractRenderer::beginCache(): cache" << state.currentCache << "is already being rendered", );
+    CORRADE_ASSERT((rect.min() >= Vector2i{}).all() && (rect.max() <= state.framebufferSize).all() && (rect.min() <= rect.max()).all(),
+        "Ui::AbstractRenderer::beginCache():" << Debug::packed << rect << "out of range for a framebuffer of size" << Debug::packed << state.framebufferSize, );
+    state.currentCache = id;
+    doBeginCache(id, rect);
+}
+
+void AbstractRenderer::doBeginCache(UnsignedInt, const Range2Di&) {
+    CORRADE_ASSERT_UNREACHABLE("Ui::AbstractRenderer::beginCache(): feature advertised but not implemented", );
+}
+
+void AbstractRenderer::endCache() {
+    State& state = *_state;
+    CORRADE_ASSERT(state.currentCache != ~UnsignedInt{},
+        "Ui::AbstractRenderer::endCache(): no cache is being rendered", );
+    const UnsignedInt id = state.currentCache;
+    state.currentCache = ~UnsignedInt{};
+    doEndCache(id);
+}
+
+void AbstractRenderer::doEndCache(UnsignedInt) {
+    CORRADE_ASSERT_UNREACHABLE("Ui::AbstractRenderer::endCache(): feature advertised but not implemented", );
+}
+
+void AbstractRenderer::drawCache(const UnsignedInt id) {
+    State& state = *_state;
+    CORRADE_ASSERT(features() & RendererFeature::DrawCache,
+        "Ui::AbstractRenderer::drawCache(): draw cache not supported", );
+    CORRADE_ASSERT(state.currentTargetState == RendererTargetState::Draw,
+        "Ui::AbstractRenderer::drawCache(): not allowed to be called in" << state.currentTargetState, );
+    CORRADE_ASSERT(state.currentCache == ~UnsignedInt{},
+        "Ui::AbstractRenderer::drawCache(): not allowed to be called while rendering cache" << state.currentCache, );
+    doDrawCache(id);
+}
+
+void AbstractRenderer::doDrawCache(UnsignedInt) {
+    CORRADE_ASSERT_UNREACHABLE("Ui::AbstractRenderer::drawCache(): feature advertised but not implemented", );
+}
+
+void AbstractRenderer::discardCache(const UnsignedInt id) {
+    State& state = *_state;
+    CORRADE_ASSERT(features() & RendererFeature::DrawCache,
+        "Ui::AbstractRenderer::discardCache(): draw cache not supported", );
+    CORRADE_ASSERT(state.currentCache != id,
+        "Ui::AbstractRenderer::discardCache(): cache" << id << "is being rendered", );
+    doDiscardCache(id);
+}
+
+void AbstractRenderer::doDiscardCache(UnsignedInt) {
+    CORRADE_ASSERT_UNREACHABLE("Ui::AbstractRenderer::discardCache(): feature advertised but not implemented", );
+}
+
 }}
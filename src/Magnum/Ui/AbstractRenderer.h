@@ -55,6 +55,55 @@ enum class RendererFeature {
      * @ref RendererTargetState::Composite.
      */
     Composite = 1 << 0,
+
+    /**
+     * Ability to retain framebuffer contents across
+     * @ref AbstractUserInterface::draw() calls and redraw only a part of it.
+     * If supported, @ref AbstractUserInterface tracks which parts of the UI
+     * changed since the last draw and passes them to
+     * @ref AbstractRenderer::setRedrawRect() before drawing. The renderer is
+     * then expected to clear just the @ref AbstractRenderer::redrawRect() and
+     * restrict all drawing to it, or skip the draw altogether if the rect is
+     * empty.
+     */
+    PartialRedraw = 1 << 1,
+
+    /**
+     * Ability to measure per-layer draw cost. If supported,
+     * @ref AbstractUserInterface::draw() wraps each
+     * @ref AbstractLayer::composite() and @ref AbstractLayer::draw() call in
+     * @ref AbstractRenderer::beginLayerProfile() and
+     * @relativeref{AbstractRenderer,endLayerProfile()}, and the renderer is
+     * then expected to expose the measured results in an
+     * implementation-specific way.
+     */
+    LayerProfiling = 1 << 2,
+
+    /**
+     * Ability to reject occluded fragments with a depth buffer. If supported,
+     * @ref AbstractUserInterface::draw() assigns a depth to each draw with
+     * @ref AbstractRenderer::setDrawDepth(), with later draws being closer
+     * to the viewer, and first draws opaque parts of layers that advertise
+     * @ref LayerFeature::DrawOpaque front-to-back with
+     * @ref RendererDrawState::DepthPrepass. All draws are then done with
+     * @ref RendererDrawState::DepthTest, making the GPU discard fragments
+     * hidden behind opaque content drawn later. The renderer is expected to
+     * clear the depth buffer together with the color contents when
+     * transitioning away from @ref RendererTargetState::Initial.
+     */
+    DepthBuffer = 1 << 3,
+
+    /**
+     * Ability to render a part of the UI into an offscreen cache once and
+     * then draw it from there in subsequent frames. If supported,
+     * @ref AbstractUserInterface::draw() renders draws of top-level node
+     * hierarchies marked with @ref NodeFlag::Cached between
+     * @ref AbstractRenderer::beginCache() and
+     * @relativeref{AbstractRenderer,endCache()} and then draws them with
+     * @ref AbstractRenderer::drawCache(), skipping the layer draws entirely
+     * until anything in the hierarchy changes.
+     */
+    DrawCache = 1 << 4,
 };
 
 /**
@@ -178,7 +227,26 @@ enum class RendererDrawState {
      * @ref LayerFeature::DrawUsesScissor, and disabled again when drawing a
      * layer that doesn't advertise it, or after drawing everything.
      */
-    Scissor = 1 << 1
+    Scissor = 1 << 1,
+
+    /**
+     * Depth test is active. Fragments farther than what's already in the
+     * depth buffer get discarded, with the depth buffer not being written
+     * to. Used only if @ref RendererFeature::DepthBuffer is supported, in
+     * which case it's enabled for all draws, and disabled after drawing
+     * everything.
+     */
+    DepthTest = 1 << 2,
+
+    /**
+     * Depth pre-pass is active. Used only together with
+     * @ref RendererDrawState::DepthTest if @ref RendererFeature::DepthBuffer
+     * is supported. Color writes are disabled and the depth buffer is
+     * written to. Gets enabled when drawing opaque parts of layers that
+     * advertise @ref LayerFeature::DrawOpaque, and disabled again before the
+     * regular draws.
+     */
+    DepthPrepass = 1 << 3
 };
 
 /**
@@ -264,6 +332,35 @@ class MAGNUM_UI_EXPORT AbstractRenderer {
          */
         RendererDrawStates currentDrawStates() const;
 
+        /**
+         * @brief Rectangle to redraw
+         *
+         * In framebuffer pixels, with the origin in the top left corner, same
+         * as @ref AbstractUserInterface. Set to the whole
+         * @ref framebufferSize() in @ref setupFramebuffers() and on every
+         * transition to @ref RendererTargetState::Initial, can be then
+         * restricted with @ref setRedrawRect() before the next transition. An
+         * empty rectangle means nothing is being redrawn.
+         * @see @ref RendererFeature::PartialRedraw
+         */
+        Range2Di redrawRect() const;
+
+        /**
+         * @brief Set the rectangle to redraw
+         *
+         * Used internally from @ref AbstractUserInterface::draw(). Exposed
+         * just for testing purposes, there should be no need to call this
+         * function directly and doing so may cause internal
+         * @ref AbstractUserInterface state update to misbehave. Expects that
+         * @ref RendererFeature::PartialRedraw is supported, that
+         * @ref currentTargetState() is @ref RendererTargetState::Initial and
+         * that @p rect is contained in the @ref framebufferSize(). The
+         * implementation is expected to query the rectangle in
+         * @ref doTransition() when transitioning away from
+         * @ref RendererTargetState::Initial.
+         */
+        void setRedrawRect(const Range2Di& rect);
+
         /**
          * @brief Set up framebuffer properties
          *
@@ -296,6 +393,137 @@ class MAGNUM_UI_EXPORT AbstractRenderer {
          */
         void transition(RendererTargetState targetState, RendererDrawStates drawStates);
 
+        /**
+         * @brief Draw depth
+         *
+         * A value in the @f$ [0, 1] @f$ range, with lower values being closer
+         * to the viewer. Initial state is @cpp 1.0f @ce, reset back to it
+         * on every transition to @ref RendererTargetState::Initial.
+         * @see @ref RendererFeature::DepthBuffer
+         */
+        Float drawDepth() const;
+
+        /**
+         * @brief Set the draw depth
+         *
+         * Used internally from @ref AbstractUserInterface::draw() before each
+         * @ref AbstractLayer::drawOpaque() and @ref AbstractLayer::draw() call
+         * if @ref RendererFeature::DepthBuffer is supported. Exposed just for
+         * testing purposes, there should be no need to call this function
+         * directly. Expects that @ref RendererFeature::DepthBuffer is
+         * supported, that @ref currentTargetState() is
+         * @ref RendererTargetState::Draw and that @p depth is in the
+         * @f$ [0, 1] @f$ range. Delegates to @ref doSetDrawDepth(), see its
+         * documentation for more information.
+         */
+        void setDrawDepth(Float depth);
+
+        /**
+         * @brief Layer being currently profiled
+         *
+         * Set to the handle passed to @ref beginLayerProfile() and reset back
+         * to @ref LayerHandle::Null in @ref endLayerProfile(). Initial state
+         * is @ref LayerHandle::Null.
+         */
+        LayerHandle currentProfiledLayer() const;
+
+        /**
+         * @brief Begin profiling a layer
+         *
+         * Used internally from @ref AbstractUserInterface::draw() before each
+         * @ref AbstractLayer::composite() and @ref AbstractLayer::draw() call
+         * if @ref RendererFeature::LayerProfiling is supported. Exposed just
+         * for testing purposes, there should be no need to call this function
+         * directly. Expects that @ref RendererFeature::LayerProfiling is
+         * supported, that @p layer isn't @ref LayerHandle::Null, that
+         * @ref currentTargetState() is @ref RendererTargetState::Draw or
+         * @relativeref{RendererTargetState,Composite} and that no layer is
+         * being profiled already. Delegates to @ref doBeginLayerProfile(),
+         * see its documentation for more information.
+         */
+        void beginLayerProfile(LayerHandle layer);
+
+        /**
+         * @brief End profiling a layer
+         *
+         * Used internally from @ref AbstractUserInterface::draw() after each
+         * @ref AbstractLayer::composite() and @ref AbstractLayer::draw() call
+         * if @ref RendererFeature::LayerProfiling is supported. Exposed just
+         * for testing purposes, there should be no need to call this function
+         * directly. Expects that @ref beginLayerProfile() was called before.
+         * Delegates to @ref doEndLayerProfile(), see its documentation for
+         * more information.
+         */
+        void endLayerProfile();
+
+        /**
+         * @brief Cache being currently rendered
+         *
+         * Set to the ID passed to @ref beginCache() and reset back to
+         * @cpp 0xffffffffu @ce in @ref endCache(). Initial state is
+         * @cpp 0xffffffffu @ce.
+         */
+        UnsignedInt currentCache() const;
+
+        /**
+         * @brief Begin rendering a cache
+         * @param id        Cache ID
+         * @param rect      Rectangle the cached contents are contained in, in
+         *      framebuffer pixels with the origin in the top left corner
+         *
+         * Used internally from @ref AbstractUserInterface::draw() if
+         * @ref RendererFeature::DrawCache is supported. Exposed just for
+         * testing purposes, there should be no need to call this function
+         * directly. Expects that @ref RendererFeature::DrawCache is supported,
+         * that @ref currentTargetState() is @ref RendererTargetState::Draw,
+         * that no cache is being rendered already and that @p rect is
+         * contained in the @ref framebufferSize(). Until @ref endCache() is
+         * called, it's only possible to transition to
+         * @ref RendererTargetState::Draw. Delegates to @ref doBeginCache(),
+         * see its documentation for more information.
+         */
+        void beginCache(UnsignedInt id, const Range2Di& rect);
+
+        /**
+         * @brief End rendering a cache
+         *
+         * Used internally from @ref AbstractUserInterface::draw() if
+         * @ref RendererFeature::DrawCache is supported. Exposed just for
+         * testing purposes, there should be no need to call this function
+         * directly. Expects that @ref beginCache() was called before.
+         * Delegates to @ref doEndCache(), see its documentation for more
+         * information.
+         */
+        void endCache();
+
+        /**
+         * @brief Draw a cache
+         * @param id        Cache ID
+         *
+         * Used internally from @ref AbstractUserInterface::draw() if
+         * @ref RendererFeature::DrawCache is supported. Exposed just for
+         * testing purposes, there should be no need to call this function
+         * directly. Expects that @ref RendererFeature::DrawCache is supported,
+         * that @ref currentTargetState() is @ref RendererTargetState::Draw
+         * and that no cache is being rendered. Delegates to @ref doDrawCache(),
+         * see its documentation for more information.
+         */
+        void drawCache(UnsignedInt id);
+
+        /**
+         * @brief Discard a cache
+         * @param id        Cache ID
+         *
+         * Used internally from @ref AbstractUserInterface::draw() if
+         * @ref RendererFeature::DrawCache is supported. Exposed just for
+         * testing purposes, there should be no need to call this function
+         * directly. Expects that @ref RendererFeature::DrawCache is supported
+         * and that @p id isn't the cache being currently rendered. Delegates
+         * to @ref doDiscardCache(), see its documentation for more
+         * information.
+         */
+        void discardCache(UnsignedInt id);
+
     private:
         /** @brief Implementation for @ref features() */
         virtual RendererFeatures doFeatures() const = 0;
@@ -369,6 +597,102 @@ class MAGNUM_UI_EXPORT AbstractRenderer {
          */
         virtual void doTransition(RendererTargetState targetStateFrom, RendererTargetState targetStateTo, RendererDrawStates drawStatesFrom, RendererDrawStates drawStatesTo) = 0;
 
+        /**
+         * @brief Begin profiling a layer
+         * @param layer     Layer that's going to be drawn or composited
+         *
+         * Implementation for @ref beginLayerProfile(), which is called from
+         * @ref AbstractUserInterface::draw() if
+         * @ref RendererFeature::LayerProfiling is supported. Is guaranteed to
+         * be followed by exactly one @ref doEndLayerProfile() call, with no
+         * @ref doTransition() in between. Default implementation asserts as
+         * the feature is expected to be implemented if advertised.
+         */
+        virtual void doBeginLayerProfile(LayerHandle layer);
+
+        /**
+         * @brief End profiling a layer
+         * @param layer     Layer that was drawn or composited. Same as passed
+         *      to the preceding @ref doBeginLayerProfile().
+         *
+         * Implementation for @ref endLayerProfile(). Default implementation
+         * asserts as the feature is expected to be implemented if
+         * advertised.
+         */
+        virtual void doEndLayerProfile(LayerHandle layer);
+
+        /**
+         * @brief Set the draw depth
+         * @param depth     Depth in the @f$ [0, 1] @f$ range
+         *
+         * Implementation for @ref setDrawDepth(), which is called from
+         * @ref AbstractUserInterface::draw() if
+         * @ref RendererFeature::DepthBuffer is supported. The implementation
+         * is expected to make all subsequent draws, regardless of what depth
+         * the layer shaders themselves output, use @p depth for depth testing
+         * and depth buffer writes. Default implementation asserts as the
+         * feature is expected to be implemented if advertised.
+         */
+        virtual void doSetDrawDepth(Float depth);
+
+        /**
+         * @brief Begin rendering a cache
+         * @param id        Cache ID
+         * @param rect      Rectangle the cached contents are contained in, in
+         *      framebuffer pixels with the origin in the top left corner
+         *
+         * Implementation for @ref beginCache(), which is called from
+         * @ref AbstractUserInterface::draw() if @ref RendererFeature::DrawCache
+         * is supported. The implementation is expected to clear the contents
+         * of cache @p id, creating it if it doesn't exist yet, and redirect
+         * all subsequent draws into it until @ref doEndCache(). Draws are
+         * done in the same coordinate system as draws into the framebuffer,
+         * i.e. including the scissor rectangles layers may set. Default
+         * implementation asserts as the feature is expected to be implemented
+         * if advertised.
+         */
+        virtual void doBeginCache(UnsignedInt id, const Range2Di& rect);
+
+        /**
+         * @brief End rendering a cache
+         * @param id        Cache ID. Same as passed to the preceding
+         *      @ref doBeginCache().
+         *
+         * Implementation for @ref endCache(). The implementation is expected
+         * to redirect subsequent draws back to the framebuffer. Default
+         * implementation asserts as the feature is expected to be implemented
+         * if advertised.
+         */
+        virtual void doEndCache(UnsignedInt id);
+
+        /**
+         * @brief Draw a cache
+         * @param id        Cache ID
+         *
+         * Implementation for @ref drawCache(), which is called from
+         * @ref AbstractUserInterface::draw() only for caches that were
+         * rendered with @ref doBeginCache() and @ref doEndCache() before. The
+         * implementation is expected to draw the @p rect passed to
+         * @ref doBeginCache() from the cache contents into the framebuffer,
+         * at the same position. The contents are premultiplied and are
+         * expected to be drawn with the same blending as the layers
+         * themselves. Default implementation asserts as the feature is
+         * expected to be implemented if advertised.
+         */
+        virtual void doDrawCache(UnsignedInt id);
+
+        /**
+         * @brief Discard a cache
+         * @param id        Cache ID
+         *
+         * Implementation for @ref discardCache(), which is called from
+         * @ref AbstractUserInterface::draw() for caches that are no longer
+         * drawn. The implementation is expected to free any resources
+         * associated with cache @p id. Default implementation asserts as the
+         * feature is expected to be implemented if advertised.
+         */
+        virtual void doDiscardCache(UnsignedInt id);
+
         struct State;
         Containers::Pointer<State> _state;
 };
@@ -125,8 +125,8 @@ BaseLayerSharedFlags AbstractStyle::doBaseLayerFlags() const {
 }
 
 AbstractStyle& AbstractStyle::setBaseLayerFlags(const BaseLayerSharedFlags add, const BaseLayerSharedFlags clear) {
-    CORRADE_ASSERT(add <= BaseLayerSharedFlag::SubdividedQuads,
-        "Ui::AbstractStyle::setBaseLayerFlags():" << (add & ~BaseLayerSharedFlag::SubdividedQuads) << "isn't allowed to be added", *this);
+    CORRADE_ASSERT(add <= (BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::ShaderClipping),
+        "Ui::AbstractStyle::setBaseLayerFlags():" << (add & ~(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::ShaderClipping)) << "isn't allowed to be added", *this);
     CORRADE_ASSERT(clear <= (BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners),
         "Ui::AbstractStyle::setBaseLayerFlags():" << (clear & ~(BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)) << "isn't allowed to be cleared", *this);
     _baseLayerFlagsAdd = add;
@@ -229,6 +229,19 @@ AbstractStyle& AbstractStyle::setTextLayerGlyphCacheSize(const Vector3i& size, c
     return *this;
 }
 
+TextLayerSharedFlags AbstractStyle::textLayerFlags() const {
+    CORRADE_ASSERT(features() >= StyleFeature::TextLayer,
+        "Ui::AbstractStyle::textLayerFlags(): feature not supported", {});
+    return _textLayerFlags;
+}
+
+AbstractStyle& AbstractStyle::setTextLayerFlags(const TextLayerSharedFlags flags) {
+    CORRADE_ASSERT(flags <= (TextLayerSharedFlag::GlyphCacheFillOnDemand|TextLayerSharedFlag::GlyphCacheFillDeferred|TextLayerSharedFlag::ShaderClipping),
+        "Ui::AbstractStyle::setTextLayerFlags():" << (flags & ~(TextLayerSharedFlag::GlyphCacheFillOnDemand|TextLayerSharedFlag::GlyphCacheFillDeferred|TextLayerSharedFlag::ShaderClipping)) << "isn't allowed to be added", *this);
+    _textLayerFlags = flags;
+    return *this;
+}
+
 bool AbstractStyle::apply(UserInterface& ui, const StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>* const importerManager, PluginManager::Manager<Text::AbstractFont>* const fontManager) const {
     CORRADE_ASSERT(features,
         "Ui::AbstractStyle::apply(): no features specified", {});
@@ -289,4 +302,43 @@ bool AbstractStyle::apply(UserInterface& ui, const StyleFeatures features, Plugi
     return doApply(ui, features, importerManager, fontManager);
 }
 
+bool AbstractStyle::applyUniforms(UserInterface& ui, const StyleFeatures features) const {
+    CORRADE_ASSERT(features,
+        "Ui::AbstractStyle::applyUniforms(): no features specified", {});
+    CORRADE_ASSERT(features <= this->features(),
+        "Ui::AbstractStyle::applyUniforms():" << features << "not a subset of supported" << this->features(), {});
+    CORRADE_ASSERT(features <= (StyleFeature::BaseLayer|StyleFeature::TextLayer),
+        "Ui::AbstractStyle::applyUniforms():" << features << "not a subset of" << (StyleFeature::BaseLayer|StyleFeature::TextLayer), {});
+    #ifndef CORRADE_NO_ASSERT
+    if(features >= StyleFeature::BaseLayer) {
+        CORRADE_ASSERT(ui.hasBaseLayer(),
+            "Ui::AbstractStyle::applyUniforms(): base layer not present in the user interface", {});
+        const BaseLayer::Shared& shared = ui.baseLayer().shared();
+        CORRADE_ASSERT(
+            shared.styleUniformCount() == baseLayerStyleUniformCount() &&
+            shared.styleCount() == baseLayerStyleCount() &&
+            shared.dynamicStyleCount() >= baseLayerDynamicStyleCount(),
+            "Ui::AbstractStyle::applyUniforms(): style wants" << baseLayerStyleUniformCount() << "uniforms," << baseLayerStyleCount() << "styles and at least" << baseLayerDynamicStyleCount() << "dynamic styles but the base layer has" << shared.styleUniformCount() << Debug::nospace << "," << shared.styleCount() << "and" << shared.dynamicStyleCount(), {});
+    }
+    if(features >= StyleFeature::TextLayer) {
+        CORRADE_ASSERT(ui.hasTextLayer(),
+            "Ui::AbstractStyle::applyUniforms(): text layer not present in the user interface", {});
+        const TextLayer::Shared& shared = ui.textLayer().shared();
+        CORRADE_ASSERT(
+            shared.styleUniformCount() == textLayerStyleUniformCount() &&
+            shared.styleCount() == textLayerStyleCount() &&
+            shared.editingStyleUniformCount() == textLayerEditingStyleUniformCount() &&
+            shared.editingStyleCount() == textLayerEditingStyleCount() &&
+            shared.dynamicStyleCount() >= textLayerDynamicStyleCount(),
+            "Ui::AbstractStyle::applyUniforms(): style wants" << textLayerStyleUniformCount() << "uniforms," << textLayerStyleCount() << "styles," << textLayerEditingStyleUniformCount() << "editing uniforms," << textLayerEditingStyleCount() << "editing styles and at least" << textLayerDynamicStyleCount() << "dynamic styles but the text layer has" << shared.styleUniformCount() << Debug::nospace << "," << shared.styleCount() << Debug::nospace << "," << shared.editingStyleUniformCount() << Debug::nospace << "," << shared.editingStyleCount() << "and" << shared.dynamicStyleCount(), {});
+    }
+    #endif
+
+    return doApplyUniforms(ui, features);
+}
+
+bool AbstractStyle::doApplyUniforms(UserInterface&, StyleFeatures) const {
+    return false;
+}
+
 }}
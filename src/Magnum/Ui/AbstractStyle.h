@@ -222,11 +222,18 @@ class MAGNUM_UI_EXPORT AbstractStyle {
          * @return Reference to self (for method chaining)
          *
          * Expects that @ref StyleFeature::BaseLayer is supported, @p add is a
-         * subset of @ref BaseLayerSharedFlag::SubdividedQuads, and @p clear is a
+         * subset of @ref BaseLayerSharedFlag::SubdividedQuads and
+         * @relativeref{BaseLayerSharedFlag,ShaderClipping}, and @p clear is a
          * subset of @ref BaseLayerSharedFlag::NoRoundedCorners and
          * @relativeref{BaseLayerSharedFlag,NoOutline}. Flags used are a union
          * of what the style itself returned and what was requested in @p add,
          * with everything in @p clear cleared from the set.
+         *
+         * On WebGL, where each draw call has a significant overhead, adding
+         * @ref BaseLayerSharedFlag::ShaderClipping together with
+         * @ref TextLayerSharedFlag::ShaderClipping in
+         * @ref setTextLayerFlags() makes each layer drawn with a single draw
+         * call instead of one for each clip rect.
          * @see @ref baseLayerFlags(), @ref features()
          */
         AbstractStyle& setBaseLayerFlags(BaseLayerSharedFlags add, BaseLayerSharedFlags clear);
@@ -391,6 +398,35 @@ class MAGNUM_UI_EXPORT AbstractStyle {
          */
         AbstractStyle& setTextLayerGlyphCacheSize(const Vector3i& size, const Vector2i& padding = {});
 
+        /**
+         * @brief Additional flags for the text layer
+         *
+         * Expects that @ref StyleFeature::TextLayer is supported. The returned
+         * value is passed to @ref TextLayer::Shared::Configuration::addFlags()
+         * by @ref UserInterfaceGL::setStyle(). Empty by default, call
+         * @ref setTextLayerFlags() to supply additional flags.
+         * @see @ref features()
+         */
+        TextLayerSharedFlags textLayerFlags() const;
+
+        /**
+         * @brief Set additional text layer flags
+         * @return Reference to self (for method chaining)
+         *
+         * Expects that @p flags is a subset of
+         * @ref TextLayerSharedFlag::GlyphCacheFillOnDemand,
+         * @relativeref{TextLayerSharedFlag,GlyphCacheFillDeferred} and
+         * @relativeref{TextLayerSharedFlag,ShaderClipping}. With the first
+         * two, glyphs get rasterized only once they're actually used. Style
+         * implementations such as @ref McssDarkStyle then skip filling the
+         * glyph cache with a predefined set of glyphs in @ref apply(), which
+         * makes the style setup considerably faster. See
+         * @ref setBaseLayerFlags() for when
+         * @relativeref{TextLayerSharedFlag,ShaderClipping} is useful.
+         * @see @ref textLayerFlags()
+         */
+        AbstractStyle& setTextLayerFlags(TextLayerSharedFlags flags);
+
         /**
          * @brief Apply the style
          *
@@ -431,6 +467,33 @@ class MAGNUM_UI_EXPORT AbstractStyle {
          */
         bool apply(UserInterface& ui, StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>* importerManager, PluginManager::Manager<Text::AbstractFont>* fontManager) const;
 
+        /**
+         * @brief Apply just the style uniforms
+         * @m_since_latest
+         *
+         * A fast path for switching a user interface that already has a
+         * compatible style applied to this style, such as between a dark and
+         * a light variant of the same style. Compared to @ref apply() it
+         * only updates uniform data such as colors, corner radii and outline
+         * widths via @ref BaseLayer::Shared::setStyleUniforms(),
+         * @ref TextLayer::Shared::setStyleUniforms() and
+         * @relativeref{TextLayer::Shared,setEditingStyleUniforms()}, keeping
+         * fonts, the glyph cache contents, style transitions and all layer
+         * data untouched. It's the caller responsibility to ensure the
+         * previously applied style uses the same fonts and style mapping.
+         *
+         * Expects that @p features are a subset of @ref features() and
+         * contain at least one feature, that they're a subset of
+         * @ref StyleFeature::BaseLayer and @relativeref{StyleFeature,TextLayer}
+         * and that @p ui already contains all layers corresponding to
+         * @p features, with a style already set and with style uniform and
+         * style counts matching the same way as in @ref apply(). Returns
+         * @cpp true @ce on success, @cpp false @ce if the style doesn't
+         * implement this fast path, in which case @ref apply() should be used
+         * instead.
+         */
+        bool applyUniforms(UserInterface& ui, StyleFeatures features) const;
+
     private:
         /**
          * @brief Implementation for @ref features()
@@ -588,6 +651,20 @@ class MAGNUM_UI_EXPORT AbstractStyle {
          */
         virtual bool doApply(UserInterface& ui, StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>* importerManager, PluginManager::Manager<Text::AbstractFont>* fontManager) const = 0;
 
+        /**
+         * @brief Implementation for @ref applyUniforms()
+         * @m_since_latest
+         *
+         * Should call @ref BaseLayer::Shared::setStyleUniforms(),
+         * @ref TextLayer::Shared::setStyleUniforms() and
+         * @relativeref{TextLayer::Shared,setEditingStyleUniforms()} with
+         * style uniforms based on what @p features are passed and return
+         * @cpp true @ce. The @p features and @p ui are guaranteed to satisfy
+         * the same constraints as described in @ref applyUniforms(). Default
+         * implementation returns @cpp false @ce.
+         */
+        virtual bool doApplyUniforms(UserInterface& ui, StyleFeatures features) const;
+
         /* When more user-overridable properties are present, might want to put
            them into a PIMPL instead, and remove the Vector3 include again */
         UnsignedInt _baseLayerDynamicStyleCount = 0;
@@ -595,6 +672,7 @@ class MAGNUM_UI_EXPORT AbstractStyle {
         Vector3i _textLayerGlyphCacheSize;
         Vector2i _textLayerGlyphCachePadding;
         BaseLayerSharedFlags _baseLayerFlagsAdd, _baseLayerFlagsClear;
+        TextLayerSharedFlags _textLayerFlags;
 };
 
 }}
@@ -26,16 +26,18 @@
 
 #include "AbstractUserInterface.h"
 
-#include <Corrade/Containers/ArrayTuple.h>
+#include <chrono>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/BitArray.h>
 #include <Corrade/Containers/EnumSet.hpp>
+#include <Corrade/Containers/Function.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/Reference.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Math/Time.h>
-#include <Magnum/Math/Vector2.h>
 
 #include "Magnum/Ui/AbstractAnimator.h"
 #include "Magnum/Ui/AbstractLayer.h"
@@ -45,10 +47,37 @@
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/NodeFlags.h"
 #include "Magnum/Ui/Implementation/abstractUserInterface.h"
-#include "Magnum/Ui/Implementation/orderNodesBreadthFirstInto.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
+#include "Magnum/Ui/Implementation/frameArena.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
+#include "Magnum/Ui/Implementation/trace.h"
 
 namespace Magnum { namespace Ui {
 
+namespace {
+
+/* Pipeline stages that can be compiled out with the MAGNUM_UI_WITH_LAYOUTERS,
+   MAGNUM_UI_WITH_NODE_ANIMATORS and MAGNUM_UI_WITH_COMPOSITE_LAYERS CMake
+   options. Constants instead of #ifdefs around the code so all variants keep
+   being compiled, the unused branches are then removed by the optimizer. */
+#ifdef MAGNUM_UI_WITH_LAYOUTERS
+constexpr bool WithLayouters = true;
+#else
+constexpr bool WithLayouters = false;
+#endif
+#ifdef MAGNUM_UI_WITH_NODE_ANIMATORS
+constexpr bool WithNodeAnimators = true;
+#else
+constexpr bool WithNodeAnimators = false;
+#endif
+#ifdef MAGNUM_UI_WITH_COMPOSITE_LAYERS
+constexpr bool WithCompositeLayers = true;
+#else
+constexpr bool WithCompositeLayers = false;
+#endif
+
+}
+
 Debug& operator<<(Debug& debug, const UserInterfaceState value) {
     /* Special case coming from the UserInterfaceStates printer. As both are a
        superset of NeedsDataUpdate, printing just one would result in
@@ -114,8 +143,72 @@ Debug& operator<<(Debug& debug, const UserInterfaceStates value) {
     });
 }
 
+Debug& operator<<(Debug& debug, const UserInterfaceUpdateStage value) {
+    debug << "Ui::UserInterfaceUpdateStage" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case UserInterfaceUpdateStage::value: return debug << "::" #value;
+        _c(Clean)
+        _c(NodeOrder)
+        _c(Layout)
+        _c(NodeState)
+        _c(DataOrder)
+        _c(Event)
+        _c(LayerUpdate)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+}
+
 namespace {
 
+/* Used by update() to measure the duration of each stage if statistics are
+   enabled and to call the stage callback if set. Does nothing otherwise. */
+class UpdateStageTracker {
+    public:
+        explicit UpdateStageTracker(UserInterfaceUpdateStatistics* statistics, Containers::Function<void(UserInterfaceUpdateStage, bool)>& callback): _statistics{statistics}, _callback{callback ? &callback : nullptr} {}
+
+        ~UpdateStageTracker() { end(); }
+
+        /* Ends the previous stage, if any, and begins the next */
+        void begin(const UserInterfaceUpdateStage stage) {
+            end();
+            _stage = stage;
+            _active = true;
+            if(_callback)
+                (*_callback)(stage, false);
+            if(_statistics)
+                _begin = std::chrono::steady_clock::now();
+        }
+
+        void end() {
+            if(!_active)
+                return;
+            if(_statistics)
+                _statistics->stageDurations[UnsignedByte(_stage)] = Nanoseconds{Long(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _begin).count())};
+            if(_callback)
+                (*_callback)(_stage, true);
+            _active = false;
+        }
+
+    private:
+        UserInterfaceUpdateStatistics* _statistics;
+        Containers::Function<void(UserInterfaceUpdateStage, bool)>* _callback;
+        std::chrono::steady_clock::time_point _begin;
+        UserInterfaceUpdateStage _stage{};
+        bool _active = false;
+};
+
+/* Nodes with fewer direct children than this are hit tested by going through
+   all children, for more a hit testing grid is built. If the children overlap
+   so much that there would be more than given count of grid cell entries per
+   child on average, the grid isn't built either. */
+constexpr UnsignedInt HitTestGridMinChildCount = 32;
+constexpr UnsignedInt HitTestGridMaxEntriesPerChild = 8;
+
 union Layer {
     explicit Layer() noexcept: used{} {}
     Layer(const Layer&&) = delete;
@@ -148,7 +241,9 @@ union Layer {
         UnsignedByte generation = 1;
 
         /* Extracted from AbstractLayer for more direct access. Filled in
-           setLayerInstance(), cleared in removeLayer(). */
+           setLayerInstance(), cleared in removeLayer(). The events are empty
+           if the layer doesn't have LayerFeature::Event. */
+        LayerEvents events;
         LayerFeatures features;
 
         /* Always meant to be non-null and valid. To make insert/remove
@@ -238,7 +333,8 @@ union Layouter {
            wraps back to zero once the handle gets disabled. */
         UnsignedByte generation = 1;
 
-        /* 1 byte free */
+        /* Queried in setLayouterInstance(), reset back in removeLayouter() */
+        LayouterFeatures features;
 
         /* Always meant to be non-null and valid. To make insert/remove
            operations easier the list is cyclic, so the last layouters's `next`
@@ -343,10 +439,10 @@ union Node {
     struct Used {
         /* Except for the generation, these have to be re-filled every time a
            handle is recycled, so it doesn't make sense to initialize them to
-           anything. */
-
-        /* Parent node handle or Null for root nodes */
-        NodeHandle parent;
+           anything. The parent and flags, which are accessed for all nodes
+           in update(), are stored in separate State::nodeParents and
+           State::nodeFlags arrays to not need to go through the whole
+           struct. */
 
         /* If not ~UnsignedInt{}, the node is part of the top-level node order
            and the value is index into the nodeOrder array, which then stores a
@@ -365,9 +461,7 @@ union Node {
            `1 << NodeHandleGenerationBits` the handle gets disabled. */
         UnsignedShort generation = 1;
 
-        NodeFlags flags{NoInit};
-
-        /* One byte free */
+        /* Two bytes free */
 
         /* Initial offset and size passed to layouters, if present. Only the
            final offset and size produced by the whole layouter chain actually
@@ -377,16 +471,20 @@ union Node {
         /* Initial node opacity. The actual value passed to layers is
            multiplied with opacity of all parents. */
         Float opacity;
+
+        /* Index of the first child node and previous / next sibling in a
+           doubly linked list of children of the same parent, ~UnsignedInt{}
+           if there's none. Root nodes aren't part of any list, nodes whose
+           parent got removed are in a list starting at
+           State::firstOrphanNode. Used by clean() to remove nested nodes
+           without having to go through the whole hierarchy. */
+        UnsignedInt firstChild;
+        UnsignedInt previousSibling;
+        UnsignedInt nextSibling;
     } used;
 
     /* Used only if the Node is among the free ones */
     struct Free {
-        /* Free nodes need to have this preserved, with generation set to 0 and
-           ID to all 1s, to avoid calling removeNode() again on free items in
-           clean(). There's no other way to distinguish free and used nodes
-           apart from walking the free list. */
-        NodeHandle parent;
-
         UnsignedInt:32;
 
         /* The generation value has to be preserved in order to increment it
@@ -402,7 +500,6 @@ union Node {
 static_assert(std::is_trivially_copyable<Node>::value, "Node not trivially copyable");
 #endif
 static_assert(
-    offsetof(Node::Used, parent) == offsetof(Node::Free, parent) &&
     offsetof(Node::Used, generation) == offsetof(Node::Free, generation),
     "Node::Used and Free layout not compatible");
 
@@ -426,6 +523,15 @@ union NodeOrder {
            If given top-level hierarchy doesn't contain any child top-level
            hierarchies, points to the top-level node itself. */
         NodeHandle lastNested;
+
+        /* Monotonically increasing along the `next` chain starting at
+           `_state->firstNodeOrder`, used for O(1) relative order queries.
+           Valid only if `_state->nodeOrderKeysValid` is set and the node is
+           reachable from `firstNodeOrder`. Inserting a single root node picks
+           a key between its neighbors, if there's no gap left or anything
+           more complex is done, all keys are recalculated on the next
+           query. */
+        UnsignedInt key;
     } used;
 
     /* Used only if the NodeOrder is among the free ones */
@@ -502,6 +608,15 @@ struct AbstractUserInterface::State {
 
     /* Nodes, indexed by NodeHandle */
     Containers::Array<Node> nodes;
+    /* Node parent handles and flags, indexed by NodeHandle ID, always with
+       the same size as the `nodes` array. Stored separately from it as these
+       are accessed for all nodes in ordering, visibility and event passes and
+       so it's more cache-friendly to have them dense. Free nodes need to have
+       the parent set to Null to make them treated as root nodes when ordering
+       the whole hierarchy in update(). There's no other way to distinguish
+       free and used nodes apart from walking the free list. */
+    Containers::Array<NodeHandle> nodeParents;
+    Containers::Array<NodeFlags> nodeFlags;
     /* Indices into the `nodes` array. The `Node` then has a `nextFree`
        member containing the next free index. To avoid repeatedly reusing the
        same handles and exhausting their generation counter too soon, new
@@ -509,12 +624,22 @@ struct AbstractUserInterface::State {
        with all bits set means there's no (first/next/last) free node. */
     UnsignedInt firstFreeNode = ~UnsignedInt{};
     UnsignedInt lastFreeNode = ~UnsignedInt{};
+    /* If non-zero, the node storage is reserved for exactly this many nodes
+       and createNode() never grows it past that */
+    UnsignedInt fixedNodeCapacity = 0;
+    /* Index into the `nodes` array, first of a list of nodes whose parent got
+       removed, linked through `Node::Used::nextSibling`. Gets emptied in
+       clean(). A value with all bits set means there's no orphaned node. */
+    UnsignedInt firstOrphanNode = ~UnsignedInt{};
 
     Containers::Array<NodeOrder> nodeOrder;
     /* Doesn't point into the `nodeOrder` array but instead is a handle, for
        which then then `Node::order` points into the `nodeOrder` array. If
        null, there's no nodes to process at all. */
     NodeHandle firstNodeOrder = NodeHandle::Null;
+    /* Whether NodeOrder::Used::key is up-to-date, see its documentation for
+       details */
+    bool nodeOrderKeysValid = false;
     /* Index into the `nodeOrder` array. The `NodeOrder` then has a
        `nextFree` member containing the next free index. No handles are exposed
        for these, thus there's no problem with generation exhausing and the
@@ -552,12 +677,68 @@ struct AbstractUserInterface::State {
     /** @todo maintain previous position per pointer type? i.e., mouse, pen and
         finger independently? */
     Containers::Optional<Vector2> currentGlobalPointerPosition;
+    /* If set, pointer move events that don't change the set of pressed
+       pointers are queued in pendingPointerMoveEvent instead of being
+       processed directly. Times and unscaled global positions of events
+       replaced by a newer one are recorded in coalescedPointerMoves, and
+       converted to be relative to the final position on flush. */
+    bool pointerMoveEventCoalescing = false;
+    Containers::Optional<PointerMoveEvent> pendingPointerMoveEvent;
+    Vector2 pendingPointerMoveGlobalPosition;
+    Containers::Array<Containers::Pair<Nanoseconds, Vector2>> coalescedPointerMoves;
     /* Focused node */
     NodeHandle currentFocusedNode = NodeHandle::Null;
+    /* Node for which it was last checked whether any of its parents have
+       NodeFlag::FallthroughPointerEvents and any event data attached, and the
+       result, separately for pointer move events and the rest. As node
+       parents can't change during the node lifetime, it's reset only when the
+       flag changes on any node or when the event data lists get rebuilt.
+       Makes repeated events on the same node, such as moves on a captured
+       node during a drag, skip walking the parents if there's nothing to call
+       fallthrough events on. */
+    NodeHandle fallthroughCheckedNode = NodeHandle::Null;
+    bool fallthroughCheckedNodeHasParents = false;
+    bool fallthroughCheckedNodeHasMoveParents = false;
+
+    /* Bump allocator for temporary data in clean(), advanceAnimations() and
+       update(). Reset at the start of each, released at the end unless
+       setPersistentUpdateStorage() is enabled. */
+    Implementation::FrameArena updateStorage;
+    bool persistentUpdateStorage = false;
+
+    /* If set, draws of non-overlapping top-level nodes are reordered and
+       merged in update() */
+    bool drawMerging = false;
+
+    /* Used to update layers with LayerFeature::ConcurrentUpdate and
+       layouters with LayouterFeature::ConcurrentUpdate, if set, and to advance
+       animators if concurrentAnimationAdvance is enabled */
+    Containers::Function<void(std::size_t, void(*)(void*, std::size_t), void*)> updateExecutor;
+    bool concurrentAnimationAdvance = false;
+
+    /* Filled by update() if updateStatisticsEnabled is set, the layer data
+       counts are referenced from updateStatistics */
+    bool updateStatisticsEnabled = false;
+    UserInterfaceUpdateStatistics updateStatistics{};
+    Containers::Array<UnsignedInt> updateStatisticsLayerDataCounts;
+    /* Per-frame counters, accumulated by update(), advanceAnimations() and
+       event functions if updateStatisticsEnabled is set and moved to the
+       published arrays referenced from updateStatistics in draw() */
+    Containers::Array<LayerStates> frameLayerStates;
+    Containers::Array<std::size_t> frameLayerUploadedSizes;
+    UnsignedInt frameEventCount = 0;
+    UnsignedInt frameHitTestNodeCount = 0;
+    UnsignedInt frameAnimatorAdvanceCount = 0;
+    Containers::Array<LayerStates> updateStatisticsLayerStates;
+    Containers::Array<std::size_t> updateStatisticsLayerUploadedSizes;
+    /* Called by update() at the start and end of each stage, if set */
+    Containers::Function<void(UserInterfaceUpdateStage, bool)> updateStageCallback;
 
     /* Data for updates, event handling and drawing, repopulated by clean() and
-       update() */
-    Containers::ArrayTuple nodeStateStorage;
+       update(). The arenas are reset every time the corresponding data get
+       repopulated, meaning they don't reallocate unless the data grow
+       larger. */
+    Implementation::FrameArena nodeStateStorage;
     Containers::ArrayView<UnsignedInt> visibleNodeIds;
     Containers::ArrayView<UnsignedInt> visibleNodeChildrenCounts;
     Containers::StridedArrayView1D<UnsignedInt> visibleFrontToBackTopLevelNodeIndices;
@@ -565,6 +746,10 @@ struct AbstractUserInterface::State {
     Containers::ArrayView<Vector2> nodeSizes;
     Containers::ArrayView<Vector2> absoluteNodeOffsets;
     Containers::ArrayView<Float> absoluteNodeOpacities;
+    /* Bounding rects of visible nodes including all their children, in the
+       visibleNodeIds order. Recalculated on every layout update, used by
+       clip updates to skip subtrees that are fully outside. */
+    Containers::ArrayView<Range2D> visibleSubtreeRects;
     Containers::MutableBitArrayView visibleNodeMask;
     Containers::MutableBitArrayView visibleEventNodeMask;
     Containers::MutableBitArrayView visibleEnabledNodeMask;
@@ -572,14 +757,39 @@ struct AbstractUserInterface::State {
     Containers::ArrayView<Vector2> clipRectOffsets;
     Containers::ArrayView<Vector2> clipRectSizes;
     Containers::ArrayView<UnsignedInt> clipRectNodeCounts;
-    Containers::ArrayTuple layoutStateStorage;
+    /* Children lists of all nodes excluding top-level nodes, repopulated
+       only if visibleNodeOrderNeedsFullUpdate is set. Otherwise only the
+       hierarchies under top-level nodes listed in dirtyTopLevelNodeIds
+       are ordered again and the rest is copied from the previous
+       visibleNodeIds. */
+    Implementation::FrameArena nodeChildrenStorage;
+    Containers::ArrayView<UnsignedInt> nodeChildrenOffsets;
+    Containers::ArrayView<UnsignedInt> nodeChildren;
+    Containers::Array<UnsignedInt> dirtyTopLevelNodeIds;
+    bool visibleNodeOrderNeedsFullUpdate = true;
+    Implementation::FrameArena layoutStateStorage;
     Containers::ArrayView<UnsignedInt> topLevelLayoutOffsets;
     Containers::ArrayView<UnsignedByte> topLevelLayoutLayouterIds;
     Containers::ArrayView<UnsignedInt> topLevelLayoutIds;
-    /** @todo this is a separate allocation from layoutStateStorage, unify
-        somehow */
-    Containers::BitArray layoutMasks;
-    Containers::ArrayTuple dataStateStorage;
+    /* Level of each update() run in topLevelLayoutLayouterIds. Runs of the
+       same level don't depend on each other and can be executed
+       concurrently. */
+    Containers::ArrayView<UnsignedInt> topLevelLayoutLevels;
+    Containers::MutableBitArrayView layoutMasks;
+    /* Root nodes which hierarchies contain nodes with offset or size changed
+       via setNodeOffset() or setNodeSize() since the last update(). Unless
+       layoutNeedsFullUpdate is set, only layouts in these hierarchies are
+       passed to layouter update() calls and the rest keeps the previously
+       calculated offsets and sizes. */
+    Containers::Array<UnsignedInt> dirtyLayoutRootNodeIds;
+    bool layoutNeedsFullUpdate = true;
+    /* Data order, draw list and event data lists, repopulated by update().
+       If dataOrderNeedsUpdate isn't set by anything that changes data
+       attachments, node flags or the draw list setup and a layout update
+       turns out to be translation-only, their previous contents are
+       reused. */
+    bool dataOrderNeedsUpdate = true;
+    Implementation::FrameArena dataStateStorage;
     /* Data offset, clip rect offset, composite rect offset */
     Containers::ArrayView<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> dataToUpdateLayerOffsets;
     Containers::ArrayView<UnsignedInt> dataToUpdateIds;
@@ -592,11 +802,64 @@ struct AbstractUserInterface::State {
     Containers::ArrayView<UnsignedInt> dataToDrawSizes;
     Containers::ArrayView<UnsignedInt> dataToDrawClipRectOffsets;
     Containers::ArrayView<UnsignedInt> dataToDrawClipRectSizes;
+    /* Layer instances and features for each of the `drawCount` draws, so
+       drawing doesn't need to access the `layers` array, which may be
+       reallocated by createLayer() */
+    Containers::ArrayView<AbstractLayer*> dataToDrawLayers;
+    Containers::ArrayView<LayerFeatures> dataToDrawLayerFeatures;
     /* Indexed by node ID in order to make it possible to look up node data by
        node ID, however contains data only for visible nodes */
     Containers::ArrayView<UnsignedInt> visibleNodeEventDataOffsets;
     Containers::ArrayView<DataHandle> visibleNodeEventData;
+    /* Indexed by visible node index, a running count of event data in the
+       visible node order, used to skip hit testing of subtrees that have no
+       event data at all */
+    Containers::ArrayView<UnsignedInt> visibleSubtreeEventDataOffsets;
+    /* Same as above, but containing only data from layers with
+       LayerEvent::PointerMove, used for pointer move, enter and leave events.
+       If all event layers handle those, the views are the same as above. */
+    Containers::ArrayView<UnsignedInt> visibleNodeMoveEventDataOffsets;
+    Containers::ArrayView<DataHandle> visibleNodeMoveEventData;
+    Containers::ArrayView<UnsignedInt> visibleSubtreeMoveEventDataOffsets;
+    /* Data IDs extracted from the two lists above, used to pass a contiguous
+       run of data of the same layer to layers with LayerFeature::EventBatch.
+       Populated only if there's at least one such layer, empty otherwise. */
+    Containers::ArrayView<UnsignedInt> visibleNodeEventDataIds;
+    Containers::ArrayView<UnsignedInt> visibleNodeMoveEventDataIds;
     UnsignedInt drawCount = 0, clipRectCount = 0;
+
+    /* Uniform grids for hit testing nodes with many direct children, built
+       lazily on the first event after the data attachment update. Growable
+       arrays as the size isn't known upfront, cleared on every rebuild, thus
+       reallocating only if the grids get larger. */
+    Containers::Array<UnsignedInt> visibleNodeHitTestGrids;
+    Containers::Array<Implementation::HitTestGrid> hitTestGrids;
+    Containers::Array<UnsignedInt> hitTestGridCellOffsets;
+    Containers::Array<UnsignedInt> hitTestGridCellChildren;
+    bool hitTestGridsNeedUpdate = false;
+
+    /* Used only if the renderer advertises RendererFeature::PartialRedraw.
+       The `redrawRect` accumulates areas that changed in update() and is
+       consumed by the next draw, if `redrawAll` is set, the whole UI is
+       redrawn instead. The `redrawNodes` contain node state from the previous
+       update() to discover what changed. */
+    bool rendererPartialRedraw = false;
+    bool redrawAll = true;
+    /* Set if update() or setup changed anything visual since the last draw,
+       reset in drawInternal(). Queried by needsDraw(). */
+    bool drawNeeded = true;
+    Range2D redrawRect;
+    Containers::Array<Implementation::RedrawNode> redrawNodes;
+
+    /* Used only if the renderer advertises RendererFeature::DrawCache. The
+       `cachedDraws` are repopulated together with the draw list, the
+       `nodeCaches` and `cacheNodes` are indexed by node ID and persist across
+       updates, with `cacheNodes` containing node state from the previous
+       update() to discover what changed in cached hierarchies. */
+    bool rendererDrawCache = false;
+    Containers::ArrayView<Implementation::CachedDraw> cachedDraws;
+    Containers::Array<Implementation::NodeCache> nodeCaches;
+    Containers::Array<Implementation::RedrawNode> cacheNodes;
 };
 
 AbstractUserInterface::AbstractUserInterface(NoCreateT): _state{InPlaceInit} {}
@@ -641,6 +904,22 @@ AbstractUserInterface& AbstractUserInterface::setSize(const Vector2& size, const
     if(framebufferSizeDifferent && state.renderer)
         state.renderer->setupFramebuffers(framebufferSize);
 
+    /* With a partial redraw, the retained contents are no longer usable if
+       either size changes */
+    if(sizeOrFramebufferSizeDifferent) {
+        state.redrawAll = true;
+        state.drawNeeded = true;
+    }
+
+    /* Same for cached contents. Framebuffer setup discards all caches in the
+       renderer. */
+    for(Implementation::NodeCache& i: state.nodeCaches) {
+        if(sizeOrFramebufferSizeDifferent)
+            i.valid = false;
+        if(framebufferSizeDifferent)
+            i.present = false;
+    }
+
     /* If the size is different, set a state flag to recalculate the set of
        visible nodes. I.e., some might now be outside of the UI area and
        hidden, some might be newly visible.
@@ -682,6 +961,13 @@ AbstractUserInterface& AbstractUserInterface::setSize(const Vector2i& size) {
     return setSize(Vector2{size}, Vector2{size}, size);
 }
 
+bool AbstractUserInterface::needsDraw() const {
+    /* Either the last update() changed something that wasn't drawn yet, or
+       there are pending changes for the next update(). NeedsDataClean on its
+       own results in a data attachment update after clean(). */
+    return _state->drawNeeded || (state() & (UserInterfaceState::NeedsDataUpdate|UserInterfaceState::NeedsDataClean));
+}
+
 UserInterfaceStates AbstractUserInterface::state() const {
     const State& state = *_state;
     UserInterfaceStates states;
@@ -712,7 +998,7 @@ UserInterfaceStates AbstractUserInterface::state() const {
     if(!(state.state >= (UserInterfaceState::NeedsDataAttachmentUpdate|UserInterfaceState::NeedsDataClean))) for(const Layer& layer: state.layers) {
         if(const AbstractLayer* const instance = layer.used.instance.get()) {
             const LayerStates layerState = instance->state();
-            if(layerState & (LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate))
+            if(layerState & (LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate|LayerState::NeedsDataStyleUpdate))
                 states |= UserInterfaceState::NeedsDataUpdate;
             if(layerState >= LayerState::NeedsAttachmentUpdate)
                 states |= UserInterfaceState::NeedsDataAttachmentUpdate;
@@ -751,6 +1037,18 @@ Nanoseconds AbstractUserInterface::animationTime() const {
     return _state->animationTime;
 }
 
+Nanoseconds AbstractUserInterface::nextAnimationAdvanceTime() const {
+    /* Invalid (removed) animators have instances set to nullptr, skip them.
+       The animators return Nanoseconds::max() if they don't have
+       NeedsAdvance set, so no need to check that here. */
+    Nanoseconds out = Nanoseconds::max();
+    for(const Animator& animator: _state->animators) {
+        if(const AbstractAnimator* const instance = animator.used.instance.get())
+            out = Math::min(out, instance->nextAdvanceTime());
+    }
+    return out;
+}
+
 AbstractRenderer& AbstractUserInterface::setRendererInstance(Containers::Pointer<AbstractRenderer>&& instance) {
     State& state = *_state;
     CORRADE_ASSERT(instance,
@@ -773,6 +1071,16 @@ AbstractRenderer& AbstractUserInterface::setRendererInstance(Containers::Pointer
     #endif
 
     state.renderer = Utility::move(instance);
+    state.rendererPartialRedraw = state.renderer->features() >= RendererFeature::PartialRedraw;
+    state.rendererDrawCache = state.renderer->features() >= RendererFeature::DrawCache;
+    state.redrawAll = true;
+    /* If there are nodes already, the draw list has to be recreated to have
+       cached draws populated */
+    if(state.rendererDrawCache && !state.nodes.isEmpty()) {
+        state.state |= UserInterfaceState::NeedsDataAttachmentUpdate;
+        state.dataOrderNeedsUpdate = true;
+    }
+    state.drawNeeded = true;
     /* If we already know the framebuffer size, perform framebuffer size
        setup. Do it immediately so the renderer internals such as custom
        framebuffers are ready to be used by the application. Only the
@@ -968,9 +1276,13 @@ AbstractLayer& AbstractUserInterface::setLayerInstance(Containers::Pointer<Abstr
        there's already a compositing layer, is in setRendererInstance() */
     CORRADE_ASSERT(!(instance->features() >= LayerFeature::Composite) || !state.renderer || (state.renderer->features() >= RendererFeature::Composite),
         "Ui::AbstractUserInterface::setLayerInstance(): layer with" << LayerFeature::Composite << "not usable with a renderer that has" << state.renderer->features(), *instance);
+    CORRADE_ASSERT(WithCompositeLayers || !(instance->features() >= LayerFeature::Composite),
+        "Ui::AbstractUserInterface::setLayerInstance(): layer with" << LayerFeature::Composite << "not usable as the library was built without MAGNUM_UI_WITH_COMPOSITE_LAYERS", *instance);
 
     Layer& layer = state.layers[id];
     layer.used.features = instance->features();
+    layer.used.events = layer.used.features & LayerFeature::Event ?
+        instance->events() : LayerEvents{};
     layer.used.instance = Utility::move(instance);
 
     /* If the size is already set, immediately proxy it to the layer. If it
@@ -1034,6 +1346,7 @@ void AbstractUserInterface::removeLayer(const LayerHandle handle) {
     /* Clear also the feature set, as that can be used by certain hot loops
        without checking that given layer instance is actually present */
     layer.used.features = {};
+    layer.used.events = {};
 
     /* Increase the layer generation so existing handles pointing to this layer
        are invalidated */
@@ -1064,8 +1377,14 @@ void AbstractUserInterface::removeLayer(const LayerHandle handle) {
     }
 
     /* Mark the UI as needing an update() call to refresh per-node data
-       lists */
+       lists. With a partial redraw, the area covered by the removed data
+       isn't known anymore, so everything has to be redrawn. Cached contents
+       may contain the removed data as well. */
     state.state |= UserInterfaceState::NeedsDataAttachmentUpdate;
+    state.dataOrderNeedsUpdate = true;
+    state.redrawAll = true;
+    for(Implementation::NodeCache& i: state.nodeCaches)
+        i.valid = false;
 }
 
 void AbstractUserInterface::attachData(const NodeHandle node, const DataHandle data) {
@@ -1082,6 +1401,19 @@ void AbstractUserInterface::attachData(const NodeHandle node, const DataHandle d
        nothing to set here */
 }
 
+void AbstractUserInterface::attachData(const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<const DataHandle>& data) {
+    CORRADE_ASSERT(data.size() == nodes.size(),
+        "Ui::AbstractUserInterface::attachData(): expected" << nodes.size() << "data handles but got" << data.size(), );
+    State& state = *_state;
+    for(std::size_t i = 0; i != nodes.size(); ++i) {
+        CORRADE_ASSERT(nodes[i] == NodeHandle::Null || isHandleValid(nodes[i]),
+            "Ui::AbstractUserInterface::attachData(): invalid handle" << nodes[i] << "at index" << i, );
+        CORRADE_ASSERT(isHandleValid(data[i]),
+            "Ui::AbstractUserInterface::attachData(): invalid handle" << data[i] << "at index" << i, );
+        state.layers[dataHandleLayerId(data[i])].used.instance->attach(dataHandleData(data[i]), nodes[i]);
+    }
+}
+
 std::size_t AbstractUserInterface::layouterCapacity() const {
     return _state->layouters.size();
 }
@@ -1169,6 +1501,8 @@ LayouterHandle AbstractUserInterface::layouterNext(LayouterHandle handle) const
 }
 
 LayouterHandle AbstractUserInterface::createLayouter(const LayouterHandle before) {
+    CORRADE_ASSERT(WithLayouters,
+        "Ui::AbstractUserInterface::createLayouter(): the library was built without MAGNUM_UI_WITH_LAYOUTERS", {});
     CORRADE_ASSERT(before == LayouterHandle::Null || isHandleValid(before),
         "Ui::AbstractUserInterface::createLayouter(): invalid before handle" << before, {});
 
@@ -1239,6 +1573,7 @@ AbstractLayouter& AbstractUserInterface::setLayouterInstance(Containers::Pointer
         "Ui::AbstractUserInterface::setLayouterInstance(): instance for" << handle << "already set", *state.layouters[0].used.instance);
     Layouter& layouter = state.layouters[id];
     layouter.used.instance = Utility::move(instance);
+    layouter.used.features = layouter.used.instance->features();
 
     /* If the size is already set, immediately proxy it to the layouter. If it
        isn't, it gets done during the next setSize() call. */
@@ -1290,6 +1625,7 @@ void AbstractUserInterface::removeLayouter(const LayouterHandle handle) {
        layouter is either free or is newly created until setLayouterInstance()
        is called, which is used for iterating them in clean() and update(). */
     layouter.used.instance = nullptr;
+    layouter.used.features = {};
 
     /* Increase the layouter generation so existing handles pointing to this
        layouter are invalidated */
@@ -1426,6 +1762,8 @@ AbstractGenericAnimator& AbstractUserInterface::setGenericAnimatorInstance(Conta
 }
 
 AbstractNodeAnimator& AbstractUserInterface::setNodeAnimatorInstance(Containers::Pointer<AbstractNodeAnimator>&& instance) {
+    CORRADE_ASSERT(WithNodeAnimators,
+        "Ui::AbstractUserInterface::setNodeAnimatorInstance(): the library was built without MAGNUM_UI_WITH_NODE_ANIMATORS", *instance);
     /* Null instance checked in setAnimatorInstanceInternal() below, avoid
        accessing it here */
     CORRADE_ASSERT(!instance || instance->features() >= AnimatorFeature::NodeAttachment,
@@ -1627,6 +1965,96 @@ std::size_t AbstractUserInterface::nodeCapacity() const {
     return _state->nodes.size();
 }
 
+void AbstractUserInterface::reserveNodes(const std::size_t capacity) {
+    CORRADE_ASSERT(capacity <= 1 << Implementation::NodeHandleIdBits,
+        "Ui::AbstractUserInterface::reserveNodes(): can only have at most" << (1 << Implementation::NodeHandleIdBits) << "nodes but got" << capacity, );
+    State& state = *_state;
+    arrayReserve(state.nodes, capacity);
+    arrayReserve(state.nodeParents, capacity);
+    arrayReserve(state.nodeFlags, capacity);
+}
+
+std::size_t AbstractUserInterface::fixedNodeCapacity() const {
+    return _state->fixedNodeCapacity;
+}
+
+AbstractUserInterface& AbstractUserInterface::setFixedNodeCapacity(const std::size_t capacity) {
+    State& state = *_state;
+    CORRADE_ASSERT(capacity <= 1 << Implementation::NodeHandleIdBits,
+        "Ui::AbstractUserInterface::setFixedNodeCapacity(): can only have at most" << (1 << Implementation::NodeHandleIdBits) << "nodes but got" << capacity, *this);
+    CORRADE_ASSERT(!capacity || capacity >= state.nodes.size(),
+        "Ui::AbstractUserInterface::setFixedNodeCapacity(): capacity" << capacity << "is less than current node capacity" << state.nodes.size(), *this);
+    reserveNodes(capacity);
+    state.fixedNodeCapacity = capacity;
+    return *this;
+}
+
+bool AbstractUserInterface::isNodeStorageFull() const {
+    const State& state = *_state;
+    return state.fixedNodeCapacity &&
+           state.firstFreeNode == ~UnsignedInt{} &&
+           state.nodes.size() == state.fixedNodeCapacity;
+}
+
+MemoryUsage AbstractUserInterface::memoryUsage() const {
+    const State& state = *_state;
+    MemoryUsage out{};
+
+    Implementation::addArrayMemoryUsage(out, state.layers);
+    Implementation::addArrayMemoryUsage(out, state.layouters);
+    Implementation::addArrayMemoryUsage(out, state.animators);
+    Implementation::addArrayMemoryUsage(out, state.animatorInstances);
+    Implementation::addArrayMemoryUsage(out, state.nodes);
+    Implementation::addArrayMemoryUsage(out, state.nodeParents);
+    Implementation::addArrayMemoryUsage(out, state.nodeFlags);
+    Implementation::addArrayMemoryUsage(out, state.nodeOrder);
+    Implementation::addArrayMemoryUsage(out, state.coalescedPointerMoves);
+    Implementation::addArrayMemoryUsage(out, state.updateStorage);
+    Implementation::addArrayMemoryUsage(out, state.updateStatisticsLayerDataCounts);
+    Implementation::addArrayMemoryUsage(out, state.frameLayerStates);
+    Implementation::addArrayMemoryUsage(out, state.frameLayerUploadedSizes);
+    Implementation::addArrayMemoryUsage(out, state.updateStatisticsLayerStates);
+    Implementation::addArrayMemoryUsage(out, state.updateStatisticsLayerUploadedSizes);
+    Implementation::addArrayMemoryUsage(out, state.nodeStateStorage);
+    Implementation::addArrayMemoryUsage(out, state.nodeChildrenStorage);
+    Implementation::addArrayMemoryUsage(out, state.dirtyTopLevelNodeIds);
+    Implementation::addArrayMemoryUsage(out, state.layoutStateStorage);
+    Implementation::addArrayMemoryUsage(out, state.dirtyLayoutRootNodeIds);
+    Implementation::addArrayMemoryUsage(out, state.dataStateStorage);
+    Implementation::addArrayMemoryUsage(out, state.visibleNodeHitTestGrids);
+    Implementation::addArrayMemoryUsage(out, state.hitTestGrids);
+    Implementation::addArrayMemoryUsage(out, state.hitTestGridCellOffsets);
+    Implementation::addArrayMemoryUsage(out, state.hitTestGridCellChildren);
+    Implementation::addArrayMemoryUsage(out, state.redrawNodes);
+    Implementation::addArrayMemoryUsage(out, state.nodeCaches);
+    Implementation::addArrayMemoryUsage(out, state.cacheNodes);
+    out.cpuUnused += (state.nodes.size() - nodeUsedCount())*(sizeof(Node) + sizeof(NodeHandle) + sizeof(NodeFlags));
+
+    for(const Layer& layer: state.layers)
+        if(const AbstractLayer* const instance = layer.used.instance.get())
+            out += instance->memoryUsage();
+    for(const Layouter& layouter: state.layouters)
+        if(const AbstractLayouter* const instance = layouter.used.instance.get())
+            out += instance->memoryUsage();
+    for(const Animator& animator: state.animators)
+        if(const AbstractAnimator* const instance = animator.used.instance.get())
+            out += instance->memoryUsage();
+
+    return out;
+}
+
+AbstractUserInterface& AbstractUserInterface::trim() {
+    /* Trimming can only drop data that are actually removed, so remove all
+       data attached to removed nodes first */
+    clean();
+
+    for(Layer& layer: _state->layers)
+        if(AbstractLayer* const instance = layer.used.instance.get())
+            instance->trim();
+
+    return *this;
+}
+
 std::size_t AbstractUserInterface::nodeUsedCount() const {
     /* The "pointer" chasing in here is a bit nasty, but there's no other way
        to know which nodes are actually used and which not. The parent is Null
@@ -1667,6 +2095,28 @@ NodeHandle AbstractUserInterface::createNode(const NodeHandle parent, const Vect
     CORRADE_ASSERT(parent == NodeHandle::Null || isHandleValid(parent),
         "Ui::AbstractUserInterface::createNode(): invalid parent handle" << parent, {});
 
+    const NodeHandle handle = createNodeInternal(
+        #ifndef CORRADE_NO_ASSERT
+        "Ui::AbstractUserInterface::createNode():",
+        #endif
+        parent, offset, size, flags);
+
+    /* Mark the UI as needing an update() call to refresh node state. The
+       cached node children lists don't contain the new node, so the node
+       order has to be fully rebuilt. */
+    State& state = *_state;
+    state.state |= UserInterfaceState::NeedsNodeUpdate;
+    state.visibleNodeOrderNeedsFullUpdate = true;
+
+    return handle;
+}
+
+NodeHandle AbstractUserInterface::createNodeInternal(
+    #ifndef CORRADE_NO_ASSERT
+    const char* const messagePrefix,
+    #endif
+    const NodeHandle parent, const Vector2& offset, const Vector2& size, const NodeFlags flags)
+{
     /* Find the first free node if there is, update the free index to
        point to the next one (or none) */
     Node* node;
@@ -1684,19 +2134,35 @@ NodeHandle AbstractUserInterface::createNode(const NodeHandle parent, const Vect
     /* If there isn't, allocate a new one */
     } else {
         CORRADE_ASSERT(state.nodes.size() < 1 << Implementation::NodeHandleIdBits,
-            "Ui::AbstractUserInterface::createNode(): can only have at most" << (1 << Implementation::NodeHandleIdBits) << "nodes", {});
+            messagePrefix << "can only have at most" << (1 << Implementation::NodeHandleIdBits) << "nodes", {});
+        CORRADE_ASSERT(!state.fixedNodeCapacity || state.nodes.size() < state.fixedNodeCapacity,
+            messagePrefix << "fixed node capacity of" << state.fixedNodeCapacity << "exhausted", {});
         node = &arrayAppend(state.nodes, InPlaceInit);
+        arrayAppend(state.nodeParents, NoInit, 1);
+        arrayAppend(state.nodeFlags, NoInit, 1);
     }
 
     /* Fill the data. In both above cases the generation is already set
        appropriately, either initialized to 1, or incremented when it got
        remove()d (to mark existing handles as invalid) */
-    node->used.parent = parent;
-    node->used.flags = flags;
+    const UnsignedInt id = node - state.nodes;
+    state.nodeParents[id] = parent;
+    state.nodeFlags[id] = flags;
     node->used.offset = offset;
     node->used.size = size;
     node->used.opacity = 1.0f;
-    const NodeHandle handle = nodeHandle(node - state.nodes, node->used.generation);
+    node->used.firstChild = ~UnsignedInt{};
+    const NodeHandle handle = nodeHandle(id, node->used.generation);
+
+    /* If not a root node, put it at the front of the parent children list */
+    if(parent != NodeHandle::Null) {
+        Node& parentNode = state.nodes[nodeHandleId(parent)];
+        node->used.previousSibling = ~UnsignedInt{};
+        node->used.nextSibling = parentNode.used.firstChild;
+        if(parentNode.used.firstChild != ~UnsignedInt{})
+            state.nodes[parentNode.used.firstChild].used.previousSibling = id;
+        parentNode.used.firstChild = id;
+    }
 
     /* If a root node, implicitly mark it as last in the node order, so
        it's drawn at the front. The setNodeOrder() internally reconnects, so
@@ -1705,12 +2171,47 @@ NodeHandle AbstractUserInterface::createNode(const NodeHandle parent, const Vect
     if(parent == NodeHandle::Null)
         setNodeOrder(handle, NodeHandle::Null);
 
-    /* Mark the UI as needing an update() call to refresh node state */
-    state.state |= UserInterfaceState::NeedsNodeUpdate;
-
     return handle;
 }
 
+void AbstractUserInterface::createNodes(const Containers::StridedArrayView1D<const NodeHandle>& parents, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const NodeFlags>& flags, const Containers::StridedArrayView1D<NodeHandle>& handles) {
+    CORRADE_ASSERT(offsets.size() == parents.size() &&
+                   sizes.size() == parents.size() &&
+                   (flags.isEmpty() || flags.size() == parents.size()) &&
+                   handles.size() == parents.size(),
+        "Ui::AbstractUserInterface::createNodes(): expected offset, size, flag and handle views to have a size of" << parents.size() << "but got" << offsets.size() << Debug::nospace << "," << sizes.size() << Debug::nospace << "," << flags.size() << "and" << handles.size(), );
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != parents.size(); ++i)
+        CORRADE_ASSERT(parents[i] == NodeHandle::Null || isHandleValid(parents[i]),
+            "Ui::AbstractUserInterface::createNodes(): invalid parent handle" << parents[i] << "at index" << i, );
+    #endif
+
+    /* Nothing to do, don't mark any state dirty */
+    if(parents.isEmpty())
+        return;
+
+    /* Reserve the node array upfront so it's reallocated at most once. Free
+       nodes get reused first, so this is an upper bound. With a fixed
+       capacity the storage is already reserved in full. */
+    State& state = *_state;
+    const std::size_t reserveSize = Math::min(state.nodes.size() + parents.size(), state.fixedNodeCapacity ? std::size_t{state.fixedNodeCapacity} : std::size_t{1} << Implementation::NodeHandleIdBits);
+    arrayReserve(state.nodes, reserveSize);
+    arrayReserve(state.nodeParents, reserveSize);
+    arrayReserve(state.nodeFlags, reserveSize);
+
+    for(std::size_t i = 0; i != parents.size(); ++i)
+        handles[i] = createNodeInternal(
+            #ifndef CORRADE_NO_ASSERT
+            "Ui::AbstractUserInterface::createNodes():",
+            #endif
+            parents[i], offsets[i], sizes[i], flags.isEmpty() ? NodeFlags{} : flags[i]);
+
+    /* Mark the UI as needing an update() call to refresh node state, same as
+       in createNode() */
+    state.state |= UserInterfaceState::NeedsNodeUpdate;
+    state.visibleNodeOrderNeedsFullUpdate = true;
+}
+
 NodeHandle AbstractUserInterface::createNode(const Vector2& offset, const Vector2& size, const NodeFlags flags) {
     return createNode(NodeHandle::Null, offset, size, flags);
 }
@@ -1718,7 +2219,7 @@ NodeHandle AbstractUserInterface::createNode(const Vector2& offset, const Vector
 NodeHandle AbstractUserInterface::nodeParent(const NodeHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::nodeParent(): invalid handle" << handle, {});
-    return _state->nodes[nodeHandleId(handle)].used.parent;
+    return _state->nodeParents[nodeHandleId(handle)];
 }
 
 Vector2 AbstractUserInterface::nodeOffset(const NodeHandle handle) const {
@@ -1733,8 +2234,7 @@ void AbstractUserInterface::setNodeOffset(const NodeHandle handle, const Vector2
     State& state = *_state;
     state.nodes[nodeHandleId(handle)].used.offset = offset;
 
-    /* Mark the UI as needing an update() call to refresh node layout state */
-    state.state |= UserInterfaceState::NeedsLayoutUpdate;
+    setNodeLayoutDirtyInternal(nodeHandleId(handle));
 }
 
 Vector2 AbstractUserInterface::nodeSize(const NodeHandle handle) const {
@@ -1749,8 +2249,107 @@ void AbstractUserInterface::setNodeSize(const NodeHandle handle, const Vector2&
     State& state = *_state;
     state.nodes[nodeHandleId(handle)].used.size = size;
 
+    setNodeLayoutDirtyInternal(nodeHandleId(handle));
+}
+
+void AbstractUserInterface::setNodeOffsets(const Containers::StridedArrayView1D<const NodeHandle>& handles, const Containers::StridedArrayView1D<const Vector2>& offsets) {
+    CORRADE_ASSERT(offsets.size() == handles.size(),
+        "Ui::AbstractUserInterface::setNodeOffsets(): expected handle and offset views to have the same size but got" << handles.size() << "and" << offsets.size(), );
+    /* Check all handles first to not end up with just a part of the nodes
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractUserInterface::setNodeOffsets(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    /* Nothing to do, don't mark any state dirty */
+    if(handles.isEmpty())
+        return;
+
+    State& state = *_state;
+    for(std::size_t i = 0; i != offsets.size(); ++i) {
+        const UnsignedInt id = nodeHandleId(handles[i]);
+        state.nodes[id].used.offset = offsets[i];
+        setNodeLayoutDirtyInternal(id);
+    }
+}
+
+void AbstractUserInterface::setNodeOffsets(const UnsignedInt firstNodeId, const Containers::StridedArrayView1D<const Vector2>& offsets) {
+    CORRADE_ASSERT(firstNodeId + offsets.size() <= _state->nodes.size(),
+        "Ui::AbstractUserInterface::setNodeOffsets(): expected node ID range to end at most at" << _state->nodes.size() << "but got" << firstNodeId << "+" << offsets.size(), );
+
+    /* Nothing to do, don't mark any state dirty */
+    if(offsets.isEmpty())
+        return;
+
+    State& state = *_state;
+    for(std::size_t i = 0; i != offsets.size(); ++i) {
+        const UnsignedInt id = firstNodeId + i;
+        state.nodes[id].used.offset = offsets[i];
+        setNodeLayoutDirtyInternal(id);
+    }
+}
+
+void AbstractUserInterface::setNodeSizes(const Containers::StridedArrayView1D<const NodeHandle>& handles, const Containers::StridedArrayView1D<const Vector2>& sizes) {
+    CORRADE_ASSERT(sizes.size() == handles.size(),
+        "Ui::AbstractUserInterface::setNodeSizes(): expected handle and size views to have the same size but got" << handles.size() << "and" << sizes.size(), );
+    /* Check all handles first to not end up with just a part of the nodes
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractUserInterface::setNodeSizes(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    /* Nothing to do, don't mark any state dirty */
+    if(handles.isEmpty())
+        return;
+
+    State& state = *_state;
+    for(std::size_t i = 0; i != sizes.size(); ++i) {
+        const UnsignedInt id = nodeHandleId(handles[i]);
+        state.nodes[id].used.size = sizes[i];
+        setNodeLayoutDirtyInternal(id);
+    }
+}
+
+void AbstractUserInterface::setNodeSizes(const UnsignedInt firstNodeId, const Containers::StridedArrayView1D<const Vector2>& sizes) {
+    CORRADE_ASSERT(firstNodeId + sizes.size() <= _state->nodes.size(),
+        "Ui::AbstractUserInterface::setNodeSizes(): expected node ID range to end at most at" << _state->nodes.size() << "but got" << firstNodeId << "+" << sizes.size(), );
+
+    /* Nothing to do, don't mark any state dirty */
+    if(sizes.isEmpty())
+        return;
+
+    State& state = *_state;
+    for(std::size_t i = 0; i != sizes.size(); ++i) {
+        const UnsignedInt id = firstNodeId + i;
+        state.nodes[id].used.size = sizes[i];
+        setNodeLayoutDirtyInternal(id);
+    }
+}
+
+void AbstractUserInterface::setNodeLayoutDirtyInternal(const UnsignedInt id) {
+    State& state = *_state;
+
     /* Mark the UI as needing an update() call to refresh node layout state */
     state.state |= UserInterfaceState::NeedsLayoutUpdate;
+
+    /* Only layouts in the hierarchy of the root node need to be updated again
+       in update(), mark it as such. If the node is a root node itself, its
+       layouts may depend on the UI size or on other root nodes, so everything
+       has to be updated. Same if too many are dirty already. */
+    if(!state.layoutNeedsFullUpdate) {
+        NodeHandle root = nodeHandle(id, state.nodes[id].used.generation);
+        if(state.nodeParents[id] == NodeHandle::Null || state.dirtyLayoutRootNodeIds.size() >= state.nodeOrder.size())
+            state.layoutNeedsFullUpdate = true;
+        else {
+            while(state.nodeParents[nodeHandleId(root)] != NodeHandle::Null)
+                root = state.nodeParents[nodeHandleId(root)];
+            arrayAppend(state.dirtyLayoutRootNodeIds, nodeHandleId(root));
+        }
+    }
 }
 
 Float AbstractUserInterface::nodeOpacity(const NodeHandle handle) const {
@@ -1770,18 +2369,88 @@ void AbstractUserInterface::setNodeOpacity(const NodeHandle handle, const Float
     state.state |= UserInterfaceState::NeedsNodeOpacityUpdate;
 }
 
+void AbstractUserInterface::setNodeOpacities(const Containers::StridedArrayView1D<const NodeHandle>& handles, const Containers::StridedArrayView1D<const Float>& opacities) {
+    CORRADE_ASSERT(opacities.size() == handles.size(),
+        "Ui::AbstractUserInterface::setNodeOpacities(): expected handle and opacity views to have the same size but got" << handles.size() << "and" << opacities.size(), );
+    /* Check all handles first to not end up with just a part of the nodes
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractUserInterface::setNodeOpacities(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    /* Nothing to do, don't mark any state dirty */
+    if(handles.isEmpty())
+        return;
+
+    State& state = *_state;
+    for(std::size_t i = 0; i != opacities.size(); ++i)
+        state.nodes[nodeHandleId(handles[i])].used.opacity = opacities[i];
+
+    /* Mark the UI as needing an update() call to refresh calculated node
+       opacities */
+    state.state |= UserInterfaceState::NeedsNodeOpacityUpdate;
+}
+
+void AbstractUserInterface::setNodeOpacities(const UnsignedInt firstNodeId, const Containers::StridedArrayView1D<const Float>& opacities) {
+    CORRADE_ASSERT(firstNodeId + opacities.size() <= _state->nodes.size(),
+        "Ui::AbstractUserInterface::setNodeOpacities(): expected node ID range to end at most at" << _state->nodes.size() << "but got" << firstNodeId << "+" << opacities.size(), );
+
+    /* Nothing to do, don't mark any state dirty */
+    if(opacities.isEmpty())
+        return;
+
+    State& state = *_state;
+    for(std::size_t i = 0; i != opacities.size(); ++i)
+        state.nodes[firstNodeId + i].used.opacity = opacities[i];
+
+    /* Mark the UI as needing an update() call to refresh calculated node
+       opacities */
+    state.state |= UserInterfaceState::NeedsNodeOpacityUpdate;
+}
+
 NodeFlags AbstractUserInterface::nodeFlags(const NodeHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::nodeFlags(): invalid handle" << handle, {});
-    return _state->nodes[nodeHandleId(handle)].used.flags;
+    return _state->nodeFlags[nodeHandleId(handle)];
+}
+
+namespace {
+
+NodeHandle closestTopLevelParent(const Containers::ArrayView<const Node> nodes, const Containers::ArrayView<const NodeHandle> nodeParents, NodeHandle node) {
+    /* Root nodes have `order` always allocated, so it should stop at those. */
+    NodeHandle parent = nodeParents[nodeHandleId(node)];
+    for(;;) {
+        const UnsignedInt parentId = nodeHandleId(parent);
+        if(nodes[parentId].used.order != ~UnsignedInt{})
+            return parent;
+        parent = nodeParents[parentId];
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+}
+
 }
 
 void AbstractUserInterface::setNodeFlagsInternal(const UnsignedInt id, const NodeFlags flags) {
     State& state = *_state;
-    if((state.nodes[id].used.flags & NodeFlag::Hidden) != (flags & NodeFlag::Hidden))
+    if((state.nodeFlags[id] & NodeFlag::Hidden) != (flags & NodeFlag::Hidden)) {
         state.state |= UserInterfaceState::NeedsNodeUpdate;
-    if((state.nodes[id].used.flags & NodeFlag::Clip) != (flags & NodeFlag::Clip))
+
+        /* Only the hierarchy under the closest top-level node needs to be
+           ordered again in update(), mark it as such. If too many are dirty
+           already, it's faster to order everything again. */
+        if(!state.visibleNodeOrderNeedsFullUpdate) {
+            if(state.dirtyTopLevelNodeIds.size() >= state.nodeOrder.size())
+                state.visibleNodeOrderNeedsFullUpdate = true;
+            else arrayAppend(state.dirtyTopLevelNodeIds, state.nodes[id].used.order != ~UnsignedInt{} ? id : nodeHandleId(closestTopLevelParent(state.nodes, state.nodeParents, nodeHandle(id, state.nodes[id].used.generation))));
+        }
+    }
+    if((state.nodeFlags[id] & NodeFlag::Clip) != (flags & NodeFlag::Clip)) {
         state.state |= UserInterfaceState::NeedsNodeClipUpdate;
+        state.dataOrderNeedsUpdate = true;
+    }
     /* Right now Focusable wouldn't need the full NeedsNodeEnabledUpdate, just
        something that triggers state.currentFocusedNode update. But eventually
        there will be focusable node fallbacks / trees (where pressing on a node
@@ -1793,14 +2462,24 @@ void AbstractUserInterface::setNodeFlagsInternal(const UnsignedInt id, const Nod
         NeedsDataUpdate .. with that, update() would re-query state() after
         calling visibilityLostEvent() (if at all), and perform layer updates if
         NeedsDataUpdate or anything else is set afterwards */
-    if((state.nodes[id].used.flags & (NodeFlag::NoEvents|NodeFlag::Disabled|NodeFlag::Focusable)) != (flags & (NodeFlag::NoEvents|NodeFlag::Disabled|NodeFlag::Focusable)))
+    if((state.nodeFlags[id] & (NodeFlag::NoEvents|NodeFlag::Disabled|NodeFlag::Focusable)) != (flags & (NodeFlag::NoEvents|NodeFlag::Disabled|NodeFlag::Focusable))) {
         state.state |= UserInterfaceState::NeedsNodeEnabledUpdate;
+        state.dataOrderNeedsUpdate = true;
+    }
     /* Unlike NoEvents, Disabled or Focusable this doesn't affect current state
        in any way, only changes how future events behave, so it's a separate
        state flag */
-    if((state.nodes[id].used.flags & NodeFlag::NoBlur) != (flags & NodeFlag::NoBlur))
+    if((state.nodeFlags[id] & NodeFlag::NoBlur) != (flags & NodeFlag::NoBlur))
         state.state |= UserInterfaceState::NeedsNodeEventMaskUpdate;
-    state.nodes[id].used.flags = flags;
+    /* Doesn't affect any state, only the cached fallthrough parent query */
+    if((state.nodeFlags[id] & NodeFlag::FallthroughPointerEvents) != (flags & NodeFlag::FallthroughPointerEvents))
+        state.fallthroughCheckedNode = NodeHandle::Null;
+    /* Nodes drawn from a cache are collected when building the draw list */
+    if((state.nodeFlags[id] & NodeFlag::Cached) != (flags & NodeFlag::Cached)) {
+        state.state |= UserInterfaceState::NeedsDataAttachmentUpdate;
+        state.dataOrderNeedsUpdate = true;
+    }
+    state.nodeFlags[id] = flags;
 }
 
 void AbstractUserInterface::setNodeFlags(const NodeHandle handle, const NodeFlags flags) {
@@ -1813,14 +2492,45 @@ void AbstractUserInterface::addNodeFlags(const NodeHandle handle, const NodeFlag
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::addNodeFlags(): invalid handle" << handle, );
     const UnsignedInt id = nodeHandleId(handle);
-    setNodeFlagsInternal(id, _state->nodes[id].used.flags|flags);
+    setNodeFlagsInternal(id, _state->nodeFlags[id]|flags);
 }
 
 void AbstractUserInterface::clearNodeFlags(const NodeHandle handle, const NodeFlags flags) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::clearNodeFlags(): invalid handle" << handle, );
     const UnsignedInt id = nodeHandleId(handle);
-    setNodeFlagsInternal(id, _state->nodes[id].used.flags & ~flags);
+    setNodeFlagsInternal(id, _state->nodeFlags[id] & ~flags);
+}
+
+void AbstractUserInterface::setNodeFlags(const Containers::StridedArrayView1D<const NodeHandle>& handles, const Containers::StridedArrayView1D<const NodeFlags>& flags) {
+    CORRADE_ASSERT(flags.size() == handles.size(),
+        "Ui::AbstractUserInterface::setNodeFlags(): expected handle and flag views to have the same size but got" << handles.size() << "and" << flags.size(), );
+    /* Check all handles first to not end up with just a part of the nodes
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractUserInterface::setNodeFlags(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    /* Nothing to do, don't mark any state dirty */
+    if(handles.isEmpty())
+        return;
+
+    for(std::size_t i = 0; i != flags.size(); ++i)
+        setNodeFlagsInternal(nodeHandleId(handles[i]), flags[i]);
+}
+
+void AbstractUserInterface::setNodeFlags(const UnsignedInt firstNodeId, const Containers::StridedArrayView1D<const NodeFlags>& flags) {
+    CORRADE_ASSERT(firstNodeId + flags.size() <= _state->nodes.size(),
+        "Ui::AbstractUserInterface::setNodeFlags(): expected node ID range to end at most at" << _state->nodes.size() << "but got" << firstNodeId << "+" << flags.size(), );
+
+    /* Nothing to do, don't mark any state dirty */
+    if(flags.isEmpty())
+        return;
+
+    for(std::size_t i = 0; i != flags.size(); ++i)
+        setNodeFlagsInternal(firstNodeId + i, flags[i]);
 }
 
 void AbstractUserInterface::removeNode(const NodeHandle handle) {
@@ -1833,10 +2543,33 @@ void AbstractUserInterface::removeNode(const NodeHandle handle) {
     _state->state |= UserInterfaceState::NeedsNodeClean;
 }
 
+void AbstractUserInterface::removeNodes(const Containers::StridedArrayView1D<const NodeHandle>& handles) {
+    /* Nothing to do, don't mark any state dirty */
+    if(handles.isEmpty())
+        return;
+
+    for(std::size_t i = 0; i != handles.size(); ++i) {
+        /* Checking in the loop and not upfront in order to catch duplicates,
+           as the handles get invalidated right after removal */
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractUserInterface::removeNodes(): invalid handle" << handles[i] << "at index" << i, );
+        removeNodeInternal(nodeHandleId(handles[i]));
+    }
+
+    /* Mark the UI as needing a clean() call to refresh node state. The
+       nested nodes and attachments of the whole batch get removed in a
+       single pass there. */
+    _state->state |= UserInterfaceState::NeedsNodeClean;
+}
+
 inline void AbstractUserInterface::removeNodeInternal(const UnsignedInt id) {
     State& state = *_state;
     Node& node = state.nodes[id];
 
+    /* The cached node children lists used for visible node ordering contain
+       the node, so they have to be rebuilt in update() */
+    state.visibleNodeOrderNeedsFullUpdate = true;
+
     /* If this was a top-level node, disconnect it from the node order list and
        put (it including its potential nested top-level nodes) to the free
        list.
@@ -1866,14 +2599,42 @@ inline void AbstractUserInterface::removeNodeInternal(const UnsignedInt id) {
            NeedsNodeClean) in order to even enter clean(), which calls here */
     }
 
+    /* If the node isn't a root node, disconnect it from the children list
+       it's in. If the parent is still valid, it's the list of the parent,
+       otherwise it's the list of orphaned nodes. */
+    NodeHandle& parent = state.nodeParents[id];
+    if(parent != NodeHandle::Null) {
+        UnsignedInt& first = isHandleValid(parent) ?
+            state.nodes[nodeHandleId(parent)].used.firstChild :
+            state.firstOrphanNode;
+        if(node.used.previousSibling == ~UnsignedInt{}) {
+            CORRADE_INTERNAL_ASSERT(first == id);
+            first = node.used.nextSibling;
+        } else state.nodes[node.used.previousSibling].used.nextSibling = node.used.nextSibling;
+        if(node.used.nextSibling != ~UnsignedInt{})
+            state.nodes[node.used.nextSibling].used.previousSibling = node.used.previousSibling;
+    }
+
+    /* Move the children, if any, to the front of the orphaned node list, from
+       where clean() subsequently removes them */
+    if(node.used.firstChild != ~UnsignedInt{}) {
+        UnsignedInt lastChild = node.used.firstChild;
+        while(state.nodes[lastChild].used.nextSibling != ~UnsignedInt{})
+            lastChild = state.nodes[lastChild].used.nextSibling;
+        state.nodes[lastChild].used.nextSibling = state.firstOrphanNode;
+        if(state.firstOrphanNode != ~UnsignedInt{})
+            state.nodes[state.firstOrphanNode].used.previousSibling = lastChild;
+        state.firstOrphanNode = node.used.firstChild;
+        node.used.firstChild = ~UnsignedInt{};
+    }
+
     /* Increase the node generation so existing handles pointing to this
        node are invalidated */
     ++node.used.generation;
 
-    /* Parent the node to the root to prevent it from being removed again in
-       clean() when its parents get removed as well. Removing more than once
-       would lead to cycles in the free list. */
-    node.used.parent = NodeHandle::Null;
+    /* Parent the node to the root to mark it as not being in any children
+       list anymore */
+    parent = NodeHandle::Null;
 
     /* If the generation wrapped around, exit without putting it to the free
        list. That makes it disabled, i.e. impossible to be recycled later, to
@@ -1972,6 +2733,74 @@ NodeHandle AbstractUserInterface::nodeOrderNext(const NodeHandle handle) const {
     return next;
 }
 
+namespace {
+
+#ifndef CORRADE_NO_ASSERT
+/* Whether the node is reachable from firstNodeOrder, i.e. the node and all its
+   top-level parents are connected */
+bool isNodeOrderConnected(const Containers::ArrayView<const Node> nodes, const Containers::ArrayView<const NodeHandle> nodeParents, const Containers::ArrayView<const NodeOrder> nodeOrder, NodeHandle node) {
+    for(;;) {
+        const UnsignedInt id = nodeHandleId(node);
+        const UnsignedInt order = nodes[id].used.order;
+        if(order != ~UnsignedInt{} && nodeOrder[order].used.previous == NodeHandle::Null)
+            return false;
+        const NodeHandle parent = nodeParents[id];
+        if(parent == NodeHandle::Null)
+            return true;
+        node = parent;
+    }
+}
+#endif
+
+/* Distributes the keys evenly across the whole 32-bit range, leaving 0 unused
+   so there's always a gap in front of the first node as well */
+void updateNodeOrderKeys(const Containers::ArrayView<const Node> nodes, const Containers::ArrayView<NodeOrder> nodeOrder, const NodeHandle firstNodeOrder) {
+    if(firstNodeOrder == NodeHandle::Null)
+        return;
+
+    std::size_t count = 0;
+    NodeHandle node = firstNodeOrder;
+    do {
+        ++count;
+        node = nodeOrder[nodes[nodeHandleId(node)].used.order].used.next;
+    } while(node != firstNodeOrder);
+
+    const UnsignedLong step = (UnsignedLong{1} << 32)/(count + 1);
+    UnsignedLong key = step;
+    node = firstNodeOrder;
+    do {
+        NodeOrder& order = nodeOrder[nodes[nodeHandleId(node)].used.order];
+        order.used.key = key;
+        key += step;
+        node = order.used.next;
+    } while(node != firstNodeOrder);
+}
+
+}
+
+bool AbstractUserInterface::isNodeOrderedBehind(const NodeHandle handle, const NodeHandle other) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::AbstractUserInterface::isNodeOrderedBehind(): invalid handle" << handle, {});
+    CORRADE_ASSERT(isHandleValid(other),
+        "Ui::AbstractUserInterface::isNodeOrderedBehind(): invalid other handle" << other, {});
+    /* The keys are recalculated lazily, which needs the state to be
+       mutable */
+    State& state = *_state;
+    const UnsignedInt order = state.nodes[nodeHandleId(handle)].used.order;
+    const UnsignedInt otherOrder = state.nodes[nodeHandleId(other)].used.order;
+    CORRADE_ASSERT(order != ~UnsignedInt{} && isNodeOrderConnected(state.nodes, state.nodeParents, state.nodeOrder, handle),
+        "Ui::AbstractUserInterface::isNodeOrderedBehind():" << handle << "is not in the draw order", {});
+    CORRADE_ASSERT(otherOrder != ~UnsignedInt{} && isNodeOrderConnected(state.nodes, state.nodeParents, state.nodeOrder, other),
+        "Ui::AbstractUserInterface::isNodeOrderedBehind():" << other << "is not in the draw order", {});
+
+    if(!state.nodeOrderKeysValid) {
+        updateNodeOrderKeys(state.nodes, state.nodeOrder, state.firstNodeOrder);
+        state.nodeOrderKeysValid = true;
+    }
+
+    return state.nodeOrder[order].used.key < state.nodeOrder[otherOrder].used.key;
+}
+
 NodeHandle AbstractUserInterface::nodeOrderLastNested(const NodeHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::nodeOrderNext(): invalid handle" << handle, {});
@@ -1987,9 +2816,10 @@ namespace {
 /* Used by clearNodeOrderInternal(), setNodeOrder() and flattenNodeOrder(). Not
    all tests for each of the 3 exercise all corner cases (while vs if, break
    with/without else), but in total they do. */
-void updateParentLastNestedOrderTo(const Containers::ArrayView<const Node> nodes, const Containers::ArrayView<NodeOrder> nodeOrder, NodeHandle parent, const NodeHandle lastNested, const NodeHandle replace) {
+void updateParentLastNestedOrderTo(const Containers::ArrayView<const Node> nodes, const Containers::ArrayView<const NodeHandle> nodeParents, const Containers::ArrayView<NodeOrder> nodeOrder, NodeHandle parent, const NodeHandle lastNested, const NodeHandle replace) {
     while(parent != NodeHandle::Null) {
-        const Node& parentNode = nodes[nodeHandleId(parent)];
+        const UnsignedInt parentId = nodeHandleId(parent);
+        const Node& parentNode = nodes[parentId];
         if(parentNode.used.order != ~UnsignedInt{}) {
             NodeOrder& parentOrder = nodeOrder[parentNode.used.order];
             if(parentOrder.used.lastNested == lastNested)
@@ -2000,7 +2830,7 @@ void updateParentLastNestedOrderTo(const Containers::ArrayView<const Node> nodes
                ending at lastNested, so we can stop here. */
             else break;
         }
-        parent = parentNode.used.parent;
+        parent = nodeParents[parentId];
     }
 }
 
@@ -2010,6 +2840,7 @@ void updateParentLastNestedOrderTo(const Containers::ArrayView<const Node> nodes
 bool AbstractUserInterface::clearNodeOrderInternal(const NodeHandle handle) {
     State& state = *_state;
     Node& node = state.nodes[nodeHandleId(handle)];
+    const NodeHandle parent = state.nodeParents[nodeHandleId(handle)];
     const UnsignedInt order = node.used.order;
     CORRADE_INTERNAL_ASSERT(order != ~UnsignedInt{});
 
@@ -2040,7 +2871,7 @@ bool AbstractUserInterface::clearNodeOrderInternal(const NodeHandle handle) {
     }
     if(state.firstNodeOrder == handle) {
         /* The node can be first in order only if it's a root node */
-        CORRADE_INTERNAL_ASSERT(node.used.parent == NodeHandle::Null);
+        CORRADE_INTERNAL_ASSERT(parent == NodeHandle::Null);
         if(handle == originalNext)
             state.firstNodeOrder = NodeHandle::Null;
         else
@@ -2049,7 +2880,7 @@ bool AbstractUserInterface::clearNodeOrderInternal(const NodeHandle handle) {
 
     /* If lastNested was the last nested in any parent order, update it to
        point to the previous. Same logic is in flattenNodeOrder(). */
-    updateParentLastNestedOrderTo(state.nodes, state.nodeOrder, node.used.parent, lastNested, originalPrevious);
+    updateParentLastNestedOrderTo(state.nodes, state.nodeParents, state.nodeOrder, parent, lastNested, originalPrevious);
 
     /* Once we don't need the prev/next handles anymore, set them to null to
        mark the top-level node as not connected. The order is only recycled
@@ -2061,28 +2892,12 @@ bool AbstractUserInterface::clearNodeOrderInternal(const NodeHandle handle) {
     return true;
 }
 
-namespace {
-
-NodeHandle closestTopLevelParent(Containers::ArrayView<const Node> nodes, NodeHandle node) {
-    /* Root nodes have `order` always allocated, so it should stop at those. */
-    NodeHandle parent = nodes[nodeHandleId(node)].used.parent;
-    for(;;) {
-        const Node& parentNode = nodes[nodeHandleId(parent)];
-        if(parentNode.used.order != ~UnsignedInt{})
-            return parent;
-        parent = parentNode.used.parent;
-    }
-
-    CORRADE_INTERNAL_ASSERT_UNREACHABLE();
-}
-
-}
-
 void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHandle behind) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::setNodeOrder(): invalid handle" << handle, );
     State& state = *_state;
     Node& node = state.nodes[nodeHandleId(handle)];
+    const NodeHandle parent = state.nodeParents[nodeHandleId(handle)];
     #ifndef CORRADE_NO_ASSERT
     if(behind != NodeHandle::Null) {
         CORRADE_ASSERT(isHandleValid(behind),
@@ -2094,8 +2909,8 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
            that's too expensive to check for */
         CORRADE_ASSERT(next.used.order != ~UnsignedInt{} && state.nodeOrder[next.used.order].used.previous != NodeHandle::Null,
             "Ui::AbstractUserInterface::setNodeOrder():" << behind << "is not ordered", );
-        CORRADE_ASSERT((state.nodes[nodeHandleId(behind)].used.parent == NodeHandle::Null) == (node.used.parent == NodeHandle::Null),
-            "Ui::AbstractUserInterface::setNodeOrder():" << handle << (node.used.parent == NodeHandle::Null ? "is a root node but" : "is not a root node but") << behind << (node.used.parent == NodeHandle::Null ? "is not" : "is"), );
+        CORRADE_ASSERT((state.nodeParents[nodeHandleId(behind)] == NodeHandle::Null) == (parent == NodeHandle::Null),
+            "Ui::AbstractUserInterface::setNodeOrder():" << handle << (parent == NodeHandle::Null ? "is a root node but" : "is not a root node but") << behind << (parent == NodeHandle::Null ? "is not" : "is"), );
     }
     #endif
 
@@ -2128,7 +2943,13 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
            below (in which case lastNested is at the very least the node handle
            itself), as it needs to discover its nested nodes first. */
         state.nodeOrder[node.used.order].used.lastNested =
-            node.used.parent == NodeHandle::Null ? handle : NodeHandle::Null;
+            parent == NodeHandle::Null ? handle : NodeHandle::Null;
+
+        /* A non-root node that becomes top-level is no longer among children
+           of its parent, so the cached node children lists have to be
+           rebuilt in update() */
+        if(parent != NodeHandle::Null)
+            state.visibleNodeOrderNeedsFullUpdate = true;
 
     /* Otherwise remove it from the previous location in the linked list, if
        connected. The `node.used.order` stays the same -- it's reused. */
@@ -2145,7 +2966,7 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
     /* At this point, with the node order not being connected (yet or not
        anymore), we can figure out where to connect it. A root node can only
        connect to other root nodes, so this case is simpler. */
-    if(node.used.parent == NodeHandle::Null) {
+    if(parent == NodeHandle::Null) {
         /* If last, it gets attached after the last node and before the first
            node as the list is cyclic. If this is the first ordered node so
            far, the previous and next one is the node itself. */
@@ -2165,7 +2986,7 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
     /* For a non-root node we have to find the closest top-level parent
        first */
     } else {
-        const NodeHandle topLevelParent = closestTopLevelParent(state.nodes, handle);
+        const NodeHandle topLevelParent = closestTopLevelParent(state.nodes, state.nodeParents, handle);
         const NodeHandle topLevelParentLastNested = state.nodeOrder[state.nodes[nodeHandleId(topLevelParent)].used.order].used.lastNested;
         const NodeHandle topLevelParentLastNestedNext = state.nodeOrder[state.nodes[nodeHandleId(topLevelParentLastNested)].used.order].used.next;
 
@@ -2177,7 +2998,7 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
         /* Otherwise the node it's ordered before should be under the same
            nearest top-level parent */
         } else {
-            CORRADE_ASSERT(closestTopLevelParent(state.nodes, behind) == topLevelParent,
+            CORRADE_ASSERT(closestTopLevelParent(state.nodes, state.nodeParents, behind) == topLevelParent,
                 "Ui::AbstractUserInterface::setNodeOrder():" << behind << "doesn't share the nearest top-level parent with" << handle, );
             order.used.previous = state.nodeOrder[state.nodes[nodeHandleId(behind)].used.order].used.previous;
             next = behind;
@@ -2203,7 +3024,7 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
             while(topLevelParentNested != topLevelParentLastNestedNext) {
                 const NodeHandle topLevelParentNestedLastNested = state.nodeOrder[state.nodes[nodeHandleId(topLevelParentNested)].used.order].used.lastNested;
                 const NodeHandle topLevelParentNestedLastNestedNext = state.nodeOrder[state.nodes[nodeHandleId(topLevelParentNestedLastNested)].used.order].used.next;
-                CORRADE_ASSERT(closestTopLevelParent(state.nodes, topLevelParentNested) != handle,
+                CORRADE_ASSERT(closestTopLevelParent(state.nodes, state.nodeParents, topLevelParentNested) != handle,
                     "Ui::AbstractUserInterface::setNodeOrder(): creating a new top-level node with existing nested top-level nodes isn't implemented yet, sorry; clear the order or flatten it first", );
                 topLevelParentNested = topLevelParentNestedLastNestedNext;
             }
@@ -2235,7 +3056,7 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
        node as well. If this is not, firstNodeOrder can as well be null, for
        example if only connecting nested top-level nodes but the UI as a whole
        still hidden. */
-    if(node.used.parent == NodeHandle::Null) {
+    if(parent == NodeHandle::Null) {
         /* This is the first ever node to be in the order */
         if(state.firstNodeOrder == NodeHandle::Null)
             state.firstNodeOrder = handle;
@@ -2252,7 +3073,32 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
        wasn't inserted at the end, the previous lastNested all stay like
        before, so nothing needs to be adjusted. */
     } else if(behind == NodeHandle::Null) {
-        updateParentLastNestedOrderTo(state.nodes, state.nodeOrder, node.used.parent, order.used.previous, order.used.lastNested);
+        updateParentLastNestedOrderTo(state.nodes, state.nodeParents, state.nodeOrder, parent, order.used.previous, order.used.lastNested);
+    }
+
+    /* If the order keys are valid and this is a single root node, which is
+       the common case of reordering for example on hover, pick a key between
+       the neighbors. When appending or prepending, step by a fixed amount
+       instead of halving the remaining range, so repeated node creation
+       doesn't exhaust it too quickly. Everything else makes the keys
+       recalculated on the next query. */
+    if(state.nodeOrderKeysValid) {
+        if(parent == NodeHandle::Null && order.used.lastNested == handle) {
+            const bool first = state.firstNodeOrder == handle;
+            const bool last = next == state.firstNodeOrder || next == handle;
+            const UnsignedLong min = first ? 0 :
+                state.nodeOrder[state.nodes[nodeHandleId(order.used.previous)].used.order].used.key;
+            const UnsignedLong max = last ? UnsignedLong{1} << 32 :
+                state.nodeOrder[state.nodes[nodeHandleId(next)].used.order].used.key;
+            if(max - min < 2)
+                state.nodeOrderKeysValid = false;
+            else if(first == last)
+                order.used.key = min + (max - min)/2;
+            else if(last)
+                order.used.key = min + Math::min((max - min)/2, UnsignedLong{1} << 16);
+            else
+                order.used.key = max - Math::min((max - min)/2, UnsignedLong{1} << 16);
+        } else state.nodeOrderKeysValid = false;
     }
 
     /* Mark the UI as needing an update() call to refresh node state */
@@ -2283,7 +3129,8 @@ void AbstractUserInterface::flattenNodeOrder(const NodeHandle handle) {
         "Ui::AbstractUserInterface::flattenNodeOrder(): invalid handle" << handle, );
     State& state = *_state;
     Node& node = state.nodes[nodeHandleId(handle)];
-    CORRADE_ASSERT(node.used.parent != NodeHandle::Null,
+    const NodeHandle parent = state.nodeParents[nodeHandleId(handle)];
+    CORRADE_ASSERT(parent != NodeHandle::Null,
         "Ui::AbstractUserInterface::flattenNodeOrder():" << handle << "is a root node", );
 
     if(node.used.order == ~UnsignedInt{})
@@ -2298,71 +3145,176 @@ void AbstractUserInterface::flattenNodeOrder(const NodeHandle handle) {
 
     /* If lastNested was the last nested in any parent order, update it to
        point to the previous */
-    updateParentLastNestedOrderTo(state.nodes, state.nodeOrder, node.used.parent, order.used.lastNested, order.used.previous);
+    updateParentLastNestedOrderTo(state.nodes, state.nodeParents, state.nodeOrder, parent, order.used.lastNested, order.used.previous);
 
     order.free.next = state.firstFreeNodeOrder;
     state.firstFreeNodeOrder = node.used.order;
 
     node.used.order = ~UnsignedInt{};
 
-    /* Mark the UI as needing an update() call to refresh node state */
+    /* Mark the UI as needing an update() call to refresh node state. The node
+       now becomes one of the children of its parent again, so the cached node
+       children lists have to be rebuilt as well. */
+    state.visibleNodeOrderNeedsFullUpdate = true;
     /** @todo in this case only the draw / event processing order changes, but
         nothing that would affect layouters or cause node offsets/sizes to
         change -- is there a better state flag that would cover this? */
     state.state |= UserInterfaceState::NeedsNodeUpdate;
 }
 
-AbstractUserInterface& AbstractUserInterface::clean() {
-    /* Get the state including what bubbles from layers. If there's nothing to
-       clean, bail. */
-    const UserInterfaceStates states = this->state();
-    if(!(states >= UserInterfaceState::NeedsDataClean)) {
-        CORRADE_INTERNAL_ASSERT(!(states >= UserInterfaceState::NeedsNodeClean));
-        return *this;
-    }
+bool AbstractUserInterface::hasPersistentUpdateStorage() const {
+    return _state->persistentUpdateStorage;
+}
 
+AbstractUserInterface& AbstractUserInterface::setPersistentUpdateStorage(const bool persistent) {
     State& state = *_state;
+    state.persistentUpdateStorage = persistent;
+    if(!persistent)
+        state.updateStorage.release();
+    return *this;
+}
 
-    /* Single allocation for all temporary data */
-    Containers::ArrayView<UnsignedInt> childrenOffsets;
-    Containers::ArrayView<UnsignedInt> children;
-    Containers::ArrayView<Int> nodeIds;
-    Containers::ArrayTuple storage{
-        /* Running children offset (+1) for each node including root (+1) */
-        {ValueInit, state.nodes.size() + 2, childrenOffsets},
-        {NoInit, state.nodes.size(), children},
-        /* One more item for the -1 at the front */
-        {NoInit, state.nodes.size() + 1, nodeIds},
-    };
+bool AbstractUserInterface::hasDrawMerging() const {
+    return _state->drawMerging;
+}
+
+AbstractUserInterface& AbstractUserInterface::setDrawMerging(const bool merging) {
+    State& state = *_state;
+    if(state.drawMerging != merging) {
+        state.drawMerging = merging;
+        /* The draw list is rebuilt as part of the data attachment update */
+        state.state |= UserInterfaceState::NeedsDataAttachmentUpdate;
+        state.dataOrderNeedsUpdate = true;
+    }
+    return *this;
+}
+
+bool AbstractUserInterface::hasPointerMoveEventCoalescing() const {
+    return _state->pointerMoveEventCoalescing;
+}
+
+AbstractUserInterface& AbstractUserInterface::setPointerMoveEventCoalescing(const bool coalescing) {
+    /* Deliver whatever got queued so far so it doesn't get stuck */
+    if(!coalescing)
+        flushPointerMoveEvent();
+    _state->pointerMoveEventCoalescing = coalescing;
+    return *this;
+}
+
+bool AbstractUserInterface::hasPendingPointerMoveEvent() const {
+    return !!_state->pendingPointerMoveEvent;
+}
+
+bool AbstractUserInterface::flushPointerMoveEvent() {
+    State& state = *_state;
+    if(!state.pendingPointerMoveEvent)
+        return false;
+
+    /* Move the event out first so the handlers can't see it as pending and
+       any queued events from within them don't overwrite it */
+    PointerMoveEvent event = *state.pendingPointerMoveEvent;
+    state.pendingPointerMoveEvent = Containers::NullOpt;
+
+    /* Make the coalesced positions relative to the final one, scaled to the
+       UI size. The event then adds them to its node-relative position. */
+    const Vector2 scale = state.size/state.windowSize;
+    for(Containers::Pair<Nanoseconds, Vector2>& i: state.coalescedPointerMoves)
+        i.second() = (i.second() - state.pendingPointerMoveGlobalPosition)*scale;
+    event._coalesced = state.coalescedPointerMoves;
+
+    const bool accepted = pointerMoveEventInternal(state.pendingPointerMoveGlobalPosition, event);
+
+    /* Clear the history, keeping the capacity for the next frame */
+    arrayClear(state.coalescedPointerMoves);
+    return accepted;
+}
+
+bool AbstractUserInterface::hasUpdateExecutor() const {
+    return !!_state->updateExecutor;
+}
+
+AbstractUserInterface& AbstractUserInterface::setUpdateExecutor(Containers::Function<void(std::size_t, void(*)(void*, std::size_t), void*)>&& executor) {
+    _state->updateExecutor = Utility::move(executor);
+    return *this;
+}
+
+bool AbstractUserInterface::hasUpdateStatistics() const {
+    return _state->updateStatisticsEnabled;
+}
+
+AbstractUserInterface& AbstractUserInterface::setUpdateStatistics(const bool enabled) {
+    State& state = *_state;
+    /* Don't show stale values from a previous time it was enabled */
+    if(enabled && !state.updateStatisticsEnabled) {
+        state.updateStatistics = {};
+        for(LayerStates& i: state.frameLayerStates)
+            i = {};
+        for(std::size_t& i: state.frameLayerUploadedSizes)
+            i = 0;
+        state.frameEventCount = 0;
+        state.frameHitTestNodeCount = 0;
+        state.frameAnimatorAdvanceCount = 0;
+    }
+    state.updateStatisticsEnabled = enabled;
+    return *this;
+}
+
+const UserInterfaceUpdateStatistics& AbstractUserInterface::updateStatistics() const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.updateStatisticsEnabled,
+        "Ui::AbstractUserInterface::updateStatistics(): update statistics not enabled", state.updateStatistics);
+    return state.updateStatistics;
+}
+
+bool AbstractUserInterface::hasUpdateStageCallback() const {
+    return !!_state->updateStageCallback;
+}
+
+AbstractUserInterface& AbstractUserInterface::setUpdateStageCallback(Containers::Function<void(UserInterfaceUpdateStage, bool)>&& callback) {
+    _state->updateStageCallback = Utility::move(callback);
+    return *this;
+}
+
+bool AbstractUserInterface::hasConcurrentAnimationAdvance() const {
+    return _state->concurrentAnimationAdvance;
+}
+
+AbstractUserInterface& AbstractUserInterface::setConcurrentAnimationAdvance(const bool concurrent) {
+    _state->concurrentAnimationAdvance = concurrent;
+    return *this;
+}
+
+std::size_t AbstractUserInterface::updateStorageSize() const {
+    const State& state = *_state;
+    return state.updateStorage.size() +
+           state.nodeStateStorage.size() +
+           state.nodeChildrenStorage.size() +
+           state.layoutStateStorage.size() +
+           state.dataStateStorage.size();
+}
+
+AbstractUserInterface& AbstractUserInterface::clean() {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::clean()");
+    /* Get the state including what bubbles from layers. If there's nothing to
+       clean, bail. */
+    const UserInterfaceStates states = this->state();
+    if(!(states >= UserInterfaceState::NeedsDataClean)) {
+        CORRADE_INTERNAL_ASSERT(!(states >= UserInterfaceState::NeedsNodeClean));
+        return *this;
+    }
+
+    State& state = *_state;
 
-    /* If no node clean is needed, there's no need to build and iterate an
-       ordered list of nodes */
+    /* If no node clean is needed, there's no need to go through the orphaned
+       nodes and node attachments */
     if(states >= UserInterfaceState::NeedsNodeClean) {
-        /* 1. Order the whole node hierarchy */
-        /** @todo here it may happen that a handle gets recycled and then
-            parented to some of its original children, leading to an
-            unreachable cycle and a internal assertion inside, see the
-            (skipped) cleanRemoveNestedNodesRecycledHandleOrphanedCycle()
-            test */
-        Implementation::orderNodesBreadthFirstInto(
-            stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::parent),
-            childrenOffsets, children, nodeIds);
-
-        /* 2. Go through the ordered nodes (skipping the first element which is
-           -1) and remove ones that have an invalid parent. Since children are
-           ordered after their parents, they'll get subsequently removed as
-           well.
-
-           Removed nodes are parented to the root, which prevents them from
-           being removed more than once which would lead to a cycle in the free
-           list. */
-        for(const UnsignedInt id: nodeIds.exceptPrefix(1)) {
-            const Node& node = state.nodes[id];
-            if(node.used.parent != NodeHandle::Null && !isHandleValid(node.used.parent))
-                removeNodeInternal(id);
-        }
+        /* 1. Remove all nodes that have their parent removed. Removing a node
+           puts its children to the front of the orphaned list, so this
+           goes through the removed subtrees only, not the whole hierarchy. */
+        while(state.firstOrphanNode != ~UnsignedInt{})
+            removeNodeInternal(state.firstOrphanNode);
 
-        /* 3. Next perform a clean for layouter node assignments and data and
+        /* 2. Next perform a clean for layouter node assignments and data and
            animation node attachments, keeping only layouts assigned to
            (remaining) valid node handles and data/animations that are either
            not attached or attached to valid node handles. */
@@ -2401,10 +3353,12 @@ AbstractUserInterface& AbstractUserInterface::clean() {
        NeedsAnimationAdvance is only propagated from the animators in state(),
        never present directly in _state->state, so clear it as well. */
     state.state = states & ~((UserInterfaceState::NeedsNodeClean|UserInterfaceState::NeedsAnimationAdvance) & ~UserInterfaceState::NeedsNodeUpdate);
+
     return *this;
 }
 
 AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanoseconds time) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::advanceAnimations()");
     State& state = *_state;
     CORRADE_ASSERT(time >= state.animationTime,
         "Ui::AbstractUserInterface::advanceAnimations(): expected a time at least" << state.animationTime << "but got" << time, *this);
@@ -2421,101 +3375,250 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
         if(const AbstractAnimator* const instance = animator.used.instance.get())
             maxCapacity = Math::max(instance->capacity(), maxCapacity);
     }
-    Containers::MutableBitArrayView active;
-    Containers::MutableBitArrayView remove;
-    Containers::ArrayView<Float> factors;
-    Containers::MutableBitArrayView nodesRemove;
-    Containers::ArrayTuple storage{
-        {NoInit, maxCapacity, active},
-        {NoInit, maxCapacity, remove},
-        {NoInit, maxCapacity, factors},
-        {ValueInit, state.nodes.size(), nodesRemove}
-    };
+    Implementation::FrameArena& storage = state.updateStorage;
+    storage.reset();
+    const Containers::MutableBitArrayView active = storage.allocateBits(NoInit, maxCapacity);
+    const Containers::MutableBitArrayView remove = storage.allocateBits(NoInit, maxCapacity);
+    const Containers::ArrayView<Float> factors = storage.allocate<Float>(NoInit, maxCapacity);
+    const Containers::MutableBitArrayView nodesRemove = storage.allocateBits(ValueInit, state.nodes.size());
 
     /* Get the state including what bubbles from animators, then go through
        them only if there's something to advance */
     const UserInterfaceStates states = this->state();
     if(states >= UserInterfaceState::NeedsAnimationAdvance) {
-        /* Common code for advancing AbstractGenericAnimator instances. It's
-           done in three separate loops because generic animators are not
-           contiguous in the `state.animatorInstances` array, instead they're
-           grouped by whether they have node or data attachments to make the
-           implementation in clean() simpler */
-        const auto advanceGenericAnimator = [&](AbstractAnimator& instance) {
-            if(!(instance.state() & AnimatorState::NeedsAdvance))
-                return;
-
-            const std::size_t capacity = instance.capacity();
-            const Containers::Pair<bool, bool> needsAdvanceClean = instance.update(time,
-                active.prefix(capacity),
-                factors.prefix(capacity),
-                remove.prefix(capacity));
-
-            if(needsAdvanceClean.first())
-                static_cast<AbstractGenericAnimator&>(instance).advance(
-                    active.prefix(capacity),
-                    factors.prefix(capacity));
-            if(needsAdvanceClean.second())
-                instance.clean(remove.prefix(capacity));
-        };
-
-        /* Go through all generic animators with neither NodeAttachment nor
-           DataAttachment and advance ones that need it */
-        for(AbstractAnimator& instance: Implementation::partitionedAnimatorsNone(state.animatorInstances, state.animatorInstancesNodeAttachmentOffset))
-            advanceGenericAnimator(instance);
+        /* Every animator that needs an advance gets advanced below, either
+           directly or through its layer */
+        if(state.updateStatisticsEnabled) {
+            for(const AbstractAnimator& instance: state.animatorInstances)
+                if(instance.state() & AnimatorState::NeedsAdvance)
+                    ++state.frameAnimatorAdvanceCount;
+        }
 
-        /* Then all generic animators with NodeAttachment */
         const Containers::StridedArrayView1D<const UnsignedShort> dataAttachmentAnimatorOffsets = stridedArrayView(state.layers).slice(&Layer::used).slice(&Layer::Used::dataAttachmentAnimatorOffset);
-        for(AbstractAnimator& instance: Implementation::partitionedAnimatorsGenericNodeAttachment(state.animatorInstances, state.animatorInstancesNodeAttachmentOffset, state.animatorInstancesNodeOffset, dataAttachmentAnimatorOffsets))
-            advanceGenericAnimator(instance);
-
-        /* Then, for each layer all generic animators with DataAttachment */
         const Containers::StridedArrayView1D<const UnsignedShort> dataAnimatorOffsets = stridedArrayView(state.layers).slice(&Layer::used).slice(&Layer::Used::dataAnimatorOffset);
         const Containers::StridedArrayView1D<const UnsignedShort> styleAnimatorOffsets = stridedArrayView(state.layers).slice(&Layer::used).slice(&Layer::Used::styleAnimatorOffset);
-        for(std::size_t i = 0; i != state.layers.size(); ++i)
-            for(AbstractAnimator& instance: Implementation::partitionedAnimatorsGenericDataAttachment(state.animatorInstances, dataAttachmentAnimatorOffsets, dataAnimatorOffsets, styleAnimatorOffsets, layerHandle(i, state.layers[i].used.generation)))
-                advanceGenericAnimator(instance);
-
-        /* After that, all AbstractNodeAnimator instances, remembering what all
-           they modified */
         const Containers::StridedArrayView1D<Vector2> nodeOffsets = stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::offset);
         const Containers::StridedArrayView1D<Vector2> nodeSizes = stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::size);
-        const Containers::StridedArrayView1D<NodeFlags> nodeFlags = stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::flags);
+        const Containers::StridedArrayView1D<NodeFlags> nodeFlags = stridedArrayView(state.nodeFlags);
         NodeAnimations nodeAnimations;
-        for(AbstractAnimator& instance: Implementation::partitionedAnimatorsNodeNodeAttachment(state.animatorInstances, state.animatorInstancesNodeAttachmentOffset, state.animatorInstancesNodeOffset, dataAttachmentAnimatorOffsets)) {
-            if(!(instance.state() & AnimatorState::NeedsAdvance))
-                continue;
 
-            const std::size_t capacity = instance.capacity();
-            const Containers::Pair<bool, bool> needsAdvanceClean = instance.update(time,
-                active.prefix(capacity),
-                factors.prefix(capacity),
-                remove.prefix(capacity));
+        /* Animators are advanced concurrently only if enabled and if there's
+           an executor to do so */
+        const bool concurrent = state.concurrentAnimationAdvance && state.updateExecutor;
+        if(!concurrent) {
+            /* Common code for advancing AbstractGenericAnimator instances.
+               It's done in three separate loops because generic animators are
+               not contiguous in the `state.animatorInstances` array, instead
+               they're grouped by whether they have node or data attachments
+               to make the implementation in clean() simpler */
+            const auto advanceGenericAnimator = [&](AbstractAnimator& instance) {
+                if(!(instance.state() & AnimatorState::NeedsAdvance))
+                    return;
+
+                const std::size_t capacity = instance.capacity();
+                const Containers::Pair<bool, bool> needsAdvanceClean = instance.update(time,
+                    active.prefix(capacity),
+                    factors.prefix(capacity),
+                    remove.prefix(capacity));
+
+                if(needsAdvanceClean.first())
+                    static_cast<AbstractGenericAnimator&>(instance).advance(
+                        active.prefix(capacity),
+                        factors.prefix(capacity));
+                if(needsAdvanceClean.second())
+                    instance.clean(remove.prefix(capacity));
+            };
 
-            if(needsAdvanceClean.first())
-                nodeAnimations |= static_cast<AbstractNodeAnimator&>(instance).advance(
+            /* Go through all generic animators with neither NodeAttachment nor
+               DataAttachment and advance ones that need it */
+            for(AbstractAnimator& instance: Implementation::partitionedAnimatorsNone(state.animatorInstances, state.animatorInstancesNodeAttachmentOffset))
+                advanceGenericAnimator(instance);
+
+            /* Then all generic animators with NodeAttachment */
+            for(AbstractAnimator& instance: Implementation::partitionedAnimatorsGenericNodeAttachment(state.animatorInstances, state.animatorInstancesNodeAttachmentOffset, state.animatorInstancesNodeOffset, dataAttachmentAnimatorOffsets))
+                advanceGenericAnimator(instance);
+
+            /* Then, for each layer all generic animators with
+               DataAttachment */
+            for(std::size_t i = 0; i != state.layers.size(); ++i)
+                for(AbstractAnimator& instance: Implementation::partitionedAnimatorsGenericDataAttachment(state.animatorInstances, dataAttachmentAnimatorOffsets, dataAnimatorOffsets, styleAnimatorOffsets, layerHandle(i, state.layers[i].used.generation)))
+                    advanceGenericAnimator(instance);
+
+            /* After that, all AbstractNodeAnimator instances, remembering
+               what all they modified */
+            if(WithNodeAnimators) for(AbstractAnimator& instance: Implementation::partitionedAnimatorsNodeNodeAttachment(state.animatorInstances, state.animatorInstancesNodeAttachmentOffset, state.animatorInstancesNodeOffset, dataAttachmentAnimatorOffsets)) {
+                if(!(instance.state() & AnimatorState::NeedsAdvance))
+                    continue;
+
+                const std::size_t capacity = instance.capacity();
+                const Containers::Pair<bool, bool> needsAdvanceClean = instance.update(time,
                     active.prefix(capacity),
                     factors.prefix(capacity),
-                    nodeOffsets,
-                    nodeSizes,
-                    nodeFlags,
-                    nodesRemove);
-            if(needsAdvanceClean.second())
-                instance.clean(remove.prefix(capacity));
+                    remove.prefix(capacity));
+
+                if(needsAdvanceClean.first())
+                    nodeAnimations |= static_cast<AbstractNodeAnimator&>(instance).advance(
+                        active.prefix(capacity),
+                        factors.prefix(capacity),
+                        nodeOffsets,
+                        nodeSizes,
+                        nodeFlags,
+                        nodesRemove);
+                if(needsAdvanceClean.second())
+                    instance.clean(remove.prefix(capacity));
+            }
+        } else {
+            /* Gather all generic and node animators that need advancing, in
+               the same order as above, each with a dedicated storage so their
+               update() can be called concurrently. The bit views are
+               allocated separately to not have multiple threads write to the
+               same byte. */
+            struct AnimatorUpdate {
+                AbstractAnimator* instance;
+                Containers::MutableBitArrayView active;
+                Containers::ArrayView<Float> factors;
+                Containers::MutableBitArrayView remove;
+                Containers::Pair<bool, bool> needsAdvanceClean;
+                bool node;
+            };
+            const Containers::ArrayView<AnimatorUpdate> animatorUpdates = storage.allocate<AnimatorUpdate>(NoInit, state.animatorInstances.size());
+            std::size_t animatorUpdateCount = 0;
+            const auto gatherAnimator = [&](AbstractAnimator& instance, bool node) {
+                if(!(instance.state() & AnimatorState::NeedsAdvance))
+                    return;
+
+                const std::size_t capacity = instance.capacity();
+                AnimatorUpdate& update = animatorUpdates[animatorUpdateCount++];
+                update.instance = &instance;
+                update.active = storage.allocateBits(NoInit, capacity);
+                update.factors = storage.allocate<Float>(NoInit, capacity);
+                update.remove = storage.allocateBits(NoInit, capacity);
+                update.node = node;
+            };
+            for(AbstractAnimator& instance: Implementation::partitionedAnimatorsNone(state.animatorInstances, state.animatorInstancesNodeAttachmentOffset))
+                gatherAnimator(instance, false);
+            for(AbstractAnimator& instance: Implementation::partitionedAnimatorsGenericNodeAttachment(state.animatorInstances, state.animatorInstancesNodeAttachmentOffset, state.animatorInstancesNodeOffset, dataAttachmentAnimatorOffsets))
+                gatherAnimator(instance, false);
+            for(std::size_t i = 0; i != state.layers.size(); ++i)
+                for(AbstractAnimator& instance: Implementation::partitionedAnimatorsGenericDataAttachment(state.animatorInstances, dataAttachmentAnimatorOffsets, dataAnimatorOffsets, styleAnimatorOffsets, layerHandle(i, state.layers[i].used.generation)))
+                    gatherAnimator(instance, false);
+            if(WithNodeAnimators) for(AbstractAnimator& instance: Implementation::partitionedAnimatorsNodeNodeAttachment(state.animatorInstances, state.animatorInstancesNodeAttachmentOffset, state.animatorInstancesNodeOffset, dataAttachmentAnimatorOffsets))
+                gatherAnimator(instance, true);
+
+            /* Layers that advertise LayerFeature::ConcurrentUpdate get their
+               data and style animators advanced concurrently as well, again
+               with a dedicated storage sized for the largest animator */
+            struct LayerAdvance {
+                AbstractLayer* instance;
+                Containers::ArrayView<const Containers::Reference<AbstractAnimator>> dataAnimators;
+                Containers::ArrayView<const Containers::Reference<AbstractAnimator>> styleAnimators;
+                Containers::MutableBitArrayView active;
+                Containers::ArrayView<Float> factors;
+                Containers::MutableBitArrayView remove;
+            };
+            const Containers::ArrayView<LayerAdvance> layerAdvances = storage.allocate<LayerAdvance>(NoInit, state.layers.size());
+            std::size_t layerAdvanceCount = 0;
+            for(std::size_t i = 0; i != state.layers.size(); ++i) {
+                Layer& layer = state.layers[i];
+                if(!(layer.used.features >= LayerFeature::ConcurrentUpdate))
+                    continue;
+
+                const Containers::ArrayView<const Containers::Reference<AbstractAnimator>> dataAnimators = Implementation::partitionedAnimatorsDataDataAttachment(state.animatorInstances, dataAttachmentAnimatorOffsets, dataAnimatorOffsets, styleAnimatorOffsets, layerHandle(i, layer.used.generation));
+                const Containers::ArrayView<const Containers::Reference<AbstractAnimator>> styleAnimators = Implementation::partitionedAnimatorsStyleDataAttachment(state.animatorInstances, dataAttachmentAnimatorOffsets, dataAnimatorOffsets, styleAnimatorOffsets, layerHandle(i, layer.used.generation));
+                if(dataAnimators.isEmpty() && styleAnimators.isEmpty())
+                    continue;
+
+                std::size_t layerCapacity = 0;
+                for(const AbstractAnimator& animator: dataAnimators)
+                    layerCapacity = Math::max(animator.capacity(), layerCapacity);
+                for(const AbstractAnimator& animator: styleAnimators)
+                    layerCapacity = Math::max(animator.capacity(), layerCapacity);
+
+                LayerAdvance& advance = layerAdvances[layerAdvanceCount++];
+                advance.instance = layer.used.instance.get();
+                advance.dataAnimators = dataAnimators;
+                advance.styleAnimators = styleAnimators;
+                advance.active = storage.allocateBits(NoInit, layerCapacity);
+                advance.factors = storage.allocate<Float>(NoInit, layerCapacity);
+                advance.remove = storage.allocateBits(NoInit, layerCapacity);
+            }
+
+            /* Calculate the animation factors of all gathered animators and
+               advance the layer animators */
+            if(const std::size_t count = animatorUpdateCount + layerAdvanceCount) {
+                struct ConcurrentAdvance {
+                    Nanoseconds time;
+                    Containers::ArrayView<AnimatorUpdate> animatorUpdates;
+                    Containers::ArrayView<const LayerAdvance> layerAdvances;
+                } concurrentAdvance{time, animatorUpdates.prefix(animatorUpdateCount), layerAdvances.prefix(layerAdvanceCount)};
+                state.updateExecutor(count, [](void* data, const std::size_t i) {
+                    const ConcurrentAdvance& concurrentAdvance = *static_cast<const ConcurrentAdvance*>(data);
+                    if(i < concurrentAdvance.animatorUpdates.size()) {
+                        AnimatorUpdate& update = concurrentAdvance.animatorUpdates[i];
+                        update.needsAdvanceClean = update.instance->update(concurrentAdvance.time, update.active, update.factors, update.remove);
+                        return;
+                    }
+
+                    const LayerAdvance& advance = concurrentAdvance.layerAdvances[i - concurrentAdvance.animatorUpdates.size()];
+                    if(!advance.dataAnimators.isEmpty())
+                        advance.instance->advanceAnimations(concurrentAdvance.time,
+                            advance.active,
+                            advance.factors,
+                            advance.remove,
+                            /* The cast is a bit ew, yeah */
+                            Containers::arrayView(reinterpret_cast<Containers::Reference<AbstractDataAnimator>*>(const_cast<Containers::Reference<AbstractAnimator>*>(advance.dataAnimators.data())), advance.dataAnimators.size()));
+                    if(!advance.styleAnimators.isEmpty())
+                        advance.instance->advanceAnimations(concurrentAdvance.time,
+                            advance.active,
+                            advance.factors,
+                            advance.remove,
+                            Containers::arrayView(reinterpret_cast<Containers::Reference<AbstractStyleAnimator>*>(const_cast<Containers::Reference<AbstractAnimator>*>(advance.styleAnimators.data())), advance.styleAnimators.size()));
+                }, &concurrentAdvance);
+            }
+
+            /* Then advance and clean the generic and node animators serially
+               in the original order, merging what all the node animators
+               modified */
+            for(const AnimatorUpdate& update: animatorUpdates.prefix(animatorUpdateCount)) {
+                if(update.needsAdvanceClean.first()) {
+                    if(update.node)
+                        nodeAnimations |= static_cast<AbstractNodeAnimator&>(*update.instance).advance(
+                            update.active,
+                            update.factors,
+                            nodeOffsets,
+                            nodeSizes,
+                            nodeFlags,
+                            nodesRemove);
+                    else
+                        static_cast<AbstractGenericAnimator&>(*update.instance).advance(
+                            update.active,
+                            update.factors);
+                }
+                if(update.needsAdvanceClean.second())
+                    update.instance->clean(update.remove);
+            }
         }
 
         /* Propagate to the global state */
-        if(nodeAnimations >= NodeAnimation::OffsetSize)
+        /* Animated nodes aren't tracked individually, so all layouts have to
+           be updated */
+        if(nodeAnimations >= NodeAnimation::OffsetSize) {
             state.state |= UserInterfaceState::NeedsLayoutUpdate;
-        if(nodeAnimations >= NodeAnimation::Enabled)
+            state.layoutNeedsFullUpdate = true;
+        }
+        if(nodeAnimations >= NodeAnimation::Enabled) {
             state.state |= UserInterfaceState::NeedsNodeEnabledUpdate;
-        if(nodeAnimations >= NodeAnimation::Clip)
+            state.dataOrderNeedsUpdate = true;
+        }
+        if(nodeAnimations >= NodeAnimation::Clip) {
             state.state |= UserInterfaceState::NeedsNodeClipUpdate;
+            state.dataOrderNeedsUpdate = true;
+        }
         if(nodeAnimations >= NodeAnimation::Removal) {
             state.state |= UserInterfaceState::NeedsNodeClean;
-            /** @todo some way to efficiently iterate set bits */
-            for(std::size_t i = 0; i != nodesRemove.size(); ++i)
-                if(nodesRemove[i]) removeNodeInternal(i);
+            Implementation::forEachSetBit(nodesRemove, [&](const std::size_t i) {
+                removeNodeInternal(i);
+            });
         }
 
         /* Then, for each layer ... */
@@ -2526,6 +3629,11 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
         for(std::size_t i = 0; i != state.layers.size(); ++i) {
             Layer& layer = state.layers[i];
 
+            /* Layers that support it were already advanced concurrently
+               above */
+            if(concurrent && layer.used.features >= LayerFeature::ConcurrentUpdate)
+                continue;
+
             /* ... all AbstractDataAnimator instances */
             const Containers::ArrayView<const Containers::Reference<AbstractAnimator>> dataAnimators = Implementation::partitionedAnimatorsDataDataAttachment(state.animatorInstances, dataAttachmentAnimatorOffsets, dataAnimatorOffsets, styleAnimatorOffsets, layerHandle(i, layer.used.generation));
             if(!dataAnimators.isEmpty()) {
@@ -2567,22 +3675,63 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
        animators, this function doesn't need to perform any additional state
        logic. */
 
+    if(!state.persistentUpdateStorage)
+        storage.release();
     return *this;
 }
 
 AbstractUserInterface& AbstractUserInterface::update() {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::update()");
+    State& state = *_state;
+
+    /* If enabled, fills the node, clip rect, draw, composite and data counts
+       in the statistics. Done from the persistent state, so it's valid also if
+       there's nothing to update. */
+    const auto updateStatisticsCounts = [&state]() {
+        UserInterfaceUpdateStatistics& statistics = state.updateStatistics;
+        statistics.visibleNodeCount = state.visibleNodeIds.size();
+        statistics.culledNodeCount = 0;
+        for(const UnsignedInt id: state.visibleNodeIds)
+            if(!state.visibleNodeMask[id])
+                ++statistics.culledNodeCount;
+        statistics.clipRectCount = state.clipRectCount;
+        statistics.drawCountBeforeCompaction = state.dataToDrawLayerIds.size();
+        statistics.drawCount = state.drawCount;
+        statistics.compositeCount = 0;
+        if(WithCompositeLayers) for(std::size_t i = 0; i != state.drawCount; ++i)
+            if(state.dataToDrawLayerFeatures[i] >= LayerFeature::Composite)
+                ++statistics.compositeCount;
+
+        arrayResize(state.updateStatisticsLayerDataCounts, NoInit, state.layers.size());
+        const bool hasLayerOffsets = state.dataToUpdateLayerOffsets.size() == state.layers.size() + 1;
+        for(std::size_t i = 0; i != state.layers.size(); ++i)
+            state.updateStatisticsLayerDataCounts[i] = hasLayerOffsets ?
+                state.dataToUpdateLayerOffsets[i + 1].first() - state.dataToUpdateLayerOffsets[i].first() : 0;
+        statistics.layerDataCounts = state.updateStatisticsLayerDataCounts;
+    };
+
+    /* Measure duration of each stage if statistics are enabled, and call the
+       stage callback if set. Stages that don't get executed are zero. */
+    UserInterfaceUpdateStatistics* const statistics = state.updateStatisticsEnabled ? &state.updateStatistics : nullptr;
+    if(statistics) for(Nanoseconds& duration: statistics->stageDurations)
+        duration = {};
+    UpdateStageTracker stageTracker{statistics, state.updateStageCallback};
+
     /* Call clean implicitly in order to make the internal state ready for
        update. Is a no-op if there's nothing to clean. */
+    stageTracker.begin(UserInterfaceUpdateStage::Clean);
     clean();
+    stageTracker.end();
 
     /* Get the state after the clean call including what bubbles from layers.
        If there's nothing to update, bail. No other states should be left after
        that -- NeedsAnimationAdvance is only propagated from the animators in
        state(), never present directly in state.state. */
     const UserInterfaceStates states = this->state();
-    State& state = *_state;
     if(!(states & UserInterfaceState::NeedsNodeUpdate)) {
         CORRADE_INTERNAL_ASSERT(!state.state);
+        if(statistics)
+            updateStatisticsCounts();
         return *this;
     }
 
@@ -2593,13 +3742,21 @@ AbstractUserInterface& AbstractUserInterface::update() {
     CORRADE_ASSERT(!state.size.isZero(),
         "Ui::AbstractUserInterface::update(): user interface size wasn't set", *this);
 
+    /* All states except for NeedsNodeEventMaskUpdate imply NeedsDataUpdate,
+       which means something may look different in the next draw. Event mask
+       alone affects only event handling. */
+    if(states & UserInterfaceState::NeedsDataUpdate)
+        state.drawNeeded = true;
+
+    stageTracker.begin(UserInterfaceUpdateStage::NodeOrder);
+
     /* If layout attachment update is desired, calculate the total conservative
        count of layouts in all layouters to size the output arrays.
        Conservative as it includes also freed layouts, however the assumption
        is that in majority cases there will be very little freed layouts. */
     std::size_t usedLayouterCount = 0;
     std::size_t layoutCount = 0;
-    if(states >= UserInterfaceState::NeedsLayoutAssignmentUpdate) {
+    if(WithLayouters && states >= UserInterfaceState::NeedsLayoutAssignmentUpdate) {
         for(const Layouter& layouter: state.layouters) {
             if(const AbstractLayouter* const instance = layouter.used.instance.get()) {
                 ++usedLayouterCount;
@@ -2630,89 +3787,124 @@ AbstractUserInterface& AbstractUserInterface::update() {
                 dataCount += instance->capacity();
     }
 
-    /* Single allocation for all temporary data */
-    /** @todo well, not really, there's one more temp array for layout mask
-        calculation */
-    Containers::MutableBitArrayView visibleNodes;
-    Containers::ArrayView<UnsignedInt> childrenOffsets;
-    Containers::ArrayView<UnsignedInt> children;
-    Containers::ArrayView<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> parentsToProcess;
-    Containers::StridedArrayView2D<LayoutHandle> nodeLayouts;
-    Containers::StridedArrayView2D<UnsignedInt> nodeLayoutLevels;
-    Containers::ArrayView<UnsignedInt> layoutLevelOffsets;
-    Containers::ArrayView<LayoutHandle> topLevelLayouts;
-    Containers::ArrayView<UnsignedInt> topLevelLayoutLevels;
-    Containers::ArrayView<LayoutHandle> levelPartitionedTopLevelLayouts;
-    Containers::ArrayView<UnsignedInt> layouterCapacities;
-    Containers::ArrayView<Containers::Triple<Vector2, Vector2, UnsignedInt>> clipStack;
-    Containers::ArrayView<UnsignedInt> visibleNodeDataOffsets;
-    Containers::ArrayView<UnsignedInt> visibleNodeDataIds;
+    /* Take all temporary data from the update storage. Unless
+       setPersistentUpdateStorage() is disabled, it's kept allocated across
+       update() calls, meaning that with a stable workload, this doesn't
+       allocate at all. */
+    Implementation::FrameArena& storage = state.updateStorage;
+    storage.reset();
+    const Containers::MutableBitArrayView visibleNodes = storage.allocateBits(ValueInit, state.nodes.size());
+    const Containers::ArrayView<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> parentsToProcess = storage.allocate<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>>(NoInit, state.nodes.size());
+    /* Not all nodes have layouts from all layouters, initialize to
+       LayoutHandle::Null */
+    const Containers::StridedArrayView2D<LayoutHandle> nodeLayouts = storage.allocate<LayoutHandle>(ValueInit, {state.nodes.size(), usedLayouterCount});
+    /* Zero-initialized as zeros indicate the layout (if non-null) is assigned
+       to a node that's not visible */
+    const Containers::StridedArrayView2D<UnsignedInt> nodeLayoutLevels = storage.allocate<UnsignedInt>(ValueInit, {state.nodes.size(), usedLayouterCount});
+    /* Running layout offset (+1) for each level */
+    const Containers::ArrayView<UnsignedInt> layoutLevelOffsets = storage.allocate<UnsignedInt>(ValueInit, layoutCount + 1);
+    const Containers::ArrayView<LayoutHandle> topLevelLayouts = storage.allocate<LayoutHandle>(NoInit, layoutCount);
+    const Containers::ArrayView<UnsignedInt> topLevelLayoutLevels = storage.allocate<UnsignedInt>(NoInit, layoutCount);
+    const Containers::ArrayView<LayoutHandle> levelPartitionedTopLevelLayouts = storage.allocate<LayoutHandle>(NoInit, layoutCount);
+    const Containers::ArrayView<UnsignedInt> layouterCapacities = storage.allocate<UnsignedInt>(NoInit, state.layouters.size());
+    /* Running data offset (+1) for each item. This array gets overwritten
+       from scratch for each layer so zero-initializing is done inside
+       orderVisibleNodeDataInto() instead. */
+    const Containers::ArrayView<UnsignedInt> visibleNodeDataOffsets = storage.allocate<UnsignedInt>(NoInit, state.nodes.size() + 1);
+    /* One more item for the stack root, which is the whole UI size */
+    const Containers::ArrayView<Containers::Triple<Vector2, Vector2, UnsignedInt>> clipStack = storage.allocate<Containers::Triple<Vector2, Vector2, UnsignedInt>>(NoInit, state.nodes.size() + 1);
+    const Containers::ArrayView<UnsignedInt> visibleNodeDataIds = storage.allocate<UnsignedInt>(NoInit, dataCount);
     /* Contains a copy of state.visibleEventNodeMask (allocated below) together
        with additional bits set for nodes that need visibility lost events
        emitted. The bits used for visibility lost events are gradually cleared
        to avoid calling the same event multiple times, so this mask isn't
        usable for anything else afterwards. */
-    Containers::MutableBitArrayView visibleOrVisibilityLostEventNodeMask;
-    Containers::ArrayTuple storage{
-        {ValueInit, state.nodes.size(), visibleNodes},
-        /* Running children offset (+1) for each node */
-        {ValueInit, state.nodes.size() + 1, childrenOffsets},
-        {NoInit, state.nodes.size(), children},
-        {NoInit, state.nodes.size(), parentsToProcess},
-        /* Not all nodes have layouts from all layouters, initialize to
-           LayoutHandle::Null */
-        {ValueInit, {state.nodes.size(), usedLayouterCount}, nodeLayouts},
-        /* Zero-initialized as zeros indicate the layout (if non-null) is
-           assigned to a node that's not visible */
-        {ValueInit, {state.nodes.size(), usedLayouterCount}, nodeLayoutLevels},
-        /* Running layout offset (+1) for each level */
-        {ValueInit, layoutCount + 1, layoutLevelOffsets},
-        {NoInit, layoutCount, topLevelLayouts},
-        {NoInit, layoutCount, topLevelLayoutLevels},
-        {NoInit, layoutCount, levelPartitionedTopLevelLayouts},
-        {NoInit, state.layouters.size(), layouterCapacities},
-        /* Running data offset (+1) for each item. This array gets overwritten
-           from scratch for each layer so zero-initializing is done inside
-           orderVisibleNodeDataInto() instead. */
-        {NoInit, state.nodes.size() + 1, visibleNodeDataOffsets},
-        /* One more item for the stack root, which is the whole UI size */
-        {NoInit, state.nodes.size() + 1, clipStack},
-        {NoInit, dataCount, visibleNodeDataIds},
-        {NoInit, state.nodes.size(), visibleOrVisibilityLostEventNodeMask},
-    };
+    Containers::MutableBitArrayView visibleOrVisibilityLostEventNodeMask = storage.allocateBits(NoInit, state.nodes.size());
 
     /* If no node update is needed, the data in `state.nodeStateStorage` and
        all views pointing to it is already up-to-date. */
     if(states >= UserInterfaceState::NeedsNodeUpdate) {
-        /* Make a resident allocation for all node-related state */
-        state.nodeStateStorage = Containers::ArrayTuple{
-            {NoInit, state.nodes.size(), state.visibleNodeIds},
-            {NoInit, state.nodes.size(), state.visibleNodeChildrenCounts},
-            {NoInit, state.nodeOrder.size(), state.visibleFrontToBackTopLevelNodeIndices},
-            {NoInit, state.nodes.size(), state.nodeOffsets},
-            {NoInit, state.nodes.size(), state.nodeSizes},
-            {NoInit, state.nodes.size(), state.absoluteNodeOffsets},
-            {NoInit, state.nodes.size(), state.absoluteNodeOpacities},
-            {NoInit, state.nodes.size(), state.visibleNodeMask},
-            {NoInit, state.nodes.size(), state.visibleEventNodeMask},
-            {NoInit, state.nodes.size(), state.visibleEnabledNodeMask},
-            {NoInit, state.nodes.size(), state.visibleBlurNodeMask},
-            {NoInit, state.nodes.size(), state.clipRectOffsets},
-            {NoInit, state.nodes.size(), state.clipRectSizes},
-            {NoInit, state.nodes.size(), state.clipRectNodeCounts},
-        };
+        /* Make a resident allocation for all node-related state. If the node
+           count didn't grow since the last time, this reuses the existing
+           memory. */
+        Implementation::FrameArena& nodeStateStorage = state.nodeStateStorage;
+
+        /* If no nodes were added, removed, made top-level or flattened since
+           the last time, the cached children lists are still valid and only
+           the dirty top-level node hierarchies need to be ordered again. The
+           previous output gets copied to temporary storage as the resident
+           allocations get recreated below. */
+        const bool incrementalNodeOrder = !state.visibleNodeOrderNeedsFullUpdate && state.nodeChildrenOffsets.size() == state.nodes.size() + 1;
+        Containers::ArrayView<UnsignedInt> previousVisibleNodeIds;
+        Containers::ArrayView<UnsignedInt> previousVisibleNodeChildrenCounts;
+        if(incrementalNodeOrder) {
+            previousVisibleNodeIds = storage.allocate<UnsignedInt>(NoInit, state.visibleNodeIds.size());
+            previousVisibleNodeChildrenCounts = storage.allocate<UnsignedInt>(NoInit, state.visibleNodeChildrenCounts.size());
+            Utility::copy(state.visibleNodeIds, previousVisibleNodeIds);
+            Utility::copy(state.visibleNodeChildrenCounts, previousVisibleNodeChildrenCounts);
+        }
 
-        /* 1. Order the visible node hierarchy. */
+        nodeStateStorage.reset();
+        state.visibleNodeIds = nodeStateStorage.allocate<UnsignedInt>(NoInit, state.nodes.size());
+        state.visibleNodeChildrenCounts = nodeStateStorage.allocate<UnsignedInt>(NoInit, state.nodes.size());
+        state.visibleFrontToBackTopLevelNodeIndices = nodeStateStorage.allocate<UnsignedInt>(NoInit, state.nodeOrder.size());
+        state.nodeOffsets = nodeStateStorage.allocate<Vector2>(NoInit, state.nodes.size());
+        state.nodeSizes = nodeStateStorage.allocate<Vector2>(NoInit, state.nodes.size());
+        state.absoluteNodeOffsets = nodeStateStorage.allocate<Vector2>(NoInit, state.nodes.size());
+        state.absoluteNodeOpacities = nodeStateStorage.allocate<Float>(NoInit, state.nodes.size());
+        state.visibleSubtreeRects = nodeStateStorage.allocate<Range2D>(NoInit, state.nodes.size());
+        state.visibleNodeMask = nodeStateStorage.allocateBits(NoInit, state.nodes.size());
+        state.visibleEventNodeMask = nodeStateStorage.allocateBits(NoInit, state.nodes.size());
+        state.visibleEnabledNodeMask = nodeStateStorage.allocateBits(NoInit, state.nodes.size());
+        state.visibleBlurNodeMask = nodeStateStorage.allocateBits(NoInit, state.nodes.size());
+        state.clipRectOffsets = nodeStateStorage.allocate<Vector2>(NoInit, state.nodes.size());
+        state.clipRectSizes = nodeStateStorage.allocate<Vector2>(NoInit, state.nodes.size());
+        state.clipRectNodeCounts = nodeStateStorage.allocate<UnsignedInt>(NoInit, state.nodes.size());
+
+        /* 1. Order the visible node hierarchy, either just the parts that
+           changed or everything. */
         {
-            const std::size_t visibleCount = Implementation::orderVisibleNodesDepthFirstInto(
-                stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::parent),
-                stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::order),
-                stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::flags),
-                stridedArrayView(state.nodeOrder).slice(&NodeOrder::used).slice(&NodeOrder::Used::next),
-                state.firstNodeOrder, visibleNodes, childrenOffsets, children,
-                parentsToProcess, state.visibleNodeIds, state.visibleNodeChildrenCounts);
+            std::size_t visibleCount;
+            if(incrementalNodeOrder) {
+                const Containers::MutableBitArrayView dirtyTopLevelNodes = storage.allocateBits(ValueInit, state.nodes.size());
+                const Containers::MutableBitArrayView previousTopLevelNodes = storage.allocateBits(ValueInit, state.nodes.size());
+                const Containers::ArrayView<UnsignedInt> previousTopLevelNodeIndices = storage.allocate<UnsignedInt>(NoInit, state.nodes.size());
+                for(const UnsignedInt id: state.dirtyTopLevelNodeIds)
+                    dirtyTopLevelNodes.set(id);
+                visibleCount = Implementation::orderVisibleNodesDepthFirstIncrementalInto(
+                    stridedArrayView(state.nodeParents),
+                    stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::order),
+                    stridedArrayView(state.nodeFlags),
+                    stridedArrayView(state.nodeOrder).slice(&NodeOrder::used).slice(&NodeOrder::Used::next),
+                    state.firstNodeOrder, dirtyTopLevelNodes,
+                    state.nodeChildrenOffsets, state.nodeChildren,
+                    previousVisibleNodeIds, previousVisibleNodeChildrenCounts,
+                    visibleNodes, previousTopLevelNodes,
+                    previousTopLevelNodeIndices, parentsToProcess,
+                    state.visibleNodeIds, state.visibleNodeChildrenCounts);
+            } else {
+                Implementation::FrameArena& nodeChildrenStorage = state.nodeChildrenStorage;
+                nodeChildrenStorage.reset();
+                /* Running children offset (+1) for each node */
+                state.nodeChildrenOffsets = nodeChildrenStorage.allocate<UnsignedInt>(ValueInit, state.nodes.size() + 1);
+                state.nodeChildren = nodeChildrenStorage.allocate<UnsignedInt>(NoInit, state.nodes.size());
+                visibleCount = Implementation::orderVisibleNodesDepthFirstInto(
+                    stridedArrayView(state.nodeParents),
+                    stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::order),
+                    stridedArrayView(state.nodeFlags),
+                    stridedArrayView(state.nodeOrder).slice(&NodeOrder::used).slice(&NodeOrder::Used::next),
+                    state.firstNodeOrder, visibleNodes,
+                    state.nodeChildrenOffsets, state.nodeChildren,
+                    parentsToProcess, state.visibleNodeIds, state.visibleNodeChildrenCounts);
+            }
             state.visibleNodeIds = state.visibleNodeIds.prefix(visibleCount);
             state.visibleNodeChildrenCounts = state.visibleNodeChildrenCounts.prefix(visibleCount);
+
+            /* The next update can be incremental unless something marks it
+               otherwise again. If there were no top-level nodes, the children
+               lists didn't get filled, so it has to be a full update again. */
+            arrayResize(state.dirtyTopLevelNodeIds, 0);
+            state.visibleNodeOrderNeedsFullUpdate = state.firstNodeOrder == NodeHandle::Null;
         }
 
         /* 2. Create a front-to-back index map for visible top-level nodes,
@@ -2723,10 +3915,12 @@ AbstractUserInterface& AbstractUserInterface::update() {
         }
     }
 
+    stageTracker.begin(UserInterfaceUpdateStage::Layout);
+
     /* If no layout assignment update is needed, the
        `state.layouterStateStorage` and all views pointing to it are
        up-to-date */
-    if(states >= UserInterfaceState::NeedsLayoutAssignmentUpdate) {
+    if(WithLayouters && states >= UserInterfaceState::NeedsLayoutAssignmentUpdate) {
         /* 3. Gather all layouts assigned to a particular node, ordered by the
            layout order. */
         if(state.firstLayouter != LayouterHandle::Null) {
@@ -2753,17 +3947,18 @@ AbstractUserInterface& AbstractUserInterface::update() {
             } while(layouter != state.firstLayouter);
         }
 
-        /* Make a resident allocation for all layout-related state */
-        state.layoutStateStorage = Containers::ArrayTuple{
-            {NoInit, layoutCount + 1, state.topLevelLayoutOffsets},
-            {NoInit, layoutCount, state.topLevelLayoutLayouterIds},
-            {NoInit, layoutCount, state.topLevelLayoutIds},
-        };
+        /* Make a resident allocation for all layout-related state. The
+           layout masks are allocated from it as well, below. */
+        Implementation::FrameArena& layoutStateStorage = state.layoutStateStorage;
+        layoutStateStorage.reset();
+        state.topLevelLayoutOffsets = layoutStateStorage.allocate<UnsignedInt>(NoInit, layoutCount + 1);
+        state.topLevelLayoutLayouterIds = layoutStateStorage.allocate<UnsignedByte>(NoInit, layoutCount);
+        state.topLevelLayoutIds = layoutStateStorage.allocate<UnsignedInt>(NoInit, layoutCount);
 
         /* 4. Discover top-level layouts to be subsequently fed to layouter
            update() calls. */
         const Containers::Pair<UnsignedInt, std::size_t> maxLevelTopLevelLayoutOffsetCount = Implementation::discoverTopLevelLayoutNodesInto(
-            stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::parent),
+            stridedArrayView(state.nodeParents),
             state.visibleNodeIds,
             state.layouters.size(),
             nodeLayouts,
@@ -2788,14 +3983,11 @@ AbstractUserInterface& AbstractUserInterface::update() {
 
         /* Calculate the total bit count for all layout masks and allocate
            them, together with a temporary mapping array */
-        /** @todo while everything else is tucked into an ArrayTuple, often
-            significantly overallocating, this is not -- have some bump
-            allocators finally */
         std::size_t maskSize = 0;
         for(std::size_t i = 0; i != maxLevelTopLevelLayoutOffsetCount.second() - 1; ++i)
             maskSize += state.layouters[state.topLevelLayoutLayouterIds[i]].used.instance->capacity();
-        state.layoutMasks = Containers::BitArray{ValueInit, maskSize};
-        Containers::Array<std::size_t> layouterLevelMaskOffsets{NoInit, state.layouters.size()*maxLevelTopLevelLayoutOffsetCount.first()};
+        state.layoutMasks = layoutStateStorage.allocateBits(ValueInit, maskSize);
+        const Containers::ArrayView<std::size_t> layouterLevelMaskOffsets = storage.allocate<std::size_t>(NoInit, state.layouters.size()*maxLevelTopLevelLayoutOffsetCount.first());
 
         /* 5. Fill the per-layout-update masks. */
         Implementation::fillLayoutUpdateMasksInto(
@@ -2807,69 +3999,270 @@ AbstractUserInterface& AbstractUserInterface::update() {
             layouterCapacities,
             stridedArrayView(layouterLevelMaskOffsets).expanded<0, 2>({maxLevelTopLevelLayoutOffsetCount.first(), state.layouters.size()}),
             state.layoutMasks);
+
+        /* Remember the level of each update() run for step 7. Same as in
+           fillLayoutUpdateMasksInto(), each run is fully contained within a
+           range of particular level, so it's enough to compare the run
+           offset to the level offsets. */
+        state.topLevelLayoutLevels = layoutStateStorage.allocate<UnsignedInt>(NoInit, maxLevelTopLevelLayoutOffsetCount.second() - 1);
+        UnsignedInt currentLevel = 0;
+        for(std::size_t i = 0; i != state.topLevelLayoutLevels.size(); ++i) {
+            if(state.topLevelLayoutOffsets[i] >= layoutLevelOffsets[currentLevel + 1]) {
+                CORRADE_INTERNAL_DEBUG_ASSERT(state.topLevelLayoutOffsets[i] == layoutLevelOffsets[currentLevel + 1]);
+                ++currentLevel;
+            }
+            state.topLevelLayoutLevels[i] = currentLevel;
+        }
+    }
+
+    /* If node offsets or sizes changed but the visible node hierarchy and
+       layout assignments stayed the same, and there are layers that can make
+       use of it, remember the previous node sizes and culling results. If
+       they stay the same after the update, the nodes were only translated and
+       such layers get LayerState::NeedsNodeTranslationUpdate instead of
+       LayerState::NeedsNodeOffsetSizeUpdate in step 15.
+
+       If additionally no data attachments, node flags or the draw list setup
+       changed since the last update, the data order, draw list and event
+       data lists from the last update stay the same as well, and steps 10 to
+       13 can be skipped. That isn't the case with compositing layers, draw
+       merging or draw caches, which all depend on node offsets. */
+    bool nodeTranslationCandidate = false;
+    bool dataOrderReuseCandidate = false;
+    if(states >= UserInterfaceState::NeedsLayoutUpdate && !(states >= UserInterfaceState::NeedsLayoutAssignmentUpdate)) {
+        dataOrderReuseCandidate =
+            !state.dataOrderNeedsUpdate &&
+            !(states >= UserInterfaceState::NeedsDataClean) &&
+            !state.drawMerging &&
+            !state.rendererDrawCache &&
+            state.layers.size() + 1 == state.dataToUpdateLayerOffsets.size();
+        for(const Layer& layer: state.layers) {
+            if(layer.used.features >= LayerFeature::NodeTranslation)
+                nodeTranslationCandidate = true;
+            if((WithCompositeLayers && layer.used.features >= LayerFeature::Composite) ||
+               (layer.used.instance && layer.used.instance->state() >= LayerState::NeedsAttachmentUpdate))
+                dataOrderReuseCandidate = false;
+        }
+        if(dataOrderReuseCandidate)
+            nodeTranslationCandidate = true;
+    }
+    Containers::ArrayView<Vector2> previousVisibleNodeSizes;
+    Containers::ArrayView<char> previousVisibleNodeMask;
+    Containers::ArrayView<UnsignedInt> previousClipRectNodeCounts;
+    Containers::ArrayView<Vector2> previousClipRectSizes;
+    if(nodeTranslationCandidate) {
+        previousVisibleNodeSizes = storage.allocate<Vector2>(NoInit, state.visibleNodeIds.size());
+        for(std::size_t i = 0; i != state.visibleNodeIds.size(); ++i)
+            previousVisibleNodeSizes[i] = state.nodeSizes[state.visibleNodeIds[i]];
+        /** @todo copy() for a BitArrayView, finally */
+        CORRADE_INTERNAL_ASSERT(state.visibleNodeMask.offset() == 0);
+        previousVisibleNodeMask = storage.allocate<char>(NoInit, (state.visibleNodeMask.size() + 7)/8);
+        Utility::copy(Containers::arrayView(static_cast<const char*>(state.visibleNodeMask.data()), previousVisibleNodeMask.size()), previousVisibleNodeMask);
+        previousClipRectNodeCounts = storage.allocate<UnsignedInt>(NoInit, state.clipRectCount);
+        previousClipRectSizes = storage.allocate<Vector2>(NoInit, state.clipRectCount);
+        Utility::copy(state.clipRectNodeCounts.prefix(state.clipRectCount), previousClipRectNodeCounts);
+        Utility::copy(state.clipRectSizes.prefix(state.clipRectCount), previousClipRectSizes);
     }
 
     /* If no layout update is needed, the `state.nodeOffsets`,
        `state.nodeSizes` and `state.absoluteNodeOffsets` are all
        up-to-date */
     if(states >= UserInterfaceState::NeedsLayoutUpdate) {
-        /* 6. Copy the explicitly set offset + sizes to the output. */
-        Utility::copy(stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::offset), state.nodeOffsets);
-        Utility::copy(stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::size), state.nodeSizes);
-
-        /* 7. Perform layout calculation for all top-level layouts. */
-        std::size_t offset = 0;
-        for(std::size_t i = 0; i != state.topLevelLayoutOffsets.size() - 1; ++i) {
-            AbstractLayouter* const instance = state.layouters[state.topLevelLayoutLayouterIds[i]].used.instance.get();
-            CORRADE_INTERNAL_ASSERT(instance);
-
-            instance->update(
-                state.layoutMasks.sliceSize(offset, instance->capacity()),
-                state.topLevelLayoutIds.slice(
+        /* If the layout assignments didn't change, no layouter needs an
+           update on its own and no node offsets or sizes were changed by
+           animations or on root nodes, only layouts in hierarchies of root
+           nodes that had a node offset or size changed need to be updated.
+           The other nodes keep the offsets and sizes calculated previously. */
+        bool fullLayoutUpdate = state.layoutNeedsFullUpdate || states >= UserInterfaceState::NeedsLayoutAssignmentUpdate;
+        for(std::size_t i = 0; !fullLayoutUpdate && i != state.layouters.size(); ++i) {
+            const AbstractLayouter* const instance = state.layouters[i].used.instance.get();
+            if(instance && instance->state() >= LayouterState::NeedsUpdate)
+                fullLayoutUpdate = true;
+        }
+        Containers::MutableBitArrayView dirtyLayoutNodes;
+        if(!fullLayoutUpdate) {
+            const Containers::MutableBitArrayView dirtyLayoutRootNodes = storage.allocateBits(ValueInit, state.nodes.size());
+            for(const UnsignedInt id: state.dirtyLayoutRootNodeIds)
+                dirtyLayoutRootNodes.set(id);
+            dirtyLayoutNodes = storage.allocateBits(ValueInit, state.nodes.size());
+            Implementation::markDirtyLayoutNodesInto(
+                stridedArrayView(state.nodeParents),
+                state.visibleNodeIds,
+                dirtyLayoutRootNodes,
+                dirtyLayoutNodes);
+        }
+
+        /* 6. Copy the explicitly set offset + sizes to the output, either for
+           all nodes or just the ones in dirty hierarchies. */
+        if(fullLayoutUpdate) {
+            Utility::copy(stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::offset), state.nodeOffsets);
+            Utility::copy(stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::size), state.nodeSizes);
+        } else Implementation::forEachSetBit(dirtyLayoutNodes, [&](const std::size_t id) {
+            state.nodeOffsets[id] = state.nodes[id].used.offset;
+            state.nodeSizes[id] = state.nodes[id].used.size;
+        });
+
+        /* 7. Perform layout calculation for all top-level layouts, or just
+           the ones assigned to nodes in dirty hierarchies. Without layouters
+           compiled in, there's nothing to calculate, the offsets and sizes
+           are just the ones copied above. */
+        if(WithLayouters) {
+            /* First gather the masks and top-level layout lists of all
+               update() runs, filtering them if it's just a partial update.
+               All allocations are done here as the storage can't be used from
+               the concurrent tasks below. */
+            struct LayoutUpdate {
+                AbstractLayouter* instance;
+                Containers::BitArrayView layoutIdsToUpdate;
+                Containers::StridedArrayView1D<const UnsignedInt> topLevelLayoutIds;
+                UnsignedInt level;
+                bool concurrent;
+            };
+            const Containers::ArrayView<LayoutUpdate> layoutUpdates = storage.allocate<LayoutUpdate>(NoInit, state.topLevelLayoutOffsets.size() - 1);
+            std::size_t layoutUpdateCount = 0;
+            std::size_t offset = 0;
+            for(std::size_t i = 0; i != state.topLevelLayoutOffsets.size() - 1; ++i) {
+                const Layouter& layouter = state.layouters[state.topLevelLayoutLayouterIds[i]];
+                AbstractLayouter* const instance = layouter.used.instance.get();
+                CORRADE_INTERNAL_ASSERT(instance);
+
+                Containers::BitArrayView layoutIdsToUpdate = state.layoutMasks.sliceSize(offset, instance->capacity());
+                Containers::StridedArrayView1D<const UnsignedInt> topLevelLayoutIds = state.topLevelLayoutIds.slice(
                     state.topLevelLayoutOffsets[i],
-                    state.topLevelLayoutOffsets[i + 1]),
-                stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::parent),
-                state.nodeOffsets,
-                state.nodeSizes);
+                    state.topLevelLayoutOffsets[i + 1]);
+                offset += instance->capacity();
+
+                if(!fullLayoutUpdate) {
+                    const Containers::MutableBitArrayView filteredLayoutIdsToUpdate = storage.allocateBits(ValueInit, instance->capacity());
+                    const Containers::ArrayView<UnsignedInt> filteredTopLevelLayoutIds = storage.allocate<UnsignedInt>(NoInit, topLevelLayoutIds.size());
+                    const std::size_t count = Implementation::filterLayoutUpdateMaskInto(
+                        layoutIdsToUpdate,
+                        topLevelLayoutIds,
+                        instance->nodes(),
+                        dirtyLayoutNodes,
+                        filteredLayoutIdsToUpdate,
+                        filteredTopLevelLayoutIds);
+                    /* Nothing from this run is in the dirty hierarchies, skip it
+                       altogether */
+                    if(!count)
+                        continue;
+                    layoutIdsToUpdate = filteredLayoutIdsToUpdate;
+                    topLevelLayoutIds = filteredTopLevelLayoutIds.prefix(count);
+                }
 
-            offset += instance->capacity();
-        }
-        CORRADE_INTERNAL_ASSERT(offset == state.layoutMasks.size());
-
-        /* Call a no-op update() on layouters that have Needs*Update flags but
-           have no visible layouts so update() wasn't called for them above */
-        /** @todo this is nasty, think of a better solution */
-        for(Layouter& layouter: state.layouters) {
-            AbstractLayouter* const instance = layouter.used.instance.get();
-            if(instance && instance->state() & LayouterState::NeedsAssignmentUpdate) {
-                instance->update(
-                    /** @todo yeah and this allocation REALLY isn't great */
-                    Containers::BitArray{ValueInit, instance->capacity()},
-                    {},
-                    stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::parent),
-                    state.nodeOffsets, state.nodeSizes);
+                LayoutUpdate& update = layoutUpdates[layoutUpdateCount++];
+                update.instance = instance;
+                update.layoutIdsToUpdate = layoutIdsToUpdate;
+                update.topLevelLayoutIds = topLevelLayoutIds;
+                update.level = state.topLevelLayoutLevels[i];
+                update.concurrent = state.updateExecutor && layouter.used.features >= LayouterFeature::ConcurrentUpdate;
+            }
+            CORRADE_INTERNAL_ASSERT(offset == state.layoutMasks.size());
+
+            /* Then execute the runs level by level. Runs of the same level don't
+               depend on each other and each is done by a different layouter, so
+               if there's more than one with LayouterFeature::ConcurrentUpdate,
+               they're dispatched to the update executor together. The remaining
+               runs of given level are executed serially. */
+            struct ConcurrentLayoutUpdate {
+                Containers::ArrayView<const LayoutUpdate* const> layoutUpdates;
+                Containers::StridedArrayView1D<const NodeHandle> nodeParents;
+                Containers::StridedArrayView1D<Vector2> nodeOffsets;
+                Containers::StridedArrayView1D<Vector2> nodeSizes;
+            };
+            const Containers::ArrayView<const LayoutUpdate*> concurrentLayoutUpdates = storage.allocate<const LayoutUpdate*>(NoInit, layoutUpdateCount);
+            for(std::size_t levelBegin = 0, levelEnd; levelBegin != layoutUpdateCount; levelBegin = levelEnd) {
+                std::size_t concurrentCount = 0;
+                for(levelEnd = levelBegin; levelEnd != layoutUpdateCount && layoutUpdates[levelEnd].level == layoutUpdates[levelBegin].level; ++levelEnd)
+                    if(layoutUpdates[levelEnd].concurrent)
+                        concurrentLayoutUpdates[concurrentCount++] = &layoutUpdates[levelEnd];
+
+                if(concurrentCount > 1) {
+                    ConcurrentLayoutUpdate concurrentUpdate{
+                        concurrentLayoutUpdates.prefix(concurrentCount),
+                        stridedArrayView(state.nodeParents),
+                        state.nodeOffsets,
+                        state.nodeSizes};
+                    state.updateExecutor(concurrentCount, [](void* data, const std::size_t i) {
+                        const ConcurrentLayoutUpdate& concurrentUpdate = *static_cast<const ConcurrentLayoutUpdate*>(data);
+                        const LayoutUpdate& update = *concurrentUpdate.layoutUpdates[i];
+                        update.instance->update(
+                            update.layoutIdsToUpdate,
+                            update.topLevelLayoutIds,
+                            concurrentUpdate.nodeParents,
+                            concurrentUpdate.nodeOffsets,
+                            concurrentUpdate.nodeSizes);
+                    }, &concurrentUpdate);
+                }
+
+                for(std::size_t i = levelBegin; i != levelEnd; ++i) {
+                    const LayoutUpdate& update = layoutUpdates[i];
+                    if(update.concurrent && concurrentCount > 1)
+                        continue;
+                    update.instance->update(
+                        update.layoutIdsToUpdate,
+                        update.topLevelLayoutIds,
+                        stridedArrayView(state.nodeParents),
+                        state.nodeOffsets,
+                        state.nodeSizes);
+                }
+            }
+
+            /* Call a no-op update() on layouters that have Needs*Update flags but
+               have no visible layouts so update() wasn't called for them above */
+            /** @todo this is nasty, think of a better solution */
+            for(Layouter& layouter: state.layouters) {
+                AbstractLayouter* const instance = layouter.used.instance.get();
+                if(instance && instance->state() & LayouterState::NeedsAssignmentUpdate) {
+                    instance->update(
+                        storage.allocateBits(ValueInit, instance->capacity()),
+                        {},
+                        stridedArrayView(state.nodeParents),
+                        state.nodeOffsets, state.nodeSizes);
+                }
             }
         }
 
-        /* 8. Calculate absolute offsets for visible nodes. */
+        /* 8. Calculate absolute offsets for visible nodes, again either all
+           or just the ones in dirty hierarchies. */
         for(const UnsignedInt id: state.visibleNodeIds) {
-            const Node& node = state.nodes[id];
+            if(!fullLayoutUpdate && !dirtyLayoutNodes[id])
+                continue;
+            const NodeHandle parent = state.nodeParents[id];
             const Vector2 nodeOffset = state.nodeOffsets[id];
             state.absoluteNodeOffsets[id] =
-                node.used.parent == NodeHandle::Null ? nodeOffset :
-                    state.absoluteNodeOffsets[nodeHandleId(node.used.parent)] + nodeOffset;
+                parent == NodeHandle::Null ? nodeOffset :
+                    state.absoluteNodeOffsets[nodeHandleId(parent)] + nodeOffset;
         }
+
+        /* Then calculate bounding rects of all visible node subtrees for
+           culling below. Done always for all nodes, as a change in a dirty
+           hierarchy propagates up to its root. */
+        state.visibleSubtreeRects = state.visibleSubtreeRects.prefix(state.visibleNodeIds.size());
+        Implementation::visibleSubtreeRectsInto(
+            state.visibleNodeIds,
+            state.visibleNodeChildrenCounts,
+            state.absoluteNodeOffsets,
+            state.nodeSizes,
+            state.visibleSubtreeRects);
+
+        /* The next layout update can be partial unless something marks it
+           otherwise again */
+        arrayResize(state.dirtyLayoutRootNodeIds, 0);
+        state.layoutNeedsFullUpdate = false;
     }
 
+    stageTracker.begin(UserInterfaceUpdateStage::NodeState);
+
     /* If no opacity update is needed, the `state.absoluteNodeOpacities` are
        all up-to-date */
     if(states >= UserInterfaceState::NeedsNodeOpacityUpdate) {
         for(const UnsignedInt id: state.visibleNodeIds) {
-            const Node& node = state.nodes[id];
-            const Float nodeOpacity = node.used.opacity;
+            const NodeHandle parent = state.nodeParents[id];
+            const Float nodeOpacity = state.nodes[id].used.opacity;
             state.absoluteNodeOpacities[id] =
-                node.used.parent == NodeHandle::Null ? nodeOpacity :
-                    state.absoluteNodeOpacities[nodeHandleId(node.used.parent)]*nodeOpacity;
+                parent == NodeHandle::Null ? nodeOpacity :
+                    state.absoluteNodeOpacities[nodeHandleId(parent)]*nodeOpacity;
         }
     }
 
@@ -2886,20 +4279,40 @@ AbstractUserInterface& AbstractUserInterface::update() {
             {}, state.size,
             state.absoluteNodeOffsets,
             state.nodeSizes,
-            stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::flags),
+            stridedArrayView(state.nodeFlags),
             clipStack.prefix(state.visibleNodeIds.size() + 1),
             state.visibleNodeIds,
             state.visibleNodeChildrenCounts,
             state.visibleNodeMask,
             state.clipRectOffsets,
             state.clipRectSizes,
-            state.clipRectNodeCounts);
+            state.clipRectNodeCounts,
+            state.visibleSubtreeRects);
 
         /** @todo might want also a layer-specific cull / clip implementation
             that gets called after the "upload" step, for line art, text runs
             and such */
     }
 
+    /* If node sizes, the set of visible nodes and clip rects are the same as
+       before, it was a translation-only change */
+    bool nodeTranslationOnly = false;
+    if(nodeTranslationCandidate) {
+        nodeTranslationOnly = state.clipRectCount == previousClipRectSizes.size();
+        for(std::size_t i = 0; nodeTranslationOnly && i != state.visibleNodeIds.size(); ++i)
+            nodeTranslationOnly = state.nodeSizes[state.visibleNodeIds[i]] == previousVisibleNodeSizes[i];
+        /* The padding bits in the last byte aren't compared */
+        const Containers::BitArrayView previousVisibleNodes{previousVisibleNodeMask.data(), 0, state.visibleNodeMask.size()};
+        for(std::size_t i = 0; nodeTranslationOnly && i != state.visibleNodeMask.size()/8; ++i)
+            nodeTranslationOnly = static_cast<const char*>(state.visibleNodeMask.data())[i] == previousVisibleNodeMask[i];
+        for(std::size_t i = state.visibleNodeMask.size()/8*8; nodeTranslationOnly && i != state.visibleNodeMask.size(); ++i)
+            nodeTranslationOnly = state.visibleNodeMask[i] == previousVisibleNodes[i];
+        for(std::size_t i = 0; nodeTranslationOnly && i != state.clipRectCount; ++i)
+            nodeTranslationOnly =
+                state.clipRectNodeCounts[i] == previousClipRectNodeCounts[i] &&
+                state.clipRectSizes[i] == previousClipRectSizes[i];
+    }
+
     /* If no node enabled state update is needed, the `state.visibleNodeMask`,
        `state.visibleEventNodeMask` and `state.visibleEnabledNodeMask` are
        up-to-date.
@@ -2921,12 +4334,12 @@ AbstractUserInterface& AbstractUserInterface::update() {
             Containers::arrayView(state.visibleNodeMask.data(), sizeWholeBytes),
             Containers::arrayView(state.visibleEnabledNodeMask.data(), sizeWholeBytes));
         Implementation::propagateNodeFlagToChildrenInto<NodeFlag::NoEvents>(
-            stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::flags),
+            stridedArrayView(state.nodeFlags),
             state.visibleNodeIds,
             state.visibleNodeChildrenCounts,
             state.visibleEventNodeMask);
         Implementation::propagateNodeFlagToChildrenInto<NodeFlag::Disabled>(
-            stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::flags),
+            stridedArrayView(state.nodeFlags),
             state.visibleNodeIds,
             state.visibleNodeChildrenCounts,
             state.visibleEnabledNodeMask);
@@ -2942,16 +4355,38 @@ AbstractUserInterface& AbstractUserInterface::update() {
             Containers::arrayView(state.visibleNodeMask.data(), sizeWholeBytes),
             Containers::arrayView(state.visibleBlurNodeMask.data(), sizeWholeBytes));
         Implementation::propagateNodeFlagToChildrenInto<NodeFlag::NoBlur>(
-            stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::flags),
+            stridedArrayView(state.nodeFlags),
             state.visibleNodeIds,
             state.visibleNodeChildrenCounts,
             state.visibleBlurNodeMask);
     }
 
+    stageTracker.begin(UserInterfaceUpdateStage::DataOrder);
+
+    /* If the node update was translation-only and nothing else affecting the
+       data order changed, the data in `state.dataStateStorage` is still
+       up-to-date as well, as it depends only on the visible node order, the
+       culling results and node flags. It's however also required that all
+       valid `state.current*Node` are still visible and taking events, as
+       otherwise step 14 would need `visibleOrVisibilityLostEventNodeMask`,
+       which is filled only in the branch below. */
+    bool dataOrderReused = dataOrderReuseCandidate && nodeTranslationOnly;
+    for(const NodeHandle node: {state.currentPressedNode,
+                                state.currentCapturedNode,
+                                state.currentHoveredNode,
+                                state.currentFocusedNode})
+        if(dataOrderReused && isHandleValid(node) && !state.visibleEventNodeMask[nodeHandleId(node)])
+            dataOrderReused = false;
+
+    /* The hit testing grids depend on node offsets, so they need a rebuild
+       even if the data order stays the same */
+    if(dataOrderReused) {
+        state.hitTestGridsNeedUpdate = true;
+
     /* If no data attachment update is needed, the data in
        `state.dataStateStorage` and all views pointing to it is already
        up-to-date. */
-    if(states >= UserInterfaceState::NeedsDataAttachmentUpdate ||
+    } else if(states >= UserInterfaceState::NeedsDataAttachmentUpdate ||
        /* Trigger this branch also if NeedsDataUpdate is set but size of
           `state.dataToUpdateLayerOffsets` isn't in sync with `state.layers`
           size, which happens for example if setNeedsUpdate() is called on a
@@ -2988,11 +4423,13 @@ AbstractUserInterface& AbstractUserInterface::update() {
            order to accurately size the array with draws */
         UnsignedInt visibleTopLevelNodeCount = 0;
         for(UnsignedInt visibleTopLevelNodeIndex = 0; visibleTopLevelNodeIndex != state.visibleNodeChildrenCounts.size(); visibleTopLevelNodeIndex += state.visibleNodeChildrenCounts[visibleTopLevelNodeIndex] + 1) {
-            if(!(state.nodes[state.visibleNodeIds[visibleTopLevelNodeIndex]].used.flags & NodeFlag::Hidden))
+            if(!(state.nodeFlags[state.visibleNodeIds[visibleTopLevelNodeIndex]] & NodeFlag::Hidden))
                 ++visibleTopLevelNodeCount;
         }
         UnsignedInt drawLayerCount = 0;
         std::size_t compositingDataCount = 0;
+        bool separateMoveEventData = false;
+        bool batchEventData = false;
         for(const Layer& layer: state.layers) {
             /* This assumes that freed layers (or recycled layers without any
                instance set yet) have the features cleared to an empty set
@@ -3000,33 +4437,64 @@ AbstractUserInterface& AbstractUserInterface::update() {
                an instance as well. */
             if(layer.used.features & LayerFeature::Draw)
                 ++drawLayerCount;
-            if(layer.used.features & LayerFeature::Composite)
+            if(WithCompositeLayers && layer.used.features & LayerFeature::Composite)
                 compositingDataCount += layer.used.instance->capacity();
+            if(layer.used.features & LayerFeature::Event && !(layer.used.events & LayerEvent::PointerMove))
+                separateMoveEventData = true;
+            if(layer.used.features >= LayerFeature::EventBatch)
+                batchEventData = true;
         }
 
         /* Make a resident allocation for all data-related state */
-        state.dataStateStorage = Containers::ArrayTuple{
-            /* Running data offset (+1) for each item. Populated sequentially
-               so it doesn't need to be zero-initialized. */
-            {NoInit, state.layers.size() + 1, state.dataToUpdateLayerOffsets},
-            {NoInit, dataCount, state.dataToUpdateIds},
-            /* The orderVisibleNodeDataInto() algorithm assumes there can be
-               a dedicated clip rect for every visible node. It's being run for
-               all layers, so in order to fit it has to have layer count times
-               visible node count elements. */
-            {NoInit, state.visibleNodeIds.size()*state.layers.size(), state.dataToUpdateClipRectIds},
-            {NoInit, state.visibleNodeIds.size()*state.layers.size(), state.dataToUpdateClipRectDataCounts},
-            {NoInit, compositingDataCount, state.dataToUpdateCompositeRectOffsets},
-            {NoInit, compositingDataCount, state.dataToUpdateCompositeRectSizes},
-            {NoInit, visibleTopLevelNodeCount*drawLayerCount, state.dataToDrawLayerIds},
-            {NoInit, visibleTopLevelNodeCount*drawLayerCount, state.dataToDrawOffsets},
-            {NoInit, visibleTopLevelNodeCount*drawLayerCount, state.dataToDrawSizes},
-            {NoInit, visibleTopLevelNodeCount*drawLayerCount, state.dataToDrawClipRectOffsets},
-            {NoInit, visibleTopLevelNodeCount*drawLayerCount, state.dataToDrawClipRectSizes},
-            /* Running data offset (+1) for each item */
-            {ValueInit, state.nodes.size() + 1, state.visibleNodeEventDataOffsets},
-            {NoInit, dataCount, state.visibleNodeEventData},
-        };
+        Implementation::FrameArena& dataStateStorage = state.dataStateStorage;
+        dataStateStorage.reset();
+        /* Running data offset (+1) for each item. Populated sequentially so
+           it doesn't need to be zero-initialized. */
+        state.dataToUpdateLayerOffsets = dataStateStorage.allocate<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>>(NoInit, state.layers.size() + 1);
+        state.dataToUpdateIds = dataStateStorage.allocate<UnsignedInt>(NoInit, dataCount);
+        /* The orderVisibleNodeDataInto() algorithm assumes there can be a
+           dedicated clip rect for every visible node. It's being run for all
+           layers, so in order to fit it has to have layer count times visible
+           node count elements. */
+        state.dataToUpdateClipRectIds = dataStateStorage.allocate<UnsignedInt>(NoInit, state.visibleNodeIds.size()*state.layers.size());
+        state.dataToUpdateClipRectDataCounts = dataStateStorage.allocate<UnsignedInt>(NoInit, state.visibleNodeIds.size()*state.layers.size());
+        state.dataToUpdateCompositeRectOffsets = dataStateStorage.allocate<Vector2>(NoInit, compositingDataCount);
+        state.dataToUpdateCompositeRectSizes = dataStateStorage.allocate<Vector2>(NoInit, compositingDataCount);
+        state.dataToDrawLayerIds = dataStateStorage.allocate<UnsignedByte>(NoInit, visibleTopLevelNodeCount*drawLayerCount);
+        state.dataToDrawOffsets = dataStateStorage.allocate<UnsignedInt>(NoInit, visibleTopLevelNodeCount*drawLayerCount);
+        state.dataToDrawSizes = dataStateStorage.allocate<UnsignedInt>(NoInit, visibleTopLevelNodeCount*drawLayerCount);
+        state.dataToDrawClipRectOffsets = dataStateStorage.allocate<UnsignedInt>(NoInit, visibleTopLevelNodeCount*drawLayerCount);
+        state.dataToDrawClipRectSizes = dataStateStorage.allocate<UnsignedInt>(NoInit, visibleTopLevelNodeCount*drawLayerCount);
+        /* Running data offset (+1) for each item */
+        state.visibleNodeEventDataOffsets = dataStateStorage.allocate<UnsignedInt>(ValueInit, state.nodes.size() + 1);
+        state.visibleNodeEventData = dataStateStorage.allocate<DataHandle>(NoInit, dataCount);
+        /* Populated sequentially as well */
+        state.visibleSubtreeEventDataOffsets = dataStateStorage.allocate<UnsignedInt>(NoInit, state.visibleNodeIds.size() + 1);
+        /* The cached fallthrough parent query depends on the event data, so
+           it has to be redone */
+        state.fallthroughCheckedNode = NodeHandle::Null;
+        /* If there are event layers that don't handle pointer move events,
+           have a dedicated list for those, otherwise it's the same */
+        if(separateMoveEventData) {
+            state.visibleNodeMoveEventDataOffsets = dataStateStorage.allocate<UnsignedInt>(ValueInit, state.nodes.size() + 1);
+            state.visibleNodeMoveEventData = dataStateStorage.allocate<DataHandle>(NoInit, dataCount);
+            state.visibleSubtreeMoveEventDataOffsets = dataStateStorage.allocate<UnsignedInt>(NoInit, state.visibleNodeIds.size() + 1);
+        } else {
+            state.visibleNodeMoveEventDataOffsets = state.visibleNodeEventDataOffsets;
+            state.visibleNodeMoveEventData = state.visibleNodeEventData;
+            state.visibleSubtreeMoveEventDataOffsets = state.visibleSubtreeEventDataOffsets;
+        }
+        /* Data IDs for batched event handling, again sharing the same list
+           if there are no layers that don't handle pointer move events */
+        if(batchEventData) {
+            state.visibleNodeEventDataIds = dataStateStorage.allocate<UnsignedInt>(NoInit, dataCount);
+            state.visibleNodeMoveEventDataIds = separateMoveEventData ?
+                dataStateStorage.allocate<UnsignedInt>(NoInit, dataCount) :
+                state.visibleNodeEventDataIds;
+        } else {
+            state.visibleNodeEventDataIds = {};
+            state.visibleNodeMoveEventDataIds = {};
+        }
 
         state.dataToUpdateLayerOffsets[0] = {0, 0, 0};
         if(state.firstLayer != LayerHandle::Null) {
@@ -3122,15 +4590,21 @@ AbstractUserInterface& AbstractUserInterface::update() {
                        collected also for nodes that may no longer participate
                        in event handling but still need visibilityLostEvent()
                        called. */
-                    if(layerItem.used.features >= LayerFeature::Event)
+                    if(layerItem.used.features >= LayerFeature::Event) {
                         Implementation::countNodeDataForEventHandlingInto(
                             instance->nodes(),
                             state.visibleNodeEventDataOffsets,
                             visibleOrVisibilityLostEventNodeMask);
+                        if(separateMoveEventData && layerItem.used.events >= LayerEvent::PointerMove)
+                            Implementation::countNodeDataForEventHandlingInto(
+                                instance->nodes(),
+                                state.visibleNodeMoveEventDataOffsets,
+                                visibleOrVisibilityLostEventNodeMask);
+                    }
 
                     /* If the layer has LayerFeature::Composite, calculate
                        rects for compositing */
-                    if(layerItem.used.features >= LayerFeature::Composite) {
+                    if(WithCompositeLayers && layerItem.used.features >= LayerFeature::Composite) {
                         Implementation::compositeRectsInto(
                             /** @todo might be useful to make the offset
                                 configurable as well, likewise in the
@@ -3172,6 +4646,14 @@ AbstractUserInterface& AbstractUserInterface::update() {
                     visibleNodeEventDataCount = nextOffset;
                 }
             }
+            if(separateMoveEventData) {
+                UnsignedInt visibleNodeMoveEventDataCount = 0;
+                for(UnsignedInt& i: state.visibleNodeMoveEventDataOffsets) {
+                    const UnsignedInt nextOffset = visibleNodeMoveEventDataCount + i;
+                    i = visibleNodeMoveEventDataCount;
+                    visibleNodeMoveEventDataCount = nextOffset;
+                }
+            }
 
             /* 12. Go through all event handling layers and populate the
                `state.visibleNodeEventData` array based on the
@@ -3204,15 +4686,157 @@ AbstractUserInterface& AbstractUserInterface::update() {
                            visibilityLostEvent() called. */
                         visibleOrVisibilityLostEventNodeMask,
                         state.visibleNodeEventData);
+
+                    /* Data of layers handling pointer move events go also to
+                       the dedicated list, if there's one */
+                    if(separateMoveEventData && layerItem.used.events >= LayerEvent::PointerMove)
+                        Implementation::orderNodeDataForEventHandlingInto(
+                            layer,
+                            layerItem.used.instance->nodes(),
+                            state.visibleNodeMoveEventDataOffsets,
+                            visibleOrVisibilityLostEventNodeMask,
+                            state.visibleNodeMoveEventData);
                 }
 
                 layer = layerItem.used.previous;
             } while(layer != lastLayer);
+
+            /* If there are layers handling events in batches, extract the
+               data IDs so a contiguous run of them can be passed directly */
+            if(batchEventData) {
+                for(std::size_t i = 0, iMax = state.visibleNodeEventDataOffsets.back(); i != iMax; ++i)
+                    state.visibleNodeEventDataIds[i] = dataHandleId(state.visibleNodeEventData[i]);
+                if(separateMoveEventData)
+                    for(std::size_t i = 0, iMax = state.visibleNodeMoveEventDataOffsets.back(); i != iMax; ++i)
+                        state.visibleNodeMoveEventDataIds[i] = dataHandleId(state.visibleNodeMoveEventData[i]);
+            }
+        }
+
+        /* Count event data in each visible subtree to make it possible to
+           skip hit testing subtrees with nothing to call an event on. If
+           there are no layers, `state.visibleNodeEventDataOffsets` is all
+           zeros, which makes all subtrees empty. The hit testing grids depend
+           on these as well as on node offsets, sizes and visibility, all of
+           which lead to this branch being executed, so mark them for a
+           rebuild. */
+        Implementation::visibleSubtreeEventDataOffsetsInto(
+            state.visibleNodeIds,
+            state.visibleEventNodeMask,
+            state.visibleNodeEventDataOffsets,
+            state.visibleSubtreeEventDataOffsets);
+        if(separateMoveEventData)
+            Implementation::visibleSubtreeEventDataOffsetsInto(
+                state.visibleNodeIds,
+                state.visibleEventNodeMask,
+                state.visibleNodeMoveEventDataOffsets,
+                state.visibleSubtreeMoveEventDataOffsets);
+        state.hitTestGridsNeedUpdate = true;
+
+        /* 13. If the renderer supports draw caches, collect top-level node
+           hierarchies that are drawn from a cache. If draw merging is
+           enabled and there are no cached hierarchies, reorder the draws so
+           draws of the same layer in consecutive non-overlapping top-level
+           nodes are next to each other. Layers that composite are excluded
+           from both. */
+        const bool drawCache = state.rendererDrawCache && !state.dataToDrawLayerIds.isEmpty();
+        Containers::MutableBitArrayView compositeLayers;
+        Containers::ArrayView<Range2D> topLevelNodeRects;
+        Containers::ArrayView<UnsignedInt> topLevelNodeIndices;
+        if(drawCache || (state.drawMerging && !state.dataToDrawLayerIds.isEmpty())) {
+            compositeLayers = storage.allocateBits(ValueInit, state.layers.size());
+            for(std::size_t i = 0; i != state.layers.size(); ++i)
+                if(WithCompositeLayers && state.layers[i].used.features >= LayerFeature::Composite)
+                    compositeLayers.set(i);
+
+            /* Bounding rect of all visible nodes in each top-level node
+               hierarchy, skipping the hidden ones same as when counting them
+               above */
+            topLevelNodeRects = storage.allocate<Range2D>(NoInit, visibleTopLevelNodeCount);
+            topLevelNodeIndices = storage.allocate<UnsignedInt>(NoInit, visibleTopLevelNodeCount);
+            std::size_t topLevelNodeRectOffset = 0;
+            for(UnsignedInt visibleTopLevelNodeIndex = 0; visibleTopLevelNodeIndex != state.visibleNodeChildrenCounts.size(); visibleTopLevelNodeIndex += state.visibleNodeChildrenCounts[visibleTopLevelNodeIndex] + 1) {
+                if(state.nodeFlags[state.visibleNodeIds[visibleTopLevelNodeIndex]] & NodeFlag::Hidden)
+                    continue;
+                Range2D rect;
+                for(UnsignedInt i = visibleTopLevelNodeIndex, iMax = i + state.visibleNodeChildrenCounts[visibleTopLevelNodeIndex] + 1; i != iMax; ++i) {
+                    const UnsignedInt id = state.visibleNodeIds[i];
+                    if(state.visibleNodeMask[id])
+                        rect = Math::join(rect, Range2D::fromSize(state.absoluteNodeOffsets[id], state.nodeSizes[id]));
+                }
+                topLevelNodeIndices[topLevelNodeRectOffset] = visibleTopLevelNodeIndex;
+                topLevelNodeRects[topLevelNodeRectOffset++] = rect;
+            }
+            CORRADE_INTERNAL_ASSERT(topLevelNodeRectOffset == visibleTopLevelNodeCount);
+        }
+
+        state.cachedDraws = {};
+        if(drawCache) {
+            const Containers::MutableBitArrayView cachedTopLevelNodes = storage.allocateBits(ValueInit, visibleTopLevelNodeCount);
+            for(std::size_t i = 0; i != visibleTopLevelNodeCount; ++i)
+                if(state.nodeFlags[state.visibleNodeIds[topLevelNodeIndices[i]]] >= NodeFlag::Cached)
+                    cachedTopLevelNodes.set(i);
+
+            state.cachedDraws = dataStateStorage.allocate<Implementation::CachedDraw>(NoInit, visibleTopLevelNodeCount);
+            state.cachedDraws = state.cachedDraws.prefix(Implementation::cachedDrawsInto(
+                state.visibleNodeIds,
+                topLevelNodeIndices,
+                topLevelNodeRects,
+                cachedTopLevelNodes,
+                state.dataToDrawLayerIds,
+                state.dataToDrawSizes,
+                compositeLayers,
+                state.cachedDraws));
+        }
+
+        /* Caches of nodes that are no longer drawn from them get discarded in
+           the next draw. As changes in such nodes aren't tracked, their
+           contents are rendered again if they're drawn from a cache again. */
+        if(state.rendererDrawCache) {
+            arrayResize(state.nodeCaches, ValueInit, state.nodes.size());
+            for(Implementation::NodeCache& i: state.nodeCaches)
+                i.drawn = false;
+            for(const Implementation::CachedDraw& i: state.cachedDraws)
+                state.nodeCaches[i.nodeId].drawn = true;
+            for(Implementation::NodeCache& i: state.nodeCaches)
+                if(!i.drawn)
+                    i.valid = false;
+        }
+
+        const bool drawMerging = state.drawMerging && state.cachedDraws.isEmpty();
+        if(drawMerging && !state.dataToDrawLayerIds.isEmpty()) {
+            const std::size_t count = state.dataToDrawLayerIds.size();
+            const Containers::ArrayView<UnsignedInt> drawOrder = storage.allocate<UnsignedInt>(NoInit, count);
+            Implementation::mergeableDrawOrderInto(
+                topLevelNodeRects,
+                state.dataToDrawLayerIds,
+                state.dataToDrawSizes,
+                compositeLayers,
+                drawOrder);
+
+            /* Permute the draws according to the calculated order */
+            const Containers::ArrayView<UnsignedByte> layerIds = storage.allocate<UnsignedByte>(NoInit, count);
+            const Containers::ArrayView<UnsignedInt> offsets = storage.allocate<UnsignedInt>(NoInit, count);
+            const Containers::ArrayView<UnsignedInt> sizes = storage.allocate<UnsignedInt>(NoInit, count);
+            const Containers::ArrayView<UnsignedInt> clipRectOffsets = storage.allocate<UnsignedInt>(NoInit, count);
+            const Containers::ArrayView<UnsignedInt> clipRectSizes = storage.allocate<UnsignedInt>(NoInit, count);
+            Utility::copy(state.dataToDrawLayerIds, layerIds);
+            Utility::copy(state.dataToDrawOffsets, offsets);
+            Utility::copy(state.dataToDrawSizes, sizes);
+            Utility::copy(state.dataToDrawClipRectOffsets, clipRectOffsets);
+            Utility::copy(state.dataToDrawClipRectSizes, clipRectSizes);
+            for(std::size_t i = 0; i != count; ++i) {
+                const UnsignedInt index = drawOrder[i];
+                state.dataToDrawLayerIds[i] = layerIds[index];
+                state.dataToDrawOffsets[i] = offsets[index];
+                state.dataToDrawSizes[i] = sizes[index];
+                state.dataToDrawClipRectOffsets[i] = clipRectOffsets[index];
+                state.dataToDrawClipRectSizes[i] = clipRectSizes[index];
+            }
         }
 
-        /* 13. Compact the draw calls by throwing away the empty ones. This
-           cannot be done in the above loop directly as it'd need to go first
-           by top-level node and then by layer in each. That it used to do in a
+        /* Compact the draw calls by throwing away the empty ones. This cannot
+           be done in the above loop directly as it'd need to go first by
+           top-level node and then by layer in each. That it used to do in a
            certain way before which was much slower. */
         state.drawCount = Implementation::compactDrawsInPlace(
             state.dataToDrawLayerIds,
@@ -3220,8 +4844,36 @@ AbstractUserInterface& AbstractUserInterface::update() {
             state.dataToDrawSizes,
             state.dataToDrawClipRectOffsets,
             state.dataToDrawClipRectSizes);
+
+        /* With draw merging enabled, merge the draws that are now next to each
+           other */
+        if(drawMerging && state.drawCount) {
+            state.drawCount = Implementation::mergeDrawsInPlace(
+                state.dataToDrawLayerIds.prefix(state.drawCount),
+                state.dataToDrawOffsets.prefix(state.drawCount),
+                state.dataToDrawSizes.prefix(state.drawCount),
+                state.dataToDrawClipRectOffsets.prefix(state.drawCount),
+                state.dataToDrawClipRectSizes.prefix(state.drawCount),
+                compositeLayers);
+        }
+
+        /* Remember layer instances and features for the remaining draws, so
+           drawSnapshot() can be called while the UI is being modified */
+        state.dataToDrawLayers = dataStateStorage.allocate<AbstractLayer*>(NoInit, state.drawCount);
+        state.dataToDrawLayerFeatures = dataStateStorage.allocate<LayerFeatures>(NoInit, state.drawCount);
+        for(std::size_t i = 0; i != state.drawCount; ++i) {
+            const Layer& layer = state.layers[state.dataToDrawLayerIds[i]];
+            state.dataToDrawLayers[i] = layer.used.instance.get();
+            state.dataToDrawLayerFeatures[i] = layer.used.features;
+        }
+
+        /* The next translation-only update can reuse the data order unless
+           something marks it otherwise again */
+        state.dataOrderNeedsUpdate = false;
     }
 
+    stageTracker.begin(UserInterfaceUpdateStage::Event);
+
     /* 14. Refresh the event handling state based on visible nodes. Because
        this may call visibilityLostEvent() on layer data, do it before calling
        layer update() so any changes from the events can be directly reflected
@@ -3269,7 +4921,7 @@ AbstractUserInterface& AbstractUserInterface::update() {
             const UnsignedInt nodeId = valid ? nodeHandleId(state.currentFocusedNode) : ~UnsignedInt{};
             if(!valid ||
                !state.visibleEventNodeMask[nodeId] ||
-               !(state.nodes[nodeId].used.flags >= NodeFlag::Focusable))
+               !(state.nodeFlags[nodeId] >= NodeFlag::Focusable))
             {
                 /* Again, call visibilityLostEvent() only if it wasn't called
                    for this node yet in any of the iterations above */
@@ -3291,6 +4943,51 @@ AbstractUserInterface& AbstractUserInterface::update() {
        doesn't get used. */
     visibleOrVisibilityLostEventNodeMask = {};
 
+    /* If the renderer supports partial redraws, find out which nodes changed
+       since the last time. If the node order changed, everything has to be
+       redrawn. The node state gets remembered even if everything is redrawn
+       already, to have something to compare to the next time. */
+    if(state.rendererPartialRedraw && (
+        states >= UserInterfaceState::NeedsNodeEnabledUpdate ||
+        states >= UserInterfaceState::NeedsNodeOpacityUpdate))
+    {
+        arrayResize(state.redrawNodes, DirectInit, state.nodes.size(), Implementation::RedrawNode{{}, {}, 0.0f, ~UnsignedInt{}, false, false});
+        if(!Implementation::redrawRectInto(
+            state.visibleNodeIds,
+            state.absoluteNodeOffsets,
+            state.nodeSizes,
+            state.absoluteNodeOpacities,
+            state.visibleNodeMask,
+            state.visibleEnabledNodeMask,
+            storage.allocateBits(ValueInit, state.nodes.size()),
+            state.redrawNodes,
+            state.redrawRect))
+            state.redrawAll = true;
+    }
+
+    /* Similarly, if the renderer supports draw caches, find out which cached
+       hierarchies changed since the last time */
+    if(state.rendererDrawCache && (
+        states >= UserInterfaceState::NeedsNodeEnabledUpdate ||
+        states >= UserInterfaceState::NeedsNodeOpacityUpdate))
+    {
+        arrayResize(state.cacheNodes, DirectInit, state.nodes.size(), Implementation::RedrawNode{{}, {}, 0.0f, ~UnsignedInt{}, false, false});
+        arrayResize(state.nodeCaches, ValueInit, state.nodes.size());
+        Implementation::invalidateChangedCachesInto(
+            state.cachedDraws,
+            state.visibleNodeIds,
+            state.visibleNodeChildrenCounts,
+            state.absoluteNodeOffsets,
+            state.nodeSizes,
+            state.absoluteNodeOpacities,
+            state.visibleNodeMask,
+            state.visibleEnabledNodeMask,
+            state.cacheNodes,
+            state.nodeCaches);
+    }
+
+    stageTracker.begin(UserInterfaceUpdateStage::LayerUpdate);
+
     /* 15. Decide what all to update on all layers */
     LayerStates allLayerStateToUpdate;
     LayerStates allCompositeLayerStateToUpdate;
@@ -3319,36 +5016,25 @@ AbstractUserInterface& AbstractUserInterface::update() {
            to update , supply just the subset it should care about */
         allLayerStateToUpdate |= LayerState::NeedsNodeOrderUpdate;
 
+    /* Layers that support it get just a translation update instead of a full
+       offset and size update if nothing else changed. If the data order got
+       reused, the draw order and the set of enabled nodes is guaranteed to be
+       the same as well, so the layer doesn't need NeedsNodeOrderUpdate (and
+       NeedsNodeEnabledUpdate implied by it) either. */
+    LayerStates allTranslationLayerStateToUpdate = allLayerStateToUpdate;
+    if(nodeTranslationOnly) {
+        allTranslationLayerStateToUpdate = (allLayerStateToUpdate & ~LayerState::NeedsNodeOffsetSizeUpdate)|LayerState::NeedsNodeTranslationUpdate;
+        if(!dataOrderReused)
+            allTranslationLayerStateToUpdate |= LayerState::NeedsNodeOrderUpdate;
+    }
+
     /* 16. For each layer (if there are actually any) submit an update of
        visible data across all visible top-level nodes. If no data update is
        needed, the data in layers is already up-to-date. */
     if(states >= UserInterfaceState::NeedsDataUpdate && state.firstLayer != LayerHandle::Null) {
-        /* Make the update calls follow layer order so the implementations can
-           rely on a consistent order of operations compared to going through
-           whatever was the order they were created in */
-        LayerHandle layer = state.firstLayer;
-        do {
-            const UnsignedInt layerId = layerHandleId(layer);
-            Layer& layerItem = state.layers[layerId];
-
-            /* Decide what all to update on this layer. If nothing is in the
-               global enum and nothing here either, skip it. Note that it
-               should never happen that we iterate through all layers here and
-               skip all because in that case the `states` wouldn't contain
-               NeedsDataUpdate and it wouldn't even get here. */
-            AbstractLayer* const instance = layerItem.used.instance.get();
-            LayerStates layerStateToUpdate = allLayerStateToUpdate;
-            if(instance) {
-                layerStateToUpdate |= instance->state();
-                if(layerItem.used.features >= LayerFeature::Composite)
-                    layerStateToUpdate |= allCompositeLayerStateToUpdate;
-            }
-
-            /* If the layer has an instance (as layers may have been created
-               but without instances set yet) and there's something to update,
-               call update() on it */
+        const auto updateLayer = [&state](const UnsignedInt layerId, const LayerStates layerStateToUpdate) {
             /** @todo include a bitmask of what data actually changed */
-            if(instance && layerStateToUpdate) instance->update(
+            state.layers[layerId].used.instance->update(
                 layerStateToUpdate,
                 state.dataToUpdateIds.slice(
                     state.dataToUpdateLayerOffsets[layerId].first(),
@@ -3380,11 +5066,138 @@ AbstractUserInterface& AbstractUserInterface::update() {
                 state.dataToUpdateCompositeRectSizes.slice(
                     state.dataToUpdateLayerOffsets[layerId].third(),
                     state.dataToUpdateLayerOffsets[layerId + 1].third()));
+        };
+
+        /* If statistics are enabled, accumulate the states each layer got
+           updated with and the amount of data it uploaded since the last
+           draw(). Called once the update including postUpdate() is done. */
+        if(statistics && state.frameLayerStates.size() < state.layers.size()) {
+            arrayResize(state.frameLayerStates, ValueInit, state.layers.size());
+            arrayResize(state.frameLayerUploadedSizes, ValueInit, state.layers.size());
+        }
+        const auto recordLayerUpdate = [&state, statistics](const UnsignedInt layerId, const LayerStates layerStateToUpdate) {
+            if(!statistics)
+                return;
+            state.frameLayerStates[layerId] |= layerStateToUpdate;
+            state.frameLayerUploadedSizes[layerId] += state.layers[layerId].used.instance->uploadedSize();
+        };
+
+        /* Layers that support concurrent updates, together with the state to
+           update, are collected here if an executor is set, and updated
+           after all other layers */
+        const Containers::ArrayView<Containers::Pair<UnsignedInt, LayerStates>> concurrentLayers = state.updateExecutor ?
+            storage.allocate<Containers::Pair<UnsignedInt, LayerStates>>(NoInit, state.layers.size()) : nullptr;
+        std::size_t concurrentLayerCount = 0;
+
+        /* Make the update calls follow layer order so the implementations can
+           rely on a consistent order of operations compared to going through
+           whatever was the order they were created in */
+        LayerHandle layer = state.firstLayer;
+        do {
+            const UnsignedInt layerId = layerHandleId(layer);
+            Layer& layerItem = state.layers[layerId];
+
+            /* Decide what all to update on this layer. If nothing is in the
+               global enum and nothing here either, skip it. Note that it
+               should never happen that we iterate through all layers here and
+               skip all because in that case the `states` wouldn't contain
+               NeedsDataUpdate and it wouldn't even get here. */
+            AbstractLayer* const instance = layerItem.used.instance.get();
+            LayerStates layerStateToUpdate = allLayerStateToUpdate;
+            if(instance) {
+                const LayerStates instanceState = instance->state();
+
+                /* With a partial redraw, redraw everything if data got
+                   attached or detached, as the detached data area isn't
+                   known, and areas of all visible data if the layer data
+                   changed, as it isn't known which exactly */
+                if(state.rendererPartialRedraw && !state.redrawAll) {
+                    if(instanceState >= LayerState::NeedsAttachmentUpdate)
+                        state.redrawAll = true;
+                    else if(instanceState & (LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate|LayerState::NeedsDataStyleUpdate))
+                        Implementation::redrawDataRectInto(
+                            state.dataToUpdateIds.slice(
+                                state.dataToUpdateLayerOffsets[layerId].first(),
+                                state.dataToUpdateLayerOffsets[layerId + 1].first()),
+                            instance->nodes(),
+                            state.absoluteNodeOffsets,
+                            state.nodeSizes,
+                            state.redrawRect);
+                }
+
+                /* With a draw cache, render all caches again if data got
+                   attached or detached, as it isn't known to which nodes, and
+                   caches containing draws of this layer if its data
+                   changed */
+                if(state.rendererDrawCache) {
+                    const bool attachmentChanged = instanceState >= LayerState::NeedsAttachmentUpdate;
+                    if(attachmentChanged || instanceState & (LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate|LayerState::NeedsDataStyleUpdate)) {
+                        for(const Implementation::CachedDraw& cachedDraw: state.cachedDraws) {
+                            for(UnsignedInt i = cachedDraw.drawOffset, iMax = i + cachedDraw.drawCount; i != iMax; ++i) {
+                                if(attachmentChanged || state.dataToDrawLayerIds[i] == layerId) {
+                                    state.nodeCaches[cachedDraw.nodeId].valid = false;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                if(layerItem.used.features >= LayerFeature::NodeTranslation && !(instanceState >= LayerState::NeedsNodeOffsetSizeUpdate))
+                    layerStateToUpdate = allTranslationLayerStateToUpdate;
+                layerStateToUpdate |= instanceState;
+                if(WithCompositeLayers && layerItem.used.features >= LayerFeature::Composite)
+                    layerStateToUpdate |= allCompositeLayerStateToUpdate;
+            }
+
+            /* If the layer has an instance (as layers may have been created
+               but without instances set yet) and there's something to update,
+               call update() on it. If it supports concurrent updates and
+               there's an executor, only remember it for later, otherwise
+               finish the update right away. */
+            if(instance && layerStateToUpdate) {
+                if(!(layerItem.used.features >= LayerFeature::ConcurrentUpdate)) {
+                    updateLayer(layerId, layerStateToUpdate);
+                    recordLayerUpdate(layerId, layerStateToUpdate);
+                } else if(state.updateExecutor) {
+                    concurrentLayers[concurrentLayerCount++] = {layerId, layerStateToUpdate};
+                } else {
+                    updateLayer(layerId, layerStateToUpdate);
+                    instance->postUpdate(layerStateToUpdate);
+                    recordLayerUpdate(layerId, layerStateToUpdate);
+                }
+            }
 
             layer = layerItem.used.next;
         } while(layer != state.firstLayer);
+
+        /* Update the layers that support it concurrently. If there's just
+           one, there's no point in going through the executor. */
+        if(concurrentLayerCount == 1) {
+            updateLayer(concurrentLayers[0].first(), concurrentLayers[0].second());
+        } else if(concurrentLayerCount) {
+            struct ConcurrentUpdate {
+                const decltype(updateLayer)& updateLayer;
+                Containers::ArrayView<const Containers::Pair<UnsignedInt, LayerStates>> layers;
+            } concurrentUpdate{updateLayer, concurrentLayers.prefix(concurrentLayerCount)};
+            state.updateExecutor(concurrentLayerCount, [](void* data, const std::size_t i) {
+                const ConcurrentUpdate& concurrentUpdate = *static_cast<const ConcurrentUpdate*>(data);
+                concurrentUpdate.updateLayer(concurrentUpdate.layers[i].first(), concurrentUpdate.layers[i].second());
+            }, &concurrentUpdate);
+        }
+
+        /* Then finish the concurrent updates serially, again in the layer
+           order */
+        for(const Containers::Pair<UnsignedInt, LayerStates>& i: concurrentLayers.prefix(concurrentLayerCount)) {
+            state.layers[i.first()].used.instance->postUpdate(i.second());
+            recordLayerUpdate(i.first(), i.second());
+        }
     }
 
+    stageTracker.end();
+    if(statistics)
+        updateStatisticsCounts();
+
     /** @todo layer-specific cull/clip step? */
 
     /* Unmark the UI as needing an update() call. No other states should be
@@ -3395,29 +5208,204 @@ AbstractUserInterface& AbstractUserInterface::update() {
        in state.state. */
     state.state &= ~UserInterfaceState::NeedsNodeUpdate;
     CORRADE_INTERNAL_ASSERT(!state.state);
+
+    if(!state.persistentUpdateStorage)
+        storage.release();
     return *this;
 }
 
 AbstractUserInterface& AbstractUserInterface::draw() {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::draw()");
     State& state = *_state;
     CORRADE_ASSERT(state.renderer,
         "Ui::AbstractUserInterface::draw(): no renderer instance set", *this);
 
+    /* Deliver a coalesced pointer move event, if any, so it affects what gets
+       drawn in this frame */
+    flushPointerMoveEvent();
+
     /* Call update implicitly in order to make the internal state ready for
        drawing. Is a no-op if there's nothing to update or clean. */
     update();
 
+    /* Publish the per-frame statistics accumulated since the last draw() and
+       start accumulating again */
+    if(state.updateStatisticsEnabled) {
+        UserInterfaceUpdateStatistics& statistics = state.updateStatistics;
+        arrayResize(state.updateStatisticsLayerStates, NoInit, state.frameLayerStates.size());
+        arrayResize(state.updateStatisticsLayerUploadedSizes, NoInit, state.frameLayerUploadedSizes.size());
+        Utility::copy(state.frameLayerStates, state.updateStatisticsLayerStates);
+        Utility::copy(state.frameLayerUploadedSizes, state.updateStatisticsLayerUploadedSizes);
+        for(LayerStates& i: state.frameLayerStates)
+            i = {};
+        for(std::size_t& i: state.frameLayerUploadedSizes)
+            i = 0;
+        statistics.layerStates = state.updateStatisticsLayerStates;
+        statistics.layerUploadedSizes = state.updateStatisticsLayerUploadedSizes;
+        statistics.eventCount = state.frameEventCount;
+        statistics.hitTestNodeCount = state.frameHitTestNodeCount;
+        statistics.animatorAdvanceCount = state.frameAnimatorAdvanceCount;
+        state.frameEventCount = 0;
+        state.frameHitTestNodeCount = 0;
+        state.frameAnimatorAdvanceCount = 0;
+    }
+
+    drawInternal();
+    return *this;
+}
+
+AbstractUserInterface& AbstractUserInterface::drawSnapshot() {
+    CORRADE_ASSERT(_state->renderer,
+        "Ui::AbstractUserInterface::drawSnapshot(): no renderer instance set", *this);
+
+    drawInternal();
+    return *this;
+}
+
+void AbstractUserInterface::drawInternal() {
+    /* Compared to update(), this accesses only the renderer and what update()
+       put into `dataStateStorage` and `nodeStateStorage`. Node, layer, layout
+       and animator state isn't touched, which is what makes it possible to
+       call drawSnapshot() while the UI gets modified by another thread. The
+       only state written here is the partial redraw area, the draw cache
+       state and the flag queried by needsDraw(), which are otherwise written
+       only by update(). */
+    State& state = *_state;
+
     /* Transition the renderer to the initial state if it was in Final. If it's
        already there, this is a no-op. */
     AbstractRenderer& renderer = *state.renderer;
     renderer.transition(RendererTargetState::Initial, {});
 
+    /* Whatever update() prepared is getting drawn now */
+    state.drawNeeded = false;
+
+    /* Scales a UI rect to the framebuffer, rounding outwards, and clamps it */
+    const auto framebufferRect = [&state](const Range2D& rect) {
+        const Vector2 scale = Vector2{state.framebufferSize}/state.size;
+        const Vector2i min = Math::clamp(Vector2i{Math::floor(rect.min()*scale)}, Vector2i{}, state.framebufferSize);
+        const Vector2i max = Math::clamp(Vector2i{Math::ceil(rect.max()*scale)}, min, state.framebufferSize);
+        return Range2Di{min, max};
+    };
+
+    /* If the renderer supports draw caches, discard caches of nodes that are
+       no longer drawn from them. Done before drawing anything so the renderer
+       can reuse the memory for caches rendered below. */
+    if(state.rendererDrawCache) {
+        for(std::size_t i = 0; i != state.nodeCaches.size(); ++i) {
+            Implementation::NodeCache& cache = state.nodeCaches[i];
+            if(cache.present && !cache.drawn) {
+                renderer.discardCache(i);
+                cache.present = false;
+            }
+        }
+    }
+
+    /* If the renderer supports partial redraws, restrict it to what changed
+       since the last draw, and skip drawing altogether if nothing did.
+       Layers that set the scissor on their own or composite need everything
+       to be redrawn. This consumes what update() accumulated, so calling
+       draw() again without any further changes draws nothing. */
+    if(state.rendererPartialRedraw) {
+        bool redrawAll = state.redrawAll;
+        for(std::size_t i = 0; !redrawAll && i != state.drawCount; ++i) {
+            const LayerFeatures features = state.dataToDrawLayerFeatures[i];
+            if(features >= LayerFeature::DrawUsesScissor ||
+               (WithCompositeLayers && features >= LayerFeature::Composite))
+                redrawAll = true;
+        }
+        /* Caches get rendered in full, which isn't restricted by the redraw
+           area, so redraw everything if any of them needs to be rendered */
+        if(state.rendererDrawCache) for(std::size_t i = 0; !redrawAll && i != state.cachedDraws.size(); ++i) {
+            if(!state.nodeCaches[state.cachedDraws[i].nodeId].valid)
+                redrawAll = true;
+        }
+
+        const Range2Di redrawRect = redrawAll ?
+            Range2Di{{}, state.framebufferSize} :
+            framebufferRect(state.redrawRect);
+
+        state.redrawAll = false;
+        state.redrawRect = {};
+        renderer.setRedrawRect(redrawRect);
+        if(!redrawRect.size().product()) {
+            renderer.transition(RendererTargetState::Final, {});
+            return;
+        }
+    }
+
+    /* If the renderer can profile layers, each composite and draw call gets
+       wrapped in a profiling scope */
+    const bool layerProfiling = renderer.features() >= RendererFeature::LayerProfiling;
+
+    /* If the renderer has a depth buffer, each draw gets a distinct depth,
+       with later draws being closer. The depth is never 1.0 so the draws pass
+       the test against a cleared depth buffer. */
+    const bool depthBuffer = renderer.features() >= RendererFeature::DepthBuffer;
+    const auto drawDepth = [&state](std::size_t i) {
+        return 1.0f - Float(i + 1)/Float(state.drawCount + 1);
+    };
+
+    /* Draws or draws depth of opaque parts of given draw. The views should be
+       exactly the same as passed to update() before, with the offsets then
+       being relative to those. */
+    const auto draw = [&](std::size_t i, bool opaque) {
+        const UnsignedInt layerId = state.dataToDrawLayerIds[i];
+        AbstractLayer& instance = *state.dataToDrawLayers[i];
+        const decltype(&AbstractLayer::draw) function = opaque ? &AbstractLayer::drawOpaque : &AbstractLayer::draw;
+
+        if(depthBuffer)
+            renderer.setDrawDepth(drawDepth(i));
+        if(layerProfiling)
+            renderer.beginLayerProfile(instance.handle());
+        (instance.*function)(
+            state.dataToUpdateIds.slice(
+                state.dataToUpdateLayerOffsets[layerId].first(),
+                state.dataToUpdateLayerOffsets[layerId + 1].first()),
+            state.dataToDrawOffsets[i] - state.dataToUpdateLayerOffsets[layerId].first(),
+            state.dataToDrawSizes[i],
+            /* Same for clip rects */
+            state.dataToUpdateClipRectIds.slice(
+                state.dataToUpdateLayerOffsets[layerId].second(),
+                state.dataToUpdateLayerOffsets[layerId + 1].second()),
+            state.dataToUpdateClipRectDataCounts.slice(
+                state.dataToUpdateLayerOffsets[layerId].second(),
+                state.dataToUpdateLayerOffsets[layerId + 1].second()),
+            state.dataToDrawClipRectOffsets[i] - state.dataToUpdateLayerOffsets[layerId].second(),
+            state.dataToDrawClipRectSizes[i],
+            state.absoluteNodeOffsets,
+            state.nodeSizes,
+            state.absoluteNodeOpacities,
+            state.visibleEnabledNodeMask,
+            state.clipRectOffsets.prefix(state.clipRectCount),
+            state.clipRectSizes.prefix(state.clipRectCount));
+        if(layerProfiling)
+            renderer.endLayerProfile();
+    };
+
+    /* Transitions between draw states and draws. If the states are the same
+       as before, the transition is a no-op in the renderer. */
+    const auto transitionAndDraw = [&](std::size_t i) {
+        const LayerFeatures features = state.dataToDrawLayerFeatures[i];
+        RendererDrawStates rendererDrawStates;
+        if(features >= LayerFeature::DrawUsesBlending)
+            rendererDrawStates |= RendererDrawState::Blending;
+        if(features >= LayerFeature::DrawUsesScissor)
+            rendererDrawStates |= RendererDrawState::Scissor;
+        if(depthBuffer)
+            rendererDrawStates |= RendererDrawState::DepthTest;
+        renderer.transition(RendererTargetState::Draw, rendererDrawStates);
+
+        draw(i, false);
+    };
+
     /* Then submit draws in the correct back-to-front order, i.e. for every
        top-level node and then for every layer used by its children */
+    std::size_t cachedDrawIndex = 0;
     for(std::size_t i = 0; i != state.drawCount; ++i) {
         const UnsignedInt layerId = state.dataToDrawLayerIds[i];
-        const LayerFeatures features = state.layers[layerId].used.features;
-        AbstractLayer& instance = *state.layers[layerId].used.instance;
+        const LayerFeatures features = state.dataToDrawLayerFeatures[i];
+        AbstractLayer& instance = *state.dataToDrawLayers[i];
 
         /* Transition to composite and composite, if the layer advertises it */
         /** @todo have Composite independent of the Draw? for example a color /
@@ -3425,9 +5413,11 @@ AbstractUserInterface& AbstractUserInterface::draw() {
             event handling implemented, but not drawing ... would require the
             draw call collection to be changed to consider Composite alone as
             well or something */
-        if(features >= LayerFeature::Composite) {
+        if(WithCompositeLayers && features >= LayerFeature::Composite) {
             renderer.transition(RendererTargetState::Composite, {});
 
+            if(layerProfiling)
+                renderer.beginLayerProfile(instance.handle());
             instance.composite(renderer,
                 /* The views should be exactly the same as passed to update()
                    before ... */
@@ -3440,48 +5430,69 @@ AbstractUserInterface& AbstractUserInterface::draw() {
                 /* ... and the offset then being relative to those */
                 state.dataToDrawOffsets[i] - state.dataToUpdateLayerOffsets[layerId].first(),
                 state.dataToDrawSizes[i]);
+            if(layerProfiling)
+                renderer.endLayerProfile();
         }
 
-        /* Transition between draw states. If they're the same, it's a no-op in
-           the renderer. */
-        RendererDrawStates rendererDrawStates;
-        if(features >= LayerFeature::DrawUsesBlending)
-            rendererDrawStates |= RendererDrawState::Blending;
-        if(features >= LayerFeature::DrawUsesScissor)
-            rendererDrawStates |= RendererDrawState::Scissor;
-        renderer.transition(RendererTargetState::Draw, rendererDrawStates);
+        /* With a depth buffer, at the start and after each compositing
+           operation, draw depth of opaque parts of all draws until the next
+           compositing one, front-to-back. Stopping at the next compositing
+           draw ensures the compositing operation sees all content before it,
+           not having parts occluded by what's drawn only after. */
+        if(depthBuffer && (i == 0 || (WithCompositeLayers && features >= LayerFeature::Composite))) {
+            std::size_t end = i + 1;
+            while(end != state.drawCount && !(WithCompositeLayers && state.dataToDrawLayerFeatures[end] >= LayerFeature::Composite))
+                ++end;
+            for(std::size_t j = end; j != i; --j) {
+                if(!(state.dataToDrawLayerFeatures[j - 1] & LayerFeature::DrawOpaque))
+                    continue;
 
-        instance.draw(
-            /* The views should be exactly the same as passed to update()
-               before ... */
-            state.dataToUpdateIds.slice(
-                state.dataToUpdateLayerOffsets[layerId].first(),
-                state.dataToUpdateLayerOffsets[layerId + 1].first()),
-            /* ... and the draw offset then being relative to those */
-            state.dataToDrawOffsets[i] - state.dataToUpdateLayerOffsets[layerId].first(),
-            state.dataToDrawSizes[i],
-            /* Same for clip rects ... */
-            state.dataToUpdateClipRectIds.slice(
-                state.dataToUpdateLayerOffsets[layerId].second(),
-                state.dataToUpdateLayerOffsets[layerId + 1].second()),
-            state.dataToUpdateClipRectDataCounts.slice(
-                state.dataToUpdateLayerOffsets[layerId].second(),
-                state.dataToUpdateLayerOffsets[layerId + 1].second()),
-            /* ... and the clip rect offset then being relative to those */
-            state.dataToDrawClipRectOffsets[i] - state.dataToUpdateLayerOffsets[layerId].second(),
-            state.dataToDrawClipRectSizes[i],
-            state.absoluteNodeOffsets,
-            state.nodeSizes,
-            state.absoluteNodeOpacities,
-            state.visibleEnabledNodeMask,
-            state.clipRectOffsets.prefix(state.clipRectCount),
-            state.clipRectSizes.prefix(state.clipRectCount));
+                /* No blending or scissor, the layers are expected to clip the
+                   opaque areas on their own */
+                renderer.transition(RendererTargetState::Draw, RendererDrawState::DepthTest|RendererDrawState::DepthPrepass);
+                draw(j - 1, true);
+            }
+        }
+
+        /* If this is the first draw of a hierarchy drawn from a cache, render
+           the cache again if its contents aren't up to date, and then draw
+           the cache instead of all draws of the hierarchy. The cached
+           hierarchies have no compositing draws, so the depth pre-pass above
+           is the only thing that may need to happen before. */
+        if(state.rendererDrawCache && cachedDrawIndex != state.cachedDraws.size() && state.cachedDraws[cachedDrawIndex].drawOffset == i) {
+            const Implementation::CachedDraw& cachedDraw = state.cachedDraws[cachedDrawIndex++];
+            Implementation::NodeCache& cache = state.nodeCaches[cachedDraw.nodeId];
+            if(!cache.valid) {
+                renderer.transition(RendererTargetState::Draw, {});
+                renderer.beginCache(cachedDraw.nodeId, framebufferRect(cachedDraw.rect));
+                for(std::size_t j = i, jMax = i + cachedDraw.drawCount; j != jMax; ++j)
+                    transitionAndDraw(j);
+                renderer.endCache();
+                cache.present = true;
+                cache.valid = true;
+            }
+
+            /* The cache contents are premultiplied, so they're always blended
+               over what's below. With a depth buffer it's tested against the
+               depth of the last draw in the hierarchy. */
+            RendererDrawStates rendererDrawStates = RendererDrawState::Blending;
+            if(depthBuffer)
+                rendererDrawStates |= RendererDrawState::DepthTest;
+            renderer.transition(RendererTargetState::Draw, rendererDrawStates);
+            if(depthBuffer)
+                renderer.setDrawDepth(drawDepth(i + cachedDraw.drawCount - 1));
+            renderer.drawCache(cachedDraw.nodeId);
+
+            i += cachedDraw.drawCount - 1;
+            continue;
+        }
+
+        transitionAndDraw(i);
     }
 
     /* Transition the renderer to the final state. If no layers were drawn,
        it goes just from Initial to Final. */
     renderer.transition(RendererTargetState::Final, {});
-    return *this;
 }
 
 /* Used only in update() but put here to have the loops and other event-related
@@ -3518,8 +5529,11 @@ template<void(AbstractLayer::*function)(UnsignedInt, FocusEvent&)> bool Abstract
     bool acceptedByAnyData = false;
     for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1]; j != jMax; ++j) {
         const DataHandle data = state.visibleNodeEventData[j];
+        const Layer& layer = state.layers[dataHandleLayerId(data)];
+        if(!(layer.used.events & LayerEvent::Focus))
+            continue;
         event._accepted = false;
-        ((*state.layers[dataHandleLayerId(data)].used.instance).*function)(dataHandleId(data), event);
+        ((*layer.used.instance).*function)(dataHandleId(data), event);
 
         if(event._accepted)
             acceptedByAnyData = true;
@@ -3530,7 +5544,7 @@ template<void(AbstractLayer::*function)(UnsignedInt, FocusEvent&)> bool Abstract
 
 /* Used only in keyPressOrReleaseEvent() but put here to have the loops and
    other event-related handling of all call*Event*() APIs together */
-template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> bool AbstractUserInterface::callKeyEventOnNode(const NodeHandle node, KeyEvent& event) {
+template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, KeyEvent&)> bool AbstractUserInterface::callKeyEventOnNode(const NodeHandle node, KeyEvent& event) {
     /* Set isNodePressed() / isNodeHovered() / isNodeFocused() if the event is
        called on node that is pressed / hovered / focused. Unlike
        callEventOnNode() below, this is set unconditionally for all three as
@@ -3542,10 +5556,19 @@ template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> bool AbstractUs
 
     const UnsignedInt nodeId = nodeHandleId(node);
     bool acceptedByAnyData = false;
-    for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1]; j != jMax; ++j) {
-        const DataHandle data = state.visibleNodeEventData[j];
+    for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1], jNext; j != jMax; j = jNext) {
+        const UnsignedInt layerId = dataHandleLayerId(state.visibleNodeEventData[j]);
+        const Layer& layer = state.layers[layerId];
+        jNext = j + 1;
+        if(!(layer.used.events & LayerEvent::Key))
+            continue;
         event._accepted = false;
-        ((*state.layers[dataHandleLayerId(data)].used.instance).*function)(dataHandleId(data), event);
+        /* Same batching as in callEventOnNode() below */
+        if(layer.used.features >= LayerFeature::EventBatch) {
+            while(jNext != jMax && dataHandleLayerId(state.visibleNodeEventData[jNext]) == layerId)
+                ++jNext;
+            ((*layer.used.instance).*batchFunction)(state.visibleNodeEventDataIds.slice(j, jNext), event);
+        } else ((*layer.used.instance).*function)(dataHandleId(state.visibleNodeEventData[j]), event);
         if(event._accepted)
             acceptedByAnyData = true;
 
@@ -3567,8 +5590,11 @@ bool AbstractUserInterface::callTextInputEventOnNode(const NodeHandle node, Text
     bool acceptedByAnyData = false;
     for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1]; j != jMax; ++j) {
         const DataHandle data = state.visibleNodeEventData[j];
+        const Layer& layer = state.layers[dataHandleLayerId(data)];
+        if(!(layer.used.events & LayerEvent::TextInput))
+            continue;
         event._accepted = false;
-        state.layers[dataHandleLayerId(data)].used.instance->textInputEvent(dataHandleId(data), event);
+        layer.used.instance->textInputEvent(dataHandleId(data), event);
 
         if(event._accepted)
             acceptedByAnyData = true;
@@ -3577,11 +5603,32 @@ bool AbstractUserInterface::callTextInputEventOnNode(const NodeHandle node, Text
     return acceptedByAnyData;
 }
 
+namespace {
+
+/* Events handled by callEventOnNode() and callEvent(). Pointer move, enter
+   and leave events use the dedicated move event data list, which contains
+   only data from layers that handle them, others filter the full list. */
+template<class> struct EventTraits;
+template<> struct EventTraits<PointerEvent> {
+    static constexpr LayerEvent event() { return LayerEvent::Pointer; }
+};
+template<> struct EventTraits<PointerMoveEvent> {
+    static constexpr LayerEvent event() { return LayerEvent::PointerMove; }
+};
+template<> struct EventTraits<ScrollEvent> {
+    static constexpr LayerEvent event() { return LayerEvent::Scroll; }
+};
+template<> struct EventTraits<KeyEvent> {
+    static constexpr LayerEvent event() { return LayerEvent::Key; }
+};
+
+}
+
 /* If this is called for fallthrough events, `targetNode` is the node on which
    the original event was accepted (to mark the pressed / hovered / captured
    bits appropriately), and `node` is the fallthrough node. In all other cases
    they're the same. */
-template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> bool AbstractUserInterface::callEventOnNode(const Vector2& globalPositionScaled, const NodeHandle node, const NodeHandle targetNode, Event& event, const bool rememberCaptureOnUnaccepted) {
+template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, Event&)> bool AbstractUserInterface::callEventOnNode(const Vector2& globalPositionScaled, const NodeHandle node, const NodeHandle targetNode, Event& event, const bool rememberCaptureOnUnaccepted) {
     State& state = *_state;
 
     /* Set isNodeHovered() to false if the event is called on node that
@@ -3606,10 +5653,20 @@ template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> bool
        the fallthrough event was called on. */
     event._nodeFocused = node == state.currentFocusedNode;
 
+    constexpr bool isMoveEvent = EventTraits<Event>::event() == LayerEvent::PointerMove;
+    const Containers::ArrayView<const UnsignedInt> eventDataOffsets = isMoveEvent ? state.visibleNodeMoveEventDataOffsets : state.visibleNodeEventDataOffsets;
+    const Containers::ArrayView<const DataHandle> eventData = isMoveEvent ? state.visibleNodeMoveEventData : state.visibleNodeEventData;
+    const Containers::ArrayView<const UnsignedInt> eventDataIds = isMoveEvent ? state.visibleNodeMoveEventDataIds : state.visibleNodeEventDataIds;
+
     const UnsignedInt nodeId = nodeHandleId(node);
     bool acceptedByAnyData = false;
-    for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1]; j != jMax; ++j) {
-        const DataHandle data = state.visibleNodeEventData[j];
+    for(UnsignedInt j = eventDataOffsets[nodeId], jMax = eventDataOffsets[nodeId + 1], jNext; j != jMax; j = jNext) {
+        const UnsignedInt layerId = dataHandleLayerId(eventData[j]);
+        const Layer& layer = state.layers[layerId];
+        jNext = j + 1;
+        /* Move events are already filtered */
+        if(!isMoveEvent && !(layer.used.events & EventTraits<Event>::event()))
+            continue;
         /* Remember the previous event capture state to reset it after each
            non-accepted event handler call. Has to be done here in the inner
            loop and not outside so the capture state changes aren't lost when
@@ -3618,7 +5675,15 @@ template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> bool
         event._position = globalPositionScaled - state.absoluteNodeOffsets[nodeId];
         event._nodeSize = state.nodeSizes[nodeId];
         event._accepted = false;
-        ((*state.layers[dataHandleLayerId(data)].used.instance).*function)(dataHandleId(data), event);
+        /* If the layer handles events in batches, pass it all its data
+           attached to this node at once. Data of the same layer are always
+           next to each other in the list. The accept and capture state is
+           then treated as if it was a single data. */
+        if(layer.used.features >= LayerFeature::EventBatch) {
+            while(jNext != jMax && dataHandleLayerId(eventData[jNext]) == layerId)
+                ++jNext;
+            ((*layer.used.instance).*batchFunction)(eventDataIds.slice(j, jNext), event);
+        } else ((*layer.used.instance).*function)(dataHandleId(eventData[j]), event);
         if(event._accepted)
             acceptedByAnyData = true;
 
@@ -3643,7 +5708,7 @@ template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> bool
     return acceptedByAnyData;
 }
 
-template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> NodeHandle AbstractUserInterface::callEvent(const Vector2& globalPositionScaled, const UnsignedInt visibleNodeIndex, Event& event) {
+template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, Event&)> NodeHandle AbstractUserInterface::callEvent(const Vector2& globalPositionScaled, const UnsignedInt visibleNodeIndex, Event& event) {
     /* The accept state should be initially false as we exit once it becomes
        true. */
     CORRADE_INTERNAL_ASSERT(!event._accepted);
@@ -3658,6 +5723,17 @@ template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> NodeH
     if(!state.visibleEventNodeMask[nodeId])
         return {};
 
+    if(state.updateStatisticsEnabled)
+        ++state.frameHitTestNodeCount;
+
+    /* If there's no event data in the whole subtree, there's nothing to call
+       the event on, so skip the hit testing altogether. This is especially
+       significant for move events on large node hierarchies. */
+    const UnsignedInt childrenCount = state.visibleNodeChildrenCounts[visibleNodeIndex];
+    const Containers::ArrayView<const UnsignedInt> subtreeEventDataOffsets = EventTraits<Event>::event() == LayerEvent::PointerMove ? state.visibleSubtreeMoveEventDataOffsets : state.visibleSubtreeEventDataOffsets;
+    if(subtreeEventDataOffsets[visibleNodeIndex + childrenCount + 1] == subtreeEventDataOffsets[visibleNodeIndex])
+        return {};
+
     /* If the position is outside the node, we got nothing */
     const Vector2 nodeOffset = state.absoluteNodeOffsets[nodeId];
     if((globalPositionScaled < nodeOffset).any() ||
@@ -3665,31 +5741,60 @@ template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> NodeH
         return {};
 
     /* If the position is inside, recurse into *direct* children. If the event
-       is handled there, we're done. */
-    /** @todo maintain some info about how many actual event handlers is in
-        particular subtrees, to not have to do complex hit testing when there's
-        nothing to call anyway? especially for move events and such */
-    for(UnsignedInt i = 1, iMax = state.visibleNodeChildrenCounts[visibleNodeIndex] + 1; i != iMax; i += state.visibleNodeChildrenCounts[visibleNodeIndex + i] + 1) {
-        const NodeHandle called = callEvent<Event, function>(globalPositionScaled, visibleNodeIndex + i, event);
+       is handled there, we're done. If the node has a hit testing grid, go
+       only through children overlapping the cell the position is in, which
+       are in the same order as in the full list. */
+    const UnsignedInt gridId = state.visibleNodeHitTestGrids[visibleNodeIndex];
+    if(gridId != ~UnsignedInt{}) {
+        const Implementation::HitTestGrid& grid = state.hitTestGrids[gridId];
+        const UnsignedInt cell = grid.cellOffset + Implementation::hitTestGridCellIndex(grid, globalPositionScaled);
+        for(UnsignedInt j = state.hitTestGridCellOffsets[cell], jMax = state.hitTestGridCellOffsets[cell + 1]; j != jMax; ++j) {
+            const NodeHandle called = callEvent<Event, function, batchFunction>(globalPositionScaled, visibleNodeIndex + state.hitTestGridCellChildren[j], event);
+            if(called != NodeHandle::Null)
+                return called;
+        }
+    } else for(UnsignedInt i = 1, iMax = childrenCount + 1; i != iMax; i += state.visibleNodeChildrenCounts[visibleNodeIndex + i] + 1) {
+        const NodeHandle called = callEvent<Event, function, batchFunction>(globalPositionScaled, visibleNodeIndex + i, event);
         if(called != NodeHandle::Null)
             return called;
     }
 
     /* Only if children didn't handle the event, look into this node data */
     const NodeHandle node = nodeHandle(nodeId, state.nodes[nodeId].used.generation);
-    if(callEventOnNode<Event, function>(globalPositionScaled, node, event))
+    if(callEventOnNode<Event, function, batchFunction>(globalPositionScaled, node, event))
         return node;
 
     return {};
 }
 
-template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> NodeHandle AbstractUserInterface::callEvent(const Vector2& globalPositionScaled, Event& event) {
+template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, Event&)> NodeHandle AbstractUserInterface::callEvent(const Vector2& globalPositionScaled, Event& event) {
     /* Call update implicitly in order to make the internal state ready for
        event processing. Is a no-op if there's nothing to update or clean. */
     update();
 
-    for(const UnsignedInt visibleTopLevelNodeIndex: _state->visibleFrontToBackTopLevelNodeIndices) {
-        const NodeHandle called = callEvent<Event, function>(globalPositionScaled, visibleTopLevelNodeIndex, event);
+    /* Build the hit testing grids if not done since the last data attachment
+       update */
+    State& state = *_state;
+    if(state.hitTestGridsNeedUpdate) {
+        arrayResize(state.visibleNodeHitTestGrids, NoInit, state.visibleNodeIds.size());
+        Implementation::buildHitTestGridsInto(
+            HitTestGridMinChildCount,
+            HitTestGridMaxEntriesPerChild,
+            state.visibleNodeIds,
+            state.visibleNodeChildrenCounts,
+            state.visibleEventNodeMask,
+            state.visibleSubtreeEventDataOffsets,
+            state.absoluteNodeOffsets,
+            state.nodeSizes,
+            state.visibleNodeHitTestGrids,
+            state.hitTestGrids,
+            state.hitTestGridCellOffsets,
+            state.hitTestGridCellChildren);
+        state.hitTestGridsNeedUpdate = false;
+    }
+
+    for(const UnsignedInt visibleTopLevelNodeIndex: state.visibleFrontToBackTopLevelNodeIndices) {
+        const NodeHandle called = callEvent<Event, function, batchFunction>(globalPositionScaled, visibleTopLevelNodeIndex, event);
         if(called != NodeHandle::Null)
             return called;
     }
@@ -3697,23 +5802,52 @@ template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> NodeH
     return {};
 }
 
-template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> MAGNUM_UI_LOCAL void AbstractUserInterface::callFallthroughPointerEvents(/*mutable*/ NodeHandle targetNode, const Vector2& globalPositionScaled, Event& event, const bool allowCapture) {
+template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, Event&)> MAGNUM_UI_LOCAL void AbstractUserInterface::callFallthroughPointerEvents(/*mutable*/ NodeHandle targetNode, const Vector2& globalPositionScaled, Event& event, const bool allowCapture) {
     State& state = *_state;
 
     /* Mark the event as a fallthrough one from now on. The assumption is that
        it won't get used for a non-fallthrough event anymore. */
     event._fallthrough = true;
 
+    /* If none of the parents want fallthrough events or none of those that
+       want them have any data that could react to them, there's nothing to
+       do. Pointer move events are checked against the dedicated move event
+       data list, as commonly the fallthrough parents are only interested in
+       press and release. The result is remembered for the node, so repeated
+       events on it don't walk the parents again. */
+    if(state.fallthroughCheckedNode != targetNode) {
+        state.fallthroughCheckedNode = targetNode;
+        state.fallthroughCheckedNodeHasParents = false;
+        state.fallthroughCheckedNodeHasMoveParents = false;
+        for(NodeHandle parent = state.nodeParents[nodeHandleId(targetNode)]; parent != NodeHandle::Null; parent = state.nodeParents[nodeHandleId(parent)]) {
+            const UnsignedInt parentId = nodeHandleId(parent);
+            if(!(state.nodeFlags[parentId] >= NodeFlag::FallthroughPointerEvents))
+                continue;
+            if(state.visibleNodeEventDataOffsets[parentId] != state.visibleNodeEventDataOffsets[parentId + 1])
+                state.fallthroughCheckedNodeHasParents = true;
+            if(state.visibleNodeMoveEventDataOffsets[parentId] != state.visibleNodeMoveEventDataOffsets[parentId + 1])
+                state.fallthroughCheckedNodeHasMoveParents = true;
+            /* The move event data are a subset of all event data, so if
+               there are move event data there are also the others */
+            if(state.fallthroughCheckedNodeHasMoveParents)
+                break;
+        }
+    }
+    if(!(EventTraits<Event>::event() == LayerEvent::PointerMove ?
+        state.fallthroughCheckedNodeHasMoveParents :
+        state.fallthroughCheckedNodeHasParents))
+        return;
+
     /* Go through parent nodes and call fallthrough events on all nodes that
        want them */
-    NodeHandle parent = state.nodes[nodeHandleId(targetNode)].used.parent;
+    NodeHandle parent = state.nodeParents[nodeHandleId(targetNode)];
     while(parent != NodeHandle::Null) {
         /* If the event is primary and is accepted, make the fallthrough node
            take over the current pressed / hovered / ... nodes. Secondary
            events don't affect that, so for them nothing is done if they're
            accepted. */
         const UnsignedInt parentId = nodeHandleId(parent);
-        if(state.nodes[parentId].used.flags >= NodeFlag::FallthroughPointerEvents && callEventOnNode<Event, function>(globalPositionScaled, parent, targetNode, event)) {
+        if(state.nodeFlags[parentId] >= NodeFlag::FallthroughPointerEvents && callEventOnNode<Event, function, batchFunction>(globalPositionScaled, parent, targetNode, event)) {
             /* Call a pointer cancel event on previous pressed / hovered /
                focused nodes if the event is primary. Call a pointer cancel on
                the previously captured node always, even for secondary events
@@ -3784,13 +5918,19 @@ template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> MAGNU
                 state.currentCapturedNode = NodeHandle::Null;
         }
 
-        parent = state.nodes[parentId].used.parent;
+        parent = state.nodeParents[parentId];
     }
 }
 
 bool AbstractUserInterface::pointerPressEvent(const Vector2& globalPosition, PointerEvent& event) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::pointerPressEvent()");
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::pointerPressEvent(): event already accepted", {});
+    if(_state->updateStatisticsEnabled)
+        ++_state->frameEventCount;
+
+    /* Deliver a queued move event first to preserve the event order */
+    flushPointerMoveEvent();
 
     State& state = *_state;
 
@@ -3816,7 +5956,7 @@ bool AbstractUserInterface::pointerPressEvent(const Vector2& globalPosition, Poi
         event._captured = true;
         event._nodeHovered = insideCapturedNode;
 
-        pressAcceptedByAnyData = callEventOnNode<PointerEvent, &AbstractLayer::pointerPressEvent>(globalPositionScaled, state.currentCapturedNode, event);
+        pressAcceptedByAnyData = callEventOnNode<PointerEvent, &AbstractLayer::pointerPressEvent, &AbstractLayer::pointerPressEvents>(globalPositionScaled, state.currentCapturedNode, event);
         calledNode = state.currentCapturedNode;
 
     /* Otherwise, if this is either a primary event (which changes the capture)
@@ -3829,7 +5969,7 @@ bool AbstractUserInterface::pointerPressEvent(const Vector2& globalPosition, Poi
            currently hovered node. */
         event._nodeHovered = true;
 
-        calledNode = callEvent<PointerEvent, &AbstractLayer::pointerPressEvent>(globalPositionScaled, event);
+        calledNode = callEvent<PointerEvent, &AbstractLayer::pointerPressEvent, &AbstractLayer::pointerPressEvents>(globalPositionScaled, event);
         pressAcceptedByAnyData = calledNode != NodeHandle::Null;
     }
 
@@ -3870,7 +6010,7 @@ bool AbstractUserInterface::pointerPressEvent(const Vector2& globalPosition, Poi
            that's focusable */
         const NodeHandle nodeToFocus =
             pressAcceptedByAnyData &&
-            state.nodes[nodeHandleId(calledNode)].used.flags >= NodeFlag::Focusable &&
+            state.nodeFlags[nodeHandleId(calledNode)] >= NodeFlag::Focusable &&
             state.visibleEventNodeMask[nodeHandleId(calledNode)] ?
                 calledNode : NodeHandle::Null;
 
@@ -3915,7 +6055,7 @@ bool AbstractUserInterface::pointerPressEvent(const Vector2& globalPosition, Poi
        case it wouldn't propagate anywhere, making it impossible for the
        fallthrough nodes to catch such events). */
     if(pressAcceptedByAnyData || state.currentCapturedNode != NodeHandle::Null)
-        callFallthroughPointerEvents<PointerEvent, &AbstractLayer::pointerPressEvent>(
+        callFallthroughPointerEvents<PointerEvent, &AbstractLayer::pointerPressEvent, &AbstractLayer::pointerPressEvents>(
             calledNode != NodeHandle::Null ? calledNode : state.currentCapturedNode,
             globalPositionScaled, event, /*allowCapture*/ true);
 
@@ -3923,8 +6063,14 @@ bool AbstractUserInterface::pointerPressEvent(const Vector2& globalPosition, Poi
 }
 
 bool AbstractUserInterface::pointerReleaseEvent(const Vector2& globalPosition, PointerEvent& event) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::pointerReleaseEvent()");
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::pointerReleaseEvent(): event already accepted", {});
+    if(_state->updateStatisticsEnabled)
+        ++_state->frameEventCount;
+
+    /* Deliver a queued move event first to preserve the event order */
+    flushPointerMoveEvent();
 
     /* Update so we don't have stale pointerEventCapture{Node,Data}. Otherwise
        the update() gets called only later in callEvent(). */
@@ -3953,7 +6099,7 @@ bool AbstractUserInterface::pointerReleaseEvent(const Vector2& globalPosition, P
         event._captured = true;
         event._nodeHovered = insideCapturedNode;
 
-        releaseAcceptedByAnyData = callEventOnNode<PointerEvent, &AbstractLayer::pointerReleaseEvent>(globalPositionScaled, state.currentCapturedNode, event);
+        releaseAcceptedByAnyData = callEventOnNode<PointerEvent, &AbstractLayer::pointerReleaseEvent, &AbstractLayer::pointerReleaseEvents>(globalPositionScaled, state.currentCapturedNode, event);
         calledNode = releaseAcceptedByAnyData ? state.currentCapturedNode : NodeHandle::Null;
 
     /* Otherwise the usual hit testing etc. */
@@ -3963,7 +6109,7 @@ bool AbstractUserInterface::pointerReleaseEvent(const Vector2& globalPosition, P
         event._captured = false;
         event._nodeHovered = true;
 
-        calledNode = callEvent<PointerEvent, &AbstractLayer::pointerReleaseEvent>(globalPositionScaled, event);
+        calledNode = callEvent<PointerEvent, &AbstractLayer::pointerReleaseEvent, &AbstractLayer::pointerReleaseEvents>(globalPositionScaled, event);
         releaseAcceptedByAnyData = calledNode != NodeHandle::Null;
     }
 
@@ -3997,7 +6143,7 @@ bool AbstractUserInterface::pointerReleaseEvent(const Vector2& globalPosition, P
        fallthrough nodes to catch such events). Allow them to change capture
        only if they're secondary release events. */
     if(releaseAcceptedByAnyData || state.currentCapturedNode != NodeHandle::Null)
-        callFallthroughPointerEvents<PointerEvent, &AbstractLayer::pointerReleaseEvent>(
+        callFallthroughPointerEvents<PointerEvent, &AbstractLayer::pointerReleaseEvent, &AbstractLayer::pointerReleaseEvents>(
             calledNode != NodeHandle::Null ? calledNode : state.currentCapturedNode,
             globalPositionScaled, event, /*allowCapture*/ !event.isPrimary());
 
@@ -4011,9 +6157,44 @@ bool AbstractUserInterface::pointerReleaseEvent(const Vector2& globalPosition, P
 }
 
 bool AbstractUserInterface::pointerMoveEvent(const Vector2& globalPosition, PointerMoveEvent& event) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::pointerMoveEvent()");
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::pointerMoveEvent(): event already accepted", {});
 
+    State& state = *_state;
+
+    /* Events changing the set of pressed pointers are never coalesced, as
+       they're effectively a press or a release */
+    if(!state.pointerMoveEventCoalescing || event._pointer != Pointer{}) {
+        flushPointerMoveEvent();
+        return pointerMoveEventInternal(globalPosition, event);
+    }
+
+    /* If there's a queued event for the same pointer in the same state,
+       remember its time and position and replace it. Otherwise deliver the
+       queued event first. */
+    if(state.pendingPointerMoveEvent) {
+        const PointerMoveEvent& pending = *state.pendingPointerMoveEvent;
+        if(pending._source == event._source &&
+           pending._id == event._id &&
+           pending._primary == event._primary &&
+           pending._pointers == event._pointers)
+            arrayAppend(state.coalescedPointerMoves, InPlaceInit, pending._time, state.pendingPointerMoveGlobalPosition);
+        else
+            flushPointerMoveEvent();
+    }
+
+    state.pendingPointerMoveEvent.emplace(event);
+    state.pendingPointerMoveGlobalPosition = globalPosition;
+    return false;
+}
+
+bool AbstractUserInterface::pointerMoveEventInternal(const Vector2& globalPosition, PointerMoveEvent& event) {
+    /* Counted here and not in pointerMoveEvent() to not include events that
+       got coalesced */
+    if(_state->updateStatisticsEnabled)
+        ++_state->frameEventCount;
+
     /* Update so we don't have stale pointerEventCapture{Node,Data}. Otherwise
        the update() gets called only later in callEvent(). */
     update();
@@ -4058,7 +6239,7 @@ bool AbstractUserInterface::pointerMoveEvent(const Vector2& globalPosition, Poin
            events without such capability for simplicity. */
         /** @todo any use case for a non-primary non-accepted event to reset
             the capture? it should just accept in that case, why not */
-        moveAcceptedByAnyData = callEventOnNode<PointerMoveEvent, &AbstractLayer::pointerMoveEvent>(globalPositionScaled, state.currentCapturedNode, event, /*rememberCaptureOnUnaccepted*/ event.isPrimary());
+        moveAcceptedByAnyData = callEventOnNode<PointerMoveEvent, &AbstractLayer::pointerMoveEvent, &AbstractLayer::pointerMoveEvents>(globalPositionScaled, state.currentCapturedNode, event, /*rememberCaptureOnUnaccepted*/ event.isPrimary());
         calledNode = state.currentCapturedNode;
 
     /* Otherwise the usual hit testing etc. */
@@ -4071,7 +6252,7 @@ bool AbstractUserInterface::pointerMoveEvent(const Vector2& globalPosition, Poin
         event._captured = false;
         event._nodeHovered = true;
 
-        calledNode = callEvent<PointerMoveEvent, &AbstractLayer::pointerMoveEvent>(globalPositionScaled, event);
+        calledNode = callEvent<PointerMoveEvent, &AbstractLayer::pointerMoveEvent, &AbstractLayer::pointerMoveEvents>(globalPositionScaled, event);
         moveAcceptedByAnyData = calledNode != NodeHandle::Null;
     }
 
@@ -4156,7 +6337,7 @@ bool AbstractUserInterface::pointerMoveEvent(const Vector2& globalPosition, Poin
         event._relativePosition = {};
         /* The accept status is ignored for the Enter/Leave events, which means
            we remember the capture state even if not explicitly accepted */
-        callEventOnNode<PointerMoveEvent, &AbstractLayer::pointerLeaveEvent>(globalPositionScaled, callLeaveOnNode, event, /*rememberCaptureOnUnaccepted*/ true);
+        callEventOnNode<PointerMoveEvent, &AbstractLayer::pointerLeaveEvent, &AbstractLayer::pointerLeaveEvents>(globalPositionScaled, callLeaveOnNode, event, /*rememberCaptureOnUnaccepted*/ true);
 
         if(state.currentCapturedNode != callLeaveOnNode)
             event._captured = captured;
@@ -4182,7 +6363,7 @@ bool AbstractUserInterface::pointerMoveEvent(const Vector2& globalPosition, Poin
         event._relativePosition = {};
         /* The accept status is ignored for the Enter/Leave events, which means
            we remember the capture state even if not explicitly accepted */
-        callEventOnNode<PointerMoveEvent, &AbstractLayer::pointerEnterEvent>(globalPositionScaled, callEnterOnNode, event, /*rememberCaptureOnUnaccepted*/ true);
+        callEventOnNode<PointerMoveEvent, &AbstractLayer::pointerEnterEvent, &AbstractLayer::pointerEnterEvents>(globalPositionScaled, callEnterOnNode, event, /*rememberCaptureOnUnaccepted*/ true);
     }
 
     /* Update the captured node based on what's desired. If the captured state
@@ -4238,7 +6419,7 @@ bool AbstractUserInterface::pointerMoveEvent(const Vector2& globalPosition, Poin
        subsequently cleared for emitting enter/leave events). */
     if(moveAcceptedByAnyData || state.currentCapturedNode != NodeHandle::Null) {
         event._relativePosition = relativePosition;
-        callFallthroughPointerEvents<PointerMoveEvent, &AbstractLayer::pointerMoveEvent>(
+        callFallthroughPointerEvents<PointerMoveEvent, &AbstractLayer::pointerMoveEvent, &AbstractLayer::pointerMoveEvents>(
             calledNode != NodeHandle::Null ? calledNode : state.currentCapturedNode,
             globalPositionScaled, event, /*allowCapture*/ true);
     }
@@ -4247,8 +6428,14 @@ bool AbstractUserInterface::pointerMoveEvent(const Vector2& globalPosition, Poin
 }
 
 bool AbstractUserInterface::scrollEvent(const Vector2& globalPosition, ScrollEvent& event) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::scrollEvent()");
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::scrollEvent(): event already accepted", {});
+    if(_state->updateStatisticsEnabled)
+        ++_state->frameEventCount;
+
+    /* Deliver a queued move event first to preserve the event order */
+    flushPointerMoveEvent();
 
     update();
 
@@ -4266,7 +6453,7 @@ bool AbstractUserInterface::scrollEvent(const Vector2& globalPosition, ScrollEve
         event._captured = true;
         event._nodeHovered = state.currentHoveredNode == state.currentCapturedNode;
 
-        acceptedByAnyData = callEventOnNode<ScrollEvent, &AbstractLayer::scrollEvent>(globalPositionScaled, state.currentCapturedNode, event);
+        acceptedByAnyData = callEventOnNode<ScrollEvent, &AbstractLayer::scrollEvent, &AbstractLayer::scrollEvents>(globalPositionScaled, state.currentCapturedNode, event);
 
     /* Otherwise the usual hit testing etc. */
     } else {
@@ -4275,7 +6462,7 @@ bool AbstractUserInterface::scrollEvent(const Vector2& globalPosition, ScrollEve
         event._captured = false;
         event._nodeHovered = true;
 
-        acceptedByAnyData = callEvent<ScrollEvent, &AbstractLayer::scrollEvent>(globalPositionScaled, event) != NodeHandle::Null;
+        acceptedByAnyData = callEvent<ScrollEvent, &AbstractLayer::scrollEvent, &AbstractLayer::scrollEvents>(globalPositionScaled, event) != NodeHandle::Null;
     }
 
     /* Changing the capture state isn't possible from a scroll event, as that
@@ -4291,12 +6478,19 @@ bool AbstractUserInterface::scrollEvent(const Vector2& globalPosition, ScrollEve
 }
 
 bool AbstractUserInterface::focusEvent(const NodeHandle node, FocusEvent& event) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::focusEvent()");
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::focusEvent(): event already accepted", {});
+    if(_state->updateStatisticsEnabled)
+        ++_state->frameEventCount;
     CORRADE_ASSERT(node == NodeHandle::Null || isHandleValid(node),
         "Ui::AbstractUserInterface::focusEvent(): invalid handle" << node, {});
+
+    /* Deliver a queued move event first to preserve the event order */
+    flushPointerMoveEvent();
+
     State& state = *_state;
-    CORRADE_ASSERT(node == NodeHandle::Null || state.nodes[nodeHandleId(node)].used.flags >= NodeFlag::Focusable,
+    CORRADE_ASSERT(node == NodeHandle::Null || state.nodeFlags[nodeHandleId(node)] >= NodeFlag::Focusable,
         "Ui::AbstractUserInterface::focusEvent(): node not focusable", {});
 
     /* Do an update. That may cause the currently focused node to be cleared,
@@ -4345,9 +6539,12 @@ bool AbstractUserInterface::focusEvent(const NodeHandle node, FocusEvent& event)
     return focusAccepted;
 }
 
-template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> bool AbstractUserInterface::keyPressOrReleaseEvent(KeyEvent& event) {
+template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, KeyEvent&)> bool AbstractUserInterface::keyPressOrReleaseEvent(KeyEvent& event) {
     /* Common code for keyPressEvent() and keyReleaseEvent() */
 
+    /* Deliver a queued move event first to preserve the event order */
+    flushPointerMoveEvent();
+
     update();
 
     State& state = *_state;
@@ -4360,7 +6557,7 @@ template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> bool AbstractUs
         /* event._captured is false, event._hovering is set by
            callKeyEventOnNode() itself */
 
-        acceptedByAnyData = callKeyEventOnNode<function>(state.currentFocusedNode, event);
+        acceptedByAnyData = callKeyEventOnNode<function, batchFunction>(state.currentFocusedNode, event);
 
         /* Changing the capture state isn't possible from a key event, and for
            the event being called on a focused node it's always false */
@@ -4380,7 +6577,7 @@ template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> bool AbstractUs
             event._captured = true;
             event._nodeHovered = state.currentHoveredNode == state.currentCapturedNode;
 
-            acceptedByAnyData = callEventOnNode<KeyEvent, function>(*state.currentGlobalPointerPosition, state.currentCapturedNode, event);
+            acceptedByAnyData = callEventOnNode<KeyEvent, function, batchFunction>(*state.currentGlobalPointerPosition, state.currentCapturedNode, event);
 
         /* Otherwise call it on the currently hovered node, if there is. Again,
            at this point it should be either null or valid. */
@@ -4391,7 +6588,7 @@ template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> bool AbstractUs
             event._captured = false;
             event._nodeHovered = true;
 
-            acceptedByAnyData = callEventOnNode<KeyEvent, function>(*state.currentGlobalPointerPosition, state.currentHoveredNode, event);
+            acceptedByAnyData = callEventOnNode<KeyEvent, function, batchFunction>(*state.currentGlobalPointerPosition, state.currentHoveredNode, event);
         }
 
         /* Changing the capture state isn't possible from a key event, as that
@@ -4404,22 +6601,34 @@ template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> bool AbstractUs
 }
 
 bool AbstractUserInterface::keyPressEvent(KeyEvent& event) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::keyPressEvent()");
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::keyPressEvent(): event already accepted", {});
+    if(_state->updateStatisticsEnabled)
+        ++_state->frameEventCount;
 
-    return keyPressOrReleaseEvent<&AbstractLayer::keyPressEvent>(event);
+    return keyPressOrReleaseEvent<&AbstractLayer::keyPressEvent, &AbstractLayer::keyPressEvents>(event);
 }
 
 bool AbstractUserInterface::keyReleaseEvent(KeyEvent& event) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::keyReleaseEvent()");
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::keyReleaseEvent(): event already accepted", {});
+    if(_state->updateStatisticsEnabled)
+        ++_state->frameEventCount;
 
-    return keyPressOrReleaseEvent<&AbstractLayer::keyReleaseEvent>(event);
+    return keyPressOrReleaseEvent<&AbstractLayer::keyReleaseEvent, &AbstractLayer::keyReleaseEvents>(event);
 }
 
 bool AbstractUserInterface::textInputEvent(TextInputEvent& event) {
+    MAGNUM_UI_TRACE_ZONE("Ui::AbstractUserInterface::textInputEvent()");
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::textInputEvent(): event already accepted", {});
+    if(_state->updateStatisticsEnabled)
+        ++_state->frameEventCount;
+
+    /* Deliver a queued move event first to preserve the event order */
+    flushPointerMoveEvent();
 
     /* Do an update. That may cause the currently focused node to be cleared,
        for example because it's now in a disabled/hidden hierarchy. */
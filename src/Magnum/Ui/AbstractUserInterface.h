@@ -31,9 +31,11 @@
  * @m_since_latest
  */
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/EnumSet.h>
 #include <Corrade/Containers/Pointer.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Time.h>
 
 #include "Magnum/Ui/Ui.h"
 #include "Magnum/Ui/visibility.h"
@@ -57,8 +59,9 @@ enum class UserInterfaceState: UnsignedShort {
      * or reupload data attached to visible node hierarchy after they've been
      * changed. Set implicitly if any of the layers have
      * @ref LayerState::NeedsDataUpdate,
-     * @relativeref{LayerState,NeedsCommonDataUpdate} or
-     * @relativeref{LayerState,NeedsSharedDataUpdate} set, is reset next time
+     * @relativeref{LayerState,NeedsCommonDataUpdate},
+     * @relativeref{LayerState,NeedsSharedDataUpdate} or
+     * @relativeref{LayerState,NeedsDataStyleUpdate} set, is reset next time
      * @ref AbstractUserInterface::update() is called. Implied by
      * @ref UserInterfaceState::NeedsDataAttachmentUpdate,
      * @relativeref{UserInterfaceState,NeedsNodeEnabledUpdate},
@@ -267,6 +270,183 @@ MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, UserInterfaceStates value);
 
 CORRADE_ENUMSET_OPERATORS(UserInterfaceStates)
 
+/**
+@brief User interface update stage
+@m_since_latest
+
+@see @ref UserInterfaceUpdateStatistics,
+    @ref AbstractUserInterface::setUpdateStageCallback()
+*/
+enum class UserInterfaceUpdateStage: UnsignedByte {
+    /**
+     * Cleaning orphaned nodes, data and data attachments with
+     * @ref AbstractUserInterface::clean()
+     */
+    Clean,
+
+    /** Ordering the visible node hierarchy and the top-level nodes */
+    NodeOrder,
+
+    /**
+     * Discovering layouts assigned to visible nodes, updating layouters and
+     * calculating absolute node offsets
+     */
+    Layout,
+
+    /**
+     * Propagating node opacity, culling and clipping the visible nodes and
+     * propagating node flags to children
+     */
+    NodeState,
+
+    /**
+     * Ordering data of each layer attached to visible nodes and building,
+     * reordering and compacting the draw list
+     */
+    DataOrder,
+
+    /**
+     * Refreshing the event handling state, including calling
+     * @ref AbstractLayer::visibilityLostEvent()
+     */
+    Event,
+
+    /** Calling @ref AbstractLayer::update() on layers that need it */
+    LayerUpdate
+};
+
+/**
+@debugoperatorenum{UserInterfaceUpdateStage}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, UserInterfaceUpdateStage value);
+
+/**
+@brief User interface update statistics
+@m_since_latest
+
+Filled by @ref AbstractUserInterface::update() if enabled with
+@ref AbstractUserInterface::setUpdateStatistics(). See its documentation for
+more information.
+*/
+struct UserInterfaceUpdateStatistics {
+    /**
+     * @brief Duration of each update stage
+     *
+     * Indexed by @ref UserInterfaceUpdateStage. If
+     * @ref AbstractUserInterface::update() had nothing to do, all durations
+     * except for @ref UserInterfaceUpdateStage::Clean are zero.
+     */
+    Nanoseconds stageDurations[7];
+
+    /** @brief Count of nodes in the visible node hierarchy */
+    UnsignedInt visibleNodeCount;
+
+    /**
+     * @brief Count of nodes culled away
+     *
+     * Nodes in the visible node hierarchy that are outside of the UI area or
+     * of their clip rects.
+     */
+    UnsignedInt culledNodeCount;
+
+    /** @brief Count of clip rects */
+    UnsignedInt clipRectCount;
+
+    /**
+     * @brief Count of draws before compaction
+     *
+     * One for each visible top-level node and each layer that advertises
+     * @ref LayerFeature::Draw, including draws that have no data.
+     */
+    UnsignedInt drawCountBeforeCompaction;
+
+    /**
+     * @brief Count of draws
+     *
+     * Count of draws after empty draws were removed and, if
+     * @ref AbstractUserInterface::setDrawMerging() is enabled, draws of
+     * non-overlapping top-level nodes were merged.
+     */
+    UnsignedInt drawCount;
+
+    /**
+     * @brief Count of composite operations
+     *
+     * Count of draws of layers that advertise @ref LayerFeature::Composite,
+     * each of which results in a @ref AbstractLayer::composite() call in
+     * @ref AbstractUserInterface::draw().
+     */
+    UnsignedInt compositeCount;
+
+    /**
+     * @brief Count of data to update in each layer
+     *
+     * Indexed by layer ID, contains the count of data attached to visible
+     * nodes. Points to internal user interface state, valid until the next
+     * @ref AbstractUserInterface::update() call or until the user interface
+     * is destroyed.
+     */
+    Containers::ArrayView<const UnsignedInt> layerDataCounts;
+
+    /**
+     * @brief States each layer got updated with in the last frame
+     *
+     * Indexed by layer ID, contains a union of @ref LayerStates passed to
+     * @ref AbstractLayer::update() between the previous and the last
+     * @ref AbstractUserInterface::draw() call, or an empty set if the layer
+     * wasn't updated at all. Useful for example to detect that a mere hover
+     * caused a @ref LayerState::NeedsDataUpdate. Unlike the other fields
+     * it's filled by @ref AbstractUserInterface::draw() and not
+     * @ref AbstractUserInterface::update(). Points to internal user
+     * interface state, valid until the next
+     * @ref AbstractUserInterface::draw() call or until the user interface is
+     * destroyed.
+     */
+    Containers::ArrayView<const LayerStates> layerStates;
+
+    /**
+     * @brief Size of data each layer uploaded in the last frame
+     *
+     * Indexed by layer ID, contains a sum of @ref AbstractLayer::uploadedSize()
+     * for all @ref AbstractLayer::update() calls between the previous and the
+     * last @ref AbstractUserInterface::draw() call, in bytes. Filled by
+     * @ref AbstractUserInterface::draw() with the same lifetime as
+     * @ref layerStates.
+     */
+    Containers::ArrayView<const std::size_t> layerUploadedSizes;
+
+    /**
+     * @brief Count of events dispatched in the last frame
+     *
+     * Count of pointer, scroll, focus, key and text input events the user
+     * interface processed between the previous and the last
+     * @ref AbstractUserInterface::draw() call. Coalesced pointer move events
+     * are counted only once they're delivered. Filled by
+     * @ref AbstractUserInterface::draw().
+     */
+    UnsignedInt eventCount;
+
+    /**
+     * @brief Count of nodes hit-tested in the last frame
+     *
+     * Count of visible nodes accepting events that were visited when finding
+     * a node under the pointer for @ref eventCount. Filled by
+     * @ref AbstractUserInterface::draw().
+     */
+    UnsignedInt hitTestNodeCount;
+
+    /**
+     * @brief Count of animators advanced in the last frame
+     *
+     * Sum of animators that were advanced in all
+     * @ref AbstractUserInterface::advanceAnimations() calls between the
+     * previous and the last @ref AbstractUserInterface::draw() call. Filled
+     * by @ref AbstractUserInterface::draw().
+     */
+    UnsignedInt animatorAdvanceCount;
+};
+
 namespace Implementation {
     template<class, class = void> struct ApplicationSizeConverter;
     template<class, class = void> struct PointerEventConverter;
@@ -393,6 +573,19 @@ was accepted by it, so the checks are separate --- for example a
 but if the cursor is already at the begin of the text, it doesn't cause any
 visual change and thus there's no need to redraw anything.
 
+@subsection Ui-AbstractUserInterface-application-animation Idling with scheduled animations
+
+If there are animators with @ref AnimatorState::NeedsAdvance, the @ref state()
+contains @ref UserInterfaceState::NeedsAnimationAdvance and the above code
+would redraw continuously. That's wasteful if the animations are only
+scheduled to be played later or are paused. The
+@ref nextAnimationAdvanceTime() query returns @ref animationTime() if any
+animation is actually playing and a future time if there are only scheduled or
+paused animations, which the application can use to schedule a redraw only
+once an animation starts:
+
+@snippet Ui-sdl2.cpp AbstractUserInterface-application-animation-idle
+
 @section Ui-AbstractUserInterface-handles Handles and resource ownership
 
 Unlike traditional UI toolkits, which commonly use pointer-like abstractions to
@@ -585,6 +778,11 @@ through to the rest of the application or to the OS, browser etc.
 
 @snippet Ui-sdl2.cpp AbstractUserInterface-events-application-fallthrough
 
+The event handlers are expected to be called from the thread that owns the
+user interface. If input arrives from a different thread, the events can be put
+into an @ref EventQueue instead, which then delivers them all at once on the UI
+thread. The accept status isn't propagated back in that case.
+
 @subsection Ui-AbstractUserInterface-events-propagation Node hierarchy event propagation
 
 Inside the UI, pointer and position-dependent key events are directed to
@@ -999,6 +1197,31 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         UserInterfaceStates state() const;
 
+        /**
+         * @brief Whether the user interface needs to be drawn
+         *
+         * Returns @cpp true @ce if the next @ref draw() may produce a
+         * different image than the previous one, i.e. if the last
+         * @ref update() processed any changes that weren't drawn yet, or if
+         * @ref state() contains anything else than
+         * @ref UserInterfaceState::NeedsNodeEventMaskUpdate and
+         * @relativeref{UserInterfaceState,NeedsAnimationAdvance}. If it
+         * returns @cpp false @ce, the application can skip the
+         * @ref draw() call as well as the buffer swap, and for example avoid
+         * scheduling a redraw of the application window.
+         *
+         * The check is conservative --- it's set if any node or layer data
+         * got updated, even if the actual pixels stay the same in the end.
+         * Running animations are only reflected after
+         * @ref advanceAnimations() is called, so with
+         * @ref UserInterfaceState::NeedsAnimationAdvance set the application
+         * should advance the animations first and check this function only
+         * after. Initially, and after any change of the framebuffer size or
+         * the renderer instance, returns @cpp true @ce. The flag is reset by
+         * @ref draw() and @ref drawSnapshot().
+         */
+        bool needsDraw() const;
+
         /**
          * @brief Animation time
          *
@@ -1008,6 +1231,30 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         Nanoseconds animationTime() const;
 
+        /**
+         * @brief Time at which animations need to be advanced next
+         * @m_since_latest
+         *
+         * Returns the earliest @ref AbstractAnimator::nextAdvanceTime() of
+         * all animators, or @ref Nanoseconds::max() if there are no animators
+         * with @ref AnimatorState::NeedsAdvance. If the returned value is
+         * @ref animationTime(), there are animations playing and
+         * @ref advanceAnimations() should be called for the next frame. If
+         * it's larger, @ref state() may contain
+         * @ref UserInterfaceState::NeedsAnimationAdvance, but there's just
+         * scheduled or paused animations and nothing would get advanced
+         * until then. This allows the application to redraw only when
+         * needed and otherwise idle until an event arrives or until the
+         * returned time, see
+         * @ref Ui-AbstractUserInterface-application-animation for an example.
+         *
+         * Right after @ref advanceAnimations() the complexity is
+         * @f$ \mathcal{O}(n) @f$ in the count of animators, as each of them
+         * caches the value calculated during the advance. See
+         * @ref AbstractAnimator::nextAdvanceTime() for details.
+         */
+        Nanoseconds nextAnimationAdvanceTime() const;
+
         /** @{
          * @name Renderer management
          */
@@ -1198,6 +1445,11 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * Calls @ref AbstractLayer::setSize() on the layer, unless neither
          * @ref setSize() nor @ref AbstractUserInterface(const Vector2&, const Vector2&, const Vector2i&)
          * was called yet.
+         *
+         * If the library is built without the `MAGNUM_UI_WITH_COMPOSITE_LAYERS`
+         * CMake option, expects that the layer doesn't advertise
+         * @ref LayerFeature::Composite. See @ref building-extras-features for
+         * more information.
          * @see @ref AbstractLayer::handle(),
          *      @ref isHandleValid(LayerHandle) const
          */
@@ -1273,6 +1525,17 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         void attachData(NodeHandle node, DataHandle data);
 
+        /**
+         * @brief Attach multiple data to nodes
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref attachData(NodeHandle, DataHandle) for
+         * each pair of items in @p nodes and @p data. Expects that both views
+         * have the same size, all @p nodes are either valid or
+         * @ref NodeHandle::Null and all @p data are valid.
+         */
+        void attachData(const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<const DataHandle>& data);
+
         /**
          * @}
          */
@@ -1385,6 +1648,10 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * used to construct an @ref AbstractLayouter subclass and the instance
          * then passed to @ref setLayouterInstance(). A layouter can be removed
          * again with @ref removeLayer().
+         *
+         * If the library is built without the `MAGNUM_UI_WITH_LAYOUTERS`
+         * CMake option, layouters can't be created at all. See
+         * @ref building-extras-features for more information.
          * @see @ref isHandleValid(LayouterHandle) const,
          *      @ref layouterCapacity(), @ref layouterUsedCount()
          */
@@ -1570,6 +1837,10 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * Internally, the instance is inserted into a list partitioned by
          * animator type, which is done with a @f$ \mathcal{O}(n) @f$
          * complexity where @f$ n @f$ is @ref animatorCapacity().
+         *
+         * If the library is built without the `MAGNUM_UI_WITH_NODE_ANIMATORS`
+         * CMake option, node animators can't be set at all. See
+         * @ref building-extras-features for more information.
          * @see @ref AbstractAnimator::handle(),
          *      @ref isHandleValid(AnimatorHandle) const
          */
@@ -1724,8 +1995,9 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
         /**
          * @brief Current capacity of the node storage
          *
-         * Can be at most 1048576. If @ref createNode() is called and there's
-         * no free slots left, the internal storage gets grown.
+         * Can be at most 1048576 by default, see @ref NodeHandle for
+         * details. If @ref createNode() is called and there's no free slots
+         * left, the internal storage gets grown.
          * @see @ref nodeUsedCount()
          */
         std::size_t nodeCapacity() const;
@@ -1740,6 +2012,65 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         std::size_t nodeUsedCount() const;
 
+        /**
+         * @brief Reserve the node storage
+         * @m_since_latest
+         *
+         * Reserves memory for the internal node storage to fit at least
+         * @p capacity nodes without reallocation. Expects that @p capacity is
+         * at most 1048576 by default, see @ref NodeHandle for details.
+         * Doesn't change @ref nodeCapacity(), which grows only when nodes are
+         * actually created. Useful before creating a large amount of nodes at
+         * once with @ref createNode() so the storage is allocated only once,
+         * @ref createNodes() reserves for all nodes passed to it implicitly.
+         * @see @ref AbstractLayer::reserve(), @ref AbstractAnimator::reserve(),
+         *      @ref setFixedNodeCapacity()
+         */
+        void reserveNodes(std::size_t capacity);
+
+        /**
+         * @brief Fixed node capacity
+         * @m_since_latest
+         *
+         * If @cpp 0 @ce, the node storage grows as needed.
+         * @see @ref setFixedNodeCapacity()
+         */
+        std::size_t fixedNodeCapacity() const;
+
+        /**
+         * @brief Set a fixed node capacity
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Reserves the node storage for @p capacity nodes with
+         * @ref reserveNodes() and makes @ref createNode() and
+         * @ref createNodes() never grow it past that, meaning no node
+         * storage allocations happen from that point on. Creating a node
+         * when the storage is full is an error, check
+         * @ref isNodeStorageFull() to handle the condition gracefully.
+         * Expects that @p capacity is at most 1048576 by default, see
+         * @ref NodeHandle for details, and not less than
+         * @ref nodeCapacity(). Passing @cpp 0 @ce makes the storage grow
+         * as needed again. Meant for deployments that need to avoid heap
+         * allocations after initialization, together with
+         * @ref AbstractLayer::setFixedCapacity(),
+         * @ref AbstractAnimator::setFixedCapacity() and
+         * @ref setPersistentUpdateStorage().
+         */
+        AbstractUserInterface& setFixedNodeCapacity(std::size_t capacity);
+
+        /**
+         * @brief Whether the node storage is full
+         * @m_since_latest
+         *
+         * Returns @cpp true @ce if @ref setFixedNodeCapacity() is set, all
+         * nodes up to it are created and there are no free nodes to reuse,
+         * i.e. @ref createNode() would fail. Unlike @ref nodeUsedCount(),
+         * the operation is done in a @f$ \mathcal{O}(1) @f$ complexity.
+         * Always returns @cpp false @ce if the capacity isn't fixed.
+         */
+        bool isNodeStorageFull() const;
+
         /**
          * @brief Whether a node handle is valid
          *
@@ -1763,8 +2094,9 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          *
          * Allocates a new handle in a free slot in the internal storage or
          * grows the storage if there's no free slots left. Expects that
-         * there's at most 1048576 nodes. The returned handle can be then
-         * removed again with @ref removeNode().
+         * there's at most 1048576 nodes by default, see @ref NodeHandle for
+         * details. The returned handle can be then removed again with
+         * @ref removeNode().
          *
          * If @p parent is @ref NodeHandle::Null, the node is added at the
          * back of the draw and event processing list, i.e. drawn last (thus
@@ -1788,6 +2120,36 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         NodeHandle createNode(const Vector2& offset, const Vector2& size, NodeFlags flags = {});
 
+        /**
+         * @brief Create multiple nodes
+         * @param parents       Parent nodes to attach to or
+         *      @ref NodeHandle::Null for new root nodes. Expected to be valid
+         *      if not null.
+         * @param offsets       Offsets relative to the parent nodes
+         * @param sizes         Sizes of the node contents
+         * @param flags         Initial node flags. Can be empty, in which case
+         *      no flags are set for any node.
+         * @param[out] handles  Where to put the new node handles
+         * @m_since_latest
+         *
+         * Equivalent to calling
+         * @ref createNode(NodeHandle, const Vector2&, const Vector2&, NodeFlags)
+         * for each item, but with the node storage grown at most once and the
+         * internal state updated just once for all nodes. Expects that
+         * @p parents, @p offsets, @p sizes and @p handles all have the same
+         * size and that @p flags either has the same size as well or is
+         * empty. All @p parents are checked for validity before any node is
+         * created, thus they can't reference nodes created by the same call
+         * --- a hierarchy is meant to be created one level at a time. Root
+         * nodes are added at the back of the draw and event processing list
+         * in the order they're listed in @p parents.
+         *
+         * Calling this function causes @ref UserInterfaceState::NeedsNodeUpdate
+         * to be set.
+         * @see @ref removeNodes()
+         */
+        void createNodes(const Containers::StridedArrayView1D<const NodeHandle>& parents, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const NodeFlags>& flags, const Containers::StridedArrayView1D<NodeHandle>& handles);
+
         /**
          * @brief Node parent
          *
@@ -1826,6 +2188,10 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          *
          * Calling this function causes
          * @ref UserInterfaceState::NeedsLayoutUpdate to be set.
+         * Unless the node is a root node, only layouts in the hierarchy of
+         * its root node are then updated in the next @ref update() call,
+         * layouts in other root node hierarchies keep their previously
+         * calculated results.
          * @see @ref isHandleValid(NodeHandle) const, @ref nodeParent()
          */
         void setNodeOffset(NodeHandle handle, const Vector2& offset);
@@ -1856,10 +2222,86 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          *
          * Calling this function causes
          * @ref UserInterfaceState::NeedsLayoutUpdate to be set.
+         * Unless the node is a root node, only layouts in the hierarchy of
+         * its root node are then updated in the next @ref update() call,
+         * layouts in other root node hierarchies keep their previously
+         * calculated results.
          * @see @ref isHandleValid(NodeHandle) const
          */
         void setNodeSize(NodeHandle handle, const Vector2& size);
 
+        /**
+         * @brief Set offsets of multiple nodes
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setNodeOffset() for each pair of items in
+         * @p handles and @p offsets, but with the handles checked just once
+         * upfront. Expects that both views have the same size and that all
+         * @p handles are valid.
+         *
+         * Calling this function causes
+         * @ref UserInterfaceState::NeedsLayoutUpdate to be set, if @p handles
+         * isn't empty.
+         * @see @ref isHandleValid(NodeHandle) const
+         */
+        void setNodeOffsets(const Containers::StridedArrayView1D<const NodeHandle>& handles, const Containers::StridedArrayView1D<const Vector2>& offsets);
+
+        /**
+         * @brief Set offsets of multiple nodes in a contiguous node ID range
+         * @m_since_latest
+         *
+         * Sets @p offsets for nodes with IDs going from @p firstNodeId to
+         * @cpp firstNodeId + offsets.size() @ce, without going through node
+         * handles. Useful for applications that manage dense node ranges,
+         * such as the ones created with a single @ref createNodes() call on
+         * an otherwise empty instance, where the IDs can be then retrieved
+         * with @ref nodeHandleId(). The only check done is that the range is
+         * in bounds of @ref nodeCapacity(), it's the caller responsibility
+         * to ensure that all nodes in the range are valid --- writing to IDs
+         * of removed nodes leads to undefined behavior.
+         *
+         * Calling this function causes
+         * @ref UserInterfaceState::NeedsLayoutUpdate to be set, if @p offsets
+         * isn't empty.
+         */
+        void setNodeOffsets(UnsignedInt firstNodeId, const Containers::StridedArrayView1D<const Vector2>& offsets);
+
+        /**
+         * @brief Set sizes of multiple nodes
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setNodeSize() for each pair of items in
+         * @p handles and @p sizes, but with the handles checked just once
+         * upfront. Expects that both views have the same size and that all
+         * @p handles are valid.
+         *
+         * Calling this function causes
+         * @ref UserInterfaceState::NeedsLayoutUpdate to be set, if @p handles
+         * isn't empty.
+         * @see @ref isHandleValid(NodeHandle) const
+         */
+        void setNodeSizes(const Containers::StridedArrayView1D<const NodeHandle>& handles, const Containers::StridedArrayView1D<const Vector2>& sizes);
+
+        /**
+         * @brief Set sizes of multiple nodes in a contiguous node ID range
+         * @m_since_latest
+         *
+         * Sets @p sizes for nodes with IDs going from @p firstNodeId to
+         * @cpp firstNodeId + sizes.size() @ce, without going through node
+         * handles. Useful for applications that manage dense node ranges,
+         * such as the ones created with a single @ref createNodes() call on
+         * an otherwise empty instance, where the IDs can be then retrieved
+         * with @ref nodeHandleId(). The only check done is that the range is
+         * in bounds of @ref nodeCapacity(), it's the caller responsibility
+         * to ensure that all nodes in the range are valid --- writing to IDs
+         * of removed nodes leads to undefined behavior.
+         *
+         * Calling this function causes
+         * @ref UserInterfaceState::NeedsLayoutUpdate to be set, if @p sizes
+         * isn't empty.
+         */
+        void setNodeSizes(UnsignedInt firstNodeId, const Containers::StridedArrayView1D<const Vector2>& sizes);
+
         /**
          * @brief Node opacity
          *
@@ -1888,6 +2330,42 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         void setNodeOpacity(NodeHandle handle, Float opacity);
 
+        /**
+         * @brief Set opacities of multiple nodes
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setNodeOpacity() for each pair of items
+         * in @p handles and @p opacities, but with the handles checked just
+         * once upfront. Expects that both views have the same size and that
+         * all @p handles are valid.
+         *
+         * Calling this function causes
+         * @ref UserInterfaceState::NeedsNodeOpacityUpdate to be set, if
+         * @p handles isn't empty.
+         * @see @ref isHandleValid(NodeHandle) const
+         */
+        void setNodeOpacities(const Containers::StridedArrayView1D<const NodeHandle>& handles, const Containers::StridedArrayView1D<const Float>& opacities);
+
+        /**
+         * @brief Set opacities of multiple nodes in a contiguous node ID range
+         * @m_since_latest
+         *
+         * Sets @p opacities for nodes with IDs going from @p firstNodeId to
+         * @cpp firstNodeId + opacities.size() @ce, without going through node
+         * handles. Useful for applications that manage dense node ranges,
+         * such as the ones created with a single @ref createNodes() call on
+         * an otherwise empty instance, where the IDs can be then retrieved
+         * with @ref nodeHandleId(). The only check done is that the range is
+         * in bounds of @ref nodeCapacity(), it's the caller responsibility
+         * to ensure that all nodes in the range are valid --- writing to IDs
+         * of removed nodes leads to undefined behavior.
+         *
+         * Calling this function causes
+         * @ref UserInterfaceState::NeedsNodeOpacityUpdate to be set, if
+         * @p opacities isn't empty.
+         */
+        void setNodeOpacities(UnsignedInt firstNodeId, const Containers::StridedArrayView1D<const Float>& opacities);
+
         /**
          * @brief Node flags
          *
@@ -1939,6 +2417,42 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         void clearNodeFlags(NodeHandle handle, NodeFlags flags);
 
+        /**
+         * @brief Set flags of multiple nodes
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setNodeFlags(NodeHandle, NodeFlags) for
+         * each pair of items in @p handles and @p flags, but with the handles
+         * checked just once upfront. Expects that both views have the same
+         * size and that all @p handles are valid.
+         *
+         * Calling this function causes the same states as in
+         * @ref setNodeFlags(NodeHandle, NodeFlags) to be set, if @p handles
+         * isn't empty.
+         * @see @ref isHandleValid(NodeHandle) const
+         */
+        void setNodeFlags(const Containers::StridedArrayView1D<const NodeHandle>& handles, const Containers::StridedArrayView1D<const NodeFlags>& flags);
+
+        /**
+         * @brief Set flags of multiple nodes in a contiguous node ID range
+         * @m_since_latest
+         *
+         * Sets @p flags for nodes with IDs going from @p firstNodeId to
+         * @cpp firstNodeId + flags.size() @ce, without going through node
+         * handles. Useful for applications that manage dense node ranges,
+         * such as the ones created with a single @ref createNodes() call on
+         * an otherwise empty instance, where the IDs can be then retrieved
+         * with @ref nodeHandleId(). The only check done is that the range is
+         * in bounds of @ref nodeCapacity(), it's the caller responsibility
+         * to ensure that all nodes in the range are valid --- writing to IDs
+         * of removed nodes leads to undefined behavior.
+         *
+         * Calling this function causes the same states as in
+         * @ref setNodeFlags(NodeHandle, NodeFlags) to be set, if @p flags
+         * isn't empty.
+         */
+        void setNodeFlags(UnsignedInt firstNodeId, const Containers::StridedArrayView1D<const NodeFlags>& flags);
+
         /**
          * @brief Remove a node
          *
@@ -1957,6 +2471,22 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         void removeNode(NodeHandle handle);
 
+        /**
+         * @brief Remove multiple nodes
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref removeNode() for each item. Expects that
+         * all @p handles are valid and unique. Similarly to
+         * @ref removeNode(), nested nodes and data attached to any of the
+         * nodes are removed during the next call to @ref update(), which
+         * then processes the whole batch at once.
+         *
+         * Calling this function causes @ref UserInterfaceState::NeedsNodeClean
+         * to be set, if @p handles isn't empty.
+         * @see @ref createNodes()
+         */
+        void removeNodes(const Containers::StridedArrayView1D<const NodeHandle>& handles);
+
         /**
          * @}
          */
@@ -2095,6 +2625,30 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         NodeHandle nodeOrderLastNested(NodeHandle handle) const;
 
+        /**
+         * @brief Whether a node is drawn behind another node
+         * @m_since_latest
+         *
+         * Returns @cpp true @ce if @p handle is earlier in the draw and event
+         * processing order than @p other, i.e. drawn behind it and reacting
+         * to events later, @cpp false @ce otherwise. Expects that both
+         * @p handle and @p other are valid top-level nodes included in the
+         * draw and event processing order, including all their top-level
+         * parents.
+         *
+         * The comparison is done in an @f$ \mathcal{O}(n) @f$ complexity,
+         * where @f$ n @f$ is the depth at which the nodes are in the node
+         * hierarchy, which is @f$ \mathcal{O}(1) @f$ for root nodes. On
+         * first call after the order was modified in a way other than with
+         * @ref setNodeOrder() on a root node without nested top-level nodes,
+         * the order is additionally walked in an @f$ \mathcal{O}(m) @f$
+         * complexity where @f$ m @f$ is the count of all ordered top-level
+         * nodes.
+         * @see @ref isHandleValid(NodeHandle) const, @ref isNodeTopLevel(),
+         *      @ref isNodeOrdered()
+         */
+        bool isNodeOrderedBehind(NodeHandle handle, NodeHandle other) const;
+
         /**
          * @brief Order a top-level node for draw and event processing
          *
@@ -2198,6 +2752,242 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * @}
          */
 
+        /**
+         * @brief Whether temporary storage for updates is persistent
+         *
+         * @see @ref setPersistentUpdateStorage()
+         */
+        bool hasPersistentUpdateStorage() const;
+
+        /**
+         * @brief Set whether temporary storage for updates is persistent
+         * @return Reference to self (for method chaining)
+         *
+         * Temporary data needed by @ref clean(), @ref advanceAnimations() and
+         * @ref update() are taken from a bump allocator that grows to the
+         * largest size needed so far. By default, the memory is freed at the
+         * end of each of these calls, resulting in a single allocation per
+         * call. If enabled, the memory is kept around until the persistence
+         * is disabled again, meaning that, once the allocator grows to
+         * accommodate the largest update, these functions don't perform any
+         * temporary allocations at all. Resident node, layout and data state
+         * is reused across calls unless it needs to grow, regardless of this
+         * option. Disabling the persistence frees the temporary storage
+         * immediately. Default is @cpp false @ce.
+         * @see @ref updateStorageSize()
+         */
+        AbstractUserInterface& setPersistentUpdateStorage(bool persistent);
+
+        /**
+         * @brief Size of memory used for update storage
+         *
+         * Size of memory in bytes currently allocated for the resident node,
+         * layout and data state calculated in @ref update() and for temporary
+         * data in @ref clean(), @ref advanceAnimations() and @ref update(). If
+         * @ref setPersistentUpdateStorage() isn't enabled, the temporary
+         * storage is freed after each call and thus doesn't contribute to the
+         * returned size.
+         */
+        std::size_t updateStorageSize() const;
+
+        /**
+         * @brief Whether draw merging is enabled
+         *
+         * @see @ref setDrawMerging()
+         */
+        bool hasDrawMerging() const;
+
+        /**
+         * @brief Set whether to merge draws of non-overlapping top-level nodes
+         * @return Reference to self (for method chaining)
+         *
+         * By default, @ref draw() goes through all top-level nodes in a
+         * back-to-front order and draws all layers for each, which means that
+         * for example a UI consisting of many top-level nodes each having a
+         * background and a text results in alternating draws of two layers.
+         * If enabled, @ref update() looks at consecutive top-level nodes
+         * whose node hierarchies don't overlap each other, and draws them
+         * together layer by layer, merging draws of the same layer into a
+         * single @ref AbstractLayer::draw() call. A group ends at the first
+         * top-level node that overlaps any node already in it, preserving the
+         * draw order between groups. Top-level nodes containing data from
+         * layers with @ref LayerFeature::Composite are always drawn on their
+         * own and draws of such layers are never merged. No merging is done
+         * while any top-level node hierarchy is drawn from a cache with
+         * @ref NodeFlag::Cached.
+         *
+         * The overlap is tested on the bounding rectangles of all visible
+         * nodes in each top-level node hierarchy. Layers that draw outside of
+         * the node rectangles, such as outlines or text that overflows its
+         * node, may thus get drawn in a wrong order relative to other
+         * top-level nodes. Default is @cpp false @ce.
+         *
+         * If the value is different from before, calling this function causes
+         * @ref UserInterfaceState::NeedsDataAttachmentUpdate to be set.
+         */
+        AbstractUserInterface& setDrawMerging(bool merging);
+
+        /**
+         * @brief Whether an update executor is set
+         *
+         * @see @ref setUpdateExecutor()
+         */
+        bool hasUpdateExecutor() const;
+
+        /**
+         * @brief Set an executor for concurrent layer and layouter updates
+         * @return Reference to self (for method chaining)
+         *
+         * The @p executor is called from @ref update() with a task count, a
+         * task function and a state pointer that's meant to be passed to the
+         * task function. It's expected to call the task function with the
+         * state pointer and all indices from @cpp 0 @ce to the task count
+         * (exclusive) exactly once, in any order and potentially from
+         * multiple threads concurrently, and return only once all tasks
+         * finish.
+         *
+         * The executor is used to call @ref AbstractLayer::update() on all
+         * layers that advertise @ref LayerFeature::ConcurrentUpdate at the
+         * same time. Other layers are updated serially in the layer order,
+         * and once both finish, @ref AbstractLayer::postUpdate() is called
+         * on the layers that were updated concurrently, again in the layer
+         * order. If there's just a single layer advertising
+         * @ref LayerFeature::ConcurrentUpdate that needs an update, the
+         * executor isn't called at all.
+         *
+         * The executor is also used to call @ref AbstractLayouter::update()
+         * on layouters that advertise @ref LayouterFeature::ConcurrentUpdate
+         * and calculate independent layout hierarchies of the same dependency
+         * level, with one task per layouter. Layouters that don't advertise
+         * the feature are updated serially, and layout levels that depend on
+         * each other are always calculated one after another. Pass an empty
+         * function to reset the executor, in which case all layers and
+         * layouters are updated serially. Default is no executor.
+         */
+        AbstractUserInterface& setUpdateExecutor(Containers::Function<void(std::size_t count, void(*task)(void* state, std::size_t i), void* state)>&& executor);
+
+        /**
+         * @brief Whether animators are advanced concurrently
+         *
+         * @see @ref setConcurrentAnimationAdvance()
+         */
+        bool hasConcurrentAnimationAdvance() const;
+
+        /**
+         * @brief Set whether animators are advanced concurrently
+         * @return Reference to self (for method chaining)
+         *
+         * If enabled and @ref setUpdateExecutor() is set,
+         * @ref advanceAnimations() calls @ref AbstractAnimator::update() on
+         * all generic and node animators that need an advance through the
+         * executor, each with a dedicated temporary storage. Data and style
+         * animators of layers that advertise
+         * @ref LayerFeature::ConcurrentUpdate are advanced through the
+         * executor as well, with one task per layer. The
+         * @ref AbstractGenericAnimator::advance(),
+         * @ref AbstractNodeAnimator::advance() and
+         * @ref AbstractAnimator::clean() calls are then done serially in the
+         * same order as without concurrency, so the results don't depend on
+         * the order in which the executor runs the tasks. Data and style
+         * animators of other layers are advanced serially after. Animators
+         * are expected to not depend on each other in their
+         * @ref AbstractAnimator::update() for this to be safe. Default is
+         * @cpp false @ce.
+         */
+        AbstractUserInterface& setConcurrentAnimationAdvance(bool concurrent);
+
+        /**
+         * @brief Whether update statistics are gathered
+         *
+         * @see @ref setUpdateStatistics()
+         */
+        bool hasUpdateStatistics() const;
+
+        /**
+         * @brief Set whether to gather update statistics
+         * @return Reference to self (for method chaining)
+         *
+         * If enabled, @ref update() measures the duration of each
+         * @ref UserInterfaceUpdateStage and gathers node, clip rect, draw,
+         * composite and data counts, which are then available through
+         * @ref updateStatistics(). The counters reflect the state prepared
+         * for the next @ref draw(), so they're valid even if @ref update()
+         * had nothing to do. Additionally, layer update states, uploaded
+         * sizes, event, hit test and animator counts are accumulated between
+         * @ref draw() calls and published by @ref draw(), giving per-frame
+         * values. If disabled, the only overhead is a branch for each stage
+         * and each event. Default is @cpp false @ce.
+         * @see @ref setUpdateStageCallback()
+         */
+        AbstractUserInterface& setUpdateStatistics(bool enabled);
+
+        /**
+         * @brief Update statistics
+         *
+         * Expects that update statistics were enabled with
+         * @ref setUpdateStatistics(). Values are zero-initialized until the
+         * first @ref update() call after enabling.
+         */
+        const UserInterfaceUpdateStatistics& updateStatistics() const;
+
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * Sum of the memory used by the internal node, layer, layouter and
+         * animator storage, the temporary storage for updates, event handling
+         * and drawing, and @ref AbstractLayer::memoryUsage(),
+         * @ref AbstractLayouter::memoryUsage() and
+         * @ref AbstractAnimator::memoryUsage() of all instances. Free slots of
+         * the node storage are counted in @ref MemoryUsage::cpuUnused. Query
+         * the layer, layouter and animator instances directly to get a
+         * per-instance breakdown. The operation is done with a
+         * @f$ \mathcal{O}(n + m) @f$ complexity where @f$ n @f$ is
+         * @ref nodeCapacity() and @f$ m @f$ is the sum of capacities of all
+         * layers, layouters and animators.
+         */
+        MemoryUsage memoryUsage() const;
+
+        /**
+         * @brief Trim layer data storage
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Calls @ref clean() to remove data attached to removed nodes and
+         * then @ref AbstractLayer::trim() on all layer instances, dropping
+         * free slots at the end of their data storage and releasing memory
+         * reserved for future growth. Meant to be called after a large amount
+         * of data was removed, such as when a big view got closed, to not
+         * keep the memory at the high-water mark. Temporary storage for
+         * updates sized from layer capacities shrinks accordingly on the next
+         * @ref update(), unless @ref setPersistentUpdateStorage() is enabled.
+         * Node, layouter and animator storage isn't affected.
+         * @see @ref memoryUsage()
+         */
+        AbstractUserInterface& trim();
+
+        /**
+         * @brief Whether an update stage callback is set
+         *
+         * @see @ref setUpdateStageCallback()
+         */
+        bool hasUpdateStageCallback() const;
+
+        /**
+         * @brief Set an update stage callback
+         * @return Reference to self (for method chaining)
+         *
+         * The @p callback is called from @ref update() with @p end set to
+         * @cpp false @ce at the start of each @ref UserInterfaceUpdateStage
+         * and with @p end set to @cpp true @ce at its end, making it
+         * possible to forward the stages to a tracing profiler that has
+         * separate functions for beginning and ending a zone. It's called
+         * independently of whether @ref setUpdateStatistics() is enabled.
+         * The callback is expected to not modify the user interface. Pass an
+         * empty function to reset the callback. Default is no callback.
+         */
+        AbstractUserInterface& setUpdateStageCallback(Containers::Function<void(UserInterfaceUpdateStage stage, bool end)>&& callback);
+
         /**
          * @brief Clean orphaned nodes, data and no longer valid data attachments
          * @return Reference to self (for method chaining)
@@ -2245,7 +3035,9 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * @ref AbstractGenericAnimator::advance(),
          * @ref AbstractNodeAnimator::advance() or layer-specific
          * @ref AbstractLayer::advanceAnimations() on all animator instances
-         * that have @ref AnimatorState::NeedsAdvance set.
+         * that have @ref AnimatorState::NeedsAdvance set. See
+         * @ref setConcurrentAnimationAdvance() for advancing the animators
+         * concurrently.
          *
          * Calling this function updates @ref animationTime(). Afterwards,
          * @ref state() may still contain
@@ -2279,14 +3071,22 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * state, in order:
          *
          * -    Orders visible nodes back-to-front for drawing and
-         *      front-to-back for event processing
+         *      front-to-back for event processing. If no nodes were created,
+         *      removed, made top-level or flattened since the last call, only
+         *      hierarchies of top-level nodes that had
+         *      @ref NodeFlag::Hidden changed on them or their children are
+         *      ordered again, the rest is reused from the last call.
          * -    Orders layouts assigned to nodes by their dependency
          * -    Performs layout calculation
          * -    Calculates absolute offsets for visible nodes
          * -    Culls invisible nodes, calculates clip rectangles
          * -    Propagates @ref NodeFlag::Disabled and @ref NodeFlag::NoEvents
          *      to child nodes
-         * -    Orders data attachments in each layer by draw order
+         * -    Orders data attachments in each layer by draw order, counts
+         *      event handling data in each visible subtree to skip hit
+         *      testing subtrees that have no event handling data attached.
+         *      For nodes with many direct children, a grid for faster hit
+         *      testing is built lazily on the next event.
          * -    Resets @ref currentPressedNode(), @ref currentCapturedNode(),
          *      @ref currentHoveredNode() or @ref currentFocusedNode() if they
          *      no longer exist
@@ -2298,7 +3098,12 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          *      currently focused node is no longer @ref NodeFlag::Focusable.
          * -    Goes in a back to front order through layers that have
          *      instances set and calls @ref AbstractLayer::update() with the
-         *      ordered data
+         *      ordered data. If @ref setUpdateExecutor() is set, layers
+         *      that advertise @ref LayerFeature::ConcurrentUpdate are updated
+         *      concurrently after all others, and then
+         *      @ref AbstractLayer::postUpdate() is called on them. Without an
+         *      executor, @ref AbstractLayer::postUpdate() is called right
+         *      after @ref AbstractLayer::update() on such layers.
          *
          * After calling this function, @ref state() is empty apart from
          * @ref UserInterfaceState::NeedsAnimationAdvance, which may be present
@@ -2316,6 +3121,16 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          *
          * -    Calls @ref AbstractRenderer::transition() with
          *      @ref RendererTargetState::Initial
+         * -    If the renderer advertises @ref RendererFeature::PartialRedraw,
+         *      calls @ref AbstractRenderer::setRedrawRect() with an area
+         *      covering all nodes and data that changed since the previous
+         *      draw, or the whole framebuffer if the size changed, data were
+         *      attached or removed, the node order changed or any drawn layer
+         *      advertises @ref LayerFeature::DrawUsesScissor or
+         *      @relativeref{LayerFeature,Composite}. If the area is empty,
+         *      calls @ref AbstractRenderer::transition() with
+         *      @ref RendererTargetState::Final and returns without drawing
+         *      anything.
          * -    Peforms draw calls by going through draws collected by
          *      @ref update() for each top level node and all its visible
          *      children in a back to front order, and then for each layer that
@@ -2324,17 +3139,77 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          *          @ref AbstractRenderer::transition() with
          *          @ref RendererTargetState::Composite, and then
          *          @ref AbstractLayer::composite()
+         *      -   If the renderer advertises
+         *          @ref RendererFeature::DepthBuffer and this is the first
+         *          draw or a draw of a layer that advertises
+         *          @ref LayerFeature::Composite, goes through this and all
+         *          following draws until the next compositing one in a front
+         *          to back order, and for each layer that advertises
+         *          @ref LayerFeature::DrawOpaque calls
+         *          @ref AbstractRenderer::transition() with
+         *          @ref RendererTargetState::Draw and
+         *          just @ref RendererDrawState::DepthTest and
+         *          @relativeref{RendererDrawState,DepthPrepass}, and then
+         *          @ref AbstractLayer::drawOpaque()
          *      -   Calls @ref AbstractRenderer::transition() with
          *          @ref RendererTargetState::Draw and appropriate
          *          @ref RendererDrawStates based on whether given layer
          *          advertises @ref LayerFeature::DrawUsesBlending or
-         *          @relativeref{LayerFeature,DrawUsesScissor}
+         *          @relativeref{LayerFeature,DrawUsesScissor} and whether the
+         *          renderer advertises @ref RendererFeature::DepthBuffer
          *      -   Calls @ref AbstractLayer::draw()
+         *      -   If the renderer advertises
+         *          @ref RendererFeature::DepthBuffer, the
+         *          @ref AbstractLayer::drawOpaque() and
+         *          @relativeref{AbstractLayer,draw()} calls are each preceded
+         *          by @ref AbstractRenderer::setDrawDepth() with a value
+         *          unique for each draw, decreasing in the back to front
+         *          order
+         *      -   If the renderer advertises
+         *          @ref RendererFeature::LayerProfiling, the
+         *          @ref AbstractLayer::composite() and
+         *          @relativeref{AbstractLayer,draw()} calls are each
+         *          surrounded by @ref AbstractRenderer::beginLayerProfile()
+         *          and @relativeref{AbstractRenderer,endLayerProfile()}
          * -    Calls @ref AbstractRenderer::transition() with
          *      @ref RendererTargetState::Final
+         *
+         * @see @ref drawSnapshot()
          */
         AbstractUserInterface& draw();
 
+        /**
+         * @brief Draw the user interface as prepared by the last update
+         * @return Reference to self (for method chaining)
+         *
+         * Performs the same as @ref draw() except for the implicit
+         * @ref update() call, drawing the state prepared by the last
+         * @ref update() instead. Any modifications done since then are
+         * reflected only after the next @ref update().
+         *
+         * The draw accesses only the renderer instance, layer instances and
+         * internal data prepared by @ref update(), not the node, layout,
+         * animator or data attachment state. It's thus possible to call this
+         * function on a dedicated rendering thread while the application
+         * thread modifies the UI for the next frame, for example with
+         * @ref setNodeOffset(), @ref setNodeFlags(), @ref createNode() or
+         * @ref attachData(), and then call @ref update() on the application
+         * thread once the draw finishes. The following isn't allowed while
+         * this function is running:
+         *
+         * -    Calling @ref update(), @ref clean(), @ref advanceAnimations()
+         *      or any event handling function, as they may update the
+         *      internal data or the layers
+         * -    Removing layers or setting a renderer instance
+         * -    Modifying data in any layer in a way that affects what the
+         *      layer's @ref AbstractLayer::draw() accesses. For the builtin
+         *      layers it's only what @ref AbstractLayer::update() prepares,
+         *      so layer data modifications are fine as well.
+         *
+         * Expects that a renderer instance is set.
+         */
+        AbstractUserInterface& drawSnapshot();
+
         /**
          * @brief Handle a pointer press event
          *
@@ -2622,6 +3497,14 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * propagated further; accept status of the enter and leave events is
          * ignored.
          *
+         * If @ref setPointerMoveEventCoalescing() is enabled and
+         * @ref PointerMoveEvent::pointer() is empty, the event is only queued
+         * and this function returns @cpp false @ce. The queued event is
+         * delivered as described above on the next
+         * @ref flushPointerMoveEvent(), which happens implicitly also at the
+         * start of @ref draw() and all other event handlers. The @p event
+         * instance isn't modified in that case.
+         *
          * Expects that the event is not accepted yet.
          * @see @ref PointerEvent::isAccepted(),
          *      @ref PointerEvent::setAccepted(), @ref currentPressedNode(),
@@ -2643,6 +3526,68 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
             return Implementation::PointerMoveEventConverter<Event>::move(*this, event, Utility::forward<Args>(args)...);
         }
 
+        /**
+         * @brief Whether pointer move event coalescing is enabled
+         * @m_since_latest
+         *
+         * @see @ref setPointerMoveEventCoalescing()
+         */
+        bool hasPointerMoveEventCoalescing() const;
+
+        /**
+         * @brief Set whether to coalesce pointer move events
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * High-frequency input devices can produce many move events per
+         * frame, each of which causes a node hit test and a dispatch to all
+         * data attached to the affected nodes. If enabled,
+         * @ref pointerMoveEvent() only queues events that don't change the set
+         * of pressed pointers. A subsequent move event with the same
+         * @ref PointerMoveEvent::source(), @relativeref{PointerMoveEvent,id()},
+         * @relativeref{PointerMoveEvent,isPrimary()} and
+         * @relativeref{PointerMoveEvent,pointers()} replaces the queued event,
+         * remembering the time and position of the replaced one, a move event
+         * that differs in any of those first delivers the queued event.
+         *
+         * The queued event is delivered with @ref flushPointerMoveEvent(),
+         * which is called implicitly at the start of @ref draw() and all other
+         * event handlers, thus at most one move event per pointer gets
+         * processed per frame while preserving the order relative to press,
+         * release and other events. The earlier positions are available
+         * through @ref PointerMoveEvent::coalescedCount(),
+         * @relativeref{PointerMoveEvent,coalescedTime()} and
+         * @relativeref{PointerMoveEvent,coalescedPosition()} for layers that
+         * need the full motion, such as drawing or gesture recognition.
+         * Default is @cpp false @ce.
+         *
+         * Disabling the coalescing implicitly calls
+         * @ref flushPointerMoveEvent().
+         */
+        AbstractUserInterface& setPointerMoveEventCoalescing(bool coalescing);
+
+        /**
+         * @brief Whether there's a pointer move event queued
+         * @m_since_latest
+         *
+         * Can be @cpp true @ce only if @ref setPointerMoveEventCoalescing() is
+         * enabled.
+         * @see @ref flushPointerMoveEvent()
+         */
+        bool hasPendingPointerMoveEvent() const;
+
+        /**
+         * @brief Deliver a queued pointer move event
+         * @m_since_latest
+         *
+         * If @ref hasPendingPointerMoveEvent() is @cpp true @ce, processes
+         * the queued event as described in @ref pointerMoveEvent() and
+         * returns whether it was accepted. Otherwise does nothing and returns
+         * @cpp false @ce.
+         * @see @ref setPointerMoveEventCoalescing()
+         */
+        bool flushPointerMoveEvent();
+
         /**
          * @brief Handle a scroll event
          *
@@ -2987,25 +3932,37 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
             const char* messagePrefix,
             #endif
             Containers::Pointer<AbstractAnimator>&& instance, Int type);
-        /* Used by removeNode(), advanceAnimations() and clean() */
+        /* Used by createNode() and createNodes() */
+        MAGNUM_UI_LOCAL NodeHandle createNodeInternal(
+            #ifndef CORRADE_NO_ASSERT
+            const char* messagePrefix,
+            #endif
+            NodeHandle parent, const Vector2& offset, const Vector2& size, NodeFlags flags);
+        /* Used by removeNode(), removeNodes(), advanceAnimations() and
+           clean() */
         MAGNUM_UI_LOCAL void removeNodeInternal(UnsignedInt id);
+        MAGNUM_UI_LOCAL void drawInternal();
+        /* Used by pointerMoveEvent() and flushPointerMoveEvent() */
+        MAGNUM_UI_LOCAL bool pointerMoveEventInternal(const Vector2& globalPosition, PointerMoveEvent& event);
         /* Used by setNodeFlags(), addNodeFlags() and clearNodeFlags() */
         MAGNUM_UI_LOCAL void setNodeFlagsInternal(UnsignedInt id, NodeFlags flags);
+        /* Used by setNodeOffset() and setNodeSize() */
+        MAGNUM_UI_LOCAL void setNodeLayoutDirtyInternal(UnsignedInt id);
         /* Used by removeNodeInternal(), setNodeOrder() and clearNodeOrder() */
         MAGNUM_UI_LOCAL bool clearNodeOrderInternal(NodeHandle handle);
         /* Used by *Event() functions */
         MAGNUM_UI_LOCAL void callVisibilityLostEventOnNode(NodeHandle node, VisibilityLostEvent& event, bool canBePressedOrHovering);
         template<void(AbstractLayer::*function)(UnsignedInt, FocusEvent&)> MAGNUM_UI_LOCAL bool callFocusEventOnNode(NodeHandle node, FocusEvent& event);
-        template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> MAGNUM_UI_LOCAL bool callKeyEventOnNode(NodeHandle node, KeyEvent& event);
+        template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, KeyEvent&)> MAGNUM_UI_LOCAL bool callKeyEventOnNode(NodeHandle node, KeyEvent& event);
         MAGNUM_UI_LOCAL bool callTextInputEventOnNode(NodeHandle node, TextInputEvent& event);
-        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> MAGNUM_UI_LOCAL bool callEventOnNode(const Vector2& globalPositionScaled, NodeHandle node, NodeHandle targetNode, Event& event, bool rememberCaptureOnUnaccepted = false);
-        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> MAGNUM_UI_LOCAL bool callEventOnNode(const Vector2& globalPositionScaled, NodeHandle node, Event& event, bool rememberCaptureOnUnaccepted = false) {
-            return callEventOnNode<Event, function>(globalPositionScaled, node, node, event, rememberCaptureOnUnaccepted);
+        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, Event&)> MAGNUM_UI_LOCAL bool callEventOnNode(const Vector2& globalPositionScaled, NodeHandle node, NodeHandle targetNode, Event& event, bool rememberCaptureOnUnaccepted = false);
+        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, Event&)> MAGNUM_UI_LOCAL bool callEventOnNode(const Vector2& globalPositionScaled, NodeHandle node, Event& event, bool rememberCaptureOnUnaccepted = false) {
+            return callEventOnNode<Event, function, batchFunction>(globalPositionScaled, node, node, event, rememberCaptureOnUnaccepted);
         }
-        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> MAGNUM_UI_LOCAL NodeHandle callEvent(const Vector2& globalPositionScaled, UnsignedInt visibleNodeIndex, Event& event);
-        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> MAGNUM_UI_LOCAL NodeHandle callEvent(const Vector2& globalPositionScaled, Event& event);
-        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> MAGNUM_UI_LOCAL void callFallthroughPointerEvents(NodeHandle node, const Vector2& globalPositionScaled, Event& event, bool allowCapture);
-        template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> MAGNUM_UI_LOCAL bool keyPressOrReleaseEvent(KeyEvent& event);
+        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, Event&)> MAGNUM_UI_LOCAL NodeHandle callEvent(const Vector2& globalPositionScaled, UnsignedInt visibleNodeIndex, Event& event);
+        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, Event&)> MAGNUM_UI_LOCAL NodeHandle callEvent(const Vector2& globalPositionScaled, Event& event);
+        template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, Event&)> MAGNUM_UI_LOCAL void callFallthroughPointerEvents(NodeHandle node, const Vector2& globalPositionScaled, Event& event, bool allowCapture);
+        template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&), void(AbstractLayer::*batchFunction)(const Containers::StridedArrayView1D<const UnsignedInt>&, KeyEvent&)> MAGNUM_UI_LOCAL bool keyPressOrReleaseEvent(KeyEvent& event);
 
         struct State;
         Containers::Pointer<State> _state;
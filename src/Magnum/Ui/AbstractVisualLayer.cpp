@@ -27,6 +27,7 @@
 #include "AbstractVisualLayer.h"
 
 #include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -36,6 +37,8 @@
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/Implementation/abstractVisualLayerState.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 
 namespace Magnum { namespace Ui {
 
@@ -81,26 +84,108 @@ UnsignedInt AbstractVisualLayer::Shared::totalStyleCount() const {
 }
 
 AbstractVisualLayer::Shared& AbstractVisualLayer::Shared::setStyleTransition(UnsignedInt(*const toInactiveOut)(UnsignedInt), UnsignedInt(*const toInactiveOver)(UnsignedInt), UnsignedInt(*const toFocusedOut)(UnsignedInt), UnsignedInt(*const toFocusedOver)(UnsignedInt), UnsignedInt(*const toPressedOut)(UnsignedInt), UnsignedInt(*const toPressedOver)(UnsignedInt), UnsignedInt(*const toDisabled)(UnsignedInt)) {
-    _state->styleTransitionToInactiveOut = toInactiveOut ? toInactiveOut :
+    State& state = *_state;
+    state.styleTransitions[Implementation::StyleTransitionToInactiveOut] = toInactiveOut ? toInactiveOut :
         Implementation::styleTransitionPassthrough;
-    _state->styleTransitionToInactiveOver = toInactiveOver ? toInactiveOver :
+    state.styleTransitions[Implementation::StyleTransitionToInactiveOver] = toInactiveOver ? toInactiveOver :
         Implementation::styleTransitionPassthrough;
-    _state->styleTransitionToFocusedOut = toFocusedOut ? toFocusedOut :
+    state.styleTransitions[Implementation::StyleTransitionToFocusedOut] = toFocusedOut ? toFocusedOut :
         Implementation::styleTransitionPassthrough;
-    _state->styleTransitionToFocusedOver = toFocusedOver ? toFocusedOver :
+    state.styleTransitions[Implementation::StyleTransitionToFocusedOver] = toFocusedOver ? toFocusedOver :
         Implementation::styleTransitionPassthrough;
-    _state->styleTransitionToPressedOut = toPressedOut ? toPressedOut :
+    state.styleTransitions[Implementation::StyleTransitionToPressedOut] = toPressedOut ? toPressedOut :
         Implementation::styleTransitionPassthrough;
-    _state->styleTransitionToPressedOver = toPressedOver ? toPressedOver :
+    state.styleTransitions[Implementation::StyleTransitionToPressedOver] = toPressedOver ? toPressedOver :
         Implementation::styleTransitionPassthrough;
     /* Unlike the others, this one can be nullptr, in which case the whole
        transitioning logic in doUpdate() gets replaced with a simple copy.
-       Setting it to a different function then causes doState() in all layers
-       sharing this state return NeedsDataUpdate. */
-    if(_state->styleTransitionToDisabled != toDisabled) {
-        _state->styleTransitionToDisabled = toDisabled;
-        ++_state->styleTransitionToDisabledUpdateStamp;
+       Setting it to a different function, or switching from tables back to
+       functions, then causes doState() in all layers sharing this state
+       return NeedsDataUpdate. */
+    if(state.styleTransitions[Implementation::StyleTransitionToDisabled] != toDisabled || !state.styleTransitionTables.isEmpty()) {
+        state.styleTransitions[Implementation::StyleTransitionToDisabled] = toDisabled;
+        ++state.styleTransitionToDisabledUpdateStamp;
+    }
+    state.styleTransitionTables = {};
+    state.styleTransitionTablesToDisabled = false;
+    return *this;
+}
+
+AbstractVisualLayer::Shared& AbstractVisualLayer::Shared::setStyleTransitionTables(const Containers::ArrayView<const UnsignedInt> toInactiveOut, const Containers::ArrayView<const UnsignedInt> toInactiveOver, const Containers::ArrayView<const UnsignedInt> toFocusedOut, const Containers::ArrayView<const UnsignedInt> toFocusedOver, const Containers::ArrayView<const UnsignedInt> toPressedOut, const Containers::ArrayView<const UnsignedInt> toPressedOver, const Containers::ArrayView<const UnsignedInt> toDisabled) {
+    State& state = *_state;
+    const UnsignedInt styleCount = state.styleCount;
+    const Containers::ArrayView<const UnsignedInt> tables[]{
+        toInactiveOut,
+        toInactiveOver,
+        toFocusedOut,
+        toFocusedOver,
+        toPressedOut,
+        toPressedOver,
+        toDisabled
+    };
+    #ifndef CORRADE_NO_ASSERT
+    const char* const names[]{
+        "toInactiveOut",
+        "toInactiveOver",
+        "toFocusedOut",
+        "toFocusedOver",
+        "toPressedOut",
+        "toPressedOver",
+        "toDisabled"
+    };
+    for(std::size_t i = 0; i != Implementation::StyleTransitionCount; ++i) {
+        CORRADE_ASSERT(tables[i].isEmpty() || tables[i].size() == styleCount,
+            "Ui::AbstractVisualLayer::Shared::setStyleTransitionTables(): expected" << names[i] << "to have either no items or" << styleCount << "but got" << tables[i].size(), *this);
+        for(std::size_t j = 0; j != tables[i].size(); ++j)
+            CORRADE_ASSERT(tables[i][j] < styleCount,
+                "Ui::AbstractVisualLayer::Shared::setStyleTransitionTables():" << names[i] << "transition from" << j << "to" << tables[i][j] << "out of range for" << styleCount << "styles", *this);
+    }
+    #endif
+
+    /* Empty tables are an identity. The disabled table is left unfilled in
+       that case, as doUpdate() skips the transition altogether. */
+    Containers::Array<UnsignedInt> out{NoInit, Implementation::StyleTransitionCount*styleCount};
+    for(std::size_t i = 0; i != Implementation::StyleTransitionCount; ++i) {
+        const Containers::ArrayView<UnsignedInt> dst = out.sliceSize(i*styleCount, styleCount);
+        if(!tables[i].isEmpty())
+            Utility::copy(tables[i], dst);
+        else for(UnsignedInt j = 0; j != styleCount; ++j)
+            dst[j] = j;
+    }
+
+    /* The disabled transition is assumed to be always different, causing
+       doState() in all layers sharing this state return NeedsDataUpdate */
+    state.styleTransitionTables = Utility::move(out);
+    state.styleTransitionTablesToDisabled = !toDisabled.isEmpty();
+    state.styleTransitions[Implementation::StyleTransitionToDisabled] = nullptr;
+    ++state.styleTransitionToDisabledUpdateStamp;
+    return *this;
+}
+
+AbstractVisualLayer::Shared& AbstractVisualLayer::Shared::bakeStyleTransitions() {
+    State& state = *_state;
+    const UnsignedInt styleCount = state.styleCount;
+
+    /* If already baked, nothing to do */
+    if(!state.styleTransitionTables.isEmpty())
+        return *this;
+
+    Containers::Array<UnsignedInt> out{NoInit, Implementation::StyleTransitionCount*styleCount};
+    const bool toDisabled = state.styleTransitions[Implementation::StyleTransitionToDisabled] != nullptr;
+    for(std::size_t i = 0; i != Implementation::StyleTransitionCount - (toDisabled ? 0 : 1); ++i) {
+        UnsignedInt(*const transition)(UnsignedInt) = state.styleTransitions[i];
+        for(UnsignedInt j = 0; j != styleCount; ++j) {
+            const UnsignedInt style = transition(j);
+            CORRADE_ASSERT(style < styleCount,
+                "Ui::AbstractVisualLayer::Shared::bakeStyleTransitions(): style transition from" << j << "to" << style << "out of range for" << styleCount << "styles", *this);
+            out[i*styleCount + j] = style;
+        }
     }
+
+    /* The transition results are the same as before, so there's no need to
+       make the layers update the disabled styles */
+    state.styleTransitionTables = Utility::move(out);
+    state.styleTransitionTablesToDisabled = toDisabled;
     return *this;
 }
 
@@ -166,6 +251,53 @@ void AbstractVisualLayer::setStyleInternal(const UnsignedInt id, const UnsignedI
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+void AbstractVisualLayer::setStyle(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const UnsignedInt>& styles) {
+    CORRADE_ASSERT(styles.size() == handles.size(),
+        "Ui::AbstractVisualLayer::setStyle(): expected handle and style views to have the same size but got" << handles.size() << "and" << styles.size(), );
+    /* Check all handles first to not end up with just a part of the data
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i) {
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractVisualLayer::setStyle(): invalid handle" << handles[i] << "at index" << i, );
+        CORRADE_ASSERT(styles[i] < _state->shared.styleCount + _state->shared.dynamicStyleCount,
+            "Ui::AbstractVisualLayer::setStyle(): style" << styles[i] << "at index" << i << "out of range for" << _state->shared.styleCount + _state->shared.dynamicStyleCount << "styles", );
+    }
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    CORRADE_INTERNAL_DEBUG_ASSERT(_state->styles.size() == capacity());
+    /* _state->calculatedStyles is filled by AbstractVisualLayer::doUpdate() */
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        _state->styles[dataHandleId(handles[i])] = styles[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void AbstractVisualLayer::setStyle(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const UnsignedInt>& styles) {
+    CORRADE_ASSERT(styles.size() == handles.size(),
+        "Ui::AbstractVisualLayer::setStyle(): expected handle and style views to have the same size but got" << handles.size() << "and" << styles.size(), );
+    /* Same as above */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i) {
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractVisualLayer::setStyle(): invalid handle" << handles[i] << "at index" << i, );
+        CORRADE_ASSERT(styles[i] < _state->shared.styleCount + _state->shared.dynamicStyleCount,
+            "Ui::AbstractVisualLayer::setStyle(): style" << styles[i] << "at index" << i << "out of range for" << _state->shared.styleCount + _state->shared.dynamicStyleCount << "styles", );
+    }
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    CORRADE_INTERNAL_DEBUG_ASSERT(_state->styles.size() == capacity());
+    /* _state->calculatedStyles is filled by AbstractVisualLayer::doUpdate() */
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        _state->styles[layerDataHandleId(handles[i])] = styles[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 void AbstractVisualLayer::setTransitionedStyle(const AbstractUserInterface& ui, const DataHandle handle, const UnsignedInt style) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractVisualLayer::setTransitionedStyle(): invalid handle" << handle, );
@@ -189,17 +321,17 @@ void AbstractVisualLayer::setTransitionedStyleInternal(const AbstractUserInterfa
     const Shared::State& sharedState = state.shared;
     const NodeHandle node = this->node(handle);
     const bool hovered = ui.currentHoveredNode() == node;
-    UnsignedInt(*transition)(UnsignedInt);
+    std::size_t transition;
     if(ui.currentPressedNode() == node) transition = hovered ?
-        sharedState.styleTransitionToPressedOver :
-        sharedState.styleTransitionToPressedOut;
+        Implementation::StyleTransitionToPressedOver :
+        Implementation::StyleTransitionToPressedOut;
     else if(ui.currentFocusedNode() == node) transition = hovered ?
-        sharedState.styleTransitionToFocusedOver :
-        sharedState.styleTransitionToFocusedOut;
+        Implementation::StyleTransitionToFocusedOver :
+        Implementation::StyleTransitionToFocusedOut;
     else transition = hovered ?
-        sharedState.styleTransitionToInactiveOver :
-        sharedState.styleTransitionToInactiveOut;
-    state.styles[layerDataHandleId(handle)] = transition(style);
+        Implementation::StyleTransitionToInactiveOver :
+        Implementation::StyleTransitionToInactiveOut;
+    state.styles[layerDataHandleId(handle)] = sharedState.styleTransition(transition, style);
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
@@ -209,16 +341,16 @@ UnsignedInt AbstractVisualLayer::dynamicStyleUsedCount() const {
 
 Containers::Optional<UnsignedInt> AbstractVisualLayer::allocateDynamicStyle(const AnimationHandle animation) {
     State& state = *_state;
-    /** @todo some builtin "find first unset" API, tzcnt etc */
-    for(std::size_t i = 0; i != state.dynamicStylesUsed.size(); ++i) {
-        if(state.dynamicStylesUsed[i])
-            continue;
-        state.dynamicStylesUsed.set(i);
-        state.dynamicStyleAnimations[i] = animation;
-        return i;
+    const std::size_t id = Implementation::firstUnsetBit(state.dynamicStylesUsed, state.dynamicStyleFreeHint);
+    if(id == state.dynamicStylesUsed.size()) {
+        state.dynamicStyleFreeHint = id;
+        return {};
     }
 
-    return {};
+    state.dynamicStylesUsed.set(id);
+    state.dynamicStyleAnimations[id] = animation;
+    state.dynamicStyleFreeHint = id + 1;
+    return id;
 }
 
 AnimationHandle AbstractVisualLayer::dynamicStyleAnimation(const UnsignedInt id) const {
@@ -228,6 +360,15 @@ AnimationHandle AbstractVisualLayer::dynamicStyleAnimation(const UnsignedInt id)
     return state.dynamicStyleAnimations[id];
 }
 
+void AbstractVisualLayer::setDynamicStyleAnimation(const UnsignedInt id, const AnimationHandle animation) {
+    State& state = *_state;
+    CORRADE_ASSERT(id < state.dynamicStylesUsed.size(),
+        "Ui::AbstractVisualLayer::setDynamicStyleAnimation(): index" << id << "out of range for" << state.dynamicStylesUsed.size() << "dynamic styles", );
+    CORRADE_ASSERT(state.dynamicStylesUsed[id],
+        "Ui::AbstractVisualLayer::setDynamicStyleAnimation(): style" << id << "not allocated", );
+    state.dynamicStyleAnimations[id] = animation;
+}
+
 void AbstractVisualLayer::recycleDynamicStyle(const UnsignedInt id) {
     State& state = *_state;
     CORRADE_ASSERT(id < state.dynamicStylesUsed.size(),
@@ -236,6 +377,7 @@ void AbstractVisualLayer::recycleDynamicStyle(const UnsignedInt id) {
         "Ui::AbstractVisualLayer::recycleDynamicStyle(): style" << id << "not allocated", );
     state.dynamicStylesUsed.reset(id);
     state.dynamicStyleAnimations[id] = AnimationHandle::Null;
+    state.dynamicStyleFreeHint = Math::min(state.dynamicStyleFreeHint, id);
 }
 
 AbstractVisualLayer& AbstractVisualLayer::assignAnimator(AbstractVisualLayerStyleAnimator& animator) {
@@ -264,6 +406,31 @@ LayerFeatures AbstractVisualLayer::doFeatures() const {
     return LayerFeature::Event;
 }
 
+LayerEvents AbstractVisualLayer::doEvents() const {
+    return LayerEvent::Pointer|LayerEvent::PointerMove|LayerEvent::Focus;
+}
+
+MemoryUsage AbstractVisualLayer::doMemoryUsage() const {
+    const State& state = *_state;
+    MemoryUsage out{};
+    Implementation::addArrayMemoryUsage(out, state.dynamicStyleStorage);
+    Implementation::addArrayMemoryUsage(out, state.styleChangedDataIds);
+    return out;
+}
+
+void AbstractVisualLayer::doTrim(const std::size_t capacity) {
+    State& state = *_state;
+
+    /* Data whose style changed may have been removed since, remove IDs that
+       are no longer in range */
+    std::size_t count = 0;
+    for(const UnsignedInt id: state.styleChangedDataIds)
+        if(id < capacity)
+            state.styleChangedDataIds[count++] = id;
+    arrayResize(state.styleChangedDataIds, count);
+    arrayShrink(state.styleChangedDataIds);
+}
+
 LayerStates AbstractVisualLayer::doState() const {
     const State& state = *_state;
     const Shared::State& sharedState = state.shared;
@@ -285,55 +452,74 @@ void AbstractVisualLayer::doUpdate(const LayerStates states, const Containers::S
 
        Do this only if the data changed (i.e., possibly including style
        assignment) or if the node enablement changed. */
-    if(states & (LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsDataUpdate)) {
-        const Shared::State& sharedState = state.shared;
-        if(UnsignedInt(*const toDisabled)(UnsignedInt) = sharedState.styleTransitionToDisabled) {
-            const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
-            const UnsignedInt styleCount = sharedState.styleCount;
-            for(const UnsignedInt id: dataIds) {
-                const UnsignedInt style = state.styles[id];
-
-                /* If the style is dynamic, maybe it has an animation with a
-                   target style index assigned, which we can use as the
-                   (soon-to-be-)current style index to transition from. */
-                const UnsignedInt currentStyle = styleOrAnimationTargetStyle(style);
-
-                /** @todo Doing a function call for all data may be a bit
-                    horrible, also especially if the code inside is a giant
-                    switch that the compiler failed to turn into a LUT. Thus,
-                    ideally, the transition should be done only for nodes that
-                    actually changed their disabled status, which means
-                    recording the previous nodesEnabled state, XORing the
-                    current with it, and then performing transition only when
-                    the XOR is 1. Furthermore, that may often be just a very
-                    tiny portion of nodes, so ideally there would be a way to
-                    quickly get just the subset of *data* IDs that actually
-                    changed (and not node IDs), to iterate over them
-                    directly. */
-                /* Skipping data that have dynamic styles, those are
-                   passthrough */
-                if(currentStyle < styleCount && !nodesEnabled[nodeHandleId(nodes[id])]) {
-                    const UnsignedInt nextStyle = toDisabled(currentStyle);
-                    /** @todo a debug assert? or is it negligible compared to
-                        the function call? */
-                    CORRADE_ASSERT(nextStyle < styleCount,
-                        "Ui::AbstractVisualLayer::update(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << styleCount << "styles", );
-                    state.calculatedStyles[id] = nextStyle;
-                } else {
-                    CORRADE_INTERNAL_DEBUG_ASSERT(style < sharedState.styleCount + sharedState.dynamicStyleCount);
-                    state.calculatedStyles[id] = style;
-                }
+    const Shared::State& sharedState = state.shared;
+    const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+    const auto calculateStyles = [&](const Containers::StridedArrayView1D<const UnsignedInt>& ids) {
+        const UnsignedInt styleCount = sharedState.styleCount;
+        for(const UnsignedInt id: ids) {
+            const UnsignedInt style = state.styles[id];
+
+            /* If the style is dynamic, maybe it has an animation with a target
+               style index assigned, which we can use as the
+               (soon-to-be-)current style index to transition from. */
+            const UnsignedInt currentStyle = styleOrAnimationTargetStyle(style);
+
+            /** @todo Doing a function call for all data may be a bit
+                horrible, also especially if the code inside is a giant switch
+                that the compiler failed to turn into a LUT. Thus, ideally, the
+                transition should be done only for nodes that actually changed
+                their disabled status, which means recording the previous
+                nodesEnabled state, XORing the current with it, and then
+                performing transition only when the XOR is 1. Furthermore, that
+                may often be just a very tiny portion of nodes, so ideally
+                there would be a way to quickly get just the subset of *data*
+                IDs that actually changed (and not node IDs), to iterate over
+                them directly. */
+            /* Skipping data that have dynamic styles, those are
+               passthrough */
+            if(currentStyle < styleCount && !nodesEnabled[nodeHandleId(nodes[id])]) {
+                /* With baked transition tables this is just a lookup, and
+                   the tables are range-checked already */
+                const UnsignedInt nextStyle = sharedState.styleTransition(Implementation::StyleTransitionToDisabled, currentStyle);
+                /** @todo a debug assert? or is it negligible compared to the
+                    function call? */
+                CORRADE_ASSERT(nextStyle < styleCount,
+                    "Ui::AbstractVisualLayer::update(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << styleCount << "styles", );
+                state.calculatedStyles[id] = nextStyle;
+            } else {
+                CORRADE_INTERNAL_DEBUG_ASSERT(style < sharedState.styleCount + sharedState.dynamicStyleCount);
+                state.calculatedStyles[id] = style;
             }
+        }
+    };
+    if(states & (LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsDataUpdate)) {
+        if(sharedState.hasStyleTransitionToDisabled())
+            calculateStyles(dataIds);
 
         /* If the transition function isn't set -- i.e., the transition is an
            identity --, just copy them over. The subclass doUpdate() / doDraw() is
            then assumed to handle that on its own, for example by applying
            desaturation and fade out globally to all data. */
-        } else Utility::copy(state.styles, state.calculatedStyles);
+        else Utility::copy(state.styles, state.calculatedStyles);
 
         /* Sync the style transition update stamp to not have doState() return
            NeedsDataUpdate again next time it's asked */
         state.styleTransitionToDisabledUpdateStamp = sharedState.styleTransitionToDisabledUpdateStamp;
+
+    /* If just styles of a few data changed in event style transitions,
+       calculate only those. Data that got removed or detached since are
+       filtered out of the list so the subclass doesn't need to check again. */
+    } else if(states >= LayerState::NeedsDataStyleUpdate) {
+        std::size_t count = 0;
+        for(const UnsignedInt id: state.styleChangedDataIds)
+            if(nodes[id] != NodeHandle::Null)
+                state.styleChangedDataIds[count++] = id;
+        arrayResize(state.styleChangedDataIds, count);
+
+        if(sharedState.hasStyleTransitionToDisabled())
+            calculateStyles(stridedArrayView(state.styleChangedDataIds));
+        else for(const UnsignedInt id: state.styleChangedDataIds)
+            state.calculatedStyles[id] = state.styles[id];
     }
 }
 
@@ -357,6 +543,16 @@ UnsignedInt AbstractVisualLayer::styleOrAnimationTargetStyle(const UnsignedInt s
     return style;
 }
 
+void AbstractVisualLayer::styleTransitionedInternal(const UnsignedInt id) {
+    State& state = *_state;
+    /* If the subclass can patch styles of just a subset of data, remember
+       which data changed, otherwise trigger a full data update */
+    if(state.dataStyleUpdates) {
+        arrayAppend(state.styleChangedDataIds, id);
+        setNeedsUpdate(LayerState::NeedsDataStyleUpdate);
+    } else setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 void AbstractVisualLayer::doPointerPressEvent(const UnsignedInt dataId, PointerEvent& event) {
     /* Not dealing with fallthrough events; only reacting to primary pointer
        types typically used to click/tap on things */
@@ -383,17 +579,17 @@ void AbstractVisualLayer::doPointerPressEvent(const UnsignedInt dataId, PointerE
            touches, or if move events aren't propagated from the
            application). Pressed state has a priority over focused state, so
            isNodeFocused() is ignored in this case. */
-        UnsignedInt(*const transition)(UnsignedInt) = event.isNodeHovered() ?
-            sharedState.styleTransitionToPressedOver :
-            sharedState.styleTransitionToPressedOut;
-        const UnsignedInt nextStyle = transition(currentStyle);
+        const std::size_t transition = event.isNodeHovered() ?
+            Implementation::StyleTransitionToPressedOver :
+            Implementation::StyleTransitionToPressedOut;
+        const UnsignedInt nextStyle = sharedState.styleTransition(transition, currentStyle);
         CORRADE_ASSERT(nextStyle < sharedState.styleCount,
             "Ui::AbstractVisualLayer::pointerPressEvent(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << sharedState.styleCount << "styles", );
         /* If the transitioned style is different from the current one (or the
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            styleTransitionedInternal(dataId);
         }
     }
 
@@ -425,21 +621,21 @@ void AbstractVisualLayer::doPointerReleaseEvent(const UnsignedInt dataId, Pointe
            move event (such as for pointer types that don't support hover like
            touches, or if move events aren't propagated from the
            application) */
-        UnsignedInt(*const transition)(UnsignedInt) = event.isNodeFocused() ?
+        const std::size_t transition = event.isNodeFocused() ?
             event.isNodeHovered() ?
-                sharedState.styleTransitionToFocusedOver :
-                sharedState.styleTransitionToFocusedOut :
+                Implementation::StyleTransitionToFocusedOver :
+                Implementation::StyleTransitionToFocusedOut :
             event.isNodeHovered() ?
-                sharedState.styleTransitionToInactiveOver :
-                sharedState.styleTransitionToInactiveOut;
-        const UnsignedInt nextStyle = transition(currentStyle);
+                Implementation::StyleTransitionToInactiveOver :
+                Implementation::StyleTransitionToInactiveOut;
+        const UnsignedInt nextStyle = sharedState.styleTransition(transition, currentStyle);
         CORRADE_ASSERT(nextStyle < sharedState.styleCount,
             "Ui::AbstractVisualLayer::pointerReleaseEvent(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << sharedState.styleCount << "styles", );
         /* If the transitioned style is different from the current one (or the
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            styleTransitionedInternal(dataId);
         }
     }
 
@@ -473,18 +669,18 @@ void AbstractVisualLayer::doPointerEnterEvent(const UnsignedInt dataId, PointerM
 
     /* Transition the style to over if it's not dynamic */
     if(currentStyle < sharedState.styleCount) {
-        UnsignedInt(*const transition)(UnsignedInt) = event.isCaptured() ?
-            sharedState.styleTransitionToPressedOver : event.isNodeFocused() ?
-                sharedState.styleTransitionToFocusedOver :
-                sharedState.styleTransitionToInactiveOver;
-        const UnsignedInt nextStyle = transition(currentStyle);
+        const std::size_t transition = event.isCaptured() ?
+            Implementation::StyleTransitionToPressedOver : event.isNodeFocused() ?
+                Implementation::StyleTransitionToFocusedOver :
+                Implementation::StyleTransitionToInactiveOver;
+        const UnsignedInt nextStyle = sharedState.styleTransition(transition, currentStyle);
         CORRADE_ASSERT(nextStyle < sharedState.styleCount,
             "Ui::AbstractVisualLayer::pointerEnterEvent(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << sharedState.styleCount << "styles", );
         /* If the transitioned style is different from the current one (or the
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            styleTransitionedInternal(dataId);
         }
     }
 }
@@ -506,18 +702,18 @@ void AbstractVisualLayer::doPointerLeaveEvent(const UnsignedInt dataId, PointerM
 
     /* Transition the style to out if it's not dynamic */
     if(currentStyle < sharedState.styleCount) {
-        UnsignedInt(*const transition)(UnsignedInt) = event.isCaptured() ?
-            sharedState.styleTransitionToPressedOut : event.isNodeFocused() ?
-                sharedState.styleTransitionToFocusedOut :
-                sharedState.styleTransitionToInactiveOut;
-        const UnsignedInt nextStyle = transition(currentStyle);
+        const std::size_t transition = event.isCaptured() ?
+            Implementation::StyleTransitionToPressedOut : event.isNodeFocused() ?
+                Implementation::StyleTransitionToFocusedOut :
+                Implementation::StyleTransitionToInactiveOut;
+        const UnsignedInt nextStyle = sharedState.styleTransition(transition, currentStyle);
         CORRADE_ASSERT(nextStyle < sharedState.styleCount,
             "Ui::AbstractVisualLayer::pointerLeaveEvent(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << sharedState.styleCount << "styles", );
         /* If the transitioned style is different from the current one (or the
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            styleTransitionedInternal(dataId);
         }
     }
 }
@@ -535,14 +731,14 @@ void AbstractVisualLayer::doPointerCancelEvent(const UnsignedInt dataId, Pointer
 
     /* Transition the style to inactive out if it's not dynamic */
     if(currentStyle < sharedState.styleCount) {
-        const UnsignedInt nextStyle = sharedState.styleTransitionToInactiveOut(currentStyle);
+        const UnsignedInt nextStyle = sharedState.styleTransition(Implementation::StyleTransitionToInactiveOut, currentStyle);
         CORRADE_ASSERT(nextStyle < sharedState.styleCount,
             "Ui::AbstractVisualLayer::pointerCancelEvent(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << sharedState.styleCount << "styles", );
         /* If the transitioned style is different from the current one (or the
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            styleTransitionedInternal(dataId);
         }
     }
 }
@@ -561,17 +757,17 @@ void AbstractVisualLayer::doFocusEvent(const UnsignedInt dataId, FocusEvent& eve
     /* Transition the style to focused if it's not dynamic and only if it's not
        pressed as well, as pressed style gets a priority. */
     if(currentStyle < sharedState.styleCount && !event.isNodePressed()) {
-        UnsignedInt(*const transition)(UnsignedInt) = event.isNodeHovered() ?
-            sharedState.styleTransitionToFocusedOver :
-            sharedState.styleTransitionToFocusedOut;
-        const UnsignedInt nextStyle = transition(currentStyle);
+        const std::size_t transition = event.isNodeHovered() ?
+            Implementation::StyleTransitionToFocusedOver :
+            Implementation::StyleTransitionToFocusedOut;
+        const UnsignedInt nextStyle = sharedState.styleTransition(transition, currentStyle);
         CORRADE_ASSERT(nextStyle < sharedState.styleCount,
             "Ui::AbstractVisualLayer::focusEvent(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << sharedState.styleCount << "styles", );
         /* If the transitioned style is different from the current one (or the
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            styleTransitionedInternal(dataId);
         }
     }
 
@@ -592,17 +788,17 @@ void AbstractVisualLayer::doBlurEvent(const UnsignedInt dataId, FocusEvent& even
     /* Transition the style to blurred if it's not dynamic and only if it's not
        pressed as well, as pressed style gets a priority. */
     if(currentStyle < sharedState.styleCount && !event.isNodePressed()) {
-        UnsignedInt(*const transition)(UnsignedInt) = event.isNodeHovered() ?
-            sharedState.styleTransitionToInactiveOver :
-            sharedState.styleTransitionToInactiveOut;
-        const UnsignedInt nextStyle = transition(currentStyle);
+        const std::size_t transition = event.isNodeHovered() ?
+            Implementation::StyleTransitionToInactiveOver :
+            Implementation::StyleTransitionToInactiveOut;
+        const UnsignedInt nextStyle = sharedState.styleTransition(transition, currentStyle);
         CORRADE_ASSERT(nextStyle < sharedState.styleCount,
             "Ui::AbstractVisualLayer::blurEvent(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << sharedState.styleCount << "styles", );
         /* If the transitioned style is different from the current one (or the
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            styleTransitionedInternal(dataId);
         }
     }
 
@@ -624,17 +820,17 @@ void AbstractVisualLayer::doVisibilityLostEvent(const UnsignedInt dataId, Visibi
        not a formerly focused node that's now pressed, in which case it stays
        pressed. */
     if(currentStyle < sharedState.styleCount && !event.isNodePressed()) {
-        UnsignedInt(*const transition)(UnsignedInt) = event.isNodeHovered() ?
-            sharedState.styleTransitionToInactiveOver :
-            sharedState.styleTransitionToInactiveOut;
-        const UnsignedInt nextStyle = transition(currentStyle);
+        const std::size_t transition = event.isNodeHovered() ?
+            Implementation::StyleTransitionToInactiveOver :
+            Implementation::StyleTransitionToInactiveOut;
+        const UnsignedInt nextStyle = sharedState.styleTransition(transition, currentStyle);
         CORRADE_ASSERT(nextStyle < sharedState.styleCount,
             "Ui::AbstractVisualLayer::visibilityLostEvent(): style transition from" << currentStyle << "to" << nextStyle << "out of range for" << sharedState.styleCount << "styles", );
         /* If the transitioned style is different from the current one (or the
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            styleTransitionedInternal(dataId);
         }
     }
 }
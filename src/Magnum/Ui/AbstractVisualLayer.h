@@ -170,6 +170,30 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer: public AbstractLayer {
             setStyle(handle, UnsignedInt(style));
         }
 
+        /**
+         * @brief Set style indices of multiple data
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setStyle(DataHandle, UnsignedInt) for
+         * each item in @p handles and @p styles, but with the layer marked
+         * with @ref LayerState::NeedsDataUpdate just once and only if
+         * @p handles is non-empty. Expects that the @p handles and @p styles
+         * views have the same size, that all styles are less than
+         * @ref Shared::totalStyleCount() and that all handles are valid. The
+         * handles are all checked before anything is updated.
+         */
+        void setStyle(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const UnsignedInt>& styles);
+
+        /**
+         * @brief Set style indices of multiple data assuming they belong to this layer
+         * @m_since_latest
+         *
+         * Like @ref setStyle(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StridedArrayView1D<const UnsignedInt>&)
+         * but without checking that @p handles indeed belong to this layer.
+         * See its documentation for more information.
+         */
+        void setStyle(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const UnsignedInt>& styles);
+
         /**
          * @brief Set data style index, potentially transitioning it based on user interface state
          *
@@ -285,6 +309,20 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer: public AbstractLayer {
          */
         AnimationHandle dynamicStyleAnimation(UnsignedInt id) const;
 
+        /**
+         * @brief Associate a dynamic style with a different animation
+         * @m_since_latest
+         *
+         * Expects that @p id is less than @ref Shared::dynamicStyleCount()
+         * and that it was returned from @ref allocateDynamicStyle() earlier
+         * and not recycled since. Used by style animators that share a single
+         * dynamic style among several animations, to reassociate it with
+         * another of them when the original animation is removed. No
+         * validation is performed on the handle, it can be arbitrary.
+         * @see @ref dynamicStyleAnimation()
+         */
+        void setDynamicStyleAnimation(UnsignedInt id, AnimationHandle animation);
+
         /**
          * @brief Recycle a dynamic style index
          *
@@ -317,27 +355,44 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer: public AbstractLayer {
         /* Can't be MAGNUM_UI_LOCAL otherwise deriving from this class in
            tests causes linker errors */
         LayerFeatures doFeatures() const override;
+        /* Pointer, hover and focus events for style transitions, no scroll,
+           key or text input */
+        LayerEvents doEvents() const override;
         LayerStates doState() const override;
+        /* Reports the dynamic style and style change storage. Should be
+           called by subclasses. */
+        MemoryUsage doMemoryUsage() const override;
+        /* Drops style changes of trimmed data. Should be called by
+           subclasses, which are expected to resize their data and update the
+           styles and calculatedStyles views afterwards. */
+        void doTrim(std::size_t capacity) override;
 
         /* Updates State::Shared::calculatedStyles based on which nodes are
            enabled. Should be called by subclasses. */
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
 
+        /* Perform style transitions and accept the events. Should be called
+           by subclasses that handle pointer input on their own, which can
+           then check event.isAccepted() to know whether to react. Can't be
+           MAGNUM_UI_LOCAL otherwise deriving from this class in tests causes
+           linker errors. */
+        void doPointerPressEvent(UnsignedInt dataId, PointerEvent& event) override;
+        void doPointerReleaseEvent(UnsignedInt dataId, PointerEvent& event) override;
+        void doPointerMoveEvent(UnsignedInt dataId, PointerMoveEvent& event) override;
+        void doPointerCancelEvent(UnsignedInt dataId, PointerCancelEvent& event) override;
+
         Containers::Pointer<State> _state;
 
     private:
         MAGNUM_UI_LOCAL void setStyleInternal(UnsignedInt id, UnsignedInt style);
         MAGNUM_UI_LOCAL void setTransitionedStyleInternal(const AbstractUserInterface& ui, LayerDataHandle handle, UnsignedInt style);
         MAGNUM_UI_LOCAL UnsignedInt styleOrAnimationTargetStyle(UnsignedInt style) const;
+        MAGNUM_UI_LOCAL void styleTransitionedInternal(UnsignedInt id);
 
         /* Can't be MAGNUM_UI_LOCAL otherwise deriving from this class in
            tests causes linker errors */
-        void doPointerPressEvent(UnsignedInt dataId, PointerEvent& event) override;
-        void doPointerReleaseEvent(UnsignedInt dataId, PointerEvent& event) override;
-        void doPointerMoveEvent(UnsignedInt dataId, PointerMoveEvent& event) override;
         void doPointerEnterEvent(UnsignedInt dataId, PointerMoveEvent& event) override;
         void doPointerLeaveEvent(UnsignedInt dataId, PointerMoveEvent& event) override;
-        void doPointerCancelEvent(UnsignedInt dataId, PointerCancelEvent& event) override;
         void doFocusEvent(UnsignedInt dataId, FocusEvent& event) override;
         void doBlurEvent(UnsignedInt dataId, FocusEvent& event) override;
         void doVisibilityLostEvent(UnsignedInt dataId, VisibilityLostEvent& event) override;
@@ -524,6 +579,49 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer::Shared {
             return setStyleTransition<StyleIndex, toInactive, toInactive, toFocused, toFocused, toPressed, toPressed, toDisabled>();
         }
 
+        /**
+         * @brief Set style transition lookup tables
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Alternative to @ref setStyleTransition() "setStyleTransition(UnsignedInt(*)(UnsignedInt), UnsignedInt(*)(UnsignedInt), UnsignedInt(*)(UnsignedInt), UnsignedInt(*)(UnsignedInt), UnsignedInt(*)(UnsignedInt), UnsignedInt(*)(UnsignedInt), UnsignedInt(*)(UnsignedInt))"
+         * where each transition is described by a table mapping a style
+         * index to the transitioned one instead of a function. Transitions in
+         * event handlers and in @ref AbstractLayer::update() are then a plain
+         * lookup without any indirect function call. Each table is expected
+         * to be either empty, in which case given transition is a no-op, or
+         * have exactly @ref styleCount() items, each less than
+         * @ref styleCount(). The contents are copied, the views don't need to
+         * stay alive after the call. The same rules as for the transition
+         * functions apply otherwise.
+         *
+         * Calling this function causes @ref LayerState::NeedsDataUpdate to be
+         * set on all layers that are constructed using this shared instance.
+         * A subsequent call to @ref setStyleTransition() replaces the tables
+         * with functions again.
+         * @see @ref bakeStyleTransitions()
+         */
+        Shared& setStyleTransitionTables(Containers::ArrayView<const UnsignedInt> toInactiveOut, Containers::ArrayView<const UnsignedInt> toInactiveOver, Containers::ArrayView<const UnsignedInt> toFocusedOut, Containers::ArrayView<const UnsignedInt> toFocusedOver, Containers::ArrayView<const UnsignedInt> toPressedOut, Containers::ArrayView<const UnsignedInt> toPressedOver, Containers::ArrayView<const UnsignedInt> toDisabled);
+
+        /**
+         * @brief Bake style transition functions into lookup tables
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Calls each function passed to @ref setStyleTransition() for all
+         * @ref styleCount() style indices once and uses the results in the
+         * same way as if they were passed to @ref setStyleTransitionTables().
+         * Expects that all functions return an index less than
+         * @ref styleCount(). Useful if the functions are expensive or the
+         * transitions happen often, but note that the functions are then
+         * called also for styles that never get transitioned. If the tables
+         * are baked already, the function does nothing.
+         *
+         * Unlike @ref setStyleTransitionTables(), this function doesn't cause
+         * any @ref LayerState to be set, as the transitions stay the same.
+         */
+        Shared& bakeStyleTransitions();
+
     #ifdef DOXYGEN_GENERATING_OUTPUT
     private:
     #else
@@ -555,6 +653,12 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer::Shared {
     }                                                                       \
     template<class StyleIndex, StyleIndex(*toInactive)(StyleIndex), StyleIndex(*toFocused)(StyleIndex), StyleIndex(*toPressed)(StyleIndex), StyleIndex(*toDisabled)(StyleIndex)> Shared& setStyleTransition() { \
         return static_cast<Shared&>(AbstractVisualLayer::Shared::setStyleTransition<StyleIndex, toInactive, toFocused, toPressed, toDisabled>()); \
+    }                                                                       \
+    Shared& setStyleTransitionTables(Containers::ArrayView<const UnsignedInt> toInactiveOut, Containers::ArrayView<const UnsignedInt> toInactiveOver, Containers::ArrayView<const UnsignedInt> toFocusedOut, Containers::ArrayView<const UnsignedInt> toFocusedOver, Containers::ArrayView<const UnsignedInt> toPressedOut, Containers::ArrayView<const UnsignedInt> toPressedOver, Containers::ArrayView<const UnsignedInt> toDisabled) { \
+        return static_cast<Shared&>(AbstractVisualLayer::Shared::setStyleTransitionTables(toInactiveOut, toInactiveOver, toFocusedOut, toFocusedOver, toPressedOut, toPressedOver, toDisabled)); \
+    }                                                                       \
+    Shared& bakeStyleTransitions() {                                        \
+        return static_cast<Shared&>(AbstractVisualLayer::Shared::bakeStyleTransitions()); \
     }
 #endif
 
@@ -31,6 +31,7 @@
 #include "Magnum/Ui/AbstractVisualLayer.h"
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/Implementation/abstractVisualLayerAnimatorState.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
 
 namespace Magnum { namespace Ui {
 
@@ -54,7 +55,35 @@ void AbstractVisualLayerStyleAnimator::removeInternal(const UnsignedInt id) {
        if advance() wasn't called for this animation yet or if it was already
        stopped by the time it reached advance(). */
     if(state.dynamicStyles[id] != ~UnsignedInt{})
-        state.layer->recycleDynamicStyle(state.dynamicStyles[id]);
+        releaseDynamicStyleInternal(id);
+}
+
+void AbstractVisualLayerStyleAnimator::releaseDynamicStyleInternal(const UnsignedInt id) {
+    State& state = *_state;
+    const UnsignedInt style = state.dynamicStyles[id];
+    CORRADE_INTERNAL_DEBUG_ASSERT(style != ~UnsignedInt{});
+
+    /* If the style isn't shared with any other animation, recycle it */
+    if(state.dynamicStyleNext.isEmpty() || state.dynamicStyleNext[id] == id) {
+        state.layer->recycleDynamicStyle(style);
+
+    /* Otherwise just remove the animation from the list. If the style was
+       associated with this animation, associate it with the next one instead
+       so the layer doesn't end up referencing a removed animation. */
+    } else {
+        const UnsignedInt next = state.dynamicStyleNext[id];
+        const UnsignedInt previous = state.dynamicStylePrevious[id];
+        state.dynamicStyleNext[previous] = next;
+        state.dynamicStylePrevious[next] = previous;
+        state.dynamicStyleNext[id] = id;
+        state.dynamicStylePrevious[id] = id;
+
+        const AnimationHandle animation = state.layer->dynamicStyleAnimation(style);
+        if(animationHandleAnimator(animation) == handle() && animationHandleId(animation) == id)
+            state.layer->setDynamicStyleAnimation(style, animationHandle(handle(), next, generations()[next]));
+    }
+
+    state.dynamicStyles[id] = ~UnsignedInt{};
 }
 
 UnsignedInt AbstractVisualLayerStyleAnimator::targetStyle(const AnimationHandle handle) const {
@@ -106,15 +135,12 @@ void AbstractVisualLayerStyleAnimator::doClean(const Containers::BitArrayView an
        empty. */
     CORRADE_INTERNAL_ASSERT(animationIdsToRemove.isEmpty() || (state.layer && state.dynamicStyles.size() == capacity()));
 
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != animationIdsToRemove.size(); ++i) {
-        if(!animationIdsToRemove[i]) continue;
-
+    Implementation::forEachSetBit(animationIdsToRemove, [&](const std::size_t i) {
         /* Recycle the dynamic style if it was allocated already. It might not
            be if advance() wasn't called for this animation yet or if it was
            already stopped by the time it reached advance(). */
         if(state.dynamicStyles[i] != ~UnsignedInt{})
-            state.layer->recycleDynamicStyle(state.dynamicStyles[i]);
+            releaseDynamicStyleInternal(i);
 
         /* As doClean() is only ever called from within advance() or from
            cleanData() (i.e., when the data the animation is attached to is
@@ -122,7 +148,7 @@ void AbstractVisualLayerStyleAnimator::doClean(const Containers::BitArrayView an
            the now-recycled dynamic one here -- it was either already done in
            advance() or there's no point in doing it as the data itself is
            removed already */
-    }
+    });
 }
 
 }}
@@ -145,6 +145,10 @@ class MAGNUM_UI_EXPORT AbstractVisualLayerStyleAnimator: public AbstractStyleAni
         explicit AbstractVisualLayerStyleAnimator(AnimatorHandle handle);
 
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
+        /* Removes the animation from the list of animations sharing its
+           dynamic style, or recycles the dynamic style if it's not shared
+           with any other */
+        MAGNUM_UI_LOCAL void releaseDynamicStyleInternal(UnsignedInt id);
 
         Containers::Pointer<State> _state;
 
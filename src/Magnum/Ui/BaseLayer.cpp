@@ -31,10 +31,12 @@
 #include <Corrade/Containers/EnumSet.hpp>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Iterable.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/Math/Time.h>
 
@@ -42,6 +44,9 @@
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/Implementation/baseLayerState.h"
+#include "Magnum/Ui/Implementation/fillBaseLayerQuad.h"
+#include "Magnum/Ui/Implementation/framebufferClipRect.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 
 namespace Magnum { namespace Ui {
 
@@ -57,11 +62,19 @@ Debug& operator<<(Debug& debug, const BaseLayerSharedFlag value) {
         _c(NoOutline)
         _c(TextureMask)
         _c(SubdividedQuads)
+        _c(InstancedQuads)
+        _c(StableIndices)
+        _c(ShaderClipping)
+        _c(BackgroundBlurCache)
+        _c(CompactVertices)
+        _c(RingBufferedDynamicStyles)
+        _c(OpaqueDepthPrepass)
+        _c(ShaderNodeProperties)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
 
-    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedShort(value) << Debug::nospace << ")";
 }
 
 Debug& operator<<(Debug& debug, const BaseLayerSharedFlags value) {
@@ -69,22 +82,59 @@ Debug& operator<<(Debug& debug, const BaseLayerSharedFlags value) {
         BaseLayerSharedFlag::TextureMask,
         /* Implied by TextureMask, has to be after */
         BaseLayerSharedFlag::Textured,
+        BaseLayerSharedFlag::BackgroundBlurCache,
+        /* Implied by BackgroundBlurCache, has to be after */
         BaseLayerSharedFlag::BackgroundBlur,
         BaseLayerSharedFlag::NoRoundedCorners,
         BaseLayerSharedFlag::NoOutline,
-        BaseLayerSharedFlag::SubdividedQuads
+        BaseLayerSharedFlag::SubdividedQuads,
+        BaseLayerSharedFlag::ShaderNodeProperties,
+        /* Implied by ShaderNodeProperties, has to be after */
+        BaseLayerSharedFlag::InstancedQuads,
+        BaseLayerSharedFlag::StableIndices,
+        BaseLayerSharedFlag::ShaderClipping,
+        BaseLayerSharedFlag::CompactVertices,
+        BaseLayerSharedFlag::RingBufferedDynamicStyles,
+        BaseLayerSharedFlag::OpaqueDepthPrepass
     });
 }
 
+Debug& operator<<(Debug& debug, const BaseLayerBackgroundBlurAlgorithm value) {
+    debug << "Ui::BaseLayerBackgroundBlurAlgorithm" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case BaseLayerBackgroundBlurAlgorithm::value: return debug << "::" #value;
+        _c(Gaussian)
+        _c(DualKawase)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+}
+
 BaseLayer::Shared::State::State(Shared& self, const Configuration& configuration): AbstractVisualLayer::Shared::State{self, configuration.styleCount(), configuration.dynamicStyleCount()},
+    flags{configuration.flags()},
     /* The radius is always at most 31, so can be a byte */
     backgroundBlurRadius{UnsignedByte(configuration.backgroundBlurRadius())},
-    flags{configuration.flags()},
+    backgroundBlurAlgorithm{configuration.backgroundBlurAlgorithm()},
+    backgroundBlurDownscale{configuration.backgroundBlurDownscale()},
+    /* SubdividedQuads is mutually exclusive with NoRoundedCorners and
+       NoOutline, and a split with StableIndices would need to be combined
+       with the draw runs, so not doing it for either */
+    featureMask{UnsignedByte(
+        configuration.flags() >= BaseLayerSharedFlag::SubdividedQuads ||
+        configuration.flags() >= BaseLayerSharedFlag::StableIndices ? 0 :
+            (configuration.flags() >= BaseLayerSharedFlag::NoRoundedCorners ? 0 : Implementation::BaseLayerFeatureRoundedCorners)|
+            (configuration.flags() >= BaseLayerSharedFlag::NoOutline ? 0 : Implementation::BaseLayerFeatureOutline))},
     styleUniformCount{configuration.styleUniformCount()}
 {
     styleStorage = Containers::ArrayTuple{
         {NoInit, configuration.styleCount(), styles},
-        {NoInit, configuration.dynamicStyleCount() ? configuration.styleUniformCount() : 0, styleUniforms}
+        {NoInit, configuration.dynamicStyleCount() ? configuration.styleUniformCount() : 0, styleUniforms},
+        {NoInit, configuration.flags() >= BaseLayerSharedFlag::OpaqueDepthPrepass ? configuration.styleUniformCount() : 0, styleOpacities},
+        {NoInit, featureMask ? configuration.styleUniformCount() : 0, styleUniformFeatures}
     };
 }
 
@@ -96,6 +146,16 @@ BaseLayer::Shared::Shared(Containers::Pointer<State>&& state): AbstractVisualLay
         "Ui::BaseLayer::Shared: expected non-zero total style count", );
     CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::SubdividedQuads) || !(s.flags & (BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)),
         "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::SubdividedQuads << "and" << (s.flags & (BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)) << "are mutually exclusive", );
+    CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::SubdividedQuads) || !(s.flags & BaseLayerSharedFlag::InstancedQuads),
+        "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::SubdividedQuads << "and" << BaseLayerSharedFlag::InstancedQuads << "are mutually exclusive", );
+    CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::InstancedQuads) || !(s.flags & BaseLayerSharedFlag::StableIndices),
+        "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::InstancedQuads << "and" << BaseLayerSharedFlag::StableIndices << "are mutually exclusive", );
+    CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::CompactVertices) || !(s.flags & (BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::InstancedQuads)),
+        "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::CompactVertices << "and" << (s.flags & (BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::InstancedQuads)) << "are mutually exclusive", );
+    CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::CompactVertices) || s.styleUniformCount + s.dynamicStyleCount <= 65536,
+        "Ui::BaseLayer::Shared: expected at most 65536 style uniforms and dynamic styles with" << BaseLayerSharedFlag::CompactVertices << "but got" << s.styleUniformCount << "and" << s.dynamicStyleCount, );
+    CORRADE_ASSERT(!(s.flags >= BaseLayerSharedFlag::OpaqueDepthPrepass) || !(s.flags & (BaseLayerSharedFlag::Textured|BaseLayerSharedFlag::BackgroundBlur)),
+        "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::OpaqueDepthPrepass << "and" << (s.flags & (BaseLayerSharedFlag::Textured|BaseLayerSharedFlag::BackgroundBlur)) << "are mutually exclusive", );
 }
 
 BaseLayer::Shared::Shared(const Configuration& configuration): Shared{Containers::pointer<State>(*this, configuration)} {}
@@ -110,6 +170,47 @@ BaseLayerSharedFlags BaseLayer::Shared::flags() const {
     return static_cast<const State&>(*_state).flags;
 }
 
+namespace {
+
+/* Used with BaseLayerSharedFlag::OpaqueDepthPrepass, for static styles in
+   setStyleInternal() and for dynamic styles directly in doUpdate() */
+Implementation::BaseLayerStyleOpacity styleOpacity(const BaseLayerStyleUniform& uniform, const BaseLayerSharedFlags flags) {
+    Implementation::BaseLayerStyleOpacity out;
+    out.opaque = uniform.topColor.a() >= 1.0f && uniform.bottomColor.a() >= 1.0f;
+    out.outlineOpaque = uniform.outlineColor.a() >= 1.0f;
+    if(flags >= BaseLayerSharedFlag::NoRoundedCorners) {
+        out.cornerRadius = 0.0f;
+        out.innerOutlineCornerRadius = 0.0f;
+    } else {
+        out.cornerRadius = uniform.cornerRadius.max();
+        out.innerOutlineCornerRadius = uniform.innerOutlineCornerRadius.max();
+    }
+    out.outlineWidth = flags >= BaseLayerSharedFlag::NoOutline ?
+        Vector4{} : uniform.outlineWidth;
+    return out;
+}
+
+bool styleOpacitiesEqual(const Implementation::BaseLayerStyleOpacity& a, const Implementation::BaseLayerStyleOpacity& b) {
+    return a.opaque == b.opaque &&
+        a.outlineOpaque == b.outlineOpaque &&
+        a.cornerRadius == b.cornerRadius &&
+        a.innerOutlineCornerRadius == b.innerOutlineCornerRadius &&
+        a.outlineWidth == b.outlineWidth;
+}
+
+/* Which of the features that can be specialized away are used by given
+   uniform, in setStyleInternal() and setStyleUniforms() */
+UnsignedByte styleUniformFeatures(const BaseLayerStyleUniform& uniform, const UnsignedByte featureMask) {
+    UnsignedByte features = 0;
+    if(!uniform.cornerRadius.isZero() || !uniform.innerOutlineCornerRadius.isZero())
+        features |= Implementation::BaseLayerFeatureRoundedCorners;
+    if(!uniform.outlineWidth.isZero())
+        features |= Implementation::BaseLayerFeatureOutline;
+    return features & featureMask;
+}
+
+}
+
 void BaseLayer::Shared::setStyleInternal(const BaseLayerCommonStyleUniform& commonUniform, const Containers::ArrayView<const BaseLayerStyleUniform> uniforms, const Containers::StridedArrayView1D<const Vector4>& stylePaddings) {
     State& state = static_cast<State&>(*_state);
     CORRADE_ASSERT(uniforms.size() == state.styleUniformCount,
@@ -124,6 +225,12 @@ void BaseLayer::Shared::setStyleInternal(const BaseLayerCommonStyleUniform& comm
         Utility::copy(stylePaddings, stridedArrayView(state.styles).slice(&Implementation::BaseLayerStyle::padding));
     }
 
+    /* Remember which of the features that can be specialized away are used by
+       each uniform. Done before doSetStyle() so BaseLayerGL can make use of
+       it already. */
+    if(state.featureMask) for(std::size_t i = 0; i != uniforms.size(); ++i)
+        state.styleUniformFeatures[i] = styleUniformFeatures(uniforms[i], state.featureMask);
+
     /* If there are dynamic styles, the layers will combine them with the
        static styles and upload to a single buffer, so just copy them to an
        array for the layers to reuse */
@@ -132,6 +239,14 @@ void BaseLayer::Shared::setStyleInternal(const BaseLayerCommonStyleUniform& comm
         Utility::copy(uniforms, state.styleUniforms);
     } else doSetStyle(commonUniform, uniforms);
 
+    /* For the depth pre-pass, the layers need to know which uniforms are
+       opaque and by how much to inset the opaque area */
+    if(state.flags >= BaseLayerSharedFlag::OpaqueDepthPrepass) {
+        for(std::size_t i = 0; i != uniforms.size(); ++i)
+            state.styleOpacities[i] = styleOpacity(uniforms[i], state.flags);
+        state.innerOutlineSmoothness = commonUniform.innerOutlineSmoothness;
+    }
+
     /* Save the smoothness value that we'll use for expanding quad area. See
        the variable comment for why the uniform isn't used instead. */
     state.smoothness = commonUniform.smoothness;
@@ -183,6 +298,58 @@ BaseLayer::Shared& BaseLayer::Shared::setStyle(const BaseLayerCommonStyleUniform
     return setStyle(commonUniform, Containers::arrayView(uniforms), Containers::arrayView(paddings));
 }
 
+BaseLayer::Shared& BaseLayer::Shared::setStyleUniforms(const BaseLayerCommonStyleUniform& commonUniform, const Containers::ArrayView<const BaseLayerStyleUniform> uniforms) {
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(state.setStyleCalled,
+        "Ui::BaseLayer::Shared::setStyleUniforms(): no style data was set", *this);
+    CORRADE_ASSERT(uniforms.size() == state.styleUniformCount,
+        "Ui::BaseLayer::Shared::setStyleUniforms(): expected" << state.styleUniformCount << "uniforms, got" << uniforms.size(), *this);
+
+    /* With dynamic styles the uniforms are uploaded by each layer together
+       with the dynamic ones, which needs a layer update. Otherwise a layer
+       update is needed only if anything derived from the uniforms on the CPU
+       side changes -- the smoothness-dependent quad expansion, the shader
+       features used by the draws and the opaque areas for the depth
+       pre-pass. */
+    bool needsLayerUpdate = state.dynamicStyleCount || commonUniform.smoothness != state.smoothness;
+    state.smoothness = commonUniform.smoothness;
+    if(state.featureMask) for(std::size_t i = 0; i != uniforms.size(); ++i) {
+        const UnsignedByte features = styleUniformFeatures(uniforms[i], state.featureMask);
+        if(features != state.styleUniformFeatures[i]) {
+            state.styleUniformFeatures[i] = features;
+            needsLayerUpdate = true;
+        }
+    }
+    if(state.flags >= BaseLayerSharedFlag::OpaqueDepthPrepass) {
+        for(std::size_t i = 0; i != uniforms.size(); ++i) {
+            const Implementation::BaseLayerStyleOpacity opacity = styleOpacity(uniforms[i], state.flags);
+            if(!styleOpacitiesEqual(opacity, state.styleOpacities[i])) {
+                state.styleOpacities[i] = opacity;
+                needsLayerUpdate = true;
+            }
+        }
+        if(commonUniform.innerOutlineSmoothness != state.innerOutlineSmoothness) {
+            state.innerOutlineSmoothness = commonUniform.innerOutlineSmoothness;
+            needsLayerUpdate = true;
+        }
+    }
+
+    /* Same as in setStyleInternal() */
+    if(state.dynamicStyleCount) {
+        state.commonStyleUniform = commonUniform;
+        Utility::copy(uniforms, state.styleUniforms);
+    } else doSetStyle(commonUniform, uniforms);
+
+    if(needsLayerUpdate)
+        ++state.styleUpdateStamp;
+
+    return *this;
+}
+
+BaseLayer::Shared& BaseLayer::Shared::setStyleUniforms(const BaseLayerCommonStyleUniform& commonUniform, const std::initializer_list<BaseLayerStyleUniform> uniforms) {
+    return setStyleUniforms(commonUniform, Containers::arrayView(uniforms));
+}
+
 BaseLayer::Shared::Configuration::Configuration(const UnsignedInt styleUniformCount, const UnsignedInt styleCount): _styleUniformCount{styleUniformCount}, _styleCount{styleCount} {
     CORRADE_ASSERT(!styleUniformCount == !styleCount,
         "Ui::BaseLayer::Shared::Configuration: expected style uniform count and style count to be either both zero or both non-zero, got" << styleUniformCount << "and" << styleCount, );
@@ -196,11 +363,23 @@ BaseLayer::Shared::Configuration& BaseLayer::Shared::Configuration::setBackgroun
     return *this;
 }
 
+BaseLayer::Shared::Configuration& BaseLayer::Shared::Configuration::setBackgroundBlurDownscale(const UnsignedInt factor) {
+    CORRADE_ASSERT(factor,
+        "Ui::BaseLayer::Shared::Configuration::setBackgroundBlurDownscale(): expected a non-zero factor", *this);
+    _backgroundBlurDownscale = factor;
+    return *this;
+}
+
 BaseLayer::State::State(Shared::State& shared): AbstractVisualLayer::State{shared}, styleUpdateStamp{shared.styleUpdateStamp} {
     dynamicStyleStorage = Containers::ArrayTuple{
         {ValueInit, shared.dynamicStyleCount, dynamicStyleUniforms},
         {ValueInit, shared.dynamicStyleCount, dynamicStylePaddings},
     };
+
+    /* Vertices are in the order of data IDs, so styles of individual data can
+       be patched on event style transitions. Instances are in draw order,
+       which would need a mapping from data IDs back to draw positions. */
+    dataStyleUpdates = !(shared.flags >= BaseLayerSharedFlag::InstancedQuads);
 }
 
 BaseLayer::BaseLayer(const LayerHandle handle, Containers::Pointer<State>&& state): AbstractVisualLayer{handle, Utility::move(state)} {}
@@ -327,6 +506,45 @@ void BaseLayer::setColorInternal(const UnsignedInt id, const Color4& color) {
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+void BaseLayer::setColor(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors) {
+    CORRADE_ASSERT(colors.size() == handles.size(),
+        "Ui::BaseLayer::setColor(): expected handle and color views to have the same size but got" << handles.size() << "and" << colors.size(), );
+    /* Check all handles first to not end up with just a part of the data
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::BaseLayer::setColor(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[dataHandleId(handles[i])].color = colors[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void BaseLayer::setColor(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors) {
+    CORRADE_ASSERT(colors.size() == handles.size(),
+        "Ui::BaseLayer::setColor(): expected handle and color views to have the same size but got" << handles.size() << "and" << colors.size(), );
+    /* Same as above */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::BaseLayer::setColor(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[layerDataHandleId(handles[i])].color = colors[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 void BaseLayer::setOutlineWidth(const DataHandle handle, const Vector4& width) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayer::setOutlineWidth(): invalid handle" << handle, );
@@ -356,6 +574,45 @@ void BaseLayer::setOutlineWidthInternal(const UnsignedInt id, const Vector4& wid
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+void BaseLayer::setOutlineWidth(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& widths) {
+    CORRADE_ASSERT(widths.size() == handles.size(),
+        "Ui::BaseLayer::setOutlineWidth(): expected handle and width views to have the same size but got" << handles.size() << "and" << widths.size(), );
+    /* Check all handles first to not end up with just a part of the data
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::BaseLayer::setOutlineWidth(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[dataHandleId(handles[i])].outlineWidth = widths[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void BaseLayer::setOutlineWidth(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& widths) {
+    CORRADE_ASSERT(widths.size() == handles.size(),
+        "Ui::BaseLayer::setOutlineWidth(): expected handle and width views to have the same size but got" << handles.size() << "and" << widths.size(), );
+    /* Same as above */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::BaseLayer::setOutlineWidth(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[layerDataHandleId(handles[i])].outlineWidth = widths[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 Vector4 BaseLayer::padding(const DataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayer::padding(): invalid handle" << handle, {});
@@ -385,6 +642,45 @@ void BaseLayer::setPaddingInternal(const UnsignedInt id, const Vector4& padding)
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+void BaseLayer::setPadding(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& paddings) {
+    CORRADE_ASSERT(paddings.size() == handles.size(),
+        "Ui::BaseLayer::setPadding(): expected handle and padding views to have the same size but got" << handles.size() << "and" << paddings.size(), );
+    /* Check all handles first to not end up with just a part of the data
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::BaseLayer::setPadding(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[dataHandleId(handles[i])].padding = paddings[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void BaseLayer::setPadding(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& paddings) {
+    CORRADE_ASSERT(paddings.size() == handles.size(),
+        "Ui::BaseLayer::setPadding(): expected handle and padding views to have the same size but got" << handles.size() << "and" << paddings.size(), );
+    /* Same as above */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::BaseLayer::setPadding(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[layerDataHandleId(handles[i])].padding = paddings[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 Vector3 BaseLayer::textureCoordinateOffset(const DataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayer::textureCoordinateOffset(): invalid handle" << handle, {});
@@ -439,15 +735,188 @@ void BaseLayer::setTextureCoordinatesInternal(const UnsignedInt id, const Vector
     auto& state = static_cast<State&>(*_state);
     CORRADE_ASSERT(static_cast<const Shared::State&>(state.shared).flags & BaseLayerSharedFlag::Textured,
         "Ui::BaseLayer::setTextureCoordinates(): texturing not enabled", );
+    CORRADE_ASSERT(!state.textureStreamingSlotCount || (offset.z() >= 0.0f && offset.z() < Float(state.textureStreamingLayerSlots.size())),
+        "Ui::BaseLayer::setTextureCoordinates(): texture layer" << offset.z() << "out of range for" << state.textureStreamingLayerSlots.size() << "streamed layers", );
     Implementation::BaseLayerData& data = state.data[id];
     data.textureCoordinateOffset = offset;
     data.textureCoordinateSize = size;
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+UnsignedInt BaseLayer::textureStreamingLayerCount() const {
+    return static_cast<const State&>(*_state).textureStreamingLayerSlots.size();
+}
+
+UnsignedInt BaseLayer::textureStreamingSlotCount() const {
+    return static_cast<const State&>(*_state).textureStreamingSlotCount;
+}
+
+BaseLayer& BaseLayer::setTextureStreaming(const UnsignedInt layerCount, const UnsignedInt slotCount, const UnsignedInt placeholderStyle, Containers::Function<bool(UnsignedInt, UnsignedInt)>&& loader) {
+    auto& state = static_cast<State&>(*_state);
+    #ifndef CORRADE_NO_ASSERT
+    auto& sharedState = static_cast<const Shared::State&>(state.shared);
+    #endif
+    CORRADE_ASSERT(sharedState.flags & BaseLayerSharedFlag::Textured,
+        "Ui::BaseLayer::setTextureStreaming(): texturing not enabled", *this);
+    CORRADE_ASSERT(slotCount,
+        "Ui::BaseLayer::setTextureStreaming(): expected a non-zero slot count", *this);
+    CORRADE_ASSERT(placeholderStyle < sharedState.styleCount + sharedState.dynamicStyleCount,
+        "Ui::BaseLayer::setTextureStreaming(): placeholder style" << placeholderStyle << "out of range for" << sharedState.styleCount + sharedState.dynamicStyleCount << "styles", *this);
+    CORRADE_ASSERT(loader,
+        "Ui::BaseLayer::setTextureStreaming(): loader is null", *this);
+
+    state.textureStreamingSlotCount = slotCount;
+    state.textureStreamingPlaceholderStyle = placeholderStyle;
+    state.textureStreamingLoader = Utility::move(loader);
+    state.textureStreamingStorage = Containers::ArrayTuple{
+        {NoInit, layerCount, state.textureStreamingLayerSlots},
+        {NoInit, slotCount, state.textureStreamingSlotLayers},
+        {ValueInit, slotCount, state.textureStreamingSlotLastUsed},
+        {ValueInit, slotCount, state.textureStreamingSlotsLoading},
+    };
+    for(UnsignedInt& i: state.textureStreamingLayerSlots)
+        i = ~UnsignedInt{};
+    for(UnsignedInt& i: state.textureStreamingSlotLayers)
+        i = ~UnsignedInt{};
+    state.textureStreamingUpdate = 0;
+    arrayClear(state.textureStreamingRequests);
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    return *this;
+}
+
+Containers::Optional<UnsignedInt> BaseLayer::textureStreamingSlot(const UnsignedInt layer) const {
+    auto& state = static_cast<const State&>(*_state);
+    CORRADE_ASSERT(state.textureStreamingSlotCount,
+        "Ui::BaseLayer::textureStreamingSlot(): texture streaming not enabled", {});
+    CORRADE_ASSERT(layer < state.textureStreamingLayerSlots.size(),
+        "Ui::BaseLayer::textureStreamingSlot(): layer" << layer << "out of range for" << state.textureStreamingLayerSlots.size() << "streamed layers", {});
+    const UnsignedInt slot = state.textureStreamingLayerSlots[layer];
+    if(slot == ~UnsignedInt{} || state.textureStreamingSlotsLoading[slot])
+        return {};
+    return slot;
+}
+
+BaseLayer& BaseLayer::setTextureLayerLoaded(const UnsignedInt layer) {
+    auto& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(state.textureStreamingSlotCount,
+        "Ui::BaseLayer::setTextureLayerLoaded(): texture streaming not enabled", *this);
+    CORRADE_ASSERT(layer < state.textureStreamingLayerSlots.size(),
+        "Ui::BaseLayer::setTextureLayerLoaded(): layer" << layer << "out of range for" << state.textureStreamingLayerSlots.size() << "streamed layers", *this);
+    const UnsignedInt slot = state.textureStreamingLayerSlots[layer];
+    if(slot != ~UnsignedInt{} && state.textureStreamingSlotsLoading[slot]) {
+        state.textureStreamingSlotsLoading.reset(slot);
+        setNeedsUpdate(LayerState::NeedsDataUpdate);
+    }
+    return *this;
+}
+
+void BaseLayer::updateTextureStreaming(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds) {
+    auto& state = static_cast<State&>(*_state);
+    arrayResize(state.textureStreamingDataSlots, NoInit, capacity());
+    const UnsignedInt update = ++state.textureStreamingUpdate;
+    /* If the update can happen on a different thread, the loader can't be
+       called from here as it's expected to upload to the GPU. Just remember
+       what to load and call it from doPostUpdate() instead. */
+    const bool deferLoads = features() >= LayerFeature::ConcurrentUpdate;
+
+    /* First mark slots of all resident layers referenced by drawn data as
+       used, so they don't get evicted by layers requested below */
+    for(const UnsignedInt dataId: dataIds) {
+        const UnsignedInt layer = UnsignedInt(state.data[dataId].textureCoordinateOffset.z());
+        if(layer >= state.textureStreamingLayerSlots.size())
+            continue;
+        const UnsignedInt slot = state.textureStreamingLayerSlots[layer];
+        if(slot != ~UnsignedInt{})
+            state.textureStreamingSlotLastUsed[slot] = update;
+    }
+
+    /* Then request the missing ones. A free slot is picked first, otherwise
+       the least recently used one that isn't needed now and isn't loading.
+       The search is linear in the slot count, which isn't great, but texture
+       arrays are limited to at most a few thousand layers in practice and
+       only a small subset of the layers is expected to be missing in any
+       given update. */
+    for(const UnsignedInt dataId: dataIds) {
+        /* Data created before streaming was enabled may reference layers out
+           of range, these are always drawn with the placeholder */
+        const UnsignedInt layer = UnsignedInt(state.data[dataId].textureCoordinateOffset.z());
+        if(layer >= state.textureStreamingLayerSlots.size()) {
+            state.textureStreamingDataSlots[dataId] = ~UnsignedInt{};
+            continue;
+        }
+
+        UnsignedInt slot = state.textureStreamingLayerSlots[layer];
+        if(slot == ~UnsignedInt{}) {
+            for(UnsignedInt i = 0; i != state.textureStreamingSlotCount; ++i) {
+                if(state.textureStreamingSlotLayers[i] == ~UnsignedInt{}) {
+                    slot = i;
+                    break;
+                }
+                if(state.textureStreamingSlotLastUsed[i] == update ||
+                   state.textureStreamingSlotsLoading[i])
+                    continue;
+                if(slot == ~UnsignedInt{} || state.textureStreamingSlotLastUsed[i] < state.textureStreamingSlotLastUsed[slot])
+                    slot = i;
+            }
+
+            /* All slots are needed by other drawn data or are loading,
+               request again in some later update */
+            if(slot != ~UnsignedInt{}) {
+                const UnsignedInt evictedLayer = state.textureStreamingSlotLayers[slot];
+                if(evictedLayer != ~UnsignedInt{})
+                    state.textureStreamingLayerSlots[evictedLayer] = ~UnsignedInt{};
+                state.textureStreamingLayerSlots[layer] = slot;
+                state.textureStreamingSlotLayers[slot] = layer;
+                state.textureStreamingSlotLastUsed[slot] = update;
+                if(deferLoads) {
+                    state.textureStreamingSlotsLoading.set(slot);
+                    arrayAppend(state.textureStreamingRequests, InPlaceInit, layer, slot);
+                } else state.textureStreamingSlotsLoading.set(slot, !state.textureStreamingLoader(layer, slot));
+            }
+        }
+
+        state.textureStreamingDataSlots[dataId] =
+            slot != ~UnsignedInt{} && !state.textureStreamingSlotsLoading[slot] ?
+                slot : ~UnsignedInt{};
+    }
+}
+
+void BaseLayer::doPostUpdate(LayerStates) {
+    auto& state = static_cast<State&>(*_state);
+
+    /* Call the loader for texture layers requested in doUpdate(), now on the
+       thread the user interface is updated on. Data using layers that got
+       loaded get drawn with them in the next update. */
+    bool loaded = false;
+    for(const Vector2ui& request: state.textureStreamingRequests) {
+        if(state.textureStreamingLoader(request.x(), request.y())) {
+            state.textureStreamingSlotsLoading.reset(request.y());
+            loaded = true;
+        }
+    }
+    arrayClear(state.textureStreamingRequests);
+    if(loaded)
+        setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+UnsignedInt BaseLayer::drawnStyleInternal(const UnsignedInt id) const {
+    auto& state = static_cast<const State&>(*_state);
+    return state.textureStreamingSlotCount && state.textureStreamingDataSlots[id] == ~UnsignedInt{} ?
+        state.textureStreamingPlaceholderStyle : state.data[id].calculatedStyle;
+}
+
+Float BaseLayer::drawnTextureLayerInternal(const UnsignedInt id) const {
+    auto& state = static_cast<const State&>(*_state);
+    if(!state.textureStreamingSlotCount)
+        return state.data[id].textureCoordinateOffset.z();
+    /* The placeholder is in the layer right after all slots */
+    const UnsignedInt slot = state.textureStreamingDataSlots[id];
+    return Float(slot == ~UnsignedInt{} ? state.textureStreamingSlotCount : slot);
+}
+
 LayerFeatures BaseLayer::doFeatures() const {
     auto& sharedState = static_cast<const Shared::State&>(_state->shared);
-    return AbstractVisualLayer::doFeatures()|(sharedState.dynamicStyleCount ? LayerFeature::AnimateStyles : LayerFeatures{})|LayerFeature::Draw|(sharedState.flags & BaseLayerSharedFlag::BackgroundBlur ? LayerFeature::Composite : LayerFeatures{});
+    return AbstractVisualLayer::doFeatures()|(sharedState.dynamicStyleCount ? LayerFeature::AnimateStyles : LayerFeatures{})|LayerFeature::Draw|LayerFeature::NodeTranslation|(sharedState.flags & BaseLayerSharedFlag::BackgroundBlur ? LayerFeature::Composite : LayerFeatures{})|(sharedState.flags >= BaseLayerSharedFlag::OpaqueDepthPrepass ? LayerFeature::DrawOpaque : LayerFeatures{});
 }
 
 void BaseLayer::doSetSize(const Vector2& size, const Vector2i& framebufferSize) {
@@ -508,6 +977,60 @@ void BaseLayer::doAdvanceAnimations(const Nanoseconds time, const Containers::Mu
     }
 }
 
+MemoryUsage BaseLayer::doMemoryUsage() const {
+    const State& state = static_cast<const State&>(*_state);
+    MemoryUsage out = AbstractVisualLayer::doMemoryUsage();
+    Implementation::addArrayMemoryUsage(out, state.data);
+    Implementation::addArrayMemoryUsage(out, state.vertices);
+    Implementation::addArrayMemoryUsage(out, state.indices);
+    Implementation::addArrayMemoryUsage(out, state.drawRuns);
+    Implementation::addArrayMemoryUsage(out, state.featureRuns);
+    Implementation::addArrayMemoryUsage(out, state.backgroundBlurVertices);
+    Implementation::addArrayMemoryUsage(out, state.backgroundBlurIndices);
+    Implementation::addArrayMemoryUsage(out, state.opaqueVertices);
+    Implementation::addArrayMemoryUsage(out, state.opaqueQuadOffsets);
+    Implementation::addArrayMemoryUsage(out, state.dynamicStyleStorage);
+    Implementation::addArrayMemoryUsage(out, state.textureStreamingStorage);
+    Implementation::addArrayMemoryUsage(out, state.textureStreamingDataSlots);
+    Implementation::addArrayMemoryUsage(out, state.textureStreamingRequests);
+    out.cpuUnused += (state.data.size() - usedCount())*sizeof(Implementation::BaseLayerData);
+    return out;
+}
+
+void BaseLayer::doTrim(const std::size_t capacity) {
+    AbstractVisualLayer::doTrim(capacity);
+
+    auto& state = static_cast<State&>(*_state);
+    if(state.data.size() > capacity)
+        arrayResize(state.data, NoInit, capacity);
+    arrayShrink(state.data);
+    state.styles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::calculatedStyle);
+
+    /* The rest is sized for data that get drawn, with the contents possibly
+       still in use until the next update, so only the reserved memory is
+       released */
+    arrayShrink(state.vertices);
+    arrayShrink(state.indices);
+    arrayShrink(state.drawRuns);
+    arrayShrink(state.featureRuns);
+    arrayShrink(state.backgroundBlurVertices);
+    arrayShrink(state.backgroundBlurIndices);
+    arrayShrink(state.opaqueVertices);
+    arrayShrink(state.opaqueQuadOffsets);
+    if(state.textureStreamingDataSlots.size() > capacity)
+        arrayResize(state.textureStreamingDataSlots, NoInit, capacity);
+    arrayShrink(state.textureStreamingDataSlots);
+}
+
+void BaseLayer::doReserve(const std::size_t capacity) {
+    auto& state = static_cast<State&>(*_state);
+    arrayReserve(state.data, capacity);
+    /* The reallocation may have moved the data */
+    state.styles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::calculatedStyle);
+}
+
 LayerStates BaseLayer::doState() const {
     LayerStates states = AbstractVisualLayer::doState();
 
@@ -530,7 +1053,7 @@ LayerStates BaseLayer::doState() const {
 }
 
 void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
-    /* The base implementation populates data.calculatedStyle */
+    /* The base implementation populates style */
     AbstractVisualLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
 
     auto& state = static_cast<State&>(*_state);
@@ -544,14 +1067,23 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
        node order changed. Flattening the logic for less indentation, first the
        less-data-heavy case with just a single quad for every data but a more
        complicated fragment shader. Keep the checks in sync with
-       BaseLayerGL::doUpdate(). */
-    const bool updateIndices =
-        states >= LayerState::NeedsNodeOrderUpdate ||
-        states >= LayerState::NeedsDataUpdate;
+       BaseLayerGL::doUpdate(). With InstancedQuads there are no indices at
+       all, the instance data are handled below.
+
+       With StableIndices the indices are for all data in the order of their
+       IDs instead, so they depend only on the capacity and the draw order is
+       described by draw runs calculated below. */
+    const bool instanced = sharedState.flags >= BaseLayerSharedFlag::InstancedQuads;
+    const bool stableIndices = sharedState.flags >= BaseLayerSharedFlag::StableIndices;
+    const std::size_t indexDataCount = stableIndices ? capacity() : dataIds.size();
+    const bool updateIndices = !instanced && (stableIndices ?
+        state.indices.size() != indexDataCount*(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads ? 54 : 6) :
+        (states >= LayerState::NeedsNodeOrderUpdate ||
+         states >= LayerState::NeedsDataUpdate));
     if(updateIndices && !(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
-        arrayResize(state.indices, NoInit, dataIds.size()*6);
-        for(UnsignedInt i = 0; i != dataIds.size(); ++i) {
-            const UnsignedInt vertexOffset = dataIds[i]*4;
+        arrayResize(state.indices, NoInit, indexDataCount*6);
+        for(UnsignedInt i = 0; i != indexDataCount; ++i) {
+            const UnsignedInt vertexOffset = (stableIndices ? i : dataIds[i])*4;
             UnsignedInt indexOffset = i*6;
 
             /* 0---1 0---2 5
@@ -583,9 +1115,9 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             10-11---15-14   36-38 41 42-44 47 48-50 53
             |   |   |   |   | /  / | | /  / | | /  / |
             8---9---13-12   37 39-40 43 45-46 49 51-52 */
-        arrayResize(state.indices, NoInit, dataIds.size()*6*9);
-        for(UnsignedInt i = 0; i != dataIds.size(); ++i) {
-            const UnsignedInt vertexOffset = dataIds[i]*16;
+        arrayResize(state.indices, NoInit, indexDataCount*6*9);
+        for(UnsignedInt i = 0; i != indexDataCount; ++i) {
+            const UnsignedInt vertexOffset = (stableIndices ? i : dataIds[i])*16;
             UnsignedInt indexOffset = i*54;
 
             state.indices[indexOffset +  0] = vertexOffset +  0;
@@ -653,6 +1185,23 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         }
     }
 
+    /* With StableIndices, split the draw order into runs of consecutive data
+       IDs, each of which is then a contiguous range in the index buffer. This
+       is just a read-only pass over the data IDs, with the output size
+       being proportional to the run count and not the data count. */
+    if(stableIndices && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsDataUpdate))
+    {
+        arrayResize(state.drawRuns, 0);
+        for(UnsignedInt i = 0; i != dataIds.size(); ++i) {
+            if(!i || dataIds[i] != dataIds[i - 1] + 1)
+                arrayAppend(state.drawRuns, Implementation::BaseLayerDrawRun{i, dataIds[i]});
+        }
+        /* Sentinel to know where the last run ends */
+        arrayAppend(state.drawRuns, Implementation::BaseLayerDrawRun{UnsignedInt(dataIds.size()), 0});
+    }
+
     /* Fill in vertex data if the data themselves, the node offset/size or node
        enablement (and thus calculated styles) changed. Again flattening the
        logic for less indentation, first the less-data-heavy case with just a
@@ -660,30 +1209,181 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
        BaseLayerGL::doUpdate(). */
     /** @todo split this further to just position-related data update and other
         data if it shows to help with perf */
-    const bool updateVertices =
+    const bool updateVertices = !instanced && (
         states >= LayerState::NeedsNodeOffsetSizeUpdate ||
         states >= LayerState::NeedsNodeEnabledUpdate ||
-        states >= LayerState::NeedsNodeOpacityUpdate ||
-        states >= LayerState::NeedsDataUpdate;
-    if(updateVertices && !(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
+        states >= LayerState::NeedsDataUpdate);
+    /* Instanced quads have a single record per data, placed in draw order as
+       there's no index buffer to reorder them with. Thus they need to be
+       updated also on a node order change. With ShaderNodeProperties the
+       node offsets, sizes and opacities are applied in the shader, so a node
+       opacity change alone doesn't need them updated. A node offset or size
+       change implies NeedsNodeOrderUpdate so the instances get regenerated,
+       but their contents stay the same and BaseLayerGL thus uploads nothing
+       for them. */
+    const bool shaderNodeProperties = sharedState.flags >= BaseLayerSharedFlag::ShaderNodeProperties;
+    const bool updateInstances = instanced && (
+        states >= LayerState::NeedsNodeOrderUpdate ||
+        states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+        states >= LayerState::NeedsNodeEnabledUpdate ||
+        (!shaderNodeProperties && states >= LayerState::NeedsNodeOpacityUpdate) ||
+        states >= LayerState::NeedsDataUpdate);
+
+    /* If just styles of a few data changed in event style transitions,
+       regenerate vertices only for those, as the style affects both the
+       uniform index and the padding. Not done with texture streaming, as
+       there the placeholder assignment is resolved for all drawn data
+       together. The list is already filtered to data that are attached in
+       AbstractVisualLayer::doUpdate(). */
+    const bool updateStyleVertices = !instanced && !updateVertices &&
+        !state.textureStreamingSlotCount &&
+        states >= LayerState::NeedsDataStyleUpdate;
+    const bool updateAllVertices = updateVertices || (!instanced &&
+        state.textureStreamingSlotCount &&
+        states >= LayerState::NeedsDataStyleUpdate);
+    const Containers::StridedArrayView1D<const UnsignedInt> vertexDataIds = updateStyleVertices ?
+        stridedArrayView(state.styleChangedDataIds) : dataIds;
+
+    /* If only node opacities changed, such as when fading in a single
+       top-level node, only the vertex colors are affected. Rewrite just those
+       instead of regenerating the whole vertex data, BaseLayerGL then uploads
+       only vertices of data whose color actually changed. Done also together
+       with the style-only update above, which handles just a subset of the
+       data. */
+    const bool updateOpacityVertices = !instanced && !updateAllVertices &&
+        states >= LayerState::NeedsNodeOpacityUpdate;
+
+    /* With texture streaming, resolve which texture slots the drawn data use
+       first, as data whose texture layer isn't resident are drawn with the
+       placeholder style and texture layer instead */
+    if(state.textureStreamingSlotCount && (updateAllVertices || updateInstances))
+        updateTextureStreaming(dataIds);
+
+    /* Split the draw order into runs of data using the same shader features,
+       so BaseLayerGL can draw the runs that don't need rounded corners or
+       outlines with a cheaper shader variant. The draw order is kept as-is,
+       so the output is the same as with a single draw. Dynamic styles can
+       change arbitrarily, so they're assumed to use all features. Has to be
+       done after texture streaming is resolved, as placeholders change the
+       drawn style. */
+    if(sharedState.featureMask && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsNodeEnabledUpdate ||
+       states >= LayerState::NeedsDataUpdate ||
+       states >= LayerState::NeedsDataStyleUpdate))
+    {
+        arrayResize(state.featureRuns, 0);
+        for(UnsignedInt i = 0; i != dataIds.size(); ++i) {
+            const UnsignedInt dataId = dataIds[i];
+            const UnsignedInt style = drawnStyleInternal(dataId);
+            UnsignedInt features = style < sharedState.styleCount ?
+                sharedState.styleUniformFeatures[sharedState.styles[style].uniform] :
+                sharedState.featureMask;
+            if(!state.data[dataId].outlineWidth.isZero())
+                features |= Implementation::BaseLayerFeatureOutline;
+            features &= sharedState.featureMask;
+            if(!i || features != state.featureRuns.back().features)
+                arrayAppend(state.featureRuns, Implementation::BaseLayerFeatureRun{i, features});
+        }
+        /* Sentinel to know where the last run ends */
+        arrayAppend(state.featureRuns, Implementation::BaseLayerFeatureRun{UnsignedInt(dataIds.size()), 0});
+    }
+
+    /* If the nodes were only translated, shift the existing vertex positions
+       or instance rectangles by the difference to the offset they were
+       generated with instead of regenerating them. Done before the style-only
+       update, which then overwrites the subset it regenerates. With
+       ShaderNodeProperties the node offsets are applied in the shader,
+       BaseLayerGL just uploads the new node properties. */
+    const bool updateTranslation = !updateAllVertices && !updateInstances &&
+        !(instanced && shaderNodeProperties) &&
+        states >= LayerState::NeedsNodeTranslationUpdate;
+    if(updateTranslation) {
+        /* The position is the first member of all vertex types and the
+           rectangle min and max the first two members of all instance
+           types */
+        std::size_t typeSize;
+        UnsignedInt vertexCount;
+        if(instanced) {
+            typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerTexturedInstance) :
+                sizeof(Implementation::BaseLayerInstance);
+            vertexCount = 1;
+        } else if(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads) {
+            typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerSubdividedTexturedVertex) :
+                sizeof(Implementation::BaseLayerSubdividedVertex);
+            vertexCount = 16;
+        } else if(sharedState.flags >= BaseLayerSharedFlag::CompactVertices) {
+            typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerCompactTexturedVertex) :
+                sizeof(Implementation::BaseLayerCompactVertex);
+            vertexCount = 4;
+        } else {
+            typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerTexturedVertex) :
+                sizeof(Implementation::BaseLayerVertex);
+            vertexCount = 4;
+        }
+        const Containers::StridedArrayView1D<Vector2> positions{
+            state.vertices,
+            reinterpret_cast<Vector2*>(state.vertices.data()),
+            state.vertices.size()/typeSize,
+            std::ptrdiff_t(typeSize)};
+        const Containers::StridedArrayView1D<Implementation::BaseLayerInstance> instances{
+            state.vertices,
+            reinterpret_cast<Implementation::BaseLayerInstance*>(state.vertices.data()),
+            state.vertices.size()/typeSize,
+            std::ptrdiff_t(typeSize)};
+
+        const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+        for(std::size_t i = 0; i != dataIds.size(); ++i) {
+            const UnsignedInt dataId = dataIds[i];
+            const Vector2 offset = nodeOffsets[nodeHandleId(nodes[dataId])];
+            Vector2& vertexNodeOffset = state.data[dataId].vertexNodeOffset;
+            const Vector2 delta = offset - vertexNodeOffset;
+            vertexNodeOffset = offset;
+
+            /* Instances are in draw order, vertices in the order of data
+               IDs */
+            if(instanced) {
+                instances[i].min += delta;
+                instances[i].max += delta;
+            } else for(UnsignedInt j = 0; j != vertexCount; ++j)
+                positions[dataId*vertexCount + j] += delta;
+        }
+    }
+
+    if((updateAllVertices || updateStyleVertices) && !(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
         /* Resize the vertex array to fit all data, make a view on the common
-           type prefix */
-        const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
-            sizeof(Implementation::BaseLayerTexturedVertex) :
-            sizeof(Implementation::BaseLayerVertex);
+           type prefix. With CompactVertices only the compactVertices view is
+           used, otherwise only the vertices view. */
+        const bool compact = sharedState.flags >= BaseLayerSharedFlag::CompactVertices;
+        const std::size_t typeSize = compact ?
+            (sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerCompactTexturedVertex) :
+                sizeof(Implementation::BaseLayerCompactVertex)) :
+            (sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerTexturedVertex) :
+                sizeof(Implementation::BaseLayerVertex));
         arrayResize(state.vertices, NoInit, capacity()*4*typeSize);
         const Containers::StridedArrayView1D<Implementation::BaseLayerVertex> vertices{
             state.vertices,
             reinterpret_cast<Implementation::BaseLayerVertex*>(state.vertices.data()),
             state.vertices.size()/typeSize,
             std::ptrdiff_t(typeSize)};
+        const Containers::StridedArrayView1D<Implementation::BaseLayerCompactVertex> compactVertices{
+            state.vertices,
+            reinterpret_cast<Implementation::BaseLayerCompactVertex*>(state.vertices.data()),
+            state.vertices.size()/typeSize,
+            std::ptrdiff_t(typeSize)};
 
         /* Convert smoothness from a pixel value to the UI coordinates */
         const Float smoothness = sharedState.smoothness*(state.uiSize/Vector2{state.framebufferSize}).max();
 
         /* Fill in quad corner positions and colors */
         const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
-        for(const UnsignedInt dataId: dataIds) {
+        for(const UnsignedInt dataId: vertexDataIds) {
             const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
             const Implementation::BaseLayerData& data = state.data[dataId];
 
@@ -697,12 +1397,15 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                to get a 2D "smoothness expansion vector" value, different for
                every data (and then another for textures), instead of just a
                single smoothness uniform for all. */
+            /* With texture streaming the style may be replaced with the
+               placeholder */
+            const UnsignedInt style = drawnStyleInternal(dataId);
             Vector4 padding = data.padding - Vector4{smoothness};
-            if(data.calculatedStyle < sharedState.styleCount)
-                padding += sharedState.styles[data.calculatedStyle].padding;
+            if(style < sharedState.styleCount)
+                padding += sharedState.styles[style].padding;
             else {
-                CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
-                padding += state.dynamicStylePaddings[data.calculatedStyle - sharedState.styleCount];
+                CORRADE_INTERNAL_DEBUG_ASSERT(style < sharedState.styleCount + sharedState.dynamicStyleCount);
+                padding += state.dynamicStylePaddings[style - sharedState.styleCount];
             }
 
             /* 0---1
@@ -713,23 +1416,33 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             const Vector2 offset = nodeOffsets[nodeId];
             const Vector2 min = offset + padding.xy();
             const Vector2 max = offset + nodeSizes[nodeId] - Math::gather<'z', 'w'>(padding);
-            const Vector2 sizeHalf = (max - min)*0.5f;
-            const Vector2 sizeHalfNegative = -sizeHalf;
-            const Float opacity = nodeOpacities[nodeId];
-            for(UnsignedByte i = 0; i != 4; ++i) {
-                Implementation::BaseLayerVertex& vertex = vertices[dataId*4 + i];
+            const Color4 color = data.color*nodeOpacities[nodeId];
+            state.data[dataId].vertexNodeOffset = offset;
+            /* For dynamic styles the uniform mapping is implicit and they're
+               placed right after all non-dynamic styles */
+            const UnsignedInt styleUniform = style < sharedState.styleCount ?
+                sharedState.styles[style].uniform :
+                sharedState.styleUniformCount + style - sharedState.styleCount;
+            if(compact) {
+                /* Converting what's the same for all four vertices just once.
+                   The color is clamped as it'd overflow otherwise, the style
+                   uniform count is checked to fit into 16 bits in the Shared
+                   constructor already. */
+                const Vector2 sizeHalf = (max - min)*0.5f;
+                const Vector2us sizeHalfPacked = Math::packHalf(sizeHalf);
+                const Vector2us sizeHalfNegativePacked = Math::packHalf(-sizeHalf);
+                const Vector4us outlineWidthPacked = Math::packHalf(data.outlineWidth);
+                const Color4ub colorPacked = Math::pack<Color4ub>(Math::clamp(color, 0.0f, 1.0f));
+                for(UnsignedByte i = 0; i != 4; ++i) {
+                    Implementation::BaseLayerCompactVertex& vertex = compactVertices[dataId*4 + i];
 
-                /* ✨ */
-                vertex.position = Math::lerp(min, max, BitVector2{i});
-                vertex.centerDistance = Math::lerp(sizeHalfNegative, sizeHalf, BitVector2{i});
-                vertex.outlineWidth = data.outlineWidth;
-                vertex.color = data.color*opacity;
-                /* For dynamic styles the uniform mapping is implicit and
-                   they're placed right after all non-dynamic styles */
-                vertex.styleUniform = data.calculatedStyle < sharedState.styleCount ?
-                    sharedState.styles[data.calculatedStyle].uniform :
-                    sharedState.styleUniformCount + data.calculatedStyle - sharedState.styleCount;
-            }
+                    vertex.position = Math::lerp(min, max, BitVector2{i});
+                    vertex.centerDistance = Math::lerp(sizeHalfNegativePacked, sizeHalfPacked, BitVector2{i});
+                    vertex.outlineWidth = outlineWidthPacked;
+                    vertex.color = colorPacked;
+                    vertex.styleUniform = styleUniform;
+                }
+            } else Implementation::fillBaseLayerQuad(reinterpret_cast<char*>(&vertices[dataId*4]), vertices.stride(), min, max, data.outlineWidth, color, styleUniform);
         }
 
         /* Fill in also quad texture coordinates if enabled */
@@ -737,9 +1450,14 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             /* Doing it like this instead of casting the typeless
                state.vertices array to ensure it's not accidentally in some
                entirely different type */
-            const Containers::ArrayView<Implementation::BaseLayerTexturedVertex> texturedVertices = Containers::arrayCast<Implementation::BaseLayerTexturedVertex>(vertices).asContiguous();
-
-            for(const UnsignedInt dataId: dataIds) {
+            const Containers::StridedArrayView1D<Vector3> textureCoordinates = compact ?
+                Containers::arrayCast<Implementation::BaseLayerCompactTexturedVertex>(compactVertices).slice(&Implementation::BaseLayerCompactTexturedVertex::textureCoordinates) :
+                Containers::arrayCast<Implementation::BaseLayerTexturedVertex>(vertices).slice(&Implementation::BaseLayerTexturedVertex::textureCoordinates);
+            const Containers::StridedArrayView1D<const Vector2> positions = compact ?
+                compactVertices.slice(&Implementation::BaseLayerCompactVertex::position) :
+                vertices.slice(&Implementation::BaseLayerVertex::position);
+
+            for(const UnsignedInt dataId: vertexDataIds) {
                 const Implementation::BaseLayerData& data = state.data[dataId];
 
                 /* Expand the texture coordinates to match the position
@@ -753,7 +1471,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                    calculation again, now I just undo the smoothness. And using
                    those is also nice to the cache because they're literally
                    next to where I'm writing. */
-                const Vector2 paddedQuadSizeWithoutSmoothness = vertices[dataId*4 + 3].position - vertices[dataId*4 + 0].position - Vector2{2.0f*smoothness};
+                const Vector2 paddedQuadSizeWithoutSmoothness = positions[dataId*4 + 3] - positions[dataId*4 + 0] - Vector2{2.0f*smoothness};
                 const Vector2 smoothnessExpansion = data.textureCoordinateSize*smoothness/paddedQuadSizeWithoutSmoothness*Vector2::yScale(-1.0f);
 
                 /* The texture coordinates are Y-flipped compared to the
@@ -763,13 +1481,14 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                     don't Y-flip the projection, reconsider? */
                 const Vector2 min = data.textureCoordinateOffset.xy() + Vector2::yAxis(data.textureCoordinateSize.y()) - smoothnessExpansion;
                 const Vector2 max = data.textureCoordinateOffset.xy() + Vector2::xAxis(data.textureCoordinateSize.x()) + smoothnessExpansion;
+                const Float layer = drawnTextureLayerInternal(dataId);
                 for(UnsignedByte i = 0; i != 4; ++i)
-                    texturedVertices[dataId*4 + i].textureCoordinates = {Math::lerp(min, max, BitVector2{i}), data.textureCoordinateOffset.z()};
+                    textureCoordinates[dataId*4 + i] = {Math::lerp(min, max, BitVector2{i}), layer};
             }
         }
 
     /* And then again the more data-heavy case with 9 quads for every data */
-    } else if(updateVertices && sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads) {
+    } else if((updateAllVertices || updateStyleVertices) && sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads) {
         /* Resize the vertex array to fit all data, make a view on the common type
            prefix */
         const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
@@ -797,11 +1516,13 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             |   |   |   |
             8---9---13-12 */
         const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
-        for(const UnsignedInt dataId: dataIds) {
+        for(const UnsignedInt dataId: vertexDataIds) {
             const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
             const Implementation::BaseLayerData& data = state.data[dataId];
 
-            /* All 16 vertices get the same color and style */
+            /* All 16 vertices get the same color and style. With texture
+               streaming the style may be replaced with the placeholder. */
+            const UnsignedInt style = drawnStyleInternal(dataId);
             const Float opacity = nodeOpacities[nodeId];
             for(std::size_t i = 0; i != 16; ++i) {
                 Implementation::BaseLayerSubdividedVertex& vertex = vertices[dataId*16 + i];
@@ -809,9 +1530,9 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                 vertex.color = data.color*opacity;
                 /* For dynamic styles the uniform mapping is implicit and
                    they're placed right after all non-dynamic styles */
-                vertex.styleUniform = data.calculatedStyle < sharedState.styleCount ?
-                    sharedState.styles[data.calculatedStyle].uniform :
-                    sharedState.styleUniformCount + data.calculatedStyle - sharedState.styleCount;
+                vertex.styleUniform = style < sharedState.styleCount ?
+                    sharedState.styles[style].uniform :
+                    sharedState.styleUniformCount + style - sharedState.styleCount;
             }
 
             /* Note that here, compared to the non-SubdividedQuads case above,
@@ -820,11 +1541,11 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                corner radii on its own anyway, and doing the outer smoothness
                expansion there as well makes the code more understandable. */
             Vector4 padding = data.padding;
-            if(data.calculatedStyle < sharedState.styleCount)
-                padding += sharedState.styles[data.calculatedStyle].padding;
+            if(style < sharedState.styleCount)
+                padding += sharedState.styles[style].padding;
             else {
-                CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
-                padding += state.dynamicStylePaddings[data.calculatedStyle - sharedState.styleCount];
+                CORRADE_INTERNAL_DEBUG_ASSERT(style < sharedState.styleCount + sharedState.dynamicStyleCount);
+                padding += state.dynamicStylePaddings[style - sharedState.styleCount];
             }
 
             /* All four vertices in each corner get set to the same position
@@ -833,6 +1554,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             const Vector2 min = offset + padding.xy();
             const Vector2 max = offset + nodeSizes[nodeId] - Math::gather<'z', 'w'>(padding);
             const Float sizeHalfY = (max.y() - min.y())*0.5f;
+            state.data[dataId].vertexNodeOffset = offset;
             const Float sizeHalfYNegative = -sizeHalfY;
             for(UnsignedByte i = 0; i != 4; ++i) {
                 /* ✨ */
@@ -864,7 +1586,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         if(sharedState.flags & BaseLayerSharedFlag::Textured) {
             const Containers::ArrayView<Implementation::BaseLayerSubdividedTexturedVertex> texturedVertices = Containers::arrayCast<Implementation::BaseLayerSubdividedTexturedVertex>(vertices).asContiguous();
 
-            for(const UnsignedInt dataId: dataIds) {
+            for(const UnsignedInt dataId: vertexDataIds) {
                 const Implementation::BaseLayerData& data = state.data[dataId];
 
                 /* The texture coordinates are Y-flipped compared to the
@@ -890,9 +1612,10 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                 const Vector2 paddedQuadSize = vertices[dataId*16 + 12].position - vertices[dataId*16 + 0].position;
                 const Vector2 textureScale = data.textureCoordinateSize/paddedQuadSize*Vector2::yScale(-1.0f);
 
+                const Float layer = drawnTextureLayerInternal(dataId);
                 for(UnsignedByte i = 0; i != 4; ++i) {
                     const std::size_t index = dataId*16 + i *4;
-                    const Vector3 coordinate{Math::lerp(min, max, BitVector2{i}), data.textureCoordinateOffset.z()};
+                    const Vector3 coordinate{Math::lerp(min, max, BitVector2{i}), layer};
                     for(std::size_t j = 0; j != 4; ++j) {
                         texturedVertices[index + j].textureScale = textureScale;
                         texturedVertices[index + j].textureCoordinates = coordinate;
@@ -902,6 +1625,183 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         }
     }
 
+    /* Color-only update, as described above. The color is the same for all
+       vertices of given data and is the only vertex attribute that depends
+       on the node opacity. */
+    if(updateOpacityVertices) {
+        const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+        if(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads) {
+            const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerSubdividedTexturedVertex) :
+                sizeof(Implementation::BaseLayerSubdividedVertex);
+            const Containers::StridedArrayView1D<Implementation::BaseLayerSubdividedVertex> vertices{
+                state.vertices,
+                reinterpret_cast<Implementation::BaseLayerSubdividedVertex*>(state.vertices.data()),
+                state.vertices.size()/typeSize,
+                std::ptrdiff_t(typeSize)};
+            for(const UnsignedInt dataId: dataIds) {
+                const Color4 color = state.data[dataId].color*nodeOpacities[nodeHandleId(nodes[dataId])];
+                for(std::size_t i = 0; i != 16; ++i)
+                    vertices[dataId*16 + i].color = color;
+            }
+        } else if(sharedState.flags >= BaseLayerSharedFlag::CompactVertices) {
+            const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerCompactTexturedVertex) :
+                sizeof(Implementation::BaseLayerCompactVertex);
+            const Containers::StridedArrayView1D<Implementation::BaseLayerCompactVertex> vertices{
+                state.vertices,
+                reinterpret_cast<Implementation::BaseLayerCompactVertex*>(state.vertices.data()),
+                state.vertices.size()/typeSize,
+                std::ptrdiff_t(typeSize)};
+            for(const UnsignedInt dataId: dataIds) {
+                const Color4ub color = Math::pack<Color4ub>(Math::clamp(state.data[dataId].color*nodeOpacities[nodeHandleId(nodes[dataId])], 0.0f, 1.0f));
+                for(std::size_t i = 0; i != 4; ++i)
+                    vertices[dataId*4 + i].color = color;
+            }
+        } else {
+            const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerTexturedVertex) :
+                sizeof(Implementation::BaseLayerVertex);
+            const Containers::StridedArrayView1D<Implementation::BaseLayerVertex> vertices{
+                state.vertices,
+                reinterpret_cast<Implementation::BaseLayerVertex*>(state.vertices.data()),
+                state.vertices.size()/typeSize,
+                std::ptrdiff_t(typeSize)};
+            for(const UnsignedInt dataId: dataIds) {
+                const Color4 color = state.data[dataId].color*nodeOpacities[nodeHandleId(nodes[dataId])];
+                for(std::size_t i = 0; i != 4; ++i)
+                    vertices[dataId*4 + i].color = color;
+            }
+        }
+    }
+
+    /* Instanced quads have a single record per data, as described above */
+    if(updateInstances && !shaderNodeProperties) {
+        /* Resize the instance array to fit all drawn data, make a view on the
+           common type prefix */
+        const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerTexturedInstance) :
+            sizeof(Implementation::BaseLayerInstance);
+        arrayResize(state.vertices, NoInit, dataIds.size()*typeSize);
+        const Containers::StridedArrayView1D<Implementation::BaseLayerInstance> instances{
+            state.vertices,
+            reinterpret_cast<Implementation::BaseLayerInstance*>(state.vertices.data()),
+            dataIds.size(),
+            std::ptrdiff_t(typeSize)};
+
+        /* Convert smoothness from a pixel value to the UI coordinates */
+        const Float smoothness = sharedState.smoothness*(state.uiSize/Vector2{state.framebufferSize}).max();
+
+        /* Fill in the quad rectangles and colors. The padding and smoothness
+           expansion is done the same way as in the non-instanced case above,
+           the shader then only interpolates between the min and max. */
+        const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+        for(std::size_t i = 0; i != dataIds.size(); ++i) {
+            const UnsignedInt dataId = dataIds[i];
+            const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
+            const Implementation::BaseLayerData& data = state.data[dataId];
+
+            /* With texture streaming the style may be replaced with the
+               placeholder */
+            const UnsignedInt style = drawnStyleInternal(dataId);
+            Vector4 padding = data.padding - Vector4{smoothness};
+            if(style < sharedState.styleCount)
+                padding += sharedState.styles[style].padding;
+            else {
+                CORRADE_INTERNAL_DEBUG_ASSERT(style < sharedState.styleCount + sharedState.dynamicStyleCount);
+                padding += state.dynamicStylePaddings[style - sharedState.styleCount];
+            }
+
+            Implementation::BaseLayerInstance& instance = instances[i];
+            const Vector2 offset = nodeOffsets[nodeId];
+            instance.min = offset + padding.xy();
+            instance.max = offset + nodeSizes[nodeId] - Math::gather<'z', 'w'>(padding);
+            state.data[dataId].vertexNodeOffset = offset;
+            instance.outlineWidth = data.outlineWidth;
+            instance.color = data.color*nodeOpacities[nodeId];
+            /* For dynamic styles the uniform mapping is implicit and they're
+               placed right after all non-dynamic styles */
+            instance.styleUniform = style < sharedState.styleCount ?
+                sharedState.styles[style].uniform :
+                sharedState.styleUniformCount + style - sharedState.styleCount;
+        }
+
+        /* Fill in also quad texture coordinates if enabled, again with the
+           same expansion as in the non-instanced case */
+        if(sharedState.flags & BaseLayerSharedFlag::Textured) {
+            const Containers::ArrayView<Implementation::BaseLayerTexturedInstance> texturedInstances = Containers::arrayCast<Implementation::BaseLayerTexturedInstance>(instances).asContiguous();
+
+            for(std::size_t i = 0; i != dataIds.size(); ++i) {
+                const Implementation::BaseLayerData& data = state.data[dataIds[i]];
+                Implementation::BaseLayerTexturedInstance& instance = texturedInstances[i];
+
+                const Vector2 paddedQuadSizeWithoutSmoothness = instance.instance.max - instance.instance.min - Vector2{2.0f*smoothness};
+                const Vector2 smoothnessExpansion = data.textureCoordinateSize*smoothness/paddedQuadSizeWithoutSmoothness*Vector2::yScale(-1.0f);
+
+                /* Y-flipped compared to the positions, same as above */
+                instance.textureCoordinateMin = {data.textureCoordinateOffset.xy() + Vector2::yAxis(data.textureCoordinateSize.y()) - smoothnessExpansion, drawnTextureLayerInternal(dataIds[i])};
+                instance.textureCoordinateMax = data.textureCoordinateOffset.xy() + Vector2::xAxis(data.textureCoordinateSize.x()) + smoothnessExpansion;
+            }
+        }
+    }
+
+    /* With ShaderNodeProperties the instances contain the same as above, but
+       without anything that depends on the node offsets, sizes and opacities.
+       Those are supplied to the shader separately by BaseLayerGL. */
+    if(updateInstances && shaderNodeProperties) {
+        const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerTexturedNodeInstance) :
+            sizeof(Implementation::BaseLayerNodeInstance);
+        arrayResize(state.vertices, NoInit, dataIds.size()*typeSize);
+        const Containers::StridedArrayView1D<Implementation::BaseLayerNodeInstance> instances{
+            state.vertices,
+            reinterpret_cast<Implementation::BaseLayerNodeInstance*>(state.vertices.data()),
+            dataIds.size(),
+            std::ptrdiff_t(typeSize)};
+
+        /* Convert smoothness from a pixel value to the UI coordinates. It
+           changes only on a UI size change, which triggers NeedsDataUpdate,
+           so it can be baked into the padding. */
+        const Float smoothness = sharedState.smoothness*(state.uiSize/Vector2{state.framebufferSize}).max();
+
+        const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+        for(std::size_t i = 0; i != dataIds.size(); ++i) {
+            const UnsignedInt dataId = dataIds[i];
+            const Implementation::BaseLayerData& data = state.data[dataId];
+
+            const UnsignedInt style = drawnStyleInternal(dataId);
+            Vector4 padding = data.padding - Vector4{smoothness};
+            if(style < sharedState.styleCount)
+                padding += sharedState.styles[style].padding;
+            else {
+                CORRADE_INTERNAL_DEBUG_ASSERT(style < sharedState.styleCount + sharedState.dynamicStyleCount);
+                padding += state.dynamicStylePaddings[style - sharedState.styleCount];
+            }
+
+            Implementation::BaseLayerNodeInstance& instance = instances[i];
+            instance.padding = padding;
+            instance.outlineWidth = data.outlineWidth;
+            instance.color = data.color;
+            instance.styleUniform = style < sharedState.styleCount ?
+                sharedState.styles[style].uniform :
+                sharedState.styleUniformCount + style - sharedState.styleCount;
+            instance.nodeId = nodeHandleId(nodes[dataId]);
+        }
+
+        /* The texture coordinate smoothness expansion depends on the node
+           size, so it's done in the shader as well */
+        if(sharedState.flags & BaseLayerSharedFlag::Textured) {
+            const Containers::ArrayView<Implementation::BaseLayerTexturedNodeInstance> texturedInstances = Containers::arrayCast<Implementation::BaseLayerTexturedNodeInstance>(instances).asContiguous();
+
+            for(std::size_t i = 0; i != dataIds.size(); ++i) {
+                const Implementation::BaseLayerData& data = state.data[dataIds[i]];
+                Implementation::BaseLayerTexturedNodeInstance& instance = texturedInstances[i];
+                instance.textureCoordinateOffset = {data.textureCoordinateOffset.xy(), drawnTextureLayerInternal(dataIds[i])};
+                instance.textureCoordinateSize = data.textureCoordinateSize;
+            }
+        }
+    }
+
     /* Fill in quads for background blur. They're present only if the layer has
        background blur (and thus compositing) enabled and need to be updated
        only if the compositing rects actually changed */
@@ -921,7 +1821,22 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
            converted to be UI-size-relative. */
         /** @todo exclude the cutoff from this? how does the sqrt count into
             that? take a max of count*radiusWithCutoff and this? */
-        const Vector2 blurRadiusPadding = Math::sqrt(Float(state.backgroundBlurPassCount))*(sharedState.backgroundBlurRadius + sharedState.smoothness)*state.uiSize/Vector2{state.framebufferSize};
+        Float blurRadius;
+        if(sharedState.backgroundBlurAlgorithm == BaseLayerBackgroundBlurAlgorithm::DualKawase) {
+            /* For the dual Kawase blur the extent is given by the number of
+               downsampling levels instead. Each downsampling step reaches at
+               most one texel of its input in each direction, which is one
+               pixel of the original resolution for the first step, two for
+               the second etc., so 2^levelCount - 1 pixels in total. Each
+               upsampling step then reaches at most two texels of its input,
+               which is 2*(2^(levelCount + 1) - 2) pixels in total. Together
+               it's less than 5*2^levelCount. */
+            const UnsignedInt levelCount = Implementation::backgroundBlurDualKawaseLevelCount(sharedState.backgroundBlurRadius, state.backgroundBlurPassCount);
+            blurRadius = Float(5 << levelCount) + sharedState.smoothness;
+        } else {
+            blurRadius = Math::sqrt(Float(state.backgroundBlurPassCount))*(sharedState.backgroundBlurRadius + sharedState.smoothness);
+        }
+        const Vector2 blurRadiusPadding = blurRadius*state.uiSize/Vector2{state.framebufferSize};
 
         for(std::size_t i = 0; i != compositeRectOffsets.size(); ++i) {
             const Vector2 min = compositeRectOffsets[i] - blurRadiusPadding;
@@ -947,11 +1862,116 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         }
     }
 
+    /* Fill in opaque interiors of quads for the depth pre-pass if anything
+       that affects their position, their opacity or the draw order changed.
+       Unlike the vertices these are in draw order, as they're drawn without
+       an index buffer. Dynamic style uniforms, which can affect the opacity,
+       change with NeedsCommonDataUpdate. Keep the checks in sync with
+       BaseLayerGL::doPostUpdate(). */
+    if(sharedState.flags >= BaseLayerSharedFlag::OpaqueDepthPrepass && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+       states >= LayerState::NeedsNodeTranslationUpdate ||
+       states >= LayerState::NeedsNodeEnabledUpdate ||
+       states >= LayerState::NeedsNodeOpacityUpdate ||
+       states >= LayerState::NeedsDataUpdate ||
+       states >= LayerState::NeedsDataStyleUpdate ||
+       states >= LayerState::NeedsCommonDataUpdate))
+    {
+        /* Convert smoothness from a pixel value to the UI coordinates, same
+           as when filling the vertices */
+        const Float pixelSize = (state.uiSize/Vector2{state.framebufferSize}).max();
+        const Float smoothness = sharedState.smoothness*pixelSize;
+        const Float innerOutlineSmoothness = sharedState.innerOutlineSmoothness*pixelSize;
+        const Vector2 clipScale = Vector2{state.framebufferSize}/state.uiSize;
+
+        arrayResize(state.opaqueVertices, 0);
+        arrayResize(state.opaqueQuadOffsets, NoInit, dataIds.size() + 1);
+        const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+        std::size_t clipDataOffset = 0;
+        for(std::size_t i = 0; i != clipRectIds.size(); ++i) {
+            /* Convert the clip rect to framebuffer pixels the same way as the
+               scissor or the shader clipping does and then back, so the
+               opaque area never extends to pixels that get clipped away in
+               the actual draw */
+            const UnsignedInt clipRectId = clipRectIds[i];
+            const Range2Di framebufferClipRect = Implementation::framebufferClipRect(clipRectOffsets[clipRectId], clipRectSizes[clipRectId], clipScale, state.framebufferSize);
+            const Vector2 clipMin = Vector2{Float(framebufferClipRect.min().x()), Float(state.framebufferSize.y() - framebufferClipRect.max().y())}/clipScale;
+            const Vector2 clipMax = Vector2{Float(framebufferClipRect.max().x()), Float(state.framebufferSize.y() - framebufferClipRect.min().y())}/clipScale;
+
+            const std::size_t clipDataEnd = clipDataOffset + clipRectDataCounts[i];
+            for(std::size_t j = clipDataOffset; j != clipDataEnd; ++j) {
+                state.opaqueQuadOffsets[j] = state.opaqueVertices.size()/6;
+
+                const UnsignedInt dataId = dataIds[j];
+                const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
+                const Implementation::BaseLayerData& data = state.data[dataId];
+                if(data.color.a() < 1.0f || nodeOpacities[nodeId] < 1.0f)
+                    continue;
+
+                const UnsignedInt style = drawnStyleInternal(dataId);
+                Implementation::BaseLayerStyleOpacity opacity;
+                Vector4 padding = data.padding;
+                if(style < sharedState.styleCount) {
+                    opacity = sharedState.styleOpacities[sharedState.styles[style].uniform];
+                    padding += sharedState.styles[style].padding;
+                } else {
+                    CORRADE_INTERNAL_DEBUG_ASSERT(style < sharedState.styleCount + sharedState.dynamicStyleCount);
+                    opacity = styleOpacity(state.dynamicStyleUniforms[style - sharedState.styleCount], sharedState.flags);
+                    padding += state.dynamicStylePaddings[style - sharedState.styleCount];
+                }
+                if(!opacity.opaque)
+                    continue;
+
+                /* Skip the rounded corners and the smoothed out edge on all
+                   sides. If the outline isn't opaque, skip it as well,
+                   including the inner rounded corners and smoothness. */
+                Vector4 inset{opacity.cornerRadius + smoothness};
+                if(!opacity.outlineOpaque) {
+                    const Vector4 outlineWidth = sharedState.flags >= BaseLayerSharedFlag::NoOutline ?
+                        Vector4{} : opacity.outlineWidth + data.outlineWidth;
+                    if(!outlineWidth.isZero())
+                        inset = Math::max(inset, outlineWidth + Vector4{opacity.innerOutlineCornerRadius + innerOutlineSmoothness});
+                }
+
+                const Vector2 offset = nodeOffsets[nodeId];
+                const Vector2 min = Math::max(offset + padding.xy() + inset.xy(), clipMin);
+                const Vector2 max = Math::min(offset + nodeSizes[nodeId] - Math::gather<'z', 'w'>(padding) - Math::gather<'z', 'w'>(inset), clipMax);
+                if(!(min < max).all())
+                    continue;
+
+                /* 0---2 5
+                   |  / /|
+                   | / / |
+                   |/ /  |
+                   1 3---4 */
+                arrayAppend(state.opaqueVertices, {
+                    min,
+                    {min.x(), max.y()},
+                    {max.x(), min.y()},
+                    {min.x(), max.y()},
+                    max,
+                    {max.x(), min.y()}
+                });
+            }
+
+            clipDataOffset = clipDataEnd;
+        }
+
+        CORRADE_INTERNAL_ASSERT(clipDataOffset == dataIds.size());
+        state.opaqueQuadOffsets[dataIds.size()] = state.opaqueVertices.size()/6;
+    }
+
     /* Sync the style update stamp to not have doState() return NeedsDataUpdate
        / NeedsCommonDataUpdate again next time it's asked */
     if(states >= LayerState::NeedsDataUpdate ||
        states >= LayerState::NeedsCommonDataUpdate)
         state.styleUpdateStamp = sharedState.styleUpdateStamp;
+
+    /* The style changes are either patched above or included in a full
+       update, so the list isn't needed anymore */
+    if(states >= LayerState::NeedsDataStyleUpdate)
+        arrayResize(state.styleChangedDataIds, 0);
 }
 
 }}
@@ -27,7 +27,7 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Ui::BaseLayer, struct @ref Magnum::Ui::BaseLayerCommonStyleUniform, @ref Magnum::Ui::BaseLayerStyleUniform, enum @ref Magnum::Ui::BaseLayerSharedFlag, enum set @ref Magnum::Ui::BaseLayerSharedFlags
+ * @brief Class @ref Magnum::Ui::BaseLayer, struct @ref Magnum::Ui::BaseLayerCommonStyleUniform, @ref Magnum::Ui::BaseLayerStyleUniform, enum @ref Magnum::Ui::BaseLayerSharedFlag, @ref Magnum::Ui::BaseLayerBackgroundBlurAlgorithm, enum set @ref Magnum::Ui::BaseLayerSharedFlags
  * @m_since_latest
  */
 
@@ -635,6 +635,13 @@ atlas, the former is usable for incremental packing as well. Currently only a
 single texture can be used with the layer, if you need to draw from multiple
 textures, create additional layer instances.
 
+For large image galleries that don't fit into GPU memory at once, the layer can
+stream individual texture layers on demand with @ref setTextureStreaming().
+Only texture layers referenced by data that are actually drawn are then kept
+resident in a fixed number of texture slots, the least recently used ones get
+evicted and data with a texture layer that's still loading are drawn with a
+placeholder style.
+
 @subsection Ui-BaseLayer-style-background-blur Background blur
 
 @m_class{m-row m-container-inflate}
@@ -766,6 +773,13 @@ time:
 
 @snippet Ui.cpp BaseLayer-style-transitions-deduplicated
 
+A style transition caused by an input event results in
+@ref LayerState::NeedsDataStyleUpdate being set on the layer instead of
+@ref LayerState::NeedsDataUpdate and only vertices of data that changed their
+style are regenerated in the next @ref update(), unless
+@ref BaseLayerSharedFlag::InstancedQuads or texture streaming is used, in which
+case all vertices are regenerated.
+
 <b></b>
 
 @m_class{m-note m-info}
@@ -786,6 +800,22 @@ features were not specified in any style nor supplied via
 texture / icon layer which don't make use of any outlines or rounded corners,
 and depending on the platform this can significantly reduce shader complexity.
 
+Additionally, unless @ref BaseLayerSharedFlag::SubdividedQuads or
+@relativeref{BaseLayerSharedFlag,StableIndices} is enabled, the layer splits the
+draw order into runs of data whose style has a zero corner radius or a zero
+outline width, with data having a non-zero @ref setOutlineWidth() counted as
+using an outline and data with dynamic styles counted as using both.
+@ref BaseLayerGL then draws each such run with a shader variant that has the
+equivalent optimizations enabled. The draw order is preserved, so the output is
+the same as when drawing everything with a single shader, at the cost of a
+draw call for each run. The variants are compiled on demand and the generic
+shader is used until they're ready. If no style in @ref Shared::setStyle() uses
+given feature, the variant is compiled right away. The
+@ref BaseLayerSharedFlag::NoOutline and
+@relativeref{BaseLayerSharedFlag,NoRoundedCorners} flags are thus mainly
+useful if the styles set up outlines or rounded corners that are never actually
+wanted, or to avoid the extra draw calls.
+
 @htmlinclude ui-baselayer-subdivided-quads.svg
 
 By default, each quad is literally two triangles, and positioning of the
@@ -799,6 +829,26 @@ a lot more data needs to be uploaded to the GPU, so this flag is only useful
 when the gains in fragment processing time outweigh the additional vertex data
 overhead.
 
+On the other hand, if the layer contains a large amount of data, the vertex and
+index data size may become the bottleneck. With
+@ref BaseLayerSharedFlag::InstancedQuads each data is drawn as an instance of a
+single static quad, making the per-data GPU memory four times smaller and not
+needing any index buffer. In particular, changing the draw order then doesn't
+involve regenerating any index data. Alternatively, with
+@ref BaseLayerSharedFlag::StableIndices the regular quads are kept but the index
+buffer stays in the order of data IDs, with draw order changes being handled by
+a multi-draw of ranges of consecutive data.
+
+If node offsets, sizes or opacities change often, such as when scrolling or
+animating, @ref BaseLayerSharedFlag::ShaderNodeProperties additionally applies
+them in the shader. The per-data instances then stay the same and only a
+compact record for each changed node is uploaded to the GPU.
+
+With many clip rects, such as when there are many small scroll areas, the
+layer is drawn with a separate draw call for each clip rect by default. With
+@ref BaseLayerSharedFlag::ShaderClipping the clipping is done in the shader
+instead and the whole layer is drawn in a single draw call.
+
 In case of background blur, smaller blur radii need less texture samples and
 thus are faster. Besides that, the second argument passed to
 @ref BaseLayer::Shared::Configuration::setBackgroundBlurRadius() is a cutoff
@@ -809,6 +859,22 @@ framebuffer. With a higher threshold the processing will get faster in exchange
 for decreased blur quality. Finally, @ref setBackgroundBlurPassCount() can be
 used to perform a blur of smaller radius in multiple passes, in case a bigger
 radius is hitting hardware or implementation limits.
+
+For large blur radii or high-resolution framebuffers, setting
+@ref BaseLayerBackgroundBlurAlgorithm::DualKawase through
+@ref BaseLayer::Shared::Configuration::setBackgroundBlurAlgorithm() performs
+the blur on progressively downsampled copies of the framebuffer instead, at a
+fraction of the cost and with a visually comparable result. If the content
+underneath the blurred areas changes only rarely, enabling
+@ref BaseLayerSharedFlag::BackgroundBlurCache skips the blur entirely when
+neither the content nor the blurred areas changed since the last frame.
+
+Finally, if the vertex data fill and upload is a bottleneck for layers with
+many data, @ref BaseLayerSharedFlag::CompactVertices makes the vertex data
+nearly two times smaller in exchange for a reduced precision of the data color.
+For layers with dynamic styles that get animated, such as with
+@ref BaseLayerStyleAnimator, @ref BaseLayerSharedFlag::RingBufferedDynamicStyles
+avoids stalls when writing to a style buffer that's still used by the GPU.
 */
 class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
     public:
@@ -1045,6 +1111,29 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
          */
         void setColor(LayerDataHandle handle, const Color4& color);
 
+        /**
+         * @brief Set custom base colors of multiple quads
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setColor(DataHandle, const Color4&) for
+         * each item in @p handles and @p colors, but with the layer marked
+         * with @ref LayerState::NeedsDataUpdate just once and only if
+         * @p handles is non-empty. Expects that the @p handles and @p colors
+         * views have the same size and that all handles are valid. The handles
+         * are all checked before anything is updated.
+         */
+        void setColor(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors);
+
+        /**
+         * @brief Set custom base colors of multiple quads assuming they belong to this layer
+         * @m_since_latest
+         *
+         * Like @ref setColor(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StridedArrayView1D<const Color4>&)
+         * but without checking that @p handles indeed belong to this layer.
+         * See its documentation for more information.
+         */
+        void setColor(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors);
+
         /**
          * @brief Custom quad outline width
          *
@@ -1110,6 +1199,30 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
             setOutlineWidth(handle, Vector4{width});
         }
 
+        /**
+         * @brief Set custom outline widths of multiple quads
+         * @m_since_latest
+         *
+         * Equivalent to calling
+         * @ref setOutlineWidth(DataHandle, const Vector4&) for each item in
+         * @p handles and @p widths, but with the layer marked with
+         * @ref LayerState::NeedsDataUpdate just once and only if @p handles is
+         * non-empty. Expects that the @p handles and @p widths views have the
+         * same size and that all handles are valid. The handles are all
+         * checked before anything is updated.
+         */
+        void setOutlineWidth(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& widths);
+
+        /**
+         * @brief Set custom outline widths of multiple quads assuming they belong to this layer
+         * @m_since_latest
+         *
+         * Like @ref setOutlineWidth(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StridedArrayView1D<const Vector4>&)
+         * but without checking that @p handles indeed belong to this layer.
+         * See its documentation for more information.
+         */
+        void setOutlineWidth(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& widths);
+
         /**
          * @brief Custom quad padding
          *
@@ -1174,6 +1287,29 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
             setPadding(handle, Vector4{padding});
         }
 
+        /**
+         * @brief Set custom paddings of multiple quads
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setPadding(DataHandle, const Vector4&)
+         * for each item in @p handles and @p paddings, but with the layer
+         * marked with @ref LayerState::NeedsDataUpdate just once and only if
+         * @p handles is non-empty. Expects that the @p handles and @p paddings
+         * views have the same size and that all handles are valid. The handles
+         * are all checked before anything is updated.
+         */
+        void setPadding(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& paddings);
+
+        /**
+         * @brief Set custom paddings of multiple quads assuming they belong to this layer
+         * @m_since_latest
+         *
+         * Like @ref setPadding(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StridedArrayView1D<const Vector4>&)
+         * but without checking that @p handles indeed belong to this layer.
+         * See its documentation for more information.
+         */
+        void setPadding(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& paddings);
+
         /**
          * @brief Quad texture coordinate offset
          *
@@ -1239,6 +1375,109 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
          */
         void setTextureCoordinates(LayerDataHandle handle, const Vector3& offset, const Vector2& size);
 
+        /**
+         * @brief Count of streamed texture layers
+         * @m_since_latest
+         *
+         * If texture streaming isn't enabled, returns @cpp 0 @ce.
+         * @see @ref setTextureStreaming()
+         */
+        UnsignedInt textureStreamingLayerCount() const;
+
+        /**
+         * @brief Count of texture slots used for streamed texture layers
+         * @m_since_latest
+         *
+         * If texture streaming isn't enabled, returns @cpp 0 @ce.
+         * @see @ref setTextureStreaming()
+         */
+        UnsignedInt textureStreamingSlotCount() const;
+
+        /**
+         * @brief Enable texture layer streaming
+         * @m_since_latest
+         * @param layerCount        Count of streamed texture layers
+         * @param slotCount         Count of texture slots the layers are
+         *      streamed into
+         * @param placeholderStyle  Style to use for data whose texture layer
+         *      isn't resident
+         * @param loader            Function loading a texture layer into a
+         *      slot
+         *
+         * Useful for image galleries and other cases where the data reference
+         * far more images than what can fit into GPU memory at once. The
+         * third coordinate of the offset passed to
+         * @ref setTextureCoordinates() is then a streamed texture layer index
+         * in range @cpp [0, layerCount) @ce instead of an actual texture
+         * layer. The texture bound with @ref BaseLayerGL::setTexture() is
+         * expected to have @cpp slotCount + 1 @ce layers, with the slots
+         * occupying the first @p slotCount layers and the last layer
+         * containing a placeholder image.
+         *
+         * On every @ref update() that fills the vertex data, the layer goes
+         * through all data that are drawn, i.e. after culling, and for every
+         * texture layer that isn't resident it picks either a free slot or
+         * the least recently used slot that isn't needed by any drawn data,
+         * and calls @p loader with the texture layer index and the slot. The
+         * loader is expected to either upload the texture layer to the slot
+         * and return @cpp true @ce, or schedule an asynchronous load, return
+         * @cpp false @ce and call @ref setTextureLayerLoaded() once the upload
+         * is done. Slots that are still loading are not evicted. The loader
+         * shouldn't modify the layer in any way. If there's more texture
+         * layers needed than there's slots, the remaining layers are
+         * requested in the next update, once other slots stop being used.
+         *
+         * If the layer advertises @ref LayerFeature::ConcurrentUpdate, which
+         * is the case with @ref BaseLayerGL, its @ref update() may run on a
+         * different thread if @ref AbstractUserInterface::setUpdateExecutor()
+         * is set. Because of that, the slots are then only picked in
+         * @ref update() and @p loader is called from @ref postUpdate(), which
+         * is always called on the thread the user interface is updated on.
+         * Data using the newly loaded layers get drawn with them in the
+         * following update, as a successful load causes
+         * @ref LayerState::NeedsDataUpdate to be set.
+         *
+         * Data with a texture layer that isn't resident yet are drawn with
+         * @p placeholderStyle instead of their own style and with the same
+         * texture coordinates relative to the placeholder layer. Expects that
+         * @ref BaseLayerSharedFlag::Textured was enabled for the shared state
+         * the layer was created with, that @p slotCount is non-zero,
+         * @p placeholderStyle is less than
+         * @ref Shared::totalStyleCount() and @p loader is not
+         * @cpp nullptr @ce. Calling this function again discards all
+         * residency information. Existing data that reference texture layers
+         * outside of @p layerCount are always drawn with the placeholder.
+         *
+         * Calling this function causes @ref LayerState::NeedsDataUpdate to be
+         * set.
+         */
+        BaseLayer& setTextureStreaming(UnsignedInt layerCount, UnsignedInt slotCount, UnsignedInt placeholderStyle, Containers::Function<bool(UnsignedInt layer, UnsignedInt slot)>&& loader);
+
+        /**
+         * @brief Texture slot a streamed texture layer is resident in
+         * @m_since_latest
+         *
+         * Expects that texture streaming is enabled and @p layer is less
+         * than @ref textureStreamingLayerCount(). If the layer isn't
+         * resident or its load isn't finished yet, returns
+         * @relativeref{Corrade,Containers::NullOpt}.
+         * @see @ref setTextureStreaming()
+         */
+        Containers::Optional<UnsignedInt> textureStreamingSlot(UnsignedInt layer) const;
+
+        /**
+         * @brief Mark an asynchronously loaded texture layer as loaded
+         * @m_since_latest
+         *
+         * Expects that texture streaming is enabled and @p layer is less
+         * than @ref textureStreamingLayerCount(). Meant to be called after the
+         * loader passed to @ref setTextureStreaming() returned @cpp false @ce
+         * and the texture layer was uploaded to the slot. If the layer is not
+         * loading, the function does nothing, otherwise it causes
+         * @ref LayerState::NeedsDataUpdate to be set.
+         */
+        BaseLayer& setTextureLayerLoaded(UnsignedInt layer);
+
     #ifdef DOXYGEN_GENERATING_OUTPUT
     private:
     #else
@@ -1253,13 +1492,24 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
         /* These can't be MAGNUM_UI_LOCAL otherwise deriving from this class
            in tests causes linker errors */
 
-        /* Advertises LayerFeature::Draw (and Composite if BackgroundBlur is
-           enabled) but *does not* implement doDraw() or doComposite(), that's
-           on the subclass */
+        /* Advertises LayerFeature::Draw and NodeTranslation (and Composite
+           if BackgroundBlur is enabled) but *does not* implement doDraw() or
+           doComposite(), that's on the subclass */
         LayerFeatures doFeatures() const override;
+        /* Reports the CPU-side data, vertex and index storage, GPU usage is
+           on the subclass */
+        MemoryUsage doMemoryUsage() const override;
+        /* Shrinks the CPU-side data, vertex and index storage */
+        void doTrim(std::size_t capacity) override;
+        /* Reserves the CPU-side data storage */
+        void doReserve(std::size_t capacity) override;
 
         void doSetSize(const Vector2& size, const Vector2i& framebufferSize) override;
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
+        /* Calls the texture streaming loader for layers requested in
+           doUpdate() if the subclass advertises
+           LayerFeature::ConcurrentUpdate. Should be called by subclasses. */
+        void doPostUpdate(LayerStates states) override;
 
     private:
         MAGNUM_UI_LOCAL void setColorInternal(UnsignedInt id, const Color4& color);
@@ -1268,6 +1518,9 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
         MAGNUM_UI_LOCAL Vector3 textureCoordinateOffsetInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL Vector2 textureCoordinateSizeInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL void setTextureCoordinatesInternal(UnsignedInt id, const Vector3& offset, const Vector2& size);
+        MAGNUM_UI_LOCAL void updateTextureStreaming(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds);
+        MAGNUM_UI_LOCAL UnsignedInt drawnStyleInternal(UnsignedInt id) const;
+        MAGNUM_UI_LOCAL Float drawnTextureLayerInternal(UnsignedInt id) const;
 
         /* These can't be MAGNUM_UI_LOCAL otherwise deriving from this class
            in tests causes linker errors */
@@ -1283,7 +1536,7 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
     @ref BaseLayer::Shared::Configuration::setFlags(),
     @ref BaseLayer::Shared::flags()
 */
-enum class BaseLayerSharedFlag: UnsignedByte {
+enum class BaseLayerSharedFlag: UnsignedShort {
     /**
      * Textured drawing. If enabled, the @ref BaseLayerStyleUniform::topColor
      * and @relativeref{BaseLayerStyleUniform,bottomColor} is multiplied with a
@@ -1401,9 +1654,170 @@ enum class BaseLayerSharedFlag: UnsignedByte {
      * wasn't bottlenecked by fragment shading.
      *
      * Mutually exclusive with the @ref BaseLayerSharedFlag::NoRoundedCorners
-     * and @relativeref{BaseLayerSharedFlag,NoOutline} optimizations.
+     * and @relativeref{BaseLayerSharedFlag,NoOutline} optimizations and with
+     * @ref BaseLayerSharedFlag::InstancedQuads.
      */
     SubdividedQuads = 1 << 5,
+
+    /**
+     * Render each quad as a single instance of a static unit quad, with
+     * position, color, outline width, style and texture coordinates supplied
+     * just once per data instead of once per vertex. Compared to the default
+     * this uploads four times less vertex data and no index data at all,
+     * which is useful for layers with a large amount of data such as grids or
+     * heatmaps. The visual output is exactly the same as with the default.
+     *
+     * In @ref BaseLayerGL requires @gl_extension{ARB,base_instance} on
+     * desktop GL, ANGLE_base_vertex_base_instance on OpenGL ES and
+     * @webgl_extension{WEBGL,draw_instanced_base_vertex_base_instance} on
+     * WebGL. Mutually exclusive with
+     * @ref BaseLayerSharedFlag::SubdividedQuads and
+     * @relativeref{BaseLayerSharedFlag,StableIndices}.
+     */
+    InstancedQuads = 1 << 6,
+
+    /**
+     * Keep the index buffer in the order of data IDs instead of the draw
+     * order, and draw runs of data with consecutive IDs using a multi-draw.
+     * The index buffer then has to be updated only when the layer capacity
+     * changes and not on every node order change, such as when bringing a
+     * top-level node to front with @ref AbstractUserInterface::setNodeOrder().
+     * On the other hand, the arrangement of data created in a random order
+     * may result in many short runs, each being a separate draw in the
+     * multi-draw.
+     *
+     * Mutually exclusive with @ref BaseLayerSharedFlag::InstancedQuads.
+     */
+    StableIndices = 1 << 7,
+
+    /**
+     * Perform clipping in the shader instead of using a scissor rectangle for
+     * each clip rect. The framebuffer-space clip rect is supplied together
+     * with each vertex and the fragment shader discards everything outside of
+     * it, which allows all data in a layer to be drawn with a single draw
+     * call regardless of how many clip rects there are. Useful for UIs with
+     * many small scroll areas especially on platforms where draw call
+     * overhead dominates, such as WebGL. The visual output is exactly the
+     * same as with the default. On the other hand, the clip rects are then
+     * a part of the vertex data, so they have to be updated on every node
+     * offset or size change and on every framebuffer size change as well.
+     *
+     * In @ref BaseLayerGL the layer then doesn't advertise
+     * @ref LayerFeature::DrawUsesScissor.
+     */
+    ShaderClipping = 1 << 8,
+
+    /**
+     * Enables background blur and caches its result. If neither the
+     * @ref RendererGL::compositingContentGeneration() nor the composite rects
+     * nor @ref BaseLayer::setBackgroundBlurPassCount() changed since the
+     * last blur done by given layer, the blur is skipped and the previous
+     * result is reused. Useful for example for a blurred sidebar over a
+     * mostly static background, where the application calls
+     * @ref RendererGL::incrementCompositingContentGeneration() only when the
+     * background actually changes.
+     *
+     * The cache is shared by all layers created from the same
+     * @ref BaseLayer::Shared instance and holds just the result of the last
+     * blur, so if there are multiple layers with background blur sharing the
+     * same instance, or a single layer is composited more than once in a
+     * frame, the cache is effectively unused. As the renderer conservatively
+     * assumes the framebuffer contents changed every time any layer is drawn
+     * before the compositing operation, the cache is also unused if any
+     * other layers are drawn underneath.
+     * @see @ref BaseLayerSharedFlag::BackgroundBlur
+     */
+    BackgroundBlurCache = BackgroundBlur|(1 << 9),
+
+    /**
+     * Use a compact vertex layout, with the center distance and outline width
+     * stored as half-floats, the color as a normalized 8-bit value and the
+     * style uniform index as a 16-bit integer. Compared to the default the
+     * vertex size shrinks from 52 to 28 bytes, or from 64 to 40 bytes with
+     * @ref BaseLayerSharedFlag::Textured, making both the vertex data fill
+     * and the upload faster for layers with a large amount of data. Vertex
+     * positions and texture coordinates stay at full precision in order to
+     * not introduce any visible rounding errors for large UI sizes, the data
+     * color is however clamped to the @f$ [0, 1] @f$ range and has just an
+     * 8-bit precision. Apart from that, the visual output is the same as with
+     * the default.
+     *
+     * Expects that the sum of
+     * @ref BaseLayer::Shared::Configuration::styleUniformCount() and
+     * @relativeref{BaseLayer::Shared::Configuration,dynamicStyleCount()} fits
+     * into 16 bits. Mutually exclusive with
+     * @ref BaseLayerSharedFlag::SubdividedQuads and
+     * @relativeref{BaseLayerSharedFlag,InstancedQuads}.
+     */
+    CompactVertices = 1 << 10,
+
+    /**
+     * Ring-buffer the dynamic style uniforms. By default, each layer has a
+     * single buffer for the static and dynamic style uniforms, which is
+     * written to every time a dynamic style changes. If the GPU is still
+     * reading the buffer for a previous frame, the write may cause the driver
+     * to stall or to make a copy of the buffer. With this flag enabled, the
+     * layer cycles through three buffers instead, writing to a different one
+     * every time the styles are updated. Useful especially in combination
+     * with @ref BaseLayerStyleAnimator, which changes dynamic styles on every
+     * frame, at the cost of three times the memory for the style uniforms.
+     *
+     * In both cases only the dynamic styles that differ from what was
+     * uploaded to given buffer last time are uploaded. Has no effect if
+     * @ref BaseLayer::Shared::Configuration::dynamicStyleCount() is zero, as
+     * then the style buffer is shared among all layers and changes only on
+     * @ref BaseLayer::Shared::setStyle().
+     */
+    RingBufferedDynamicStyles = 1 << 11,
+
+    /**
+     * Draw depth of opaque interiors of the quads in a pre-pass, allowing a
+     * renderer with @ref RendererFeature::DepthBuffer to reject content
+     * hidden underneath. Advertises @ref LayerFeature::DrawOpaque.
+     *
+     * A quad is considered opaque if both
+     * @ref BaseLayerStyleUniform::topColor and
+     * @relativeref{BaseLayerStyleUniform,bottomColor} of its style and the
+     * color set with @ref BaseLayer::setColor() have a full alpha and its
+     * node has a full opacity. Its opaque interior is then the quad area
+     * without the rounded corners and the smoothness, and additionally
+     * without the outline if @ref BaseLayerStyleUniform::outlineColor isn't
+     * fully opaque. The interior is clipped to the node clip rect directly.
+     * The opaque areas are recalculated on every data, node and style change,
+     * at the cost of extra CPU time and memory for the additional vertex
+     * data. Mutually exclusive with @ref BaseLayerSharedFlag::Textured and
+     * @relativeref{BaseLayerSharedFlag,BackgroundBlur}, as there the
+     * resulting opacity isn't known on the CPU side. See
+     * @ref Ui-RendererGL-depth-buffer for more information.
+     */
+    OpaqueDepthPrepass = 1 << 12,
+
+    /**
+     * Render the quads as instances like with
+     * @ref BaseLayerSharedFlag::InstancedQuads, but apply node offsets, sizes
+     * and opacities in the shader instead of baking them into the instance
+     * data. Each instance then references just the node it's attached to,
+     * with the quad padding, color without the node opacity applied, outline
+     * width, style and texture coordinates being independent of node
+     * properties. The absolute quad position, the texture coordinate
+     * smoothness expansion and the node opacity are calculated in the vertex
+     * shader. A node offset, size or opacity change, such as when scrolling,
+     * animating a layout or fading a whole top-level node with
+     * @ref AbstractUserInterface::setNodeOpacity(), then only uploads the
+     * changed node properties, with the instance data staying the same. The
+     * visual output is the same as with the default.
+     *
+     * The node enabled state affects the style the data is drawn with and
+     * thus isn't handled in the shader. With
+     * @ref BaseLayerSharedFlag::ShaderClipping the clip rects are still
+     * calculated on the CPU and uploaded on every node offset or size change.
+     *
+     * In @ref BaseLayerGL the node properties are stored in a floating-point
+     * texture, which is fetched from in the vertex shader. Implies
+     * @ref BaseLayerSharedFlag::InstancedQuads and has the same requirements.
+     * @m_since_latest
+     */
+    ShaderNodeProperties = InstancedQuads|(1 << 13),
 };
 
 /**
@@ -1429,6 +1843,51 @@ MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, BaseLayerSharedFlag value);
 */
 MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, BaseLayerSharedFlags value);
 
+/**
+@brief Base layer background blur algorithm
+@m_since_latest
+
+@see @ref BaseLayer::Shared::Configuration::setBackgroundBlurAlgorithm(),
+    @ref BaseLayerSharedFlag::BackgroundBlur
+*/
+enum class BaseLayerBackgroundBlurAlgorithm: UnsignedByte {
+    /**
+     * Separable Gaussian blur done at full framebuffer resolution. The radius
+     * and cutoff set with
+     * @ref BaseLayer::Shared::Configuration::setBackgroundBlurRadius() control
+     * the number of samples taken for each pixel in each pass, the cost is
+     * thus proportional to the radius, pass count and the framebuffer size.
+     * This is the default.
+     */
+    Gaussian,
+
+    /**
+     * Dual Kawase blur. The framebuffer contents are progressively
+     * downsampled to half the resolution in each step, with five bilinear
+     * samples per output pixel, and then upsampled back with eight bilinear
+     * samples per output pixel. As every step operates on a quarter of the
+     * pixels of the previous one, the cost is dominated by the first
+     * downsampling step and grows only very slowly with the blur radius,
+     * making it significantly faster than @ref BaseLayerBackgroundBlurAlgorithm::Gaussian
+     * for large radii or high-resolution framebuffers.
+     *
+     * The number of downsampling steps is chosen so the blur extent matches
+     * the radius set with
+     * @ref BaseLayer::Shared::Configuration::setBackgroundBlurRadius() and
+     * the pass count set with @ref BaseLayer::setBackgroundBlurPassCount()
+     * as closely as possible. As the extent doubles with each step, the
+     * result is only an approximation of the Gaussian blur, with the
+     * granularity being a power of two. The cutoff value is ignored.
+     */
+    DualKawase
+};
+
+/**
+@debugoperatorenum{BaseLayerBackgroundBlurAlgorithm}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, BaseLayerBackgroundBlurAlgorithm value);
+
 /**
 @brief Shared state for the base layer
 
@@ -1522,6 +1981,32 @@ class MAGNUM_UI_EXPORT BaseLayer::Shared: public AbstractVisualLayer::Shared {
         /** @overload */
         Shared& setStyle(const BaseLayerCommonStyleUniform& commonUniform, std::initializer_list<BaseLayerStyleUniform> uniforms, std::initializer_list<UnsignedInt> styleToUniform, std::initializer_list<Vector4> stylePaddings);
 
+        /**
+         * @brief Update style uniform data
+         * @param commonUniform Common style uniform data
+         * @param uniforms      Style uniforms
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Compared to @ref setStyle(), replaces just the uniform data, keeping
+         * the style to uniform mapping and paddings unchanged. Useful for
+         * example for switching between a dark and a light variant of the
+         * same style at runtime. Expects that @ref setStyle() was called
+         * before and that the @p uniforms view has the same size as
+         * @ref styleUniformCount().
+         *
+         * If @ref dynamicStyleCount() is zero and the new uniforms don't
+         * change the smoothness, the set of shader features used by each
+         * uniform and, with @ref BaseLayerSharedFlag::OpaqueDepthPrepass, the
+         * opaque area of each uniform, the data are only uploaded to the
+         * uniform buffer, without causing any update in the layers. Otherwise
+         * it causes the same layer state updates as @ref setStyle().
+         * @see @ref AbstractStyle::applyUniforms()
+         */
+        Shared& setStyleUniforms(const BaseLayerCommonStyleUniform& commonUniform, Containers::ArrayView<const BaseLayerStyleUniform> uniforms);
+        /** @overload */
+        Shared& setStyleUniforms(const BaseLayerCommonStyleUniform& commonUniform, std::initializer_list<BaseLayerStyleUniform> uniforms);
+
         /* Overloads to remove a WTF factor from method chaining order */
         #ifndef DOXYGEN_GENERATING_OUTPUT
         MAGNUMEXTRAS_UI_ABSTRACTVISUALLAYER_SHARED_SUBCLASS_IMPLEMENTATION()
@@ -1682,12 +2167,57 @@ class MAGNUM_UI_EXPORT BaseLayer::Shared::Configuration {
          */
         Configuration& setBackgroundBlurRadius(UnsignedInt radius, Float cutoff = 0.5f/255.0f);
 
+        /** @brief Background blur algorithm */
+        BaseLayerBackgroundBlurAlgorithm backgroundBlurAlgorithm() const {
+            return _backgroundBlurAlgorithm;
+        }
+
+        /**
+         * @brief Set background blur algorithm
+         * @return Reference to self (for method chaining)
+         *
+         * Used only if @ref BaseLayerSharedFlag::BackgroundBlur is enabled.
+         * With @ref BaseLayerBackgroundBlurAlgorithm::DualKawase the radius
+         * passed to @ref setBackgroundBlurRadius() together with the pass
+         * count set with @ref BaseLayer::setBackgroundBlurPassCount() is
+         * used to pick the number of downsampling steps, the cutoff is
+         * ignored. Initial value is
+         * @ref BaseLayerBackgroundBlurAlgorithm::Gaussian.
+         */
+        Configuration& setBackgroundBlurAlgorithm(BaseLayerBackgroundBlurAlgorithm algorithm) {
+            _backgroundBlurAlgorithm = algorithm;
+            return *this;
+        }
+
+        /** @brief Background blur downscale factor */
+        UnsignedInt backgroundBlurDownscale() const {
+            return _backgroundBlurDownscale;
+        }
+
+        /**
+         * @brief Set background blur downscale factor
+         * @return Reference to self (for method chaining)
+         *
+         * Used only if @ref BaseLayerSharedFlag::BackgroundBlur is enabled.
+         * The blur is calculated in textures that are @p factor times
+         * smaller than the framebuffer in each dimension, with the result
+         * being linearly upsampled when drawn. The area being processed is
+         * thus @p factor squared times smaller, at the cost of high-frequency
+         * details getting lost, which is usually invisible with any larger
+         * blur radius. The blur radius stays the same relative to the
+         * framebuffer size. Expects that the @p factor is non-zero, initial
+         * value is @cpp 1 @ce, i.e. no downscaling.
+         */
+        Configuration& setBackgroundBlurDownscale(UnsignedInt factor);
+
     private:
         UnsignedInt _styleUniformCount, _styleCount;
         UnsignedInt _dynamicStyleCount = 0;
         BaseLayerSharedFlags _flags;
         UnsignedInt _backgroundBlurRadius = 4;
         Float _backgroundBlurCutoff = 0.5f/255.0f;
+        BaseLayerBackgroundBlurAlgorithm _backgroundBlurAlgorithm = BaseLayerBackgroundBlurAlgorithm::Gaussian;
+        UnsignedInt _backgroundBlurDownscale = 1;
 };
 
 inline BaseLayer::Shared& BaseLayer::shared() {
@@ -26,7 +26,10 @@
 
 #include "BaseLayerAnimator.h"
 
+#include <cstddef> /* offsetof() */
+#include <cstring> /* std::memcmp() */
 #include <Corrade/Containers/ArrayTuple.h>
+#include <Corrade/Containers/BitArray.h>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/EnumSet.hpp>
 #include <Corrade/Containers/GrowableArray.h>
@@ -38,9 +41,17 @@
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/Implementation/abstractVisualLayerAnimatorState.h"
 #include "Magnum/Ui/Implementation/baseLayerState.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
+#include "Magnum/Ui/Implementation/lerpFloats.h"
 
 namespace Magnum { namespace Ui {
 
+/* Interpolated as a single run of floats in advance() */
+static_assert(
+    offsetof(BaseLayerStyleUniform, topColor) == 0 &&
+    sizeof(BaseLayerStyleUniform) == 6*4*sizeof(Float),
+    "unexpected BaseLayerStyleUniform layout");
+
 Debug& operator<<(Debug& debug, const BaseLayerStyleAnimation value) {
     debug << "Ui::BaseLayerStyleAnimation" << Debug::nospace;
 
@@ -74,6 +85,9 @@ struct Animation {
     BaseLayerStyleUniform sourceUniform{NoInit}, targetUniform{NoInit};
     Vector4 sourcePadding{NoInit}, targetPadding{NoInit};
     UnsignedInt targetStyle, dynamicStyle;
+    /* Circular list of animations sharing the same dynamic style, pointing
+       to itself if not shared. Accessed through the base state views. */
+    UnsignedInt dynamicStyleNext, dynamicStylePrevious;
     bool uniformDifferent;
     /* 3/7 bytes free */
     Float(*easing)(Float);
@@ -83,6 +97,16 @@ struct Animation {
 
 struct BaseLayerStyleAnimator::State: AbstractVisualLayerStyleAnimator::State {
     Containers::Array<Animation> animations;
+
+    /* Temporaries used in advance() for sharing dynamic styles among
+       animations that are the same. Animations that allocated a dynamic style
+       in the current advance() as candidates to share it with, and for each
+       dynamic style bits marking whether it was already interpolated in
+       current advance(), together with ID of the animation that did it. The
+       latter two are sized to match the dynamic style count. */
+    Containers::Array<UnsignedInt> dynamicStyleAllocatedAnimations;
+    Containers::BitArray dynamicStylesAdvanced;
+    Containers::Array<UnsignedInt> dynamicStyleLeaders;
 };
 
 BaseLayerStyleAnimator::BaseLayerStyleAnimator(AnimatorHandle handle): AbstractVisualLayerStyleAnimator{handle, Containers::pointer<State>()} {}
@@ -140,10 +164,14 @@ void BaseLayerStyleAnimator::createInternal(const AnimationHandle handle, const
         arrayResize(state.animations, NoInit, id + 1);
         state.targetStyles = stridedArrayView(state.animations).slice(&Animation::targetStyle);
         state.dynamicStyles = stridedArrayView(state.animations).slice(&Animation::dynamicStyle);
+        state.dynamicStyleNext = stridedArrayView(state.animations).slice(&Animation::dynamicStyleNext);
+        state.dynamicStylePrevious = stridedArrayView(state.animations).slice(&Animation::dynamicStylePrevious);
     }
     Animation& animation = state.animations[id];
     animation.targetStyle = targetStyle;
     animation.dynamicStyle = ~UnsignedInt{};
+    animation.dynamicStyleNext = id;
+    animation.dynamicStylePrevious = id;
     animation.easing = easing;
 
     const Implementation::BaseLayerStyle& sourceStyleData = layerSharedState.styles[sourceStyle];
@@ -160,6 +188,16 @@ void BaseLayerStyleAnimator::createInternal(const AnimationHandle handle, const
     animation.uniformDifferent = sourceStyleData.uniform != targetStyleData.uniform;
 }
 
+void BaseLayerStyleAnimator::doReserve(const std::size_t capacity) {
+    State& state = static_cast<State&>(*_state);
+    arrayReserve(state.animations, capacity);
+    /* The reallocation may have moved the data */
+    state.targetStyles = stridedArrayView(state.animations).slice(&Animation::targetStyle);
+    state.dynamicStyles = stridedArrayView(state.animations).slice(&Animation::dynamicStyle);
+    state.dynamicStyleNext = stridedArrayView(state.animations).slice(&Animation::dynamicStyleNext);
+    state.dynamicStylePrevious = stridedArrayView(state.animations).slice(&Animation::dynamicStylePrevious);
+}
+
 void BaseLayerStyleAnimator::remove(const AnimationHandle handle) {
     AbstractAnimator::remove(handle);
     removeInternal(animationHandleId(handle));
@@ -226,11 +264,74 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
     const BaseLayer::Shared::State& layerSharedState = static_cast<const BaseLayer::Shared::State&>(*state.layerSharedState);
     const Containers::StridedArrayView1D<const LayerDataHandle> layerData = this->layerData();
 
+    /* Reset the temporaries used for dynamic style sharing */
+    arrayClear(state.dynamicStyleAllocatedAnimations);
+    if(state.dynamicStylesAdvanced.size() != dynamicStyleUniforms.size()) {
+        state.dynamicStylesAdvanced = Containers::BitArray{ValueInit, dynamicStyleUniforms.size()};
+        state.dynamicStyleLeaders = Containers::Array<UnsignedInt>{NoInit, dynamicStyleUniforms.size()};
+    } else state.dynamicStylesAdvanced.resetAll();
+
     BaseLayerStyleAnimations animations;
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != active.size(); ++i) {
-        if(!active[i]) continue;
 
+    /* Switches the data of given animation to its dynamic style */
+    const auto switchDataToDynamicStyle = [&](const UnsignedInt id) {
+        const LayerDataHandle data = layerData[id];
+        if(data != LayerDataHandle::Null) {
+            dataStyles[layerDataHandleId(data)] = layerSharedState.styleCount + state.animations[id].dynamicStyle;
+            animations |= BaseLayerStyleAnimation::Style;
+            /* If the uniform IDs are the same between the source and target
+               style, the uniform interpolation below won't happen. We still
+               need to upload it at least once though, so trigger it here
+               unconditionally. */
+            animations |= BaseLayerStyleAnimation::Uniform;
+        }
+    };
+
+    /* Gives an animation that shares a dynamic style with others its own,
+       with the current contents of the shared one. If the allocation fails,
+       the animation stays shared, which is still better than not animating at
+       all. */
+    const auto detachDynamicStyle = [&](const UnsignedInt id) {
+        const Containers::Optional<UnsignedInt> style = state.layer->allocateDynamicStyle(animationHandle(handle(), id, generations()[id]));
+        if(!style)
+            return false;
+
+        Animation& animation = state.animations[id];
+        const UnsignedInt sharedStyle = animation.dynamicStyle;
+        releaseDynamicStyleInternal(id);
+        dynamicStyleUniforms[*style] = dynamicStyleUniforms[sharedStyle];
+        dynamicStylePaddings[*style] = dynamicStylePaddings[sharedStyle];
+        animation.dynamicStyle = *style;
+        switchDataToDynamicStyle(id);
+        return true;
+    };
+
+    /* Whether given two animations will produce the same dynamic style
+       contents in this and all subsequent advance() calls */
+    const auto isSame = [&](const UnsignedInt a, const UnsignedInt b) {
+        const Animation& animationA = state.animations[a];
+        const Animation& animationB = state.animations[b];
+        if(factors[a] != factors[b] ||
+           animationA.targetStyle != animationB.targetStyle ||
+           animationA.easing != animationB.easing ||
+           animationA.uniformDifferent != animationB.uniformDifferent)
+            return false;
+
+        const AnimatorDataHandle handleA = animatorDataHandle(a, generations()[a]);
+        const AnimatorDataHandle handleB = animatorDataHandle(b, generations()[b]);
+        if(played(handleA) != played(handleB) ||
+           duration(handleA) != duration(handleB) ||
+           repeatCount(handleA) != repeatCount(handleB) ||
+           flags(handleA) != flags(handleB))
+            return false;
+
+        /* The source and target uniforms and paddings are all floats next to
+           each other, compare them all at once. Bitwise comparison is fine,
+           as the values are copied from the style and not calculated. */
+        return std::memcmp(&animationA.sourceUniform, &animationB.sourceUniform, offsetof(Animation, targetStyle) - offsetof(Animation, sourceUniform)) == 0;
+    };
+
+    Implementation::forEachSetBit(active, [&](const std::size_t i) {
         Animation& animation = state.animations[i];
         /* The handle is assumed to be valid if not null, i.e. that appropriate
            dataClean() got called before advance() */
@@ -246,7 +347,7 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
                 dataStyles[layerDataHandleId(data)] = animation.targetStyle;
                 animations |= BaseLayerStyleAnimation::Style;
             }
-            continue;
+            return;
         }
 
         /* The animation is running, allocate a dynamic style if it isn't yet
@@ -266,19 +367,63 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
                thing at least. One could also just let it assert when there's
                no free slots anymore, but letting a program assert just because
                it couldn't animate feels silly. */
+
+            /* If there's an animation that allocated a dynamic style in this
+               advance() already and it's the same as this one, such as when
+               many data get the same hover or press animation at once, share
+               the dynamic style with it instead of allocating a new one. The
+               style was already interpolated with the same factor, so
+               there's nothing else to do. */
+            for(std::size_t j = state.dynamicStyleAllocatedAnimations.size(); j != 0; --j) {
+                const UnsignedInt other = state.dynamicStyleAllocatedAnimations[j - 1];
+                if(!isSame(i, other))
+                    continue;
+
+                Animation& otherAnimation = state.animations[other];
+                animation.dynamicStyle = otherAnimation.dynamicStyle;
+                animation.dynamicStyleNext = otherAnimation.dynamicStyleNext;
+                animation.dynamicStylePrevious = other;
+                state.animations[otherAnimation.dynamicStyleNext].dynamicStylePrevious = i;
+                otherAnimation.dynamicStyleNext = i;
+                if(!state.dynamicStylesAdvanced[animation.dynamicStyle]) {
+                    state.dynamicStylesAdvanced.set(animation.dynamicStyle);
+                    state.dynamicStyleLeaders[animation.dynamicStyle] = other;
+                }
+                switchDataToDynamicStyle(i);
+                return;
+            }
+
             const Containers::Optional<UnsignedInt> style = state.layer->allocateDynamicStyle(animationHandle(handle(), i, generations()[i]));
             if(!style)
-                continue;
+                return;
             animation.dynamicStyle = *style;
-
-            if(data != LayerDataHandle::Null) {
-                dataStyles[layerDataHandleId(data)] = layerSharedState.styleCount + animation.dynamicStyle;
-                animations |= BaseLayerStyleAnimation::Style;
-                /* If the uniform IDs are the same between the source and
-                   target style, the uniform interpolation below won't happen.
-                   We still need to upload it at least once though, so trigger
-                   it here unconditionally. */
-                animations |= BaseLayerStyleAnimation::Uniform;
+            arrayAppend(state.dynamicStyleAllocatedAnimations, UnsignedInt(i));
+            switchDataToDynamicStyle(i);
+
+        /* If the dynamic style is shared with other animations, only the first
+           one to get here interpolates it */
+        } else if(animation.dynamicStyleNext != i) {
+            /* If another animation interpolated the style already, there's
+               nothing to do if it did so with the same factor. Otherwise the
+               animations diverged, for example due to one being restarted,
+               and this one needs its own style from now on. */
+            if(state.dynamicStylesAdvanced[animation.dynamicStyle]) {
+                if(factors[state.dynamicStyleLeaders[animation.dynamicStyle]] == factors[i] || !detachDynamicStyle(i))
+                    return;
+
+            /* Otherwise this animation is the one doing the interpolation.
+               Animations that aren't advanced in this step at all, such as
+               when paused or stopped, would get modified by it as well, so
+               give them their own style first. */
+            } else {
+                state.dynamicStylesAdvanced.set(animation.dynamicStyle);
+                state.dynamicStyleLeaders[animation.dynamicStyle] = i;
+                for(UnsignedInt j = animation.dynamicStyleNext; j != i; ) {
+                    const UnsignedInt next = state.animations[j].dynamicStyleNext;
+                    if(!active[j])
+                        detachDynamicStyle(j);
+                    j = next;
+                }
             }
         }
 
@@ -290,18 +435,14 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
            uniform in which case the data has to be uploaded. That's handled in
            the animation.styleDynamic allocation above. */
         if(animation.uniformDifferent) {
-            BaseLayerStyleUniform uniform{NoInit};
-            #define _c(member) uniform.member = Math::lerp(             \
-                animation.sourceUniform.member,                         \
-                animation.targetUniform.member, factor);
-            _c(topColor)
-            _c(bottomColor)
-            _c(outlineColor)
-            _c(outlineWidth)
-            _c(cornerRadius)
-            _c(innerOutlineCornerRadius)
-            #undef _c
-            dynamicStyleUniforms[animation.dynamicStyle] = uniform;
+            /* All members are floats with no padding in between, so the
+               whole uniform is interpolated at once, written directly to the
+               dynamic style */
+            Implementation::lerpFloats(
+                animation.sourceUniform.topColor.data(),
+                animation.targetUniform.topColor.data(), factor,
+                dynamicStyleUniforms[animation.dynamicStyle].topColor.data(),
+                sizeof(BaseLayerStyleUniform)/sizeof(Float));
             animations |= BaseLayerStyleAnimation::Uniform;
         } else dynamicStyleUniforms[animation.dynamicStyle] = animation.targetUniform;
 
@@ -314,7 +455,7 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
            dynamicStylePaddings[animation.dynamicStyle] = padding;
             animations |= BaseLayerStyleAnimation::Padding;
         }
-    }
+    });
 
     return animations;
 }
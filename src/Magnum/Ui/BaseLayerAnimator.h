@@ -156,6 +156,14 @@ the source style index until another dynamic style is recycled. If no dynamic
 style gets recycled until the animation ends, the data gets switched directly
 to the target style without animating.
 
+Animations that start playing in the same @ref advance() and have the same
+source and target style, easing, timing and flags, such as when many data get
+the same hover animation at once, share a single dynamic style, which is
+associated with the first of them. If any of them diverges later, for example
+because it's paused or stopped earlier than the others, it gets a dynamic style
+of its own. Removing an animation recycles the shared dynamic style only once
+the last animation using it is removed.
+
 The animation interpolates all properties of @ref BaseLayerStyleUniform
 including outline width and corner radius, as well as the style padding value.
 At the moment, only animation between predefined styles is possible.
@@ -327,8 +335,8 @@ class MAGNUM_UI_EXPORT BaseLayerStyleAnimator: public AbstractVisualLayerStyleAn
          * @brief Remove an animation
          *
          * Expects that @p handle is valid. Recycles a dynamic style used by
-         * given animation with @ref BaseLayer::recycleDynamicStyle() and
-         * delegates to @ref AbstractAnimator::remove(AnimationHandle), see its
+         * given animation with @ref BaseLayer::recycleDynamicStyle(), unless
+         * it's shared with other animations, and delegates to @ref AbstractAnimator::remove(AnimationHandle), see its
          * documentation for more information.
          *
          * @m_class{m-note m-warning}
@@ -446,6 +454,8 @@ class MAGNUM_UI_EXPORT BaseLayerStyleAnimator: public AbstractVisualLayerStyleAn
         struct State;
 
         MAGNUM_UI_LOCAL void createInternal(AnimationHandle handle, UnsignedInt sourceStyle, UnsignedInt targetStyle, Float(*easing)(Float));
+
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
 };
 
 }}
@@ -26,11 +26,16 @@
 
 #include "BaseLayerGL.h"
 
+#include <cstring> /* std::memcmp() */
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Resource.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
 #include <Magnum/GL/Buffer.h>
@@ -40,6 +45,7 @@
 #endif
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/MeshView.h>
 #include <Magnum/GL/Renderer.h>
 #include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Texture.h>
@@ -47,10 +53,15 @@
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/GL/Version.h>
 
+#include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/RendererGL.h"
+#include "Magnum/Ui/Implementation/asyncShaderProgramGL.h"
 #include "Magnum/Ui/Implementation/baseLayerState.h"
 #include "Magnum/Ui/Implementation/blurCoefficients.h"
 #include "Magnum/Ui/Implementation/BlurShaderGL.h"
+#include "Magnum/Ui/Implementation/framebufferClipRect.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
+#include "Magnum/Ui/Implementation/uploadChangedRangesGL.h"
 
 #ifdef MAGNUM_UI_BUILD_STATIC
 static void importShaderResources() {
@@ -64,22 +75,31 @@ using namespace Containers::Literals;
 
 namespace {
 
-class BaseShaderGL: public GL::AbstractShaderProgram {
+/* With ShaderNodeProperties the node offset, size and opacity is stored in
+   two consecutive texels for each node, in rows of this many texels. Has to
+   be even for both texels of a node to be always in the same row. */
+constexpr Int NodePropertiesTextureWidth = 256;
+
+class BaseShaderGL: public Implementation::AsyncShaderProgramGL {
     private:
         enum: Int {
             StyleBufferBinding = 0,
             TextureBinding = 0,
             BackgroundBlurTextureBinding = 1,
+            NodePropertiesTextureBinding = 2
         };
 
     public:
-        enum Flag: UnsignedByte {
+        enum Flag: UnsignedShort {
             Textured = 1 << 0,
             BackgroundBlur = 1 << 1,
             NoRoundedCorners = 1 << 2,
             NoOutline = 1 << 3,
             TextureMask = 1 << 4,
-            SubdividedQuads = 1 << 5
+            SubdividedQuads = 1 << 5,
+            InstancedQuads = 1 << 6,
+            ShaderClipping = 1 << 7,
+            ShaderNodeProperties = 1 << 8
         };
 
         typedef Containers::EnumSet<Flag> Flags;
@@ -97,38 +117,82 @@ class BaseShaderGL: public GL::AbstractShaderProgram {
         typedef GL::Attribute<3, Vector4> Color4;
         typedef GL::Attribute<4, UnsignedInt> Style;
         typedef GL::Attribute<5, Vector3> TextureCoordinates;
-
+        /* Only if InstancedQuads are set, replacing Position and
+           CenterDistance. TextureCoordinates are then the minimal coordinates
+           and the texture layer. */
+        typedef GL::Attribute<0, Vector2> InstancedQuadCorner;
+        typedef GL::Attribute<1, Vector4> InstancedQuadMinMax;
+        typedef GL::Attribute<6, Vector2> InstancedQuadTextureCoordinateMax;
+        /* Only if ShaderNodeProperties is set, replacing InstancedQuadMinMax
+           and InstancedQuadTextureCoordinateMax. TextureCoordinates are then
+           the texture coordinate offset and the texture layer. */
+        typedef GL::Attribute<1, Vector4> InstancedQuadPadding;
+        typedef GL::Attribute<6, Vector2> InstancedQuadTextureCoordinateSize;
+        typedef GL::Attribute<8, UnsignedInt> NodeId;
+        /* Only if ShaderClipping is set, in a separate buffer. Per vertex or
+           per instance if InstancedQuads are set. */
+        typedef GL::Attribute<7, Vector4> ClipRect;
+
+        explicit BaseShaderGL(NoCreateT): Implementation::AsyncShaderProgramGL{NoCreate} {}
         explicit BaseShaderGL(Flags flags, UnsignedInt styleCount);
 
+        /* Waits for the compilation submitted in the constructor to finish
+           and performs the post-link setup. Called implicitly from all
+           setters except setProjection(), which gets applied here if it was
+           called before. */
+        void finish();
+
         BaseShaderGL& setProjection(const Vector2& scaling, const Float pixelScaling) {
             /* XY is Y-flipped scale from the UI size to the 2x2 unit square,
                the shader then translates by (-1, 1) on its own to put the
                origin at center. Z is multiplied with the pixel smoothness
                value to get the smoothness in actual UI units. */
-            setUniform(_projectionUniform, Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling});
+            return setProjection(Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling});
+        }
+
+        /* Used to transfer the projection to a newly created shader variant */
+        Vector3 projection() const { return _projection; }
+        BaseShaderGL& setProjection(const Vector3& projection) {
+            _projection = projection;
+            /* If the shader is still compiling, it's set in finish() */
+            if(!isCompilePending())
+                setUniform(_projectionUniform, _projection);
             return *this;
         }
 
+        Flags flags() const { return _flags; }
+
         BaseShaderGL& bindStyleBuffer(GL::Buffer& buffer) {
+            finish();
             buffer.bind(GL::Buffer::Target::Uniform, StyleBufferBinding);
             return *this;
         }
 
         BaseShaderGL& bindTexture(GL::Texture2DArray& texture) {
+            finish();
             CORRADE_INTERNAL_ASSERT(_flags & Flag::Textured);
             texture.bind(TextureBinding);
             return *this;
         }
 
         BaseShaderGL& bindBackgroundBlurTexture(GL::Texture2D& texture) {
+            finish();
             CORRADE_INTERNAL_ASSERT(_flags & Flag::BackgroundBlur);
             texture.bind(BackgroundBlurTextureBinding);
             return *this;
         }
 
+        BaseShaderGL& bindNodePropertiesTexture(GL::Texture2D& texture) {
+            finish();
+            CORRADE_INTERNAL_ASSERT(_flags & Flag::ShaderNodeProperties);
+            texture.bind(NodePropertiesTextureBinding);
+            return *this;
+        }
+
     private:
         Flags _flags;
         Int _projectionUniform = 0;
+        Vector3 _projection;
 };
 
 #ifdef CORRADE_TARGET_CLANG
@@ -144,6 +208,10 @@ BaseShaderGL::BaseShaderGL(const Flags flags, const UnsignedInt styleCount): _fl
     GL::Context& context = GL::Context::current();
     #ifndef MAGNUM_TARGET_GLES
     MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
+    /* Drawing a subset of the instances for each clip rect needs a base
+       instance */
+    if(flags & Flag::InstancedQuads)
+        MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::base_instance);
     #endif
 
     #ifdef MAGNUM_UI_BUILD_STATIC
@@ -170,6 +238,9 @@ BaseShaderGL::BaseShaderGL(const Flags flags, const UnsignedInt styleCount): _fl
         .addSource(flags & Flag::Textured ? "#define TEXTURED\n"_s : ""_s)
         .addSource(flags & Flag::NoOutline ? "#define NO_OUTLINE\n"_s : ""_s)
         .addSource(flags & Flag::SubdividedQuads ? "#define SUBDIVIDED_QUADS\n"_s : ""_s)
+        .addSource(flags & Flag::InstancedQuads ? "#define INSTANCED_QUADS\n"_s : ""_s)
+        .addSource(flags & Flag::ShaderClipping ? "#define SHADER_CLIPPING\n"_s : ""_s)
+        .addSource(flags & Flag::ShaderNodeProperties ? Utility::format("#define SHADER_NODE_PROPERTIES\n#define NODE_PROPERTIES_TEXTURE_WIDTH {}\n", NodePropertiesTextureWidth) : Containers::String{})
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("BaseShader.vert"_s));
 
@@ -181,35 +252,234 @@ BaseShaderGL::BaseShaderGL(const Flags flags, const UnsignedInt styleCount): _fl
         .addSource(flags & Flag::NoOutline ? "#define NO_OUTLINE\n"_s : ""_s)
         .addSource(flags & Flag::TextureMask ? "#define TEXTURE_MASK\n"_s : ""_s)
         .addSource(flags & Flag::SubdividedQuads ? "#define SUBDIVIDED_QUADS\n"_s : ""_s)
+        .addSource(flags & Flag::ShaderClipping ? "#define SHADER_CLIPPING\n"_s : ""_s)
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("BaseShader.frag"_s));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+    submitCompileLink(Utility::move(vert), Utility::move(frag), version);
+}
+
+void BaseShaderGL::finish() {
+    if(!checkCompileLink())
+        return;
+
+    if(!hasExplicitUniformLocations()) {
+        _projectionUniform = uniformLocation("projection"_s);
+    }
+
+    if(!hasExplicitBindings()) {
+        if(_flags & Flag::Textured)
+            setUniform(uniformLocation("textureData"_s), TextureBinding);
+        if(_flags & Flag::BackgroundBlur)
+            setUniform(uniformLocation("backgroundBlurTextureData"_s), BackgroundBlurTextureBinding);
+        if(_flags & Flag::ShaderNodeProperties)
+            setUniform(uniformLocation("nodePropertiesTextureData"_s), NodePropertiesTextureBinding);
+        setUniformBlockBinding(uniformBlockIndex("Style"_s), StyleBufferBinding);
+    }
+
+    setUniform(_projectionUniform, _projection);
+}
+
+/* Used for BaseLayerBackgroundBlurAlgorithm::DualKawase, with one instance
+   for downsampling and one for upsampling. Uses the same vertex shader as
+   BlurShaderGL. */
+class DualKawaseBlurShaderGL: public Implementation::AsyncShaderProgramGL {
+    private:
+        enum: Int {
+            /* Same as BlurShaderGL::TextureBinding */
+            TextureBinding = 6
+        };
+
+    public:
+        enum class Mode {
+            Downsample,
+            Upsample
+        };
+
+        typedef GL::Attribute<0, Vector2> Position;
 
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+        explicit DualKawaseBlurShaderGL(NoCreateT): Implementation::AsyncShaderProgramGL{NoCreate} {}
+        explicit DualKawaseBlurShaderGL(Mode mode);
+
+        /* Waits for the compilation submitted in the constructor to finish
+           and performs the post-link setup. Called implicitly from all
+           setters except setProjection(), which gets applied here if it was
+           called before. */
+        void finish();
+
+        DualKawaseBlurShaderGL& setProjection(const Vector2& scaling) {
+            /* Same as BlurShaderGL::setProjection() */
+            _projection = Vector2{2.0f, -2.0f}/scaling;
+            /* If the shader is still compiling, it's set in finish() */
+            if(!isCompilePending())
+                setUniform(_projectionUniform, _projection);
+            return *this;
+        }
 
+        /* Half of the size of a texel of the input texture */
+        DualKawaseBlurShaderGL& setHalfTexelSize(const Vector2& size) {
+            finish();
+            setUniform(_halfTexelSizeUniform, size);
+            return *this;
+        }
+
+        DualKawaseBlurShaderGL& bindTexture(GL::Texture2D& texture) {
+            finish();
+            texture.bind(TextureBinding);
+            return *this;
+        }
+
+    private:
+        Int _projectionUniform = 0,
+            _halfTexelSizeUniform = 1;
+        Vector2 _projection;
+};
+
+DualKawaseBlurShaderGL::DualKawaseBlurShaderGL(const Mode mode) {
+    GL::Context& context = GL::Context::current();
     #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
+    MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
     #endif
-    {
+
+    #ifdef MAGNUM_UI_BUILD_STATIC
+    if(!Utility::Resource::hasGroup("MagnumUi"_s))
+        importShaderResources();
+    #endif
+
+    Utility::Resource rs{"MagnumUi"_s};
+
+    const GL::Version version = context.supportedVersion({
+        #ifndef MAGNUM_TARGET_GLES
+        GL::Version::GL330
+        #else
+        GL::Version::GLES300
+            #ifndef MAGNUM_TARGET_WEBGL
+            , GL::Version::GLES310
+            #endif
+        #endif
+    });
+
+    GL::Shader vert{version, GL::Shader::Type::Vertex};
+    vert.addSource(rs.getString("compatibility.glsl"_s))
+        .addSource(rs.getString("BlurShader.vert"_s));
+
+    GL::Shader frag{version, GL::Shader::Type::Fragment};
+    frag.addSource(rs.getString("compatibility.glsl"_s))
+        .addSource(mode == Mode::Downsample ? "#define DOWNSAMPLE\n"_s : "#define UPSAMPLE\n"_s)
+        .addSource(rs.getString("DualKawaseBlurShader.frag"_s));
+
+    submitCompileLink(Utility::move(vert), Utility::move(frag), version);
+}
+
+void DualKawaseBlurShaderGL::finish() {
+    if(!checkCompileLink())
+        return;
+
+    if(!hasExplicitUniformLocations()) {
         _projectionUniform = uniformLocation("projection"_s);
+        _halfTexelSizeUniform = uniformLocation("halfTexelSize"_s);
+    }
+
+    if(!hasExplicitBindings()) {
+        setUniform(uniformLocation("textureData"_s), TextureBinding);
     }
 
+    setUniform(_projectionUniform, _projection);
+}
+
+/* Used for BaseLayerSharedFlag::OpaqueDepthPrepass. Draws just positions,
+   with colors being masked away and the depth supplied by the renderer. Uses
+   the same vertex shader as BlurShaderGL. */
+class DepthShaderGL: public Implementation::AsyncShaderProgramGL {
+    public:
+        typedef GL::Attribute<0, Vector2> Position;
+
+        explicit DepthShaderGL(NoCreateT): Implementation::AsyncShaderProgramGL{NoCreate} {}
+        explicit DepthShaderGL();
+
+        /* Waits for the compilation submitted in the constructor to finish
+           and performs the post-link setup. Called implicitly from all
+           setters except setProjection(), which gets applied here if it was
+           called before. */
+        void finish();
+
+        DepthShaderGL& setProjection(const Vector2& scaling) {
+            /* Same as BlurShaderGL::setProjection() */
+            _projection = Vector2{2.0f, -2.0f}/scaling;
+            /* If the shader is still compiling, it's set in finish() */
+            if(!isCompilePending())
+                setUniform(_projectionUniform, _projection);
+            return *this;
+        }
+
+    private:
+        Int _projectionUniform = 0;
+        Vector2 _projection;
+};
+
+DepthShaderGL::DepthShaderGL() {
+    GL::Context& context = GL::Context::current();
     #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::shading_language_420pack>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
+    MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
     #endif
-    {
-        if(flags & Flag::Textured)
-            setUniform(uniformLocation("textureData"_s), TextureBinding);
-        if(flags & Flag::BackgroundBlur)
-            setUniform(uniformLocation("backgroundBlurTextureData"_s), BackgroundBlurTextureBinding);
-        setUniformBlockBinding(uniformBlockIndex("Style"_s), StyleBufferBinding);
+
+    #ifdef MAGNUM_UI_BUILD_STATIC
+    if(!Utility::Resource::hasGroup("MagnumUi"_s))
+        importShaderResources();
+    #endif
+
+    Utility::Resource rs{"MagnumUi"_s};
+
+    const GL::Version version = context.supportedVersion({
+        #ifndef MAGNUM_TARGET_GLES
+        GL::Version::GL330
+        #else
+        GL::Version::GLES300
+            #ifndef MAGNUM_TARGET_WEBGL
+            , GL::Version::GLES310
+            #endif
+        #endif
+    });
+
+    GL::Shader vert{version, GL::Shader::Type::Vertex};
+    vert.addSource(rs.getString("compatibility.glsl"_s))
+        .addSource(rs.getString("BlurShader.vert"_s));
+
+    GL::Shader frag{version, GL::Shader::Type::Fragment};
+    frag.addSource(rs.getString("compatibility.glsl"_s))
+        .addSource(rs.getString("DepthShader.frag"_s));
+
+    submitCompileLink(Utility::move(vert), Utility::move(frag), version);
+}
+
+void DepthShaderGL::finish() {
+    if(!checkCompileLink())
+        return;
+
+    if(!hasExplicitUniformLocations()) {
+        _projectionUniform = uniformLocation("projection"_s);
     }
+
+    setUniform(_projectionUniform, _projection);
+}
+
+/* Count of dynamic style buffers with Flag::RingBufferedDynamicStyles. Three
+   should be enough to cover the frames a driver usually has in flight. */
+constexpr UnsignedByte StyleBufferRingSize = 3;
+
+/* Finds the last run starting at or before given draw offset. The last run is
+   expected to be a sentinel that's always after. */
+template<class T> std::size_t findRun(const Containers::ArrayView<const T> runs, const std::size_t drawOffset) {
+    std::size_t runBegin = 0;
+    std::size_t runEnd = runs.size() - 1;
+    while(runEnd - runBegin > 1) {
+        const std::size_t runMiddle = runBegin + (runEnd - runBegin)/2;
+        if(runs[runMiddle].drawOffset <= drawOffset)
+            runBegin = runMiddle;
+        else
+            runEnd = runMiddle;
+    }
+    return runBegin;
 }
 
 }
@@ -299,17 +569,14 @@ BlurShaderGL::BlurShaderGL(UnsignedInt radius, Float limit) {
         .addSource(count % 2 == 1 ? "#define FIRST_TAP_AT_CENTER\n"_s : ""_s)
         .addSource(rs.getString("BlurShader.frag"_s));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+    submitCompileLink(Utility::move(vert), Utility::move(frag), version);
+}
 
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+void BlurShaderGL::finish() {
+    if(!checkCompileLink())
+        return;
 
-    #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
-    #endif
-    {
+    if(!hasExplicitUniformLocations()) {
         _projectionUniform = uniformLocation("projection"_s);
         /* For a zero radius we check just the center pixel, the direction
            isn't used by the shader at all. Originally it was queried always
@@ -321,30 +588,72 @@ BlurShaderGL::BlurShaderGL(UnsignedInt radius, Float limit) {
             _directionUniform = uniformLocation("direction"_s);
     }
 
-    #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::shading_language_420pack>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
-    #endif
-    {
+    if(!hasExplicitBindings()) {
         setUniform(uniformLocation("textureData"_s), TextureBinding);
     }
+
+    setUniform(_projectionUniform, _projection);
 }
 
 struct BaseLayerGL::Shared::State: BaseLayer::Shared::State {
     explicit State(Shared& self, const Configuration& configuration);
 
+    /* Returns a shader variant supporting just given features, creating it
+       if not already. If the features are all in featureMask, returns the
+       generic shader. */
+    BaseShaderGL& shaderVariant(UnsignedInt features);
+
     BaseShaderGL shader;
     /* In case dynamic styles are present, this buffer is unused and each layer
        has its own copy instead */
     GL::Buffer styleBuffer{NoCreate};
 
+    /* Created only if Flag::InstancedQuads is enabled, contains corners of
+       a unit quad shared by all layers */
+    GL::Buffer instancedQuadCornerBuffer{NoCreate};
+
+    /* Variants of the shader with NoRoundedCorners and / or NoOutline
+       additionally enabled, indexed by the Implementation::BaseLayerFeature
+       bits they support. Used to draw runs of data that don't make use of
+       these features, potentially saving a lot of fill rate, the variant
+       with all features is the shader above. Created on demand in
+       shaderVariant(), NoCreate'd until then. */
+    BaseShaderGL shaderVariants[3]{BaseShaderGL{NoCreate}, BaseShaderGL{NoCreate}, BaseShaderGL{NoCreate}};
+
     /* These are created only if Flag::BackgroundBlur is enabled */
     GL::Texture2D backgroundBlurTextureVertical{NoCreate},
                   backgroundBlurTextureHorizontal{NoCreate};
     GL::Framebuffer backgroundBlurFramebufferVertical{NoCreate},
                     backgroundBlurFramebufferHorizontal{NoCreate};
     BlurShaderGL backgroundBlurShader{NoCreate};
+    /* Framebuffer size divided by the downscale factor, size of the
+       horizontal and vertical textures. Set in doSetSize(). */
+    Vector2i backgroundBlurSize;
+
+    /* These are created only if Flag::BackgroundBlur is enabled together with
+       BaseLayerBackgroundBlurAlgorithm::DualKawase. In that case the vertical
+       texture, framebuffer and the Gaussian shader aren't created, the
+       horizontal texture is the final output. The level textures and
+       framebuffers are for each possible downsampling level, the first one
+       being half the framebuffer size. */
+    DualKawaseBlurShaderGL backgroundBlurDownsampleShader{NoCreate},
+                           backgroundBlurUpsampleShader{NoCreate};
+    Containers::Array<GL::Texture2D> backgroundBlurLevelTextures;
+    Containers::Array<GL::Framebuffer> backgroundBlurLevelFramebuffers;
+
+    /* Created only if Flag::OpaqueDepthPrepass is enabled */
+    DepthShaderGL depthShader{NoCreate};
+
+    /* Used only if Flag::BackgroundBlurCache is enabled. Describes what's
+       currently in backgroundBlurTextureHorizontal -- which layer and with
+       which renderer was the last blur done, with what content generation
+       and pass count, and what were the composite rect vertices in the
+       blurred range. A null renderer means there's nothing cached. */
+    const RendererGL* backgroundBlurCacheRenderer = nullptr;
+    LayerHandle backgroundBlurCacheLayer = LayerHandle::Null;
+    UnsignedInt backgroundBlurCacheContentGeneration = 0;
+    UnsignedInt backgroundBlurCachePassCount = 0;
+    Containers::Array<Vector2> backgroundBlurCacheVertices;
 };
 
 BaseLayerGL::Shared::State::State(Shared& self, const Configuration& configuration): BaseLayer::Shared::State{self, configuration}, shader{
@@ -354,20 +663,76 @@ BaseLayerGL::Shared::State::State(Shared& self, const Configuration& configurati
     _c(NoRoundedCorners)|
     _c(NoOutline)|
     _c(TextureMask)|
-    _c(SubdividedQuads),
+    _c(SubdividedQuads)|
+    _c(InstancedQuads)|
+    _c(ShaderClipping)|
+    _c(ShaderNodeProperties),
     #undef _c
     configuration.styleUniformCount() + configuration.dynamicStyleCount()}
 {
     if(!dynamicStyleCount)
         styleBuffer = GL::Buffer{GL::Buffer::TargetHint::Uniform, {nullptr, sizeof(BaseLayerCommonStyleUniform) + sizeof(BaseLayerStyleUniform)*styleUniformCount}};
-    if(configuration.flags() & BaseLayerSharedFlag::BackgroundBlur)
-        backgroundBlurShader = BlurShaderGL{configuration.backgroundBlurRadius(), configuration.backgroundBlurCutoff()};
+    if(configuration.flags() & BaseLayerSharedFlag::BackgroundBlur) {
+        if(configuration.backgroundBlurAlgorithm() == BaseLayerBackgroundBlurAlgorithm::DualKawase) {
+            backgroundBlurDownsampleShader = DualKawaseBlurShaderGL{DualKawaseBlurShaderGL::Mode::Downsample};
+            backgroundBlurUpsampleShader = DualKawaseBlurShaderGL{DualKawaseBlurShaderGL::Mode::Upsample};
+        } else backgroundBlurShader = BlurShaderGL{configuration.backgroundBlurRadius(), configuration.backgroundBlurCutoff()};
+    }
+    if(configuration.flags() >= BaseLayerSharedFlag::OpaqueDepthPrepass)
+        depthShader = DepthShaderGL{};
+    if(configuration.flags() & BaseLayerSharedFlag::InstancedQuads) {
+        /* Drawn as a triangle strip in the same winding as the indexed
+           non-instanced quads
+
+           0---2
+           |  /|
+           | / |
+           |/  |
+           1---3 */
+        const Vector2 corners[]{
+            {0.0f, 0.0f},
+            {0.0f, 1.0f},
+            {1.0f, 0.0f},
+            {1.0f, 1.0f}
+        };
+        instancedQuadCornerBuffer = GL::Buffer{GL::Buffer::TargetHint::Array, corners};
+    }
+}
+
+BaseShaderGL& BaseLayerGL::Shared::State::shaderVariant(const UnsignedInt features) {
+    CORRADE_INTERNAL_DEBUG_ASSERT(!(features & ~featureMask));
+    if(features == featureMask)
+        return shader;
+
+    BaseShaderGL& variant = shaderVariants[features];
+    if(!variant.id()) {
+        variant = BaseShaderGL{shader.flags()|
+            (features & Implementation::BaseLayerFeatureRoundedCorners ? BaseShaderGL::Flags{} : BaseShaderGL::Flag::NoRoundedCorners)|
+            (features & Implementation::BaseLayerFeatureOutline ? BaseShaderGL::Flags{} : BaseShaderGL::Flag::NoOutline),
+            styleUniformCount + dynamicStyleCount};
+        variant.setProjection(shader.projection());
+    }
+    return variant;
 }
 
 BaseLayerGL::Shared::Shared(const Configuration& configuration): BaseLayer::Shared{Containers::pointer<State>(*this, configuration)} {}
 
 BaseLayerGL::Shared::Shared(NoCreateT) noexcept: BaseLayer::Shared{NoCreate} {}
 
+bool BaseLayerGL::Shared::isCompileFinished() {
+    auto& state = static_cast<State&>(*_state);
+    /* The shaders that aren't used are NoCreate'd and report the compilation
+       as finished */
+    return state.shader.isCompileFinished() &&
+        state.shaderVariants[0].isCompileFinished() &&
+        state.shaderVariants[1].isCompileFinished() &&
+        state.shaderVariants[2].isCompileFinished() &&
+        state.backgroundBlurShader.isCompileFinished() &&
+        state.backgroundBlurDownsampleShader.isCompileFinished() &&
+        state.backgroundBlurUpsampleShader.isCompileFinished() &&
+        state.depthShader.isCompileFinished();
+}
+
 void BaseLayerGL::Shared::doSetStyle(const BaseLayerCommonStyleUniform& commonUniform, const Containers::ArrayView<const BaseLayerStyleUniform> uniforms) {
     /* This function should get called only if the dynamic style count is 0 */
     auto& state = static_cast<State&>(*_state);
@@ -375,36 +740,151 @@ void BaseLayerGL::Shared::doSetStyle(const BaseLayerCommonStyleUniform& commonUn
 
     state.styleBuffer.setSubData(0, {&commonUniform, 1});
     state.styleBuffer.setSubData(sizeof(BaseLayerCommonStyleUniform), uniforms);
+
+    /* If none of the styles use some features, compile the variant
+       without them right away instead of waiting for the first draw */
+    if(state.featureMask) {
+        UnsignedByte features = 0;
+        for(const UnsignedByte uniformFeatures: state.styleUniformFeatures)
+            features |= uniformFeatures;
+        if(features != state.featureMask)
+            state.shaderVariant(features);
+    }
 }
 
 struct BaseLayerGL::State: BaseLayer::State {
-    explicit State(Shared::State& shared): BaseLayer::State{shared} {}
+    explicit State(Shared::State& shared): BaseLayer::State{shared}, styleBufferCount{UnsignedByte(shared.flags & BaseLayerSharedFlag::RingBufferedDynamicStyles ? StyleBufferRingSize : 1)} {}
 
     GL::Buffer vertexBuffer{GL::Buffer::TargetHint::Array}, indexBuffer{GL::Buffer::TargetHint::ElementArray};
+    /* Copies of what was uploaded to vertexBuffer and indexBuffer last time,
+       used to upload only the ranges that changed since */
+    Containers::Array<char> uploadedVertices, uploadedIndices;
     GL::Mesh mesh;
     Vector2 clipScale;
 
+    /* Used only if Flag::StableIndices is enabled, reused across draws to
+       avoid repeated allocations */
+    Containers::Array<GL::MeshView> drawRunViews;
+
+    /* Used only if Flag::ShaderClipping is enabled. Framebuffer-space clip
+       rect min and max for each vertex, or for each instance if
+       Flag::InstancedQuads is enabled, and a copy of what was uploaded last
+       time. */
+    GL::Buffer clipRectBuffer{NoCreate};
+    Containers::Array<Vector4> clipRects;
+    Containers::Array<char> uploadedClipRects;
+
+    /* Used only if Flag::ShaderNodeProperties is enabled. The node offsets,
+       sizes and opacities are copied to a contiguous array padded to whole
+       texture rows in doUpdate(), doPostUpdate() then uploads the rows that
+       differ from what was uploaded last time. The texture is created during
+       the first doPostUpdate() with any nodes and recreated with twice the
+       rows when the node count grows beyond its capacity. */
+    Containers::Array<Vector4> nodeProperties, uploadedNodeProperties;
+    GL::Texture2D nodePropertiesTexture{NoCreate};
+    Int nodePropertiesTextureRows = 0;
+
     /* Used only if Flag::Textured is enabled. Is non-owning if
        setTexture(GL::Texture2DArray&) was called, owning if
        setTexture(GL::Texture2DArray&&). */
     GL::Texture2DArray texture{NoCreate};
 
-    /* Used only if shared.dynamicStyleCount is non-zero, in which case it's
-       created during the first doUpdate(). Even though the size is known in
-       advance, the NoCreate'd state is used to correctly perform the first
-       ever style upload without having to implicitly set any LayerStates. */
-    GL::Buffer styleBuffer{NoCreate};
+    /* Used only if shared.dynamicStyleCount is non-zero, in which case
+       they're created during the first doUpdate() that writes to them. Even
+       though the size is known in advance, the NoCreate'd state is used to
+       correctly perform the first ever style upload without having to
+       implicitly set any LayerStates. There's just one buffer by default, with
+       Flag::RingBufferedDynamicStyles every upload goes to the next buffer in
+       the ring. Each buffer has a copy of the dynamic styles uploaded to it
+       last time and the shared style update stamp they were uploaded at, in
+       order to upload only what changed since. */
+    struct StyleBuffer {
+        GL::Buffer buffer{NoCreate};
+        Containers::Array<char> uploadedDynamicStyleUniforms;
+        UnsignedShort styleUpdateStamp;
+    } styleBuffers[StyleBufferRingSize];
+    UnsignedByte styleBufferCount;
+    UnsignedByte currentStyleBuffer = 0;
 
     /* Used only if Flag::BackgroundBlur is enabled */
     GL::Buffer backgroundBlurVertexBuffer{NoCreate};
     GL::Buffer backgroundBlurIndexBuffer{NoCreate};
     GL::Mesh backgroundBlurMesh{NoCreate};
+
+    /* Used only if Flag::OpaqueDepthPrepass is enabled */
+    GL::Buffer opaqueVertexBuffer{NoCreate};
+    GL::Mesh opaqueMesh{NoCreate};
+
+    /* Whether shared styles changed since the last doUpdate(), saved for
+       the subsequent doPostUpdate() as doUpdate() syncs the stamps */
+    bool sharedStyleChanged = false;
 };
 
 BaseLayerGL::BaseLayerGL(const LayerHandle handle, Shared& sharedState_): BaseLayer{handle, Containers::pointer<State>(static_cast<Shared::State&>(*sharedState_._state))} {
     auto& state = static_cast<State&>(*_state);
     Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
-    if(!(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
+    if(sharedState.flags >= BaseLayerSharedFlag::InstancedQuads) {
+        state.mesh
+            .setPrimitive(GL::MeshPrimitive::TriangleStrip)
+            .setCount(4)
+            .addVertexBuffer(sharedState.instancedQuadCornerBuffer, 0,
+                BaseShaderGL::InstancedQuadCorner{});
+        if(sharedState.flags >= BaseLayerSharedFlag::ShaderNodeProperties) {
+            if(sharedState.flags & BaseLayerSharedFlag::Textured) {
+                state.mesh.addVertexBufferInstanced(state.vertexBuffer, 1, 0,
+                    BaseShaderGL::InstancedQuadPadding{},
+                    BaseShaderGL::OutlineWidth{},
+                    BaseShaderGL::Color4{},
+                    BaseShaderGL::Style{},
+                    BaseShaderGL::NodeId{},
+                    BaseShaderGL::TextureCoordinates{},
+                    BaseShaderGL::InstancedQuadTextureCoordinateSize{});
+            } else {
+                state.mesh.addVertexBufferInstanced(state.vertexBuffer, 1, 0,
+                    BaseShaderGL::InstancedQuadPadding{},
+                    BaseShaderGL::OutlineWidth{},
+                    BaseShaderGL::Color4{},
+                    BaseShaderGL::Style{},
+                    BaseShaderGL::NodeId{});
+            }
+        } else if(sharedState.flags & BaseLayerSharedFlag::Textured) {
+            state.mesh.addVertexBufferInstanced(state.vertexBuffer, 1, 0,
+                BaseShaderGL::InstancedQuadMinMax{},
+                BaseShaderGL::OutlineWidth{},
+                BaseShaderGL::Color4{},
+                BaseShaderGL::Style{},
+                BaseShaderGL::TextureCoordinates{},
+                BaseShaderGL::InstancedQuadTextureCoordinateMax{});
+        } else {
+            state.mesh.addVertexBufferInstanced(state.vertexBuffer, 1, 0,
+                BaseShaderGL::InstancedQuadMinMax{},
+                BaseShaderGL::OutlineWidth{},
+                BaseShaderGL::Color4{},
+                BaseShaderGL::Style{});
+        }
+    } else if(sharedState.flags >= BaseLayerSharedFlag::CompactVertices) {
+        /* The shader is the same, the packed attributes get unpacked by the
+           vertex fetch. The 2-byte gap after the style is padding to keep the
+           position and texture coordinates aligned to four bytes. */
+        if(sharedState.flags & BaseLayerSharedFlag::Textured) {
+            state.mesh.addVertexBuffer(state.vertexBuffer, 0,
+                BaseShaderGL::Position{},
+                BaseShaderGL::CenterDistance{BaseShaderGL::CenterDistance::DataType::Half},
+                BaseShaderGL::OutlineWidth{BaseShaderGL::OutlineWidth::DataType::Half},
+                BaseShaderGL::Color4{BaseShaderGL::Color4::DataType::UnsignedByte, BaseShaderGL::Color4::DataOption::Normalized},
+                BaseShaderGL::Style{BaseShaderGL::Style::DataType::UnsignedShort},
+                2,
+                BaseShaderGL::TextureCoordinates{});
+        } else {
+            state.mesh.addVertexBuffer(state.vertexBuffer, 0,
+                BaseShaderGL::Position{},
+                BaseShaderGL::CenterDistance{BaseShaderGL::CenterDistance::DataType::Half},
+                BaseShaderGL::OutlineWidth{BaseShaderGL::OutlineWidth::DataType::Half},
+                BaseShaderGL::Color4{BaseShaderGL::Color4::DataType::UnsignedByte, BaseShaderGL::Color4::DataOption::Normalized},
+                BaseShaderGL::Style{BaseShaderGL::Style::DataType::UnsignedShort},
+                2);
+        }
+    } else if(!(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
         if(sharedState.flags & BaseLayerSharedFlag::Textured) {
             state.mesh.addVertexBuffer(state.vertexBuffer, 0,
                 BaseShaderGL::Position{},
@@ -439,7 +919,18 @@ BaseLayerGL::BaseLayerGL(const LayerHandle handle, Shared& sharedState_): BaseLa
                 BaseShaderGL::SubdividedQuadCenterDistanceY{});
         }
     }
-    state.mesh.setIndexBuffer(state.indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+    if(!(sharedState.flags >= BaseLayerSharedFlag::InstancedQuads))
+        state.mesh.setIndexBuffer(state.indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+
+    if(sharedState.flags >= BaseLayerSharedFlag::ShaderClipping) {
+        state.clipRectBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
+        if(sharedState.flags >= BaseLayerSharedFlag::InstancedQuads)
+            state.mesh.addVertexBufferInstanced(state.clipRectBuffer, 1, 0,
+                BaseShaderGL::ClipRect{});
+        else
+            state.mesh.addVertexBuffer(state.clipRectBuffer, 0,
+                BaseShaderGL::ClipRect{});
+    }
 
     if(sharedState.flags >= BaseLayerSharedFlag::BackgroundBlur) {
         state.backgroundBlurVertexBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
@@ -448,6 +939,12 @@ BaseLayerGL::BaseLayerGL(const LayerHandle handle, Shared& sharedState_): BaseLa
             .addVertexBuffer(state.backgroundBlurVertexBuffer, 0, BlurShaderGL::Position{})
             .setIndexBuffer(state.backgroundBlurIndexBuffer, 0, GL::MeshIndexType::UnsignedInt);
     }
+
+    if(sharedState.flags >= BaseLayerSharedFlag::OpaqueDepthPrepass) {
+        state.opaqueVertexBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
+        (state.opaqueMesh = GL::Mesh{})
+            .addVertexBuffer(state.opaqueVertexBuffer, 0, DepthShaderGL::Position{});
+    }
 }
 
 BaseLayerGL& BaseLayerGL::setTexture(GL::Texture2DArray& texture) {
@@ -465,36 +962,130 @@ BaseLayerGL& BaseLayerGL::setTexture(GL::Texture2DArray&& texture) {
     return *this;
 }
 
+MemoryUsage BaseLayerGL::doMemoryUsage() const {
+    const State& state = static_cast<const State&>(*_state);
+    MemoryUsage out = BaseLayer::doMemoryUsage();
+    Implementation::addArrayMemoryUsage(out, state.uploadedVertices);
+    Implementation::addArrayMemoryUsage(out, state.uploadedIndices);
+    Implementation::addArrayMemoryUsage(out, state.drawRunViews);
+    Implementation::addArrayMemoryUsage(out, state.clipRects);
+    Implementation::addArrayMemoryUsage(out, state.uploadedClipRects);
+    Implementation::addArrayMemoryUsage(out, state.nodeProperties);
+    Implementation::addArrayMemoryUsage(out, state.uploadedNodeProperties);
+    for(UnsignedInt i = 0; i != state.styleBufferCount; ++i)
+        Implementation::addArrayMemoryUsage(out, state.styleBuffers[i].uploadedDynamicStyleUniforms);
+
+    /* The uploaded copies have the same size as the buffers they mirror. The
+       blur and opaque buffers are uploaded whole from the CPU-side arrays
+       every time. The texture is set from outside and thus not owned by the
+       layer in general, so it's not included. */
+    out.gpu +=
+        state.uploadedVertices.size() +
+        state.uploadedIndices.size() +
+        state.uploadedClipRects.size() +
+        std::size_t(state.nodePropertiesTextureRows)*NodePropertiesTextureWidth*sizeof(Vector4);
+    for(UnsignedInt i = 0; i != state.styleBufferCount; ++i)
+        out.gpu += state.styleBuffers[i].uploadedDynamicStyleUniforms.size();
+    if(state.backgroundBlurVertexBuffer.id())
+        out.gpu +=
+            state.backgroundBlurVertices.size()*sizeof(Vector2) +
+            state.backgroundBlurIndices.size()*sizeof(UnsignedInt);
+    if(state.opaqueVertexBuffer.id())
+        out.gpu += state.opaqueVertices.size()*sizeof(Vector2);
+    return out;
+}
+
+void BaseLayerGL::doTrim(const std::size_t capacity) {
+    BaseLayer::doTrim(capacity);
+
+    /* The buffers are reallocated to the exact size on every change in size,
+       only the CPU-side copies have memory reserved */
+    auto& state = static_cast<State&>(*_state);
+    arrayShrink(state.drawRunViews);
+    arrayShrink(state.clipRects);
+    arrayShrink(state.nodeProperties);
+    arrayShrink(state.uploadedNodeProperties);
+}
+
 LayerFeatures BaseLayerGL::doFeatures() const {
-    return BaseLayer::doFeatures()|LayerFeature::DrawUsesBlending|LayerFeature::DrawUsesScissor;
+    auto& sharedState = static_cast<const Shared::State&>(_state->shared);
+    /* With shader clipping the scissor is not used at all */
+    return BaseLayer::doFeatures()|LayerFeature::DrawUsesBlending|(sharedState.flags >= BaseLayerSharedFlag::ShaderClipping ? LayerFeatures{} : LayerFeature::DrawUsesScissor)|LayerFeature::ConcurrentUpdate;
 }
 
 void BaseLayerGL::doSetSize(const Vector2& size, const Vector2i& framebufferSize) {
-    BaseLayer::doSetSize(size, framebufferSize);
-
     auto& state = static_cast<State&>(*_state);
     auto& sharedState = static_cast<Shared::State&>(state.shared);
 
+    /* With shader clipping the framebuffer-space clip rects are a part of the
+       vertex data, so if the framebuffer size or the scale changes and there
+       are any data already, trigger an update of those. Has to be checked
+       before the base implementation updates the framebuffer size. */
+    const Vector2 clipScale = Vector2{framebufferSize}/size;
+    if(sharedState.flags >= BaseLayerSharedFlag::ShaderClipping && (framebufferSize != state.framebufferSize || clipScale != state.clipScale) && !state.data.isEmpty())
+        setNeedsUpdate(LayerState::NeedsDataUpdate);
+
+    BaseLayer::doSetSize(size, framebufferSize);
+
     /** @todo Max or min? Should I even bother with non-square scaling? */
     sharedState.shader.setProjection(size, (size/Vector2{framebufferSize}).max());
+    for(BaseShaderGL& variant: sharedState.shaderVariants)
+        if(variant.id()) variant.setProjection(sharedState.shader.projection());
+
+    /* For scaling and Y-flipping the clip rects in doUpdate() and doDraw() */
+    state.clipScale = clipScale;
 
-    /* For scaling and Y-flipping the clip rects in doDraw() */
-    state.clipScale = Vector2{framebufferSize}/size;
+    if(sharedState.flags >= BaseLayerSharedFlag::OpaqueDepthPrepass)
+        sharedState.depthShader.setProjection(size);
 
     if(sharedState.flags & BaseLayerSharedFlag::BackgroundBlur) {
-        sharedState.backgroundBlurShader.setProjection(size);
+        /* The output texture is recreated, so there's nothing cached anymore */
+        sharedState.backgroundBlurCacheRenderer = nullptr;
+
+        /* With a downscale factor the blur is done in smaller textures, which
+           are then linearly upsampled when drawing. Make sure it's never
+           zero-sized. */
+        const Vector2i blurSize = Math::max(framebufferSize/Int(sharedState.backgroundBlurDownscale), Vector2i{1});
+        sharedState.backgroundBlurSize = blurSize;
 
-        (sharedState.backgroundBlurTextureVertical = GL::Texture2D{})
-            .setWrapping(GL::SamplerWrapping::ClampToEdge)
-            .setStorage(1, GL::TextureFormat::RGBA8, framebufferSize);
         (sharedState.backgroundBlurTextureHorizontal = GL::Texture2D{})
             .setWrapping(GL::SamplerWrapping::ClampToEdge)
-            .setStorage(1, GL::TextureFormat::RGBA8, framebufferSize);
-
-        (sharedState.backgroundBlurFramebufferVertical = GL::Framebuffer{{{}, framebufferSize}})
-            .attachTexture(GL::Framebuffer::ColorAttachment{0}, sharedState.backgroundBlurTextureVertical, 0);
-        (sharedState.backgroundBlurFramebufferHorizontal = GL::Framebuffer{{{}, framebufferSize}})
+            .setStorage(1, GL::TextureFormat::RGBA8, blurSize);
+        (sharedState.backgroundBlurFramebufferHorizontal = GL::Framebuffer{{{}, blurSize}})
             .attachTexture(GL::Framebuffer::ColorAttachment{0}, sharedState.backgroundBlurTextureHorizontal, 0);
+
+        if(sharedState.backgroundBlurAlgorithm == BaseLayerBackgroundBlurAlgorithm::DualKawase) {
+            sharedState.backgroundBlurDownsampleShader.setProjection(size);
+            sharedState.backgroundBlurUpsampleShader.setProjection(size);
+
+            /* Create all levels down to a single pixel in the smaller
+               dimension. Which of them get used depends on the radius and the
+               pass count, which can be different for each layer. In total
+               it's just a third of the memory needed by the full-size
+               texture. The levels are sampled in between texels, so they need
+               linear filtering also for minification. */
+            const UnsignedInt levelCount = Math::log2(UnsignedInt(blurSize.min()));
+            sharedState.backgroundBlurLevelTextures = Containers::Array<GL::Texture2D>{DirectInit, levelCount, NoCreate};
+            sharedState.backgroundBlurLevelFramebuffers = Containers::Array<GL::Framebuffer>{DirectInit, levelCount, NoCreate};
+            for(UnsignedInt i = 0; i != levelCount; ++i) {
+                const Vector2i levelSize = blurSize >> (i + 1);
+                (sharedState.backgroundBlurLevelTextures[i] = GL::Texture2D{})
+                    .setMinificationFilter(GL::SamplerFilter::Linear)
+                    .setMagnificationFilter(GL::SamplerFilter::Linear)
+                    .setWrapping(GL::SamplerWrapping::ClampToEdge)
+                    .setStorage(1, GL::TextureFormat::RGBA8, levelSize);
+                (sharedState.backgroundBlurLevelFramebuffers[i] = GL::Framebuffer{{{}, levelSize}})
+                    .attachTexture(GL::Framebuffer::ColorAttachment{0}, sharedState.backgroundBlurLevelTextures[i], 0);
+            }
+        } else {
+            sharedState.backgroundBlurShader.setProjection(size);
+
+            (sharedState.backgroundBlurTextureVertical = GL::Texture2D{})
+                .setWrapping(GL::SamplerWrapping::ClampToEdge)
+                .setStorage(1, GL::TextureFormat::RGBA8, blurSize);
+            (sharedState.backgroundBlurFramebufferVertical = GL::Framebuffer{{{}, blurSize}})
+                .attachTexture(GL::Framebuffer::ColorAttachment{0}, sharedState.backgroundBlurTextureVertical, 0);
+        }
     }
 }
 
@@ -506,52 +1097,264 @@ void BaseLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
        doUpdate() that syncs the stamps. For dynamic styles, if the style
        changed, it should be accompanied by NeedsCommonDataUpdate being set in
        order to be correctly handled below. */
-    const bool sharedStyleChanged = sharedState.styleUpdateStamp != state.styleUpdateStamp;
-    CORRADE_INTERNAL_ASSERT(!sharedState.dynamicStyleCount || (!sharedStyleChanged && !state.dynamicStyleChanged) || states >= LayerState::NeedsCommonDataUpdate);
+    state.sharedStyleChanged = sharedState.styleUpdateStamp != state.styleUpdateStamp;
+    CORRADE_INTERNAL_ASSERT(!sharedState.dynamicStyleCount || (!state.sharedStyleChanged && !state.dynamicStyleChanged) || states >= LayerState::NeedsCommonDataUpdate);
 
     BaseLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
 
+    /* With shader clipping, fill in the framebuffer-space clip rect for every
+       vertex. Clip rects change with node offsets and sizes, which implies
+       NeedsNodeOrderUpdate, or with node translation. The data update is for
+       newly added data and for framebuffer size changes, which are triggered
+       from doSetSize(). Keep the checks in sync with doPostUpdate(). */
+    if(sharedState.flags >= BaseLayerSharedFlag::ShaderClipping && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsNodeTranslationUpdate ||
+       states >= LayerState::NeedsDataUpdate))
+    {
+        /* Instances are in draw order, vertices in the order of data IDs */
+        const bool instanced = sharedState.flags >= BaseLayerSharedFlag::InstancedQuads;
+        const UnsignedInt vertexCount = instanced ? 1 :
+            sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads ? 16 : 4;
+        arrayResize(state.clipRects, NoInit, (instanced ? dataIds.size() : capacity())*vertexCount);
+
+        std::size_t clipDataOffset = 0;
+        for(std::size_t i = 0; i != clipRectIds.size(); ++i) {
+            const UnsignedInt clipRectId = clipRectIds[i];
+            const Range2Di rect = Implementation::framebufferClipRect(clipRectOffsets[clipRectId], clipRectSizes[clipRectId], state.clipScale, state.framebufferSize);
+            const Vector4 clipRect{Vector2{rect.min()}, Vector2{rect.max()}};
+
+            const std::size_t clipDataEnd = clipDataOffset + clipRectDataCounts[i];
+            for(std::size_t j = clipDataOffset; j != clipDataEnd; ++j) {
+                const std::size_t vertexOffset = (instanced ? j : dataIds[j])*vertexCount;
+                for(std::size_t k = 0; k != vertexCount; ++k)
+                    state.clipRects[vertexOffset + k] = clipRect;
+            }
+
+            clipDataOffset = clipDataEnd;
+        }
+
+        CORRADE_INTERNAL_ASSERT(clipDataOffset == dataIds.size());
+    }
+
+    /* With shader node properties, copy the node offset and size and the
+       node opacity to two texels for each node. Node offset and size change
+       implies NeedsNodeOrderUpdate, node translation alone is a separate
+       flag. Properties of nodes that aren't visible are left uninitialized by
+       the UI, they're not drawn so their contents don't matter. The padding
+       is cleared to not cause spurious uploads. Keep the checks in sync with
+       doPostUpdate(). */
+    if(sharedState.flags >= BaseLayerSharedFlag::ShaderNodeProperties && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsNodeTranslationUpdate ||
+       states >= LayerState::NeedsNodeOpacityUpdate))
+    {
+        const std::size_t texelCount = nodeOffsets.size()*2;
+        const std::size_t rows = (texelCount + NodePropertiesTextureWidth - 1)/NodePropertiesTextureWidth;
+        arrayResize(state.nodeProperties, NoInit, rows*NodePropertiesTextureWidth);
+        for(std::size_t i = 0; i != nodeOffsets.size(); ++i) {
+            const Vector2 offset = nodeOffsets[i];
+            const Vector2 size = nodeSizes[i];
+            state.nodeProperties[i*2 + 0] = {offset.x(), offset.y(), size.x(), size.y()};
+            state.nodeProperties[i*2 + 1] = {nodeOpacities[i], 0.0f, 0.0f, 0.0f};
+        }
+        for(Vector4& i: state.nodeProperties.exceptPrefix(texelCount))
+            i = {};
+    }
+
+    /* All GL uploads are done in doPostUpdate() as this function may be
+       called from a different thread */
+}
+
+void BaseLayerGL::doPostUpdate(const LayerStates states) {
+    /* The base implementation calls the texture streaming loader, which may
+       upload to the GPU */
+    BaseLayer::doPostUpdate(states);
+
+    State& state = static_cast<State&>(*_state);
+    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+
     /* The branching here mirrors how BaseLayer::doUpdate() restricts the
        updates. Keep in sync. */
-    if(states >= LayerState::NeedsNodeOrderUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+    const bool instanced = sharedState.flags >= BaseLayerSharedFlag::InstancedQuads;
+    std::size_t uploadedSize = 0;
+    /* With StableIndices the index data change only if the capacity
+       changes, which is detected by the size being different */
+    if(!instanced && (sharedState.flags >= BaseLayerSharedFlag::StableIndices ?
+       state.uploadedIndices.size() != state.indices.size()*sizeof(UnsignedInt) :
+       (states >= LayerState::NeedsNodeOrderUpdate ||
+        states >= LayerState::NeedsDataUpdate)))
     {
-        state.indexBuffer.setData(state.indices);
+        /* Indices are compared per data, which is 6 indices for a quad or
+           54 for a subdivided one */
+        uploadedSize += Implementation::uploadChangedRanges(state.indexBuffer, state.uploadedIndices,
+            Containers::arrayCast<const char>(Containers::arrayView(state.indices)),
+            (sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads ? 54 : 6)*sizeof(UnsignedInt));
         state.mesh.setCount(state.indices.size());
     }
-    if(states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+    if(!instanced && (
+       states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+       states >= LayerState::NeedsNodeTranslationUpdate ||
        states >= LayerState::NeedsNodeEnabledUpdate ||
        states >= LayerState::NeedsNodeOpacityUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+       states >= LayerState::NeedsDataUpdate ||
+       states >= LayerState::NeedsDataStyleUpdate))
+    {
+        /* Vertices are compared per data as well. The vertex array is sized
+           to the layer capacity, so the per-data size can be derived from
+           it. */
+        if(const std::size_t capacity = this->capacity())
+            uploadedSize += Implementation::uploadChangedRanges(state.vertexBuffer, state.uploadedVertices, state.vertices, state.vertices.size()/capacity);
+    }
+    const bool shaderNodeProperties = sharedState.flags >= BaseLayerSharedFlag::ShaderNodeProperties;
+    if(instanced && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+       (!shaderNodeProperties && states >= LayerState::NeedsNodeTranslationUpdate) ||
+       states >= LayerState::NeedsNodeEnabledUpdate ||
+       (!shaderNodeProperties && states >= LayerState::NeedsNodeOpacityUpdate) ||
+       states >= LayerState::NeedsDataUpdate))
+    {
+        /* Instances are in draw order, so they're compared per draw position
+           and not per data. With shader node properties they don't change
+           with node offsets and sizes, so in that case nothing gets
+           uploaded. */
+        uploadedSize += Implementation::uploadChangedRanges(state.vertexBuffer, state.uploadedVertices, state.vertices,
+            shaderNodeProperties ?
+                (sharedState.flags & BaseLayerSharedFlag::Textured ?
+                    sizeof(Implementation::BaseLayerTexturedNodeInstance) :
+                    sizeof(Implementation::BaseLayerNodeInstance)) :
+                (sharedState.flags & BaseLayerSharedFlag::Textured ?
+                    sizeof(Implementation::BaseLayerTexturedInstance) :
+                    sizeof(Implementation::BaseLayerInstance)));
+    }
+    /* With shader node properties, upload the rows of node properties that
+       changed since the last upload. If the node count grows beyond what the
+       texture can hold, it's recreated with twice the rows and uploaded
+       whole. */
+    if(shaderNodeProperties && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsNodeTranslationUpdate ||
+       states >= LayerState::NeedsNodeOpacityUpdate))
+    {
+        const Int rows = Int(state.nodeProperties.size()/NodePropertiesTextureWidth);
+        if(rows > state.nodePropertiesTextureRows) {
+            const Int newRows = Math::max(rows, 2*state.nodePropertiesTextureRows);
+            /* The format isn't filterable, so the filtering has to be Nearest
+               for the texture to be complete, even though it's only ever
+               accessed with texelFetch() */
+            state.nodePropertiesTexture = GL::Texture2D{};
+            state.nodePropertiesTexture
+                .setMinificationFilter(GL::SamplerFilter::Nearest)
+                .setMagnificationFilter(GL::SamplerFilter::Nearest)
+                .setStorage(1, GL::TextureFormat::RGBA32F, {NodePropertiesTextureWidth, newRows});
+            state.nodePropertiesTextureRows = newRows;
+            arrayResize(state.uploadedNodeProperties, 0);
+        }
+
+        /* Compared per row, rows past what was uploaded last time are
+           uploaded always */
+        const Containers::ArrayView<const char> current = Containers::arrayCast<const char>(Containers::arrayView(state.nodeProperties));
+        const auto uploadRows = [&state, &current](const std::size_t offset, const std::size_t size) {
+            constexpr std::size_t RowSize = NodePropertiesTextureWidth*sizeof(Vector4);
+            state.nodePropertiesTexture.setSubImage(0, {0, Int(offset/RowSize)}, ImageView2D{PixelFormat::RGBA32F, {NodePropertiesTextureWidth, Int(size/RowSize)}, current.sliceSize(offset, size)});
+        };
+        const std::size_t commonSize = Math::min(state.uploadedNodeProperties.size(), state.nodeProperties.size())*sizeof(Vector4);
+        Containers::Pair<std::size_t, std::size_t> ranges[16];
+        const std::size_t rangeCount = Implementation::dirtyRangesInto(
+            Containers::arrayCast<const char>(Containers::arrayView(state.uploadedNodeProperties)).prefix(commonSize),
+            current.prefix(commonSize),
+            NodePropertiesTextureWidth*sizeof(Vector4), ranges);
+        for(std::size_t i = 0; i != rangeCount; ++i) {
+            uploadRows(ranges[i].first(), ranges[i].second());
+            uploadedSize += ranges[i].second();
+        }
+        if(current.size() > commonSize) {
+            uploadRows(commonSize, current.size() - commonSize);
+            uploadedSize += current.size() - commonSize;
+        }
+
+        arrayResize(state.uploadedNodeProperties, NoInit, state.nodeProperties.size());
+        Utility::copy(state.nodeProperties, state.uploadedNodeProperties);
+    }
+    if(sharedState.flags >= BaseLayerSharedFlag::ShaderClipping && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsNodeTranslationUpdate ||
+       states >= LayerState::NeedsDataUpdate))
     {
-        state.vertexBuffer.setData(state.vertices);
+        /* Compared per data or per instance, same as the vertices */
+        uploadedSize += Implementation::uploadChangedRanges(state.clipRectBuffer, state.uploadedClipRects,
+            Containers::arrayCast<const char>(Containers::arrayView(state.clipRects)),
+            (instanced ? 1 : sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads ? 16 : 4)*sizeof(Vector4));
     }
     if(states >= LayerState::NeedsCompositeOffsetSizeUpdate && sharedState.flags & BaseLayerSharedFlag::BackgroundBlur) {
         state.backgroundBlurIndexBuffer.setData(state.backgroundBlurIndices);
         state.backgroundBlurVertexBuffer.setData(state.backgroundBlurVertices);
         state.backgroundBlurMesh.setCount(state.backgroundBlurIndices.size());
+        uploadedSize += state.backgroundBlurIndices.size()*sizeof(UnsignedInt) +
+                        state.backgroundBlurVertices.size()*sizeof(Vector2);
+    }
+    if(sharedState.flags >= BaseLayerSharedFlag::OpaqueDepthPrepass && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+       states >= LayerState::NeedsNodeTranslationUpdate ||
+       states >= LayerState::NeedsNodeEnabledUpdate ||
+       states >= LayerState::NeedsNodeOpacityUpdate ||
+       states >= LayerState::NeedsDataUpdate ||
+       states >= LayerState::NeedsDataStyleUpdate ||
+       states >= LayerState::NeedsCommonDataUpdate))
+    {
+        state.opaqueVertexBuffer.setData(state.opaqueVertices);
+        uploadedSize += state.opaqueVertices.size()*sizeof(Vector2);
     }
 
     /* If we have dynamic styles and either NeedsCommonDataUpdate is set
        (meaning either the static style or the dynamic style changed) or
        they haven't been uploaded yet at all, upload them. */
-    if(sharedState.dynamicStyleCount && ((states >= LayerState::NeedsCommonDataUpdate) || !state.styleBuffer.id())) {
-        const bool needsFirstUpload = !state.styleBuffer.id();
+    if(sharedState.dynamicStyleCount && ((states >= LayerState::NeedsCommonDataUpdate) || !state.styleBuffers[state.currentStyleBuffer].buffer.id())) {
+        /* With a ring of buffers, write to the next one in order to not stall
+           on the GPU still reading the one used for previous draws. Unless
+           there was nothing uploaded yet at all, in which case the current
+           one, i.e. the first, is used. */
+        if(state.styleBuffers[state.currentStyleBuffer].buffer.id())
+            state.currentStyleBuffer = (state.currentStyleBuffer + 1) % state.styleBufferCount;
+        State::StyleBuffer& styleBuffer = state.styleBuffers[state.currentStyleBuffer];
+
+        const std::size_t dynamicStyleOffset = sizeof(BaseLayerCommonStyleUniform) + sizeof(BaseLayerStyleUniform)*sharedState.styleUniformCount;
+        const Containers::ArrayView<const char> dynamicStyleUniforms = Containers::arrayCast<const char>(state.dynamicStyleUniforms);
+        const bool needsFirstUpload = !styleBuffer.buffer.id();
         if(needsFirstUpload) {
-            /** @todo check if DynamicDraw has any effect on perf */
-            state.styleBuffer = GL::Buffer{GL::Buffer::TargetHint::Uniform, {nullptr, sizeof(BaseLayerCommonStyleUniform) + sizeof(BaseLayerStyleUniform)*(sharedState.styleUniformCount + sharedState.dynamicStyleCount)}, GL::BufferUsage::DynamicDraw};
+            styleBuffer.buffer = GL::Buffer{GL::Buffer::TargetHint::Uniform, {nullptr, dynamicStyleOffset + dynamicStyleUniforms.size()}, GL::BufferUsage::DynamicDraw};
+            styleBuffer.uploadedDynamicStyleUniforms = Containers::Array<char>{NoInit, dynamicStyleUniforms.size()};
         }
-        if(needsFirstUpload || sharedStyleChanged) {
-            state.styleBuffer.setSubData(0, {&sharedState.commonStyleUniform, 1});
+
+        /* The shared styles are uploaded to each buffer only if they changed
+           since the last upload to given buffer */
+        if(needsFirstUpload || styleBuffer.styleUpdateStamp != sharedState.styleUpdateStamp) {
+            styleBuffer.buffer.setSubData(0, {&sharedState.commonStyleUniform, 1});
             /* Skip empty upload if there are just dynamic styles */
             if(!sharedState.styleUniforms.isEmpty())
-                state.styleBuffer.setSubData(sizeof(BaseLayerCommonStyleUniform), sharedState.styleUniforms);
+                styleBuffer.buffer.setSubData(sizeof(BaseLayerCommonStyleUniform), sharedState.styleUniforms);
+            styleBuffer.styleUpdateStamp = sharedState.styleUpdateStamp;
+            uploadedSize += sizeof(BaseLayerCommonStyleUniform) + sharedState.styleUniforms.size()*sizeof(BaseLayerStyleUniform);
         }
-        if(needsFirstUpload || state.dynamicStyleChanged) {
-            state.styleBuffer.setSubData(sizeof(BaseLayerCommonStyleUniform) + sizeof(BaseLayerStyleUniform)*sharedState.styleUniformCount, state.dynamicStyleUniforms);
-            state.dynamicStyleChanged = false;
+
+        /* Of the dynamic styles, usually just a few change at a time, such as
+           when animating, so upload only those that differ from what was
+           uploaded to given buffer last time. With a single buffer the copy
+           is the same as the current state if no dynamic style changed, so
+           the comparison can be skipped. */
+        if(needsFirstUpload) {
+            styleBuffer.buffer.setSubData(dynamicStyleOffset, dynamicStyleUniforms);
+            Utility::copy(dynamicStyleUniforms, styleBuffer.uploadedDynamicStyleUniforms);
+            uploadedSize += dynamicStyleUniforms.size();
+        } else if(state.styleBufferCount != 1 || state.dynamicStyleChanged) {
+            uploadedSize += Implementation::uploadChangedSubRanges(styleBuffer.buffer, dynamicStyleOffset, styleBuffer.uploadedDynamicStyleUniforms, dynamicStyleUniforms, sizeof(BaseLayerStyleUniform));
         }
+        state.dynamicStyleChanged = false;
     }
+
+    addUploadedSize(uploadedSize);
 }
 
 void BaseLayerGL::doComposite(AbstractRenderer& renderer, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, std::size_t offset, std::size_t count) {
@@ -559,13 +1362,77 @@ void BaseLayerGL::doComposite(AbstractRenderer& renderer, const Containers::Stri
     Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
     RendererGL& rendererGL = static_cast<RendererGL&>(renderer);
 
+    /* If the output texture contains a blur done by this layer with the same
+       renderer, content generation, pass count and composite rects, there's
+       nothing to do. Otherwise remember what's going to be blurred. */
+    if(sharedState.flags >= BaseLayerSharedFlag::BackgroundBlurCache) {
+        const UnsignedInt contentGeneration = rendererGL.compositingContentGeneration();
+        const Containers::ArrayView<const Vector2> vertices = state.backgroundBlurVertices.sliceSize(offset*4, count*4);
+        if(sharedState.backgroundBlurCacheRenderer == &rendererGL &&
+           sharedState.backgroundBlurCacheLayer == handle() &&
+           sharedState.backgroundBlurCacheContentGeneration == contentGeneration &&
+           sharedState.backgroundBlurCachePassCount == state.backgroundBlurPassCount &&
+           sharedState.backgroundBlurCacheVertices.size() == vertices.size() &&
+           std::memcmp(sharedState.backgroundBlurCacheVertices.data(), vertices.data(), vertices.size()*sizeof(Vector2)) == 0)
+            return;
+
+        sharedState.backgroundBlurCacheRenderer = &rendererGL;
+        sharedState.backgroundBlurCacheLayer = handle();
+        sharedState.backgroundBlurCacheContentGeneration = contentGeneration;
+        sharedState.backgroundBlurCachePassCount = state.backgroundBlurPassCount;
+        if(sharedState.backgroundBlurCacheVertices.size() != vertices.size())
+            sharedState.backgroundBlurCacheVertices = Containers::Array<Vector2>{NoInit, vertices.size()};
+        Utility::copy(vertices, sharedState.backgroundBlurCacheVertices);
+    }
+
     state.backgroundBlurMesh
         .setIndexOffset(offset*6)
         .setCount(count*6);
 
+    /* Downsample the compositing framebuffer texture to progressively
+       smaller levels, and then upsample back through the same levels to the
+       output texture. The level count is capped by how many levels there are
+       for given framebuffer size. */
+    if(sharedState.backgroundBlurAlgorithm == BaseLayerBackgroundBlurAlgorithm::DualKawase) {
+        const UnsignedInt levelCount = Math::min(
+            Implementation::backgroundBlurDualKawaseLevelCount(sharedState.backgroundBlurRadius, state.backgroundBlurPassCount),
+            UnsignedInt(sharedState.backgroundBlurLevelTextures.size()));
+
+        GL::Texture2D* input = &rendererGL.compositingTexture();
+        Vector2i inputSize = state.framebufferSize;
+        for(UnsignedInt i = 0; i != levelCount; ++i) {
+            sharedState.backgroundBlurLevelFramebuffers[i].bind();
+            sharedState.backgroundBlurDownsampleShader
+                .setHalfTexelSize(0.5f/Vector2{inputSize})
+                .bindTexture(*input)
+                .draw(state.backgroundBlurMesh);
+
+            input = &sharedState.backgroundBlurLevelTextures[i];
+            inputSize = sharedState.backgroundBlurSize >> (i + 1);
+        }
+
+        /* Upsampling from level i to level i - 1, the last step goes from
+           the first level to the output texture */
+        for(UnsignedInt i = levelCount; i != 0; --i) {
+            if(i != 1)
+                sharedState.backgroundBlurLevelFramebuffers[i - 2].bind();
+            else
+                sharedState.backgroundBlurFramebufferHorizontal.bind();
+            sharedState.backgroundBlurUpsampleShader
+                .setHalfTexelSize(0.5f/Vector2{sharedState.backgroundBlurSize >> i})
+                .bindTexture(sharedState.backgroundBlurLevelTextures[i - 1])
+                .draw(state.backgroundBlurMesh);
+        }
+
+        return;
+    }
+
     /* Perform the blur in as many passes as desired. For the first pass the
        input is the compositing framebuffer texture, successive passes take
-       output of the previous horizontal blur for the next vertical blur. */
+       output of the previous horizontal blur for the next vertical blur. The
+       direction is in full framebuffer texels even if the blur textures are
+       downscaled, so the blur radius stays the same relative to the
+       framebuffer. */
     GL::Texture2D* input = &rendererGL.compositingTexture();
     for(UnsignedInt i = 0; i != state.backgroundBlurPassCount; ++i) {
         sharedState.backgroundBlurFramebufferVertical.bind();
@@ -596,42 +1463,141 @@ void BaseLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>
         "Ui::BaseLayerGL::draw(): no texture to draw with was set", );
 
     /* If there are dynamic styles, bind the layer-specific buffer that
-       contains them, otherwise bind the shared buffer */
+       contains them, otherwise bind the shared buffer. The bindings are
+       global, so they're used by the shader variants as well. */
     sharedState.shader.bindStyleBuffer(sharedState.dynamicStyleCount ?
-        state.styleBuffer : sharedState.styleBuffer);
+        state.styleBuffers[state.currentStyleBuffer].buffer : sharedState.styleBuffer);
 
     if(sharedState.flags & BaseLayerSharedFlag::Textured)
         sharedState.shader.bindTexture(state.texture);
     if(sharedState.flags & BaseLayerSharedFlag::BackgroundBlur)
         sharedState.shader.bindBackgroundBlurTexture(sharedState.backgroundBlurTextureHorizontal);
+    /* The node properties texture is created on the first update with any
+       nodes, if there's none yet, there's also nothing drawn */
+    if(sharedState.flags >= BaseLayerSharedFlag::ShaderNodeProperties && state.nodePropertiesTexture.id())
+        sharedState.shader.bindNodePropertiesTexture(state.nodePropertiesTexture);
 
+    const bool instanced = sharedState.flags >= BaseLayerSharedFlag::InstancedQuads;
+    const bool stableIndices = sharedState.flags >= BaseLayerSharedFlag::StableIndices;
     const UnsignedInt drawSize = sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads ? 54 : 6;
 
-    std::size_t clipDataOffset = offset;
-    for(std::size_t i = 0; i != clipRectCount; ++i) {
-        const UnsignedInt clipRectId = clipRectIds[clipRectOffset + i];
-        const UnsignedInt clipRectDataCount = clipRectDataCounts[clipRectOffset + i];
-        const Vector2i clipRectOffset_ = Vector2i{clipRectOffsets[clipRectId]*state.clipScale};
-        const Vector2i clipRectSize = clipRectSizes[clipRectId].isZero() ?
-            state.framebufferSize : Vector2i{clipRectSizes[clipRectId]*state.clipScale};
-
-        GL::Renderer::setScissor(Range2Di::fromSize(
-            {clipRectOffset_.x(), state.framebufferSize.y() - clipRectOffset_.y() - clipRectSize.y()},
-            clipRectSize));
+    /* Draws given range of the draw order */
+    const auto drawRange = [&](const std::size_t drawOffset, const std::size_t drawCount) {
+        /* With stable indices, draw each run of consecutive data IDs that
+           overlaps the range as a separate index range in a single
+           multi-draw */
+        if(stableIndices) {
+            const Containers::ArrayView<const Implementation::BaseLayerDrawRun> runs = state.drawRuns;
+            const std::size_t drawEnd = drawOffset + drawCount;
+            arrayResize(state.drawRunViews, 0);
+            for(std::size_t run = findRun(runs, drawOffset); runs[run].drawOffset < drawEnd; ++run) {
+                const std::size_t begin = Math::max(std::size_t(runs[run].drawOffset), drawOffset);
+                const std::size_t end = Math::min(std::size_t(runs[run + 1].drawOffset), drawEnd);
+                arrayAppend(state.drawRunViews, InPlaceInit, state.mesh)
+                    .setIndexOffset((runs[run].dataId + begin - runs[run].drawOffset)*drawSize)
+                    .setCount((end - begin)*drawSize);
+            }
+
+            if(!state.drawRunViews.isEmpty())
+                sharedState.shader
+                    .draw(Containers::arrayView(state.drawRunViews));
+
+        /* Otherwise both the indices and the instances are in draw order, so
+           the draw offset maps directly to the index or instance offset */
+        } else {
+            const auto drawMesh = [&](BaseShaderGL& shader, const std::size_t meshOffset, const std::size_t meshCount) {
+                if(instanced) state.mesh
+                    .setInstanceCount(meshCount)
+                    .setBaseInstance(meshOffset);
+                else state.mesh
+                    .setIndexOffset(meshOffset*drawSize)
+                    .setCount(meshCount*drawSize);
+                shader.draw(state.mesh);
+            };
+
+            /* If the data aren't split by the features they use, draw
+               everything with the generic shader */
+            if(state.featureRuns.isEmpty()) {
+                drawMesh(sharedState.shader, drawOffset, drawCount);
+                return;
+            }
+
+            /* Otherwise draw each run overlapping the range with a shader
+               variant supporting just the features it needs */
+            const Containers::ArrayView<const Implementation::BaseLayerFeatureRun> runs = state.featureRuns;
+            const std::size_t drawEnd = drawOffset + drawCount;
+            for(std::size_t run = findRun(runs, drawOffset); runs[run].drawOffset < drawEnd; ++run) {
+                const std::size_t begin = Math::max(std::size_t(runs[run].drawOffset), drawOffset);
+                const std::size_t end = Math::min(std::size_t(runs[run + 1].drawOffset), drawEnd);
+
+                /* Until the variant finishes compiling, draw with the generic
+                   shader to not stall. Without explicit bindings the variant
+                   needs the post-link setup before its first use. */
+                BaseShaderGL* shader = &sharedState.shaderVariant(runs[run].features);
+                if(!shader->isCompileFinished())
+                    shader = &sharedState.shader;
+                else
+                    shader->finish();
+
+                drawMesh(*shader, begin, end - begin);
+            }
+        }
+    };
 
-        state.mesh
-            .setIndexOffset(clipDataOffset*drawSize)
-            .setCount(clipRectDataCount*drawSize);
-        sharedState.shader
-            .draw(state.mesh);
+    /* With shader clipping the clip rects are a part of the vertex data, so
+       everything is drawn at once. Otherwise there's a scissor rectangle and a
+       separate draw for each clip rect. */
+    if(sharedState.flags >= BaseLayerSharedFlag::ShaderClipping) {
+        drawRange(offset, count);
+    } else {
+        /* Consecutive clip rects can map to the same framebuffer rectangle,
+           for example if a clipping node is fully inside its clipping parent
+           or if both are unclipped. Set the scissor only if it differs from
+           what was set last, the first one is set always as the state from
+           outside isn't known. */
+        std::size_t clipDataOffset = offset;
+        Range2Di scissor;
+        for(std::size_t i = 0; i != clipRectCount; ++i) {
+            const UnsignedInt clipRectId = clipRectIds[clipRectOffset + i];
+            const UnsignedInt clipRectDataCount = clipRectDataCounts[clipRectOffset + i];
+            const Range2Di clipRect = Implementation::framebufferClipRect(clipRectOffsets[clipRectId], clipRectSizes[clipRectId], state.clipScale, state.framebufferSize);
+            if(!i || clipRect != scissor) {
+                GL::Renderer::setScissor(clipRect);
+                scissor = clipRect;
+            }
+
+            drawRange(clipDataOffset, clipRectDataCount);
+
+            clipDataOffset += clipRectDataCount;
+        }
 
-        clipDataOffset += clipRectDataCount;
+        CORRADE_INTERNAL_ASSERT(clipDataOffset == offset + count);
     }
+}
 
-    CORRADE_INTERNAL_ASSERT(clipDataOffset == offset + count);
-    #ifdef CORRADE_NO_ASSERT
-    static_cast<void>(count);
-    #endif
+void BaseLayerGL::doDrawOpaque(const Containers::StridedArrayView1D<const UnsignedInt>&, const std::size_t offset, const std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, std::size_t, std::size_t, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) {
+    auto& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(!state.framebufferSize.isZero() && !state.clipScale.isZero(),
+        "Ui::BaseLayerGL::drawOpaque(): user interface size wasn't set", );
+
+    /* The opaque quads are already clipped in doUpdate(), so there's no
+       scissor to set. Draw all opaque quads in given range of the draw order,
+       if there are any. */
+    auto& sharedState = static_cast<Shared::State&>(state.shared);
+    const UnsignedInt quadOffset = state.opaqueQuadOffsets[offset];
+    const UnsignedInt quadCount = state.opaqueQuadOffsets[offset + count] - quadOffset;
+    if(!quadCount)
+        return;
+
+    /* For a non-indexed mesh the base vertex is the first vertex to draw */
+    state.opaqueMesh
+        .setBaseVertex(quadOffset*6)
+        .setCount(quadCount*6);
+    /* The depth shader has no setter that'd implicitly wait for the
+       compilation to finish, so do it explicitly */
+    sharedState.depthShader.finish();
+    sharedState.depthShader
+        .draw(state.opaqueMesh);
 }
 
 }}
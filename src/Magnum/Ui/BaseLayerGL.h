@@ -145,6 +145,17 @@ class MAGNUM_UI_EXPORT BaseLayerGL: public BaseLayer {
          */
         void doDraw(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t offset, std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, std::size_t clipRectOffset, std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) override;
 
+        /**
+         * @copybrief AbstractLayer::doDrawOpaque()
+         *
+         * Called only if @ref BaseLayerSharedFlag::OpaqueDepthPrepass is
+         * enabled. Same as with @ref doDraw(), a subclass can override this
+         * function to perform extra GL state changes and then delegate to the
+         * parent implementation. See @ref AbstractLayer::doDrawOpaque() for
+         * more information about how this function is called.
+         */
+        void doDrawOpaque(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t offset, std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, std::size_t clipRectOffset, std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) override;
+
     private:
         struct State;
 
@@ -152,10 +163,13 @@ class MAGNUM_UI_EXPORT BaseLayerGL: public BaseLayer {
            causes linker errors. See BaseLayerGLTest::constructDerived() for a
            repro case. */
         LayerFeatures doFeatures() const override;
+        MemoryUsage doMemoryUsage() const override;
+        void doTrim(std::size_t capacity) override;
 
         void doSetSize(const Vector2& size, const Vector2i& framebufferSize) override;
 
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
+        void doPostUpdate(LayerStates states) override;
 };
 
 /**
@@ -183,6 +197,19 @@ class MAGNUM_UI_EXPORT BaseLayerGL::Shared: public BaseLayer::Shared {
          */
         explicit Shared(NoCreateT) noexcept;
 
+        /**
+         * @brief Whether shader compilation has finished
+         * @m_since_latest
+         *
+         * The shaders are compiled and linked asynchronously if
+         * @gl_extension{KHR,parallel_shader_compile} is supported, allowing
+         * the application to do other work in the meantime. This function
+         * doesn't block. If the extension isn't supported, always returns
+         * @cpp true @ce. Drawing the layer before the compilation finished
+         * waits for it.
+         */
+        bool isCompileFinished();
+
     private:
         struct State;
         friend BaseLayerGL;
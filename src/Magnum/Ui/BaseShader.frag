@@ -69,6 +69,9 @@ uniform lowp sampler2D backgroundBlurTextureData;
 #endif
 
 flat in mediump uint interpolatedStyle;
+#ifdef SHADER_CLIPPING
+flat in highp vec4 interpolatedClipRect;
+#endif
 NOPERSPECTIVE in mediump vec4 interpolatedColor;
 #ifndef SUBDIVIDED_QUADS
 flat in mediump vec2 halfQuadSize;
@@ -84,6 +87,9 @@ NOPERSPECTIVE in mediump vec4 edgeDistance;
    edgeDistance is always at least as large, cancelling them. */
 NOPERSPECTIVE in mediump float cornerRadius;
 NOPERSPECTIVE in mediump float outlineCornerRadius;
+/* Non-zero in both components only in the corner quads, zero in both in the
+   center quad */
+NOPERSPECTIVE in lowp vec2 outerVertex;
 #endif
 #ifdef TEXTURED
 NOPERSPECTIVE in mediump vec3 interpolatedTextureCoordinates;
@@ -95,6 +101,15 @@ NOPERSPECTIVE in highp vec2 backgroundBlurTextureCoordinates;
 out lowp vec4 fragmentColor;
 
 void main() {
+    /* The clip rect is in whole framebuffer pixels and gl_FragCoord is at
+       pixel centers, so this discards exactly the pixels a scissor rectangle
+       of the same size would */
+    #ifdef SHADER_CLIPPING
+    if(any(lessThan(gl_FragCoord.xy, interpolatedClipRect.xy)) ||
+       any(greaterThan(gl_FragCoord.xy, interpolatedClipRect.zw)))
+        discard;
+    #endif
+
     #ifndef SUBDIVIDED_QUADS
     mediump vec2 position = interpolatedCenterDistance;
 
@@ -168,24 +183,35 @@ void main() {
     }
     #endif
     #else
-    /* Is (0, 0) in centers of outer corner radii, positive in corners,
-       negative at the edges */
-    lowp vec2 cornerCenterDistance = vec2(cornerRadius) - edgeDistance.xy;
-    /* Distance from the actual (rounded) edge, positive inside, negative
-       outside */
-    lowp float dist =
-        /* (Negative) distance from the corner edge, or +radius if not inside
-           any corner */
-        cornerRadius - length(max(cornerCenterDistance, vec2(0.0)))
-        /* (Positive) distance from closest center of corner radii, or 0 if
-           at the edges */
-        - min(max(cornerCenterDistance.x, cornerCenterDistance.y), 0.0);
+    lowp float dist;
+    lowp float outlineDist;
+    if(outerVertex.x > 0.0 && outerVertex.y > 0.0) {
+        /* Is (0, 0) in centers of outer corner radii, positive in corners,
+           negative at the edges */
+        lowp vec2 cornerCenterDistance = vec2(cornerRadius) - edgeDistance.xy;
+        /* Distance from the actual (rounded) edge, positive inside, negative
+           outside */
+        dist =
+            /* (Negative) distance from the corner edge, or +radius if not
+               inside any corner */
+            cornerRadius - length(max(cornerCenterDistance, vec2(0.0)))
+            /* (Positive) distance from closest center of corner radii, or 0
+               if at the edges */
+            - min(max(cornerCenterDistance.x, cornerCenterDistance.y), 0.0);
 
-    /* And similarly for the inner outline edge */
-    lowp vec2 outlineCornerCenterDistance = vec2(outlineCornerRadius) - edgeDistance.zw;
-    lowp float outlineDist =
-        outlineCornerRadius - length(max(outlineCornerCenterDistance, vec2(0.0)))
-        - min(max(outlineCornerCenterDistance.x, outlineCornerCenterDistance.y), 0.0);
+        /* And similarly for the inner outline edge */
+        lowp vec2 outlineCornerCenterDistance = vec2(outlineCornerRadius) - edgeDistance.zw;
+        outlineDist =
+            outlineCornerRadius - length(max(outlineCornerCenterDistance, vec2(0.0)))
+            - min(max(outlineCornerCenterDistance.x, outlineCornerCenterDistance.y), 0.0);
+
+    /* In the edge and center quads the edge distance along the edge is always
+       at least the corner radius, so the above reduces to just the distance to
+       the closest edge */
+    } else {
+        dist = min(edgeDistance.x, edgeDistance.y);
+        outlineDist = min(edgeDistance.z, edgeDistance.w);
+    }
     #endif
 
     #if !defined(NO_OUTLINE) || defined(SUBDIVIDED_QUADS)
@@ -233,6 +259,15 @@ void main() {
     #endif
     #endif
 
+    /* The center quad is positioned so that no edge including its smoothness
+       reaches into it, so there's just the gradient color */
+    #ifdef SUBDIVIDED_QUADS
+    if(outerVertex.x == 0.0 && outerVertex.y == 0.0) {
+        fragmentColor = gradientColor;
+        return;
+    }
+    #endif
+
     /* Blend between the base and outline color. The goal is that, if a
        particular edge has a zero outline width, the outline color should not
        leak to the base color. In case the inner and outer smoothness is the
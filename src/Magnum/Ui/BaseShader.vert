@@ -53,9 +53,25 @@ layout(location = 0)
 uniform highp vec3 projection; /* xy = UI size to unit square scaling,
                                   z = pixel smoothness to UI size scaling */
 
+#ifndef INSTANCED_QUADS
 layout(location = 0) in highp vec2 position;
+#else
+/* Corner of a static unit quad, and the quad min and max per instance. The
+   position, center distance and texture coordinates are then calculated from
+   these in main(). */
+layout(location = 0) in lowp vec2 quadCorner;
+#ifndef SHADER_NODE_PROPERTIES
+layout(location = 1) in highp vec4 quadMinMax;
+#else
+/* Quad padding relative to the node, including the smoothness expansion. The
+   node offset and size is fetched from the node properties texture. */
+layout(location = 1) in highp vec4 quadPadding;
+#endif
+#endif
 #ifndef SUBDIVIDED_QUADS
+#ifndef INSTANCED_QUADS
 layout(location = 1) in mediump vec2 centerDistance;
+#endif
 #ifndef NO_OUTLINE
 layout(location = 2) in mediump vec4 outlineWidth;
 #endif
@@ -69,13 +85,45 @@ layout(location = 1) in mediump vec3 centerDistanceYTextureScale;
 #endif
 layout(location = 2) in mediump vec2 outlineWidth;
 #endif
+#ifndef SHADER_NODE_PROPERTIES
 layout(location = 3) in lowp vec4 color;
+#else
+/* Without the node opacity applied */
+layout(location = 3) in lowp vec4 dataColor;
+#endif
 layout(location = 4) in mediump uint style;
 #ifdef TEXTURED
+#ifndef INSTANCED_QUADS
 layout(location = 5) in mediump vec3 textureCoordinates;
+#elif !defined(SHADER_NODE_PROPERTIES)
+layout(location = 5) in mediump vec3 textureCoordinateMin; /* z = layer */
+layout(location = 6) in mediump vec2 textureCoordinateMax;
+#else
+layout(location = 5) in mediump vec3 textureCoordinateOffset; /* z = layer */
+layout(location = 6) in mediump vec2 textureCoordinateSize;
+#endif
+#endif
+#ifdef SHADER_NODE_PROPERTIES
+/* Index into the node properties texture */
+layout(location = 8) in highp uint nodeId;
+
+/* Two texels for each node, first with the node offset in xy and size in zw,
+   second with the absolute node opacity in x. Laid out in rows of
+   NODE_PROPERTIES_TEXTURE_WIDTH texels. */
+#ifdef EXPLICIT_BINDING
+layout(binding = 2)
+#endif
+uniform highp sampler2D nodePropertiesTextureData;
+#endif
+#ifdef SHADER_CLIPPING
+/* Framebuffer-space clip rect min and max in pixels */
+layout(location = 7) in highp vec4 clipRect;
 #endif
 
 flat out mediump uint interpolatedStyle;
+#ifdef SHADER_CLIPPING
+flat out highp vec4 interpolatedClipRect;
+#endif
 NOPERSPECTIVE out lowp vec4 interpolatedColor;
 #ifdef TEXTURED
 NOPERSPECTIVE out mediump vec3 interpolatedTextureCoordinates;
@@ -92,10 +140,48 @@ NOPERSPECTIVE out mediump vec2 interpolatedCenterDistance;
 NOPERSPECTIVE out mediump vec4 edgeDistance;
 NOPERSPECTIVE out mediump float cornerRadius;
 NOPERSPECTIVE out mediump float outlineCornerRadius;
+/* 1 for outer vertices in given direction, 0 for inner */
+NOPERSPECTIVE out lowp vec2 outerVertex;
 #endif
 
 void main() {
     interpolatedStyle = style;
+    #ifdef SHADER_CLIPPING
+    interpolatedClipRect = clipRect;
+    #endif
+
+    /* Calculate the absolute quad min and max and the color from the node
+       properties, the rest is then the same as with regular instances */
+    #ifdef SHADER_NODE_PROPERTIES
+    highp int nodeTexelId = int(nodeId)*2;
+    highp ivec2 nodeTexelCoordinates = ivec2(
+        nodeTexelId % NODE_PROPERTIES_TEXTURE_WIDTH,
+        nodeTexelId / NODE_PROPERTIES_TEXTURE_WIDTH);
+    highp vec4 nodeOffsetSize = texelFetch(nodePropertiesTextureData, nodeTexelCoordinates, 0);
+    lowp float nodeOpacity = texelFetch(nodePropertiesTextureData, nodeTexelCoordinates + ivec2(1, 0), 0).x;
+    highp vec4 quadMinMax = vec4(
+        nodeOffsetSize.xy + quadPadding.xy,
+        nodeOffsetSize.xy + nodeOffsetSize.zw - quadPadding.zw);
+    lowp vec4 color = dataColor*nodeOpacity;
+    #ifdef TEXTURED
+    /* Same smoothness expansion as BaseLayer does on the CPU side for
+       regular instances. Y-flipped compared to the positions. */
+    mediump float textureSmoothness = commonStyle_smoothness*projection.z;
+    mediump vec2 smoothnessExpansion = textureCoordinateSize*textureSmoothness/(quadMinMax.zw - quadMinMax.xy - vec2(2.0*textureSmoothness))*vec2(1.0, -1.0);
+    mediump vec3 textureCoordinateMin = vec3(textureCoordinateOffset.xy + vec2(0.0, textureCoordinateSize.y) - smoothnessExpansion, textureCoordinateOffset.z);
+    mediump vec2 textureCoordinateMax = textureCoordinateOffset.xy + vec2(textureCoordinateSize.x, 0.0) + smoothnessExpansion;
+    #endif
+    #endif
+
+    /* Expand the instance to the same per-vertex inputs as the non-instanced
+       case has */
+    #ifdef INSTANCED_QUADS
+    highp vec2 position = mix(quadMinMax.xy, quadMinMax.zw, quadCorner);
+    mediump vec2 centerDistance = (quadCorner - vec2(0.5))*(quadMinMax.zw - quadMinMax.xy);
+    #ifdef TEXTURED
+    mediump vec3 textureCoordinates = vec3(mix(textureCoordinateMin.xy, textureCoordinateMax, quadCorner), textureCoordinateMin.z);
+    #endif
+    #endif
 
     /* Case with just a single quad -- the position, center distance and
        texture coordinates all already contain the smoothness expansion */
@@ -191,20 +277,28 @@ void main() {
     lowp float smoothness = commonStyle_smoothness*projection.z;
     lowp float innerOutlineSmoothness = commonStyle_innerOutlineSmoothness*projection.z;
     mediump float radiusOrSmoothnessShift = max(cornerRadius, smoothness);
-    mediump float innerRadiusOrSmoothnessShift = max(1.0*projection.z, max(outlineCornerRadius, innerOutlineSmoothness));
+    /* The outer smoothness is included as well, as the inner edge smoothness
+       gets adjusted towards it for thin outlines. That makes the center quad
+       never touched by any edge, and the fragment shader can output just the
+       gradient color there. */
+    mediump float innerRadiusOrSmoothnessShift = max(1.0*projection.z, max(outlineCornerRadius, max(innerOutlineSmoothness, smoothness)));
 
     /* Calculate how far to shift so the inner vertices include both radii and
        corresponding smoothness and the total outline width, and the outer
        vertices include the outer smoothness in the opposite direction. */
     if((vertexId & 1) == 1) { /* Horizontal shift */
         edgeDistance.x = max(radiusOrSmoothnessShift, innerRadiusOrSmoothnessShift + totalOutlineWidth.x);
+        outerVertex.x = 0.0;
     } else {
         edgeDistance.x = -smoothness;
+        outerVertex.x = 1.0;
     }
     if((vertexId & 2) == 2) { /* Vertical shift */
         edgeDistance.y = max(radiusOrSmoothnessShift, innerRadiusOrSmoothnessShift + totalOutlineWidth.y);
+        outerVertex.y = 0.0;
     } else {
         edgeDistance.y = -smoothness;
+        outerVertex.y = 1.0;
     }
 
     /* Inner edge distance is then with the outline width subtracted */
@@ -26,6 +26,9 @@
 
 #include "Button.h"
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringIterable.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Assert.h>
 #include <Magnum/Math/Vector2.h>
@@ -307,4 +310,75 @@ Anchor button(const Anchor& anchor, const Containers::StringView text, const But
     return button(anchor, text, {}, style);
 }
 
+void buttons(UserInterface& ui, const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<const Icon>& icons, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& textProperties, const Containers::StridedArrayView1D<const ButtonStyle>& styles) {
+    CORRADE_ASSERT((icons.isEmpty() || icons.size() == nodes.size()) &&
+                   (texts.isEmpty() || texts.size() == nodes.size()) &&
+                   (textProperties.isEmpty() || textProperties.size() == nodes.size()) &&
+                   styles.size() == nodes.size(),
+        "Ui::buttons(): expected icon, text, text property and style views to have a size of" << nodes.size() << "but got" << icons.size() << Debug::nospace << "," << texts.size() << Debug::nospace << "," << textProperties.size() << "and" << styles.size(), );
+
+    BaseLayer& baseLayer = ui.baseLayer();
+    TextLayer& textLayer = ui.textLayer();
+    Containers::Array<ButtonData> data{ValueInit, nodes.size()};
+
+    /* Reserve the layer data storage upfront so it's allocated just once.
+       Freed slots get reused first, so reserving for the used count plus
+       all new data is always enough. */
+    std::size_t textLayerDataCount = 0;
+    for(std::size_t i = 0; i != nodes.size(); ++i) {
+        if(!icons.isEmpty() && icons[i] != Icon::None)
+            ++textLayerDataCount;
+        if(!texts.isEmpty() && texts[i])
+            ++textLayerDataCount;
+    }
+    baseLayer.reserve(baseLayer.usedCount() + nodes.size());
+    textLayer.reserve(textLayer.usedCount() + textLayerDataCount);
+
+    for(std::size_t i = 0; i != nodes.size(); ++i)
+        data[i].background = dataHandleData(baseLayer.create(baseLayerStyle(styles[i]), nodes[i]));
+
+    /* Style ID for icons and texts is corrected in alignIconText() below */
+    if(!icons.isEmpty()) for(std::size_t i = 0; i != nodes.size(); ++i) {
+        if(icons[i] != Icon::None)
+            data[i].icon = dataHandleData(textLayer.createGlyph(textLayerStyleIconOnly(styles[i]), icons[i], {}, nodes[i]));
+    }
+
+    if(!texts.isEmpty()) {
+        /* Create empty text data first and then shape all of them in a
+           single batch, which reserves the glyph and text storage just
+           once. Empty texts don't get any data, which means the batch is
+           split into contiguous runs of non-empty texts. */
+        Containers::Array<Containers::StringView> textViews{NoInit, nodes.size()};
+        for(std::size_t i = 0; i != nodes.size(); ++i) {
+            textViews[i] = texts[i];
+            if(textViews[i])
+                data[i].text = dataHandleData(textLayer.create(textLayerStyleTextOnly(styles[i]), Containers::StringView{}, TextProperties{}, nodes[i]));
+        }
+
+        const TextProperties defaultProperties;
+        const Containers::StridedArrayView1D<const TextProperties> properties = textProperties.isEmpty() ?
+            Containers::stridedArrayView(&defaultProperties, 1).broadcasted<0>(nodes.size()) : textProperties;
+        const Containers::StridedArrayView1D<const LayerDataHandle> textData = stridedArrayView(data).slice(&ButtonData::text);
+        for(std::size_t i = 0; i != nodes.size(); ) {
+            if(!textViews[i]) {
+                ++i;
+                continue;
+            }
+
+            std::size_t end = i + 1;
+            while(end != nodes.size() && textViews[end])
+                ++end;
+            textLayer.setText(textData.slice(i, end), textViews.slice(i, end), properties.slice(i, end));
+            i = end;
+        }
+    }
+
+    for(std::size_t i = 0; i != nodes.size(); ++i)
+        alignIconText(textLayer, styles[i], data[i].icon, data[i].text);
+}
+
+void buttons(UserInterface& ui, const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<const Icon>& icons, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const ButtonStyle>& styles) {
+    buttons(ui, nodes, icons, texts, {}, styles);
+}
+
 }}
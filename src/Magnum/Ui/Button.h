@@ -27,7 +27,7 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Ui::Button, function @ref Magnum::Ui::button(), enum @ref Magnum::Ui::ButtonStyle
+ * @brief Class @ref Magnum::Ui::Button, function @ref Magnum::Ui::button(), @ref Magnum::Ui::buttons(), enum @ref Magnum::Ui::ButtonStyle
  * @m_since_latest
  */
 
@@ -254,6 +254,39 @@ MAGNUM_UI_EXPORT Anchor button(const Anchor& anchor, Icon icon, Containers::Stri
 /** @overload */
 MAGNUM_UI_EXPORT Anchor button(const Anchor& anchor, Icon icon, Containers::StringView text, ButtonStyle style = ButtonStyle::Default);
 
+/**
+@brief Create multiple stateless buttons at once
+@param ui               User interface to create the buttons in
+@param nodes            Nodes to create the buttons on
+@param icons            Button icons. Either empty, in which case the buttons
+    are created without icons, or with the same size as @p nodes.
+@param texts            Button texts. Either empty, in which case the buttons
+    are created without texts, or with the same size as @p nodes.
+@param textProperties   Text shaping and layouting properties. Either empty,
+    in which case default-constructed @ref TextProperties are used for all
+    texts, or with the same size as @p nodes.
+@param styles           Button styles. Expected to have the same size as
+    @p nodes.
+@m_since_latest
+
+Equivalent to calling @ref button(const Anchor&, Icon, Containers::StringView, const TextProperties&, ButtonStyle)
+for each item in @p nodes, but all texts are shaped in a single
+@ref TextLayer::setText(const Containers::StridedArrayView1D<const LayerDataHandle>&, const Containers::StringIterable&, const Containers::StridedArrayView1D<const TextProperties>&)
+call, which enlarges the glyph and text storage just once instead of growing
+it gradually with each button. Useful for example together with
+@ref AbstractUserInterface::createNodes() when populating large toolbars or
+grids.
+*/
+MAGNUM_UI_EXPORT void buttons(UserInterface& ui, const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<const Icon>& icons, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& textProperties, const Containers::StridedArrayView1D<const ButtonStyle>& styles);
+
+/**
+@overload
+@m_since_latest
+
+Uses default-constructed @ref TextProperties for all texts.
+*/
+MAGNUM_UI_EXPORT void buttons(UserInterface& ui, const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<const Icon>& icons, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const ButtonStyle>& styles);
+
 }}
 
 #endif
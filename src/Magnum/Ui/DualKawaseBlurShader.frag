@@ -0,0 +1,71 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#ifdef EXPLICIT_UNIFORM_LOCATION
+layout(location = 1)
+#endif
+uniform highp vec2 halfTexelSize;
+
+#ifdef EXPLICIT_BINDING
+layout(binding = 6)
+#endif
+uniform lowp sampler2D textureData;
+
+in mediump vec2 textureCoordinates;
+
+out lowp vec4 fragmentColor;
+
+void main() {
+    #ifdef DOWNSAMPLE
+    /* The center tap lands on a corner between four input texels, which get
+       averaged by the bilinear filtering, the four diagonal taps then land on
+       centers of the input texels around. The center is weighted four times
+       more, meaning a total weight of 8. */
+    fragmentColor.rgb = texture(textureData, textureCoordinates).rgb*4.0;
+    fragmentColor.rgb += texture(textureData, textureCoordinates - halfTexelSize).rgb;
+    fragmentColor.rgb += texture(textureData, textureCoordinates + halfTexelSize).rgb;
+    fragmentColor.rgb += texture(textureData, textureCoordinates + vec2(halfTexelSize.x, -halfTexelSize.y)).rgb;
+    fragmentColor.rgb += texture(textureData, textureCoordinates - vec2(halfTexelSize.x, -halfTexelSize.y)).rgb;
+    fragmentColor.rgb *= 1.0/8.0;
+    #elif defined(UPSAMPLE)
+    /* Four taps one input texel away along the axes, and four diagonal taps
+       half a texel away, weighted two times more, meaning a total weight of
+       12 */
+    fragmentColor.rgb = texture(textureData, textureCoordinates + vec2(-2.0*halfTexelSize.x, 0.0)).rgb;
+    fragmentColor.rgb += texture(textureData, textureCoordinates + vec2(2.0*halfTexelSize.x, 0.0)).rgb;
+    fragmentColor.rgb += texture(textureData, textureCoordinates + vec2(0.0, -2.0*halfTexelSize.y)).rgb;
+    fragmentColor.rgb += texture(textureData, textureCoordinates + vec2(0.0, 2.0*halfTexelSize.y)).rgb;
+    fragmentColor.rgb += texture(textureData, textureCoordinates - halfTexelSize).rgb*2.0;
+    fragmentColor.rgb += texture(textureData, textureCoordinates + halfTexelSize).rgb*2.0;
+    fragmentColor.rgb += texture(textureData, textureCoordinates + vec2(halfTexelSize.x, -halfTexelSize.y)).rgb*2.0;
+    fragmentColor.rgb += texture(textureData, textureCoordinates - vec2(halfTexelSize.x, -halfTexelSize.y)).rgb*2.0;
+    fragmentColor.rgb *= 1.0/12.0;
+    #else
+    #error expected either DOWNSAMPLE or UPSAMPLE to be defined
+    #endif
+
+    fragmentColor.a = 1.0;
+}
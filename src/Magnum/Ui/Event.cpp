@@ -28,6 +28,7 @@
 
 #include <Corrade/Containers/EnumSet.hpp>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/Debug.h>
 
@@ -130,6 +131,18 @@ Containers::Optional<Pointer> PointerMoveEvent::pointer() const {
     return _pointer == Pointer{} ? Containers::NullOpt : Containers::optional(_pointer);
 }
 
+Nanoseconds PointerMoveEvent::coalescedTime(const std::size_t id) const {
+    CORRADE_ASSERT(id < _coalesced.size(),
+        "Ui::PointerMoveEvent::coalescedTime(): index" << id << "out of range for" << _coalesced.size() << "coalesced events", {});
+    return _coalesced[id].first();
+}
+
+Vector2 PointerMoveEvent::coalescedPosition(const std::size_t id) const {
+    CORRADE_ASSERT(id < _coalesced.size(),
+        "Ui::PointerMoveEvent::coalescedPosition(): index" << id << "out of range for" << _coalesced.size() << "coalesced events", {});
+    return _position + _coalesced[id].second();
+}
+
 Debug& operator<<(Debug& debug, const Key value) {
     debug << "Ui::Key" << Debug::nospace;
 
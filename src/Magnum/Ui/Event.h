@@ -31,6 +31,7 @@
  * @m_since_latest
  */
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/StringView.h>
 #include <Magnum/Math/Time.h>
 #include <Magnum/Math/Vector2.h>
@@ -520,6 +521,42 @@ class MAGNUM_UI_EXPORT PointerMoveEvent {
          */
         Vector2 relativePosition() const { return _relativePosition; }
 
+        /**
+         * @brief Count of coalesced move events
+         * @m_since_latest
+         *
+         * If @ref AbstractUserInterface::setPointerMoveEventCoalescing() is
+         * enabled, multiple consecutive move events of the same pointer get
+         * merged into a single event that's delivered on the next
+         * @ref AbstractUserInterface::flushPointerMoveEvent(). In that case
+         * @ref time() and @ref position() correspond to the latest sample,
+         * @ref relativePosition() spans the whole coalesced motion and this
+         * function returns the count of earlier samples that were merged into
+         * it, accessible via @ref coalescedTime() and @ref coalescedPosition()
+         * in the order they happened. Returns @cpp 0 @ce if the event isn't
+         * coalesced.
+         */
+        std::size_t coalescedCount() const { return _coalesced.size(); }
+
+        /**
+         * @brief Time of a coalesced move event
+         * @m_since_latest
+         *
+         * The @p id is expected to be less than @ref coalescedCount().
+         * @see @ref time()
+         */
+        Nanoseconds coalescedTime(std::size_t id) const;
+
+        /**
+         * @brief Position of a coalesced move event
+         * @m_since_latest
+         *
+         * Relative to top left corner of the node the event is called on,
+         * same as @ref position(). The @p id is expected to be less than
+         * @ref coalescedCount().
+         */
+        Vector2 coalescedPosition(std::size_t id) const;
+
         /**
          * @brief Size of the node the event is called on
          *
@@ -636,6 +673,10 @@ class MAGNUM_UI_EXPORT PointerMoveEvent {
         PointerEventSource _source;
         Pointer _pointer; /* NullOpt encoded as Pointer{} to avoid an include */
         Pointers _pointers;
+        /* Times and positions of earlier coalesced events, positions
+           relative to the final event position. Owned by the
+           AbstractUserInterface. */
+        Containers::ArrayView<const Containers::Pair<Nanoseconds, Vector2>> _coalesced;
         bool _primary;
         bool _fallthrough = false;
         bool _nodePressed = false;
@@ -30,6 +30,8 @@
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Platform/Gesture.h>
 
 #include "Magnum/Ui/Handle.h"
@@ -62,32 +64,71 @@ namespace Implementation {
 
 namespace {
 
+/* The slot signature is fully determined by eventType, sharedSlot and
+   position, so the slot is called directly through the FunctionData call
+   pointer without any extra trampoline */
 struct Data {
+    /* Empty if sharedSlot is not ~UnsignedInt{} */
     Containers::FunctionData slot;
+    /* Index into State::sharedSlots for connections created with the
+       multi-node on*() overloads, ~UnsignedInt{} otherwise */
+    UnsignedInt sharedSlot;
     Implementation::EventType eventType;
+    /* Whether the slot takes a node-relative position as the first argument.
+       Always false for Pinch, which has just one variant. */
+    bool position;
     bool hasScopedConnection;
-    /* 6+ bytes free */
-    /** @todo ideally this would be inlined directly inside FunctionData.call,
-        somehow -- e.g. an extra template argument to Function that decouples
-        the actual wrapped signature from the call signature */
-    void(*call)();
+    /* 1+ bytes free */
 };
 
+struct SharedSlot {
+    Containers::Function<void(NodeHandle)> slot;
+    /* Count of connections referencing this slot. If 0, the slot is empty
+       and can be reused. */
+    UnsignedInt usedCount;
+};
+
+bool isPinch(const Implementation::EventType eventType) {
+    return eventType == Implementation::EventType::Pinch;
+}
+
+bool isDrag(const Implementation::EventType eventType) {
+    return eventType == Implementation::EventType::Drag ||
+           eventType == Implementation::EventType::DragOrScroll;
+}
+
+/* Picks a single data matching `predicate` out of all data attached to a node
+   that's meant to handle a gesture on behalf of all of them. If the already
+   tracked one is among them, it's used to not lose the state, otherwise it's
+   the first one. Returns ~UnsignedInt{} if there's no such data. */
+UnsignedInt pickData(const Containers::ArrayView<const Data> data, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, bool(*const predicate)(Implementation::EventType), const UnsignedInt trackedDataId) {
+    UnsignedInt picked = ~UnsignedInt{};
+    for(const UnsignedInt dataId: dataIds) {
+        if(!predicate(data[dataId].eventType))
+            continue;
+        if(dataId == trackedDataId)
+            return dataId;
+        if(picked == ~UnsignedInt{})
+            picked = dataId;
+    }
+    return picked;
+}
+
 }
 
 struct EventLayer::State {
     Containers::Array<Data> data;
+    Containers::Array<SharedSlot> sharedSlots;
 
     Platform::TwoFingerGesture twoFingerGesture;
-    /** @todo remember the node instead of data, once the event handling is
-        reworked to be called for all data attached to given node at once, to
-        allow multiple onPinch() associated with the same node */
+    /* With events coming for all data attached to a node at once, it's just
+       one onPinch() data in the batch that feeds the gesture, the others get
+       just the slot called */
     UnsignedInt twoFingerGestureData = ~UnsignedInt{};
 
     Float dragThresholdSquared = 16.0f*16.0f;
-    /** @todo remember the node instead of data, once the event handling is
-        reworked to be called for all data attached to given node at once, to
-        allow multiple fallthrough onDrag() associated with the same node */
+    /* Similarly, it's just one fallthrough onDrag() data in the batch that
+       remembers the press, the others get called once it's accepted */
     UnsignedInt dragFallthroughData = ~UnsignedInt{};
     /* If dragFallthroughData is not ~UnsignedInt{}, this contains position of
        the last press for a drag on a fallthrough node. Once the (squared)
@@ -156,7 +197,7 @@ EventLayer& EventLayer::operator=(EventLayer&& other) noexcept {
 }
 
 LayerFeatures EventLayer::doFeatures() const {
-    return LayerFeature::Event;
+    return LayerFeature::EventBatch;
 }
 
 UnsignedInt EventLayer::usedScopedConnectionCount() const {
@@ -168,6 +209,10 @@ UnsignedInt EventLayer::usedAllocatedConnectionCount() const {
     for(const Data& data: _state->data)
         if(data.slot.isAllocated())
             ++count;
+    /* Slots shared by multiple connections are counted just once */
+    for(const SharedSlot& sharedSlot: _state->sharedSlots)
+        if(sharedSlot.usedCount && sharedSlot.slot.isAllocated())
+            ++count;
 
     return count;
 }
@@ -190,13 +235,12 @@ EventLayer& EventLayer::setScrollStepDistance(const Vector2& distance) {
     return *this;
 }
 
-DataHandle EventLayer::create(const NodeHandle node, const Implementation::EventType eventType, Containers::FunctionData&& slot, void(*call)()) {
+DataHandle EventLayer::create(const NodeHandle node, const Implementation::EventType eventType, Containers::FunctionData&& slot, const bool position) {
     CORRADE_ASSERT(slot,
         /* saying create() would be confusing, and passing onPress(),
            onPressScoped() etc as a string just for the assert from all
            variants seems excessive */
         "Ui::EventLayer: slot is null", {});
-
     State& state = static_cast<State&>(*_state);
     const DataHandle handle = AbstractLayer::create(node);
     const UnsignedInt id = dataHandleId(handle);
@@ -207,292 +251,196 @@ DataHandle EventLayer::create(const NodeHandle node, const Implementation::Event
         arrayResize(state.data, id + 1);
 
     Data& data = state.data[id];
-    data.eventType = eventType;
     data.slot = Utility::move(slot);
+    data.sharedSlot = ~UnsignedInt{};
+    data.eventType = eventType;
+    data.position = position;
     data.hasScopedConnection = false;
-    data.call = call;
     return handle;
 }
 
+void EventLayer::createShared(const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Implementation::EventType eventType, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    CORRADE_ASSERT(slot,
+        "Ui::EventLayer: slot is null", );
+    CORRADE_ASSERT(handles.size() == nodes.size(),
+        "Ui::EventLayer: expected" << nodes.size() << "handles but got" << handles.size(), );
+    State& state = static_cast<State&>(*_state);
+
+    /* Don't store the slot at all if there's nothing to connect it to */
+    if(nodes.isEmpty())
+        return;
+
+    /* Reuse a shared slot that's no longer used by any connection, if there's
+       any, otherwise add a new one */
+    UnsignedInt sharedSlot = state.sharedSlots.size();
+    for(std::size_t i = 0; i != state.sharedSlots.size(); ++i) {
+        if(!state.sharedSlots[i].usedCount) {
+            sharedSlot = i;
+            break;
+        }
+    }
+    if(sharedSlot == state.sharedSlots.size())
+        arrayAppend(state.sharedSlots, InPlaceInit);
+    state.sharedSlots[sharedSlot].slot = Utility::move(slot);
+    state.sharedSlots[sharedSlot].usedCount = nodes.size();
+
+    /* Reserve the data array upfront so it's reallocated at most once.
+       Freed IDs may get reused, so this is an upper bound. */
+    arrayReserve(state.data, state.data.size() + nodes.size());
+
+    for(std::size_t i = 0; i != nodes.size(); ++i) {
+        const DataHandle handle = AbstractLayer::create(nodes[i]);
+        const UnsignedInt id = dataHandleId(handle);
+        if(id >= state.data.size())
+            arrayResize(state.data, id + 1);
+
+        Data& data = state.data[id];
+        data.slot = {};
+        data.sharedSlot = sharedSlot;
+        data.eventType = eventType;
+        data.position = false;
+        data.hasScopedConnection = false;
+        handles[i] = handle;
+    }
+}
+
+void EventLayer::callSlot(const UnsignedInt dataId, const Vector2& position) {
+    State& state = *_state;
+    Data& data = state.data[dataId];
+    if(data.sharedSlot != ~UnsignedInt{})
+        state.sharedSlots[data.sharedSlot].slot(nodes()[dataId]);
+    else if(data.position)
+        static_cast<Containers::Function<void(const Vector2&)>&>(data.slot)(position);
+    else
+        static_cast<Containers::Function<void()>&>(data.slot)();
+}
+
+void EventLayer::callSlot(const UnsignedInt dataId, const Vector2& position, const Vector2& second) {
+    Data& data = _state->data[dataId];
+    if(data.position)
+        static_cast<Containers::Function<void(const Vector2&, const Vector2&)>&>(data.slot)(position, second);
+    else
+        static_cast<Containers::Function<void(const Vector2&)>&>(data.slot)(second);
+}
+
 DataHandle EventLayer::onPress(const NodeHandle node, Containers::Function<void()>&& slot) {
-    return create(node, Implementation::EventType::Press, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            /* The + is to decay the lambda to a function pointer so we can
-               cast it. MSVC 2015 says "error C2593: 'operator +' is ambiguous"
-               so there it's an explicit cast to the function pointer type (and
-               the parentheses are for both to have only one ifdef). */
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent&) {
-            static_cast<Containers::Function<void()>&>(slot)();
-        })));
+    return create(node, Implementation::EventType::Press, Utility::move(slot), false);
 }
 
 DataHandle EventLayer::onPress(const NodeHandle node, Containers::Function<void(const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::Press, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent& event) {
-            static_cast<Containers::Function<void(const Vector2&)>&>(slot)(event.position());
-        })));
+    return create(node, Implementation::EventType::Press, Utility::move(slot), true);
+}
+
+void EventLayer::onPress(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    createShared(nodes, Implementation::EventType::Press, Utility::move(slot), handles);
 }
 
 DataHandle EventLayer::onRelease(const NodeHandle node, Containers::Function<void()>&& slot) {
-    return create(node, Implementation::EventType::Release, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent&) {
-            static_cast<Containers::Function<void()>&>(slot)();
-        })));
+    return create(node, Implementation::EventType::Release, Utility::move(slot), false);
 }
 
 DataHandle EventLayer::onRelease(const NodeHandle node, Containers::Function<void(const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::Release, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent& event) {
-            static_cast<Containers::Function<void(const Vector2&)>&>(slot)(event.position());
-        })));
+    return create(node, Implementation::EventType::Release, Utility::move(slot), true);
+}
+
+void EventLayer::onRelease(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    createShared(nodes, Implementation::EventType::Release, Utility::move(slot), handles);
 }
 
 DataHandle EventLayer::onTapOrClick(const NodeHandle node, Containers::Function<void()>&& slot) {
-    return create(node, Implementation::EventType::TapOrClick, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent&) {
-            static_cast<Containers::Function<void()>&>(slot)();
-        })));
+    return create(node, Implementation::EventType::TapOrClick, Utility::move(slot), false);
 }
 
 DataHandle EventLayer::onTapOrClick(const NodeHandle node, Containers::Function<void(const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::TapOrClick, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent& event) {
-            static_cast<Containers::Function<void(const Vector2&)>&>(slot)(event.position());
-        })));
+    return create(node, Implementation::EventType::TapOrClick, Utility::move(slot), true);
+}
+
+void EventLayer::onTapOrClick(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    createShared(nodes, Implementation::EventType::TapOrClick, Utility::move(slot), handles);
 }
 
 DataHandle EventLayer::onMiddleClick(const NodeHandle node, Containers::Function<void()>&& slot) {
-    return create(node, Implementation::EventType::MiddleClick, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent&) {
-            static_cast<Containers::Function<void()>&>(slot)();
-        })));
+    return create(node, Implementation::EventType::MiddleClick, Utility::move(slot), false);
 }
 
 DataHandle EventLayer::onMiddleClick(const NodeHandle node, Containers::Function<void(const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::MiddleClick, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent& event) {
-            static_cast<Containers::Function<void(const Vector2&)>&>(slot)(event.position());
-        })));
+    return create(node, Implementation::EventType::MiddleClick, Utility::move(slot), true);
+}
+
+void EventLayer::onMiddleClick(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    createShared(nodes, Implementation::EventType::MiddleClick, Utility::move(slot), handles);
 }
 
 DataHandle EventLayer::onRightClick(const NodeHandle node, Containers::Function<void()>&& slot) {
-    return create(node, Implementation::EventType::RightClick, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent&) {
-            static_cast<Containers::Function<void()>&>(slot)();
-        })));
+    return create(node, Implementation::EventType::RightClick, Utility::move(slot), false);
 }
 
 DataHandle EventLayer::onRightClick(const NodeHandle node, Containers::Function<void(const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::RightClick, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerEvent& event) {
-            static_cast<Containers::Function<void(const Vector2&)>&>(slot)(event.position());
-        })));
+    return create(node, Implementation::EventType::RightClick, Utility::move(slot), true);
+}
+
+void EventLayer::onRightClick(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    createShared(nodes, Implementation::EventType::RightClick, Utility::move(slot), handles);
 }
 
 DataHandle EventLayer::onDrag(const NodeHandle node, Containers::Function<void(const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::Drag, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&, const Vector2&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerMoveEvent&, const Vector2& relativePosition) {
-            /* The relative position is supplied custom in case of drag event
-               fallthrough so it cannot be event.relativePosition() */
-            static_cast<Containers::Function<void(const Vector2&)>&>(slot)(relativePosition);
-        })));
+    return create(node, Implementation::EventType::Drag, Utility::move(slot), false);
 }
 
 DataHandle EventLayer::onDrag(const NodeHandle node, Containers::Function<void(const Vector2&, const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::Drag, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&, const Vector2&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerMoveEvent& event, const Vector2& relativePosition) {
-            /* The relative position is supplied custom in case of drag event
-               fallthrough so it cannot be event.relativePosition() */
-            static_cast<Containers::Function<void(const Vector2&, const Vector2&)>&>(slot)(event.position(), relativePosition);
-        })));
+    return create(node, Implementation::EventType::Drag, Utility::move(slot), true);
 }
 
 DataHandle EventLayer::onScroll(const NodeHandle node, Containers::Function<void(const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::Scroll, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const ScrollEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const ScrollEvent& event) {
-            static_cast<Containers::Function<void(const Vector2&)>&>(slot)(event.offset());
-        })));
+    return create(node, Implementation::EventType::Scroll, Utility::move(slot), false);
 }
 
 DataHandle EventLayer::onScroll(const NodeHandle node, Containers::Function<void(const Vector2&, const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::Scroll, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const ScrollEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const ScrollEvent& event) {
-            static_cast<Containers::Function<void(const Vector2&, const Vector2&)>&>(slot)(event.position(), event.offset());
-        })));
+    return create(node, Implementation::EventType::Scroll, Utility::move(slot), true);
 }
 
 DataHandle EventLayer::onDragOrScroll(const NodeHandle node, Containers::Function<void(const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::DragOrScroll, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const Vector2&, const Vector2&)>
-            #endif
-        ([](Containers::FunctionData& slot, const Vector2&, const Vector2& offset) {
-            static_cast<Containers::Function<void(const Vector2&)>&>(slot)(offset);
-        })));
+    return create(node, Implementation::EventType::DragOrScroll, Utility::move(slot), false);
 }
 
 DataHandle EventLayer::onDragOrScroll(const NodeHandle node, Containers::Function<void(const Vector2&, const Vector2&)>&& slot) {
-    return create(node, Implementation::EventType::DragOrScroll, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const Vector2&, const Vector2&)>
-            #endif
-        ([](Containers::FunctionData& slot, const Vector2& position, const Vector2& offset) {
-            static_cast<Containers::Function<void(const Vector2&, const Vector2&)>&>(slot)(position, offset);
-        })));
+    return create(node, Implementation::EventType::DragOrScroll, Utility::move(slot), true);
 }
 
 DataHandle EventLayer::onPinch(const NodeHandle node, Containers::Function<void(const Vector2&, const Vector2&, const Complex&, Float)>&& slot) {
-    return create(node, Implementation::EventType::Pinch, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const Platform::TwoFingerGesture&)>
-            #endif
-        ([](Containers::FunctionData& slot, const Platform::TwoFingerGesture& gesture) {
-            static_cast<Containers::Function<void(const Vector2&, const Vector2&, const Complex&, Float)>&>(slot)(gesture.position(), gesture.relativeTranslation(), gesture.relativeRotation(), gesture.relativeScaling());
-        })));
+    return create(node, Implementation::EventType::Pinch, Utility::move(slot), false);
 }
 
 DataHandle EventLayer::onEnter(const NodeHandle node, Containers::Function<void()>&& slot) {
-    return create(node, Implementation::EventType::Enter, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerMoveEvent&) {
-            static_cast<Containers::Function<void()>&>(slot)();
-        })));
+    return create(node, Implementation::EventType::Enter, Utility::move(slot), false);
+}
+
+void EventLayer::onEnter(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    createShared(nodes, Implementation::EventType::Enter, Utility::move(slot), handles);
 }
 
 DataHandle EventLayer::onLeave(const NodeHandle node, Containers::Function<void()>&& slot) {
-    return create(node, Implementation::EventType::Leave, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const PointerMoveEvent&) {
-            static_cast<Containers::Function<void()>&>(slot)();
-        })));
+    return create(node, Implementation::EventType::Leave, Utility::move(slot), false);
+}
+
+void EventLayer::onLeave(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    createShared(nodes, Implementation::EventType::Leave, Utility::move(slot), handles);
 }
 
 DataHandle EventLayer::onFocus(const NodeHandle node, Containers::Function<void()>&& slot) {
-    return create(node, Implementation::EventType::Focus, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const FocusEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const FocusEvent&) {
-            static_cast<Containers::Function<void()>&>(slot)();
-        })));
+    return create(node, Implementation::EventType::Focus, Utility::move(slot), false);
+}
+
+void EventLayer::onFocus(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    createShared(nodes, Implementation::EventType::Focus, Utility::move(slot), handles);
 }
 
 DataHandle EventLayer::onBlur(const NodeHandle node, Containers::Function<void()>&& slot) {
-    return create(node, Implementation::EventType::Blur, Utility::move(slot),
-        reinterpret_cast<void(*)()>(
-            #ifndef CORRADE_MSVC2015_COMPATIBILITY
-            +
-            #else
-            static_cast<void(*)(Containers::FunctionData&, const FocusEvent&)>
-            #endif
-        ([](Containers::FunctionData& slot, const FocusEvent&) {
-            static_cast<Containers::Function<void()>&>(slot)();
-        })));
+    return create(node, Implementation::EventType::Blur, Utility::move(slot), false);
+}
+
+void EventLayer::onBlur(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    createShared(nodes, Implementation::EventType::Blur, Utility::move(slot), handles);
 }
 
 void EventLayer::remove(DataHandle handle) {
@@ -510,8 +458,16 @@ void EventLayer::removeInternal(const UnsignedInt id) {
     Data& data = state.data[id];
 
     /* Set the slot to an empty instance to call any captured state
-       destructors */
-    data.slot = {};
+       destructors. If the slot is shared, do so only once it's not used by
+       any other connection. */
+    if(data.sharedSlot != ~UnsignedInt{}) {
+        SharedSlot& sharedSlot = state.sharedSlots[data.sharedSlot];
+        CORRADE_INTERNAL_ASSERT(sharedSlot.usedCount);
+        if(!--sharedSlot.usedCount)
+            sharedSlot.slot = {};
+        /* Not strictly needed but makes it easier to detect bugs */
+        data.sharedSlot = ~UnsignedInt{};
+    } else data.slot = {};
 
     /* If the connection was scoped, decrement the counter. No need to reset
        the hasScopedConnection bit, as the data won't be touched again until
@@ -526,11 +482,22 @@ void EventLayer::removeInternal(const UnsignedInt id) {
     }
 }
 
-void EventLayer::doClean(const Containers::BitArrayView dataIdsToRemove) {
-    /** @todo some way to iterate bits */
-    for(std::size_t i = 0; i != dataIdsToRemove.size(); ++i)
-        if(dataIdsToRemove[i])
-            removeInternal(i);
+void EventLayer::doCleanSparse(Containers::BitArrayView, const Containers::ArrayView<const UnsignedInt> dataIds) {
+    for(const UnsignedInt i: dataIds)
+        removeInternal(i);
+}
+
+void EventLayer::doTrim(const std::size_t capacity) {
+    State& state = *_state;
+    /* The data past capacity are all removed, thus with no slots that would
+       need to be destructed in a particular way */
+    if(state.data.size() > capacity)
+        arrayResize(state.data, capacity);
+    arrayShrink(state.data);
+}
+
+void EventLayer::doReserve(const std::size_t capacity) {
+    arrayReserve(_state->data, capacity);
 }
 
 void EventLayer::doPointerPressEvent(const UnsignedInt dataId, PointerEvent& event) {
@@ -577,12 +544,9 @@ void EventLayer::doPointerPressEvent(const UnsignedInt dataId, PointerEvent& eve
            gesture. Do that only for a touch input tho, I feel it should still
            be possible to do a pinch gesture while clicking around with a mouse
            or a pen. */
-        /** @todo this will be broken if there's more than one onPinch()
-            attached to the same node -- needs the events to be fired for all
-            data attached to given node, not for individual data (and
-            remembering the node doesn't work because then it'd record the
-            press / move multiple times instead of just once, being broken even
-            more) */
+        /* If there's more than one onPinch() attached to the same node,
+           doPointerPressEvents() etc. call this only for one of them, so the
+           press / move isn't recorded multiple times */
         if(dataId != state.twoFingerGestureData && event.source() == PointerEventSource::Touch) {
             state.twoFingerGestureData = dataId;
             state.twoFingerGesture = Platform::TwoFingerGesture{};
@@ -604,7 +568,7 @@ void EventLayer::doPointerPressEvent(const UnsignedInt dataId, PointerEvent& eve
     if(data.eventType == Implementation::EventType::Press &&
         event.pointer() & (Pointer::MouseLeft|Pointer::Finger|Pointer::Pen))
     {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>(data.call)(data.slot, event);
+        callSlot(dataId, event.position());
         event.setAccepted();
         return;
     }
@@ -625,6 +589,33 @@ void EventLayer::doPointerPressEvent(const UnsignedInt dataId, PointerEvent& eve
         event.setAccepted();
 }
 
+void EventLayer::doPointerPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) {
+    State& state = *_state;
+
+    /* Feed the gesture recognition only with one onPinch() attached to the
+       node, otherwise the press would be recorded multiple times. Similarly,
+       remember the press only for one fallthrough onDrag(),
+       doPointerMoveEvents() then calls the others as well. */
+    const UnsignedInt pinchDataId = pickData(state.data, dataIds, isPinch, state.twoFingerGestureData);
+    const UnsignedInt dragFallthroughDataId = event.isFallthrough() ?
+        pickData(state.data, dataIds, isDrag, state.dragFallthroughData) : ~UnsignedInt{};
+
+    bool acceptedByAnyData = false;
+    for(const UnsignedInt dataId: dataIds) {
+        const Implementation::EventType eventType = state.data[dataId].eventType;
+        if((isPinch(eventType) && dataId != pinchDataId) ||
+           (isDrag(eventType) && event.isFallthrough() && dataId != dragFallthroughDataId))
+            continue;
+
+        event.setAccepted(false);
+        doPointerPressEvent(dataId, event);
+        if(event.isAccepted())
+            acceptedByAnyData = true;
+    }
+
+    event.setAccepted(acceptedByAnyData);
+}
+
 void EventLayer::doPointerReleaseEvent(const UnsignedInt dataId, PointerEvent& event) {
     State& state = *_state;
     Data& data = state.data[dataId];
@@ -654,7 +645,7 @@ void EventLayer::doPointerReleaseEvent(const UnsignedInt dataId, PointerEvent& e
     if(data.eventType == Implementation::EventType::Release &&
         event.pointer() & (Pointer::MouseLeft|Pointer::Finger|Pointer::Pen))
     {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>(data.call)(data.slot, event);
+        callSlot(dataId, event.position());
         event.setAccepted();
         return;
     }
@@ -673,12 +664,33 @@ void EventLayer::doPointerReleaseEvent(const UnsignedInt dataId, PointerEvent& e
          (data.eventType == Implementation::EventType::RightClick &&
             event.pointer() == Pointer::MouseRight))
     ) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>(data.call)(data.slot, event);
+        callSlot(dataId, event.position());
         event.setAccepted();
         return;
     }
 }
 
+void EventLayer::doPointerReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) {
+    State& state = *_state;
+
+    /* Same as in doPointerPressEvents(), feed the gesture recognition only
+       with one onPinch() attached to the node */
+    const UnsignedInt pinchDataId = pickData(state.data, dataIds, isPinch, state.twoFingerGestureData);
+
+    bool acceptedByAnyData = false;
+    for(const UnsignedInt dataId: dataIds) {
+        if(isPinch(state.data[dataId].eventType) && dataId != pinchDataId)
+            continue;
+
+        event.setAccepted(false);
+        doPointerReleaseEvent(dataId, event);
+        if(event.isAccepted())
+            acceptedByAnyData = true;
+    }
+
+    event.setAccepted(acceptedByAnyData);
+}
+
 void EventLayer::doPointerMoveEvent(const UnsignedInt dataId, PointerMoveEvent& event) {
     State& state = *_state;
     Data& data = state.data[dataId];
@@ -700,11 +712,9 @@ void EventLayer::doPointerMoveEvent(const UnsignedInt dataId, PointerMoveEvent&
            yet, bail -- maybe next time it will be. */
         if(state.dragFallthroughData == dataId) {
             if((state.dragFallthroughPosition - event.position()).dot() >= state.dragThresholdSquared) {
-                if(data.eventType == Implementation::EventType::Drag)
-                    reinterpret_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&, const Vector2&)>(data.call)(data.slot, event, event.position() - state.dragFallthroughPosition);
-                else if(data.eventType == Implementation::EventType::DragOrScroll)
-                    reinterpret_cast<void(*)(Containers::FunctionData&, const Vector2&, const Vector2&)>(data.call)(data.slot, event.position(), event.position() - state.dragFallthroughPosition);
-                else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+                /* The relative position is supplied custom here so it cannot
+                   be event.relativePosition() */
+                callSlot(dataId, event.position(), event.position() - state.dragFallthroughPosition);
                 event.setAccepted();
             } else return;
         }
@@ -741,7 +751,7 @@ void EventLayer::doPointerMoveEvent(const UnsignedInt dataId, PointerMoveEvent&
             event.setAccepted();
 
             if(state.twoFingerGesture)
-                reinterpret_cast<void(*)(Containers::FunctionData&, const Platform::TwoFingerGesture&)>(data.call)(data.slot, state.twoFingerGesture);
+                static_cast<Containers::Function<void(const Vector2&, const Vector2&, const Complex&, Float)>&>(data.slot)(state.twoFingerGesture.position(), state.twoFingerGesture.relativeTranslation(), state.twoFingerGesture.relativeRotation(), state.twoFingerGesture.relativeScaling());
         }
 
         return;
@@ -760,11 +770,7 @@ void EventLayer::doPointerMoveEvent(const UnsignedInt dataId, PointerMoveEvent&
        (event.pointers() & (Pointer::MouseLeft|Pointer::Finger|Pointer::Pen)) &&
        event.isCaptured() && !state.twoFingerGesture)
     {
-        if(data.eventType == Implementation::EventType::Drag)
-            reinterpret_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&, const Vector2&)>(data.call)(data.slot, event, event.relativePosition());
-        else if(data.eventType == Implementation::EventType::DragOrScroll)
-            reinterpret_cast<void(*)(Containers::FunctionData&, const Vector2&, const Vector2&)>(data.call)(data.slot, event.position(), event.relativePosition());
-        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        callSlot(dataId, event.position(), event.relativePosition());
         event.setAccepted();
     }
 
@@ -775,6 +781,67 @@ void EventLayer::doPointerMoveEvent(const UnsignedInt dataId, PointerMoveEvent&
         event.setAccepted();
 }
 
+void EventLayer::doPointerMoveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) {
+    State& state = *_state;
+
+    bool acceptedByAnyData = false;
+
+    /* Feed the gesture recognition only with one onPinch() attached to the
+       node. If it accepted the event and the gesture is recognized, the
+       remaining onPinch() slots get called below with the same gesture
+       properties. */
+    const UnsignedInt pinchDataId = pickData(state.data, dataIds, isPinch, state.twoFingerGestureData);
+    bool pinchAccepted = false;
+    if(pinchDataId != ~UnsignedInt{}) {
+        event.setAccepted(false);
+        doPointerMoveEvent(pinchDataId, event);
+        if(event.isAccepted())
+            acceptedByAnyData = pinchAccepted = true;
+    }
+
+    /* Only one fallthrough onDrag() attached to the node remembered the press
+       in doPointerPressEvents(), so it's the one deciding whether the drag
+       threshold was reached. If it was, the remaining onDrag() slots get
+       called below with the same relative position, otherwise they're
+       skipped as they'd wrongly reset the remembered state. The press
+       position gets reset by doPointerMoveEvent(), so save it first. */
+    const UnsignedInt dragFallthroughDataId = event.isFallthrough() ?
+        pickData(state.data, dataIds, isDrag, state.dragFallthroughData) : ~UnsignedInt{};
+    const Vector2 dragFallthroughPosition = state.dragFallthroughPosition;
+    bool dragFallthroughAccepted = false;
+    if(dragFallthroughDataId != ~UnsignedInt{}) {
+        event.setAccepted(false);
+        doPointerMoveEvent(dragFallthroughDataId, event);
+        if(event.isAccepted())
+            acceptedByAnyData = dragFallthroughAccepted = true;
+    }
+
+    for(const UnsignedInt dataId: dataIds) {
+        if(dataId == pinchDataId || dataId == dragFallthroughDataId)
+            continue;
+
+        Data& data = state.data[dataId];
+        if(isPinch(data.eventType)) {
+            if(pinchAccepted && state.twoFingerGesture)
+                static_cast<Containers::Function<void(const Vector2&, const Vector2&, const Complex&, Float)>&>(data.slot)(state.twoFingerGesture.position(), state.twoFingerGesture.relativeTranslation(), state.twoFingerGesture.relativeRotation(), state.twoFingerGesture.relativeScaling());
+            continue;
+        }
+
+        if(isDrag(data.eventType) && event.isFallthrough()) {
+            if(dragFallthroughAccepted)
+                callSlot(dataId, event.position(), event.position() - dragFallthroughPosition);
+            continue;
+        }
+
+        event.setAccepted(false);
+        doPointerMoveEvent(dataId, event);
+        if(event.isAccepted())
+            acceptedByAnyData = true;
+    }
+
+    event.setAccepted(acceptedByAnyData);
+}
+
 void EventLayer::doPointerEnterEvent(const UnsignedInt dataId, PointerMoveEvent& event) {
     /* event is guaranteed to be primary by AbstractLayer */
 
@@ -784,7 +851,7 @@ void EventLayer::doPointerEnterEvent(const UnsignedInt dataId, PointerMoveEvent&
 
     Data& data = _state->data[dataId];
     if(data.eventType == Implementation::EventType::Enter) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&)>(data.call)(data.slot, event);
+        callSlot(dataId, event.position());
         /* Accept status is ignored on enter/leave events, no need to call
            setAccepted() */
     }
@@ -799,7 +866,7 @@ void EventLayer::doPointerLeaveEvent(const UnsignedInt dataId, PointerMoveEvent&
 
     Data& data = _state->data[dataId];
     if(data.eventType == Implementation::EventType::Leave) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&)>(data.call)(data.slot, event);
+        callSlot(dataId, event.position());
         /* Accept status is ignored on enter/leave events, no need to call
            setAccepted() */
     }
@@ -822,10 +889,10 @@ void EventLayer::doScrollEvent(const UnsignedInt dataId, ScrollEvent& event) {
     Data& data = state.data[dataId];
 
     if(data.eventType == Implementation::EventType::Scroll) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const ScrollEvent&)>(data.call)(data.slot, event);
+        callSlot(dataId, event.position(), event.offset());
         event.setAccepted();
     } else if(data.eventType == Implementation::EventType::DragOrScroll) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const Vector2&, const Vector2&)>(data.call)(data.slot, event.position(), event.offset()*state.scrollStepDistance);
+        callSlot(dataId, event.position(), event.offset()*state.scrollStepDistance);
         event.setAccepted();
     }
 }
@@ -833,7 +900,7 @@ void EventLayer::doScrollEvent(const UnsignedInt dataId, ScrollEvent& event) {
 void EventLayer::doFocusEvent(const UnsignedInt dataId, FocusEvent& event) {
     Data& data = _state->data[dataId];
     if(data.eventType == Implementation::EventType::Focus) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const FocusEvent&)>(data.call)(data.slot, event);
+        callSlot(dataId, {});
         event.setAccepted();
     }
 }
@@ -841,7 +908,7 @@ void EventLayer::doFocusEvent(const UnsignedInt dataId, FocusEvent& event) {
 void EventLayer::doBlurEvent(const UnsignedInt dataId, FocusEvent& event) {
     Data& data = _state->data[dataId];
     if(data.eventType == Implementation::EventType::Blur) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const FocusEvent&)>(data.call)(data.slot, event);
+        callSlot(dataId, {});
         /* Accept status is ignored on blur events, no need to call
            setAccepted() */
     }
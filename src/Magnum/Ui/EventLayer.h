@@ -162,6 +162,30 @@ instead of a lambda:
 
 @snippet Ui.cpp EventLayer-create-scoped
 
+@subsection Ui-EventLayer-create-batch Connecting many nodes at once
+
+When the same action is performed for a large amount of nodes, such as items in
+a long list, creating a separate function for each of them may have a
+significant memory overhead, especially if the function captures state that
+doesn't fit into the inline storage of @relativeref{Corrade,Containers::Function}.
+The @ref onPress(), @ref onRelease(), @ref onTapOrClick(),
+@ref onMiddleClick(), @ref onRightClick(), @ref onEnter(), @ref onLeave(),
+@ref onFocus() and @ref onBlur() APIs thus have overloads taking a list of
+nodes and a single function that's shared by all created connections,
+receiving the node the event happened on. The created handles are written into
+the passed view:
+
+@code{.cpp}
+Containers::Array<Ui::NodeHandle> items = …;
+Containers::Array<Ui::DataHandle> handles{NoInit, items.size()};
+eventLayer.onTapOrClick(items, [](Ui::NodeHandle item) {
+    …
+}, handles);
+@endcode
+
+The shared function is destroyed once all connections using it are removed.
+There are no scoped variants of these overloads.
+
 @section Ui-EventLayer-tap-click-press-release Tap or click, press & release
 
 A function passed to @ref onTapOrClick() gets called when a
@@ -355,8 +379,10 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
          *
          * Always at most @ref usedCount(). Counts all connections that capture
          * non-trivially-destructible state or state that's too large to be
-         * stored in-place. The operation is done with a @f$ \mathcal{O}(n) @f$
-         * complexity where @f$ n @f$ is @ref capacity().
+         * stored in-place. A function shared by connections created with the
+         * multi-node @ref onTapOrClick() etc. overloads is counted just once.
+         * The operation is done with a @f$ \mathcal{O}(n) @f$ complexity
+         * where @f$ n @f$ is @ref capacity().
          * @todoc fix the isAllocated link once Doxygen stops being shit -- it
          *      works only from Containers themselves
          * @see @ref Corrade::Containers::Function "Containers::Function<R(Args...)>::isAllocated()"
@@ -427,6 +453,20 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onPress(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a finger / pen tap or left mouse press on multiple nodes
+         *
+         * Compared to @ref onPress(NodeHandle, Containers::Function<void()>&&)
+         * creates a connection for each item in @p nodes, all sharing a
+         * single @p slot that receives the node the event happened on. The
+         * created handles are written into @p handles, which is expected to
+         * have the same size as @p nodes. Expects that the @p slot is not
+         * @cpp nullptr @ce. The @p slot is destroyed once all connections
+         * using it are removed.
+         * @see @ref Ui-EventLayer-create-batch
+         */
+        void onPress(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle node)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Connect to a finger / pen tap or left mouse release
          *
@@ -464,6 +504,20 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onRelease(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a finger / pen tap or left mouse release on multiple nodes
+         *
+         * Compared to @ref onRelease(NodeHandle, Containers::Function<void()>&&)
+         * creates a connection for each item in @p nodes, all sharing a
+         * single @p slot that receives the node the event happened on. The
+         * created handles are written into @p handles, which is expected to
+         * have the same size as @p nodes. Expects that the @p slot is not
+         * @cpp nullptr @ce. The @p slot is destroyed once all connections
+         * using it are removed.
+         * @see @ref Ui-EventLayer-create-batch
+         */
+        void onRelease(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle node)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Connect to a finger / pen tap or left mouse click
          *
@@ -505,6 +559,20 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onTapOrClick(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a finger / pen tap or left mouse click on multiple nodes
+         *
+         * Compared to @ref onTapOrClick(NodeHandle, Containers::Function<void()>&&)
+         * creates a connection for each item in @p nodes, all sharing a
+         * single @p slot that receives the node the event happened on. The
+         * created handles are written into @p handles, which is expected to
+         * have the same size as @p nodes. Expects that the @p slot is not
+         * @cpp nullptr @ce. The @p slot is destroyed once all connections
+         * using it are removed.
+         * @see @ref Ui-EventLayer-create-batch
+         */
+        void onTapOrClick(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle node)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Connect to a middle mouse click
          *
@@ -545,6 +613,20 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onMiddleClick(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a middle mouse click on multiple nodes
+         *
+         * Compared to @ref onMiddleClick(NodeHandle, Containers::Function<void()>&&)
+         * creates a connection for each item in @p nodes, all sharing a
+         * single @p slot that receives the node the event happened on. The
+         * created handles are written into @p handles, which is expected to
+         * have the same size as @p nodes. Expects that the @p slot is not
+         * @cpp nullptr @ce. The @p slot is destroyed once all connections
+         * using it are removed.
+         * @see @ref Ui-EventLayer-create-batch
+         */
+        void onMiddleClick(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle node)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Connect to a right mouse click
          *
@@ -585,6 +667,20 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onRightClick(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a right mouse click on multiple nodes
+         *
+         * Compared to @ref onRightClick(NodeHandle, Containers::Function<void()>&&)
+         * creates a connection for each item in @p nodes, all sharing a
+         * single @p slot that receives the node the event happened on. The
+         * created handles are written into @p handles, which is expected to
+         * have the same size as @p nodes. Expects that the @p slot is not
+         * @cpp nullptr @ce. The @p slot is destroyed once all connections
+         * using it are removed.
+         * @see @ref Ui-EventLayer-create-batch
+         */
+        void onRightClick(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle node)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Connect to a drag
          *
@@ -790,6 +886,20 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onEnter(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a pointer enter on multiple nodes
+         *
+         * Compared to @ref onEnter(NodeHandle, Containers::Function<void()>&&)
+         * creates a connection for each item in @p nodes, all sharing a
+         * single @p slot that receives the node the event happened on. The
+         * created handles are written into @p handles, which is expected to
+         * have the same size as @p nodes. Expects that the @p slot is not
+         * @cpp nullptr @ce. The @p slot is destroyed once all connections
+         * using it are removed.
+         * @see @ref Ui-EventLayer-create-batch
+         */
+        void onEnter(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle node)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Connect to a pointer leave
          *
@@ -819,6 +929,20 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onLeave(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a pointer leave on multiple nodes
+         *
+         * Compared to @ref onLeave(NodeHandle, Containers::Function<void()>&&)
+         * creates a connection for each item in @p nodes, all sharing a
+         * single @p slot that receives the node the event happened on. The
+         * created handles are written into @p handles, which is expected to
+         * have the same size as @p nodes. Expects that the @p slot is not
+         * @cpp nullptr @ce. The @p slot is destroyed once all connections
+         * using it are removed.
+         * @see @ref Ui-EventLayer-create-batch
+         */
+        void onLeave(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle node)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Connect to a focus
          *
@@ -845,6 +969,20 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onFocus(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a focus on multiple nodes
+         *
+         * Compared to @ref onFocus(NodeHandle, Containers::Function<void()>&&)
+         * creates a connection for each item in @p nodes, all sharing a
+         * single @p slot that receives the node the event happened on. The
+         * created handles are written into @p handles, which is expected to
+         * have the same size as @p nodes. Expects that the @p slot is not
+         * @cpp nullptr @ce. The @p slot is destroyed once all connections
+         * using it are removed.
+         * @see @ref Ui-EventLayer-create-batch
+         */
+        void onFocus(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle node)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Connect to a blur
          *
@@ -871,6 +1009,20 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onBlur(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a blur on multiple nodes
+         *
+         * Compared to @ref onBlur(NodeHandle, Containers::Function<void()>&&)
+         * creates a connection for each item in @p nodes, all sharing a
+         * single @p slot that receives the node the event happened on. The
+         * created handles are written into @p handles, which is expected to
+         * have the same size as @p nodes. Expects that the @p slot is not
+         * @cpp nullptr @ce. The @p slot is destroyed once all connections
+         * using it are removed.
+         * @see @ref Ui-EventLayer-create-batch
+         */
+        void onBlur(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Containers::Function<void(NodeHandle node)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Remove a connection
          *
@@ -899,16 +1051,26 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
         /* Updates usedScopedConnectionCount */
         friend EventConnection;
 
-        /* Used internally from all templated create() overloads below */
-        MAGNUM_UI_LOCAL DataHandle create(NodeHandle node, Implementation::EventType eventType, Containers::FunctionData&& slot, void(*call)());
+        /* Used internally from all on*() APIs above */
+        MAGNUM_UI_LOCAL DataHandle create(NodeHandle node, Implementation::EventType eventType, Containers::FunctionData&& slot, bool position);
+        MAGNUM_UI_LOCAL void createShared(const Containers::StridedArrayView1D<const NodeHandle>& nodes, Implementation::EventType eventType, Containers::Function<void(NodeHandle)>&& slot, const Containers::StridedArrayView1D<DataHandle>& handles);
+        /* Calls a slot taking either no arguments, an optional position or a
+           node handle, or an optional position and a second vector */
+        MAGNUM_UI_LOCAL void callSlot(UnsignedInt dataId, const Vector2& position);
+        MAGNUM_UI_LOCAL void callSlot(UnsignedInt dataId, const Vector2& position, const Vector2& second);
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
 
         MAGNUM_UI_LOCAL LayerFeatures doFeatures() const override;
-        MAGNUM_UI_LOCAL void doClean(Containers::BitArrayView dataIdsToRemove) override;
+        MAGNUM_UI_LOCAL void doCleanSparse(Containers::BitArrayView dataIdsToRemove, Containers::ArrayView<const UnsignedInt> dataIds) override;
+        MAGNUM_UI_LOCAL void doTrim(std::size_t capacity) override;
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
 
         MAGNUM_UI_LOCAL void doPointerPressEvent(UnsignedInt dataId, PointerEvent& event) override;
         MAGNUM_UI_LOCAL void doPointerReleaseEvent(UnsignedInt dataId, PointerEvent& event) override;
         MAGNUM_UI_LOCAL void doPointerMoveEvent(UnsignedInt dataId, PointerMoveEvent& event) override;
+        MAGNUM_UI_LOCAL void doPointerPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) override;
+        MAGNUM_UI_LOCAL void doPointerReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) override;
+        MAGNUM_UI_LOCAL void doPointerMoveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) override;
         MAGNUM_UI_LOCAL void doPointerEnterEvent(UnsignedInt dataId, PointerMoveEvent& event) override;
         MAGNUM_UI_LOCAL void doPointerLeaveEvent(UnsignedInt dataId, PointerMoveEvent& event) override;
         MAGNUM_UI_LOCAL void doPointerCancelEvent(UnsignedInt dataId, PointerCancelEvent& event) override;
@@ -0,0 +1,324 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "EventQueue.h"
+
+#include <atomic>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Event.h"
+#include "Magnum/Ui/Implementation/trace.h"
+
+namespace Magnum { namespace Ui {
+
+namespace {
+
+enum class EventType: UnsignedByte {
+    PointerPress,
+    PointerRelease,
+    PointerMove,
+    Scroll,
+    KeyPress,
+    KeyRelease,
+    TextInput
+};
+
+/* A superset of properties of all event types that are passed to their
+   constructors, the rest is filled by AbstractUserInterface */
+struct Slot {
+    /* Equal to the slot index if it's free for a producer at given position,
+       position + 1 if it's filled and ready for the consumer. Using the
+       scheme from D. Vyukov's bounded MPMC queue, which needs just a single
+       CAS per enqueue and no CAS at all for a single consumer. */
+    std::atomic<std::size_t> sequence;
+
+    EventType type;
+    PointerEventSource source;
+    Pointer pointer;
+    Pointers pointers;
+    bool primary;
+    Key key;
+    Modifiers modifiers;
+    Long id;
+    Nanoseconds time;
+    /* Global position for pointer and scroll events, scroll offset is in
+       offset */
+    Vector2 position;
+    Vector2 offset;
+    Containers::String text;
+};
+
+}
+
+struct EventQueue::State {
+    explicit State(std::size_t capacity): slots{ValueInit, capacity}, mask{capacity - 1} {
+        for(std::size_t i = 0; i != capacity; ++i)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /* Try to reserve a slot for a producer, returns nullptr if full. The slot
+       has to be then published with publish(). */
+    Slot* reserve(std::size_t& position) {
+        position = enqueuePosition.load(std::memory_order_relaxed);
+        for(;;) {
+            Slot& slot = slots[position & mask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+            if(difference == 0) {
+                if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    return &slot;
+            /* The consumer didn't get to this slot yet, the queue is full */
+            } else if(difference < 0) {
+                return nullptr;
+            /* Another producer got the slot first, try again */
+            } else position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    void publish(Slot& slot, const std::size_t position) {
+        slot.sequence.store(position + 1, std::memory_order_release);
+    }
+
+    Containers::Array<Slot> slots;
+    std::size_t mask;
+    /* Written by producers only */
+    std::atomic<std::size_t> enqueuePosition{0};
+    /* Written by the consumer only, size() reads it approximately */
+    std::atomic<std::size_t> dequeuePosition{0};
+};
+
+EventQueue::EventQueue(const std::size_t capacity) {
+    CORRADE_ASSERT(capacity && !(capacity & (capacity - 1)),
+        "Ui::EventQueue: expected capacity to be a power of two, got" << capacity, );
+    _state.emplace(capacity);
+}
+
+EventQueue::~EventQueue() = default;
+
+std::size_t EventQueue::capacity() const {
+    return _state->slots.size();
+}
+
+std::size_t EventQueue::size() const {
+    const std::size_t dequeuePosition = _state->dequeuePosition.load(std::memory_order_relaxed);
+    const std::size_t enqueuePosition = _state->enqueuePosition.load(std::memory_order_relaxed);
+    /* The positions are loaded separately, clamp in case the consumer got
+       ahead in the meantime */
+    return enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0;
+}
+
+bool EventQueue::pointerPressEvent(const Vector2& globalPosition, const PointerEvent& event) {
+    std::size_t position;
+    Slot* const slot = _state->reserve(position);
+    if(!slot)
+        return false;
+
+    slot->type = EventType::PointerPress;
+    slot->time = event.time();
+    slot->source = event.source();
+    slot->pointer = event.pointer();
+    slot->primary = event.isPrimary();
+    slot->id = event.id();
+    slot->position = globalPosition;
+    _state->publish(*slot, position);
+    return true;
+}
+
+bool EventQueue::pointerReleaseEvent(const Vector2& globalPosition, const PointerEvent& event) {
+    std::size_t position;
+    Slot* const slot = _state->reserve(position);
+    if(!slot)
+        return false;
+
+    slot->type = EventType::PointerRelease;
+    slot->time = event.time();
+    slot->source = event.source();
+    slot->pointer = event.pointer();
+    slot->primary = event.isPrimary();
+    slot->id = event.id();
+    slot->position = globalPosition;
+    _state->publish(*slot, position);
+    return true;
+}
+
+bool EventQueue::pointerMoveEvent(const Vector2& globalPosition, const PointerMoveEvent& event) {
+    std::size_t position;
+    Slot* const slot = _state->reserve(position);
+    if(!slot)
+        return false;
+
+    slot->type = EventType::PointerMove;
+    slot->time = event.time();
+    slot->source = event.source();
+    /* NullOpt encoded as Pointer{}, same as in PointerMoveEvent itself */
+    const Containers::Optional<Pointer> pointer = event.pointer();
+    slot->pointer = pointer ? *pointer : Pointer{};
+    slot->pointers = event.pointers();
+    slot->primary = event.isPrimary();
+    slot->id = event.id();
+    slot->position = globalPosition;
+    _state->publish(*slot, position);
+    return true;
+}
+
+bool EventQueue::scrollEvent(const Vector2& globalPosition, const ScrollEvent& event) {
+    std::size_t position;
+    Slot* const slot = _state->reserve(position);
+    if(!slot)
+        return false;
+
+    slot->type = EventType::Scroll;
+    slot->time = event.time();
+    slot->offset = event.offset();
+    slot->position = globalPosition;
+    _state->publish(*slot, position);
+    return true;
+}
+
+bool EventQueue::keyPressEvent(const KeyEvent& event) {
+    std::size_t position;
+    Slot* const slot = _state->reserve(position);
+    if(!slot)
+        return false;
+
+    slot->type = EventType::KeyPress;
+    slot->time = event.time();
+    slot->key = event.key();
+    slot->modifiers = event.modifiers();
+    _state->publish(*slot, position);
+    return true;
+}
+
+bool EventQueue::keyReleaseEvent(const KeyEvent& event) {
+    std::size_t position;
+    Slot* const slot = _state->reserve(position);
+    if(!slot)
+        return false;
+
+    slot->type = EventType::KeyRelease;
+    slot->time = event.time();
+    slot->key = event.key();
+    slot->modifiers = event.modifiers();
+    _state->publish(*slot, position);
+    return true;
+}
+
+bool EventQueue::textInputEvent(const TextInputEvent& event) {
+    std::size_t position;
+    Slot* const slot = _state->reserve(position);
+    if(!slot)
+        return false;
+
+    slot->type = EventType::TextInput;
+    slot->time = event.time();
+    /* Make a copy, the view is likely pointing to a temporary on the
+       producer side. For short strings it's stored inline in the slot. */
+    slot->text = Containers::String{event.text()};
+    _state->publish(*slot, position);
+    return true;
+}
+
+std::size_t EventQueue::dispatch(AbstractUserInterface& ui) {
+    MAGNUM_UI_TRACE_ZONE("Ui::EventQueue::dispatch()");
+    State& state = *_state;
+
+    /* Deliver only events that were added until now, so a producer adding
+       events faster than they can be processed, or an event handler adding
+       events back to the queue, doesn't cause this to never finish */
+    const std::size_t end = state.enqueuePosition.load(std::memory_order_acquire);
+    std::size_t position = state.dequeuePosition.load(std::memory_order_relaxed);
+    if(position == end)
+        return 0;
+
+    /* Do a single update for the whole batch. The event handlers call it as
+       well, but it does nothing unless a previous event caused some change. */
+    ui.update();
+
+    std::size_t count = 0;
+    while(position != end) {
+        Slot& slot = state.slots[position & state.mask];
+        /* A producer reserved the slot but didn't finish writing it yet. Stop
+           here to preserve the order, it'll get delivered next time. */
+        if(slot.sequence.load(std::memory_order_acquire) != position + 1)
+            break;
+
+        switch(slot.type) {
+            case EventType::PointerPress: {
+                PointerEvent event{slot.time, slot.source, slot.pointer, slot.primary, slot.id};
+                ui.pointerPressEvent(slot.position, event);
+            } break;
+            case EventType::PointerRelease: {
+                PointerEvent event{slot.time, slot.source, slot.pointer, slot.primary, slot.id};
+                ui.pointerReleaseEvent(slot.position, event);
+            } break;
+            case EventType::PointerMove: {
+                Containers::Optional<Pointer> pointer;
+                if(slot.pointer != Pointer{})
+                    pointer = slot.pointer;
+                PointerMoveEvent event{slot.time, slot.source, pointer, slot.pointers, slot.primary, slot.id};
+                ui.pointerMoveEvent(slot.position, event);
+            } break;
+            case EventType::Scroll: {
+                ScrollEvent event{slot.time, slot.offset};
+                ui.scrollEvent(slot.position, event);
+            } break;
+            case EventType::KeyPress: {
+                KeyEvent event{slot.time, slot.key, slot.modifiers};
+                ui.keyPressEvent(event);
+            } break;
+            case EventType::KeyRelease: {
+                KeyEvent event{slot.time, slot.key, slot.modifiers};
+                ui.keyReleaseEvent(event);
+            } break;
+            case EventType::TextInput: {
+                /* The text is released only once the event is delivered as
+                   the event references it */
+                {
+                    TextInputEvent event{slot.time, slot.text};
+                    ui.textInputEvent(event);
+                }
+                slot.text = Containers::String{};
+            } break;
+        }
+
+        /* Make the slot available for producers again, for the position one
+           round later. The dequeue position is published right after so
+           size() doesn't lag behind. */
+        slot.sequence.store(position + state.mask + 1, std::memory_order_release);
+        ++position;
+        state.dequeuePosition.store(position, std::memory_order_relaxed);
+        ++count;
+    }
+
+    return count;
+}
+
+}}
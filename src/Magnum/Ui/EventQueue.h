@@ -0,0 +1,236 @@
+#ifndef Magnum_Ui_EventQueue_h
+#define Magnum_Ui_EventQueue_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Ui::EventQueue
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/Pointer.h>
+
+#include "Magnum/Ui/Ui.h"
+#include "Magnum/Ui/visibility.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Thread-safe event queue
+@m_since_latest
+
+The @ref AbstractUserInterface event handlers such as
+@ref AbstractUserInterface::pointerPressEvent() are expected to be called from
+the thread that owns the user interface. If input arrives from a different
+thread, such as from a custom touch controller driver or from a remote
+connection, the events can be put into this queue instead and then delivered
+on the UI thread all at once, typically right before
+@ref AbstractUserInterface::draw():
+
+@code{.cpp}
+Ui::EventQueue queue{256};
+
+// On an input thread
+Ui::PointerEvent press{time, Ui::PointerEventSource::Touch,
+    Ui::Pointer::Finger, true, id};
+if(!queue.pointerPressEvent(position, press))
+    Warning{} << "Input queue full, dropping an event";
+
+// On the UI thread, once per frame
+queue.dispatch(ui);
+ui.draw();
+@endcode
+
+The queue has a fixed capacity specified in the constructor, it doesn't
+allocate afterwards except for @ref textInputEvent() with text that doesn't
+fit into the @relativeref{Corrade,Containers::String} small string storage.
+Adding events doesn't block and is safe to be done from any number of threads
+at the same time, if the queue is full the event is dropped and the function
+returns @cpp false @ce. Only the event properties that are passed to the event
+constructors are stored, the position, capture and node-related properties are
+filled by the @ref AbstractUserInterface event handlers on dispatch as usual.
+
+@section Ui-EventQueue-dispatch Event dispatch
+
+The @ref dispatch() function can be called only from a single thread at a time,
+usually the thread owning the user interface. It calls
+@ref AbstractUserInterface::update() once and then delivers the events in the
+order they were added. Each event handler still calls
+@ref AbstractUserInterface::update() internally, but as long as the previously
+delivered events didn't cause any node or data changes, it's a no-op. Events
+added while @ref dispatch() is running, either by other threads or by event
+handlers themselves, are left for the next call so a busy producer can't stall
+the frame.
+
+If @ref AbstractUserInterface::setPointerMoveEventCoalescing() is enabled,
+consecutive pointer move events from the queue get coalesced as well, and only
+the last one is delivered on the next non-move event or at the start of
+@ref AbstractUserInterface::draw().
+*/
+class MAGNUM_UI_EXPORT EventQueue {
+    public:
+        /**
+         * @brief Constructor
+         * @param capacity  Max count of events that can be queued at the same
+         *      time
+         *
+         * Expects that @p capacity is a power of two.
+         */
+        explicit EventQueue(std::size_t capacity);
+
+        /** @brief Copying is not allowed */
+        EventQueue(const EventQueue&) = delete;
+
+        /**
+         * @brief Moving is not allowed
+         *
+         * The queue is meant to be shared between threads, which means it
+         * can't change its location in memory.
+         */
+        EventQueue(EventQueue&&) = delete;
+
+        ~EventQueue();
+
+        /** @brief Copying is not allowed */
+        EventQueue& operator=(const EventQueue&) = delete;
+
+        /** @brief Moving is not allowed */
+        EventQueue& operator=(EventQueue&&) = delete;
+
+        /** @brief Queue capacity */
+        std::size_t capacity() const;
+
+        /**
+         * @brief Count of queued events
+         *
+         * Includes events that are currently being added by other threads.
+         * As other threads can add events and @ref dispatch() can remove them
+         * at the same time, the value is only approximate.
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Queue a pointer press event
+         *
+         * Remembers @ref PointerEvent::time(),
+         * @relativeref{PointerEvent,source()},
+         * @relativeref{PointerEvent,pointer()},
+         * @relativeref{PointerEvent,isPrimary()} and
+         * @relativeref{PointerEvent,id()} together with @p globalPosition for
+         * a later @ref AbstractUserInterface::pointerPressEvent(). Returns
+         * @cpp false @ce if the queue is full, @cpp true @ce otherwise. Can be
+         * called from any thread.
+         */
+        bool pointerPressEvent(const Vector2& globalPosition, const PointerEvent& event);
+
+        /**
+         * @brief Queue a pointer release event
+         *
+         * Remembers the same properties as @ref pointerPressEvent() for a
+         * later @ref AbstractUserInterface::pointerReleaseEvent(). Returns
+         * @cpp false @ce if the queue is full, @cpp true @ce otherwise. Can be
+         * called from any thread.
+         */
+        bool pointerReleaseEvent(const Vector2& globalPosition, const PointerEvent& event);
+
+        /**
+         * @brief Queue a pointer move event
+         *
+         * Remembers @ref PointerMoveEvent::time(),
+         * @relativeref{PointerMoveEvent,source()},
+         * @relativeref{PointerMoveEvent,pointer()},
+         * @relativeref{PointerMoveEvent,pointers()},
+         * @relativeref{PointerMoveEvent,isPrimary()} and
+         * @relativeref{PointerMoveEvent,id()} together with @p globalPosition
+         * for a later @ref AbstractUserInterface::pointerMoveEvent(). Returns
+         * @cpp false @ce if the queue is full, @cpp true @ce otherwise. Can be
+         * called from any thread.
+         */
+        bool pointerMoveEvent(const Vector2& globalPosition, const PointerMoveEvent& event);
+
+        /**
+         * @brief Queue a scroll event
+         *
+         * Remembers @ref ScrollEvent::time() and
+         * @relativeref{ScrollEvent,offset()} together with @p globalPosition
+         * for a later @ref AbstractUserInterface::scrollEvent(). Returns
+         * @cpp false @ce if the queue is full, @cpp true @ce otherwise. Can be
+         * called from any thread.
+         */
+        bool scrollEvent(const Vector2& globalPosition, const ScrollEvent& event);
+
+        /**
+         * @brief Queue a key press event
+         *
+         * Remembers @ref KeyEvent::time(), @relativeref{KeyEvent,key()} and
+         * @relativeref{KeyEvent,modifiers()} for a later
+         * @ref AbstractUserInterface::keyPressEvent(). Returns @cpp false @ce
+         * if the queue is full, @cpp true @ce otherwise. Can be called from
+         * any thread.
+         */
+        bool keyPressEvent(const KeyEvent& event);
+
+        /**
+         * @brief Queue a key release event
+         *
+         * Remembers the same properties as @ref keyPressEvent() for a later
+         * @ref AbstractUserInterface::keyReleaseEvent(). Returns
+         * @cpp false @ce if the queue is full, @cpp true @ce otherwise. Can be
+         * called from any thread.
+         */
+        bool keyReleaseEvent(const KeyEvent& event);
+
+        /**
+         * @brief Queue a text input event
+         *
+         * Remembers @ref TextInputEvent::time() and a copy of
+         * @relativeref{TextInputEvent,text()} for a later
+         * @ref AbstractUserInterface::textInputEvent(), so the original text
+         * doesn't need to stay in scope. Returns @cpp false @ce if the queue
+         * is full, @cpp true @ce otherwise. Can be called from any thread.
+         */
+        bool textInputEvent(const TextInputEvent& event);
+
+        /**
+         * @brief Deliver queued events to a user interface
+         * @return Count of delivered events
+         *
+         * Calls @ref AbstractUserInterface::update() and then delivers all
+         * events that were fully added before this function was called, in
+         * the order they were added. See @ref Ui-EventQueue-dispatch for more
+         * information. Expects that it's not called from multiple threads at
+         * the same time.
+         */
+        std::size_t dispatch(AbstractUserInterface& ui);
+
+    private:
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
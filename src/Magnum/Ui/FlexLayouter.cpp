@@ -0,0 +1,461 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include "FlexLayouter.h"
+
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/EnumSet.hpp>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Swizzle.h>
+#include <Magnum/Math/Vector4.h>
+
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/Implementation/breadthFirstNodeOrder.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
+#include "Magnum/Ui/Implementation/frameArena.h"
+
+namespace Magnum { namespace Ui {
+
+Debug& operator<<(Debug& debug, const FlexDirection value) {
+    const bool packed = debug.immediateFlags() >= Debug::Flag::Packed;
+
+    if(!packed)
+        debug << "Ui::FlexDirection" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case FlexDirection::value: return debug << (packed ? "" : "::") << Debug::nospace << #value;
+        _c(Row)
+        _c(Column)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << (packed ? "" : "(") << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << (packed ? "" : ")");
+}
+
+Debug& operator<<(Debug& debug, const FlexAlignment value) {
+    const bool packed = debug.immediateFlags() >= Debug::Flag::Packed;
+
+    if(!packed)
+        debug << "Ui::FlexAlignment" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case FlexAlignment::value: return debug << (packed ? "" : "::") << Debug::nospace << #value;
+        _c(Start)
+        _c(Center)
+        _c(End)
+        _c(Stretch)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << (packed ? "" : "(") << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << (packed ? "" : ")");
+}
+
+Debug& operator<<(Debug& debug, const FlexLayoutFlag value) {
+    const bool packed = debug.immediateFlags() >= Debug::Flag::Packed;
+
+    if(!packed)
+        debug << "Ui::FlexLayoutFlag" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case FlexLayoutFlag::value: return debug << (packed ? "" : "::") << Debug::nospace << #value;
+        _c(Wrap)
+        _c(FitContent)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << (packed ? "" : "(") << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << (packed ? "" : ")");
+}
+
+Debug& operator<<(Debug& debug, const FlexLayoutFlags value) {
+    return Containers::enumSetDebugOutput(debug, value, debug.immediateFlags() >= Debug::Flag::Packed ? "{}" : "Ui::FlexLayoutFlags{}", {
+        FlexLayoutFlag::Wrap,
+        FlexLayoutFlag::FitContent,
+    });
+}
+
+namespace {
+
+struct Layout {
+    /* Used to order child layouts in the order they were added, as layout
+       IDs get recycled */
+    UnsignedInt order;
+    FlexDirection direction;
+    FlexAlignment alignment;
+    FlexLayoutFlags flags;
+    /* 1 byte free */
+};
+
+}
+
+struct FlexLayouter::State {
+    Vector4 padding;
+    Vector2 gap;
+    Containers::Array<Layout> layouts;
+    UnsignedInt nextOrder = 0;
+
+    /* Temporary storage for doUpdate(), kept across calls to avoid
+       allocating on every update */
+    Implementation::FrameArena updateStorage;
+    /* Breadth-first node order, kept across doUpdate() calls and
+       recalculated only if the node hierarchy changes */
+    Implementation::BreadthFirstNodeOrder nodeOrder;
+};
+
+FlexLayouter::FlexLayouter(const LayouterHandle handle): AbstractLayouter{handle}, _state{InPlaceInit} {}
+
+FlexLayouter::FlexLayouter(FlexLayouter&&) noexcept = default;
+
+FlexLayouter::~FlexLayouter() = default;
+
+FlexLayouter& FlexLayouter::operator=(FlexLayouter&&) noexcept = default;
+
+Vector4 FlexLayouter::padding() const { return _state->padding; }
+
+FlexLayouter& FlexLayouter::setPadding(const Vector4& padding) {
+    _state->padding = padding;
+    setNeedsUpdate();
+    return *this;
+}
+
+FlexLayouter& FlexLayouter::setPadding(const Vector2& padding) {
+    return setPadding(Math::gather<'x', 'y', 'x', 'y'>(padding));
+}
+
+FlexLayouter& FlexLayouter::setPadding(const Float padding) {
+    return setPadding(Vector4{padding});
+}
+
+Vector2 FlexLayouter::gap() const { return _state->gap; }
+
+FlexLayouter& FlexLayouter::setGap(const Vector2& gap) {
+    _state->gap = gap;
+    setNeedsUpdate();
+    return *this;
+}
+
+FlexLayouter& FlexLayouter::setGap(const Float gap) {
+    return setGap(Vector2{gap});
+}
+
+LayoutHandle FlexLayouter::add(const NodeHandle node, const FlexDirection direction, const FlexAlignment alignment, const FlexLayoutFlags flags) {
+    State& state = *_state;
+
+    const LayoutHandle handle = AbstractLayouter::add(node);
+    const UnsignedInt id = layoutHandleId(handle);
+    if(id >= state.layouts.size())
+        arrayAppend(state.layouts, NoInit, id - state.layouts.size() + 1);
+
+    Layout& layout = state.layouts[id];
+    layout.order = state.nextOrder++;
+    layout.direction = direction;
+    layout.alignment = alignment;
+    layout.flags = flags;
+    return handle;
+}
+
+FlexDirection FlexLayouter::direction(const LayoutHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::direction(): invalid handle" << handle, {});
+    return _state->layouts[layoutHandleId(handle)].direction;
+}
+
+FlexDirection FlexLayouter::direction(const LayouterDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::direction(): invalid handle" << handle, {});
+    return _state->layouts[layouterDataHandleId(handle)].direction;
+}
+
+void FlexLayouter::setDirection(const LayoutHandle handle, const FlexDirection direction) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::setDirection(): invalid handle" << handle, );
+    _state->layouts[layoutHandleId(handle)].direction = direction;
+    setNeedsUpdate();
+}
+
+void FlexLayouter::setDirection(const LayouterDataHandle handle, const FlexDirection direction) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::setDirection(): invalid handle" << handle, );
+    _state->layouts[layouterDataHandleId(handle)].direction = direction;
+    setNeedsUpdate();
+}
+
+FlexAlignment FlexLayouter::alignment(const LayoutHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::alignment(): invalid handle" << handle, {});
+    return _state->layouts[layoutHandleId(handle)].alignment;
+}
+
+FlexAlignment FlexLayouter::alignment(const LayouterDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::alignment(): invalid handle" << handle, {});
+    return _state->layouts[layouterDataHandleId(handle)].alignment;
+}
+
+void FlexLayouter::setAlignment(const LayoutHandle handle, const FlexAlignment alignment) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::setAlignment(): invalid handle" << handle, );
+    _state->layouts[layoutHandleId(handle)].alignment = alignment;
+    setNeedsUpdate();
+}
+
+void FlexLayouter::setAlignment(const LayouterDataHandle handle, const FlexAlignment alignment) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::setAlignment(): invalid handle" << handle, );
+    _state->layouts[layouterDataHandleId(handle)].alignment = alignment;
+    setNeedsUpdate();
+}
+
+FlexLayoutFlags FlexLayouter::flags(const LayoutHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::flags(): invalid handle" << handle, {});
+    return _state->layouts[layoutHandleId(handle)].flags;
+}
+
+FlexLayoutFlags FlexLayouter::flags(const LayouterDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::flags(): invalid handle" << handle, {});
+    return _state->layouts[layouterDataHandleId(handle)].flags;
+}
+
+void FlexLayouter::setFlags(const LayoutHandle handle, const FlexLayoutFlags flags) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::setFlags(): invalid handle" << handle, );
+    _state->layouts[layoutHandleId(handle)].flags = flags;
+    setNeedsUpdate();
+}
+
+void FlexLayouter::setFlags(const LayouterDataHandle handle, const FlexLayoutFlags flags) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::FlexLayouter::setFlags(): invalid handle" << handle, );
+    _state->layouts[layouterDataHandleId(handle)].flags = flags;
+    setNeedsUpdate();
+}
+
+void FlexLayouter::doUpdate(const Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) {
+    State& state = *_state;
+    const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+
+    Implementation::FrameArena& storage = state.updateStorage;
+    storage.reset();
+
+    /* Order the nodes breadth-first, which is done only if the node hierarchy
+       changed since the last time */
+    const Containers::ArrayView<const Int> nodeIdsBreadthFirst = state.nodeOrder.update(nodeParents, storage);
+
+    /* Layout ID for each node that has a layout to update, ~0 otherwise */
+    const Containers::ArrayView<UnsignedInt> nodeLayoutIds = storage.allocate<UnsignedInt>(NoInit, nodeParents.size());
+    for(UnsignedInt& i: nodeLayoutIds)
+        i = ~UnsignedInt{};
+    Implementation::forEachSetBit(layoutIdsToUpdate, [&](const std::size_t i) {
+        nodeLayoutIds[nodeHandleId(nodes[i])] = i;
+    });
+
+    /* Layouts to update in the breadth-first order of their nodes, i.e. with
+       parent layouts always before their children, skipping the first node
+       item which is -1 */
+    const std::size_t count = layoutIdsToUpdate.count();
+    const Containers::ArrayView<UnsignedInt> layoutIds = storage.allocate<UnsignedInt>(NoInit, count);
+    {
+        std::size_t offset = 0;
+        for(const Int nodeId: nodeIdsBreadthFirst.exceptPrefix(1)) {
+            const UnsignedInt layoutId = nodeLayoutIds[nodeId];
+            if(layoutId != ~UnsignedInt{})
+                layoutIds[offset++] = layoutId;
+        }
+        CORRADE_INTERNAL_DEBUG_ASSERT(offset == count);
+    }
+
+    /* Child layouts for each layout. First calculate the count of children
+       for each, skipping the first two elements ... */
+    const Containers::ArrayView<UnsignedInt> childOffsets = storage.allocate<UnsignedInt>(ValueInit, layoutIdsToUpdate.size() + 2);
+    const Containers::ArrayView<UnsignedInt> children = storage.allocate<UnsignedInt>(NoInit, count);
+    const auto parentLayoutId = [&](const UnsignedInt layoutId) {
+        const NodeHandle parent = nodeParents[nodeHandleId(nodes[layoutId])];
+        return parent == NodeHandle::Null ? ~UnsignedInt{} : nodeLayoutIds[nodeHandleId(parent)];
+    };
+    for(const UnsignedInt i: layoutIds) {
+        const UnsignedInt parent = parentLayoutId(i);
+        if(parent != ~UnsignedInt{})
+            ++childOffsets[parent + 2];
+    }
+
+    /* ... then convert the counts to a running offset ... */
+    {
+        UnsignedInt offset = 0;
+        for(UnsignedInt& i: childOffsets) {
+            const UnsignedInt nextOffset = offset + i;
+            i = offset;
+            offset = nextOffset;
+        }
+    }
+
+    /* ... and go through the layouts again, putting them into the ranges.
+       This shifts the offsets by one element, so now
+       `[childOffsets[i], childOffsets[i + 1])` is the range of children of
+       layout `i`. Finally, the children are brought into the order in which
+       they were added. They're usually added in the same order as the node
+       IDs go, which makes the insertion sort close to linear. */
+    for(const UnsignedInt i: layoutIds) {
+        const UnsignedInt parent = parentLayoutId(i);
+        if(parent != ~UnsignedInt{})
+            children[childOffsets[parent + 1]++] = i;
+    }
+    for(const UnsignedInt i: layoutIds) {
+        for(std::size_t j = childOffsets[i] + 1; j < childOffsets[i + 1]; ++j) {
+            const UnsignedInt child = children[j];
+            const UnsignedInt order = state.layouts[child].order;
+            std::size_t k = j;
+            for(; k != childOffsets[i] && state.layouts[children[k - 1]].order > order; --k)
+                children[k] = children[k - 1];
+            children[k] = child;
+        }
+    }
+
+    /* Finds where a line starting at `begin` ends if wrapping at given
+       main-axis size, and returns the end together with the largest
+       cross-axis size in the line */
+    const auto wrapLine = [&](const Containers::ArrayView<const UnsignedInt> items, const std::size_t begin, const UnsignedInt mainAxis, const Float mainSize) {
+        const UnsignedInt crossAxis = 1 - mainAxis;
+        Float lineMainSize = 0.0f;
+        Float lineCrossSize = 0.0f;
+        std::size_t end = begin;
+        for(; end != items.size(); ++end) {
+            const Vector2 size = nodeSizes[nodeHandleId(nodes[items[end]])];
+            const Float nextLineMainSize = end == begin ?
+                size[mainAxis] : lineMainSize + state.gap[mainAxis] + size[mainAxis];
+            if(end != begin && nextLineMainSize > mainSize)
+                break;
+            lineMainSize = nextLineMainSize;
+            lineCrossSize = Math::max(lineCrossSize, size[crossAxis]);
+        }
+        return Containers::pair(end, lineCrossSize);
+    };
+
+    /* Calculate sizes of layouts that fit their content. Goes in reverse
+       order so child sizes are known when calculating their parent. */
+    for(std::size_t i = count; i != 0; --i) {
+        const UnsignedInt layoutId = layoutIds[i - 1];
+        const Layout& layout = state.layouts[layoutId];
+        const Containers::ArrayView<const UnsignedInt> items = children.slice(childOffsets[layoutId], childOffsets[layoutId + 1]);
+        if(!(layout.flags >= FlexLayoutFlag::FitContent) || items.isEmpty())
+            continue;
+
+        const UnsignedInt mainAxis = layout.direction == FlexDirection::Row ? 0 : 1;
+        const UnsignedInt crossAxis = 1 - mainAxis;
+        Vector2& size = nodeSizes[nodeHandleId(nodes[layoutId])];
+
+        /* If wrapping, the main-axis size stays and the lines are summed up
+           on the cross axis */
+        Float crossSize = 0.0f;
+        if(layout.flags >= FlexLayoutFlag::Wrap) {
+            const Float mainSize = size[mainAxis] - state.padding[mainAxis] - state.padding[mainAxis + 2];
+            for(std::size_t begin = 0; begin != items.size(); ) {
+                const Containers::Pair<std::size_t, Float> line = wrapLine(items, begin, mainAxis, mainSize);
+                crossSize += (begin ? state.gap[crossAxis] : 0.0f) + line.second();
+                begin = line.first();
+            }
+
+        /* Otherwise the items are summed on the main axis and the largest is
+           taken on the cross axis */
+        } else {
+            Float mainSize = state.gap[mainAxis]*Float(items.size() - 1);
+            for(const UnsignedInt item: items) {
+                const Vector2 itemSize = nodeSizes[nodeHandleId(nodes[item])];
+                mainSize += itemSize[mainAxis];
+                crossSize = Math::max(crossSize, itemSize[crossAxis]);
+            }
+            size[mainAxis] = state.padding[mainAxis] + mainSize + state.padding[mainAxis + 2];
+        }
+
+        size[crossAxis] = state.padding[crossAxis] + crossSize + state.padding[crossAxis + 2];
+    }
+
+    /* Position the children. Goes in the breadth-first order so a stretched
+       size of a layout is known when positioning its children. */
+    for(const UnsignedInt layoutId: layoutIds) {
+        const Layout& layout = state.layouts[layoutId];
+        const Containers::ArrayView<const UnsignedInt> items = children.slice(childOffsets[layoutId], childOffsets[layoutId + 1]);
+        if(items.isEmpty())
+            continue;
+
+        const UnsignedInt mainAxis = layout.direction == FlexDirection::Row ? 0 : 1;
+        const UnsignedInt crossAxis = 1 - mainAxis;
+        const Vector2 size = nodeSizes[nodeHandleId(nodes[layoutId])];
+        const Float mainSize = size[mainAxis] - state.padding[mainAxis] - state.padding[mainAxis + 2];
+        const Float crossSize = size[crossAxis] - state.padding[crossAxis] - state.padding[crossAxis + 2];
+
+        Float crossOffset = state.padding[crossAxis];
+        for(std::size_t begin = 0; begin != items.size(); ) {
+            /* If not wrapping, there's just one line spanning the whole
+               cross-axis size */
+            const Containers::Pair<std::size_t, Float> line = layout.flags >= FlexLayoutFlag::Wrap ?
+                wrapLine(items, begin, mainAxis, mainSize) :
+                Containers::pair(items.size(), crossSize);
+
+            Float mainOffset = state.padding[mainAxis];
+            for(const UnsignedInt item: items.slice(begin, line.first())) {
+                const UnsignedInt itemNodeId = nodeHandleId(nodes[item]);
+                Vector2& itemSize = nodeSizes[itemNodeId];
+
+                Vector2 offset{NoInit};
+                offset[mainAxis] = mainOffset;
+                switch(layout.alignment) {
+                    case FlexAlignment::Start:
+                        offset[crossAxis] = crossOffset;
+                        break;
+                    case FlexAlignment::Center:
+                        offset[crossAxis] = crossOffset + (line.second() - itemSize[crossAxis])*0.5f;
+                        break;
+                    case FlexAlignment::End:
+                        offset[crossAxis] = crossOffset + line.second() - itemSize[crossAxis];
+                        break;
+                    case FlexAlignment::Stretch:
+                        offset[crossAxis] = crossOffset;
+                        itemSize[crossAxis] = line.second();
+                        break;
+                }
+
+                /* The original node offset is added to the calculated
+                   position */
+                nodeOffsets[itemNodeId] += offset;
+                mainOffset += itemSize[mainAxis] + state.gap[mainAxis];
+            }
+
+            crossOffset += line.second() + state.gap[crossAxis];
+            begin = line.first();
+        }
+    }
+}
+
+}}
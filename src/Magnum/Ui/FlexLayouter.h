@@ -0,0 +1,409 @@
+#ifndef Magnum_Ui_FlexLayouter_h
+#define Magnum_Ui_FlexLayouter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Ui::FlexLayouter, enum @ref Magnum::Ui::FlexDirection, @ref Magnum::Ui::FlexAlignment, @ref Magnum::Ui::FlexLayoutFlag, enum set @ref Magnum::Ui::FlexLayoutFlags
+ * @m_since_latest
+ */
+
+#include "Magnum/Ui/AbstractLayouter.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Flex layout direction
+@m_since_latest
+
+@see @ref FlexLayouter::add(), @ref FlexLayouter::setDirection()
+*/
+enum class FlexDirection: UnsignedByte {
+    /**
+     * Child layouts are placed next to each other from left to right. The
+     * horizontal direction is then the main axis and vertical the cross
+     * axis.
+     */
+    Row,
+
+    /**
+     * Child layouts are placed below each other from top to bottom. The
+     * vertical direction is then the main axis and horizontal the cross
+     * axis.
+     */
+    Column
+};
+
+/**
+@debugoperatorenum{FlexDirection}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, FlexDirection value);
+
+/**
+@brief Flex layout cross-axis alignment
+@m_since_latest
+
+@see @ref FlexLayouter::add(), @ref FlexLayouter::setAlignment()
+*/
+enum class FlexAlignment: UnsignedByte {
+    /** Child layouts are aligned to the top or left side of a line. */
+    Start,
+
+    /** Child layouts are centered in a line. */
+    Center,
+
+    /** Child layouts are aligned to the bottom or right side of a line. */
+    End,
+
+    /**
+     * Cross-axis size of child layouts is made to match the line size.
+     */
+    Stretch
+};
+
+/**
+@debugoperatorenum{FlexAlignment}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, FlexAlignment value);
+
+/**
+@brief Flex layout flag
+@m_since_latest
+
+@see @ref FlexLayoutFlags, @ref FlexLayouter::add(),
+    @ref FlexLayouter::setFlags()
+*/
+enum class FlexLayoutFlag: UnsignedByte {
+    /**
+     * Child layouts that don't fit into the main-axis size of the node are
+     * wrapped to a new line, with the lines separated by cross-axis
+     * @ref FlexLayouter::gap(). Can be used to lay out grids of items with
+     * the same size. If not set, all child layouts are in a single line
+     * spanning the whole cross-axis size of the node.
+     */
+    Wrap = 1 << 0,
+
+    /**
+     * Node size is calculated from sizes of its child layouts, padding and
+     * gaps. If combined with @ref FlexLayoutFlag::Wrap, only the cross-axis
+     * size is calculated, as the main-axis size is needed to know where to
+     * wrap. Has no effect if the layout has no child layouts.
+     */
+    FitContent = 1 << 1
+};
+
+/**
+@debugoperatorenum{FlexLayoutFlag}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, FlexLayoutFlag value);
+
+/**
+@brief Flex layout flags
+@m_since_latest
+
+@see @ref FlexLayouter::add(), @ref FlexLayouter::setFlags()
+*/
+typedef Containers::EnumSet<FlexLayoutFlag> FlexLayoutFlags;
+
+/**
+@debugoperatorenum{FlexLayoutFlags}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, FlexLayoutFlags value);
+
+CORRADE_ENUMSET_OPERATORS(FlexLayoutFlags)
+
+/**
+@brief Flex layouter
+@m_since_latest
+
+Places nodes in rows or columns, optionally wrapping them to a grid, based on
+their sizes. A layout added with @ref add() is for the node it's assigned to
+both a container and an item:
+
+-   As a container, it positions all child nodes that have a layout from the
+    same layouter next to each other in given @ref FlexDirection, in the order
+    the child layouts were added, and aligns them on the cross axis according
+    to @ref FlexAlignment. Offsets set on the child nodes are added to the
+    calculated positions.
+-   As an item, it's positioned by the layout of its parent node, if the parent
+    node has a layout from the same layouter. Otherwise its offset is left
+    unchanged.
+
+Sizes of the child nodes are taken as they are, which means the node sizes can
+be for example calculated from @ref TextLayer::size() for nodes containing
+text, and with @ref FlexLayoutFlag::FitContent the container then grows to
+fit them. Nested containers with @ref FlexLayoutFlag::FitContent are measured
+from the innermost ones outwards, they're all calculated in a single pass.
+
+Left, top, right and bottom @ref padding() is applied inside each container
+and the horizontal and vertical @ref gap() between neighboring child nodes and
+wrapped lines.
+
+Only layouts passed to @ref AbstractLayouter::update() are processed, so if
+only a part of the node hierarchy changes, only containers in the hierarchies
+containing the change are recalculated.
+@see @ref SnapLayouter
+*/
+class MAGNUM_UI_EXPORT FlexLayouter: public AbstractLayouter {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle    Layouter handle returned from
+         *      @ref AbstractUserInterface::createLayouter()
+         */
+        explicit FlexLayouter(LayouterHandle handle);
+
+        /** @brief Copying is not allowed */
+        FlexLayouter(const FlexLayouter&) = delete;
+
+        /**
+         * @brief Move constructor
+         *
+         * Performs a destructive move, i.e. the original object isn't usable
+         * afterwards anymore.
+         */
+        FlexLayouter(FlexLayouter&&) noexcept;
+
+        virtual ~FlexLayouter();
+
+        /** @brief Copying is not allowed */
+        FlexLayouter& operator=(const FlexLayouter&) = delete;
+
+        /** @brief Move assignment */
+        FlexLayouter& operator=(FlexLayouter&&) noexcept;
+
+        /** @brief Left, top, right and bottom padding inside a container */
+        Vector4 padding() const;
+
+        /**
+         * @brief Set different left, top, right and bottom padding inside a container
+         * @return Reference to self (for method chaining)
+         *
+         * The padding is applied between the container node edges and its
+         * child nodes. Initial value is @cpp 0.0f @ce on all sides.
+         *
+         * Calling this function causes @ref LayouterState::NeedsUpdate to be
+         * set.
+         * @see @ref setGap()
+         */
+        FlexLayouter& setPadding(const Vector4& padding);
+
+        /**
+         * @brief Set different horizontal and vertical padding inside a container
+         * @return Reference to self (for method chaining)
+         *
+         * Same as calling @ref setPadding(const Vector4&) with the
+         * horizontal and vertical value specified for both sides.
+         */
+        FlexLayouter& setPadding(const Vector2& padding);
+
+        /**
+         * @brief Set padding inside a container
+         * @return Reference to self (for method chaining)
+         *
+         * Same as calling @ref setPadding(const Vector4&) with the value
+         * specified for all sides.
+         */
+        FlexLayouter& setPadding(Float padding);
+
+        /** @brief Horizontal and vertical gap between child nodes and lines */
+        Vector2 gap() const;
+
+        /**
+         * @brief Set different horizontal and vertical gap between child nodes and lines
+         * @return Reference to self (for method chaining)
+         *
+         * The main-axis gap is applied between neighboring child nodes, the
+         * cross-axis gap between lines if @ref FlexLayoutFlag::Wrap is set.
+         * Initial value is @cpp 0.0f @ce in both directions.
+         *
+         * Calling this function causes @ref LayouterState::NeedsUpdate to be
+         * set.
+         * @see @ref setPadding()
+         */
+        FlexLayouter& setGap(const Vector2& gap);
+
+        /**
+         * @brief Set gap between child nodes and lines
+         * @return Reference to self (for method chaining)
+         *
+         * Same as calling @ref setGap(const Vector2&) with the value
+         * specified for both directions.
+         */
+        FlexLayouter& setGap(Float gap);
+
+        /**
+         * @brief Add a layout
+         * @param node          Node to assign the layout to
+         * @param direction     Direction in which child layouts are placed
+         * @param alignment     Cross-axis alignment of child layouts
+         * @param flags         Flags
+         *
+         * Expects that @p node isn't @ref NodeHandle::Null. Child layouts of
+         * @p node are then placed in the order they were added. Delegates to
+         * @ref AbstractLayouter::add(), see its documentation for more
+         * information.
+         * @see @ref remove()
+         */
+        LayoutHandle add(NodeHandle node, FlexDirection direction = FlexDirection::Row, FlexAlignment alignment = FlexAlignment::Start, FlexLayoutFlags flags = {});
+
+        /**
+         * @brief Remove a layout
+         *
+         * Delegates to @ref AbstractLayouter::remove(LayoutHandle).
+         */
+        void remove(LayoutHandle handle) {
+            AbstractLayouter::remove(handle);
+        }
+
+        /**
+         * @brief Remove a layout assuming it belongs to this layouter
+         *
+         * Delegates to @ref AbstractLayouter::remove(LayouterDataHandle).
+         */
+        void remove(LayouterDataHandle handle) {
+            AbstractLayouter::remove(handle);
+        }
+
+        /**
+         * @brief Layout direction
+         *
+         * Expects that @p handle is valid.
+         * @see @ref isHandleValid(LayoutHandle) const
+         */
+        FlexDirection direction(LayoutHandle handle) const;
+
+        /**
+         * @brief Layout direction assuming it belongs to this layouter
+         *
+         * Like @ref direction(LayoutHandle) const but without checking that
+         * @p handle indeed belongs to this layouter. See its documentation for
+         * more information.
+         */
+        FlexDirection direction(LayouterDataHandle handle) const;
+
+        /**
+         * @brief Set layout direction
+         *
+         * Expects that @p handle is valid. Calling this function causes
+         * @ref LayouterState::NeedsUpdate to be set.
+         * @see @ref isHandleValid(LayoutHandle) const
+         */
+        void setDirection(LayoutHandle handle, FlexDirection direction);
+
+        /**
+         * @brief Set layout direction assuming it belongs to this layouter
+         *
+         * Like @ref setDirection(LayoutHandle, FlexDirection) but without
+         * checking that @p handle indeed belongs to this layouter. See its
+         * documentation for more information.
+         */
+        void setDirection(LayouterDataHandle handle, FlexDirection direction);
+
+        /**
+         * @brief Layout cross-axis alignment
+         *
+         * Expects that @p handle is valid.
+         * @see @ref isHandleValid(LayoutHandle) const
+         */
+        FlexAlignment alignment(LayoutHandle handle) const;
+
+        /**
+         * @brief Layout cross-axis alignment assuming it belongs to this layouter
+         *
+         * Like @ref alignment(LayoutHandle) const but without checking that
+         * @p handle indeed belongs to this layouter. See its documentation for
+         * more information.
+         */
+        FlexAlignment alignment(LayouterDataHandle handle) const;
+
+        /**
+         * @brief Set layout cross-axis alignment
+         *
+         * Expects that @p handle is valid. Calling this function causes
+         * @ref LayouterState::NeedsUpdate to be set.
+         * @see @ref isHandleValid(LayoutHandle) const
+         */
+        void setAlignment(LayoutHandle handle, FlexAlignment alignment);
+
+        /**
+         * @brief Set layout cross-axis alignment assuming it belongs to this layouter
+         *
+         * Like @ref setAlignment(LayoutHandle, FlexAlignment) but without
+         * checking that @p handle indeed belongs to this layouter. See its
+         * documentation for more information.
+         */
+        void setAlignment(LayouterDataHandle handle, FlexAlignment alignment);
+
+        /**
+         * @brief Layout flags
+         *
+         * Expects that @p handle is valid.
+         * @see @ref isHandleValid(LayoutHandle) const
+         */
+        FlexLayoutFlags flags(LayoutHandle handle) const;
+
+        /**
+         * @brief Layout flags assuming it belongs to this layouter
+         *
+         * Like @ref flags(LayoutHandle) const but without checking that
+         * @p handle indeed belongs to this layouter. See its documentation for
+         * more information.
+         */
+        FlexLayoutFlags flags(LayouterDataHandle handle) const;
+
+        /**
+         * @brief Set layout flags
+         *
+         * Expects that @p handle is valid. Calling this function causes
+         * @ref LayouterState::NeedsUpdate to be set.
+         * @see @ref isHandleValid(LayoutHandle) const
+         */
+        void setFlags(LayoutHandle handle, FlexLayoutFlags flags);
+
+        /**
+         * @brief Set layout flags assuming it belongs to this layouter
+         *
+         * Like @ref setFlags(LayoutHandle, FlexLayoutFlags) but without
+         * checking that @p handle indeed belongs to this layouter. See its
+         * documentation for more information.
+         */
+        void setFlags(LayouterDataHandle handle, FlexLayoutFlags flags);
+
+    private:
+        MAGNUM_UI_LOCAL void doUpdate(Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>& topLevelLayoutIds, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) override;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -33,6 +33,7 @@
 #include <Magnum/Math/Time.h>
 
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
 
 namespace Magnum { namespace Ui {
 
@@ -111,24 +112,21 @@ auto GenericAnimator::easing(const AnimatorDataHandle handle) const -> Float(*)(
 
 AnimatorFeatures GenericAnimator::doFeatures() const { return {}; }
 
+void GenericAnimator::doReserve(const std::size_t capacity) {
+    arrayReserve(static_cast<State&>(*_state).animations, capacity);
+}
+
 void GenericAnimator::doClean(const Containers::BitArrayView animationIdsToRemove) {
-    /** @todo some way to iterate bits */
-    for(std::size_t i = 0; i != animationIdsToRemove.size(); ++i) {
-        if(!animationIdsToRemove[i])
-            continue;
+    Implementation::forEachSetBit(animationIdsToRemove, [&](const std::size_t i) {
         removeInternal(i);
-    }
+    });
 }
 
 void GenericAnimator::doAdvance(const Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) {
     State& state = static_cast<State&>(*_state);
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != active.size(); ++i) {
-        if(!active[i])
-            continue;
-
+    Implementation::forEachSetBit(active, [&](const std::size_t i) {
         state.animations[i].animation(factors[i]);
-    }
+    });
 }
 
 struct AnimationNode {
@@ -208,25 +206,22 @@ AnimatorFeatures GenericNodeAnimator::doFeatures() const {
     return AnimatorFeature::NodeAttachment;
 }
 
+void GenericNodeAnimator::doReserve(const std::size_t capacity) {
+    arrayReserve(static_cast<State&>(*_state).animations, capacity);
+}
+
 void GenericNodeAnimator::doClean(const Containers::BitArrayView animationIdsToRemove) {
-    /** @todo some way to iterate bits */
-    for(std::size_t i = 0; i != animationIdsToRemove.size(); ++i) {
-        if(!animationIdsToRemove[i])
-            continue;
+    Implementation::forEachSetBit(animationIdsToRemove, [&](const std::size_t i) {
         removeInternal(i);
-    }
+    });
 }
 
 void GenericNodeAnimator::doAdvance(const Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) {
     const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
     State& state = static_cast<State&>(*_state);
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != active.size(); ++i) {
-        if(!active[i])
-            continue;
-
+    Implementation::forEachSetBit(active, [&](const std::size_t i) {
         state.animations[i].animation(nodes[i], factors[i]);
-    }
+    });
 }
 
 struct AnimationData {
@@ -315,30 +310,93 @@ AnimatorFeatures GenericDataAnimator::doFeatures() const {
     return AnimatorFeature::DataAttachment;
 }
 
+void GenericDataAnimator::doReserve(const std::size_t capacity) {
+    arrayReserve(static_cast<State&>(*_state).animations, capacity);
+}
+
 void GenericDataAnimator::doClean(const Containers::BitArrayView animationIdsToRemove) {
-    /** @todo some way to iterate bits */
-    for(std::size_t i = 0; i != animationIdsToRemove.size(); ++i) {
-        if(!animationIdsToRemove[i])
-            continue;
+    Implementation::forEachSetBit(animationIdsToRemove, [&](const std::size_t i) {
         removeInternal(i);
-    }
+    });
 }
 
 void GenericDataAnimator::doAdvance(const Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) {
     const Containers::StridedArrayView1D<const LayerDataHandle> layerData = this->layerData();
     State& state = static_cast<State&>(*_state);
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != active.size(); ++i) {
-        if(!active[i])
-            continue;
-
+    Implementation::forEachSetBit(active, [&](const std::size_t i) {
         /* If not associated with any data, pass a null instead of combining it
            with the layer handle */
         state.animations[i].animation(
             layerData[i] == LayerDataHandle::Null ?
                 DataHandle::Null : dataHandle(layer(), layerData[i]),
             factors[i]);
-    }
+    });
+}
+
+struct GenericBatchAnimator::State {
+    Containers::Function<void(Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&, const Containers::StridedArrayView1D<const UnsignedInt>&)> animation;
+    Containers::Array<UnsignedInt> payloads;
+};
+
+GenericBatchAnimator::GenericBatchAnimator(AnimatorHandle handle, Containers::Function<void(Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&, const Containers::StridedArrayView1D<const UnsignedInt>&)>&& animation): AbstractGenericAnimator{handle}, _state{InPlaceInit} {
+    CORRADE_ASSERT(animation,
+        "Ui::GenericBatchAnimator: animation is null", );
+    _state->animation = Utility::move(animation);
+}
+
+GenericBatchAnimator::GenericBatchAnimator(GenericBatchAnimator&&) noexcept = default;
+
+GenericBatchAnimator::~GenericBatchAnimator() = default;
+
+GenericBatchAnimator& GenericBatchAnimator::operator=(GenericBatchAnimator&&) noexcept = default;
+
+AnimationHandle GenericBatchAnimator::create(const Nanoseconds played, const Nanoseconds duration, const UnsignedInt payload, const UnsignedInt repeatCount, const AnimationFlags flags) {
+    State& state = *_state;
+    const AnimationHandle handle = AbstractGenericAnimator::create(played, duration, repeatCount, flags);
+    const UnsignedInt id = animationHandleId(handle);
+    /* The payload array is kept at the same size as the animation storage so
+       the batch function can index it directly */
+    if(id >= state.payloads.size())
+        arrayResize(state.payloads, NoInit, capacity());
+
+    state.payloads[id] = payload;
+
+    return handle;
+}
+
+void GenericBatchAnimator::remove(const AnimationHandle handle) {
+    AbstractGenericAnimator::remove(handle);
+}
+
+void GenericBatchAnimator::remove(const AnimatorDataHandle handle) {
+    AbstractGenericAnimator::remove(handle);
+}
+
+UnsignedInt GenericBatchAnimator::payload(const AnimationHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::GenericBatchAnimator::payload(): invalid handle" << handle, {});
+    return _state->payloads[animationHandleId(handle)];
+}
+
+UnsignedInt GenericBatchAnimator::payload(const AnimatorDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::GenericBatchAnimator::payload(): invalid handle" << handle, {});
+    return _state->payloads[animatorDataHandleId(handle)];
+}
+
+Containers::StridedArrayView1D<const UnsignedInt> GenericBatchAnimator::payloads() const {
+    return _state->payloads;
+}
+
+AnimatorFeatures GenericBatchAnimator::doFeatures() const { return {}; }
+
+void GenericBatchAnimator::doReserve(const std::size_t capacity) {
+    arrayReserve(_state->payloads, capacity);
+}
+
+void GenericBatchAnimator::doAdvance(const Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) {
+    State& state = *_state;
+    state.animation(active, factors, state.payloads);
 }
 
 }}
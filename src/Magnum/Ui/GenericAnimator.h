@@ -27,7 +27,7 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Ui::GenericAnimator, @ref Magnum::Ui::GenericNodeAnimator, @ref Magnum::Ui::GenericDataAnimator
+ * @brief Class @ref Magnum::Ui::GenericAnimator, @ref Magnum::Ui::GenericNodeAnimator, @ref Magnum::Ui::GenericDataAnimator, @ref Magnum::Ui::GenericBatchAnimator
  * @m_since_latest
  */
 
@@ -191,6 +191,7 @@ class MAGNUM_UI_EXPORT GenericAnimator: public AbstractGenericAnimator {
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
 
         MAGNUM_UI_LOCAL AnimatorFeatures doFeatures() const override;
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
         MAGNUM_UI_LOCAL void doClean(Containers::BitArrayView animationIdsToRemove) override;
         MAGNUM_UI_LOCAL void doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) override;
 
@@ -359,6 +360,7 @@ class MAGNUM_UI_EXPORT GenericNodeAnimator: public AbstractGenericAnimator {
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
 
         MAGNUM_UI_LOCAL AnimatorFeatures doFeatures() const override;
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
         MAGNUM_UI_LOCAL void doClean(Containers::BitArrayView animationIdsToRemove) override;
         MAGNUM_UI_LOCAL void doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) override;
 
@@ -557,6 +559,7 @@ class MAGNUM_UI_EXPORT GenericDataAnimator: public AbstractGenericAnimator {
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
 
         MAGNUM_UI_LOCAL AnimatorFeatures doFeatures() const override;
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
         MAGNUM_UI_LOCAL void doClean(Containers::BitArrayView animationIdsToRemove) override;
         MAGNUM_UI_LOCAL void doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) override;
 
@@ -564,6 +567,147 @@ class MAGNUM_UI_EXPORT GenericDataAnimator: public AbstractGenericAnimator {
         Containers::Pointer<State> _state;
 };
 
+/**
+@brief Generic animator processing all animations in a single batch
+@m_since_latest
+
+Compared to @ref GenericAnimator, which calls a dedicated function for each
+active animation, this animator has a single function that gets called with
+all active animations at once. Useful for a large amount of animations of the
+same kind, such as progress bars or loading indicators, where a per-animation
+indirect call and scattered captured state would be a bottleneck. The
+function can then go through all active animations in a single, potentially
+vectorized, loop.
+
+@section Ui-GenericBatchAnimator-setup Setting up an animator instance
+
+The animator is constructed from a fresh
+@ref AbstractUserInterface::createAnimator() handle and the batch function,
+and passed to @relativeref{AbstractUserInterface,setGenericAnimatorInstance()}.
+The function receives a mask of active animations, their factors in the
+@f$ [0, 1] @f$ range and a payload for each, all indexed by the animation ID:
+
+@snippet Ui.cpp GenericBatchAnimator-setup
+
+The factors are passed without any easing, if desired, the function is
+expected to apply it on its own. Similarly to @ref GenericAnimator, the
+function is free to do anything except for touching state related to the
+animations themselves.
+
+@section Ui-GenericBatchAnimator-create Creating animations
+
+An animation is created by calling @ref create() with a time at which it's
+meant to be played, its duration and a payload. The payload is an arbitrary
+user-defined value, such as an index into an array of progress bars the
+animation should affect. As animation IDs get recycled in an unspecified
+order, the payload is a more robust way to refer to external data than the
+animation ID itself.
+
+@snippet Ui.cpp GenericBatchAnimator-create
+
+As with all other animations, they're implicitly removed once they're played.
+Pass @ref AnimationFlag::KeepOncePlayed to @ref create() or @ref addFlags() to
+disable this behavior.
+*/
+class MAGNUM_UI_EXPORT GenericBatchAnimator: public AbstractGenericAnimator {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle    Handle returned by
+         *      @ref AbstractUserInterface::createAnimator()
+         * @param animation Batch animation function
+         *
+         * The @p animation is called with a mask of active animations, their
+         * factors and payloads, all three having the size of @ref capacity()
+         * and indexed by the animation ID. Values of factors and payloads for
+         * animations that aren't active are unspecified. Expects that
+         * @p animation is not @cpp nullptr @ce.
+         */
+        explicit GenericBatchAnimator(AnimatorHandle handle, Containers::Function<void(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::StridedArrayView1D<const UnsignedInt>& payloads)>&& animation);
+
+        /** @brief Copying is not allowed */
+        GenericBatchAnimator(const GenericBatchAnimator&) = delete;
+
+        /** @copydoc AbstractAnimator::AbstractAnimator(AbstractAnimator&&) */
+        GenericBatchAnimator(GenericBatchAnimator&&) noexcept;
+
+        ~GenericBatchAnimator();
+
+        /** @brief Copying is not allowed */
+        GenericBatchAnimator& operator=(const GenericBatchAnimator&) = delete;
+
+        /** @brief Move assignment */
+        GenericBatchAnimator& operator=(GenericBatchAnimator&&) noexcept;
+
+        /**
+         * @brief Create an animation
+         * @param played        Time at which the animation is played. Use
+         *      @ref Nanoseconds::max() for creating a stopped animation.
+         * @param duration      Duration of a single play of the animation
+         * @param payload       Payload passed to the batch animation function
+         * @param repeatCount   Repeat count. Use @cpp 0 @ce for an
+         *      indefinitely repeating animation.
+         * @param flags         Flags
+         *
+         * Delegates to @ref AbstractAnimator::create(Nanoseconds, Nanoseconds, UnsignedInt, AnimationFlags),
+         * see its documentation for more information. The batch animation
+         * function is guaranteed to be called with the factor being exactly
+         * @cpp 1.0f @ce once the animation is stopped.
+         */
+        AnimationHandle create(Nanoseconds played, Nanoseconds duration, UnsignedInt payload, UnsignedInt repeatCount = 1, AnimationFlags flags = {});
+
+        /**
+         * @brief Remove an animation
+         *
+         * Expects that @p handle is valid. Delegates to
+         * @ref AbstractAnimator::remove(AnimationHandle), see its
+         * documentation for more information.
+         */
+        void remove(AnimationHandle handle);
+
+        /**
+         * @brief Remove an animation assuming it belongs to this animator
+         *
+         * Compared to @ref remove(AnimationHandle) delegates to
+         * @ref AbstractAnimator::remove(AnimatorDataHandle) instead.
+         */
+        void remove(AnimatorDataHandle handle);
+
+        /**
+         * @brief Animation payload
+         *
+         * Expects that @p handle is valid.
+         * @see @ref payloads()
+         */
+        UnsignedInt payload(AnimationHandle handle) const;
+
+        /**
+         * @brief Animation payload assuming it belongs to this animator
+         *
+         * Like @ref payload(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator. See its documentation for
+         * more information.
+         * @see @ref animationHandleData()
+         */
+        UnsignedInt payload(AnimatorDataHandle handle) const;
+
+        /**
+         * @brief Animation payloads
+         *
+         * Size of the returned view is @ref capacity(). Items that are free
+         * have unspecified values.
+         */
+        Containers::StridedArrayView1D<const UnsignedInt> payloads() const;
+
+    private:
+        MAGNUM_UI_LOCAL AnimatorFeatures doFeatures() const override;
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
+        MAGNUM_UI_LOCAL void doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) override;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
 }}
 
 #endif
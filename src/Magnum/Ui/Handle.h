@@ -301,8 +301,8 @@ constexpr UnsignedInt dataHandleGeneration(DataHandle handle) {
 
 namespace Implementation {
     enum: UnsignedInt {
-        NodeHandleIdBits = 20,
-        NodeHandleGenerationBits = 12
+        NodeHandleIdBits = 32 - MAGNUM_UI_NODE_HANDLE_GENERATION_BITS,
+        NodeHandleGenerationBits = MAGNUM_UI_NODE_HANDLE_GENERATION_BITS
     };
 }
 
@@ -310,7 +310,12 @@ namespace Implementation {
 @brief Node handle
 @m_since_latest
 
-Uses 20 bits for storing an ID and 12 bits for a generation.
+By default uses 20 bits for storing an ID and 12 bits for a generation. The
+`MAGNUM_UI_NODE_HANDLE_GENERATION_BITS` CMake option can be used to trade the
+ID bits for up to 15 bits of generation, which makes it possible to recycle
+each node slot up to 32767 times instead of 4095 before its handle gets
+disabled, at the cost of the max node count going down from 1048576 to 131072.
+The handle size stays the same.
 @see @ref AbstractUserInterface::createNode(),
     @ref AbstractUserInterface::removeNode(), @ref nodeHandle(),
     @ref nodeHandleId(), @ref nodeHandleGeneration()
@@ -329,8 +334,10 @@ MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, NodeHandle value);
 @brief Compose a node handle from an ID and a generation
 @m_since_latest
 
-Expects that the ID fits into 20 bits and the generation into 12 bits. Use
-@ref nodeHandleId() and @ref nodeHandleGeneration() for an inverse operation.
+Expects that the ID fits into 20 bits and the generation into 12 bits, or
+other split if configured differently, see @ref NodeHandle for more
+information. Use @ref nodeHandleId() and @ref nodeHandleGeneration() for an
+inverse operation.
 */
 constexpr NodeHandle nodeHandle(UnsignedInt id, UnsignedInt generation) {
     return (CORRADE_CONSTEXPR_DEBUG_ASSERT(id < (1 << Implementation::NodeHandleIdBits) && generation < (1 << Implementation::NodeHandleGenerationBits),
@@ -26,10 +26,10 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-#include <Magnum/GL/AbstractShaderProgram.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/Math/Vector2.h>
 
+#include "Magnum/Ui/Implementation/asyncShaderProgramGL.h"
 #include "Magnum/Ui/visibility.h"
 
 /* Extracted out of BaseLayerGL for easier testing and benchmarking. The
@@ -43,7 +43,7 @@ class
 #ifdef CORRADE_GRACEFUL_ASSERT
 MAGNUM_UI_EXPORT
 #endif
-BlurShaderGL: public GL::AbstractShaderProgram {
+BlurShaderGL: public Implementation::AsyncShaderProgramGL {
     private:
         enum: Int {
             /* Using a texture binding hopefully different from all others to
@@ -57,18 +57,28 @@ BlurShaderGL: public GL::AbstractShaderProgram {
     public:
         typedef GL::Attribute<0, Vector2> Position;
 
-        explicit BlurShaderGL(NoCreateT): GL::AbstractShaderProgram{NoCreate} {}
+        explicit BlurShaderGL(NoCreateT): Implementation::AsyncShaderProgramGL{NoCreate} {}
         explicit BlurShaderGL(UnsignedInt radius, Float limit);
 
+        /* Waits for the compilation submitted in the constructor to finish
+           and performs the post-link setup. Called implicitly from all
+           setters except setProjection(), which gets applied here if it was
+           called before. */
+        void finish();
+
         BlurShaderGL& setProjection(const Vector2& scaling) {
             /* Y-flipped scale from the UI size to the 2x2 unit square, the
                shader then translates by (-1, 1) on its own to put the
                origin at center */
-            setUniform(_projectionUniform, Vector2{2.0f, -2.0f}/scaling);
+            _projection = Vector2{2.0f, -2.0f}/scaling;
+            /* If the shader is still compiling, it's set in finish() */
+            if(!isCompilePending())
+                setUniform(_projectionUniform, _projection);
             return *this;
         }
 
         BlurShaderGL& setDirection(const Vector2& direction) {
+            finish();
             /* If we check just the center pixel, the direction isn't used by
                the shader at all */
             if(_sampleCount != 1)
@@ -77,6 +87,7 @@ BlurShaderGL: public GL::AbstractShaderProgram {
         }
 
         BlurShaderGL& bindTexture(GL::Texture2D& texture) {
+            finish();
             texture.bind(TextureBinding);
             return *this;
         }
@@ -85,6 +96,7 @@ BlurShaderGL: public GL::AbstractShaderProgram {
         UnsignedInt _sampleCount;
         Int _projectionUniform = 0,
             _directionUniform = 1;
+        Vector2 _projection;
 };
 
 }}
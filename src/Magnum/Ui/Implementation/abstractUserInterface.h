@@ -35,10 +35,12 @@
 #include <Corrade/Utility/Algorithms.h>
 #include <Magnum/Magnum.h>
 #include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
 
 #include "Magnum/Ui/AbstractAnimator.h" /* AnimatorFeatures */
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/NodeFlags.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
 
 /* Contains algorithms used internally in AbstractUserInterface.cpp. Extracted
    here for easier testing and ability to iterate on them in isolation without
@@ -46,6 +48,52 @@
 
 namespace Magnum { namespace Ui { namespace Implementation { namespace {
 
+/* Adds a visible top-level node with ID `topLevelId` and all its visible
+   children to `visibleNodeIds` and `visibleNodeChildrenCounts` at
+   `outputOffset`, returning the offset after. Used by
+   orderVisibleNodesDepthFirstInto() and
+   orderVisibleNodesDepthFirstIncrementalInto() below. */
+UnsignedInt orderVisibleTopLevelNodeDepthFirstInto(const UnsignedInt topLevelId, const Containers::StridedArrayView1D<const NodeFlags>& nodeFlags, const Containers::ArrayView<const UnsignedInt> childrenOffsets, const Containers::ArrayView<const UnsignedInt> children, const Containers::MutableBitArrayView visibleNodes, const Containers::ArrayView<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> parentsToProcess, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeChildrenCounts, UnsignedInt outputOffset) {
+    /* Add the top-level node to the output, mark it as visible, and to the
+       list of parents to process next */
+    std::size_t parentsToProcessOffset = 0;
+    visibleNodeIds[outputOffset] = topLevelId;
+    visibleNodes.set(topLevelId);
+    parentsToProcess[parentsToProcessOffset++] = {topLevelId, outputOffset++, childrenOffsets[topLevelId]};
+
+    while(parentsToProcessOffset) {
+        const UnsignedInt id = parentsToProcess[parentsToProcessOffset - 1].first();
+        UnsignedInt& childrenOffset = parentsToProcess[parentsToProcessOffset - 1].third();
+
+        /* If all children were processed, we're done with this node */
+        if(childrenOffset == childrenOffsets[id + 1]) {
+            /* Save the total size */
+            const UnsignedInt firstChildOutputOffset = parentsToProcess[parentsToProcessOffset - 1].second();
+            visibleNodeChildrenCounts[firstChildOutputOffset] = outputOffset - firstChildOutputOffset - 1;
+
+            /* Remove from the processing stack and continue with next */
+            --parentsToProcessOffset;
+            continue;
+        }
+
+        CORRADE_INTERNAL_DEBUG_ASSERT(childrenOffset < childrenOffsets[id + 1]);
+
+        /* Unless the current child is hidden, add it to the output, mark it
+           as visible, and to the list of parents to process next. Increment
+           all offsets for the next round. */
+        const UnsignedInt childId = children[childrenOffset];
+        if(!(nodeFlags[childId] & NodeFlag::Hidden)) {
+            visibleNodeIds[outputOffset] = childId;
+            visibleNodes.set(childId);
+            parentsToProcess[parentsToProcessOffset++] = {childId, outputOffset++, childrenOffsets[childId]};
+        }
+
+        ++childrenOffset;
+    }
+
+    return outputOffset;
+}
+
 /* The `visibleNodeIds` and `visibleNodeChildrenCounts` arrays get filled with
    visible node IDs and the count of their children in the following order,
    with the returned value being the size of the prefix filled:
@@ -54,9 +102,14 @@ namespace Magnum { namespace Ui { namespace Implementation { namespace {
         `visibleNodeIds` array in a depth-first order, with the count stored in
         the corresponding item of the `visibleNodeChildrenCounts` array
 
-   The `visibleNodes`, `childrenOffsets`, `children` and `parentsToProcess`
-   arrays are temporary storage. The `visibleNodes` and `childrenOffsets`
-   arrays have to be zero-initialized. Other outputs don't need to be. */
+   The `childrenOffsets` and `children` arrays get filled with a list of
+   children for each node, excluding top-level nodes, and if `firstNodeOrder`
+   isn't null can be subsequently passed to
+   orderVisibleNodesDepthFirstIncrementalInto() as long as no nodes are added,
+   removed, made top-level or flattened. The `visibleNodes` and
+   `parentsToProcess` arrays are temporary storage. The `visibleNodes` and
+   `childrenOffsets` arrays have to be zero-initialized. Other outputs don't
+   need to be. */
 std::size_t orderVisibleNodesDepthFirstInto(const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<const UnsignedInt>& nodeOrder, const Containers::StridedArrayView1D<const NodeFlags>& nodeFlags, const Containers::StridedArrayView1D<const NodeHandle>& nodeOrderNext, const NodeHandle firstNodeOrder, const Containers::MutableBitArrayView visibleNodes, const Containers::ArrayView<UnsignedInt> childrenOffsets, const Containers::ArrayView<UnsignedInt> children, const Containers::ArrayView<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> parentsToProcess, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeChildrenCounts) {
     CORRADE_INTERNAL_ASSERT(
         nodeOrder.size() == nodeParents.size() &&
@@ -71,7 +124,7 @@ std::size_t orderVisibleNodesDepthFirstInto(const Containers::StridedArrayView1D
         visibleNodeChildrenCounts.size() == nodeParents.size());
 
     /* If there are no top-level nodes, nothing is visible and thus nothing to
-       do */
+       do. The children lists aren't filled in this case either. */
     if(firstNodeOrder == NodeHandle::Null)
         return 0;
 
@@ -127,47 +180,8 @@ std::size_t orderVisibleNodesDepthFirstInto(const Containers::StridedArrayView1D
                nodes being always ordered after their parents, otherwise the
                visibleNodes mask won't be updated for those yet. */
             const UnsignedInt topLevelId = nodeHandleId(topLevel);
-            if(!(nodeFlags[topLevelId] & NodeFlag::Hidden) && (nodeParents[topLevelId] == NodeHandle::Null || visibleNodes[nodeHandleId(nodeParents[topLevelId])])) {
-                /* Add the top-level node to the output, mark it as visible,
-                   and to the list of parents to process next */
-                std::size_t parentsToProcessOffset = 0;
-                visibleNodeIds[outputOffset] = topLevelId;
-                visibleNodes.set(topLevelId);
-                parentsToProcess[parentsToProcessOffset++] = {topLevelId, outputOffset++, childrenOffsets[topLevelId]};
-
-                while(parentsToProcessOffset) {
-                    const UnsignedInt id = parentsToProcess[parentsToProcessOffset - 1].first();
-                    UnsignedInt& childrenOffset = parentsToProcess[parentsToProcessOffset - 1].third();
-
-                    /* If all children were processed, we're done with this
-                       node */
-                    if(childrenOffset == childrenOffsets[id + 1]) {
-                        /* Save the total size */
-                        const UnsignedInt firstChildOutputOffset = parentsToProcess[parentsToProcessOffset - 1].second();
-                        visibleNodeChildrenCounts[firstChildOutputOffset] = outputOffset - firstChildOutputOffset - 1;
-
-                        /* Remove from the processing stack and continue with
-                           next */
-                        --parentsToProcessOffset;
-                        continue;
-                    }
-
-                    CORRADE_INTERNAL_DEBUG_ASSERT(childrenOffset < childrenOffsets[id + 1]);
-
-                    /* Unless the current child is hidden, add it to the
-                       output, mark it as visible, and to the list of parents
-                       to process next. Increment all offsets for the next
-                       round. */
-                    const UnsignedInt childId = children[childrenOffset];
-                    if(!(nodeFlags[childId] & NodeFlag::Hidden)) {
-                        visibleNodeIds[outputOffset] = childId;
-                        visibleNodes.set(childId);
-                        parentsToProcess[parentsToProcessOffset++] = {childId, outputOffset++, childrenOffsets[childId]};
-                    }
-
-                    ++childrenOffset;
-                }
-            }
+            if(!(nodeFlags[topLevelId] & NodeFlag::Hidden) && (nodeParents[topLevelId] == NodeHandle::Null || visibleNodes[nodeHandleId(nodeParents[topLevelId])]))
+                outputOffset = orderVisibleTopLevelNodeDepthFirstInto(topLevelId, nodeFlags, childrenOffsets, children, visibleNodes, parentsToProcess, visibleNodeIds, visibleNodeChildrenCounts, outputOffset);
 
             CORRADE_INTERNAL_DEBUG_ASSERT(nodeOrder[topLevelId] != ~UnsignedInt{});
             topLevel = nodeOrderNext[nodeOrder[topLevelId]];
@@ -178,6 +192,88 @@ std::size_t orderVisibleNodesDepthFirstInto(const Containers::StridedArrayView1D
     return outputOffset;
 }
 
+/* Incremental variant of orderVisibleNodesDepthFirstInto(). The
+   `childrenOffsets` and `children` arrays are expected to be filled by a
+   previous orderVisibleNodesDepthFirstInto() call, with no nodes added,
+   removed, made top-level or flattened since, and `previousVisibleNodeIds`
+   with `previousVisibleNodeChildrenCounts` are expected to be a copy of the
+   output of the previous orderVisibleNodesDepthFirstInto() or
+   orderVisibleNodesDepthFirstIncrementalInto() call.
+
+   Top-level nodes marked in `dirtyTopLevelNodes` and top-level nodes that
+   weren't visible before get their hierarchy ordered again, visible node
+   ranges of all other visible top-level nodes are copied from the previous
+   output in the new top-level node order. Thus, showing or hiding a node
+   affects only its closest top-level node, and reordering top-level nodes
+   doesn't cause any node hierarchy to be ordered again.
+
+   The `visibleNodes`, `previousTopLevelNodes`, `previousTopLevelNodeIndices`
+   and `parentsToProcess` arrays are temporary storage. The `visibleNodes` and
+   `previousTopLevelNodes` arrays have to be zero-initialized. Other outputs
+   don't need to be. */
+std::size_t orderVisibleNodesDepthFirstIncrementalInto(const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<const UnsignedInt>& nodeOrder, const Containers::StridedArrayView1D<const NodeFlags>& nodeFlags, const Containers::StridedArrayView1D<const NodeHandle>& nodeOrderNext, const NodeHandle firstNodeOrder, const Containers::BitArrayView dirtyTopLevelNodes, const Containers::ArrayView<const UnsignedInt> childrenOffsets, const Containers::ArrayView<const UnsignedInt> children, const Containers::StridedArrayView1D<const UnsignedInt>& previousVisibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& previousVisibleNodeChildrenCounts, const Containers::MutableBitArrayView visibleNodes, const Containers::MutableBitArrayView previousTopLevelNodes, const Containers::ArrayView<UnsignedInt> previousTopLevelNodeIndices, const Containers::ArrayView<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> parentsToProcess, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeChildrenCounts) {
+    CORRADE_INTERNAL_ASSERT(
+        nodeOrder.size() == nodeParents.size() &&
+        nodeFlags.size() == nodeParents.size() &&
+        dirtyTopLevelNodes.size() == nodeParents.size() &&
+        childrenOffsets.size() == nodeParents.size() + 1 &&
+        children.size() == nodeParents.size() &&
+        previousVisibleNodeChildrenCounts.size() == previousVisibleNodeIds.size() &&
+        visibleNodes.size() == nodeParents.size() &&
+        previousTopLevelNodes.size() == nodeParents.size() &&
+        previousTopLevelNodeIndices.size() == nodeParents.size() &&
+        parentsToProcess.size() == nodeParents.size() &&
+        visibleNodeIds.size() == nodeParents.size() &&
+        visibleNodeChildrenCounts.size() == nodeParents.size());
+
+    /* If there are no top-level nodes, nothing is visible and thus nothing to
+       do */
+    if(firstNodeOrder == NodeHandle::Null)
+        return 0;
+
+    /* Remember where each previously visible top-level node was in the
+       previous output. The top-level nodes are at the start of each range. */
+    for(UnsignedInt i = 0; i != previousVisibleNodeIds.size(); i += previousVisibleNodeChildrenCounts[i] + 1) {
+        const UnsignedInt id = previousVisibleNodeIds[i];
+        previousTopLevelNodes.set(id);
+        previousTopLevelNodeIndices[id] = i;
+    }
+
+    UnsignedInt outputOffset = 0;
+
+    /* Go through the top-level node list. It's cyclic, so stop when reaching
+       the first node again. The visibility logic is the same as in
+       orderVisibleNodesDepthFirstInto(). */
+    NodeHandle topLevel = firstNodeOrder;
+    do {
+        const UnsignedInt topLevelId = nodeHandleId(topLevel);
+        if(!(nodeFlags[topLevelId] & NodeFlag::Hidden) && (nodeParents[topLevelId] == NodeHandle::Null || visibleNodes[nodeHandleId(nodeParents[topLevelId])])) {
+            /* If the hierarchy is unchanged and was visible before, copy the
+               previous range. The children counts are relative, so they can be
+               copied as-is as well. */
+            if(previousTopLevelNodes[topLevelId] && !dirtyTopLevelNodes[topLevelId]) {
+                const UnsignedInt previousOffset = previousTopLevelNodeIndices[topLevelId];
+                const UnsignedInt count = previousVisibleNodeChildrenCounts[previousOffset] + 1;
+                for(UnsignedInt i = 0; i != count; ++i) {
+                    const UnsignedInt id = previousVisibleNodeIds[previousOffset + i];
+                    visibleNodeIds[outputOffset + i] = id;
+                    visibleNodeChildrenCounts[outputOffset + i] = previousVisibleNodeChildrenCounts[previousOffset + i];
+                    visibleNodes.set(id);
+                }
+                outputOffset += count;
+
+            /* Otherwise order it again */
+            } else outputOffset = orderVisibleTopLevelNodeDepthFirstInto(topLevelId, nodeFlags, childrenOffsets, children, visibleNodes, parentsToProcess, visibleNodeIds, visibleNodeChildrenCounts, outputOffset);
+        }
+
+        CORRADE_INTERNAL_DEBUG_ASSERT(nodeOrder[topLevelId] != ~UnsignedInt{});
+        topLevel = nodeOrderNext[nodeOrder[topLevelId]];
+    } while(topLevel != firstNodeOrder);
+    CORRADE_INTERNAL_ASSERT(outputOffset <= nodeParents.size());
+
+    return outputOffset;
+}
+
 std::size_t visibleTopLevelNodeIndicesInto(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::StridedArrayView1D<UnsignedInt>& visibleTopLevelNodeIndices) {
     UnsignedInt offset = 0;
     for(UnsignedInt visibleTopLevelNodeIndex = 0; visibleTopLevelNodeIndex != visibleNodeChildrenCounts.size(); visibleTopLevelNodeIndex += visibleNodeChildrenCounts[visibleTopLevelNodeIndex] + 1)
@@ -505,18 +601,102 @@ void fillLayoutUpdateMasksInto(const Containers::StridedArrayView2D<const Layout
     }
 }
 
+/* Sets bits in `dirtyNodes` for all nodes in `visibleNodeIds` that are in a
+   hierarchy of a root node set in `dirtyRootNodes`, i.e. nodes which layouts
+   may be affected by an offset or size change of some node in given
+   hierarchy. Relies on parents being always listed before their children in
+   `visibleNodeIds`, which is the case for the output of
+   orderVisibleNodesDepthFirstInto(). The `dirtyNodes` array is expected to be
+   zero-initialized. Returns count of nodes that were marked. */
+std::size_t markDirtyLayoutNodesInto(const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::BitArrayView dirtyRootNodes, const Containers::MutableBitArrayView dirtyNodes) {
+    CORRADE_INTERNAL_ASSERT(
+        dirtyRootNodes.size() == nodeParents.size() &&
+        dirtyNodes.size() == nodeParents.size());
+
+    std::size_t count = 0;
+    for(const UnsignedInt id: visibleNodeIds) {
+        const NodeHandle parent = nodeParents[id];
+        if(parent == NodeHandle::Null ? dirtyRootNodes[id] : dirtyNodes[nodeHandleId(parent)]) {
+            dirtyNodes.set(id);
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/* Filters `mask` and `topLevelLayoutIds` of a single layouter update() run,
+   coming from fillLayoutUpdateMasksInto() and
+   discoverTopLevelLayoutNodesInto() above, to contain only layouts assigned
+   to nodes set in `dirtyNodes`. The `layoutNodes` are nodes the layouts of
+   given layouter are assigned to. The `filteredMask` is expected to be
+   zero-initialized and have the same size as `mask`, the
+   `filteredTopLevelLayoutIds` is expected to have the same size as
+   `topLevelLayoutIds`. Returns count of top-level layout IDs written to
+   `filteredTopLevelLayoutIds`. */
+std::size_t filterLayoutUpdateMaskInto(const Containers::BitArrayView mask, const Containers::StridedArrayView1D<const UnsignedInt>& topLevelLayoutIds, const Containers::StridedArrayView1D<const NodeHandle>& layoutNodes, const Containers::BitArrayView dirtyNodes, const Containers::MutableBitArrayView filteredMask, const Containers::StridedArrayView1D<UnsignedInt>& filteredTopLevelLayoutIds) {
+    CORRADE_INTERNAL_ASSERT(
+        layoutNodes.size() == mask.size() &&
+        filteredMask.size() == mask.size() &&
+        filteredTopLevelLayoutIds.size() == topLevelLayoutIds.size());
+
+    forEachSetBit(mask, [&](const std::size_t i) {
+        if(dirtyNodes[nodeHandleId(layoutNodes[i])])
+            filteredMask.set(i);
+    });
+
+    /* All layouts in a hierarchy under a top-level layout are assigned to
+       nodes in the same root node hierarchy, so it's enough to check just the
+       top-level layout itself */
+    std::size_t count = 0;
+    for(const UnsignedInt id: topLevelLayoutIds)
+        if(filteredMask[id])
+            filteredTopLevelLayoutIds[count++] = id;
+
+    return count;
+}
+
+/* Calculates a bounding rect of each visible node and all its children, in
+   the visible node order. Unlike Math::join(), the rects are joined also if
+   they have a zero area, as such nodes can still pass the clip test in
+   cullVisibleNodesInto(). The children are a contiguous range after their
+   parent, so going backwards means each node has all its children already
+   calculated and joins just the direct ones, making it O(n) overall. */
+void visibleSubtreeRectsInto(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<Range2D>& visibleSubtreeRects) {
+    CORRADE_INTERNAL_ASSERT(
+        visibleNodeChildrenCounts.size() == visibleNodeIds.size() &&
+        nodeSizes.size() == absoluteNodeOffsets.size() &&
+        visibleSubtreeRects.size() == visibleNodeIds.size());
+
+    for(std::size_t i = visibleNodeIds.size(); i != 0; --i) {
+        const std::size_t index = i - 1;
+        const UnsignedInt nodeId = visibleNodeIds[index];
+        Vector2 min = absoluteNodeOffsets[nodeId];
+        Vector2 max = min + nodeSizes[nodeId];
+        for(std::size_t child = index + 1, childEnd = index + visibleNodeChildrenCounts[index] + 1; child != childEnd; child += visibleNodeChildrenCounts[child] + 1) {
+            min = Math::min(min, visibleSubtreeRects[child].min());
+            max = Math::max(max, visibleSubtreeRects[child].max());
+        }
+        visibleSubtreeRects[index] = {min, max};
+    }
+}
+
 /* The `visibleNodeMask` has bits set for nodes in `visibleNodeIds` that are
    at least partially visible in the parent clip rects, the `clipRects` is then
    a list of clip rects and count of nodes affected by them.
 
-   The `clipStack` array is temporary storage. */
-UnsignedInt cullVisibleNodesInto(const Vector2& uiOffset, const Vector2& uiSize, const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const NodeFlags>& nodeFlags, const Containers::ArrayView<Containers::Triple<Vector2, Vector2, UnsignedInt>> clipStack, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::MutableBitArrayView visibleNodeMask, const Containers::StridedArrayView1D<Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<Vector2>& clipRectSizes, const Containers::StridedArrayView1D<UnsignedInt>& clipRectNodeCounts) {
+   The `clipStack` array is temporary storage. If `visibleSubtreeRects` is
+   non-empty, it's expected to be the output of `visibleSubtreeRectsInto()`
+   and is used to skip non-clipping subtrees that are fully outside of the
+   parent clip rect without testing each node in them. */
+UnsignedInt cullVisibleNodesInto(const Vector2& uiOffset, const Vector2& uiSize, const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const NodeFlags>& nodeFlags, const Containers::ArrayView<Containers::Triple<Vector2, Vector2, UnsignedInt>> clipStack, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::MutableBitArrayView visibleNodeMask, const Containers::StridedArrayView1D<Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<Vector2>& clipRectSizes, const Containers::StridedArrayView1D<UnsignedInt>& clipRectNodeCounts, const Containers::StridedArrayView1D<const Range2D>& visibleSubtreeRects = {}) {
     CORRADE_INTERNAL_ASSERT(
         nodeSizes.size() == absoluteNodeOffsets.size() &&
         nodeFlags.size() == absoluteNodeOffsets.size() &&
         /* One more item for the actual UI offset + size */
         clipStack.size() == visibleNodeIds.size() + 1 &&
         visibleNodeChildrenCounts.size() == visibleNodeIds.size() &&
+        (visibleSubtreeRects.isEmpty() || visibleSubtreeRects.size() == visibleNodeIds.size()) &&
         visibleNodeMask.size() == absoluteNodeOffsets.size() &&
         clipRectSizes.size() == clipRectOffsets.size() &&
         clipRectNodeCounts.size() == clipRectOffsets.size());
@@ -587,20 +767,31 @@ UnsignedInt cullVisibleNodesInto(const Vector2& uiOffset, const Vector2& uiSize,
                    Math::intersect() for Range. */
                 clipStack[clipStackDepth].first() = Math::max(parentMin, min);
                 clipStack[clipStackDepth].second() = Math::min(parentMax, max);
-
-                /* If the previous clip rect affected no nodes, replace it,
-                   otherwise move to the next one. */
-                if(clipRectNodeCounts[clipRectsOffset])
-                    ++clipRectsOffset;
-
-                /* Save the final clip rect to the output. Initially it affects
-                   just the clipping node itself. */
-                clipRectOffsets[clipRectsOffset] =
-                    clipStack[clipStackDepth].first();
-                clipRectSizes[clipRectsOffset] =
-                    clipStack[clipStackDepth].second() -
-                    clipStack[clipStackDepth].first();
-                clipRectNodeCounts[clipRectsOffset] = 1;
+                const Vector2 clipRectOffset = clipStack[clipStackDepth].first();
+                const Vector2 clipRectSize = clipStack[clipStackDepth].second() - clipRectOffset;
+
+                /* If the intersection is the same as the clip rect that's
+                   currently used, such as when the node is fully covering
+                   its parent clip rect, it doesn't clip anything extra.
+                   Continue with the current clip rect to not split the draw
+                   needlessly. */
+                if(clipRectNodeCounts[clipRectsOffset] &&
+                   clipRectOffsets[clipRectsOffset] == clipRectOffset &&
+                   clipRectSizes[clipRectsOffset] == clipRectSize) {
+                    ++clipRectNodeCounts[clipRectsOffset];
+
+                } else {
+                    /* If the previous clip rect affected no nodes, replace it,
+                       otherwise move to the next one. */
+                    if(clipRectNodeCounts[clipRectsOffset])
+                        ++clipRectsOffset;
+
+                    /* Save the final clip rect to the output. Initially it
+                       affects just the clipping node itself. */
+                    clipRectOffsets[clipRectsOffset] = clipRectOffset;
+                    clipRectSizes[clipRectsOffset] = clipRectSize;
+                    clipRectNodeCounts[clipRectsOffset] = 1;
+                }
 
                 /* Remember offset after all children of its node so we know
                    when to pop this clip rect off the stack */
@@ -616,8 +807,18 @@ UnsignedInt cullVisibleNodesInto(const Vector2& uiOffset, const Vector2& uiSize,
                 clipRectNodeCounts[clipRectsOffset] += nodePlusChildrenCount;
             }
 
-        /* If the node isn't a clipping node, just continue to the next one
-           after */
+        /* If the node isn't a clipping node and neither it nor any of its
+           children overlap the parent clip rect, skip the whole subtree. It
+           can't contain any visible nodes or clip rects, so the output is
+           the same as if the nodes were tested one by one. */
+        } else if(!visible && !visibleSubtreeRects.isEmpty() &&
+                  !((parentMax > visibleSubtreeRects[i].min()).all() &&
+                    (parentMin < visibleSubtreeRects[i].max()).all())) {
+            const UnsignedInt nodePlusChildrenCount = visibleNodeChildrenCounts[i] + 1;
+            i += nodePlusChildrenCount;
+            clipRectNodeCounts[clipRectsOffset] += nodePlusChildrenCount;
+
+        /* Otherwise just continue to the next one after */
         } else {
             ++i;
             ++clipRectNodeCounts[clipRectsOffset];
@@ -636,9 +837,11 @@ UnsignedInt cullVisibleNodesInto(const Vector2& uiOffset, const Vector2& uiSize,
 
         /* If we're at another top level node, it's a new draw, which means we
            need to start a new clip rect as well */
+        bool newTopLevelNode = false;
         if(i == topLevelNodeEnd && i != visibleNodeIds.size()) {
             topLevelNodeEnd = i + visibleNodeChildrenCounts[i] + 1;
             clipStackChanged = true;
+            newTopLevelNode = true;
         }
 
         /* If the clip stack changed, decide about the clip rect to use for the
@@ -649,27 +852,37 @@ UnsignedInt cullVisibleNodesInto(const Vector2& uiOffset, const Vector2& uiSize,
                clipRectNodeCounts or moves to the next element and sets it to
                1, so it's never 0 */
             CORRADE_INTERNAL_DEBUG_ASSERT(clipRectNodeCounts[clipRectsOffset]);
-            ++clipRectsOffset;
 
             /* If there's no non-implicit clip rect available, use the "none"
                rect */
+            Vector2 clipRectOffset, clipRectSize;
             if(clipStackDepth == 1) {
-                clipRectOffsets[clipRectsOffset] = {};
-                clipRectSizes[clipRectsOffset] = {};
+                clipRectOffset = {};
+                clipRectSize = {};
 
             /* Otherwise go back to the parent clip rect */
             } else {
                 CORRADE_INTERNAL_DEBUG_ASSERT(clipStackDepth > 1);
 
-                clipRectOffsets[clipRectsOffset] =
-                    clipStack[clipStackDepth - 1].first();
-                clipRectSizes[clipRectsOffset] =
-                    clipStack[clipStackDepth - 1].second() -
+                clipRectOffset = clipStack[clipStackDepth - 1].first();
+                clipRectSize = clipStack[clipStackDepth - 1].second() -
                     clipStack[clipStackDepth - 1].first();
             }
 
-            /* There's no nodes to consume this clip rect yet */
-            clipRectNodeCounts[clipRectsOffset] = 0;
+            /* If the parent clip rect is the same as the current one, which
+               happens if the popped clip rects were merged with it above,
+               continue with it. Unless it's a new top-level node, which is
+               a separate draw. */
+            if(newTopLevelNode ||
+               clipRectOffsets[clipRectsOffset] != clipRectOffset ||
+               clipRectSizes[clipRectsOffset] != clipRectSize) {
+                ++clipRectsOffset;
+                clipRectOffsets[clipRectsOffset] = clipRectOffset;
+                clipRectSizes[clipRectsOffset] = clipRectSize;
+
+                /* There's no nodes to consume this clip rect yet */
+                clipRectNodeCounts[clipRectsOffset] = 0;
+            }
         }
     }
 
@@ -903,6 +1116,182 @@ void orderNodeDataForEventHandlingInto(const LayerHandle layer, const Containers
     }
 }
 
+/* Calculates a running offset of event data in all subtrees, in the visible
+   node order. The `visibleNodeEventDataOffsets` is expected to be the output
+   of `orderNodeDataForEventHandlingInto()` above, data of nodes that aren't
+   in `visibleEventNodeMask` are not counted. Then, for a node at index `i` in
+   `visibleNodeIds`,
+   `visibleSubtreeEventDataOffsets[i + visibleNodeChildrenCounts[i] + 1] - visibleSubtreeEventDataOffsets[i]`
+   is the count of event data in the node and all its children. If it's zero,
+   there's nothing to call an event on in the whole subtree and hit testing
+   of it can be skipped altogether. */
+void visibleSubtreeEventDataOffsetsInto(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::BitArrayView visibleEventNodeMask, const Containers::ArrayView<const UnsignedInt> visibleNodeEventDataOffsets, const Containers::ArrayView<UnsignedInt> visibleSubtreeEventDataOffsets) {
+    CORRADE_INTERNAL_ASSERT(
+        visibleNodeEventDataOffsets.size() == visibleEventNodeMask.size() + 1 &&
+        visibleSubtreeEventDataOffsets.size() == visibleNodeIds.size() + 1);
+
+    UnsignedInt offset = 0;
+    for(std::size_t i = 0; i != visibleNodeIds.size(); ++i) {
+        visibleSubtreeEventDataOffsets[i] = offset;
+        const UnsignedInt id = visibleNodeIds[i];
+        if(visibleEventNodeMask[id])
+            offset += visibleNodeEventDataOffsets[id + 1] - visibleNodeEventDataOffsets[id];
+    }
+    visibleSubtreeEventDataOffsets[visibleNodeIds.size()] = offset;
+}
+
+/* A uniform grid subdividing area of a node with many direct children, used
+   to hit test just the children overlapping a particular cell instead of
+   going through all of them. The `cellOffset` points to an offset array
+   passed to `buildHitTestGridsInto()` below, with cells ordered row by
+   row. */
+struct HitTestGrid {
+    Vector2 offset;
+    Vector2 cellSize;
+    Vector2ui cellCount;
+    UnsignedInt cellOffset;
+};
+
+/* Returns a cell containing given position. Positions outside of the grid
+   area are clamped to the nearest edge cell. */
+inline Vector2ui hitTestGridCellInto(const HitTestGrid& grid, const Vector2& position) {
+    return Math::min(Vector2ui{Math::max((position - grid.offset)/grid.cellSize, Vector2{0.0f})}, grid.cellCount - Vector2ui{1});
+}
+
+inline UnsignedInt hitTestGridCellIndex(const HitTestGrid& grid, const Vector2& position) {
+    const Vector2ui cell = hitTestGridCellInto(grid, position);
+    return cell.y()*grid.cellCount.x() + cell.x();
+}
+
+/* Builds a grid for each visible node that has at least `minChildCount`
+   direct children that have any event data in their subtree, which is taken
+   from `visibleSubtreeEventDataOffsets` calculated above. Children that are
+   not in `visibleEventNodeMask`, have no event data or are fully outside of
+   the parent node area are not put into the grid at all, as the hit testing
+   of them would fail anyway.
+
+   The `visibleNodeGrids` is then containing, for each index in
+   `visibleNodeIds`, an index into `grids`, or `~UnsignedInt{}` if no grid is
+   built for given node. Then, for a cell `c` of a grid `g`,
+   `[gridCellOffsets[g.cellOffset + c], gridCellOffsets[g.cellOffset + c + 1])`
+   is a range in `gridCellChildren` containing indices of direct children,
+   relative to the parent index in `visibleNodeIds`, in the same order as they
+   are in `visibleNodeIds`. I.e., hit testing them in order gives the same
+   result as going through all direct children.
+
+   A child can be listed in more than one cell if it spans over multiple. If
+   the node has zero area or the children overlap each other too much, such
+   that the total count of cell entries would be larger than
+   `maxEntriesPerChild` times the child count, no grid is built for it. The
+   `grids`, `gridCellOffsets` and `gridCellChildren` arrays are cleared at
+   first and then grown, meaning they reallocate only if the grids become
+   larger than before. */
+void buildHitTestGridsInto(const UnsignedInt minChildCount, const UnsignedInt maxEntriesPerChild, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::BitArrayView visibleEventNodeMask, const Containers::ArrayView<const UnsignedInt> visibleSubtreeEventDataOffsets, const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::ArrayView<UnsignedInt> visibleNodeGrids, Containers::Array<HitTestGrid>& grids, Containers::Array<UnsignedInt>& gridCellOffsets, Containers::Array<UnsignedInt>& gridCellChildren) {
+    CORRADE_INTERNAL_ASSERT(
+        visibleNodeChildrenCounts.size() == visibleNodeIds.size() &&
+        visibleSubtreeEventDataOffsets.size() == visibleNodeIds.size() + 1 &&
+        visibleNodeGrids.size() == visibleNodeIds.size() &&
+        minChildCount);
+
+    arrayResize(grids, NoInit, 0);
+    arrayResize(gridCellOffsets, NoInit, 0);
+    arrayResize(gridCellChildren, NoInit, 0);
+
+    /* Whether a child is worth putting into a grid of given parent */
+    const auto isCandidate = [&](const UnsignedInt childIndex, const Vector2& min, const Vector2& max) {
+        if(visibleSubtreeEventDataOffsets[childIndex + visibleNodeChildrenCounts[childIndex] + 1] == visibleSubtreeEventDataOffsets[childIndex])
+            return false;
+        const UnsignedInt childId = visibleNodeIds[childIndex];
+        if(!visibleEventNodeMask[childId])
+            return false;
+        const Vector2 childMin = absoluteNodeOffsets[childId];
+        const Vector2 childMax = childMin + nodeSizes[childId];
+        return !(childMax <= min).any() && !(childMin >= max).any() &&
+               !(childMax <= childMin).any();
+    };
+
+    for(std::size_t i = 0; i != visibleNodeIds.size(); ++i) {
+        visibleNodeGrids[i] = ~UnsignedInt{};
+
+        /* The total child count is an upper bound on the direct child count,
+           if it's not enough, there's no need to look further */
+        const UnsignedInt childrenCount = visibleNodeChildrenCounts[i];
+        if(childrenCount < minChildCount)
+            continue;
+
+        const UnsignedInt nodeId = visibleNodeIds[i];
+        const Vector2 min = absoluteNodeOffsets[nodeId];
+        const Vector2 size = nodeSizes[nodeId];
+        if(!(size > Vector2{0.0f}).all())
+            continue;
+        const Vector2 max = min + size;
+
+        UnsignedInt candidateCount = 0;
+        for(UnsignedInt j = 1, jMax = childrenCount + 1; j != jMax; j += visibleNodeChildrenCounts[i + j] + 1)
+            if(isCandidate(i + j, min, max))
+                ++candidateCount;
+        if(candidateCount < minChildCount)
+            continue;
+
+        /* Roughly as many cells as there are candidate children, in a square
+           pattern */
+        const UnsignedInt cellsPerSide = UnsignedInt(Math::ceil(Math::sqrt(Float(candidateCount))));
+        HitTestGrid grid;
+        grid.offset = min;
+        grid.cellSize = size/Float(cellsPerSide);
+        grid.cellCount = Vector2ui{cellsPerSide};
+        grid.cellOffset = gridCellOffsets.size();
+        const UnsignedInt cellCount = cellsPerSide*cellsPerSide;
+
+        /* Count entries in each cell, skipping the first element */
+        const std::size_t childOffset = gridCellChildren.size();
+        Containers::ArrayView<UnsignedInt> cellOffsets = arrayAppend(gridCellOffsets, ValueInit, cellCount + 1);
+        std::size_t entryCount = 0;
+        for(UnsignedInt j = 1, jMax = childrenCount + 1; j != jMax; j += visibleNodeChildrenCounts[i + j] + 1) {
+            if(!isCandidate(i + j, min, max))
+                continue;
+            const UnsignedInt childId = visibleNodeIds[i + j];
+            const Vector2ui cellMin = hitTestGridCellInto(grid, absoluteNodeOffsets[childId]);
+            const Vector2ui cellMax = hitTestGridCellInto(grid, absoluteNodeOffsets[childId] + nodeSizes[childId]);
+            for(UnsignedInt y = cellMin.y(); y <= cellMax.y(); ++y)
+                for(UnsignedInt x = cellMin.x(); x <= cellMax.x(); ++x)
+                    ++cellOffsets[y*cellsPerSide + x + 1];
+            entryCount += (cellMax - cellMin + Vector2ui{1}).product();
+        }
+
+        /* If the children overlap too much, the grid wouldn't help. Throw
+           away what was added for it. */
+        if(entryCount > std::size_t(maxEntriesPerChild)*candidateCount) {
+            arrayResize(gridCellOffsets, NoInit, grid.cellOffset);
+            continue;
+        }
+
+        /* Turn the counts into an offset array, then fill the children. The
+           process shifts the array by one element, so afterwards
+           `[cellOffsets[c], cellOffsets[c + 1])` is a range of children in
+           cell `c`. */
+        UnsignedInt offset = childOffset;
+        for(UnsignedInt& j: cellOffsets) {
+            const UnsignedInt nextOffset = offset + j;
+            j = offset;
+            offset = nextOffset;
+        }
+        Containers::ArrayView<UnsignedInt> cellChildren = arrayAppend(gridCellChildren, NoInit, entryCount);
+        for(UnsignedInt j = 1, jMax = childrenCount + 1; j != jMax; j += visibleNodeChildrenCounts[i + j] + 1) {
+            if(!isCandidate(i + j, min, max))
+                continue;
+            const UnsignedInt childId = visibleNodeIds[i + j];
+            const Vector2ui cellMin = hitTestGridCellInto(grid, absoluteNodeOffsets[childId]);
+            const Vector2ui cellMax = hitTestGridCellInto(grid, absoluteNodeOffsets[childId] + nodeSizes[childId]);
+            for(UnsignedInt y = cellMin.y(); y <= cellMax.y(); ++y)
+                for(UnsignedInt x = cellMin.x(); x <= cellMax.x(); ++x)
+                    cellChildren[cellOffsets[y*cellsPerSide + x + 1]++ - childOffset] = j;
+        }
+        visibleNodeGrids[i] = grids.size();
+        arrayAppend(grids, grid);
+    }
+}
+
 /* Reduces the three arrays by throwing away items where size is 0. Returns the
    resulting size. */
 UnsignedInt compactDrawsInPlace(const Containers::StridedArrayView1D<UnsignedByte>& dataToDrawLayerIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawSizes, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectSizes) {
@@ -930,27 +1319,107 @@ UnsignedInt compactDrawsInPlace(const Containers::StridedArrayView1D<UnsignedByt
         ++offset;
     }
 
-    /** @todo optimization step where draws of the same layer following each
-        other are merged into one (with the assumption that the draw order is
-        kept), that allows imgui-level efficiency where the whole UI with all
-        widgets can be drawn in a single call, assuming most of the content
-        (text, backgrounds, ...) is implemented in a single layer
+    return offset;
+}
 
-        this would require that UserInterface populates the to-update data in
-        the draw order, not in the layer ID order */
+/* Calculates a draw order in which draws of consecutive top-level nodes with
+   mutually disjoint rects are grouped by layer, in order to then have them
+   merged with mergeDrawsInPlace(). The `dataToDrawLayerIds` and
+   `dataToDrawSizes` are in the layout populated by orderVisibleNodeDataInto(),
+   i.e. first by the top-level node and then by the layer draw order, and the
+   `drawOrder` is filled with indices into them.
+
+   The groups are found greedily, each new top-level node is tested against
+   all nodes in the current group and a new group is started once it overlaps
+   any of them. That's O(n^2) in the worst case, but only within a group, and
+   it keeps the relative order between the groups intact. A top-level node
+   that has draws from any of the `compositeLayers`, indexed by layer ID, is
+   always in a group of its own, as the compositing operation may depend on
+   what's drawn before. */
+void mergeableDrawOrderInto(const Containers::StridedArrayView1D<const Range2D>& topLevelNodeRects, const Containers::StridedArrayView1D<const UnsignedByte>& dataToDrawLayerIds, const Containers::StridedArrayView1D<const UnsignedInt>& dataToDrawSizes, const Containers::BitArrayView compositeLayers, const Containers::StridedArrayView1D<UnsignedInt>& drawOrder) {
+    CORRADE_INTERNAL_ASSERT(
+        dataToDrawSizes.size() == dataToDrawLayerIds.size() &&
+        drawOrder.size() == dataToDrawLayerIds.size() &&
+        (topLevelNodeRects.isEmpty() || dataToDrawLayerIds.size() % topLevelNodeRects.size() == 0));
+    if(topLevelNodeRects.isEmpty())
+        return;
+
+    const std::size_t topLevelNodeCount = topLevelNodeRects.size();
+    const std::size_t drawLayerCount = dataToDrawLayerIds.size()/topLevelNodeCount;
+    const auto hasComposite = [&](const std::size_t topLevelNode) {
+        for(std::size_t i = topLevelNode*drawLayerCount, iMax = i + drawLayerCount; i != iMax; ++i)
+            if(dataToDrawSizes[i] && compositeLayers[dataToDrawLayerIds[i]])
+                return true;
+        return false;
+    };
 
-    /** @todo top-level nodes that have mutually disjoint bounding rect for all
-        (clipped) subnodes can be also be drawn together without worrying about
-        incorrect draw order -- however it needs some algorithm that is better
-        than O(n^2) in finding mutually disjoint sets, plus also things like
-        two top-level nodes being disjoint but between them is ordered another
-        that overlaps with both
+    std::size_t offset = 0;
+    for(std::size_t begin = 0, end; begin != topLevelNodeCount; begin = end) {
+        end = begin + 1;
+        if(!hasComposite(begin)) while(end != topLevelNodeCount && !hasComposite(end)) {
+            bool disjoint = true;
+            for(std::size_t i = begin; i != end; ++i) {
+                if(Math::intersects(topLevelNodeRects[i], topLevelNodeRects[end])) {
+                    disjoint = false;
+                    break;
+                }
+            }
+            if(!disjoint)
+                break;
+            ++end;
+        }
 
-        so pick just nodes that are disjoint in a sequence, and stop when
-        something overlaps? that's still O(n^2) though, every new node
-        considered has to be checked with all previous */
+        /* Emit the group by layer and then by the top-level node to have
+           draws of the same layer next to each other */
+        for(std::size_t layer = 0; layer != drawLayerCount; ++layer)
+            for(std::size_t i = begin; i != end; ++i)
+                drawOrder[offset++] = i*drawLayerCount + layer;
+    }
 
-    return offset;
+    CORRADE_INTERNAL_ASSERT(offset == drawOrder.size());
+}
+
+/* Merges consecutive draws of the same layer into one if their data and clip
+   rect ranges follow each other, which is the case for draws of consecutive
+   top-level nodes put next to each other by mergeableDrawOrderInto(). Draws
+   of `compositeLayers`, indexed by layer ID, aren't merged as the compositing
+   is done per draw. Expects that empty draws were already removed by
+   compactDrawsInPlace(). Returns the resulting size. */
+UnsignedInt mergeDrawsInPlace(const Containers::StridedArrayView1D<UnsignedByte>& dataToDrawLayerIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawSizes, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectSizes, const Containers::BitArrayView compositeLayers) {
+    CORRADE_INTERNAL_ASSERT(
+        dataToDrawOffsets.size() == dataToDrawLayerIds.size() &&
+        dataToDrawSizes.size() == dataToDrawLayerIds.size() &&
+        dataToDrawClipRectOffsets.size() == dataToDrawLayerIds.size() &&
+        dataToDrawClipRectSizes.size() == dataToDrawLayerIds.size());
+    if(dataToDrawLayerIds.isEmpty())
+        return 0;
+
+    std::size_t offset = 0;
+    for(std::size_t i = 1, iMax = dataToDrawLayerIds.size(); i != iMax; ++i) {
+        const UnsignedByte layerId = dataToDrawLayerIds[i];
+        if(layerId == dataToDrawLayerIds[offset] &&
+           !compositeLayers[layerId] &&
+           dataToDrawOffsets[offset] + dataToDrawSizes[offset] == dataToDrawOffsets[i] &&
+           dataToDrawClipRectOffsets[offset] + dataToDrawClipRectSizes[offset] == dataToDrawClipRectOffsets[i])
+        {
+            dataToDrawSizes[offset] += dataToDrawSizes[i];
+            dataToDrawClipRectSizes[offset] += dataToDrawClipRectSizes[i];
+            continue;
+        }
+
+        ++offset;
+
+        /* Don't copy to itself */
+        if(i != offset) {
+            dataToDrawLayerIds[offset] = dataToDrawLayerIds[i];
+            dataToDrawOffsets[offset] = dataToDrawOffsets[i];
+            dataToDrawSizes[offset] = dataToDrawSizes[i];
+            dataToDrawClipRectOffsets[offset] = dataToDrawClipRectOffsets[i];
+            dataToDrawClipRectSizes[offset] = dataToDrawClipRectSizes[i];
+        }
+    }
+
+    return offset + 1;
 }
 
 /* Calculates compositing rectangles for all nodes referenced by drawn data,
@@ -1008,6 +1477,232 @@ void compositeRectsInto(const Vector2& uiOffset, const Vector2& uiSize, const Co
     CORRADE_INTERNAL_ASSERT(dataOffset == dataIds.size());
 }
 
+/* Node state remembered from the previous update() for partial redraws with
+   RendererFeature::PartialRedraw. The `order` is an index into the previous
+   `visibleNodeIds` or ~UnsignedInt{} if the node wasn't there, `visible` is
+   the bit from the previous `visibleNodeMask`, i.e. after culling. */
+struct RedrawNode {
+    Vector2 offset;
+    Vector2 size;
+    Float opacity;
+    UnsignedInt order;
+    bool visible;
+    bool enabled;
+};
+
+/* Compares the current node state with `redrawNodes` and joins both the
+   previous and the current rect of every node that changed offset, size,
+   opacity, enabled state or visibility into `redrawRect`. The `redrawNodes`
+   are then updated to the current state. The array is expected to have the
+   same size as `visibleNodeMask`, with entries for nodes that weren't there
+   in the previous update() having `order` set to ~UnsignedInt{} and
+   `visible` to false.
+
+   Returns false if a relative order of nodes that are in both the previous
+   and the current `visibleNodeIds` changed, in which case the whole UI has to
+   be redrawn. The `inVisibleNodeIds` is a scratch mask of the same size as
+   `visibleNodeMask`, expected to be zero-initialized. */
+bool redrawRectInto(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& absoluteNodeOpacities, const Containers::BitArrayView visibleNodeMask, const Containers::BitArrayView visibleEnabledNodeMask, const Containers::MutableBitArrayView inVisibleNodeIds, const Containers::StridedArrayView1D<RedrawNode>& redrawNodes, Range2D& redrawRect) {
+    CORRADE_INTERNAL_ASSERT(
+        nodeSizes.size() == absoluteNodeOffsets.size() &&
+        absoluteNodeOpacities.size() == absoluteNodeOffsets.size() &&
+        visibleNodeMask.size() == absoluteNodeOffsets.size() &&
+        visibleEnabledNodeMask.size() == absoluteNodeOffsets.size() &&
+        inVisibleNodeIds.size() == absoluteNodeOffsets.size() &&
+        redrawNodes.size() == absoluteNodeOffsets.size());
+
+    bool sameOrder = true;
+    UnsignedInt previousOrder = 0;
+    for(std::size_t i = 0; i != visibleNodeIds.size(); ++i) {
+        const UnsignedInt id = visibleNodeIds[i];
+        RedrawNode& node = redrawNodes[id];
+        inVisibleNodeIds.set(id);
+
+        /* Nodes that appeared since the last time don't affect the order of
+           the others */
+        if(node.order != ~UnsignedInt{}) {
+            if(node.order < previousOrder)
+                sameOrder = false;
+            previousOrder = node.order;
+        }
+
+        const bool visible = visibleNodeMask[id];
+        const bool enabled = visibleEnabledNodeMask[id];
+        const Vector2 offset = absoluteNodeOffsets[id];
+        const Vector2 size = nodeSizes[id];
+        const Float opacity = absoluteNodeOpacities[id];
+        if(visible != node.visible || (visible &&
+            (offset != node.offset ||
+             size != node.size ||
+             opacity != node.opacity ||
+             enabled != node.enabled)))
+        {
+            if(node.visible)
+                redrawRect = Math::join(redrawRect, Range2D::fromSize(node.offset, node.size));
+            if(visible)
+                redrawRect = Math::join(redrawRect, Range2D::fromSize(offset, size));
+        }
+
+        node.offset = offset;
+        node.size = size;
+        node.opacity = opacity;
+        node.order = i;
+        node.visible = visible;
+        node.enabled = enabled;
+    }
+
+    /* Nodes that were there in the previous update() but aren't anymore,
+       either because they got hidden or removed */
+    for(std::size_t id = 0; id != redrawNodes.size(); ++id) {
+        if(inVisibleNodeIds[id])
+            continue;
+        RedrawNode& node = redrawNodes[id];
+        if(node.visible)
+            redrawRect = Math::join(redrawRect, Range2D::fromSize(node.offset, node.size));
+        node.order = ~UnsignedInt{};
+        node.visible = false;
+    }
+
+    return sameOrder;
+}
+
+/* Joins rects of nodes the `dataIds` are attached to into `redrawRect`. Used
+   for layers that had their data updated, in which case it's not known which
+   data exactly changed. */
+void redrawDataRectInto(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const NodeHandle>& dataNodes, const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, Range2D& redrawRect) {
+    CORRADE_INTERNAL_ASSERT(nodeSizes.size() == absoluteNodeOffsets.size());
+
+    for(const UnsignedInt dataId: dataIds) {
+        const UnsignedInt nodeId = nodeHandleId(dataNodes[dataId]);
+        redrawRect = Math::join(redrawRect, Range2D::fromSize(absoluteNodeOffsets[nodeId], nodeSizes[nodeId]));
+    }
+}
+
+/* Draws of a top-level node hierarchy marked with NodeFlag::Cached, used if
+   the renderer advertises RendererFeature::DrawCache. The `visibleNodeIndex`
+   is an index into `visibleNodeIds`, `drawOffset` and `drawCount` a range in
+   the draw list after compactDrawsInPlace() and `rect` a bounding rect of all
+   visible nodes in the hierarchy. */
+struct CachedDraw {
+    Range2D rect;
+    UnsignedInt nodeId;
+    UnsignedInt visibleNodeIndex;
+    UnsignedInt drawOffset;
+    UnsignedInt drawCount;
+};
+
+/* Per-node cache state with RendererFeature::DrawCache. If `present`, the
+   renderer has a cache for given node ID, if `valid`, its contents are up to
+   date, and `drawn` is set if the node is among the current cached draws.
+   Caches that are present but not drawn are discarded in the next draw. */
+struct NodeCache {
+    bool present;
+    bool valid;
+    bool drawn;
+};
+
+/* Collects top-level node hierarchies to be drawn from a cache. The
+   `dataToDrawLayerIds` and `dataToDrawSizes` are in the layout populated by
+   orderVisibleNodeDataInto(), i.e. first by the top-level node and then by
+   the layer draw order, before compactDrawsInPlace() is called, and the draw
+   offsets are calculated for the compacted list. The `topLevelNodeIndices`
+   are indices into `visibleNodeIds` for each top-level node the draws are
+   for, `topLevelNodeRects` their bounding rects and `cachedTopLevelNodes` has
+   bits set for those that are marked as cached. Hierarchies that draw nothing
+   or have draws of any of the `compositeLayers`, indexed by layer ID, aren't
+   cached, as the compositing operation needs the framebuffer contents under
+   them. Returns the count of items written to `cachedDraws`. */
+std::size_t cachedDrawsInto(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& topLevelNodeIndices, const Containers::StridedArrayView1D<const Range2D>& topLevelNodeRects, const Containers::BitArrayView cachedTopLevelNodes, const Containers::StridedArrayView1D<const UnsignedByte>& dataToDrawLayerIds, const Containers::StridedArrayView1D<const UnsignedInt>& dataToDrawSizes, const Containers::BitArrayView compositeLayers, const Containers::ArrayView<CachedDraw> cachedDraws) {
+    CORRADE_INTERNAL_ASSERT(
+        topLevelNodeRects.size() == topLevelNodeIndices.size() &&
+        cachedTopLevelNodes.size() == topLevelNodeIndices.size() &&
+        dataToDrawSizes.size() == dataToDrawLayerIds.size() &&
+        cachedDraws.size() >= topLevelNodeIndices.size());
+    if(topLevelNodeIndices.isEmpty())
+        return 0;
+    CORRADE_INTERNAL_ASSERT(dataToDrawLayerIds.size() % topLevelNodeIndices.size() == 0);
+    const std::size_t drawLayerCount = dataToDrawLayerIds.size()/topLevelNodeIndices.size();
+
+    std::size_t count = 0;
+    UnsignedInt drawOffset = 0;
+    for(std::size_t i = 0; i != topLevelNodeIndices.size(); ++i) {
+        UnsignedInt drawCount = 0;
+        bool composite = false;
+        for(std::size_t j = i*drawLayerCount, jMax = j + drawLayerCount; j != jMax; ++j) {
+            if(!dataToDrawSizes[j])
+                continue;
+            ++drawCount;
+            if(compositeLayers[dataToDrawLayerIds[j]])
+                composite = true;
+        }
+
+        if(cachedTopLevelNodes[i] && drawCount && !composite) {
+            CachedDraw& cachedDraw = cachedDraws[count++];
+            cachedDraw.rect = topLevelNodeRects[i];
+            cachedDraw.nodeId = visibleNodeIds[topLevelNodeIndices[i]];
+            cachedDraw.visibleNodeIndex = topLevelNodeIndices[i];
+            cachedDraw.drawOffset = drawOffset;
+            cachedDraw.drawCount = drawCount;
+        }
+
+        drawOffset += drawCount;
+    }
+
+    return count;
+}
+
+/* Compares the current state of nodes in each of the `cachedDraws`
+   hierarchies with `cacheNodes` and resets the `valid` bit in `nodeCaches`
+   for the top-level node if any node in the hierarchy changed offset, size,
+   opacity, enabled state, visibility or the order. The `cacheNodes` are then
+   updated to the current state, with `order` being the index relative to the
+   top-level node and for the top-level node itself the count of nodes in the
+   hierarchy. Both arrays are indexed by node ID, entries for nodes that
+   weren't in any cached hierarchy before are expected to have the `order`
+   set to ~UnsignedInt{}. */
+void invalidateChangedCachesInto(const Containers::ArrayView<const CachedDraw> cachedDraws, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& absoluteNodeOpacities, const Containers::BitArrayView visibleNodeMask, const Containers::BitArrayView visibleEnabledNodeMask, const Containers::StridedArrayView1D<RedrawNode>& cacheNodes, const Containers::StridedArrayView1D<NodeCache>& nodeCaches) {
+    CORRADE_INTERNAL_ASSERT(
+        visibleNodeChildrenCounts.size() == visibleNodeIds.size() &&
+        nodeSizes.size() == absoluteNodeOffsets.size() &&
+        absoluteNodeOpacities.size() == absoluteNodeOffsets.size() &&
+        visibleNodeMask.size() == absoluteNodeOffsets.size() &&
+        visibleEnabledNodeMask.size() == absoluteNodeOffsets.size() &&
+        cacheNodes.size() == absoluteNodeOffsets.size() &&
+        nodeCaches.size() == absoluteNodeOffsets.size());
+
+    for(const CachedDraw& cachedDraw: cachedDraws) {
+        bool changed = false;
+        const UnsignedInt count = visibleNodeChildrenCounts[cachedDraw.visibleNodeIndex] + 1;
+        for(UnsignedInt i = 0; i != count; ++i) {
+            const UnsignedInt id = visibleNodeIds[cachedDraw.visibleNodeIndex + i];
+            RedrawNode& node = cacheNodes[id];
+
+            const UnsignedInt order = i ? i : count;
+            const bool visible = visibleNodeMask[id];
+            const bool enabled = visibleEnabledNodeMask[id];
+            const Vector2 offset = absoluteNodeOffsets[id];
+            const Vector2 size = nodeSizes[id];
+            const Float opacity = absoluteNodeOpacities[id];
+            if(order != node.order || visible != node.visible || (visible &&
+                (offset != node.offset ||
+                 size != node.size ||
+                 opacity != node.opacity ||
+                 enabled != node.enabled)))
+                changed = true;
+
+            node.offset = offset;
+            node.size = size;
+            node.opacity = opacity;
+            node.order = order;
+            node.visible = visible;
+            node.enabled = enabled;
+        }
+
+        if(changed)
+            nodeCaches[cachedDraw.nodeId].valid = false;
+    }
+}
+
 /* Query a list of animators partitioned into the following groups:
    - Animators with no NodeAttachment
    - Animators with NodeAttachment
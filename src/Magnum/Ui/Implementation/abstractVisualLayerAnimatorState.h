@@ -54,6 +54,12 @@ struct AbstractVisualLayerStyleAnimator::State {
        have its size always match layer capacity */
     Containers::StridedArrayView1D<UnsignedInt> targetStyles;
     Containers::StridedArrayView1D<UnsignedInt> dynamicStyles;
+    /* Optional. If non-empty, animations that share the same dynamic style
+       form a circular list through these, and an animation that doesn't share
+       its dynamic style with any other points to itself. Same as above
+       assumed to point to subclass own data and have the same size. */
+    Containers::StridedArrayView1D<UnsignedInt> dynamicStyleNext;
+    Containers::StridedArrayView1D<UnsignedInt> dynamicStylePrevious;
 };
 
 }}
@@ -31,6 +31,7 @@
    header gets published) eventually possibly also 3rd party renderer
    implementations */
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/Reference.h>
@@ -42,6 +43,19 @@ namespace Magnum { namespace Ui {
 
 namespace Implementation {
     constexpr UnsignedInt styleTransitionPassthrough(UnsignedInt index) { return index; }
+
+    /* Indices into AbstractVisualLayer::Shared::State::styleTransitions and
+       the corresponding tables in styleTransitionTables */
+    enum: std::size_t {
+        StyleTransitionToInactiveOut,
+        StyleTransitionToInactiveOver,
+        StyleTransitionToFocusedOut,
+        StyleTransitionToFocusedOver,
+        StyleTransitionToPressedOut,
+        StyleTransitionToPressedOver,
+        StyleTransitionToDisabled,
+        StyleTransitionCount
+    };
 }
 
 struct AbstractVisualLayer::Shared::State {
@@ -64,24 +78,51 @@ struct AbstractVisualLayer::Shared::State {
        similar APIs. Gets updated when the Shared instance itself is moved. */
     Containers::Reference<Shared> self;
 
+    /* Transitioned style for given Implementation::StyleTransition* index,
+       taken either from the tables or by calling the function */
+    UnsignedInt styleTransition(std::size_t transition, UnsignedInt style) const {
+        return styleTransitionTables.isEmpty() ?
+            styleTransitions[transition](style) :
+            styleTransitionTables[transition*styleCount + style];
+    }
+
+    /* Whether there's any transition to the disabled style */
+    bool hasStyleTransitionToDisabled() const {
+        return styleTransitionTables.isEmpty() ?
+            styleTransitions[Implementation::StyleTransitionToDisabled] != nullptr :
+            styleTransitionTablesToDisabled;
+    }
+
     UnsignedInt styleCount, dynamicStyleCount;
-    UnsignedInt(*styleTransitionToInactiveOut)(UnsignedInt) = Implementation::styleTransitionPassthrough;
-    UnsignedInt(*styleTransitionToInactiveOver)(UnsignedInt) = Implementation::styleTransitionPassthrough;
-    UnsignedInt(*styleTransitionToFocusedOut)(UnsignedInt) = Implementation::styleTransitionPassthrough;
-    UnsignedInt(*styleTransitionToFocusedOver)(UnsignedInt) = Implementation::styleTransitionPassthrough;
-    UnsignedInt(*styleTransitionToPressedOut)(UnsignedInt) = Implementation::styleTransitionPassthrough;
-    UnsignedInt(*styleTransitionToPressedOver)(UnsignedInt) = Implementation::styleTransitionPassthrough;
-    /* Unlike the others, this one can be nullptr, in which case the whole
-       logic in doUpdate() gets skipped */
-    UnsignedInt(*styleTransitionToDisabled)(UnsignedInt) = nullptr;
-
-    /* Incremented every time the styleTransitionToDisabled pointer is changed.
-       There's a corresponding styleTransitionToDisabledUpdateStamp variable in
+    /* Indexed with Implementation::StyleTransition*. Unlike the others, the
+       StyleTransitionToDisabled one can be nullptr, in which case the whole
+       logic in doUpdate() gets skipped. */
+    UnsignedInt(*styleTransitions[Implementation::StyleTransitionCount])(UnsignedInt){
+        Implementation::styleTransitionPassthrough,
+        Implementation::styleTransitionPassthrough,
+        Implementation::styleTransitionPassthrough,
+        Implementation::styleTransitionPassthrough,
+        Implementation::styleTransitionPassthrough,
+        Implementation::styleTransitionPassthrough,
+        nullptr
+    };
+
+    /* If non-empty, contains Implementation::StyleTransitionCount tables of
+       `styleCount` items each, in the same order as `styleTransitions`, which
+       are then used instead of the functions. Filled by
+       setStyleTransitionTables() or bakeStyleTransitions(), emptied again by
+       setStyleTransition(). The disabled table is filled only if
+       styleTransitionTablesToDisabled is set. */
+    Containers::Array<UnsignedInt> styleTransitionTables;
+
+    /* Incremented every time the disabled transition is changed. There's a
+       corresponding styleTransitionToDisabledUpdateStamp variable in
        AbstractVisualLayer::State that doState() compares to this one,
        returning LayerState::NeedsDataUpdate if it differs. */
     UnsignedShort styleTransitionToDisabledUpdateStamp = 0;
+    bool styleTransitionTablesToDisabled = false;
 
-    /* 2/6 bytes free to be used by the derived structs */
+    /* 1/5 bytes free to be used by the derived structs */
 };
 
 struct AbstractVisualLayer::State {
@@ -104,12 +145,23 @@ struct AbstractVisualLayer::State {
     Containers::ArrayTuple dynamicStyleStorage;
     Containers::MutableBitArrayView dynamicStylesUsed;
     Containers::ArrayView<AnimationHandle> dynamicStyleAnimations;
+    /* All dynamic styles before this index are known to be used, so
+       allocateDynamicStyle() starts looking for a free one from here. Gets
+       moved back in recycleDynamicStyle(). */
+    UnsignedInt dynamicStyleFreeHint = 0;
 
     /* These views are assumed to point to subclass own data and maintained to
        have its size always match layer capacity. The `calculatedStyles` are a
        copy of `styles` with additional transitions applied for disabled
        nodes, which is performed in the layer doUpdate(). */
     Containers::StridedArrayView1D<UnsignedInt> styles, calculatedStyles;
+
+    /* IDs of data whose style changed in an event style transition since the
+       last update, if the subclass supports patching just those, i.e. has
+       `dataStyleUpdates` set. Filled by styleTransitionedInternal(), filtered
+       to still-valid attached data in AbstractVisualLayer::doUpdate() and
+       cleared by the subclass doUpdate(). May contain duplicates. */
+    Containers::Array<UnsignedInt> styleChangedDataIds;
     /* 99% of internal accesses to the Shared instance need the State struct,
        so saving it directly to avoid an extra indirection, In some cases the
        public API reference is needed (mainly for user-side access, such as
@@ -136,7 +188,13 @@ struct AbstractVisualLayer::State {
        expanded to 32 bits. */
     UnsignedShort styleTransitionToDisabledUpdateStamp;
 
-    /* 2/6 bytes free used by the derived structs */
+    /* Set by the subclass if it's able to handle
+       LayerState::NeedsDataStyleUpdate for data listed in
+       styleChangedDataIds. If not, event style transitions set
+       LayerState::NeedsDataUpdate instead. */
+    bool dataStyleUpdates = false;
+
+    /* 1/5 bytes free used by the derived structs */
 };
 
 }}
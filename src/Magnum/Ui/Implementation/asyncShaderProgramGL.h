@@ -0,0 +1,114 @@
+#ifndef Magnum_Ui_Implementation_asyncShaderProgramGL_h
+#define Magnum_Ui_Implementation_asyncShaderProgramGL_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Move.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+
+/* Base for shaders used by BaseLayerGL, LineLayerGL and TextLayerGL. The
+   subclass constructor submits the compilation and linking without waiting
+   for the result, which the driver can then do in parallel for all shaders
+   if KHR_parallel_shader_compile is supported. The result is checked and the
+   post-link setup done in a finish() function the subclass implements, which
+   is expected to be called before the shader is used for the first time.
+   Whether explicit uniform locations and bindings are available is
+   remembered at submit time so the post-link setup doesn't need the version
+   the shader was compiled with. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+class AsyncShaderProgramGL: public GL::AbstractShaderProgram {
+    public:
+        explicit AsyncShaderProgramGL(NoCreateT) noexcept: GL::AbstractShaderProgram{NoCreate}, _vert{NoCreate}, _frag{NoCreate} {}
+
+        /* Doesn't block. If KHR_parallel_shader_compile isn't supported, it's
+           always true. */
+        bool isCompileFinished() {
+            return !_vert.id() || (_vert.isCompileFinished() && _frag.isCompileFinished() && isLinkFinished());
+        }
+
+    protected:
+        explicit AsyncShaderProgramGL(): _vert{NoCreate}, _frag{NoCreate} {}
+
+        /* Whether the compilation was submitted and its result not checked
+           yet */
+        bool isCompilePending() const { return _vert.id(); }
+
+        void submitCompileLink(GL::Shader&& vert, GL::Shader&& frag, const GL::Version version) {
+            #ifndef MAGNUM_TARGET_GLES
+            static_cast<void>(version);
+            GL::Context& context = GL::Context::current();
+            _explicitUniformLocations = context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>();
+            _explicitBindings = context.isExtensionSupported<GL::Extensions::ARB::shading_language_420pack>();
+            #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+            _explicitUniformLocations = _explicitBindings = version >= GL::Version::GLES310;
+            #else
+            static_cast<void>(version);
+            #endif
+
+            vert.submitCompile();
+            frag.submitCompile();
+            attachShaders({vert, frag});
+            submitLink();
+            _vert = Utility::move(vert);
+            _frag = Utility::move(frag);
+        }
+
+        /* If the compilation is pending, waits for it, checks the result and
+           returns true so the subclass can do the post-link setup. Returns
+           false if it was already checked before. */
+        bool checkCompileLink() {
+            if(!_vert.id())
+                return false;
+            CORRADE_INTERNAL_ASSERT(_vert.checkCompile() && _frag.checkCompile());
+            CORRADE_INTERNAL_ASSERT(checkLink({_vert, _frag}));
+            _vert = GL::Shader{NoCreate};
+            _frag = GL::Shader{NoCreate};
+            return true;
+        }
+
+        /* If false, uniform locations have to be queried after link */
+        bool hasExplicitUniformLocations() const { return _explicitUniformLocations; }
+
+        /* If false, texture and uniform block bindings have to be set after
+           link */
+        bool hasExplicitBindings() const { return _explicitBindings; }
+
+    private:
+        GL::Shader _vert, _frag;
+        bool _explicitUniformLocations = false,
+            _explicitBindings = false;
+};
+
+}}}
+
+#endif
@@ -31,6 +31,11 @@
    eventually possibly also 3rd party renderer implementations */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayTuple.h>
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/Function.h>
+#include <Magnum/Math/Constants.h>
+#include <Magnum/Math/Functions.h>
 
 #include "Magnum/Ui/BaseLayer.h"
 #include "Magnum/Ui/Implementation/abstractVisualLayerState.h"
@@ -46,6 +51,21 @@ struct BaseLayerStyle {
     Vector4 padding;
 };
 
+/* Used with BaseLayerSharedFlag::OpaqueDepthPrepass, calculated from a
+   BaseLayerStyleUniform */
+struct BaseLayerStyleOpacity {
+    /* Whether topColor and bottomColor have a full alpha */
+    bool opaque;
+    /* Whether outlineColor has a full alpha */
+    bool outlineOpaque;
+    /* Maximum of all cornerRadius and innerOutlineCornerRadius components,
+       zero with NoRoundedCorners */
+    Float cornerRadius;
+    Float innerOutlineCornerRadius;
+    /* Left, top, right, bottom, zero with NoOutline */
+    Vector4 outlineWidth;
+};
+
 }
 
 struct BaseLayer::Shared::State: AbstractVisualLayer::Shared::State {
@@ -58,17 +78,26 @@ struct BaseLayer::Shared::State: AbstractVisualLayer::Shared::State {
        this one, returning LayerState::NeedsDataUpdate if it differs. */
     UnsignedShort styleUpdateStamp = 0;
 
+    BaseLayerSharedFlags flags;
+
     /* Used by BaseLayerGL to expand the area used for processing the blur
        so the second and subsequent passes don't tap outside. The radius is
        always at most 31, so can be a byte. */
     UnsignedByte backgroundBlurRadius;
+    BaseLayerBackgroundBlurAlgorithm backgroundBlurAlgorithm;
+    /* Used by BaseLayerGL to pick the size of the blur textures */
+    UnsignedInt backgroundBlurDownscale;
 
-    BaseLayerSharedFlags flags;
+    /* Implementation::BaseLayerFeature bits that aren't disabled by
+       NoRoundedCorners / NoOutline, i.e. the features for which BaseLayerGL
+       can pick a shader variant without them. Zero if SubdividedQuads or
+       StableIndices is enabled, in which case no such split is done. */
+    UnsignedByte featureMask;
 
     #ifndef CORRADE_NO_ASSERT
     bool setStyleCalled = false;
     #endif
-    /* 1 byte free, 2 bytes free w/ CORRADE_NO_ASSERT */
+    /* 2 bytes free, 0 bytes free w/ CORRADE_NO_ASSERT */
 
     /* Can't be inferred from styleUniforms.size() as those are non-empty only
        if dynamicStyleCount is non-zero */
@@ -85,7 +114,16 @@ struct BaseLayer::Shared::State: AbstractVisualLayer::Shared::State {
     /* Uniform values to be copied to layer-specific uniform buffers. Empty
        and unused if dynamicStyleCount is 0. */
     Containers::ArrayView<BaseLayerStyleUniform> styleUniforms;
+    /* Opacity properties of each uniform. Empty and unused if
+       OpaqueDepthPrepass isn't enabled. */
+    Containers::ArrayView<Implementation::BaseLayerStyleOpacity> styleOpacities;
+    /* Implementation::BaseLayerFeature bits used by each uniform. Empty and
+       unused if featureMask is zero. */
+    Containers::ArrayView<UnsignedByte> styleUniformFeatures;
     BaseLayerCommonStyleUniform commonStyleUniform{NoInit};
+    /* Used for insetting opaque areas with OpaqueDepthPrepass. The smoothness
+       is saved above already. */
+    Float innerOutlineSmoothness;
 };
 
 namespace Implementation {
@@ -98,6 +136,9 @@ struct BaseLayerData {
     UnsignedInt style, calculatedStyle;
     Vector3 textureCoordinateOffset;
     Vector2 textureCoordinateSize;
+    /* Node offset the vertices or instance of given data were last generated
+       with, used to shift them on node translation */
+    Vector2 vertexNodeOffset;
 };
 
 struct BaseLayerVertex {
@@ -115,6 +156,22 @@ struct BaseLayerTexturedVertex {
     Vector3 textureCoordinates;
 };
 
+/* Used with BaseLayerSharedFlag::CompactVertices. The center distance and
+   outline width are half-floats, color is normalized 8-bit. 26 bytes, padded
+   to 28, which is then supplied as a gap in BaseLayerGL. */
+struct BaseLayerCompactVertex {
+    Vector2 position;
+    Vector2us centerDistance;
+    Vector4us outlineWidth;
+    Color4ub color;
+    UnsignedShort styleUniform;
+};
+
+struct BaseLayerCompactTexturedVertex {
+    BaseLayerCompactVertex vertex;
+    Vector3 textureCoordinates;
+};
+
 struct BaseLayerSubdividedVertex {
     Vector2 position;
     Vector2 outlineWidth;
@@ -139,6 +196,86 @@ static_assert(
     offsetof(BaseLayerSubdividedTexturedVertex, textureScale) == offsetof(BaseLayerSubdividedVertex, centerDistanceY) + sizeof(BaseLayerSubdividedVertex::centerDistanceY),
     "expected textureScale to immediately follow centerDistanceY");
 
+/* Used if BaseLayerSharedFlag::InstancedQuads is enabled, one instance per
+   data in draw order instead of four vertices per data */
+struct BaseLayerInstance {
+    /* Put into a single vertex attribute in BaseLayerGL, thus expected to be
+       next to each other */
+    Vector2 min;
+    Vector2 max;
+    Vector4 outlineWidth;
+    Color4 color;
+    UnsignedInt styleUniform;
+};
+
+struct BaseLayerTexturedInstance {
+    BaseLayerInstance instance;
+    /* Z is the texture layer */
+    Vector3 textureCoordinateMin;
+    Vector2 textureCoordinateMax;
+};
+
+/* Used if BaseLayerSharedFlag::ShaderNodeProperties is enabled. Same as
+   BaseLayerInstance, but with just the padding relative to the node instead
+   of the absolute quad min and max, the color without the node opacity
+   applied and the node ID to fetch the node offset, size and opacity with in
+   the shader. Thus the contents don't depend on any node properties. */
+struct BaseLayerNodeInstance {
+    /* Including the smoothness expansion, left, top, right, bottom */
+    Vector4 padding;
+    Vector4 outlineWidth;
+    Color4 color;
+    UnsignedInt styleUniform;
+    UnsignedInt nodeId;
+};
+
+struct BaseLayerTexturedNodeInstance {
+    BaseLayerNodeInstance instance;
+    /* Z is the texture layer. The smoothness expansion is done in the
+       shader. */
+    Vector3 textureCoordinateOffset;
+    Vector2 textureCoordinateSize;
+};
+
+/* Used if BaseLayerSharedFlag::StableIndices is enabled. A run of data with
+   consecutive IDs in the draw order, starting at `drawOffset` with data
+   `dataId`. The run ends where the next one starts, the last run is a
+   sentinel with `drawOffset` being the total draw count. */
+struct BaseLayerDrawRun {
+    UnsignedInt drawOffset;
+    UnsignedInt dataId;
+};
+
+/* Shader features used by a particular style uniform or data */
+enum: UnsignedByte {
+    BaseLayerFeatureRoundedCorners = 1 << 0,
+    BaseLayerFeatureOutline = 1 << 1
+};
+
+/* Used if BaseLayer::Shared::State::featureMask is non-zero. A run of data
+   in the draw order using the same set of BaseLayerFeature bits, starting at
+   `drawOffset`. The run ends where the next one starts, the last run is a
+   sentinel with `drawOffset` being the total draw count. */
+struct BaseLayerFeatureRun {
+    UnsignedInt drawOffset;
+    UnsignedInt features;
+};
+
+/* Used if BaseLayerBackgroundBlurAlgorithm::DualKawase is chosen. Each
+   downsampling level doubles the extent of the blur, so in order to match a
+   Gaussian blur with given radius done in given count of passes, which is
+   equivalent to a single pass of radius sqrt(passCount)*radius, it's a base-2
+   logarithm of that, rounded to the nearest integer. Always at least one
+   level, even for a zero radius, as otherwise there would be no blur at all.
+   Used by BaseLayer to calculate the blur padding and by BaseLayerGL to pick
+   the level count, has to be consistent between the two. */
+inline UnsignedInt backgroundBlurDualKawaseLevelCount(UnsignedInt radius, UnsignedInt passCount) {
+    /* Multiplying by sqrt(2) before the flooring log2() makes it round to the
+       nearest instead of down */
+    const UnsignedInt combinedRadius = UnsignedInt(Math::sqrt(Float(passCount))*Float(radius)*Constants::sqrt2());
+    return Math::max(1u, Math::log2(Math::max(1u, combinedRadius)));
+}
+
 }
 
 struct BaseLayer::State: AbstractVisualLayer::State {
@@ -167,9 +304,20 @@ struct BaseLayer::State: AbstractVisualLayer::State {
     Containers::Array<Implementation::BaseLayerData> data;
     /* Is either Implementation::BaseLayerVertex, BaseLayerTexturedVertex,
        BaseLayerSubdividedVertex or BaseLayerSubdividedTexturedVertex based on
-       whether texturing / SubdividedQuads is enabled */
+       whether texturing / SubdividedQuads is enabled. With CompactVertices
+       it's BaseLayerCompactVertex or BaseLayerCompactTexturedVertex
+       instead. With InstancedQuads it's BaseLayerInstance or
+       BaseLayerTexturedInstance instead, one per data in draw order, and the
+       indices are unused. With ShaderNodeProperties it's
+       BaseLayerNodeInstance or BaseLayerTexturedNodeInstance. With
+       StableIndices the indices are in data ID order
+       instead of draw order, and the draw order is described by drawRuns. */
     Containers::Array<char> vertices;
     Containers::Array<UnsignedInt> indices;
+    Containers::Array<Implementation::BaseLayerDrawRun> drawRuns;
+    /* Calculated if shared.featureMask is non-zero, BaseLayerGL draws each
+       run with a shader variant that has only the features it uses */
+    Containers::Array<Implementation::BaseLayerFeatureRun> featureRuns;
 
     /* Used for scaling the smoothness expansion to actual pixels, for clipping
        rects in BaseLayerGL and for expanding compositing rects for blur radius
@@ -184,10 +332,47 @@ struct BaseLayer::State: AbstractVisualLayer::State {
 
     /* 0/4 bytes free */
 
+    /* Used only if Flag::OpaqueDepthPrepass is enabled. Two triangles for
+       each opaque quad in draw order, and for each item in the draw order
+       the count of opaque quads before it, plus one item at the end, so a
+       draw of a range of the draw order maps to a range of quads. */
+    Containers::Array<Vector2> opaqueVertices;
+    Containers::Array<UnsignedInt> opaqueQuadOffsets;
+
     /* Used only if shared.dynamicStyleCount is non-zero */
     Containers::ArrayTuple dynamicStyleStorage;
     Containers::ArrayView<BaseLayerStyleUniform> dynamicStyleUniforms;
     Containers::ArrayView<Vector4> dynamicStylePaddings;
+
+    /* Used only if texture streaming is enabled, i.e. if
+       textureStreamingSlotCount is non-zero. The update counter is
+       incremented every time the slots get resolved, slots last used in the
+       current update aren't evicted. */
+    UnsignedInt textureStreamingSlotCount = 0;
+    UnsignedInt textureStreamingPlaceholderStyle;
+    UnsignedInt textureStreamingUpdate = 0;
+    /* 4 bytes free */
+    Containers::Function<bool(UnsignedInt, UnsignedInt)> textureStreamingLoader;
+    Containers::ArrayTuple textureStreamingStorage;
+    /* Indexed by the streamed texture layer, contains the slot it's resident
+       in or ~UnsignedInt{} if it isn't */
+    Containers::ArrayView<UnsignedInt> textureStreamingLayerSlots;
+    /* Indexed by the slot, contain the streamed texture layer occupying it or
+       ~UnsignedInt{} if it's free, the textureStreamingUpdate value at which
+       it was last used, and whether the load is still in progress */
+    Containers::ArrayView<UnsignedInt> textureStreamingSlotLayers;
+    Containers::ArrayView<UnsignedInt> textureStreamingSlotLastUsed;
+    Containers::MutableBitArrayView textureStreamingSlotsLoading;
+    /* Indexed by data ID, contains the slot used by given data in the last
+       update or ~UnsignedInt{} if the placeholder is used. Contents are valid
+       only for data that were drawn in the last update. */
+    Containers::Array<UnsignedInt> textureStreamingDataSlots;
+    /* Texture layer and slot pairs picked in doUpdate() for which the loader
+       wasn't called yet. Used only if the layer advertises
+       LayerFeature::ConcurrentUpdate, in which case doUpdate() may run on a
+       different thread and the loader is called from doPostUpdate()
+       instead. The slots are marked as loading until then. */
+    Containers::Array<Vector2ui> textureStreamingRequests;
 };
 
 }}
@@ -0,0 +1,79 @@
+#ifndef Magnum_Ui_Implementation_breadthFirstNodeOrder_h
+#define Magnum_Ui_Implementation_breadthFirstNodeOrder_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Utility/Algorithms.h>
+
+#include "Magnum/Ui/Implementation/frameArena.h"
+#include "Magnum/Ui/Implementation/orderNodesBreadthFirstInto.h"
+
+/* Used by layouter implementations to have the breadth-first node order
+   calculated only when the node hierarchy changes, as their doUpdate() is
+   called once for every top-level layout run, usually with the same node
+   parents */
+
+namespace Magnum { namespace Ui { namespace Implementation { namespace {
+
+class BreadthFirstNodeOrder {
+    public:
+        /* Returns node IDs in the order produced by
+           orderNodesBreadthFirstInto(), including the first -1 item. The
+           order depends only on the node parents, so it's recalculated only
+           if they differ from the last call. Temporary storage is allocated
+           from `storage`, which is reset afterwards if it was used. */
+        Containers::ArrayView<const Int> update(const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, FrameArena& storage) {
+            /* Initially the order array is empty, so it's always calculated
+               the first time even if there are no nodes */
+            bool upToDate = _nodeIds.size() == nodeParents.size() + 1;
+            for(std::size_t i = 0; upToDate && i != nodeParents.size(); ++i)
+                if(_nodeParents[i] != nodeParents[i])
+                    upToDate = false;
+            if(upToDate)
+                return _nodeIds;
+
+            _nodeParents = Containers::Array<NodeHandle>{NoInit, nodeParents.size()};
+            Utility::copy(nodeParents, _nodeParents);
+            /* +1 for the first element which is -1 indicating a root */
+            _nodeIds = Containers::Array<Int>{NoInit, nodeParents.size() + 1};
+            /* +1 for the last offset, +1 for root nodes */
+            const Containers::ArrayView<UnsignedInt> childrenOffsets = storage.allocate<UnsignedInt>(ValueInit, nodeParents.size() + 2);
+            const Containers::ArrayView<UnsignedInt> children = storage.allocate<UnsignedInt>(NoInit, nodeParents.size());
+            orderNodesBreadthFirstInto(nodeParents, childrenOffsets, children, _nodeIds);
+            /* The temporaries aren't needed anymore, let the caller reuse the
+               memory */
+            storage.reset();
+            return _nodeIds;
+        }
+
+    private:
+        Containers::Array<NodeHandle> _nodeParents;
+        Containers::Array<Int> _nodeIds;
+};
+
+}}}}
+
+#endif
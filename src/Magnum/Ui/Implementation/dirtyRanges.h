@@ -0,0 +1,72 @@
+#ifndef Magnum_Ui_Implementation_dirtyRanges_h
+#define Magnum_Ui_Implementation_dirtyRanges_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> /* std::memcmp() */
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Pair.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+
+/* Detection of changed ranges in CPU-side copies of GPU buffers, used by
+   BaseLayerGL and TextLayerGL through uploadChangedRangesGL.h to upload only
+   parts of vertex and index buffers that changed since the last upload.
+   Extracted to a dedicated header for easier testing. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* Compares `previous` and `current` in blocks of `blockSize` bytes, the last
+   block can be shorter, and fills `ranges` with byte offsets and sizes of
+   the blocks that differ. Adjacent differing blocks are coalesced into a
+   single range. If there's more ranges than the size of `ranges`, the last
+   one gets extended to cover all remaining differing blocks, so the upload is
+   done with a bounded number of calls at the cost of uploading also some
+   unchanged data. Returns the count of ranges written. Both arrays are
+   expected to have the same size, `blockSize` is expected to be non-zero. */
+inline std::size_t dirtyRangesInto(const Containers::ArrayView<const char> previous, const Containers::ArrayView<const char> current, const std::size_t blockSize, const Containers::ArrayView<Containers::Pair<std::size_t, std::size_t>> ranges) {
+    CORRADE_INTERNAL_ASSERT(previous.size() == current.size() && blockSize && !ranges.isEmpty());
+
+    std::size_t count = 0;
+    for(std::size_t offset = 0; offset < current.size(); offset += blockSize) {
+        const std::size_t size = Math::min(blockSize, current.size() - offset);
+        if(std::memcmp(previous.data() + offset, current.data() + offset, size) == 0)
+            continue;
+
+        /* Extend the previous range if it's adjacent or if there's no space
+           for more ranges, otherwise start a new one */
+        if(count && (ranges[count - 1].first() + ranges[count - 1].second() == offset || count == ranges.size()))
+            ranges[count - 1].second() = offset + size - ranges[count - 1].first();
+        else
+            ranges[count++] = {offset, size};
+    }
+
+    return count;
+}
+
+}}}
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef Magnum_Ui_Implementation_fillBaseLayerQuad_h
+#define Magnum_Ui_Implementation_fillBaseLayerQuad_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstddef> /* offsetof() */
+#include <Magnum/Math/Color.h>
+
+#include "Magnum/Ui/Implementation/baseLayerState.h"
+
+#if defined(CORRADE_TARGET_SSE2)
+#include <emmintrin.h>
+#elif defined(CORRADE_TARGET_NEON)
+#include <arm_neon.h>
+#elif defined(CORRADE_TARGET_SIMD128)
+#include <wasm_simd128.h>
+#endif
+
+/* Filling of the four BaseLayerVertex corners of a single quad, used in
+   BaseLayer::doUpdate(). Extracted to a dedicated header in order to test the
+   SIMD variant against the scalar one. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* The SIMD variants write the position together with the center distance and
+   then the outline width and color with single 16-byte stores */
+static_assert(
+    offsetof(BaseLayerVertex, centerDistance) == offsetof(BaseLayerVertex, position) + 8 &&
+    offsetof(BaseLayerVertex, outlineWidth) == offsetof(BaseLayerVertex, position) + 16 &&
+    offsetof(BaseLayerVertex, color) == offsetof(BaseLayerVertex, position) + 32,
+    "unexpected BaseLayerVertex layout");
+
+/* Fills the four vertices of a quad spanning from `min` to `max` in the
+   following order, with the vertices being `stride` bytes apart starting at
+   `data`:
+
+    0---1
+    |   |
+    2---3 */
+inline void fillBaseLayerQuadScalar(char* const data, const std::ptrdiff_t stride, const Vector2& min, const Vector2& max, const Vector4& outlineWidth, const Color4& color, const UnsignedInt styleUniform) {
+    const Vector2 sizeHalf = (max - min)*0.5f;
+    const Vector2 sizeHalfNegative = -sizeHalf;
+    for(UnsignedByte i = 0; i != 4; ++i) {
+        BaseLayerVertex& vertex = *reinterpret_cast<BaseLayerVertex*>(data + i*stride);
+
+        /* ✨ */
+        vertex.position = Math::lerp(min, max, BitVector2{i});
+        vertex.centerDistance = Math::lerp(sizeHalfNegative, sizeHalf, BitVector2{i});
+        vertex.outlineWidth = outlineWidth;
+        vertex.color = color;
+        vertex.styleUniform = styleUniform;
+    }
+}
+
+/* Same as above, but with the corner positions and center distances
+   calculated in a single 128-bit register if SSE2, NEON or WebAssembly SIMD
+   is available. All of these are either a baseline or a compile-time choice
+   on the platforms where they exist, so the variant is picked at compile time
+   and there's nothing to dispatch at runtime. Processing more than one quad
+   at a time wouldn't help much, as the inputs are gathered from per-node
+   arrays and the outputs are interleaved, so the transpositions would eat up
+   the gains. The output is bit-exact with the scalar variant, including the
+   sign of zero center distances. */
+inline void fillBaseLayerQuad(char* const data, const std::ptrdiff_t stride, const Vector2& min, const Vector2& max, const Vector4& outlineWidth, const Color4& color, const UnsignedInt styleUniform) {
+    #if defined(CORRADE_TARGET_SSE2)
+    /* {min.x, min.y, max.x, max.y} */
+    const __m128 minMax = _mm_setr_ps(min.x(), min.y(), max.x(), max.y());
+    /* {sizeHalf.x, sizeHalf.y, -sizeHalf.x, -sizeHalf.y}. The negation is
+       done by flipping the sign bit to match the scalar variant. */
+    const __m128 sizeHalf = _mm_mul_ps(_mm_sub_ps(_mm_movehl_ps(minMax, minMax), minMax), _mm_set1_ps(0.5f));
+    const __m128 sizeHalfBoth = _mm_movelh_ps(sizeHalf, _mm_xor_ps(sizeHalf, _mm_set1_ps(-0.0f)));
+    const __m128 positionCenterDistance[]{
+        _mm_shuffle_ps(minMax, sizeHalfBoth, _MM_SHUFFLE(3, 2, 1, 0)),
+        _mm_shuffle_ps(minMax, sizeHalfBoth, _MM_SHUFFLE(3, 0, 1, 2)),
+        _mm_shuffle_ps(minMax, sizeHalfBoth, _MM_SHUFFLE(1, 2, 3, 0)),
+        _mm_shuffle_ps(minMax, sizeHalfBoth, _MM_SHUFFLE(1, 0, 3, 2)),
+    };
+    const __m128 outlineWidthX4 = _mm_loadu_ps(outlineWidth.data());
+    const __m128 colorX4 = _mm_loadu_ps(color.data());
+    for(UnsignedByte i = 0; i != 4; ++i) {
+        BaseLayerVertex& vertex = *reinterpret_cast<BaseLayerVertex*>(data + i*stride);
+        _mm_storeu_ps(vertex.position.data(), positionCenterDistance[i]);
+        _mm_storeu_ps(vertex.outlineWidth.data(), outlineWidthX4);
+        _mm_storeu_ps(vertex.color.data(), colorX4);
+        vertex.styleUniform = styleUniform;
+    }
+    #elif defined(CORRADE_TARGET_NEON)
+    const float32x2_t min2 = vld1_f32(min.data());
+    const float32x2_t max2 = vld1_f32(max.data());
+    const float32x2_t sizeHalf = vmul_n_f32(vsub_f32(max2, min2), 0.5f);
+    /* {min.x, min.y, -sizeHalf.x, -sizeHalf.y} and
+       {max.x, max.y, sizeHalf.x, sizeHalf.y}, the other two corners are then
+       a per-lane selection of the two */
+    const float32x4_t corner0 = vcombine_f32(min2, vneg_f32(sizeHalf));
+    const float32x4_t corner3 = vcombine_f32(max2, sizeHalf);
+    const UnsignedInt maskXData[]{~0u, 0u, ~0u, 0u};
+    const uint32x4_t maskX = vld1q_u32(maskXData);
+    const float32x4_t positionCenterDistance[]{
+        corner0,
+        vbslq_f32(maskX, corner3, corner0),
+        vbslq_f32(maskX, corner0, corner3),
+        corner3,
+    };
+    const float32x4_t outlineWidthX4 = vld1q_f32(outlineWidth.data());
+    const float32x4_t colorX4 = vld1q_f32(color.data());
+    for(UnsignedByte i = 0; i != 4; ++i) {
+        BaseLayerVertex& vertex = *reinterpret_cast<BaseLayerVertex*>(data + i*stride);
+        vst1q_f32(vertex.position.data(), positionCenterDistance[i]);
+        vst1q_f32(vertex.outlineWidth.data(), outlineWidthX4);
+        vst1q_f32(vertex.color.data(), colorX4);
+        vertex.styleUniform = styleUniform;
+    }
+    #elif defined(CORRADE_TARGET_SIMD128)
+    /* {min.x, min.y, max.x, max.y} */
+    const v128_t minMax = wasm_f32x4_make(min.x(), min.y(), max.x(), max.y());
+    /* {sizeHalf.x, sizeHalf.y, -sizeHalf.x, -sizeHalf.y} */
+    const v128_t sizeHalf = wasm_f32x4_mul(wasm_f32x4_sub(wasm_i32x4_shuffle(minMax, minMax, 2, 3, 0, 1), minMax), wasm_f32x4_splat(0.5f));
+    const v128_t sizeHalfBoth = wasm_i32x4_shuffle(sizeHalf, wasm_f32x4_neg(sizeHalf), 0, 1, 4, 5);
+    const v128_t positionCenterDistance[]{
+        wasm_i32x4_shuffle(minMax, sizeHalfBoth, 0, 1, 6, 7),
+        wasm_i32x4_shuffle(minMax, sizeHalfBoth, 2, 1, 4, 7),
+        wasm_i32x4_shuffle(minMax, sizeHalfBoth, 0, 3, 6, 5),
+        wasm_i32x4_shuffle(minMax, sizeHalfBoth, 2, 3, 4, 5),
+    };
+    const v128_t outlineWidthX4 = wasm_v128_load(outlineWidth.data());
+    const v128_t colorX4 = wasm_v128_load(color.data());
+    for(UnsignedByte i = 0; i != 4; ++i) {
+        BaseLayerVertex& vertex = *reinterpret_cast<BaseLayerVertex*>(data + i*stride);
+        wasm_v128_store(vertex.position.data(), positionCenterDistance[i]);
+        wasm_v128_store(vertex.outlineWidth.data(), outlineWidthX4);
+        wasm_v128_store(vertex.color.data(), colorX4);
+        vertex.styleUniform = styleUniform;
+    }
+    #else
+    fillBaseLayerQuadScalar(data, stride, min, max, outlineWidth, color, styleUniform);
+    #endif
+}
+
+}}}
+
+#endif
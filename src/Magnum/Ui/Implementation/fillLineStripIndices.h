@@ -0,0 +1,130 @@
+#ifndef Magnum_Ui_Implementation_fillLineStripIndices_h
+#define Magnum_Ui_Implementation_fillLineStripIndices_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstddef> /* offsetof() */
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/DebugAssert.h>
+
+#include "Magnum/Ui/Implementation/lineLayerState.h"
+
+#if defined(CORRADE_TARGET_SSE2)
+#include <emmintrin.h>
+#elif defined(CORRADE_TARGET_NEON)
+#include <arm_neon.h>
+#elif defined(CORRADE_TARGET_SIMD128)
+#include <wasm_simd128.h>
+#endif
+
+/* Filling of line strip point indices, used in LineLayer::fillStripIndices(),
+   fillLoopIndices() and appendLineStrip(). Extracted to a dedicated header in
+   order to test the SIMD variant against the scalar one. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* The SIMD variants write two consecutive LineLayerPointIndex items with a
+   single 16-byte store */
+static_assert(
+    sizeof(LineLayerPointIndex) == 8 &&
+    offsetof(LineLayerPointIndex, neighbor) == offsetof(LineLayerPointIndex, index) + 4,
+    "unexpected LineLayerPointIndex layout");
+
+/* Fills a 0, 1, 1, 2, 2, 3, ... strip index sequence into the [begin, end)
+   range of `pointIndices`. The sequence depends only on the position in the
+   strip, not on the point data, so it can be filled just for a part of the
+   strip. Neigbor (which is not a point index but rather an index index, as
+   explained in LineLayer::fillIndices()) points either to the further point
+   in the next segment (+2) or the further point in the previous segment (-2).
+   Values for the first and last element of the whole strip will be wrong
+   here, the caller is expected to patch them to avoid branching on every
+   item. */
+inline void fillLineStripIndexRangeScalar(const Containers::ArrayView<LineLayerPointIndex> pointIndices, const UnsignedInt begin, const UnsignedInt end) {
+    for(UnsignedInt i = begin; i != end; ++i) {
+        pointIndices[i].index = (i >> 1) + (i & 1);
+        pointIndices[i].neighbor = i & 1 ? i + 2 : i - 2;
+    }
+}
+
+/* Same as above, but filling a whole segment, i.e. two items, with a single
+   128-bit store if SSE2, NEON or WebAssembly SIMD is available. Items at even
+   position `i` are `{i/2, i - 2}` and items at odd position are
+   `{i/2 + 1, i + 2}`, so a pair starting at an even position is
+   `{i/2, i - 2, i/2 + 1, i + 3}` and the next pair is that plus
+   `{1, 2, 1, 2}`. As with fillBaseLayerQuad(), all of these are either a
+   baseline or a compile-time choice on the platforms where they exist, so
+   the variant is picked at compile time and there's nothing to dispatch at
+   runtime. A potential odd item at the start and at the end is filled with
+   the scalar variant. The output is the same as with the scalar variant,
+   including the wraparound of the first neighbor. */
+inline void fillLineStripIndexRange(const Containers::ArrayView<LineLayerPointIndex> pointIndices, UnsignedInt begin, const UnsignedInt end) {
+    #if defined(CORRADE_TARGET_SSE2) || defined(CORRADE_TARGET_NEON) || defined(CORRADE_TARGET_SIMD128)
+    CORRADE_INTERNAL_DEBUG_ASSERT(begin <= end && end <= pointIndices.size());
+
+    /* Align the start to a whole segment */
+    if(begin & 1 && begin != end) {
+        fillLineStripIndexRangeScalar(pointIndices, begin, begin + 1);
+        ++begin;
+    }
+
+    UnsignedInt* const data = reinterpret_cast<UnsignedInt*>(pointIndices.data());
+    const UnsignedInt endPair = end & ~1u;
+    #if defined(CORRADE_TARGET_SSE2)
+    __m128i value = _mm_setr_epi32(Int(begin >> 1), Int(begin - 2), Int((begin >> 1) + 1), Int(begin + 3));
+    const __m128i increment = _mm_setr_epi32(1, 2, 1, 2);
+    for(; begin < endPair; begin += 2) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + begin*2), value);
+        value = _mm_add_epi32(value, increment);
+    }
+    #elif defined(CORRADE_TARGET_NEON)
+    const UnsignedInt valueData[]{begin >> 1, begin - 2, (begin >> 1) + 1, begin + 3};
+    const UnsignedInt incrementData[]{1, 2, 1, 2};
+    uint32x4_t value = vld1q_u32(valueData);
+    const uint32x4_t increment = vld1q_u32(incrementData);
+    for(; begin < endPair; begin += 2) {
+        vst1q_u32(data + begin*2, value);
+        value = vaddq_u32(value, increment);
+    }
+    #elif defined(CORRADE_TARGET_SIMD128)
+    v128_t value = wasm_u32x4_make(begin >> 1, begin - 2, (begin >> 1) + 1, begin + 3);
+    const v128_t increment = wasm_u32x4_make(1, 2, 1, 2);
+    for(; begin < endPair; begin += 2) {
+        wasm_v128_store(data + begin*2, value);
+        value = wasm_i32x4_add(value, increment);
+    }
+    #endif
+
+    /* Fill the remaining odd item, if any */
+    if(begin != end)
+        fillLineStripIndexRangeScalar(pointIndices, begin, end);
+    #else
+    fillLineStripIndexRangeScalar(pointIndices, begin, end);
+    #endif
+}
+
+}}}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef Magnum_Ui_Implementation_forEachSetBit_h
+#define Magnum_Ui_Implementation_forEachSetBit_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> /* std::memcpy() */
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+
+/* Iteration over set bits in a BitArrayView, used by animators and layers to
+   go through active animations or data to remove, and a lookup of the first
+   unset bit for allocating dynamic styles. Extracted to a dedicated header as
+   it's used across the whole library. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* Index of the lowest set bit, the value is expected to be non-zero */
+inline UnsignedInt lowestSetBit(UnsignedLong value) {
+    #ifdef CORRADE_TARGET_GCC
+    return __builtin_ctzll(value);
+    #else
+    UnsignedInt bit = 0;
+    while(!(value & 0xff)) {
+        value >>= 8;
+        bit += 8;
+    }
+    while(!(value & 1)) {
+        value >>= 1;
+        ++bit;
+    }
+    return bit;
+    #endif
+}
+
+/* Calls `callback` with the index of every set bit in `bits`, in increasing
+   order. Goes through the view 64 bits at a time, skipping all-zero words
+   right away and then extracting each set bit from the remaining ones with a
+   count-trailing-zeros operation, so it's significantly faster than a
+   per-bit check for sparsely populated views. The callback is allowed to
+   modify the underlying memory, the whole word is loaded before processing
+   it. */
+template<class F> void forEachSetBit(const Containers::BitArrayView bits, F&& callback) {
+    const char* const data = static_cast<const char*>(bits.data());
+    const std::size_t offset = bits.offset();
+    const std::size_t end = offset + bits.size();
+    for(std::size_t wordBegin = 0; wordBegin < end; wordBegin += 64) {
+        /* Load the word byte-by-byte to not need any alignment and not read
+           past the end of the memory. Bits are in a little-endian order, so
+           swap on big-endian platforms to have bit `i` at position `i`. */
+        const std::size_t byteCount = Math::min(std::size_t{8}, (end - wordBegin + 7)/8);
+        UnsignedLong word = 0;
+        std::memcpy(&word, data + wordBegin/8, byteCount);
+        Utility::Endianness::littleEndianInPlace(word);
+
+        /* Mask away bits before the view start and after its end */
+        if(wordBegin < offset)
+            word &= ~0ull << offset;
+        if(end - wordBegin < 64)
+            word &= ~(~0ull << (end - wordBegin));
+
+        while(word) {
+            callback(wordBegin + lowestSetBit(word) - offset);
+            /* Clear the lowest set bit */
+            word &= word - 1;
+        }
+    }
+}
+
+/* Returns index of the first unset bit in `bits` at or after `begin`, or
+   `bits.size()` if all bits from `begin` are set. Goes through the view 64
+   bits at a time like forEachSetBit() above, so an all-set prefix is skipped
+   quickly. */
+inline std::size_t firstUnsetBit(const Containers::BitArrayView bits, const std::size_t begin) {
+    const char* const data = static_cast<const char*>(bits.data());
+    const std::size_t offset = bits.offset();
+    const std::size_t end = offset + bits.size();
+    for(std::size_t wordBegin = (offset + begin)/64*64; wordBegin < end; wordBegin += 64) {
+        const std::size_t byteCount = Math::min(std::size_t{8}, (end - wordBegin + 7)/8);
+        UnsignedLong word = 0;
+        std::memcpy(&word, data + wordBegin/8, byteCount);
+        Utility::Endianness::littleEndianInPlace(word);
+
+        /* Invert to look for set bits instead, and mask away bits before the
+           range start and after the view end */
+        word = ~word;
+        if(wordBegin < offset + begin)
+            word &= ~0ull << (offset + begin - wordBegin);
+        if(end - wordBegin < 64)
+            word &= ~(~0ull << (end - wordBegin));
+
+        if(word)
+            return wordBegin + lowestSetBit(word) - offset;
+    }
+
+    return bits.size();
+}
+
+}}}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef Magnum_Ui_Implementation_frameArena_h
+#define Magnum_Ui_Implementation_frameArena_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> /* std::memset() */
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+
+/* A bump allocator used for temporary and resident data in
+   AbstractUserInterface::update() and elsewhere. Extracted to a dedicated
+   header for easier testing and because it's used by SnapLayouter and
+   TextLayer as well. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* All allocations are taken from a single contiguous block. The block is
+   never resized while allocations from it are alive, if it's exhausted the
+   remaining allocations are served from dedicated overflow allocations, and
+   the block gets enlarged to the high-water mark on the next reset(). Thus,
+   with a stable workload, after the first few frames all allocations are a
+   matter of bumping an offset.
+
+   The storage is meant to hold only trivially copyable types, no
+   constructors or destructors are called. */
+class FrameArena {
+    public:
+        /* Discards all existing allocations. If the allocations done since
+           the last reset() didn't fit, the storage is enlarged to fit all of
+           them. */
+        void reset() {
+            _highWaterMark = Math::max(_highWaterMark, _offset);
+            if(_storage.size() < _highWaterMark)
+                _storage = Containers::Array<char>{NoInit, _highWaterMark};
+            arrayResize(_overflow, 0);
+            _offset = 0;
+        }
+
+        /* Discards all existing allocations and frees the storage. The
+           high-water mark is kept, so the next reset() allocates a block that
+           is large enough right away. */
+        void release() {
+            _highWaterMark = Math::max(_highWaterMark, _offset);
+            _storage = nullptr;
+            _overflow = nullptr;
+            _offset = 0;
+        }
+
+        /* Size of the contiguous block, excluding overflow allocations */
+        std::size_t capacity() const { return _storage.size(); }
+
+        /* Total size of all currently held memory including overflow
+           allocations */
+        std::size_t size() const {
+            std::size_t size = _storage.size();
+            for(const Containers::Array<char>& i: _overflow)
+                size += i.size();
+            return size;
+        }
+
+        /* Largest total amount of memory needed between two reset() calls so
+           far */
+        std::size_t highWaterMark() const {
+            return Math::max(_highWaterMark, _offset);
+        }
+
+        template<class T> Containers::ArrayView<T> allocate(NoInitT, std::size_t size) {
+            return {reinterpret_cast<T*>(allocateBytes(size*sizeof(T), alignof(T))), size};
+        }
+
+        template<class T> Containers::ArrayView<T> allocate(ValueInitT, std::size_t size) {
+            char* const data = allocateBytes(size*sizeof(T), alignof(T));
+            if(size) std::memset(data, 0, size*sizeof(T));
+            return {reinterpret_cast<T*>(data), size};
+        }
+
+        template<class T> Containers::StridedArrayView2D<T> allocate(NoInitT, const Containers::Size2D& size) {
+            return {allocate<T>(NoInit, size[0]*size[1]), size};
+        }
+
+        template<class T> Containers::StridedArrayView2D<T> allocate(ValueInitT, const Containers::Size2D& size) {
+            return {allocate<T>(ValueInit, size[0]*size[1]), size};
+        }
+
+        Containers::MutableBitArrayView allocateBits(NoInitT, std::size_t size) {
+            return {allocate<char>(NoInit, (size + 7)/8).data(), 0, size};
+        }
+
+        Containers::MutableBitArrayView allocateBits(ValueInitT, std::size_t size) {
+            return {allocate<char>(ValueInit, (size + 7)/8).data(), 0, size};
+        }
+
+    private:
+        char* allocateBytes(std::size_t size, std::size_t alignment) {
+            /* Zero-sized allocations don't need any memory at all */
+            if(!size) return nullptr;
+
+            /* The offset is tracked as if all allocations were contiguous,
+               i.e. even the overflow ones, in order to know what size the
+               block should be enlarged to in the next reset(). If an
+               allocation doesn't fit, all following allocations will be
+               overflow as well. The allocation alignment is assumed to be at
+               most the default new alignment, which is what the storage
+               itself is aligned to. */
+            const std::size_t offset = (_offset + alignment - 1)/alignment*alignment;
+            _offset = offset + size;
+            if(_offset <= _storage.size())
+                return _storage.data() + offset;
+
+            return arrayAppend(_overflow, Containers::Array<char>{NoInit, size}).data();
+        }
+
+        Containers::Array<char> _storage;
+        Containers::Array<Containers::Array<char>> _overflow;
+        std::size_t _offset = 0;
+        std::size_t _highWaterMark = 0;
+};
+
+}}}
+
+#endif
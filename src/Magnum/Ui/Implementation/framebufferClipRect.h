@@ -0,0 +1,53 @@
+#ifndef Magnum_Ui_Implementation_framebufferClipRect_h
+#define Magnum_Ui_Implementation_framebufferClipRect_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Range.h>
+
+/* Conversion of clip rects coming from AbstractUserInterface to framebuffer
+   pixels, used by BaseLayerGL and TextLayerGL both for scissor rectangles and
+   for the per-vertex clip rects with the ShaderClipping flags. Extracted to a
+   dedicated header so both code paths produce exactly the same result. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* The offset and size is scaled from UI units to framebuffer pixels with
+   `clipScale`, truncated and Y-flipped. A zero size, which means the clip
+   rect isn't restricting the draw in any way, is the whole framebuffer. */
+inline Range2Di framebufferClipRect(const Vector2& offset, const Vector2& size, const Vector2& clipScale, const Vector2i& framebufferSize) {
+    const Vector2i scaledOffset = Vector2i{offset*clipScale};
+    const Vector2i scaledSize = size.isZero() ?
+        framebufferSize : Vector2i{size*clipScale};
+    return Range2Di::fromSize(
+        {scaledOffset.x(), framebufferSize.y() - scaledOffset.y() - scaledSize.y()},
+        scaledSize);
+}
+
+}}}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef Magnum_Ui_Implementation_lerpFloats_h
+#define Magnum_Ui_Implementation_lerpFloats_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstddef>
+#include <Magnum/Magnum.h>
+
+#if defined(CORRADE_TARGET_SSE2)
+#include <emmintrin.h>
+#elif defined(CORRADE_TARGET_NEON)
+#include <arm_neon.h>
+#elif defined(CORRADE_TARGET_SIMD128)
+#include <wasm_simd128.h>
+#endif
+
+/* Linear interpolation of a contiguous run of floats, used by
+   BaseLayerStyleAnimator and TextLayerStyleAnimator to interpolate whole
+   style uniforms at once instead of member by member. Extracted to a
+   dedicated header in order to test the SIMD variant against the scalar
+   one. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* Calculates `(1 - factor)*a + factor*b` for `count` floats, which is the
+   same operation order as Math::lerp() does */
+inline void lerpFloatsScalar(const Float* const a, const Float* const b, const Float factor, Float* const out, const std::size_t count) {
+    const Float factorInverse = 1.0f - factor;
+    for(std::size_t i = 0; i != count; ++i)
+        out[i] = factorInverse*a[i] + factor*b[i];
+}
+
+/* Same as above, but processing four floats at a time if SSE2, NEON or
+   WebAssembly SIMD is available, with the remainder done with the scalar
+   variant. Like in fillBaseLayerQuad(), the variant is picked at compile
+   time. The multiplication and addition are done separately, so the output
+   is bit-exact with the scalar variant. */
+inline void lerpFloats(const Float* const a, const Float* const b, const Float factor, Float* const out, const std::size_t count) {
+    std::size_t i = 0;
+    #if defined(CORRADE_TARGET_SSE2)
+    const __m128 factorX4 = _mm_set1_ps(factor);
+    const __m128 factorInverseX4 = _mm_set1_ps(1.0f - factor);
+    for(; i + 4 <= count; i += 4)
+        _mm_storeu_ps(out + i, _mm_add_ps(
+            _mm_mul_ps(factorInverseX4, _mm_loadu_ps(a + i)),
+            _mm_mul_ps(factorX4, _mm_loadu_ps(b + i))));
+    #elif defined(CORRADE_TARGET_NEON)
+    const float32x4_t factorX4 = vdupq_n_f32(factor);
+    const float32x4_t factorInverseX4 = vdupq_n_f32(1.0f - factor);
+    for(; i + 4 <= count; i += 4)
+        vst1q_f32(out + i, vaddq_f32(
+            vmulq_f32(factorInverseX4, vld1q_f32(a + i)),
+            vmulq_f32(factorX4, vld1q_f32(b + i))));
+    #elif defined(CORRADE_TARGET_SIMD128)
+    const v128_t factorX4 = wasm_f32x4_splat(factor);
+    const v128_t factorInverseX4 = wasm_f32x4_splat(1.0f - factor);
+    for(; i + 4 <= count; i += 4)
+        wasm_v128_store(out + i, wasm_f32x4_add(
+            wasm_f32x4_mul(factorInverseX4, wasm_v128_load(a + i)),
+            wasm_f32x4_mul(factorX4, wasm_v128_load(b + i))));
+    #endif
+    lerpFloatsScalar(a + i, b + i, factor, out + i, count - i);
+}
+
+}}}
+
+#endif
@@ -63,7 +63,8 @@ struct LineLayer::Shared::State: AbstractVisualLayer::Shared::State {
     #ifndef CORRADE_NO_ASSERT
     bool setStyleCalled = false;
     #endif
-    /* 1 byte free, 2 bytes w/ CORRADE_NO_ASSERT */
+    /* 1 byte free w/ CORRADE_NO_ASSERT */
+    LineLayerSharedFlags flags;
     LineCapStyle capStyle;
     LineJoinStyle joinStyle;
     UnsignedInt styleUniformCount;
@@ -88,6 +89,15 @@ struct LineLayerPointIndex {
     UnsignedInt neighbor;
 };
 
+/* Used by LineLayer::fillIndices() to count the number of times each point is
+   used, and the neighboring point index for the first two of them. For runs
+   with their own points the point storage is abused for it, for runs
+   referencing shared points `LineLayer::State::sharedPointUses` is used. */
+struct LineLayerPointUse {
+    UnsignedInt count;
+    UnsignedInt neighbors[2];
+};
+
 struct LineLayerRun {
     /* If set to ~UnsignedInt{}, given run is unused and gets removed during
        the next recompaction in doUpdate(). */
@@ -102,6 +112,14 @@ struct LineLayerRun {
        for calculating index buffer size, each such join is two additional
        triangles. */
     UnsignedInt joinCount;
+    /* If not ~UnsignedInt{}, the run is decimated and the points are drawn
+       using `decimatedIndexCount` indices at this offset in
+       `LineLayer::State::decimatedPointIndices` instead. The count is never
+       larger than `indexCount` so the decimated vertex data fit into the
+       same place as the original. The decimated line is always an open
+       chain, so its join count is `decimatedIndexCount - 2`. */
+    UnsignedInt decimatedIndexOffset;
+    UnsignedInt decimatedIndexCount;
 };
 
 struct LineLayerData {
@@ -111,7 +129,12 @@ struct LineLayerData {
     /* If 0xff, the alignment coming from style is used. Not using an Optional
        to allow for better padding when more fields are added. */
     LineAlignment alignment;
-    /* 3 bytes free */
+    /* If set, indices of the run reference `LineLayer::State::sharedPoints`
+       instead of the run's own points, and the run has no points */
+    bool sharedPoints;
+    /* 2 bytes free */
+    /* In pixels, if zero the line isn't decimated */
+    Float decimationTolerance;
     Color4 color;
     Vector4 padding;
 };
@@ -124,6 +147,41 @@ enum: UnsignedInt {
     LineVertexAnnotationBegin = 1 << 2
 };
 
+/* Used by LineLayerSharedFlag::InstancedSegments instead of LineLayerVertex,
+   one for each segment. The shader expands it to the same per-vertex inputs
+   LineLayerVertex has, for both ends of the segment and for the vertices of
+   neighbor segments that form the joins. */
+struct LineLayerSegmentInstance {
+    /* Farther point of the segment joined at position0, or zero if there's a
+       cap */
+    Vector2 previousPosition;
+    Vector2 position0;
+    Vector2 position1;
+    /* Farther point of the segment joined at position1, or zero if there's a
+       cap */
+    Vector2 nextPosition;
+    Color4 color0;
+    Color4 color1;
+    /* First 6 bits used for LineSegmentAnnotation* bits from below, the rest
+       is (shifted) style uniform index */
+    UnsignedInt annotationStyleUniform;
+};
+
+/* The same constants are in the shader code as well. Join0 / Join1 is set if
+   the segment has a neighbor at given end, EmitJoin0 / EmitJoin1 if the join
+   triangles should be drawn by this segment and not the neighbor, which
+   follows the same rule as the index buffer generation in the non-instanced
+   case. NeighborBegin0 / NeighborBegin1 is set if the neighbor point closer
+   to given end is the first point of the neighbor segment. */
+enum: UnsignedInt {
+    LineSegmentAnnotationJoin0 = 1 << 0,
+    LineSegmentAnnotationJoin1 = 1 << 1,
+    LineSegmentAnnotationEmitJoin0 = 1 << 2,
+    LineSegmentAnnotationEmitJoin1 = 1 << 3,
+    LineSegmentAnnotationNeighborBegin0 = 1 << 4,
+    LineSegmentAnnotationNeighborBegin1 = 1 << 5
+};
+
 struct LineLayerVertex {
     Vector2 position;
     /** @todo use the overlapping layouts eventually */
@@ -155,7 +213,8 @@ struct LineLayer::State: AbstractVisualLayer::State {
     UnsignedShort styleUpdateStamp;
 
     /* Point data. Only the items referenced from `runs` are valid, the rest is
-       unused space that gets recompacted during each doUpdate(). */
+       unused space that gets recompacted during doUpdate() based on
+       Implementation::shouldCompactRuns() and the counts below. */
     Containers::Array<Implementation::LineLayerPoint> points;
     /* Indices are run-relative, not absolute, so when the runs get recompacted
        they don't need to be updated */
@@ -165,10 +224,29 @@ struct LineLayer::State: AbstractVisualLayer::State {
        layer data. Ordered by the offset. Removed items get marked as unused,
        new items get put at the end, modifying an item if the point / index
        count isn't the same means a removal and an addition. Gets recompacted
-       during each doUpdate(), this process results in the static lines being
+       during doUpdate(), this process results in the static lines being
        eventually pushed to the front of the buffer (which doesn't need to be
        updated as often). */
     Containers::Array<Implementation::LineLayerRun> runs;
+    /* Count of runs marked as unused and count of points / indices not
+       referenced by any run, reset to zero on recompaction */
+    UnsignedInt unusedRunCount = 0,
+        unusedPointCount = 0,
+        unusedPointIndexCount = 0;
+
+    /* Decimated point indices for runs that have decimation enabled,
+       referenced from LineLayerRun::decimatedIndexOffset. Regenerated from
+       scratch for all runs on every data update. */
+    Containers::Array<Implementation::LineLayerPointIndex> decimatedPointIndices;
+    /* Points set by setSharedPoints() and referenced by runs that have
+       `LineLayerData::sharedPoints` set, and a scratch storage of the same
+       size used by fillIndices() for such runs */
+    Containers::Array<Implementation::LineLayerPoint> sharedPoints;
+    Containers::Array<Implementation::LineLayerPointUse> sharedPointUses;
+    /* Size of a pixel in UI units, used to convert decimation tolerance to
+       UI units. Calculated in doSetSize() the same way as the smoothness
+       scaling in LineLayerGL. */
+    Float pixelSize = 0.0f;
 
     /* Data for each text. Index to `runs` above, a style index and other
        properties. */
@@ -183,6 +261,12 @@ struct LineLayer::State: AbstractVisualLayer::State {
        order. */
     Containers::Array<UnsignedInt> indices;
     Containers::Array<UnsignedInt> indexDrawOffsets;
+
+    /* Used instead of `vertices` and `indices` if
+       LineLayerSharedFlag::InstancedSegments is enabled. In draw order, the
+       `indexDrawOffsets` then point into `instances` for each data in draw
+       order. */
+    Containers::Array<Implementation::LineLayerSegmentInstance> instances;
 };
 
 }}
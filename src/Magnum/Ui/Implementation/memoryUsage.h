@@ -0,0 +1,63 @@
+#ifndef Magnum_Ui_Implementation_memoryUsage_h
+#define Magnum_Ui_Implementation_memoryUsage_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/ArrayTuple.h>
+#include <Corrade/Containers/GrowableArray.h>
+
+#include "Magnum/Ui/MemoryUsage.h"
+#include "Magnum/Ui/Implementation/frameArena.h"
+
+/* Helpers for accumulating MemoryUsage of internal CPU-side storage, used by
+   memoryUsage() implementations of all layers, layouters, animators and the
+   user interface itself */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* Size of the array goes to used memory, its capacity to reserved. For
+   arrays that aren't growable the capacity is the same as size. */
+template<class T> inline void addArrayMemoryUsage(MemoryUsage& out, const Containers::Array<T>& array) {
+    out.cpuUsed += array.size()*sizeof(T);
+    out.cpuReserved += arrayCapacity(array)*sizeof(T);
+}
+
+/* Array tuples are allocated at once and never grow */
+inline void addArrayMemoryUsage(MemoryUsage& out, const Containers::ArrayTuple& array) {
+    out.cpuUsed += array.size();
+    out.cpuReserved += array.size();
+}
+
+/* The whole arena is counted as used as nothing else can allocate from the
+   memory it holds */
+inline void addArrayMemoryUsage(MemoryUsage& out, const FrameArena& arena) {
+    out.cpuUsed += arena.size();
+    out.cpuReserved += arena.size();
+}
+
+}}}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef Magnum_Ui_Implementation_runCompaction_h
+#define Magnum_Ui_Implementation_runCompaction_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> /* std::memmove() */
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Magnum.h>
+
+/* Helpers for the run-based storage in TextLayer and LineLayer. Each run
+   references a contiguous range of items in one or more arrays, removed runs
+   are only marked as unused and new runs are put at the end, with doUpdate()
+   then occasionally recompacting the arrays by moving the used runs and
+   their items to the front, preserving their order. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* Item arrays smaller than this get recompacted in every doUpdate() that has
+   any unused runs, as the memmove is cheap. Once larger, they get recompacted
+   only once at least a quarter of the runs or items is unused, to not shift
+   nearly the whole array every time a single run near the front gets
+   changed. The amortized cost of the recompaction is then linear in the
+   amount of changed data. */
+constexpr UnsignedInt RunCompactionMinSize = 1024;
+
+inline bool shouldCompactRuns(const std::size_t runCount, const std::size_t unusedRunCount, const std::size_t itemCount, const std::size_t unusedItemCount) {
+    CORRADE_INTERNAL_DEBUG_ASSERT(unusedRunCount <= runCount && unusedItemCount <= itemCount);
+    return (unusedRunCount || unusedItemCount) && (
+        itemCount < RunCompactionMinSize ||
+        unusedRunCount*4 >= runCount ||
+        unusedItemCount*4 >= itemCount);
+}
+
+/* Moves `count` items at `offset` to `outputOffset` if there were skipped
+   runs before, updates `offset` to the new location and advances
+   `outputOffset` past the items. Meant to be called for each used run in
+   order, after which the arrays can be resized to the final `outputOffset`.
+   The items are expected to be trivially copyable. */
+template<class T> void compactRunItems(const Containers::ArrayView<T> items, UnsignedInt& offset, const UnsignedInt count, std::size_t& outputOffset) {
+    if(offset != outputOffset) {
+        CORRADE_INTERNAL_DEBUG_ASSERT(offset > outputOffset);
+        std::memmove(items.data() + outputOffset,
+                     items.data() + offset,
+                     count*sizeof(T));
+        offset = outputOffset;
+    }
+    outputOffset += count;
+}
+
+}}}
+
+#endif
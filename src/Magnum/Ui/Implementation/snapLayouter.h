@@ -30,6 +30,8 @@
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/Math/Vector4.h>
 
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
+
 namespace Magnum { namespace Ui { namespace Implementation { namespace {
 
 /* Snapping inside given direction is either explicitly or if either filling or
@@ -142,13 +144,10 @@ std::size_t orderLayoutsBreadthFirstInto(const Containers::BitArrayView layoutId
     /* First calculate the count of layouts targeting each node, skipping the
        first element (targeting the UI itself is at index 1, targeting first
        node at index 2) ... */
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != layoutIdsToUpdate.size(); ++i) {
-        if(!layoutIdsToUpdate[i])
-            continue;
+    forEachSetBit(layoutIdsToUpdate, [&](const std::size_t i) {
         const NodeHandle target = layoutTargets[i];
         ++layoutOffsets[target == NodeHandle::Null ? 1 : nodeHandleId(target) + 2];
-    }
+    });
 
     /* ... then convert the counts to a running offset. Now
        `[layoutOffsets[i + 2], layoutOffsets[i + 3])` is a range in which
@@ -168,13 +167,10 @@ std::size_t orderLayoutsBreadthFirstInto(const Containers::BitArrayView layoutId
        now `[layoutOffsets[i + 1], layoutOffsets[i + 2])` is a range in which
        the `layouts` array below contains a list of layouts targeting node `i`.
        The last filled array element is now containing the end offset. */
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != layoutIdsToUpdate.size(); ++i) {
-        if(!layoutIdsToUpdate[i])
-            continue;
+    forEachSetBit(layoutIdsToUpdate, [&](const std::size_t i) {
         const NodeHandle target = layoutTargets[i];
         layouts[layoutOffsets[target == NodeHandle::Null ? 1 : nodeHandleId(target) + 2]++] = i;
-    }
+    });
 
     /* Go through the breadth-first node order and put each that has a layout
        assigned to the output array */
@@ -32,17 +32,22 @@
    implementations */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Reference.h>
 #include <Magnum/Math/Complex.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/AbstractShaper.h>
 #include <Magnum/Text/Alignment.h>
+#include <Magnum/Text/Feature.h>
 #include <Magnum/Text/Renderer.h>
 
 #include "Magnum/Ui/TextLayer.h"
 #include "Magnum/Ui/TextProperties.h"
 #include "Magnum/Ui/Implementation/abstractVisualLayerState.h"
+#include "Magnum/Ui/Implementation/frameArena.h"
 
 namespace Magnum { namespace Ui {
 
@@ -59,6 +64,19 @@ struct TextLayerFont {
     /* Size at which to render divided by `font->size()` */
     Float scale;
     UnsignedInt glyphCacheFontId;
+    /* Used only with TextLayerSharedFlag::GlyphCacheFillOnDemand. Set if
+       AbstractFont::fillGlyphCache() failed for this font, in which case
+       it's not attempted again. */
+    bool glyphCacheFillFailed;
+    /* Used only with TextLayerSharedFlag::GlyphCacheFillDeferred. Font glyph
+       IDs to fill in the next TextLayer::doUpdate(), with the mask being
+       lazily allocated for all font glyphs and used to add each just once. */
+    Containers::Array<UnsignedInt> pendingGlyphs;
+    Containers::BitArray pendingGlyphMask;
+    /* Used only if Configuration::setShaperCount() is larger than 1 and a
+       shape executor is set. Created lazily for each font that's used in a
+       concurrent shaping, one for each task. */
+    Containers::Array<Containers::Pointer<Text::AbstractShaper>> concurrentShapers;
 };
 
 struct TextLayerStyle {
@@ -83,6 +101,83 @@ struct TextLayerEditingStyle {
     Vector4 padding;
 };
 
+/* With TextLayerSharedFlag::GlyphCacheFillDeferred, a glyph that isn't in the
+   glyph cache yet has this bit set in TextLayerGlyphData::glyphId, followed by
+   a 15-bit glyph cache font ID and a 16-bit font glyph ID. TextLayer::doUpdate()
+   replaces it with a cache-global glyph ID after filling the cache. */
+constexpr UnsignedInt TextLayerPendingGlyph = 1u << 31;
+
+struct TextLayerGlyphData {
+    /* (Aligned) position relative to the node origin */
+    Vector2 position;
+    /* Cache-global glyph ID, or TextLayerPendingGlyph combined with a glyph
+       cache font ID and a font glyph ID */
+    UnsignedInt glyphId;
+    /* Cluster ID for cursor positioning in editable text. Initially abused for
+       saving glyph offset + advance (i.e., two Vector2) *somewehere* without
+       having to make a temp allocation. With TextDataFlag::Wrap it's replaced
+       with a combination of TextLayerGlyphWrap* bits after shaping. If the
+       text is neither editable nor wrapped, this retains unspecified advance
+       values. */
+    UnsignedInt glyphCluster;
+};
+
+/* With TextDataFlag::Wrap, TextLayerGlyphData::glyphCluster marks whether the
+   line can be broken after given glyph, which is the case for spaces, and
+   whether there's a forced line break before given glyph, coming from a \n in
+   the source text. Used by TextLayer::doUpdate() to break the shaped text
+   into lines fitting the node width without shaping it again. */
+constexpr UnsignedInt TextLayerGlyphWrapSpace = 1 << 0;
+constexpr UnsignedInt TextLayerGlyphWrapLineBreak = 1 << 1;
+
+struct TextLayerGlyphRun {
+    /* If set to ~UnsignedInt{}, given run is unused and gets removed during
+       the next recompaction in doUpdate(). */
+    UnsignedInt glyphOffset;
+    UnsignedInt glyphCount;
+    /* Backreference to the `TextLayerData` so the `glyphRun` can be updated
+       there when recompacting */
+    UnsignedInt data;
+    /* Ratio of the style size and font size, for appropriately scaling the
+       rectangles coming out of the glyph cache */
+    Float scale;
+    /* Distance between lines, used only by runs of TextDataFlag::Wrap data,
+       unspecified otherwise */
+    Float lineAdvance;
+};
+
+struct TextLayerShapeWorker {
+    /* Same as TextLayer::State::rendererGlyphClusters, except that it puts
+       the data into the arrays below. Always with glyph clusters enabled in
+       TextLayer::State::shapeWorkers, for non-editable text they're just
+       unused. The TextLayer::Shared::State::measureWorker has them disabled
+       as it never deals with editable text. */
+    Text::RendererCore renderer{NoCreate};
+    Containers::Array<TextLayerGlyphData> glyphData;
+    Containers::Array<TextLayerGlyphRun> glyphRuns;
+};
+
+/* A shaped text saved in TextLayer::Shared::State::shapeCache */
+struct TextLayerShapeCacheEntry {
+    /* Font handle, alignment, direction, script, language, features and the
+       text itself, serialized by shapeCacheKeyInto() in TextLayer.cpp.
+       Compared only if the hash matches. */
+    Containers::Array<char> key;
+    Containers::Array<TextLayerGlyphData> glyphData;
+    UnsignedLong hash;
+    Range2D rectangle;
+    /* Value of TextLayer::Shared::State::shapeCacheUsage at the time the
+       entry was last used, the entry with the lowest value gets replaced
+       when the cache is full */
+    UnsignedInt lastUsed;
+    /* Scale of the glyph run. If the text resulted in no glyphs, there's no
+       glyph run and this is unused. */
+    Float scale;
+    /* Alignment resolved based on the shape direction */
+    Text::Alignment alignment;
+    bool hasRun;
+};
+
 }
 
 struct TextLayer::Shared::State: AbstractVisualLayer::Shared::State {
@@ -148,34 +243,39 @@ struct TextLayer::Shared::State: AbstractVisualLayer::Shared::State {
        unused if dynamicStyleCount is 0. */
     Containers::ArrayView<TextLayerEditingStyleUniform> editingStyleUniforms;
     TextLayerCommonEditingStyleUniform commonEditingStyleUniform{NoInit};
-};
-
-namespace Implementation {
 
-struct TextLayerGlyphData {
-    /* (Aligned) position relative to the node origin */
-    Vector2 position;
-    /* Cache-global glyph ID */
-    UnsignedInt glyphId;
-    /* Cluster ID for cursor positioning in editable text. Initially abused for
-       saving glyph offset + advance (i.e., two Vector2) *somewehere* without
-       having to make a temp allocation. If the text is not editable, this
-       retains unspecified advance values. */
-    UnsignedInt glyphCluster;
+    /* Used only if Configuration::setShapeCacheSize() was non-zero. The
+       array has the size of the whole cache, only the first
+       shapeCacheUsedCount entries are used. The usage counter is incremented
+       on every lookup to track which entry was used least recently. The key
+       is a scratch storage for serializing the lookup key, reused across
+       lookups to avoid allocations. */
+    Containers::Array<Implementation::TextLayerShapeCacheEntry> shapeCache;
+    UnsignedInt shapeCacheUsedCount = 0;
+    UnsignedInt shapeCacheUsage = 0;
+    Containers::Array<char> shapeCacheKey;
+
+    /* Used by measure(). The worker is created on first use, the storage is
+       for putting together the style and TextProperties features, reset on
+       every call. */
+    Containers::Optional<Implementation::TextLayerShapeWorker> measureWorker;
+    Implementation::FrameArena measureStorage;
+
+    /* Used only with TextLayerSharedFlag::GlyphCacheFillOnDemand. Scratch
+       storage for font glyph IDs of a shaped text and for those missing from
+       the glyph cache, reused across fills to avoid allocations. */
+    Containers::Array<UnsignedInt> glyphCacheFillFontGlyphIds;
+    Containers::Array<UnsignedInt> glyphCacheFillIds;
+    /* Used only with TextLayerSharedFlag::GlyphCacheFillDeferred. Set if any
+       font has pendingGlyphs, reset after they're filled. */
+    bool hasPendingGlyphs = false;
+
+    /* Used by setText() with multiple texts if shaperCount is larger than 1 */
+    UnsignedInt shaperCount;
+    Containers::Function<void(std::size_t, void(*)(void*, std::size_t), void*)> shapeExecutor;
 };
 
-struct TextLayerGlyphRun {
-    /* If set to ~UnsignedInt{}, given run is unused and gets removed during
-       the next recompaction in doUpdate(). */
-    UnsignedInt glyphOffset;
-    UnsignedInt glyphCount;
-    /* Backreference to the `TextLayerData` so the `glyphRun` can be updated
-       there when recompacting */
-    UnsignedInt data;
-    /* Ratio of the style size and font size, for appropriately scaling the
-       rectangles coming out of the glyph cache */
-    Float scale;
-};
+namespace Implementation {
 
 struct TextLayerTextRun {
     UnsignedInt textOffset;
@@ -203,6 +303,26 @@ struct TextLayerTextRun {
     UnsignedByte direction;
 };
 
+/* Text and properties of data with TextDataFlag::DeferShaping that weren't
+   shaped yet, the features then point to TextLayer::State::deferredFeatures.
+   Same packing as in TextLayerTextRun. */
+struct TextLayerDeferredText {
+    /* Set to ~UnsignedInt{} if unused */
+    UnsignedInt textOffset;
+    UnsignedInt textSize;
+    UnsignedInt featureOffset;
+    UnsignedInt featureCount;
+    /* Backreference to the `TextLayerData` so the `deferredText` can be
+       updated there when recompacting */
+    UnsignedInt data;
+
+    char language[16];
+    Text::Script script;
+    FontHandle font;
+    Text::Alignment alignment;
+    UnsignedByte direction;
+};
+
 struct TextLayerData {
     /* Transformation or padding is used depending on the layer having
        TextLayerFlag::Transformation set */
@@ -219,6 +339,9 @@ struct TextLayerData {
     /* Used only if flags contain TextDataFlag::Editable, otherwise set to
        ~UnsignedInt{} */
     UnsignedInt textRun;
+    /* Used only if flags contain TextDataFlag::DeferShaping and the text
+       wasn't shaped yet, otherwise set to ~UnsignedInt{} */
+    UnsignedInt deferredText;
     /* calculatedStyle is filled by AbstractVisualLayer::doUpdate() */
     UnsignedInt style, calculatedStyle;
     /* Actual rectangle occupied by the text glyphs. Used for cursor /
@@ -259,6 +382,38 @@ struct TextLayerDistanceFieldVertex {
     Float invertedRunScale;
 };
 
+/* Used if TextLayerSharedFlag::InstancedGlyphs is enabled, one instance per
+   drawn glyph in draw order instead of four vertices per glyph. The quad
+   corners are in the same order as the four TextLayerVertex entries, i.e.
+   with the glyph quad produced Y up
+
+    2---3
+    |   |
+    0---1
+
+   and the fourth corner is implicitly `corner1 + corner2 - corner0`, which
+   makes it possible to represent quads rotated and scaled with
+   TextLayerFlag::Transformable as well. */
+struct TextLayerGlyphInstance {
+    /* The first two are put into a single vertex attribute in TextLayerGL,
+       thus expected to be next to each other */
+    Vector2 corner0;
+    Vector2 corner1;
+    Vector2 corner2;
+    /* Z is the glyph cache layer */
+    Vector3 textureCoordinateMin;
+    Vector2 textureCoordinateMax;
+    Color4 color;
+    UnsignedInt styleUniform;
+};
+
+struct TextLayerDistanceFieldGlyphInstance {
+    /* Member and not a base class for the same reason as in
+       TextLayerDistanceFieldVertex */
+    TextLayerGlyphInstance instance;
+    Float invertedRunScale;
+};
+
 struct TextLayerEditingVertex {
     Vector2 position;
     Vector2 centerDistance;
@@ -275,6 +430,60 @@ struct TextLayerDynamicStyle {
     Vector4 padding;
 };
 
+/* A text shaped concurrently in TextLayer::setText() with multiple texts,
+   referencing glyphs in a TextLayerShapeWorker. The inputs are filled
+   serially before shaping, the outputs by the worker. */
+struct TextLayerShapeJob {
+    /* Inputs */
+    Containers::ArrayView<const Text::FeatureRange> features;
+    FontHandle font;
+    Text::Alignment alignment;
+    /* Index into TextLayer::State::shapeWorkers */
+    UnsignedInt worker;
+    /* Outputs, glyphOffset pointing into TextLayerShapeWorker::glyphData */
+    Text::ShapeDirection direction;
+    bool hasRun;
+    Range2D rectangle;
+    UnsignedInt glyphOffset;
+    UnsignedInt glyphCount;
+    Float scale;
+};
+
+/* A single line in TextLayerLineShapeCache */
+struct TextLayerLineShape {
+    /* Line contents in TextLayerLineShapeCache::text */
+    UnsignedInt textOffset;
+    UnsignedInt textSize;
+    /* Shaped glyphs in TextLayerLineShapeCache::glyphIds etc. */
+    UnsignedInt glyphOffset;
+    UnsignedInt glyphCount;
+    /* Direction the shaper resolved for the line */
+    Text::ShapeDirection direction;
+};
+
+/* Shaping results of each line of the most recently shaped multi-line
+   editable text, used by TextLayer::shapeTextInternal() to shape only lines
+   that changed when given text is edited. Font glyph IDs, offsets, advances
+   and clusters are stored as returned by the shaper, with the clusters
+   relative to the line begin. */
+struct TextLayerLineShapeCache {
+    /* Data the lines are for, ~UnsignedInt{} if the cache is unused */
+    UnsignedInt data = ~UnsignedInt{};
+    /* Properties the lines were shaped with */
+    FontHandle font;
+    Text::Script script;
+    UnsignedByte direction;
+    char language[16];
+    Containers::Array<Text::FeatureRange> features;
+
+    Containers::Array<TextLayerLineShape> lines;
+    Containers::Array<char> text;
+    Containers::Array<UnsignedInt> glyphIds;
+    Containers::Array<Vector2> glyphOffsets;
+    Containers::Array<Vector2> glyphAdvances;
+    Containers::Array<UnsignedInt> glyphClusters;
+};
+
 /* Deliberately named differently from TextLayer::dynamicStyleCursorStyle() etc
    to avoid those being called instead by accident */
 inline UnsignedInt cursorStyleForDynamicStyle(UnsignedInt id) {
@@ -319,11 +528,24 @@ struct TextLayer::State: AbstractVisualLayer::State {
     bool dynamicEditingStyleChanged = false;
 
     TextLayerFlags flags;
-    /* 3/7 bytes free */
+    /* Used only with TextLayerSharedFlag::GlyphCacheFillDeferred. Set if
+       glyphData may contain glyph IDs with TextLayerPendingGlyph, which get
+       resolved in doUpdate(). */
+    bool hasPendingGlyphs = false;
+    /* Set by TextLayer::doUpdate() if it shaped any TextDataFlag::DeferShaping
+       text, in which case TextLayerGL::doUpdate() has to upload the data even
+       if it wasn't asked to */
+    bool deferredTextsShaped = false;
+    /* Used only with TextLayerSharedFlag::ShaderTransformation. Set by
+       TextLayer::doUpdate() if it updated `dataTransformations`, reset by
+       TextLayerGL::doUpdate() once it uploads them. */
+    bool dataTransformationsChanged = false;
+    /* 0/4 bytes free */
 
     /* Glyph / text data. Only the items referenced from `glyphRuns` /
        `textRuns` are valid, the rest is unused space that gets recompacted
-       during each doUpdate(). */
+       during doUpdate() based on Implementation::shouldCompactRuns() and the
+       counts below. */
     Containers::Array<Implementation::TextLayerGlyphData> glyphData;
     Containers::Array<char> textData;
 
@@ -337,14 +559,53 @@ struct TextLayer::State: AbstractVisualLayer::State {
     Text::RendererCore renderer;
     Text::RendererCore rendererGlyphClusters;
 
+    /* Scratch memory for temporary data in shapeTextInternal(), reset at the
+       start of each call. The glyph positions, IDs, clusters and advances are
+       allocated directly in `glyphData` above, so this is only feature lists
+       for now. */
+    Implementation::FrameArena shapeStorage;
+
+    /* Used by setText() with multiple texts if it's shaping concurrently. The
+       data IDs are filled for all such calls, the rest only when shaping
+       concurrently, with the storage holding the per-job feature lists.
+       Workers are created on the first concurrent shaping, with their count
+       matching Shared::State::shaperCount. */
+    Containers::Array<UnsignedInt> shapeJobIds;
+    Containers::Array<Implementation::TextLayerShapeJob> shapeJobs;
+    Implementation::FrameArena shapeJobStorage;
+    Containers::Array<Implementation::TextLayerShapeWorker> shapeWorkers;
+
+    /* Lines of the most recently shaped multi-line editable text, and
+       storage for the lines of the currently shaped one that then gets
+       swapped with the former. The arrays are growable in order to reuse
+       their allocations. */
+    Implementation::TextLayerLineShapeCache lineShapeCache, lineShapeCacheNext;
+
     /* Glyph / text runs. Each run is a complete text belogning to one text
        layer data. Ordered by the offset. Removed items get marked as unused,
        new items get put at the end, modifying an item means a removal and an
-       addition. Gets recompacted during each doUpdate(), this process results
-       in the static texts being eventually pushed to the front of the
-       buffer (which doesn't need to be updated as often). */
+       addition, except for large glyph data where the modified run gets
+       reused in place if the new glyphs fit. Gets recompacted during
+       doUpdate(), this process results in the static texts being eventually
+       pushed to the front of the buffer (which doesn't need to be updated as
+       often). */
     Containers::Array<Implementation::TextLayerGlyphRun> glyphRuns;
     Containers::Array<Implementation::TextLayerTextRun> textRuns;
+    /* Count of runs marked as unused and count of glyphs / bytes not
+       referenced by any run, reset to zero on recompaction */
+    UnsignedInt unusedGlyphRunCount = 0,
+        unusedGlyphCount = 0;
+    UnsignedInt unusedTextRunCount = 0,
+        unusedTextSize = 0;
+
+    /* Texts of TextDataFlag::DeferShaping data that weren't shaped yet,
+       together with their text and feature storage. Entries of texts that got
+       shaped or replaced are marked as unused and get removed in doUpdate()
+       once at least half of them is unused. */
+    Containers::Array<Implementation::TextLayerDeferredText> deferredTexts;
+    Containers::Array<char> deferredTextData;
+    Containers::Array<Text::FeatureRange> deferredFeatures;
+    UnsignedInt unusedDeferredTextCount = 0;
 
     /* Data for each text. Index to `glyphRus` and optionally `textRuns` above,
        a style index and other properties. */
@@ -353,14 +614,19 @@ struct TextLayer::State: AbstractVisualLayer::State {
     /* Vertex data, ultimately built from `glyphData` combined with color and
        style index from `data`. Is either Implementation::TextLayerVertex or
        TextLayerDistanceFieldVertex based on whether Flag::DistanceField is
-       enabled */
+       enabled. With Flag::InstancedGlyphs it's TextLayerGlyphInstance or
+       TextLayerDistanceFieldGlyphInstance instead, one per drawn glyph in
+       draw order. */
     Containers::Array<char> vertices;
     /* Vertex data for cursor and selection rectangles */
     Containers::Array<Implementation::TextLayerEditingVertex> editingVertices;
 
     /* Index data, used to draw from `vertices` and `editingVertices`. In draw
        order, the `indexDrawOffsets` then point into `indices` /
-       `editingIndices` for each data in draw order. */
+       `editingIndices` for each data in draw order. With
+       Flag::InstancedGlyphs the `indices` are unused and the first
+       `indexDrawOffsets` element is the offset of the first instance in
+       `vertices` instead. */
     /** @todo any way to make these 16-bit? not really possible in the general
         case given that vertex data get ultimately ordered by frequency of
         change and not by draw order; tho we could maybe assume that there will
@@ -370,6 +636,27 @@ struct TextLayer::State: AbstractVisualLayer::State {
     Containers::Array<UnsignedInt> editingIndices;
     Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> indexDrawOffsets;
 
+    /* Used only with TextLayerSharedFlag::ShaderTransformation, indexed by
+       data ID. Offset of the aligned text origin calculated during the last
+       vertex update, and a transformation calculated from it together with
+       the per-data transformation, with XY being the translation and ZW the
+       combined rotation and scaling. */
+    Containers::Array<Vector2> dataOffsets;
+    Containers::Array<Vector4> dataTransformations;
+
+    /* Used only by TextDataFlag::Wrap data, glyph positions of a single text
+       broken into lines during the last vertex update. The original unwrapped
+       positions stay in `glyphData`, so a node size change only needs to
+       break the lines again. */
+    Containers::Array<Vector2> wrappedGlyphPositions;
+
+    /* Set by doPointerPressEvent() to the data it placed the cursor in, reset
+       on a release or a cancel. A subsequent doPointerMoveEvent() extends the
+       selection only if it's the same data, so a drag that started with a
+       press that focused the node and thus didn't place the cursor doesn't
+       select anything. */
+    UnsignedInt pointerSelectionDataId = ~UnsignedInt{};
+
     /* All these are used only if shared.dynamicStyleCount is non-zero */
 
     /* Each dynamic style points here with TextLayerDynamicStyle::featureOffset
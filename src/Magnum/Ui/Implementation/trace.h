@@ -0,0 +1,82 @@
+#ifndef Magnum_Ui_Implementation_trace_h
+#define Magnum_Ui_Implementation_trace_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/StringView.h>
+
+#include "Magnum/Ui/configure.h"
+
+/* Trace zones around hot paths, reporting to callbacks set with
+   Ui::setTraceCallbacks(). If MAGNUM_UI_WITH_TRACING isn't enabled, the
+   MAGNUM_UI_TRACE_ZONE() macro expands to nothing. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+struct TraceCallbacks {
+    void(*begin)(Containers::StringView, void*);
+    void(*end)(Containers::StringView, void*);
+    void* state;
+};
+
+/* Defined in Trace.cpp */
+extern TraceCallbacks traceCallbacks;
+
+#ifdef MAGNUM_UI_WITH_TRACING
+class TraceZone {
+    public:
+        template<std::size_t size> explicit TraceZone(const char(&name)[size]): _name{name, size - 1, Containers::StringViewFlag::Global|Containers::StringViewFlag::NullTerminated}, _end{traceCallbacks.end}, _state{traceCallbacks.state} {
+            /* Remembering the end callback and state so a change in the
+               callbacks while inside a zone doesn't cause unpaired calls */
+            if(traceCallbacks.begin)
+                traceCallbacks.begin(_name, _state);
+            else _end = nullptr;
+        }
+
+        ~TraceZone() {
+            if(_end)
+                _end(_name, _state);
+        }
+
+        TraceZone(const TraceZone&) = delete;
+        TraceZone& operator=(const TraceZone&) = delete;
+
+    private:
+        Containers::StringView _name;
+        void(*_end)(Containers::StringView, void*);
+        void* _state;
+};
+#endif
+
+}}}
+
+#ifdef MAGNUM_UI_WITH_TRACING
+#define MAGNUM_UI_TRACE_ZONE(name) Magnum::Ui::Implementation::TraceZone _magnumUiTraceZone{name}
+#else
+#define MAGNUM_UI_TRACE_ZONE(name) do {} while(false)
+#endif
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef Magnum_Ui_Implementation_uploadChangedRangesGL_h
+#define Magnum_Ui_Implementation_uploadChangedRangesGL_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Magnum/GL/Buffer.h>
+
+#include "Magnum/Ui/Implementation/dirtyRanges.h"
+
+/* Uploads of CPU-side vertex, index and uniform data to GPU buffers, with
+   only the ranges that changed since the last upload being sent. Used by
+   BaseLayerGL, LineLayerGL and TextLayerGL. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* Uploads `data` at `offset` bytes into `buffer`, with `uploaded` being a
+   copy of what was uploaded there last time. Only the `blockSize`-sized
+   blocks that differ are uploaded, coalesced into a bounded number of
+   ranges, and the `uploaded` copy is updated to match `data` afterwards.
+   Both are expected to have the same size. Returns the count of bytes
+   uploaded. */
+inline std::size_t uploadChangedSubRanges(GL::Buffer& buffer, const std::size_t offset, const Containers::ArrayView<char> uploaded, const Containers::ArrayView<const char> data, const std::size_t blockSize) {
+    CORRADE_INTERNAL_ASSERT(uploaded.size() == data.size());
+    if(data.isEmpty())
+        return 0;
+
+    /** @todo make the range count configurable? or use persistently mapped
+        buffers where available */
+    Containers::Pair<std::size_t, std::size_t> ranges[16];
+    const std::size_t count = dirtyRangesInto(uploaded, data, blockSize, ranges);
+    std::size_t size = 0;
+    for(std::size_t i = 0; i != count; ++i) {
+        const Containers::ArrayView<const char> range = data.sliceSize(ranges[i].first(), ranges[i].second());
+        buffer.setSubData(offset + ranges[i].first(), range);
+        Utility::copy(range, uploaded.sliceSize(ranges[i].first(), ranges[i].second()));
+        size += range.size();
+    }
+    return size;
+}
+
+/* Like uploadChangedSubRanges() with a zero offset, but if the size differs
+   from the `uploaded` copy, the whole buffer is reallocated */
+inline std::size_t uploadChangedRanges(GL::Buffer& buffer, Containers::Array<char>& uploaded, const Containers::ArrayView<const char> data, const std::size_t blockSize) {
+    if(uploaded.size() != data.size()) {
+        buffer.setData(data);
+        uploaded = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, uploaded);
+        return data.size();
+    }
+
+    return uploadChangedSubRanges(buffer, 0, uploaded, data, blockSize);
+}
+
+/* Like uploadChangedRanges(), but meant for data that change size often. The
+   buffer is reallocated only if `data` don't fit into its `capacity`, in
+   which case it's grown to at least double the capacity. Otherwise the
+   changed ranges of the common prefix with the `uploaded` copy are uploaded
+   and any suffix beyond it is uploaded whole. Data past the end of `data`
+   that may be still in the buffer are left there, the caller is expected to
+   not reference them. The `uploaded` copy is expected to be a growable
+   array. */
+inline std::size_t uploadChangedRangesGrowable(GL::Buffer& buffer, std::size_t& capacity, Containers::Array<char>& uploaded, const Containers::ArrayView<const char> data, const std::size_t blockSize) {
+    if(data.size() > capacity) {
+        capacity = Math::max(data.size(), capacity*2);
+        buffer.setData({nullptr, capacity});
+        buffer.setSubData(0, data);
+        arrayResize(uploaded, NoInit, data.size());
+        Utility::copy(data, uploaded);
+        return data.size();
+    }
+
+    const std::size_t commonSize = Math::min(uploaded.size(), data.size());
+    std::size_t size = uploadChangedSubRanges(buffer, 0, uploaded.prefix(commonSize), data.prefix(commonSize), blockSize);
+    arrayResize(uploaded, NoInit, data.size());
+    if(data.size() > commonSize) {
+        const Containers::ArrayView<const char> suffix = data.exceptPrefix(commonSize);
+        buffer.setSubData(commonSize, suffix);
+        Utility::copy(suffix, uploaded.exceptPrefix(commonSize));
+        size += suffix.size();
+    }
+    return size;
+}
+
+/* Shrinks a buffer filled with uploadChangedRangesGrowable() to just what's
+   in the `uploaded` copy, which has the same contents as the buffer
+   prefix, and releases memory reserved in the copy as well */
+inline void shrinkGrowable(GL::Buffer& buffer, std::size_t& capacity, Containers::Array<char>& uploaded) {
+    if(capacity > uploaded.size()) {
+        capacity = uploaded.size();
+        buffer.setData(uploaded);
+    }
+    arrayShrink(uploaded);
+}
+
+}}}
+
+#endif
@@ -0,0 +1,345 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "KeyframeNodeAnimator.h"
+
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Move.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Time.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/NodeFlags.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
+
+namespace Magnum { namespace Ui {
+
+namespace {
+
+struct KeyframeAnimation {
+    /* Range in the keyframe arrays. The count is zero for free and removed
+       animations, which is used to distinguish them when compacting. */
+    UnsignedInt keyframeOffset;
+    UnsignedInt keyframeCount;
+    /* Keyframe at which the previous advance() ended, used as a starting
+       point for the next search as the factor usually only increases */
+    UnsignedInt hint;
+    bool offsets;
+    bool sizes;
+    /* 2 bytes free */
+};
+
+}
+
+struct KeyframeNodeAnimator::State {
+    Containers::Array<KeyframeAnimation> animations;
+
+    /* Keyframes of all animations, each animation occupying a contiguous
+       range. The easing at index i is used between keyframes i and i + 1,
+       the last easing in each range is unused and null. Offsets and sizes are stored
+       even if the animation doesn't animate them, to have just a single
+       range for all. */
+    Containers::Array<Float> keyframeTimes;
+    Containers::Array<Vector2> keyframeOffsets;
+    Containers::Array<Vector2> keyframeSizes;
+    Containers::Array<Float(*)(Float)> keyframeEasings;
+    /* Count of keyframes belonging to removed animations, compacted away
+       in create() once it's more than half of all keyframes */
+    std::size_t removedKeyframeCount = 0;
+};
+
+KeyframeNodeAnimator::KeyframeNodeAnimator(AnimatorHandle handle): AbstractNodeAnimator{handle}, _state{InPlaceInit} {}
+
+KeyframeNodeAnimator::KeyframeNodeAnimator(KeyframeNodeAnimator&&) noexcept = default;
+
+KeyframeNodeAnimator::~KeyframeNodeAnimator() = default;
+
+KeyframeNodeAnimator& KeyframeNodeAnimator::operator=(KeyframeNodeAnimator&&) noexcept = default;
+
+std::size_t KeyframeNodeAnimator::keyframeCapacity() const {
+    return _state->keyframeTimes.size();
+}
+
+AnimationHandle KeyframeNodeAnimator::create(const Containers::ArrayView<const Float> times, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<Float(*const)(Float)>& easings, const Nanoseconds played, const Nanoseconds duration, const NodeHandle node, const UnsignedInt repeatCount, const AnimationFlags flags) {
+    CORRADE_ASSERT(!times.isEmpty(),
+        "Ui::KeyframeNodeAnimator::create(): expected at least one keyframe", {});
+    CORRADE_ASSERT(easings.size() + 1 == times.size(),
+        "Ui::KeyframeNodeAnimator::create(): expected" << times.size() - 1 << "easings for" << times.size() << "keyframes but got" << easings.size(), {});
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != easings.size(); ++i)
+        CORRADE_ASSERT(easings[i],
+            "Ui::KeyframeNodeAnimator::create(): easing" << i << "is null", {});
+    #endif
+    return createInternal(times, offsets, sizes, easings, nullptr, played, duration, node, repeatCount, flags);
+}
+
+AnimationHandle KeyframeNodeAnimator::create(const Containers::ArrayView<const Float> times, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, Float(*const easing)(Float), const Nanoseconds played, const Nanoseconds duration, const NodeHandle node, const UnsignedInt repeatCount, const AnimationFlags flags) {
+    CORRADE_ASSERT(!times.isEmpty(),
+        "Ui::KeyframeNodeAnimator::create(): expected at least one keyframe", {});
+    CORRADE_ASSERT(easing,
+        "Ui::KeyframeNodeAnimator::create(): easing is null", {});
+    return createInternal(times, offsets, sizes, nullptr, easing, played, duration, node, repeatCount, flags);
+}
+
+AnimationHandle KeyframeNodeAnimator::createInternal(const Containers::ArrayView<const Float> times, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<Float(*const)(Float)>& easings, Float(*const easing)(Float), const Nanoseconds played, const Nanoseconds duration, const NodeHandle node, const UnsignedInt repeatCount, const AnimationFlags flags) {
+    CORRADE_ASSERT(!offsets.isEmpty() || !sizes.isEmpty(),
+        "Ui::KeyframeNodeAnimator::create(): expected either offsets or sizes to be non-empty", {});
+    CORRADE_ASSERT(offsets.isEmpty() || offsets.size() == times.size(),
+        "Ui::KeyframeNodeAnimator::create(): expected" << times.size() << "offsets but got" << offsets.size(), {});
+    CORRADE_ASSERT(sizes.isEmpty() || sizes.size() == times.size(),
+        "Ui::KeyframeNodeAnimator::create(): expected" << times.size() << "sizes but got" << sizes.size(), {});
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != times.size(); ++i) {
+        CORRADE_ASSERT(times[i] >= 0.0f && times[i] <= 1.0f,
+            "Ui::KeyframeNodeAnimator::create(): expected keyframe times to be in the [0, 1] range but got" << times[i] << "at index" << i, {});
+        CORRADE_ASSERT(!i || times[i - 1] <= times[i],
+            "Ui::KeyframeNodeAnimator::create(): expected keyframe times to be sorted but got" << times[i] << "after" << times[i - 1] << "at index" << i, {});
+    }
+    #endif
+
+    State& state = *_state;
+
+    /* If more than half of the keyframe storage belongs to removed
+       animations, compact it first. The animations are moved in the order
+       of their IDs, which isn't necessarily the order in which they were
+       in the original arrays, so it's done into a fresh allocation. */
+    if(state.removedKeyframeCount*2 > state.keyframeTimes.size()) {
+        const std::size_t keyframeCount = state.keyframeTimes.size() - state.removedKeyframeCount;
+        Containers::Array<Float> keyframeTimes{NoInit, keyframeCount};
+        Containers::Array<Vector2> keyframeOffsets{NoInit, keyframeCount};
+        Containers::Array<Vector2> keyframeSizes{NoInit, keyframeCount};
+        Containers::Array<Float(*)(Float)> keyframeEasings{NoInit, keyframeCount};
+        UnsignedInt offset = 0;
+        for(KeyframeAnimation& animation: state.animations) {
+            if(!animation.keyframeCount)
+                continue;
+            Utility::copy(state.keyframeTimes.sliceSize(animation.keyframeOffset, animation.keyframeCount), keyframeTimes.sliceSize(offset, animation.keyframeCount));
+            Utility::copy(state.keyframeOffsets.sliceSize(animation.keyframeOffset, animation.keyframeCount), keyframeOffsets.sliceSize(offset, animation.keyframeCount));
+            Utility::copy(state.keyframeSizes.sliceSize(animation.keyframeOffset, animation.keyframeCount), keyframeSizes.sliceSize(offset, animation.keyframeCount));
+            Utility::copy(state.keyframeEasings.sliceSize(animation.keyframeOffset, animation.keyframeCount), keyframeEasings.sliceSize(offset, animation.keyframeCount));
+            animation.keyframeOffset = offset;
+            offset += animation.keyframeCount;
+        }
+        CORRADE_INTERNAL_ASSERT(offset == keyframeCount);
+        state.keyframeTimes = Utility::move(keyframeTimes);
+        state.keyframeOffsets = Utility::move(keyframeOffsets);
+        state.keyframeSizes = Utility::move(keyframeSizes);
+        state.keyframeEasings = Utility::move(keyframeEasings);
+        state.removedKeyframeCount = 0;
+    }
+
+    const AnimationHandle handle = AbstractNodeAnimator::create(played, duration, node, repeatCount, flags);
+    const UnsignedInt id = animationHandleId(handle);
+    if(id >= state.animations.size())
+        arrayResize(state.animations, ValueInit, id + 1);
+
+    KeyframeAnimation& animation = state.animations[id];
+    animation.keyframeOffset = state.keyframeTimes.size();
+    animation.keyframeCount = times.size();
+    animation.hint = 0;
+    animation.offsets = !offsets.isEmpty();
+    animation.sizes = !sizes.isEmpty();
+
+    Utility::copy(times, arrayAppend(state.keyframeTimes, NoInit, times.size()));
+    const Containers::ArrayView<Vector2> keyframeOffsets = arrayAppend(state.keyframeOffsets, ValueInit, times.size());
+    if(animation.offsets)
+        Utility::copy(offsets, keyframeOffsets);
+    const Containers::ArrayView<Vector2> keyframeSizes = arrayAppend(state.keyframeSizes, ValueInit, times.size());
+    if(animation.sizes)
+        Utility::copy(sizes, keyframeSizes);
+    const Containers::ArrayView<Float(*)(Float)> keyframeEasings = arrayAppend(state.keyframeEasings, NoInit, times.size());
+    for(std::size_t i = 0; i != times.size() - 1; ++i)
+        keyframeEasings[i] = easing ? easing : easings[i];
+    keyframeEasings.back() = nullptr;
+
+    return handle;
+}
+
+void KeyframeNodeAnimator::removeInternal(const UnsignedInt id) {
+    State& state = *_state;
+    KeyframeAnimation& animation = state.animations[id];
+    state.removedKeyframeCount += animation.keyframeCount;
+    animation.keyframeCount = 0;
+}
+
+void KeyframeNodeAnimator::remove(const AnimationHandle handle) {
+    AbstractNodeAnimator::remove(handle);
+    removeInternal(animationHandleId(handle));
+}
+
+void KeyframeNodeAnimator::remove(const AnimatorDataHandle handle) {
+    AbstractNodeAnimator::remove(handle);
+    removeInternal(animatorDataHandleId(handle));
+}
+
+Containers::ArrayView<const Float> KeyframeNodeAnimator::times(const AnimationHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::KeyframeNodeAnimator::times(): invalid handle" << handle, {});
+    return timesInternal(animationHandleId(handle));
+}
+
+Containers::ArrayView<const Float> KeyframeNodeAnimator::times(const AnimatorDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::KeyframeNodeAnimator::times(): invalid handle" << handle, {});
+    return timesInternal(animatorDataHandleId(handle));
+}
+
+Containers::ArrayView<const Float> KeyframeNodeAnimator::timesInternal(const UnsignedInt id) const {
+    const State& state = *_state;
+    const KeyframeAnimation& animation = state.animations[id];
+    return state.keyframeTimes.sliceSize(animation.keyframeOffset, animation.keyframeCount);
+}
+
+Containers::ArrayView<const Vector2> KeyframeNodeAnimator::offsets(const AnimationHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::KeyframeNodeAnimator::offsets(): invalid handle" << handle, {});
+    return offsetsInternal(animationHandleId(handle));
+}
+
+Containers::ArrayView<const Vector2> KeyframeNodeAnimator::offsets(const AnimatorDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::KeyframeNodeAnimator::offsets(): invalid handle" << handle, {});
+    return offsetsInternal(animatorDataHandleId(handle));
+}
+
+Containers::ArrayView<const Vector2> KeyframeNodeAnimator::offsetsInternal(const UnsignedInt id) const {
+    const State& state = *_state;
+    const KeyframeAnimation& animation = state.animations[id];
+    if(!animation.offsets)
+        return {};
+    return state.keyframeOffsets.sliceSize(animation.keyframeOffset, animation.keyframeCount);
+}
+
+Containers::ArrayView<const Vector2> KeyframeNodeAnimator::sizes(const AnimationHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::KeyframeNodeAnimator::sizes(): invalid handle" << handle, {});
+    return sizesInternal(animationHandleId(handle));
+}
+
+Containers::ArrayView<const Vector2> KeyframeNodeAnimator::sizes(const AnimatorDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::KeyframeNodeAnimator::sizes(): invalid handle" << handle, {});
+    return sizesInternal(animatorDataHandleId(handle));
+}
+
+Containers::ArrayView<const Vector2> KeyframeNodeAnimator::sizesInternal(const UnsignedInt id) const {
+    const State& state = *_state;
+    const KeyframeAnimation& animation = state.animations[id];
+    if(!animation.sizes)
+        return {};
+    return state.keyframeSizes.sliceSize(animation.keyframeOffset, animation.keyframeCount);
+}
+
+auto KeyframeNodeAnimator::easings(const AnimationHandle handle) const -> Containers::ArrayView<Float(*const)(Float)> {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::KeyframeNodeAnimator::easings(): invalid handle" << handle, {});
+    return easingsInternal(animationHandleId(handle));
+}
+
+auto KeyframeNodeAnimator::easings(const AnimatorDataHandle handle) const -> Containers::ArrayView<Float(*const)(Float)> {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::KeyframeNodeAnimator::easings(): invalid handle" << handle, {});
+    return easingsInternal(animatorDataHandleId(handle));
+}
+
+auto KeyframeNodeAnimator::easingsInternal(const UnsignedInt id) const -> Containers::ArrayView<Float(*const)(Float)> {
+    const State& state = *_state;
+    const KeyframeAnimation& animation = state.animations[id];
+    /* The last easing in the range is unused */
+    return state.keyframeEasings.sliceSize(animation.keyframeOffset, animation.keyframeCount - 1);
+}
+
+void KeyframeNodeAnimator::doReserve(const std::size_t capacity) {
+    arrayReserve(_state->animations, capacity);
+}
+
+void KeyframeNodeAnimator::doClean(const Containers::BitArrayView animationIdsToRemove) {
+    Implementation::forEachSetBit(animationIdsToRemove, [&](const std::size_t i) {
+        removeInternal(i);
+    });
+}
+
+NodeAnimations KeyframeNodeAnimator::doAdvance(const Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes, const Containers::StridedArrayView1D<NodeFlags>&, Containers::MutableBitArrayView) {
+    State& state = *_state;
+    const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+    const Float* const keyframeTimes = state.keyframeTimes.data();
+    const Vector2* const keyframeOffsets = state.keyframeOffsets.data();
+    const Vector2* const keyframeSizes = state.keyframeSizes.data();
+    Float(*const* const keyframeEasings)(Float) = state.keyframeEasings.data();
+
+    NodeAnimations animations;
+    Implementation::forEachSetBit(active, [&](const std::size_t i) {
+        /* Animations not attached to any node are still played, but don't
+           affect anything */
+        const NodeHandle node = nodes[i];
+        if(node == NodeHandle::Null)
+            return;
+
+        KeyframeAnimation& animation = state.animations[i];
+        const Float* const times = keyframeTimes + animation.keyframeOffset;
+        const Float factor = factors[i];
+
+        /* Find the last keyframe that's not after the factor, starting from
+           the previous one unless the factor went back, such as when the
+           animation got restarted or is repeated */
+        UnsignedInt keyframe = animation.hint;
+        if(times[keyframe] > factor)
+            keyframe = 0;
+        while(keyframe + 1 < animation.keyframeCount && times[keyframe + 1] <= factor)
+            ++keyframe;
+        animation.hint = keyframe;
+
+        /* Before the first keyframe or at / after the last the values are
+           clamped, otherwise interpolated with the easing of given keyframe.
+           As the next keyframe is strictly greater than the factor, the
+           division is never by zero. */
+        const std::size_t a = animation.keyframeOffset + keyframe;
+        std::size_t b;
+        Float t;
+        if(keyframe + 1 == animation.keyframeCount || factor <= times[keyframe]) {
+            b = a;
+            t = 0.0f;
+        } else {
+            b = a + 1;
+            t = keyframeEasings[a]((factor - times[keyframe])/(times[keyframe + 1] - times[keyframe]));
+        }
+
+        const UnsignedInt nodeId = nodeHandleId(node);
+        if(animation.offsets)
+            nodeOffsets[nodeId] = Math::lerp(keyframeOffsets[a], keyframeOffsets[b], t);
+        if(animation.sizes)
+            nodeSizes[nodeId] = Math::lerp(keyframeSizes[a], keyframeSizes[b], t);
+        animations |= NodeAnimation::OffsetSize;
+    });
+
+    return animations;
+}
+
+}}
@@ -0,0 +1,277 @@
+#ifndef Magnum_Ui_KeyframeNodeAnimator_h
+#define Magnum_Ui_KeyframeNodeAnimator_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Ui::KeyframeNodeAnimator
+ * @m_since_latest
+ */
+
+#include "Magnum/Ui/AbstractAnimator.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Keyframe node animator
+@m_since_latest
+
+Each animation is a list of keyframes for node offset, size or both, attached
+to a particular node. Compared to @ref GenericNodeAnimator, where every
+animation is an arbitrary function called through an indirection and
+typically capturing its own state, the keyframes of all animations are stored
+in a few contiguous arrays and evaluated in a single loop that writes directly
+to the node offsets and sizes, which makes it better suited for large amounts
+of simultaneously running animations.
+
+@section Ui-KeyframeNodeAnimator-setup Setting up an animator instance
+
+The animator doesn't have any shared state or configuration, so it's just about
+constructing it from a fresh @ref AbstractUserInterface::createAnimator()
+handle and passing it to @relativeref{AbstractUserInterface,setNodeAnimatorInstance()}.
+After that, assuming @ref AbstractUserInterface::advanceAnimations() is called
+in an appropriate place, it's ready to use.
+
+Unlike builtin layers or layouters, the default @ref UserInterface
+implementation doesn't implicitly provide a @ref KeyframeNodeAnimator
+instance.
+
+@section Ui-KeyframeNodeAnimator-create Creating animations
+
+An animation is created by calling @ref create() with a list of keyframe
+times, corresponding node offsets and / or sizes, easing functions used to
+interpolate between consecutive keyframes, time at which it's meant to be
+played, its duration and the @ref NodeHandle it's attached to. The keyframe
+times are in the @f$ [0, 1] @f$ range relative to the animation duration,
+with the offsets and sizes being clamped to the first and last keyframe
+outside of the range they span. Pass an empty view for either offsets or
+sizes to not animate given property.
+
+At least one keyframe has to be specified, with a single keyframe the node
+offset or size is simply set to a constant value for the whole animation
+duration.
+
+@section Ui-KeyframeNodeAnimator-lifetime Animation lifetime and node attachment
+
+As with all other animations, they're implicitly removed once they're played.
+Pass @ref AnimationFlag::KeepOncePlayed to @ref create() or @ref addFlags() to
+disable this behavior.
+
+When the node the animation is attached to is removed, the animation gets
+removed as well. If the animation gets detached from the node with
+@ref attach(AnimationHandle, NodeHandle) or the node is @ref NodeHandle::Null
+in the first place, the animation is still played, but doesn't affect
+anything.
+*/
+class MAGNUM_UI_EXPORT KeyframeNodeAnimator: public AbstractNodeAnimator {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle    Handle returned by
+         *      @ref AbstractUserInterface::createAnimator()
+         */
+        explicit KeyframeNodeAnimator(AnimatorHandle handle);
+
+        /** @brief Copying is not allowed */
+        KeyframeNodeAnimator(const KeyframeNodeAnimator&) = delete;
+
+        /** @copydoc AbstractAnimator::AbstractAnimator(AbstractAnimator&&) */
+        KeyframeNodeAnimator(KeyframeNodeAnimator&&) noexcept;
+
+        ~KeyframeNodeAnimator();
+
+        /** @brief Copying is not allowed */
+        KeyframeNodeAnimator& operator=(const KeyframeNodeAnimator&) = delete;
+
+        /** @brief Move assignment */
+        KeyframeNodeAnimator& operator=(KeyframeNodeAnimator&&) noexcept;
+
+        /**
+         * @brief Count of stored keyframes
+         *
+         * Includes also keyframes of animations that were removed but weren't
+         * compacted away yet. The storage is compacted in @ref create() once
+         * more than half of it is unused.
+         */
+        std::size_t keyframeCapacity() const;
+
+        /**
+         * @brief Create an animation
+         * @param times         Keyframe times in the @f$ [0, 1] @f$ range
+         *      relative to @p duration
+         * @param offsets       Node offsets for each keyframe or an empty
+         *      view to not animate the offset
+         * @param sizes         Node sizes for each keyframe or an empty view
+         *      to not animate the size
+         * @param easings       Easing functions applied between each pair of
+         *      consecutive keyframes. Pick from
+         *      @ref Animation::BasicEasing "Animation::Easing" or supply
+         *      custom ones.
+         * @param played        Time at which the animation is played. Use
+         *      @ref Nanoseconds::max() for creating a stopped animation.
+         * @param duration      Duration of a single play of the animation
+         * @param node          Node the animation is attached to. Use
+         *      @ref NodeHandle::Null to create an animation that isn't
+         *      attached to any node.
+         * @param repeatCount   Repeat count. Use @cpp 0 @ce for an
+         *      indefinitely repeating animation.
+         * @param flags         Flags
+         *
+         * Expects that @p times isn't empty and is sorted in an ascending
+         * order with all values in the @f$ [0, 1] @f$ range, that @p offsets
+         * and @p sizes are either empty or have the same size as @p times and
+         * aren't both empty, and that @p easings has one item less than
+         * @p times, with none of them being @cpp nullptr @ce. The data are
+         * copied into the animator. Delegates to
+         * @ref AbstractAnimator::create(Nanoseconds, Nanoseconds, NodeHandle, UnsignedInt, AnimationFlags),
+         * see its documentation for more information.
+         */
+        AnimationHandle create(Containers::ArrayView<const Float> times, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<Float(*const)(Float)>& easings, Nanoseconds played, Nanoseconds duration, NodeHandle node, UnsignedInt repeatCount = 1, AnimationFlags flags = {});
+
+        /**
+         * @brief Create an animation with the same easing function between all keyframes
+         *
+         * Same as calling @ref create(Containers::ArrayView<const Float>, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<Float(*const)(Float)>&, Nanoseconds, Nanoseconds, NodeHandle, UnsignedInt, AnimationFlags)
+         * with @p easing repeated for every pair of consecutive keyframes.
+         * Expects that @p easing isn't @cpp nullptr @ce.
+         */
+        AnimationHandle create(Containers::ArrayView<const Float> times, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, Float(*easing)(Float), Nanoseconds played, Nanoseconds duration, NodeHandle node, UnsignedInt repeatCount = 1, AnimationFlags flags = {});
+
+        /**
+         * @brief Remove an animation
+         *
+         * Expects that @p handle is valid. Delegates to
+         * @ref AbstractAnimator::remove(AnimationHandle), see its
+         * documentation for more information.
+         */
+        void remove(AnimationHandle handle);
+
+        /**
+         * @brief Remove an animation assuming it belongs to this animator
+         *
+         * Compared to @ref remove(AnimationHandle) delegates to
+         * @ref AbstractAnimator::remove(AnimatorDataHandle) instead.
+         */
+        void remove(AnimatorDataHandle handle);
+
+        /**
+         * @brief Animation keyframe times
+         *
+         * Expects that @p handle is valid. The returned view is never empty
+         * and is only guaranteed to stay valid until the next @ref create()
+         * call.
+         */
+        Containers::ArrayView<const Float> times(AnimationHandle handle) const;
+
+        /**
+         * @brief Animation keyframe times assuming it belongs to this animator
+         *
+         * Like @ref times(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator. See its documentation for
+         * more information.
+         * @see @ref animationHandleData()
+         */
+        Containers::ArrayView<const Float> times(AnimatorDataHandle handle) const;
+
+        /**
+         * @brief Animation keyframe offsets
+         *
+         * Expects that @p handle is valid. The returned view is either empty,
+         * if the animation doesn't animate node offset, or has the same size
+         * as @ref times(AnimationHandle) const, and is only guaranteed to stay
+         * valid until the next @ref create() call.
+         */
+        Containers::ArrayView<const Vector2> offsets(AnimationHandle handle) const;
+
+        /**
+         * @brief Animation keyframe offsets assuming it belongs to this animator
+         *
+         * Like @ref offsets(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator. See its documentation for
+         * more information.
+         * @see @ref animationHandleData()
+         */
+        Containers::ArrayView<const Vector2> offsets(AnimatorDataHandle handle) const;
+
+        /**
+         * @brief Animation keyframe sizes
+         *
+         * Expects that @p handle is valid. The returned view is either empty,
+         * if the animation doesn't animate node size, or has the same size as
+         * @ref times(AnimationHandle) const, and is only guaranteed to stay
+         * valid until the next @ref create() call.
+         */
+        Containers::ArrayView<const Vector2> sizes(AnimationHandle handle) const;
+
+        /**
+         * @brief Animation keyframe sizes assuming it belongs to this animator
+         *
+         * Like @ref sizes(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator. See its documentation for
+         * more information.
+         * @see @ref animationHandleData()
+         */
+        Containers::ArrayView<const Vector2> sizes(AnimatorDataHandle handle) const;
+
+        /**
+         * @brief Animation keyframe easing functions
+         *
+         * Expects that @p handle is valid. The returned view has one item
+         * less than @ref times(AnimationHandle) const, none of the pointers
+         * are @cpp nullptr @ce. The view is only guaranteed to stay valid
+         * until the next @ref create() call.
+         */
+        auto easings(AnimationHandle handle) const -> Containers::ArrayView<Float(*const)(Float)>;
+
+        /**
+         * @brief Animation keyframe easing functions assuming it belongs to this animator
+         *
+         * Like @ref easings(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator. See its documentation for
+         * more information.
+         * @see @ref animationHandleData()
+         */
+        auto easings(AnimatorDataHandle handle) const -> Containers::ArrayView<Float(*const)(Float)>;
+
+    private:
+        MAGNUM_UI_LOCAL AnimationHandle createInternal(Containers::ArrayView<const Float> times, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<Float(*const)(Float)>& easings, Float(*easing)(Float), Nanoseconds played, Nanoseconds duration, NodeHandle node, UnsignedInt repeatCount, AnimationFlags flags);
+        MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
+        MAGNUM_UI_LOCAL Containers::ArrayView<const Float> timesInternal(UnsignedInt id) const;
+        MAGNUM_UI_LOCAL Containers::ArrayView<const Vector2> offsetsInternal(UnsignedInt id) const;
+        MAGNUM_UI_LOCAL Containers::ArrayView<const Vector2> sizesInternal(UnsignedInt id) const;
+        MAGNUM_UI_LOCAL Containers::ArrayView<Float(*const)(Float)> easingsInternal(UnsignedInt id) const;
+
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
+        MAGNUM_UI_LOCAL void doClean(Containers::BitArrayView animationIdsToRemove) override;
+        MAGNUM_UI_LOCAL NodeAnimations doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes, const Containers::StridedArrayView1D<NodeFlags>& nodeFlags, Containers::MutableBitArrayView nodesRemove) override;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -26,14 +26,23 @@
 
 #include "LineLayer.h"
 
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/EnumSet.hpp>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Magnum/Math/Distance.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Swizzle.h>
 
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/Implementation/fillLineStripIndices.h"
 #include "Magnum/Ui/Implementation/lineLayerState.h"
 #include "Magnum/Ui/Implementation/lineMiterLimit.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
+#include "Magnum/Ui/Implementation/runCompaction.h"
 
 namespace Magnum { namespace Ui {
 
@@ -101,7 +110,27 @@ Debug& operator<<(Debug& debug, const LineAlignment value) {
     return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
 }
 
-LineLayer::Shared::State::State(Shared& self, const Configuration& configuration): AbstractVisualLayer::Shared::State{self, configuration.styleCount(), 0}, capStyle{configuration.capStyle()}, joinStyle{configuration.joinStyle()}, styleUniformCount{configuration.styleUniformCount()} {
+Debug& operator<<(Debug& debug, const LineLayerSharedFlag value) {
+    debug << "Ui::LineLayerSharedFlag" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case LineLayerSharedFlag::value: return debug << "::" #value;
+        _c(InstancedSegments)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+}
+
+Debug& operator<<(Debug& debug, const LineLayerSharedFlags value) {
+    return Containers::enumSetDebugOutput(debug, value, "Ui::LineLayerSharedFlags{}", {
+        LineLayerSharedFlag::InstancedSegments
+    });
+}
+
+LineLayer::Shared::State::State(Shared& self, const Configuration& configuration): AbstractVisualLayer::Shared::State{self, configuration.styleCount(), 0}, flags{configuration.flags()}, capStyle{configuration.capStyle()}, joinStyle{configuration.joinStyle()}, styleUniformCount{configuration.styleUniformCount()} {
     styleStorage = Containers::ArrayTuple{
         {NoInit, configuration.styleCount(), styles},
     };
@@ -125,6 +154,10 @@ LineJoinStyle LineLayer::Shared::joinStyle() const {
     return static_cast<const State&>(*_state).joinStyle;
 }
 
+LineLayerSharedFlags LineLayer::Shared::flags() const {
+    return static_cast<const State&>(*_state).flags;
+}
+
 void LineLayer::Shared::setStyleInternal(const LineLayerCommonStyleUniform& commonUniform, const Containers::ArrayView<const LineLayerStyleUniform> uniforms, const Containers::StridedArrayView1D<const LineAlignment>& styleAlignments, const Containers::StridedArrayView1D<const Vector4>& stylePaddings) {
     State& state = static_cast<State&>(*_state);
     CORRADE_ASSERT(uniforms.size() == state.styleUniformCount,
@@ -206,10 +239,25 @@ UnsignedInt LineLayer::createRun(const UnsignedInt dataId, const UnsignedInt ind
     const UnsignedInt pointIndexOffset = state.pointIndices.size();
     arrayAppend(state.points, NoInit, pointCount);
     arrayAppend(state.pointIndices, NoInit, indexCount);
-    arrayAppend(state.runs, InPlaceInit, pointOffset, pointCount, pointIndexOffset, indexCount, dataId, 0u);
+    arrayAppend(state.runs, InPlaceInit, pointOffset, pointCount, pointIndexOffset, indexCount, dataId, 0u, ~UnsignedInt{}, 0u);
     return run;
 }
 
+void LineLayer::removeRun(const UnsignedInt run) {
+    State& state = static_cast<State&>(*_state);
+
+    /* Mark the run as unused and remember how much space it occupies so
+       doUpdate() can decide whether it's worth recompacting. Both
+       `indexOffset` and `pointOffset` are marked to avoid inconsistency. */
+    Implementation::LineLayerRun& runData = state.runs[run];
+    CORRADE_INTERNAL_DEBUG_ASSERT(runData.indexOffset != ~UnsignedInt{});
+    runData.indexOffset = ~UnsignedInt{};
+    runData.pointOffset = ~UnsignedInt{};
+    ++state.unusedRunCount;
+    state.unusedPointCount += runData.pointCount;
+    state.unusedPointIndexCount += runData.indexCount;
+}
+
 void LineLayer::fillIndices(const char*
     #ifndef CORRADE_NO_ASSERT
     const messagePrefix
@@ -229,17 +277,22 @@ void LineLayer::fillIndices(const char*
        used exactly twice, consider that a line join, if once or more than
        twice, consider that a cap. If the point isn't used at all, it'll
        ultimately stays unused when processing the index buffer in doUpdate()
-       later. */
-    struct PointUse {
-        UnsignedInt count;
-        UnsignedInt neighbors[2];
-    };
-    const Containers::StridedArrayView1D<PointUse> pointUses = Containers::arrayCast<PointUse>(stridedArrayView(state.points.sliceSize(run.pointOffset, run.pointCount)).slice(&Implementation::LineLayerPoint::position));
-    for(PointUse& i: pointUses)
-        i = {0, {~UnsignedInt{}, ~UnsignedInt{}}};
+       later. Runs referencing shared points have no points of their own, so
+       a dedicated scratch storage of the same size as the shared points is
+       used for them instead. */
+    const bool sharedPoints = state.data[dataId].sharedPoints;
+    const UnsignedInt pointCount = sharedPoints ? state.sharedPoints.size() : run.pointCount;
+    const Containers::StridedArrayView1D<Implementation::LineLayerPointUse> pointUses = sharedPoints ?
+        stridedArrayView(state.sharedPointUses) :
+        Containers::arrayCast<Implementation::LineLayerPointUse>(stridedArrayView(state.points.sliceSize(run.pointOffset, run.pointCount)).slice(&Implementation::LineLayerPoint::position));
+    /* Reset only the entries that are actually used, as with shared points
+       the storage can be considerably larger than the index count */
+    for(std::size_t i = 0; i != indices.size(); ++i) {
+        CORRADE_DEBUG_ASSERT(indices[i] < pointCount,
+            messagePrefix << "index" << indices[i] << "out of range for" << pointCount << "points" << "at index" << i, );
+        pointUses[indices[i]] = {0, {~UnsignedInt{}, ~UnsignedInt{}}};
+    }
     for(std::size_t i = 0; i != indices.size(); ++i) {
-        CORRADE_DEBUG_ASSERT(indices[i] < run.pointCount,
-            messagePrefix << "index" << indices[i] << "out of range for" << run.pointCount << "points" << "at index" << i, );
         /* If this is the second from the index pair, neighbor is the first
            from the pair and vice versa. We're however not storing the point
            index, but the index index, as we ultimately need to reference a
@@ -251,7 +304,7 @@ void LineLayer::fillIndices(const char*
            should't have any neighbors, thus skip. */
         if(indices[i] == indices[neighbor])
             continue;
-        PointUse& pointUse = pointUses[indices[i]];
+        Implementation::LineLayerPointUse& pointUse = pointUses[indices[i]];
         /* If we have so far 1 neighbor and it's the same as this one, skip as
            well -- it'd result in a two-point loop, which isn't really possible
            to render anyway. */
@@ -269,7 +322,7 @@ void LineLayer::fillIndices(const char*
     const Containers::ArrayView<Implementation::LineLayerPointIndex> pointIndices = state.pointIndices.sliceSize(run.indexOffset, run.indexCount);
     for(std::size_t i = 0; i != indices.size(); ++i) {
         pointIndices[i] = {indices[i], ~UnsignedInt{}};
-        const PointUse& pointUse = pointUses[indices[i]];
+        const Implementation::LineLayerPointUse& pointUse = pointUses[indices[i]];
 
         /* The stored neighbor is always the one that isn't already known from
            the other element of the pair */
@@ -303,17 +356,7 @@ void LineLayer::fillStripIndices(const char*
        isn't good. Fail in that case. */
     CORRADE_ASSERT(run.indexCount || !run.pointCount,
         messagePrefix << "expected either no or at least two points, got" << run.pointCount, );
-    UnsignedInt i = 0;
-    for(Implementation::LineLayerPointIndex& index: state.pointIndices.sliceSize(run.indexOffset, run.indexCount)) {
-        index.index = (i >> 1) + (i & 1);
-        /* Neigbor (which is not a point index but rather an index index, as
-           explained in fillIndices() above) points either to the further point
-           in the next segment (+2) or the further point in the previous
-           segment (-2). Begin / end values will be wrong here, they get
-           patched after the loop to avoid branching on every item. */
-        index.neighbor = i & 1 ? i + 2 : i - 2;
-        ++i;
-    }
+    Implementation::fillLineStripIndexRange(state.pointIndices.sliceSize(run.indexOffset, run.indexCount), 0, run.indexCount);
 
     /* If there are no points at all, there are no joins either. */
     if(!run.indexCount) {
@@ -347,18 +390,9 @@ void LineLayer::fillLoopIndices(const char*
     CORRADE_ASSERT(run.pointCount != 2,
         messagePrefix << "expected either no, one or at least three points, got" << run.pointCount, );
 
-    /* A 0, 1, 1, 2, 2, 3, ..., n - 1, 0 index sequence */
-    UnsignedInt i = 0;
-    for(Implementation::LineLayerPointIndex& index: state.pointIndices.sliceSize(run.indexOffset, run.indexCount - 1)) {
-        index.index = (i >> 1) + (i & 1);
-        /* Neigbor (which is not a point index but rather an index index, as
-           explained in fillIndices() above) points either to the further point
-           in the next segment (+2) or the further point in the previous
-           segment (-2). Begin / end values will be wrong here, they get
-           patched after the loop to avoid branching on every item. */
-        index.neighbor = i & 1 ? i + 2 : i - 2;
-        ++i;
-    }
+    /* A 0, 1, 1, 2, 2, 3, ..., n - 1, 0 index sequence. Neighbors of the
+       first and last element get patched below. */
+    Implementation::fillLineStripIndexRange(state.pointIndices.sliceSize(run.indexOffset, run.indexCount), 0, run.indexCount - 1);
     state.pointIndices[run.indexOffset + run.indexCount - 1].index = 0;
 
     /* If we have just a single point, it won't have any neighbors */
@@ -418,6 +452,8 @@ DataHandle LineLayer::createInternal(const char*
     data.style = style;
     /* calculatedStyle is filled by AbstractVisualLayer::doUpdate() */
     data.alignment = LineAlignment(0xff);
+    data.sharedPoints = false;
+    data.decimationTolerance = 0.0f;
     data.color = Color4{1.0f};
     data.padding = Vector4{};
 
@@ -467,6 +503,70 @@ DataHandle LineLayer::createLoop(const UnsignedInt style, const std::initializer
     return createLoop(style, Containers::stridedArrayView(points), Containers::stridedArrayView(colors), node);
 }
 
+UnsignedInt LineLayer::sharedPointCount() const {
+    return static_cast<const State&>(*_state).sharedPoints.size();
+}
+
+void LineLayer::setSharedPoints(const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors) {
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(points.size() >= state.sharedPoints.size(),
+        "Ui::LineLayer::setSharedPoints(): expected at least" << state.sharedPoints.size() << "points, got" << points.size(), );
+    CORRADE_ASSERT(colors.isEmpty() || colors.size() == points.size(),
+        "Ui::LineLayer::setSharedPoints(): expected either no or" << points.size() << "colors, got" << colors.size(), );
+
+    /* The scratch storage for fillIndices() has to be the same size. Its
+       contents don't need to be preserved. */
+    /** @todo once the pool is allowed to shrink, it can't be just a plain
+        resize as existing lines may reference points past the end */
+    if(points.size() != state.sharedPoints.size()) {
+        arrayResize(state.sharedPoints, NoInit, points.size());
+        arrayResize(state.sharedPointUses, NoInit, points.size());
+    }
+
+    const Containers::StridedArrayView1D<Implementation::LineLayerPoint> pointData = state.sharedPoints;
+    Utility::copy(points, pointData.slice(&Implementation::LineLayerPoint::position));
+    if(colors.isEmpty())
+        for(Implementation::LineLayerPoint& point: pointData)
+            point.color = Color4{1.0f};
+    else Utility::copy(colors, pointData.slice(&Implementation::LineLayerPoint::color));
+
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void LineLayer::setSharedPoints(const std::initializer_list<Vector2> points, const std::initializer_list<Color4> colors) {
+    setSharedPoints(Containers::stridedArrayView(points), Containers::stridedArrayView(colors));
+}
+
+void LineLayer::setSharedPoint(const UnsignedInt id, const Vector2& point) {
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(id < state.sharedPoints.size(),
+        "Ui::LineLayer::setSharedPoint(): index" << id << "out of range for" << state.sharedPoints.size() << "points", );
+    state.sharedPoints[id].position = point;
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void LineLayer::setSharedPoint(const UnsignedInt id, const Vector2& point, const Color4& color) {
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(id < state.sharedPoints.size(),
+        "Ui::LineLayer::setSharedPoint(): index" << id << "out of range for" << state.sharedPoints.size() << "points", );
+    state.sharedPoints[id].position = point;
+    state.sharedPoints[id].color = color;
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+DataHandle LineLayer::createShared(const UnsignedInt style, const Containers::StridedArrayView1D<const UnsignedInt>& indices, const NodeHandle node) {
+    /* The run has no points of its own */
+    const DataHandle handle = createInternal("Ui::LineLayer::createShared():", style, indices.size(), 0, node);
+    static_cast<State&>(*_state).data[dataHandleId(handle)].sharedPoints = true;
+    fillIndices("Ui::LineLayer::createShared():", dataHandleId(handle), indices);
+
+    return handle;
+}
+
+DataHandle LineLayer::createShared(const UnsignedInt style, const std::initializer_list<UnsignedInt> indices, const NodeHandle node) {
+    return createShared(style, Containers::stridedArrayView(indices), node);
+}
+
 void LineLayer::remove(const DataHandle handle) {
     AbstractVisualLayer::remove(handle);
     removeInternal(dataHandleId(handle));
@@ -480,11 +580,9 @@ void LineLayer::remove(const LayerDataHandle handle) {
 void LineLayer::removeInternal(const UnsignedInt id) {
     State& state = static_cast<State&>(*_state);
 
-    /* Mark the run as unused. It'll be removed during the next recompaction in
-       doUpdate(). Both `indexOffset` and `pointOffset` are marked to avoid
-       inconsistency. */
-    state.runs[state.data[id].run].indexOffset = ~UnsignedInt{};
-    state.runs[state.data[id].run].pointOffset = ~UnsignedInt{};
+    /* Mark the run as unused. It'll be removed during a later recompaction
+       in doUpdate(). */
+    removeRun(state.data[id].run);
 
     /* Data removal doesn't need anything to be reuploaded to continue working
        correctly, thus setNeedsUpdate() isn't called.
@@ -558,14 +656,15 @@ void LineLayer::setLineInternal(const UnsignedInt id, const Containers::StridedA
         Implementation::LineLayerData& data = state.data[id];;
         Implementation::LineLayerRun& run = state.runs[data.run];
         if(run.indexCount != indices.size() || run.pointCount != points.size()) {
-            /* The run will be removed during the next recompaction in
-               doUpdate(). Both `indexOffset` and `pointOffset` are marked to
-               avoid inconsistency. */
-            run.indexOffset = ~UnsignedInt{};
-            run.pointOffset = ~UnsignedInt{};
+            /* The run will be removed during a later recompaction in
+               doUpdate() */
+            removeRun(data.run);
 
             data.run = createRun(id, indices.size(), points.size());
         }
+
+        /* If the line referenced shared points before, it doesn't anymore */
+        data.sharedPoints = false;
     }
 
     /* Fill the run with new indices, points and colors. Indices abuse the
@@ -609,14 +708,15 @@ void LineLayer::setLineStripInternal(const UnsignedInt id, const Containers::Str
         Implementation::LineLayerRun& run = state.runs[data.run];
         const UnsignedInt indexCount = points.isEmpty() ? 0 : points.size()*2 - 2;
         if(run.indexCount != indexCount || run.pointCount != points.size()) {
-            /* The run will be removed during the next recompaction in
-               doUpdate(). Both `indexOffset` and `pointOffset` are marked to
-               avoid inconsistency. */
-            run.indexOffset = ~UnsignedInt{};
-            run.pointOffset = ~UnsignedInt{};
+            /* The run will be removed during a later recompaction in
+               doUpdate() */
+            removeRun(data.run);
 
             data.run = createRun(id, indexCount, points.size());
         }
+
+        /* If the line referenced shared points before, it doesn't anymore */
+        data.sharedPoints = false;
     }
 
     /* Fill the run with new strip indices, points and colors. We *may* have a
@@ -629,6 +729,125 @@ void LineLayer::setLineStripInternal(const UnsignedInt id, const Containers::Str
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+void LineLayer::appendLineStrip(const DataHandle handle, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors, const UnsignedInt maxPointCount) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::LineLayer::appendLineStrip(): invalid handle" << handle, );
+    appendLineStripInternal(dataHandleId(handle), points, colors, maxPointCount);
+}
+
+void LineLayer::appendLineStrip(const DataHandle handle, const std::initializer_list<Vector2> points, const std::initializer_list<Color4> colors, const UnsignedInt maxPointCount) {
+    appendLineStrip(handle, Containers::stridedArrayView(points), Containers::stridedArrayView(colors), maxPointCount);
+}
+
+void LineLayer::appendLineStrip(const LayerDataHandle handle, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors, const UnsignedInt maxPointCount) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::LineLayer::appendLineStrip(): invalid handle" << handle, );
+    appendLineStripInternal(layerDataHandleId(handle), points, colors, maxPointCount);
+}
+
+void LineLayer::appendLineStrip(const LayerDataHandle handle, const std::initializer_list<Vector2> points, const std::initializer_list<Color4> colors, const UnsignedInt maxPointCount) {
+    appendLineStrip(handle, Containers::stridedArrayView(points), Containers::stridedArrayView(colors), maxPointCount);
+}
+
+void LineLayer::appendLineStripInternal(const UnsignedInt id, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors, const UnsignedInt maxPointCount) {
+    CORRADE_ASSERT(colors.isEmpty() || colors.size() == points.size(),
+        "Ui::LineLayer::appendLineStrip(): expected either no or" << points.size() << "colors, got" << colors.size(), );
+    CORRADE_ASSERT(maxPointCount >= 2,
+        "Ui::LineLayer::appendLineStrip(): expected max point count to be at least 2, got" << maxPointCount, );
+
+    State& state = static_cast<State&>(*_state);
+    Implementation::LineLayerData& data = state.data[id];
+    const Implementation::LineLayerRun& previousRun = state.runs[data.run];
+    /* Internally there's no distinction between a strip and other lines, so
+       check at least that the counts match. A single-point strip can be only
+       a result of a previous append. */
+    CORRADE_ASSERT(
+        (previousRun.pointCount < 2 && !previousRun.indexCount && !previousRun.joinCount) ||
+        (previousRun.pointCount >= 2 && previousRun.indexCount == 2*previousRun.pointCount - 2 && previousRun.joinCount == 2*(previousRun.pointCount - 2)),
+        "Ui::LineLayer::appendLineStrip(): expected a line strip but got" << previousRun.pointCount << "points and" << previousRun.indexCount << "indices", );
+
+    /* An empty line referencing shared points passes the above, it doesn't
+       reference them anymore after */
+    data.sharedPoints = false;
+
+    /* If there's more new points than the max count, only the last ones are
+       taken. Then as many existing points as still fit are kept from the
+       end. */
+    const UnsignedInt appendCount = Math::min(UnsignedInt(points.size()), maxPointCount);
+    const UnsignedInt previousPointCount = previousRun.pointCount;
+    const UnsignedInt previousPointOffset = previousRun.pointOffset;
+    const UnsignedInt keepCount = Math::min(previousPointCount, maxPointCount - appendCount);
+    const UnsignedInt dropCount = previousPointCount - keepCount;
+    if(!appendCount && !dropCount)
+        return;
+
+    const UnsignedInt pointCount = keepCount + appendCount;
+    const UnsignedInt indexCount = pointCount < 2 ? 0 : 2*pointCount - 2;
+
+    /* If the strip size doesn't change, it's updated in place. If it
+       changes and the run is the last one, it owns everything until the end
+       of the point and index storage, so the storage can be resized without
+       affecting any other run. A strip that isn't the last can't shrink in
+       place either, as doUpdate() decides about recompaction based on the
+       space occupied by unused runs, which wouldn't include such gaps. */
+    UnsignedInt filledIndexCount;
+    if(pointCount == previousPointCount || data.run == state.runs.size() - 1) {
+        filledIndexCount = Math::min(previousRun.indexCount, indexCount);
+        if(pointCount != previousPointCount) {
+            arrayResize(state.points, NoInit, previousPointOffset + pointCount);
+            arrayResize(state.pointIndices, NoInit, previousRun.indexOffset + indexCount);
+        }
+
+        /* Drop the points from the front, the indices are only relative to
+           the run so they don't need to change */
+        if(dropCount)
+            std::memmove(state.points.data() + previousPointOffset,
+                         state.points.data() + previousPointOffset + dropCount,
+                         keepCount*sizeof(Implementation::LineLayerPoint));
+
+    /* Otherwise mark the run as unused and create a new one at the end, with
+       the kept points copied over. Subsequent appends to the same strip can
+       then be done in place. */
+    } else {
+        /* The run will be removed during a later recompaction in
+           doUpdate() */
+        removeRun(data.run);
+
+        data.run = createRun(id, indexCount, pointCount);
+        Utility::copy(state.points.sliceSize(previousPointOffset + dropCount, keepCount),
+                      state.points.sliceSize(state.runs[data.run].pointOffset, keepCount));
+        filledIndexCount = 0;
+    }
+
+    Implementation::LineLayerRun& run = state.runs[data.run];
+    run.pointCount = pointCount;
+    run.indexCount = indexCount;
+    run.joinCount = pointCount < 2 ? 0 : (pointCount - 2)*2;
+
+    /* Copy the new points after the kept ones */
+    const Containers::StridedArrayView1D<Implementation::LineLayerPoint> pointData = state.points.sliceSize(run.pointOffset + keepCount, appendCount);
+    Utility::copy(points.exceptPrefix(points.size() - appendCount), pointData.slice(&Implementation::LineLayerPoint::position));
+    if(colors.isEmpty())
+        for(Implementation::LineLayerPoint& point: pointData)
+            point.color = Color4{1.0f};
+    else Utility::copy(colors.exceptPrefix(colors.size() - appendCount), pointData.slice(&Implementation::LineLayerPoint::color));
+
+    /* The strip index sequence depends only on the point count, so just fill
+       the indices that weren't there before and then patch the first and last
+       element to have no neighbor. The element that was last before is now
+       joined with the next segment, which is what fillLineStripIndexRange()
+       would have filled there. */
+    if(indexCount) {
+        const Containers::ArrayView<Implementation::LineLayerPointIndex> pointIndices = state.pointIndices.sliceSize(run.indexOffset, indexCount);
+        Implementation::fillLineStripIndexRange(pointIndices, filledIndexCount, indexCount);
+        if(filledIndexCount && filledIndexCount < indexCount)
+            pointIndices[filledIndexCount - 1].neighbor = filledIndexCount + 1;
+        pointIndices.front().neighbor = pointIndices.back().neighbor = ~UnsignedInt{};
+    }
+
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 void LineLayer::setLineLoop(const DataHandle handle, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::LineLayer::setLineLoop(): invalid handle" << handle, );
@@ -661,14 +880,15 @@ void LineLayer::setLineLoopInternal(const UnsignedInt id, const Containers::Stri
         Implementation::LineLayerRun& run = state.runs[data.run];
         const UnsignedInt indexCount = points.size()*2;
         if(run.indexCount != indexCount || run.pointCount != points.size()) {
-            /* The run will be removed during the next recompaction in
-               doUpdate(). Both `indexOffset` and `pointOffset` are marked to
-               avoid inconsistency. */
-            run.indexOffset = ~UnsignedInt{};
-            run.pointOffset = ~UnsignedInt{};
+            /* The run will be removed during a later recompaction in
+               doUpdate() */
+            removeRun(data.run);
 
             data.run = createRun(id, indexCount, points.size());
         }
+
+        /* If the line referenced shared points before, it doesn't anymore */
+        data.sharedPoints = false;
     }
 
     /* Fill the run with new loop indices, points and colors. We *may* have a
@@ -681,6 +901,50 @@ void LineLayer::setLineLoopInternal(const UnsignedInt id, const Containers::Stri
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+void LineLayer::setLineShared(const DataHandle handle, const Containers::StridedArrayView1D<const UnsignedInt>& indices) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::LineLayer::setLineShared(): invalid handle" << handle, );
+    setLineSharedInternal(dataHandleId(handle), indices);
+}
+
+void LineLayer::setLineShared(const DataHandle handle, const std::initializer_list<UnsignedInt> indices) {
+    setLineShared(handle, Containers::stridedArrayView(indices));
+}
+
+void LineLayer::setLineShared(const LayerDataHandle handle, const Containers::StridedArrayView1D<const UnsignedInt>& indices) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::LineLayer::setLineShared(): invalid handle" << handle, );
+    setLineSharedInternal(layerDataHandleId(handle), indices);
+}
+
+void LineLayer::setLineShared(const LayerDataHandle handle, const std::initializer_list<UnsignedInt> indices) {
+    setLineShared(handle, Containers::stridedArrayView(indices));
+}
+
+void LineLayer::setLineSharedInternal(const UnsignedInt id, const Containers::StridedArrayView1D<const UnsignedInt>& indices) {
+    State& state = static_cast<State&>(*_state);
+
+    /* If the run has the same count of indices and no points of its own,
+       reuse it, otherwise mark it as unused and create a new one */
+    {
+        Implementation::LineLayerData& data = state.data[id];
+        Implementation::LineLayerRun& run = state.runs[data.run];
+        if(run.indexCount != indices.size() || run.pointCount != 0) {
+            /* The run will be removed during a later recompaction in
+               doUpdate() */
+            removeRun(data.run);
+
+            data.run = createRun(id, indices.size(), 0);
+        }
+
+        data.sharedPoints = true;
+    }
+
+    fillIndices("Ui::LineLayer::setLineShared():", id, indices);
+
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 Color4 LineLayer::color(const DataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::LineLayer::color(): invalid handle" << handle, {});
@@ -710,6 +974,45 @@ void LineLayer::setColorInternal(const UnsignedInt id, const Color4& color) {
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+void LineLayer::setColor(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors) {
+    CORRADE_ASSERT(colors.size() == handles.size(),
+        "Ui::LineLayer::setColor(): expected handle and color views to have the same size but got" << handles.size() << "and" << colors.size(), );
+    /* Check all handles first to not end up with just a part of the data
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::LineLayer::setColor(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[dataHandleId(handles[i])].color = colors[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void LineLayer::setColor(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors) {
+    CORRADE_ASSERT(colors.size() == handles.size(),
+        "Ui::LineLayer::setColor(): expected handle and color views to have the same size but got" << handles.size() << "and" << colors.size(), );
+    /* Same as above */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::LineLayer::setColor(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[layerDataHandleId(handles[i])].color = colors[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 Containers::Optional<LineAlignment> LineLayer::alignment(const DataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::LineLayer::alignment(): invalid handle" << handle, {});
@@ -774,10 +1077,111 @@ void LineLayer::setPaddingInternal(const UnsignedInt id, const Vector4& padding)
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+Float LineLayer::decimationTolerance(const DataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::LineLayer::decimationTolerance(): invalid handle" << handle, {});
+    return static_cast<const State&>(*_state).data[dataHandleId(handle)].decimationTolerance;
+}
+
+Float LineLayer::decimationTolerance(const LayerDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::LineLayer::decimationTolerance(): invalid handle" << handle, {});
+    return static_cast<const State&>(*_state).data[layerDataHandleId(handle)].decimationTolerance;
+}
+
+void LineLayer::setDecimationTolerance(const DataHandle handle, const Float tolerance) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::LineLayer::setDecimationTolerance(): invalid handle" << handle, );
+    setDecimationToleranceInternal(dataHandleId(handle), tolerance);
+}
+
+void LineLayer::setDecimationTolerance(const LayerDataHandle handle, const Float tolerance) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::LineLayer::setDecimationTolerance(): invalid handle" << handle, );
+    setDecimationToleranceInternal(layerDataHandleId(handle), tolerance);
+}
+
+void LineLayer::setDecimationToleranceInternal(const UnsignedInt id, const Float tolerance) {
+    CORRADE_ASSERT(tolerance >= 0.0f,
+        "Ui::LineLayer::setDecimationTolerance(): expected a non-negative tolerance, got" << tolerance, );
+    static_cast<State&>(*_state).data[id].decimationTolerance = tolerance;
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 LayerFeatures LineLayer::doFeatures() const {
     return AbstractVisualLayer::doFeatures()|LayerFeature::Draw;
 }
 
+void LineLayer::doSetSize(const Vector2& size, const Vector2i& framebufferSize) {
+    auto& state = static_cast<State&>(*_state);
+
+    /* Pixel size is used for converting decimation tolerance to UI units. If
+       it differs and there are any decimated lines already, trigger a data
+       update to decimate them again. */
+    /** @todo Max or min? Should I even bother with non-square scaling? */
+    const Float pixelSize = (size/Vector2{framebufferSize}).max();
+    if(pixelSize != state.pixelSize && !state.decimatedPointIndices.isEmpty())
+        setNeedsUpdate(LayerState::NeedsDataUpdate);
+    state.pixelSize = pixelSize;
+}
+
+MemoryUsage LineLayer::doMemoryUsage() const {
+    const State& state = static_cast<const State&>(*_state);
+    MemoryUsage out = AbstractVisualLayer::doMemoryUsage();
+    Implementation::addArrayMemoryUsage(out, state.points);
+    Implementation::addArrayMemoryUsage(out, state.pointIndices);
+    Implementation::addArrayMemoryUsage(out, state.runs);
+    Implementation::addArrayMemoryUsage(out, state.decimatedPointIndices);
+    Implementation::addArrayMemoryUsage(out, state.sharedPoints);
+    Implementation::addArrayMemoryUsage(out, state.sharedPointUses);
+    Implementation::addArrayMemoryUsage(out, state.data);
+    Implementation::addArrayMemoryUsage(out, state.vertices);
+    Implementation::addArrayMemoryUsage(out, state.indices);
+    Implementation::addArrayMemoryUsage(out, state.indexDrawOffsets);
+    Implementation::addArrayMemoryUsage(out, state.instances);
+
+    /* Runs marked as unused, together with the points and indices they
+       reference, are waiting for a later recompaction in doUpdate() */
+    out.cpuUnused +=
+        state.unusedRunCount*sizeof(Implementation::LineLayerRun) +
+        state.unusedPointCount*sizeof(Implementation::LineLayerPoint) +
+        state.unusedPointIndexCount*sizeof(Implementation::LineLayerPointIndex);
+    out.cpuUnused += (state.data.size() - usedCount())*sizeof(Implementation::LineLayerData);
+    return out;
+}
+
+void LineLayer::doTrim(const std::size_t capacity) {
+    AbstractVisualLayer::doTrim(capacity);
+
+    auto& state = static_cast<State&>(*_state);
+    if(state.data.size() > capacity)
+        arrayResize(state.data, NoInit, capacity);
+    arrayShrink(state.data);
+    state.styles = stridedArrayView(state.data).slice(&Implementation::LineLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::LineLayerData::calculatedStyle);
+
+    /* Runs are referenced by data and get recompacted in doUpdate(), vertices
+       and indices are sized for data that get drawn. In both cases the
+       contents may be still in use, so only the reserved memory is
+       released. */
+    arrayShrink(state.points);
+    arrayShrink(state.pointIndices);
+    arrayShrink(state.runs);
+    arrayShrink(state.decimatedPointIndices);
+    arrayShrink(state.vertices);
+    arrayShrink(state.indices);
+    arrayShrink(state.indexDrawOffsets);
+    arrayShrink(state.instances);
+}
+
+void LineLayer::doReserve(const std::size_t capacity) {
+    auto& state = static_cast<State&>(*_state);
+    arrayReserve(state.data, capacity);
+    /* The reallocation may have moved the data */
+    state.styles = stridedArrayView(state.data).slice(&Implementation::LineLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::LineLayerData::calculatedStyle);
+}
+
 LayerStates LineLayer::doState() const {
     LayerStates states = AbstractVisualLayer::doState();
 
@@ -790,20 +1194,148 @@ LayerStates LineLayer::doState() const {
     return states;
 }
 
-void LineLayer::doClean(const Containers::BitArrayView dataIdsToRemove) {
+void LineLayer::doCleanSparse(Containers::BitArrayView, const Containers::ArrayView<const UnsignedInt> dataIds) {
     /* Mark runs attached to removed data as unused, similarly as when calling
        remove(). They'll get actually removed during the next recompaction in
        doUpdate(). */
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != dataIdsToRemove.size(); ++i)
-        if(dataIdsToRemove[i])
-            removeInternal(i);
+    for(const UnsignedInt i: dataIds)
+        removeInternal(i);
 
     /* Data removal doesn't need anything to be reuploaded to continue working
        correctly, thus setNeedsUpdate() isn't called, and neither is in
        remove(). See a comment there for more information. */
 }
 
+namespace {
+
+/* Calculates the offset of a line run relative to the node area, based on the
+   alignment and padding coming from the data and its style */
+Vector2 alignedRunOffset(const Implementation::LineLayerData& data, const Implementation::LineLayerStyle& style, const Vector2& nodeOffset, const Vector2& nodeSize) {
+    const Vector4 padding = data.padding + style.padding;
+    Vector2 offset = nodeOffset + padding.xy();
+    const Vector2 size = nodeSize - padding.xy() - Math::gather<'z', 'w'>(padding);
+    /* If per-data alignment is set, use that, otherwise take one from the
+       style */
+    const LineAlignment alignment = data.alignment != LineAlignment(0xff) ?
+        data.alignment : style.alignment;
+    const UnsignedByte alignmentHorizontal = UnsignedByte(alignment) & Implementation::LineAlignmentHorizontal;
+    if(alignmentHorizontal == Implementation::LineAlignmentLeft) {
+        offset.x() += 0.0f;
+    } else if(alignmentHorizontal == Implementation::LineAlignmentRight) {
+        offset.x() += size.x();
+    } else if(alignmentHorizontal == Implementation::LineAlignmentCenter) {
+        offset.x() += size.x()*0.5f;
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    const UnsignedByte alignmentVertical = UnsignedByte(alignment) & Implementation::LineAlignmentVertical;
+    if(alignmentVertical == Implementation::LineAlignmentTop) {
+        offset.y() += 0.0f;
+    } else if(alignmentVertical == Implementation::LineAlignmentBottom) {
+        offset.y() += size.y();
+    } else if(alignmentVertical == Implementation::LineAlignmentMiddle) {
+        offset.y() += size.y()*0.5f;
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    return offset;
+}
+
+/* Returns true if the indices form a single open chain of at least two
+   segments with all interior points joined, i.e. what setLineStrip() or
+   appendLineStrip() produces. */
+bool isOpenChain(const Containers::ArrayView<const Implementation::LineLayerPointIndex> pointIndices, const UnsignedInt joinCount) {
+    if(pointIndices.size() < 4 || joinCount != pointIndices.size() - 2 ||
+       pointIndices.front().neighbor != ~UnsignedInt{} ||
+       pointIndices.back().neighbor != ~UnsignedInt{})
+        return false;
+    for(std::size_t i = 1; i < pointIndices.size() - 1; i += 2)
+        if(pointIndices[i].index != pointIndices[i + 1].index)
+            return false;
+    return true;
+}
+
+/* Decimates an open chain of segments using the Douglas-Peucker algorithm and
+   writes the kept points as a line strip to the output, returning the number
+   of indices written. The first and last point are always kept. The output is
+   expected to be at least as large as the input. */
+std::size_t decimateOpenChain(const Containers::ArrayView<const Implementation::LineLayerPointIndex> pointIndices, const Containers::ArrayView<const Implementation::LineLayerPoint> points, const Float tolerance, const Containers::ArrayView<Implementation::LineLayerPointIndex> out) {
+    CORRADE_INTERNAL_DEBUG_ASSERT(out.size() >= pointIndices.size());
+
+    /* Point i of the chain is the first index of segment i, except for the
+       last point which is the second index of the last segment */
+    const std::size_t chainSize = pointIndices.size()/2 + 1;
+    const auto chainPoint = [&](std::size_t i) {
+        return i == chainSize - 1 ?
+            pointIndices[i*2 - 1].index : pointIndices[i*2].index;
+    };
+
+    /* Iterative instead of recursive to not blow up the stack on large
+       inputs */
+    /** @todo reuse the allocations across runs and updates */
+    Containers::BitArray keep{ValueInit, chainSize};
+    keep.set(0);
+    keep.set(chainSize - 1);
+    Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> ranges;
+    arrayAppend(ranges, InPlaceInit, 0u, UnsignedInt(chainSize - 1));
+    const Float toleranceSquared = tolerance*tolerance;
+    while(!ranges.isEmpty()) {
+        const Containers::Pair<UnsignedInt, UnsignedInt> range = ranges.back();
+        arrayRemoveSuffix(ranges);
+
+        const Vector2 a = points[chainPoint(range.first())].position;
+        const Vector2 b = points[chainPoint(range.second())].position;
+        Float maxDistanceSquared = 0.0f;
+        UnsignedInt max = 0;
+        for(UnsignedInt i = range.first() + 1; i < range.second(); ++i) {
+            const Float distanceSquared = Math::Distance::lineSegmentPointSquared(a, b, points[chainPoint(i)].position);
+            if(distanceSquared > maxDistanceSquared) {
+                maxDistanceSquared = distanceSquared;
+                max = i;
+            }
+        }
+
+        /* If the farthest point is outside of the tolerance, keep it and
+           process both halves */
+        if(maxDistanceSquared > toleranceSquared) {
+            keep.set(max);
+            arrayAppend(ranges, InPlaceInit, range.first(), max);
+            arrayAppend(ranges, InPlaceInit, max, range.second());
+        }
+    }
+
+    /* Output a line strip connecting the kept points, with the neighbor
+       pattern matching what fillLineStripIndexRange() produces */
+    std::size_t count = 0;
+    UnsignedInt previous = chainPoint(0);
+    for(std::size_t i = 1; i != chainSize; ++i) {
+        if(!keep[i])
+            continue;
+        const UnsignedInt current = chainPoint(i);
+        out[count].index = previous;
+        out[count].neighbor = count - 2;
+        out[count + 1].index = current;
+        out[count + 1].neighbor = count + 3;
+        previous = current;
+        count += 2;
+    }
+    out[0].neighbor = ~UnsignedInt{};
+    out[count - 1].neighbor = ~UnsignedInt{};
+    return count;
+}
+
+/* Points a run references, which are either the shared points or the run's
+   own points */
+Containers::ArrayView<const Implementation::LineLayerPoint> drawPoints(const Containers::ArrayView<const Implementation::LineLayerPoint> points, const Containers::ArrayView<const Implementation::LineLayerPoint> sharedPoints, const Implementation::LineLayerData& data, const Implementation::LineLayerRun& run) {
+    return data.sharedPoints ? sharedPoints : points.sliceSize(run.pointOffset, run.pointCount);
+}
+
+/* Point indices a run is drawn with, which are the decimated ones if the run
+   got decimated and the original ones otherwise */
+Containers::ArrayView<const Implementation::LineLayerPointIndex> drawPointIndices(const Containers::ArrayView<const Implementation::LineLayerPointIndex> pointIndices, const Containers::ArrayView<const Implementation::LineLayerPointIndex> decimatedPointIndices, const Implementation::LineLayerRun& run) {
+    return run.decimatedIndexOffset != ~UnsignedInt{} ?
+        decimatedPointIndices.sliceSize(run.decimatedIndexOffset, run.decimatedIndexCount) :
+        pointIndices.sliceSize(run.indexOffset, run.indexCount);
+}
+
+}
+
 void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
     /* The base implementation populates data.calculatedStyle */
     AbstractVisualLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
@@ -816,14 +1348,20 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         "Ui::LineLayer::update(): no style data was set", );
 
     /* Recompact the line data by removing unused runs. Do this only if data
-       actually change, this isn't affected by anything node-related */
+       actually change, this isn't affected by anything node-related. See
+       Implementation::shouldCompactRuns() for the heuristic deciding whether
+       it's worth doing, the runs are recompacted if either the points or the
+       indices need it. */
     /** @todo further restrict this to just NeedsCommonDataUpdate which gets
         set by setLine*(), remove() etc that actually produces unused runs, but
         not setColor() and such? the recompaction however implies a need to
         update the actual index buffer etc anyway, so a dedicated state won't
         make that update any smaller, and we'd now trigger it from clean() and
         remove() as well, which we didn't need to before */
-    if(states >= LayerState::NeedsDataUpdate) {
+    if(states >= LayerState::NeedsDataUpdate && (
+        Implementation::shouldCompactRuns(state.runs.size(), state.unusedRunCount, state.points.size(), state.unusedPointCount) ||
+        Implementation::shouldCompactRuns(state.runs.size(), state.unusedRunCount, state.pointIndices.size(), state.unusedPointIndexCount)))
+    {
         std::size_t outputPointIndexOffset = 0;
         std::size_t outputPointOffset = 0;
         std::size_t outputRunOffset = 0;
@@ -837,30 +1375,12 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
 
             /* Move the index data earlier if there were skipped runs before,
                update the reference to it in the run */
-            if(run.indexOffset != outputPointIndexOffset) {
-                CORRADE_INTERNAL_DEBUG_ASSERT(run.indexOffset > outputPointIndexOffset);
-                CORRADE_INTERNAL_DEBUG_ASSERT(i != outputRunOffset);
-
-                std::memmove(state.pointIndices.data() + outputPointIndexOffset,
-                             state.pointIndices.data() + run.indexOffset,
-                             run.indexCount*sizeof(Implementation::LineLayerPointIndex));
-                run.indexOffset = outputPointIndexOffset;
-            }
-            outputPointIndexOffset += run.indexCount;
+            Implementation::compactRunItems(arrayView(state.pointIndices), run.indexOffset, run.indexCount, outputPointIndexOffset);
 
             /* Same for point data. Note that there may be runs with non-zero
                points but zero indices so this has to be checked independently
                of the indexOffset. */
-            if(run.pointOffset != outputPointOffset) {
-                CORRADE_INTERNAL_DEBUG_ASSERT(run.pointOffset > outputPointOffset);
-                CORRADE_INTERNAL_DEBUG_ASSERT(i != outputRunOffset);
-
-                std::memmove(state.points.data() + outputPointOffset,
-                             state.points.data() + run.pointOffset,
-                             run.pointCount*sizeof(Implementation::LineLayerPoint));
-                run.pointOffset = outputPointOffset;
-            }
-            outputPointOffset += run.pointCount;
+            Implementation::compactRunItems(arrayView(state.points), run.pointOffset, run.pointCount, outputPointOffset);
 
             /* Move the glyph run info earlier if there were skipped runs
                before, update the reference to it in the data */
@@ -879,13 +1399,54 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         arrayResize(state.pointIndices, outputPointIndexOffset);
         arrayResize(state.points, outputPointOffset);
         arrayResize(state.runs, outputRunOffset);
+        state.unusedRunCount = 0;
+        state.unusedPointCount = 0;
+        state.unusedPointIndexCount = 0;
+    }
+
+    /* Decimate runs that have a tolerance set. Done after the recompaction so
+       the decimated indices are always generated into a fresh array. Runs
+       that are unused but not recompacted yet are skipped. The tolerance is
+       in pixels, convert it to UI units. */
+    if(states >= LayerState::NeedsDataUpdate) {
+        /** @todo this decimates all runs again on every data update, cache
+            the results for runs that didn't change */
+        arrayResize(state.decimatedPointIndices, 0);
+        for(Implementation::LineLayerRun& run: state.runs) {
+            run.decimatedIndexOffset = ~UnsignedInt{};
+            if(run.indexOffset == ~UnsignedInt{})
+                continue;
+            const Implementation::LineLayerData& data = state.data[run.data];
+            const Float tolerance = data.decimationTolerance;
+            if(tolerance == 0.0f)
+                continue;
+
+            const Containers::ArrayView<const Implementation::LineLayerPointIndex> pointIndices = state.pointIndices.sliceSize(run.indexOffset, run.indexCount);
+            if(!isOpenChain(pointIndices, run.joinCount))
+                continue;
+
+            const std::size_t offset = state.decimatedPointIndices.size();
+            const std::size_t count = decimateOpenChain(pointIndices, drawPoints(state.points, state.sharedPoints, data, run), tolerance*state.pixelSize, arrayAppend(state.decimatedPointIndices, NoInit, run.indexCount));
+
+            /* If nothing was removed, draw the original indices */
+            if(count == run.indexCount) {
+                arrayResize(state.decimatedPointIndices, offset);
+                continue;
+            }
+
+            arrayResize(state.decimatedPointIndices, offset + count);
+            run.decimatedIndexOffset = offset;
+            run.decimatedIndexCount = count;
+        }
     }
 
     /* Fill in indices in desired order if either the data themselves or the
        node order changed. Keep the checks in sync with
-       LineLayerGL::doUpdate(). */
-    if(states >= LayerState::NeedsNodeOrderUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+       LineLayerGL::doPostUpdate(). With instanced segments there are no
+       indices and the instances are filled below instead. */
+    const bool instanced = sharedState.flags >= LineLayerSharedFlag::InstancedSegments;
+    if(!instanced && (states >= LayerState::NeedsNodeOrderUpdate ||
+                      states >= LayerState::NeedsDataUpdate))
     {
         /* Index offsets for each run, plus one more for the last run */
         arrayResize(state.indexDrawOffsets, NoInit, dataIds.size() + 1);
@@ -896,10 +1457,16 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         for(const UnsignedInt id: dataIds) {
             const Implementation::LineLayerData& data = state.data[id];
             const Implementation::LineLayerRun& run = state.runs[data.run];
-            /* Every two indices is one segment */
-            CORRADE_INTERNAL_DEBUG_ASSERT(run.indexCount % 2 == 0);
-            drawSegmentCount += run.indexCount/2;
-            drawJoinCount += run.joinCount;
+            /* Every two indices is one segment. A decimated run is always a
+               single strip, with all interior points joined. */
+            if(run.decimatedIndexOffset != ~UnsignedInt{}) {
+                drawSegmentCount += run.decimatedIndexCount/2;
+                drawJoinCount += run.decimatedIndexCount - 2;
+            } else {
+                CORRADE_INTERNAL_DEBUG_ASSERT(run.indexCount % 2 == 0);
+                drawSegmentCount += run.indexCount/2;
+                drawJoinCount += run.joinCount;
+            }
         }
 
         /* Generate index data */
@@ -912,10 +1479,11 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             /* Generate indices in draw order. Remeber the offset for each data
                to draw from later. */
             state.indexDrawOffsets[i] = indexOffset;
-            const Containers::ArrayView<const Implementation::LineLayerPointIndex> pointIndices = state.pointIndices.sliceSize(run.indexOffset, run.indexCount);
+            const Containers::ArrayView<const Implementation::LineLayerPointIndex> pointIndices = drawPointIndices(state.pointIndices, state.decimatedPointIndices, run);
+            const UnsignedInt joinCount = run.decimatedIndexOffset != ~UnsignedInt{} ? run.decimatedIndexCount - 2 : run.joinCount;
             /* Every two input indices is one segment, every segment is six
                output indices, every pair of joins is two triangles */
-            const Containers::ArrayView<UnsignedInt> indexData = state.indices.sliceSize(indexOffset, (run.indexCount/2)*6 + run.joinCount*3);
+            const Containers::ArrayView<UnsignedInt> indexData = state.indices.sliceSize(indexOffset, (pointIndices.size()/2)*6 + joinCount*3);
 
             /* The order is chosen in a way that makes it possible to interpret
                the 6 indices as 3 lines instead of 2 triangles, and
@@ -933,9 +1501,10 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             std::size_t runIndexOffset = 0;
             /* The output vertices are in the order defined by the input index
                buffer, and for every pair of input indices defining a line
-               segment we have four output vertices */
+               segment we have four output vertices. Decimated runs occupy the
+               same vertex range as the original, just a prefix of it. */
             const UnsignedInt vertexOffset = (run.indexOffset/2)*4;
-            for(std::size_t j = 0, jMax = run.indexCount/2; j != jMax; ++j) {
+            for(std::size_t j = 0, jMax = pointIndices.size()/2; j != jMax; ++j) {
                 const UnsignedInt segmentVertexOffset = vertexOffset + j*4;
 
                 indexData[runIndexOffset++] = segmentVertexOffset + 2;
@@ -996,21 +1565,21 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
     /* Fill in vertex data if the data themselves, the node offset/size or node
        enablement (and thus calculated styles) or opacities (and thus
        calculated colors) changed. Keep the checks in sync with
-       LineLayerGL::doUpdate(). */
+       LineLayerGL::doPostUpdate(). */
     /** @todo split this further to just position-related data update and other
         data if it shows to help with perf */
-    if(states >= LayerState::NeedsNodeOffsetSizeUpdate ||
-       states >= LayerState::NeedsNodeEnabledUpdate ||
-       states >= LayerState::NeedsNodeOpacityUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+    if(!instanced && (states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+                      states >= LayerState::NeedsNodeEnabledUpdate ||
+                      states >= LayerState::NeedsNodeOpacityUpdate ||
+                      states >= LayerState::NeedsDataUpdate))
     {
         /* Calculate how many points are there in total. For each segment
            defined by the input index buffer we'll have two points, so
            basically removing the indexing, and then further duplicating them
            to form quads. */
-        UnsignedInt totalPointCount = 0;
-        for(const Implementation::LineLayerRun& run: state.runs)
-            totalPointCount += run.indexCount;
+        /* Vertices are placed at the index offset of each run, including
+           space for unused runs that weren't recompacted yet */
+        const UnsignedInt totalPointCount = state.pointIndices.size();
 
         const Containers::StridedArrayView1D<const Ui::NodeHandle> nodes = this->nodes();
 
@@ -1024,10 +1593,10 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             /* Fill in vertices in the same order as the original runs */
             /** @todo ideally this would only be done if some text actually
                 changes, not on every visibility change */
-            const Containers::ArrayView<const Implementation::LineLayerPointIndex> pointIndices = state.pointIndices.sliceSize(run.indexOffset, run.indexCount);
-            const Containers::StridedArrayView1D<const Implementation::LineLayerPoint> points = state.points.sliceSize(run.pointOffset, run.pointCount);
-            const Containers::StridedArrayView1D<Implementation::LineLayerVertex> vertexData = state.vertices.sliceSize(run.indexOffset*2, run.indexCount*2);
-            for(std::size_t i = 0, iMax = run.indexCount; i != iMax; ++i) {
+            const Containers::ArrayView<const Implementation::LineLayerPointIndex> pointIndices = drawPointIndices(state.pointIndices, state.decimatedPointIndices, run);
+            const Containers::StridedArrayView1D<const Implementation::LineLayerPoint> points = drawPoints(state.points, state.sharedPoints, data, run);
+            const Containers::StridedArrayView1D<Implementation::LineLayerVertex> vertexData = state.vertices.sliceSize(run.indexOffset*2, pointIndices.size()*2);
+            for(std::size_t i = 0, iMax = pointIndices.size(); i != iMax; ++i) {
                 /* Position and color is the same for both copies of the
                    segment endpoint */
                 vertexData[i*2 + 0].position =
@@ -1094,29 +1663,7 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             }
 
             /* Align the run relative to the node area */
-            const Vector4 padding = data.padding + sharedState.styles[data.calculatedStyle].padding;
-            Vector2 offset = nodeOffsets[nodeId] + padding.xy();
-            const Vector2 size = nodeSizes[nodeId] - padding.xy() - Math::gather<'z', 'w'>(padding);
-            /* If per-data alignment is set, use that, otherwise take one from
-               the style */
-            const LineAlignment alignment = data.alignment != LineAlignment(0xff) ?
-                data.alignment : sharedState.styles[data.calculatedStyle].alignment;
-            const UnsignedByte alignmentHorizontal = UnsignedByte(alignment) & Implementation::LineAlignmentHorizontal;
-            if(alignmentHorizontal == Implementation::LineAlignmentLeft) {
-                offset.x() += 0.0f;
-            } else if(alignmentHorizontal == Implementation::LineAlignmentRight) {
-                offset.x() += size.x();
-            } else if(alignmentHorizontal == Implementation::LineAlignmentCenter) {
-                offset.x() += size.x()*0.5f;
-            } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-            const UnsignedByte alignmentVertical = UnsignedByte(alignment) & Implementation::LineAlignmentVertical;
-            if(alignmentVertical == Implementation::LineAlignmentTop) {
-                offset.y() += 0.0f;
-            } else if(alignmentVertical == Implementation::LineAlignmentBottom) {
-                offset.y() += size.y();
-            } else if(alignmentVertical == Implementation::LineAlignmentMiddle) {
-                offset.y() += size.y()*0.5f;
-            } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            const Vector2 offset = alignedRunOffset(data, sharedState.styles[data.calculatedStyle], nodeOffsets[nodeId], nodeSizes[nodeId]);
 
             /* Translate the (aligned) run, fill color and style */
             const Float opacity = nodeOpacities[nodeId];
@@ -1131,6 +1678,92 @@ void LineLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         }
     }
 
+    /* Fill in instance data if anything of the above changed. The instances
+       are in draw order, so they're regenerated on a node order change as
+       well. Keep the checks in sync with LineLayerGL::doPostUpdate(). */
+    if(instanced && (states >= LayerState::NeedsNodeOrderUpdate ||
+                     states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+                     states >= LayerState::NeedsNodeEnabledUpdate ||
+                     states >= LayerState::NeedsNodeOpacityUpdate ||
+                     states >= LayerState::NeedsDataUpdate))
+    {
+        /* Instance offsets for each run, plus one more for the last run */
+        arrayResize(state.indexDrawOffsets, NoInit, dataIds.size() + 1);
+
+        /* Calculate how many line segments we'll draw, every two indices is
+           one segment */
+        UnsignedInt drawSegmentCount = 0;
+        for(const UnsignedInt id: dataIds) {
+            const Implementation::LineLayerRun& run = state.runs[state.data[id].run];
+            const std::size_t indexCount = drawPointIndices(state.pointIndices, state.decimatedPointIndices, run).size();
+            CORRADE_INTERNAL_DEBUG_ASSERT(indexCount % 2 == 0);
+            drawSegmentCount += indexCount/2;
+        }
+
+        const Containers::StridedArrayView1D<const Ui::NodeHandle> nodes = this->nodes();
+
+        /* Generate instance data */
+        arrayResize(state.instances, NoInit, drawSegmentCount);
+        UnsignedInt instanceOffset = 0;
+        for(std::size_t i = 0; i != dataIds.size(); ++i) {
+            const UnsignedInt nodeId = nodeHandleId(nodes[dataIds[i]]);
+            const Implementation::LineLayerData& data = state.data[dataIds[i]];
+            const Implementation::LineLayerRun& run = state.runs[data.run];
+
+            /* Remember the offset for each data to draw from later */
+            state.indexDrawOffsets[i] = instanceOffset;
+
+            const Vector2 offset = alignedRunOffset(data, sharedState.styles[data.calculatedStyle], nodeOffsets[nodeId], nodeSizes[nodeId]);
+            const Color4 color = data.color*nodeOpacities[nodeId];
+            /* Annotation is the lower 6 bits, style index is above that */
+            const UnsignedInt styleUniform = sharedState.styles[data.calculatedStyle].uniform << 6;
+
+            const Containers::ArrayView<const Implementation::LineLayerPointIndex> pointIndices = drawPointIndices(state.pointIndices, state.decimatedPointIndices, run);
+            const Containers::ArrayView<const Implementation::LineLayerPoint> points = drawPoints(state.points, state.sharedPoints, data, run);
+            const Containers::ArrayView<Implementation::LineLayerSegmentInstance> instanceData = state.instances.sliceSize(instanceOffset, pointIndices.size()/2);
+            for(std::size_t j = 0; j != instanceData.size(); ++j) {
+                const Implementation::LineLayerPointIndex& index0 = pointIndices[j*2 + 0];
+                const Implementation::LineLayerPointIndex& index1 = pointIndices[j*2 + 1];
+                Implementation::LineLayerSegmentInstance& instance = instanceData[j];
+                instance.position0 = points[index0.index].position + offset;
+                instance.position1 = points[index1.index].position + offset;
+                instance.color0 = points[index0.index].color*color;
+                instance.color1 = points[index1.index].color*color;
+
+                /* The neighbor is the index index, same as when filling the
+                   vertices above. The join is drawn only by the segment where
+                   the neighbor index is larger than the point index itself,
+                   same as with the index buffer. If the neighbor index is odd,
+                   the closer point is in the first index of the neighbor
+                   segment. */
+                UnsignedInt annotation = 0;
+                if(index0.neighbor != ~UnsignedInt{}) {
+                    instance.previousPosition = points[pointIndices[index0.neighbor].index].position + offset;
+                    annotation |= Implementation::LineSegmentAnnotationJoin0;
+                    if(index0.neighbor > j*2 + 0)
+                        annotation |= Implementation::LineSegmentAnnotationEmitJoin0;
+                    if(index0.neighbor & 1)
+                        annotation |= Implementation::LineSegmentAnnotationNeighborBegin0;
+                } else instance.previousPosition = offset;
+                if(index1.neighbor != ~UnsignedInt{}) {
+                    instance.nextPosition = points[pointIndices[index1.neighbor].index].position + offset;
+                    annotation |= Implementation::LineSegmentAnnotationJoin1;
+                    if(index1.neighbor > j*2 + 1)
+                        annotation |= Implementation::LineSegmentAnnotationEmitJoin1;
+                    if(index1.neighbor & 1)
+                        annotation |= Implementation::LineSegmentAnnotationNeighborBegin1;
+                } else instance.nextPosition = offset;
+
+                instance.annotationStyleUniform = annotation|styleUniform;
+            }
+
+            instanceOffset += instanceData.size();
+        }
+
+        CORRADE_INTERNAL_ASSERT(instanceOffset == drawSegmentCount);
+        state.indexDrawOffsets[dataIds.size()] = instanceOffset;
+    }
+
     /* Sync the style update stamp to not have doState() return NeedsDataUpdate
        again next time it's asked */
     if(states >= LayerState::NeedsDataUpdate)
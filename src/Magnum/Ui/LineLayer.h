@@ -27,7 +27,7 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Ui::LineLayer, struct @ref Magnum::Ui::LineLayerCommonStyleUniform, @ref Magnum::Ui::LineLayerStyleUniform, enum @ref Magnum::Ui::LineCapStyle, @ref Magnum::Ui::LineJoinStyle, @ref Magnum::Ui::LineAlignment
+ * @brief Class @ref Magnum::Ui::LineLayer, struct @ref Magnum::Ui::LineLayerCommonStyleUniform, @ref Magnum::Ui::LineLayerStyleUniform, enum @ref Magnum::Ui::LineCapStyle, @ref Magnum::Ui::LineJoinStyle, @ref Magnum::Ui::LineAlignment, @ref Magnum::Ui::LineLayerSharedFlag, enum set @ref Magnum::Ui::LineLayerSharedFlags
  * @m_since_latest
  */
 
@@ -436,6 +436,55 @@ enum class LineAlignment: UnsignedByte {
 */
 MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, LineAlignment value);
 
+/**
+@brief Line layer shared state flag
+@m_since_latest
+
+@see @ref LineLayerSharedFlags, @ref LineLayer::Shared::flags(),
+    @ref LineLayer::Shared::Configuration::setFlags()
+*/
+enum class LineLayerSharedFlag: UnsignedByte {
+    /**
+     * Render each line segment as a single instance of a static mesh, with
+     * the segment endpoints, positions of the neighboring points, colors and
+     * style supplied just once per segment. Caps and joins are then resolved
+     * in the vertex shader. Compared to the default, which duplicates each
+     * segment endpoint into two vertices and draws them with an index buffer,
+     * this uploads roughly three times less vertex data and no index data at
+     * all, which is useful for layers with a large amount of line segments
+     * such as plots. The visual output is the same as with the default.
+     *
+     * In @ref LineLayerGL requires @gl_extension{ARB,base_instance} on
+     * desktop GL, ANGLE_base_vertex_base_instance on OpenGL ES and
+     * @webgl_extension{WEBGL,draw_instanced_base_vertex_base_instance} on
+     * WebGL.
+     */
+    InstancedSegments = 1 << 0
+};
+
+/**
+@brief Line layer shared state flags
+@m_since_latest
+
+@see @ref LineLayer::Shared::flags(),
+    @ref LineLayer::Shared::Configuration::setFlags()
+*/
+typedef Containers::EnumSet<LineLayerSharedFlag> LineLayerSharedFlags;
+
+CORRADE_ENUMSET_OPERATORS(LineLayerSharedFlags)
+
+/**
+@debugoperatorenum{LineLayerSharedFlag}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, LineLayerSharedFlag value);
+
+/**
+@debugoperatorenum{LineLayerSharedFlags}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, LineLayerSharedFlags value);
+
 /**
 @brief Line layer
 @m_since_latest
@@ -699,7 +748,32 @@ for example when updating plotted values.
 
 Changing the point / index count is supported however and internally there's
 also no distinction between a strip, loop or an indexed line, so a strip can be
-safely changed to a loop etc.
+safely changed to a loop etc. In that case, or when a line is removed, the
+previous points are left as unused space, which gets recompacted in the next
+@ref update(). For layers with a lot of points the recompaction is done only
+once a significant portion of the point data is unused, so changing a single
+line in a large layer doesn't cause all following point data to be shifted.
+
+For streaming data such as real-time plots, @ref appendLineStrip() adds points
+to the end of an existing strip, optionally dropping the oldest ones from its
+front to keep it at a fixed maximum length, without having to regenerate the
+whole strip on every change. If the strip has many more points than there
+are pixels in the area it's drawn to, @ref setDecimationTolerance() makes the
+layer draw a simplified line with only the points that are visually
+significant.
+
+If many lines share the same points, such as edges in a node graph, the points
+can be put into a per-layer pool with @ref setSharedPoints() and the lines
+created with @ref createShared(), referencing the pool points by their
+indices. Moving a single point with @ref setSharedPoint() then updates all
+lines that reference it, without having to call @ref setLine() on every one
+of them.
+
+For layers with a lot of line segments the vertex data size may become the
+bottleneck when the lines change every frame. With
+@ref LineLayerSharedFlag::InstancedSegments each segment is drawn as an
+instance of a single static mesh with caps and joins resolved in the shader,
+and changing the draw order doesn't involve regenerating any index data.
 */
 class MAGNUM_UI_EXPORT LineLayer: public AbstractVisualLayer {
     public:
@@ -974,6 +1048,138 @@ class MAGNUM_UI_EXPORT LineLayer: public AbstractVisualLayer {
             return createLoop(UnsignedInt(style), points, colors, node);
         }
 
+        /**
+         * @brief Count of points in the shared point pool
+         * @m_since_latest
+         *
+         * Count of points passed to @ref setSharedPoints(). Initially there
+         * are no shared points.
+         */
+        UnsignedInt sharedPointCount() const;
+
+        /**
+         * @brief Set points in the shared point pool
+         * @param points        Points, in UI units
+         * @param colors        Optional per-point colors
+         * @m_since_latest
+         *
+         * Replaces the contents of the per-layer point pool that's referenced
+         * by lines created with @ref createShared() or @ref setLineShared().
+         * The @p points are expected to not be fewer than
+         * @ref sharedPointCount() in order to not make indices of existing
+         * lines out of range. The @p colors array is expected to be either
+         * empty or have the same size as @p points, with the same meaning as
+         * in @ref create().
+         *
+         * Calling this function causes @ref LayerState::NeedsDataUpdate to be
+         * set.
+         * @see @ref setSharedPoint()
+         */
+        /* This one takes Vector4 instead of Color4 because color views are
+           implicitly convertible to vectors but not the other way around */
+        void setSharedPoints(const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors);
+        /** @overload */
+        /* This one takes a Color4 instead of Vector4 in order to have e.g.
+           0x993366_rgbf implicitly converted to 0x993366ff_rgbaf */
+        void setSharedPoints(std::initializer_list<Vector2> points, std::initializer_list<Color4> colors);
+
+        /**
+         * @brief Set a single point in the shared point pool
+         * @m_since_latest
+         *
+         * Expects that @p id is less than @ref sharedPointCount(). The point
+         * color is left unchanged. All lines that reference the point pick up
+         * the change in the next @ref update().
+         *
+         * Calling this function causes @ref LayerState::NeedsDataUpdate to be
+         * set.
+         * @see @ref setSharedPoints()
+         */
+        void setSharedPoint(UnsignedInt id, const Vector2& point);
+
+        /**
+         * @brief Set a single point and its color in the shared point pool
+         * @m_since_latest
+         *
+         * Like @ref setSharedPoint(UnsignedInt, const Vector2&) but also
+         * replacing the color. The @p color is expected to have premultiplied
+         * alpha.
+         */
+        void setSharedPoint(UnsignedInt id, const Vector2& point, const Color4& color);
+
+        /**
+         * @brief Create a line from an indexed list of shared points
+         * @param style         Style index
+         * @param indices       Indices into the shared point pool
+         * @param node          Node to attach to
+         * @return New data handle
+         * @m_since_latest
+         *
+         * Like @ref create(UnsignedInt, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector4>&, NodeHandle),
+         * but instead of a dedicated point list the @p indices reference
+         * points set with @ref setSharedPoints(), and are thus all expected to
+         * be less than @ref sharedPointCount(). The points are resolved
+         * during @ref update(), so a change done with @ref setSharedPoint() is
+         * reflected in all lines that reference given point. The
+         * @ref pointCount() of such line is @cpp 0 @ce. Joins and caps are
+         * formed the same way as with @ref create().
+         * @see @ref setLineShared()
+         */
+        DataHandle createShared(UnsignedInt style, const Containers::StridedArrayView1D<const UnsignedInt>& indices, NodeHandle node =
+            #ifdef DOXYGEN_GENERATING_OUTPUT
+            NodeHandle::Null
+            #else
+            NodeHandle{} /* To not have to include Handle.h */
+            #endif
+        );
+        /** @overload */
+        DataHandle createShared(UnsignedInt style, std::initializer_list<UnsignedInt> indices, NodeHandle node =
+            #ifdef DOXYGEN_GENERATING_OUTPUT
+            NodeHandle::Null
+            #else
+            NodeHandle{} /* To not have to include Handle.h */
+            #endif
+        );
+
+        /**
+         * @brief Create a line from an indexed list of shared points with a style index in a concrete enum type
+         * @m_since_latest
+         *
+         * Casts @p style to @relativeref{Magnum,UnsignedInt} and delegates to
+         * @ref createShared(UnsignedInt, const Containers::StridedArrayView1D<const UnsignedInt>&, NodeHandle).
+         */
+        template<class StyleIndex
+            #ifndef DOXYGEN_GENERATING_OUTPUT
+            /* Accept any enum except NodeHandle to prevent create(node, ...)
+               from being called by mistake */
+            , typename std::enable_if<std::is_enum<StyleIndex>::value && !std::is_same<StyleIndex, NodeHandle>::value, int>::type = 0
+            #endif
+        > DataHandle createShared(StyleIndex style, const Containers::StridedArrayView1D<const UnsignedInt>& indices, NodeHandle node =
+            #ifdef DOXYGEN_GENERATING_OUTPUT
+            NodeHandle::Null
+            #else
+            NodeHandle{} /* To not have to include Handle.h */
+            #endif
+        ) {
+            return createShared(UnsignedInt(style), indices, node);
+        }
+        /** @overload */
+        template<class StyleIndex
+            #ifndef DOXYGEN_GENERATING_OUTPUT
+            /* Accept any enum except NodeHandle to prevent create(node, ...)
+               from being called by mistake */
+            , typename std::enable_if<std::is_enum<StyleIndex>::value && !std::is_same<StyleIndex, NodeHandle>::value, int>::type = 0
+            #endif
+        > DataHandle createShared(StyleIndex style, std::initializer_list<UnsignedInt> indices, NodeHandle node =
+            #ifdef DOXYGEN_GENERATING_OUTPUT
+            NodeHandle::Null
+            #else
+            NodeHandle{} /* To not have to include Handle.h */
+            #endif
+        ) {
+            return createShared(UnsignedInt(style), indices, node);
+        }
+
         /**
          * @brief Remove a line
          *
@@ -1014,7 +1220,9 @@ class MAGNUM_UI_EXPORT LineLayer: public AbstractVisualLayer {
          *
          * Count of points passed to @ref create(), @ref createStrip(),
          * @ref createLoop(), @ref setLine(), @ref setLineStrip() or
-         * @ref setLineLoop(). Expects that @p handle is valid.
+         * @ref setLineLoop(). For lines created with @ref createShared() or
+         * @ref setLineShared() the count is @cpp 0 @ce. Expects that
+         * @p handle is valid.
          * @see @ref isHandleValid(DataHandle) const, @ref indexCount()
          */
         UnsignedInt pointCount(DataHandle handle) const;
@@ -1098,6 +1306,56 @@ class MAGNUM_UI_EXPORT LineLayer: public AbstractVisualLayer {
         /** @overload */
         void setLineStrip(LayerDataHandle handle, std::initializer_list<Vector2> points, std::initializer_list<Color4> colors);
 
+        /**
+         * @brief Append to line strip data
+         *
+         * Expects that @p handle is valid and that it's a line strip, i.e.
+         * created with @ref createStrip() or @ref setLineStrip(), or by a
+         * previous call to this function. The @p colors are expected to be
+         * either empty or have the same size as @p points, if empty, the
+         * appended points are white, the same as in
+         * @ref createStrip(UnsignedInt, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector4>&, NodeHandle).
+         *
+         * If the strip would have more than @p maxPointCount points after the
+         * append, points are dropped from its front, and if @p points alone
+         * are more than @p maxPointCount, only the last @p maxPointCount of
+         * them are used. The @p maxPointCount is expected to be at least
+         * @cpp 2 @ce. Useful for example for plots that get a new sample
+         * every frame and show only a fixed amount of most recent samples.
+         *
+         * As the strip indices depend only on the point count, only indices
+         * for the newly added points get filled, compared to
+         * @ref setLineStrip() which fills all of them. If the strip grows and
+         * isn't the most recently created or grown data in the layer, it's
+         * moved to the end of the internal storage, so subsequent appends to
+         * the same strip can grow it in place. Unlike with @ref createStrip()
+         * and @ref setLineStrip(), a strip can have just a single point after
+         * this call, in which case it's not drawn until more points are
+         * appended.
+         *
+         * Calling this function causes @ref LayerState::NeedsDataUpdate to be
+         * set, unless @p points are empty and no points got dropped.
+         * @see @ref isHandleValid(DataHandle) const, @ref pointCount()
+         */
+        /* This one takes Vector4 instead of Color4 because color views are
+           implicitly convertible to vectors but not the other way around */
+        void appendLineStrip(DataHandle handle, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors, UnsignedInt maxPointCount = ~UnsignedInt{});
+        /** @overload */
+        /* This one takes a Color4 instead of Vector4 in order to have e.g.
+           0x993366_rgbf implicitly converted to 0x993366ff_rgbaf */
+        void appendLineStrip(DataHandle handle, std::initializer_list<Vector2> points, std::initializer_list<Color4> colors, UnsignedInt maxPointCount = ~UnsignedInt{});
+
+        /**
+         * @brief Append to line strip data assuming it belongs to this layer
+         *
+         * Like @ref appendLineStrip(DataHandle, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector4>&, UnsignedInt)
+         * but without checking that @p handle indeed belongs to this layer.
+         * See its documentation for more information.
+         */
+        void appendLineStrip(LayerDataHandle handle, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors, UnsignedInt maxPointCount = ~UnsignedInt{});
+        /** @overload */
+        void appendLineStrip(LayerDataHandle handle, std::initializer_list<Vector2> points, std::initializer_list<Color4> colors, UnsignedInt maxPointCount = ~UnsignedInt{});
+
         /**
          * @brief Set line loop data
          *
@@ -1133,6 +1391,38 @@ class MAGNUM_UI_EXPORT LineLayer: public AbstractVisualLayer {
         /** @overload */
         void setLineLoop(LayerDataHandle handle, std::initializer_list<Vector2> points, std::initializer_list<Color4> colors);
 
+        /**
+         * @brief Set line data referencing shared points
+         * @m_since_latest
+         *
+         * Expects that @p handle is valid. The @p indices are interpreted the
+         * same way with the same restrictions as in
+         * @ref createShared(UnsignedInt, const Containers::StridedArrayView1D<const UnsignedInt>&, NodeHandle),
+         * see its documentation for more information. Can be used to turn a
+         * line with its own points into a line referencing shared points, and
+         * @ref setLine(), @ref setLineStrip() or @ref setLineLoop() can be
+         * used for the inverse.
+         *
+         * Calling this function causes @ref LayerState::NeedsDataUpdate to be
+         * set.
+         * @see @ref isHandleValid(DataHandle) const
+         */
+        void setLineShared(DataHandle handle, const Containers::StridedArrayView1D<const UnsignedInt>& indices);
+        /** @overload */
+        void setLineShared(DataHandle handle, std::initializer_list<UnsignedInt> indices);
+
+        /**
+         * @brief Set line data referencing shared points assuming it belongs to this layer
+         * @m_since_latest
+         *
+         * Like @ref setLineShared(DataHandle, const Containers::StridedArrayView1D<const UnsignedInt>&)
+         * but without checking that @p handle indeed belongs to this layer.
+         * See its documentation for more information.
+         */
+        void setLineShared(LayerDataHandle handle, const Containers::StridedArrayView1D<const UnsignedInt>& indices);
+        /** @overload */
+        void setLineShared(LayerDataHandle handle, std::initializer_list<UnsignedInt> indices);
+
         /**
          * @brief Custom line color
          *
@@ -1176,6 +1466,29 @@ class MAGNUM_UI_EXPORT LineLayer: public AbstractVisualLayer {
          */
         void setColor(LayerDataHandle handle, const Color4& color);
 
+        /**
+         * @brief Set custom colors of multiple lines
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setColor(DataHandle, const Color4&) for
+         * each item in @p handles and @p colors, but with the layer marked
+         * with @ref LayerState::NeedsDataUpdate just once and only if
+         * @p handles is non-empty. Expects that the @p handles and @p colors
+         * views have the same size and that all handles are valid. The handles
+         * are all checked before anything is updated.
+         */
+        void setColor(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors);
+
+        /**
+         * @brief Set custom colors of multiple lines assuming they belong to this layer
+         * @m_since_latest
+         *
+         * Like @ref setColor(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StridedArrayView1D<const Color4>&)
+         * but without checking that @p handles indeed belong to this layer.
+         * See its documentation for more information.
+         */
+        void setColor(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors);
+
         /**
          * @brief Custom line alignment
          *
@@ -1282,6 +1595,64 @@ class MAGNUM_UI_EXPORT LineLayer: public AbstractVisualLayer {
             setPadding(handle, Vector4{padding});
         }
 
+        /**
+         * @brief Line decimation tolerance
+         * @m_since_latest
+         *
+         * In pixels. Expects that @p handle is valid.
+         * @see @ref isHandleValid(DataHandle) const
+         */
+        Float decimationTolerance(DataHandle handle) const;
+
+        /**
+         * @brief Line decimation tolerance assuming it belongs to this layer
+         * @m_since_latest
+         *
+         * Like @ref decimationTolerance(DataHandle) const but without checking
+         * that @p handle indeed belongs to this layer. See its documentation
+         * for more information.
+         */
+        Float decimationTolerance(LayerDataHandle handle) const;
+
+        /**
+         * @brief Set line decimation tolerance
+         * @m_since_latest
+         *
+         * Expects that @p handle is valid and @p tolerance is not negative.
+         * If non-zero, the line is simplified during @ref update() using the
+         * Douglas-Peucker algorithm, dropping points that are closer than
+         * @p tolerance pixels to the simplified line. The pixel size is
+         * calculated from the UI and framebuffer size passed to
+         * @ref setSize(). Useful for plots that have considerably more points
+         * than there are pixels in the area they're drawn to, as the drawing
+         * cost is then proportional to the visual complexity of the line and
+         * not the data size. The original points are kept, so the tolerance
+         * can be changed or disabled again without having to set the line
+         * again. By default the tolerance is @cpp 0.0f @ce, i.e. no
+         * decimation is done.
+         *
+         * The decimation is done only for lines that form a single open
+         * chain, such as those created with @ref createStrip(),
+         * @ref setLineStrip() and @ref appendLineStrip(). Loops and other
+         * lines are drawn as-is. The result is calculated again only if the
+         * layer data or the ratio of UI and framebuffer size changes.
+         *
+         * Calling this function causes @ref LayerState::NeedsDataUpdate to be
+         * set.
+         * @see @ref isHandleValid(DataHandle) const
+         */
+        void setDecimationTolerance(DataHandle handle, Float tolerance);
+
+        /**
+         * @brief Set line decimation tolerance assuming it belongs to this layer
+         * @m_since_latest
+         *
+         * Like @ref setDecimationTolerance(DataHandle, Float) but without
+         * checking that @p handle indeed belongs to this layer. See its
+         * documentation for more information.
+         */
+        void setDecimationTolerance(LayerDataHandle handle, Float tolerance);
+
     #ifdef DOXYGEN_GENERATING_OUTPUT
     private:
     #else
@@ -1299,13 +1670,22 @@ class MAGNUM_UI_EXPORT LineLayer: public AbstractVisualLayer {
         /* Advertises LayerFeature::Draw but *does not* implement doDraw(),
            that's on the subclass */
         LayerFeatures doFeatures() const override;
-
+        /* Reports the CPU-side data, point, vertex and index storage, GPU
+           usage is on the subclass */
+        MemoryUsage doMemoryUsage() const override;
+        /* Shrinks the CPU-side data, point, vertex and index storage */
+        void doTrim(std::size_t capacity) override;
+        /* Reserves the CPU-side data storage */
+        void doReserve(std::size_t capacity) override;
+
+        void doSetSize(const Vector2& size, const Vector2i& framebufferSize) override;
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
 
     private:
         /* (Transitively) used by create(), createStrip(), createLoop(),
            setLine(), setLineStrip() and setLineLoop() */
         MAGNUM_UI_LOCAL UnsignedInt createRun(UnsignedInt dataId, UnsignedInt indexCount, UnsignedInt pointCount);
+        MAGNUM_UI_LOCAL void removeRun(UnsignedInt run);
         MAGNUM_UI_LOCAL void fillIndices(const char* messagePrefix, UnsignedInt dataId, const Containers::StridedArrayView1D<const UnsignedInt>& indices);
         MAGNUM_UI_LOCAL void fillStripIndices(const char* messagePrefix, UnsignedInt dataId);
         MAGNUM_UI_LOCAL void fillLoopIndices(const char* messagePrefix, UnsignedInt dataId);
@@ -1319,16 +1699,19 @@ class MAGNUM_UI_EXPORT LineLayer: public AbstractVisualLayer {
         MAGNUM_UI_LOCAL void setLineInternal(UnsignedInt id, const Containers::StridedArrayView1D<const UnsignedInt>& indices, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors);
         MAGNUM_UI_LOCAL void setLineStripInternal(UnsignedInt id, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors);
         MAGNUM_UI_LOCAL void setLineLoopInternal(UnsignedInt id, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors);
+        MAGNUM_UI_LOCAL void setLineSharedInternal(UnsignedInt id, const Containers::StridedArrayView1D<const UnsignedInt>& indices);
+        MAGNUM_UI_LOCAL void appendLineStripInternal(UnsignedInt id, const Containers::StridedArrayView1D<const Vector2>& points, const Containers::StridedArrayView1D<const Vector4>& colors, UnsignedInt maxPointCount);
 
         MAGNUM_UI_LOCAL void setColorInternal(UnsignedInt id, const Color4& color);
         MAGNUM_UI_LOCAL Containers::Optional<LineAlignment> alignmentInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL void setAlignmentInternal(UnsignedInt id, Containers::Optional<LineAlignment> alignment);
         MAGNUM_UI_LOCAL void setPaddingInternal(UnsignedInt id, const Vector4& padding);
+        MAGNUM_UI_LOCAL void setDecimationToleranceInternal(UnsignedInt id, Float tolerance);
 
         /* Can't be MAGNUM_UI_LOCAL otherwise deriving from this class in
            tests causes linker errors */
         LayerStates doState() const override;
-        void doClean(Containers::BitArrayView dataIdsToRemove) override;
+        void doCleanSparse(Containers::BitArrayView dataIdsToRemove, Containers::ArrayView<const UnsignedInt> dataIds) override;
 };
 
 /**
@@ -1361,6 +1744,13 @@ class MAGNUM_UI_EXPORT LineLayer::Shared: public AbstractVisualLayer::Shared {
         /** @brief Join style */
         LineJoinStyle joinStyle() const;
 
+        /**
+         * @brief Shared layer flags
+         *
+         * @see @ref Configuration::setFlags()
+         */
+        LineLayerSharedFlags flags() const;
+
         /**
          * @brief Set style data with implicit mapping between styles and uniforms
          * @param commonUniform Common style uniform data
@@ -1524,10 +1914,51 @@ class MAGNUM_UI_EXPORT LineLayer::Shared::Configuration {
             return *this;
         }
 
+        /** @brief Shared layer flags */
+        LineLayerSharedFlags flags() const { return _flags; }
+
+        /**
+         * @brief Set shared layer flags
+         * @return Reference to self (for method chaining)
+         *
+         * By default no flags are set.
+         * @see @ref addFlags(), @ref clearFlags(),
+         *      @ref LineLayer::Shared::flags()
+         */
+        Configuration& setFlags(LineLayerSharedFlags flags) {
+            _flags = flags;
+            return *this;
+        }
+
+        /**
+         * @brief Add flags
+         * @return Reference to self (for method chaining)
+         *
+         * Calls @ref setFlags() with the existing flags ORed with @p flags.
+         * Useful for preserving previously set flags.
+         * @see @ref clearFlags()
+         */
+        Configuration& addFlags(LineLayerSharedFlags flags) {
+            return setFlags(_flags|flags);
+        }
+
+        /**
+         * @brief Clear flags
+         * @return Reference to self (for method chaining)
+         *
+         * Calls @ref setFlags() with the existing flags ANDed with the inverse
+         * of @p flags. Useful for removing a subset of previously set flags.
+         * @see @ref addFlags()
+         */
+        Configuration& clearFlags(LineLayerSharedFlags flags) {
+            return setFlags(_flags & ~flags);
+        }
+
     private:
         UnsignedInt _styleUniformCount, _styleCount;
         LineCapStyle _capStyle = LineCapStyle::Square;
         LineJoinStyle _joinStyle = LineJoinStyle::Miter;
+        LineLayerSharedFlags _flags;
 };
 
 inline LineLayer::Shared& LineLayer::shared() {
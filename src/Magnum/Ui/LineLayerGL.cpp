@@ -41,7 +41,10 @@
 #include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Version.h>
 
+#include "Magnum/Ui/Implementation/asyncShaderProgramGL.h"
 #include "Magnum/Ui/Implementation/lineLayerState.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
+#include "Magnum/Ui/Implementation/uploadChangedRangesGL.h"
 
 #ifdef MAGNUM_UI_BUILD_STATIC
 static void importShaderResources() {
@@ -55,43 +58,71 @@ using namespace Containers::Literals;
 
 namespace {
 
-class LineShaderGL: public GL::AbstractShaderProgram {
+class LineShaderGL: public Implementation::AsyncShaderProgramGL {
     private:
         enum: Int {
             StyleBufferBinding = 0,
         };
 
     public:
+        enum Flag: UnsignedByte {
+            InstancedSegments = 1 << 0
+        };
+
+        typedef Containers::EnumSet<Flag> Flags;
+
         typedef GL::Attribute<0, Vector2> Position;
         typedef GL::Attribute<1, Vector2> PreviousPosition;
         typedef GL::Attribute<2, Vector2> NextPosition;
         typedef GL::Attribute<3, Vector4> Color4;
         typedef GL::Attribute<4, UnsignedInt> AnnotationStyle;
+        /* Only if InstancedSegments are set, replacing Position. Color4 is
+           then the color of the first endpoint. */
+        typedef GL::Attribute<5, UnsignedInt> InstancedSegmentCorner;
+        typedef GL::Attribute<0, Vector4> InstancedSegmentPositions;
+        typedef GL::Attribute<6, Vector4> InstancedSegmentColor1;
 
-        explicit LineShaderGL(UnsignedInt styleCount, LineCapStyle capStyle, LineJoinStyle joinStyle);
+        explicit LineShaderGL(Flags flags, UnsignedInt styleCount, LineCapStyle capStyle, LineJoinStyle joinStyle);
+
+        /* Waits for the compilation submitted in the constructor to finish
+           and performs the post-link setup. Called implicitly from all
+           setters except setProjection(), which gets applied here if it was
+           called before. */
+        void finish();
 
         LineShaderGL& setProjection(const Vector2& scaling, const Float pixelScaling) {
             /* XY is Y-flipped scale from the UI size to the 2x2 unit square,
                the shader then translates by (-1, 1) on its own to put the
                origin at center. Z is multiplied with the pixel smoothness
                value to get the smoothness in actual UI units. */
-            setUniform(_projectionUniform, Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling});
+            _projection = Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling};
+            /* If the shader is still compiling, it's set in finish() */
+            if(!isCompilePending())
+                setUniform(_projectionUniform, _projection);
             return *this;
         }
 
         LineShaderGL& bindStyleBuffer(GL::Buffer& buffer) {
+            finish();
             buffer.bind(GL::Buffer::Target::Uniform, StyleBufferBinding);
             return *this;
         }
 
     private:
         Int _projectionUniform = 0;
+        Vector3 _projection;
 };
 
-LineShaderGL::LineShaderGL(const UnsignedInt styleCount, const LineCapStyle capStyle, const LineJoinStyle joinStyle) {
+CORRADE_ENUMSET_OPERATORS(LineShaderGL::Flags)
+
+LineShaderGL::LineShaderGL(const Flags flags, const UnsignedInt styleCount, const LineCapStyle capStyle, const LineJoinStyle joinStyle) {
     GL::Context& context = GL::Context::current();
     #ifndef MAGNUM_TARGET_GLES
     MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
+    /* Drawing a subset of the instances for each draw call needs a base
+       instance */
+    if(flags >= Flag::InstancedSegments)
+        MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::base_instance);
     #endif
 
     #ifdef MAGNUM_UI_BUILD_STATIC
@@ -145,6 +176,7 @@ LineShaderGL::LineShaderGL(const UnsignedInt styleCount, const LineCapStyle capS
     vert.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
         .addSource(capStyleDefine)
         .addSource(joinStyleDefine)
+        .addSource(flags >= Flag::InstancedSegments ? "#define INSTANCED_SEGMENTS\n"_s : ""_s)
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("LineShader.vert"_s))
         .addSource(rs.getString("LineShader.in.vert"_s));
@@ -158,28 +190,22 @@ LineShaderGL::LineShaderGL(const UnsignedInt styleCount, const LineCapStyle capS
         .addSource(rs.getString("LineShader.frag"_s))
         .addSource(rs.getString("LineShader.in.frag"_s));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+    submitCompileLink(Utility::move(vert), Utility::move(frag), version);
+}
 
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+void LineShaderGL::finish() {
+    if(!checkCompileLink())
+        return;
 
-    #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
-    #endif
-    {
+    if(!hasExplicitUniformLocations()) {
         _projectionUniform = uniformLocation("projection"_s);
     }
 
-    #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::shading_language_420pack>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
-    #endif
-    {
+    if(!hasExplicitBindings()) {
         setUniformBlockBinding(uniformBlockIndex("Style"_s), StyleBufferBinding);
     }
+
+    setUniform(_projectionUniform, _projection);
 }
 
 }
@@ -189,16 +215,55 @@ struct LineLayerGL::Shared::State: LineLayer::Shared::State {
 
     LineShaderGL shader;
     GL::Buffer styleBuffer{GL::Buffer::TargetHint::Uniform};
+    /* Created only if Flag::InstancedSegments is enabled, contain corners and
+       indices of a segment mesh shared by all layers */
+    GL::Buffer instancedSegmentCornerBuffer{NoCreate},
+        instancedSegmentIndexBuffer{NoCreate};
 };
 
-LineLayerGL::Shared::State::State(Shared& self, const Configuration& configuration): LineLayer::Shared::State{self, configuration}, shader{configuration.styleUniformCount(), configuration.capStyle(), configuration.joinStyle()} {
+LineLayerGL::Shared::State::State(Shared& self, const Configuration& configuration): LineLayer::Shared::State{self, configuration}, shader{
+    configuration.flags() >= LineLayerSharedFlag::InstancedSegments ? LineShaderGL::Flag::InstancedSegments : LineShaderGL::Flags{},
+    configuration.styleUniformCount(), configuration.capStyle(), configuration.joinStyle()}
+{
     styleBuffer.setData({nullptr, sizeof(LineLayerCommonStyleUniform) + sizeof(LineLayerStyleUniform)*styleUniformCount}, GL::BufferUsage::StaticDraw);
+    if(configuration.flags() >= LineLayerSharedFlag::InstancedSegments) {
+        /* Corners 0 and 1 are the up and down vertex of the first segment
+           endpoint, 2 and 3 of the second, 4 and 5 of the neighbor segment
+           joined at the second endpoint and 6 and 7 of the neighbor joined
+           at the first endpoint. The shader then expands them from the
+           instance data. */
+        const UnsignedInt corners[]{0, 1, 2, 3, 4, 5, 6, 7};
+        /* The segment quad is in the same order as the indices generated in
+           LineLayer::doUpdate(), followed by the two join triangles at each
+           end. The joins that aren't drawn by given segment degenerate.
+
+            6 0---2 4
+            |\|  /|\|
+            | |/  | |
+            7 1---3 5 */
+        const UnsignedByte indices[]{
+            2, 0, 1,
+            1, 3, 2,
+
+            2, 3, 4,
+            4, 3, 5,
+
+            0, 1, 6,
+            6, 1, 7
+        };
+        instancedSegmentCornerBuffer = GL::Buffer{GL::Buffer::TargetHint::Array, corners};
+        instancedSegmentIndexBuffer = GL::Buffer{GL::Buffer::TargetHint::ElementArray, indices};
+    }
 }
 
 LineLayerGL::Shared::Shared(const Configuration& configuration): LineLayer::Shared{Containers::pointer<State>(*this, configuration)} {}
 
 LineLayerGL::Shared::Shared(NoCreateT) noexcept: LineLayer::Shared{NoCreate} {}
 
+bool LineLayerGL::Shared::isCompileFinished() {
+    return static_cast<State&>(*_state).shader.isCompileFinished();
+}
+
 void LineLayerGL::Shared::doSetStyle(const LineLayerCommonStyleUniform& commonUniform, const Containers::ArrayView<const LineLayerStyleUniform> uniforms) {
     auto& state = static_cast<State&>(*_state);
     state.styleBuffer.setSubData(0, {&commonUniform, 1});
@@ -212,6 +277,12 @@ struct LineLayerGL::State: LineLayer::State {
         indexBuffer{GL::Buffer::TargetHint::ElementArray};
     GL::Mesh mesh;
 
+    /* Copies of what was uploaded to each buffer above last time and the
+       buffer capacities, used to upload only the ranges that changed since
+       and to reallocate the buffers only when they need to grow */
+    Containers::Array<char> uploadedVertices, uploadedIndices;
+    std::size_t vertexBufferCapacity = 0, indexBufferCapacity = 0;
+
     #ifndef CORRADE_NO_ASSERT
     bool setSizeCalled = false;
     #endif
@@ -220,20 +291,59 @@ struct LineLayerGL::State: LineLayer::State {
 
 LineLayerGL::LineLayerGL(const LayerHandle handle, Shared& sharedState_): LineLayer{handle, Containers::pointer<State>(static_cast<Shared::State&>(*sharedState_._state))} {
     auto& state = static_cast<State&>(*_state);
-    state.mesh.addVertexBuffer(state.vertexBuffer, 0,
-        LineShaderGL::Position{},
-        LineShaderGL::PreviousPosition{},
-        LineShaderGL::NextPosition{},
-        LineShaderGL::Color4{},
-        LineShaderGL::AnnotationStyle{});
-    state.mesh.setIndexBuffer(state.indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+    auto& sharedState = static_cast<Shared::State&>(state.shared);
+    if(sharedState.flags >= LineLayerSharedFlag::InstancedSegments) {
+        state.mesh
+            .setCount(18)
+            .addVertexBuffer(sharedState.instancedSegmentCornerBuffer, 0,
+                LineShaderGL::InstancedSegmentCorner{})
+            .addVertexBufferInstanced(state.vertexBuffer, 1, 0,
+                LineShaderGL::PreviousPosition{},
+                LineShaderGL::InstancedSegmentPositions{},
+                LineShaderGL::NextPosition{},
+                LineShaderGL::Color4{},
+                LineShaderGL::InstancedSegmentColor1{},
+                LineShaderGL::AnnotationStyle{})
+            .setIndexBuffer(sharedState.instancedSegmentIndexBuffer, 0, GL::MeshIndexType::UnsignedByte);
+    } else {
+        state.mesh.addVertexBuffer(state.vertexBuffer, 0,
+            LineShaderGL::Position{},
+            LineShaderGL::PreviousPosition{},
+            LineShaderGL::NextPosition{},
+            LineShaderGL::Color4{},
+            LineShaderGL::AnnotationStyle{});
+        state.mesh.setIndexBuffer(state.indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+    }
+}
+
+MemoryUsage LineLayerGL::doMemoryUsage() const {
+    const State& state = static_cast<const State&>(*_state);
+    MemoryUsage out = LineLayer::doMemoryUsage();
+    Implementation::addArrayMemoryUsage(out, state.uploadedVertices);
+    Implementation::addArrayMemoryUsage(out, state.uploadedIndices);
+
+    /* The buffers are reallocated only when they need to grow, so the
+       capacity is what's actually allocated */
+    out.gpu += state.vertexBufferCapacity + state.indexBufferCapacity;
+    return out;
+}
+
+void LineLayerGL::doTrim(const std::size_t capacity) {
+    LineLayer::doTrim(capacity);
+
+    auto& state = static_cast<State&>(*_state);
+    Implementation::shrinkGrowable(state.vertexBuffer, state.vertexBufferCapacity, state.uploadedVertices);
+    Implementation::shrinkGrowable(state.indexBuffer, state.indexBufferCapacity, state.uploadedIndices);
 }
 
 LayerFeatures LineLayerGL::doFeatures() const {
-    return LineLayer::doFeatures()|LayerFeature::DrawUsesBlending;
+    return LineLayer::doFeatures()|LayerFeature::DrawUsesBlending|LayerFeature::ConcurrentUpdate;
 }
 
 void LineLayerGL::doSetSize(const Vector2& size, const Vector2i& framebufferSize) {
+    /* The base implementation tracks the pixel size for line decimation */
+    LineLayer::doSetSize(size, framebufferSize);
+
     auto& state = static_cast<State&>(*_state);
     auto& sharedState = static_cast<Shared::State&>(state.shared);
 
@@ -247,27 +357,59 @@ void LineLayerGL::doSetSize(const Vector2& size, const Vector2i& framebufferSize
 }
 
 void LineLayerGL::doUpdate(const LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
-    State& state = static_cast<State&>(*_state);
-
     LineLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
 
+    /* All GL uploads are done in doPostUpdate() as this function may be
+       called from a different thread */
+}
+
+void LineLayerGL::doPostUpdate(const LayerStates states) {
+    State& state = static_cast<State&>(*_state);
+    auto& sharedState = static_cast<Shared::State&>(state.shared);
+
     /* The branching here mirrors how LineLayer::doUpdate() restricts the
-       updates */
-    if(states >= LayerState::NeedsNodeOrderUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+       updates.
+
+       Only the ranges that differ from what was uploaded last time are sent,
+       so for example changing a single line strip out of many uploads just
+       the vertices of that strip and the indices that got shifted by it. The
+       buffers grow by at least doubling their capacity, so lines that are
+       appended to don't cause a reallocation every time. */
+    const bool instanced = sharedState.flags >= LineLayerSharedFlag::InstancedSegments;
+    std::size_t uploadedSize = 0;
+    if(!instanced && (states >= LayerState::NeedsNodeOrderUpdate ||
+                      states >= LayerState::NeedsDataUpdate))
     {
-        state.indexBuffer.setData(state.indices);
+        /* Indices are compared per line segment, which is 6 indices */
+        uploadedSize += Implementation::uploadChangedRangesGrowable(state.indexBuffer, state.indexBufferCapacity, state.uploadedIndices,
+            Containers::arrayCast<const char>(Containers::arrayView(state.indices)),
+            6*sizeof(UnsignedInt));
         state.mesh.setCount(state.indices.size());
     }
-    if(states >= LayerState::NeedsNodeOffsetSizeUpdate ||
-       states >= LayerState::NeedsNodeEnabledUpdate ||
-       states >= LayerState::NeedsNodeOpacityUpdate ||
-       states >= LayerState::NeedsDataUpdate
-
-    )
+    if(!instanced && (states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+                      states >= LayerState::NeedsNodeEnabledUpdate ||
+                      states >= LayerState::NeedsNodeOpacityUpdate ||
+                      states >= LayerState::NeedsDataUpdate))
+    {
+        /* Vertices are compared per point, which is 2 vertices */
+        uploadedSize += Implementation::uploadChangedRangesGrowable(state.vertexBuffer, state.vertexBufferCapacity, state.uploadedVertices,
+            Containers::arrayCast<const char>(Containers::arrayView(state.vertices)),
+            2*sizeof(Implementation::LineLayerVertex));
+    }
+    /* Instances are in draw order, so they're compared per draw position and
+       not per segment offset. The index buffer is static. */
+    if(instanced && (states >= LayerState::NeedsNodeOrderUpdate ||
+                     states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+                     states >= LayerState::NeedsNodeEnabledUpdate ||
+                     states >= LayerState::NeedsNodeOpacityUpdate ||
+                     states >= LayerState::NeedsDataUpdate))
     {
-        state.vertexBuffer.setData(state.vertices);
+        uploadedSize += Implementation::uploadChangedRangesGrowable(state.vertexBuffer, state.vertexBufferCapacity, state.uploadedVertices,
+            Containers::arrayCast<const char>(Containers::arrayView(state.instances)),
+            sizeof(Implementation::LineLayerSegmentInstance));
     }
+
+    addUploadedSize(uploadedSize);
 }
 
 void LineLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>&, const std::size_t offset, const std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const std::size_t, const std::size_t, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) {
@@ -283,7 +425,12 @@ void LineLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>
        contains them, otherwise bind the shared buffer */
     sharedState.shader.bindStyleBuffer(sharedState.styleBuffer);
 
-    state.mesh
+    /* With instanced segments the draw offsets are directly the first
+       instance to draw */
+    if(sharedState.flags >= LineLayerSharedFlag::InstancedSegments) state.mesh
+        .setInstanceCount(state.indexDrawOffsets[offset + count] - state.indexDrawOffsets[offset])
+        .setBaseInstance(state.indexDrawOffsets[offset]);
+    else state.mesh
         .setIndexOffset(state.indexDrawOffsets[offset])
         .setCount(state.indexDrawOffsets[offset + count] - state.indexDrawOffsets[offset]);
     sharedState.shader
@@ -106,10 +106,13 @@ class MAGNUM_UI_EXPORT LineLayerGL: public LineLayer {
            causes linker errors. See LineLayerGLTest::constructDerived() for a
            repro case. */
         LayerFeatures doFeatures() const override;
+        MemoryUsage doMemoryUsage() const override;
+        void doTrim(std::size_t capacity) override;
 
         void doSetSize(const Vector2& size, const Vector2i& framebufferSize) override;
 
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
+        void doPostUpdate(LayerStates states) override;
 };
 
 /**
@@ -136,6 +139,19 @@ class MAGNUM_UI_EXPORT LineLayerGL::Shared: public LineLayer::Shared {
          */
         explicit Shared(NoCreateT) noexcept;
 
+        /**
+         * @brief Whether shader compilation has finished
+         * @m_since_latest
+         *
+         * The shaders are compiled and linked asynchronously if
+         * @gl_extension{KHR,parallel_shader_compile} is supported, allowing
+         * the application to do other work in the meantime. This function
+         * doesn't block. If the extension isn't supported, always returns
+         * @cpp true @ce. Drawing the layer before the compilation finished
+         * waits for it.
+         */
+        bool isCompileFinished();
+
     private:
         struct State;
         friend LineLayerGL;
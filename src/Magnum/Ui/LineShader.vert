@@ -53,10 +53,22 @@ layout(location = 0)
 uniform highp vec3 projection; /* xy = UI size to unit square scaling,
                                   z = pixel smoothness to UI size scaling */
 
+#ifndef INSTANCED_SEGMENTS
 layout(location = 0) in highp vec2 position;
 layout(location = 1) in highp vec2 previousPosition;
 layout(location = 2) in highp vec2 nextPosition;
 layout(location = 3) in lowp vec4 color;
+#else
+/* Corner of a static segment mesh, and both segment endpoints with their
+   colors plus the farther points of the joined neighbor segments per
+   instance. The per-vertex inputs are then calculated from these in main(). */
+layout(location = 5) in lowp uint segmentCorner;
+layout(location = 0) in highp vec4 segmentPositions;
+layout(location = 1) in highp vec2 segmentPreviousPosition;
+layout(location = 2) in highp vec2 segmentNextPosition;
+layout(location = 3) in lowp vec4 segmentColor0;
+layout(location = 6) in lowp vec4 segmentColor1;
+#endif
 layout(location = 4) in mediump uint annotationStyle;
 
 NOPERSPECTIVE out highp vec2 centerDistanceSigned;
@@ -81,8 +93,55 @@ highp vec2 expandLineVertex(
     out highp float hasCap);
 
 void main() {
+    #ifndef INSTANCED_SEGMENTS
     mediump uint annotation = annotationStyle & 0x7u;
     mediump uint style = annotationStyle >> 3;
+    #else
+    /* Expand the instance to the same per-vertex inputs as the non-instanced
+       case has. Corners 0 and 1 are the up and down vertex at the first
+       segment endpoint, 2 and 3 at the second endpoint, 4 and 5 are the up
+       and down vertex of the neighbor segment joined at the second endpoint
+       and 6 and 7 of the neighbor segment joined at the first endpoint. If
+       the join isn't drawn by this segment, corners 4 to 7 become the same as
+       corners 2, 3, 0 and 1, making the join triangles degenerate. */
+    mediump uint style = annotationStyle >> 6;
+    bool atSecond = segmentCorner >= 2u && segmentCorner < 6u;
+    mediump uint annotationShift = atSecond ? 1u : 0u;
+    highp vec2 position = atSecond ? segmentPositions.zw : segmentPositions.xy;
+    highp vec2 otherPosition = atSecond ? segmentPositions.xy : segmentPositions.zw;
+    highp vec2 neighborPosition = atSecond ? segmentNextPosition : segmentPreviousPosition;
+    lowp vec4 color = atSecond ? segmentColor1 : segmentColor0;
+
+    /* Up, join and begin bits are 1u, 2u and 4u, same as the constants in
+       LineShader.in.vert. Even corners are the up vertices, the join bit is
+       there if the segment has a neighbor at given endpoint. */
+    mediump uint annotation = (segmentCorner & 1u) == 0u ? 1u : 0u;
+    if((annotationStyle & (1u << annotationShift)) != 0u)
+        annotation |= 2u;
+    highp vec2 previousPosition, nextPosition;
+    /* Vertex of the neighbor segment, for which the other segment endpoint
+       is the neighbor. It's a begin vertex of the neighbor segment if the
+       point is its first point. */
+    if(segmentCorner >= 4u && (annotationStyle & (4u << annotationShift)) != 0u) {
+        if((annotationStyle & (16u << annotationShift)) != 0u) {
+            annotation |= 4u;
+            previousPosition = otherPosition;
+            nextPosition = neighborPosition;
+        } else {
+            previousPosition = neighborPosition;
+            nextPosition = otherPosition;
+        }
+    /* Begin vertex of this segment */
+    } else if(!atSecond) {
+        annotation |= 4u;
+        previousPosition = neighborPosition;
+        nextPosition = otherPosition;
+    /* End vertex of this segment */
+    } else {
+        previousPosition = otherPosition;
+        nextPosition = neighborPosition;
+    }
+    #endif
     mediump const float width = styles[style].style_width;
     /* The common smoothness is in pixels, treated the same way as in BaseLayer
        and TextLayer. The per-style smoothness is in UI units for glows and
@@ -0,0 +1,105 @@
+#ifndef Magnum_Ui_MemoryUsage_h
+#define Magnum_Ui_MemoryUsage_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Struct @ref Magnum::Ui::MemoryUsage
+ * @m_since_latest
+ */
+
+#include <cstddef>
+
+#include "Magnum/Ui/Ui.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Memory usage
+@m_since_latest
+
+Returned from @ref AbstractLayer::memoryUsage(),
+@ref AbstractLayouter::memoryUsage(), @ref AbstractAnimator::memoryUsage()
+and @ref AbstractUserInterface::memoryUsage(). All values are in bytes. The
+values are calculated from sizes and capacities of internal arrays at the time
+of the call and don't include the size of the instance itself, allocator
+overhead or state shared among multiple instances such as styles, fonts or
+glyph caches.
+*/
+struct MemoryUsage {
+    /**
+     * @brief CPU memory in use
+     *
+     * Sum of sizes of all internal CPU-side arrays.
+     */
+    std::size_t cpuUsed;
+
+    /**
+     * @brief CPU memory reserved
+     *
+     * Sum of capacities of all internal CPU-side arrays. Always at least
+     * @ref cpuUsed, the difference is memory allocated upfront for future
+     * growth.
+     */
+    std::size_t cpuReserved;
+
+    /**
+     * @brief CPU memory in use but not holding live data
+     *
+     * Subset of @ref cpuUsed occupied by free slots of removed layer data,
+     * layouts, animations or nodes, and by removed text, glyph or line runs
+     * that are waiting for a compaction in the next update.
+     */
+    std::size_t cpuUnused;
+
+    /**
+     * @brief GPU memory
+     *
+     * Sum of sizes of all GPU buffers owned by the instance. Textures that
+     * are set from outside, such as in @ref BaseLayerGL::setTexture(), and
+     * glyph caches shared among multiple instances aren't included. Zero for
+     * instances that don't have any GPU-side state.
+     */
+    std::size_t gpu;
+
+    /** @brief Add memory usage of another instance */
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        cpuUsed += other.cpuUsed;
+        cpuReserved += other.cpuReserved;
+        cpuUnused += other.cpuUnused;
+        gpu += other.gpu;
+        return *this;
+    }
+
+    /** @brief Sum of memory usage of two instances */
+    MemoryUsage operator+(const MemoryUsage& other) const {
+        return MemoryUsage{*this} += other;
+    }
+};
+
+}}
+
+#endif
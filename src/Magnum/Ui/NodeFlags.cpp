@@ -43,6 +43,7 @@ Debug& operator<<(Debug& debug, const NodeFlag value) {
         _c(FallthroughPointerEvents)
         _c(Focusable)
         _c(NoBlur)
+        _c(Cached)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -59,7 +60,8 @@ Debug& operator<<(Debug& debug, const NodeFlags value) {
         NodeFlag::NoEvents,
         NodeFlag::FallthroughPointerEvents,
         NodeFlag::Focusable,
-        NodeFlag::NoBlur
+        NodeFlag::NoBlur,
+        NodeFlag::Cached
     });
 }
 
@@ -150,7 +150,31 @@ enum class NodeFlag: UnsignedByte {
      * Changing this flag causes
      * @ref UserInterfaceState::NeedsNodeEventMaskUpdate to be set.
      */
-    NoBlur = 1 << 6
+    NoBlur = 1 << 6,
+
+    /**
+     * Render the node and all nested nodes into an offscreen cache once and
+     * then draw them from there as a single quad, until anything in the
+     * hierarchy changes. Useful for complex hierarchies that change only
+     * rarely, such as detailed chart legends. Has an effect only on top-level
+     * nodes and only if the renderer advertises
+     * @ref RendererFeature::DrawCache, ignored for hierarchies that contain
+     * data of layers advertising @ref LayerFeature::Composite.
+     *
+     * The cache gets rendered again if offset, size, opacity, enabled state or
+     * visibility of any node in the hierarchy changes, including moving the
+     * whole hierarchy, if any layer that has data in the hierarchy updates its
+     * data, or if data attachment of any layer changes. Only the bounding
+     * rectangle of all visible nodes in the hierarchy is drawn from the
+     * cache, so content drawn outside of node rectangles, such as outlines
+     * or overflowing text, gets cut. Draw merging enabled
+     * with @ref AbstractUserInterface::setDrawMerging() isn't done
+     * while any cached hierarchy is drawn.
+     *
+     * Changing this flag causes
+     * @ref UserInterfaceState::NeedsDataAttachmentUpdate to be set.
+     */
+    Cached = 1 << 7
 };
 
 /**
@@ -26,16 +26,49 @@
 
 #include "RendererGL.h"
 
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/EnumSet.hpp>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Move.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Context.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/Extensions.h>
+#endif
 #include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/OpenGL.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/PrimitiveQuery.h>
+#endif
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
 #include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
+#include <Magnum/GL/TimeQuery.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Range.h>
 
+#include "Magnum/Ui/AbstractUserInterface.h"
+
+#ifdef MAGNUM_UI_BUILD_STATIC
+static void importShaderResources() {
+    CORRADE_RESOURCE_INITIALIZE(MagnumUi_RESOURCES)
+}
+#endif
+
 namespace Magnum { namespace Ui {
 
+using namespace Containers::Literals;
+
 Debug& operator<<(Debug& debug, const RendererGL::Flag value) {
     debug << "Ui::RendererGL::Flag" << Debug::nospace;
 
@@ -43,6 +76,11 @@ Debug& operator<<(Debug& debug, const RendererGL::Flag value) {
         /* LCOV_EXCL_START */
         #define _c(value) case RendererGL::Flag::value: return debug << "::" #value;
         _c(CompositingFramebuffer)
+        _c(RetainedFramebuffer)
+        _c(LayerProfiling)
+        _c(DepthBuffer)
+        _c(DrawCache)
+        _c(DynamicResolution)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -52,20 +90,220 @@ Debug& operator<<(Debug& debug, const RendererGL::Flag value) {
 
 Debug& operator<<(Debug& debug, const RendererGL::Flags value) {
     return Containers::enumSetDebugOutput(debug, value, "Ui::RendererGL::Flags{}", {
-        RendererGL::Flag::CompositingFramebuffer
+        RendererGL::Flag::CompositingFramebuffer,
+        RendererGL::Flag::RetainedFramebuffer,
+        RendererGL::Flag::LayerProfiling,
+        RendererGL::Flag::DepthBuffer,
+        RendererGL::Flag::DrawCache,
+        RendererGL::Flag::DynamicResolution
+    });
+}
+
+namespace {
+
+/* Used with Flag::LayerProfiling. Queries for all layer draws and composites
+   in one frame, reused across frames. */
+struct ProfileFrame {
+    /* Two timestamps for each profiled range */
+    Containers::Array<GL::TimeQuery> timestamps;
+    #ifndef MAGNUM_TARGET_GLES
+    Containers::Array<GL::PrimitiveQuery> primitives;
+    #endif
+    Containers::Array<LayerHandle> layers;
+    /* Count of profiled ranges in this frame */
+    std::size_t count = 0;
+    /* Whether the frame was submitted and waits for its results to be
+       retrieved */
+    bool pending = false;
+};
+
+struct LayerProfile {
+    LayerHandle layer;
+    UnsignedInt drawCount;
+    UnsignedLong gpuDuration;
+    #ifndef MAGNUM_TARGET_GLES
+    UnsignedLong primitiveCount;
+    #endif
+};
+
+/* Used with Flag::DrawCache. The texture has just the size of `rect`, the
+   contents are rendered into a scratch framebuffer of the whole framebuffer
+   size shared by all caches, so layers can keep using framebuffer coordinates
+   for scissor rects, and then just the `rect` gets copied here. The `size` is
+   the size the texture was allocated with, which is at least 1x1. */
+struct Cache {
+    GL::Texture2D texture{NoCreate};
+    GL::Framebuffer framebuffer{NoCreate};
+    Range2Di rect;
+    Vector2i size;
+};
+
+/* Draws a cache texture blended over the framebuffer. Uses the same vertex
+   shader as BlurShaderGL. */
+class CacheShaderGL: public GL::AbstractShaderProgram {
+    private:
+        enum: Int {
+            /* Same as BlurShaderGL::TextureBinding */
+            TextureBinding = 6
+        };
+
+    public:
+        typedef GL::Attribute<0, Vector2> Position;
+
+        explicit CacheShaderGL(NoCreateT): GL::AbstractShaderProgram{NoCreate} {}
+        explicit CacheShaderGL();
+
+        CacheShaderGL& setProjection(const Vector2& scaling) {
+            /* Same as BlurShaderGL::setProjection() */
+            setUniform(_projectionUniform, Vector2{2.0f, -2.0f}/scaling);
+            return *this;
+        }
+
+        /* Maps the [0, 1] texture coordinates calculated by the vertex
+           shader to the texture, for textures that cover just a part of the
+           projection */
+        CacheShaderGL& setTextureTransform(const Vector2& scaling, const Vector2& offset) {
+            setUniform(_textureTransformUniform, Vector4{offset.x(), offset.y(), scaling.x(), scaling.y()});
+            return *this;
+        }
+
+        CacheShaderGL& bindTexture(GL::Texture2D& texture) {
+            texture.bind(TextureBinding);
+            return *this;
+        }
+
+    private:
+        Int _projectionUniform = 0,
+            _textureTransformUniform = 1;
+};
+
+CacheShaderGL::CacheShaderGL() {
+    GL::Context& context = GL::Context::current();
+    #ifndef MAGNUM_TARGET_GLES
+    MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
+    #endif
+
+    #ifdef MAGNUM_UI_BUILD_STATIC
+    if(!Utility::Resource::hasGroup("MagnumUi"_s))
+        importShaderResources();
+    #endif
+
+    Utility::Resource rs{"MagnumUi"_s};
+
+    const GL::Version version = context.supportedVersion({
+        #ifndef MAGNUM_TARGET_GLES
+        GL::Version::GL330
+        #else
+        GL::Version::GLES300
+            #ifndef MAGNUM_TARGET_WEBGL
+            , GL::Version::GLES310
+            #endif
+        #endif
     });
+
+    GL::Shader vert{version, GL::Shader::Type::Vertex};
+    vert.addSource(rs.getString("compatibility.glsl"_s))
+        .addSource(rs.getString("BlurShader.vert"_s));
+
+    GL::Shader frag{version, GL::Shader::Type::Fragment};
+    frag.addSource(rs.getString("compatibility.glsl"_s))
+        .addSource(rs.getString("CacheShader.frag"_s));
+
+    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+
+    attachShaders({vert, frag});
+    CORRADE_INTERNAL_ASSERT(link());
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
+    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    if(version < GL::Version::GLES310)
+    #endif
+    {
+        _projectionUniform = uniformLocation("projection"_s);
+        _textureTransformUniform = uniformLocation("textureTransform"_s);
+    }
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(!context.isExtensionSupported<GL::Extensions::ARB::shading_language_420pack>())
+    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    if(version < GL::Version::GLES310)
+    #endif
+    {
+        setUniform(uniformLocation("textureData"_s), TextureBinding);
+    }
+}
+
 }
 
 struct RendererGL::State {
-    explicit State(Flags flags): flags{flags} {}
+    explicit State(Flags flags, GL::TextureFormat compositingTextureFormat): flags{flags}, compositingTextureFormat{compositingTextureFormat} {}
 
     bool scissorUsed = false;
+    /* Set if the scissor was enabled for a partial redraw with
+       Flag::RetainedFramebuffer */
+    bool redrawScissorUsed = false;
     Flags flags;
+    GL::TextureFormat compositingTextureFormat;
+    UnsignedInt compositingContentGeneration = 0;
+    /* If renderTargetTexture is set, it's a non-owning wrapper of a texture
+       passed to setRenderTargetTexture() */
     GL::Texture2D compositingTexture{NoCreate};
     GL::Framebuffer compositingFramebuffer{NoCreate};
+    bool renderTargetTexture = false;
+    /* Used only if Flag::DepthBuffer is enabled */
+    GL::Renderbuffer depthRenderbuffer{NoCreate};
+    /* Set if glDepthRange() was changed from the default in this draw */
+    bool drawDepthUsed = false;
+
+    /* Used only if Flag::LayerProfiling is enabled. A ring of frames with
+       queries in flight, and the per-layer results of the most recent frame
+       that was retrieved. */
+    ProfileFrame profileFrames[3];
+    UnsignedInt currentProfileFrame = 0;
+    Containers::Array<LayerProfile> layerProfiles;
+
+    /* Used only if Flag::DrawCache is enabled. Indexed by the cache ID, the
+       scratch texture and framebuffer is created on the first beginCache(),
+       the shader and the mesh on the first setupFramebuffers(). */
+    Containers::Array<Cache> caches;
+    GL::Texture2D cacheScratchTexture{NoCreate};
+    GL::Framebuffer cacheScratchFramebuffer{NoCreate};
+    CacheShaderGL cacheShader{NoCreate};
+    GL::Buffer cacheVertexBuffer{NoCreate};
+    GL::Mesh cacheMesh{NoCreate};
+
+    /* Used only if Flag::DynamicResolution is enabled. The scaled texture is
+       recreated when the scaled size changes, and is resolved into the
+       compositing framebuffer using the cache shader and mesh above. */
+    UnsignedLong dynamicResolutionBudget = 8000000;
+    Float minResolutionScale = 0.5f;
+    Float resolutionScale = 1.0f;
+    /* Count of retrieved profile frames to wait before the next scale
+       change */
+    UnsignedInt resolutionScaleCooldown = 0;
+    Containers::Array<LayerHandle> nativeResolutionLayers;
+    GL::Texture2D scaledTexture{NoCreate};
+    GL::Framebuffer scaledFramebuffer{NoCreate};
+    Vector2i scaledSize;
+    /* Set if the scaled framebuffer is used in this draw, if it's currently
+       the draw target and if anything was drawn to it since the last
+       resolve */
+    bool scaledActive = false;
+    bool scaledBound = false;
+    bool scaledDirty = false;
 };
 
-RendererGL::RendererGL(const Flags flags): _state{InPlaceInit, flags} {}
+RendererGL::RendererGL(const Flags flags): RendererGL{flags, GL::TextureFormat::RGBA8} {}
+
+RendererGL::RendererGL(const Flags flags, const GL::TextureFormat compositingTextureFormat): _state{InPlaceInit, flags, compositingTextureFormat} {
+    CORRADE_ASSERT(!(flags & Flag::DepthBuffer) || flags & (Flag::CompositingFramebuffer|Flag::RetainedFramebuffer),
+        "Ui::RendererGL:" << Flag::DepthBuffer << "expects" << Flag::CompositingFramebuffer << "or" << Flag::RetainedFramebuffer << "to be enabled as well", );
+    CORRADE_ASSERT(!(flags & Flag::DrawCache) || flags & (Flag::CompositingFramebuffer|Flag::RetainedFramebuffer),
+        "Ui::RendererGL:" << Flag::DrawCache << "expects" << Flag::CompositingFramebuffer << "or" << Flag::RetainedFramebuffer << "to be enabled as well", );
+    CORRADE_ASSERT(!(flags & Flag::DynamicResolution) || (flags >= (Flag::CompositingFramebuffer|Flag::LayerProfiling) && !(flags & (Flag::RetainedFramebuffer|Flag::DepthBuffer))),
+        "Ui::RendererGL:" << Flag::DynamicResolution << "expects" << (Flag::CompositingFramebuffer|Flag::LayerProfiling) << "to be enabled as well and isn't combinable with" << (Flag::RetainedFramebuffer|Flag::DepthBuffer), );
+}
 
 RendererGL::RendererGL(RendererGL&&) noexcept = default;
 
@@ -75,9 +313,13 @@ RendererGL& RendererGL::operator=(RendererGL&&) noexcept = default;
 
 RendererGL::Flags RendererGL::flags() const { return _state->flags; }
 
+GL::TextureFormat RendererGL::compositingTextureFormat() const {
+    return _state->compositingTextureFormat;
+}
+
 const GL::Framebuffer& RendererGL::compositingFramebuffer() const {
     const State& state = *_state;
-    CORRADE_ASSERT(state.flags & Flag::CompositingFramebuffer,
+    CORRADE_ASSERT(state.flags & (Flag::CompositingFramebuffer|Flag::RetainedFramebuffer),
         "Ui::RendererGL::compositingFramebuffer(): compositing framebuffer not enabled", state.compositingFramebuffer);
     CORRADE_ASSERT(!framebufferSize().isZero(),
         "Ui::RendererGL::compositingFramebuffer(): framebuffer size wasn't set up", state.compositingFramebuffer);
@@ -90,7 +332,7 @@ GL::Framebuffer& RendererGL::compositingFramebuffer() {
 
 const GL::Texture2D& RendererGL::compositingTexture() const {
     const State& state = *_state;
-    CORRADE_ASSERT(state.flags & Flag::CompositingFramebuffer,
+    CORRADE_ASSERT(state.flags & (Flag::CompositingFramebuffer|Flag::RetainedFramebuffer),
         "Ui::RendererGL::compositingTexture(): compositing framebuffer not enabled", state.compositingTexture);
     CORRADE_ASSERT(!framebufferSize().isZero(),
         "Ui::RendererGL::compositingTexture(): framebuffer size wasn't set up", state.compositingTexture);
@@ -101,36 +343,332 @@ GL::Texture2D& RendererGL::compositingTexture() {
     return const_cast<GL::Texture2D&>(const_cast<const RendererGL&>(*this).compositingTexture());
 }
 
+const GL::Renderbuffer& RendererGL::depthRenderbuffer() const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::DepthBuffer,
+        "Ui::RendererGL::depthRenderbuffer(): depth buffer not enabled", state.depthRenderbuffer);
+    CORRADE_ASSERT(!framebufferSize().isZero(),
+        "Ui::RendererGL::depthRenderbuffer(): framebuffer size wasn't set up", state.depthRenderbuffer);
+    return state.depthRenderbuffer;
+}
+
+GL::Renderbuffer& RendererGL::depthRenderbuffer() {
+    return const_cast<GL::Renderbuffer&>(const_cast<const RendererGL&>(*this).depthRenderbuffer());
+}
+
+bool RendererGL::hasRenderTargetTexture() const {
+    return _state->renderTargetTexture;
+}
+
+RendererGL& RendererGL::setRenderTargetTexture(GL::Texture2D& texture) {
+    State& state = *_state;
+    CORRADE_ASSERT(state.flags & (Flag::CompositingFramebuffer|Flag::RetainedFramebuffer),
+        "Ui::RendererGL::setRenderTargetTexture(): compositing framebuffer not enabled", *this);
+    CORRADE_ASSERT(texture.id(),
+        "Ui::RendererGL::setRenderTargetTexture(): texture not created", *this);
+
+    /* Keep the previous framebuffer alive until the contents are copied */
+    const UnsignedInt previousTextureId = state.compositingTexture.id();
+    GL::Framebuffer previousFramebuffer = Utility::move(state.compositingFramebuffer);
+
+    state.compositingTexture = GL::Texture2D::wrap(texture.id());
+    state.renderTargetTexture = true;
+
+    /* If the framebuffer was set up already, attach the new texture right
+       away. For a retained framebuffer copy the contents over, as
+       AbstractUserInterface doesn't know it should redraw everything. A
+       self-blit if the same texture is set again isn't allowed, and isn't
+       needed anyway. */
+    const Vector2i size = framebufferSize();
+    if(!size.isZero()) {
+        setupCompositingFramebuffer(size);
+        if(state.flags & Flag::RetainedFramebuffer && previousFramebuffer.id() && previousTextureId != texture.id())
+            GL::AbstractFramebuffer::blit(previousFramebuffer, state.compositingFramebuffer, {{}, size}, GL::FramebufferBlit::Color);
+        ++state.compositingContentGeneration;
+    }
+
+    return *this;
+}
+
+Vector2 RendererGL::globalPositionFromTextureCoordinates(const AbstractUserInterface& ui, const Vector2& textureCoordinates) {
+    /* The UI has the origin at the top left, texture coordinates at the
+       bottom left */
+    return Vector2{textureCoordinates.x(), 1.0f - textureCoordinates.y()}*ui.windowSize();
+}
+
+UnsignedInt RendererGL::compositingContentGeneration() const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::CompositingFramebuffer,
+        "Ui::RendererGL::compositingContentGeneration(): compositing framebuffer not enabled", {});
+    return state.compositingContentGeneration;
+}
+
+RendererGL& RendererGL::incrementCompositingContentGeneration() {
+    State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::CompositingFramebuffer,
+        "Ui::RendererGL::incrementCompositingContentGeneration(): compositing framebuffer not enabled", *this);
+    ++state.compositingContentGeneration;
+    return *this;
+}
+
+namespace {
+
+const LayerProfile* findLayerProfile(const Containers::ArrayView<const LayerProfile> profiles, const LayerHandle layer) {
+    for(const LayerProfile& profile: profiles)
+        if(profile.layer == layer) return &profile;
+    return nullptr;
+}
+
+}
+
+UnsignedLong RendererGL::layerGpuDuration(const LayerHandle layer) const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::LayerProfiling,
+        "Ui::RendererGL::layerGpuDuration(): layer profiling not enabled", {});
+    const LayerProfile* const profile = findLayerProfile(state.layerProfiles, layer);
+    return profile ? profile->gpuDuration : 0;
+}
+
+#ifndef MAGNUM_TARGET_GLES
+UnsignedLong RendererGL::layerPrimitiveCount(const LayerHandle layer) const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::LayerProfiling,
+        "Ui::RendererGL::layerPrimitiveCount(): layer profiling not enabled", {});
+    const LayerProfile* const profile = findLayerProfile(state.layerProfiles, layer);
+    return profile ? profile->primitiveCount : 0;
+}
+#endif
+
+UnsignedInt RendererGL::layerDrawCount(const LayerHandle layer) const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::LayerProfiling,
+        "Ui::RendererGL::layerDrawCount(): layer profiling not enabled", {});
+    const LayerProfile* const profile = findLayerProfile(state.layerProfiles, layer);
+    return profile ? profile->drawCount : 0;
+}
+
+UnsignedLong RendererGL::dynamicResolutionBudget() const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::DynamicResolution,
+        "Ui::RendererGL::dynamicResolutionBudget(): dynamic resolution not enabled", {});
+    return state.dynamicResolutionBudget;
+}
+
+RendererGL& RendererGL::setDynamicResolutionBudget(const UnsignedLong budget) {
+    State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::DynamicResolution,
+        "Ui::RendererGL::setDynamicResolutionBudget(): dynamic resolution not enabled", *this);
+    state.dynamicResolutionBudget = budget;
+    return *this;
+}
+
+Float RendererGL::minResolutionScale() const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::DynamicResolution,
+        "Ui::RendererGL::minResolutionScale(): dynamic resolution not enabled", {});
+    return state.minResolutionScale;
+}
+
+RendererGL& RendererGL::setMinResolutionScale(const Float scale) {
+    State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::DynamicResolution,
+        "Ui::RendererGL::setMinResolutionScale(): dynamic resolution not enabled", *this);
+    CORRADE_ASSERT(scale > 0.0f && scale <= 1.0f,
+        "Ui::RendererGL::setMinResolutionScale(): expected a scale in range (0, 1] but got" << scale, *this);
+    state.minResolutionScale = scale;
+    state.resolutionScale = Math::max(state.resolutionScale, scale);
+    return *this;
+}
+
+Float RendererGL::resolutionScale() const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::DynamicResolution,
+        "Ui::RendererGL::resolutionScale(): dynamic resolution not enabled", {});
+    return state.resolutionScale;
+}
+
+RendererGL& RendererGL::setResolutionScale(const Float scale) {
+    State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::DynamicResolution,
+        "Ui::RendererGL::setResolutionScale(): dynamic resolution not enabled", *this);
+    CORRADE_ASSERT(scale >= state.minResolutionScale && scale <= 1.0f,
+        "Ui::RendererGL::setResolutionScale(): expected a scale between" << state.minResolutionScale << "and 1 but got" << scale, *this);
+    state.resolutionScale = scale;
+    return *this;
+}
+
+RendererGL& RendererGL::setNativeResolutionLayers(const Containers::ArrayView<const LayerHandle> layers) {
+    State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::DynamicResolution,
+        "Ui::RendererGL::setNativeResolutionLayers(): dynamic resolution not enabled", *this);
+    arrayResize(state.nativeResolutionLayers, NoInit, layers.size());
+    Utility::copy(layers, state.nativeResolutionLayers);
+    return *this;
+}
+
+RendererGL& RendererGL::setNativeResolutionLayers(const std::initializer_list<LayerHandle> layers) {
+    return setNativeResolutionLayers(Containers::arrayView(layers));
+}
+
 RendererFeatures RendererGL::doFeatures() const {
-    return _state->flags & Flag::CompositingFramebuffer ?
-        RendererFeature::Composite : RendererFeatures{};
+    RendererFeatures features;
+    if(_state->flags & Flag::CompositingFramebuffer)
+        features |= RendererFeature::Composite;
+    if(_state->flags & Flag::RetainedFramebuffer)
+        features |= RendererFeature::PartialRedraw;
+    if(_state->flags & Flag::LayerProfiling)
+        features |= RendererFeature::LayerProfiling;
+    if(_state->flags & Flag::DepthBuffer)
+        features |= RendererFeature::DepthBuffer;
+    if(_state->flags & Flag::DrawCache)
+        features |= RendererFeature::DrawCache;
+    return features;
 }
 
 void RendererGL::doSetupFramebuffers(const Vector2i& size) {
     /** @todo recreate only if size changes, and not if size gets smaller?
         would however mean the compositor needs to be aware that there's just a
         subset of the texture being used */
-    if(_state->flags & Flag::CompositingFramebuffer) {
-        (_state->compositingTexture = GL::Texture2D{})
+    if(_state->flags & (Flag::CompositingFramebuffer|Flag::RetainedFramebuffer)) {
+        /* A user-provided render target texture is expected to have the
+           right size already */
+        if(!_state->renderTargetTexture) (_state->compositingTexture = GL::Texture2D{})
             .setMinificationFilter(GL::SamplerFilter::Linear, GL::SamplerMipmap::Base)
             .setMagnificationFilter(GL::SamplerFilter::Linear)
             .setWrapping(GL::SamplerWrapping::ClampToEdge)
-            .setStorage(1, GL::TextureFormat::RGBA8, size);
-        (_state->compositingFramebuffer = GL::Framebuffer{{{}, size}})
-            .attachTexture(GL::Framebuffer::ColorAttachment{0}, _state->compositingTexture, 0);
+            .setStorage(1, _state->compositingTextureFormat, size);
+        if(_state->flags & Flag::DepthBuffer) (_state->depthRenderbuffer = GL::Renderbuffer{})
+            .setStorage(GL::RenderbufferFormat::DepthComponent24, size);
+        setupCompositingFramebuffer(size);
+        ++_state->compositingContentGeneration;
     }
+
+    /* The cache rects and the scratch framebuffer depend on the framebuffer
+       size, so they're discarded and created again on the next beginCache().
+       The shader and mesh is used for resolving the scaled framebuffer as
+       well. */
+    if(_state->flags & (Flag::DrawCache|Flag::DynamicResolution)) {
+        arrayResize(_state->caches, 0);
+        _state->cacheScratchTexture = GL::Texture2D{NoCreate};
+        _state->cacheScratchFramebuffer = GL::Framebuffer{NoCreate};
+        if(!_state->cacheShader.id()) {
+            _state->cacheShader = CacheShaderGL{};
+            _state->cacheVertexBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
+            (_state->cacheMesh = GL::Mesh{GL::MeshPrimitive::TriangleStrip})
+                .setCount(4)
+                .addVertexBuffer(_state->cacheVertexBuffer, 0, CacheShaderGL::Position{});
+        }
+    }
+}
+
+void RendererGL::setupCompositingFramebuffer(const Vector2i& size) {
+    (_state->compositingFramebuffer = GL::Framebuffer{{{}, size}})
+        .attachTexture(GL::Framebuffer::ColorAttachment{0}, _state->compositingTexture, 0);
+    if(_state->flags & Flag::DepthBuffer)
+        _state->compositingFramebuffer.attachRenderbuffer(GL::Framebuffer::BufferAttachment::Depth, _state->depthRenderbuffer);
 }
 
-void RendererGL::doTransition(RendererTargetState, const RendererTargetState targetStateTo, const RendererDrawStates drawStatesFrom, const RendererDrawStates drawStatesTo) {
+void RendererGL::doTransition(const RendererTargetState targetStateFrom, const RendererTargetState targetStateTo, const RendererDrawStates drawStatesFrom, const RendererDrawStates drawStatesTo) {
     State& state = *_state;
 
-    /* If the compositing framebuffer is active, make sure to bind it when
-       transitioning to a layer draw state or to the final state. */
-    if(state.flags & Flag::CompositingFramebuffer &&
+    /* With a retained framebuffer, clear the area that's going to be redrawn
+       when starting to draw. If it's not the whole framebuffer, restrict all
+       drawing to it with a scissor. AbstractUserInterface doesn't ask for a
+       partial redraw if any layer uses the scissor on its own. If the area is
+       empty, nothing gets drawn and the framebuffer is kept as it was. The
+       depth buffer, if present, is cleared together with it. */
+    if(state.flags & Flag::RetainedFramebuffer &&
+       targetStateFrom == RendererTargetState::Initial)
+    {
+        const Range2Di rect = redrawRect();
+        if(rect.size().product()) {
+            state.compositingFramebuffer.bind();
+            if(rect != Range2Di{{}, framebufferSize()}) {
+                GL::Renderer::enable(GL::Renderer::Feature::ScissorTest);
+                /* The redraw rect has the origin at the top left, GL at the
+                   bottom left */
+                GL::Renderer::setScissor(Range2Di::fromSize(
+                    {rect.min().x(), framebufferSize().y() - rect.max().y()},
+                    rect.size()));
+                state.redrawScissorUsed = true;
+            }
+            state.compositingFramebuffer.clear(state.flags & Flag::DepthBuffer ?
+                GL::FramebufferClear::Color|GL::FramebufferClear::Depth :
+                GL::FramebufferClear::Color);
+        }
+
+    /* Otherwise the application is responsible for clearing the color, but
+       the depth buffer is internal to the renderer so it has to be cleared
+       here */
+    } else if(state.flags & Flag::DepthBuffer &&
+              targetStateFrom == RendererTargetState::Initial &&
+              targetStateTo != RendererTargetState::Final)
+    {
+        state.compositingFramebuffer.clear(GL::FramebufferClear::Depth);
+    }
+
+    /* With dynamic resolution, decide at the start whether the scaled
+       framebuffer is used in this draw, (re)create it if its size changed
+       and clear it to transparent black, as it gets blended over the
+       compositing framebuffer later. Drawing then starts with it bound. */
+    if(state.flags & Flag::DynamicResolution &&
+       targetStateFrom == RendererTargetState::Initial)
+    {
+        state.scaledActive = state.resolutionScale < 1.0f &&
+            targetStateTo != RendererTargetState::Final;
+        if(state.scaledActive) {
+            const Vector2i size = Math::max(Vector2i{Vector2{framebufferSize()}*state.resolutionScale + Vector2{0.5f}}, Vector2i{1});
+            if(size != state.scaledSize) {
+                (state.scaledTexture = GL::Texture2D{})
+                    .setMinificationFilter(GL::SamplerFilter::Linear, GL::SamplerMipmap::Base)
+                    .setMagnificationFilter(GL::SamplerFilter::Linear)
+                    .setWrapping(GL::SamplerWrapping::ClampToEdge)
+                    .setStorage(1, state.compositingTextureFormat, size);
+                (state.scaledFramebuffer = GL::Framebuffer{{{}, size}})
+                    .attachTexture(GL::Framebuffer::ColorAttachment{0}, state.scaledTexture, 0);
+                state.scaledSize = size;
+            }
+            state.scaledFramebuffer.clearColor(0, Color4{0.0f});
+            state.scaledDirty = false;
+        }
+        state.scaledBound = state.scaledActive;
+    }
+
+    /* Before a compositing operation and at the end, blend what was drawn at
+       the reduced resolution over the compositing framebuffer, so the
+       compositing sees it and the application gets the final result */
+    if(state.scaledActive &&
+       (targetStateTo == RendererTargetState::Composite ||
+        targetStateTo == RendererTargetState::Final))
+    {
+        resolveScaledFramebuffer();
+        state.scaledBound = false;
+        if(targetStateTo == RendererTargetState::Final)
+            state.scaledActive = false;
+    }
+
+    /* If any layers were drawn before a compositing operation, assume they
+       changed the framebuffer contents. This is a conservative choice, the
+       layers may have drawn exactly the same as in the previous frame. */
+    if(targetStateFrom == RendererTargetState::Draw &&
+       targetStateTo == RendererTargetState::Composite)
+        ++state.compositingContentGeneration;
+
+    /* If the compositing or retained framebuffer is active, make sure to bind
+       it when transitioning to a layer draw state or to the final state. */
+    if(state.flags & (Flag::CompositingFramebuffer|Flag::RetainedFramebuffer) &&
        (targetStateTo == RendererTargetState::Draw ||
         targetStateTo == RendererTargetState::Final))
     {
-        state.compositingFramebuffer.bind();
+        /* Unless a cache is being rendered, in which case it's the cache
+           scratch framebuffer, or the scaled framebuffer is the draw target.
+           The base class allows only Draw while rendering a cache. */
+        if(currentCache() != ~UnsignedInt{})
+            state.cacheScratchFramebuffer.bind();
+        else if(state.scaledBound)
+            state.scaledFramebuffer.bind();
+        else
+            state.compositingFramebuffer.bind();
     }
 
     /* Flip GL state as appropriate. This does the right thing (i.e., disabling
@@ -147,14 +685,336 @@ void RendererGL::doTransition(RendererTargetState, const RendererTargetState tar
         state.scissorUsed = true;
     }
 
+    /* Content drawn with the same depth has to pass the test, in order to not
+       reject data after the opaque ones in the same draw. Depth is written
+       only in the pre-pass, where colors are not. */
+    if((drawStatesFrom >= RendererDrawState::DepthTest) !=
+         (drawStatesTo >= RendererDrawState::DepthTest)) {
+        GL::Renderer::setFeature(GL::Renderer::Feature::DepthTest, drawStatesTo >= RendererDrawState::DepthTest);
+        GL::Renderer::setDepthFunction(drawStatesTo >= RendererDrawState::DepthTest ?
+            GL::Renderer::DepthFunction::LessOrEqual :
+            GL::Renderer::DepthFunction::Less);
+    }
+
+    if((drawStatesFrom >= RendererDrawState::DepthTest) !=
+         (drawStatesTo >= RendererDrawState::DepthTest) ||
+       (drawStatesFrom >= RendererDrawState::DepthPrepass) !=
+         (drawStatesTo >= RendererDrawState::DepthPrepass)) {
+        GL::Renderer::setDepthMask(!(drawStatesTo >= RendererDrawState::DepthTest) || drawStatesTo >= RendererDrawState::DepthPrepass);
+    }
+
+    if((drawStatesFrom >= RendererDrawState::DepthPrepass) !=
+         (drawStatesTo >= RendererDrawState::DepthPrepass)) {
+        const bool write = !(drawStatesTo >= RendererDrawState::DepthPrepass);
+        GL::Renderer::setColorMask(write, write, write, write);
+    }
+
     /* Reset the scissor rect back to the whole framebuffer if scissor test was
        used by any layer in this draw */
     if(targetStateTo == RendererTargetState::Initial) {
         state.scissorUsed = false;
     } else if(targetStateTo == RendererTargetState::Final) {
-        if(state.scissorUsed)
+        if(state.redrawScissorUsed)
+            GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
+        if(state.scissorUsed || state.redrawScissorUsed)
             GL::Renderer::setScissor(Range2Di::fromSize({}, framebufferSize()));
+        state.redrawScissorUsed = false;
+
+        /* Reset the depth range back to the default if it was changed */
+        if(state.drawDepthUsed) {
+            #ifndef MAGNUM_TARGET_GLES
+            glDepthRange(0.0, 1.0);
+            #else
+            glDepthRangef(0.0f, 1.0f);
+            #endif
+            state.drawDepthUsed = false;
+        }
+
+        /* Submit the profiled frame and retrieve results of the frames that
+           are ready, oldest first so the most recent one is what stays in
+           the end. If the frame that's going to be reused next still isn't
+           ready, discard it instead of waiting for it. */
+        if(state.flags & Flag::LayerProfiling) {
+            bool retrieved = false;
+            state.profileFrames[state.currentProfileFrame].pending = state.profileFrames[state.currentProfileFrame].count != 0;
+            state.currentProfileFrame = (state.currentProfileFrame + 1) % Containers::arraySize(state.profileFrames);
+            for(std::size_t i = 0; i != Containers::arraySize(state.profileFrames); ++i) {
+                ProfileFrame& frame = state.profileFrames[(state.currentProfileFrame + i) % Containers::arraySize(state.profileFrames)];
+                if(!frame.pending || !frame.timestamps[frame.count*2 - 1].resultAvailable())
+                    continue;
+
+                arrayResize(state.layerProfiles, 0);
+                for(std::size_t j = 0; j != frame.count; ++j) {
+                    LayerProfile* profile = nullptr;
+                    for(LayerProfile& existing: state.layerProfiles) {
+                        if(existing.layer == frame.layers[j]) {
+                            profile = &existing;
+                            break;
+                        }
+                    }
+                    if(!profile) {
+                        profile = &arrayAppend(state.layerProfiles, InPlaceInit);
+                        profile->layer = frame.layers[j];
+                    }
+                    ++profile->drawCount;
+                    profile->gpuDuration += frame.timestamps[j*2 + 1].result<UnsignedLong>() - frame.timestamps[j*2].result<UnsignedLong>();
+                    #ifndef MAGNUM_TARGET_GLES
+                    profile->primitiveCount += frame.primitives[j].result<UnsignedLong>();
+                    #endif
+                }
+                frame.pending = false;
+                retrieved = true;
+            }
+
+            /* With dynamic resolution, lower the scale if the UI took longer
+               than the budget and raise it again if it's well below. The
+               results arrive a few frames late, so after a change wait until
+               frames drawn with the new scale get retrieved. */
+            if(state.flags & Flag::DynamicResolution && retrieved) {
+                if(state.resolutionScaleCooldown) {
+                    --state.resolutionScaleCooldown;
+                } else {
+                    UnsignedLong gpuDuration = 0;
+                    for(const LayerProfile& profile: state.layerProfiles)
+                        gpuDuration += profile.gpuDuration;
+
+                    Float scale = state.resolutionScale;
+                    if(gpuDuration > state.dynamicResolutionBudget)
+                        scale = Math::max(scale - 0.125f, state.minResolutionScale);
+                    else if(gpuDuration < state.dynamicResolutionBudget/2)
+                        scale = Math::min(scale + 0.125f, 1.0f);
+                    if(scale != state.resolutionScale) {
+                        state.resolutionScale = scale;
+                        state.resolutionScaleCooldown = Containers::arraySize(state.profileFrames);
+                    }
+                }
+            }
+
+            ProfileFrame& next = state.profileFrames[state.currentProfileFrame];
+            next.pending = false;
+            next.count = 0;
+        }
+    }
+}
+
+void RendererGL::doBeginLayerProfile(const LayerHandle layer) {
+    State& state = *_state;
+
+    /* With dynamic resolution, route the draw to either the scaled or the
+       compositing framebuffer. Draws using the scissor go to the latter as
+       the scissor rects are in native framebuffer pixels. Caches are always
+       rendered at the native resolution. */
+    if(state.scaledActive &&
+       currentTargetState() == RendererTargetState::Draw &&
+       currentCache() == ~UnsignedInt{})
+    {
+        bool native = currentDrawStates() >= RendererDrawState::Scissor;
+        for(std::size_t i = 0; !native && i != state.nativeResolutionLayers.size(); ++i)
+            native = state.nativeResolutionLayers[i] == layer;
+
+        if(native && state.scaledBound) {
+            resolveScaledFramebuffer();
+            state.compositingFramebuffer.bind();
+            state.scaledBound = false;
+        } else if(!native && !state.scaledBound) {
+            state.scaledFramebuffer.bind();
+            state.scaledBound = true;
+        }
+        if(state.scaledBound)
+            state.scaledDirty = true;
+    }
+
+    ProfileFrame& frame = state.profileFrames[state.currentProfileFrame];
+
+    /* Allocate new queries if there's more ranges than in any frame before */
+    if(frame.count == frame.layers.size()) {
+        arrayAppend(frame.timestamps, InPlaceInit, GL::TimeQuery::Target::Timestamp);
+        arrayAppend(frame.timestamps, InPlaceInit, GL::TimeQuery::Target::Timestamp);
+        #ifndef MAGNUM_TARGET_GLES
+        arrayAppend(frame.primitives, InPlaceInit, GL::PrimitiveQuery::Target::PrimitivesGenerated);
+        #endif
+        arrayAppend(frame.layers, layer);
+    } else frame.layers[frame.count] = layer;
+
+    frame.timestamps[frame.count*2].timestamp();
+    #ifndef MAGNUM_TARGET_GLES
+    frame.primitives[frame.count].begin();
+    #endif
+}
+
+void RendererGL::doEndLayerProfile(LayerHandle) {
+    ProfileFrame& frame = _state->profileFrames[_state->currentProfileFrame];
+    #ifndef MAGNUM_TARGET_GLES
+    frame.primitives[frame.count].end();
+    #endif
+    frame.timestamps[frame.count*2 + 1].timestamp();
+    ++frame.count;
+}
+
+void RendererGL::doSetDrawDepth(const Float depth) {
+    /* There's no GL::Renderer API for this. Collapsing the range to a single
+       value makes everything drawn have given depth, regardless of what the
+       shaders output. */
+    #ifndef MAGNUM_TARGET_GLES
+    glDepthRange(depth, depth);
+    #else
+    glDepthRangef(depth, depth);
+    #endif
+    _state->drawDepthUsed = true;
+}
+
+void RendererGL::doBeginCache(const UnsignedInt id, const Range2Di& rect) {
+    State& state = *_state;
+    if(id >= state.caches.size())
+        arrayResize(state.caches, ValueInit, id + 1);
+
+    /* The cache texture has just the size of the rect, allocated with at
+       least 1x1 as zero-sized textures aren't allowed. It's reallocated only
+       if the size changes, so moving the hierarchy around doesn't
+       reallocate it. */
+    Cache& cache = state.caches[id];
+    const Vector2i size = Math::max(rect.size(), Vector2i{1});
+    if(!cache.texture.id() || cache.size != size) {
+        (cache.texture = GL::Texture2D{})
+            .setMinificationFilter(GL::SamplerFilter::Nearest, GL::SamplerMipmap::Base)
+            .setMagnificationFilter(GL::SamplerFilter::Nearest)
+            .setWrapping(GL::SamplerWrapping::ClampToEdge)
+            .setStorage(1, state.compositingTextureFormat, size);
+        (cache.framebuffer = GL::Framebuffer{{{}, size}})
+            .attachTexture(GL::Framebuffer::ColorAttachment{0}, cache.texture, 0);
+        cache.size = size;
+    }
+    cache.rect = rect;
+
+    /* The scratch framebuffer the layers draw into is shared by all caches
+       and has the whole framebuffer size */
+    if(!state.cacheScratchTexture.id()) {
+        (state.cacheScratchTexture = GL::Texture2D{})
+            .setMinificationFilter(GL::SamplerFilter::Nearest, GL::SamplerMipmap::Base)
+            .setMagnificationFilter(GL::SamplerFilter::Nearest)
+            .setWrapping(GL::SamplerWrapping::ClampToEdge)
+            .setStorage(1, state.compositingTextureFormat, framebufferSize());
+        (state.cacheScratchFramebuffer = GL::Framebuffer{{{}, framebufferSize()}})
+            .attachTexture(GL::Framebuffer::ColorAttachment{0}, state.cacheScratchTexture, 0);
     }
+
+    /* Clear the scratch contents to transparent black so the cache can be
+       blended over the framebuffer later. A scissor, if enabled, would
+       restrict the clear, so it's disabled for it. */
+    const bool scissor = currentDrawStates() >= RendererDrawState::Scissor || state.redrawScissorUsed;
+    if(scissor)
+        GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
+    state.cacheScratchFramebuffer
+        .clearColor(0, Color4{0.0f})
+        .bind();
+    if(scissor)
+        GL::Renderer::enable(GL::Renderer::Feature::ScissorTest);
+}
+
+void RendererGL::doEndCache(const UnsignedInt id) {
+    State& state = *_state;
+
+    /* Copy the cache rect from the scratch framebuffer to the cache texture.
+       The rect has the origin at the top left, GL at the bottom left. A
+       scissor, if enabled, would restrict the copy, so it's disabled for
+       it. */
+    Cache& cache = state.caches[id];
+    const bool scissor = currentDrawStates() >= RendererDrawState::Scissor || state.redrawScissorUsed;
+    if(scissor)
+        GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
+    GL::AbstractFramebuffer::blit(state.cacheScratchFramebuffer, cache.framebuffer,
+        Range2Di::fromSize({cache.rect.min().x(), framebufferSize().y() - cache.rect.max().y()}, cache.rect.size()),
+        {{}, cache.rect.size()},
+        GL::FramebufferBlit::Color, GL::FramebufferBlitFilter::Nearest);
+    if(scissor)
+        GL::Renderer::enable(GL::Renderer::Feature::ScissorTest);
+
+    if(state.scaledBound)
+        state.scaledFramebuffer.bind();
+    else
+        state.compositingFramebuffer.bind();
+}
+
+void RendererGL::doDrawCache(const UnsignedInt id) {
+    State& state = *_state;
+    CORRADE_ASSERT(id < state.caches.size() && state.caches[id].texture.id(),
+        "Ui::RendererGL::drawCache(): cache" << id << "wasn't rendered", );
+
+    /* An empty rect has nothing to draw */
+    Cache& cache = state.caches[id];
+    if(!cache.rect.size().product())
+        return;
+
+    /* The vertex positions are in framebuffer pixels with the origin at the
+       top left, same as the cache rect. The texture coordinates the shader
+       calculates for the whole framebuffer are then mapped to the texture
+       covering just the rect, which has the origin at the bottom left. */
+    const Vector2 framebufferSize{this->framebufferSize()};
+    const Vector2 min{cache.rect.min()};
+    const Vector2 max{cache.rect.max()};
+    const Vector2 size{cache.rect.size()};
+    const Vector2 vertices[]{
+        {max.x(), max.y()},
+        {max.x(), min.y()},
+        {min.x(), max.y()},
+        {min.x(), min.y()}
+    };
+    state.cacheVertexBuffer.setData(vertices, GL::BufferUsage::StreamDraw);
+    state.cacheShader
+        .setProjection(framebufferSize)
+        .setTextureTransform(framebufferSize/size, -Vector2{min.x(), framebufferSize.y() - max.y()}/size)
+        .bindTexture(cache.texture)
+        .draw(state.cacheMesh);
+    if(state.scaledBound)
+        state.scaledDirty = true;
+}
+
+void RendererGL::doDiscardCache(const UnsignedInt id) {
+    State& state = *_state;
+    if(id < state.caches.size())
+        state.caches[id] = Cache{};
+}
+
+void RendererGL::resolveScaledFramebuffer() {
+    State& state = *_state;
+    if(!state.scaledDirty)
+        return;
+
+    /* The scaled contents are premultiplied, so they're blended over the
+       compositing framebuffer the same way as caches are. A scissor, if
+       enabled, would restrict the quad, so it's disabled for it. */
+    const RendererDrawStates drawStates = currentDrawStates();
+    if(!(drawStates >= RendererDrawState::Blending))
+        GL::Renderer::enable(GL::Renderer::Feature::Blending);
+    if(drawStates >= RendererDrawState::Scissor)
+        GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
+
+    const Vector2 size{framebufferSize()};
+    const Vector2 vertices[]{
+        {size.x(), size.y()},
+        {size.x(), 0.0f},
+        {0.0f, size.y()},
+        {0.0f, 0.0f}
+    };
+    state.cacheVertexBuffer.setData(vertices, GL::BufferUsage::StreamDraw);
+    state.compositingFramebuffer.bind();
+    state.cacheShader
+        .setProjection(size)
+        .setTextureTransform(Vector2{1.0f}, {})
+        .bindTexture(state.scaledTexture)
+        .draw(state.cacheMesh);
+
+    /* Clear the scaled contents so what's drawn to it next doesn't get
+       blended again. The clear may bind the scaled framebuffer, so bind the
+       compositing one back after. */
+    state.scaledFramebuffer.clearColor(0, Color4{0.0f});
+    state.compositingFramebuffer.bind();
+    state.scaledDirty = false;
+
+    if(!(drawStates >= RendererDrawState::Blending))
+        GL::Renderer::disable(GL::Renderer::Feature::Blending);
+    if(drawStates >= RendererDrawState::Scissor)
+        GL::Renderer::enable(GL::Renderer::Feature::ScissorTest);
 }
 
 }}
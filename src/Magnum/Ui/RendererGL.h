@@ -34,6 +34,7 @@
 #include "Magnum/configure.h"
 
 #ifdef MAGNUM_TARGET_GL
+#include <initializer_list>
 #include <Magnum/GL/GL.h>
 
 #include "Magnum/Ui/AbstractRenderer.h"
@@ -84,6 +85,151 @@ framebuffer after the UI is drawn:
 
 @snippet Ui-sdl2.cpp RendererGL-compositing-framebuffer-draw
 
+@section Ui-RendererGL-retained-framebuffer Partial redraw with a retained framebuffer
+
+For a mostly static UI, constructing the renderer with
+@ref Flag::RetainedFramebuffer makes @ref AbstractUserInterface::draw() redraw
+only what changed since the last draw. The UI is drawn to a framebuffer that
+keeps its contents between frames, and the application then blits it to the
+default framebuffer every frame. The @ref AbstractUserInterface accumulates a
+rectangle covering nodes that changed their offset, size, opacity, enabled
+state or visibility, and nodes with data in layers that had
+@ref LayerState::NeedsDataUpdate,
+@relativeref{LayerState,NeedsCommonDataUpdate} or
+@relativeref{LayerState,NeedsSharedDataUpdate} set. The renderer then clears
+just that rectangle and restricts drawing to it with a scissor. If nothing
+changed, nothing is drawn at all.
+
+The whole UI is redrawn if the UI or framebuffer size changes, a layer is
+created or removed, data get attached to or detached from a node, or the
+visible node order changes. The whole UI is also redrawn if a visible layer
+advertises @ref LayerFeature::DrawUsesScissor or
+@relativeref{LayerFeature,Composite}, as the layer scissor would override
+the redraw scissor and compositing depends on the contents underneath. For
+@ref BaseLayerGL and @ref TextLayerGL the scissor can be avoided with
+@ref BaseLayerSharedFlag::ShaderClipping and
+@ref TextLayerSharedFlag::ShaderClipping.
+
+The changed area is derived from node rectangles, so layer contents drawn
+outside of the node they're attached to, such as text overflowing its node,
+lines with points outside of the node or an outline extending past node edges,
+may not get fully cleared when they change. Such data should have a node
+covering their whole contents.
+
+@section Ui-RendererGL-render-target Drawing into a texture
+
+To display the UI on a panel in a 3D scene, the UI can be drawn into an
+application-provided texture with @ref setRenderTargetTexture() and the
+texture then used as any other texture in the scene. Combined with
+@ref Flag::RetainedFramebuffer and skipping @ref AbstractUserInterface::draw()
+if @ref AbstractUserInterface::needsDraw() is @cpp false @ce, a panel that
+doesn't change doesn't cost anything to draw, and when it does, only the
+changed parts get redrawn. Each panel needs its own @ref AbstractUserInterface
+and renderer instance:
+
+@snippet Ui-gl.cpp RendererGL-render-target
+
+Pointer events for the panel are usually derived from a ray cast against the
+panel in the scene, which gives texture coordinates of the hit point.
+@ref globalPositionFromTextureCoordinates() then converts them to a position
+that can be passed to @ref AbstractUserInterface::pointerPressEvent() and
+other pointer event functions:
+
+@snippet Ui-gl.cpp RendererGL-render-target-events
+
+@section Ui-RendererGL-layer-profiling Per-layer GPU profiling
+
+With @ref Flag::LayerProfiling enabled, every @ref AbstractLayer::draw() and
+@relativeref{AbstractLayer,composite()} call is surrounded by a pair of
+@ref GL::TimeQuery timestamps and, on desktop GL, a @ref GL::PrimitiveQuery.
+The results are summed for each layer and made available through
+@ref layerGpuDuration(), @ref layerPrimitiveCount() and @ref layerDrawCount():
+
+@snippet Ui-gl.cpp RendererGL-layer-profiling
+
+To avoid stalling the pipeline when retrieving the results, the queries are
+kept in a ring of three frames and the results of a frame are retrieved only
+once the GPU finished them, which is usually one or two frames later. If the
+GPU is more than three frames behind, the results of the oldest frame are
+discarded. Timestamps are used instead of
+@ref GL::TimeQuery::Target::TimeElapsed so the profiling can be combined
+with other time elapsed measurements such as @ref DebugTools::FrameProfilerGL.
+
+@section Ui-RendererGL-depth-buffer Reducing overdraw with a depth buffer
+
+With many overlapping top-level nodes, such as stacked windows, most of the
+content underneath ends up being drawn only to be immediately covered. With
+@ref Flag::DepthBuffer, a @ref GL::RenderbufferFormat::DepthComponent24
+renderbuffer is attached to the @ref compositingFramebuffer() and each
+top-level node draw gets a distinct depth through @ref GL::Renderer::enable()
+of @ref GL::Renderer::Feature::DepthTest and @m_class{m-doc-external}
+[glDepthRange()](https://registry.khronos.org/OpenGL-Refpages/gl4/html/glDepthRange.xhtml),
+so layer shaders don't need to be aware of it. Layers advertising
+@ref LayerFeature::DrawOpaque, such as @ref BaseLayerGL with
+@ref BaseLayerSharedFlag::OpaqueDepthPrepass, first draw depth of their
+opaque parts front-to-back, and all layers then draw as usual with fragments
+hidden behind opaque content being rejected by the depth test. The depth
+buffer is cleared by the renderer itself, the application is still
+responsible for clearing the color contents unless
+@ref Flag::RetainedFramebuffer is used as well.
+
+@snippet Ui-gl.cpp RendererGL-depth-buffer
+
+@section Ui-RendererGL-draw-cache Caching static hierarchies
+
+With @ref Flag::DrawCache, top-level node hierarchies marked with
+@ref NodeFlag::Cached are rendered into a texture of
+@ref compositingTextureFormat() and then drawn as a single textured quad,
+skipping all layer draws of the hierarchy until any node in it changes its
+offset, size, opacity, enabled state or visibility, or data of any layer drawn
+in it change. The hierarchies are rendered into a single scratch texture of
+the whole @ref framebufferSize(), so layers can keep using framebuffer
+coordinates in their draws, and then just the area covering the hierarchy is
+copied to a cache texture of that area size. The memory used is thus one
+framebuffer-sized texture plus the area of all cached hierarchies. All caches
+are discarded when the framebuffer is set up again.
+
+The cache contents are premultiplied and are blended over what's underneath,
+which makes it mainly useful for complex hierarchies that change rarely, such
+as a toolbar or a side panel with a lot of text.
+
+@snippet Ui-gl.cpp RendererGL-draw-cache
+
+@section Ui-RendererGL-dynamic-resolution Dynamic resolution scaling
+
+With @ref Flag::DynamicResolution, the renderer uses the GPU times gathered by
+@ref Flag::LayerProfiling to keep the UI within a time budget. If the sum of
+all @ref layerGpuDuration() values exceeds @ref dynamicResolutionBudget(), the
+@ref resolutionScale() is lowered in steps of @cpp 0.125f @ce down to
+@ref minResolutionScale(), and if it gets below a half of the budget, it's
+raised again back up to @cpp 1.0f @ce. With a scale below @cpp 1.0f @ce,
+layer draws go into a transparent texture of a correspondingly smaller size,
+which is then upscaled and blended over the @ref compositingFramebuffer()
+before each compositing operation and at the end of the draw. Layers passed to
+@ref setNativeResolutionLayers(), such as the text layer, and all draws that
+use the scissor are drawn directly to the compositing framebuffer at the
+native resolution, keeping text sharp while backgrounds and blur-heavy
+compositing get cheaper:
+
+@snippet Ui-gl.cpp RendererGL-dynamic-resolution
+
+As the scale adapts to measurements that arrive a few frames late, it's
+changed at most once per three frames. The scale isn't raised back if the UI
+isn't drawn at all, so an application that redraws only on UI changes should
+call @ref setResolutionScale() with @cpp 1.0f @ce and redraw once the UI gets
+idle, to not leave the last frame at a reduced resolution. Every switch
+between a scaled and a native-resolution draw blends the scaled contents over
+the framebuffer, so it's most efficient with
+@ref AbstractUserInterface::setDrawMerging() enabled. The flag can't be
+combined with @ref Flag::RetainedFramebuffer or @ref Flag::DepthBuffer.
+
+@requires_gl33 Extension @gl_extension{ARB,timer_query} for
+    @ref Flag::LayerProfiling
+@requires_es_extension Extension @gl_extension{EXT,disjoint_timer_query} for
+    @ref Flag::LayerProfiling
+@requires_webgl_extension Extension @webgl_extension{EXT,disjoint_timer_query_webgl2}
+    for @ref Flag::LayerProfiling
+
 @note This class is available only if Magnum is compiled with
     @ref MAGNUM_TARGET_GL enabled (done by default). See @ref building-features
     for more information.
@@ -101,9 +247,10 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
              * contents and a source for compositing operations implemented by
              * various layers.
              *
-             * The framebuffer, with a single @ref GL::TextureFormat::RGBA8
-             * color attachment, is created on the first call to
-             * @ref setupFramebuffers(), which is called as a
+             * The framebuffer, with a single color attachment in
+             * @ref compositingTextureFormat(), which is
+             * @ref GL::TextureFormat::RGBA8 by default, is created on the
+             * first call to @ref setupFramebuffers(), which is called as a
              * consequence of @ref AbstractUserInterface::setSize() or a
              * user interface constructor taking a size parameter, and is
              * recreated on all following @ref AbstractUserInterface::setSize()
@@ -116,6 +263,64 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
              * drawn.
              */
             CompositingFramebuffer = 1 << 0,
+
+            /**
+             * Keep the UI contents in a framebuffer across
+             * @ref AbstractUserInterface::draw() calls and redraw only the
+             * parts that changed. Advertises
+             * @ref RendererFeature::PartialRedraw.
+             *
+             * The framebuffer is the same as with
+             * @ref Flag::CompositingFramebuffer, accessible through
+             * @ref compositingFramebuffer() and @ref compositingTexture(),
+             * and the flags can be combined. Compared to
+             * @ref Flag::CompositingFramebuffer alone, the renderer clears
+             * the area to redraw on its own with the currently set
+             * @ref GL::Renderer::setClearColor(), so the application
+             * shouldn't clear it or draw any other content to it. It's only
+             * responsible for blitting it or drawing it blended to the main /
+             * default application framebuffer after the UI is drawn. See
+             * @ref Ui-RendererGL-retained-framebuffer for more information.
+             */
+            RetainedFramebuffer = 1 << 1,
+
+            /**
+             * Measure GPU time spent in each layer. Advertises
+             * @ref RendererFeature::LayerProfiling. See
+             * @ref Ui-RendererGL-layer-profiling for more information.
+             */
+            LayerProfiling = 1 << 2,
+
+            /**
+             * Attach a depth buffer to the compositing framebuffer and use it
+             * to reject occluded content. Advertises
+             * @ref RendererFeature::DepthBuffer. Expects that
+             * @ref Flag::CompositingFramebuffer or
+             * @relativeref{Flag,RetainedFramebuffer} is enabled as well. See
+             * @ref Ui-RendererGL-depth-buffer for more information.
+             */
+            DepthBuffer = 1 << 3,
+
+            /**
+             * Render top-level node hierarchies marked with
+             * @ref NodeFlag::Cached into a texture and draw just the texture
+             * until their contents change. Advertises
+             * @ref RendererFeature::DrawCache. Expects that
+             * @ref Flag::CompositingFramebuffer or
+             * @relativeref{Flag,RetainedFramebuffer} is enabled as well. See
+             * @ref Ui-RendererGL-draw-cache for more information.
+             */
+            DrawCache = 1 << 4,
+
+            /**
+             * Render the UI at a reduced resolution if its GPU time exceeds
+             * a budget. Expects that @ref Flag::CompositingFramebuffer and
+             * @relativeref{Flag,LayerProfiling} are enabled as well and that
+             * neither @ref Flag::RetainedFramebuffer nor
+             * @relativeref{Flag,DepthBuffer} is. See
+             * @ref Ui-RendererGL-dynamic-resolution for more information.
+             */
+            DynamicResolution = 1 << 5,
         };
 
         /**
@@ -125,9 +330,32 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
          */
         typedef Containers::EnumSet<Flag> Flags;
 
-        /** @brief Constructor */
+        /**
+         * @brief Constructor
+         *
+         * Equivalent to calling @ref RendererGL(Flags, GL::TextureFormat)
+         * with @ref GL::TextureFormat::RGBA8.
+         */
         explicit RendererGL(Flags flags = {});
 
+        /**
+         * @brief Construct with a custom compositing texture format
+         *
+         * The @p compositingTextureFormat is used for the
+         * @ref compositingTexture() if @ref Flag::CompositingFramebuffer or
+         * @ref Flag::RetainedFramebuffer is enabled, and is ignored
+         * otherwise. For example, @ref GL::TextureFormat::RGB10A2 gives more
+         * color precision in the same memory as
+         * @ref GL::TextureFormat::RGBA8, while
+         * @ref GL::TextureFormat::R11FG11FB10F can hold HDR content
+         * underneath the UI at half the bandwidth of
+         * @ref GL::TextureFormat::RGBA16F. Formats without an alpha channel
+         * can be used, as the UI is drawn with blending that doesn't use the
+         * destination alpha. The format has to be color-renderable on given
+         * platform.
+         */
+        explicit RendererGL(Flags flags, GL::TextureFormat compositingTextureFormat);
+
         /** @brief Copying is not allowed */
         RendererGL(const RendererGL&) = delete;
 
@@ -150,6 +378,13 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
         /** @brief Renderer flags */
         Flags flags() const;
 
+        /**
+         * @brief Compositing texture format
+         *
+         * @see @ref RendererGL(Flags, GL::TextureFormat)
+         */
+        GL::TextureFormat compositingTextureFormat() const;
+
         /**
          * @brief Compositing framebuffer instance
          *
@@ -177,9 +412,11 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
          * were set up with @ref setupFramebuffers(), which is called as a
          * consequence of @ref AbstractUserInterface::setSize() or a
          * user interface constructor taking a size parameter. The texture is
-         * implicitly set to a single @ref GL::TextureFormat::RGBA8 level of
-         * @ref framebufferSize(), with both minification and magnification
-         * filter being @ref GL::SamplerFilter::Linear and with
+         * implicitly set to a single level of @ref framebufferSize() in
+         * @ref compositingTextureFormat(), which is
+         * @ref GL::TextureFormat::RGBA8 by default, with both minification
+         * and magnification filter being @ref GL::SamplerFilter::Linear and
+         * with
          * @ref GL::SamplerWrapping::ClampToEdge.
          *
          * The texture is meant to be accessed inside an
@@ -192,10 +429,250 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
         GL::Texture2D& compositingTexture();
         const GL::Texture2D& compositingTexture() const; /**< @overload */
 
+        /**
+         * @brief Depth renderbuffer instance
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::DepthBuffer and only after framebuffer sizes were set up
+         * with @ref setupFramebuffers(). The renderbuffer is implicitly set to
+         * @ref framebufferSize() in
+         * @ref GL::RenderbufferFormat::DepthComponent24 and attached to the
+         * @ref compositingFramebuffer().
+         * @see @ref flags()
+         */
+        GL::Renderbuffer& depthRenderbuffer();
+        const GL::Renderbuffer& depthRenderbuffer() const; /**< @overload */
+
+        /**
+         * @brief Whether a user-provided render target texture is used
+         * @m_since_latest
+         *
+         * @see @ref setRenderTargetTexture()
+         */
+        bool hasRenderTargetTexture() const;
+
+        /**
+         * @brief Draw into a user-provided texture
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::CompositingFramebuffer or
+         * @ref Flag::RetainedFramebuffer. Makes the
+         * @ref compositingFramebuffer() draw into @p texture instead of an
+         * internally created texture, with @ref compositingTexture() then
+         * referencing @p texture. The texture is expected to be created,
+         * have storage of @ref framebufferSize() allocated and be
+         * color-renderable, its format doesn't need to match
+         * @ref compositingTextureFormat(). The renderer doesn't take over
+         * the ownership, the texture is expected to stay alive for as long
+         * as it's used by the renderer.
+         *
+         * If @ref setupFramebuffers() was called already, the framebuffer is
+         * recreated with @p texture attached right away. With
+         * @ref Flag::RetainedFramebuffer, contents of the previous texture
+         * are copied to @p texture so partial redraws can continue from
+         * there. As texture storage can't be resized, to change the size, set
+         * a texture of the new size and call
+         * @ref AbstractUserInterface::setSize() after, which then redraws
+         * everything. See @ref Ui-RendererGL-render-target for more
+         * information.
+         */
+        RendererGL& setRenderTargetTexture(GL::Texture2D& texture);
+
+        /**
+         * @brief Pointer position from render target texture coordinates
+         * @m_since_latest
+         *
+         * Converts @p textureCoordinates, with origin at the bottom left
+         * corner of @ref compositingTexture() as is common for texture
+         * coordinates, to a position with origin at the top left corner in
+         * @ref AbstractUserInterface::windowSize() units of @p ui, suitable
+         * for passing to @ref AbstractUserInterface::pointerPressEvent() and
+         * other pointer event functions. Positions outside of the
+         * @f$ [0, 1] @f$ range are converted as well, resulting in positions
+         * outside of the user interface. See @ref Ui-RendererGL-render-target
+         * for more information.
+         */
+        static Vector2 globalPositionFromTextureCoordinates(const AbstractUserInterface& ui, const Vector2& textureCoordinates);
+
+        /**
+         * @brief Compositing framebuffer content generation
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::CompositingFramebuffer. Incremented every time the
+         * compositing framebuffer is recreated in @ref setupFramebuffers(),
+         * every time a compositing operation happens after some layers were
+         * drawn, i.e. on every transition from @ref RendererTargetState::Draw
+         * to @ref RendererTargetState::Composite, and on every
+         * @ref incrementCompositingContentGeneration() call. If the value is
+         * the same as in a previous compositing operation, it's assumed the
+         * framebuffer contents didn't change since. Used by
+         * @ref BaseLayerSharedFlag::BackgroundBlurCache to skip blurring
+         * contents that were already blurred before. Initial value is
+         * @cpp 0 @ce.
+         * @see @ref flags()
+         */
+        UnsignedInt compositingContentGeneration() const;
+
+        /**
+         * @brief Increment the compositing framebuffer content generation
+         * @return Reference to self (for method chaining)
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::CompositingFramebuffer. The application is expected to
+         * call this function every time it draws content underneath the UI
+         * that differs from what was drawn in the previous frame. If the
+         * content is the same, such as a static map or image underneath the
+         * UI, not calling this function allows layers to reuse results of
+         * previous compositing operations.
+         * @see @ref compositingContentGeneration(), @ref flags()
+         */
+        RendererGL& incrementCompositingContentGeneration();
+
+        /**
+         * @brief Layer GPU duration
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::LayerProfiling. Returns time in nanoseconds spent by the
+         * GPU in all @ref AbstractLayer::draw() and
+         * @relativeref{AbstractLayer,composite()} calls of @p layer in the
+         * most recent frame for which the results are available, or
+         * @cpp 0 @ce if the layer wasn't drawn in that frame or no results
+         * are available yet. Frames in which no layer was drawn don't
+         * replace the previous results. See
+         * @ref Ui-RendererGL-layer-profiling for more information.
+         * @see @ref flags()
+         */
+        UnsignedLong layerGpuDuration(LayerHandle layer) const;
+
+        #if !defined(MAGNUM_TARGET_GLES) || defined(DOXYGEN_GENERATING_OUTPUT)
+        /**
+         * @brief Layer primitive count
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::LayerProfiling. Returns count of primitives generated by
+         * all @ref AbstractLayer::draw() and
+         * @relativeref{AbstractLayer,composite()} calls of @p layer in the
+         * same frame as @ref layerGpuDuration(), or @cpp 0 @ce if the layer
+         * wasn't drawn in that frame or no results are available yet.
+         * @requires_gl Primitive queries are not available in OpenGL ES or
+         *      WebGL.
+         * @see @ref flags()
+         */
+        UnsignedLong layerPrimitiveCount(LayerHandle layer) const;
+        #endif
+
+        /**
+         * @brief Layer draw count
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::LayerProfiling. Returns how many times
+         * @ref AbstractLayer::draw() and
+         * @relativeref{AbstractLayer,composite()} was called for @p layer
+         * in the same frame as @ref layerGpuDuration(), or @cpp 0 @ce if the
+         * layer wasn't drawn in that frame or no results are available yet.
+         * This is the count of draw submissions from the user interface, not
+         * of the actual GL draw calls done by the layer.
+         * @see @ref flags()
+         */
+        UnsignedInt layerDrawCount(LayerHandle layer) const;
+
+        /**
+         * @brief Dynamic resolution GPU time budget
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::DynamicResolution.
+         * @see @ref flags()
+         */
+        UnsignedLong dynamicResolutionBudget() const;
+
+        /**
+         * @brief Set dynamic resolution GPU time budget
+         * @return Reference to self (for method chaining)
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::DynamicResolution. The @p budget is in nanoseconds and is
+         * compared against the sum of @ref layerGpuDuration() for all layers.
+         * Default is @cpp 8000000 @ce, i.e. half of a frame at 60 FPS. See
+         * @ref Ui-RendererGL-dynamic-resolution for more information.
+         * @see @ref flags()
+         */
+        RendererGL& setDynamicResolutionBudget(UnsignedLong budget);
+
+        /**
+         * @brief Minimal resolution scale
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::DynamicResolution.
+         * @see @ref flags()
+         */
+        Float minResolutionScale() const;
+
+        /**
+         * @brief Set minimal resolution scale
+         * @return Reference to self (for method chaining)
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::DynamicResolution. Expects that @p scale is greater than
+         * @cpp 0.0f @ce and not larger than @cpp 1.0f @ce, the current
+         * @ref resolutionScale() is clamped to it. Default is @cpp 0.5f @ce.
+         * @see @ref flags()
+         */
+        RendererGL& setMinResolutionScale(Float scale);
+
+        /**
+         * @brief Current resolution scale
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::DynamicResolution. Initial value is @cpp 1.0f @ce.
+         * @see @ref flags()
+         */
+        Float resolutionScale() const;
+
+        /**
+         * @brief Set current resolution scale
+         * @return Reference to self (for method chaining)
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::DynamicResolution. Expects that @p scale is between
+         * @ref minResolutionScale() and @cpp 1.0f @ce. Takes effect in the
+         * next @ref AbstractUserInterface::draw() and overrides the
+         * automatically chosen scale until the next adjustment.
+         * @see @ref flags()
+         */
+        RendererGL& setResolutionScale(Float scale);
+
+        /**
+         * @brief Set layers drawn at native resolution
+         * @return Reference to self (for method chaining)
+         *
+         * Available only if the renderer was constructed with
+         * @ref Flag::DynamicResolution. Draws of @p layers always go directly
+         * to the @ref compositingFramebuffer(), regardless of
+         * @ref resolutionScale(). The list is copied, replacing the previous
+         * one. Default is an empty list.
+         * @see @ref flags()
+         */
+        RendererGL& setNativeResolutionLayers(Containers::ArrayView<const LayerHandle> layers);
+
+        /** @overload */
+        RendererGL& setNativeResolutionLayers(std::initializer_list<LayerHandle> layers);
+
     private:
         MAGNUM_UI_LOCAL RendererFeatures doFeatures() const override;
         MAGNUM_UI_LOCAL void doSetupFramebuffers(const Vector2i& size) override;
         MAGNUM_UI_LOCAL void doTransition(RendererTargetState targetStateFrom, RendererTargetState targetStateTo, RendererDrawStates drawStatesFrom, RendererDrawStates drawStatesTo) override;
+        MAGNUM_UI_LOCAL void doBeginLayerProfile(LayerHandle layer) override;
+        MAGNUM_UI_LOCAL void doEndLayerProfile(LayerHandle layer) override;
+        MAGNUM_UI_LOCAL void doSetDrawDepth(Float depth) override;
+        MAGNUM_UI_LOCAL void doBeginCache(UnsignedInt id, const Range2Di& rect) override;
+        MAGNUM_UI_LOCAL void doEndCache(UnsignedInt id) override;
+        MAGNUM_UI_LOCAL void doDrawCache(UnsignedInt id) override;
+        MAGNUM_UI_LOCAL void doDiscardCache(UnsignedInt id) override;
+
+        MAGNUM_UI_LOCAL void setupCompositingFramebuffer(const Vector2i& size);
+        MAGNUM_UI_LOCAL void resolveScaledFramebuffer();
 
         struct State;
         Containers::Pointer<State> _state;
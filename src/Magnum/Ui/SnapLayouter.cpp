@@ -26,7 +26,6 @@
 
 #include "SnapLayouter.h"
 
-#include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/EnumSet.hpp>
@@ -35,7 +34,8 @@
 
 #include "Magnum/Ui/Anchor.h"
 #include "Magnum/Ui/Handle.h"
-#include "Magnum/Ui/Implementation/orderNodesBreadthFirstInto.h"
+#include "Magnum/Ui/Implementation/breadthFirstNodeOrder.h"
+#include "Magnum/Ui/Implementation/frameArena.h"
 #include "Magnum/Ui/Implementation/snapLayouter.h"
 #include "Magnum/Ui/UserInterface.h"
 
@@ -117,6 +117,13 @@ struct SnapLayouter::State {
     Vector2 margin;
     Containers::Array<Layout> layouts;
     Vector2 uiSize;
+
+    /* Temporary storage for doUpdate(), kept across calls to avoid
+       allocating on every update */
+    Implementation::FrameArena updateStorage;
+    /* Breadth-first node order, kept across doUpdate() calls and
+       recalculated only if the node hierarchy changes */
+    Implementation::BreadthFirstNodeOrder nodeOrder;
 };
 
 SnapLayouter::SnapLayouter(const LayouterHandle handle): AbstractLayouter{handle}, _state{InPlaceInit} {}
@@ -213,41 +220,25 @@ void SnapLayouter::doSetSize(const Vector2& size) {
 }
 
 void SnapLayouter::doUpdate(const Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) {
-    const State& state = *_state;
+    State& state = *_state;
 
     /* Order layouts breadth first in dependency order to ensure the parent
        node offset / size is known when calculating child node layout */
-    /** @todo The childrenOffsets and children have a non-overlapping lifetime
-        with layoutOffsets and layouts, but handling that manually is too messy
-        -- clean up once a bump allocator exists */
     /** @todo If other layouters start needing this, it may be beneficial to
         do this in AbstractUserInterface already and pass an ordered list of
-        layout IDs to update. If not, it might be beneficial to split this
-        function into update() + layout(), where the former gets the *full*
-        mask of layouts and can perform this ordering just once, not for every
-        call */
-    Containers::ArrayView<UnsignedInt> childrenOffsets;
-    Containers::ArrayView<UnsignedInt> children;
-    Containers::ArrayView<Int> nodeIdsBreadthFirst;
-    Containers::ArrayView<UnsignedInt> layoutOffsets;
-    Containers::ArrayView<UnsignedInt> layouts;
-    Containers::ArrayView<UnsignedInt> layoutIds;
-    Containers::ArrayTuple storage{
-        /* +1 for the last offset, +1 for root nodes */
-        {ValueInit, nodeParents.size() + 2, childrenOffsets},
-        {NoInit, nodeParents.size(), children},
-        /* +1 for the first element which is -1 indicating a root */
-        {NoInit, nodeParents.size() + 1, nodeIdsBreadthFirst},
-        /* +1 for the last offset, +1 for layouts that target the UI */
-        {ValueInit, nodeParents.size() + 2, layoutOffsets},
-        {NoInit, layoutIdsToUpdate.size(), layouts},
-        {NoInit, layoutIdsToUpdate.size(), layoutIds},
-    };
-    /* First order the nodes themselves ... */
-    Implementation::orderNodesBreadthFirstInto(
-        nodeParents,
-        childrenOffsets, children, nodeIdsBreadthFirst);
-    /* Then use the ordered nodes to order the layouts */
+        layout IDs to update */
+    Implementation::FrameArena& storage = state.updateStorage;
+    storage.reset();
+
+    /* First order the nodes themselves, which is done only if the node
+       hierarchy changed since the last time ... */
+    const Containers::ArrayView<const Int> nodeIdsBreadthFirst = state.nodeOrder.update(nodeParents, storage);
+
+    /* +1 for the last offset, +1 for layouts that target the UI */
+    const Containers::ArrayView<UnsignedInt> layoutOffsets = storage.allocate<UnsignedInt>(ValueInit, nodeParents.size() + 2);
+    const Containers::ArrayView<UnsignedInt> layouts = storage.allocate<UnsignedInt>(NoInit, layoutIdsToUpdate.size());
+    const Containers::ArrayView<UnsignedInt> layoutIds = storage.allocate<UnsignedInt>(NoInit, layoutIdsToUpdate.size());
+    /* ... then use the ordered nodes to order the layouts */
     const std::size_t count = Implementation::orderLayoutsBreadthFirstInto(
         layoutIdsToUpdate,
         stridedArrayView(state.layouts).slice(&Layout::target),
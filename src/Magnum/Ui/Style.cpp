@@ -699,13 +699,18 @@ bool McssDarkStyle::doApply(UserInterface& ui, const StyleFeatures features, Plu
             Error{} << "Ui::McssDarkStyle::apply(): cannot open a font";
             return {};
         }
+        /* If the text layer fills the glyph cache on demand, skip the
+           upfront rasterization of the whole character set, which is the
+           most expensive part of applying the style. Only glyphs that are
+           actually used then get rasterized. */
         /** @todo fail if this fails, once the function doesn't return void */
-        /** @todo configurable way to fill the cache, or switch to on-demand
-            by default once AbstractFont can fill the cache with glyph IDs */
-        font->fillGlyphCache(glyphCache,
-            "abcdefghijklmnopqrstuvwxyz"
-            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-            "0123456789 _.,-+=*:;?!@$&#/\\|`\"'<>()[]{}%…");
+        /** @todo switch to on-demand by default once it's the default in
+            AbstractStyle as well */
+        if(!(shared.flags() & (TextLayerSharedFlag::GlyphCacheFillOnDemand|TextLayerSharedFlag::GlyphCacheFillDeferred|TextLayerSharedFlag::GlyphCacheGrowOnDemand)))
+            font->fillGlyphCache(glyphCache,
+                "abcdefghijklmnopqrstuvwxyz"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                "0123456789 _.,-+=*:;?!@$&#/\\|`\"'<>()[]{}%…");
 
         /* Main font */
         const Ui::FontHandle mainFont = shared.addFont(Utility::move(font), 16.0f);
@@ -839,4 +844,24 @@ bool McssDarkStyle::doApply(UserInterface& ui, const StyleFeatures features, Plu
     return true;
 }
 
+bool McssDarkStyle::doApplyUniforms(UserInterface& ui, const StyleFeatures features) const {
+    /* Only the uniform data from doApply() above, the style to uniform
+       mapping, fonts and everything else stay the same */
+    if(features >= StyleFeature::BaseLayer)
+        ui.baseLayer().shared().setStyleUniforms(
+            BaseCommonStyleUniformMcssDark,
+            BaseStyleUniformsMcssDark);
+
+    if(features >= StyleFeature::TextLayer)
+        ui.textLayer().shared()
+            .setStyleUniforms(
+                TextCommonStyleUniformMcssDark,
+                TextStyleUniformsMcssDark)
+            .setEditingStyleUniforms(
+                TextCommonEditingStyleUniformMcssDark,
+                TextEditingStyleUniformsMcssDark);
+
+    return true;
+}
+
 }}
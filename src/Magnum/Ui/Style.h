@@ -87,6 +87,7 @@ class MAGNUM_UI_EXPORT McssDarkStyle: public AbstractStyle {
         MAGNUM_UI_LOCAL UnsignedInt doTextLayerEditingStyleCount() const override;
         MAGNUM_UI_LOCAL Vector3i doTextLayerGlyphCacheSize(StyleFeatures features) const override;
         MAGNUM_UI_LOCAL bool doApply(UserInterface& ui, StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>* importerManager, PluginManager::Manager<Text::AbstractFont>* fontManager) const override;
+        MAGNUM_UI_LOCAL bool doApplyUniforms(UserInterface& ui, StyleFeatures features) const override;
 };
 
 }}
@@ -82,6 +82,11 @@ struct AbstractAnimatorTest: TestSuite::Tester {
     void genericSetLayerInvalid();
     void genericSetLayerInvalidFeatures();
 
+    void reserve();
+    void reserveInvalid();
+    void fixedCapacity();
+    void fixedCapacityInvalid();
+
     void createRemove();
     void createRemoveHandleRecycle();
     void createRemoveHandleDisable();
@@ -128,6 +133,9 @@ struct AbstractAnimatorTest: TestSuite::Tester {
 
     void update();
     void updateEmpty();
+    void updateStoppedKept();
+    void updateNextAdvanceTime();
+    void updateNextAdvanceTimeRemove();
     void updateInvalid();
 
     void advanceGeneric();
@@ -352,7 +360,12 @@ AbstractAnimatorTest::AbstractAnimatorTest() {
 
               &AbstractAnimatorTest::genericSetLayer,
               &AbstractAnimatorTest::genericSetLayerInvalid,
-              &AbstractAnimatorTest::genericSetLayerInvalidFeatures});
+              &AbstractAnimatorTest::genericSetLayerInvalidFeatures,
+
+              &AbstractAnimatorTest::reserve,
+              &AbstractAnimatorTest::reserveInvalid,
+              &AbstractAnimatorTest::fixedCapacity,
+              &AbstractAnimatorTest::fixedCapacityInvalid});
 
     addInstancedTests({&AbstractAnimatorTest::createRemove,
                        &AbstractAnimatorTest::createRemoveHandleRecycle},
@@ -409,6 +422,9 @@ AbstractAnimatorTest::AbstractAnimatorTest() {
 
     addTests({&AbstractAnimatorTest::update,
               &AbstractAnimatorTest::updateEmpty,
+              &AbstractAnimatorTest::updateStoppedKept,
+              &AbstractAnimatorTest::updateNextAdvanceTime,
+              &AbstractAnimatorTest::updateNextAdvanceTimeRemove,
               &AbstractAnimatorTest::updateInvalid,
 
               &AbstractAnimatorTest::advanceGeneric,
@@ -817,6 +833,109 @@ void AbstractAnimatorTest::genericSetLayerInvalidFeatures() {
     CORRADE_COMPARE(out, "Ui::AbstractGenericAnimator::setLayer(): feature not supported\n");
 }
 
+void AbstractAnimatorTest::reserve() {
+    struct Animator: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+
+        AnimatorFeatures doFeatures() const override {
+            return AnimatorFeature::NodeAttachment;
+        }
+        void doReserve(std::size_t capacity) override {
+            reservedCapacity = capacity;
+        }
+
+        std::size_t reservedCapacity = 0;
+    } animator{animatorHandle(0xab, 0x12)};
+
+    animator.reserve(50);
+    CORRADE_COMPARE(animator.reservedCapacity, 50);
+
+    /* The capacity doesn't change, only the reserved memory */
+    CORRADE_COMPARE(animator.capacity(), 0);
+    const std::size_t reserved = animator.memoryUsage().cpuReserved;
+    CORRADE_VERIFY(reserved);
+
+    /* Creating animations up to the reserved capacity doesn't reallocate */
+    for(std::size_t i = 0; i != 50; ++i)
+        animator.create(0_nsec, 10_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animator.capacity(), 50);
+    CORRADE_COMPARE(animator.memoryUsage().cpuReserved, reserved);
+}
+
+void AbstractAnimatorTest::reserveInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0xab, 0x12)};
+
+    Containers::String out;
+    Error redirectError{&out};
+    animator.reserve(1048577);
+    CORRADE_COMPARE(out, "Ui::AbstractAnimator::reserve(): can only have at most 1048576 animations but got 1048577\n");
+}
+
+void AbstractAnimatorTest::fixedCapacity() {
+    struct Animator: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+        using AbstractAnimator::remove;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0xab, 0x12)};
+    CORRADE_COMPARE(animator.fixedCapacity(), 0);
+    CORRADE_VERIFY(!animator.isFull());
+
+    animator.setFixedCapacity(2);
+    CORRADE_COMPARE(animator.fixedCapacity(), 2);
+    CORRADE_COMPARE(animator.capacity(), 0);
+    const std::size_t reserved = animator.memoryUsage().cpuReserved;
+
+    AnimationHandle first = animator.create(0_nsec, 10_nsec);
+    CORRADE_VERIFY(!animator.isFull());
+    animator.create(0_nsec, 10_nsec);
+    CORRADE_VERIFY(animator.isFull());
+    CORRADE_COMPARE(animator.capacity(), 2);
+    CORRADE_COMPARE(animator.memoryUsage().cpuReserved, reserved);
+
+    /* Removing an animation makes a slot free again */
+    animator.remove(first);
+    CORRADE_VERIFY(!animator.isFull());
+
+    animator.setFixedCapacity(0);
+    CORRADE_COMPARE(animator.fixedCapacity(), 0);
+    CORRADE_VERIFY(!animator.isFull());
+}
+
+void AbstractAnimatorTest::fixedCapacityInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0xab, 0x12)};
+
+    animator.create(0_nsec, 10_nsec);
+    animator.create(0_nsec, 10_nsec);
+
+    Containers::String out;
+    Error redirectError{&out};
+    animator.setFixedCapacity(1048577);
+    animator.setFixedCapacity(1);
+    animator.setFixedCapacity(2);
+    animator.create(0_nsec, 10_nsec);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractAnimator::setFixedCapacity(): can only have at most 1048576 animations but got 1048577\n"
+        "Ui::AbstractAnimator::setFixedCapacity(): capacity 1 is less than current capacity 2\n"
+        "Ui::AbstractAnimator::create(): fixed capacity of 2 exhausted\n",
+        TestSuite::Compare::String);
+}
+
 void AbstractAnimatorTest::createRemove() {
     auto&& data = CreateRemoveData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -3349,6 +3468,200 @@ void AbstractAnimatorTest::updateEmpty() {
     CORRADE_COMPARE(animator.state(), AnimatorStates{});
 }
 
+void AbstractAnimatorTest::updateStoppedKept() {
+    /* update() goes only through animations that can be affected by it.
+       Verifies that animations that stopped and are kept get picked up again
+       once their properties change so they need to be. */
+
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+        using AbstractAnimator::remove;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0, 1)};
+
+    AnimationHandle keep = animator.create(0_nsec, 10_nsec, AnimationFlag::KeepOncePlayed);
+    AnimationHandle repeat = animator.create(0_nsec, 10_nsec, AnimationFlag::KeepOncePlayed);
+    AnimationHandle replay = animator.create(0_nsec, 10_nsec, AnimationFlag::KeepOncePlayed);
+    AnimationHandle removed = animator.create(0_nsec, 10_nsec);
+
+    /* All get stopped at 20, none removed as they're kept, except the last
+       one which gets removed explicitly */
+    {
+        Containers::BitArray active{ValueInit, 4};
+        Containers::BitArray remove{ValueInit, 4};
+        Float factors[4];
+        animator.remove(removed);
+        CORRADE_COMPARE(animator.update(20_nsec, active, factors, remove), Containers::pair(true, false));
+        CORRADE_COMPARE_AS(active, Containers::stridedArrayView({
+            true, true, true, false
+        }).sliceBit(0), TestSuite::Compare::Container);
+        CORRADE_COMPARE(animator.state(), AnimatorStates{});
+    }
+
+    /* Nothing happens in the next update */
+    {
+        Containers::BitArray active{DirectInit, 4, true};
+        Containers::BitArray remove{DirectInit, 4, true};
+        Float factors[4];
+        CORRADE_COMPARE(animator.update(30_nsec, active, factors, remove), Containers::pair(false, false));
+        CORRADE_COMPARE_AS(active, Containers::stridedArrayView({
+            false, false, false, false
+        }).sliceBit(0), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(remove, Containers::stridedArrayView({
+            false, false, false, false
+        }).sliceBit(0), TestSuite::Compare::Container);
+    }
+
+    /* Clearing the flag makes the first scheduled for removal, adding more
+       repeats makes the second playing again, playing the third makes it
+       scheduled, and recycling the removed one makes it playing */
+    animator.clearFlags(keep, AnimationFlag::KeepOncePlayed);
+    animator.setRepeatCount(repeat, 5);
+    animator.play(replay, 35_nsec);
+    AnimationHandle recycled = animator.create(25_nsec, 10_nsec);
+    CORRADE_COMPARE(animationHandleId(recycled), animationHandleId(removed));
+    {
+        Containers::BitArray active{ValueInit, 4};
+        Containers::BitArray remove{ValueInit, 4};
+        Float factors[4];
+        CORRADE_COMPARE(animator.update(32_nsec, active, factors, remove), Containers::pair(true, true));
+        CORRADE_COMPARE_AS(active, Containers::stridedArrayView({
+            false, true, false, true
+        }).sliceBit(0), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(remove, Containers::stridedArrayView({
+            true, false, false, false
+        }).sliceBit(0), TestSuite::Compare::Container);
+        CORRADE_COMPARE(factors[1], 0.2f);
+        CORRADE_COMPARE(factors[3], 0.7f);
+        CORRADE_COMPARE(animator.state(), AnimatorState::NeedsAdvance);
+    }
+}
+
+void AbstractAnimatorTest::updateNextAdvanceTime() {
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+        using AbstractAnimator::remove;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0, 1)};
+
+    /* Nothing to advance initially */
+    CORRADE_COMPARE(animator.state(), AnimatorStates{});
+    CORRADE_COMPARE(animator.nextAdvanceTime(), Nanoseconds::max());
+
+    /* Scheduled animations need an advance once the earliest of them starts */
+    AnimationHandle later = animator.create(30_nsec, 10_nsec);
+    CORRADE_COMPARE(animator.state(), AnimatorState::NeedsAdvance);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 30_nsec);
+
+    AnimationHandle earlier = animator.create(20_nsec, 10_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 20_nsec);
+
+    /* Stopped and kept animations don't affect anything */
+    animator.create(0_nsec, 5_nsec, AnimationFlag::KeepOncePlayed);
+    {
+        Containers::BitArray active{ValueInit, 3};
+        Containers::BitArray remove{ValueInit, 3};
+        Float factors[3];
+        CORRADE_COMPARE(animator.update(10_nsec, active, factors, remove), Containers::pair(true, false));
+        CORRADE_COMPARE(animator.state(), AnimatorState::NeedsAdvance);
+        CORRADE_COMPARE(animator.nextAdvanceTime(), 20_nsec);
+    }
+
+    /* A playing animation needs an advance right away */
+    {
+        Containers::BitArray active{ValueInit, 3};
+        Containers::BitArray remove{ValueInit, 3};
+        Float factors[3];
+        CORRADE_COMPARE(animator.update(25_nsec, active, factors, remove), Containers::pair(true, false));
+        CORRADE_COMPARE(animator.nextAdvanceTime(), 25_nsec);
+    }
+
+    /* Once it's paused, the earliest time is again the scheduled animation,
+       unless the paused animation gets stopped before that */
+    animator.pause(earlier, 25_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 30_nsec);
+
+    animator.stop(earlier, 28_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 28_nsec);
+
+    /* If stopped at current time, it has to be advanced right away */
+    animator.stop(earlier, 25_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 25_nsec);
+
+    /* After the stopped animation is removed it's again just the scheduled
+       one */
+    {
+        Containers::BitArray active{ValueInit, 3};
+        Containers::BitArray remove{ValueInit, 3};
+        Float factors[3];
+        CORRADE_COMPARE(animator.update(26_nsec, active, factors, remove), Containers::pair(false, true));
+        CORRADE_COMPARE_AS(remove, Containers::stridedArrayView({
+            false, true, false
+        }).sliceBit(0), TestSuite::Compare::Container);
+        animator.remove(earlier);
+        CORRADE_COMPARE(animator.nextAdvanceTime(), 30_nsec);
+    }
+
+    /* Once everything is stopped, there's nothing to advance anymore */
+    {
+        Containers::BitArray active{ValueInit, 3};
+        Containers::BitArray remove{ValueInit, 3};
+        Float factors[3];
+        CORRADE_COMPARE(animator.update(50_nsec, active, factors, remove), Containers::pair(true, true));
+        animator.remove(later);
+        CORRADE_COMPARE(animator.state(), AnimatorStates{});
+        CORRADE_COMPARE(animator.nextAdvanceTime(), Nanoseconds::max());
+    }
+}
+
+void AbstractAnimatorTest::updateNextAdvanceTimeRemove() {
+    /* The next advance time is calculated in update() and removal doesn't
+       invalidate it, so it can be earlier than needed until the next update()
+       */
+
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+        using AbstractAnimator::remove;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0, 1)};
+
+    AnimationHandle earlier = animator.create(20_nsec, 10_nsec);
+    animator.create(30_nsec, 10_nsec);
+    {
+        Containers::BitArray active{ValueInit, 2};
+        Containers::BitArray remove{ValueInit, 2};
+        Float factors[2];
+        CORRADE_COMPARE(animator.update(10_nsec, active, factors, remove), Containers::pair(false, false));
+        CORRADE_COMPARE(animator.nextAdvanceTime(), 20_nsec);
+    }
+
+    /* Removing the earlier one still reports the old time, which is
+       harmless */
+    animator.remove(earlier);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 20_nsec);
+
+    /* Next update() calculates it again */
+    {
+        Containers::BitArray active{ValueInit, 2};
+        Containers::BitArray remove{ValueInit, 2};
+        Float factors[2];
+        CORRADE_COMPARE(animator.update(15_nsec, active, factors, remove), Containers::pair(false, false));
+        CORRADE_COMPARE(animator.nextAdvanceTime(), 30_nsec);
+    }
+
+    /* Playing an animation invalidates it, and it's calculated directly */
+    AnimationHandle another = animator.create(25_nsec, 10_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 25_nsec);
+    animator.play(another, 10_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 15_nsec);
+}
+
 void AbstractAnimatorTest::updateInvalid() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -25,6 +25,7 @@
 */
 
 #include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/StridedArrayView.h>
@@ -32,6 +33,7 @@
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Magnum/Math/Time.h>
 #include <Magnum/Math/Vector2.h>
@@ -50,6 +52,8 @@ struct AbstractLayerTest: TestSuite::Tester {
     void debugFeature();
     void debugFeatures();
     void debugFeaturesSupersets();
+    void debugEvent();
+    void debugEvents();
     void debugState();
     void debugStates();
     void debugStatesSupersets();
@@ -75,6 +79,15 @@ struct AbstractLayerTest: TestSuite::Tester {
     void attach();
     void attachInvalid();
 
+    void memoryUsage();
+    void memoryUsageNotImplemented();
+    void trim();
+    void trimEmpty();
+    void reserve();
+    void reserveInvalid();
+    void fixedCapacity();
+    void fixedCapacityInvalid();
+
     void setSize();
     void setSizeZero();
     void setSizeNotSupported();
@@ -89,6 +102,7 @@ struct AbstractLayerTest: TestSuite::Tester {
 
     void cleanNodes();
     void cleanNodesEmpty();
+    void cleanNodesSparse();
     void cleanNodesNotImplemented();
 
     void cleanDataAnimators();
@@ -118,12 +132,17 @@ struct AbstractLayerTest: TestSuite::Tester {
     void updateComposite();
     void updateEmpty();
     void updateNotImplemented();
+    void updateUploadedSize();
     void updateStateFiltering();
     void updateInvalidState();
     void updateInvalidStateComposite();
     void updateInvalidSizes();
     void updateNoSizeSet();
 
+    void postUpdate();
+    void postUpdateNotSupported();
+    void postUpdateEmpty();
+
     void state();
 
     void composite();
@@ -138,6 +157,15 @@ struct AbstractLayerTest: TestSuite::Tester {
     void drawNotImplemented();
     void drawInvalidSizes();
 
+    void drawOpaque();
+    void drawOpaqueNotSupported();
+    void drawOpaqueNotImplemented();
+    void drawOpaqueInvalidSizes();
+
+    void events();
+    void eventsDefault();
+    void eventsNotSupported();
+
     void pointerEvent();
     void pointerEventNotSupported();
     void pointerEventNotImplemented();
@@ -173,6 +201,13 @@ struct AbstractLayerTest: TestSuite::Tester {
     void visibilityLostEventNotSupported();
     void visibilityLostEventNotImplemented();
     void visibilityLostEventOutOfRange();
+
+    void eventBatch();
+    void eventBatchDefault();
+    void eventBatchNotSupported();
+    void eventBatchOutOfRange();
+    void eventBatchNotPrimary();
+    void eventBatchAlreadyAccepted();
 };
 
 using namespace Containers::Literals;
@@ -216,6 +251,8 @@ AbstractLayerTest::AbstractLayerTest() {
     addTests({&AbstractLayerTest::debugFeature,
               &AbstractLayerTest::debugFeatures,
               &AbstractLayerTest::debugFeaturesSupersets,
+              &AbstractLayerTest::debugEvent,
+              &AbstractLayerTest::debugEvents,
               &AbstractLayerTest::debugState,
               &AbstractLayerTest::debugStates,
               &AbstractLayerTest::debugStatesSupersets,
@@ -245,6 +282,15 @@ AbstractLayerTest::AbstractLayerTest() {
               &AbstractLayerTest::attach,
               &AbstractLayerTest::attachInvalid,
 
+              &AbstractLayerTest::memoryUsage,
+              &AbstractLayerTest::memoryUsageNotImplemented,
+              &AbstractLayerTest::trim,
+              &AbstractLayerTest::trimEmpty,
+              &AbstractLayerTest::reserve,
+              &AbstractLayerTest::reserveInvalid,
+              &AbstractLayerTest::fixedCapacity,
+              &AbstractLayerTest::fixedCapacityInvalid,
+
               &AbstractLayerTest::setSize,
               &AbstractLayerTest::setSizeZero,
               &AbstractLayerTest::setSizeNotSupported,
@@ -259,6 +305,7 @@ AbstractLayerTest::AbstractLayerTest() {
 
               &AbstractLayerTest::cleanNodes,
               &AbstractLayerTest::cleanNodesEmpty,
+              &AbstractLayerTest::cleanNodesSparse,
               &AbstractLayerTest::cleanNodesNotImplemented,
 
               &AbstractLayerTest::cleanDataAnimators,
@@ -287,7 +334,8 @@ AbstractLayerTest::AbstractLayerTest() {
               &AbstractLayerTest::update,
               &AbstractLayerTest::updateComposite,
               &AbstractLayerTest::updateEmpty,
-              &AbstractLayerTest::updateNotImplemented});
+              &AbstractLayerTest::updateNotImplemented,
+              &AbstractLayerTest::updateUploadedSize});
 
     addInstancedTests({&AbstractLayerTest::updateStateFiltering},
         Containers::arraySize(UpdateStateFilteringData));
@@ -295,7 +343,11 @@ AbstractLayerTest::AbstractLayerTest() {
     addTests({&AbstractLayerTest::updateInvalidState,
               &AbstractLayerTest::updateInvalidStateComposite,
               &AbstractLayerTest::updateInvalidSizes,
-              &AbstractLayerTest::updateNoSizeSet});
+              &AbstractLayerTest::updateNoSizeSet,
+
+              &AbstractLayerTest::postUpdate,
+              &AbstractLayerTest::postUpdateNotSupported,
+              &AbstractLayerTest::postUpdateEmpty});
 
     addInstancedTests({&AbstractLayerTest::state},
         Containers::arraySize(StateData));
@@ -312,6 +364,15 @@ AbstractLayerTest::AbstractLayerTest() {
               &AbstractLayerTest::drawNotImplemented,
               &AbstractLayerTest::drawInvalidSizes,
 
+              &AbstractLayerTest::drawOpaque,
+              &AbstractLayerTest::drawOpaqueNotSupported,
+              &AbstractLayerTest::drawOpaqueNotImplemented,
+              &AbstractLayerTest::drawOpaqueInvalidSizes,
+
+              &AbstractLayerTest::events,
+              &AbstractLayerTest::eventsDefault,
+              &AbstractLayerTest::eventsNotSupported,
+
               &AbstractLayerTest::pointerEvent,
               &AbstractLayerTest::pointerEventNotSupported,
               &AbstractLayerTest::pointerEventNotImplemented,
@@ -346,7 +407,14 @@ AbstractLayerTest::AbstractLayerTest() {
               &AbstractLayerTest::visibilityLostEvent,
               &AbstractLayerTest::visibilityLostEventNotSupported,
               &AbstractLayerTest::visibilityLostEventNotImplemented,
-              &AbstractLayerTest::visibilityLostEventOutOfRange});
+              &AbstractLayerTest::visibilityLostEventOutOfRange,
+
+              &AbstractLayerTest::eventBatch,
+              &AbstractLayerTest::eventBatchDefault,
+              &AbstractLayerTest::eventBatchNotSupported,
+              &AbstractLayerTest::eventBatchOutOfRange,
+              &AbstractLayerTest::eventBatchNotPrimary,
+              &AbstractLayerTest::eventBatchAlreadyAccepted});
 }
 
 void AbstractLayerTest::debugFeature() {
@@ -357,8 +425,8 @@ void AbstractLayerTest::debugFeature() {
 
 void AbstractLayerTest::debugFeatures() {
     Containers::String out;
-    Debug{&out} << (LayerFeature::Draw|LayerFeature(0x80)) << LayerFeatures{};
-    CORRADE_COMPARE(out, "Ui::LayerFeature::Draw|Ui::LayerFeature(0x80) Ui::LayerFeatures{}\n");
+    Debug{&out} << (LayerFeature::Draw|LayerFeature(0x800)) << LayerFeatures{};
+    CORRADE_COMPARE(out, "Ui::LayerFeature::Draw|Ui::LayerFeature(0x800) Ui::LayerFeatures{}\n");
 }
 
 void AbstractLayerTest::debugFeaturesSupersets() {
@@ -382,9 +450,27 @@ void AbstractLayerTest::debugFeaturesSupersets() {
         Containers::String out;
         Debug{&out} << (LayerFeature::Composite|LayerFeature::Draw);
         CORRADE_COMPARE(out, "Ui::LayerFeature::Composite\n");
+
+    /* EventBatch is a superset of Event, so only one should be printed */
+    } {
+        Containers::String out;
+        Debug{&out} << (LayerFeature::EventBatch|LayerFeature::Event);
+        CORRADE_COMPARE(out, "Ui::LayerFeature::EventBatch\n");
     }
 }
 
+void AbstractLayerTest::debugEvent() {
+    Containers::String out;
+    Debug{&out} << LayerEvent::PointerMove << LayerEvent(0xbe);
+    CORRADE_COMPARE(out, "Ui::LayerEvent::PointerMove Ui::LayerEvent(0xbe)\n");
+}
+
+void AbstractLayerTest::debugEvents() {
+    Containers::String out;
+    Debug{&out} << (LayerEvent::Pointer|LayerEvent::Focus|LayerEvent(0x80)) << LayerEvents{};
+    CORRADE_COMPARE(out, "Ui::LayerEvent::Pointer|Ui::LayerEvent::Focus|Ui::LayerEvent(0x80) Ui::LayerEvents{}\n");
+}
+
 void AbstractLayerTest::debugState() {
     Containers::String out;
     Debug{&out} << LayerState::NeedsAttachmentUpdate << LayerState(0xbebe);
@@ -602,9 +688,9 @@ void AbstractLayerTest::setNeedsUpdateInvalid() {
     layer.setNeedsUpdate(LayerState::NeedsCompositeOffsetSizeUpdate);
     layerCompositing.setNeedsUpdate(LayerState::NeedsNodeOffsetSizeUpdate);
     CORRADE_COMPARE_AS(out,
-        "Ui::AbstractLayer::setNeedsUpdate(): expected a non-empty subset of Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate but got Ui::LayerStates{}\n"
-        "Ui::AbstractLayer::setNeedsUpdate(): expected a non-empty subset of Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate but got Ui::LayerState::NeedsCompositeOffsetSizeUpdate\n"
-        "Ui::AbstractLayer::setNeedsUpdate(): expected a non-empty subset of Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsCompositeOffsetSizeUpdate but got Ui::LayerState::NeedsNodeOffsetSizeUpdate\n",
+        "Ui::AbstractLayer::setNeedsUpdate(): expected a non-empty subset of Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsDataStyleUpdate but got Ui::LayerStates{}\n"
+        "Ui::AbstractLayer::setNeedsUpdate(): expected a non-empty subset of Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsDataStyleUpdate but got Ui::LayerState::NeedsCompositeOffsetSizeUpdate\n"
+        "Ui::AbstractLayer::setNeedsUpdate(): expected a non-empty subset of Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsCompositeOffsetSizeUpdate|Ui::LayerState::NeedsDataStyleUpdate but got Ui::LayerState::NeedsNodeOffsetSizeUpdate\n",
         TestSuite::Compare::String);
 }
 
@@ -651,6 +737,273 @@ void AbstractLayerTest::createRemove() {
     CORRADE_COMPARE(layer.usedCount(), 0);
 }
 
+void AbstractLayerTest::memoryUsage() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+        MemoryUsage doMemoryUsage() const override {
+            return {1000, 2000, 300, 4000};
+        }
+    } layer{layerHandle(0xab, 0x12)};
+
+    /* Initially there's just what the implementation reports */
+    {
+        MemoryUsage usage = layer.memoryUsage();
+        CORRADE_COMPARE(usage.cpuUsed, 1000);
+        CORRADE_COMPARE(usage.cpuReserved, 2000);
+        CORRADE_COMPARE(usage.cpuUnused, 300);
+        CORRADE_COMPARE(usage.gpu, 4000);
+    }
+
+    DataHandle first = layer.create();
+    layer.create();
+    MemoryUsage usage = layer.memoryUsage();
+    CORRADE_COMPARE_AS(usage.cpuUsed, 1000,
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE_AS(usage.cpuReserved - 2000, usage.cpuUsed - 1000,
+        TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE(usage.cpuUnused, 300);
+    CORRADE_COMPARE(usage.gpu, 4000);
+
+    /* The removed data slot is counted as unused, the total stays the same */
+    layer.remove(first);
+    MemoryUsage usageRemoved = layer.memoryUsage();
+    CORRADE_COMPARE(usageRemoved.cpuUsed, usage.cpuUsed);
+    CORRADE_COMPARE(usageRemoved.cpuReserved, usage.cpuReserved);
+    CORRADE_COMPARE(usageRemoved.cpuUnused - 300, (usage.cpuUsed - 1000)/2);
+    CORRADE_COMPARE(usageRemoved.gpu, 4000);
+}
+
+void AbstractLayerTest::memoryUsageNotImplemented() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0xab, 0x12)};
+
+    MemoryUsage usage = layer.memoryUsage();
+    CORRADE_COMPARE(usage.cpuUsed, 0);
+    CORRADE_COMPARE(usage.cpuReserved, 0);
+    CORRADE_COMPARE(usage.cpuUnused, 0);
+    CORRADE_COMPARE(usage.gpu, 0);
+}
+
+void AbstractLayerTest::trim() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+        void doTrim(std::size_t capacity) override {
+            CORRADE_COMPARE(capacity, this->capacity());
+            ++called;
+        }
+
+        Int called = 0;
+    } layer{layerHandle(0xab, 0x12)};
+
+    DataHandle first = layer.create();
+    DataHandle second = layer.create();
+    DataHandle third = layer.create();
+    DataHandle fourth = layer.create();
+    DataHandle fifth = layer.create();
+    layer.remove(fifth);
+    layer.remove(second);
+    layer.remove(fourth);
+    CORRADE_COMPARE(layer.capacity(), 5);
+    CORRADE_COMPARE(layer.usedCount(), 2);
+
+    /* Clear the state from create() and remove() to verify trim() sets it */
+    layer.cleanData({});
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* The free slots at the end are dropped, the one in the middle stays */
+    layer.trim();
+    CORRADE_COMPARE(layer.called, 1);
+    CORRADE_COMPARE(layer.capacity(), 3);
+    CORRADE_COMPARE(layer.usedCount(), 2);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    CORRADE_VERIFY(layer.isHandleValid(first));
+    CORRADE_VERIFY(!layer.isHandleValid(second));
+    CORRADE_VERIFY(layer.isHandleValid(third));
+    CORRADE_VERIFY(!layer.isHandleValid(fourth));
+    CORRADE_VERIFY(!layer.isHandleValid(fifth));
+
+    /* The free slot in the middle is reused first, the dropped ones get
+       recreated with a generation that doesn't alias the old handles */
+    DataHandle second2 = layer.create();
+    DataHandle fourth2 = layer.create();
+    DataHandle fifth2 = layer.create();
+    CORRADE_COMPARE(dataHandleId(second2), 1);
+    CORRADE_COMPARE(dataHandleId(fourth2), 3);
+    CORRADE_COMPARE(dataHandleId(fifth2), 4);
+    CORRADE_COMPARE_AS(dataHandleGeneration(fourth2), dataHandleGeneration(fourth),
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE_AS(dataHandleGeneration(fifth2), dataHandleGeneration(fifth),
+        TestSuite::Compare::Greater);
+    CORRADE_VERIFY(!layer.isHandleValid(fourth));
+    CORRADE_VERIFY(!layer.isHandleValid(fifth));
+    CORRADE_COMPARE(layer.capacity(), 5);
+    CORRADE_COMPARE(layer.usedCount(), 5);
+
+    /* With no free slots at the end the capacity stays the same, the
+       implementation is still called to release reserved memory */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    layer.trim();
+    CORRADE_COMPARE(layer.called, 2);
+    CORRADE_COMPARE(layer.capacity(), 5);
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+}
+
+void AbstractLayerTest::trimEmpty() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0xab, 0x12)};
+
+    /* Trimming an empty layer does nothing */
+    layer.trim();
+    CORRADE_COMPARE(layer.capacity(), 0);
+
+    DataHandle first = layer.create();
+    DataHandle second = layer.create();
+    layer.remove(first);
+    layer.remove(second);
+
+    /* All data are dropped, the free list is empty after */
+    layer.trim();
+    CORRADE_COMPARE(layer.capacity(), 0);
+    CORRADE_COMPARE(layer.usedCount(), 0);
+
+    DataHandle first2 = layer.create();
+    CORRADE_COMPARE(dataHandleId(first2), 0);
+    CORRADE_COMPARE(layer.capacity(), 1);
+    CORRADE_VERIFY(!layer.isHandleValid(first));
+    CORRADE_VERIFY(layer.isHandleValid(first2));
+}
+
+void AbstractLayerTest::reserve() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override { return {}; }
+        void doReserve(std::size_t capacity) override {
+            reservedCapacity = capacity;
+        }
+
+        std::size_t reservedCapacity = 0;
+    } layer{layerHandle(0xab, 0x12)};
+
+    layer.create();
+    layer.reserve(100);
+    CORRADE_COMPARE(layer.reservedCapacity, 100);
+
+    /* The capacity doesn't change, only the reserved memory */
+    CORRADE_COMPARE(layer.capacity(), 1);
+    MemoryUsage usage = layer.memoryUsage();
+    CORRADE_COMPARE_AS(usage.cpuReserved, 100*usage.cpuUsed,
+        TestSuite::Compare::GreaterOrEqual);
+
+    /* Creating data up to the reserved capacity doesn't reallocate */
+    for(std::size_t i = 0; i != 99; ++i)
+        layer.create();
+    CORRADE_COMPARE(layer.capacity(), 100);
+    CORRADE_COMPARE(layer.memoryUsage().cpuReserved, usage.cpuReserved);
+}
+
+void AbstractLayerTest::reserveInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0xab, 0x12)};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.reserve(1048577);
+    CORRADE_COMPARE(out, "Ui::AbstractLayer::reserve(): can only have at most 1048576 data but got 1048577\n");
+}
+
+void AbstractLayerTest::fixedCapacity() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0xab, 0x12)};
+    CORRADE_COMPARE(layer.fixedCapacity(), 0);
+    CORRADE_VERIFY(!layer.isFull());
+
+    layer.setFixedCapacity(3);
+    CORRADE_COMPARE(layer.fixedCapacity(), 3);
+    CORRADE_COMPARE(layer.capacity(), 0);
+    CORRADE_VERIFY(!layer.isFull());
+    const std::size_t reserved = layer.memoryUsage().cpuReserved;
+
+    layer.create();
+    DataHandle second = layer.create();
+    CORRADE_VERIFY(!layer.isFull());
+    layer.create();
+    CORRADE_VERIFY(layer.isFull());
+    CORRADE_COMPARE(layer.capacity(), 3);
+    CORRADE_COMPARE(layer.memoryUsage().cpuReserved, reserved);
+
+    /* Removing data makes a slot free again */
+    layer.remove(second);
+    CORRADE_VERIFY(!layer.isFull());
+    layer.create();
+    CORRADE_VERIFY(layer.isFull());
+
+    /* Trimming doesn't release the fixed storage */
+    layer.trim();
+    CORRADE_COMPARE(layer.memoryUsage().cpuReserved, reserved);
+
+    /* Resetting the capacity back makes the storage grow again */
+    layer.setFixedCapacity(0);
+    CORRADE_COMPARE(layer.fixedCapacity(), 0);
+    CORRADE_VERIFY(!layer.isFull());
+    layer.create();
+    CORRADE_COMPARE(layer.capacity(), 4);
+}
+
+void AbstractLayerTest::fixedCapacityInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0xab, 0x12)};
+
+    layer.create();
+    layer.create();
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.setFixedCapacity(1048577);
+    layer.setFixedCapacity(1);
+    layer.setFixedCapacity(2);
+    layer.create();
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractLayer::setFixedCapacity(): can only have at most 1048576 data but got 1048577\n"
+        "Ui::AbstractLayer::setFixedCapacity(): capacity 1 is less than current capacity 2\n"
+        "Ui::AbstractLayer::create(): fixed capacity of 2 exhausted\n",
+        TestSuite::Compare::String);
+}
+
 void AbstractLayerTest::createRemoveHandleRecycle() {
     struct: AbstractLayer {
         using AbstractLayer::AbstractLayer;
@@ -1354,6 +1707,102 @@ void AbstractLayerTest::cleanNodesEmpty() {
     CORRADE_COMPARE(layer.called, 1);
 }
 
+void AbstractLayerTest::cleanNodesSparse() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override { return {}; }
+
+        void doClean(Containers::BitArrayView) override {
+            CORRADE_FAIL("This shouldn't get called.");
+        }
+        void doCleanSparse(Containers::BitArrayView dataIdsToRemove, Containers::ArrayView<const UnsignedInt> dataIds) override {
+            ++called;
+            CORRADE_COMPARE_AS(dataIdsToRemove, expectedDataIdsToRemove.sliceBit(0), TestSuite::Compare::Container);
+            CORRADE_COMPARE_AS(dataIds, expectedDataIds, TestSuite::Compare::Container);
+        }
+
+        Int called = 0;
+        Containers::StridedArrayView1D<const bool> expectedDataIdsToRemove;
+        Containers::ArrayView<const UnsignedInt> expectedDataIds;
+    } layer{layerHandle(0, 1)};
+
+    NodeHandle nodeFirst = nodeHandle(0, 0xcec);
+    NodeHandle nodeSecond = nodeHandle(1, 0xded);
+    NodeHandle nodeThird = nodeHandle(2, 0xaba);
+
+    DataHandle first = layer.create(nodeSecond);
+    DataHandle second = layer.create(nodeFirst);
+    DataHandle third = layer.create(nodeThird);
+    DataHandle fourth = layer.create(nodeSecond);
+
+    /* Second node gets removed, affecting first and fourth data */
+    {
+        const bool expectedDataIdsToRemove[]{true, false, false, true};
+        const UnsignedInt expectedDataIds[]{0, 3};
+        layer.expectedDataIdsToRemove = expectedDataIdsToRemove;
+        layer.expectedDataIds = expectedDataIds;
+        layer.cleanNodes(Containers::arrayView({
+            UnsignedShort(nodeHandleGeneration(nodeFirst)),
+            UnsignedShort(nodeHandleGeneration(nodeSecond) + 1),
+            UnsignedShort(nodeHandleGeneration(nodeThird)),
+        }));
+        CORRADE_COMPARE(layer.called, 1);
+    }
+
+    /* Calling again with the third node removed doesn't have the bits from
+       the previous call set anymore */
+    {
+        const bool expectedDataIdsToRemove[]{false, false, true, false};
+        const UnsignedInt expectedDataIds[]{2};
+        layer.expectedDataIdsToRemove = expectedDataIdsToRemove;
+        layer.expectedDataIds = expectedDataIds;
+        layer.cleanNodes(Containers::arrayView({
+            UnsignedShort(nodeHandleGeneration(nodeFirst)),
+            UnsignedShort(nodeHandleGeneration(nodeSecond) + 1),
+            UnsignedShort(nodeHandleGeneration(nodeThird) + 1),
+        }));
+        CORRADE_COMPARE(layer.called, 2);
+    }
+
+    /* The removed data get reused in the order they were removed in, the
+       last one makes the capacity larger. The bits are reallocated in that
+       case, and again nothing from before is set. */
+    DataHandle fifth = layer.create(nodeFirst);
+    DataHandle sixth = layer.create(nodeHandle(2, nodeHandleGeneration(nodeThird) + 1));
+    DataHandle seventh = layer.create(nodeFirst);
+    DataHandle eighth = layer.create(nodeFirst);
+    CORRADE_COMPARE(dataHandleId(fifth), 0);
+    CORRADE_COMPARE(dataHandleId(sixth), 3);
+    CORRADE_COMPARE(dataHandleId(seventh), 2);
+    CORRADE_COMPARE(dataHandleId(eighth), 4);
+    CORRADE_COMPARE(layer.capacity(), 5);
+    {
+        /* First node gets removed, affecting second, fifth, seventh and
+           eighth data */
+        const bool expectedDataIdsToRemove[]{true, true, true, false, true};
+        const UnsignedInt expectedDataIds[]{0, 1, 2, 4};
+        layer.expectedDataIdsToRemove = expectedDataIdsToRemove;
+        layer.expectedDataIds = expectedDataIds;
+        layer.cleanNodes(Containers::arrayView({
+            UnsignedShort(nodeHandleGeneration(nodeFirst) + 1),
+            UnsignedShort(nodeHandleGeneration(nodeSecond) + 1),
+            UnsignedShort(nodeHandleGeneration(nodeThird) + 1),
+        }));
+        CORRADE_COMPARE(layer.called, 3);
+    }
+
+    CORRADE_VERIFY(!layer.isHandleValid(first));
+    CORRADE_VERIFY(!layer.isHandleValid(second));
+    CORRADE_VERIFY(!layer.isHandleValid(third));
+    CORRADE_VERIFY(!layer.isHandleValid(fourth));
+    CORRADE_VERIFY(!layer.isHandleValid(fifth));
+    CORRADE_VERIFY(layer.isHandleValid(sixth));
+    CORRADE_VERIFY(!layer.isHandleValid(seventh));
+    CORRADE_VERIFY(!layer.isHandleValid(eighth));
+}
+
 void AbstractLayerTest::cleanNodesNotImplemented() {
     struct: AbstractLayer {
         using AbstractLayer::AbstractLayer;
@@ -2389,6 +2838,40 @@ void AbstractLayerTest::updateNotImplemented() {
     CORRADE_VERIFY(true);
 }
 
+void AbstractLayerTest::updateUploadedSize() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::addUploadedSize;
+
+        LayerFeatures doFeatures() const override { return LayerFeature::ConcurrentUpdate; }
+
+        void doUpdate(LayerStates, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) override {
+            addUploadedSize(100);
+            addUploadedSize(20);
+        }
+
+        void doPostUpdate(LayerStates) override {
+            addUploadedSize(3);
+        }
+    } layer{layerHandle(0, 1)};
+
+    /* Initially zero */
+    CORRADE_COMPARE(layer.uploadedSize(), 0);
+
+    /* Accumulates from both the update and the post update */
+    layer.update(LayerState::NeedsSharedDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    layer.postUpdate(LayerState::NeedsSharedDataUpdate);
+    CORRADE_COMPARE(layer.uploadedSize(), 123);
+
+    /* Calling it from outside of an update accumulates as well */
+    layer.addUploadedSize(7);
+    CORRADE_COMPARE(layer.uploadedSize(), 130);
+
+    /* Next update resets it */
+    layer.update(LayerState::NeedsSharedDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.uploadedSize(), 120);
+}
+
 void AbstractLayerTest::updateStateFiltering() {
     auto&& data = UpdateStateFilteringData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -2432,9 +2915,9 @@ void AbstractLayerTest::updateInvalidState() {
     layer.update(LayerState::NeedsDataClean, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
     layer.update(LayerState::NeedsCompositeOffsetSizeUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
     CORRADE_COMPARE_AS(out,
-        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate but got Ui::LayerStates{}\n"
-        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate but got Ui::LayerState::NeedsDataClean\n"
-        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate but got Ui::LayerState::NeedsCompositeOffsetSizeUpdate\n",
+        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsDataStyleUpdate but got Ui::LayerStates{}\n"
+        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsDataStyleUpdate but got Ui::LayerState::NeedsDataClean\n"
+        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsDataStyleUpdate but got Ui::LayerState::NeedsCompositeOffsetSizeUpdate\n",
         TestSuite::Compare::String);
 }
 
@@ -2454,8 +2937,8 @@ void AbstractLayerTest::updateInvalidStateComposite() {
     layer.update({}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
     layer.update(LayerState::NeedsDataClean, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
     CORRADE_COMPARE_AS(out,
-        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsCompositeOffsetSizeUpdate but got Ui::LayerStates{}\n"
-        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsCompositeOffsetSizeUpdate but got Ui::LayerState::NeedsDataClean\n",
+        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsCompositeOffsetSizeUpdate|Ui::LayerState::NeedsDataStyleUpdate but got Ui::LayerStates{}\n"
+        "Ui::AbstractLayer::update(): expected a non-empty subset of Ui::LayerState::NeedsNodeOffsetSizeUpdate|Ui::LayerState::NeedsAttachmentUpdate|Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate|Ui::LayerState::NeedsCompositeOffsetSizeUpdate|Ui::LayerState::NeedsDataStyleUpdate but got Ui::LayerState::NeedsDataClean\n",
         TestSuite::Compare::String);
 }
 
@@ -2624,23 +3107,75 @@ void AbstractLayerTest::updateNoSizeSet() {
     CORRADE_COMPARE(out, "Ui::AbstractLayer::update(): user interface size wasn't set\n");
 }
 
-void AbstractLayerTest::state() {
-    auto&& data = StateData[testCaseInstanceId()];
-    setTestCaseDescription(data.name);
+void AbstractLayerTest::postUpdate() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
 
-    struct Layer: AbstractLayer {
-        explicit Layer(LayerHandle handle, LayerFeatures features): AbstractLayer{handle}, _features{features} {}
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::ConcurrentUpdate;
+        }
+        void doPostUpdate(LayerStates states) override {
+            called = states;
+        }
 
-        using AbstractLayer::create;
-        using AbstractLayer::remove;
+        LayerStates called;
+    } layer{layerHandle(0, 1)};
 
-        LayerFeatures doFeatures() const override { return _features; }
+    /* Same as with update(), the NeedsAttachmentUpdate bits except for
+       NeedsNodeOpacityUpdate and NeedsNodeOrderUpdate are filtered away */
+    layer.postUpdate(LayerState::NeedsAttachmentUpdate|LayerState::NeedsCommonDataUpdate);
+    CORRADE_COMPARE(layer.called, LayerState::NeedsNodeOpacityUpdate|LayerState::NeedsNodeOrderUpdate|LayerState::NeedsCommonDataUpdate);
+}
 
-        void doUpdate(LayerStates state, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) override {
-            /* The doUpdate() should never get the NeedsAttachmentUpdate, only
-               the NeedsNodeOpacityUpdate / NeedsNodeOrderUpdate that's a
-               subset of it. It shouldn't get an empty state either, that'd
-               mean there's some bug in the process. */
+void AbstractLayerTest::postUpdateNotSupported() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1)};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.postUpdate(LayerState::NeedsDataUpdate);
+    CORRADE_COMPARE(out, "Ui::AbstractLayer::postUpdate(): feature not supported\n");
+}
+
+void AbstractLayerTest::postUpdateEmpty() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::ConcurrentUpdate;
+        }
+    } layer{layerHandle(0, 1)};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.postUpdate({});
+    CORRADE_COMPARE(out, "Ui::AbstractLayer::postUpdate(): expected a non-empty set of states\n");
+}
+
+void AbstractLayerTest::state() {
+    auto&& data = StateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    struct Layer: AbstractLayer {
+        explicit Layer(LayerHandle handle, LayerFeatures features): AbstractLayer{handle}, _features{features} {}
+
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return _features; }
+
+        void doUpdate(LayerStates state, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) override {
+            /* The doUpdate() should never get the NeedsAttachmentUpdate, only
+               the NeedsNodeOpacityUpdate / NeedsNodeOrderUpdate that's a
+               subset of it. It shouldn't get an empty state either, that'd
+               mean there's some bug in the process. */
             CORRADE_VERIFY(state);
             CORRADE_VERIFY(!(state >= LayerState::NeedsAttachmentUpdate));
         }
@@ -3281,6 +3816,227 @@ void AbstractLayerTest::drawInvalidSizes() {
         TestSuite::Compare::String);
 }
 
+void AbstractLayerTest::drawOpaque() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::Draw|LayerFeature::DrawOpaque;
+        }
+
+        void doDraw(const Containers::StridedArrayView1D<const UnsignedInt>&, std::size_t, std::size_t, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, std::size_t, std::size_t, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) override {
+            CORRADE_FAIL("This shouldn't be called");
+        }
+
+        void doDrawOpaque(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t offset, std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, std::size_t clipRectOffset, std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) override {
+            ++called;
+            CORRADE_COMPARE_AS(dataIds, Containers::arrayView({
+                0xabcdeu,
+                0u,
+                0x45678u,
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(offset, 1);
+            CORRADE_COMPARE(count, 2);
+            CORRADE_COMPARE_AS(clipRectIds, Containers::arrayView({
+                3u,
+                0u
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE_AS(clipRectDataCounts, Containers::arrayView({
+                1u,
+                2u
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(clipRectOffset, 1);
+            CORRADE_COMPARE(clipRectCount, 1);
+            CORRADE_COMPARE_AS(nodeOffsets, Containers::arrayView<Vector2>({
+                {1.0f, 2.0f},
+                {3.0f, 4.0f}
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE_AS(nodeSizes, Containers::arrayView<Vector2>({
+                {0.1f, 0.2f},
+                {0.3f, 0.4f}
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE_AS(nodeOpacities, Containers::arrayView({
+                0.25f,
+                0.75f
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE_AS(nodesEnabled, Containers::stridedArrayView({
+                false,
+                true
+            }).sliceBit(0), TestSuite::Compare::Container);
+            CORRADE_COMPARE_AS(clipRectOffsets, Containers::arrayView<Vector2>({
+                {6.5f, 7.5f},
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE_AS(clipRectSizes, Containers::arrayView<Vector2>({
+                {8.5f, 9.5f},
+            }), TestSuite::Compare::Container);
+        }
+
+        Int called = 0;
+    } layer{layerHandle(0, 1)};
+
+    /* Capture correct function name */
+    CORRADE_VERIFY(true);
+
+    UnsignedByte nodesEnabled[1]{0x2};
+
+    layer.drawOpaque(
+        Containers::arrayView({
+            0xabcdeu,
+            0u,
+            0x45678u
+        }),
+        1, 2,
+        Containers::arrayView({
+            3u,
+            0u
+        }),
+        Containers::arrayView({
+            1u,
+            2u
+        }),
+        1, 1,
+        Containers::arrayView<Vector2>({
+            {1.0f, 2.0f},
+            {3.0f, 4.0f}
+        }),
+        Containers::arrayView<Vector2>({
+            {0.1f, 0.2f},
+            {0.3f, 0.4f}
+        }),
+        Containers::arrayView({
+            0.25f,
+            0.75f
+        }),
+        Containers::BitArrayView{nodesEnabled, 0, 2},
+        Containers::arrayView<Vector2>({
+            {6.5f, 7.5f},
+        }),
+        Containers::arrayView<Vector2>({
+            {8.5f, 9.5f},
+        })
+    );
+    CORRADE_COMPARE(layer.called, 1);
+}
+
+void AbstractLayerTest::drawOpaqueNotSupported() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        /* Draw alone isn't enough */
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::Draw;
+        }
+    } layer{layerHandle(0, 1)};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.drawOpaque({}, 0, 0, {}, {}, 0, 0, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(out, "Ui::AbstractLayer::drawOpaque(): feature not supported\n");
+}
+
+void AbstractLayerTest::drawOpaqueNotImplemented() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::Draw|LayerFeature::DrawOpaque;
+        }
+    } layer{layerHandle(0, 1)};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.drawOpaque({}, 0, 0, {}, {}, 0, 0, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(out, "Ui::AbstractLayer::drawOpaque(): feature advertised but not implemented\n");
+}
+
+void AbstractLayerTest::drawOpaqueInvalidSizes() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::Draw|LayerFeature::DrawOpaque;
+        }
+    } layer{layerHandle(0, 1)};
+
+    UnsignedByte nodesEnabled[1]{};
+
+    /* Just a subset of what's tested in drawInvalidSizes(), the checks are
+       the same */
+    Containers::String out;
+    Error redirectError{&out};
+    layer.drawOpaque(
+        Containers::arrayView({
+            0u,
+            0u
+        }),
+        1, 2,
+        {}, {},
+        0, 0,
+        {}, {}, {}, {},
+        {}, {}
+    );
+    layer.drawOpaque(
+        {},
+        0, 0,
+        {}, {},
+        0, 0,
+        Containers::arrayView<Vector2>({{}, {}}),
+        Containers::arrayView<Vector2>({{}, {}}),
+        Containers::arrayView({0.0f, 0.0f}),
+        Containers::BitArrayView{nodesEnabled, 0, 3},
+        {}, {}
+    );
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractLayer::drawOpaque(): offset 1 and count 2 out of range for 2 items\n"
+        "Ui::AbstractLayer::drawOpaque(): expected node offset, size, opacity and enabled views to have the same size but got 2, 2, 2 and 3\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractLayerTest::events() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override { return LayerFeature::Event; }
+        LayerEvents doEvents() const override {
+            return LayerEvent::Pointer|LayerEvent::Scroll;
+        }
+    } layer{layerHandle(0, 1)};
+
+    CORRADE_COMPARE(layer.events(), LayerEvent::Pointer|LayerEvent::Scroll);
+}
+
+void AbstractLayerTest::eventsDefault() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override { return LayerFeature::Event; }
+    } layer{layerHandle(0, 1)};
+
+    /* All events are handled by default */
+    CORRADE_COMPARE(layer.events(), LayerEvent::Pointer|LayerEvent::PointerMove|LayerEvent::Scroll|LayerEvent::Focus|LayerEvent::Key|LayerEvent::TextInput);
+}
+
+void AbstractLayerTest::eventsNotSupported() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override { return LayerFeature::Draw; }
+    } layer{layerHandle(0, 1)};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.events();
+    CORRADE_COMPARE(out, "Ui::AbstractLayer::events(): feature not supported\n");
+}
+
 void AbstractLayerTest::pointerEvent() {
     struct: AbstractLayer {
         using AbstractLayer::AbstractLayer;
@@ -4112,6 +4868,324 @@ void AbstractLayerTest::visibilityLostEventOutOfRange() {
         TestSuite::Compare::String);
 }
 
+void AbstractLayerTest::eventBatch() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::EventBatch;
+        }
+
+        void doPointerPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) override {
+            CORRADE_COMPARE_AS(dataIds, Containers::arrayView<UnsignedInt>({
+                2, 0
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(event.pointer(), Pointer::MouseMiddle);
+            called *= 2;
+        }
+        void doPointerReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerEvent& event) override {
+            CORRADE_COMPARE_AS(dataIds, Containers::arrayView<UnsignedInt>({
+                1
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(event.pointer(), Pointer::MouseRight);
+            called *= 3;
+        }
+        void doPointerMoveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) override {
+            CORRADE_COMPARE_AS(dataIds, Containers::arrayView<UnsignedInt>({
+                0, 1, 2
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(event.pointers(), Pointer::Pen);
+            called *= 5;
+        }
+        void doPointerEnterEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) override {
+            CORRADE_COMPARE_AS(dataIds, Containers::arrayView<UnsignedInt>({
+                1, 0
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(event.pointers(), Pointer::MouseLeft);
+            called *= 7;
+        }
+        void doPointerLeaveEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, PointerMoveEvent& event) override {
+            CORRADE_COMPARE_AS(dataIds, Containers::arrayView<UnsignedInt>({
+                2
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(event.pointers(), Pointer::Finger);
+            called *= 11;
+        }
+        void doScrollEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, ScrollEvent& event) override {
+            CORRADE_COMPARE_AS(dataIds, Containers::arrayView<UnsignedInt>({
+                0, 2
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(event.offset(), (Vector2{2.5f, -1.3f}));
+            called *= 13;
+        }
+        void doKeyPressEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event) override {
+            CORRADE_COMPARE_AS(dataIds, Containers::arrayView<UnsignedInt>({
+                1, 2
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(event.key(), Key::Comma);
+            called *= 17;
+        }
+        void doKeyReleaseEvents(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, KeyEvent& event) override {
+            CORRADE_COMPARE_AS(dataIds, Containers::arrayView<UnsignedInt>({
+                0
+            }), TestSuite::Compare::Container);
+            CORRADE_COMPARE(event.key(), Key::Delete);
+            called *= 19;
+        }
+
+        int called = 1;
+    } layer{layerHandle(0, 1)};
+
+    /* Capture correct test case name */
+    CORRADE_VERIFY(true);
+
+    layer.create();
+    layer.create();
+    layer.create();
+    {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseMiddle, true, 0};
+        layer.pointerPressEvents(Containers::arrayView<UnsignedInt>({2, 0}), event);
+    } {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseRight, true, 0};
+        layer.pointerReleaseEvents(Containers::arrayView<UnsignedInt>({1}), event);
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Pen, {}, Pointer::Pen, true, 0};
+        layer.pointerMoveEvents(Containers::arrayView<UnsignedInt>({0, 1, 2}), event);
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, Pointer::MouseLeft, true, 0};
+        layer.pointerEnterEvents(Containers::arrayView<UnsignedInt>({1, 0}), event);
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Touch, {}, Pointer::Finger, true, 0};
+        layer.pointerLeaveEvents(Containers::arrayView<UnsignedInt>({2}), event);
+    } {
+        ScrollEvent event{{}, {2.5f, -1.3f}};
+        layer.scrollEvents(Containers::arrayView<UnsignedInt>({0, 2}), event);
+    } {
+        KeyEvent event{{}, Key::Comma, {}};
+        layer.keyPressEvents(Containers::arrayView<UnsignedInt>({1, 2}), event);
+    } {
+        KeyEvent event{{}, Key::Delete, {}};
+        layer.keyReleaseEvents(Containers::arrayView<UnsignedInt>({0}), event);
+    }
+    CORRADE_COMPARE(layer.called, 2*3*5*7*11*13*17*19);
+}
+
+void AbstractLayerTest::eventBatchDefault() {
+    /* The default implementation calls the per-data variants in order,
+       accepting the event if any of them accepts it. Doesn't need
+       LayerFeature::EventBatch to be advertised. */
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::Event;
+        }
+
+        void doPointerPressEvent(UnsignedInt dataId, PointerEvent& event) override {
+            /* Each call should get the accept status reset */
+            CORRADE_VERIFY(!event.isAccepted());
+            arrayAppend(calls, dataId);
+            if(dataId == acceptedId)
+                event.setAccepted();
+        }
+        void doKeyReleaseEvent(UnsignedInt dataId, KeyEvent& event) override {
+            CORRADE_VERIFY(!event.isAccepted());
+            arrayAppend(calls, dataId);
+            if(dataId == acceptedId)
+                event.setAccepted();
+        }
+
+        Containers::Array<UnsignedInt> calls;
+        UnsignedInt acceptedId = ~UnsignedInt{};
+    } layer{layerHandle(0, 1)};
+
+    layer.create();
+    layer.create();
+    layer.create();
+
+    /* Accepted by one data in the middle, the event stays accepted */
+    {
+        layer.acceptedId = 0;
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        layer.pointerPressEvents(Containers::arrayView<UnsignedInt>({2, 0, 1}), event);
+        CORRADE_VERIFY(event.isAccepted());
+        CORRADE_COMPARE_AS(layer.calls, Containers::arrayView<UnsignedInt>({
+            2, 0, 1
+        }), TestSuite::Compare::Container);
+
+    /* Not accepted by any */
+    } {
+        layer.calls = {};
+        layer.acceptedId = ~UnsignedInt{};
+        KeyEvent event{{}, Key::Delete, {}};
+        layer.keyReleaseEvents(Containers::arrayView<UnsignedInt>({1, 2}), event);
+        CORRADE_VERIFY(!event.isAccepted());
+        CORRADE_COMPARE_AS(layer.calls, Containers::arrayView<UnsignedInt>({
+            1, 2
+        }), TestSuite::Compare::Container);
+    }
+}
+
+void AbstractLayerTest::eventBatchNotSupported() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1)};
+
+    PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseMiddle, true, 0};
+    PointerMoveEvent moveEvent{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+    ScrollEvent scrollEvent{{}, {}};
+    KeyEvent keyEvent{{}, Key::C, {}};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.pointerPressEvents({}, event);
+    layer.pointerReleaseEvents({}, event);
+    layer.pointerMoveEvents({}, moveEvent);
+    layer.pointerEnterEvents({}, moveEvent);
+    layer.pointerLeaveEvents({}, moveEvent);
+    layer.scrollEvents({}, scrollEvent);
+    layer.keyPressEvents({}, keyEvent);
+    layer.keyReleaseEvents({}, keyEvent);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractLayer::pointerPressEvents(): feature not supported\n"
+        "Ui::AbstractLayer::pointerReleaseEvents(): feature not supported\n"
+        "Ui::AbstractLayer::pointerMoveEvents(): feature not supported\n"
+        "Ui::AbstractLayer::pointerEnterEvents(): feature not supported\n"
+        "Ui::AbstractLayer::pointerLeaveEvents(): feature not supported\n"
+        "Ui::AbstractLayer::scrollEvents(): feature not supported\n"
+        "Ui::AbstractLayer::keyPressEvents(): feature not supported\n"
+        "Ui::AbstractLayer::keyReleaseEvents(): feature not supported\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractLayerTest::eventBatchOutOfRange() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::EventBatch;
+        }
+    } layer{layerHandle(0, 1)};
+
+    layer.create();
+    layer.create();
+
+    PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseMiddle, true, 0};
+    PointerMoveEvent moveEvent{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+    ScrollEvent scrollEvent{{}, {}};
+    KeyEvent keyEvent{{}, Key::C, {}};
+    const UnsignedInt dataIds[]{1, 2, 0};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.pointerPressEvents(dataIds, event);
+    layer.pointerReleaseEvents(dataIds, event);
+    layer.pointerMoveEvents(dataIds, moveEvent);
+    layer.pointerEnterEvents(dataIds, moveEvent);
+    layer.pointerLeaveEvents(dataIds, moveEvent);
+    layer.scrollEvents(dataIds, scrollEvent);
+    layer.keyPressEvents(dataIds, keyEvent);
+    layer.keyReleaseEvents(dataIds, keyEvent);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractLayer::pointerPressEvents(): index 2 at position 1 out of range for 2 data\n"
+        "Ui::AbstractLayer::pointerReleaseEvents(): index 2 at position 1 out of range for 2 data\n"
+        "Ui::AbstractLayer::pointerMoveEvents(): index 2 at position 1 out of range for 2 data\n"
+        "Ui::AbstractLayer::pointerEnterEvents(): index 2 at position 1 out of range for 2 data\n"
+        "Ui::AbstractLayer::pointerLeaveEvents(): index 2 at position 1 out of range for 2 data\n"
+        "Ui::AbstractLayer::scrollEvents(): index 2 at position 1 out of range for 2 data\n"
+        "Ui::AbstractLayer::keyPressEvents(): index 2 at position 1 out of range for 2 data\n"
+        "Ui::AbstractLayer::keyReleaseEvents(): index 2 at position 1 out of range for 2 data\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractLayerTest::eventBatchNotPrimary() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::EventBatch;
+        }
+    } layer{layerHandle(0, 1)};
+
+    layer.create();
+
+    PointerEvent event{{}, PointerEventSource::Touch, Pointer::Finger, false, 0};
+    PointerMoveEvent moveEvent{{}, PointerEventSource::Touch, {}, {}, false, 0};
+    const UnsignedInt dataIds[]{0};
+
+    /* These can be called with non-primary events */
+    layer.pointerPressEvents(dataIds, event);
+    layer.pointerReleaseEvents(dataIds, event);
+    layer.pointerMoveEvents(dataIds, moveEvent);
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.pointerEnterEvents(dataIds, moveEvent);
+    layer.pointerLeaveEvents(dataIds, moveEvent);
+    CORRADE_COMPARE(out,
+        "Ui::AbstractLayer::pointerEnterEvents(): event not primary\n"
+        "Ui::AbstractLayer::pointerLeaveEvents(): event not primary\n");
+}
+
+void AbstractLayerTest::eventBatchAlreadyAccepted() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::EventBatch;
+        }
+    } layer{layerHandle(0, 1)};
+
+    layer.create();
+
+    PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseMiddle, true, 0};
+    event.setAccepted();
+    PointerMoveEvent moveEvent{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+    moveEvent.setAccepted();
+    ScrollEvent scrollEvent{{}, {}};
+    scrollEvent.setAccepted();
+    KeyEvent keyEvent{{}, Key::C, {}};
+    keyEvent.setAccepted();
+    const UnsignedInt dataIds[]{0};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.pointerPressEvents(dataIds, event);
+    layer.pointerReleaseEvents(dataIds, event);
+    layer.pointerMoveEvents(dataIds, moveEvent);
+    layer.pointerEnterEvents(dataIds, moveEvent);
+    layer.pointerLeaveEvents(dataIds, moveEvent);
+    layer.scrollEvents(dataIds, scrollEvent);
+    layer.keyPressEvents(dataIds, keyEvent);
+    layer.keyReleaseEvents(dataIds, keyEvent);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractLayer::pointerPressEvents(): event already accepted\n"
+        "Ui::AbstractLayer::pointerReleaseEvents(): event already accepted\n"
+        "Ui::AbstractLayer::pointerMoveEvents(): event already accepted\n"
+        "Ui::AbstractLayer::pointerEnterEvents(): event already accepted\n"
+        "Ui::AbstractLayer::pointerLeaveEvents(): event already accepted\n"
+        "Ui::AbstractLayer::scrollEvents(): event already accepted\n"
+        "Ui::AbstractLayer::keyPressEvents(): event already accepted\n"
+        "Ui::AbstractLayer::keyReleaseEvents(): event already accepted\n",
+        TestSuite::Compare::String);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::AbstractLayerTest)
@@ -43,6 +43,8 @@ struct AbstractLayouterTest: TestSuite::Tester {
     void debugState();
     void debugStates();
     void debugStatesSupersets();
+    void debugFeature();
+    void debugFeatures();
 
     void construct();
     void constructInvalidHandle();
@@ -77,6 +79,8 @@ AbstractLayouterTest::AbstractLayouterTest() {
     addTests({&AbstractLayouterTest::debugState,
               &AbstractLayouterTest::debugStates,
               &AbstractLayouterTest::debugStatesSupersets,
+              &AbstractLayouterTest::debugFeature,
+              &AbstractLayouterTest::debugFeatures,
 
               &AbstractLayouterTest::construct,
               &AbstractLayouterTest::constructInvalidHandle,
@@ -129,6 +133,18 @@ void AbstractLayouterTest::debugStatesSupersets() {
     }
 }
 
+void AbstractLayouterTest::debugFeature() {
+    Containers::String out;
+    Debug{&out} << LayouterFeature::ConcurrentUpdate << LayouterFeature(0xbe);
+    CORRADE_COMPARE(out, "Ui::LayouterFeature::ConcurrentUpdate Ui::LayouterFeature(0xbe)\n");
+}
+
+void AbstractLayouterTest::debugFeatures() {
+    Containers::String out;
+    Debug{&out} << (LayouterFeature::ConcurrentUpdate|LayouterFeature(0xe0)) << LayouterFeatures{};
+    CORRADE_COMPARE(out, "Ui::LayouterFeature::ConcurrentUpdate|Ui::LayouterFeature(0xe0) Ui::LayouterFeatures{}\n");
+}
+
 void AbstractLayouterTest::construct() {
     struct: AbstractLayouter {
         using AbstractLayouter::AbstractLayouter;
@@ -137,6 +153,7 @@ void AbstractLayouterTest::construct() {
     } layouter{layouterHandle(0xab, 0x12)};
 
     CORRADE_COMPARE(layouter.handle(), layouterHandle(0xab, 0x12));
+    CORRADE_COMPARE(layouter.features(), LayouterFeatures{});
     CORRADE_COMPARE(layouter.state(), LayouterStates{});
     CORRADE_COMPARE(layouter.capacity(), 0);
     CORRADE_COMPARE(layouter.usedCount(), 0);
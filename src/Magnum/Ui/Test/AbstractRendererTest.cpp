@@ -30,9 +30,11 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/String.h>
-#include <Magnum/Math/Vector2.h>
+#include <Corrade/Utility/Format.h>
+#include <Magnum/Math/Range.h>
 
 #include "Magnum/Ui/AbstractRenderer.h"
+#include "Magnum/Ui/Handle.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
 
@@ -58,6 +60,28 @@ struct AbstractRendererTest: TestSuite::Tester {
     void transitionInvalid();
     void transitionNoFramebufferSetup();
     void transitionCompositeNotSupported();
+
+    void redrawRect();
+    void redrawRectInvalid();
+    void redrawRectNotSupported();
+
+    void layerProfile();
+    void layerProfileInvalid();
+    void layerProfileNotSupported();
+    void layerProfileNotImplemented();
+
+    void transitionDepth();
+    void transitionDepthInvalid();
+
+    void drawDepth();
+    void drawDepthInvalid();
+    void drawDepthNotSupported();
+    void drawDepthNotImplemented();
+
+    void drawCache();
+    void drawCacheInvalid();
+    void drawCacheNotSupported();
+    void drawCacheNotImplemented();
 };
 
 AbstractRendererTest::AbstractRendererTest() {
@@ -79,7 +103,29 @@ AbstractRendererTest::AbstractRendererTest() {
               &AbstractRendererTest::transition,
               &AbstractRendererTest::transitionInvalid,
               &AbstractRendererTest::transitionNoFramebufferSetup,
-              &AbstractRendererTest::transitionCompositeNotSupported});
+              &AbstractRendererTest::transitionCompositeNotSupported,
+
+              &AbstractRendererTest::redrawRect,
+              &AbstractRendererTest::redrawRectInvalid,
+              &AbstractRendererTest::redrawRectNotSupported,
+
+              &AbstractRendererTest::layerProfile,
+              &AbstractRendererTest::layerProfileInvalid,
+              &AbstractRendererTest::layerProfileNotSupported,
+              &AbstractRendererTest::layerProfileNotImplemented,
+
+              &AbstractRendererTest::transitionDepth,
+              &AbstractRendererTest::transitionDepthInvalid,
+
+              &AbstractRendererTest::drawDepth,
+              &AbstractRendererTest::drawDepthInvalid,
+              &AbstractRendererTest::drawDepthNotSupported,
+              &AbstractRendererTest::drawDepthNotImplemented,
+
+              &AbstractRendererTest::drawCache,
+              &AbstractRendererTest::drawCacheInvalid,
+              &AbstractRendererTest::drawCacheNotSupported,
+              &AbstractRendererTest::drawCacheNotImplemented});
 }
 
 void AbstractRendererTest::debugFeature() {
@@ -90,8 +136,8 @@ void AbstractRendererTest::debugFeature() {
 
 void AbstractRendererTest::debugFeatures() {
     Containers::String out;
-    Debug{&out} << (RendererFeature::Composite|RendererFeature(0xb0)) << RendererFeatures{};
-    CORRADE_COMPARE(out, "Ui::RendererFeature::Composite|Ui::RendererFeature(0xb0) Ui::RendererFeatures{}\n");
+    Debug{&out} << (RendererFeature::Composite|RendererFeature(0xa0)) << RendererFeatures{};
+    CORRADE_COMPARE(out, "Ui::RendererFeature::Composite|Ui::RendererFeature(0xa0) Ui::RendererFeatures{}\n");
 }
 
 void AbstractRendererTest::debugTargetState() {
@@ -122,6 +168,9 @@ void AbstractRendererTest::construct() {
     CORRADE_COMPARE(renderer.framebufferSize(), Vector2i{});
     CORRADE_COMPARE(renderer.currentTargetState(), RendererTargetState::Initial);
     CORRADE_COMPARE(renderer.currentDrawStates(), RendererDrawStates{});
+    CORRADE_COMPARE(renderer.redrawRect(), Range2Di{});
+    CORRADE_COMPARE(renderer.currentProfiledLayer(), LayerHandle::Null);
+    CORRADE_COMPARE(renderer.drawDepth(), 1.0f);
 }
 
 void AbstractRendererTest::constructCopy() {
@@ -407,6 +456,537 @@ void AbstractRendererTest::transitionCompositeNotSupported() {
     CORRADE_COMPARE(out, "Ui::AbstractRenderer::transition(): transition to Ui::RendererTargetState::Composite not supported\n");
 }
 
+void AbstractRendererTest::redrawRect() {
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::PartialRedraw;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState targetStateFrom, RendererTargetState, RendererDrawStates, RendererDrawStates) override {
+            /* The rect should be available in the transition away from the
+               initial state */
+            if(targetStateFrom == RendererTargetState::Initial)
+                arrayAppend(called, redrawRect());
+        }
+
+        Containers::Array<Range2Di> called;
+    } renderer;
+
+    /* Setting up the framebuffer makes the rect cover all of it */
+    renderer.setupFramebuffers({15, 37});
+    CORRADE_COMPARE(renderer.redrawRect(), (Range2Di{{}, {15, 37}}));
+
+    renderer.setRedrawRect({{3, 4}, {5, 17}});
+    CORRADE_COMPARE(renderer.redrawRect(), (Range2Di{{3, 4}, {5, 17}}));
+
+    /* The rect stays set in the transition and after */
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.transition(RendererTargetState::Final, {});
+    CORRADE_COMPARE(renderer.redrawRect(), (Range2Di{{3, 4}, {5, 17}}));
+
+    /* Transitioning to the initial state resets it back to the whole
+       framebuffer */
+    renderer.transition(RendererTargetState::Initial, {});
+    CORRADE_COMPARE(renderer.redrawRect(), (Range2Di{{}, {15, 37}}));
+
+    /* An empty rect and a rect covering the whole framebuffer is allowed */
+    renderer.setRedrawRect({});
+    CORRADE_COMPARE(renderer.redrawRect(), Range2Di{});
+    renderer.setRedrawRect({{}, {15, 37}});
+    CORRADE_COMPARE(renderer.redrawRect(), (Range2Di{{}, {15, 37}}));
+    renderer.setRedrawRect({});
+    renderer.transition(RendererTargetState::Final, {});
+
+    /* Setting up the framebuffer again resets it as well */
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.setRedrawRect({{3, 4}, {5, 17}});
+    renderer.setupFramebuffers({37, 15});
+    CORRADE_COMPARE(renderer.redrawRect(), (Range2Di{{}, {37, 15}}));
+
+    CORRADE_COMPARE_AS(renderer.called, Containers::arrayView<Range2Di>({
+        {{3, 4}, {5, 17}},
+        {}
+    }), TestSuite::Compare::Container);
+}
+
+void AbstractRendererTest::redrawRectInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::PartialRedraw;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.setRedrawRect({{-1, 3}, {5, 7}});
+    renderer.setRedrawRect({{1, 3}, {16, 7}});
+    renderer.setRedrawRect({{5, 3}, {4, 7}});
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.setRedrawRect({{1, 3}, {5, 7}});
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractRenderer::setRedrawRect(): {{-1, 3}, {5, 7}} out of range for a framebuffer of size {15, 37}\n"
+        "Ui::AbstractRenderer::setRedrawRect(): {{1, 3}, {16, 7}} out of range for a framebuffer of size {15, 37}\n"
+        "Ui::AbstractRenderer::setRedrawRect(): {{5, 3}, {4, 7}} out of range for a framebuffer of size {15, 37}\n"
+        "Ui::AbstractRenderer::setRedrawRect(): not allowed to be called in Ui::RendererTargetState::Draw\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractRendererTest::redrawRectNotSupported() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override { return {}; }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.setRedrawRect({{1, 3}, {5, 7}});
+    CORRADE_COMPARE(out, "Ui::AbstractRenderer::setRedrawRect(): partial redraw not supported\n");
+}
+
+void AbstractRendererTest::layerProfile() {
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::Composite|RendererFeature::LayerProfiling;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+        void doBeginLayerProfile(LayerHandle layer) override {
+            /* The layer is already set at this point */
+            CORRADE_COMPARE(currentProfiledLayer(), layer);
+            arrayAppend(called, InPlaceInit, layer, true);
+        }
+        void doEndLayerProfile(LayerHandle layer) override {
+            /* The layer is already reset at this point */
+            CORRADE_COMPARE(currentProfiledLayer(), LayerHandle::Null);
+            arrayAppend(called, InPlaceInit, layer, false);
+        }
+
+        Containers::Array<Containers::Pair<LayerHandle, bool>> called;
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+
+    renderer.transition(RendererTargetState::Composite, {});
+    renderer.beginLayerProfile(layerHandle(3, 0xcf));
+    CORRADE_COMPARE(renderer.currentProfiledLayer(), layerHandle(3, 0xcf));
+    renderer.endLayerProfile();
+    CORRADE_COMPARE(renderer.currentProfiledLayer(), LayerHandle::Null);
+
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::Blending);
+    renderer.beginLayerProfile(layerHandle(3, 0xcf));
+    renderer.endLayerProfile();
+    renderer.beginLayerProfile(layerHandle(1, 0x2a));
+    renderer.endLayerProfile();
+
+    CORRADE_COMPARE_AS(renderer.called, (Containers::arrayView<Containers::Pair<LayerHandle, bool>>({
+        {layerHandle(3, 0xcf), true},
+        {layerHandle(3, 0xcf), false},
+        {layerHandle(3, 0xcf), true},
+        {layerHandle(3, 0xcf), false},
+        {layerHandle(1, 0x2a), true},
+        {layerHandle(1, 0x2a), false},
+    })), TestSuite::Compare::Container);
+}
+
+void AbstractRendererTest::layerProfileInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::LayerProfiling;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+        void doBeginLayerProfile(LayerHandle) override {}
+        void doEndLayerProfile(LayerHandle) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.beginLayerProfile(layerHandle(3, 0xcf));
+    renderer.endLayerProfile();
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.beginLayerProfile(LayerHandle::Null);
+    renderer.beginLayerProfile(layerHandle(3, 0xcf));
+    renderer.beginLayerProfile(layerHandle(1, 0x2a));
+    renderer.transition(RendererTargetState::Final, {});
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractRenderer::beginLayerProfile(): not allowed to be called in Ui::RendererTargetState::Initial\n"
+        "Ui::AbstractRenderer::endLayerProfile(): no layer is being profiled\n"
+        "Ui::AbstractRenderer::beginLayerProfile(): expected a non-null layer\n"
+        "Ui::AbstractRenderer::beginLayerProfile(): Ui::LayerHandle(0x3, 0xcf) is already being profiled\n"
+        "Ui::AbstractRenderer::transition(): not allowed to be called while Ui::LayerHandle(0x3, 0xcf) is being profiled\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractRendererTest::layerProfileNotSupported() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override { return {}; }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+    renderer.transition(RendererTargetState::Draw, {});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.beginLayerProfile(layerHandle(3, 0xcf));
+    CORRADE_COMPARE(out, "Ui::AbstractRenderer::beginLayerProfile(): layer profiling not supported\n");
+}
+
+void AbstractRendererTest::layerProfileNotImplemented() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::LayerProfiling;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+    renderer.transition(RendererTargetState::Draw, {});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.beginLayerProfile(layerHandle(3, 0xcf));
+    renderer.endLayerProfile();
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractRenderer::beginLayerProfile(): feature advertised but not implemented\n"
+        "Ui::AbstractRenderer::endLayerProfile(): feature advertised but not implemented\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractRendererTest::transitionDepth() {
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::DepthBuffer;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates drawStatesFrom, RendererDrawStates drawStatesTo) override {
+            arrayAppend(called, InPlaceInit, drawStatesFrom, drawStatesTo);
+        }
+        void doSetDrawDepth(Float) override {}
+
+        Containers::Array<Containers::Pair<RendererDrawStates, RendererDrawStates>> called;
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::DepthTest|RendererDrawState::DepthPrepass);
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::DepthTest|RendererDrawState::Blending);
+    renderer.transition(RendererTargetState::Final, {});
+    CORRADE_COMPARE_AS(renderer.called, (Containers::arrayView<Containers::Pair<RendererDrawStates, RendererDrawStates>>({
+        {{}, RendererDrawState::DepthTest|RendererDrawState::DepthPrepass},
+        {RendererDrawState::DepthTest|RendererDrawState::DepthPrepass, RendererDrawState::DepthTest|RendererDrawState::Blending},
+        {RendererDrawState::DepthTest|RendererDrawState::Blending, {}},
+    })), TestSuite::Compare::Container);
+}
+
+void AbstractRendererTest::transitionDepthInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct Renderer: AbstractRenderer {
+        explicit Renderer(RendererFeatures features): _features{features} {}
+
+        RendererFeatures doFeatures() const override { return _features; }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+
+        private:
+            RendererFeatures _features;
+    };
+    Renderer renderer{RendererFeature::DepthBuffer};
+    Renderer rendererNoDepth{{}};
+
+    renderer.setupFramebuffers({15, 37});
+    rendererNoDepth.setupFramebuffers({15, 37});
+
+    Containers::String out;
+    Error redirectError{&out};
+    rendererNoDepth.transition(RendererTargetState::Draw, RendererDrawState::DepthTest|RendererDrawState::Blending);
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::DepthPrepass);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractRenderer::transition(): Ui::RendererDrawState::DepthTest not supported\n"
+        "Ui::AbstractRenderer::transition(): Ui::RendererDrawState::DepthPrepass expected to be used together with Ui::RendererDrawState::DepthTest\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractRendererTest::drawDepth() {
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::DepthBuffer;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+        void doSetDrawDepth(Float depth) override {
+            /* The depth is already set at this point */
+            CORRADE_COMPARE(drawDepth(), depth);
+            arrayAppend(called, depth);
+        }
+
+        Containers::Array<Float> called;
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::DepthTest);
+    renderer.setDrawDepth(0.75f);
+    CORRADE_COMPARE(renderer.drawDepth(), 0.75f);
+    renderer.setDrawDepth(0.0f);
+    renderer.setDrawDepth(1.0f);
+    renderer.setDrawDepth(0.25f);
+    CORRADE_COMPARE(renderer.drawDepth(), 0.25f);
+    CORRADE_COMPARE_AS(renderer.called, Containers::arrayView({
+        0.75f, 0.0f, 1.0f, 0.25f
+    }), TestSuite::Compare::Container);
+
+    /* Stays the same in the final state, gets reset on transition to the
+       initial state */
+    renderer.transition(RendererTargetState::Final, {});
+    CORRADE_COMPARE(renderer.drawDepth(), 0.25f);
+    renderer.transition(RendererTargetState::Initial, {});
+    CORRADE_COMPARE(renderer.drawDepth(), 1.0f);
+}
+
+void AbstractRendererTest::drawDepthInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::DepthBuffer;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+        void doSetDrawDepth(Float) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.setDrawDepth(0.5f);
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::DepthTest);
+    renderer.setDrawDepth(-0.1f);
+    renderer.setDrawDepth(1.1f);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractRenderer::setDrawDepth(): not allowed to be called in Ui::RendererTargetState::Initial\n"
+        "Ui::AbstractRenderer::setDrawDepth(): expected a value in the [0, 1] range, got -0.1\n"
+        "Ui::AbstractRenderer::setDrawDepth(): expected a value in the [0, 1] range, got 1.1\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractRendererTest::drawDepthNotSupported() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override { return {}; }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+    renderer.transition(RendererTargetState::Draw, {});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.setDrawDepth(0.5f);
+    CORRADE_COMPARE(out, "Ui::AbstractRenderer::setDrawDepth(): depth buffer not supported\n");
+}
+
+void AbstractRendererTest::drawDepthNotImplemented() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::DepthBuffer;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::DepthTest);
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.setDrawDepth(0.5f);
+    CORRADE_COMPARE(out, "Ui::AbstractRenderer::setDrawDepth(): feature advertised but not implemented\n");
+}
+
+void AbstractRendererTest::drawCache() {
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::DrawCache;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {
+            /* Transitions while rendering a cache see it as current */
+            arrayAppend(called, InPlaceInit, Utility::format("transition({})", Int(currentCache())));
+        }
+        void doBeginCache(UnsignedInt id, const Range2Di& rect) override {
+            /* The cache is already current at this point */
+            CORRADE_COMPARE(currentCache(), id);
+            arrayAppend(called, InPlaceInit, Utility::format("beginCache({}, {{{}, {}}}, {{{}, {}}})", id, rect.min().x(), rect.min().y(), rect.max().x(), rect.max().y()));
+        }
+        void doEndCache(UnsignedInt id) override {
+            /* And not anymore here */
+            CORRADE_COMPARE(currentCache(), ~UnsignedInt{});
+            arrayAppend(called, InPlaceInit, Utility::format("endCache({})", id));
+        }
+        void doDrawCache(UnsignedInt id) override {
+            arrayAppend(called, InPlaceInit, Utility::format("drawCache({})", id));
+        }
+        void doDiscardCache(UnsignedInt id) override {
+            arrayAppend(called, InPlaceInit, Utility::format("discardCache({})", id));
+        }
+
+        Containers::Array<Containers::String> called;
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+    CORRADE_COMPARE(renderer.currentCache(), ~UnsignedInt{});
+
+    /* Discarding is allowed in any state */
+    renderer.discardCache(3);
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.beginCache(7, {{2, 3}, {15, 37}});
+    CORRADE_COMPARE(renderer.currentCache(), 7);
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::Blending);
+    /* Discarding a cache that isn't being rendered is fine */
+    renderer.discardCache(3);
+    renderer.endCache();
+    CORRADE_COMPARE(renderer.currentCache(), ~UnsignedInt{});
+    renderer.drawCache(7);
+    renderer.transition(RendererTargetState::Final, {});
+    CORRADE_COMPARE_AS(renderer.called, Containers::arrayView<Containers::String>({
+        "discardCache(3)",
+        "transition(-1)",
+        "beginCache(7, {2, 3}, {15, 37})",
+        "transition(7)",
+        "discardCache(3)",
+        "endCache(7)",
+        "drawCache(7)",
+        "transition(-1)",
+    }), TestSuite::Compare::Container);
+}
+
+void AbstractRendererTest::drawCacheInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::DrawCache;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+        void doBeginCache(UnsignedInt, const Range2Di&) override {}
+        void doEndCache(UnsignedInt) override {}
+        void doDrawCache(UnsignedInt) override {}
+        void doDiscardCache(UnsignedInt) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.beginCache(3, {{}, {15, 37}});
+    renderer.drawCache(3);
+    renderer.endCache();
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.beginCache(3, {{-1, 3}, {5, 7}});
+    renderer.beginCache(3, {{1, 3}, {16, 7}});
+    renderer.beginCache(3, {{5, 3}, {4, 7}});
+    renderer.beginCache(3, {{}, {15, 37}});
+    renderer.beginCache(4, {{}, {15, 37}});
+    renderer.drawCache(2);
+    renderer.discardCache(3);
+    renderer.transition(RendererTargetState::Composite, {});
+    renderer.transition(RendererTargetState::Final, {});
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractRenderer::beginCache(): not allowed to be called in Ui::RendererTargetState::Initial\n"
+        "Ui::AbstractRenderer::drawCache(): not allowed to be called in Ui::RendererTargetState::Initial\n"
+        "Ui::AbstractRenderer::endCache(): no cache is being rendered\n"
+        "Ui::AbstractRenderer::beginCache(): {{-1, 3}, {5, 7}} out of range for a framebuffer of size {15, 37}\n"
+        "Ui::AbstractRenderer::beginCache(): {{1, 3}, {16, 7}} out of range for a framebuffer of size {15, 37}\n"
+        "Ui::AbstractRenderer::beginCache(): {{5, 3}, {4, 7}} out of range for a framebuffer of size {15, 37}\n"
+        "Ui::AbstractRenderer::beginCache(): cache 3 is already being rendered\n"
+        "Ui::AbstractRenderer::drawCache(): not allowed to be called while rendering cache 3\n"
+        "Ui::AbstractRenderer::discardCache(): cache 3 is being rendered\n"
+        "Ui::AbstractRenderer::transition(): transition to Ui::RendererTargetState::Composite not allowed while rendering cache 3\n"
+        "Ui::AbstractRenderer::transition(): transition to Ui::RendererTargetState::Final not allowed while rendering cache 3\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractRendererTest::drawCacheNotSupported() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override { return {}; }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+    renderer.transition(RendererTargetState::Draw, {});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.beginCache(3, {{}, {15, 37}});
+    renderer.drawCache(3);
+    renderer.discardCache(3);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractRenderer::beginCache(): draw cache not supported\n"
+        "Ui::AbstractRenderer::drawCache(): draw cache not supported\n"
+        "Ui::AbstractRenderer::discardCache(): draw cache not supported\n",
+        TestSuite::Compare::String);
+}
+
+void AbstractRendererTest::drawCacheNotImplemented() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractRenderer {
+        RendererFeatures doFeatures() const override {
+            return RendererFeature::DrawCache;
+        }
+        void doSetupFramebuffers(const Vector2i&) override {}
+        void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+    } renderer;
+
+    renderer.setupFramebuffers({15, 37});
+    renderer.transition(RendererTargetState::Draw, {});
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.beginCache(3, {{}, {15, 37}});
+    renderer.endCache();
+    renderer.drawCache(3);
+    renderer.discardCache(3);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractRenderer::beginCache(): feature advertised but not implemented\n"
+        "Ui::AbstractRenderer::endCache(): feature advertised but not implemented\n"
+        "Ui::AbstractRenderer::drawCache(): feature advertised but not implemented\n"
+        "Ui::AbstractRenderer::discardCache(): feature advertised but not implemented\n",
+        TestSuite::Compare::String);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::AbstractRendererTest)
@@ -72,6 +72,8 @@ struct AbstractStyleTest: TestSuite::Tester {
     void textLayerGlyphCacheSizeFeaturesNotSupported();
     void setTextLayerDynamicStyleCount();
     void setTextLayerGlyphCacheSize();
+    void textLayerFlags();
+    void textLayerFlagsInvalid();
 
     void apply();
     void applyNoSizeSet();
@@ -88,6 +90,10 @@ struct AbstractStyleTest: TestSuite::Tester {
     void applyEventLayerNotPresent();
     void applySnapLayouterNotPresent();
 
+    void applyUniforms();
+    void applyUniformsNotImplemented();
+    void applyUniformsInvalid();
+
     private:
         PluginManager::Manager<Trade::AbstractImporter> _importerManager;
         PluginManager::Manager<Text::AbstractFont> _fontManager;
@@ -146,7 +152,9 @@ AbstractStyleTest::AbstractStyleTest() {
               &AbstractStyleTest::textLayerGlyphCacheSizeNoTextFeature,
               &AbstractStyleTest::textLayerGlyphCacheSizeFeaturesNotSupported,
               &AbstractStyleTest::setTextLayerDynamicStyleCount,
-              &AbstractStyleTest::setTextLayerGlyphCacheSize});
+              &AbstractStyleTest::setTextLayerGlyphCacheSize,
+              &AbstractStyleTest::textLayerFlags,
+              &AbstractStyleTest::textLayerFlagsInvalid});
 
     addInstancedTests({&AbstractStyleTest::apply},
         Containers::arraySize(ApplyData));
@@ -164,6 +172,10 @@ AbstractStyleTest::AbstractStyleTest() {
               &AbstractStyleTest::applyTextLayerImagesNoImporterManager,
               &AbstractStyleTest::applyEventLayerNotPresent,
               &AbstractStyleTest::applySnapLayouterNotPresent});
+
+    addTests({&AbstractStyleTest::applyUniforms,
+              &AbstractStyleTest::applyUniformsNotImplemented,
+              &AbstractStyleTest::applyUniformsInvalid});
 }
 
 void AbstractStyleTest::debugFeature() {
@@ -432,6 +444,10 @@ void AbstractStyleTest::baseLayerFlags() {
     CORRADE_COMPARE(styleNoRoundedCorners.baseLayerFlags(), BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::NoRoundedCorners);
     CORRADE_COMPARE(styleNeither.baseLayerFlags(), BaseLayerSharedFlag::NoRoundedCorners);
 
+    /* Shader clipping can be added as well */
+    styleNeither.setBaseLayerFlags(BaseLayerSharedFlag::ShaderClipping, {});
+    CORRADE_COMPARE(styleNeither.baseLayerFlags(), BaseLayerSharedFlag::ShaderClipping|BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners);
+
     /* Adding no flags returns to the previous state */
     styleNeither.setBaseLayerFlags({}, {});
     styleNoRoundedCorners.setBaseLayerFlags({}, {});
@@ -685,6 +701,57 @@ void AbstractStyleTest::setTextLayerGlyphCacheSize() {
     CORRADE_COMPARE(style.textLayerGlyphCachePadding(), (Vector2i{4, 2}));
 }
 
+void AbstractStyleTest::textLayerFlags() {
+    struct: AbstractStyle {
+        StyleFeatures doFeatures() const override {
+            return StyleFeature::TextLayer;
+        }
+        bool doApply(UserInterface&, StyleFeatures, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*) const override { return {}; }
+    } style;
+
+    /* Empty by default */
+    CORRADE_COMPARE(style.textLayerFlags(), TextLayerSharedFlags{});
+
+    style.setTextLayerFlags(TextLayerSharedFlag::GlyphCacheFillDeferred);
+    CORRADE_COMPARE(style.textLayerFlags(), TextLayerSharedFlag::GlyphCacheFillDeferred);
+
+    /* Setting new flags replaces the previous */
+    style.setTextLayerFlags(TextLayerSharedFlag::GlyphCacheFillOnDemand);
+    CORRADE_COMPARE(style.textLayerFlags(), TextLayerSharedFlag::GlyphCacheFillOnDemand);
+
+    style.setTextLayerFlags(TextLayerSharedFlag::GlyphCacheFillOnDemand|TextLayerSharedFlag::ShaderClipping);
+    CORRADE_COMPARE(style.textLayerFlags(), TextLayerSharedFlag::GlyphCacheFillOnDemand|TextLayerSharedFlag::ShaderClipping);
+
+    style.setTextLayerFlags({});
+    CORRADE_COMPARE(style.textLayerFlags(), TextLayerSharedFlags{});
+}
+
+void AbstractStyleTest::textLayerFlagsInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct Style: AbstractStyle {
+        explicit Style(StyleFeatures features): _features{features} {}
+
+        StyleFeatures doFeatures() const override {
+            return _features;
+        }
+        bool doApply(UserInterface&, StyleFeatures, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*) const override { return {}; }
+
+        private:
+            StyleFeatures _features;
+    } style{StyleFeature::TextLayer},
+      styleNoTextLayer{StyleFeature::BaseLayer|StyleFeature::TextLayerImages};
+
+    Containers::String out;
+    Error redirectError{&out};
+    styleNoTextLayer.textLayerFlags();
+    style.setTextLayerFlags(TextLayerSharedFlag::GlyphCacheFillOnDemand|TextLayerSharedFlag::DistanceField|TextLayerSharedFlag::InstancedGlyphs);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractStyle::textLayerFlags(): feature not supported\n"
+        "Ui::AbstractStyle::setTextLayerFlags(): Ui::TextLayerSharedFlag::DistanceField|Ui::TextLayerSharedFlag::InstancedGlyphs isn't allowed to be added\n",
+        TestSuite::Compare::String);
+}
+
 void AbstractStyleTest::apply() {
     auto&& data = ApplyData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1376,6 +1443,152 @@ void AbstractStyleTest::applySnapLayouterNotPresent() {
     CORRADE_COMPARE(out, "Ui::AbstractStyle::apply(): snap layouter not present in the user interface\n");
 }
 
+void AbstractStyleTest::applyUniforms() {
+    struct LayerSharedBase: BaseLayer::Shared {
+        explicit LayerSharedBase(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } sharedBase{BaseLayer::Shared::Configuration{3, 5}
+        .setDynamicStyleCount(11)
+    };
+
+    struct LayerBase: BaseLayer {
+        explicit LayerBase(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+    };
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32}};
+
+    struct LayerSharedText: TextLayer::Shared {
+        explicit LayerSharedText(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } sharedText{cache, TextLayer::Shared::Configuration{2, 4}
+        .setEditingStyleCount(6, 7)
+        .setDynamicStyleCount(9)
+    };
+
+    struct LayerText: TextLayer {
+        explicit LayerText(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    };
+
+    struct Interface: UserInterface {
+        explicit Interface(NoCreateT): UserInterface{NoCreate} {}
+    } ui{NoCreate};
+    ui.setSize({200, 300})
+      .setBaseLayerInstance(Containers::pointer<LayerBase>(ui.createLayer(), sharedBase))
+      .setTextLayerInstance(Containers::pointer<LayerText>(ui.createLayer(), sharedText));
+
+    Int applyUniformsCalled = 0;
+    struct Style: AbstractStyle {
+        Style(Int& applyUniformsCalled): _applyUniformsCalled(applyUniformsCalled) {}
+
+        StyleFeatures doFeatures() const override {
+            return StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::EventLayer;
+        }
+        UnsignedInt doBaseLayerStyleUniformCount() const override { return 3; }
+        UnsignedInt doBaseLayerStyleCount() const override { return 5; }
+        UnsignedInt doBaseLayerDynamicStyleCount() const override { return 11; }
+        UnsignedInt doTextLayerStyleUniformCount() const override { return 2; }
+        UnsignedInt doTextLayerStyleCount() const override { return 4; }
+        UnsignedInt doTextLayerEditingStyleUniformCount() const override { return 6; }
+        UnsignedInt doTextLayerEditingStyleCount() const override { return 7; }
+        UnsignedInt doTextLayerDynamicStyleCount() const override { return 9; }
+        bool doApply(UserInterface&, StyleFeatures, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*) const override {
+            CORRADE_FAIL("This shouldn't get called.");
+            return {};
+        }
+        bool doApplyUniforms(UserInterface&, StyleFeatures features) const override {
+            CORRADE_COMPARE(features, StyleFeature::BaseLayer|StyleFeature::TextLayer);
+            ++_applyUniformsCalled;
+            return true;
+        }
+
+        Int& _applyUniformsCalled;
+    } style{applyUniformsCalled};
+
+    CORRADE_VERIFY(style.applyUniforms(ui, StyleFeature::BaseLayer|StyleFeature::TextLayer));
+    CORRADE_COMPARE(applyUniformsCalled, 1);
+}
+
+void AbstractStyleTest::applyUniformsNotImplemented() {
+    struct Interface: UserInterface {
+        explicit Interface(NoCreateT): UserInterface{NoCreate} {}
+    } ui{NoCreate};
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{3, 5}};
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+    };
+
+    ui.setSize({200, 300})
+      .setBaseLayerInstance(Containers::pointer<Layer>(ui.createLayer(), shared));
+
+    struct: AbstractStyle {
+        StyleFeatures doFeatures() const override { return StyleFeature::BaseLayer; }
+        UnsignedInt doBaseLayerStyleUniformCount() const override { return 3; }
+        UnsignedInt doBaseLayerStyleCount() const override { return 5; }
+        bool doApply(UserInterface&, StyleFeatures, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*) const override {
+            CORRADE_FAIL("This shouldn't get called.");
+            return {};
+        }
+    } style;
+
+    /* The default implementation returns false to signal that a full apply()
+       is needed */
+    CORRADE_VERIFY(!style.applyUniforms(ui, StyleFeature::BaseLayer));
+}
+
+void AbstractStyleTest::applyUniformsInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct Interface: UserInterface {
+        explicit Interface(NoCreateT): UserInterface{NoCreate} {}
+    } ui{NoCreate};
+
+    struct: AbstractStyle {
+        StyleFeatures doFeatures() const override {
+            return StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::EventLayer;
+        }
+        bool doApply(UserInterface&, StyleFeatures, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*) const override {
+            CORRADE_FAIL("This shouldn't get called.");
+            return {};
+        }
+        bool doApplyUniforms(UserInterface&, StyleFeatures) const override {
+            CORRADE_FAIL("This shouldn't get called.");
+            return {};
+        }
+    } style;
+
+    /* Capture correct function name */
+    CORRADE_VERIFY(true);
+
+    Containers::String out;
+    Error redirectError{&out};
+    style.applyUniforms(ui, {});
+    style.applyUniforms(ui, StyleFeature::BaseLayer|StyleFeature::SnapLayouter);
+    style.applyUniforms(ui, StyleFeature::TextLayer|StyleFeature::EventLayer);
+    style.applyUniforms(ui, StyleFeature::BaseLayer);
+    style.applyUniforms(ui, StyleFeature::TextLayer);
+    CORRADE_COMPARE_AS(out,
+        "Ui::AbstractStyle::applyUniforms(): no features specified\n"
+        "Ui::AbstractStyle::applyUniforms(): Ui::StyleFeature::BaseLayer|Ui::StyleFeature::SnapLayouter not a subset of supported Ui::StyleFeature::BaseLayer|Ui::StyleFeature::TextLayer|Ui::StyleFeature::EventLayer\n"
+        "Ui::AbstractStyle::applyUniforms(): Ui::StyleFeature::TextLayer|Ui::StyleFeature::EventLayer not a subset of Ui::StyleFeature::BaseLayer|Ui::StyleFeature::TextLayer\n"
+        "Ui::AbstractStyle::applyUniforms(): base layer not present in the user interface\n"
+        "Ui::AbstractStyle::applyUniforms(): text layer not present in the user interface\n",
+        TestSuite::Compare::String);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::AbstractStyleTest)
@@ -0,0 +1,471 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Magnum/Math/Time.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractAnimator.h"
+#include "Magnum/Ui/AbstractLayer.h"
+#include "Magnum/Ui/AbstractLayouter.h"
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Event.h"
+#include "Magnum/Ui/EventLayer.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/NodeFlags.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct AbstractUserInterfaceBenchmark: TestSuite::Tester {
+    explicit AbstractUserInterfaceBenchmark();
+
+    void updateNodeOrder();
+    void updateNodeOffset();
+    void updateNodeFlags();
+    void updateLayout();
+    void updateDataAttachment();
+    void cleanRemovedNode();
+    void advanceAnimations();
+
+    void eventReplay();
+};
+
+using namespace Math::Literals;
+
+/* Each top-level node has 16 children, each with 16 children again, so 273
+   nodes per top-level node. All of them are in the UI area so none of them
+   get culled. */
+constexpr UnsignedInt UpdateBenchmarkChildCount = 16;
+
+const struct {
+    const char* name;
+    UnsignedInt rootCount;
+} NodeCountData[]{
+    {"1k nodes", 4},
+    {"10k nodes", 37},
+    {"100k nodes", 366},
+};
+
+/* A compact recorded event, a trace is a sequence of these replayed in order.
+   Pointer events are always from the primary mouse pointer, the move events
+   have the left button pressed if `pressed` is set. */
+enum class ReplayEventType: UnsignedByte {
+    PointerMove,
+    PointerPress,
+    PointerRelease,
+    Scroll,
+    KeyPress,
+    KeyRelease
+};
+
+struct ReplayEvent {
+    ReplayEventType type;
+    bool pressed;
+    Nanoseconds time;
+    /* Global pointer position, unused for key events. Scroll events always
+       scroll by one unit down. */
+    Vector2 position;
+};
+
+/* 32x32 buttons, each 32x32 units, in 32 rows, filling the whole UI */
+constexpr UnsignedInt ReplayBenchmarkGridSize = 32;
+constexpr Float ReplayBenchmarkCellSize = 32.0f;
+constexpr UnsignedInt ReplayBenchmarkEventCount = 4096;
+
+const struct {
+    const char* name;
+    /* Every Nth event in the trace after a move is a press followed by a
+       sequence of drag moves and a release, 0 means no presses */
+    UnsignedInt pressEvery;
+    /* Every Nth event is a scroll, 0 means no scroll events */
+    UnsignedInt scrollEvery;
+    /* Every Nth event is a key press + release, 0 means no key events */
+    UnsignedInt keyEvery;
+} EventReplayData[]{
+    {"pointer move", 0, 0, 0},
+    {"pointer move, press, drag, release", 16, 0, 0},
+    {"pointer move, scroll", 0, 4, 0},
+    {"pointer move, key press, release", 0, 0, 4},
+    {"mixed", 32, 8, 16},
+};
+
+AbstractUserInterfaceBenchmark::AbstractUserInterfaceBenchmark() {
+    addInstancedBenchmarks({&AbstractUserInterfaceBenchmark::updateNodeOrder,
+                            &AbstractUserInterfaceBenchmark::updateNodeOffset,
+                            &AbstractUserInterfaceBenchmark::updateNodeFlags,
+                            &AbstractUserInterfaceBenchmark::updateLayout,
+                            &AbstractUserInterfaceBenchmark::updateDataAttachment,
+                            &AbstractUserInterfaceBenchmark::cleanRemovedNode,
+                            &AbstractUserInterfaceBenchmark::advanceAnimations}, 10,
+        Containers::arraySize(NodeCountData));
+
+    addInstancedBenchmarks({&AbstractUserInterfaceBenchmark::eventReplay}, 10,
+        Containers::arraySize(EventReplayData));
+}
+
+/* Returns all created nodes, the first being the first top-level node */
+Containers::Array<NodeHandle> populate(AbstractUserInterface& ui, UnsignedInt rootCount) {
+    Containers::Array<NodeHandle> out;
+    arrayReserve(out, rootCount*(1 + UpdateBenchmarkChildCount*(1 + UpdateBenchmarkChildCount)));
+    for(UnsignedInt i = 0; i != rootCount; ++i) {
+        const NodeHandle root = ui.createNode({Float(i), 0.0f}, {1.0f, 1.0f});
+        arrayAppend(out, root);
+        for(UnsignedInt j = 0; j != UpdateBenchmarkChildCount; ++j) {
+            const NodeHandle child = ui.createNode(root, {}, {1.0f, 1.0f});
+            arrayAppend(out, child);
+            for(UnsignedInt k = 0; k != UpdateBenchmarkChildCount; ++k)
+                arrayAppend(out, ui.createNode(child, {}, {1.0f, 1.0f}));
+        }
+    }
+
+    return out;
+}
+
+void AbstractUserInterfaceBenchmark::updateNodeOrder() {
+    auto&& data = NodeCountData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side node hierarchy ordering, visibility and offset
+       calculation done on a full node order update. No layers or layouters
+       are present so it's just the node processing itself. */
+
+    AbstractUserInterface ui{{Int(data.rootCount), 1}};
+    const NodeHandle first = populate(ui, data.rootCount)[0];
+
+    /* Initial update to have all allocations done outside of the benchmark
+       loop */
+    ui.update();
+
+    /* Reordering a top-level node causes the whole hierarchy to be ordered
+       again */
+    CORRADE_BENCHMARK(10) {
+        ui.clearNodeOrder(first);
+        ui.setNodeOrder(first, NodeHandle::Null);
+        ui.update();
+    }
+}
+
+void AbstractUserInterfaceBenchmark::updateNodeOffset() {
+    auto&& data = NodeCountData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side layout and absolute offset calculation done on a
+       node offset update. Setting offset of a top-level node causes all
+       layouts and offsets to be updated. */
+
+    AbstractUserInterface ui{{Int(data.rootCount), 1}};
+    const NodeHandle first = populate(ui, data.rootCount)[0];
+
+    /* Initial update to have all allocations done outside of the benchmark
+       loop */
+    ui.update();
+
+    Float offset = 0.0f;
+    CORRADE_BENCHMARK(10) {
+        ui.setNodeOffset(first, {offset += 1.0f, 0.0f});
+        ui.update();
+    }
+}
+
+void AbstractUserInterfaceBenchmark::updateNodeFlags() {
+    auto&& data = NodeCountData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side update done on a node flag change. Toggling
+       NodeFlag::Disabled on a top-level node causes the enabled state to be
+       propagated through the whole hierarchy again. */
+
+    AbstractUserInterface ui{{Int(data.rootCount), 1}};
+    const NodeHandle first = populate(ui, data.rootCount)[0];
+
+    /* Initial update to have all allocations done outside of the benchmark
+       loop */
+    ui.update();
+
+    bool disabled = false;
+    CORRADE_BENCHMARK(10) {
+        if((disabled = !disabled))
+            ui.addNodeFlags(first, NodeFlag::Disabled);
+        else
+            ui.clearNodeFlags(first, NodeFlag::Disabled);
+        ui.update();
+    }
+}
+
+void AbstractUserInterfaceBenchmark::updateLayout() {
+    auto&& data = NodeCountData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side layout update done when a layouter requests it,
+       with a layout assigned to every node. The layouter doesn't do anything
+       so it's just the layout ordering and dispatch. */
+
+    struct Layouter: AbstractLayouter {
+        using AbstractLayouter::AbstractLayouter;
+        using AbstractLayouter::add;
+
+        void doUpdate(Containers::BitArrayView, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const NodeHandle>&, const Containers::StridedArrayView1D<Vector2>&, const  Containers::StridedArrayView1D<Vector2>&) override {}
+    };
+
+    AbstractUserInterface ui{{Int(data.rootCount), 1}};
+    Layouter& layouter = ui.setLayouterInstance(Containers::pointer<Layouter>(ui.createLayouter()));
+    for(const NodeHandle node: populate(ui, data.rootCount))
+        layouter.add(node);
+
+    /* Initial update to have all allocations done outside of the benchmark
+       loop */
+    ui.update();
+
+    CORRADE_BENCHMARK(10) {
+        layouter.setNeedsUpdate();
+        ui.update();
+    }
+}
+
+void AbstractUserInterfaceBenchmark::updateDataAttachment() {
+    auto&& data = NodeCountData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side update done on a data attachment change, with
+       one data attached to every node. Reattaching a single data causes the
+       visible data to be collected and ordered for the layer again. */
+
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    };
+
+    AbstractUserInterface ui{{Int(data.rootCount), 1}};
+    Layer& layer = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer()));
+    const Containers::Array<NodeHandle> nodes = populate(ui, data.rootCount);
+    for(const NodeHandle node: nodes)
+        layer.create(node);
+    const DataHandle reattached = layer.create(nodes[0]);
+
+    /* Initial update to have all allocations done outside of the benchmark
+       loop */
+    ui.update();
+
+    std::size_t i = 0;
+    CORRADE_BENCHMARK(10) {
+        ui.attachData(nodes[++i % nodes.size()], reattached);
+        ui.update();
+    }
+}
+
+void AbstractUserInterfaceBenchmark::cleanRemovedNode() {
+    auto&& data = NodeCountData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side orphan removal done in clean() after a top-level
+       node is removed, with a data and a layout attached to every node so
+       the layers and layouters get cleaned as well. The UI is populated
+       again for every benchmark run, so there's just one iteration. */
+
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    };
+    struct Layouter: AbstractLayouter {
+        using AbstractLayouter::AbstractLayouter;
+        using AbstractLayouter::add;
+
+        void doUpdate(Containers::BitArrayView, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const NodeHandle>&, const Containers::StridedArrayView1D<Vector2>&, const  Containers::StridedArrayView1D<Vector2>&) override {}
+    };
+
+    AbstractUserInterface ui{{Int(data.rootCount), 1}};
+    Layer& layer = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer()));
+    Layouter& layouter = ui.setLayouterInstance(Containers::pointer<Layouter>(ui.createLayouter()));
+    const Containers::Array<NodeHandle> nodes = populate(ui, data.rootCount);
+    for(const NodeHandle node: nodes) {
+        layer.create(node);
+        layouter.add(node);
+    }
+
+    /* Initial update to have all allocations done outside of the benchmark
+       loop */
+    ui.update();
+
+    CORRADE_BENCHMARK(1) {
+        ui.removeNode(nodes[0]);
+        ui.clean();
+    }
+
+    CORRADE_COMPARE(ui.nodeUsedCount(), nodes.size() - 1 - UpdateBenchmarkChildCount*(1 + UpdateBenchmarkChildCount));
+}
+
+void AbstractUserInterfaceBenchmark::advanceAnimations() {
+    auto&& data = NodeCountData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side animation advance, with one repeating animation
+       for each node. The animator doesn't do anything so it's just the
+       animation state and factor calculation and dispatch. */
+
+    struct Animator: AbstractGenericAnimator {
+        using AbstractGenericAnimator::AbstractGenericAnimator;
+        using AbstractGenericAnimator::create;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+        void doAdvance(Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&) override {}
+    };
+
+    AbstractUserInterface ui{{Int(data.rootCount), 1}};
+    Animator& animator = ui.setGenericAnimatorInstance(Containers::pointer<Animator>(ui.createAnimator()));
+    const std::size_t nodeCount = populate(ui, data.rootCount).size();
+    for(std::size_t i = 0; i != nodeCount; ++i)
+        animator.create(0_nsec, 1.0_sec, 0);
+
+    /* Initial advance to have all allocations done outside of the benchmark
+       loop */
+    Nanoseconds time = 0_nsec;
+    ui.advanceAnimations(time);
+
+    CORRADE_BENCHMARK(10) {
+        ui.advanceAnimations(time += 16.0_msec);
+    }
+
+    CORRADE_VERIFY(ui.state() & UserInterfaceState::NeedsAnimationAdvance);
+}
+
+Containers::Array<ReplayEvent> synthesizeTrace(UnsignedInt pressEvery, UnsignedInt scrollEvery, UnsignedInt keyEvery) {
+    Containers::Array<ReplayEvent> out;
+    arrayReserve(out, ReplayBenchmarkEventCount);
+
+    /* A zig-zag path over the whole grid, going over a few cells with each
+       event so enter and leave events get fired a lot */
+    const Float size = ReplayBenchmarkGridSize*ReplayBenchmarkCellSize;
+    bool pressed = false;
+    for(UnsignedInt i = 0; out.size() < ReplayBenchmarkEventCount; ++i) {
+        const Nanoseconds time{Long(i)*1000000};
+        const Float x = Float((i*37) % UnsignedInt(size)) + 0.5f;
+        const Float y = Float((i*37/UnsignedInt(size)*13) % UnsignedInt(size)) + 0.5f;
+
+        arrayAppend(out, ReplayEvent{ReplayEventType::PointerMove, pressed, time, Vector2{x, y}});
+
+        if(pressEvery && i % pressEvery == 0) {
+            arrayAppend(out, ReplayEvent{ReplayEventType::PointerPress, false, time, Vector2{x, y}});
+            pressed = true;
+        } else if(pressEvery && pressed && i % pressEvery == pressEvery/2) {
+            arrayAppend(out, ReplayEvent{ReplayEventType::PointerRelease, false, time, Vector2{x, y}});
+            pressed = false;
+        }
+
+        if(scrollEvery && i % scrollEvery == 0)
+            arrayAppend(out, ReplayEvent{ReplayEventType::Scroll, false, time, Vector2{x, y}});
+
+        if(keyEvery && i % keyEvery == 0) {
+            arrayAppend(out, ReplayEvent{ReplayEventType::KeyPress, false, time, Vector2{}});
+            arrayAppend(out, ReplayEvent{ReplayEventType::KeyRelease, false, time, Vector2{}});
+        }
+    }
+
+    return out;
+}
+
+bool replay(AbstractUserInterface& ui, const ReplayEvent& e) {
+    switch(e.type) {
+        case ReplayEventType::PointerMove: {
+            PointerMoveEvent event{e.time, PointerEventSource::Mouse, {}, e.pressed ? Pointers{Pointer::MouseLeft} : Pointers{}, true, 0};
+            return ui.pointerMoveEvent(e.position, event);
+        }
+        case ReplayEventType::PointerPress: {
+            PointerEvent event{e.time, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+            return ui.pointerPressEvent(e.position, event);
+        }
+        case ReplayEventType::PointerRelease: {
+            PointerEvent event{e.time, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+            return ui.pointerReleaseEvent(e.position, event);
+        }
+        case ReplayEventType::Scroll: {
+            ScrollEvent event{e.time, {0.0f, -1.0f}};
+            return ui.scrollEvent(e.position, event);
+        }
+        case ReplayEventType::KeyPress: {
+            KeyEvent event{e.time, Key::Tab, {}};
+            return ui.keyPressEvent(event);
+        }
+        case ReplayEventType::KeyRelease: {
+            KeyEvent event{e.time, Key::Tab, {}};
+            return ui.keyReleaseEvent(event);
+        }
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+void AbstractUserInterfaceBenchmark::eventReplay() {
+    auto&& data = EventReplayData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side event dispatch for a recorded trace of events,
+       including the hit testing, hover, press and capture tracking and
+       calling into the event layer. Each button reacts to taps, drags and
+       scroll. */
+
+    const Float size = ReplayBenchmarkGridSize*ReplayBenchmarkCellSize;
+    AbstractUserInterface ui{{Int(size), Int(size)}};
+    EventLayer& layer = ui.setLayerInstance(Containers::pointer<EventLayer>(ui.createLayer()));
+
+    UnsignedInt called = 0;
+    for(UnsignedInt i = 0; i != ReplayBenchmarkGridSize; ++i) {
+        const NodeHandle row = ui.createNode({0.0f, i*ReplayBenchmarkCellSize}, {size, ReplayBenchmarkCellSize});
+        for(UnsignedInt j = 0; j != ReplayBenchmarkGridSize; ++j) {
+            const NodeHandle button = ui.createNode(row, {j*ReplayBenchmarkCellSize, 0.0f}, {ReplayBenchmarkCellSize, ReplayBenchmarkCellSize});
+            layer.onTapOrClick(button, [&called]{ ++called; });
+            layer.onDrag(button, [&called](const Vector2&) { ++called; });
+            layer.onScroll(button, [&called](const Vector2&) { ++called; });
+        }
+    }
+
+    const Containers::Array<ReplayEvent> trace = synthesizeTrace(data.pressEvery, data.scrollEvery, data.keyEvery);
+
+    /* Initial update and replay to have all allocations done outside of the
+       benchmark loop */
+    ui.update();
+    for(const ReplayEvent& e: trace)
+        replay(ui, e);
+
+    CORRADE_BENCHMARK(1) {
+        for(const ReplayEvent& e: trace)
+            replay(ui, e);
+    }
+
+    /* Just to verify the events actually went somewhere */
+    if(data.pressEvery || data.scrollEvery)
+        CORRADE_VERIFY(called);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::AbstractUserInterfaceBenchmark)
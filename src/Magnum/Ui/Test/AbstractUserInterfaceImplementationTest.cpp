@@ -31,11 +31,14 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
-#include <Magnum/Math/Vector2.h>
+#include <Magnum/Math/Range.h>
 
 #include "Magnum/Ui/AbstractLayer.h" /* LayerFeatures */
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/Implementation/abstractUserInterface.h"
+#include "Magnum/Ui/Implementation/dirtyRanges.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
+#include "Magnum/Ui/Implementation/frameArena.h"
 #include "Magnum/Ui/Implementation/orderNodesBreadthFirstInto.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
@@ -48,6 +51,7 @@ struct AbstractUserInterfaceImplementationTest: TestSuite::Tester {
     void orderVisibleNodesDepthFirst();
     void orderVisibleNodesDepthFirstSingleBranch();
     void orderVisibleNodesDepthFirstNoTopLevelNodes();
+    void orderVisibleNodesDepthFirstIncremental();
 
     void visibleTopLevelNodeIndices();
 
@@ -63,6 +67,11 @@ struct AbstractUserInterfaceImplementationTest: TestSuite::Tester {
     void fillLayoutUpdateMasks();
     void fillLayoutUpdateMasksNoLayouters();
 
+    void markDirtyLayoutNodes();
+    void filterLayoutUpdateMask();
+
+    void visibleSubtreeRects();
+
     void cullVisibleNodesClipRects();
     void cullVisibleNodesEdges();
     void cullVisibleNodes();
@@ -72,12 +81,25 @@ struct AbstractUserInterfaceImplementationTest: TestSuite::Tester {
     void orderVisibleNodeDataNoTopLevelNodes();
 
     void countOrderNodeDataForEventHandling();
+    void visibleSubtreeEventDataOffsets();
+    void buildHitTestGrids();
 
     void compactDraws();
+    void mergeableDrawOrder();
+    void mergeableDrawOrderComposite();
+    void mergeDraws();
 
     void compositeRectsEdges();
     void compositingRects();
 
+    void redrawRect();
+    void redrawRectOrderChanged();
+    void redrawDataRect();
+
+    void cachedDraws();
+    void cachedDrawsEmpty();
+    void invalidateChangedCaches();
+
     void partitionedAnimatorsInsert();
     void partitionedAnimatorsInsertNoLayers();
     void partitionedAnimatorsRemove();
@@ -86,6 +108,16 @@ struct AbstractUserInterfaceImplementationTest: TestSuite::Tester {
     void partitionedAnimatorsGetNoLayers();
     void partitionedAnimatorsCreateLayer();
     void partitionedAnimatorsRemoveLayer();
+
+    void frameArena();
+    void frameArenaRelease();
+
+    void forEachSetBit();
+    void forEachSetBitOffset();
+    void firstUnsetBit();
+
+    void dirtyRanges();
+    void dirtyRangesOverflow();
 };
 
 const struct {
@@ -318,6 +350,62 @@ const struct {
             {{4.0f, 2.0f}, {1.0f, 1.0f}, 1},
             {{1.0f, 1.0f}, {4.5f, 3.0f}, 1}, /* node 1 is invisible */
         }}},
+    {"nested clip rect same as parent", {}, {100.0f, 100.0f}, {InPlaceInit, {
+            {2, 4},         /* clips */
+                {3, 0},
+                {0, 1},     /* clips */
+                    {4, 0},
+                {1, 0},
+        }}, {InPlaceInit, {
+            /*  1 2   3 4   5 6   7 8
+              1 +-------------------+
+              2 | +---+ +---+ +---+ |
+                | | 3 | | 4 | | 1 | |
+              3 | +---+ +---+ +---+ |
+              4 +-------------------+ */
+            {{1.0f, 1.0f}, {7.0f, 3.0f}, NodeFlag::Clip}, /* 0 */
+            {{6.0f, 2.0f}, {1.0f, 1.0f}, {}},             /* 1 */
+            {{1.0f, 1.0f}, {7.0f, 3.0f}, NodeFlag::Clip}, /* 2 */
+            {{2.0f, 2.0f}, {1.0f, 1.0f}, {}},             /* 3 */
+            {{4.0f, 2.0f}, {1.0f, 1.0f}, {}},             /* 4 */
+        }}, {InPlaceInit, {
+            true, true, true, true, true
+        }}, {InPlaceInit, {
+            /* Node 0 doesn't clip anything extra, so it doesn't split the
+               clip rect of node 2 */
+            {{1.0f, 1.0f}, {7.0f, 3.0f}, 5},
+        }}},
+    {"nested clip rect larger than parent", {}, {100.0f, 100.0f}, {InPlaceInit, {
+            {2, 3},         /* clips */
+                {0, 2},     /* clips */
+                    {3, 1}, /* clips */
+                        {1, 0},
+            {4, 0},         /* clips */
+        }}, {InPlaceInit, {
+            /*  0 1 2   3 4   5   9 10
+             -1 +-------------------+
+              0 | +---------------+ |
+              2 | | +---+         | |
+                | | | 3 | +---+   | |
+              3 | | +---+ | 1 |   | |
+              5 | +-------|---|---+ |
+              6 +---------+---+-----+ */
+            {{0.0f, -1.0f}, {10.0f, 7.0f}, NodeFlag::Clip}, /* 0 */
+            {{4.0f, 2.5f}, {1.0f, 2.5f}, {}},               /* 1 */
+            {{1.0f, 0.0f}, {8.0f, 5.0f}, NodeFlag::Clip},   /* 2 */
+            {{2.0f, 2.0f}, {1.0f, 1.0f}, NodeFlag::Clip},   /* 3 */
+            {{1.0f, 0.0f}, {8.0f, 5.0f}, NodeFlag::Clip},   /* 4 */
+        }}, {InPlaceInit, {
+            true, false, true, true, true
+        }}, {InPlaceInit, {
+            /* Node 2 and node 0, which doesn't clip anything extra */
+            {{1.0f, 0.0f}, {8.0f, 5.0f}, 2},
+            /* Node 3, with node 1 outside of it */
+            {{2.0f, 2.0f}, {1.0f, 1.0f}, 2},
+            /* Node 4 is the same as node 2, but it's a separate top-level
+               node and thus not merged with it */
+            {{1.0f, 0.0f}, {8.0f, 5.0f}, 1},
+        }}},
 };
 
 const struct {
@@ -480,6 +568,7 @@ AbstractUserInterfaceImplementationTest::AbstractUserInterfaceImplementationTest
               &AbstractUserInterfaceImplementationTest::orderVisibleNodesDepthFirst,
               &AbstractUserInterfaceImplementationTest::orderVisibleNodesDepthFirstSingleBranch,
               &AbstractUserInterfaceImplementationTest::orderVisibleNodesDepthFirstNoTopLevelNodes,
+              &AbstractUserInterfaceImplementationTest::orderVisibleNodesDepthFirstIncremental,
 
               &AbstractUserInterfaceImplementationTest::visibleTopLevelNodeIndices,
 
@@ -496,7 +585,12 @@ AbstractUserInterfaceImplementationTest::AbstractUserInterfaceImplementationTest
               &AbstractUserInterfaceImplementationTest::discoverTopLevelLayoutNodesSingleNodeLayoutChain,
 
               &AbstractUserInterfaceImplementationTest::fillLayoutUpdateMasks,
-              &AbstractUserInterfaceImplementationTest::fillLayoutUpdateMasksNoLayouters});
+              &AbstractUserInterfaceImplementationTest::fillLayoutUpdateMasksNoLayouters,
+
+              &AbstractUserInterfaceImplementationTest::markDirtyLayoutNodes,
+              &AbstractUserInterfaceImplementationTest::filterLayoutUpdateMask});
+
+    addTests({&AbstractUserInterfaceImplementationTest::visibleSubtreeRects});
 
     addInstancedTests({&AbstractUserInterfaceImplementationTest::cullVisibleNodesClipRects},
         Containers::arraySize(CullVisibleNodesClipRectsData));
@@ -513,12 +607,25 @@ AbstractUserInterfaceImplementationTest::AbstractUserInterfaceImplementationTest
               &AbstractUserInterfaceImplementationTest::orderVisibleNodeDataNoTopLevelNodes,
 
               &AbstractUserInterfaceImplementationTest::countOrderNodeDataForEventHandling,
+              &AbstractUserInterfaceImplementationTest::visibleSubtreeEventDataOffsets,
+              &AbstractUserInterfaceImplementationTest::buildHitTestGrids,
 
               &AbstractUserInterfaceImplementationTest::compactDraws,
+              &AbstractUserInterfaceImplementationTest::mergeableDrawOrder,
+              &AbstractUserInterfaceImplementationTest::mergeableDrawOrderComposite,
+              &AbstractUserInterfaceImplementationTest::mergeDraws,
 
               &AbstractUserInterfaceImplementationTest::compositeRectsEdges,
               &AbstractUserInterfaceImplementationTest::compositingRects,
 
+              &AbstractUserInterfaceImplementationTest::redrawRect,
+              &AbstractUserInterfaceImplementationTest::redrawRectOrderChanged,
+              &AbstractUserInterfaceImplementationTest::redrawDataRect,
+
+              &AbstractUserInterfaceImplementationTest::cachedDraws,
+              &AbstractUserInterfaceImplementationTest::cachedDrawsEmpty,
+              &AbstractUserInterfaceImplementationTest::invalidateChangedCaches,
+
               &AbstractUserInterfaceImplementationTest::partitionedAnimatorsInsert,
               &AbstractUserInterfaceImplementationTest::partitionedAnimatorsInsertNoLayers,
               &AbstractUserInterfaceImplementationTest::partitionedAnimatorsRemove,
@@ -526,7 +633,17 @@ AbstractUserInterfaceImplementationTest::AbstractUserInterfaceImplementationTest
               &AbstractUserInterfaceImplementationTest::partitionedAnimatorsGet,
               &AbstractUserInterfaceImplementationTest::partitionedAnimatorsGetNoLayers,
               &AbstractUserInterfaceImplementationTest::partitionedAnimatorsCreateLayer,
-              &AbstractUserInterfaceImplementationTest::partitionedAnimatorsRemoveLayer});
+              &AbstractUserInterfaceImplementationTest::partitionedAnimatorsRemoveLayer,
+
+              &AbstractUserInterfaceImplementationTest::frameArena,
+              &AbstractUserInterfaceImplementationTest::frameArenaRelease,
+
+              &AbstractUserInterfaceImplementationTest::forEachSetBit,
+              &AbstractUserInterfaceImplementationTest::forEachSetBitOffset,
+              &AbstractUserInterfaceImplementationTest::firstUnsetBit,
+
+              &AbstractUserInterfaceImplementationTest::dirtyRanges,
+              &AbstractUserInterfaceImplementationTest::dirtyRangesOverflow});
 }
 
 void AbstractUserInterfaceImplementationTest::orderNodesBreadthFirst() {
@@ -797,6 +914,131 @@ void AbstractUserInterfaceImplementationTest::orderVisibleNodesDepthFirstNoTopLe
     CORRADE_COMPARE(count, 0);
 }
 
+void AbstractUserInterfaceImplementationTest::orderVisibleNodesDepthFirstIncremental() {
+    struct Node {
+        NodeHandle parent;
+        UnsignedInt order;
+        NodeFlags flags;
+    } nodes[]{
+        {NodeHandle::Null, 0, {}},                  /* 0 */
+        {nodeHandle(0, 0x1), ~UnsignedInt{}, {}},   /* 1 */
+        {nodeHandle(1, 0x1), ~UnsignedInt{}, {}},   /* 2 */
+        {NodeHandle::Null, 1, {}},                  /* 3 */
+        {nodeHandle(3, 0x1), ~UnsignedInt{}, {}},   /* 4 */
+        /* Top-level node nested under node 1 */
+        {nodeHandle(1, 0x1), 2, {}},                /* 5 */
+    };
+
+    /* The order is 0, 5, 3 with node 0 being first. As the list is cyclic,
+       just changing the first node to 3 changes the order to 3, 0, 5. */
+    const struct NodeOrder {
+        NodeHandle next;
+    } nodeOrder[]{
+        {nodeHandle(5, 0x1)},                       /* 0 */
+        {nodeHandle(0, 0x1)},                       /* 1 */
+        {nodeHandle(3, 0x1)},                       /* 2 */
+    };
+
+    char visibleNodes[1]{};
+    UnsignedInt childrenOffsets[Containers::arraySize(nodes) + 1]{};
+    UnsignedInt children[Containers::arraySize(nodes)];
+    Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt> parentsToProcess[Containers::arraySize(nodes)];
+    Containers::Pair<UnsignedInt, UnsignedInt> out[Containers::arraySize(nodes)];
+    std::size_t count = Implementation::orderVisibleNodesDepthFirstInto(
+        Containers::stridedArrayView(nodes).slice(&Node::parent),
+        Containers::stridedArrayView(nodes).slice(&Node::order),
+        Containers::stridedArrayView(nodes).slice(&Node::flags),
+        Containers::stridedArrayView(nodeOrder).slice(&NodeOrder::next),
+        nodeHandle(0, 0x1),
+        Containers::MutableBitArrayView{visibleNodes, 0, Containers::arraySize(nodes)},
+        childrenOffsets, children, parentsToProcess,
+        Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+        Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second));
+    CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count), (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 2},
+            {1, 1},
+                {2, 0},
+        {5, 0},
+        {3, 1},
+            {4, 0},
+    })), TestSuite::Compare::Container);
+
+    /* Hide node 2 and mark its top-level node 0 as dirty. Hide node 4 as
+       well, but don't mark node 3 as dirty to verify that its previous
+       hierarchy is reused. */
+    nodes[2].flags = NodeFlag::Hidden;
+    nodes[4].flags = NodeFlag::Hidden;
+    char dirtyTopLevelNodes[1]{1 << 0};
+    {
+        Containers::Pair<UnsignedInt, UnsignedInt> previous[Containers::arraySize(nodes)];
+        Utility::copy(Containers::arrayView(out).prefix(count), Containers::arrayView(previous).prefix(count));
+
+        char visibleNodes[1]{};
+        char previousTopLevelNodes[1]{};
+        UnsignedInt previousTopLevelNodeIndices[Containers::arraySize(nodes)];
+        count = Implementation::orderVisibleNodesDepthFirstIncrementalInto(
+            Containers::stridedArrayView(nodes).slice(&Node::parent),
+            Containers::stridedArrayView(nodes).slice(&Node::order),
+            Containers::stridedArrayView(nodes).slice(&Node::flags),
+            Containers::stridedArrayView(nodeOrder).slice(&NodeOrder::next),
+            nodeHandle(3, 0x1),
+            Containers::BitArrayView{dirtyTopLevelNodes, 0, Containers::arraySize(nodes)},
+            childrenOffsets, children,
+            Containers::stridedArrayView(previous).prefix(count).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(previous).prefix(count).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second),
+            Containers::MutableBitArrayView{visibleNodes, 0, Containers::arraySize(nodes)},
+            Containers::MutableBitArrayView{previousTopLevelNodes, 0, Containers::arraySize(nodes)},
+            previousTopLevelNodeIndices, parentsToProcess,
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second));
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count), (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+            /* Copied from the previous state, including node 4 that's
+               actually hidden now */
+            {3, 1},
+                {4, 0},
+            /* Ordered again, without node 2 */
+            {0, 1},
+                {1, 0},
+            /* Copied from the previous state, parent 1 is still visible */
+            {5, 0},
+        })), TestSuite::Compare::Container);
+    }
+
+    /* Hide node 1 and mark node 0 as dirty. Node 5 is nested under it, so it
+       disappears as well even though it isn't marked as dirty. Node 3 is now
+       marked dirty as well, so its hierarchy gets updated for the hidden node
+       4. */
+    nodes[1].flags = NodeFlag::Hidden;
+    dirtyTopLevelNodes[0] = (1 << 0)|(1 << 3);
+    {
+        Containers::Pair<UnsignedInt, UnsignedInt> previous[Containers::arraySize(nodes)];
+        Utility::copy(Containers::arrayView(out).prefix(count), Containers::arrayView(previous).prefix(count));
+
+        char visibleNodes[1]{};
+        char previousTopLevelNodes[1]{};
+        UnsignedInt previousTopLevelNodeIndices[Containers::arraySize(nodes)];
+        count = Implementation::orderVisibleNodesDepthFirstIncrementalInto(
+            Containers::stridedArrayView(nodes).slice(&Node::parent),
+            Containers::stridedArrayView(nodes).slice(&Node::order),
+            Containers::stridedArrayView(nodes).slice(&Node::flags),
+            Containers::stridedArrayView(nodeOrder).slice(&NodeOrder::next),
+            nodeHandle(3, 0x1),
+            Containers::BitArrayView{dirtyTopLevelNodes, 0, Containers::arraySize(nodes)},
+            childrenOffsets, children,
+            Containers::stridedArrayView(previous).prefix(count).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(previous).prefix(count).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second),
+            Containers::MutableBitArrayView{visibleNodes, 0, Containers::arraySize(nodes)},
+            Containers::MutableBitArrayView{previousTopLevelNodes, 0, Containers::arraySize(nodes)},
+            previousTopLevelNodeIndices, parentsToProcess,
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second));
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count), (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+            {3, 0},
+            {0, 0},
+        })), TestSuite::Compare::Container);
+    }
+}
+
 void AbstractUserInterfaceImplementationTest::visibleTopLevelNodeIndices() {
     /* Mostly like the output in the orderVisibleNodesDepthFirst() case */
     UnsignedInt visibleNodeChildrenCounts[]{
@@ -1481,6 +1723,138 @@ void AbstractUserInterfaceImplementationTest::fillLayoutUpdateMasksNoLayouters()
     CORRADE_VERIFY(true);
 }
 
+void AbstractUserInterfaceImplementationTest::markDirtyLayoutNodes() {
+    NodeHandle nodeParents[]{
+        NodeHandle::Null,       /* 0 */
+        nodeHandle(0, 0x1),     /* 1 */
+        NodeHandle::Null,       /* 2 */
+        nodeHandle(2, 0x1),     /* 3 */
+        nodeHandle(3, 0x1),     /* 4 */
+        nodeHandle(1, 0x1),     /* 5 */
+        NodeHandle::Null,       /* 6, not visible */
+        nodeHandle(6, 0x1),     /* 7, not visible */
+        nodeHandle(3, 0x1),     /* 8 */
+    };
+    UnsignedInt visibleNodeIds[]{
+        2, 3, 4, 8, 0, 1, 5
+    };
+
+    UnsignedShort dirtyRootNodesData[1]{};
+    Containers::MutableBitArrayView dirtyRootNodes{dirtyRootNodesData, 0, 9};
+    dirtyRootNodes.set(2);
+    dirtyRootNodes.set(6);
+
+    UnsignedShort dirtyNodesData[1]{};
+    Containers::MutableBitArrayView dirtyNodes{dirtyNodesData, 0, 9};
+    CORRADE_COMPARE(Implementation::markDirtyLayoutNodesInto(
+        nodeParents,
+        visibleNodeIds,
+        dirtyRootNodes,
+        dirtyNodes), 4);
+    /* Hierarchy of the invisible node 6 isn't marked */
+    CORRADE_COMPARE_AS(dirtyNodes, Containers::stridedArrayView({
+     /* 0  1  2  3  4  5  6  7  8 */
+        0, 0, 1, 1, 1, 0, 0, 0, 1
+    }).sliceBit(0), TestSuite::Compare::Container);
+}
+
+void AbstractUserInterfaceImplementationTest::filterLayoutUpdateMask() {
+    NodeHandle layoutNodes[]{
+        nodeHandle(3, 0x1),     /* 0 */
+        NodeHandle::Null,       /* 1, removed */
+        nodeHandle(1, 0x1),     /* 2 */
+        nodeHandle(4, 0x1),     /* 3 */
+        nodeHandle(2, 0x1),     /* 4 */
+        nodeHandle(0, 0x1),     /* 5, in a different update() run */
+        nodeHandle(5, 0x1),     /* 6 */
+    };
+    /* Layouts 0 and 3 are nested under layout 4, layout 6 under 2 */
+    UnsignedInt topLevelLayoutIds[]{
+        4, 2
+    };
+
+    UnsignedByte maskData[1]{};
+    Containers::MutableBitArrayView mask{maskData, 0, 7};
+    mask.set(0);
+    mask.set(2);
+    mask.set(3);
+    mask.set(4);
+    mask.set(6);
+
+    /* Nodes 2, 3 and 4 are in one hierarchy, 1 and 5 in another, only the
+       first is dirty */
+    UnsignedByte dirtyNodesData[1]{};
+    Containers::MutableBitArrayView dirtyNodes{dirtyNodesData, 0, 6};
+    dirtyNodes.set(2);
+    dirtyNodes.set(3);
+    dirtyNodes.set(4);
+    /* Not in the mask, so shouldn't be included either */
+    dirtyNodes.set(0);
+
+    UnsignedByte filteredMaskData[1]{};
+    Containers::MutableBitArrayView filteredMask{filteredMaskData, 0, 7};
+    UnsignedInt filteredTopLevelLayoutIds[2];
+    CORRADE_COMPARE(Implementation::filterLayoutUpdateMaskInto(
+        mask,
+        topLevelLayoutIds,
+        layoutNodes,
+        dirtyNodes,
+        filteredMask,
+        filteredTopLevelLayoutIds), 1);
+    CORRADE_COMPARE_AS(filteredMask, Containers::stridedArrayView({
+     /* 0  1  2  3  4  5  6 */
+        1, 0, 0, 1, 1, 0, 0
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_COMPARE(filteredTopLevelLayoutIds[0], 4);
+}
+
+void AbstractUserInterfaceImplementationTest::visibleSubtreeRects() {
+    const struct Children {
+        UnsignedInt id;
+        UnsignedInt count;
+    } nodeIdsChildrenCount[]{
+        /* No children */
+        {3, 0},
+        /* Nested children, one of them zero-size outside of the parent */
+        {0, 3},
+            {2, 1},
+                {4, 0},
+            {1, 0},
+    };
+
+    const Vector2 absoluteNodeOffsets[]{
+        {10.0f, 10.0f}, /* 0 */
+        {30.0f, 15.0f}, /* 1, zero size */
+        {12.0f, 12.0f}, /* 2 */
+        {0.0f, 0.0f},   /* 3 */
+        {5.0f, 14.0f},  /* 4 */
+    };
+    const Vector2 nodeSizes[]{
+        {10.0f, 10.0f}, /* 0 */
+        {},             /* 1 */
+        {4.0f, 4.0f},   /* 2 */
+        {2.0f, 3.0f},   /* 3 */
+        {2.0f, 12.0f},  /* 4 */
+    };
+
+    Range2D visibleSubtreeRects[Containers::arraySize(nodeIdsChildrenCount)];
+    Implementation::visibleSubtreeRectsInto(
+        Containers::stridedArrayView(nodeIdsChildrenCount).slice(&Children::id),
+        Containers::stridedArrayView(nodeIdsChildrenCount).slice(&Children::count),
+        absoluteNodeOffsets,
+        nodeSizes,
+        visibleSubtreeRects);
+    CORRADE_COMPARE_AS(Containers::arrayView(visibleSubtreeRects), Containers::arrayView<Range2D>({
+        {{0.0f, 0.0f}, {2.0f, 3.0f}},    /* Node 3 */
+        /* Node 0, including 4 extending to the left and bottom and the
+           zero-size 1 to the right */
+        {{5.0f, 10.0f}, {30.0f, 26.0f}},
+        {{5.0f, 12.0f}, {16.0f, 26.0f}}, /* Node 2 and 4 */
+        {{5.0f, 14.0f}, {7.0f, 26.0f}},  /* Node 4 */
+        {{30.0f, 15.0f}, {30.0f, 15.0f}} /* Node 1 */
+    }), TestSuite::Compare::Container);
+}
+
 void AbstractUserInterfaceImplementationTest::cullVisibleNodesClipRects() {
     auto&& data = CullVisibleNodesClipRectsData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1766,6 +2140,43 @@ void AbstractUserInterfaceImplementationTest::cullVisibleNodes() {
     for(const auto& i: Containers::arrayView(clipRects).prefix(count))
         clipRectCount += i.third();
     CORRADE_COMPARE(clipRectCount, Containers::arraySize(nodeOffsetsSizes));
+
+    /* Culling with subtree rects skips some subtrees without testing each
+       node, but the output should be exactly the same */
+    {
+        CORRADE_ITERATION("with subtree rects");
+
+        Range2D visibleSubtreeRects[Containers::arraySize(nodeIdsChildrenCount)];
+        Implementation::visibleSubtreeRectsInto(
+            Containers::stridedArrayView(nodeIdsChildrenCount).slice(&Children::id),
+            Containers::stridedArrayView(nodeIdsChildrenCount).slice(&Children::count),
+            Containers::stridedArrayView(nodeOffsetsSizes).slice(&Node::offset),
+            Containers::stridedArrayView(nodeOffsetsSizes).slice(&Node::size),
+            visibleSubtreeRects);
+
+        UnsignedShort visibleNodeMaskSubtreeRectsStorage[1];
+        Containers::MutableBitArrayView visibleNodeMaskSubtreeRects{visibleNodeMaskSubtreeRectsStorage, 0, Containers::arraySize(nodeOffsetsSizes)};
+        Containers::Triple<Vector2, Vector2, UnsignedInt> clipRectsSubtreeRects[Containers::arraySize(nodeOffsetsSizes)];
+        UnsignedInt countSubtreeRects = Implementation::cullVisibleNodesInto(
+            data.uiOffset, data.uiSize,
+            Containers::stridedArrayView(nodeOffsetsSizes).slice(&Node::offset),
+            Containers::stridedArrayView(nodeOffsetsSizes).slice(&Node::size),
+            Containers::arrayView(data.flags),
+            clipStack,
+            Containers::stridedArrayView(nodeIdsChildrenCount).slice(&Children::id),
+            Containers::stridedArrayView(nodeIdsChildrenCount).slice(&Children::count),
+            visibleNodeMaskSubtreeRects,
+            Containers::stridedArrayView(clipRectsSubtreeRects).slice(&Containers::Triple<Vector2, Vector2, UnsignedInt>::first),
+            Containers::stridedArrayView(clipRectsSubtreeRects).slice(&Containers::Triple<Vector2, Vector2, UnsignedInt>::second),
+            Containers::stridedArrayView(clipRectsSubtreeRects).slice(&Containers::Triple<Vector2, Vector2, UnsignedInt>::third),
+            visibleSubtreeRects);
+        CORRADE_COMPARE_AS(visibleNodeMaskSubtreeRects,
+            Containers::stridedArrayView(data.visible).sliceBit(0),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(Containers::arrayView(clipRectsSubtreeRects).prefix(countSubtreeRects),
+            Containers::arrayView(data.clipRects),
+            TestSuite::Compare::Container);
+    }
 }
 
 void AbstractUserInterfaceImplementationTest::cullVisibleNodesNoTopLevelNodes() {
@@ -2251,6 +2662,163 @@ void AbstractUserInterfaceImplementationTest::countOrderNodeDataForEventHandling
     }), TestSuite::Compare::Container);
 }
 
+void AbstractUserInterfaceImplementationTest::visibleSubtreeEventDataOffsets() {
+    /* Top-level node 3 with a child 1 that has a child 4, top-level node 0
+       with a child 2 */
+    const UnsignedInt visibleNodeIds[]{3, 1, 4, 0, 2};
+
+    /* Node 0 has one data, 1 none, 2 two, 3 one, 4 three */
+    const UnsignedInt visibleNodeEventDataOffsets[]{0, 1, 1, 3, 4, 7};
+
+    /* Node 4 isn't taking events, so its data aren't counted */
+    UnsignedByte visibleEventNodeMaskData[]{0x0f};
+    Containers::BitArrayView visibleEventNodeMask{visibleEventNodeMaskData, 0, 5};
+
+    UnsignedInt visibleSubtreeEventDataOffsets[6];
+    Implementation::visibleSubtreeEventDataOffsetsInto(visibleNodeIds, visibleEventNodeMask, visibleNodeEventDataOffsets, visibleSubtreeEventDataOffsets);
+    CORRADE_COMPARE_AS(Containers::arrayView(visibleSubtreeEventDataOffsets), Containers::arrayView<UnsignedInt>({
+        0, /* Node 3 */
+        1, /* Node 1, the subtree of 1 and 4 has no data */
+        1, /* Node 4 */
+        1, /* Node 0 */
+        2, /* Node 2 */
+        4
+    }), TestSuite::Compare::Container);
+}
+
+void AbstractUserInterfaceImplementationTest::buildHitTestGrids() {
+    /* To make the test easier to follow, the node IDs match the visible
+       node indices */
+    const UnsignedInt visibleNodeIds[]{
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20
+    };
+    const UnsignedInt visibleNodeChildrenCounts[]{
+        /* Node 0 with 8 direct children, node 8 having a child 9. There's
+           just five children worth putting into a grid. */
+        9, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+        /* Node 10 with 5 children that all overlap each other, meaning the
+           grid wouldn't help */
+        5, 0, 0, 0, 0, 0,
+        /* Node 16 with 4 children but zero size */
+        4, 0, 0, 0, 0
+    };
+    const Vector2 nodeOffsets[]{
+        {0.0f, 0.0f},
+        {0.0f, 0.0f},       /* 1 */
+        {25.0f, 25.0f},     /* 2 */
+        {5.0f, 5.0f},       /* 3, spans all cells */
+        {50.0f, 50.0f},     /* 4, fully outside of 0 */
+        {30.0f, 0.0f},      /* 5, has no event data */
+        {0.0f, 30.0f},      /* 6, not taking events */
+        {30.0f, 30.0f},     /* 7 */
+        {10.0f, 30.0f},     /* 8, has no event data but its child 9 has */
+        {11.0f, 31.0f},     /* 9 */
+        {100.0f, 100.0f},
+        {100.0f, 100.0f},   /* 11 */
+        {95.0f, 95.0f},     /* 12 */
+        {100.0f, 100.0f},   /* 13 */
+        {100.0f, 100.0f},   /* 14 */
+        {100.0f, 100.0f},   /* 15 */
+        {200.0f, 200.0f},
+        {200.0f, 200.0f},   /* 17 */
+        {200.0f, 200.0f},   /* 18 */
+        {200.0f, 200.0f},   /* 19 */
+        {200.0f, 200.0f},   /* 20 */
+    };
+    const Vector2 nodeSizes[]{
+        {40.0f, 40.0f},
+        {10.0f, 10.0f},     /* 1 */
+        {10.0f, 10.0f},     /* 2 */
+        {30.0f, 30.0f},     /* 3 */
+        {5.0f, 5.0f},       /* 4 */
+        {10.0f, 10.0f},     /* 5 */
+        {10.0f, 10.0f},     /* 6 */
+        {10.0f, 10.0f},     /* 7 */
+        {5.0f, 5.0f},       /* 8 */
+        {2.0f, 2.0f},       /* 9 */
+        {10.0f, 10.0f},
+        {10.0f, 10.0f},     /* 11 */
+        {20.0f, 20.0f},     /* 12 */
+        {10.0f, 10.0f},     /* 13 */
+        {10.0f, 10.0f},     /* 14 */
+        {10.0f, 10.0f},     /* 15 */
+        {0.0f, 10.0f},
+        {1.0f, 1.0f},       /* 17 */
+        {1.0f, 1.0f},       /* 18 */
+        {1.0f, 1.0f},       /* 19 */
+        {1.0f, 1.0f},       /* 20 */
+    };
+    /* Everything except node 6 takes events */
+    UnsignedInt visibleEventNodeMaskData[]{0x1fffff & ~(1 << 6)};
+    Containers::BitArrayView visibleEventNodeMask{visibleEventNodeMaskData, 0, 21};
+    /* Nodes 0, 5, 8, 10 and 16 have no data, all others have one */
+    const UnsignedInt visibleSubtreeEventDataOffsets[]{
+        0, 0, 1, 2, 3, 4, 4, 5, 6, 6,
+        7, 7, 8, 9, 10, 11,
+        12, 12, 13, 14, 15,
+        16
+    };
+
+    /* The outputs should get cleared first */
+    UnsignedInt visibleNodeGrids[21];
+    Containers::Array<Implementation::HitTestGrid> grids;
+    Containers::Array<UnsignedInt> gridCellOffsets;
+    Containers::Array<UnsignedInt> gridCellChildren;
+    arrayAppend(grids, Implementation::HitTestGrid{});
+    arrayAppend(gridCellOffsets, {0u, 1u});
+    arrayAppend(gridCellChildren, 3u);
+
+    Implementation::buildHitTestGridsInto(4, 4,
+        visibleNodeIds,
+        visibleNodeChildrenCounts,
+        visibleEventNodeMask,
+        visibleSubtreeEventDataOffsets,
+        nodeOffsets,
+        nodeSizes,
+        visibleNodeGrids,
+        grids,
+        gridCellOffsets,
+        gridCellChildren);
+
+    CORRADE_COMPARE_AS(Containers::arrayView(visibleNodeGrids), Containers::arrayView<UnsignedInt>({
+        0, ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{},
+        ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{},
+        ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{},
+        ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{},
+        ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{}, ~UnsignedInt{}
+    }), TestSuite::Compare::Container);
+
+    /* Five candidate children in node 0, so it's a 3x3 grid */
+    CORRADE_COMPARE(grids.size(), 1);
+    CORRADE_COMPARE(grids[0].offset, (Vector2{0.0f, 0.0f}));
+    CORRADE_COMPARE(grids[0].cellSize, Vector2{40.0f/3.0f});
+    CORRADE_COMPARE(grids[0].cellCount, (Vector2ui{3, 3}));
+    CORRADE_COMPARE(grids[0].cellOffset, 0);
+
+    /* The grid for node 10 got discarded, so there's nothing else after */
+    CORRADE_COMPARE_AS(gridCellOffsets, Containers::arrayView<UnsignedInt>({
+        0, 2, 3, 4, 5, 7, 9, 11, 14, 17
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(gridCellChildren, Containers::arrayView<UnsignedInt>({
+        1, 3,       /* Cell 0, 0 */
+        3,          /* Cell 1, 0 */
+        3,          /* Cell 2, 0 */
+        3,          /* Cell 0, 1 */
+        2, 3,       /* Cell 1, 1 */
+        2, 3,       /* Cell 2, 1 */
+        3, 8,       /* Cell 0, 2 */
+        2, 3, 8,    /* Cell 1, 2 */
+        2, 3, 7,    /* Cell 2, 2 */
+    }), TestSuite::Compare::Container);
+
+    /* Positions outside of the grid are clamped to edge cells */
+    CORRADE_COMPARE(Implementation::hitTestGridCellIndex(grids[0], {0.0f, 0.0f}), 0);
+    CORRADE_COMPARE(Implementation::hitTestGridCellIndex(grids[0], {39.9f, 14.0f}), 5);
+    CORRADE_COMPARE(Implementation::hitTestGridCellIndex(grids[0], {13.0f, 27.0f}), 6);
+    CORRADE_COMPARE(Implementation::hitTestGridCellIndex(grids[0], {-5.0f, 50.0f}), 6);
+    CORRADE_COMPARE(Implementation::hitTestGridCellIndex(grids[0], {50.0f, -5.0f}), 2);
+}
+
 void AbstractUserInterfaceImplementationTest::compactDraws() {
     Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>> draws[]{
         {8, {15, 3}, {1, 2}},
@@ -2286,12 +2854,144 @@ void AbstractUserInterfaceImplementationTest::compactDraws() {
         {3, {226, 762}, {27, 46}},
         {8, {18, 2}, {1, 33}},
         {3, {0, 226}, {26, 78}},
-        /* These two *could* get merged together eventually. So far aren't. */
+        /* These two get merged only by mergeDrawsInPlace(), tested in
+           mergeDraws() */
         {4, {0, 6777}, {1, 233}},
         {4, {6777, 2}, {233, 16}}
     })), TestSuite::Compare::Container);
 }
 
+void AbstractUserInterfaceImplementationTest::mergeableDrawOrder() {
+    /*  0    10   20   30        100
+      0 +----+----+----+
+        | 0  | 1  | 2  |
+      5 |  +-|--+ |    |
+     10 +--|-+--|-+----+
+           | 3  |
+     15    +----+
+                                 +---+
+                                 | 4 |
+                                 +---+
+
+       Nodes 0, 1 and 2 only touch each other so they're disjoint, 3 overlaps
+       0 and 1 so it starts a new group, 4 is disjoint with 3 so it's in the
+       same group. */
+    Range2D topLevelNodeRects[]{
+        {{0.0f, 0.0f}, {10.0f, 10.0f}},
+        {{10.0f, 0.0f}, {20.0f, 10.0f}},
+        {{20.0f, 0.0f}, {30.0f, 10.0f}},
+        {{5.0f, 5.0f}, {15.0f, 15.0f}},
+        {{100.0f, 100.0f}, {110.0f, 110.0f}},
+    };
+    /* Two draw layers, with IDs 3 and 7, for each top-level node */
+    UnsignedByte dataToDrawLayerIds[]{
+        3, 7,
+        3, 7,
+        3, 7,
+        3, 7,
+        3, 7,
+    };
+    UnsignedInt dataToDrawSizes[]{
+        1, 2,
+        0, 1, /* Empty draws get reordered as well */
+        3, 0,
+        1, 1,
+        2, 2,
+    };
+    Containers::BitArray compositeLayers{ValueInit, 8};
+
+    UnsignedInt drawOrder[10];
+    Implementation::mergeableDrawOrderInto(topLevelNodeRects, dataToDrawLayerIds, dataToDrawSizes, compositeLayers, drawOrder);
+    CORRADE_COMPARE_AS(Containers::arrayView(drawOrder), Containers::arrayView<UnsignedInt>({
+        0, 2, 4, /* layer 3 of nodes 0, 1, 2 */
+        1, 3, 5, /* layer 7 of nodes 0, 1, 2 */
+        6, 8,    /* layer 3 of nodes 3, 4 */
+        7, 9,    /* layer 7 of nodes 3, 4 */
+    }), TestSuite::Compare::Container);
+
+    /* No top-level nodes is a no-op */
+    Implementation::mergeableDrawOrderInto({}, {}, {}, compositeLayers, {});
+}
+
+void AbstractUserInterfaceImplementationTest::mergeableDrawOrderComposite() {
+    /* All nodes are disjoint, node 2 has a non-empty draw of a layer that's
+       compositing, which puts it into a group of its own. Node 1 has an empty
+       draw of it, which doesn't matter. */
+    Range2D topLevelNodeRects[]{
+        {{0.0f, 0.0f}, {10.0f, 10.0f}},
+        {{10.0f, 0.0f}, {20.0f, 10.0f}},
+        {{20.0f, 0.0f}, {30.0f, 10.0f}},
+        {{30.0f, 0.0f}, {40.0f, 10.0f}},
+    };
+    UnsignedByte dataToDrawLayerIds[]{
+        3, 7,
+        3, 7,
+        3, 7,
+        3, 7,
+    };
+    UnsignedInt dataToDrawSizes[]{
+        1, 0,
+        1, 0,
+        1, 1,
+        1, 0,
+    };
+    Containers::BitArray compositeLayers{ValueInit, 8};
+    compositeLayers.set(7);
+
+    UnsignedInt drawOrder[8];
+    Implementation::mergeableDrawOrderInto(topLevelNodeRects, dataToDrawLayerIds, dataToDrawSizes, compositeLayers, drawOrder);
+    CORRADE_COMPARE_AS(Containers::arrayView(drawOrder), Containers::arrayView<UnsignedInt>({
+        0, 2, 1, 3, /* nodes 0 and 1 */
+        4, 5,       /* node 2 alone */
+        6, 7        /* node 3, which can't be in a group with node 2 */
+    }), TestSuite::Compare::Container);
+}
+
+void AbstractUserInterfaceImplementationTest::mergeDraws() {
+    Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>> draws[]{
+        {3, {0, 2}, {0, 1}},
+        {3, {2, 3}, {1, 2}}, /* merged with the previous */
+        {3, {5, 1}, {3, 1}}, /* merged with the previous */
+        {7, {0, 2}, {0, 1}},
+        {7, {4, 1}, {2, 1}}, /* data don't follow the previous */
+        {7, {5, 1}, {4, 1}}, /* clip rects don't follow the previous */
+        {5, {0, 1}, {0, 1}},
+        {5, {1, 1}, {1, 1}}, /* compositing layer, not merged */
+        {3, {6, 1}, {4, 1}}, /* not directly after the other layer 3 draws */
+    };
+    Containers::BitArray compositeLayers{ValueInit, 8};
+    compositeLayers.set(5);
+
+    UnsignedInt count = Implementation::mergeDrawsInPlace(
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::first),
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::second)
+            .slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::second)
+            .slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second),
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::third)
+            .slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::third)
+            .slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second),
+        compositeLayers);
+    CORRADE_COMPARE_AS(Containers::arrayView(draws).prefix(count), (Containers::arrayView<Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>>({
+        {3, {0, 6}, {0, 4}},
+        {7, {0, 2}, {0, 1}},
+        {7, {4, 1}, {2, 1}},
+        {7, {5, 1}, {4, 1}},
+        {5, {0, 1}, {0, 1}},
+        {5, {1, 1}, {1, 1}},
+        {3, {6, 1}, {4, 1}},
+    })), TestSuite::Compare::Container);
+
+    /* Empty input is a no-op */
+    CORRADE_COMPARE(Implementation::mergeDrawsInPlace({}, {}, {}, {}, {}, compositeLayers), 0);
+}
+
 void AbstractUserInterfaceImplementationTest::compositeRectsEdges() {
     /* Offsets + sizes like in cullVisibleNodesEdges(), without the outside.
        The double-line rectangle is one side of the culling, the 0 to 13
@@ -2547,6 +3247,335 @@ void AbstractUserInterfaceImplementationTest::compositingRects() {
     }
 }
 
+void AbstractUserInterfaceImplementationTest::redrawRect() {
+    Vector2 nodeOffsets[]{
+        {1.0f, 2.0f},
+        {10.0f, 10.0f},
+        {5.0f, 1.0f},
+        {}, /* 3, unused */
+    };
+    Vector2 nodeSizes[]{
+        {3.0f, 4.0f},
+        {1.0f, 1.0f},
+        {2.0f, 2.0f},
+        {},
+    };
+    Float nodeOpacities[]{
+        1.0f,
+        1.0f,
+        0.5f,
+        0.0f
+    };
+    Containers::BitArray visibleNodeMask{ValueInit, 4};
+    Containers::BitArray visibleEnabledNodeMask{ValueInit, 4};
+    Implementation::RedrawNode redrawNodes[4];
+    for(Implementation::RedrawNode& i: redrawNodes)
+        i = {{}, {}, 0.0f, ~UnsignedInt{}, false, false};
+
+    /* Initially, all visible nodes are redrawn. Node 1 is culled, so it isn't
+       included. */
+    {
+        UnsignedInt visibleNodeIds[]{2, 0, 1};
+        visibleNodeMask.set(0);
+        visibleNodeMask.set(2);
+        visibleEnabledNodeMask.set(0);
+        Range2D rect;
+        CORRADE_VERIFY(Implementation::redrawRectInto(visibleNodeIds, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, Containers::BitArray{ValueInit, 4}, redrawNodes, rect));
+        CORRADE_COMPARE(rect, (Range2D{{1.0f, 1.0f}, {7.0f, 6.0f}}));
+        CORRADE_COMPARE(redrawNodes[0].order, 1);
+        CORRADE_COMPARE(redrawNodes[1].order, 2);
+        CORRADE_COMPARE(redrawNodes[2].order, 0);
+        CORRADE_COMPARE(redrawNodes[3].order, ~UnsignedInt{});
+        CORRADE_VERIFY(redrawNodes[0].visible);
+        CORRADE_VERIFY(!redrawNodes[1].visible);
+        CORRADE_VERIFY(redrawNodes[2].visible);
+        CORRADE_VERIFY(!redrawNodes[3].visible);
+        CORRADE_VERIFY(redrawNodes[0].enabled);
+        CORRADE_VERIFY(!redrawNodes[2].enabled);
+        CORRADE_COMPARE(redrawNodes[2].offset, (Vector2{5.0f, 1.0f}));
+        CORRADE_COMPARE(redrawNodes[2].size, (Vector2{2.0f, 2.0f}));
+        CORRADE_COMPARE(redrawNodes[2].opacity, 0.5f);
+
+    /* Calling it again with no change results in nothing being redrawn */
+    } {
+        UnsignedInt visibleNodeIds[]{2, 0, 1};
+        Range2D rect;
+        CORRADE_VERIFY(Implementation::redrawRectInto(visibleNodeIds, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, Containers::BitArray{ValueInit, 4}, redrawNodes, rect));
+        CORRADE_COMPARE(rect, Range2D{});
+
+    /* Changing opacity of node 0 redraws it, moving node 2 redraws both the
+       previous and the new location. Moving the culled node 1 doesn't redraw
+       anything. */
+    } {
+        UnsignedInt visibleNodeIds[]{2, 0, 1};
+        nodeOpacities[0] = 0.75f;
+        nodeOffsets[2] = {6.0f, 1.0f};
+        nodeOffsets[1] = {20.0f, 20.0f};
+        Range2D rect;
+        CORRADE_VERIFY(Implementation::redrawRectInto(visibleNodeIds, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, Containers::BitArray{ValueInit, 4}, redrawNodes, rect));
+        CORRADE_COMPARE(rect, (Range2D{{1.0f, 1.0f}, {8.0f, 6.0f}}));
+        CORRADE_COMPARE(redrawNodes[0].opacity, 0.75f);
+        CORRADE_COMPARE(redrawNodes[2].offset, (Vector2{6.0f, 1.0f}));
+
+    /* Node 2 no longer being in the list redraws its previous location,
+       node 1 becoming visible redraws its current location. Node 0 changing
+       the enabled state redraws it too. */
+    } {
+        UnsignedInt visibleNodeIds[]{0, 1};
+        visibleNodeMask.reset(2);
+        visibleNodeMask.set(1);
+        visibleEnabledNodeMask.reset(0);
+        Range2D rect;
+        CORRADE_VERIFY(Implementation::redrawRectInto(visibleNodeIds, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, Containers::BitArray{ValueInit, 4}, redrawNodes, rect));
+        CORRADE_COMPARE(rect, (Range2D{{1.0f, 1.0f}, {21.0f, 21.0f}}));
+        CORRADE_COMPARE(redrawNodes[0].order, 0);
+        CORRADE_COMPARE(redrawNodes[1].order, 1);
+        CORRADE_COMPARE(redrawNodes[2].order, ~UnsignedInt{});
+        CORRADE_VERIFY(redrawNodes[1].visible);
+        CORRADE_VERIFY(!redrawNodes[2].visible);
+        CORRADE_VERIFY(!redrawNodes[0].enabled);
+
+    /* Node 2 appearing again at the end doesn't affect the order of others */
+    } {
+        UnsignedInt visibleNodeIds[]{0, 1, 2};
+        visibleNodeMask.set(2);
+        Range2D rect;
+        CORRADE_VERIFY(Implementation::redrawRectInto(visibleNodeIds, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, Containers::BitArray{ValueInit, 4}, redrawNodes, rect));
+        CORRADE_COMPARE(rect, (Range2D{{6.0f, 1.0f}, {8.0f, 3.0f}}));
+    }
+}
+
+void AbstractUserInterfaceImplementationTest::redrawRectOrderChanged() {
+    Vector2 nodeOffsets[]{
+        {1.0f, 2.0f},
+        {5.0f, 1.0f},
+        {10.0f, 10.0f},
+    };
+    Vector2 nodeSizes[]{
+        {3.0f, 4.0f},
+        {2.0f, 2.0f},
+        {1.0f, 1.0f},
+    };
+    Float nodeOpacities[]{
+        1.0f,
+        1.0f,
+        1.0f
+    };
+    Containers::BitArray visibleNodeMask{DirectInit, 3, true};
+    Containers::BitArray visibleEnabledNodeMask{DirectInit, 3, true};
+    Implementation::RedrawNode redrawNodes[3];
+    for(Implementation::RedrawNode& i: redrawNodes)
+        i = {{}, {}, 0.0f, ~UnsignedInt{}, false, false};
+
+    {
+        UnsignedInt visibleNodeIds[]{0, 1, 2};
+        Range2D rect;
+        CORRADE_VERIFY(Implementation::redrawRectInto(visibleNodeIds, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, Containers::BitArray{ValueInit, 3}, redrawNodes, rect));
+        CORRADE_COMPARE(rect, (Range2D{{1.0f, 1.0f}, {11.0f, 11.0f}}));
+
+    /* Removing a node from the middle doesn't change the order */
+    } {
+        UnsignedInt visibleNodeIds[]{0, 2};
+        visibleNodeMask.reset(1);
+        Range2D rect;
+        CORRADE_VERIFY(Implementation::redrawRectInto(visibleNodeIds, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, Containers::BitArray{ValueInit, 3}, redrawNodes, rect));
+        CORRADE_COMPARE(rect, (Range2D{{5.0f, 1.0f}, {7.0f, 3.0f}}));
+
+    /* Swapping the remaining two does, even if nothing else changed. The
+       state is still updated, so the next call compares to the new order. */
+    } {
+        UnsignedInt visibleNodeIds[]{2, 0};
+        Range2D rect;
+        CORRADE_VERIFY(!Implementation::redrawRectInto(visibleNodeIds, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, Containers::BitArray{ValueInit, 3}, redrawNodes, rect));
+        CORRADE_COMPARE(rect, Range2D{});
+        CORRADE_COMPARE(redrawNodes[0].order, 1);
+        CORRADE_COMPARE(redrawNodes[2].order, 0);
+    } {
+        UnsignedInt visibleNodeIds[]{2, 0};
+        Range2D rect;
+        CORRADE_VERIFY(Implementation::redrawRectInto(visibleNodeIds, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, Containers::BitArray{ValueInit, 3}, redrawNodes, rect));
+        CORRADE_COMPARE(rect, Range2D{});
+    }
+}
+
+void AbstractUserInterfaceImplementationTest::redrawDataRect() {
+    UnsignedInt dataIds[]{3, 0, 4};
+    NodeHandle dataNodes[]{
+        nodeHandle(2, 0xcec), /* 0 */
+        NodeHandle::Null,     /* 1, unused */
+        NodeHandle::Null,     /* 2, unused */
+        nodeHandle(0, 0xcec), /* 3 */
+        nodeHandle(2, 0xcec), /* 4, same node as data 0 */
+    };
+    Vector2 nodeOffsets[]{
+        {1.0f, 2.0f},
+        {}, /* 1, unused */
+        {5.0f, 1.0f},
+    };
+    Vector2 nodeSizes[]{
+        {3.0f, 4.0f},
+        {},
+        {2.0f, 2.0f},
+    };
+
+    /* The rect gets joined with what's there already */
+    Range2D rect{{0.0f, 5.0f}, {2.0f, 8.0f}};
+    Implementation::redrawDataRectInto(dataIds, dataNodes, nodeOffsets, nodeSizes, rect);
+    CORRADE_COMPARE(rect, (Range2D{{0.0f, 1.0f}, {7.0f, 8.0f}}));
+
+    /* Empty data list doesn't change anything */
+    Implementation::redrawDataRectInto({}, dataNodes, nodeOffsets, nodeSizes, rect);
+    CORRADE_COMPARE(rect, (Range2D{{0.0f, 1.0f}, {7.0f, 8.0f}}));
+}
+
+void AbstractUserInterfaceImplementationTest::cachedDraws() {
+    /* Five top-level nodes with their children, the third one isn't cached,
+       the fourth has a compositing draw and the fifth draws nothing */
+    UnsignedInt visibleNodeIds[]{
+        7, 3,   /* node 7 with a child */
+        5,
+        1,
+        0, 4,   /* node 0 with a child */
+        2,
+        6
+    };
+    UnsignedInt topLevelNodeIndices[]{0, 2, 3, 4, 6};
+    Range2D topLevelNodeRects[]{
+        {{1.0f, 2.0f}, {3.0f, 4.0f}},
+        {{5.0f, 6.0f}, {7.0f, 8.0f}},
+        {{9.0f, 0.0f}, {1.0f, 2.0f}},
+        {{3.0f, 4.0f}, {5.0f, 6.0f}},
+        {{7.0f, 8.0f}, {9.0f, 0.0f}}
+    };
+    Containers::BitArray cachedTopLevelNodes{DirectInit, 5, true};
+    cachedTopLevelNodes.reset(2);
+
+    /* Three layers, the layer 1 composites */
+    UnsignedByte dataToDrawLayerIds[]{
+        0, 1, 2,
+        0, 1, 2,
+        0, 1, 2,
+        0, 1, 2,
+        0, 1, 2,
+    };
+    UnsignedInt dataToDrawSizes[]{
+        3, 0, 2,    /* two draws */
+        1, 0, 0,    /* one draw */
+        4, 0, 1,    /* two draws, not cached */
+        1, 2, 0,    /* two draws, one composites */
+        0, 0, 0,    /* no draws */
+    };
+    Containers::BitArray compositeLayers{ValueInit, 3};
+    compositeLayers.set(1);
+
+    Implementation::CachedDraw cachedDraws[5];
+    CORRADE_COMPARE(Implementation::cachedDrawsInto(visibleNodeIds, topLevelNodeIndices, topLevelNodeRects, cachedTopLevelNodes, dataToDrawLayerIds, dataToDrawSizes, compositeLayers, cachedDraws), 2);
+
+    CORRADE_COMPARE(cachedDraws[0].rect, (Range2D{{1.0f, 2.0f}, {3.0f, 4.0f}}));
+    CORRADE_COMPARE(cachedDraws[0].nodeId, 7);
+    CORRADE_COMPARE(cachedDraws[0].visibleNodeIndex, 0);
+    CORRADE_COMPARE(cachedDraws[0].drawOffset, 0);
+    CORRADE_COMPARE(cachedDraws[0].drawCount, 2);
+
+    CORRADE_COMPARE(cachedDraws[1].rect, (Range2D{{5.0f, 6.0f}, {7.0f, 8.0f}}));
+    CORRADE_COMPARE(cachedDraws[1].nodeId, 5);
+    CORRADE_COMPARE(cachedDraws[1].visibleNodeIndex, 2);
+    CORRADE_COMPARE(cachedDraws[1].drawOffset, 2);
+    CORRADE_COMPARE(cachedDraws[1].drawCount, 1);
+}
+
+void AbstractUserInterfaceImplementationTest::cachedDrawsEmpty() {
+    Implementation::CachedDraw cachedDraws[1];
+    CORRADE_COMPARE(Implementation::cachedDrawsInto(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, Containers::BitArray{ValueInit, 3}, cachedDraws), 0);
+}
+
+void AbstractUserInterfaceImplementationTest::invalidateChangedCaches() {
+    /* Node 2 is a top-level node with children 0 and 3, node 1 is a top-level
+       node that isn't cached */
+    UnsignedInt visibleNodeIds[]{2, 0, 3, 1};
+    UnsignedInt visibleNodeChildrenCounts[]{2, 0, 0, 0};
+    Vector2 nodeOffsets[]{
+        {1.0f, 2.0f},
+        {10.0f, 10.0f},
+        {5.0f, 1.0f},
+        {3.0f, 3.0f},
+    };
+    Vector2 nodeSizes[]{
+        {3.0f, 4.0f},
+        {1.0f, 1.0f},
+        {2.0f, 2.0f},
+        {1.0f, 1.0f},
+    };
+    Float nodeOpacities[]{
+        1.0f,
+        1.0f,
+        0.5f,
+        1.0f
+    };
+    Containers::BitArray visibleNodeMask{DirectInit, 4, true};
+    Containers::BitArray visibleEnabledNodeMask{DirectInit, 4, true};
+    Implementation::RedrawNode cacheNodes[4];
+    for(Implementation::RedrawNode& i: cacheNodes)
+        i = {{}, {}, 0.0f, ~UnsignedInt{}, false, false};
+    Implementation::NodeCache nodeCaches[4]{};
+
+    Implementation::CachedDraw cachedDraws[]{
+        {{}, 2, 0, 0, 1}
+    };
+
+    /* Initially the cache is invalidated as the nodes weren't known before */
+    nodeCaches[2].valid = true;
+    Implementation::invalidateChangedCachesInto(cachedDraws, visibleNodeIds, visibleNodeChildrenCounts, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, cacheNodes, nodeCaches);
+    CORRADE_VERIFY(!nodeCaches[2].valid);
+    CORRADE_COMPARE(cacheNodes[2].order, 3);
+    CORRADE_COMPARE(cacheNodes[0].order, 1);
+    CORRADE_COMPARE(cacheNodes[3].order, 2);
+    /* The node that isn't cached isn't tracked */
+    CORRADE_COMPARE(cacheNodes[1].order, ~UnsignedInt{});
+    CORRADE_COMPARE(cacheNodes[2].opacity, 0.5f);
+
+    /* Calling it again with no change keeps it valid */
+    nodeCaches[2].valid = true;
+    Implementation::invalidateChangedCachesInto(cachedDraws, visibleNodeIds, visibleNodeChildrenCounts, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, cacheNodes, nodeCaches);
+    CORRADE_VERIFY(nodeCaches[2].valid);
+
+    /* Changing the node that isn't cached keeps it valid too */
+    nodeOffsets[1] = {20.0f, 20.0f};
+    visibleEnabledNodeMask.reset(1);
+    Implementation::invalidateChangedCachesInto(cachedDraws, visibleNodeIds, visibleNodeChildrenCounts, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, cacheNodes, nodeCaches);
+    CORRADE_VERIFY(nodeCaches[2].valid);
+
+    /* Changing a size of a child invalidates it */
+    nodeSizes[3] = {2.0f, 1.0f};
+    Implementation::invalidateChangedCachesInto(cachedDraws, visibleNodeIds, visibleNodeChildrenCounts, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, cacheNodes, nodeCaches);
+    CORRADE_VERIFY(!nodeCaches[2].valid);
+    CORRADE_COMPARE(cacheNodes[3].size, (Vector2{2.0f, 1.0f}));
+
+    /* Changing a child enabled state as well */
+    nodeCaches[2].valid = true;
+    visibleEnabledNodeMask.reset(0);
+    Implementation::invalidateChangedCachesInto(cachedDraws, visibleNodeIds, visibleNodeChildrenCounts, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, cacheNodes, nodeCaches);
+    CORRADE_VERIFY(!nodeCaches[2].valid);
+
+    /* Changing a child that's culled doesn't */
+    nodeCaches[2].valid = true;
+    visibleNodeMask.reset(3);
+    Implementation::invalidateChangedCachesInto(cachedDraws, visibleNodeIds, visibleNodeChildrenCounts, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, cacheNodes, nodeCaches);
+    CORRADE_VERIFY(!nodeCaches[2].valid);
+    nodeCaches[2].valid = true;
+    nodeOffsets[3] = {4.0f, 4.0f};
+    Implementation::invalidateChangedCachesInto(cachedDraws, visibleNodeIds, visibleNodeChildrenCounts, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, cacheNodes, nodeCaches);
+    CORRADE_VERIFY(nodeCaches[2].valid);
+
+    /* Swapping the children invalidates it even if nothing else changed */
+    visibleNodeIds[1] = 3;
+    visibleNodeIds[2] = 0;
+    Implementation::invalidateChangedCachesInto(cachedDraws, visibleNodeIds, visibleNodeChildrenCounts, nodeOffsets, nodeSizes, nodeOpacities, visibleNodeMask, visibleEnabledNodeMask, cacheNodes, nodeCaches);
+    CORRADE_VERIFY(!nodeCaches[2].valid);
+    CORRADE_COMPARE(cacheNodes[3].order, 1);
+    CORRADE_COMPARE(cacheNodes[0].order, 2);
+}
+
 void AbstractUserInterfaceImplementationTest::partitionedAnimatorsInsert() {
     AbstractAnimator& animator1 = *reinterpret_cast<AbstractAnimator*>(std::size_t{0xabcdef01});
     AbstractAnimator& animator2 = *reinterpret_cast<AbstractAnimator*>(std::size_t{0xabcdef02});
@@ -3759,6 +4788,244 @@ void AbstractUserInterfaceImplementationTest::partitionedAnimatorsRemoveLayer()
     }), TestSuite::Compare::Container);
 }
 
+void AbstractUserInterfaceImplementationTest::frameArena() {
+    Implementation::FrameArena arena;
+    CORRADE_COMPARE(arena.capacity(), 0);
+    CORRADE_COMPARE(arena.size(), 0);
+    CORRADE_COMPARE(arena.highWaterMark(), 0);
+
+    /* Zero-sized allocations don't take any memory */
+    CORRADE_COMPARE(arena.allocate<UnsignedInt>(NoInit, 0).size(), 0);
+    CORRADE_COMPARE(arena.highWaterMark(), 0);
+
+    /* With no storage, everything goes to overflow allocations, but the
+       offset is tracked as if it was contiguous, including alignment */
+    Containers::ArrayView<UnsignedByte> a = arena.allocate<UnsignedByte>(ValueInit, 3);
+    Containers::ArrayView<UnsignedInt> b = arena.allocate<UnsignedInt>(ValueInit, 5);
+    Containers::MutableBitArrayView c = arena.allocateBits(ValueInit, 17);
+    CORRADE_COMPARE(a.size(), 3);
+    CORRADE_COMPARE(b.size(), 5);
+    CORRADE_COMPARE(c.size(), 17);
+    CORRADE_COMPARE_AS(a, Containers::arrayView<UnsignedByte>({
+        0, 0, 0
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(b, Containers::arrayView<UnsignedInt>({
+        0, 0, 0, 0, 0
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(c.count(), 0);
+    CORRADE_COMPARE(arena.capacity(), 0);
+    CORRADE_COMPARE(arena.size(), 3 + 20 + 3);
+    /* 3 bytes, padded to 4, 20 bytes, 3 bytes */
+    CORRADE_COMPARE(arena.highWaterMark(), 4 + 20 + 3);
+
+    /* After a reset the storage is enlarged to what was needed, and the
+       overflow allocations are gone */
+    arena.reset();
+    CORRADE_COMPARE(arena.capacity(), 27);
+    CORRADE_COMPARE(arena.size(), 27);
+    CORRADE_COMPARE(arena.highWaterMark(), 27);
+
+    /* The same allocations now come from the storage, contiguously */
+    a = arena.allocate<UnsignedByte>(NoInit, 3);
+    b = arena.allocate<UnsignedInt>(NoInit, 5);
+    c = arena.allocateBits(NoInit, 17);
+    CORRADE_COMPARE(static_cast<void*>(b.data()), static_cast<void*>(a.data() + 4));
+    CORRADE_COMPARE(c.data(), static_cast<void*>(b.data() + 5));
+    CORRADE_COMPARE(arena.size(), 27);
+
+    /* Allocating more than what fits goes to overflow again, further
+       allocations as well even if they'd fit */
+    Containers::StridedArrayView2D<UnsignedShort> d = arena.allocate<UnsignedShort>(ValueInit, {3, 4});
+    CORRADE_COMPARE(d.size()[0], 3);
+    CORRADE_COMPARE(d.size()[1], 4);
+    CORRADE_COMPARE(d[2][3], 0);
+    CORRADE_COMPARE(arena.size(), 27 + 24);
+    /* 27 bytes, padded to 28, 24 bytes */
+    CORRADE_COMPARE(arena.highWaterMark(), 28 + 24);
+
+    /* A reset grows the storage again */
+    arena.reset();
+    CORRADE_COMPARE(arena.capacity(), 52);
+    CORRADE_COMPARE(arena.size(), 52);
+
+    /* A smaller workload doesn't shrink it */
+    arena.allocate<UnsignedInt>(NoInit, 2);
+    arena.reset();
+    CORRADE_COMPARE(arena.capacity(), 52);
+    CORRADE_COMPARE(arena.highWaterMark(), 52);
+}
+
+void AbstractUserInterfaceImplementationTest::frameArenaRelease() {
+    Implementation::FrameArena arena;
+    arena.allocate<UnsignedInt>(NoInit, 16);
+    arena.reset();
+    CORRADE_COMPARE(arena.capacity(), 64);
+
+    /* Release frees everything but remembers the high-water mark, including
+       what was allocated since the last reset */
+    arena.allocate<UnsignedInt>(NoInit, 32);
+    arena.release();
+    CORRADE_COMPARE(arena.capacity(), 0);
+    CORRADE_COMPARE(arena.size(), 0);
+    CORRADE_COMPARE(arena.highWaterMark(), 128);
+
+    /* The next reset allocates all of that at once */
+    arena.reset();
+    CORRADE_COMPARE(arena.capacity(), 128);
+    CORRADE_COMPARE(arena.size(), 128);
+}
+
+void AbstractUserInterfaceImplementationTest::forEachSetBit() {
+    /* 150 bits to span more than two words including a partial last one,
+       with bits at word boundaries and a completely empty middle word */
+    Containers::BitArray bits{ValueInit, 150};
+    bits.set(0);
+    bits.set(5);
+    bits.set(63);
+    bits.set(128);
+    bits.set(129);
+    bits.set(149);
+
+    Containers::Array<std::size_t> indices;
+    Implementation::forEachSetBit(bits, [&](std::size_t i) {
+        arrayAppend(indices, i);
+    });
+    CORRADE_COMPARE_AS(indices, Containers::arrayView<std::size_t>({
+        0, 5, 63, 128, 129, 149
+    }), TestSuite::Compare::Container);
+
+    /* Empty view calls nothing */
+    Implementation::forEachSetBit(Containers::BitArrayView{}, [&](std::size_t) {
+        CORRADE_FAIL("This shouldn't be called");
+    });
+}
+
+void AbstractUserInterfaceImplementationTest::forEachSetBitOffset() {
+    /* All bits set, then taking a view that starts at a non-zero offset and
+       doesn't end at a byte boundary. Only bits inside the view should be
+       reported, relative to its start. */
+    Containers::BitArray bits{DirectInit, 80, true};
+    const Containers::BitArrayView view = bits.slice(3, 70);
+    CORRADE_COMPARE(view.offset(), 3);
+
+    Containers::Array<std::size_t> indices;
+    Implementation::forEachSetBit(view, [&](std::size_t i) {
+        arrayAppend(indices, i);
+    });
+    CORRADE_COMPARE(indices.size(), 67);
+    CORRADE_COMPARE(indices.front(), 0);
+    CORRADE_COMPARE(indices.back(), 66);
+
+    /* Clearing some bits in the underlying array, including the ones right
+       around the view edges */
+    bits.reset(2);
+    bits.reset(3);
+    bits.reset(64);
+    bits.reset(69);
+    bits.reset(70);
+    indices = {};
+    Implementation::forEachSetBit(view, [&](std::size_t i) {
+        arrayAppend(indices, i);
+    });
+    CORRADE_COMPARE(indices.size(), 64);
+    CORRADE_COMPARE(indices.front(), 1);
+    CORRADE_COMPARE(indices[59], 60);
+    CORRADE_COMPARE(indices[60], 62);
+    CORRADE_COMPARE(indices.back(), 65);
+}
+
+void AbstractUserInterfaceImplementationTest::firstUnsetBit() {
+    /* 150 bits with all set except for a few, spanning more than two words
+       including a partial last one */
+    Containers::BitArray bits{DirectInit, 150, true};
+    bits.reset(5);
+    bits.reset(64);
+    bits.reset(149);
+
+    CORRADE_COMPARE(Implementation::firstUnsetBit(bits, 0), 5);
+    CORRADE_COMPARE(Implementation::firstUnsetBit(bits, 5), 5);
+    /* Skips the rest of the first word */
+    CORRADE_COMPARE(Implementation::firstUnsetBit(bits, 6), 64);
+    /* Skips the whole second word and the fully set part of the third */
+    CORRADE_COMPARE(Implementation::firstUnsetBit(bits, 65), 149);
+    CORRADE_COMPARE(Implementation::firstUnsetBit(bits, 149), 149);
+    /* At the end, nothing is found */
+    CORRADE_COMPARE(Implementation::firstUnsetBit(bits, 150), 150);
+
+    /* All set, nothing is found. Bits after the end of the array, which are
+       zero, aren't treated as unset. */
+    bits.set(5);
+    bits.set(64);
+    bits.set(149);
+    CORRADE_COMPARE(Implementation::firstUnsetBit(bits, 0), 150);
+
+    /* A view with a non-zero offset reports indices relative to its start,
+       unset bits right before the view aren't considered */
+    bits.reset(2);
+    bits.reset(10);
+    bits.reset(70);
+    const Containers::BitArrayView view = bits.slice(3, 70);
+    CORRADE_COMPARE(view.offset(), 3);
+    CORRADE_COMPARE(Implementation::firstUnsetBit(view, 0), 7);
+    /* Unset bits right after the view aren't considered either */
+    CORRADE_COMPARE(Implementation::firstUnsetBit(view, 8), 67);
+
+    /* Empty view */
+    CORRADE_COMPARE(Implementation::firstUnsetBit(Containers::BitArrayView{}, 0), 0);
+}
+
+void AbstractUserInterfaceImplementationTest::dirtyRanges() {
+    /* Blocks of 3 bytes, the last one is just 2 */
+    const char previous[]{
+        'a', 'b', 'c',
+        'd', 'e', 'f',
+        'g', 'h', 'i',
+        'j', 'k', 'l',
+        'm', 'n', 'o',
+        'p', 'q'
+    };
+    const char current[]{
+        'a', 'b', 'c',
+        'd', 'E', 'f',  /* changed */
+        'g', 'h', 'I',  /* changed, adjacent to the previous */
+        'j', 'k', 'l',
+        'm', 'n', 'o',
+        'p', 'Q'        /* changed */
+    };
+
+    Containers::Pair<std::size_t, std::size_t> ranges[4];
+    CORRADE_COMPARE(Implementation::dirtyRangesInto(previous, current, 3, ranges), 2);
+    CORRADE_COMPARE_AS(Containers::arrayView(ranges).prefix(2), (Containers::arrayView<Containers::Pair<std::size_t, std::size_t>>({
+        {3, 6},
+        {15, 2}
+    })), TestSuite::Compare::Container);
+
+    /* Nothing changed */
+    CORRADE_COMPARE(Implementation::dirtyRangesInto(previous, previous, 3, ranges), 0);
+
+    /* Empty input */
+    CORRADE_COMPARE(Implementation::dirtyRangesInto({}, {}, 3, ranges), 0);
+}
+
+void AbstractUserInterfaceImplementationTest::dirtyRangesOverflow() {
+    const char previous[]{
+        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'
+    };
+    const char current[]{
+        'A', 'b', 'C', 'd', 'E', 'f', 'G', 'h'
+    };
+
+    /* With just two ranges available, the second one gets extended to cover
+       all remaining changed blocks, including the unchanged ones in
+       between */
+    Containers::Pair<std::size_t, std::size_t> ranges[2];
+    CORRADE_COMPARE(Implementation::dirtyRangesInto(previous, current, 1, ranges), 2);
+    CORRADE_COMPARE_AS(Containers::arrayView(ranges), (Containers::arrayView<Containers::Pair<std::size_t, std::size_t>>({
+        {0, 1},
+        {2, 5}
+    })), TestSuite::Compare::Container);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::AbstractUserInterfaceImplementationTest)
@@ -62,6 +62,8 @@ struct AbstractVisualLayerTest: TestSuite::Tester {
     void constructMove();
 
     template<class T> void setStyle();
+    void setStyleMultiple();
+    void setStyleMultipleInvalid();
     void setTransitionedStyle();
     void setTransitionedStyleInEvent();
     void invalidHandle();
@@ -80,6 +82,9 @@ struct AbstractVisualLayerTest: TestSuite::Tester {
     void eventStyleTransitionNoCapture();
     void eventStyleTransitionOutOfRange();
     void eventStyleTransitionDynamicStyle();
+    void eventStyleTransitionTables();
+    void eventStyleTransitionTablesInvalid();
+    void eventStyleTransitionBakeOutOfRange();
 
     void sharedNeedsUpdateStatePropagatedToLayers();
 };
@@ -287,6 +292,14 @@ const struct {
         true, false, true, true, false, false},
 };
 
+const struct {
+    const char* name;
+    bool baked;
+} EventStyleTransitionTablesData[]{
+    {"tables", false},
+    {"baked functions", true}
+};
+
 AbstractVisualLayerTest::AbstractVisualLayerTest() {
     addTests({&AbstractVisualLayerTest::sharedConstruct,
               &AbstractVisualLayerTest::sharedConstructNoCreate,
@@ -303,7 +316,10 @@ AbstractVisualLayerTest::AbstractVisualLayerTest() {
         &AbstractVisualLayerTest::setStyle<Enum>},
         Containers::arraySize(SetStyleData));
 
-    addTests({&AbstractVisualLayerTest::setTransitionedStyle,
+    addTests({&AbstractVisualLayerTest::setStyleMultiple,
+              &AbstractVisualLayerTest::setStyleMultipleInvalid,
+
+              &AbstractVisualLayerTest::setTransitionedStyle,
               &AbstractVisualLayerTest::setTransitionedStyleInEvent,
               &AbstractVisualLayerTest::invalidHandle});
 
@@ -341,6 +357,12 @@ AbstractVisualLayerTest::AbstractVisualLayerTest() {
     addInstancedTests({&AbstractVisualLayerTest::eventStyleTransitionDynamicStyle},
         Containers::arraySize(EventStyleTransitionDynamicStyleData));
 
+    addInstancedTests({&AbstractVisualLayerTest::eventStyleTransitionTables},
+        Containers::arraySize(EventStyleTransitionTablesData));
+
+    addTests({&AbstractVisualLayerTest::eventStyleTransitionTablesInvalid,
+              &AbstractVisualLayerTest::eventStyleTransitionBakeOutOfRange});
+
     addTests({&AbstractVisualLayerTest::sharedNeedsUpdateStatePropagatedToLayers});
 }
 
@@ -457,6 +479,8 @@ void AbstractVisualLayerTest::construct() {
     CORRADE_COMPARE(&layer.shared(), &shared);
     /* Const overload */
     CORRADE_COMPARE(&static_cast<const Layer&>(layer).shared(), &shared);
+    /* Only events needed for style transitions are handled */
+    CORRADE_COMPARE(layer.events(), LayerEvent::Pointer|LayerEvent::PointerMove|LayerEvent::Focus);
 }
 
 void AbstractVisualLayerTest::constructCopy() {
@@ -584,6 +608,83 @@ template<class T> void AbstractVisualLayerTest::setStyle() {
     CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
 }
 
+void AbstractVisualLayerTest::setStyleMultiple() {
+    StyleLayerShared shared{StyleCount, 3};
+    StyleLayer layer{layerHandle(0, 1), shared};
+
+    DataHandle data1 = layer.create(StyleIndex::Red);
+    DataHandle data2 = layer.create(StyleIndex::Green);
+    DataHandle data3 = layer.create(StyleIndex::Blue);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* An empty view doesn't mark the layer as dirty */
+    layer.setStyle(Containers::StridedArrayView1D<const DataHandle>{}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting multiple styles marks the layer as dirty, data not in the list
+       stay unchanged. Using also a dynamic style. */
+    DataHandle handles[]{data3, data1};
+    UnsignedInt styles[]{StyleCount + 2, UnsignedInt(StyleIndex::BlueFocused)};
+    layer.setStyle(handles, styles);
+    CORRADE_COMPARE(layer.style(data1), UnsignedInt(StyleIndex::BlueFocused));
+    CORRADE_COMPARE(layer.style(data2), UnsignedInt(StyleIndex::Green));
+    CORRADE_COMPARE(layer.style(data3), StyleCount + 2);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    LayerDataHandle layerHandles[]{dataHandleData(data2)};
+    UnsignedInt layerStyles[]{UnsignedInt(StyleIndex::RedHover)};
+    layer.setStyle(layerHandles, layerStyles);
+    CORRADE_COMPARE(layer.style(data1), UnsignedInt(StyleIndex::BlueFocused));
+    CORRADE_COMPARE(layer.style(data2), UnsignedInt(StyleIndex::RedHover));
+    CORRADE_COMPARE(layer.style(data3), StyleCount + 2);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void AbstractVisualLayerTest::setStyleMultipleInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    StyleLayerShared shared{StyleCount, 3};
+    StyleLayer layer{layerHandle(0, 1), shared};
+
+    DataHandle data1 = layer.create(StyleIndex::Red);
+    DataHandle data2 = layer.create(StyleIndex::Green);
+
+    DataHandle handles[]{data1, data2};
+    DataHandle handlesInvalid[]{data1, DataHandle::Null};
+    LayerDataHandle layerHandles[]{dataHandleData(data1), dataHandleData(data2)};
+    LayerDataHandle layerHandlesInvalid[]{dataHandleData(data1), LayerDataHandle::Null};
+    UnsignedInt styles[]{1, 2};
+    UnsignedInt stylesOutOfRange[]{1, StyleCount + 3};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.setStyle(handles, Containers::arrayView(styles).prefix(1));
+    layer.setStyle(layerHandles, Containers::arrayView(styles).prefix(1));
+    layer.setStyle(handlesInvalid, styles);
+    layer.setStyle(layerHandlesInvalid, styles);
+    layer.setStyle(handles, stylesOutOfRange);
+    layer.setStyle(layerHandles, stylesOutOfRange);
+    CORRADE_COMPARE(out,
+        "Ui::AbstractVisualLayer::setStyle(): expected handle and style views to have the same size but got 2 and 1\n"
+        "Ui::AbstractVisualLayer::setStyle(): expected handle and style views to have the same size but got 2 and 1\n"
+        "Ui::AbstractVisualLayer::setStyle(): invalid handle Ui::DataHandle::Null at index 1\n"
+        "Ui::AbstractVisualLayer::setStyle(): invalid handle Ui::LayerDataHandle::Null at index 1\n"
+        "Ui::AbstractVisualLayer::setStyle(): style 21 at index 1 out of range for 21 styles\n"
+        "Ui::AbstractVisualLayer::setStyle(): style 21 at index 1 out of range for 21 styles\n");
+
+    /* Nothing should be changed by the failed calls */
+    CORRADE_COMPARE(layer.style(data1), UnsignedInt(StyleIndex::Red));
+    CORRADE_COMPARE(layer.style(data2), UnsignedInt(StyleIndex::Green));
+}
+
 void AbstractVisualLayerTest::setTransitionedStyle() {
     AbstractUserInterface ui{{100, 100}};
 
@@ -1274,6 +1375,11 @@ void AbstractVisualLayerTest::dynamicStyleAllocateRecycle() {
     CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 4);
     CORRADE_COMPARE(layer.dynamicStyleAnimation(3), AnimationHandle::Null);
 
+    /* Associating with a different animation later */
+    layer.setDynamicStyleAnimation(*fourth, AnimationHandle(0x98fe76543abc));
+    CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 4);
+    CORRADE_COMPARE(layer.dynamicStyleAnimation(3), AnimationHandle(0x98fe76543abc));
+
     /* Recycle a subset in random order */
     layer.recycleDynamicStyle(*third);
     CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 3);
@@ -1346,11 +1452,15 @@ void AbstractVisualLayerTest::dynamicStyleRecycleInvalid() {
     Containers::String out;
     Error redirectError{&out};
     layer.recycleDynamicStyle(2);
+    layer.setDynamicStyleAnimation(2, AnimationHandle::Null);
     layer.dynamicStyleAnimation(4);
+    layer.setDynamicStyleAnimation(4, AnimationHandle::Null);
     layer.recycleDynamicStyle(4);
     CORRADE_COMPARE(out,
         "Ui::AbstractVisualLayer::recycleDynamicStyle(): style 2 not allocated\n"
+        "Ui::AbstractVisualLayer::setDynamicStyleAnimation(): style 2 not allocated\n"
         "Ui::AbstractVisualLayer::dynamicStyleAnimation(): index 4 out of range for 4 dynamic styles\n"
+        "Ui::AbstractVisualLayer::setDynamicStyleAnimation(): index 4 out of range for 4 dynamic styles\n"
         "Ui::AbstractVisualLayer::recycleDynamicStyle(): index 4 out of range for 4 dynamic styles\n");
 }
 
@@ -3898,6 +4008,128 @@ UnsignedInt typeErasedTransition2(UnsignedInt style) {
     return style*3;
 }
 
+void AbstractVisualLayerTest::eventStyleTransitionTables() {
+    auto&& data = EventStyleTransitionTablesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Style 0 is inactive out, 1 inactive over, 2 pressed out, 3 pressed
+       over, 4 disabled. Focused transitions are left as no-op. */
+    StyleLayerShared shared{5, 0};
+    if(data.baked) shared
+        .setStyleTransition(
+            [](UnsignedInt) { return 0u; },
+            [](UnsignedInt) { return 1u; },
+            nullptr,
+            nullptr,
+            [](UnsignedInt) { return 2u; },
+            [](UnsignedInt) { return 3u; },
+            [](UnsignedInt) { return 4u; })
+        .bakeStyleTransitions();
+    else {
+        const UnsignedInt toInactiveOut[]{0, 0, 0, 0, 0};
+        const UnsignedInt toInactiveOver[]{1, 1, 1, 1, 1};
+        const UnsignedInt toPressedOut[]{2, 2, 2, 2, 2};
+        const UnsignedInt toPressedOver[]{3, 3, 3, 3, 3};
+        const UnsignedInt toDisabled[]{4, 4, 4, 4, 4};
+        shared.setStyleTransitionTables(toInactiveOut, toInactiveOver, {}, {}, toPressedOut, toPressedOver, toDisabled);
+    }
+
+    AbstractUserInterface ui{{100, 100}};
+
+    NodeHandle node = ui.createNode({1.0f, 1.0f}, {2.0f, 2.0f});
+    NodeHandle nodeDisabled = ui.createNode({4.0f, 1.0f}, {2.0f, 2.0f}, NodeFlag::Disabled);
+
+    StyleLayer& layer = ui.setLayerInstance(Containers::pointer<StyleLayer>(ui.createLayer(), shared));
+    DataHandle nodeData = layer.create(0u, node);
+    DataHandle nodeDisabledData = layer.create(1u, nodeDisabled);
+
+    ui.update();
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+    CORRADE_COMPARE(layer.stateData().calculatedStyles[dataHandleId(nodeData)], 0);
+    CORRADE_COMPARE(layer.stateData().calculatedStyles[dataHandleId(nodeDisabledData)], 4);
+
+    {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({2.0f, 2.0f}, event));
+        CORRADE_COMPARE(ui.currentHoveredNode(), node);
+        CORRADE_COMPARE(layer.style(nodeData), 1);
+        CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    } {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerPressEvent({2.0f, 2.0f}, event));
+        CORRADE_COMPARE(ui.currentPressedNode(), node);
+        CORRADE_COMPARE(layer.style(nodeData), 3);
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({10.0f, 10.0f}, event));
+        CORRADE_COMPARE(ui.currentHoveredNode(), NodeHandle::Null);
+        CORRADE_COMPARE(layer.style(nodeData), 2);
+    } {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerReleaseEvent({10.0f, 10.0f}, event));
+        CORRADE_COMPARE(ui.currentPressedNode(), NodeHandle::Null);
+        CORRADE_COMPARE(layer.style(nodeData), 0);
+    }
+
+    ui.update();
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+    CORRADE_COMPARE(layer.stateData().calculatedStyles[dataHandleId(nodeData)], 0);
+    CORRADE_COMPARE(layer.stateData().calculatedStyles[dataHandleId(nodeDisabledData)], 4);
+
+    /* Baking again does nothing and doesn't trigger any update */
+    shared.bakeStyleTransitions();
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting the tables or functions again triggers an update of the
+       disabled styles */
+    shared.setStyleTransition(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    ui.update();
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+    CORRADE_COMPARE(layer.stateData().calculatedStyles[dataHandleId(nodeDisabledData)], 1);
+}
+
+void AbstractVisualLayerTest::eventStyleTransitionTablesInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    StyleLayerShared shared{3, 0};
+
+    const UnsignedInt two[]{0, 1};
+    const UnsignedInt three[]{0, 1, 2};
+    const UnsignedInt threeOutOfRange[]{0, 3, 2};
+
+    Containers::String out;
+    Error redirectError{&out};
+    shared.setStyleTransitionTables({}, {}, {}, two, {}, {}, {});
+    shared.setStyleTransitionTables(three, three, three, three, three, three, two);
+    shared.setStyleTransitionTables({}, {}, {}, {}, threeOutOfRange, {}, {});
+    CORRADE_COMPARE(out,
+        "Ui::AbstractVisualLayer::Shared::setStyleTransitionTables(): expected toFocusedOver to have either no items or 3 but got 2\n"
+        "Ui::AbstractVisualLayer::Shared::setStyleTransitionTables(): expected toDisabled to have either no items or 3 but got 2\n"
+        "Ui::AbstractVisualLayer::Shared::setStyleTransitionTables(): toPressedOut transition from 1 to 3 out of range for 3 styles\n");
+}
+
+void AbstractVisualLayerTest::eventStyleTransitionBakeOutOfRange() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    StyleLayerShared shared{3, 0};
+    shared.setStyleTransition(
+        nullptr,
+        nullptr,
+        [](UnsignedInt s) { return s*2; },
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr);
+
+    Containers::String out;
+    Error redirectError{&out};
+    shared.bakeStyleTransitions();
+    CORRADE_COMPARE(out,
+        "Ui::AbstractVisualLayer::Shared::bakeStyleTransitions(): style transition from 2 to 4 out of range for 3 styles\n");
+}
+
 void AbstractVisualLayerTest::sharedNeedsUpdateStatePropagatedToLayers() {
     struct LayerShared: AbstractVisualLayer::Shared {
         explicit LayerShared(UnsignedInt styleCount, UnsignedInt dynamicStyleCount): AbstractVisualLayer::Shared{styleCount, dynamicStyleCount} {}
@@ -0,0 +1,125 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/StridedArrayView.h>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/BaseLayer.h"
+#include "Magnum/Ui/Handle.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct BaseLayerBenchmark: TestSuite::Tester {
+    explicit BaseLayerBenchmark();
+
+    void update();
+};
+
+using namespace Math::Literals;
+
+constexpr Vector2i UpdateBenchmarkSize{128, 128};
+
+const struct {
+    const char* name;
+    BaseLayerSharedFlags flags;
+} UpdateData[]{
+    {"default", {}},
+    {"textured",
+        BaseLayerSharedFlag::Textured},
+    {"subdivided quads",
+        BaseLayerSharedFlag::SubdividedQuads},
+    {"instanced quads",
+        BaseLayerSharedFlag::InstancedQuads},
+    {"compact vertices",
+        BaseLayerSharedFlag::CompactVertices},
+    {"compact vertices, textured",
+        BaseLayerSharedFlag::CompactVertices|BaseLayerSharedFlag::Textured},
+};
+
+BaseLayerBenchmark::BaseLayerBenchmark() {
+    addInstancedBenchmarks({&BaseLayerBenchmark::update}, 10,
+        Containers::arraySize(UpdateData));
+}
+
+void BaseLayerBenchmark::update() {
+    auto&& data = UpdateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures just the CPU-side vertex data fill done on a node offset/size
+       update, with one data for every node. The GPU side is benchmarked in
+       BaseLayerGLBenchmark. */
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1}
+        .setFlags(data.flags)
+    };
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {
+        BaseLayerStyleUniform{}
+            .setColor(0xff3366_rgbf)
+    }, {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+    layer.setSize(Vector2{UpdateBenchmarkSize}, UpdateBenchmarkSize);
+
+    const std::size_t count = UpdateBenchmarkSize.product();
+    Containers::Array<UnsignedInt> dataIds{NoInit, count};
+    Containers::Array<Vector2> nodeOffsets{NoInit, count};
+    Containers::Array<Vector2> nodeSizes{NoInit, count};
+    Containers::Array<Float> nodeOpacities{NoInit, count};
+    Containers::BitArray nodesEnabled{DirectInit, count, true};
+    for(Int y = 0; y != UpdateBenchmarkSize.y(); ++y) {
+        for(Int x = 0; x != UpdateBenchmarkSize.x(); ++x) {
+            const UnsignedInt id = y*UpdateBenchmarkSize.x() + x;
+            layer.create(0, nodeHandle(id, 1));
+            dataIds[id] = id;
+            nodeOffsets[id] = {Float(x), Float(y)};
+            nodeSizes[id] = Vector2{1.0f};
+            nodeOpacities[id] = 1.0f;
+        }
+    }
+
+    /* Initial update to have all allocations done outside of the benchmark
+       loop */
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    CORRADE_BENCHMARK(20)
+        layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::BaseLayerBenchmark)
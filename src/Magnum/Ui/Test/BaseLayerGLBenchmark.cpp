@@ -49,6 +49,7 @@ struct BaseLayerGLBenchmark: GL::OpenGLTester {
 
     void vertex();
     void fragment();
+    void backgroundBlur();
 
     private:
         GL::Texture2D _color{NoCreate};
@@ -109,6 +110,25 @@ const struct {
         0, FragmentBenchmarkSize.x()*0.5f, FragmentBenchmarkSize.x()*0.5f, {}},
 };
 
+const struct {
+    const char* name;
+    BaseLayerBackgroundBlurAlgorithm algorithm;
+    UnsignedInt radius, passCount;
+} BackgroundBlurData[]{
+    {"Gaussian, radius 4",
+        BaseLayerBackgroundBlurAlgorithm::Gaussian, 4, 1},
+    {"Gaussian, radius 31",
+        BaseLayerBackgroundBlurAlgorithm::Gaussian, 31, 1},
+    {"Gaussian, radius 31, 4 passes",
+        BaseLayerBackgroundBlurAlgorithm::Gaussian, 31, 4},
+    {"dual Kawase, radius 4",
+        BaseLayerBackgroundBlurAlgorithm::DualKawase, 4, 1},
+    {"dual Kawase, radius 31",
+        BaseLayerBackgroundBlurAlgorithm::DualKawase, 31, 1},
+    {"dual Kawase, radius 31, 4 passes",
+        BaseLayerBackgroundBlurAlgorithm::DualKawase, 31, 4},
+};
+
 BaseLayerGLBenchmark::BaseLayerGLBenchmark() {
     addInstancedBenchmarks({&BaseLayerGLBenchmark::vertex}, 10,
         Containers::arraySize(VertexData),
@@ -121,6 +141,12 @@ BaseLayerGLBenchmark::BaseLayerGLBenchmark() {
         &BaseLayerGLBenchmark::setupFragment,
         &BaseLayerGLBenchmark::teardown,
         BenchmarkType::GpuTime);
+
+    addInstancedBenchmarks({&BaseLayerGLBenchmark::backgroundBlur}, 10,
+        Containers::arraySize(BackgroundBlurData),
+        &BaseLayerGLBenchmark::setupFragment,
+        &BaseLayerGLBenchmark::teardown,
+        BenchmarkType::GpuTime);
 }
 
 void BaseLayerGLBenchmark::setupVertex() {
@@ -258,6 +284,56 @@ void BaseLayerGLBenchmark::fragment() {
         TestSuite::Compare::around(Color4{1.0f/255.0f, 1.0f/255.0f}));
 }
 
+void BaseLayerGLBenchmark::backgroundBlur() {
+    auto&& data = BackgroundBlurData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Renders a single fully transparent data with background blur over the
+       whole size to benchmark mainly the blur itself */
+
+    AbstractUserInterface ui{FragmentBenchmarkSize};
+    RendererGL& renderer = ui.setRendererInstance(Containers::pointer<RendererGL>(RendererGL::Flag::CompositingFramebuffer));
+
+    BaseLayerGL::Shared shared{BaseLayer::Shared::Configuration{1}
+        .setFlags(BaseLayerSharedFlag::BackgroundBlur)
+        .setBackgroundBlurRadius(data.radius)
+        .setBackgroundBlurAlgorithm(data.algorithm)
+    };
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {
+        BaseLayerStyleUniform{}
+            .setColor(0x00000000_rgbaf)
+    }, {});
+
+    BaseLayerGL& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), shared));
+    layer.setBackgroundBlurPassCount(data.passCount);
+
+    NodeHandle node = ui.createNode({}, Vector2{FragmentBenchmarkSize});
+    layer.create(0, node);
+
+    /* A blur of a single color is the same color again, so the output stays
+       the same regardless of how many times it's drawn */
+    GL::Renderer::setClearColor(0xff3366_rgbf);
+    renderer.compositingFramebuffer().clear(GL::FramebufferClear::Color);
+    GL::Renderer::setClearColor(0x00000000_rgbaf);
+
+    ui.update();
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+
+    CORRADE_BENCHMARK(20)
+        ui.draw();
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Verify just one pixel, the BaseLayerGLTest does the rest */
+    Image2D out = renderer.compositingFramebuffer().read({{}, FragmentBenchmarkSize}, {PixelFormat::RGBA8Unorm});
+    CORRADE_COMPARE_WITH(
+        Math::unpack<Color4>(
+            out.pixels<Color4ub>()[std::size_t(FragmentBenchmarkSize.y()/2)]
+                                  [std::size_t(FragmentBenchmarkSize.x()/2)]),
+        0xff3366_rgbf,
+        TestSuite::Compare::around(Color4{1.0f/255.0f, 1.0f/255.0f}));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::BaseLayerGLBenchmark)
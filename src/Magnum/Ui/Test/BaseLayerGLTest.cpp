@@ -33,10 +33,15 @@
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/System.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/DebugTools/CompareImage.h>
+#include <Magnum/GL/Context.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/Extensions.h>
+#endif
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureArray.h>
@@ -66,6 +71,7 @@ struct BaseLayerGLTest: GL::OpenGLTester {
        context */
     void sharedConstructCopy();
     void sharedConstructMove();
+    void sharedCompileFinished();
 
     void construct();
     void constructDerived();
@@ -83,6 +89,8 @@ struct BaseLayerGLTest: GL::OpenGLTester {
     template<BaseLayerSharedFlag flag = BaseLayerSharedFlag{}> void render();
     template<BaseLayerSharedFlag flag = BaseLayerSharedFlag{}> void renderCustomColor();
     template<BaseLayerSharedFlag flag = BaseLayerSharedFlag{}> void renderCustomOutlineWidth();
+    void renderSpecializedShaderVariant();
+    void renderSpecializedShaderVariantDataOutlineWidth();
     template<BaseLayerSharedFlag flag = BaseLayerSharedFlag{}> void renderPadding();
     /* The SubdividedQuads flag shouldn't cover any codepaths for style change
        that weren't already tested above, done "just in case" */
@@ -95,6 +103,7 @@ struct BaseLayerGLTest: GL::OpenGLTester {
     /* The SubdividedQuads flag shouldn't cover any codepaths for dynamic
        styles that weren't already tested above, done "just in case" */
     template<BaseLayerSharedFlag flag = BaseLayerSharedFlag{}> void renderDynamicStyles();
+    void renderDynamicStylesRingBufferedWrapAround();
 
     void renderOrDrawCompositeSetup();
     void renderOrDrawCompositeTeardown();
@@ -104,6 +113,7 @@ struct BaseLayerGLTest: GL::OpenGLTester {
     template<BaseLayerSharedFlag flag = BaseLayerSharedFlag{}> void renderCompositeTextured();
     /* Composite node rectangles aren't affected by the SubdividedQuads flag */
     void renderCompositeNodeRects();
+    void renderCompositeBackgroundBlurCache();
 
     void drawSetup();
     void drawTeardown();
@@ -828,10 +838,28 @@ const struct {
 
 const struct {
     const char* name;
+    BaseLayerSharedFlags flags;
+    bool expectCached;
+} RenderCompositeBackgroundBlurCacheData[]{
+    {"", BaseLayerSharedFlag::BackgroundBlur, false},
+    {"cached", BaseLayerSharedFlag::BackgroundBlurCache, true},
+};
+
+const struct {
+    const char* name;
+    BaseLayerSharedFlags flags;
     bool dataInNodeOrder;
 } DrawOrderData[]{
-    {"data created in node order", true},
-    {"data created randomly", false}
+    {"data created in node order",
+        {}, true},
+    {"data created randomly",
+        {}, false},
+    {"stable indices, data created in node order",
+        BaseLayerSharedFlag::StableIndices, true},
+    {"stable indices, data created randomly",
+        BaseLayerSharedFlag::StableIndices, false},
+    {"instanced quads, data created randomly",
+        BaseLayerSharedFlag::InstancedQuads, false},
 };
 
 const struct {
@@ -851,15 +879,30 @@ const struct {
     bool clip;
     bool singleTopLevel;
     bool flipOrder;
+    BaseLayerSharedFlags flags;
 } DrawClippingData[]{
     {"clipping disabled", "clipping-disabled.png",
-        false, false, false},
+        false, false, false, {}},
     {"clipping top-level nodes", "clipping-enabled.png",
-        true, false, false},
+        true, false, false, {}},
     {"clipping top-level nodes, different node order", "clipping-enabled.png",
-        true, false, true},
+        true, false, true, {}},
     {"single top-level node with clipping subnodes", "clipping-enabled.png",
-        true, true, false},
+        true, true, false, {}},
+    {"clipping top-level nodes, different node order, stable indices", "clipping-enabled.png",
+        true, false, true, BaseLayerSharedFlag::StableIndices},
+    {"single top-level node with clipping subnodes, stable indices", "clipping-enabled.png",
+        true, true, false, BaseLayerSharedFlag::StableIndices},
+    {"clipping disabled, shader clipping", "clipping-disabled.png",
+        false, false, false, BaseLayerSharedFlag::ShaderClipping},
+    {"clipping top-level nodes, different node order, shader clipping", "clipping-enabled.png",
+        true, false, true, BaseLayerSharedFlag::ShaderClipping},
+    {"single top-level node with clipping subnodes, shader clipping", "clipping-enabled.png",
+        true, true, false, BaseLayerSharedFlag::ShaderClipping},
+    {"single top-level node with clipping subnodes, shader clipping, subdivided quads", "clipping-enabled.png",
+        true, true, false, BaseLayerSharedFlag::ShaderClipping|BaseLayerSharedFlag::SubdividedQuads},
+    {"single top-level node with clipping subnodes, shader clipping, stable indices", "clipping-enabled.png",
+        true, true, false, BaseLayerSharedFlag::ShaderClipping|BaseLayerSharedFlag::StableIndices},
 };
 
 BaseLayerGLTest::BaseLayerGLTest() {
@@ -867,6 +910,7 @@ BaseLayerGLTest::BaseLayerGLTest() {
               &BaseLayerGLTest::sharedConstructComposite,
               &BaseLayerGLTest::sharedConstructCopy,
               &BaseLayerGLTest::sharedConstructMove,
+              &BaseLayerGLTest::sharedCompileFinished,
 
               &BaseLayerGLTest::construct,
               &BaseLayerGLTest::constructDerived,
@@ -885,91 +929,128 @@ BaseLayerGLTest::BaseLayerGLTest() {
     /* MSVC needs explicit type due to default template args */
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::render,
-        &BaseLayerGLTest::render<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::render<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::render<BaseLayerSharedFlag::InstancedQuads>,
+        &BaseLayerGLTest::render<BaseLayerSharedFlag::ShaderNodeProperties>,
+        &BaseLayerGLTest::render<BaseLayerSharedFlag::CompactVertices>},
         Containers::arraySize(RenderData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderCustomColor,
-        &BaseLayerGLTest::renderCustomColor<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderCustomColor<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderCustomColor<BaseLayerSharedFlag::InstancedQuads>,
+        &BaseLayerGLTest::renderCustomColor<BaseLayerSharedFlag::ShaderNodeProperties>,
+        &BaseLayerGLTest::renderCustomColor<BaseLayerSharedFlag::CompactVertices>},
         Containers::arraySize(RenderCustomColorData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderCustomOutlineWidth,
-        &BaseLayerGLTest::renderCustomOutlineWidth<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderCustomOutlineWidth<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderCustomOutlineWidth<BaseLayerSharedFlag::InstancedQuads>,
+        &BaseLayerGLTest::renderCustomOutlineWidth<BaseLayerSharedFlag::CompactVertices>},
         Containers::arraySize(RenderCustomOutlineWidthData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
+    addInstancedTests({&BaseLayerGLTest::renderSpecializedShaderVariant},
+        Containers::arraySize(RenderData),
+        &BaseLayerGLTest::renderSetup,
+        &BaseLayerGLTest::renderTeardown);
+
+    addTests({&BaseLayerGLTest::renderSpecializedShaderVariantDataOutlineWidth},
+        &BaseLayerGLTest::renderSetup,
+        &BaseLayerGLTest::renderTeardown);
+
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderPadding,
-        &BaseLayerGLTest::renderPadding<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderPadding<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderPadding<BaseLayerSharedFlag::InstancedQuads>,
+        &BaseLayerGLTest::renderPadding<BaseLayerSharedFlag::ShaderNodeProperties>,
+        &BaseLayerGLTest::renderPadding<BaseLayerSharedFlag::CompactVertices>},
         Containers::arraySize(RenderPaddingData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderChangeStyle,
-        &BaseLayerGLTest::renderChangeStyle<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderChangeStyle<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderChangeStyle<BaseLayerSharedFlag::InstancedQuads>},
         Containers::arraySize(RenderChangeStyleData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderTextured,
-        &BaseLayerGLTest::renderTextured<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderTextured<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderTextured<BaseLayerSharedFlag::InstancedQuads>,
+        &BaseLayerGLTest::renderTextured<BaseLayerSharedFlag::ShaderNodeProperties>,
+        &BaseLayerGLTest::renderTextured<BaseLayerSharedFlag::CompactVertices>},
         Containers::arraySize(RenderTexturedData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderOutlineEdgeSmoothness,
-        &BaseLayerGLTest::renderOutlineEdgeSmoothness<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderOutlineEdgeSmoothness<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderOutlineEdgeSmoothness<BaseLayerSharedFlag::InstancedQuads>},
         Containers::arraySize(RenderOutlineEdgeSmoothnessData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderGradientOutlineEdgeSmoothness,
-        &BaseLayerGLTest::renderGradientOutlineEdgeSmoothness<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderGradientOutlineEdgeSmoothness<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderGradientOutlineEdgeSmoothness<BaseLayerSharedFlag::InstancedQuads>},
         Containers::arraySize(RenderGradientOutlineEdgeSmoothnessData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderTexturedOutlineEdgeSmoothness,
-        &BaseLayerGLTest::renderTexturedOutlineEdgeSmoothness<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderTexturedOutlineEdgeSmoothness<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderTexturedOutlineEdgeSmoothness<BaseLayerSharedFlag::InstancedQuads>,
+        &BaseLayerGLTest::renderTexturedOutlineEdgeSmoothness<BaseLayerSharedFlag::ShaderNodeProperties>},
         Containers::arraySize(RenderTexturedOutlineEdgeSmoothnessData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderDynamicStyles,
-        &BaseLayerGLTest::renderDynamicStyles<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderDynamicStyles<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderDynamicStyles<BaseLayerSharedFlag::InstancedQuads>,
+        &BaseLayerGLTest::renderDynamicStyles<BaseLayerSharedFlag::RingBufferedDynamicStyles>},
         Containers::arraySize(RenderDynamicStylesData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
 
+    addTests({&BaseLayerGLTest::renderDynamicStylesRingBufferedWrapAround},
+        &BaseLayerGLTest::renderSetup,
+        &BaseLayerGLTest::renderTeardown);
+
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderComposite,
-        &BaseLayerGLTest::renderComposite<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderComposite<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderComposite<BaseLayerSharedFlag::InstancedQuads>},
         Containers::arraySize(RenderCompositeData),
         &BaseLayerGLTest::renderOrDrawCompositeSetup,
         &BaseLayerGLTest::renderOrDrawCompositeTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderCompositeEdgeSmoothness,
-        &BaseLayerGLTest::renderCompositeEdgeSmoothness<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderCompositeEdgeSmoothness<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderCompositeEdgeSmoothness<BaseLayerSharedFlag::InstancedQuads>},
         Containers::arraySize(RenderCompositeEdgeSmoothnessData),
         &BaseLayerGLTest::renderOrDrawCompositeSetup,
         &BaseLayerGLTest::renderOrDrawCompositeTeardown);
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderCompositeTextured,
-        &BaseLayerGLTest::renderCompositeTextured<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderCompositeTextured<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderCompositeTextured<BaseLayerSharedFlag::InstancedQuads>},
         Containers::arraySize(RenderCompositeTexturedData),
         &BaseLayerGLTest::renderOrDrawCompositeSetup,
         &BaseLayerGLTest::renderOrDrawCompositeTeardown);
@@ -979,6 +1060,11 @@ BaseLayerGLTest::BaseLayerGLTest() {
         &BaseLayerGLTest::renderOrDrawCompositeSetup,
         &BaseLayerGLTest::renderOrDrawCompositeTeardown);
 
+    addInstancedTests({&BaseLayerGLTest::renderCompositeBackgroundBlurCache},
+        Containers::arraySize(RenderCompositeBackgroundBlurCacheData),
+        &BaseLayerGLTest::renderOrDrawCompositeSetup,
+        &BaseLayerGLTest::renderOrDrawCompositeTeardown);
+
     addInstancedTests({&BaseLayerGLTest::drawOrder},
         Containers::arraySize(DrawOrderData),
         &BaseLayerGLTest::drawSetup,
@@ -1041,6 +1127,23 @@ void BaseLayerGLTest::sharedConstructMove() {
     CORRADE_VERIFY(std::is_nothrow_move_assignable<BaseLayerGL::Shared>::value);
 }
 
+void BaseLayerGLTest::sharedCompileFinished() {
+    /* With background blur to verify both the created and the NoCreate'd
+       shaders are handled */
+    BaseLayerGL::Shared shared{BaseLayer::Shared::Configuration{3}
+        .addFlags(BaseLayerSharedFlag::BackgroundBlur)};
+
+    /* Whether the compilation is still pending right after construction
+       depends on the driver, but it should finish eventually */
+    while(!shared.isCompileFinished())
+        Utility::System::sleep(1);
+    CORRADE_VERIFY(shared.isCompileFinished());
+
+    /* The actual drawing then waits for the result and performs the post-link
+       setup, which is tested by all render*() test cases */
+    MAGNUM_VERIFY_NO_GL_ERROR();
+}
+
 void BaseLayerGLTest::construct() {
     BaseLayerGL::Shared shared{BaseLayer::Shared::Configuration{3}};
 
@@ -1192,7 +1295,16 @@ void BaseLayerGLTest::renderTeardown() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::render() {
     auto&& data = RenderData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" :
+        flag == BaseLayerSharedFlag::ShaderNodeProperties ? "Flag::ShaderNodeProperties" :
+        flag == BaseLayerSharedFlag::CompactVertices ? "Flag::CompactVertices" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(BaseLayerSharedFlags{flag} >= BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     if(flag == BaseLayerSharedFlag::SubdividedQuads && (data.flags & (BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)))
         CORRADE_SKIP(flag << "and" << data.flags << "are mutually exclusive");
@@ -1250,7 +1362,16 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::render() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderCustomColor() {
     auto&& data = RenderCustomColorData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" :
+        flag == BaseLayerSharedFlag::ShaderNodeProperties ? "Flag::ShaderNodeProperties" :
+        flag == BaseLayerSharedFlag::CompactVertices ? "Flag::CompactVertices" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(BaseLayerSharedFlags{flag} >= BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     /* Basically the same as the "gradient" case in render(), except that the
        color is additionally taken from the data and node opacity as well */
@@ -1318,7 +1439,15 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderCustomColor() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderCustomOutlineWidth() {
     auto&& data = RenderCustomOutlineWidthData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" :
+        flag == BaseLayerSharedFlag::CompactVertices ? "Flag::CompactVertices" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     if(flag == BaseLayerSharedFlag::SubdividedQuads && (data.flags & (BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)))
         CORRADE_SKIP(flag << "and" << data.flags << "are mutually exclusive");
@@ -1374,10 +1503,105 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderCustomOutlineWidt
         DebugTools::CompareImageToFile{_manager});
 }
 
+void BaseLayerGLTest::renderSpecializedShaderVariant() {
+    auto&& data = RenderData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Like render(), but waiting until all shaders are compiled before
+       drawing, so the variant specialized for the features the style
+       actually uses gets picked. The output should be the same. */
+
+    AbstractUserInterface ui{RenderSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    BaseLayerGL::Shared layerShared{BaseLayer::Shared::Configuration{1}
+        .setFlags(data.flags)
+    };
+    layerShared.setStyle(data.styleUniformCommon, {data.styleUniform}, {});
+
+    BaseLayer& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), layerShared));
+
+    NodeHandle node = ui.createNode({8.0f, 8.0f}, {112.0f, 48.0f});
+    layer.create(0, node);
+
+    while(!layerShared.isCompileFinished())
+        Utility::System::sleep(1);
+
+    ui.draw();
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    if(!(_manager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
+       !(_manager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("AnyImageImporter / StbImageImporter plugins not found.");
+
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_WEBGL)
+    /* Same problem is with all builtin shaders, so this doesn't seem to be a
+       bug in the base layer shader code */
+    if(GL::Context::current().detectedDriver() & GL::Context::DetectedDriver::SwiftShader)
+        CORRADE_SKIP("UBOs with dynamically indexed arrays don't seem to work on SwiftShader, can't test.");
+    #endif
+    CORRADE_COMPARE_WITH(_framebuffer.read({{}, RenderSize}, {PixelFormat::RGBA8Unorm}),
+        Utility::Path::join({UI_TEST_DIR, "BaseLayerTestFiles", data.filename}),
+        DebugTools::CompareImageToFile{_manager});
+}
+
+void BaseLayerGLTest::renderSpecializedShaderVariantDataOutlineWidth() {
+    /* The style has no outline width, so a variant without outlines gets
+       compiled. But the data have a custom outline width, which the draw has
+       to take into account, so the output should be the same as the
+       "outline, all sides same" case in render(). */
+
+    AbstractUserInterface ui{RenderSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    BaseLayerGL::Shared layerShared{BaseLayer::Shared::Configuration{1}};
+    layerShared.setStyle(BaseLayerCommonStyleUniform{}, {
+        BaseLayerStyleUniform{}
+            .setOutlineColor(0x7f7f7f_rgbf)
+    }, {});
+
+    BaseLayer& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), layerShared));
+
+    NodeHandle node = ui.createNode({8.0f, 8.0f}, {112.0f, 48.0f});
+    DataHandle nodeData = layer.create(0, node);
+    layer.setOutlineWidth(nodeData, Vector4{8.0f});
+
+    while(!layerShared.isCompileFinished())
+        Utility::System::sleep(1);
+
+    ui.draw();
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    if(!(_manager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
+       !(_manager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("AnyImageImporter / StbImageImporter plugins not found.");
+
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_WEBGL)
+    /* Same problem is with all builtin shaders, so this doesn't seem to be a
+       bug in the base layer shader code */
+    if(GL::Context::current().detectedDriver() & GL::Context::DetectedDriver::SwiftShader)
+        CORRADE_SKIP("UBOs with dynamically indexed arrays don't seem to work on SwiftShader, can't test.");
+    #endif
+    CORRADE_COMPARE_WITH(_framebuffer.read({{}, RenderSize}, {PixelFormat::RGBA8Unorm}),
+        Utility::Path::join({UI_TEST_DIR, "BaseLayerTestFiles", "outline-same.png"}),
+        DebugTools::CompareImageToFile{_manager});
+}
+
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderPadding() {
     auto&& data = RenderPaddingData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" :
+        flag == BaseLayerSharedFlag::ShaderNodeProperties ? "Flag::ShaderNodeProperties" :
+        flag == BaseLayerSharedFlag::CompactVertices ? "Flag::CompactVertices" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(BaseLayerSharedFlags{flag} >= BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     /* Basically the same as the "outline, rounded corners, different" case in
        render(), except that the node offset, size and style or data padding
@@ -1441,7 +1665,14 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderPadding() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderChangeStyle() {
     auto&& data = RenderChangeStyleData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     /* Basically the same as the "gradient" case in render(), except that the
        style ID is changed to it only later. */
@@ -1498,7 +1729,16 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderChangeStyle() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderTextured() {
     auto&& data = RenderTexturedData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" :
+        flag == BaseLayerSharedFlag::ShaderNodeProperties ? "Flag::ShaderNodeProperties" :
+        flag == BaseLayerSharedFlag::CompactVertices ? "Flag::CompactVertices" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(BaseLayerSharedFlags{flag} >= BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     if(!(_manager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
        !(_manager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
@@ -1577,7 +1817,14 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderTextured() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderOutlineEdgeSmoothness() {
     auto&& data = RenderOutlineEdgeSmoothnessData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     /* It should produce the same result (8 *pixel* smoothness either inside or
        outside or both) regardless of the actual UI size */
@@ -1679,7 +1926,14 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderOutlineEdgeSmooth
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderGradientOutlineEdgeSmoothness() {
     auto&& data = RenderGradientOutlineEdgeSmoothnessData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     /* The gradient should extend also under the outline. Testing by expanding
        the quad outside with negative padding, cancelling that with a
@@ -1750,7 +2004,15 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderGradientOutlineEd
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderTexturedOutlineEdgeSmoothness() {
     auto&& data = RenderTexturedOutlineEdgeSmoothnessData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" :
+        flag == BaseLayerSharedFlag::ShaderNodeProperties ? "Flag::ShaderNodeProperties" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(BaseLayerSharedFlags{flag} >= BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     /* The texture should extend also under the outline. Testing by expanding
        the quad outside with negative padding, cancelling that with a
@@ -1837,7 +2099,15 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderTexturedOutlineEd
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderDynamicStyles() {
     auto&& data = RenderDynamicStylesData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" :
+        flag == BaseLayerSharedFlag::RingBufferedDynamicStyles ? "Flag::RingBufferedDynamicStyles" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     AbstractUserInterface ui{RenderSize};
     ui.setRendererInstance(Containers::pointer<RendererGL>());
@@ -1949,6 +2219,64 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderDynamicStyles() {
         DebugTools::CompareImageToFile{_manager});
 }
 
+void BaseLayerGLTest::renderDynamicStylesRingBufferedWrapAround() {
+    AbstractUserInterface ui{RenderSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    BaseLayerGL::Shared layerShared{
+        BaseLayer::Shared::Configuration{1}
+            .addFlags(BaseLayerSharedFlag::RingBufferedDynamicStyles)
+            .setDynamicStyleCount(2)
+    };
+    layerShared.setStyle(BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}},
+        {});
+
+    BaseLayerGL& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), layerShared));
+
+    /* The first dynamic style comes right after the single static one */
+    NodeHandle node = ui.createNode({8.0f, 8.0f}, {112.0f, 48.0f});
+    layer.create(1, node);
+
+    if(!(_manager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
+       !(_manager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("AnyImageImporter / StbImageImporter plugins not found.");
+
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_WEBGL)
+    /* Same problem is with all builtin shaders, so this doesn't seem to be a
+       bug in the base layer shader code */
+    if(GL::Context::current().detectedDriver() & GL::Context::DetectedDriver::SwiftShader)
+        CORRADE_SKIP("UBOs with dynamically indexed arrays don't seem to work on SwiftShader, can't test.");
+    #endif
+
+    /* Alternate between two styles for more updates than there are buffers in
+       the ring. Once it wraps around, the buffer being written to contains the
+       style from two updates ago, which should be correctly detected as
+       differing from the current one and uploaded. */
+    for(std::size_t i = 0; i != 5; ++i) {
+        CORRADE_ITERATION(i);
+
+        if(i % 2 == 0) layer.setDynamicStyle(0,
+            BaseLayerStyleUniform{}
+                .setColor(0xffffff_rgbf, 0x333333_rgbf)
+                .setOutlineColor(0x3333ff_rgbf)
+                .setOutlineWidth(8.0f),
+            {});
+        else layer.setDynamicStyle(0,
+            BaseLayerStyleUniform{},
+            {});
+
+        _framebuffer.clear(GL::FramebufferClear::Color);
+        ui.draw();
+        CORRADE_COMPARE(layer.state(), LayerStates{});
+
+        MAGNUM_VERIFY_NO_GL_ERROR();
+        CORRADE_COMPARE_WITH(_framebuffer.read({{}, RenderSize}, {PixelFormat::RGBA8Unorm}),
+            Utility::Path::join({UI_TEST_DIR, "BaseLayerTestFiles", i % 2 == 0 ? "outline-gradient.png" : "default.png"}),
+            DebugTools::CompareImageToFile{_manager});
+    }
+}
+
 void BaseLayerGLTest::renderOrDrawCompositeSetup() {
     /* Using the framebuffer inside the RendererGL instead, thus this can be
        also shared for all render*() and draw*() cases */
@@ -1972,7 +2300,14 @@ void BaseLayerGLTest::renderOrDrawCompositeTeardown() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderComposite() {
     auto&& data = RenderCompositeData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     if(!(_manager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
        !(_manager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
@@ -2039,7 +2374,14 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderComposite() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderCompositeEdgeSmoothness() {
     auto&& data = RenderCompositeEdgeSmoothnessData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     if(!(_manager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
        !(_manager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
@@ -2131,7 +2473,14 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderCompositeEdgeSmoo
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderCompositeTextured() {
     auto&& data = RenderCompositeTexturedData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
 
     if(!(_manager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
        !(_manager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
@@ -2305,6 +2654,81 @@ void BaseLayerGLTest::renderCompositeNodeRects() {
         (DebugTools::CompareImageToFile{_manager, data.maxThreshold, data.meanThreshold}));
 }
 
+void BaseLayerGLTest::renderCompositeBackgroundBlurCache() {
+    auto&& data = RenderCompositeBackgroundBlurCacheData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_WEBGL)
+    /* Same problem is with all builtin shaders, so this doesn't seem to be a
+       bug in the base layer shader code */
+    if(GL::Context::current().detectedDriver() & GL::Context::DetectedDriver::SwiftShader)
+        CORRADE_SKIP("UBOs with dynamically indexed arrays don't seem to work on SwiftShader, can't test.");
+    #endif
+
+    AbstractUserInterface ui{RenderSize};
+    RendererGL& renderer = ui.setRendererInstance(Containers::pointer<RendererGL>(RendererGL::Flag::CompositingFramebuffer));
+
+    /* A fully transparent quad, so the output is just the blurred background.
+       A blur of a single color is the same color again, so it's enough to
+       check a single pixel to know whether the blur was redone with a
+       different background or not. */
+    BaseLayerGL::Shared layerShared{BaseLayerGL::Shared::Configuration{1}
+        .addFlags(data.flags)};
+    layerShared.setStyle(
+        BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}
+            .setColor(0x00000000_rgbaf)},
+        {});
+
+    BaseLayerGL& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), layerShared));
+
+    NodeHandle node = ui.createNode({32.0f, 16.0f}, {64.0f, 32.0f});
+    layer.create(0, node);
+
+    const Range2Di center = Range2Di::fromSize(RenderSize/2, {1, 1});
+    const Range2Di corner = Range2Di::fromSize({}, {1, 1});
+
+    renderer.compositingFramebuffer().clearColor(0, 0xff3366_rgbf);
+    ui.draw();
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.compositingFramebuffer().read(center, {PixelFormat::RGBA8Unorm}).pixels<Color4ub>()[0][0], 0xff3366_rgb);
+
+    /* Changing the background without telling the renderer doesn't redo the
+       blur if cached, the area outside of the node isn't affected by the
+       cache in any way */
+    renderer.compositingFramebuffer().clearColor(0, 0x3366ff_rgbf);
+    ui.draw();
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.compositingFramebuffer().read(center, {PixelFormat::RGBA8Unorm}).pixels<Color4ub>()[0][0], data.expectCached ? 0xff3366_rgb : 0x3366ff_rgb);
+    CORRADE_COMPARE(renderer.compositingFramebuffer().read(corner, {PixelFormat::RGBA8Unorm}).pixels<Color4ub>()[0][0], 0x3366ff_rgb);
+
+    /* Incrementing the content generation redoes it */
+    renderer.incrementCompositingContentGeneration();
+    ui.draw();
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.compositingFramebuffer().read(center, {PixelFormat::RGBA8Unorm}).pixels<Color4ub>()[0][0], 0x3366ff_rgb);
+
+    /* Changing the pass count redoes it as well */
+    renderer.compositingFramebuffer().clearColor(0, 0xff3366_rgbf);
+    layer.setBackgroundBlurPassCount(2);
+    ui.draw();
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.compositingFramebuffer().read(center, {PixelFormat::RGBA8Unorm}).pixels<Color4ub>()[0][0], 0xff3366_rgb);
+
+    /* And changing the composite rect too */
+    renderer.compositingFramebuffer().clearColor(0, 0x3366ff_rgbf);
+    ui.setNodeOffset(node, {24.0f, 16.0f});
+    ui.draw();
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.compositingFramebuffer().read(center, {PixelFormat::RGBA8Unorm}).pixels<Color4ub>()[0][0], 0x3366ff_rgb);
+
+    /* Changing nothing keeps the previous result again */
+    renderer.compositingFramebuffer().clearColor(0, 0xff3366_rgbf);
+    ui.draw();
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.compositingFramebuffer().read(center, {PixelFormat::RGBA8Unorm}).pixels<Color4ub>()[0][0], data.expectCached ? 0x3366ff_rgb : 0xff3366_rgb);
+}
+
 constexpr Vector2i DrawSize{64, 64};
 
 void BaseLayerGLTest::drawSetup() {
@@ -2336,10 +2760,16 @@ void BaseLayerGLTest::drawOrder() {
     auto&& data = DrawOrderData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
+    #ifndef MAGNUM_TARGET_GLES
+    if(data.flags >= BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
+
     AbstractUserInterface ui{DrawSize};
     ui.setRendererInstance(Containers::pointer<RendererGL>());
 
-    BaseLayerGL::Shared layerShared{BaseLayer::Shared::Configuration{3}};
+    BaseLayerGL::Shared layerShared{BaseLayer::Shared::Configuration{3}
+        .setFlags(data.flags)};
     /* Testing the styleToUniform initializer list overload, others cases use
        implicit mapping initializer list overloads */
     layerShared.setStyle(BaseLayerCommonStyleUniform{}, {
@@ -2471,7 +2901,8 @@ void BaseLayerGLTest::drawClipping() {
     AbstractUserInterface ui{{640.0f, 6400.0f}, {1.0f, 1.0f}, DrawSize};
     ui.setRendererInstance(Containers::pointer<RendererGL>());
 
-    BaseLayerGL::Shared layerShared{BaseLayer::Shared::Configuration{3}};
+    BaseLayerGL::Shared layerShared{BaseLayer::Shared::Configuration{3}
+        .setFlags(data.flags)};
     layerShared.setStyle(BaseLayerCommonStyleUniform{}, {
         BaseLayerStyleUniform{}         /* 0, red */
             .setColor(0xff0000_rgbf),
@@ -35,12 +35,14 @@
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Magnum/Animation/Easing.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Time.h>
 
 #include "Magnum/Ui/BaseLayer.h"
 #include "Magnum/Ui/BaseLayerAnimator.h"
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/Implementation/baseLayerState.h" /* for layerAdvance() */
+#include "Magnum/Ui/Implementation/lerpFloats.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
 
@@ -70,9 +72,12 @@ struct BaseLayerStyleAnimatorTest: TestSuite::Tester {
     void advance();
     void advanceProperties();
     void advanceNoFreeDynamicStyles();
+    void advanceSharedDynamicStyles();
     void advanceEmpty();
     void advanceInvalid();
 
+    void lerpFloats();
+
     void layerAdvance();
 };
 
@@ -104,6 +109,20 @@ const struct {
         BaseLayerStyleAnimation::Padding|BaseLayerStyleAnimation::Uniform},
 };
 
+const struct {
+    const char* name;
+    std::size_t count;
+    Float factor;
+} LerpFloatsData[]{
+    {"empty", 0, 0.5f},
+    {"less than four", 3, 0.25f},
+    {"exactly four", 4, 0.75f},
+    {"a whole BaseLayerStyleUniform", 24, 0.125f},
+    {"with a remainder", 11, 0.3f},
+    {"factor 0", 11, 0.0f},
+    {"factor 1", 11, 1.0f},
+};
+
 const struct {
     const char* name;
     Vector4 padding;
@@ -135,9 +154,13 @@ BaseLayerStyleAnimatorTest::BaseLayerStyleAnimatorTest() {
         Containers::arraySize(AdvancePropertiesData));
 
     addTests({&BaseLayerStyleAnimatorTest::advanceNoFreeDynamicStyles,
+              &BaseLayerStyleAnimatorTest::advanceSharedDynamicStyles,
               &BaseLayerStyleAnimatorTest::advanceEmpty,
               &BaseLayerStyleAnimatorTest::advanceInvalid});
 
+    addInstancedTests({&BaseLayerStyleAnimatorTest::lerpFloats},
+        Containers::arraySize(LerpFloatsData));
+
     addInstancedTests({&BaseLayerStyleAnimatorTest::layerAdvance},
         Containers::arraySize(LayerAdvanceData));
 }
@@ -1152,6 +1175,151 @@ void BaseLayerStyleAnimatorTest::advanceNoFreeDynamicStyles() {
     }
 }
 
+void BaseLayerStyleAnimatorTest::advanceSharedDynamicStyles() {
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{3}
+        .setDynamicStyleCount(3)
+    };
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}
+            .setColor(Color4{0.25f}),
+         BaseLayerStyleUniform{}
+            .setColor(Color4{0.75f}),
+         BaseLayerStyleUniform{}},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    BaseLayerStyleAnimator animator{animatorHandle(0, 1)};
+    layer.assignAnimator(animator);
+
+    DataHandle data1 = layer.create(2);
+    DataHandle data2 = layer.create(2);
+    DataHandle data3 = layer.create(2);
+    DataHandle data4 = layer.create(2);
+
+    /* All four animations are the same, just on different data */
+    AnimationHandle first = animator.create(0, 1, Animation::Easing::linear, 0_nsec, 20_nsec, data1);
+    AnimationHandle second = animator.create(0, 1, Animation::Easing::linear, 0_nsec, 20_nsec, data2);
+    AnimationHandle third = animator.create(0, 1, Animation::Easing::linear, 0_nsec, 20_nsec, data3);
+    AnimationHandle fourth = animator.create(0, 1, Animation::Easing::linear, 0_nsec, 20_nsec, data4);
+
+    /* Same as in advanceNoFreeDynamicStyles() */
+    const auto advance = [&](Nanoseconds time, Containers::ArrayView<BaseLayerStyleUniform> dynamicStyleUniforms, const Containers::StridedArrayView1D<UnsignedInt>& dataStyles) {
+        UnsignedByte activeData[1];
+        Containers::MutableBitArrayView active{activeData, 0, 4};
+        Float factors[4];
+        UnsignedByte removeData[1];
+        Containers::MutableBitArrayView remove{removeData, 0, 4};
+
+        Containers::Pair<bool, bool> needsAdvanceClean = animator.update(time, active, factors, remove);
+        BaseLayerStyleAnimations animations;
+        if(needsAdvanceClean.first()) {
+            Vector4 paddings[3];
+            animations = animator.advance(active, factors, remove, dynamicStyleUniforms, paddings, dataStyles);
+        } if(needsAdvanceClean.second())
+            animator.clean(remove);
+        return animations;
+    };
+
+    BaseLayerStyleUniform uniforms[3];
+    UnsignedInt dataStyles[]{666, 666, 666, 666};
+
+    /* First advance allocates just a single dynamic style for all of them,
+       associated with the first animation */
+    {
+        CORRADE_COMPARE(advance(5_nsec, uniforms, dataStyles), BaseLayerStyleAnimation::Uniform|BaseLayerStyleAnimation::Style);
+        CORRADE_COMPARE(animator.dynamicStyle(first), 0);
+        CORRADE_COMPARE(animator.dynamicStyle(second), 0);
+        CORRADE_COMPARE(animator.dynamicStyle(third), 0);
+        CORRADE_COMPARE(animator.dynamicStyle(fourth), 0);
+        CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 1);
+        CORRADE_COMPARE(layer.dynamicStyleAnimation(0), first);
+        CORRADE_COMPARE_AS(Containers::arrayView(dataStyles), Containers::arrayView({
+            shared.styleCount() + 0u,
+            shared.styleCount() + 0u,
+            shared.styleCount() + 0u,
+            shared.styleCount() + 0u
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE(uniforms[0].topColor, Color4{0.375f});
+
+    /* Removing the first animation keeps the style used by the others and
+       associates it with the next one */
+    } {
+        animator.remove(first);
+        CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 1);
+        CORRADE_COMPARE(layer.dynamicStyleAnimation(0), second);
+
+    /* Pausing the third animation at the time of next advance makes it still
+       have the same factor as the others, so the style stays shared */
+    } {
+        animator.pause(third, 10_nsec);
+        CORRADE_COMPARE(advance(10_nsec, uniforms, dataStyles), BaseLayerStyleAnimation::Uniform);
+        CORRADE_COMPARE(animator.dynamicStyle(second), 0);
+        CORRADE_COMPARE(animator.dynamicStyle(third), 0);
+        CORRADE_COMPARE(animator.dynamicStyle(fourth), 0);
+        CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 1);
+        CORRADE_COMPARE(uniforms[0].topColor, Color4{0.5f});
+
+    /* In the next advance the paused animation isn't advanced anymore, so it
+       gets its own copy of the style, which doesn't change further */
+    } {
+        CORRADE_COMPARE(advance(15_nsec, uniforms, dataStyles), BaseLayerStyleAnimation::Uniform|BaseLayerStyleAnimation::Style);
+        CORRADE_COMPARE(animator.dynamicStyle(second), 0);
+        CORRADE_COMPARE(animator.dynamicStyle(third), 1);
+        CORRADE_COMPARE(animator.dynamicStyle(fourth), 0);
+        CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 2);
+        CORRADE_COMPARE(layer.dynamicStyleAnimation(0), second);
+        CORRADE_COMPARE(layer.dynamicStyleAnimation(1), third);
+        CORRADE_COMPARE_AS(Containers::arrayView(dataStyles), Containers::arrayView({
+            /* The first animation was removed without touching the data */
+            shared.styleCount() + 0u,
+            shared.styleCount() + 0u,
+            shared.styleCount() + 1u,
+            shared.styleCount() + 0u
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE(uniforms[0].topColor, Color4{0.625f});
+        CORRADE_COMPARE(uniforms[1].topColor, Color4{0.5f});
+
+    /* Once the remaining animations stop, the shared style gets recycled as
+       well, while the paused one stays */
+    } {
+        CORRADE_COMPARE(advance(20_nsec, uniforms, dataStyles), BaseLayerStyleAnimation::Style);
+        CORRADE_VERIFY(!animator.isHandleValid(second));
+        CORRADE_VERIFY(!animator.isHandleValid(fourth));
+        CORRADE_COMPARE(animator.dynamicStyle(third), 1);
+        CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 1);
+        CORRADE_COMPARE(layer.dynamicStyleAnimation(0), AnimationHandle::Null);
+        CORRADE_COMPARE(layer.dynamicStyleAnimation(1), third);
+        CORRADE_COMPARE_AS(Containers::arrayView(dataStyles), Containers::arrayView({
+            shared.styleCount() + 0u,
+            1u,
+            shared.styleCount() + 1u,
+            1u
+        }), TestSuite::Compare::Container);
+    }
+
+    /* Animations with a different timing don't share the style. Capacity
+       stays at four as the IDs get recycled. */
+    {
+        DataHandle data5 = layer.create(2);
+        AnimationHandle fifth = animator.create(0, 1, Animation::Easing::linear, 20_nsec, 10_nsec, data5);
+        AnimationHandle sixth = animator.create(0, 1, Animation::Easing::linear, 20_nsec, 20_nsec, data1);
+        UnsignedInt dataStyles5[]{666, 666, 666, 666, 666};
+        CORRADE_COMPARE(advance(25_nsec, uniforms, dataStyles5), BaseLayerStyleAnimation::Uniform|BaseLayerStyleAnimation::Style);
+        CORRADE_VERIFY(animator.dynamicStyle(fifth));
+        CORRADE_VERIFY(animator.dynamicStyle(sixth));
+        CORRADE_VERIFY(*animator.dynamicStyle(fifth) != *animator.dynamicStyle(sixth));
+        CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 3);
+    }
+}
+
 void BaseLayerStyleAnimatorTest::advanceEmpty() {
     /* This should work even with no layer being set */
     BaseLayerStyleAnimator animator{animatorHandle(0, 1)};
@@ -1208,6 +1376,38 @@ void BaseLayerStyleAnimatorTest::advanceInvalid() {
         TestSuite::Compare::String);
 }
 
+void BaseLayerStyleAnimatorTest::lerpFloats() {
+    auto&& data = LerpFloatsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Offset by one to catch accidental aligned loads */
+    Float a[25];
+    Float b[25];
+    for(std::size_t i = 0; i != Containers::arraySize(a); ++i) {
+        a[i] = Float(i)*1.5f - 7.0f;
+        b[i] = 100.0f/Float(i + 1);
+    }
+
+    Float expected[24]{};
+    Float actual[24]{};
+    Implementation::lerpFloatsScalar(a + 1, b + 1, data.factor, expected, data.count);
+    Implementation::lerpFloats(a + 1, b + 1, data.factor, actual, data.count);
+    CORRADE_COMPARE_AS(Containers::arrayView(actual),
+        Containers::arrayView(expected),
+        TestSuite::Compare::Container);
+
+    /* The scalar variant should match Math::lerp(), and nothing past the
+       count should be touched */
+    for(std::size_t i = 0; i != data.count; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(expected[i], Math::lerp(a[i + 1], b[i + 1], data.factor));
+    }
+    for(std::size_t i = data.count; i != Containers::arraySize(actual); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(actual[i], 0.0f);
+    }
+}
+
 void BaseLayerStyleAnimatorTest::layerAdvance() {
     auto&& data = LayerAdvanceData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -24,14 +24,19 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <new>
 #include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/String.h>
+#include <Magnum/Math/Packing.h>
 
 #include "Magnum/Ui/AbstractUserInterface.h"
 #include "Magnum/Ui/BaseLayer.h"
@@ -39,6 +44,8 @@
 #include "Magnum/Ui/Handle.h"
 /* for dynamicStyle(), updateDataOrder() */
 #include "Magnum/Ui/Implementation/baseLayerState.h"
+/* for updateFillQuad() */
+#include "Magnum/Ui/Implementation/fillBaseLayerQuad.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
 
@@ -69,6 +76,7 @@ struct BaseLayerTest: TestSuite::Tester {
     void sharedDebugFlag();
     void sharedDebugFlags();
     void sharedDebugFlagSupersets();
+    void debugBackgroundBlurAlgorithm();
 
     void sharedConfigurationConstruct();
     void sharedConfigurationConstructSameStyleUniformCount();
@@ -91,6 +99,8 @@ struct BaseLayerTest: TestSuite::Tester {
     void sharedSetStyleImplicitMapping();
     void sharedSetStyleImplicitMappingImplicitPadding();
     void sharedSetStyleImplicitMappingInvalidSize();
+    void sharedSetStyleUniforms();
+    void sharedSetStyleUniformsInvalid();
 
     void construct();
     void constructCopy();
@@ -112,8 +122,13 @@ struct BaseLayerTest: TestSuite::Tester {
     void setColor();
     void setOutlineWidth();
     void setPadding();
+    void setColorOutlineWidthPaddingMultiple();
+    void setColorOutlineWidthPaddingMultipleInvalid();
     void setTextureCoordinates();
     void setTextureCoordinatesInvalid();
+    void textureStreaming();
+    void textureStreamingConcurrentUpdate();
+    void textureStreamingInvalid();
 
     void invalidHandle();
 
@@ -122,6 +137,15 @@ struct BaseLayerTest: TestSuite::Tester {
 
     void updateEmpty();
     void updateDataOrder();
+    void updateDataOrderInstanced();
+    void updateDataOrderShaderNodeProperties();
+    void updateDataOrderStableIndices();
+    void updateDataOrderCompactVertices();
+    void updateDataOrderFeatureRuns();
+    void updateFillQuad();
+    void updateDataStyle();
+    void updateNodeOpacity();
+    void updateNodeTranslation();
     void updateNoStyleSet();
 
     void sharedNeedsUpdateStatePropagatedToLayers();
@@ -363,6 +387,116 @@ const struct {
         LayerState::NeedsCompositeOffsetSizeUpdate, false, false, true},
 };
 
+const struct {
+    const char* name;
+    bool textured;
+    Float smoothness;
+    Float expectedPadding;
+    LayerStates states;
+    bool expectInstanceDataUpdated;
+} UpdateDataOrderInstancedData[]{
+    {"", false, 0.0f, 0.0f,
+        LayerState::NeedsDataUpdate, true},
+    {"smoothness expansion", false, 100.0f, 10.0f,
+        LayerState::NeedsDataUpdate, true},
+    {"textured", true, 0.0f, 0.0f,
+        LayerState::NeedsDataUpdate, true},
+    {"textured, smoothness expansion", true, 100.0f, 10.0f,
+        LayerState::NeedsDataUpdate, true},
+    {"node offset/size update only", false, 0.0f, 0.0f,
+        LayerState::NeedsNodeOffsetSizeUpdate, true},
+    /* Unlike with the non-instanced quads, the instances are in draw order
+       and so have to be updated on order change as well */
+    {"node order update only", false, 0.0f, 0.0f,
+        LayerState::NeedsNodeOrderUpdate, true},
+    {"common data update only", false, 0.0f, 0.0f,
+        LayerState::NeedsCommonDataUpdate, false},
+};
+
+const struct {
+    const char* name;
+    bool textured;
+    Float smoothness;
+    Float expectedPadding;
+    LayerStates states;
+    bool expectInstanceDataUpdated;
+} UpdateDataOrderShaderNodePropertiesData[]{
+    {"", false, 0.0f, 0.0f,
+        LayerState::NeedsDataUpdate, true},
+    {"smoothness expansion", false, 100.0f, 10.0f,
+        LayerState::NeedsDataUpdate, true},
+    {"textured", true, 0.0f, 0.0f,
+        LayerState::NeedsDataUpdate, true},
+    {"textured, smoothness expansion", true, 100.0f, 10.0f,
+        LayerState::NeedsDataUpdate, true},
+    /* Implies NeedsNodeOrderUpdate, so the instances are regenerated, but
+       with the same contents */
+    {"node offset/size update only", false, 0.0f, 0.0f,
+        LayerState::NeedsNodeOffsetSizeUpdate, true},
+    /* Unlike with regular instances, the node opacity is applied in the
+       shader so the instances don't need to be updated */
+    {"node opacity update only", false, 0.0f, 0.0f,
+        LayerState::NeedsNodeOpacityUpdate, false},
+    {"common data update only", false, 0.0f, 0.0f,
+        LayerState::NeedsCommonDataUpdate, false},
+};
+
+const struct {
+    const char* name;
+    bool subdivided;
+} UpdateDataOrderStableIndicesData[]{
+    {"", false},
+    {"subdivided", true},
+};
+
+const struct {
+    const char* name;
+    BaseLayerSharedFlags flags;
+    std::size_t expectedRunCount;
+    UnsignedInt expectedRunOffsets[5];
+    UnsignedInt expectedRunFeatures[5];
+} UpdateDataOrderFeatureRunsData[]{
+    /* The features are 0, 0, 1, 2, 2, 3, 3 for all data in draw order, with
+       each enabled flag masking them */
+    {"", {},
+        5, {0, 2, 3, 5, 7}, {0, 1, 2, 3, 0}},
+    {"no rounded corners", BaseLayerSharedFlag::NoRoundedCorners,
+        3, {0, 3, 7}, {0, 2, 0}},
+    {"no outline", BaseLayerSharedFlag::NoOutline,
+        5, {0, 2, 3, 5, 7}, {0, 1, 0, 1, 0}},
+    {"no rounded corners or outline", BaseLayerSharedFlag::NoRoundedCorners|BaseLayerSharedFlag::NoOutline,
+        0, {}, {}},
+    {"subdivided quads", BaseLayerSharedFlag::SubdividedQuads,
+        0, {}, {}},
+    {"stable indices", BaseLayerSharedFlag::StableIndices,
+        0, {}, {}},
+};
+
+const struct {
+    const char* name;
+    bool textured;
+} UpdateDataOrderCompactVerticesData[]{
+    {"", false},
+    {"textured", true},
+};
+
+const struct {
+    const char* name;
+    std::size_t stride;
+    Vector2 min, max;
+} UpdateFillQuadData[]{
+    {"", sizeof(Implementation::BaseLayerVertex),
+        {-3.5f, 17.25f}, {120.0f, 44.125f}},
+    {"textured vertex stride", sizeof(Implementation::BaseLayerTexturedVertex),
+        {-3.5f, 17.25f}, {120.0f, 44.125f}},
+    /* For a zero size the center distance is a zero with a different sign,
+       which should match between the two variants as well */
+    {"zero size", sizeof(Implementation::BaseLayerVertex),
+        {15.0f, -7.0f}, {15.0f, -7.0f}},
+    {"negative size", sizeof(Implementation::BaseLayerVertex),
+        {15.0f, -7.0f}, {-15.0f, -70.0f}},
+};
+
 enum class Enum: UnsignedShort {};
 
 Debug& operator<<(Debug& debug, Enum value) {
@@ -395,6 +529,28 @@ const struct {
     {"dynamic styles", 1, 2},
 };
 
+const struct {
+    const char* name;
+    BaseLayerSharedFlags flags;
+} UpdateNodeOpacityData[]{
+    {"", {}},
+    {"textured", BaseLayerSharedFlag::Textured},
+    {"compact vertices", BaseLayerSharedFlag::CompactVertices},
+    {"subdivided quads", BaseLayerSharedFlag::SubdividedQuads},
+};
+
+const struct {
+    const char* name;
+    BaseLayerSharedFlags flags;
+} UpdateNodeTranslationData[]{
+    {"", {}},
+    {"textured", BaseLayerSharedFlag::Textured},
+    {"compact vertices", BaseLayerSharedFlag::CompactVertices},
+    {"subdivided quads", BaseLayerSharedFlag::SubdividedQuads},
+    {"instanced quads", BaseLayerSharedFlag::InstancedQuads},
+    {"instanced quads, textured", BaseLayerSharedFlag::InstancedQuads|BaseLayerSharedFlag::Textured},
+};
+
 const struct {
     const char* name;
     UnsignedInt styleCount, dynamicStyleCount;
@@ -441,6 +597,7 @@ BaseLayerTest::BaseLayerTest() {
               &BaseLayerTest::sharedDebugFlag,
               &BaseLayerTest::sharedDebugFlags,
               &BaseLayerTest::sharedDebugFlagSupersets,
+              &BaseLayerTest::debugBackgroundBlurAlgorithm,
 
               &BaseLayerTest::sharedConfigurationConstruct,
               &BaseLayerTest::sharedConfigurationConstructSameStyleUniformCount,
@@ -465,7 +622,9 @@ BaseLayerTest::BaseLayerTest() {
 
     addInstancedTests({&BaseLayerTest::sharedSetStyleImplicitMapping,
                        &BaseLayerTest::sharedSetStyleImplicitMappingImplicitPadding,
-                       &BaseLayerTest::sharedSetStyleImplicitMappingInvalidSize},
+                       &BaseLayerTest::sharedSetStyleImplicitMappingInvalidSize,
+                       &BaseLayerTest::sharedSetStyleUniforms,
+                       &BaseLayerTest::sharedSetStyleUniformsInvalid},
         Containers::arraySize(SharedSetStyleData));
 
     addTests({&BaseLayerTest::construct,
@@ -496,8 +655,13 @@ BaseLayerTest::BaseLayerTest() {
     addTests({&BaseLayerTest::setColor,
               &BaseLayerTest::setOutlineWidth,
               &BaseLayerTest::setPadding,
+              &BaseLayerTest::setColorOutlineWidthPaddingMultiple,
+              &BaseLayerTest::setColorOutlineWidthPaddingMultipleInvalid,
               &BaseLayerTest::setTextureCoordinates,
               &BaseLayerTest::setTextureCoordinatesInvalid,
+              &BaseLayerTest::textureStreaming,
+              &BaseLayerTest::textureStreamingConcurrentUpdate,
+              &BaseLayerTest::textureStreamingInvalid,
 
               &BaseLayerTest::invalidHandle,
 
@@ -506,6 +670,32 @@ BaseLayerTest::BaseLayerTest() {
     addInstancedTests({&BaseLayerTest::updateDataOrder},
         Containers::arraySize(UpdateDataOrderData));
 
+    addInstancedTests({&BaseLayerTest::updateDataOrderInstanced},
+        Containers::arraySize(UpdateDataOrderInstancedData));
+
+    addInstancedTests({&BaseLayerTest::updateDataOrderShaderNodeProperties},
+        Containers::arraySize(UpdateDataOrderShaderNodePropertiesData));
+
+    addInstancedTests({&BaseLayerTest::updateDataOrderStableIndices},
+        Containers::arraySize(UpdateDataOrderStableIndicesData));
+
+    addInstancedTests({&BaseLayerTest::updateDataOrderCompactVertices},
+        Containers::arraySize(UpdateDataOrderCompactVerticesData));
+
+    addInstancedTests({&BaseLayerTest::updateDataOrderFeatureRuns},
+        Containers::arraySize(UpdateDataOrderFeatureRunsData));
+
+    addInstancedTests({&BaseLayerTest::updateFillQuad},
+        Containers::arraySize(UpdateFillQuadData));
+
+    addTests({&BaseLayerTest::updateDataStyle});
+
+    addInstancedTests({&BaseLayerTest::updateNodeOpacity},
+        Containers::arraySize(UpdateNodeOpacityData));
+
+    addInstancedTests({&BaseLayerTest::updateNodeTranslation},
+        Containers::arraySize(UpdateNodeTranslationData));
+
     addInstancedTests({&BaseLayerTest::updateNoStyleSet},
         Containers::arraySize(UpdateNoStyleSetData));
 
@@ -868,8 +1058,8 @@ void BaseLayerTest::sharedDebugFlag() {
 
 void BaseLayerTest::sharedDebugFlags() {
     Containers::String out;
-    Debug{&out} << (BaseLayerSharedFlag::BackgroundBlur|BaseLayerSharedFlag(0x80)) << BaseLayerSharedFlags{};
-    CORRADE_COMPARE(out, "Ui::BaseLayerSharedFlag::BackgroundBlur|Ui::BaseLayerSharedFlag(0x80) Ui::BaseLayerSharedFlags{}\n");
+    Debug{&out} << (BaseLayerSharedFlag::BackgroundBlur|BaseLayerSharedFlag(0x8000)) << BaseLayerSharedFlags{};
+    CORRADE_COMPARE(out, "Ui::BaseLayerSharedFlag::BackgroundBlur|Ui::BaseLayerSharedFlag(0x8000) Ui::BaseLayerSharedFlags{}\n");
 }
 
 void BaseLayerTest::sharedDebugFlagSupersets() {
@@ -879,6 +1069,28 @@ void BaseLayerTest::sharedDebugFlagSupersets() {
         Debug{&out} << (BaseLayerSharedFlag::Textured|BaseLayerSharedFlag::TextureMask);
         CORRADE_COMPARE(out, "Ui::BaseLayerSharedFlag::TextureMask\n");
     }
+
+    /* BackgroundBlurCache is a superset of BackgroundBlur, so only one should
+       get printed */
+    {
+        Containers::String out;
+        Debug{&out} << (BaseLayerSharedFlag::BackgroundBlur|BaseLayerSharedFlag::BackgroundBlurCache);
+        CORRADE_COMPARE(out, "Ui::BaseLayerSharedFlag::BackgroundBlurCache\n");
+    }
+
+    /* ShaderNodeProperties is a superset of InstancedQuads, so only one
+       should get printed */
+    {
+        Containers::String out;
+        Debug{&out} << (BaseLayerSharedFlag::InstancedQuads|BaseLayerSharedFlag::ShaderNodeProperties);
+        CORRADE_COMPARE(out, "Ui::BaseLayerSharedFlag::ShaderNodeProperties\n");
+    }
+}
+
+void BaseLayerTest::debugBackgroundBlurAlgorithm() {
+    Containers::String out;
+    Debug{&out} << BaseLayerBackgroundBlurAlgorithm::DualKawase << BaseLayerBackgroundBlurAlgorithm(0xbe);
+    CORRADE_COMPARE(out, "Ui::BaseLayerBackgroundBlurAlgorithm::DualKawase Ui::BaseLayerBackgroundBlurAlgorithm(0xbe)\n");
 }
 
 void BaseLayerTest::sharedConfigurationConstruct() {
@@ -935,17 +1147,23 @@ void BaseLayerTest::sharedConfigurationSetters() {
     CORRADE_COMPARE(configuration.flags(), BaseLayerSharedFlags{});
     CORRADE_COMPARE(configuration.backgroundBlurRadius(), 4);
     CORRADE_COMPARE(configuration.backgroundBlurCutoff(), 0.5f/255.0f);
+    CORRADE_COMPARE(configuration.backgroundBlurAlgorithm(), BaseLayerBackgroundBlurAlgorithm::Gaussian);
+    CORRADE_COMPARE(configuration.backgroundBlurDownscale(), 1);
 
     configuration
         .setDynamicStyleCount(9)
         .setFlags(BaseLayerSharedFlag::BackgroundBlur)
         .addFlags(BaseLayerSharedFlag(0xe0))
         .clearFlags(BaseLayerSharedFlag(0x70))
-        .setBackgroundBlurRadius(16, 0.1f);
+        .setBackgroundBlurRadius(16, 0.1f)
+        .setBackgroundBlurAlgorithm(BaseLayerBackgroundBlurAlgorithm::DualKawase)
+        .setBackgroundBlurDownscale(4);
     CORRADE_COMPARE(configuration.dynamicStyleCount(), 9);
     CORRADE_COMPARE(configuration.flags(), BaseLayerSharedFlag::BackgroundBlur|BaseLayerSharedFlag(0x80));
     CORRADE_COMPARE(configuration.backgroundBlurRadius(), 16);
     CORRADE_COMPARE(configuration.backgroundBlurCutoff(), 0.1f);
+    CORRADE_COMPARE(configuration.backgroundBlurAlgorithm(), BaseLayerBackgroundBlurAlgorithm::DualKawase);
+    CORRADE_COMPARE(configuration.backgroundBlurDownscale(), 4);
 }
 
 void BaseLayerTest::sharedConfigurationSettersInvalid() {
@@ -961,7 +1179,11 @@ void BaseLayerTest::sharedConfigurationSettersInvalid() {
     Containers::String out;
     Error redirectError{&out};
     configuration.setBackgroundBlurRadius(32);
-    CORRADE_COMPARE(out, "Ui::BaseLayer::Shared::Configuration::setBackgroundBlurRadius(): radius 32 too large\n");
+    configuration.setBackgroundBlurDownscale(0);
+    CORRADE_COMPARE_AS(out,
+        "Ui::BaseLayer::Shared::Configuration::setBackgroundBlurRadius(): radius 32 too large\n"
+        "Ui::BaseLayer::Shared::Configuration::setBackgroundBlurDownscale(): expected a non-zero factor\n",
+        TestSuite::Compare::String);
 }
 
 void BaseLayerTest::sharedConstruct() {
@@ -1058,11 +1280,21 @@ void BaseLayerTest::sharedConstructInvalid() {
     Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::NoRoundedCorners)};
     Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::NoOutline)};
     Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::InstancedQuads)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::InstancedQuads|BaseLayerSharedFlag::StableIndices)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::CompactVertices|BaseLayerSharedFlag::SubdividedQuads)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::CompactVertices|BaseLayerSharedFlag::InstancedQuads)};
+    Shared{Shared::Configuration{65536, 1}.setDynamicStyleCount(1).addFlags(BaseLayerSharedFlag::CompactVertices)};
     CORRADE_COMPARE_AS(out,
         "Ui::BaseLayer::Shared: expected non-zero total style count\n"
         "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::NoRoundedCorners are mutually exclusive\n"
         "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::NoOutline are mutually exclusive\n"
-        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::NoRoundedCorners|Ui::BaseLayerSharedFlag::NoOutline are mutually exclusive\n",
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::NoRoundedCorners|Ui::BaseLayerSharedFlag::NoOutline are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::InstancedQuads are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::InstancedQuads and Ui::BaseLayerSharedFlag::StableIndices are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::CompactVertices and Ui::BaseLayerSharedFlag::SubdividedQuads are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::CompactVertices and Ui::BaseLayerSharedFlag::InstancedQuads are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: expected at most 65536 style uniforms and dynamic styles with Ui::BaseLayerSharedFlag::CompactVertices but got 65536 and 1\n",
         TestSuite::Compare::String);
 }
 
@@ -1425,6 +1657,135 @@ void BaseLayerTest::sharedSetStyleImplicitMappingInvalidSize() {
         "Ui::BaseLayer::Shared::setStyle(): there's 3 uniforms for 5 styles, provide an explicit mapping\n");
 }
 
+void BaseLayerTest::sharedSetStyleUniforms() {
+    auto&& data = SharedSetStyleData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    struct Shared: BaseLayer::Shared {
+        explicit Shared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+        State& state() { return static_cast<State&>(*_state); }
+
+        void doSetStyle(const BaseLayerCommonStyleUniform& commonUniform, Containers::ArrayView<const BaseLayerStyleUniform> uniforms) override {
+            CORRADE_COMPARE(uniforms.size(), 3);
+            lastSmoothness = commonUniform.smoothness;
+            lastOutlineColor = uniforms[1].outlineColor;
+            ++setStyleCalled;
+        }
+
+        Int setStyleCalled = 0;
+        Float lastSmoothness{};
+        Color4 lastOutlineColor;
+    } shared{BaseLayer::Shared::Configuration{3, 5}
+        .setDynamicStyleCount(data.dynamicStyleCount)
+    };
+
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{}
+            .setSmoothness(3.14f),
+        {BaseLayerStyleUniform{},
+         BaseLayerStyleUniform{}
+            .setOutlineColor(0xc0ffee_rgbf),
+         BaseLayerStyleUniform{}},
+        {2, 1, 0, 0, 1},
+        {{1.0f, 2.0f, 3.0f, 4.0f},
+         {4.0f, 3.0f, 2.0f, 1.0f},
+         {2.0f, 1.0f, 4.0f, 3.0f},
+         {1.0f, 3.0f, 2.0f, 4.0f},
+         {4.0f, 1.0f, 3.0f, 2.0f}});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting just the uniforms with the same smoothness */
+    shared.setStyleUniforms(
+        BaseLayerCommonStyleUniform{}
+            .setSmoothness(3.14f),
+        {BaseLayerStyleUniform{},
+         BaseLayerStyleUniform{}
+            .setOutlineColor(0xdeadbe_rgbf),
+         BaseLayerStyleUniform{}});
+    if(data.dynamicStyleCount == 0) {
+        /* The uniforms get uploaded directly, the layer doesn't need to do
+           anything */
+        CORRADE_COMPARE(shared.setStyleCalled, 2);
+        CORRADE_COMPARE(shared.lastSmoothness, 3.14f);
+        CORRADE_COMPARE(shared.lastOutlineColor, 0xdeadbe_rgbf);
+        CORRADE_COMPARE(layer.state(), LayerStates{});
+    } else {
+        /* With dynamic styles the uniforms are copied to an internal array
+           and each layer has to combine them with dynamic styles again */
+        CORRADE_COMPARE(shared.setStyleCalled, 0);
+        CORRADE_COMPARE(shared.state().commonStyleUniform.smoothness, 3.14f);
+        CORRADE_COMPARE(shared.state().styleUniforms[1].outlineColor, 0xdeadbe_rgbf);
+        CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate);
+        layer.update(LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+        CORRADE_COMPARE(layer.state(), LayerStates{});
+    }
+
+    /* The style mapping and paddings stay unchanged */
+    CORRADE_COMPARE_AS(stridedArrayView(shared.state().styles).slice(&Implementation::BaseLayerStyle::uniform), Containers::stridedArrayView({
+        2u, 1u, 0u, 0u, 1u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(shared.state().styles).slice(&Implementation::BaseLayerStyle::padding), Containers::stridedArrayView({
+        Vector4{1.0f, 2.0f, 3.0f, 4.0f},
+        Vector4{4.0f, 3.0f, 2.0f, 1.0f},
+        Vector4{2.0f, 1.0f, 4.0f, 3.0f},
+        Vector4{1.0f, 3.0f, 2.0f, 4.0f},
+        Vector4{4.0f, 1.0f, 3.0f, 2.0f}
+    }), TestSuite::Compare::Container);
+
+    /* Changing the smoothness affects quad expansion, so a data update is
+       needed in both cases. Testing also the initializer list overload. */
+    shared.setStyleUniforms(
+        BaseLayerCommonStyleUniform{}
+            .setSmoothness(1.5f),
+        {BaseLayerStyleUniform{},
+         BaseLayerStyleUniform{},
+         BaseLayerStyleUniform{}});
+    CORRADE_COMPARE(shared.state().smoothness, 1.5f);
+    CORRADE_COMPARE(layer.state(), data.dynamicStyleCount ?
+        LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate :
+        LayerState::NeedsDataUpdate);
+}
+
+void BaseLayerTest::sharedSetStyleUniformsInvalid() {
+    auto&& data = SharedSetStyleData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct Shared: BaseLayer::Shared {
+        explicit Shared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{3, 5}
+        .setDynamicStyleCount(data.dynamicStyleCount)
+    };
+
+    Containers::String out;
+    Error redirectError{&out};
+    shared.setStyleUniforms(BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}, BaseLayerStyleUniform{}, BaseLayerStyleUniform{}});
+    shared.setStyle(BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}, BaseLayerStyleUniform{}, BaseLayerStyleUniform{}},
+        {0, 1, 2, 1, 0},
+        {});
+    shared.setStyleUniforms(BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}, BaseLayerStyleUniform{}});
+    CORRADE_COMPARE(out,
+        "Ui::BaseLayer::Shared::setStyleUniforms(): no style data was set\n"
+        "Ui::BaseLayer::Shared::setStyleUniforms(): expected 3 uniforms, got 2\n");
+}
+
 void BaseLayerTest::construct() {
     struct LayerShared: BaseLayer::Shared {
         explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
@@ -1992,6 +2353,147 @@ void BaseLayerTest::setPadding() {
     CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
 }
 
+void BaseLayerTest::setColorOutlineWidthPaddingMultiple() {
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1, 3}};
+
+    /* Needed in order to be able to call update() */
+    shared.setStyle(BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}},
+        {0, 0, 0},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    DataHandle data1 = layer.create(1);
+    DataHandle data2 = layer.create(2);
+    DataHandle data3 = layer.create(0);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Empty views don't mark the layer as dirty */
+    layer.setColor(Containers::StridedArrayView1D<const DataHandle>{}, {});
+    layer.setOutlineWidth(Containers::StridedArrayView1D<const DataHandle>{}, {});
+    layer.setPadding(Containers::StridedArrayView1D<const DataHandle>{}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting multiple values marks the layer as dirty, data not in the list
+       stay unchanged. The order is deliberately different from the creation
+       order. */
+    DataHandle handles[]{data3, data1};
+    Color4 colors[]{0xaabbccdd_rgbaf, 0x11223344_rgbaf};
+    layer.setColor(handles, colors);
+    CORRADE_COMPARE(layer.color(data1), 0x11223344_rgbaf);
+    CORRADE_COMPARE(layer.color(data2), 0xffffffff_rgbaf);
+    CORRADE_COMPARE(layer.color(data3), 0xaabbccdd_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    Vector4 widths[]{{1.0f, 2.0f, 3.0f, 4.0f}, {5.0f, 6.0f, 7.0f, 8.0f}};
+    layer.setOutlineWidth(handles, widths);
+    CORRADE_COMPARE(layer.outlineWidth(data1), (Vector4{5.0f, 6.0f, 7.0f, 8.0f}));
+    CORRADE_COMPARE(layer.outlineWidth(data2), Vector4{0.0f});
+    CORRADE_COMPARE(layer.outlineWidth(data3), (Vector4{1.0f, 2.0f, 3.0f, 4.0f}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    Vector4 paddings[]{{4.0f, 3.0f, 2.0f, 1.0f}, {8.0f, 7.0f, 6.0f, 5.0f}};
+    layer.setPadding(handles, paddings);
+    CORRADE_COMPARE(layer.padding(data1), (Vector4{8.0f, 7.0f, 6.0f, 5.0f}));
+    CORRADE_COMPARE(layer.padding(data2), Vector4{0.0f});
+    CORRADE_COMPARE(layer.padding(data3), (Vector4{4.0f, 3.0f, 2.0f, 1.0f}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overloads */
+    LayerDataHandle layerHandles[]{dataHandleData(data2)};
+    Color4 layerColors[]{0x99887766_rgbaf};
+    Vector4 layerValues[]{{0.5f, 1.5f, 2.5f, 3.5f}};
+    layer.setColor(layerHandles, layerColors);
+    layer.setOutlineWidth(layerHandles, layerValues);
+    layer.setPadding(layerHandles, layerValues);
+    CORRADE_COMPARE(layer.color(data2), 0x99887766_rgbaf);
+    CORRADE_COMPARE(layer.outlineWidth(data2), (Vector4{0.5f, 1.5f, 2.5f, 3.5f}));
+    CORRADE_COMPARE(layer.padding(data2), (Vector4{0.5f, 1.5f, 2.5f, 3.5f}));
+    CORRADE_COMPARE(layer.color(data1), 0x11223344_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void BaseLayerTest::setColorOutlineWidthPaddingMultipleInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1}};
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle data = layer.create(0);
+
+    DataHandle handles[]{data, DataHandle::Null};
+    LayerDataHandle layerHandles[]{dataHandleData(data), LayerDataHandle::Null};
+    Color4 colors[2];
+    Vector4 values[2];
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.setColor(handles, Containers::arrayView(colors).prefix(1));
+    layer.setColor(layerHandles, Containers::arrayView(colors).prefix(1));
+    layer.setColor(handles, colors);
+    layer.setColor(layerHandles, colors);
+    layer.setOutlineWidth(handles, Containers::arrayView(values).prefix(1));
+    layer.setOutlineWidth(layerHandles, Containers::arrayView(values).prefix(1));
+    layer.setOutlineWidth(handles, values);
+    layer.setOutlineWidth(layerHandles, values);
+    layer.setPadding(handles, Containers::arrayView(values).prefix(1));
+    layer.setPadding(layerHandles, Containers::arrayView(values).prefix(1));
+    layer.setPadding(handles, values);
+    layer.setPadding(layerHandles, values);
+    CORRADE_COMPARE_AS(out,
+        "Ui::BaseLayer::setColor(): expected handle and color views to have the same size but got 2 and 1\n"
+        "Ui::BaseLayer::setColor(): expected handle and color views to have the same size but got 2 and 1\n"
+        "Ui::BaseLayer::setColor(): invalid handle Ui::DataHandle::Null at index 1\n"
+        "Ui::BaseLayer::setColor(): invalid handle Ui::LayerDataHandle::Null at index 1\n"
+        "Ui::BaseLayer::setOutlineWidth(): expected handle and width views to have the same size but got 2 and 1\n"
+        "Ui::BaseLayer::setOutlineWidth(): expected handle and width views to have the same size but got 2 and 1\n"
+        "Ui::BaseLayer::setOutlineWidth(): invalid handle Ui::DataHandle::Null at index 1\n"
+        "Ui::BaseLayer::setOutlineWidth(): invalid handle Ui::LayerDataHandle::Null at index 1\n"
+        "Ui::BaseLayer::setPadding(): expected handle and padding views to have the same size but got 2 and 1\n"
+        "Ui::BaseLayer::setPadding(): expected handle and padding views to have the same size but got 2 and 1\n"
+        "Ui::BaseLayer::setPadding(): invalid handle Ui::DataHandle::Null at index 1\n"
+        "Ui::BaseLayer::setPadding(): invalid handle Ui::LayerDataHandle::Null at index 1\n",
+        TestSuite::Compare::String);
+
+    /* Nothing should be changed by the failed calls */
+    CORRADE_COMPARE(layer.color(data), 0xffffffff_rgbaf);
+    CORRADE_COMPARE(layer.outlineWidth(data), Vector4{0.0f});
+    CORRADE_COMPARE(layer.padding(data), Vector4{0.0f});
+}
+
 void BaseLayerTest::setTextureCoordinates() {
     struct LayerShared: BaseLayer::Shared {
         explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
@@ -2072,41 +2574,306 @@ void BaseLayerTest::setTextureCoordinatesInvalid() {
         TestSuite::Compare::String);
 }
 
-void BaseLayerTest::invalidHandle() {
-    CORRADE_SKIP_IF_NO_ASSERT();
-
+void BaseLayerTest::textureStreaming() {
     struct LayerShared: BaseLayer::Shared {
         explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
 
         void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
-    } shared{BaseLayer::Shared::Configuration{1}
+    } shared{BaseLayer::Shared::Configuration{3}
         .addFlags(BaseLayerSharedFlag::Textured)
     };
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {
+        BaseLayerStyleUniform{},
+        BaseLayerStyleUniform{},
+        BaseLayerStyleUniform{}
+    }, {});
 
     struct Layer: BaseLayer {
         explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
     } layer{layerHandle(0, 1), shared};
+    layer.setSize({1, 1}, {1, 1});
+    CORRADE_COMPARE(layer.textureStreamingLayerCount(), 0);
+    CORRADE_COMPARE(layer.textureStreamingSlotCount(), 0);
+
+    /* Layer 7 is loaded asynchronously, the rest immediately */
+    Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> calls;
+    layer.setTextureStreaming(10, 2, 2, [&calls](UnsignedInt layer, UnsignedInt slot) {
+        arrayAppend(calls, InPlaceInit, layer, slot);
+        return layer != 7;
+    });
+    CORRADE_COMPARE(layer.textureStreamingLayerCount(), 10);
+    CORRADE_COMPARE(layer.textureStreamingSlotCount(), 2);
+    CORRADE_VERIFY(layer.state() >= LayerState::NeedsDataUpdate);
+
+    NodeHandle node = nodeHandle(0, 1);
+    DataHandle first = layer.create(0, node);
+    DataHandle second = layer.create(1, node);
+    DataHandle third = layer.create(0, node);
+    layer.setTextureCoordinates(first, {0.0f, 0.0f, 3.0f}, {1.0f, 1.0f});
+    layer.setTextureCoordinates(second, {0.0f, 0.0f, 5.0f}, {1.0f, 1.0f});
+    layer.setTextureCoordinates(third, {0.0f, 0.0f, 7.0f}, {1.0f, 1.0f});
+
+    Vector2 nodeOffsets[1];
+    Vector2 nodeSizes[1]{{1.0f, 1.0f}};
+    Float nodeOpacities[1]{1.0f};
+    UnsignedByte nodesEnabledData[1]{0x1};
+    Containers::MutableBitArrayView nodesEnabled{nodesEnabledData, 0, 1};
+    auto vertex = [&](DataHandle data) -> const Implementation::BaseLayerTexturedVertex& {
+        return Containers::arrayCast<const Implementation::BaseLayerTexturedVertex>(layer.stateData().vertices)[dataHandleId(data)*4];
+    };
 
-    Containers::String out;
-    Error redirectError{&out};
-    layer.color(DataHandle::Null);
-    layer.color(LayerDataHandle::Null);
-    layer.setColor(DataHandle::Null, {});
-    layer.setColor(LayerDataHandle::Null, {});
-    layer.outlineWidth(DataHandle::Null);
-    layer.outlineWidth(LayerDataHandle::Null);
-    layer.setOutlineWidth(DataHandle::Null, {});
-    layer.setOutlineWidth(LayerDataHandle::Null, {});
-    layer.padding(DataHandle::Null);
-    layer.padding(LayerDataHandle::Null);
-    layer.setPadding(DataHandle::Null, {});
-    layer.setPadding(LayerDataHandle::Null, {});
-    layer.textureCoordinateOffset(DataHandle::Null);
-    layer.textureCoordinateOffset(LayerDataHandle::Null);
-    layer.textureCoordinateSize(DataHandle::Null);
-    layer.textureCoordinateSize(LayerDataHandle::Null);
-    layer.setTextureCoordinates(DataHandle::Null, {}, {});
-    layer.setTextureCoordinates(LayerDataHandle::Null, {}, {});
+    /* The first two layers get a free slot, the third doesn't fit and is
+       drawn with the placeholder style and the placeholder texture layer,
+       which is right after all slots */
+    {
+        UnsignedInt dataIds[]{0, 1, 2};
+        layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+        CORRADE_COMPARE_AS(calls, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+            {3, 0},
+            {5, 1},
+        })), TestSuite::Compare::Container);
+        CORRADE_COMPARE(layer.textureStreamingSlot(3), Containers::optional(0u));
+        CORRADE_COMPARE(layer.textureStreamingSlot(5), Containers::optional(1u));
+        CORRADE_VERIFY(!layer.textureStreamingSlot(7));
+        CORRADE_COMPARE(vertex(first).textureCoordinates.z(), 0.0f);
+        CORRADE_COMPARE(vertex(first).vertex.styleUniform, 0);
+        CORRADE_COMPARE(vertex(second).textureCoordinates.z(), 1.0f);
+        CORRADE_COMPARE(vertex(second).vertex.styleUniform, 1);
+        CORRADE_COMPARE(vertex(third).textureCoordinates.z(), 2.0f);
+        CORRADE_COMPARE(vertex(third).vertex.styleUniform, 2);
+    }
+
+    /* With the second data not drawn, its slot is the least recently used
+       one and gets evicted for the third data. The load is asynchronous, so
+       the placeholder is still used. */
+    arrayResize(calls, 0);
+    {
+        UnsignedInt dataIds[]{0, 2};
+        layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+        CORRADE_COMPARE_AS(calls, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+            {7, 1},
+        })), TestSuite::Compare::Container);
+        CORRADE_COMPARE(layer.textureStreamingSlot(3), Containers::optional(0u));
+        CORRADE_VERIFY(!layer.textureStreamingSlot(5));
+        CORRADE_VERIFY(!layer.textureStreamingSlot(7));
+        CORRADE_COMPARE(vertex(first).textureCoordinates.z(), 0.0f);
+        CORRADE_COMPARE(vertex(third).textureCoordinates.z(), 2.0f);
+        CORRADE_COMPARE(vertex(third).vertex.styleUniform, 2);
+    }
+
+    /* Marking an evicted layer as loaded does nothing */
+    CORRADE_VERIFY(!(layer.state() >= LayerState::NeedsDataUpdate));
+    layer.setTextureLayerLoaded(5);
+    CORRADE_VERIFY(!layer.textureStreamingSlot(5));
+    CORRADE_VERIFY(!(layer.state() >= LayerState::NeedsDataUpdate));
+
+    /* Once loaded, the third data is drawn with its own style and slot, and
+       no new loads are requested */
+    layer.setTextureLayerLoaded(7);
+    CORRADE_COMPARE(layer.textureStreamingSlot(7), Containers::optional(1u));
+    CORRADE_VERIFY(layer.state() >= LayerState::NeedsDataUpdate);
+    arrayResize(calls, 0);
+    {
+        UnsignedInt dataIds[]{0, 2};
+        layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+        CORRADE_COMPARE(calls.size(), 0);
+        CORRADE_COMPARE(vertex(third).textureCoordinates.z(), 1.0f);
+        CORRADE_COMPARE(vertex(third).vertex.styleUniform, 0);
+    }
+
+    /* Enabling the streaming again discards all residency information */
+    layer.setTextureStreaming(10, 4, 2, [](UnsignedInt, UnsignedInt) {
+        return true;
+    });
+    CORRADE_COMPARE(layer.textureStreamingSlotCount(), 4);
+    CORRADE_VERIFY(!layer.textureStreamingSlot(3));
+    CORRADE_VERIFY(!layer.textureStreamingSlot(7));
+}
+
+void BaseLayerTest::textureStreamingConcurrentUpdate() {
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{3}
+        .addFlags(BaseLayerSharedFlag::Textured)
+    };
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {
+        BaseLayerStyleUniform{},
+        BaseLayerStyleUniform{},
+        BaseLayerStyleUniform{}
+    }, {});
+
+    /* Advertising concurrent updates like BaseLayerGL does */
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
+
+        LayerFeatures doFeatures() const override {
+            return BaseLayer::doFeatures()|LayerFeature::ConcurrentUpdate;
+        }
+    };
+
+    AbstractUserInterface ui{{100, 100}};
+    Layer& layer1 = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer(), shared));
+    Layer& layer2 = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer(), shared));
+
+    /* Records the layer index and whether the loader was called from inside
+       the executor */
+    bool inExecutor = false;
+    Containers::Array<Containers::Pair<UnsignedInt, bool>> calls;
+    layer1.setTextureStreaming(10, 2, 2, [&](UnsignedInt layer, UnsignedInt) {
+        arrayAppend(calls, InPlaceInit, layer, inExecutor);
+        return true;
+    });
+    layer2.setTextureStreaming(10, 2, 2, [&](UnsignedInt layer, UnsignedInt) {
+        arrayAppend(calls, InPlaceInit, layer, inExecutor);
+        return true;
+    });
+
+    std::size_t executorCalls = 0;
+    ui.setUpdateExecutor([&](std::size_t count, void(*task)(void*, std::size_t), void* state) {
+        ++executorCalls;
+        inExecutor = true;
+        for(std::size_t i = 0; i != count; ++i)
+            task(state, i);
+        inExecutor = false;
+    });
+
+    NodeHandle node = ui.createNode({}, {10.0f, 10.0f});
+    DataHandle data1 = layer1.create(0, node);
+    DataHandle data2 = layer2.create(1, node);
+    layer1.setTextureCoordinates(data1, {0.0f, 0.0f, 3.0f}, {1.0f, 1.0f});
+    layer2.setTextureCoordinates(data2, {0.0f, 0.0f, 5.0f}, {1.0f, 1.0f});
+
+    auto vertex = [](const Layer& layer, DataHandle data) -> const Implementation::BaseLayerTexturedVertex& {
+        return Containers::arrayCast<const Implementation::BaseLayerTexturedVertex>(layer.stateData().vertices)[dataHandleId(data)*4];
+    };
+
+    /* The update goes through the executor, but the loaders get called only
+       from postUpdate() afterwards. The data are thus drawn with the
+       placeholder in this update, and another update is scheduled. */
+    ui.update();
+    CORRADE_COMPARE(executorCalls, 1);
+    CORRADE_COMPARE_AS(calls, (Containers::arrayView<Containers::Pair<UnsignedInt, bool>>({
+        {3, false},
+        {5, false},
+    })), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer1.textureStreamingSlot(3), Containers::optional(0u));
+    CORRADE_COMPARE(layer2.textureStreamingSlot(5), Containers::optional(0u));
+    CORRADE_COMPARE(vertex(layer1, data1).textureCoordinates.z(), 2.0f);
+    CORRADE_COMPARE(vertex(layer1, data1).vertex.styleUniform, 2);
+    CORRADE_COMPARE(vertex(layer2, data2).textureCoordinates.z(), 2.0f);
+    CORRADE_COMPARE(vertex(layer2, data2).vertex.styleUniform, 2);
+    CORRADE_VERIFY(layer1.state() >= LayerState::NeedsDataUpdate);
+    CORRADE_VERIFY(layer2.state() >= LayerState::NeedsDataUpdate);
+    CORRADE_VERIFY(ui.state() >= UserInterfaceState::NeedsDataUpdate);
+
+    /* The next update draws the data with the loaded layers, without calling
+       the loaders again */
+    arrayResize(calls, 0);
+    ui.update();
+    CORRADE_COMPARE(executorCalls, 2);
+    CORRADE_COMPARE(calls.size(), 0);
+    CORRADE_COMPARE(vertex(layer1, data1).textureCoordinates.z(), 0.0f);
+    CORRADE_COMPARE(vertex(layer1, data1).vertex.styleUniform, 0);
+    CORRADE_COMPARE(vertex(layer2, data2).textureCoordinates.z(), 0.0f);
+    CORRADE_COMPARE(vertex(layer2, data2).vertex.styleUniform, 1);
+    CORRADE_VERIFY(!ui.state());
+}
+
+void BaseLayerTest::textureStreamingInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{3}},
+      sharedTextured{BaseLayer::Shared::Configuration{2, 3}
+        .setDynamicStyleCount(1)
+        .addFlags(BaseLayerSharedFlag::Textured)
+    };
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared},
+      layerTextured{layerHandle(0, 1), sharedTextured},
+      layerTexturedStreaming{layerHandle(0, 1), sharedTextured};
+
+    auto loader = [](UnsignedInt, UnsignedInt) { return true; };
+    layerTexturedStreaming.setTextureStreaming(10, 2, 3, loader);
+    DataHandle data = layerTexturedStreaming.create(0);
+
+    /* Placeholder style index 3 is a dynamic style, which is fine */
+    layerTextured.setTextureStreaming(10, 2, 3, loader);
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.setTextureStreaming(10, 2, 0, loader);
+    layerTextured.setTextureStreaming(10, 0, 0, loader);
+    layerTextured.setTextureStreaming(10, 2, 4, loader);
+    layerTextured.setTextureStreaming(10, 2, 0, nullptr);
+    layer.textureStreamingSlot(0);
+    layerTexturedStreaming.textureStreamingSlot(10);
+    layer.setTextureLayerLoaded(0);
+    layerTexturedStreaming.setTextureLayerLoaded(10);
+    layerTexturedStreaming.setTextureCoordinates(data, {0.0f, 0.0f, 10.0f}, {1.0f, 1.0f});
+    layerTexturedStreaming.setTextureCoordinates(data, {0.0f, 0.0f, -1.0f}, {1.0f, 1.0f});
+    CORRADE_COMPARE_AS(out,
+        "Ui::BaseLayer::setTextureStreaming(): texturing not enabled\n"
+        "Ui::BaseLayer::setTextureStreaming(): expected a non-zero slot count\n"
+        "Ui::BaseLayer::setTextureStreaming(): placeholder style 4 out of range for 4 styles\n"
+        "Ui::BaseLayer::setTextureStreaming(): loader is null\n"
+        "Ui::BaseLayer::textureStreamingSlot(): texture streaming not enabled\n"
+        "Ui::BaseLayer::textureStreamingSlot(): layer 10 out of range for 10 streamed layers\n"
+        "Ui::BaseLayer::setTextureLayerLoaded(): texture streaming not enabled\n"
+        "Ui::BaseLayer::setTextureLayerLoaded(): layer 10 out of range for 10 streamed layers\n"
+        "Ui::BaseLayer::setTextureCoordinates(): texture layer 10 out of range for 10 streamed layers\n"
+        "Ui::BaseLayer::setTextureCoordinates(): texture layer -1 out of range for 10 streamed layers\n",
+        TestSuite::Compare::String);
+}
+
+void BaseLayerTest::invalidHandle() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1}
+        .addFlags(BaseLayerSharedFlag::Textured)
+    };
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.color(DataHandle::Null);
+    layer.color(LayerDataHandle::Null);
+    layer.setColor(DataHandle::Null, {});
+    layer.setColor(LayerDataHandle::Null, {});
+    layer.outlineWidth(DataHandle::Null);
+    layer.outlineWidth(LayerDataHandle::Null);
+    layer.setOutlineWidth(DataHandle::Null, {});
+    layer.setOutlineWidth(LayerDataHandle::Null, {});
+    layer.padding(DataHandle::Null);
+    layer.padding(LayerDataHandle::Null);
+    layer.setPadding(DataHandle::Null, {});
+    layer.setPadding(LayerDataHandle::Null, {});
+    layer.textureCoordinateOffset(DataHandle::Null);
+    layer.textureCoordinateOffset(LayerDataHandle::Null);
+    layer.textureCoordinateSize(DataHandle::Null);
+    layer.textureCoordinateSize(LayerDataHandle::Null);
+    layer.setTextureCoordinates(DataHandle::Null, {}, {});
+    layer.setTextureCoordinates(LayerDataHandle::Null, {}, {});
     CORRADE_COMPARE_AS(out,
         "Ui::BaseLayer::color(): invalid handle Ui::DataHandle::Null\n"
         "Ui::BaseLayer::color(): invalid handle Ui::LayerDataHandle::Null\n"
@@ -2715,6 +3482,833 @@ void BaseLayerTest::updateDataOrder() {
     }
 }
 
+void BaseLayerTest::updateDataOrderInstanced() {
+    auto&& data = UpdateDataOrderInstancedData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Like updateDataOrder(), but verifying that there's one instance per
+       drawn data in draw order and no indices. The actual visual output is
+       checked in BaseLayerGLTest. */
+
+    BaseLayer::Shared::Configuration configuration{3, 3};
+    configuration.addFlags(BaseLayerSharedFlag::InstancedQuads);
+    if(data.textured)
+        configuration.addFlags(BaseLayerSharedFlag::Textured);
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{configuration};
+
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{}
+            .setSmoothness(data.smoothness, 10000.0f),
+        {BaseLayerStyleUniform{}, BaseLayerStyleUniform{},
+         BaseLayerStyleUniform{}},
+        {1, 2, 0},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    NodeHandle node6 = nodeHandle(6, 0);
+    NodeHandle node15 = nodeHandle(15, 0);
+
+    layer.create(0);                                                    /* 0 */
+    DataHandle data1 = layer.create(2, node6);
+    layer.create(0);                                                    /* 2 */
+    DataHandle data3 = layer.create(1, node15);
+
+    layer.setColor(data1, 0xff336699_rgbaf);
+    layer.setOutlineWidth(data1, {1.0f, 2.0f, 3.0f, 4.0f});
+    layer.setColor(data3, 0x11223344_rgbaf);
+    layer.setOutlineWidth(data3, 2.0f);
+    if(data.textured)
+        layer.setTextureCoordinates(data3, {0.25f, 0.5f, 37.0f}, {0.5f, 0.125f});
+
+    Vector2 nodeOffsets[16];
+    Vector2 nodeSizes[16];
+    Float nodeOpacities[16];
+    UnsignedByte nodesEnabledData[2]{};
+    Containers::MutableBitArrayView nodesEnabled{nodesEnabledData, 0, 16};
+    nodeOffsets[6] = {1.0f, 2.0f};
+    nodeSizes[6] = {10.0f, 15.0f};
+    nodeOpacities[6] = 0.4f;
+    nodeOffsets[15] = {3.0f, 4.0f};
+    nodeSizes[15] = {20.0f, 5.0f};
+    nodeOpacities[15] = 0.9f;
+    nodesEnabled.set(6);
+    nodesEnabled.set(15);
+
+    /* Same ratio as in updateDataOrder(), smoothness expansion is thus
+       multiplied by 0.1 */
+    layer.setSize({25, 50}, {250, 5000});
+
+    /* Data 3 is drawn before data 1 */
+    UnsignedInt dataIds[]{3, 1};
+    layer.update(data.states, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* There are never any indices */
+    CORRADE_COMPARE_AS(layer.stateData().indices,
+        Containers::ArrayView<const UnsignedInt>{},
+        TestSuite::Compare::Container);
+
+    if(!data.expectInstanceDataUpdated) {
+        CORRADE_COMPARE(layer.stateData().vertices.size(), 0);
+        return;
+    }
+
+    const std::size_t typeSize = data.textured ?
+        sizeof(Implementation::BaseLayerTexturedInstance) :
+        sizeof(Implementation::BaseLayerInstance);
+    Containers::StridedArrayView1D<const Implementation::BaseLayerInstance> instances{
+        layer.stateData().vertices,
+        reinterpret_cast<const Implementation::BaseLayerInstance*>(layer.stateData().vertices.data()),
+        layer.stateData().vertices.size()/typeSize,
+        std::ptrdiff_t(typeSize)};
+    /* Just for the drawn data, not for the whole capacity */
+    CORRADE_COMPARE(instances.size(), 2);
+
+    /* Data 3, attached to node 15, created with style 1, which is mapped to
+       uniform 2 */
+    CORRADE_COMPARE(instances[0].min, (Vector2{3.0f, 4.0f} - Vector2{data.expectedPadding}));
+    CORRADE_COMPARE(instances[0].max, (Vector2{23.0f, 9.0f} + Vector2{data.expectedPadding}));
+    CORRADE_COMPARE(instances[0].outlineWidth, Vector4{2.0f});
+    CORRADE_COMPARE(instances[0].color, 0x11223344_rgbaf*0.9f);
+    CORRADE_COMPARE(instances[0].styleUniform, 2);
+
+    /* Data 1, attached to node 6, created with style 2, which is mapped to
+       uniform 0 */
+    CORRADE_COMPARE(instances[1].min, (Vector2{1.0f, 2.0f} - Vector2{data.expectedPadding}));
+    CORRADE_COMPARE(instances[1].max, (Vector2{11.0f, 17.0f} + Vector2{data.expectedPadding}));
+    CORRADE_COMPARE(instances[1].outlineWidth, (Vector4{1.0f, 2.0f, 3.0f, 4.0f}));
+    CORRADE_COMPARE(instances[1].color, 0xff336699_rgbaf*0.4f);
+    CORRADE_COMPARE(instances[1].styleUniform, 0);
+
+    /* Texture coordinates are Y-flipped and expanded the same way as in
+       updateDataOrder() */
+    if(data.textured) {
+        Containers::ArrayView<const Implementation::BaseLayerTexturedInstance> texturedInstances = Containers::arrayCast<const Implementation::BaseLayerTexturedInstance>(instances).asContiguous();
+
+        /* Texture size is {0.5, 0.125}, node size {20, 5} */
+        CORRADE_COMPARE(texturedInstances[0].textureCoordinateMin, (Vector3{
+            0.25f - data.expectedPadding*0.5f/20.0f,
+            0.625f + data.expectedPadding*0.125f/5.0f, 37.0f}));
+        CORRADE_COMPARE(texturedInstances[0].textureCoordinateMax, (Vector2{
+            0.75f + data.expectedPadding*0.5f/20.0f,
+            0.5f - data.expectedPadding*0.125f/5.0f}));
+
+        /* Texture size is {1.0, 1.0}, node size {10, 15} */
+        CORRADE_COMPARE(texturedInstances[1].textureCoordinateMin, (Vector3{
+            0.0f - data.expectedPadding/10.0f,
+            1.0f + data.expectedPadding/15.0f, 0.0f}));
+        CORRADE_COMPARE(texturedInstances[1].textureCoordinateMax, (Vector2{
+            1.0f + data.expectedPadding/10.0f,
+            0.0f - data.expectedPadding/15.0f}));
+    }
+}
+
+void BaseLayerTest::updateDataOrderShaderNodeProperties() {
+    auto&& data = UpdateDataOrderShaderNodePropertiesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Like updateDataOrderInstanced(), but verifying that the instances
+       contain just the padding, color without the node opacity and the node
+       ID. The node properties are applied in the shader, the actual visual
+       output is checked in BaseLayerGLTest. */
+
+    BaseLayer::Shared::Configuration configuration{3, 3};
+    configuration.addFlags(BaseLayerSharedFlag::ShaderNodeProperties);
+    if(data.textured)
+        configuration.addFlags(BaseLayerSharedFlag::Textured);
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{configuration};
+
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{}
+            .setSmoothness(data.smoothness, 10000.0f),
+        {BaseLayerStyleUniform{}, BaseLayerStyleUniform{},
+         BaseLayerStyleUniform{}},
+        {1, 2, 0},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    NodeHandle node6 = nodeHandle(6, 0);
+    NodeHandle node15 = nodeHandle(15, 0);
+
+    layer.create(0);                                                    /* 0 */
+    DataHandle data1 = layer.create(2, node6);
+    layer.create(0);                                                    /* 2 */
+    DataHandle data3 = layer.create(1, node15);
+
+    layer.setColor(data1, 0xff336699_rgbaf);
+    layer.setOutlineWidth(data1, {1.0f, 2.0f, 3.0f, 4.0f});
+    layer.setPadding(data1, {0.5f, 1.0f, 1.5f, 2.0f});
+    layer.setColor(data3, 0x11223344_rgbaf);
+    layer.setOutlineWidth(data3, 2.0f);
+    if(data.textured)
+        layer.setTextureCoordinates(data3, {0.25f, 0.5f, 37.0f}, {0.5f, 0.125f});
+
+    Vector2 nodeOffsets[16];
+    Vector2 nodeSizes[16];
+    Float nodeOpacities[16];
+    UnsignedByte nodesEnabledData[2]{};
+    Containers::MutableBitArrayView nodesEnabled{nodesEnabledData, 0, 16};
+    nodeOffsets[6] = {1.0f, 2.0f};
+    nodeSizes[6] = {10.0f, 15.0f};
+    nodeOpacities[6] = 0.4f;
+    nodeOffsets[15] = {3.0f, 4.0f};
+    nodeSizes[15] = {20.0f, 5.0f};
+    nodeOpacities[15] = 0.9f;
+    nodesEnabled.set(6);
+    nodesEnabled.set(15);
+
+    /* Same ratio as in updateDataOrder(), smoothness expansion is thus
+       multiplied by 0.1 */
+    layer.setSize({25, 50}, {250, 5000});
+
+    /* Data 3 is drawn before data 1 */
+    UnsignedInt dataIds[]{3, 1};
+    layer.update(data.states, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* There are never any indices */
+    CORRADE_COMPARE_AS(layer.stateData().indices,
+        Containers::ArrayView<const UnsignedInt>{},
+        TestSuite::Compare::Container);
+
+    if(!data.expectInstanceDataUpdated) {
+        CORRADE_COMPARE(layer.stateData().vertices.size(), 0);
+        return;
+    }
+
+    const std::size_t typeSize = data.textured ?
+        sizeof(Implementation::BaseLayerTexturedNodeInstance) :
+        sizeof(Implementation::BaseLayerNodeInstance);
+    Containers::StridedArrayView1D<const Implementation::BaseLayerNodeInstance> instances{
+        layer.stateData().vertices,
+        reinterpret_cast<const Implementation::BaseLayerNodeInstance*>(layer.stateData().vertices.data()),
+        layer.stateData().vertices.size()/typeSize,
+        std::ptrdiff_t(typeSize)};
+    /* Just for the drawn data, not for the whole capacity */
+    CORRADE_COMPARE(instances.size(), 2);
+
+    /* Data 3, attached to node 15, created with style 1, which is mapped to
+       uniform 2 */
+    CORRADE_COMPARE(instances[0].padding, Vector4{-data.expectedPadding});
+    CORRADE_COMPARE(instances[0].outlineWidth, Vector4{2.0f});
+    CORRADE_COMPARE(instances[0].color, 0x11223344_rgbaf);
+    CORRADE_COMPARE(instances[0].styleUniform, 2);
+    CORRADE_COMPARE(instances[0].nodeId, 15);
+
+    /* Data 1, attached to node 6, created with style 2, which is mapped to
+       uniform 0 */
+    CORRADE_COMPARE(instances[1].padding, (Vector4{0.5f, 1.0f, 1.5f, 2.0f} - Vector4{data.expectedPadding}));
+    CORRADE_COMPARE(instances[1].outlineWidth, (Vector4{1.0f, 2.0f, 3.0f, 4.0f}));
+    CORRADE_COMPARE(instances[1].color, 0xff336699_rgbaf);
+    CORRADE_COMPARE(instances[1].styleUniform, 0);
+    CORRADE_COMPARE(instances[1].nodeId, 6);
+
+    /* Texture coordinates are passed through unchanged, the smoothness
+       expansion is done in the shader */
+    if(data.textured) {
+        Containers::ArrayView<const Implementation::BaseLayerTexturedNodeInstance> texturedInstances = Containers::arrayCast<const Implementation::BaseLayerTexturedNodeInstance>(instances).asContiguous();
+
+        CORRADE_COMPARE(texturedInstances[0].textureCoordinateOffset, (Vector3{0.25f, 0.5f, 37.0f}));
+        CORRADE_COMPARE(texturedInstances[0].textureCoordinateSize, (Vector2{0.5f, 0.125f}));
+        CORRADE_COMPARE(texturedInstances[1].textureCoordinateOffset, (Vector3{0.0f, 0.0f, 0.0f}));
+        CORRADE_COMPARE(texturedInstances[1].textureCoordinateSize, (Vector2{1.0f, 1.0f}));
+    }
+}
+
+void BaseLayerTest::updateDataOrderStableIndices() {
+    auto&& data = UpdateDataOrderStableIndicesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Verifies just the index data and draw runs, the vertex data are the
+       same as without StableIndices and tested in updateDataOrder(). The
+       splitting of draw runs into draws is tested in BaseLayerGLTest. */
+
+    BaseLayer::Shared::Configuration configuration{1};
+    configuration.addFlags(BaseLayerSharedFlag::StableIndices);
+    if(data.subdivided)
+        configuration.addFlags(BaseLayerSharedFlag::SubdividedQuads);
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{configuration};
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {BaseLayerStyleUniform{}}, {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Six data, all attached to the same node */
+    NodeHandle node = nodeHandle(0, 0);
+    for(std::size_t i = 0; i != 6; ++i)
+        layer.create(0, node);
+
+    Vector2 nodeOffsets[1];
+    Vector2 nodeSizes[1];
+    Float nodeOpacities[1]{1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::MutableBitArrayView nodesEnabled{nodesEnabledData, 0, 1};
+    layer.setSize({1, 1}, {1, 1});
+
+    /* Runs of 3, 4, then 0, 1, 2, and a lone 5 */
+    UnsignedInt dataIds[]{3, 4, 0, 1, 2, 5};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* The indices are for all data in the order of their IDs, independently
+       of the draw order */
+    const std::size_t indicesPerData = data.subdivided ? 54 : 6;
+    const UnsignedInt verticesPerData = data.subdivided ? 16 : 4;
+    CORRADE_COMPARE(layer.stateData().indices.size(), layer.capacity()*indicesPerData);
+    for(std::size_t i = 0; i != layer.capacity(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(layer.stateData().indices[i*indicesPerData], i*verticesPerData);
+    }
+
+    Containers::ArrayView<const Implementation::BaseLayerDrawRun> runs = layer.stateData().drawRuns;
+    CORRADE_COMPARE(runs.size(), 4);
+    CORRADE_COMPARE(runs[0].drawOffset, 0);
+    CORRADE_COMPARE(runs[0].dataId, 3);
+    CORRADE_COMPARE(runs[1].drawOffset, 2);
+    CORRADE_COMPARE(runs[1].dataId, 0);
+    CORRADE_COMPARE(runs[2].drawOffset, 5);
+    CORRADE_COMPARE(runs[2].dataId, 5);
+    /* Sentinel */
+    CORRADE_COMPARE(runs[3].drawOffset, 6);
+
+    /* Changing just the order updates the draw runs but not the indices */
+    const UnsignedInt* const indicesBefore = layer.stateData().indices.data();
+    UnsignedInt dataIdsReordered[]{5, 0, 1, 2, 3, 4};
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIdsReordered, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().indices.data(), indicesBefore);
+
+    Containers::ArrayView<const Implementation::BaseLayerDrawRun> reorderedRuns = layer.stateData().drawRuns;
+    CORRADE_COMPARE(reorderedRuns.size(), 3);
+    CORRADE_COMPARE(reorderedRuns[0].drawOffset, 0);
+    CORRADE_COMPARE(reorderedRuns[0].dataId, 5);
+    CORRADE_COMPARE(reorderedRuns[1].drawOffset, 1);
+    CORRADE_COMPARE(reorderedRuns[1].dataId, 0);
+    CORRADE_COMPARE(reorderedRuns[2].drawOffset, 6);
+}
+
+void BaseLayerTest::updateDataOrderFeatureRuns() {
+    auto&& data = UpdateDataOrderFeatureRunsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Verifies just the runs of data using the same shader features, drawing
+       them with shader variants is tested in BaseLayerGLTest */
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{4}
+        .setDynamicStyleCount(1)
+        .addFlags(data.flags)};
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {
+        /* Features 0 */
+        BaseLayerStyleUniform{},
+        /* Features 1, also with just the inner outline radius */
+        BaseLayerStyleUniform{}
+            .setInnerOutlineCornerRadius(2.0f),
+        /* Features 2 */
+        BaseLayerStyleUniform{}
+            .setOutlineWidth({0.0f, 1.0f, 0.0f, 0.0f}),
+        /* Features 3 */
+        BaseLayerStyleUniform{}
+            .setCornerRadius(4.0f)
+            .setOutlineWidth(1.0f),
+    }, {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    NodeHandle node = nodeHandle(0, 0);
+    layer.create(0, node);
+    layer.create(0, node);
+    layer.create(1, node);
+    layer.create(2, node);
+    /* A style with no outline but a custom outline width in the data, is
+       features 2 as well */
+    DataHandle outlined = layer.create(0, node);
+    layer.setOutlineWidth(outlined, {0.0f, 0.0f, 1.0f, 0.0f});
+    layer.create(3, node);
+    /* Dynamic styles are assumed to use all features, so 3 */
+    layer.create(4, node);
+
+    Vector2 nodeOffsets[1];
+    Vector2 nodeSizes[1];
+    Float nodeOpacities[1]{1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::MutableBitArrayView nodesEnabled{nodesEnabledData, 0, 1};
+    layer.setSize({1, 1}, {1, 1});
+
+    UnsignedInt dataIds[]{0, 1, 2, 3, 4, 5, 6};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    Containers::ArrayView<const Implementation::BaseLayerFeatureRun> runs = layer.stateData().featureRuns;
+    CORRADE_COMPARE(runs.size(), data.expectedRunCount);
+    for(std::size_t i = 0; i != runs.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(runs[i].drawOffset, data.expectedRunOffsets[i]);
+        /* The sentinel features are unspecified */
+        if(i != runs.size() - 1)
+            CORRADE_COMPARE(runs[i].features, data.expectedRunFeatures[i]);
+    }
+
+    /* Changing just the order updates the runs as well */
+    if(!data.expectedRunCount)
+        return;
+    UnsignedInt dataIdsReordered[]{5, 0, 1, 2, 3, 4, 6};
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIdsReordered, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().featureRuns.front().drawOffset, 0);
+    CORRADE_COMPARE(layer.stateData().featureRuns.front().features, data.expectedRunFeatures[data.expectedRunCount - 2]);
+}
+
+void BaseLayerTest::updateDataOrderCompactVertices() {
+    auto&& data = UpdateDataOrderCompactVerticesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Verifies that the compact vertices contain the same values as the
+       default ones, the default vertex contents are tested in
+       updateDataOrder() */
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    };
+
+    BaseLayer::Shared::Configuration configuration{2, 3};
+    configuration.setDynamicStyleCount(1);
+    if(data.textured)
+        configuration.addFlags(BaseLayerSharedFlag::Textured);
+    LayerShared shared{configuration};
+    LayerShared sharedCompact{BaseLayer::Shared::Configuration{configuration}
+        .addFlags(BaseLayerSharedFlag::CompactVertices)};
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared},
+      layerCompact{layerHandle(0, 1), sharedCompact};
+
+    Vector2 nodeOffsets[2]{{10.0f, 20.0f}, {-3.5f, 1.25f}};
+    Vector2 nodeSizes[2]{{200.0f, 100.0f}, {16.0f, 32.0f}};
+    Float nodeOpacities[2]{1.0f, 0.75f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::MutableBitArrayView nodesEnabled{nodesEnabledData, 0, 2};
+    UnsignedInt dataIds[]{2, 0, 1};
+
+    for(Layer* l: {&layer, &layerCompact}) {
+        l->shared().setStyle(BaseLayerCommonStyleUniform{},
+            {BaseLayerStyleUniform{}, BaseLayerStyleUniform{}},
+            {1, 0, 1},
+            {{}, {1.0f, 2.0f, 3.0f, 4.0f}, {}});
+        l->setSize({300, 200}, {300, 200});
+
+        DataHandle first = l->create(1, nodeHandle(0, 0));
+        l->setColor(first, 0x336699cc_rgbaf);
+        l->setOutlineWidth(first, {1.5f, 0.25f, 3.0f, 0.0f});
+        l->setPadding(first, {2.0f, 4.0f, 8.0f, 0.5f});
+        if(data.textured)
+            l->setTextureCoordinates(first, {0.25f, 0.5f, 7.0f}, {0.5f, 0.25f});
+
+        /* A color that's out of range gets clamped */
+        DataHandle second = l->create(0, nodeHandle(1, 0));
+        l->setColor(second, Color4{1.5f, 0.5f, -0.5f, 1.0f});
+
+        /* Dynamic style */
+        l->create(3, nodeHandle(0, 0));
+
+        l->update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    }
+
+    const std::size_t vertexSize = data.textured ?
+        sizeof(Implementation::BaseLayerTexturedVertex) :
+        sizeof(Implementation::BaseLayerVertex);
+    const std::size_t compactVertexSize = data.textured ?
+        sizeof(Implementation::BaseLayerCompactTexturedVertex) :
+        sizeof(Implementation::BaseLayerCompactVertex);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), layer.capacity()*4*vertexSize);
+    CORRADE_COMPARE(layerCompact.stateData().vertices.size(), layerCompact.capacity()*4*compactVertexSize);
+    CORRADE_COMPARE(compactVertexSize, data.textured ? 40 : 28);
+
+    Containers::StridedArrayView1D<const Implementation::BaseLayerVertex> vertices{
+        layer.stateData().vertices,
+        reinterpret_cast<const Implementation::BaseLayerVertex*>(layer.stateData().vertices.data()),
+        layer.capacity()*4, std::ptrdiff_t(vertexSize)};
+    Containers::StridedArrayView1D<const Implementation::BaseLayerCompactVertex> compactVertices{
+        layerCompact.stateData().vertices,
+        reinterpret_cast<const Implementation::BaseLayerCompactVertex*>(layerCompact.stateData().vertices.data()),
+        layerCompact.capacity()*4, std::ptrdiff_t(compactVertexSize)};
+    for(std::size_t i = 0; i != 3*4; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(compactVertices[i].position, vertices[i].position);
+        CORRADE_COMPARE(Math::unpackHalf(compactVertices[i].centerDistance), vertices[i].centerDistance);
+        CORRADE_COMPARE(Math::unpackHalf(compactVertices[i].outlineWidth), vertices[i].outlineWidth);
+        CORRADE_COMPARE(compactVertices[i].color, Math::pack<Color4ub>(Math::clamp(vertices[i].color, 0.0f, 1.0f)));
+        CORRADE_COMPARE(compactVertices[i].styleUniform, vertices[i].styleUniform);
+    }
+    /* Verify the clamping and dynamic style mapping explicitly as well */
+    CORRADE_COMPARE(compactVertices[1*4].color, (Color4ub{255, 96, 0, 191}));
+    CORRADE_COMPARE(compactVertices[2*4].styleUniform, 2);
+
+    if(data.textured) {
+        Containers::StridedArrayView1D<const Implementation::BaseLayerTexturedVertex> texturedVertices = Containers::arrayCast<const Implementation::BaseLayerTexturedVertex>(vertices);
+        Containers::StridedArrayView1D<const Implementation::BaseLayerCompactTexturedVertex> compactTexturedVertices = Containers::arrayCast<const Implementation::BaseLayerCompactTexturedVertex>(compactVertices);
+        for(std::size_t i = 0; i != 3*4; ++i) {
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(compactTexturedVertices[i].textureCoordinates, texturedVertices[i].textureCoordinates);
+        }
+    }
+}
+
+void BaseLayerTest::updateFillQuad() {
+    auto&& data = UpdateFillQuadData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* The SIMD variant, if any, should produce bit-exact output compared to
+       the scalar one, and neither should touch the bytes between the vertices.
+       The scalar output is tested in updateDataOrder() already. */
+
+    alignas(4) char expected[4*sizeof(Implementation::BaseLayerTexturedVertex)];
+    alignas(4) char actual[4*sizeof(Implementation::BaseLayerTexturedVertex)];
+    std::memset(expected, 0xcd, sizeof(expected));
+    std::memset(actual, 0xcd, sizeof(actual));
+
+    Implementation::fillBaseLayerQuadScalar(expected, data.stride, data.min, data.max, {1.0f, 2.5f, -3.0f, 0.125f}, 0x3366ff99_rgbaf, 1337);
+    Implementation::fillBaseLayerQuad(actual, data.stride, data.min, data.max, {1.0f, 2.5f, -3.0f, 0.125f}, 0x3366ff99_rgbaf, 1337);
+
+    CORRADE_COMPARE_AS(
+        Containers::arrayCast<const UnsignedInt>(Containers::arrayView(actual)),
+        Containers::arrayCast<const UnsignedInt>(Containers::arrayView(expected)),
+        TestSuite::Compare::Container);
+
+    /* Verify the vertex order and values to be sure the tested variant is not
+       broken in the same way as the reference */
+    const Implementation::BaseLayerVertex& vertex1 = *reinterpret_cast<const Implementation::BaseLayerVertex*>(actual + data.stride);
+    CORRADE_COMPARE(vertex1.position, (Vector2{data.max.x(), data.min.y()}));
+    CORRADE_COMPARE(vertex1.centerDistance, (Vector2{data.max.x() - data.min.x(), data.min.y() - data.max.y()})*0.5f);
+    CORRADE_COMPARE(vertex1.outlineWidth, (Vector4{1.0f, 2.5f, -3.0f, 0.125f}));
+    CORRADE_COMPARE(vertex1.color, 0x3366ff99_rgbaf);
+    CORRADE_COMPARE(vertex1.styleUniform, 1337);
+}
+
+void BaseLayerTest::updateDataStyle() {
+    /* An event style transition should regenerate only vertices of the data
+       that changed, the full vertex contents are tested in updateDataOrder()
+       already */
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{3, 2}};
+
+    shared.setStyle(BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}, BaseLayerStyleUniform{}, BaseLayerStyleUniform{}},
+        {0, 2},
+        {{}, {1.0f, 2.0f, 3.0f, 4.0f}});
+    /* Style 0 transitions to style 1 on hover */
+    shared.setStyleTransition(
+        nullptr,
+        [](UnsignedInt style) { return style == 0 ? 1u : style; },
+        nullptr, nullptr, nullptr, nullptr, nullptr);
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+    layer.setSize({300, 200}, {300, 200});
+
+    layer.create(0, nodeHandle(0, 0));
+    layer.create(0, nodeHandle(1, 0));
+    layer.create(0, nodeHandle(0, 0));
+
+    Vector2 nodeOffsets[2]{{10.0f, 20.0f}, {30.0f, 40.0f}};
+    Vector2 nodeSizes[2]{{100.0f, 50.0f}, {100.0f, 50.0f}};
+    Float nodeOpacities[2]{1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{0x3};
+    Containers::MutableBitArrayView nodesEnabled{nodesEnabledData, 0, 2};
+    UnsignedInt dataIds[]{0, 1, 2};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    const Containers::StridedArrayView1D<const Implementation::BaseLayerVertex> vertices = Containers::arrayCast<const Implementation::BaseLayerVertex>(layer.stateData().vertices);
+    CORRADE_COMPARE(vertices[0*4].position, (Vector2{10.0f, 20.0f}));
+    CORRADE_COMPARE(vertices[1*4].position, (Vector2{30.0f, 40.0f}));
+    CORRADE_COMPARE(vertices[1*4].styleUniform, 0);
+
+    /* Hovering the second data transitions its style, resulting in just a
+       style update being requested */
+    PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+    layer.pointerEnterEvent(1, event);
+    CORRADE_COMPARE(layer.style(layerDataHandle(1, 1)), 1);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataStyleUpdate);
+
+    /* Change the node offsets to be able to tell which vertices got
+       regenerated. Only the second data should have the new offset, its new
+       padding and the new style uniform. */
+    nodeOffsets[0] = {};
+    nodeOffsets[1] = {50.0f, 60.0f};
+    layer.update(LayerState::NeedsDataStyleUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+    CORRADE_VERIFY(layer.stateData().styleChangedDataIds.isEmpty());
+    CORRADE_COMPARE(vertices[0*4].position, (Vector2{10.0f, 20.0f}));
+    CORRADE_COMPARE(vertices[1*4].position, (Vector2{51.0f, 62.0f}));
+    CORRADE_COMPARE(vertices[1*4 + 3].position, (Vector2{147.0f, 106.0f}));
+    CORRADE_COMPARE(vertices[1*4].styleUniform, 2);
+    CORRADE_COMPARE(vertices[2*4].position, (Vector2{10.0f, 20.0f}));
+
+    /* Removed data are skipped */
+    layer.pointerEnterEvent(2, event);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataStyleUpdate);
+    layer.remove(layerDataHandle(2, 1));
+    layer.update(LayerState::NeedsDataStyleUpdate, Containers::arrayView(dataIds).prefix(2), {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(vertices[2*4].position, (Vector2{10.0f, 20.0f}));
+    CORRADE_COMPARE(vertices[2*4].styleUniform, 0);
+
+    /* With instanced quads there's no per-data patching and a full update is
+       requested instead */
+    LayerShared sharedInstanced{BaseLayer::Shared::Configuration{3, 2}
+        .addFlags(BaseLayerSharedFlag::InstancedQuads)};
+    sharedInstanced.setStyleTransition(
+        nullptr,
+        [](UnsignedInt style) { return style == 0 ? 1u : style; },
+        nullptr, nullptr, nullptr, nullptr, nullptr);
+    Layer layerInstanced{layerHandle(0, 1), sharedInstanced};
+    layerInstanced.create(0, nodeHandle(0, 0));
+    PointerMoveEvent eventInstanced{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+    layerInstanced.pointerEnterEvent(0, eventInstanced);
+    CORRADE_COMPARE(layerInstanced.state(), LayerState::NeedsDataUpdate);
+}
+
+void BaseLayerTest::updateNodeOpacity() {
+    auto&& data = UpdateNodeOpacityData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A node opacity change alone should update just the vertex colors, the
+       full vertex contents are tested in updateDataOrder() already */
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1}
+        .addFlags(data.flags)};
+    shared.setStyle(BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+    layer.setSize({300, 200}, {300, 200});
+
+    layer.setColor(layer.create(0, nodeHandle(0, 0)), 0xff336699_rgbaf);
+    layer.setColor(layer.create(0, nodeHandle(1, 0)), 0x3366ff99_rgbaf);
+
+    Vector2 nodeOffsets[2]{{10.0f, 20.0f}, {30.0f, 40.0f}};
+    Vector2 nodeSizes[2]{{100.0f, 50.0f}, {100.0f, 50.0f}};
+    Float nodeOpacities[2]{1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{0x3};
+    Containers::MutableBitArrayView nodesEnabled{nodesEnabledData, 0, 2};
+    UnsignedInt dataIds[]{0, 1};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Change the node offsets as well to verify the positions don't get
+       regenerated */
+    nodeOffsets[0] = {};
+    nodeOffsets[1] = {};
+    nodeOpacities[1] = 0.5f;
+    layer.update(LayerState::NeedsNodeOpacityUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    if(data.flags >= BaseLayerSharedFlag::SubdividedQuads) {
+        const Containers::StridedArrayView1D<const Implementation::BaseLayerSubdividedVertex> vertices = Containers::arrayCast<const Implementation::BaseLayerSubdividedVertex>(layer.stateData().vertices);
+        for(std::size_t i = 0; i != 16; ++i) {
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(vertices[0*16 + i].color, 0xff336699_rgbaf);
+            CORRADE_COMPARE(vertices[1*16 + i].color, 0x3366ff99_rgbaf*0.5f);
+        }
+        CORRADE_COMPARE(vertices[0*16].position, (Vector2{10.0f, 20.0f}));
+        CORRADE_COMPARE(vertices[1*16].position, (Vector2{30.0f, 40.0f}));
+    } else if(data.flags >= BaseLayerSharedFlag::CompactVertices) {
+        const Containers::StridedArrayView1D<const Implementation::BaseLayerCompactVertex> vertices = Containers::arrayCast<const Implementation::BaseLayerCompactVertex>(layer.stateData().vertices);
+        for(std::size_t i = 0; i != 4; ++i) {
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(vertices[0*4 + i].color, Math::pack<Color4ub>(0xff336699_rgbaf));
+            CORRADE_COMPARE(vertices[1*4 + i].color, Math::pack<Color4ub>(0x3366ff99_rgbaf*0.5f));
+        }
+        CORRADE_COMPARE(vertices[0*4].position, (Vector2{10.0f, 20.0f}));
+        CORRADE_COMPARE(vertices[1*4].position, (Vector2{30.0f, 40.0f}));
+    } else {
+        const std::size_t typeSize = data.flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerTexturedVertex) :
+            sizeof(Implementation::BaseLayerVertex);
+        const Containers::StridedArrayView1D<const Implementation::BaseLayerVertex> vertices{
+            layer.stateData().vertices,
+            reinterpret_cast<const Implementation::BaseLayerVertex*>(layer.stateData().vertices.data()),
+            layer.stateData().vertices.size()/typeSize,
+            std::ptrdiff_t(typeSize)};
+        for(std::size_t i = 0; i != 4; ++i) {
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(vertices[0*4 + i].color, 0xff336699_rgbaf);
+            CORRADE_COMPARE(vertices[1*4 + i].color, 0x3366ff99_rgbaf*0.5f);
+        }
+        CORRADE_COMPARE(vertices[0*4].position, (Vector2{10.0f, 20.0f}));
+        CORRADE_COMPARE(vertices[1*4].position, (Vector2{30.0f, 40.0f}));
+    }
+}
+
+void BaseLayerTest::updateNodeTranslation() {
+    auto&& data = UpdateNodeTranslationData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A node translation should only shift the existing vertex positions or
+       instance rectangles, the full vertex contents are tested in
+       updateDataOrder() already */
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1}
+        .addFlags(data.flags)};
+    shared.setStyle(BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        const BaseLayer::State& stateData() const {
+            return static_cast<const BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+    layer.setSize({300, 200}, {300, 200});
+    CORRADE_VERIFY(layer.features() >= LayerFeature::NodeTranslation);
+
+    DataHandle data0 = layer.create(0, nodeHandle(0, 0));
+    DataHandle data1 = layer.create(0, nodeHandle(1, 0));
+    layer.setColor(data0, 0xff336699_rgbaf);
+    layer.setColor(data1, 0x3366ff99_rgbaf);
+
+    Vector2 nodeOffsets[2]{{10.0f, 20.0f}, {30.0f, 40.0f}};
+    Vector2 nodeSizes[2]{{100.0f, 50.0f}, {100.0f, 50.0f}};
+    Float nodeOpacities[2]{1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{0x3};
+    Containers::MutableBitArrayView nodesEnabled{nodesEnabledData, 0, 2};
+    UnsignedInt dataIds[]{1, 0};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Change the colors as well to verify the vertices don't get
+       regenerated */
+    layer.setColor(data0, 0x11223344_rgbaf);
+    layer.setColor(data1, 0x55667788_rgbaf);
+    nodeOffsets[0] = {15.0f, 20.0f};
+    nodeOffsets[1] = {30.0f, 10.0f};
+    layer.update(LayerState::NeedsNodeTranslationUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* Translating again applies the difference to the new offsets */
+    nodeOffsets[0] = {25.0f, 30.0f};
+    layer.update(LayerState::NeedsNodeTranslationUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    if(data.flags >= BaseLayerSharedFlag::InstancedQuads) {
+        const std::size_t typeSize = data.flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerTexturedInstance) :
+            sizeof(Implementation::BaseLayerInstance);
+        const Containers::StridedArrayView1D<const Implementation::BaseLayerInstance> instances{
+            layer.stateData().vertices,
+            reinterpret_cast<const Implementation::BaseLayerInstance*>(layer.stateData().vertices.data()),
+            layer.stateData().vertices.size()/typeSize,
+            std::ptrdiff_t(typeSize)};
+        CORRADE_COMPARE(instances.size(), 2);
+        /* Instances are in draw order */
+        CORRADE_COMPARE(instances[0].color, 0x3366ff99_rgbaf);
+        CORRADE_COMPARE(instances[1].color, 0xff336699_rgbaf);
+        CORRADE_COMPARE(instances[0].min, (Vector2{30.0f, 10.0f}));
+        CORRADE_COMPARE(instances[0].max, (Vector2{130.0f, 60.0f}));
+        CORRADE_COMPARE(instances[1].min, (Vector2{25.0f, 30.0f}));
+        CORRADE_COMPARE(instances[1].max, (Vector2{125.0f, 80.0f}));
+    } else if(data.flags >= BaseLayerSharedFlag::SubdividedQuads) {
+        const Containers::StridedArrayView1D<const Implementation::BaseLayerSubdividedVertex> vertices = Containers::arrayCast<const Implementation::BaseLayerSubdividedVertex>(layer.stateData().vertices);
+        for(std::size_t i = 0; i != 16; ++i) {
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(vertices[0*16 + i].color, 0xff336699_rgbaf);
+            CORRADE_COMPARE(vertices[1*16 + i].color, 0x3366ff99_rgbaf);
+        }
+        CORRADE_COMPARE(vertices[0*16 + 0].position, (Vector2{25.0f, 30.0f}));
+        CORRADE_COMPARE(vertices[0*16 + 12].position, (Vector2{125.0f, 80.0f}));
+        CORRADE_COMPARE(vertices[1*16 + 0].position, (Vector2{30.0f, 10.0f}));
+        CORRADE_COMPARE(vertices[1*16 + 12].position, (Vector2{130.0f, 60.0f}));
+    } else if(data.flags >= BaseLayerSharedFlag::CompactVertices) {
+        const Containers::StridedArrayView1D<const Implementation::BaseLayerCompactVertex> vertices = Containers::arrayCast<const Implementation::BaseLayerCompactVertex>(layer.stateData().vertices);
+        for(std::size_t i = 0; i != 4; ++i) {
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(vertices[0*4 + i].color, Math::pack<Color4ub>(0xff336699_rgbaf));
+            CORRADE_COMPARE(vertices[1*4 + i].color, Math::pack<Color4ub>(0x3366ff99_rgbaf));
+        }
+        CORRADE_COMPARE(vertices[0*4 + 0].position, (Vector2{25.0f, 30.0f}));
+        CORRADE_COMPARE(vertices[0*4 + 3].position, (Vector2{125.0f, 80.0f}));
+        CORRADE_COMPARE(vertices[1*4 + 0].position, (Vector2{30.0f, 10.0f}));
+        CORRADE_COMPARE(vertices[1*4 + 3].position, (Vector2{130.0f, 60.0f}));
+    } else {
+        const std::size_t typeSize = data.flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerTexturedVertex) :
+            sizeof(Implementation::BaseLayerVertex);
+        const Containers::StridedArrayView1D<const Implementation::BaseLayerVertex> vertices{
+            layer.stateData().vertices,
+            reinterpret_cast<const Implementation::BaseLayerVertex*>(layer.stateData().vertices.data()),
+            layer.stateData().vertices.size()/typeSize,
+            std::ptrdiff_t(typeSize)};
+        for(std::size_t i = 0; i != 4; ++i) {
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(vertices[0*4 + i].color, 0xff336699_rgbaf);
+            CORRADE_COMPARE(vertices[1*4 + i].color, 0x3366ff99_rgbaf);
+        }
+        CORRADE_COMPARE(vertices[0*4 + 0].position, (Vector2{25.0f, 30.0f}));
+        CORRADE_COMPARE(vertices[0*4 + 3].position, (Vector2{125.0f, 80.0f}));
+        CORRADE_COMPARE(vertices[1*4 + 0].position, (Vector2{30.0f, 10.0f}));
+        CORRADE_COMPARE(vertices[1*4 + 3].position, (Vector2{130.0f, 60.0f}));
+    }
+}
+
 void BaseLayerTest::updateNoStyleSet() {
     auto&& data = UpdateNoStyleSetData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
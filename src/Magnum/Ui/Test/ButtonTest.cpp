@@ -25,6 +25,7 @@
 */
 
 #include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringIterable.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 
 #include "Magnum/Ui/Anchor.h"
@@ -47,6 +48,9 @@ struct ButtonTest: WidgetTester {
     void constructIconText();
     void constructIconTextTextProperties();
     void constructNoCreate();
+    void constructMultiple();
+    void constructMultipleTextProperties();
+    void constructMultipleInvalid();
 
     void setStyle();
     void setStyleWhileActive();
@@ -85,6 +89,9 @@ ButtonTest::ButtonTest() {
         &ButtonTest::constructIconText,
         &ButtonTest::constructIconTextTextProperties,
         &ButtonTest::constructNoCreate,
+        &ButtonTest::constructMultiple,
+        &ButtonTest::constructMultipleTextProperties,
+        &ButtonTest::constructMultipleInvalid,
     }, &WidgetTester::setup,
        &WidgetTester::teardown);
 
@@ -350,6 +357,108 @@ void ButtonTest::constructNoCreate() {
     CORRADE_COMPARE(button.textData(), DataHandle::Null);
 }
 
+void ButtonTest::constructMultiple() {
+    NodeHandle nodes[]{
+        ui.createNode(rootNode, {}, {32, 16}),
+        ui.createNode(rootNode, {}, {32, 16}),
+        ui.createNode(rootNode, {}, {32, 16}),
+        ui.createNode(rootNode, {}, {32, 16}),
+        ui.createNode(rootNode, {}, {32, 16}),
+    };
+    Icon icons[]{
+        Icon::None,
+        Icon::Yes,
+        Icon::No,
+        Icon::None,
+        Icon::No
+    };
+    const Containers::StringView texts[]{
+        "hello!",
+        "",
+        "bye!",
+        "",
+        "ok"
+    };
+    ButtonStyle styles[]{
+        ButtonStyle::Primary,
+        ButtonStyle::Danger,
+        ButtonStyle::Dim,
+        ButtonStyle::Success,
+        ButtonStyle::Flat
+    };
+    buttons(ui, nodes, icons, Containers::arrayView(texts), styles);
+
+    /* Can only verify that the data were created, nothing else. Visually
+       tested in StyleGLTest. */
+    CORRADE_COMPARE(ui.baseLayer().usedCount(), 5);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 6);
+
+    /* Icons are created first, texts after, all in order */
+    CORRADE_COMPARE(ui.textLayer().node(layerDataHandle(0, 1)), nodes[1]);
+    CORRADE_COMPARE(ui.textLayer().node(layerDataHandle(1, 1)), nodes[2]);
+    CORRADE_COMPARE(ui.textLayer().node(layerDataHandle(2, 1)), nodes[4]);
+    CORRADE_COMPARE(ui.textLayer().glyphCount(layerDataHandle(0, 1)), 1);
+    CORRADE_COMPARE(ui.textLayer().glyphCount(layerDataHandle(1, 1)), 1);
+    CORRADE_COMPARE(ui.textLayer().glyphCount(layerDataHandle(2, 1)), 1);
+    CORRADE_COMPARE(ui.textLayer().node(layerDataHandle(3, 1)), nodes[0]);
+    CORRADE_COMPARE(ui.textLayer().node(layerDataHandle(4, 1)), nodes[2]);
+    CORRADE_COMPARE(ui.textLayer().node(layerDataHandle(5, 1)), nodes[4]);
+    CORRADE_COMPARE(ui.textLayer().glyphCount(layerDataHandle(3, 1)), 6);
+    CORRADE_COMPARE(ui.textLayer().glyphCount(layerDataHandle(4, 1)), 4);
+    CORRADE_COMPARE(ui.textLayer().glyphCount(layerDataHandle(5, 1)), 2);
+
+    /* Empty icons and texts means just the background gets created */
+    buttons(ui, Containers::arrayView(nodes).prefix(2), nullptr, {}, Containers::arrayView(styles).prefix(2));
+    CORRADE_COMPARE(ui.baseLayer().usedCount(), 7);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 6);
+}
+
+void ButtonTest::constructMultipleTextProperties() {
+    NodeHandle nodes[]{
+        ui.createNode(rootNode, {}, {32, 16}),
+        ui.createNode(rootNode, {}, {32, 16}),
+    };
+    const Containers::StringView texts[]{
+        "hello!",
+        "bye!"
+    };
+    TextProperties properties[2];
+    properties[1].setScript(Text::Script::Braille);
+    ButtonStyle styles[]{
+        ButtonStyle::Info,
+        ButtonStyle::Warning
+    };
+    buttons(ui, nodes, nullptr, Containers::arrayView(texts), properties, styles);
+
+    CORRADE_COMPARE(ui.baseLayer().usedCount(), 2);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 2);
+    CORRADE_COMPARE(ui.textLayer().glyphCount(layerDataHandle(0, 1)), 6);
+    /* Multiplied by 6 because of the Braille script */
+    CORRADE_COMPARE(ui.textLayer().glyphCount(layerDataHandle(1, 1)), 4*6);
+}
+
+void ButtonTest::constructMultipleInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    NodeHandle nodes[3]{};
+    Icon icons[2]{};
+    const Containers::StringView texts[3];
+    TextProperties properties[3];
+    ButtonStyle styles[3]{};
+
+    Containers::String out;
+    Error redirectError{&out};
+    buttons(ui, nodes, icons, Containers::arrayView(texts), properties, styles);
+    buttons(ui, nodes, nullptr, Containers::arrayView(texts).prefix(2), properties, styles);
+    buttons(ui, nodes, nullptr, Containers::arrayView(texts), Containers::arrayView(properties).prefix(1), styles);
+    buttons(ui, nodes, nullptr, Containers::arrayView(texts), properties, Containers::arrayView(styles).prefix(2));
+    CORRADE_COMPARE(out,
+        "Ui::buttons(): expected icon, text, text property and style views to have a size of 3 but got 2, 3, 3 and 3\n"
+        "Ui::buttons(): expected icon, text, text property and style views to have a size of 3 but got 0, 2, 3 and 3\n"
+        "Ui::buttons(): expected icon, text, text property and style views to have a size of 3 but got 0, 3, 1 and 3\n"
+        "Ui::buttons(): expected icon, text, text property and style views to have a size of 3 but got 0, 3, 3 and 2\n");
+}
+
 void ButtonTest::setStyle() {
     auto&& data = SetStyleData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
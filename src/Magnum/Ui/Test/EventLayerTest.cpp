@@ -25,10 +25,12 @@
 */
 
 #include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Magnum/Math/Complex.h>
 
@@ -62,8 +64,12 @@ struct EventLayerTest: TestSuite::Tester {
 
     void connect();
     void connectScoped();
+    void connectShared();
+    void connectSharedInvalid();
+    void callShared();
     void remove();
     void removeScoped();
+    void removeShared();
     void connectRemoveHandleRecycle();
     void cleanNodes();
 
@@ -295,6 +301,67 @@ const struct {
     #undef _c
 };
 
+const struct {
+    TestSuite::TestCaseDescriptionSourceLocation name;
+    void(*functor)(EventLayer&, const Containers::StridedArrayView1D<const NodeHandle>&, Int& output, const Containers::StridedArrayView1D<DataHandle>&);
+    void(*call)(EventLayer& layer, UnsignedInt dataId);
+} ConnectSharedData[]{
+    #define _c(function)  #function,                                        \
+        [](EventLayer& layer, const Containers::StridedArrayView1D<const NodeHandle>& nodes, Int& output, const Containers::StridedArrayView1D<DataHandle>& handles) { \
+            ConnectFunctor<NodeHandle> functor{output};                     \
+            layer.function(nodes, functor, handles);                        \
+        }
+    {_c(onPress),
+        [](EventLayer& layer, UnsignedInt dataId) {
+            PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+            layer.pointerPressEvent(dataId, event);
+        }},
+    {_c(onRelease),
+        [](EventLayer& layer, UnsignedInt dataId) {
+            PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+            layer.pointerReleaseEvent(dataId, event);
+        }},
+    {_c(onTapOrClick),
+        [](EventLayer& layer, UnsignedInt dataId) {
+            /* Yes, this uses the horrific testing-only constructor */
+            PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0, {}, true, {1.0f, 1.0f}};
+            layer.pointerReleaseEvent(dataId, event);
+        }},
+    {_c(onMiddleClick),
+        [](EventLayer& layer, UnsignedInt dataId) {
+            /* Yes, this uses the horrific testing-only constructor */
+            PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseMiddle, true, 0, {}, true, {1.0f, 1.0f}};
+            layer.pointerReleaseEvent(dataId, event);
+        }},
+    {_c(onRightClick),
+        [](EventLayer& layer, UnsignedInt dataId) {
+            /* Yes, this uses the horrific testing-only constructor */
+            PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseRight, true, 0, {}, true, {1.0f, 1.0f}};
+            layer.pointerReleaseEvent(dataId, event);
+        }},
+    {_c(onEnter),
+        [](EventLayer& layer, UnsignedInt dataId) {
+            PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+            layer.pointerEnterEvent(dataId, event);
+        }},
+    {_c(onLeave),
+        [](EventLayer& layer, UnsignedInt dataId) {
+            PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+            layer.pointerLeaveEvent(dataId, event);
+        }},
+    {_c(onFocus),
+        [](EventLayer& layer, UnsignedInt dataId) {
+            FocusEvent event{{}};
+            layer.focusEvent(dataId, event);
+        }},
+    {_c(onBlur),
+        [](EventLayer& layer, UnsignedInt dataId) {
+            FocusEvent event{{}};
+            layer.blurEvent(dataId, event);
+        }},
+    #undef _c
+};
+
 const struct {
     const char* name;
     NodeFlags flags;
@@ -409,8 +476,15 @@ EventLayerTest::EventLayerTest() {
                        &EventLayerTest::connectScoped},
         Containers::arraySize(ConnectData));
 
-    addTests({&EventLayerTest::remove,
+    addInstancedTests({&EventLayerTest::connectShared},
+        Containers::arraySize(ConnectSharedData));
+
+    addTests({&EventLayerTest::connectSharedInvalid,
+              &EventLayerTest::callShared,
+
+              &EventLayerTest::remove,
               &EventLayerTest::removeScoped,
+              &EventLayerTest::removeShared,
               &EventLayerTest::connectRemoveHandleRecycle,
               &EventLayerTest::cleanNodes,
 
@@ -838,6 +912,111 @@ void EventLayerTest::connectScoped() {
     CORRADE_COMPARE(functorOutput, 2*3*5*7*5);
 }
 
+void EventLayerTest::connectShared() {
+    auto&& data = ConnectSharedData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Int functorOutput = 1;
+
+    {
+        EventLayer layer{layerHandle(0x96, 0xef)};
+
+        /* Some initial data to have non-trivial IDs */
+        layer.onTapOrClick(nodeHandle(0, 1), []{});
+        layer.onTapOrClick(nodeHandle(2, 3), []{});
+
+        /* The same node listed twice is fine */
+        const NodeHandle nodes[]{
+            nodeHandle(137, 0xded),
+            nodeHandle(4, 5),
+            nodeHandle(137, 0xded),
+        };
+        DataHandle handles[3]{};
+
+        /* A functor temporary gets constructed inside, copied just once for
+           all connections and destructed */
+        data.functor(layer, nodes, functorOutput, handles);
+        CORRADE_COMPARE(functorOutput, 2*3*5);
+        CORRADE_COMPARE(handles[0], dataHandle(layer.handle(), 2, 1));
+        CORRADE_COMPARE(handles[1], dataHandle(layer.handle(), 3, 1));
+        CORRADE_COMPARE(handles[2], dataHandle(layer.handle(), 4, 1));
+        CORRADE_COMPARE(layer.node(handles[0]), nodes[0]);
+        CORRADE_COMPARE(layer.node(handles[1]), nodes[1]);
+        CORRADE_COMPARE(layer.node(handles[2]), nodes[2]);
+
+        /* The shared functor is counted just once */
+        CORRADE_COMPARE(layer.usedCount(), 5);
+        CORRADE_COMPARE(layer.usedScopedConnectionCount(), 0);
+        CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 1);
+
+        /* The functor gets called for each data it's connected to */
+        data.call(layer, 2);
+        data.call(layer, 4);
+        CORRADE_COMPARE(functorOutput, 2*3*5*7*7);
+    }
+
+    /* The functor copy gets destructed after, just once */
+    CORRADE_COMPARE(functorOutput, 2*3*5*7*7*5);
+}
+
+void EventLayerTest::connectSharedInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    EventLayer layer{layerHandle(0, 1)};
+
+    const NodeHandle nodes[2]{};
+    DataHandle handles[2]{};
+    DataHandle handlesInvalid[3]{};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.onBlur(nodes, nullptr, handles);
+    layer.onBlur(nodes, [](NodeHandle) {}, handlesInvalid);
+    CORRADE_COMPARE(out,
+        "Ui::EventLayer: slot is null\n"
+        "Ui::EventLayer: expected 2 handles but got 3\n");
+}
+
+void EventLayerTest::callShared() {
+    EventLayer layer{layerHandle(0, 1)};
+
+    Containers::Array<NodeHandle> called;
+    const NodeHandle nodes[]{
+        nodeHandle(3, 4),
+        nodeHandle(1, 2),
+        nodeHandle(7, 1),
+    };
+    DataHandle handles[3]{};
+    layer.onPress(nodes, [&called](NodeHandle node) {
+        arrayAppend(called, node);
+    }, handles);
+
+    /* The slot receives the node the connection is attached to */
+    {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        layer.pointerPressEvent(dataHandleId(handles[1]), event);
+        CORRADE_VERIFY(event.isAccepted());
+    } {
+        PointerEvent event{{}, PointerEventSource::Touch, Pointer::Finger, true, 0};
+        layer.pointerPressEvent(dataHandleId(handles[2]), event);
+        CORRADE_VERIFY(event.isAccepted());
+    } {
+        /* Wrong button, same filtering as with the single-node variant */
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseRight, true, 0};
+        layer.pointerPressEvent(dataHandleId(handles[0]), event);
+        CORRADE_VERIFY(!event.isAccepted());
+    } {
+        PointerEvent event{{}, PointerEventSource::Pen, Pointer::Pen, true, 0};
+        layer.pointerPressEvent(dataHandleId(handles[0]), event);
+        CORRADE_VERIFY(event.isAccepted());
+    }
+    CORRADE_COMPARE_AS(called, Containers::arrayView({
+        nodeHandle(1, 2),
+        nodeHandle(7, 1),
+        nodeHandle(3, 4),
+    }), TestSuite::Compare::Container);
+}
+
 void EventLayerTest::remove() {
     Int destructedCount = 0;
     struct NonTrivial {
@@ -922,6 +1101,87 @@ void EventLayerTest::removeScoped() {
     }
 }
 
+void EventLayerTest::removeShared() {
+    Int destructedCount = 0;
+    Int anotherDestructedCount = 0;
+    struct NonTrivial {
+        explicit NonTrivial(int& output): destructedCount{&output} {}
+        ~NonTrivial() {
+            ++*destructedCount;
+        }
+        void operator()(NodeHandle) const {}
+
+        Int* destructedCount;
+    };
+
+    EventLayer layer{layerHandle(0, 1)};
+
+    const NodeHandle nodes[]{
+        nodeHandle(0, 1),
+        nodeHandle(1, 2),
+    };
+    DataHandle handles[2]{};
+
+    /* The temporary gets destructed right away */
+    layer.onTapOrClick(nodes, NonTrivial{destructedCount}, handles);
+    CORRADE_COMPARE(layer.usedCount(), 2);
+    CORRADE_COMPARE(layer.usedScopedConnectionCount(), 0);
+    CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 1);
+    CORRADE_COMPARE(destructedCount, 1);
+
+    /* Removing one connection keeps the shared slot alive for the other */
+    layer.remove(handles[0]);
+    CORRADE_COMPARE(layer.usedCount(), 1);
+    CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 1);
+    CORRADE_COMPARE(destructedCount, 1);
+
+    /* Another shared connection shouldn't reuse the slot that's still in
+       use */
+    const NodeHandle anotherNodes[]{
+        nodeHandle(3, 4),
+    };
+    DataHandle anotherHandles[1]{};
+    layer.onEnter(anotherNodes, NonTrivial{anotherDestructedCount}, anotherHandles);
+    CORRADE_COMPARE(layer.usedCount(), 2);
+    CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 2);
+    CORRADE_COMPARE(destructedCount, 1);
+    CORRADE_COMPARE(anotherDestructedCount, 1);
+
+    /* Removing the last connection destroys the shared slot. Verifying also
+       the other handle overload. */
+    layer.remove(dataHandleData(handles[1]));
+    CORRADE_COMPARE(layer.usedCount(), 1);
+    CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 1);
+    CORRADE_COMPARE(destructedCount, 2);
+    CORRADE_COMPARE(anotherDestructedCount, 1);
+
+    /* A new shared connection reuses the freed slot and doesn't call the
+       destructor on the previous function again */
+    DataHandle handles2[2]{};
+    layer.onLeave(nodes, NonTrivial{destructedCount}, handles2);
+    CORRADE_COMPARE(layer.usedCount(), 3);
+    CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 2);
+    CORRADE_COMPARE(destructedCount, 3);
+
+    /* Cleaning nodes goes through the same removal path */
+    UnsignedShort nodeHandleGenerations[]{
+        1,      /* node 0 stays */
+        3,      /* node 1 has generation = 2, so it gets deleted */
+        666,    /* node 2 isn't used */
+        5,      /* node 3 has generation = 4, so it gets deleted too */
+    };
+    layer.cleanNodes(nodeHandleGenerations);
+    CORRADE_COMPARE(layer.usedCount(), 1);
+    CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 1);
+    CORRADE_COMPARE(destructedCount, 3);
+    CORRADE_COMPARE(anotherDestructedCount, 2);
+
+    layer.remove(handles2[0]);
+    CORRADE_COMPARE(layer.usedCount(), 0);
+    CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 0);
+    CORRADE_COMPARE(destructedCount, 4);
+}
+
 void EventLayerTest::connectRemoveHandleRecycle() {
     Int destructedCount1 = 0,
         destructedCount2 = 0;
@@ -2588,9 +2848,9 @@ void EventLayerTest::dragFromUserInterfaceFallthroughThresholdMultipleHandlers()
         CORRADE_COMPARE(belowCalled1, 1);
     }
 
-    /* Second handler on the same node breaks it because it's currently tracked
-       on a data ID and not a node ID. Doing a press + drag again so it starts
-       from the nodeAbove -- it's only the fallthrough that breaks, not the
+    /* Second handler on the same node gets called as well, with the same
+       relative position. Doing a press + drag again so it starts from the
+       nodeAbove, as it's the fallthrough that's interesting here, not the
        direct call. */
     Int belowCalled2 = 0;
     layer.onDrag(nodeBelow, [&belowCalled2](const Vector2&) {
@@ -2602,8 +2862,6 @@ void EventLayerTest::dragFromUserInterfaceFallthroughThresholdMultipleHandlers()
         CORRADE_VERIFY(ui.pointerPressEvent({50, 70}, press));
         CORRADE_VERIFY(ui.pointerMoveEvent({70, 70}, move));
         CORRADE_COMPARE(aboveCalled, 2);
-
-        CORRADE_EXPECT_FAIL("Multiple onDrag() handlers on the same fallthrough node conflict with each other, causing nothing to be sent.");
         CORRADE_COMPARE(belowCalled1, 2);
         CORRADE_COMPARE(belowCalled2, 1);
     }
@@ -3378,16 +3636,14 @@ void EventLayerTest::pinchFromUserInterfaceMultipleHandlers() {
         CORRADE_COMPARE(called1, 1);
     }
 
-    /* Second handler on the same node breaks it because it's currently tracked
-       on a data ID and not a node ID */
+    /* Second handler on the same node gets called as well, with the gesture
+       being recognized just once for both */
     Int called2 = 0;
     layer.onPinch(node, [&called2](const Vector2&, const Vector2&, const Complex&, Float) {
         ++called2;
     });
     {
         PointerMoveEvent move{{}, PointerEventSource::Touch, {}, {}, false, 3371};
-
-        CORRADE_EXPECT_FAIL("Multiple onPinch() handlers on the same node conflict with each other, causing nothing to be sent.");
         CORRADE_VERIFY(ui.pointerMoveEvent({50, 75}, move));
         CORRADE_COMPARE(called1, 2);
         CORRADE_COMPARE(called2, 1);
@@ -0,0 +1,368 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "VirtualList.h"
+
+#include <type_traits>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/Format.h>
+#include <Magnum/Math/Time.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractLayer.h"
+#include "Magnum/Ui/AbstractRenderer.h"
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Event.h"
+#include "Magnum/Ui/EventQueue.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/NodeFlags.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct EventQueueTest: TestSuite::Tester {
+    explicit EventQueueTest();
+
+    void construct();
+    void constructInvalidCapacity();
+    void constructCopy();
+    void constructMove();
+
+    void dispatch();
+    void dispatchEmpty();
+    void dispatchFull();
+    void dispatchTextCopied();
+    void dispatchEventsAddedDuringDispatch();
+    void dispatchCoalescing();
+};
+
+using namespace Math::Literals;
+
+EventQueueTest::EventQueueTest() {
+    addTests({&EventQueueTest::construct,
+              &EventQueueTest::constructInvalidCapacity,
+              &EventQueueTest::constructCopy,
+              &EventQueueTest::constructMove,
+
+              &EventQueueTest::dispatch,
+              &EventQueueTest::dispatchEmpty,
+              &EventQueueTest::dispatchFull,
+              &EventQueueTest::dispatchTextCopied,
+              &EventQueueTest::dispatchEventsAddedDuringDispatch,
+              &EventQueueTest::dispatchCoalescing});
+}
+
+struct Renderer: AbstractRenderer {
+    RendererFeatures doFeatures() const override { return {}; }
+    void doSetupFramebuffers(const Vector2i&) override {}
+    void doTransition(RendererTargetState, RendererTargetState, RendererDrawStates, RendererDrawStates) override {}
+};
+
+struct Layer: AbstractLayer {
+    using AbstractLayer::AbstractLayer;
+    using AbstractLayer::create;
+
+    LayerFeatures doFeatures() const override { return LayerFeature::Event; }
+
+    void doPointerPressEvent(UnsignedInt, PointerEvent& event) override {
+        arrayAppend(eventCalls, Utility::format("press {} {},{}", Long(event.time()), event.position().x(), event.position().y()));
+        event.setAccepted();
+    }
+    void doPointerReleaseEvent(UnsignedInt, PointerEvent& event) override {
+        arrayAppend(eventCalls, Utility::format("release {} {},{}", Long(event.time()), event.position().x(), event.position().y()));
+        event.setAccepted();
+    }
+    void doPointerMoveEvent(UnsignedInt, PointerMoveEvent& event) override {
+        arrayAppend(eventCalls, Utility::format("move {} {},{} coalesced {}", Long(event.time()), event.position().x(), event.position().y(), event.coalescedCount()));
+        event.setAccepted();
+    }
+    void doScrollEvent(UnsignedInt, ScrollEvent& event) override {
+        arrayAppend(eventCalls, Utility::format("scroll {} {},{} offset {},{}", Long(event.time()), event.position().x(), event.position().y(), event.offset().x(), event.offset().y()));
+        event.setAccepted();
+    }
+    void doFocusEvent(UnsignedInt, FocusEvent& event) override {
+        event.setAccepted();
+    }
+    void doKeyPressEvent(UnsignedInt, KeyEvent& event) override {
+        arrayAppend(eventCalls, Utility::format("key press {} {}", Long(event.time()), char(event.key())));
+        event.setAccepted();
+    }
+    void doKeyReleaseEvent(UnsignedInt, KeyEvent& event) override {
+        arrayAppend(eventCalls, Utility::format("key release {} {}", Long(event.time()), char(event.key())));
+        event.setAccepted();
+    }
+    void doTextInputEvent(UnsignedInt, TextInputEvent& event) override {
+        arrayAppend(eventCalls, Utility::format("text input {} {}", Long(event.time()), event.text()));
+        event.setAccepted();
+    }
+
+    Containers::Array<Containers::String> eventCalls;
+};
+
+void EventQueueTest::construct() {
+    EventQueue queue{16};
+    CORRADE_COMPARE(queue.capacity(), 16);
+    CORRADE_COMPARE(queue.size(), 0);
+}
+
+void EventQueueTest::constructInvalidCapacity() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::String out;
+    Error redirectError{&out};
+    EventQueue{0};
+    EventQueue{12};
+    CORRADE_COMPARE(out,
+        "Ui::EventQueue: expected capacity to be a power of two, got 0\n"
+        "Ui::EventQueue: expected capacity to be a power of two, got 12\n");
+}
+
+void EventQueueTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<EventQueue>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<EventQueue>{});
+}
+
+void EventQueueTest::constructMove() {
+    /* The queue is shared between threads, so it can't move */
+    CORRADE_VERIFY(!std::is_move_constructible<EventQueue>{});
+    CORRADE_VERIFY(!std::is_move_assignable<EventQueue>{});
+}
+
+void EventQueueTest::dispatch() {
+    /* Events should get scaled by 0.5 */
+    AbstractUserInterface ui{{100.0f, 100.0f}, {200.0f, 200.0f}, {100, 100}};
+    ui.setRendererInstance(Containers::pointer<Renderer>());
+
+    NodeHandle node = ui.createNode({10.0f, 10.0f}, {50.0f, 50.0f}, NodeFlag::Focusable);
+    Layer& layer = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer()));
+    layer.create(node);
+
+    /* Focus the node for the text input to go there */
+    FocusEvent focus{0_nsec};
+    CORRADE_VERIFY(ui.focusEvent(node, focus));
+
+    EventQueue queue{16};
+    {
+        PointerMoveEvent move{1_nsec, PointerEventSource::Mouse, {}, {}, true, 0};
+        PointerEvent press{2_nsec, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        ScrollEvent scroll{3_nsec, {0.5f, -1.0f}};
+        KeyEvent keyPress{4_nsec, Key::A, {}};
+        KeyEvent keyRelease{5_nsec, Key::B, {}};
+        TextInputEvent textInput{6_nsec, "hello"};
+        PointerEvent release{7_nsec, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(queue.pointerMoveEvent({40.0f, 40.0f}, move));
+        CORRADE_VERIFY(queue.pointerPressEvent({50.0f, 40.0f}, press));
+        CORRADE_VERIFY(queue.scrollEvent({50.0f, 50.0f}, scroll));
+        CORRADE_VERIFY(queue.keyPressEvent(keyPress));
+        CORRADE_VERIFY(queue.keyReleaseEvent(keyRelease));
+        CORRADE_VERIFY(queue.textInputEvent(textInput));
+        CORRADE_VERIFY(queue.pointerReleaseEvent({60.0f, 40.0f}, release));
+    }
+    CORRADE_COMPARE(queue.size(), 7);
+
+    /* Nothing gets delivered until dispatch */
+    CORRADE_COMPARE(layer.eventCalls.size(), 0);
+
+    CORRADE_COMPARE(queue.dispatch(ui), 7);
+    CORRADE_COMPARE(queue.size(), 0);
+    CORRADE_COMPARE_AS(layer.eventCalls, Containers::arrayView<Containers::String>({
+        "move 1 10,10 coalesced 0",
+        "press 2 15,10",
+        "scroll 3 15,15 offset 0.5,-1",
+        "key press 4 a",
+        "key release 5 b",
+        "text input 6 hello",
+        "release 7 20,10"
+    }), TestSuite::Compare::Container);
+
+    /* Dispatching again does nothing */
+    CORRADE_COMPARE(queue.dispatch(ui), 0);
+    CORRADE_COMPARE(layer.eventCalls.size(), 7);
+}
+
+void EventQueueTest::dispatchEmpty() {
+    /* This doesn't even need a renderer, as nothing gets updated */
+    AbstractUserInterface ui{{100, 100}};
+
+    EventQueue queue{4};
+    CORRADE_COMPARE(queue.dispatch(ui), 0);
+}
+
+void EventQueueTest::dispatchFull() {
+    AbstractUserInterface ui{{100, 100}};
+    ui.setRendererInstance(Containers::pointer<Renderer>());
+
+    NodeHandle node = ui.createNode({}, {100.0f, 100.0f});
+    Layer& layer = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer()));
+    layer.create(node);
+
+    EventQueue queue{2};
+    PointerEvent press1{1_nsec, PointerEventSource::Touch, Pointer::Finger, true, 0};
+    PointerEvent press2{2_nsec, PointerEventSource::Touch, Pointer::Finger, false, 1};
+    PointerEvent press3{3_nsec, PointerEventSource::Touch, Pointer::Finger, false, 2};
+    CORRADE_VERIFY(queue.pointerPressEvent({10.0f, 10.0f}, press1));
+    CORRADE_VERIFY(queue.pointerPressEvent({20.0f, 20.0f}, press2));
+    /* The queue is full, the event gets dropped */
+    CORRADE_VERIFY(!queue.pointerPressEvent({30.0f, 30.0f}, press3));
+    CORRADE_COMPARE(queue.size(), 2);
+
+    CORRADE_COMPARE(queue.dispatch(ui), 2);
+    CORRADE_COMPARE(queue.size(), 0);
+    CORRADE_COMPARE_AS(layer.eventCalls, Containers::arrayView<Containers::String>({
+        "press 1 10,10",
+        "press 2 20,20"
+    }), TestSuite::Compare::Container);
+
+    /* After a dispatch the slots can be reused, and they wrap around */
+    for(Long i = 0; i != 3; ++i) {
+        PointerEvent release{Nanoseconds{4 + i*2}, PointerEventSource::Touch, Pointer::Finger, true, 0};
+        PointerEvent press{Nanoseconds{5 + i*2}, PointerEventSource::Touch, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(queue.pointerReleaseEvent({40.0f, 40.0f}, release));
+        CORRADE_VERIFY(queue.pointerPressEvent({50.0f, 50.0f}, press));
+        CORRADE_VERIFY(!queue.pointerPressEvent({60.0f, 60.0f}, press));
+        CORRADE_COMPARE(queue.dispatch(ui), 2);
+    }
+    CORRADE_COMPARE_AS(layer.eventCalls, Containers::arrayView<Containers::String>({
+        "press 1 10,10",
+        "press 2 20,20",
+        "release 4 40,40",
+        "press 5 50,50",
+        "release 6 40,40",
+        "press 7 50,50",
+        "release 8 40,40",
+        "press 9 50,50"
+    }), TestSuite::Compare::Container);
+}
+
+void EventQueueTest::dispatchTextCopied() {
+    AbstractUserInterface ui{{100, 100}};
+    ui.setRendererInstance(Containers::pointer<Renderer>());
+
+    NodeHandle node = ui.createNode({}, {100.0f, 100.0f}, NodeFlag::Focusable);
+    Layer& layer = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer()));
+    layer.create(node);
+
+    FocusEvent focus{0_nsec};
+    CORRADE_VERIFY(ui.focusEvent(node, focus));
+
+    EventQueue queue{4};
+    {
+        /* Both a small string and one that doesn't fit into the SSO buffer */
+        Containers::String text1 = "hey";
+        Containers::String text2 = "this is a rather long text that gets allocated";
+        TextInputEvent event1{1_nsec, text1};
+        TextInputEvent event2{2_nsec, text2};
+        CORRADE_VERIFY(queue.textInputEvent(event1));
+        CORRADE_VERIFY(queue.textInputEvent(event2));
+
+        /* Overwrite the originals to be sure the copy is used */
+        text1 = "!!!";
+        text2 = "nope";
+    }
+
+    CORRADE_COMPARE(queue.dispatch(ui), 2);
+    CORRADE_COMPARE_AS(layer.eventCalls, Containers::arrayView<Containers::String>({
+        "text input 1 hey",
+        "text input 2 this is a rather long text that gets allocated"
+    }), TestSuite::Compare::Container);
+}
+
+void EventQueueTest::dispatchEventsAddedDuringDispatch() {
+    AbstractUserInterface ui{{100, 100}};
+    ui.setRendererInstance(Containers::pointer<Renderer>());
+
+    EventQueue queue{4};
+
+    struct RequeueLayer: Layer {
+        explicit RequeueLayer(LayerHandle handle, EventQueue& queue): Layer{handle}, queue(queue) {}
+
+        void doPointerPressEvent(UnsignedInt dataId, PointerEvent& event) override {
+            Layer::doPointerPressEvent(dataId, event);
+            /* Adding an event from the handler doesn't make the current
+               dispatch deliver it as well */
+            PointerEvent release{event.time() + 10_nsec, event.source(), event.pointer(), event.isPrimary(), event.id()};
+            CORRADE_VERIFY(queue.pointerReleaseEvent({20.0f, 30.0f}, release));
+        }
+
+        EventQueue& queue;
+    };
+
+    NodeHandle node = ui.createNode({}, {100.0f, 100.0f});
+    RequeueLayer& layer = ui.setLayerInstance(Containers::pointer<RequeueLayer>(ui.createLayer(), queue));
+    layer.create(node);
+
+    PointerEvent press{1_nsec, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+    CORRADE_VERIFY(queue.pointerPressEvent({10.0f, 20.0f}, press));
+
+    CORRADE_COMPARE(queue.dispatch(ui), 1);
+    CORRADE_COMPARE(queue.size(), 1);
+    CORRADE_COMPARE_AS(layer.eventCalls, Containers::arrayView<Containers::String>({
+        "press 1 10,20"
+    }), TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(queue.dispatch(ui), 1);
+    CORRADE_COMPARE(queue.size(), 0);
+    CORRADE_COMPARE_AS(layer.eventCalls, Containers::arrayView<Containers::String>({
+        "press 1 10,20",
+        "release 11 20,30"
+    }), TestSuite::Compare::Container);
+}
+
+void EventQueueTest::dispatchCoalescing() {
+    AbstractUserInterface ui{{100, 100}};
+    ui.setRendererInstance(Containers::pointer<Renderer>())
+      .setPointerMoveEventCoalescing(true);
+
+    NodeHandle node = ui.createNode({}, {100.0f, 100.0f});
+    Layer& layer = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer()));
+    layer.create(node);
+
+    EventQueue queue{4};
+    PointerMoveEvent move1{1_nsec, PointerEventSource::Pen, {}, {}, true, 0};
+    PointerMoveEvent move2{2_nsec, PointerEventSource::Pen, {}, {}, true, 0};
+    PointerMoveEvent move3{3_nsec, PointerEventSource::Pen, {}, {}, true, 0};
+    CORRADE_VERIFY(queue.pointerMoveEvent({10.0f, 10.0f}, move1));
+    CORRADE_VERIFY(queue.pointerMoveEvent({20.0f, 10.0f}, move2));
+    CORRADE_VERIFY(queue.pointerMoveEvent({30.0f, 10.0f}, move3));
+
+    /* All events are passed to the UI, which coalesces them into one and
+       delivers it on the next flush */
+    CORRADE_COMPARE(queue.dispatch(ui), 3);
+    CORRADE_COMPARE(layer.eventCalls.size(), 0);
+    CORRADE_VERIFY(ui.hasPendingPointerMoveEvent());
+
+    CORRADE_VERIFY(ui.flushPointerMoveEvent());
+    CORRADE_COMPARE_AS(layer.eventCalls, Containers::arrayView<Containers::String>({
+        "move 3 30,10 coalesced 2"
+    }), TestSuite::Compare::Container);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::EventQueueTest)
@@ -51,6 +51,7 @@ struct EventTest: TestSuite::Tester {
     void pointerMoveRelativePosition();
     void pointerMoveNoPointer();
     void pointerMoveNoPointerRelativePosition();
+    void pointerMoveCoalescedInvalid();
     void pointerCancel();
 
     void scroll();
@@ -80,6 +81,7 @@ EventTest::EventTest() {
               &EventTest::pointerMoveRelativePosition,
               &EventTest::pointerMoveNoPointer,
               &EventTest::pointerMoveNoPointerRelativePosition,
+              &EventTest::pointerMoveCoalescedInvalid,
               &EventTest::pointerCancel,
 
               &EventTest::scroll,
@@ -225,6 +227,7 @@ void EventTest::pointerMove() {
     CORRADE_COMPARE(event.id(), 1ll << 37);
     CORRADE_COMPARE(event.position(), Vector2{});
     CORRADE_COMPARE(event.relativePosition(), Vector2{});
+    CORRADE_COMPARE(event.coalescedCount(), 0);
     CORRADE_COMPARE(event.nodeSize(), Vector2{});
     CORRADE_VERIFY(!event.isNodePressed());
     CORRADE_VERIFY(!event.isNodeHovered());
@@ -350,6 +353,21 @@ void EventTest::pointerMoveNoPointerRelativePosition() {
     CORRADE_VERIFY(!event.isAccepted());
 }
 
+void EventTest::pointerMoveCoalescedInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+
+    Containers::String out;
+    Error redirectError{&out};
+    event.coalescedTime(0);
+    event.coalescedPosition(0);
+    CORRADE_COMPARE_AS(out,
+        "Ui::PointerMoveEvent::coalescedTime(): index 0 out of range for 0 coalesced events\n"
+        "Ui::PointerMoveEvent::coalescedPosition(): index 0 out of range for 0 coalesced events\n",
+        TestSuite::Compare::String);
+}
+
 void EventTest::pointerCancel() {
     PointerCancelEvent event{1234567_nsec};
     CORRADE_COMPARE(event.time(), 1234567_nsec);
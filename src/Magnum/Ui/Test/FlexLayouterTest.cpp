@@ -0,0 +1,564 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/String.h>
+#include <Magnum/Math/Vector4.h>
+
+#include "Magnum/Ui/FlexLayouter.h"
+#include "Magnum/Ui/Handle.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct FlexLayouterTest: TestSuite::Tester {
+    explicit FlexLayouterTest();
+
+    void debugDirection();
+    void debugAlignment();
+    void debugLayoutFlag();
+    void debugLayoutFlags();
+
+    void construct();
+    void constructCopy();
+    void constructMove();
+
+    void setPadding();
+    void setGap();
+
+    void addRemove();
+    void addRemoveHandleRecycle();
+
+    void invalidHandle();
+
+    void updateEmpty();
+    void update();
+    void updateNested();
+    void updatePartial();
+};
+
+const struct {
+    const char* name;
+    FlexDirection direction;
+    FlexAlignment alignment;
+    FlexLayoutFlags flags;
+    Vector2 expectedSize;
+    Vector2 expectedItemOffsets[3];
+    Vector2 expectedItemSizes[3];
+} UpdateData[]{
+    /* Padding is 1, 2, 3, 4 (left, top, right, bottom), gap is 2, 3, the
+       container is 100x50 and the items 40x20, 50x10 and 30x30. The second
+       item has a (0.5, 0.25) offset, which gets added to the result. */
+    {"row", FlexDirection::Row, FlexAlignment::Start, {},
+        {100.0f, 50.0f},
+        {{1.0f, 2.0f}, {43.5f, 2.25f}, {95.0f, 2.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+    /* Line is 44 units tall */
+    {"row, centered", FlexDirection::Row, FlexAlignment::Center, {},
+        {100.0f, 50.0f},
+        {{1.0f, 14.0f}, {43.5f, 19.25f}, {95.0f, 9.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+    {"row, aligned to end", FlexDirection::Row, FlexAlignment::End, {},
+        {100.0f, 50.0f},
+        {{1.0f, 26.0f}, {43.5f, 36.25f}, {95.0f, 16.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+    {"row, stretched", FlexDirection::Row, FlexAlignment::Stretch, {},
+        {100.0f, 50.0f},
+        {{1.0f, 2.0f}, {43.5f, 2.25f}, {95.0f, 2.0f}},
+        {{40.0f, 44.0f}, {50.0f, 44.0f}, {30.0f, 44.0f}}},
+    {"column", FlexDirection::Column, FlexAlignment::Start, {},
+        {100.0f, 50.0f},
+        {{1.0f, 2.0f}, {1.5f, 25.25f}, {1.0f, 38.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+    /* Column is 96 units wide */
+    {"column, centered", FlexDirection::Column, FlexAlignment::Center, {},
+        {100.0f, 50.0f},
+        {{29.0f, 2.0f}, {24.5f, 25.25f}, {34.0f, 38.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+    /* The lines are 20 and 30 units tall, separated by a 3-unit gap */
+    {"row, wrapped", FlexDirection::Row, FlexAlignment::Start, FlexLayoutFlag::Wrap,
+        {100.0f, 50.0f},
+        {{1.0f, 2.0f}, {43.5f, 2.25f}, {1.0f, 25.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+    {"row, wrapped, centered", FlexDirection::Row, FlexAlignment::Center, FlexLayoutFlag::Wrap,
+        {100.0f, 50.0f},
+        {{1.0f, 2.0f}, {43.5f, 7.25f}, {1.0f, 25.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+    {"row, wrapped, stretched", FlexDirection::Row, FlexAlignment::Stretch, FlexLayoutFlag::Wrap,
+        {100.0f, 50.0f},
+        {{1.0f, 2.0f}, {43.5f, 2.25f}, {1.0f, 25.0f}},
+        {{40.0f, 20.0f}, {50.0f, 20.0f}, {30.0f, 30.0f}}},
+    /* 1 + 40 + 2 + 50 + 2 + 30 + 3, 2 + 30 + 4 */
+    {"row, fit content", FlexDirection::Row, FlexAlignment::Start, FlexLayoutFlag::FitContent,
+        {128.0f, 36.0f},
+        {{1.0f, 2.0f}, {43.5f, 2.25f}, {95.0f, 2.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+    /* Line is 30 units tall now */
+    {"row, fit content, stretched", FlexDirection::Row, FlexAlignment::Stretch, FlexLayoutFlag::FitContent,
+        {128.0f, 36.0f},
+        {{1.0f, 2.0f}, {43.5f, 2.25f}, {95.0f, 2.0f}},
+        {{40.0f, 30.0f}, {50.0f, 30.0f}, {30.0f, 30.0f}}},
+    /* 1 + 50 + 3, 2 + 20 + 3 + 10 + 3 + 30 + 4 */
+    {"column, fit content", FlexDirection::Column, FlexAlignment::Start, FlexLayoutFlag::FitContent,
+        {54.0f, 72.0f},
+        {{1.0f, 2.0f}, {1.5f, 25.25f}, {1.0f, 38.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+    /* Width stays, 2 + 20 + 3 + 30 + 4 */
+    {"row, wrapped, fit content", FlexDirection::Row, FlexAlignment::Start, FlexLayoutFlag::Wrap|FlexLayoutFlag::FitContent,
+        {100.0f, 59.0f},
+        {{1.0f, 2.0f}, {43.5f, 2.25f}, {1.0f, 25.0f}},
+        {{40.0f, 20.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}}},
+};
+
+FlexLayouterTest::FlexLayouterTest() {
+    addTests({&FlexLayouterTest::debugDirection,
+              &FlexLayouterTest::debugAlignment,
+              &FlexLayouterTest::debugLayoutFlag,
+              &FlexLayouterTest::debugLayoutFlags,
+
+              &FlexLayouterTest::construct,
+              &FlexLayouterTest::constructCopy,
+              &FlexLayouterTest::constructMove,
+
+              &FlexLayouterTest::setPadding,
+              &FlexLayouterTest::setGap,
+
+              &FlexLayouterTest::addRemove,
+              &FlexLayouterTest::addRemoveHandleRecycle,
+
+              &FlexLayouterTest::invalidHandle,
+
+              &FlexLayouterTest::updateEmpty});
+
+    addInstancedTests({&FlexLayouterTest::update},
+        Containers::arraySize(UpdateData));
+
+    addTests({&FlexLayouterTest::updateNested,
+              &FlexLayouterTest::updatePartial});
+}
+
+void FlexLayouterTest::debugDirection() {
+    Containers::String out;
+    Debug{&out} << FlexDirection::Column << FlexDirection(0xbe);
+    CORRADE_COMPARE(out, "Ui::FlexDirection::Column Ui::FlexDirection(0xbe)\n");
+}
+
+void FlexLayouterTest::debugAlignment() {
+    Containers::String out;
+    Debug{&out} << FlexAlignment::Stretch << FlexAlignment(0xbe);
+    CORRADE_COMPARE(out, "Ui::FlexAlignment::Stretch Ui::FlexAlignment(0xbe)\n");
+}
+
+void FlexLayouterTest::debugLayoutFlag() {
+    Containers::String out;
+    Debug{&out} << FlexLayoutFlag::FitContent << FlexLayoutFlag(0xbe);
+    CORRADE_COMPARE(out, "Ui::FlexLayoutFlag::FitContent Ui::FlexLayoutFlag(0xbe)\n");
+}
+
+void FlexLayouterTest::debugLayoutFlags() {
+    Containers::String out;
+    Debug{&out} << (FlexLayoutFlag::Wrap|FlexLayoutFlag(0xe0)) << FlexLayoutFlags{};
+    CORRADE_COMPARE(out, "Ui::FlexLayoutFlag::Wrap|Ui::FlexLayoutFlag(0xe0) Ui::FlexLayoutFlags{}\n");
+}
+
+void FlexLayouterTest::construct() {
+    FlexLayouter layouter{layouterHandle(0xab, 0x12)};
+    CORRADE_COMPARE(layouter.handle(), layouterHandle(0xab, 0x12));
+    CORRADE_COMPARE(layouter.padding(), Vector4{});
+    CORRADE_COMPARE(layouter.gap(), Vector2{});
+}
+
+void FlexLayouterTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<FlexLayouter>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<FlexLayouter>{});
+}
+
+void FlexLayouterTest::constructMove() {
+    FlexLayouter a{layouterHandle(0xab, 0x12)};
+    a.setPadding(1.0f);
+    a.setGap(3.0f);
+
+    FlexLayouter b{Utility::move(a)};
+    CORRADE_COMPARE(b.handle(), layouterHandle(0xab, 0x12));
+    CORRADE_COMPARE(b.padding(), Vector4{1.0f});
+    CORRADE_COMPARE(b.gap(), Vector2{3.0f});
+
+    FlexLayouter c{layouterHandle(3, 5)};
+    c = Utility::move(b);
+    CORRADE_COMPARE(c.handle(), layouterHandle(0xab, 0x12));
+    CORRADE_COMPARE(c.padding(), Vector4{1.0f});
+    CORRADE_COMPARE(c.gap(), Vector2{3.0f});
+
+    CORRADE_VERIFY(std::is_nothrow_move_constructible<FlexLayouter>::value);
+    CORRADE_VERIFY(std::is_nothrow_move_assignable<FlexLayouter>::value);
+}
+
+void FlexLayouterTest::setPadding() {
+    FlexLayouter layouter{layouterHandle(0, 1)};
+    CORRADE_COMPARE(layouter.padding(), Vector4{});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layouter.setSize({1, 1});
+
+    /* Each side separately */
+    layouter.setPadding({1.0f, 3.0f, 2.0f, 4.0f});
+    CORRADE_COMPARE(layouter.padding(), (Vector4{1.0f, 3.0f, 2.0f, 4.0f}));
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+
+    /* Clear the state flags */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Horizontal and vertical */
+    layouter.setPadding({1.0f, 3.0f});
+    CORRADE_COMPARE(layouter.padding(), (Vector4{1.0f, 3.0f, 1.0f, 3.0f}));
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+
+    /* Clear the state flags */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* All sides the same */
+    layouter.setPadding(1.0f);
+    CORRADE_COMPARE(layouter.padding(), (Vector4{1.0f}));
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+}
+
+void FlexLayouterTest::setGap() {
+    FlexLayouter layouter{layouterHandle(0, 1)};
+    CORRADE_COMPARE(layouter.gap(), Vector2{});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layouter.setSize({1, 1});
+
+    /* Horizontal and vertical separately */
+    layouter.setGap({2.0f, 4.0f});
+    CORRADE_COMPARE(layouter.gap(), (Vector2{2.0f, 4.0f}));
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+
+    /* Clear the state flags */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Both directions the same */
+    layouter.setGap(2.0f);
+    CORRADE_COMPARE(layouter.gap(), (Vector2{2.0f}));
+}
+
+void FlexLayouterTest::addRemove() {
+    FlexLayouter layouter{layouterHandle(0, 1)};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layouter.setSize({1, 1});
+
+    LayoutHandle first = layouter.add(nodeHandle(3, 1));
+    CORRADE_COMPARE(layouter.node(first), nodeHandle(3, 1));
+    CORRADE_COMPARE(layouter.direction(first), FlexDirection::Row);
+    CORRADE_COMPARE(layouter.alignment(first), FlexAlignment::Start);
+    CORRADE_COMPARE(layouter.flags(first), FlexLayoutFlags{});
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsAssignmentUpdate);
+
+    LayoutHandle second = layouter.add(nodeHandle(5, 2), FlexDirection::Column, FlexAlignment::Center, FlexLayoutFlag::Wrap);
+    CORRADE_COMPARE(layouter.node(second), nodeHandle(5, 2));
+    CORRADE_COMPARE(layouter.direction(second), FlexDirection::Column);
+    CORRADE_COMPARE(layouter.alignment(layoutHandleData(second)), FlexAlignment::Center);
+    CORRADE_COMPARE(layouter.flags(layoutHandleData(second)), FlexLayoutFlag::Wrap);
+
+    /* Clear the state flags */
+    layouter.update(Containers::BitArray{ValueInit, layouter.capacity()}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    layouter.setDirection(first, FlexDirection::Column);
+    CORRADE_COMPARE(layouter.direction(first), FlexDirection::Column);
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+
+    layouter.setDirection(layoutHandleData(first), FlexDirection::Row);
+    CORRADE_COMPARE(layouter.direction(layoutHandleData(first)), FlexDirection::Row);
+
+    layouter.setAlignment(first, FlexAlignment::Stretch);
+    CORRADE_COMPARE(layouter.alignment(first), FlexAlignment::Stretch);
+
+    layouter.setAlignment(layoutHandleData(first), FlexAlignment::End);
+    CORRADE_COMPARE(layouter.alignment(first), FlexAlignment::End);
+
+    layouter.setFlags(first, FlexLayoutFlag::FitContent);
+    CORRADE_COMPARE(layouter.flags(first), FlexLayoutFlag::FitContent);
+
+    layouter.setFlags(layoutHandleData(first), FlexLayoutFlag::Wrap|FlexLayoutFlag::FitContent);
+    CORRADE_COMPARE(layouter.flags(first), FlexLayoutFlag::Wrap|FlexLayoutFlag::FitContent);
+
+    /* Clear the state flags */
+    layouter.update(Containers::BitArray{ValueInit, layouter.capacity()}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    layouter.remove(first);
+    CORRADE_VERIFY(!layouter.isHandleValid(first));
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsAssignmentUpdate);
+
+    layouter.remove(layoutHandleData(second));
+    CORRADE_VERIFY(!layouter.isHandleValid(second));
+}
+
+void FlexLayouterTest::addRemoveHandleRecycle() {
+    FlexLayouter layouter{layouterHandle(0, 1)};
+
+    /*LayoutHandle first =*/ layouter.add(nodeHandle(0, 1));
+    LayoutHandle second = layouter.add(nodeHandle(1, 1), FlexDirection::Column, FlexAlignment::Stretch, FlexLayoutFlag::FitContent);
+
+    /* Layout that reuses a previous slot should have the properties reset to
+       the defaults */
+    layouter.remove(second);
+    LayoutHandle second2 = layouter.add(nodeHandle(1, 2));
+    CORRADE_COMPARE(layoutHandleId(second2), layoutHandleId(second));
+    CORRADE_COMPARE(layouter.direction(second2), FlexDirection::Row);
+    CORRADE_COMPARE(layouter.alignment(second2), FlexAlignment::Start);
+    CORRADE_COMPARE(layouter.flags(second2), FlexLayoutFlags{});
+}
+
+void FlexLayouterTest::invalidHandle() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    FlexLayouter layouter{layouterHandle(0, 1)};
+
+    Containers::String out;
+    Error redirectError{&out};
+    layouter.direction(LayoutHandle::Null);
+    layouter.direction(LayouterDataHandle::Null);
+    layouter.setDirection(LayoutHandle::Null, {});
+    layouter.setDirection(LayouterDataHandle::Null, {});
+    layouter.alignment(LayoutHandle::Null);
+    layouter.alignment(LayouterDataHandle::Null);
+    layouter.setAlignment(LayoutHandle::Null, {});
+    layouter.setAlignment(LayouterDataHandle::Null, {});
+    layouter.flags(LayoutHandle::Null);
+    layouter.flags(LayouterDataHandle::Null);
+    layouter.setFlags(LayoutHandle::Null, {});
+    layouter.setFlags(LayouterDataHandle::Null, {});
+    CORRADE_COMPARE_AS(out,
+        "Ui::FlexLayouter::direction(): invalid handle Ui::LayoutHandle::Null\n"
+        "Ui::FlexLayouter::direction(): invalid handle Ui::LayouterDataHandle::Null\n"
+        "Ui::FlexLayouter::setDirection(): invalid handle Ui::LayoutHandle::Null\n"
+        "Ui::FlexLayouter::setDirection(): invalid handle Ui::LayouterDataHandle::Null\n"
+        "Ui::FlexLayouter::alignment(): invalid handle Ui::LayoutHandle::Null\n"
+        "Ui::FlexLayouter::alignment(): invalid handle Ui::LayouterDataHandle::Null\n"
+        "Ui::FlexLayouter::setAlignment(): invalid handle Ui::LayoutHandle::Null\n"
+        "Ui::FlexLayouter::setAlignment(): invalid handle Ui::LayouterDataHandle::Null\n"
+        "Ui::FlexLayouter::flags(): invalid handle Ui::LayoutHandle::Null\n"
+        "Ui::FlexLayouter::flags(): invalid handle Ui::LayouterDataHandle::Null\n"
+        "Ui::FlexLayouter::setFlags(): invalid handle Ui::LayoutHandle::Null\n"
+        "Ui::FlexLayouter::setFlags(): invalid handle Ui::LayouterDataHandle::Null\n",
+        TestSuite::Compare::String);
+}
+
+void FlexLayouterTest::updateEmpty() {
+    FlexLayouter layouter{layouterHandle(0, 1)};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layouter.setSize({1, 1});
+
+    /* It shouldn't crash or do anything weird */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_VERIFY(true);
+}
+
+void FlexLayouterTest::update() {
+    auto&& data = UpdateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FlexLayouter layouter{layouterHandle(0, 1)};
+    layouter.setSize({1, 1});
+    layouter.setPadding({1.0f, 2.0f, 3.0f, 4.0f})
+            .setGap({2.0f, 3.0f});
+
+    /* The container is node 3 to verify the items are positioned after it
+       even though they have lower IDs */
+    layouter.add(nodeHandle(3, 1), data.direction, data.alignment, data.flags);
+    layouter.add(nodeHandle(0, 1));
+    layouter.add(nodeHandle(1, 1));
+    layouter.add(nodeHandle(2, 1));
+
+    const NodeHandle nodeParents[]{
+        nodeHandle(3, 1),
+        nodeHandle(3, 1),
+        nodeHandle(3, 1),
+        NodeHandle::Null
+    };
+    Vector2 nodeOffsets[]{
+        {},
+        {0.5f, 0.25f},
+        {},
+        /* A root node, stays untouched */
+        {7.0f, 8.0f}
+    };
+    Vector2 nodeSizes[]{
+        {40.0f, 20.0f},
+        {50.0f, 10.0f},
+        {30.0f, 30.0f},
+        {100.0f, 50.0f}
+    };
+    layouter.update(Containers::BitArray{DirectInit, layouter.capacity(), true}, {}, nodeParents, nodeOffsets, nodeSizes);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets), Containers::arrayView<Vector2>({
+        data.expectedItemOffsets[0],
+        data.expectedItemOffsets[1],
+        data.expectedItemOffsets[2],
+        {7.0f, 8.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes), Containers::arrayView<Vector2>({
+        data.expectedItemSizes[0],
+        data.expectedItemSizes[1],
+        data.expectedItemSizes[2],
+        data.expectedSize
+    }), TestSuite::Compare::Container);
+}
+
+void FlexLayouterTest::updateNested() {
+    FlexLayouter layouter{layouterHandle(0, 1)};
+    layouter.setSize({1, 1});
+    layouter.setPadding(1.0f)
+            .setGap(2.0f);
+
+    /* Node 0 is a column fitting its content, containing node 1 which is a
+       row fitting its content, with nodes 3 and 4 inside, and node 2. The
+       layouts are added with the leafs first to verify the order doesn't
+       matter for the calculation, and with node 4 before node 3 to verify
+       that the items are placed in the order they were added, not in the
+       node ID order. */
+    layouter.add(nodeHandle(4, 1));
+    layouter.add(nodeHandle(3, 1));
+    layouter.add(nodeHandle(1, 1), FlexDirection::Row, FlexAlignment::Start, FlexLayoutFlag::FitContent);
+    layouter.add(nodeHandle(0, 1), FlexDirection::Column, FlexAlignment::Start, FlexLayoutFlag::FitContent);
+    layouter.add(nodeHandle(2, 1));
+
+    const NodeHandle nodeParents[]{
+        NodeHandle::Null,
+        nodeHandle(0, 1),
+        nodeHandle(0, 1),
+        nodeHandle(1, 1),
+        nodeHandle(1, 1),
+    };
+    Vector2 nodeOffsets[5]{};
+    Vector2 nodeSizes[]{
+        {},
+        {},
+        {15.0f, 15.0f},
+        {10.0f, 10.0f},
+        {20.0f, 5.0f},
+    };
+    layouter.update(Containers::BitArray{DirectInit, layouter.capacity(), true}, {}, nodeParents, nodeOffsets, nodeSizes);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets), Containers::arrayView<Vector2>({
+        {},
+        {1.0f, 1.0f},
+        /* 1 + 12 + 2 */
+        {1.0f, 15.0f},
+        /* 1 + 20 + 2 */
+        {23.0f, 1.0f},
+        {1.0f, 1.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes), Containers::arrayView<Vector2>({
+        /* 1 + 34 + 1, 1 + 12 + 2 + 15 + 1 */
+        {36.0f, 31.0f},
+        /* 1 + 20 + 2 + 10 + 1, 1 + 10 + 1 */
+        {34.0f, 12.0f},
+        {15.0f, 15.0f},
+        {10.0f, 10.0f},
+        {20.0f, 5.0f},
+    }), TestSuite::Compare::Container);
+}
+
+void FlexLayouterTest::updatePartial() {
+    FlexLayouter layouter{layouterHandle(0, 1)};
+    layouter.setSize({1, 1});
+    layouter.setGap(2.0f);
+
+    LayoutHandle container = layouter.add(nodeHandle(0, 1));
+    layouter.add(nodeHandle(1, 1));
+    LayoutHandle hidden = layouter.add(nodeHandle(2, 1));
+    layouter.add(nodeHandle(3, 1));
+
+    const NodeHandle nodeParents[]{
+        NodeHandle::Null,
+        nodeHandle(0, 1),
+        nodeHandle(0, 1),
+        nodeHandle(0, 1),
+    };
+    Vector2 nodeOffsets[]{
+        {},
+        {},
+        {0.5f, 0.75f},
+        {},
+    };
+    Vector2 nodeSizes[]{
+        {100.0f, 10.0f},
+        {10.0f, 10.0f},
+        {20.0f, 10.0f},
+        {30.0f, 10.0f},
+    };
+
+    /* Layouts not in the mask, such as ones on nodes that are not visible,
+       are left untouched and don't take any space in the container */
+    Containers::BitArray mask{DirectInit, layouter.capacity(), true};
+    mask.reset(layoutHandleId(hidden));
+    layouter.update(mask, {}, nodeParents, nodeOffsets, nodeSizes);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets), Containers::arrayView<Vector2>({
+        {},
+        {0.0f, 0.0f},
+        {0.5f, 0.75f},
+        {12.0f, 0.0f},
+    }), TestSuite::Compare::Container);
+
+    /* If the container itself isn't in the mask, the items are left at their
+       original offsets */
+    Vector2 nodeOffsets2[]{
+        {},
+        {},
+        {0.5f, 0.75f},
+        {},
+    };
+    mask.set(layoutHandleId(hidden));
+    mask.reset(layoutHandleId(container));
+    layouter.update(mask, {}, nodeParents, nodeOffsets2, nodeSizes);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets2), Containers::arrayView<Vector2>({
+        {},
+        {},
+        {0.5f, 0.75f},
+        {},
+    }), TestSuite::Compare::Container);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::FlexLayouterTest)
@@ -29,6 +29,7 @@
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/String.h>
 
 #include "Magnum/Animation/Easing.h"
@@ -51,6 +52,10 @@ struct GenericAnimatorTest: TestSuite::Tester {
     void constructMove();
     void constructMoveNode();
     void constructMoveData();
+    void constructBatch();
+    void constructBatchInvalid();
+    void constructCopyBatch();
+    void constructMoveBatch();
 
     void createRemove();
     void createRemoveNode();
@@ -66,6 +71,8 @@ struct GenericAnimatorTest: TestSuite::Tester {
     void propertiesInvalid();
     void propertiesInvalidNode();
     void propertiesInvalidData();
+    void createRemoveBatch();
+    void propertiesInvalidBatch();
 
     void clean();
     void cleanNode();
@@ -77,6 +84,8 @@ struct GenericAnimatorTest: TestSuite::Tester {
     void advanceEmpty();
     void advanceEmptyNode();
     void advanceEmptyData();
+    void advanceBatch();
+    void advanceEmptyBatch();
 };
 
 using namespace Math::Literals;
@@ -91,6 +100,10 @@ GenericAnimatorTest::GenericAnimatorTest() {
               &GenericAnimatorTest::constructMove,
               &GenericAnimatorTest::constructMoveNode,
               &GenericAnimatorTest::constructMoveData,
+              &GenericAnimatorTest::constructBatch,
+              &GenericAnimatorTest::constructBatchInvalid,
+              &GenericAnimatorTest::constructCopyBatch,
+              &GenericAnimatorTest::constructMoveBatch,
 
               &GenericAnimatorTest::createRemove,
               &GenericAnimatorTest::createRemoveNode,
@@ -104,6 +117,8 @@ GenericAnimatorTest::GenericAnimatorTest() {
               &GenericAnimatorTest::propertiesInvalid,
               &GenericAnimatorTest::propertiesInvalidNode,
               &GenericAnimatorTest::propertiesInvalidData,
+              &GenericAnimatorTest::createRemoveBatch,
+              &GenericAnimatorTest::propertiesInvalidBatch,
 
               &GenericAnimatorTest::clean,
               &GenericAnimatorTest::cleanNode,
@@ -114,7 +129,9 @@ GenericAnimatorTest::GenericAnimatorTest() {
               &GenericAnimatorTest::advanceData,
               &GenericAnimatorTest::advanceEmpty,
               &GenericAnimatorTest::advanceEmptyNode,
-              &GenericAnimatorTest::advanceEmptyData});
+              &GenericAnimatorTest::advanceEmptyData,
+              &GenericAnimatorTest::advanceBatch,
+              &GenericAnimatorTest::advanceEmptyBatch});
 }
 
 void GenericAnimatorTest::construct() {
@@ -216,6 +233,45 @@ void GenericAnimatorTest::constructMoveData() {
     CORRADE_VERIFY(std::is_nothrow_move_assignable<GenericDataAnimator>::value);
 }
 
+void GenericAnimatorTest::constructBatch() {
+    GenericBatchAnimator animator{animatorHandle(0xab, 0x12), [](Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&, const Containers::StridedArrayView1D<const UnsignedInt>&) {}};
+
+    CORRADE_COMPARE(animator.features(), AnimatorFeatures{});
+    CORRADE_COMPARE(animator.handle(), animatorHandle(0xab, 0x12));
+    CORRADE_COMPARE(animator.payloads().size(), 0);
+    /* The rest is the same as in AbstractAnimatorTest::constructGeneric() */
+}
+
+void GenericAnimatorTest::constructBatchInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::String out;
+    Error redirectError{&out};
+    GenericBatchAnimator{animatorHandle(0xab, 0x12), nullptr};
+    CORRADE_COMPARE(out, "Ui::GenericBatchAnimator: animation is null\n");
+}
+
+void GenericAnimatorTest::constructCopyBatch() {
+    CORRADE_VERIFY(!std::is_copy_constructible<GenericBatchAnimator>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<GenericBatchAnimator>{});
+}
+
+void GenericAnimatorTest::constructMoveBatch() {
+    /* Just verify that the subclass doesn't have the moves broken */
+
+    GenericBatchAnimator a{animatorHandle(0xab, 0x12), [](Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&, const Containers::StridedArrayView1D<const UnsignedInt>&) {}};
+
+    GenericBatchAnimator b{Utility::move(a)};
+    CORRADE_COMPARE(b.handle(), animatorHandle(0xab, 0x12));
+
+    GenericBatchAnimator c{animatorHandle(0xcd, 0x34), [](Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&, const Containers::StridedArrayView1D<const UnsignedInt>&) {}};
+    c = Utility::move(b);
+    CORRADE_COMPARE(c.handle(), animatorHandle(0xab, 0x12));
+
+    CORRADE_VERIFY(std::is_nothrow_move_constructible<GenericBatchAnimator>::value);
+    CORRADE_VERIFY(std::is_nothrow_move_assignable<GenericBatchAnimator>::value);
+}
+
 void GenericAnimatorTest::createRemove() {
     Int destructedCount = 0;
     struct NonTrivial {
@@ -626,6 +682,54 @@ void GenericAnimatorTest::propertiesInvalidData() {
         TestSuite::Compare::String);
 }
 
+void GenericAnimatorTest::createRemoveBatch() {
+    GenericBatchAnimator animator{animatorHandle(0, 1), [](Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&, const Containers::StridedArrayView1D<const UnsignedInt>&) {}};
+
+    AnimationHandle first = animator.create(137_nsec, 277_nsec, 0xcafe, 3, AnimationFlag::KeepOncePlayed);
+    CORRADE_COMPARE(animator.duration(first), 277_nsec);
+    CORRADE_COMPARE(animator.repeatCount(first), 3);
+    CORRADE_COMPARE(animator.flags(first), AnimationFlag::KeepOncePlayed);
+    CORRADE_COMPARE(animator.played(first), 137_nsec);
+    CORRADE_COMPARE(animator.payload(first), 0xcafe);
+
+    AnimationHandle second = animator.create(226_nsec, 191_nsec, 0xbeef);
+    CORRADE_COMPARE(animator.payload(animationHandleData(second)), 0xbeef);
+    CORRADE_COMPARE_AS(animator.payloads(), Containers::arrayView<UnsignedInt>({
+        0xcafe, 0xbeef
+    }), TestSuite::Compare::Container);
+
+    /* Removing and recreating reuses the slot, updating the payload */
+    animator.remove(first);
+    AnimationHandle third = animator.create(0_nsec, 1_nsec, 0xf00d);
+    CORRADE_COMPARE(animationHandleId(third), animationHandleId(first));
+    CORRADE_COMPARE(animator.payload(third), 0xf00d);
+    CORRADE_COMPARE(animator.payloads().size(), 2);
+}
+
+void GenericAnimatorTest::propertiesInvalidBatch() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    GenericBatchAnimator animator{animatorHandle(0, 1), [](Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&, const Containers::StridedArrayView1D<const UnsignedInt>&) {}};
+
+    AnimationHandle handle = animator.create(12_nsec, 13_nsec, 0);
+
+    Containers::String out;
+    Error redirectError{&out};
+    animator.payload(AnimationHandle::Null);
+    /* Valid animator, invalid data */
+    animator.payload(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    /* Invalid animator, valid data */
+    animator.payload(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
+    /* AnimatorDataHandle directly */
+    animator.payload(AnimatorDataHandle(0x123abcde));
+    CORRADE_COMPARE_AS(out,
+        "Ui::GenericBatchAnimator::payload(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::GenericBatchAnimator::payload(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
+        "Ui::GenericBatchAnimator::payload(): invalid handle Ui::AnimationHandle(Null, {0x0, 0x1})\n"
+        "Ui::GenericBatchAnimator::payload(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n",
+        TestSuite::Compare::String);
+}
+
 void GenericAnimatorTest::clean() {
     Int destructedCount = 0,
         anotherDestructedCount = 0;
@@ -908,6 +1012,46 @@ void GenericAnimatorTest::advanceEmptyData() {
     CORRADE_VERIFY(true);
 }
 
+void GenericAnimatorTest::advanceBatch() {
+    Int called = 0;
+    Float sums[3]{};
+    GenericBatchAnimator animator{animatorHandle(0, 1), [&](Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::StridedArrayView1D<const UnsignedInt>& payloads) {
+        ++called;
+        CORRADE_COMPARE(active.size(), 3);
+        CORRADE_COMPARE(factors.size(), 3);
+        CORRADE_COMPARE(payloads.size(), 3);
+        for(std::size_t i = 0; i != active.size(); ++i)
+            if(active[i]) sums[payloads[i]] += factors[i];
+    }};
+
+    animator.create(0_nsec, 10_nsec, 2);
+    animator.create(5_nsec, 15_nsec, 1);
+    animator.create(10_nsec, 5_nsec, 0);
+
+    /* Should be called just once, affecting the first and third with given
+       factors */
+    UnsignedByte data[]{(1 << 0)|(1 << 2)};
+    Float factors[]{0.75f, 0.42f, 0.25f};
+    animator.advance(Containers::BitArrayView{data, 0, 3}, factors);
+    CORRADE_COMPARE(called, 1);
+    CORRADE_COMPARE(sums[0], 0.25f);
+    CORRADE_COMPARE(sums[1], 0.0f);
+    CORRADE_COMPARE(sums[2], 0.75f);
+}
+
+void GenericAnimatorTest::advanceEmptyBatch() {
+    Int called = 0;
+    GenericBatchAnimator animator{animatorHandle(0, 1), [&](Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>&, const Containers::StridedArrayView1D<const UnsignedInt>& payloads) {
+        ++called;
+        CORRADE_COMPARE(active.size(), 0);
+        CORRADE_COMPARE(payloads.size(), 0);
+    }};
+    animator.advance({}, {});
+
+    /* The function gets called even with nothing to process */
+    CORRADE_COMPARE(called, 1);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::GenericAnimatorTest)
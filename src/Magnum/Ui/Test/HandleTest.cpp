@@ -258,6 +258,9 @@ void HandleTest::debugData() {
 }
 
 void HandleTest::node() {
+    if(Implementation::NodeHandleGenerationBits != 12)
+        CORRADE_SKIP("Tested only with the default node handle bits.");
+
     CORRADE_COMPARE(NodeHandle::Null, NodeHandle{});
     CORRADE_COMPARE(nodeHandle(0, 0), NodeHandle::Null);
     CORRADE_COMPARE(nodeHandle(0xabcde, 0x123), NodeHandle(0x123abcde));
@@ -275,6 +278,9 @@ void HandleTest::node() {
 }
 
 void HandleTest::nodeInvalid() {
+    if(Implementation::NodeHandleGenerationBits != 12)
+        CORRADE_SKIP("Tested only with the default node handle bits.");
+
     CORRADE_SKIP_IF_NO_DEBUG_ASSERT();
 
     Containers::String out;
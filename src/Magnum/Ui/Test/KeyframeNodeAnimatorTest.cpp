@@ -0,0 +1,493 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/String.h>
+
+#include "Magnum/Animation/Easing.h"
+#include "Magnum/Math/Time.h"
+#include "Magnum/Math/Vector2.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/KeyframeNodeAnimator.h"
+#include "Magnum/Ui/NodeFlags.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct KeyframeNodeAnimatorTest: TestSuite::Tester {
+    explicit KeyframeNodeAnimatorTest();
+
+    void construct();
+    void constructCopy();
+    void constructMove();
+
+    void createRemove();
+    void createRemoveHandleRecycle();
+    void createCompact();
+    void createInvalid();
+    void propertiesInvalid();
+
+    void clean();
+
+    void advance();
+    void advanceEmpty();
+};
+
+using namespace Math::Literals;
+
+KeyframeNodeAnimatorTest::KeyframeNodeAnimatorTest() {
+    addTests({&KeyframeNodeAnimatorTest::construct,
+              &KeyframeNodeAnimatorTest::constructCopy,
+              &KeyframeNodeAnimatorTest::constructMove,
+
+              &KeyframeNodeAnimatorTest::createRemove,
+              &KeyframeNodeAnimatorTest::createRemoveHandleRecycle,
+              &KeyframeNodeAnimatorTest::createCompact,
+              &KeyframeNodeAnimatorTest::createInvalid,
+              &KeyframeNodeAnimatorTest::propertiesInvalid,
+
+              &KeyframeNodeAnimatorTest::clean,
+
+              &KeyframeNodeAnimatorTest::advance,
+              &KeyframeNodeAnimatorTest::advanceEmpty});
+}
+
+void KeyframeNodeAnimatorTest::construct() {
+    KeyframeNodeAnimator animator{animatorHandle(0xab, 0x12)};
+
+    CORRADE_COMPARE(animator.features(), AnimatorFeature::NodeAttachment);
+    CORRADE_COMPARE(animator.handle(), animatorHandle(0xab, 0x12));
+    CORRADE_COMPARE(animator.keyframeCapacity(), 0);
+    /* The rest is the same as in AbstractAnimatorTest::constructNode() */
+}
+
+void KeyframeNodeAnimatorTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<KeyframeNodeAnimator>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<KeyframeNodeAnimator>{});
+}
+
+void KeyframeNodeAnimatorTest::constructMove() {
+    /* Just verify that the subclass doesn't have the moves broken */
+
+    KeyframeNodeAnimator a{animatorHandle(0xab, 0x12)};
+
+    KeyframeNodeAnimator b{Utility::move(a)};
+    CORRADE_COMPARE(b.handle(), animatorHandle(0xab, 0x12));
+
+    KeyframeNodeAnimator c{animatorHandle(0xcd, 0x34)};
+    c = Utility::move(b);
+    CORRADE_COMPARE(c.handle(), animatorHandle(0xab, 0x12));
+
+    CORRADE_VERIFY(std::is_nothrow_move_constructible<KeyframeNodeAnimator>::value);
+    CORRADE_VERIFY(std::is_nothrow_move_assignable<KeyframeNodeAnimator>::value);
+}
+
+void KeyframeNodeAnimatorTest::createRemove() {
+    KeyframeNodeAnimator animator{animatorHandle(0, 1)};
+
+    Float(*const easings[])(Float){
+        Animation::Easing::bounceOut,
+        Animation::Easing::smootherstep
+    };
+    AnimationHandle first = animator.create(
+        Containers::arrayView({0.0f, 0.25f, 1.0f}),
+        Containers::arrayView<Vector2>({{1.0f, 2.0f}, {3.0f, 4.0f}, {5.0f, 6.0f}}),
+        nullptr,
+        easings,
+        137_nsec, 277_nsec, nodeHandle(0x12345, 0xabc), 3, AnimationFlag::KeepOncePlayed);
+    CORRADE_COMPARE(animator.usedCount(), 1);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 3);
+    CORRADE_COMPARE(animator.played(first), 137_nsec);
+    CORRADE_COMPARE(animator.duration(first), 277_nsec);
+    CORRADE_COMPARE(animator.repeatCount(first), 3);
+    CORRADE_COMPARE(animator.flags(first), AnimationFlag::KeepOncePlayed);
+    CORRADE_COMPARE(animator.node(first), nodeHandle(0x12345, 0xabc));
+    CORRADE_COMPARE_AS(animator.times(first), Containers::arrayView({
+        0.0f, 0.25f, 1.0f
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(animator.offsets(first), Containers::arrayView<Vector2>({
+        {1.0f, 2.0f}, {3.0f, 4.0f}, {5.0f, 6.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(animator.sizes(first).size(), 0);
+    CORRADE_COMPARE(animator.easings(first).size(), 2);
+    CORRADE_COMPARE(animator.easings(first)[0], Animation::Easing::bounceOut);
+    CORRADE_COMPARE(animator.easings(first)[1], Animation::Easing::smootherstep);
+
+    /* Single easing for all, testing also the other handle overloads */
+    AnimationHandle second = animator.create(
+        Containers::arrayView({0.5f, 1.0f}),
+        nullptr,
+        Containers::arrayView<Vector2>({{7.0f, 8.0f}, {9.0f, 10.0f}}),
+        Animation::Easing::cubicIn,
+        226_nsec, 191_nsec, NodeHandle::Null, 0, AnimationFlags{0x80});
+    CORRADE_COMPARE(animator.usedCount(), 2);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 5);
+    CORRADE_COMPARE(animator.played(second), 226_nsec);
+    CORRADE_COMPARE(animator.duration(second), 191_nsec);
+    CORRADE_COMPARE(animator.repeatCount(second), 0);
+    CORRADE_COMPARE(animator.flags(second), AnimationFlags{0x80});
+    CORRADE_COMPARE(animator.node(second), NodeHandle::Null);
+    CORRADE_COMPARE_AS(animator.times(animationHandleData(second)), Containers::arrayView({
+        0.5f, 1.0f
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(animator.offsets(animationHandleData(second)).size(), 0);
+    CORRADE_COMPARE_AS(animator.sizes(animationHandleData(second)), Containers::arrayView<Vector2>({
+        {7.0f, 8.0f}, {9.0f, 10.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(animator.easings(animationHandleData(second)).size(), 1);
+    CORRADE_COMPARE(animator.easings(animationHandleData(second))[0], Animation::Easing::cubicIn);
+
+    /* A single keyframe with no easing */
+    AnimationHandle third = animator.create(
+        Containers::arrayView({0.0f}),
+        Containers::arrayView<Vector2>({{1.0f, 2.0f}}),
+        Containers::arrayView<Vector2>({{3.0f, 4.0f}}),
+        Containers::StridedArrayView1D<Float(*const)(Float)>{},
+        0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animator.usedCount(), 3);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 6);
+    CORRADE_COMPARE_AS(animator.times(third), Containers::arrayView({
+        0.0f
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(animator.easings(third).size(), 0);
+
+    /* Removing keeps the keyframe storage until it gets compacted */
+    animator.remove(first);
+    CORRADE_COMPARE(animator.usedCount(), 2);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 6);
+
+    animator.remove(animationHandleData(second));
+    CORRADE_COMPARE(animator.usedCount(), 1);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 6);
+}
+
+void KeyframeNodeAnimatorTest::createRemoveHandleRecycle() {
+    KeyframeNodeAnimator animator{animatorHandle(0, 1)};
+    animator.create(Containers::arrayView({0.0f}), Containers::arrayView<Vector2>({{0.0f, 0.0f}}), nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+
+    AnimationHandle second = animator.create(Containers::arrayView({0.0f, 1.0f}), Containers::arrayView<Vector2>({{1.0f, 2.0f}, {3.0f, 4.0f}}), nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.remove(second);
+
+    /* Animation that reuses a previous slot shouldn't inherit any of the
+       previous keyframes or properties */
+    AnimationHandle second2 = animator.create(Containers::arrayView({0.5f}), nullptr, Containers::arrayView<Vector2>({{5.0f, 6.0f}}), Animation::Easing::step, 0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animationHandleId(second2), animationHandleId(second));
+    CORRADE_COMPARE_AS(animator.times(second2), Containers::arrayView({
+        0.5f
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(animator.offsets(second2).size(), 0);
+    CORRADE_COMPARE_AS(animator.sizes(second2), Containers::arrayView<Vector2>({
+        {5.0f, 6.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(animator.easings(second2).size(), 0);
+}
+
+void KeyframeNodeAnimatorTest::createCompact() {
+    KeyframeNodeAnimator animator{animatorHandle(0, 1)};
+
+    AnimationHandle first = animator.create(Containers::arrayView({0.0f, 1.0f}), Containers::arrayView<Vector2>({{1.0f, 2.0f}, {3.0f, 4.0f}}), nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    AnimationHandle second = animator.create(Containers::arrayView({0.0f, 0.5f, 1.0f}), nullptr, Containers::arrayView<Vector2>({{5.0f, 6.0f}, {7.0f, 8.0f}, {9.0f, 10.0f}}), Animation::Easing::cubicOut, 0_nsec, 1_nsec, NodeHandle::Null);
+    AnimationHandle third = animator.create(Containers::arrayView({0.0f, 0.25f, 0.5f, 1.0f}), Containers::arrayView<Vector2>({{}, {}, {}, {}}), nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 9);
+
+    /* Removing just the first doesn't make more than half of the storage
+       unused, so it isn't compacted */
+    animator.remove(first);
+    AnimationHandle fourth = animator.create(Containers::arrayView({0.75f}), Containers::arrayView<Vector2>({{11.0f, 12.0f}}), nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 10);
+
+    /* Removing the third makes 6 keyframes out of 10 unused, compacting it
+       on next creation */
+    animator.remove(third);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 10);
+    AnimationHandle fifth = animator.create(Containers::arrayView({0.0f, 1.0f}), nullptr, Containers::arrayView<Vector2>({{13.0f, 14.0f}, {15.0f, 16.0f}}), Animation::Easing::bounceIn, 0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 6);
+
+    /* The remaining animations have their data preserved */
+    CORRADE_COMPARE_AS(animator.times(second), Containers::arrayView({
+        0.0f, 0.5f, 1.0f
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(animator.sizes(second), Containers::arrayView<Vector2>({
+        {5.0f, 6.0f}, {7.0f, 8.0f}, {9.0f, 10.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(animator.easings(second)[0], Animation::Easing::cubicOut);
+    CORRADE_COMPARE(animator.easings(second)[1], Animation::Easing::cubicOut);
+    CORRADE_COMPARE_AS(animator.times(fourth), Containers::arrayView({
+        0.75f
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(animator.offsets(fourth), Containers::arrayView<Vector2>({
+        {11.0f, 12.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(animator.times(fifth), Containers::arrayView({
+        0.0f, 1.0f
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(animator.sizes(fifth), Containers::arrayView<Vector2>({
+        {13.0f, 14.0f}, {15.0f, 16.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(animator.easings(fifth)[0], Animation::Easing::bounceIn);
+}
+
+void KeyframeNodeAnimatorTest::createInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    KeyframeNodeAnimator animator{animatorHandle(0, 1)};
+
+    const Vector2 values[3]{};
+    Float(*const easings[])(Float){
+        Animation::Easing::linear,
+        nullptr
+    };
+
+    Containers::String out;
+    Error redirectError{&out};
+    animator.create({}, values, nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.create({}, values, nullptr, Containers::StridedArrayView1D<Float(*const)(Float)>{}, 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.create(Containers::arrayView({0.0f, 1.0f}), values, nullptr, nullptr, 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.create(Containers::arrayView({0.0f, 1.0f}), Containers::arrayView(values).prefix(2), nullptr, Containers::arrayView(easings), 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.create(Containers::arrayView({0.0f, 0.5f, 1.0f}), Containers::arrayView(values), nullptr, Containers::arrayView(easings), 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.create(Containers::arrayView({0.0f, 1.0f}), nullptr, nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.create(Containers::arrayView({0.0f, 1.0f}), values, nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.create(Containers::arrayView({0.0f, 1.0f}), nullptr, values, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.create(Containers::arrayView({0.0f, 0.5f, 1.25f}), values, nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.create(Containers::arrayView({0.0f, 0.5f, 0.25f}), values, nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animator.usedCount(), 0);
+    CORRADE_COMPARE_AS(out,
+        "Ui::KeyframeNodeAnimator::create(): expected at least one keyframe\n"
+        "Ui::KeyframeNodeAnimator::create(): expected at least one keyframe\n"
+        "Ui::KeyframeNodeAnimator::create(): easing is null\n"
+        "Ui::KeyframeNodeAnimator::create(): expected 1 easings for 2 keyframes but got 2\n"
+        "Ui::KeyframeNodeAnimator::create(): easing 1 is null\n"
+        "Ui::KeyframeNodeAnimator::create(): expected either offsets or sizes to be non-empty\n"
+        "Ui::KeyframeNodeAnimator::create(): expected 2 offsets but got 3\n"
+        "Ui::KeyframeNodeAnimator::create(): expected 2 sizes but got 3\n"
+        "Ui::KeyframeNodeAnimator::create(): expected keyframe times to be in the [0, 1] range but got 1.25 at index 2\n"
+        "Ui::KeyframeNodeAnimator::create(): expected keyframe times to be sorted but got 0.25 after 0.5 at index 2\n",
+        TestSuite::Compare::String);
+}
+
+void KeyframeNodeAnimatorTest::propertiesInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    KeyframeNodeAnimator animator{animatorHandle(0, 1)};
+
+    AnimationHandle handle = animator.create(Containers::arrayView({0.0f}), Containers::arrayView<Vector2>({{0.0f, 0.0f}}), nullptr, Animation::Easing::linear, 12_nsec, 13_nsec, NodeHandle::Null);
+
+    Containers::String out;
+    Error redirectError{&out};
+    animator.times(AnimationHandle::Null);
+    animator.offsets(AnimationHandle::Null);
+    animator.sizes(AnimationHandle::Null);
+    animator.easings(AnimationHandle::Null);
+    /* Valid animator, invalid data */
+    animator.times(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.offsets(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.sizes(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.easings(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    /* Invalid animator, valid data */
+    animator.times(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
+    animator.offsets(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
+    animator.sizes(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
+    animator.easings(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
+    /* AnimatorDataHandle directly */
+    animator.times(AnimatorDataHandle(0x123abcde));
+    animator.offsets(AnimatorDataHandle(0x123abcde));
+    animator.sizes(AnimatorDataHandle(0x123abcde));
+    animator.easings(AnimatorDataHandle(0x123abcde));
+    CORRADE_COMPARE_AS(out,
+        "Ui::KeyframeNodeAnimator::times(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::KeyframeNodeAnimator::offsets(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::KeyframeNodeAnimator::sizes(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::KeyframeNodeAnimator::easings(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::KeyframeNodeAnimator::times(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
+        "Ui::KeyframeNodeAnimator::offsets(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
+        "Ui::KeyframeNodeAnimator::sizes(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
+        "Ui::KeyframeNodeAnimator::easings(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
+        "Ui::KeyframeNodeAnimator::times(): invalid handle Ui::AnimationHandle(Null, {0x0, 0x1})\n"
+        "Ui::KeyframeNodeAnimator::offsets(): invalid handle Ui::AnimationHandle(Null, {0x0, 0x1})\n"
+        "Ui::KeyframeNodeAnimator::sizes(): invalid handle Ui::AnimationHandle(Null, {0x0, 0x1})\n"
+        "Ui::KeyframeNodeAnimator::easings(): invalid handle Ui::AnimationHandle(Null, {0x0, 0x1})\n"
+        "Ui::KeyframeNodeAnimator::times(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n"
+        "Ui::KeyframeNodeAnimator::offsets(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n"
+        "Ui::KeyframeNodeAnimator::sizes(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n"
+        "Ui::KeyframeNodeAnimator::easings(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n",
+        TestSuite::Compare::String);
+}
+
+void KeyframeNodeAnimatorTest::clean() {
+    KeyframeNodeAnimator animator{animatorHandle(0, 1)};
+
+    AnimationHandle first = animator.create(Containers::arrayView({0.0f, 1.0f}), Containers::arrayView<Vector2>({{}, {}}), nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    AnimationHandle second = animator.create(Containers::arrayView({0.0f}), Containers::arrayView<Vector2>({{0.0f, 0.0f}}), nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    AnimationHandle third = animator.create(Containers::arrayView({0.0f, 0.5f, 1.0f}), Containers::arrayView<Vector2>({{}, {}, {}}), nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animator.usedCount(), 3);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 6);
+
+    UnsignedByte data[]{(1 << 0)|(1 << 2)};
+    animator.clean(Containers::BitArrayView{data, 0, 3});
+    CORRADE_COMPARE(animator.usedCount(), 1);
+    CORRADE_VERIFY(!animator.isHandleValid(first));
+    CORRADE_VERIFY(animator.isHandleValid(second));
+    CORRADE_VERIFY(!animator.isHandleValid(third));
+
+    /* The cleaned keyframes count as removed, so the storage gets compacted
+       on next creation */
+    CORRADE_COMPARE(animator.keyframeCapacity(), 6);
+    animator.create(Containers::arrayView({0.0f}), Containers::arrayView<Vector2>({{0.0f, 0.0f}}), nullptr, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animator.keyframeCapacity(), 2);
+}
+
+void KeyframeNodeAnimatorTest::advance() {
+    KeyframeNodeAnimator animator{animatorHandle(0, 1)};
+
+    /* Offset only, linear interpolation between three keyframes */
+    animator.create(Containers::arrayView({0.0f, 0.5f, 1.0f}),
+        Containers::arrayView<Vector2>({{0.0f, 0.0f}, {10.0f, 20.0f}, {30.0f, 40.0f}}),
+        nullptr,
+        Animation::Easing::linear,
+        0_nsec, 10_nsec, nodeHandle(1, 0x123));
+
+    /* Both offset and size, starting later than the animation itself */
+    animator.create(Containers::arrayView({0.2f, 0.6f}),
+        Containers::arrayView<Vector2>({{1.0f, 1.0f}, {3.0f, 3.0f}}),
+        Containers::arrayView<Vector2>({{10.0f, 10.0f}, {20.0f, 30.0f}}),
+        Animation::Easing::linear,
+        0_nsec, 10_nsec, nodeHandle(3, 0x123));
+
+    /* Not attached to anything, shouldn't affect any node */
+    animator.create(Containers::arrayView({0.0f}),
+        Containers::arrayView<Vector2>({{7.0f, 7.0f}}),
+        nullptr,
+        Animation::Easing::linear,
+        0_nsec, 10_nsec, NodeHandle::Null);
+
+    /* Not active, shouldn't get touched */
+    animator.create(Containers::arrayView({0.0f, 1.0f}),
+        Containers::arrayView<Vector2>({{100.0f, 100.0f}, {200.0f, 200.0f}}),
+        nullptr,
+        Animation::Easing::linear,
+        0_nsec, 10_nsec, nodeHandle(2, 0x123));
+
+    /* Size only, with a custom easing */
+    Float(*const easings[])(Float){
+        Animation::Easing::quadraticIn
+    };
+    animator.create(Containers::arrayView({0.0f, 1.0f}),
+        nullptr,
+        Containers::arrayView<Vector2>({{0.0f, 0.0f}, {4.0f, 8.0f}}),
+        easings,
+        0_nsec, 10_nsec, nodeHandle(0, 0x123));
+
+    Vector2 nodeOffsets[]{
+        {-1.0f, -1.0f},
+        {-2.0f, -2.0f},
+        {-3.0f, -3.0f},
+        {-4.0f, -4.0f},
+    };
+    Vector2 nodeSizes[]{
+        {-5.0f, -5.0f},
+        {-6.0f, -6.0f},
+        {-7.0f, -7.0f},
+        {-8.0f, -8.0f},
+    };
+    NodeFlags nodeFlags[4]{};
+    UnsignedByte nodesRemoveData[1]{};
+    Containers::MutableBitArrayView nodesRemove{nodesRemoveData, 0, 4};
+
+    UnsignedByte active[]{(1 << 0)|(1 << 1)|(1 << 2)|(1 << 4)};
+    {
+        Float factors[]{0.25f, 0.1f, 0.5f, 0.5f, 1.0f};
+        CORRADE_COMPARE(animator.advance(Containers::BitArrayView{active, 0, 5}, factors, nodeOffsets, nodeSizes, nodeFlags, nodesRemove), NodeAnimation::OffsetSize);
+        CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets), Containers::arrayView<Vector2>({
+            {-1.0f, -1.0f},     /* Size only */
+            {5.0f, 10.0f},      /* Halfway between first and second */
+            {-3.0f, -3.0f},     /* Not active */
+            {1.0f, 1.0f},       /* Clamped to the first */
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes), Containers::arrayView<Vector2>({
+            {4.0f, 8.0f},       /* At the end */
+            {-6.0f, -6.0f},     /* Offset only */
+            {-7.0f, -7.0f},     /* Not active */
+            {10.0f, 10.0f},     /* Clamped to the first */
+        }), TestSuite::Compare::Container);
+    }
+
+    /* Advancing further and back, which isn't the common case but should
+       still be handled correctly */
+    {
+        Float factors[]{0.75f, 0.8f, 1.0f, 0.5f, 0.5f};
+        CORRADE_COMPARE(animator.advance(Containers::BitArrayView{active, 0, 5}, factors, nodeOffsets, nodeSizes, nodeFlags, nodesRemove), NodeAnimation::OffsetSize);
+        CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets), Containers::arrayView<Vector2>({
+            {-1.0f, -1.0f},     /* Size only */
+            {20.0f, 30.0f},     /* Halfway between second and third */
+            {-3.0f, -3.0f},     /* Not active */
+            {3.0f, 3.0f},       /* Clamped to the last */
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes), Containers::arrayView<Vector2>({
+            {1.0f, 2.0f},       /* Quadratic easing at the half */
+            {-6.0f, -6.0f},     /* Offset only */
+            {-7.0f, -7.0f},     /* Not active */
+            {20.0f, 30.0f},     /* Clamped to the last */
+        }), TestSuite::Compare::Container);
+    }
+
+    /* Going back to the start */
+    {
+        Float factors[]{0.0f, 0.4f, 0.0f, 0.0f, 0.0f};
+        CORRADE_COMPARE(animator.advance(Containers::BitArrayView{active, 0, 5}, factors, nodeOffsets, nodeSizes, nodeFlags, nodesRemove), NodeAnimation::OffsetSize);
+        CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets), Containers::arrayView<Vector2>({
+            {-1.0f, -1.0f},     /* Size only */
+            {0.0f, 0.0f},       /* At the first */
+            {-3.0f, -3.0f},     /* Not active */
+            {2.0f, 2.0f},       /* Halfway between first and second */
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes), Containers::arrayView<Vector2>({
+            {0.0f, 0.0f},       /* At the first */
+            {-6.0f, -6.0f},     /* Offset only */
+            {-7.0f, -7.0f},     /* Not active */
+            {15.0f, 20.0f},     /* Halfway between first and second */
+        }), TestSuite::Compare::Container);
+    }
+
+    /* Nothing is scheduled for removal, no flags are touched */
+    CORRADE_COMPARE_AS(nodesRemove, Containers::stridedArrayView({
+        false, false, false, false
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeFlags), Containers::arrayView({
+        NodeFlags{}, NodeFlags{}, NodeFlags{}, NodeFlags{}
+    }), TestSuite::Compare::Container);
+}
+
+void KeyframeNodeAnimatorTest::advanceEmpty() {
+    KeyframeNodeAnimator animator{animatorHandle(0, 1)};
+    CORRADE_COMPARE(animator.advance({}, {}, {}, {}, {}, {}), NodeAnimations{});
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::KeyframeNodeAnimatorTest)
@@ -0,0 +1,246 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/LineLayer.h"
+#include "Magnum/Ui/Implementation/fillLineStripIndices.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct LineLayerBenchmark: TestSuite::Tester {
+    explicit LineLayerBenchmark();
+
+    void fillStripIndexRange();
+    void setLineStrip();
+
+    void create();
+    void update();
+};
+
+constexpr UnsignedInt StripBenchmarkPointCount = 100000;
+
+/* Used by create() and update(). Together it's again 100k points. */
+constexpr UnsignedInt LineBenchmarkLineCount = 1000;
+constexpr UnsignedInt LineBenchmarkPointCount = 100;
+
+enum class CreateType {
+    Indexed,
+    Strip,
+    Loop
+};
+
+const struct {
+    const char* name;
+    void(*function)(Containers::ArrayView<Implementation::LineLayerPointIndex>, UnsignedInt, UnsignedInt);
+} FillStripIndexRangeData[]{
+    {"scalar", Implementation::fillLineStripIndexRangeScalar},
+    {"SIMD, if available", Implementation::fillLineStripIndexRange},
+};
+
+const struct {
+    const char* name;
+    CreateType type;
+} CreateData[]{
+    {"create()", CreateType::Indexed},
+    {"createStrip()", CreateType::Strip},
+    {"createLoop()", CreateType::Loop},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt relocateEvery;
+} UpdateData[]{
+    {"no fragmentation", 0},
+    {"every 10th line relocated", 10},
+    {"every 2nd line relocated", 2},
+    {"all lines relocated", 1},
+};
+
+LineLayerBenchmark::LineLayerBenchmark() {
+    addInstancedBenchmarks({&LineLayerBenchmark::fillStripIndexRange}, 50,
+        Containers::arraySize(FillStripIndexRangeData));
+
+    addBenchmarks({&LineLayerBenchmark::setLineStrip}, 20);
+
+    addInstancedBenchmarks({&LineLayerBenchmark::create}, 20,
+        Containers::arraySize(CreateData));
+
+    addInstancedBenchmarks({&LineLayerBenchmark::update}, 20,
+        Containers::arraySize(UpdateData));
+}
+
+void LineLayerBenchmark::fillStripIndexRange() {
+    auto&& data = FillStripIndexRangeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures just the index sequence fill that's done by createStrip(),
+       setLineStrip(), createLoop(), setLineLoop() and appendLineStrip() */
+
+    Containers::Array<Implementation::LineLayerPointIndex> pointIndices{NoInit, StripBenchmarkPointCount*2 - 2};
+
+    CORRADE_BENCHMARK(10)
+        data.function(pointIndices, 0, pointIndices.size());
+
+    /* Just to make sure the output isn't optimized away */
+    CORRADE_COMPARE(pointIndices[pointIndices.size() - 2].index, StripBenchmarkPointCount - 2);
+    CORRADE_COMPARE(pointIndices[pointIndices.size() - 1].index, StripBenchmarkPointCount - 1);
+}
+
+void LineLayerBenchmark::setLineStrip() {
+    /* Measures the whole setLineStrip() operation, i.e. the index fill
+       benchmarked above and the point copy. The update() afterwards is not
+       included. */
+
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{1}};
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    Containers::Array<Vector2> points{NoInit, StripBenchmarkPointCount};
+    for(UnsignedInt i = 0; i != points.size(); ++i)
+        points[i] = {Float(i), Float(i % 7)};
+
+    /* Setting the same point count reuses the existing allocation, so only
+       the first call, outside of the benchmark loop, allocates */
+    DataHandle data = layer.createStrip(0, points, {});
+
+    CORRADE_BENCHMARK(10)
+        layer.setLineStrip(data, points, {});
+
+    CORRADE_COMPARE(layer.indexCount(data), StripBenchmarkPointCount*2 - 2);
+}
+
+void LineLayerBenchmark::create() {
+    auto&& data = CreateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures creation of many small lines, i.e. the run allocation, the
+       point copy and index fill. The layer is recreated for every repeat so
+       the storage grows from scratch each time. */
+
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{1}};
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    Containers::Array<Vector2> points{NoInit, LineBenchmarkPointCount};
+    for(UnsignedInt i = 0; i != points.size(); ++i)
+        points[i] = {Float(i), Float(i % 7)};
+
+    /* Equivalent to a strip, expressed as an indexed segment list */
+    Containers::Array<UnsignedInt> indices{NoInit, LineBenchmarkPointCount*2 - 2};
+    for(UnsignedInt i = 0; i != indices.size(); ++i)
+        indices[i] = (i >> 1) + (i & 1);
+
+    CORRADE_BENCHMARK(1) {
+        for(UnsignedInt i = 0; i != LineBenchmarkLineCount; ++i) {
+            if(data.type == CreateType::Indexed)
+                layer.create(0, indices, points, {});
+            else if(data.type == CreateType::Strip)
+                layer.createStrip(0, points, {});
+            else if(data.type == CreateType::Loop)
+                layer.createLoop(0, points, {});
+            else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+        }
+    }
+
+    CORRADE_COMPARE(layer.usedCount(), LineBenchmarkLineCount);
+}
+
+void LineLayerBenchmark::update() {
+    auto&& data = UpdateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures LineLayer::doUpdate() with a varying amount of runs relocated
+       by setLineStrip() with a different point count, which the update has to
+       recompact first before generating the vertex and index data. The GPU
+       upload is benchmarked in LineLayerGLBenchmark. */
+
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{1}};
+    shared.setStyle(LineLayerCommonStyleUniform{},
+        {LineLayerStyleUniform{}},
+        {{}},
+        {});
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    Containers::Array<Vector2> points{NoInit, LineBenchmarkPointCount + 1};
+    for(UnsignedInt i = 0; i != points.size(); ++i)
+        points[i] = {Float(i), Float(i % 7)};
+
+    Containers::Array<DataHandle> handles{NoInit, LineBenchmarkLineCount};
+    Containers::Array<UnsignedInt> dataIds{NoInit, LineBenchmarkLineCount};
+    for(UnsignedInt i = 0; i != LineBenchmarkLineCount; ++i) {
+        handles[i] = layer.createStrip(0, points.prefix(LineBenchmarkPointCount), {}, nodeHandle(0, 1));
+        dataIds[i] = dataHandleId(handles[i]);
+    }
+
+    /* Relocating happens with one more point, so the runs aren't reused */
+    if(data.relocateEvery) for(UnsignedInt i = 0; i < LineBenchmarkLineCount; i += data.relocateEvery)
+        layer.setLineStrip(handles[i], points, {});
+
+    Vector2 nodeOffsets[1];
+    Vector2 nodeSizes[1]{{1.0f, 1.0f}};
+    Float nodeOpacities[1]{1.0f};
+    UnsignedByte nodesEnabled[1]{};
+
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    CORRADE_BENCHMARK(1)
+        layer.update(layer.state(), dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, Containers::BitArrayView{nodesEnabled, 0, 1}, {}, {}, {}, {});
+
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::LineLayerBenchmark)
@@ -0,0 +1,325 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/OpenGLTester.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/LineLayerGL.h"
+#include "Magnum/Ui/RendererGL.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct LineLayerGLBenchmark: GL::OpenGLTester {
+    explicit LineLayerGLBenchmark();
+
+    void setupVertex();
+    void setup();
+    void teardown();
+
+    void upload();
+    void vertex();
+    void draw();
+
+    private:
+        GL::Texture2D _color{NoCreate};
+        GL::Framebuffer _framebuffer{NoCreate};
+};
+
+using namespace Math::Literals;
+
+constexpr Vector2i VertexBenchmarkSize{128, 128};
+constexpr Vector2i BenchmarkSize{512, 512};
+
+/* Zig-zag lines every 4 pixels, 8 pixels wide, so they overlap and cover the
+   whole framebuffer. The points are 8 pixels apart horizontally. */
+constexpr UnsignedInt BenchmarkLineCount = BenchmarkSize.y()/4;
+constexpr UnsignedInt BenchmarkLinePointCount = BenchmarkSize.x()/8 + 1;
+
+const struct {
+    const char* name;
+    UnsignedInt changedLineCount;
+} UploadData[]{
+    {"nothing changed", 0},
+    {"one line changed", 1},
+    {"all lines changed", BenchmarkLineCount},
+};
+
+const struct {
+    const char* name;
+    LineCapStyle capStyle;
+    LineJoinStyle joinStyle;
+} DrawData[]{
+    {"butt caps, miter joins", LineCapStyle::Butt, LineJoinStyle::Miter},
+    {"butt caps, bevel joins", LineCapStyle::Butt, LineJoinStyle::Bevel},
+    {"square caps, miter joins", LineCapStyle::Square, LineJoinStyle::Miter},
+    {"square caps, bevel joins", LineCapStyle::Square, LineJoinStyle::Bevel},
+    {"round caps, miter joins", LineCapStyle::Round, LineJoinStyle::Miter},
+    {"round caps, bevel joins", LineCapStyle::Round, LineJoinStyle::Bevel},
+    {"triangle caps, miter joins", LineCapStyle::Triangle, LineJoinStyle::Miter},
+    {"triangle caps, bevel joins", LineCapStyle::Triangle, LineJoinStyle::Bevel},
+};
+
+const struct {
+    const char* name;
+    LineCapStyle capStyle;
+    LineJoinStyle joinStyle;
+    bool strip;
+} VertexData[]{
+    {"single segments, butt caps", LineCapStyle::Butt, LineJoinStyle::Miter, false},
+    {"single segments, round caps", LineCapStyle::Round, LineJoinStyle::Miter, false},
+    {"two-segment strips, butt caps, miter joins", LineCapStyle::Butt, LineJoinStyle::Miter, true},
+    {"two-segment strips, butt caps, bevel joins", LineCapStyle::Butt, LineJoinStyle::Bevel, true},
+};
+
+LineLayerGLBenchmark::LineLayerGLBenchmark() {
+    addInstancedBenchmarks({&LineLayerGLBenchmark::upload}, 20,
+        Containers::arraySize(UploadData),
+        &LineLayerGLBenchmark::setup,
+        &LineLayerGLBenchmark::teardown);
+
+    addInstancedBenchmarks({&LineLayerGLBenchmark::vertex}, 10,
+        Containers::arraySize(VertexData),
+        &LineLayerGLBenchmark::setupVertex,
+        &LineLayerGLBenchmark::teardown,
+        BenchmarkType::GpuTime);
+
+    addInstancedBenchmarks({&LineLayerGLBenchmark::draw}, 10,
+        Containers::arraySize(DrawData),
+        &LineLayerGLBenchmark::setup,
+        &LineLayerGLBenchmark::teardown,
+        BenchmarkType::GpuTime);
+}
+
+void LineLayerGLBenchmark::setupVertex() {
+    _color = GL::Texture2D{};
+    _color.setStorage(1, GL::TextureFormat::RGBA8, VertexBenchmarkSize);
+    _framebuffer = GL::Framebuffer{{{}, VertexBenchmarkSize}};
+    _framebuffer
+        .attachTexture(GL::Framebuffer::ColorAttachment{0}, _color, 0)
+        .clear(GL::FramebufferClear::Color)
+        .bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+    /* The RendererGL should enable these on its own if needed */
+    GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
+    GL::Renderer::disable(GL::Renderer::Feature::Blending);
+}
+
+void LineLayerGLBenchmark::setup() {
+    _color = GL::Texture2D{};
+    _color.setStorage(1, GL::TextureFormat::RGBA8, BenchmarkSize);
+    _framebuffer = GL::Framebuffer{{{}, BenchmarkSize}};
+    _framebuffer
+        .attachTexture(GL::Framebuffer::ColorAttachment{0}, _color, 0)
+        .clear(GL::FramebufferClear::Color)
+        .bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+    /* The RendererGL should enable these on its own if needed */
+    GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
+    GL::Renderer::disable(GL::Renderer::Feature::Blending);
+}
+
+void LineLayerGLBenchmark::teardown() {
+    _framebuffer = GL::Framebuffer{NoCreate};
+    _color = GL::Texture2D{NoCreate};
+
+    GL::Renderer::disable(GL::Renderer::Feature::FaceCulling);
+    GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
+    GL::Renderer::disable(GL::Renderer::Feature::Blending);
+}
+
+Containers::Array<DataHandle> createLines(LineLayer& layer, NodeHandle node) {
+    Containers::Array<Vector2> points{NoInit, BenchmarkLinePointCount};
+    Containers::Array<DataHandle> handles{NoInit, BenchmarkLineCount};
+    for(UnsignedInt i = 0; i != BenchmarkLineCount; ++i) {
+        for(UnsignedInt j = 0; j != BenchmarkLinePointCount; ++j)
+            points[j] = {j*8.0f, i*4.0f + 2.0f + (j & 1 ? 2.0f : -2.0f)};
+        handles[i] = layer.createStrip(0, points, {}, node);
+    }
+
+    return handles;
+}
+
+void LineLayerGLBenchmark::upload() {
+    auto&& data = UploadData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side LineLayerGL::doUpdate(), including the vertex
+       and index data generation in LineLayer::doUpdate() and the upload of
+       changed ranges. The data change is done by alternating the per-data
+       color, which doesn't change the run layout. */
+
+    AbstractUserInterface ui{BenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    LineLayerGL::Shared shared{LineLayer::Shared::Configuration{1}};
+    shared.setStyle(LineLayerCommonStyleUniform{}, {
+        LineLayerStyleUniform{}
+            .setWidth(8.0f)
+    }, {LineAlignment::TopLeft}, {});
+
+    LineLayerGL& layer = ui.setLayerInstance(Containers::pointer<LineLayerGL>(ui.createLayer(), shared));
+
+    NodeHandle node = ui.createNode({}, ui.size());
+    Containers::Array<DataHandle> handles = createLines(layer, node);
+
+    ui.update();
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+
+    UnsignedInt iteration = 0;
+    CORRADE_BENCHMARK(20) {
+        const Color4 color = iteration++ & 1 ? 0xffffff_rgbf : 0xff3366_rgbf;
+        layer.setNeedsUpdate(LayerState::NeedsDataUpdate);
+        for(UnsignedInt i = 0; i != data.changedLineCount; ++i)
+            layer.setColor(handles[i], color);
+        ui.update();
+    }
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+}
+
+void LineLayerGLBenchmark::vertex() {
+    auto&& data = VertexData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Renders a tiny horizontal line for every pixel to benchmark mainly the
+       vertex shader invocation. The strip variant has an extra point in the
+       middle in order to have a join as well. */
+
+    AbstractUserInterface ui{VertexBenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    LineLayerGL::Shared shared{LineLayer::Shared::Configuration{1}
+        .setCapStyle(data.capStyle)
+        .setJoinStyle(data.joinStyle)
+    };
+    shared.setStyle(LineLayerCommonStyleUniform{}, {
+        LineLayerStyleUniform{}
+            .setColor(0xff3366_rgbf)
+            .setWidth(1.0f)
+    }, {LineAlignment::TopLeft}, {});
+
+    LineLayerGL& layer = ui.setLayerInstance(Containers::pointer<LineLayerGL>(ui.createLayer(), shared));
+
+    const Vector2 points[]{
+        {0.0f, 0.5f},
+        {0.5f, 0.5f},
+        {1.0f, 0.5f},
+    };
+    const Vector2 segmentPoints[]{
+        points[0],
+        points[2],
+    };
+
+    NodeHandle root = ui.createNode({}, ui.size());
+    for(Int x = 0; x != VertexBenchmarkSize.x(); ++x)
+        for(Int y = 0; y != VertexBenchmarkSize.y(); ++y) {
+            NodeHandle node = ui.createNode(root, {Float(x), Float(y)}, Vector2{1.0f});
+            if(data.strip)
+                layer.createStrip(0, points, {}, node);
+            else
+                layer.createStrip(0, segmentPoints, {}, node);
+        }
+
+    ui.update();
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+
+    CORRADE_BENCHMARK(20)
+        ui.draw();
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Verify just one pixel, the LineLayerGLTest does the rest */
+    Image2D out = _framebuffer.read({{}, VertexBenchmarkSize}, {PixelFormat::RGBA8Unorm});
+    CORRADE_COMPARE_WITH(
+        Math::unpack<Color4>(
+            out.pixels<Color4ub>()[std::size_t(VertexBenchmarkSize.y()/2)]
+                                  [std::size_t(VertexBenchmarkSize.x()/2)]),
+        0xff3366_rgbf,
+        TestSuite::Compare::around(Color4{1.0f/255.0f, 1.0f/255.0f}));
+}
+
+void LineLayerGLBenchmark::draw() {
+    auto&& data = DrawData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Renders overlapping lines covering the whole framebuffer to benchmark
+       the vertex and fragment shader invocation for given cap and join
+       style */
+
+    AbstractUserInterface ui{BenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    LineLayerGL::Shared shared{LineLayer::Shared::Configuration{1}
+        .setCapStyle(data.capStyle)
+        .setJoinStyle(data.joinStyle)
+    };
+    shared.setStyle(LineLayerCommonStyleUniform{}, {
+        LineLayerStyleUniform{}
+            .setColor(0xff3366_rgbf)
+            .setWidth(8.0f)
+    }, {LineAlignment::TopLeft}, {});
+
+    LineLayerGL& layer = ui.setLayerInstance(Containers::pointer<LineLayerGL>(ui.createLayer(), shared));
+
+    NodeHandle node = ui.createNode({}, ui.size());
+    createLines(layer, node);
+
+    ui.update();
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+
+    CORRADE_BENCHMARK(20)
+        ui.draw();
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Verify just one pixel, the LineLayerGLTest does the rest */
+    Image2D out = _framebuffer.read({{}, BenchmarkSize}, {PixelFormat::RGBA8Unorm});
+    CORRADE_COMPARE_WITH(
+        Math::unpack<Color4>(
+            out.pixels<Color4ub>()[std::size_t(BenchmarkSize.y()/2)]
+                                  [std::size_t(BenchmarkSize.x()/2)]),
+        0xff3366_rgbf,
+        TestSuite::Compare::around(Color4{1.0f/255.0f, 1.0f/255.0f}));
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::LineLayerGLBenchmark)
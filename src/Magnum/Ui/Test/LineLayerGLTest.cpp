@@ -35,6 +35,9 @@
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/DebugTools/CompareImage.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/Extensions.h>
+#endif
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/OpenGLTester.h>
 #include <Magnum/GL/Texture.h>
@@ -498,21 +501,33 @@ const struct {
     const char* filename;
     bool indexed, strip, loop;
     bool partialUpdate;
+    LineLayerSharedFlags flags;
 } RenderChangeLineData[]{
-    {"to indexed", "strip.png", true, false, false, false},
-    {"to indexed, partial update", "strip.png", true, false, false, true},
-    {"to a strip", "strip.png", false, true, false, false},
-    {"to a strip, partial update", "strip.png", false, true, false, true},
-    {"to a loop", "loop.png", false, false, true, false},
-    {"to a loop, partial update", "loop.png", false, false, true, true},
+    {"to indexed", "strip.png", true, false, false, false, {}},
+    {"to indexed, partial update", "strip.png", true, false, false, true, {}},
+    {"to a strip", "strip.png", false, true, false, false, {}},
+    {"to a strip, partial update", "strip.png", false, true, false, true, {}},
+    {"to a loop", "loop.png", false, false, true, false, {}},
+    {"to a loop, partial update", "loop.png", false, false, true, true, {}},
+    {"to indexed, instanced segments", "strip.png", true, false, false, false,
+        LineLayerSharedFlag::InstancedSegments},
+    {"to a strip, partial update, instanced segments", "strip.png", false, true, false, true,
+        LineLayerSharedFlag::InstancedSegments},
+    {"to a loop, instanced segments", "loop.png", false, false, true, false,
+        LineLayerSharedFlag::InstancedSegments},
+    {"to a loop, partial update, instanced segments", "loop.png", false, false, true, true,
+        LineLayerSharedFlag::InstancedSegments},
 };
 
 const struct {
     const char* name;
     bool dataInNodeOrder;
+    LineLayerSharedFlags flags;
 } DrawOrderData[]{
-    {"data created in node order", true},
-    {"data created randomly", false}
+    {"data created in node order", true, {}},
+    {"data created randomly", false, {}},
+    {"data created randomly, instanced segments", false,
+        LineLayerSharedFlag::InstancedSegments},
 };
 
 LineLayerGLTest::LineLayerGLTest() {
@@ -1133,13 +1148,19 @@ void LineLayerGLTest::renderChangeLine() {
     auto&& data = RenderChangeLineData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
+    #ifndef MAGNUM_TARGET_GLES
+    if(data.flags >= LineLayerSharedFlag::InstancedSegments && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
+
     /* Basically the same as renderStrip() / renderLoop(), except that the line
        is changed only subsequently, via one of the three setLine*() APIs. */
 
     AbstractUserInterface ui{RenderSize};
     ui.setRendererInstance(Containers::pointer<RendererGL>());
 
-    LineLayerGL::Shared layerShared{LineLayer::Shared::Configuration{1}};
+    LineLayerGL::Shared layerShared{LineLayer::Shared::Configuration{1}
+        .setFlags(data.flags)};
     layerShared.setStyle(
         LineLayerCommonStyleUniform{},
         {LineLayerStyleUniform{}
@@ -1237,10 +1258,16 @@ void LineLayerGLTest::drawOrder() {
     auto&& data = DrawOrderData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
+    #ifndef MAGNUM_TARGET_GLES
+    if(data.flags >= LineLayerSharedFlag::InstancedSegments && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
+
     AbstractUserInterface ui{DrawSize};
     ui.setRendererInstance(Containers::pointer<RendererGL>());
 
-    LineLayerGL::Shared layerShared{LineLayer::Shared::Configuration{4}};
+    LineLayerGL::Shared layerShared{LineLayer::Shared::Configuration{4}
+        .setFlags(data.flags)};
     /* Testing the styleToUniform initializer list overload, others cases use
        implicit mapping initializer list overloads */
     layerShared.setStyle(LineLayerCommonStyleUniform{}, {
@@ -25,8 +25,10 @@
 */
 
 #include <new>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
@@ -36,6 +38,9 @@
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/LineLayer.h"
 #include "Magnum/Ui/Implementation/lineLayerState.h"
+#include "Magnum/Ui/Implementation/runCompaction.h"
+/* for fillStripIndexRange() */
+#include "Magnum/Ui/Implementation/fillLineStripIndices.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
 
@@ -63,6 +68,8 @@ struct LineLayerTest: TestSuite::Tester {
     void debugCapStyle();
     void debugJoinStyle();
     void debugAlignment();
+    void debugSharedFlag();
+    void debugSharedFlags();
 
     void sharedConfigurationConstruct();
     void sharedConfigurationConstructSameStyleUniformCount();
@@ -94,11 +101,16 @@ struct LineLayerTest: TestSuite::Tester {
     void createSetIndicesNeighbors();
     void createSetStripIndicesNeighbors();
     void createSetLoopIndicesNeighbors();
+    void appendStrip();
+    void createSetShared();
+    void fillStripIndexRange();
     void createStyleOutOfRange();
 
     void setColor();
+    void setColorMultipleInvalid();
     void setAlignment();
     void setPadding();
+    void setDecimationTolerance();
 
     void invalidHandle();
     void createSetInvalid();
@@ -108,6 +120,9 @@ struct LineLayerTest: TestSuite::Tester {
     void updateCleanDataOrder();
     void updateAlignment();
     void updatePadding();
+    void updateCompactionLargeData();
+    void updateInstancedSegments();
+    void updateDecimation();
     void updateNoStyleSet();
 
     void sharedNeedsUpdateStatePropagatedToLayers();
@@ -207,6 +222,19 @@ const struct {
         LayerState::NeedsDataUpdate, true, true},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt begin, end;
+} FillStripIndexRangeData[]{
+    {"whole segments", 0, 20},
+    {"odd begin", 3, 20},
+    {"odd end", 0, 19},
+    {"odd begin and end", 5, 17},
+    {"single item, even", 6, 7},
+    {"single item, odd", 7, 8},
+    {"empty", 6, 6},
+};
+
 const struct {
     const char* name;
     LineAlignment alignment;
@@ -248,6 +276,8 @@ LineLayerTest::LineLayerTest() {
     addTests({&LineLayerTest::debugCapStyle,
               &LineLayerTest::debugJoinStyle,
               &LineLayerTest::debugAlignment,
+              &LineLayerTest::debugSharedFlag,
+              &LineLayerTest::debugSharedFlags,
 
               &LineLayerTest::sharedConfigurationConstruct,
               &LineLayerTest::sharedConfigurationConstructSameStyleUniformCount,
@@ -281,11 +311,19 @@ LineLayerTest::LineLayerTest() {
               &LineLayerTest::createSetIndicesNeighbors,
               &LineLayerTest::createSetStripIndicesNeighbors,
               &LineLayerTest::createSetLoopIndicesNeighbors,
-              &LineLayerTest::createStyleOutOfRange,
+              &LineLayerTest::appendStrip,
+              &LineLayerTest::createSetShared});
+
+    addInstancedTests({&LineLayerTest::fillStripIndexRange},
+        Containers::arraySize(FillStripIndexRangeData));
+
+    addTests({&LineLayerTest::createStyleOutOfRange,
 
               &LineLayerTest::setColor,
+              &LineLayerTest::setColorMultipleInvalid,
               &LineLayerTest::setAlignment,
               &LineLayerTest::setPadding,
+              &LineLayerTest::setDecimationTolerance,
 
               &LineLayerTest::invalidHandle,
               &LineLayerTest::createSetInvalid,
@@ -300,7 +338,10 @@ LineLayerTest::LineLayerTest() {
                        &LineLayerTest::updatePadding},
         Containers::arraySize(UpdateAlignmentPaddingData));
 
-    addTests({&LineLayerTest::updateNoStyleSet,
+    addTests({&LineLayerTest::updateCompactionLargeData,
+              &LineLayerTest::updateInstancedSegments,
+              &LineLayerTest::updateDecimation,
+              &LineLayerTest::updateNoStyleSet,
 
               &LineLayerTest::sharedNeedsUpdateStatePropagatedToLayers});
 }
@@ -520,6 +561,18 @@ void LineLayerTest::debugAlignment() {
     CORRADE_COMPARE(out, "Ui::LineAlignment::MiddleRight Ui::LineAlignment(0xb0)\n");
 }
 
+void LineLayerTest::debugSharedFlag() {
+    Containers::String out;
+    Debug{&out} << LineLayerSharedFlag::InstancedSegments << LineLayerSharedFlag(0xbe);
+    CORRADE_COMPARE(out, "Ui::LineLayerSharedFlag::InstancedSegments Ui::LineLayerSharedFlag(0xbe)\n");
+}
+
+void LineLayerTest::debugSharedFlags() {
+    Containers::String out;
+    Debug{&out} << (LineLayerSharedFlag::InstancedSegments|LineLayerSharedFlag(0xe0)) << LineLayerSharedFlags{};
+    CORRADE_COMPARE(out, "Ui::LineLayerSharedFlag::InstancedSegments|Ui::LineLayerSharedFlag(0xe0) Ui::LineLayerSharedFlags{}\n");
+}
+
 void LineLayerTest::sharedConfigurationConstruct() {
     LineLayer::Shared::Configuration configuration{3, 5};
     CORRADE_COMPARE(configuration.styleUniformCount(), 3);
@@ -572,12 +625,21 @@ void LineLayerTest::sharedConfigurationSetters() {
     LineLayer::Shared::Configuration configuration{3, 5};
     CORRADE_COMPARE(configuration.capStyle(), LineCapStyle::Square);
     CORRADE_COMPARE(configuration.joinStyle(), LineJoinStyle::Miter);
+    CORRADE_COMPARE(configuration.flags(), LineLayerSharedFlags{});
 
     configuration
         .setCapStyle(LineCapStyle::Butt)
-        .setJoinStyle(LineJoinStyle::Bevel);
+        .setJoinStyle(LineJoinStyle::Bevel)
+        .setFlags(LineLayerSharedFlag::InstancedSegments|LineLayerSharedFlag(0x10));
     CORRADE_COMPARE(configuration.capStyle(), LineCapStyle::Butt);
     CORRADE_COMPARE(configuration.joinStyle(), LineJoinStyle::Bevel);
+    CORRADE_COMPARE(configuration.flags(), LineLayerSharedFlag::InstancedSegments|LineLayerSharedFlag(0x10));
+
+    configuration.clearFlags(LineLayerSharedFlag::InstancedSegments);
+    CORRADE_COMPARE(configuration.flags(), LineLayerSharedFlag(0x10));
+
+    configuration.addFlags(LineLayerSharedFlag::InstancedSegments);
+    CORRADE_COMPARE(configuration.flags(), LineLayerSharedFlag::InstancedSegments|LineLayerSharedFlag(0x10));
 }
 
 void LineLayerTest::sharedConstruct() {
@@ -588,11 +650,13 @@ void LineLayerTest::sharedConstruct() {
     } shared{LineLayer::Shared::Configuration{3, 5}
         .setCapStyle(LineCapStyle::Butt)
         .setJoinStyle(LineJoinStyle::Bevel)
+        .setFlags(LineLayerSharedFlag::InstancedSegments)
     };
     CORRADE_COMPARE(shared.styleUniformCount(), 3);
     CORRADE_COMPARE(shared.styleCount(), 5);
     CORRADE_COMPARE(shared.capStyle(), LineCapStyle::Butt);
     CORRADE_COMPARE(shared.joinStyle(), LineJoinStyle::Bevel);
+    CORRADE_COMPARE(shared.flags(), LineLayerSharedFlag::InstancedSegments);
 }
 
 void LineLayerTest::sharedConstructNoCreate() {
@@ -2018,6 +2082,336 @@ void LineLayerTest::createSetLoopIndicesNeighbors() {
         TestSuite::Compare::Container);
 }
 
+void LineLayerTest::appendStrip() {
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{1}};
+
+    /* Needed in order to be able to call update() */
+    shared.setStyle(LineLayerCommonStyleUniform{},
+        {LineLayerStyleUniform{}},
+        {{}},
+        {});
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    const auto pointIndices = [&](DataHandle data) {
+        const Implementation::LineLayerRun& run = layer.stateData().runs[layer.stateData().data[dataHandleId(data)].run];
+        return Containers::arrayCast<const Containers::Pair<UnsignedInt, UnsignedInt>>(layer.stateData().pointIndices.sliceSize(run.indexOffset, run.indexCount));
+    };
+    const auto points = [&](DataHandle data) {
+        const Implementation::LineLayerRun& run = layer.stateData().runs[layer.stateData().data[dataHandleId(data)].run];
+        return stridedArrayView(layer.stateData().points.sliceSize(run.pointOffset, run.pointCount));
+    };
+
+    Vector2 nodeOffsets[1];
+    Vector2 nodeSizes[1];
+    Float nodeOpacities[1];
+    UnsignedByte nodesEnabled[1]{};
+
+    DataHandle first = layer.createStrip(0, {{1.0f, 0.0f}, {2.0f, 0.0f}}, {}, nodeHandle(0, 1));
+    DataHandle second = layer.createStrip(0, {{5.0f, 0.0f}, {6.0f, 0.0f}, {7.0f, 0.0f}}, {}, nodeHandle(0, 1));
+    {
+        UnsignedInt dataIds[]{0, 1};
+        layer.update(layer.state(), dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, Containers::BitArrayView{nodesEnabled, 0, 1}, {}, {}, {}, {});
+        CORRADE_COMPARE(layer.state(), LayerStates{});
+    }
+
+    /* Appending to a strip that isn't the last run moves it to the end */
+    layer.appendLineStrip(first, {{3.0f, 0.0f}, {4.0f, 0.0f}}, {0xff0000_rgbf, 0x00ff00_rgbf});
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    CORRADE_COMPARE(layer.pointCount(first), 4);
+    CORRADE_COMPARE(layer.indexCount(first), 6);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().data).slice(&Implementation::LineLayerData::run), Containers::arrayView({
+        2u, 1u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().runs).slice(&Implementation::LineLayerRun::indexOffset), Containers::arrayView({
+        0xffffffffu, 2u, 6u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().runs).slice(&Implementation::LineLayerRun::pointOffset), Containers::arrayView({
+        0xffffffffu, 2u, 5u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().runs).slice(&Implementation::LineLayerRun::joinCount), Containers::arrayView({
+        0u, 2u, 4u
+    }), TestSuite::Compare::Container);
+    Containers::Pair<UnsignedInt, UnsignedInt> expectedPointIndices4[]{
+        {0, 0xffffffffu}, {1, 3},
+        {1, 0}, {2, 5},
+        {2, 2}, {3, 0xffffffffu},
+    };
+    CORRADE_COMPARE_AS(pointIndices(first),
+        Containers::arrayView(expectedPointIndices4),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(points(first).slice(&Implementation::LineLayerPoint::position), Containers::arrayView<Vector2>({
+        {1.0f, 0.0f}, {2.0f, 0.0f}, {3.0f, 0.0f}, {4.0f, 0.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(points(first).slice(&Implementation::LineLayerPoint::color), Containers::arrayView<Color4>({
+        0xffffff_rgbf, 0xffffff_rgbf, 0xff0000_rgbf, 0x00ff00_rgbf
+    }), TestSuite::Compare::Container);
+
+    /* Appending again with a max count drops a point from the front, now the
+       run is updated in place and the indices stay the same */
+    layer.appendLineStrip(dataHandleData(first), {{5.0f, 0.0f}}, {}, 4);
+    CORRADE_COMPARE(layer.pointCount(first), 4);
+    CORRADE_COMPARE(layer.indexCount(first), 6);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(first)].run, 2);
+    CORRADE_COMPARE(layer.stateData().runs[2].pointOffset, 5);
+    CORRADE_COMPARE(layer.stateData().runs[2].joinCount, 4);
+    CORRADE_COMPARE_AS(pointIndices(first),
+        Containers::arrayView(expectedPointIndices4),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(points(first).slice(&Implementation::LineLayerPoint::position), Containers::arrayView<Vector2>({
+        {2.0f, 0.0f}, {3.0f, 0.0f}, {4.0f, 0.0f}, {5.0f, 0.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(points(first).slice(&Implementation::LineLayerPoint::color), Containers::arrayView<Color4>({
+        0xffffff_rgbf, 0xff0000_rgbf, 0x00ff00_rgbf, 0xffffff_rgbf
+    }), TestSuite::Compare::Container);
+
+    /* Appending more points than the max count takes just the last ones,
+       dropping all existing */
+    layer.appendLineStrip(first, {{6.0f, 0.0f}, {7.0f, 0.0f}, {8.0f, 0.0f}, {9.0f, 0.0f}, {10.0f, 0.0f}}, {}, 3);
+    CORRADE_COMPARE(layer.pointCount(first), 3);
+    CORRADE_COMPARE(layer.indexCount(first), 4);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(first)].run, 2);
+    CORRADE_COMPARE(layer.stateData().runs[2].joinCount, 2);
+    Containers::Pair<UnsignedInt, UnsignedInt> expectedPointIndices3[]{
+        {0, 0xffffffffu}, {1, 3},
+        {1, 0}, {2, 0xffffffffu},
+    };
+    CORRADE_COMPARE_AS(pointIndices(first),
+        Containers::arrayView(expectedPointIndices3),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(points(first).slice(&Implementation::LineLayerPoint::position), Containers::arrayView<Vector2>({
+        {8.0f, 0.0f}, {9.0f, 0.0f}, {10.0f, 0.0f}
+    }), TestSuite::Compare::Container);
+
+    /* Appending to an empty strip point by point, the run is the last one so
+       it's grown in place. A single point isn't drawn. */
+    DataHandle third = layer.createStrip(0, {}, {}, nodeHandle(0, 1));
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(third)].run, 3);
+    layer.appendLineStrip(third, {{0.0f, 1.0f}}, {});
+    CORRADE_COMPARE(layer.pointCount(third), 1);
+    CORRADE_COMPARE(layer.indexCount(third), 0);
+    CORRADE_COMPARE(layer.stateData().runs[3].joinCount, 0);
+    layer.appendLineStrip(third, {{0.0f, 2.0f}}, {});
+    CORRADE_COMPARE(layer.pointCount(third), 2);
+    CORRADE_COMPARE(layer.indexCount(third), 2);
+    CORRADE_COMPARE(layer.stateData().runs[3].joinCount, 0);
+    layer.appendLineStrip(third, {{0.0f, 3.0f}}, {});
+    CORRADE_COMPARE(layer.pointCount(third), 3);
+    CORRADE_COMPARE(layer.indexCount(third), 4);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(third)].run, 3);
+    CORRADE_COMPARE(layer.stateData().runs[3].joinCount, 2);
+    CORRADE_COMPARE_AS(pointIndices(third),
+        Containers::arrayView(expectedPointIndices3),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(points(third).slice(&Implementation::LineLayerPoint::position), Containers::arrayView<Vector2>({
+        {0.0f, 1.0f}, {0.0f, 2.0f}, {0.0f, 3.0f}
+    }), TestSuite::Compare::Container);
+
+    /* The update recompacts the runs and generates vertex and index data for
+       all three strips, each having two segments and two joins */
+    {
+        UnsignedInt dataIds[]{0, 1, 2};
+        layer.update(layer.state(), dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, Containers::BitArrayView{nodesEnabled, 0, 1}, {}, {}, {}, {});
+        CORRADE_COMPARE(layer.state(), LayerStates{});
+    }
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().data).slice(&Implementation::LineLayerData::run), Containers::arrayView({
+        1u, 0u, 2u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 3*4*2);
+    CORRADE_COMPARE(layer.stateData().indices.size(), 3*(2*6 + 2*3));
+
+    /* Appending nothing does nothing */
+    layer.appendLineStrip(second, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+    CORRADE_COMPARE(layer.pointCount(second), 3);
+
+    /* Appending nothing but with a smaller max count drops points */
+    layer.appendLineStrip(second, {}, {}, 2);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    CORRADE_COMPARE(layer.pointCount(second), 2);
+    CORRADE_COMPARE(layer.indexCount(second), 2);
+    CORRADE_COMPARE_AS(points(second).slice(&Implementation::LineLayerPoint::position), Containers::arrayView<Vector2>({
+        {6.0f, 0.0f}, {7.0f, 0.0f}
+    }), TestSuite::Compare::Container);
+
+    /* The strip wasn't the last run, so it got moved to the end instead of
+       shrinking in place and leaving a gap that the recompaction wouldn't
+       handle */
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(second)].run, 3);
+    CORRADE_COMPARE(layer.stateData().runs[0].pointOffset, 0xffffffffu);
+    {
+        UnsignedInt dataIds[]{0, 1, 2};
+        layer.update(layer.state(), dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, Containers::BitArrayView{nodesEnabled, 0, 1}, {}, {}, {}, {});
+        CORRADE_COMPARE(layer.state(), LayerStates{});
+    }
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().data).slice(&Implementation::LineLayerData::run), Containers::arrayView({
+        0u, 2u, 1u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(points(second).slice(&Implementation::LineLayerPoint::position), Containers::arrayView<Vector2>({
+        {6.0f, 0.0f}, {7.0f, 0.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), (2 + 1 + 2)*4);
+    CORRADE_COMPARE(layer.stateData().indices.size(), 2*(2*6 + 2*3) + 6);
+}
+
+void LineLayerTest::createSetShared() {
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{1}};
+
+    shared.setStyle(LineLayerCommonStyleUniform{},
+        {LineLayerStyleUniform{}},
+        {LineAlignment::TopLeft},
+        {});
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    CORRADE_COMPARE(layer.sharedPointCount(), 0);
+
+    layer.setSharedPoints({{0.0f, 0.0f}, {2.0f, 0.0f}, {2.0f, 2.0f}, {0.0f, 2.0f}}, {});
+    CORRADE_COMPARE(layer.sharedPointCount(), 4);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Two segments sharing a point, which is thus a join, and a standalone
+       segment, with a line that has its own points in between to verify the
+       two can be mixed */
+    DataHandle edges = layer.createShared(0, {0, 1, 1, 2}, nodeHandle(0, 1));
+    DataHandle local = layer.createStrip(0, {{5.0f, 5.0f}, {6.0f, 6.0f}}, {}, nodeHandle(0, 1));
+    DataHandle edge = layer.createShared(0, {2, 3}, nodeHandle(0, 1));
+    CORRADE_COMPARE(layer.indexCount(edges), 4);
+    CORRADE_COMPARE(layer.pointCount(edges), 0);
+    CORRADE_COMPARE(layer.indexCount(edge), 2);
+    CORRADE_COMPARE(layer.pointCount(edge), 0);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().runs).slice(&Implementation::LineLayerRun::joinCount), Containers::arrayView({
+        2u, 0u, 0u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS((Containers::arrayCast<Containers::Pair<UnsignedInt, UnsignedInt>>(layer.stateData().pointIndices)), (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        /* edges */
+        {0, 0xffffffffu}, {1, 3}, {1, 0}, {2, 0xffffffffu},
+        /* local */
+        {0, 0xffffffffu}, {1, 0xffffffffu},
+        /* edge */
+        {2, 0xffffffffu}, {3, 0xffffffffu},
+    })), TestSuite::Compare::Container);
+
+    Vector2 nodeOffsets[1]{{10.0f, 20.0f}};
+    Vector2 nodeSizes[1]{{5.0f, 5.0f}};
+    Float nodeOpacities[1]{1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 1};
+    UnsignedInt dataIds[]{0, 1, 2};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().vertices).slice(&Implementation::LineLayerVertex::position), Containers::arrayView<Vector2>({
+        /* edges */
+        {10.0f, 20.0f}, {10.0f, 20.0f}, {12.0f, 20.0f}, {12.0f, 20.0f},
+        {12.0f, 20.0f}, {12.0f, 20.0f}, {12.0f, 22.0f}, {12.0f, 22.0f},
+        /* local */
+        {15.0f, 25.0f}, {15.0f, 25.0f}, {16.0f, 26.0f}, {16.0f, 26.0f},
+        /* edge */
+        {12.0f, 22.0f}, {12.0f, 22.0f}, {10.0f, 22.0f}, {10.0f, 22.0f},
+    }), TestSuite::Compare::Container);
+
+    /* Moving a single point updates all lines referencing it */
+    layer.setSharedPoint(1, {3.0f, -1.0f});
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    layer.setSharedPoint(2, {2.0f, 2.0f}, 0xff000099_rgbaf);
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().vertices).slice(&Implementation::LineLayerVertex::position).prefix(8), Containers::arrayView<Vector2>({
+        {10.0f, 20.0f}, {10.0f, 20.0f}, {13.0f, 19.0f}, {13.0f, 19.0f},
+        {13.0f, 19.0f}, {13.0f, 19.0f}, {12.0f, 22.0f}, {12.0f, 22.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().vertices).slice(&Implementation::LineLayerVertex::color).exceptPrefix(12), Containers::arrayView<Color4>({
+        0xff000099_rgbaf, 0xff000099_rgbaf, 0xffffffff_rgbaf, 0xffffffff_rgbaf
+    }), TestSuite::Compare::Container);
+
+    /* Setting a line with its own points makes it not reference the shared
+       points anymore ... */
+    layer.setLineStrip(edge, {{1.0f, 1.0f}, {2.0f, 3.0f}}, {});
+    CORRADE_COMPARE(layer.pointCount(edge), 2);
+    CORRADE_VERIFY(!layer.stateData().data[dataHandleId(edge)].sharedPoints);
+
+    /* ... and vice versa */
+    layer.setLineShared(local, {3, 0});
+    CORRADE_COMPARE(layer.pointCount(local), 0);
+    CORRADE_VERIFY(layer.stateData().data[dataHandleId(local)].sharedPoints);
+
+    /* The other overload, reusing the existing run */
+    UnsignedInt edgesRun = layer.stateData().data[dataHandleId(edges)].run;
+    layer.setLineShared(dataHandleData(edges), {3, 2, 2, 1});
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(edges)].run, edgesRun);
+
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    /* The edges run got reused, the other two were recreated in order edge,
+       local, which is also the order after recompaction */
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().vertices).slice(&Implementation::LineLayerVertex::position), Containers::arrayView<Vector2>({
+        /* edges */
+        {10.0f, 22.0f}, {10.0f, 22.0f}, {12.0f, 22.0f}, {12.0f, 22.0f},
+        {12.0f, 22.0f}, {12.0f, 22.0f}, {13.0f, 19.0f}, {13.0f, 19.0f},
+        /* edge */
+        {11.0f, 21.0f}, {11.0f, 21.0f}, {12.0f, 23.0f}, {12.0f, 23.0f},
+        /* local */
+        {10.0f, 22.0f}, {10.0f, 22.0f}, {10.0f, 20.0f}, {10.0f, 20.0f},
+    }), TestSuite::Compare::Container);
+}
+
+void LineLayerTest::fillStripIndexRange() {
+    auto&& data = FillStripIndexRangeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* The SIMD variant, if any, should produce the same output as the scalar
+       one, and neither should touch the items outside of the range. The
+       scalar output is tested in createSetStripIndicesNeighbors() and
+       createSetLoopIndicesNeighbors() already. */
+
+    Implementation::LineLayerPointIndex expected[20];
+    Implementation::LineLayerPointIndex actual[20];
+    for(std::size_t i = 0; i != Containers::arraySize(expected); ++i)
+        expected[i] = actual[i] = {0xcdcdcdcd, 0xcdcdcdcd};
+
+    Implementation::fillLineStripIndexRangeScalar(expected, data.begin, data.end);
+    Implementation::fillLineStripIndexRange(actual, data.begin, data.end);
+
+    CORRADE_COMPARE_AS(
+        (Containers::arrayCast<Containers::Pair<UnsignedInt, UnsignedInt>>(Containers::arrayView(actual))),
+        (Containers::arrayCast<Containers::Pair<UnsignedInt, UnsignedInt>>(Containers::arrayView(expected))),
+        TestSuite::Compare::Container);
+
+    /* Verify a few items to be sure the tested variant is not broken in the
+       same way as the reference */
+    if(data.begin <= 6 && data.end > 7) {
+        CORRADE_COMPARE(actual[6].index, 3);
+        CORRADE_COMPARE(actual[6].neighbor, 4);
+        CORRADE_COMPARE(actual[7].index, 4);
+        CORRADE_COMPARE(actual[7].neighbor, 9);
+    }
+}
+
 void LineLayerTest::createStyleOutOfRange() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -2092,6 +2486,78 @@ void LineLayerTest::setColor() {
     layer.setColor(dataHandleData(data), 0x11223344_rgbaf);
     CORRADE_COMPARE(layer.color(dataHandleData(data)), 0x11223344_rgbaf);
     CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    DataHandle data2 = layer.create(0, {}, {}, {});
+    DataHandle data3 = layer.create(0, {}, {}, {});
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting an empty list doesn't mark the layer as dirty */
+    layer.setColor(Containers::StridedArrayView1D<const DataHandle>{}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting multiple colors at once, data not in the list are left
+       untouched */
+    DataHandle handles[]{data3, data};
+    Color4 colors[]{0x99887766_rgbaf, 0x55443322_rgbaf};
+    layer.setColor(handles, colors);
+    CORRADE_COMPARE(layer.color(data), 0x55443322_rgbaf);
+    CORRADE_COMPARE(layer.color(data2), 0xffffffff_rgbaf);
+    CORRADE_COMPARE(layer.color(data3), 0x99887766_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    LayerDataHandle layerHandles[]{dataHandleData(data2)};
+    Color4 layerColors[]{0x12345678_rgbaf};
+    layer.setColor(layerHandles, layerColors);
+    CORRADE_COMPARE(layer.color(data2), 0x12345678_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void LineLayerTest::setColorMultipleInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{1}};
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle data = layer.create(0, {}, {}, {});
+
+    DataHandle handles[]{data, DataHandle::Null};
+    LayerDataHandle layerHandles[]{dataHandleData(data), LayerDataHandle::Null};
+    Color4 colors[2];
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.setColor(handles, Containers::arrayView(colors).prefix(1));
+    layer.setColor(layerHandles, Containers::arrayView(colors).prefix(1));
+    layer.setColor(handles, colors);
+    layer.setColor(layerHandles, colors);
+    CORRADE_COMPARE_AS(out,
+        "Ui::LineLayer::setColor(): expected handle and color views to have the same size but got 2 and 1\n"
+        "Ui::LineLayer::setColor(): expected handle and color views to have the same size but got 2 and 1\n"
+        "Ui::LineLayer::setColor(): invalid handle Ui::DataHandle::Null at index 1\n"
+        "Ui::LineLayer::setColor(): invalid handle Ui::LayerDataHandle::Null at index 1\n",
+        TestSuite::Compare::String);
+
+    /* The valid handle isn't updated if any other is invalid */
+    CORRADE_COMPARE(layer.color(data), 0xffffffff_rgbaf);
 }
 
 void LineLayerTest::setAlignment() {
@@ -2218,6 +2684,54 @@ void LineLayerTest::setPadding() {
     CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
 }
 
+void LineLayerTest::setDecimationTolerance() {
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{1}};
+
+    /* Needed in order to be able to call update() */
+    shared.setStyle(LineLayerCommonStyleUniform{},
+        {LineLayerStyleUniform{}},
+        {{}},
+        {});
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* Just to be sure the setters aren't picking up the first ever data
+       always */
+    layer.create(0, {}, {}, {});
+
+    DataHandle data = layer.create(0, {}, {}, {});
+    CORRADE_COMPARE(layer.decimationTolerance(data), 0.0f);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting a tolerance marks the layer as dirty */
+    layer.setDecimationTolerance(data, 0.75f);
+    CORRADE_COMPARE(layer.decimationTolerance(data), 0.75f);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    layer.setDecimationTolerance(dataHandleData(data), 2.5f);
+    CORRADE_COMPARE(layer.decimationTolerance(dataHandleData(data)), 2.5f);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
 void LineLayerTest::invalidHandle() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -2243,6 +2757,10 @@ void LineLayerTest::invalidHandle() {
     layer.setLineStrip(LayerDataHandle::Null, {}, {});
     layer.setLineLoop(DataHandle::Null, {}, {});
     layer.setLineLoop(LayerDataHandle::Null, {}, {});
+    layer.appendLineStrip(DataHandle::Null, {}, {});
+    layer.appendLineStrip(LayerDataHandle::Null, {}, {});
+    layer.setLineShared(DataHandle::Null, {});
+    layer.setLineShared(LayerDataHandle::Null, {});
     layer.color(DataHandle::Null);
     layer.color(LayerDataHandle::Null);
     layer.setColor(DataHandle::Null, {});
@@ -2255,6 +2773,10 @@ void LineLayerTest::invalidHandle() {
     layer.padding(LayerDataHandle::Null);
     layer.setPadding(DataHandle::Null, {});
     layer.setPadding(LayerDataHandle::Null, {});
+    layer.decimationTolerance(DataHandle::Null);
+    layer.decimationTolerance(LayerDataHandle::Null);
+    layer.setDecimationTolerance(DataHandle::Null, {});
+    layer.setDecimationTolerance(LayerDataHandle::Null, {});
     CORRADE_COMPARE_AS(out,
         "Ui::LineLayer::indexCount(): invalid handle Ui::DataHandle::Null\n"
         "Ui::LineLayer::indexCount(): invalid handle Ui::LayerDataHandle::Null\n"
@@ -2266,6 +2788,10 @@ void LineLayerTest::invalidHandle() {
         "Ui::LineLayer::setLineStrip(): invalid handle Ui::LayerDataHandle::Null\n"
         "Ui::LineLayer::setLineLoop(): invalid handle Ui::DataHandle::Null\n"
         "Ui::LineLayer::setLineLoop(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::LineLayer::appendLineStrip(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::LineLayer::appendLineStrip(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::LineLayer::setLineShared(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::LineLayer::setLineShared(): invalid handle Ui::LayerDataHandle::Null\n"
         "Ui::LineLayer::color(): invalid handle Ui::DataHandle::Null\n"
         "Ui::LineLayer::color(): invalid handle Ui::LayerDataHandle::Null\n"
         "Ui::LineLayer::setColor(): invalid handle Ui::DataHandle::Null\n"
@@ -2277,7 +2803,11 @@ void LineLayerTest::invalidHandle() {
         "Ui::LineLayer::padding(): invalid handle Ui::DataHandle::Null\n"
         "Ui::LineLayer::padding(): invalid handle Ui::LayerDataHandle::Null\n"
         "Ui::LineLayer::setPadding(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::LineLayer::setPadding(): invalid handle Ui::LayerDataHandle::Null\n",
+        "Ui::LineLayer::setPadding(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::LineLayer::decimationTolerance(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::LineLayer::decimationTolerance(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::LineLayer::setDecimationTolerance(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::LineLayer::setDecimationTolerance(): invalid handle Ui::LayerDataHandle::Null\n",
         TestSuite::Compare::String);
 }
 
@@ -2307,8 +2837,8 @@ void LineLayerTest::createSetInvalid() {
 
     /* Supplying no colors is okay */
     layer.create(0, indices, points, {});
-    layer.createStrip(0, points, {});
-    layer.createLoop(0, points, {});
+    DataHandle strip = layer.createStrip(0, points, {});
+    DataHandle loop = layer.createLoop(0, points, {});
 
     Containers::String out;
     Error redirectError{&out};
@@ -2334,6 +2864,17 @@ void LineLayerTest::createSetInvalid() {
     layer.createLoop(0, twoPoints, {});
     layer.setLineLoop(data, twoPoints, {});
     layer.setLineLoop(dataHandleData(data), twoPoints, {});
+    layer.appendLineStrip(strip, points, colorsWrong);
+    layer.appendLineStrip(dataHandleData(strip), points, colorsWrong);
+    layer.appendLineStrip(strip, points, {}, 1);
+    layer.appendLineStrip(loop, points, {});
+    layer.setDecimationTolerance(strip, -0.5f);
+    layer.setDecimationTolerance(dataHandleData(strip), -0.5f);
+    layer.setSharedPoints(points, {});
+    layer.setSharedPoints(twoPoints, {});
+    layer.setSharedPoints(points, colorsWrong);
+    layer.setSharedPoint(5, {});
+    layer.setSharedPoint(5, {}, {});
     CORRADE_COMPARE_AS(out,
         "Ui::LineLayer::create(): expected index count to be divisible by 2 but got 7\n"
         "Ui::LineLayer::setLine(): expected index count to be divisible by 2 but got 7\n"
@@ -2352,7 +2893,17 @@ void LineLayerTest::createSetInvalid() {
         "Ui::LineLayer::setLineStrip(): expected either no or at least two points, got 1\n"
         "Ui::LineLayer::createLoop(): expected either no, one or at least three points, got 2\n"
         "Ui::LineLayer::setLineLoop(): expected either no, one or at least three points, got 2\n"
-        "Ui::LineLayer::setLineLoop(): expected either no, one or at least three points, got 2\n",
+        "Ui::LineLayer::setLineLoop(): expected either no, one or at least three points, got 2\n"
+        "Ui::LineLayer::appendLineStrip(): expected either no or 5 colors, got 6\n"
+        "Ui::LineLayer::appendLineStrip(): expected either no or 5 colors, got 6\n"
+        "Ui::LineLayer::appendLineStrip(): expected max point count to be at least 2, got 1\n"
+        "Ui::LineLayer::appendLineStrip(): expected a line strip but got 5 points and 10 indices\n"
+        "Ui::LineLayer::setDecimationTolerance(): expected a non-negative tolerance, got -0.5\n"
+        "Ui::LineLayer::setDecimationTolerance(): expected a non-negative tolerance, got -0.5\n"
+        "Ui::LineLayer::setSharedPoints(): expected at least 5 points, got 2\n"
+        "Ui::LineLayer::setSharedPoints(): expected either no or 5 colors, got 6\n"
+        "Ui::LineLayer::setSharedPoint(): index 5 out of range for 5 points\n"
+        "Ui::LineLayer::setSharedPoint(): index 5 out of range for 5 points\n",
         TestSuite::Compare::String);
 }
 
@@ -2378,10 +2929,16 @@ void LineLayerTest::createSetIndicesOutOfRange() {
     layer.create(0, {0, 2, 3, 1, 0, 4, 2, 1}, {{}, {}, {}, {}}, {});
     layer.setLine(data, {0, 2, 3, 1, 0, 4, 2, 1}, {{}, {}, {}, {}}, {});
     layer.setLine(dataHandleData(data), {0, 2, 3, 1, 0, 4, 2, 1}, {{}, {}, {}, {}}, {});
-    CORRADE_COMPARE_AS(out,
+    layer.setSharedPoints({{}, {}, {}}, {});
+    layer.createShared(0, {0, 2, 3, 1});
+    layer.setLineShared(data, {0, 2, 3, 1});
+    layer.setLineShared(dataHandleData(data), {0, 2, 3, 1});
         "Ui::LineLayer::create(): index 4 out of range for 4 points at index 5\n"
         "Ui::LineLayer::setLine(): index 4 out of range for 4 points at index 5\n"
-        "Ui::LineLayer::setLine(): index 4 out of range for 4 points at index 5\n",
+        "Ui::LineLayer::setLine(): index 4 out of range for 4 points at index 5\n"
+        "Ui::LineLayer::createShared(): index 3 out of range for 3 points at index 2\n"
+        "Ui::LineLayer::setLineShared(): index 3 out of range for 3 points at index 2\n"
+        "Ui::LineLayer::setLineShared(): index 3 out of range for 3 points at index 2\n",
         TestSuite::Compare::String);
 }
 
@@ -3298,6 +3855,326 @@ void LineLayerTest::updatePadding() {
     }), TestSuite::Compare::Container);
 }
 
+void LineLayerTest::updateCompactionLargeData() {
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{1}};
+
+    shared.setStyle(LineLayerCommonStyleUniform{},
+        {LineLayerStyleUniform{}},
+        {LineAlignment::TopLeft},
+        {});
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* A large strip at the front to get over the threshold where the data are
+       recompacted on every update, a strip that's going to be changed and a
+       few more to not have the run count trigger the recompaction */
+    Containers::Array<Vector2> largePoints{ValueInit, Implementation::RunCompactionMinSize};
+    DataHandle large = layer.createStrip(0, stridedArrayView(largePoints), {});
+    DataHandle changed = layer.createStrip(0, {{0.0f, 0.0f}, {1.0f, 0.0f}}, {});
+    for(std::size_t i = 0; i != 6; ++i)
+        layer.createStrip(0, {{0.0f, 1.0f}, {1.0f, 1.0f}}, {});
+    CORRADE_COMPARE(layer.stateData().runs.size(), 8);
+    CORRADE_COMPARE(layer.stateData().points.size(), Implementation::RunCompactionMinSize + 2 + 6*2);
+    CORRADE_COMPARE(layer.stateData().pointIndices.size(), Implementation::RunCompactionMinSize*2 - 2 + 2 + 6*2);
+
+    /* Changing the point count marks the original run as unused and puts a
+       new one at the end */
+    layer.setLineStrip(changed, {{0.0f, 0.0f}, {1.0f, 0.0f}, {2.0f, 0.0f}}, {});
+    CORRADE_COMPARE(layer.stateData().runs.size(), 9);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(changed)].run, 8);
+    CORRADE_COMPARE(layer.stateData().runs[1].pointOffset, ~UnsignedInt{});
+    CORRADE_COMPARE(layer.stateData().unusedRunCount, 1);
+    CORRADE_COMPARE(layer.stateData().unusedPointCount, 2);
+    CORRADE_COMPARE(layer.stateData().unusedPointIndexCount, 2);
+
+    /* The unused portion is small, so update() doesn't recompact. The vertex
+       data include the unused space as well, as they're indexed by the point
+       index offset. */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().runs.size(), 9);
+    CORRADE_COMPARE(layer.stateData().points.size(), Implementation::RunCompactionMinSize + 2 + 6*2 + 3);
+    CORRADE_COMPARE(layer.stateData().pointIndices.size(), Implementation::RunCompactionMinSize*2 - 2 + 2 + 6*2 + 4);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), (Implementation::RunCompactionMinSize*2 - 2 + 2 + 6*2 + 4)*2);
+    CORRADE_COMPARE(layer.stateData().unusedRunCount, 1);
+    CORRADE_COMPARE(layer.stateData().unusedPointCount, 2);
+    CORRADE_COMPARE(layer.stateData().unusedPointIndexCount, 2);
+
+    /* Removing the large strip makes most of the data unused, so the next
+       update() recompacts everything */
+    layer.remove(large);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().runs).slice(&Implementation::LineLayerRun::pointOffset), Containers::arrayView({
+        0u, 2u, 4u, 6u, 8u, 10u, 12u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().runs).slice(&Implementation::LineLayerRun::indexOffset), Containers::arrayView({
+        0u, 2u, 4u, 6u, 8u, 10u, 12u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.stateData().points.size(), 6*2 + 3);
+    CORRADE_COMPARE(layer.stateData().pointIndices.size(), 6*2 + 4);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), (6*2 + 4)*2);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(changed)].run, 6);
+    CORRADE_COMPARE(layer.pointCount(changed), 3);
+    CORRADE_COMPARE(layer.stateData().unusedRunCount, 0);
+    CORRADE_COMPARE(layer.stateData().unusedPointCount, 0);
+    CORRADE_COMPARE(layer.stateData().unusedPointIndexCount, 0);
+}
+
+void LineLayerTest::updateInstancedSegments() {
+    /* Verifies just the instance data generation, the visual output is
+       checked in LineLayerGLTest */
+
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{2}
+        .setFlags(LineLayerSharedFlag::InstancedSegments)};
+
+    shared.setStyle(LineLayerCommonStyleUniform{},
+        {LineLayerStyleUniform{}, LineLayerStyleUniform{}},
+        {LineAlignment::TopLeft, LineAlignment::BottomRight},
+        {});
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* One join in the middle and two caps */
+    DataHandle strip = layer.createStrip(1,
+        {{1.0f, 2.0f}, {3.0f, 4.0f}, {5.0f, 6.0f}}, {}, nodeHandle(1, 0));
+    /* Three joins and no caps */
+    layer.createLoop(0,
+        {{-1.0f, -1.0f}, {1.0f, -1.0f}, {0.0f, 1.0f}},
+        {0xff0000_rgbf, 0x00ff00_rgbf, 0x0000ff_rgbf}, nodeHandle(0, 0));
+    layer.setColor(strip, 0xff336699_rgbaf);
+
+    Vector2 nodeOffsets[2]{
+        {3.0f, 4.0f},
+        {10.0f, 20.0f}
+    };
+    Vector2 nodeSizes[2]{
+        {},
+        {4.0f, 6.0f}
+    };
+    Float nodeOpacities[2]{
+        1.0f,
+        0.5f
+    };
+    UnsignedByte nodesEnabledData[1]{0x3};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 2};
+
+    /* The loop is drawn first, then the strip */
+    UnsignedInt dataIds[]{1, 0};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* No vertices or indices get generated, the draw offsets point to the
+       instances */
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 0);
+    CORRADE_COMPARE(layer.stateData().indices.size(), 0);
+    CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, Containers::arrayView<UnsignedInt>({
+        0, 3, 5
+    }), TestSuite::Compare::Container);
+
+    constexpr UnsignedInt Join0 = Implementation::LineSegmentAnnotationJoin0;
+    constexpr UnsignedInt Join1 = Implementation::LineSegmentAnnotationJoin1;
+    constexpr UnsignedInt EmitJoin0 = Implementation::LineSegmentAnnotationEmitJoin0;
+    constexpr UnsignedInt EmitJoin1 = Implementation::LineSegmentAnnotationEmitJoin1;
+    constexpr UnsignedInt NeighborBegin1 = Implementation::LineSegmentAnnotationNeighborBegin1;
+    /* The joins get emitted by the same segments as in the indexed case, i.e.
+       the first loop segment emits both and the second one just at its end.
+       None of the neighbor points closer to the first segment ends is a first
+       point of the neighbor segment. */
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().instances).slice(&Implementation::LineLayerSegmentInstance::annotationStyleUniform), Containers::arrayView<UnsignedInt>({
+        /* Loop, uniform 0 */
+        (0 << 6)|Join0|EmitJoin0|Join1|EmitJoin1|NeighborBegin1,
+        (0 << 6)|Join0|Join1|EmitJoin1|NeighborBegin1,
+        (0 << 6)|Join0|Join1|NeighborBegin1,
+        /* Strip, uniform 1 */
+        (1 << 6)|Join1|EmitJoin1|NeighborBegin1,
+        (1 << 6)|Join0,
+    }), TestSuite::Compare::Container);
+
+    /* The loop is aligned to the top left corner of node 0, the strip to the
+       bottom right of node 1, which is {14, 26} */
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().instances).slice(&Implementation::LineLayerSegmentInstance::position0), Containers::arrayView<Vector2>({
+        {2.0f, 3.0f},
+        {4.0f, 3.0f},
+        {3.0f, 5.0f},
+        {15.0f, 28.0f},
+        {17.0f, 30.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().instances).slice(&Implementation::LineLayerSegmentInstance::position1), Containers::arrayView<Vector2>({
+        {4.0f, 3.0f},
+        {3.0f, 5.0f},
+        {2.0f, 3.0f},
+        {17.0f, 30.0f},
+        {19.0f, 32.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().instances).slice(&Implementation::LineLayerSegmentInstance::previousPosition), Containers::arrayView<Vector2>({
+        {3.0f, 5.0f},
+        {2.0f, 3.0f},
+        {4.0f, 3.0f},
+        {14.0f, 26.0f}, /* unused, just the shift alone */
+        {15.0f, 28.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().instances).slice(&Implementation::LineLayerSegmentInstance::nextPosition), Containers::arrayView<Vector2>({
+        {3.0f, 5.0f},
+        {2.0f, 3.0f},
+        {4.0f, 3.0f},
+        {19.0f, 32.0f},
+        {14.0f, 26.0f}, /* unused, just the shift alone */
+    }), TestSuite::Compare::Container);
+    /* Per-point colors multiplied by the per-data color and node opacity */
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().instances).slice(&Implementation::LineLayerSegmentInstance::color0), Containers::arrayView<Color4>({
+        0xff0000_rgbf,
+        0x00ff00_rgbf,
+        0x0000ff_rgbf,
+        0xff336699_rgbaf*0.5f,
+        0xff336699_rgbaf*0.5f,
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().instances).slice(&Implementation::LineLayerSegmentInstance::color1), Containers::arrayView<Color4>({
+        0x00ff00_rgbf,
+        0x0000ff_rgbf,
+        0xff0000_rgbf,
+        0xff336699_rgbaf*0.5f,
+        0xff336699_rgbaf*0.5f,
+    }), TestSuite::Compare::Container);
+
+    /* The instances are in draw order, so a node order change alone
+       regenerates them */
+    UnsignedInt dataIdsStripOnly[]{0};
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIdsStripOnly, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, Containers::arrayView<UnsignedInt>({
+        0, 2
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().instances).slice(&Implementation::LineLayerSegmentInstance::position0), Containers::arrayView<Vector2>({
+        {15.0f, 28.0f},
+        {17.0f, 30.0f},
+    }), TestSuite::Compare::Container);
+}
+
+void LineLayerTest::updateDecimation() {
+    /* Verifies just the decimated index generation, the visual output is
+       the same as with a line strip made out of the kept points */
+
+    struct LayerShared: LineLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): LineLayer::Shared{configuration} {}
+
+        void doSetStyle(const LineLayerCommonStyleUniform&, Containers::ArrayView<const LineLayerStyleUniform>) override {}
+    } shared{LineLayer::Shared::Configuration{1}};
+
+    shared.setStyle(LineLayerCommonStyleUniform{},
+        {LineLayerStyleUniform{}},
+        {LineAlignment::TopLeft},
+        {});
+
+    struct Layer: LineLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): LineLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* One pixel is one UI unit */
+    layer.setSize({100, 100}, {100, 100});
+
+    /* The second point is 0.1 units off the line between the first and the
+       third, which gets dropped, the third is ~1.1 units off the line between
+       the first and the fourth, and the fourth is 2 units off the line
+       between the first and last */
+    DataHandle strip = layer.createStrip(0,
+        {{0.0f, 0.0f}, {1.0f, 0.1f}, {2.0f, 0.0f}, {3.0f, 2.0f}, {4.0f, 0.0f}}, {});
+    /* A loop isn't an open chain, so it's never decimated */
+    DataHandle loop = layer.createLoop(0,
+        {{0.0f, 0.0f}, {1.0f, 0.01f}, {2.0f, 0.0f}, {1.0f, 1.0f}}, {});
+    layer.setDecimationTolerance(strip, 0.5f);
+    layer.setDecimationTolerance(loop, 0.5f);
+
+    Vector2 nodeOffsets[1]{};
+    Vector2 nodeSizes[1]{};
+    Float nodeOpacities[1]{1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 1};
+
+    UnsignedInt dataIds[]{0, 1};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* The strip drops the second point, the loop is left as is */
+    CORRADE_COMPARE(layer.stateData().runs[0].decimatedIndexOffset, 0);
+    CORRADE_COMPARE(layer.stateData().runs[0].decimatedIndexCount, 6);
+    CORRADE_COMPARE(layer.stateData().runs[1].decimatedIndexOffset, ~UnsignedInt{});
+    CORRADE_COMPARE_AS((Containers::arrayCast<Containers::Pair<UnsignedInt, UnsignedInt>>(layer.stateData().decimatedPointIndices)), (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 0xffffffffu}, {2, 3},
+        {2, 0}, {3, 5},
+        {3, 2}, {4, 0xffffffffu}
+    })), TestSuite::Compare::Container);
+
+    /* Three segments with two joins for the strip, four segments with four
+       joins for the loop */
+    CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, Containers::arrayView<UnsignedInt>({
+        0, 3*6 + 2*3, 3*6 + 2*3 + 4*6 + 8*3
+    }), TestSuite::Compare::Container);
+    /* The vertex data are still sized for the original strip, the decimated
+       strip using just a prefix of them */
+    CORRADE_COMPARE(layer.stateData().vertices.size(), (8 + 8)*2);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().vertices).prefix(6*2).slice(&Implementation::LineLayerVertex::position), Containers::arrayView<Vector2>({
+        {0.0f, 0.0f}, {0.0f, 0.0f}, {2.0f, 0.0f}, {2.0f, 0.0f},
+        {2.0f, 0.0f}, {2.0f, 0.0f}, {3.0f, 2.0f}, {3.0f, 2.0f},
+        {3.0f, 2.0f}, {3.0f, 2.0f}, {4.0f, 0.0f}, {4.0f, 0.0f}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting the same size again doesn't trigger anything */
+    layer.setSize({100, 100}, {100, 100});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Making pixels 2.5 times larger makes the tolerance 1.25 units, which
+       drops also the third point, leaving a single segment */
+    layer.setSize({250, 250}, {100, 100});
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().runs[0].decimatedIndexCount, 4);
+    CORRADE_COMPARE_AS((Containers::arrayCast<Containers::Pair<UnsignedInt, UnsignedInt>>(layer.stateData().decimatedPointIndices)), (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 0xffffffffu}, {3, 3},
+        {3, 0}, {4, 0xffffffffu}
+    })), TestSuite::Compare::Container);
+
+    /* With a tolerance small enough to keep all points the original indices
+       are used, and nothing is decimated anymore so a size change doesn't
+       trigger an update */
+    layer.setDecimationTolerance(strip, 0.01f);
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().runs[0].decimatedIndexOffset, ~UnsignedInt{});
+    CORRADE_COMPARE(layer.stateData().decimatedPointIndices.size(), 0);
+
+    layer.setSize({100, 100}, {100, 100});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+}
+
 void LineLayerTest::updateNoStyleSet() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -53,8 +53,10 @@ void NodeFlagsTest::debugFlag() {
 
 void NodeFlagsTest::debugFlags() {
     Containers::String out;
-    Debug{&out} << (NodeFlag::Hidden|NodeFlag(0x80)) << NodeFlags{};
-    CORRADE_COMPARE(out, "Ui::NodeFlag::Hidden|Ui::NodeFlag(0x80) Ui::NodeFlags{}\n");
+    /* All bits are used, only the bit that's a part of Disabled can be
+       unknown on its own */
+    Debug{&out} << (NodeFlag::Hidden|NodeFlag(0x08)) << NodeFlags{};
+    CORRADE_COMPARE(out, "Ui::NodeFlag::Hidden|Ui::NodeFlag(0x8) Ui::NodeFlags{}\n");
 }
 
 void NodeFlagsTest::debugFlagsSupersets() {
@@ -26,46 +26,81 @@
 
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Compare/String.h>
+#include <Magnum/Image.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/OpenGLTester.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/Renderer.h>
 #include <Magnum/GL/Texture.h>
-#include <Magnum/Math/Vector4.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Range.h>
 
+#include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/RendererGL.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
 
+using namespace Math::Literals;
+
 struct RendererGLTest: GL::OpenGLTester {
     explicit RendererGLTest();
 
     void construct();
     void constructCompositingFramebuffer();
+    void constructRetainedFramebuffer();
+    void constructCompositingTextureFormat();
+    void constructLayerProfiling();
+    void constructDynamicResolution();
     void constructCopy();
     void constructMove();
 
     void compositingFramebuffer();
     void compositingFramebufferNoFramebufferSizeSet();
+    void compositingContentGeneration();
+    void renderTargetTexture();
+
+    void layerProfiling();
 
     void setupTeardown();
 
     void transition();
     void transitionCompositing();
     void transitionNoScissor();
+    void transitionRetained();
+    void transitionRetainedRenderTargetTexture();
+
+    void drawCache();
 };
 
 RendererGLTest::RendererGLTest() {
     addTests({&RendererGLTest::construct,
               &RendererGLTest::constructCompositingFramebuffer,
+              &RendererGLTest::constructRetainedFramebuffer,
+              &RendererGLTest::constructCompositingTextureFormat,
+              &RendererGLTest::constructLayerProfiling,
+              &RendererGLTest::constructDynamicResolution,
               &RendererGLTest::constructCopy,
               &RendererGLTest::constructMove,
 
               &RendererGLTest::compositingFramebuffer,
-              &RendererGLTest::compositingFramebufferNoFramebufferSizeSet});
+              &RendererGLTest::compositingFramebufferNoFramebufferSizeSet,
+              &RendererGLTest::compositingContentGeneration,
+              &RendererGLTest::renderTargetTexture,
+
+              &RendererGLTest::layerProfiling});
 
     addTests({&RendererGLTest::transition,
               &RendererGLTest::transitionCompositing,
-              &RendererGLTest::transitionNoScissor},
+              &RendererGLTest::transitionNoScissor,
+              &RendererGLTest::transitionRetained,
+              &RendererGLTest::transitionRetainedRenderTargetTexture,
+
+              &RendererGLTest::drawCache},
               &RendererGLTest::setupTeardown,
               &RendererGLTest::setupTeardown);
 }
@@ -74,6 +109,7 @@ void RendererGLTest::construct() {
     RendererGL renderer;
     CORRADE_COMPARE(renderer.flags(), RendererGL::Flags{});
     CORRADE_COMPARE(renderer.features(), RendererFeatures{});
+    CORRADE_COMPARE(renderer.compositingTextureFormat(), GL::TextureFormat::RGBA8);
 }
 
 void RendererGLTest::constructCompositingFramebuffer() {
@@ -84,6 +120,76 @@ void RendererGLTest::constructCompositingFramebuffer() {
     /* Queries tested in compositingFramebuffer() as they need also size set */
 }
 
+void RendererGLTest::constructRetainedFramebuffer() {
+    RendererGL renderer{RendererGL::Flag::RetainedFramebuffer};
+    CORRADE_COMPARE(renderer.flags(), RendererGL::Flag::RetainedFramebuffer);
+    CORRADE_COMPARE(renderer.features(), RendererFeature::PartialRedraw);
+
+    /* The same framebuffer is used as for compositing */
+    renderer.setupFramebuffers({15, 37});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_VERIFY(renderer.compositingFramebuffer().id());
+    CORRADE_COMPARE(renderer.compositingFramebuffer().viewport(), (Range2Di{{}, {15, 37}}));
+    CORRADE_VERIFY(renderer.compositingTexture().id());
+
+    /* Both can be combined */
+    RendererGL both{RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag::RetainedFramebuffer};
+    CORRADE_COMPARE(both.features(), RendererFeature::Composite|RendererFeature::PartialRedraw);
+}
+
+void RendererGLTest::constructCompositingTextureFormat() {
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer, GL::TextureFormat::RGB10A2};
+    CORRADE_COMPARE(renderer.flags(), RendererGL::Flag::CompositingFramebuffer);
+    CORRADE_COMPARE(renderer.compositingTextureFormat(), GL::TextureFormat::RGB10A2);
+
+    /* The texture is created with the format on the first size setup */
+    renderer.setupFramebuffers({15, 37});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_VERIFY(renderer.compositingTexture().id());
+    CORRADE_COMPARE(renderer.compositingFramebuffer().viewport(), (Range2Di{{}, {15, 37}}));
+}
+
+void RendererGLTest::constructLayerProfiling() {
+    RendererGL renderer{RendererGL::Flag::LayerProfiling};
+    CORRADE_COMPARE(renderer.flags(), RendererGL::Flag::LayerProfiling);
+    CORRADE_COMPARE(renderer.features(), RendererFeature::LayerProfiling);
+
+    /* No results are available initially */
+    CORRADE_COMPARE(renderer.layerGpuDuration(layerHandle(3, 0xcf)), 0);
+    CORRADE_COMPARE(renderer.layerDrawCount(layerHandle(3, 0xcf)), 0);
+    #ifndef MAGNUM_TARGET_GLES
+    CORRADE_COMPARE(renderer.layerPrimitiveCount(layerHandle(3, 0xcf)), 0);
+    #endif
+}
+
+void RendererGLTest::constructDynamicResolution() {
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag::LayerProfiling|RendererGL::Flag::DynamicResolution};
+    CORRADE_COMPARE(renderer.flags(), RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag::LayerProfiling|RendererGL::Flag::DynamicResolution);
+    /* No dedicated feature, the layer profiling is what drives it */
+    CORRADE_COMPARE(renderer.features(), RendererFeature::Composite|RendererFeature::LayerProfiling);
+    CORRADE_COMPARE(renderer.dynamicResolutionBudget(), 8000000);
+    CORRADE_COMPARE(renderer.minResolutionScale(), 0.5f);
+    CORRADE_COMPARE(renderer.resolutionScale(), 1.0f);
+
+    renderer.setResolutionScale(0.625f);
+    CORRADE_COMPARE(renderer.resolutionScale(), 0.625f);
+
+    /* Raising the minimum clamps the current scale */
+    renderer.setMinResolutionScale(0.75f);
+    CORRADE_COMPARE(renderer.minResolutionScale(), 0.75f);
+    CORRADE_COMPARE(renderer.resolutionScale(), 0.75f);
+
+    /* Drawing at a reduced scale with nothing drawn shouldn't cause any GL
+       errors */
+    renderer.setupFramebuffers({15, 37});
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.beginLayerProfile(layerHandle(3, 0xcf));
+    renderer.endLayerProfile();
+    renderer.transition(RendererTargetState::Final, {});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+}
+
 void RendererGLTest::constructCopy() {
     CORRADE_VERIFY(!std::is_copy_constructible<RendererGL>{});
     CORRADE_VERIFY(!std::is_copy_assignable<RendererGL>{});
@@ -152,12 +258,150 @@ void RendererGLTest::compositingFramebufferNoFramebufferSizeSet() {
         TestSuite::Compare::String);
 }
 
+void RendererGLTest::compositingContentGeneration() {
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer};
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 0);
+
+    /* Creating the framebuffer increments the generation, every following
+       recreation as well */
+    renderer.setupFramebuffers({15, 37});
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 1);
+    renderer.setupFramebuffers({20, 30});
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 2);
+
+    /* Compositing right at the start doesn't increment it, as nothing was
+       drawn before */
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.transition(RendererTargetState::Composite, {});
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 2);
+
+    /* Drawing by itself doesn't increment it either */
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::Blending);
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 2);
+
+    /* Compositing after a draw does */
+    renderer.transition(RendererTargetState::Composite, {});
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 3);
+
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.transition(RendererTargetState::Final, {});
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 3);
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Explicit increment */
+    CORRADE_COMPARE(&renderer.incrementCompositingContentGeneration(), &renderer);
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 4);
+}
+
+void RendererGLTest::renderTargetTexture() {
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag::DepthBuffer};
+    CORRADE_VERIFY(!renderer.hasRenderTargetTexture());
+
+    GL::Texture2D texture;
+    texture.setStorage(1, GL::TextureFormat::RGBA8, {200, 300});
+
+    /* Setting it before the framebuffer is set up only remembers it */
+    CORRADE_COMPARE(&renderer.setRenderTargetTexture(texture), &renderer);
+    CORRADE_VERIFY(renderer.hasRenderTargetTexture());
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 0);
+
+    /* The framebuffer is then created with the texture attached, a depth
+       buffer is created as usual */
+    renderer.setupFramebuffers({200, 300});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    UnsignedInt framebufferId = renderer.compositingFramebuffer().id();
+    CORRADE_VERIFY(framebufferId);
+    CORRADE_COMPARE(renderer.compositingFramebuffer().viewport(), (Range2Di{{}, {200, 300}}));
+    CORRADE_COMPARE(renderer.compositingFramebuffer().checkStatus(GL::FramebufferTarget::Draw), GL::Framebuffer::Status::Complete);
+    CORRADE_COMPARE(renderer.compositingTexture().id(), texture.id());
+    CORRADE_VERIFY(renderer.depthRenderbuffer().id());
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 1);
+
+    /* Setting a different texture with the framebuffer already set up
+       recreates the framebuffer right away */
+    GL::Texture2D another;
+    another.setStorage(1, GL::TextureFormat::RGBA8, {200, 300});
+    renderer.setRenderTargetTexture(another);
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_VERIFY(renderer.compositingFramebuffer().id());
+    CORRADE_VERIFY(renderer.compositingFramebuffer().id() != framebufferId);
+    CORRADE_COMPARE(renderer.compositingFramebuffer().checkStatus(GL::FramebufferTarget::Draw), GL::Framebuffer::Status::Complete);
+    CORRADE_COMPARE(renderer.compositingTexture().id(), another.id());
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 2);
+
+    /* Resizing keeps the texture, it's expected to be replaced by the user
+       beforehand */
+    GL::Texture2D smaller;
+    smaller.setStorage(1, GL::TextureFormat::RGBA8, {150, 200});
+    renderer.setRenderTargetTexture(smaller);
+    renderer.setupFramebuffers({150, 200});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.compositingFramebuffer().viewport(), (Range2Di{{}, {150, 200}}));
+    CORRADE_COMPARE(renderer.compositingFramebuffer().checkStatus(GL::FramebufferTarget::Draw), GL::Framebuffer::Status::Complete);
+    CORRADE_COMPARE(renderer.compositingTexture().id(), smaller.id());
+    CORRADE_COMPARE(renderer.compositingContentGeneration(), 4);
+}
+
 void RendererGLTest::setupTeardown() {
     GL::Renderer::disable(GL::Renderer::Feature::Blending);
     GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
     GL::defaultFramebuffer.bind();
 }
 
+void RendererGLTest::layerProfiling() {
+    #ifndef MAGNUM_TARGET_GLES
+    if(!GL::Context::current().isExtensionSupported<GL::Extensions::ARB::timer_query>())
+        CORRADE_SKIP(GL::Extensions::ARB::timer_query::string() << "is not supported.");
+    #elif !defined(MAGNUM_TARGET_WEBGL)
+    if(!GL::Context::current().isExtensionSupported<GL::Extensions::EXT::disjoint_timer_query>())
+        CORRADE_SKIP(GL::Extensions::EXT::disjoint_timer_query::string() << "is not supported.");
+    #else
+    if(!GL::Context::current().isExtensionSupported<GL::Extensions::EXT::disjoint_timer_query_webgl2>())
+        CORRADE_SKIP(GL::Extensions::EXT::disjoint_timer_query_webgl2::string() << "is not supported.");
+    #endif
+
+    RendererGL renderer{RendererGL::Flag::LayerProfiling};
+    renderer.setupFramebuffers({15, 37});
+
+    /* First layer profiled twice, the second once. Nothing is actually drawn,
+       so the primitive count is zero. */
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.beginLayerProfile(layerHandle(3, 0xcf));
+    renderer.endLayerProfile();
+    renderer.beginLayerProfile(layerHandle(1, 0x2a));
+    renderer.endLayerProfile();
+    renderer.beginLayerProfile(layerHandle(3, 0xcf));
+    renderer.endLayerProfile();
+    renderer.transition(RendererTargetState::Final, {});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Wait for the GPU to finish, the results are then retrieved at the
+       latest at the end of the next frame */
+    GL::Renderer::finish();
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.transition(RendererTargetState::Final, {});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.layerDrawCount(layerHandle(3, 0xcf)), 2);
+    CORRADE_COMPARE(renderer.layerDrawCount(layerHandle(1, 0x2a)), 1);
+    /* Different generation, not profiled */
+    CORRADE_COMPARE(renderer.layerDrawCount(layerHandle(3, 0xce)), 0);
+    CORRADE_COMPARE(renderer.layerGpuDuration(layerHandle(3, 0xce)), 0);
+    #ifndef MAGNUM_TARGET_GLES
+    CORRADE_COMPARE(renderer.layerPrimitiveCount(layerHandle(3, 0xcf)), 0);
+    #endif
+    /* Nothing to check for the GPU duration, it can be anything */
+
+    /* An empty frame doesn't replace the results */
+    GL::Renderer::finish();
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.transition(RendererTargetState::Final, {});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.layerDrawCount(layerHandle(3, 0xcf)), 2);
+    CORRADE_COMPARE(renderer.layerDrawCount(layerHandle(1, 0x2a)), 1);
+}
+
 void RendererGLTest::transition() {
     Vector4i defaultScissorRect{};
     glGetIntegerv(GL_SCISSOR_BOX, defaultScissorRect.data());
@@ -334,6 +578,151 @@ void RendererGLTest::transitionNoScissor() {
     CORRADE_COMPARE(currentScissorRect, (Vector4i{0, 1, 2, 3}));
 }
 
+void RendererGLTest::transitionRetained() {
+    Int currentScissor = 1, currentFramebuffer = 999;
+    Vector4i currentScissorRect{};
+
+    RendererGL renderer{RendererGL::Flag::RetainedFramebuffer};
+    renderer.setupFramebuffers({15, 37});
+
+    /* The first draw clears the whole framebuffer and doesn't enable
+       scissor */
+    GL::Renderer::setClearColor(0x3366ff_rgbf);
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.transition(RendererTargetState::Draw, {});
+    glGetIntegerv(GL_SCISSOR_TEST, &currentScissor);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &currentFramebuffer);
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_VERIFY(!currentScissor);
+    CORRADE_COMPARE(currentFramebuffer, renderer.compositingFramebuffer().id());
+    renderer.transition(RendererTargetState::Final, {});
+
+    /* A partial redraw clears just the redraw area and restricts further
+       drawing to it, with Y flipped */
+    GL::Renderer::setClearColor(0xff3366_rgbf);
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.setRedrawRect({{2, 3}, {5, 7}});
+    renderer.transition(RendererTargetState::Draw, {});
+    glGetIntegerv(GL_SCISSOR_TEST, &currentScissor);
+    glGetIntegerv(GL_SCISSOR_BOX, currentScissorRect.data());
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_VERIFY(currentScissor);
+    CORRADE_COMPARE(currentScissorRect, (Vector4i{2, 30, 3, 4}));
+
+    /* The final transition disables the scissor and resets it back */
+    renderer.transition(RendererTargetState::Final, {});
+    glGetIntegerv(GL_SCISSOR_TEST, &currentScissor);
+    glGetIntegerv(GL_SCISSOR_BOX, currentScissorRect.data());
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_VERIFY(!currentScissor);
+    CORRADE_COMPARE(currentScissorRect, (Vector4i{0, 0, 15, 37}));
+
+    /* An empty redraw area doesn't clear anything. Setting the clear color
+       back to the default transparent black in the process. */
+    GL::Renderer::setClearColor(0x00000000_rgbaf);
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.setRedrawRect({});
+    renderer.transition(RendererTargetState::Final, {});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Only the area inside the partial redraw rect got cleared to the second
+       color, the rest is kept from the first draw */
+    Image2D image = renderer.compositingFramebuffer().read({{}, {15, 37}}, {PixelFormat::RGBA8Unorm});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(image.pixels<Color4ub>()[0][0], 0x3366ff_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[36][14], 0x3366ff_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[30][2], 0xff3366_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[33][4], 0xff3366_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[29][2], 0x3366ff_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[34][5], 0x3366ff_rgba);
+}
+
+void RendererGLTest::transitionRetainedRenderTargetTexture() {
+    RendererGL renderer{RendererGL::Flag::RetainedFramebuffer};
+    renderer.setupFramebuffers({15, 37});
+
+    /* Draw into the internal texture first */
+    GL::Renderer::setClearColor(0x3366ff_rgbf);
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.transition(RendererTargetState::Final, {});
+    GL::Renderer::setClearColor(0x00000000_rgbaf);
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Switching to a user texture copies the retained contents over, as the
+       UI isn't going to redraw everything */
+    GL::Texture2D texture;
+    texture.setStorage(1, GL::TextureFormat::RGBA8, {15, 37});
+    renderer.setRenderTargetTexture(texture);
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.compositingTexture().id(), texture.id());
+
+    Image2D image = renderer.compositingFramebuffer().read({{}, {15, 37}}, {PixelFormat::RGBA8Unorm});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(image.pixels<Color4ub>()[0][0], 0x3366ff_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[36][14], 0x3366ff_rgba);
+
+    /* A partial redraw then goes to the user texture and keeps the rest */
+    GL::Renderer::setClearColor(0xff3366_rgbf);
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.setRedrawRect({{2, 3}, {5, 7}});
+    renderer.transition(RendererTargetState::Draw, {});
+    renderer.transition(RendererTargetState::Final, {});
+    GL::Renderer::setClearColor(0x00000000_rgbaf);
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    GL::Framebuffer framebuffer{{{}, {15, 37}}};
+    framebuffer.attachTexture(GL::Framebuffer::ColorAttachment{0}, texture, 0);
+    Image2D textureImage = framebuffer.read({{}, {15, 37}}, {PixelFormat::RGBA8Unorm});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(textureImage.pixels<Color4ub>()[0][0], 0x3366ff_rgba);
+    CORRADE_COMPARE(textureImage.pixels<Color4ub>()[30][2], 0xff3366_rgba);
+    CORRADE_COMPARE(textureImage.pixels<Color4ub>()[34][5], 0x3366ff_rgba);
+}
+
+void RendererGLTest::drawCache() {
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag::DrawCache};
+    renderer.setupFramebuffers({16, 16});
+    renderer.compositingFramebuffer().clearColor(0, 0x000000ff_rgbaf);
+
+    renderer.transition(RendererTargetState::Initial, {});
+    renderer.transition(RendererTargetState::Draw, {});
+
+    /* Fill the whole area while rendering each cache, only the cache rect
+       should get kept. The second overlaps the first. */
+    renderer.beginCache(0, {{2, 3}, {8, 12}});
+    GL::Renderer::setClearColor(0xff3366_rgbf);
+    glClear(GL_COLOR_BUFFER_BIT);
+    renderer.endCache();
+
+    renderer.beginCache(1, {{6, 10}, {14, 16}});
+    GL::Renderer::setClearColor(0x3366ff_rgbf);
+    glClear(GL_COLOR_BUFFER_BIT);
+    renderer.endCache();
+    GL::Renderer::setClearColor(0x00000000_rgbaf);
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Drawing the second cache shouldn't have affected the first */
+    renderer.transition(RendererTargetState::Draw, RendererDrawState::Blending);
+    renderer.drawCache(0);
+    renderer.drawCache(1);
+    renderer.transition(RendererTargetState::Final, {});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* The rects have the origin at the top left, the pixels are bottom up */
+    Image2D image = renderer.compositingFramebuffer().read({{}, {16, 16}}, {PixelFormat::RGBA8Unorm});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(image.pixels<Color4ub>()[12][2], 0xff3366_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[10][3], 0xff3366_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[6][7], 0xff3366_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[12][1], 0x000000ff_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[13][2], 0x000000ff_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[5][6], 0x3366ff_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[0][13], 0x3366ff_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[0][14], 0x000000ff_rgba);
+    CORRADE_COMPARE(image.pixels<Color4ub>()[15][15], 0x000000ff_rgba);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::RendererGLTest)
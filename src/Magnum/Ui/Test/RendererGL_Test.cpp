@@ -27,7 +27,11 @@
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/String.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Math/Vector2.h>
 
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/RendererGL.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
@@ -41,6 +45,15 @@ struct RendererGL_Test: TestSuite::Tester {
     void construct();
 
     void compositingFramebufferTextureNotEnabled();
+    void compositingContentGenerationNotEnabled();
+    void layerProfilingNotEnabled();
+    void dynamicResolutionNotEnabled();
+    void dynamicResolutionInvalidFlags();
+    void dynamicResolutionInvalidScale();
+    void renderTargetTextureNotEnabled();
+    void renderTargetTextureNotCreated();
+
+    void globalPositionFromTextureCoordinates();
 };
 
 RendererGL_Test::RendererGL_Test() {
@@ -49,7 +62,16 @@ RendererGL_Test::RendererGL_Test() {
 
               &RendererGL_Test::construct,
 
-              &RendererGL_Test::compositingFramebufferTextureNotEnabled});
+              &RendererGL_Test::compositingFramebufferTextureNotEnabled,
+              &RendererGL_Test::compositingContentGenerationNotEnabled,
+              &RendererGL_Test::layerProfilingNotEnabled,
+              &RendererGL_Test::dynamicResolutionNotEnabled,
+              &RendererGL_Test::dynamicResolutionInvalidFlags,
+              &RendererGL_Test::dynamicResolutionInvalidScale,
+              &RendererGL_Test::renderTargetTextureNotEnabled,
+              &RendererGL_Test::renderTargetTextureNotCreated,
+
+              &RendererGL_Test::globalPositionFromTextureCoordinates});
 }
 
 void RendererGL_Test::debugFlag() {
@@ -60,8 +82,8 @@ void RendererGL_Test::debugFlag() {
 
 void RendererGL_Test::debugFlags() {
     Containers::String out;
-    Debug{&out} << (RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag(0xb0)) << RendererGL::Flags{};
-    CORRADE_COMPARE(out, "Ui::RendererGL::Flag::CompositingFramebuffer|Ui::RendererGL::Flag(0xb0) Ui::RendererGL::Flags{}\n");
+    Debug{&out} << (RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag(0xa0)) << RendererGL::Flags{};
+    CORRADE_COMPARE(out, "Ui::RendererGL::Flag::CompositingFramebuffer|Ui::RendererGL::Flag(0xa0) Ui::RendererGL::Flags{}\n");
 }
 
 void RendererGL_Test::construct() {
@@ -69,6 +91,7 @@ void RendererGL_Test::construct() {
 
     /* It shouldn't require a GL context on construction or destruction */
     CORRADE_COMPARE(renderer.currentDrawStates(), RendererDrawStates{});
+    CORRADE_VERIFY(!renderer.hasRenderTargetTexture());
 }
 
 void RendererGL_Test::compositingFramebufferTextureNotEnabled() {
@@ -91,6 +114,140 @@ void RendererGL_Test::compositingFramebufferTextureNotEnabled() {
         TestSuite::Compare::String);
 }
 
+void RendererGL_Test::compositingContentGenerationNotEnabled() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    RendererGL renderer;
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.compositingContentGeneration();
+    renderer.incrementCompositingContentGeneration();
+    CORRADE_COMPARE_AS(out,
+        "Ui::RendererGL::compositingContentGeneration(): compositing framebuffer not enabled\n"
+        "Ui::RendererGL::incrementCompositingContentGeneration(): compositing framebuffer not enabled\n",
+        TestSuite::Compare::String);
+}
+
+void RendererGL_Test::layerProfilingNotEnabled() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    RendererGL renderer;
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.layerGpuDuration(layerHandle(3, 0xcf));
+    #ifndef MAGNUM_TARGET_GLES
+    renderer.layerPrimitiveCount(layerHandle(3, 0xcf));
+    #endif
+    renderer.layerDrawCount(layerHandle(3, 0xcf));
+    CORRADE_COMPARE_AS(out,
+        "Ui::RendererGL::layerGpuDuration(): layer profiling not enabled\n"
+        #ifndef MAGNUM_TARGET_GLES
+        "Ui::RendererGL::layerPrimitiveCount(): layer profiling not enabled\n"
+        #endif
+        "Ui::RendererGL::layerDrawCount(): layer profiling not enabled\n",
+        TestSuite::Compare::String);
+}
+
+void RendererGL_Test::dynamicResolutionNotEnabled() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag::LayerProfiling};
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.dynamicResolutionBudget();
+    renderer.setDynamicResolutionBudget(1000);
+    renderer.minResolutionScale();
+    renderer.setMinResolutionScale(0.25f);
+    renderer.resolutionScale();
+    renderer.setResolutionScale(0.75f);
+    renderer.setNativeResolutionLayers({layerHandle(3, 0xcf)});
+    CORRADE_COMPARE_AS(out,
+        "Ui::RendererGL::dynamicResolutionBudget(): dynamic resolution not enabled\n"
+        "Ui::RendererGL::setDynamicResolutionBudget(): dynamic resolution not enabled\n"
+        "Ui::RendererGL::minResolutionScale(): dynamic resolution not enabled\n"
+        "Ui::RendererGL::setMinResolutionScale(): dynamic resolution not enabled\n"
+        "Ui::RendererGL::resolutionScale(): dynamic resolution not enabled\n"
+        "Ui::RendererGL::setResolutionScale(): dynamic resolution not enabled\n"
+        "Ui::RendererGL::setNativeResolutionLayers(): dynamic resolution not enabled\n",
+        TestSuite::Compare::String);
+}
+
+void RendererGL_Test::dynamicResolutionInvalidFlags() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::String out;
+    Error redirectError{&out};
+    RendererGL{RendererGL::Flag::DynamicResolution|RendererGL::Flag::CompositingFramebuffer};
+    RendererGL{RendererGL::Flag::DynamicResolution|RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag::LayerProfiling|RendererGL::Flag::RetainedFramebuffer};
+    RendererGL{RendererGL::Flag::DynamicResolution|RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag::LayerProfiling|RendererGL::Flag::DepthBuffer};
+    CORRADE_COMPARE_AS(out,
+        "Ui::RendererGL: Ui::RendererGL::Flag::DynamicResolution expects Ui::RendererGL::Flag::CompositingFramebuffer|Ui::RendererGL::Flag::LayerProfiling to be enabled as well and isn't combinable with Ui::RendererGL::Flag::RetainedFramebuffer|Ui::RendererGL::Flag::DepthBuffer\n"
+        "Ui::RendererGL: Ui::RendererGL::Flag::DynamicResolution expects Ui::RendererGL::Flag::CompositingFramebuffer|Ui::RendererGL::Flag::LayerProfiling to be enabled as well and isn't combinable with Ui::RendererGL::Flag::RetainedFramebuffer|Ui::RendererGL::Flag::DepthBuffer\n"
+        "Ui::RendererGL: Ui::RendererGL::Flag::DynamicResolution expects Ui::RendererGL::Flag::CompositingFramebuffer|Ui::RendererGL::Flag::LayerProfiling to be enabled as well and isn't combinable with Ui::RendererGL::Flag::RetainedFramebuffer|Ui::RendererGL::Flag::DepthBuffer\n",
+        TestSuite::Compare::String);
+}
+
+void RendererGL_Test::dynamicResolutionInvalidScale() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer|RendererGL::Flag::LayerProfiling|RendererGL::Flag::DynamicResolution};
+    renderer.setMinResolutionScale(0.25f);
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.setMinResolutionScale(0.0f);
+    renderer.setMinResolutionScale(1.5f);
+    renderer.setResolutionScale(0.125f);
+    renderer.setResolutionScale(1.25f);
+    CORRADE_COMPARE_AS(out,
+        "Ui::RendererGL::setMinResolutionScale(): expected a scale in range (0, 1] but got 0\n"
+        "Ui::RendererGL::setMinResolutionScale(): expected a scale in range (0, 1] but got 1.5\n"
+        "Ui::RendererGL::setResolutionScale(): expected a scale between 0.25 and 1 but got 0.125\n"
+        "Ui::RendererGL::setResolutionScale(): expected a scale between 0.25 and 1 but got 1.25\n",
+        TestSuite::Compare::String);
+}
+
+void RendererGL_Test::renderTargetTextureNotEnabled() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    RendererGL renderer{RendererGL::Flag::DepthBuffer};
+
+    /* The texture isn't accessed in any way, so a NoCreate'd one is fine */
+    GL::Texture2D texture{NoCreate};
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.setRenderTargetTexture(texture);
+    CORRADE_COMPARE(out, "Ui::RendererGL::setRenderTargetTexture(): compositing framebuffer not enabled\n");
+}
+
+void RendererGL_Test::renderTargetTextureNotCreated() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer};
+
+    GL::Texture2D texture{NoCreate};
+
+    Containers::String out;
+    Error redirectError{&out};
+    renderer.setRenderTargetTexture(texture);
+    CORRADE_COMPARE(out, "Ui::RendererGL::setRenderTargetTexture(): texture not created\n");
+    CORRADE_VERIFY(!renderer.hasRenderTargetTexture());
+}
+
+void RendererGL_Test::globalPositionFromTextureCoordinates() {
+    /* The UI size is deliberately different from the window size, events
+       are expected to be in window coordinates */
+    AbstractUserInterface ui{{200.0f, 300.0f}, {400.0f, 600.0f}, {800, 1200}};
+
+    CORRADE_COMPARE(RendererGL::globalPositionFromTextureCoordinates(ui, {0.0f, 0.0f}), (Vector2{0.0f, 600.0f}));
+    CORRADE_COMPARE(RendererGL::globalPositionFromTextureCoordinates(ui, {1.0f, 1.0f}), (Vector2{400.0f, 0.0f}));
+    CORRADE_COMPARE(RendererGL::globalPositionFromTextureCoordinates(ui, {0.25f, 0.75f}), (Vector2{100.0f, 150.0f}));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::RendererGL_Test)
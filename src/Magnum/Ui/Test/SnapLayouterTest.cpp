@@ -207,10 +207,12 @@ const struct {
     const char* name;
     bool setMarginPaddingLater;
     bool recycledLayouts;
+    bool updateBefore;
 } UpdateDataOrderData[]{
-    {"", false, false},
-    {"margin & padding set later", true, false},
-    {"layouts recycled in shuffled order", false, true},
+    {"", false, false, false},
+    {"margin & padding set later", true, false, false},
+    {"layouts recycled in shuffled order", false, true, false},
+    {"updated with a partial hierarchy before", false, false, true},
 };
 
 SnapLayouterTest::SnapLayouterTest() {
@@ -1083,6 +1085,14 @@ void SnapLayouterTest::updateDataOrder() {
     AbstractAnchor layout3 = Ui::snap(ui, layouter, Snap::Top|Snap::Bottom|Snap::Right|Snap::Inside|Snap::NoPadX, nodeRoot, {0.9f, 0.6f}, {10.0f, 0.0f});
     CORRADE_COMPARE(ui.nodeParent(layout3), nodeRoot);
 
+    /* Updating with just a part of the hierarchy caches the breadth-first
+       node order, which has to be recalculated once the nodes below are
+       added */
+    if(data.updateBefore) {
+        ui.setSize({500, 400});
+        ui.update();
+    }
+
     /* A layout relative to layouted node with an offset, should inerit that
        offset in addition to its own, and match its Y size */
     AbstractAnchor layout4 = Ui::snap(ui, layouter, Snap::Top|Snap::Bottom|Snap::Left, layout3, {0.2f, -0.5f}, {20.0f, 0.0f});
@@ -24,11 +24,15 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <chrono>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Reference.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/FormatStl.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/VertexFormat.h>
 #include <Magnum/DebugTools/ColorMap.h>
@@ -68,6 +72,12 @@ class StressTest: public Platform::Application {
             _triggerNodeUpdate;
 
         DebugTools::FrameProfilerGL _profiler;
+
+        /* If non-zero, given count of frames is measured, after which the
+           results are printed as JSON and the application exits */
+        UnsignedInt _frameCount, _frameDelay{};
+        std::chrono::steady_clock::duration _updateDuration{}, _drawDuration{};
+        std::size_t _dataCount;
 };
 
 using namespace Containers::Literals;
@@ -211,6 +221,18 @@ StressTest::StressTest(const Arguments& arguments): Platform::Application{argume
         /** @todo other triggers */
         .addOption("size", "1000 1000").setHelp("size", "node grid size")
         .addOption("count", "1").setHelp("count", "count of data per node")
+        .addOption("frames", "0").setHelp("frames", "measure given count of frames, print the results as JSON and exit", "N")
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        .addBooleanOption("headless").setHelp("headless", "don't show the window")
+        #endif
+        .setGlobalHelp(R"(Renders a grid of nodes with given count of data attached to each, and
+measures how long it takes to update and draw them.
+
+With --frames, after given count of frames a single line of JSON is printed,
+containing mean durations of the UI update and draw submission on the CPU
+and the FrameProfilerGL frame time, CPU and GPU duration, all in
+nanoseconds. On the web, the options can be passed in the URL query string,
+such as ?frames=500&node-update.)")
         .parse(arguments.argc, arguments.argv);
 
     _triggerDataUpdate = args.isSet("data-update");
@@ -229,13 +251,27 @@ StressTest::StressTest(const Arguments& arguments): Platform::Application{argume
     if(count > 128)
         Fatal{} << "At most 128 layers is allowed, got" << count;
 
-    create(Configuration{}
-        .setTitle("Magnum::Ui Stress Test"_s));
+    _frameCount = args.value<UnsignedInt>("frames");
 
+    Configuration conf;
+    conf.setTitle("Magnum::Ui Stress Test"_s);
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    if(args.isSet("headless"))
+        conf.setWindowFlags(Configuration::WindowFlag::Hidden);
+    #endif
+    create(conf);
+
+    /* When measuring a fixed count of frames, keep all of them in the
+       profiler so the mean is calculated from all */
     _profiler = DebugTools::FrameProfilerGL{
         DebugTools::FrameProfilerGL::Value::FrameTime|
         DebugTools::FrameProfilerGL::Value::GpuDuration|
-        DebugTools::FrameProfilerGL::Value::CpuDuration, 50};
+        DebugTools::FrameProfilerGL::Value::CpuDuration,
+        _frameCount ? _frameCount : 50};
+    /* GPU queries are retrieved with a delay, the measurement has to wait
+       until all frames have their values available */
+    for(UnsignedInt i = 0; i != _profiler.measurementCount(); ++i)
+        _frameDelay = Math::max(_frameDelay, _profiler.measurementDelay(i));
 
     _ui
         .setSize(Vector2{size}*args.value<Float>("clip"), Vector2{windowSize()}, framebufferSize())
@@ -270,6 +306,7 @@ StressTest::StressTest(const Arguments& arguments): Platform::Application{argume
     for(UnsignedInt j = 0; j != count*2; ++j)
         capacity += layers[j]->capacity();
 
+    _dataCount = capacity;
     Debug{} << _ui.nodeCapacity() << "nodes total," << capacity << "data attachments";
 
     #ifndef CORRADE_TARGET_EMSCRIPTEN
@@ -292,10 +329,43 @@ void StressTest::drawEvent() {
     else if(_triggerDataUpdate)
         _ui.layer<Layer>(_firstLayer).setNeedsUpdate(LayerState::NeedsDataUpdate);
 
+    /* Update explicitly to measure it separately from the draw */
+    const std::chrono::steady_clock::time_point updateBegin = std::chrono::steady_clock::now();
+    _ui.update();
+    const std::chrono::steady_clock::time_point drawBegin = std::chrono::steady_clock::now();
     _ui.draw();
+    const std::chrono::steady_clock::time_point drawEnd = std::chrono::steady_clock::now();
 
     _profiler.endFrame();
-    _profiler.printStatistics(50);
+
+    if(!_frameCount) {
+        _profiler.printStatistics(50);
+    } else {
+        /* Sum the CPU durations for the same frames the profiler calculates
+           its means from, so the values correspond to each other */
+        if(_profiler.measuredFrameCount() > _frameDelay) {
+            _updateDuration += drawBegin - updateBegin;
+            _drawDuration += drawEnd - drawBegin;
+        }
+
+        if(_profiler.measuredFrameCount() >= _frameCount + _frameDelay) {
+            Containers::String out = Utility::format("{{\"frames\":{},\"nodes\":{},\"data\":{},\"update\":{},\"draw\":{}",
+                _frameCount,
+                _ui.nodeCapacity(),
+                _dataCount,
+                UnsignedLong(std::chrono::duration_cast<std::chrono::nanoseconds>(_updateDuration).count()/_frameCount),
+                UnsignedLong(std::chrono::duration_cast<std::chrono::nanoseconds>(_drawDuration).count()/_frameCount));
+            for(UnsignedInt i = 0; i != _profiler.measurementCount(); ++i)
+                out = out + Utility::format(",\"{}\":{}",
+                    _profiler.measurementName(i),
+                    UnsignedLong(_profiler.measurementMean(i)));
+            out = out + "}"_s;
+            Debug{} << out;
+
+            exit();
+            return;
+        }
+    }
 
     swapBuffers();
     redraw();
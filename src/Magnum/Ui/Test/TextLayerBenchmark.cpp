@@ -0,0 +1,379 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector4.h>
+#include <Magnum/Text/AbstractFont.h>
+#include <Magnum/Text/AbstractGlyphCache.h>
+#include <Magnum/Text/Alignment.h>
+
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/TextLayer.h"
+#include "Magnum/Ui/TextProperties.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct TextLayerBenchmark: TestSuite::Tester {
+    explicit TextLayerBenchmark();
+
+    void create();
+    void setText();
+    void update();
+    void editText();
+    void fillGlyphCache();
+
+    private:
+        Containers::Pointer<Text::AbstractFont> openFont(const char* plugin);
+
+        PluginManager::Manager<Text::AbstractFont> _fontManager;
+};
+
+/* Used by create(), setText() and update() */
+constexpr UnsignedInt TextBenchmarkTextCount = 100;
+
+constexpr Containers::StringView GlyphCacheCharacters =
+    "abcdefghijklmnopqrstuvwxyz"
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "0123456789 _.,-+=*:;?!@$&#/\\|`\"'<>()[]{}%"_s;
+
+const struct {
+    const char* name;
+    const char* plugin;
+    UnsignedInt textLength;
+} CreateData[]{
+    {"StbTrueTypeFont, 8 characters", "StbTrueTypeFont", 8},
+    {"StbTrueTypeFont, 64 characters", "StbTrueTypeFont", 64},
+    {"StbTrueTypeFont, 1024 characters", "StbTrueTypeFont", 1024},
+    {"HarfBuzzFont, 8 characters", "HarfBuzzFont", 8},
+    {"HarfBuzzFont, 64 characters", "HarfBuzzFont", 64},
+    {"HarfBuzzFont, 1024 characters", "HarfBuzzFont", 1024},
+};
+
+const struct {
+    const char* name;
+    const char* plugin;
+    UnsignedInt shapeCacheSize;
+} SetTextData[]{
+    {"StbTrueTypeFont", "StbTrueTypeFont", 0},
+    {"StbTrueTypeFont, shape cache", "StbTrueTypeFont", TextBenchmarkTextCount*2},
+    {"HarfBuzzFont", "HarfBuzzFont", 0},
+    {"HarfBuzzFont, shape cache", "HarfBuzzFont", TextBenchmarkTextCount*2},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt relocateEvery;
+} UpdateData[]{
+    {"no fragmentation", 0},
+    {"every 10th text relocated", 10},
+    {"every 2nd text relocated", 2},
+    {"all texts relocated", 1},
+};
+
+const struct {
+    const char* name;
+    const char* plugin;
+    UnsignedInt textLength;
+} EditTextData[]{
+    {"StbTrueTypeFont, 1k characters", "StbTrueTypeFont", 1000},
+    {"StbTrueTypeFont, 10k characters", "StbTrueTypeFont", 10000},
+    {"HarfBuzzFont, 1k characters", "HarfBuzzFont", 1000},
+    {"HarfBuzzFont, 10k characters", "HarfBuzzFont", 10000},
+};
+
+const struct {
+    const char* name;
+    const char* plugin;
+} FillGlyphCacheData[]{
+    {"StbTrueTypeFont", "StbTrueTypeFont"},
+    {"HarfBuzzFont", "HarfBuzzFont"},
+};
+
+/* Glyph cache that's only in CPU memory, the upload is benchmarked in
+   TextLayerGLBenchmark */
+struct GlyphCache: Text::AbstractGlyphCache {
+    using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+    Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+    void doSetImage(const Vector2i&, const ImageView2D&) override {}
+};
+
+struct LayerShared: TextLayer::Shared {
+    explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+    void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+    void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+};
+
+struct Layer: TextLayer {
+    explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+};
+
+/* Repeats a sentence to get a text of given length */
+Containers::String textOfLength(UnsignedInt length) {
+    const Containers::StringView sentence = "The quick brown fox jumps over the lazy dog. "_s;
+    Containers::String out{NoInit, length};
+    for(std::size_t i = 0; i != length; ++i)
+        out[i] = sentence[i % sentence.size()];
+    return out;
+}
+
+void setupStyle(LayerShared& shared, FontHandle fontHandle) {
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {},
+        {0}, {0},
+        {});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}},
+        {-1},
+        {{}});
+}
+
+TextLayerBenchmark::TextLayerBenchmark() {
+    addInstancedBenchmarks({&TextLayerBenchmark::create}, 10,
+        Containers::arraySize(CreateData));
+
+    addInstancedBenchmarks({&TextLayerBenchmark::setText}, 10,
+        Containers::arraySize(SetTextData));
+
+    addInstancedBenchmarks({&TextLayerBenchmark::update}, 20,
+        Containers::arraySize(UpdateData));
+
+    addInstancedBenchmarks({&TextLayerBenchmark::editText}, 10,
+        Containers::arraySize(EditTextData));
+
+    addInstancedBenchmarks({&TextLayerBenchmark::fillGlyphCache}, 5,
+        Containers::arraySize(FillGlyphCacheData));
+}
+
+Containers::Pointer<Text::AbstractFont> TextLayerBenchmark::openFont(const char* plugin) {
+    if(!(_fontManager.load(plugin) & PluginManager::LoadState::Loaded))
+        return {};
+
+    Containers::Pointer<Text::AbstractFont> font = _fontManager.instantiate(plugin);
+    if(!font->openFile(Utility::Path::join(UI_DIR, "SourceSans3-Regular.otf"), 32.0f))
+        return {};
+
+    return font;
+}
+
+void TextLayerBenchmark::create() {
+    auto&& data = CreateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures creation of many texts, i.e. mainly the shaping and then glyph
+       data allocation. The glyphs are in the cache already so the cache
+       lookup doesn't need to fill anything. */
+
+    Containers::Pointer<Text::AbstractFont> font = openFont(data.plugin);
+    if(!font)
+        CORRADE_SKIP(data.plugin << "plugin not found or the font can't be opened.");
+
+    GlyphCache cache{PixelFormat::R8Unorm, {1024, 1024}};
+    CORRADE_VERIFY(font->fillGlyphCache(cache, GlyphCacheCharacters));
+
+    LayerShared shared{cache, TextLayer::Shared::Configuration{1}
+        .setEditingStyleCount(1)};
+    setupStyle(shared, shared.addFont(*font, 16.0f));
+
+    Layer layer{layerHandle(0, 1), shared};
+
+    const Containers::String text = textOfLength(data.textLength);
+
+    CORRADE_BENCHMARK(1) {
+        for(UnsignedInt i = 0; i != TextBenchmarkTextCount; ++i)
+            layer.create(0, text, {});
+    }
+
+    CORRADE_COMPARE(layer.usedCount(), TextBenchmarkTextCount);
+}
+
+void TextLayerBenchmark::setText() {
+    auto&& data = SetTextData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures changing many short texts, such as table cells or labels in a
+       recycled list, alternating between two sets of strings. With the shape
+       cache enabled, all texts except the first round are cache hits. */
+
+    Containers::Pointer<Text::AbstractFont> font = openFont(data.plugin);
+    if(!font)
+        CORRADE_SKIP(data.plugin << "plugin not found or the font can't be opened.");
+
+    GlyphCache cache{PixelFormat::R8Unorm, {1024, 1024}};
+    CORRADE_VERIFY(font->fillGlyphCache(cache, GlyphCacheCharacters));
+
+    LayerShared shared{cache, TextLayer::Shared::Configuration{1}
+        .setEditingStyleCount(1)
+        .setShapeCacheSize(data.shapeCacheSize)};
+    setupStyle(shared, shared.addFont(*font, 16.0f));
+
+    Layer layer{layerHandle(0, 1), shared};
+
+    /* Texts of the same length, so the glyph data are reused in place */
+    Containers::Array<Containers::String> texts{TextBenchmarkTextCount*2};
+    for(UnsignedInt i = 0; i != texts.size(); ++i)
+        texts[i] = Utility::format("Item {:.4} #{:.5}", i % TextBenchmarkTextCount, i);
+
+    Containers::Array<DataHandle> handles{NoInit, TextBenchmarkTextCount};
+    for(UnsignedInt i = 0; i != TextBenchmarkTextCount; ++i)
+        handles[i] = layer.create(0, texts[i], {});
+
+    /* Populate the cache with the other set of strings as well */
+    for(UnsignedInt i = 0; i != TextBenchmarkTextCount; ++i)
+        layer.setText(handles[i], texts[TextBenchmarkTextCount + i], {});
+
+    UnsignedInt round = 0;
+    CORRADE_BENCHMARK(10) {
+        const UnsignedInt offset = (round++ % 2)*TextBenchmarkTextCount;
+        for(UnsignedInt i = 0; i != TextBenchmarkTextCount; ++i)
+            layer.setText(handles[i], texts[offset + i], {});
+    }
+
+    CORRADE_COMPARE(layer.usedCount(), TextBenchmarkTextCount);
+}
+
+void TextLayerBenchmark::update() {
+    auto&& data = UpdateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures TextLayer::doUpdate() with a varying amount of texts relocated
+       by setText() with a longer text, which the update has to recompact
+       first before generating the vertex and index data. The shaping isn't
+       included, the GPU upload is benchmarked in TextLayerGLBenchmark. */
+
+    Containers::Pointer<Text::AbstractFont> font = openFont("StbTrueTypeFont");
+    if(!font)
+        CORRADE_SKIP("StbTrueTypeFont plugin not found or the font can't be opened.");
+
+    GlyphCache cache{PixelFormat::R8Unorm, {1024, 1024}};
+    CORRADE_VERIFY(font->fillGlyphCache(cache, GlyphCacheCharacters));
+
+    LayerShared shared{cache, TextLayer::Shared::Configuration{1}
+        .setEditingStyleCount(1)};
+    setupStyle(shared, shared.addFont(*font, 16.0f));
+
+    Layer layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    const Containers::String text = textOfLength(65);
+
+    Containers::Array<DataHandle> handles{NoInit, TextBenchmarkTextCount};
+    Containers::Array<UnsignedInt> dataIds{NoInit, TextBenchmarkTextCount};
+    for(UnsignedInt i = 0; i != TextBenchmarkTextCount; ++i) {
+        handles[i] = layer.create(0, text.prefix(64), {}, nodeHandle(0, 1));
+        dataIds[i] = dataHandleId(handles[i]);
+    }
+
+    /* Relocating happens with one more glyph, so the glyph data aren't
+       reused in place */
+    if(data.relocateEvery) for(UnsignedInt i = 0; i < TextBenchmarkTextCount; i += data.relocateEvery)
+        layer.setText(handles[i], text, {});
+
+    Vector2 nodeOffsets[1];
+    Vector2 nodeSizes[1]{{1.0f, 1.0f}};
+    Float nodeOpacities[1]{1.0f};
+    UnsignedByte nodesEnabled[1]{};
+
+    CORRADE_VERIFY(layer.state() >= LayerState::NeedsDataUpdate);
+    CORRADE_BENCHMARK(1)
+        layer.update(layer.state(), dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, Containers::BitArrayView{nodesEnabled, 0, 1}, {}, {}, {}, {});
+
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+}
+
+void TextLayerBenchmark::editText() {
+    auto&& data = EditTextData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the cost of a single keystroke in the middle of a long text,
+       which currently means reshaping the whole text */
+
+    Containers::Pointer<Text::AbstractFont> font = openFont(data.plugin);
+    if(!font)
+        CORRADE_SKIP(data.plugin << "plugin not found or the font can't be opened.");
+
+    GlyphCache cache{PixelFormat::R8Unorm, {1024, 1024}};
+    CORRADE_VERIFY(font->fillGlyphCache(cache, GlyphCacheCharacters));
+
+    LayerShared shared{cache, TextLayer::Shared::Configuration{1}
+        .setEditingStyleCount(1)};
+    setupStyle(shared, shared.addFont(*font, 16.0f));
+
+    Layer layer{layerHandle(0, 1), shared};
+
+    DataHandle handle = layer.create(0, textOfLength(data.textLength), {}, TextDataFlag::Editable);
+    layer.setCursor(handle, data.textLength/2);
+
+    CORRADE_BENCHMARK(10)
+        layer.editText(handle, TextEdit::InsertBeforeCursor, "a");
+
+    CORRADE_COMPARE(layer.text(handle).size(), data.textLength + 10);
+}
+
+void TextLayerBenchmark::fillGlyphCache() {
+    auto&& data = FillGlyphCacheData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the rasterization and atlas packing of the character set
+       used by the builtin style, which is the upfront cost of applying it
+       without TextLayerSharedFlag::GlyphCacheFillOnDemand */
+
+    Containers::Pointer<Text::AbstractFont> font = openFont(data.plugin);
+    if(!font)
+        CORRADE_SKIP(data.plugin << "plugin not found or the font can't be opened.");
+
+    GlyphCache cache{PixelFormat::R8Unorm, {1024, 1024}};
+
+    bool filled = false;
+    CORRADE_BENCHMARK(1)
+        filled = font->fillGlyphCache(cache, GlyphCacheCharacters);
+
+    CORRADE_VERIFY(filled);
+    CORRADE_COMPARE(cache.fontCount(), 1);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::TextLayerBenchmark)
@@ -24,6 +24,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -40,6 +41,7 @@
 #include <Magnum/Text/DistanceFieldGlyphCacheGL.h>
 
 #include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/TextLayerGL.h"
 #include "Magnum/Ui/TextProperties.h"
 #include "Magnum/Ui/RendererGL.h"
@@ -49,9 +51,13 @@ namespace Magnum { namespace Ui { namespace Test { namespace {
 struct TextLayerGLBenchmark: GL::OpenGLTester {
     explicit TextLayerGLBenchmark();
 
-    void setup();
+    void setupVertex();
+    void setupFragment();
     void teardown();
+
+    void vertex();
     void fragment();
+    void upload();
 
     private:
         GL::Texture2D _color{NoCreate};
@@ -60,6 +66,23 @@ struct TextLayerGLBenchmark: GL::OpenGLTester {
 
 using namespace Math::Literals;
 
+constexpr Vector2i VertexBenchmarkSize{128, 128};
+constexpr Vector2i FragmentBenchmarkSize{2048, 2048};
+
+const struct {
+    const char* name;
+    bool distanceField;
+    UnsignedInt dynamicStyleCount;
+    bool drawCursor;
+    const char* text;
+} VertexData[]{
+    {"glyph quads", false, 0, false, "a"},
+    {"glyph quads, dynamic styles", false, 1, false, "a"},
+    {"glyph quads, distance field", true, 0, false, "a"},
+    {"cursor quads", false, 0, true, ""},
+    {"cursor quads, dynamic styles", false, 1, true, ""},
+};
+
 const struct {
     const char* name;
     bool distanceField;
@@ -74,20 +97,64 @@ const struct {
     {"cursor quad, dynamic styles", false, 1, true, ""},
 };
 
+/* Texts every 4 pixels, made of four glyphs each, together with a cursor and
+   a selection if editable */
+constexpr UnsignedInt UploadTextCount = VertexBenchmarkSize.product()/16;
+
+const struct {
+    const char* name;
+    bool distanceField;
+    bool editable;
+    UnsignedInt changedTextCount;
+} UploadData[]{
+    {"nothing changed", false, false, 0},
+    {"one text changed", false, false, 1},
+    {"all texts changed", false, false, UploadTextCount},
+    {"one text changed, distance field", true, false, 1},
+    {"all texts changed, distance field", true, false, UploadTextCount},
+    {"one text changed, editable", false, true, 1},
+    {"all texts changed, editable", false, true, UploadTextCount},
+};
+
 TextLayerGLBenchmark::TextLayerGLBenchmark() {
+    addInstancedBenchmarks({&TextLayerGLBenchmark::vertex}, 10,
+        Containers::arraySize(VertexData),
+        &TextLayerGLBenchmark::setupVertex,
+        &TextLayerGLBenchmark::teardown,
+        BenchmarkType::GpuTime);
+
     addInstancedBenchmarks({&TextLayerGLBenchmark::fragment}, 10,
         Containers::arraySize(FragmentData),
-        &TextLayerGLBenchmark::setup,
+        &TextLayerGLBenchmark::setupFragment,
         &TextLayerGLBenchmark::teardown,
         BenchmarkType::GpuTime);
+
+    addInstancedBenchmarks({&TextLayerGLBenchmark::upload}, 20,
+        Containers::arraySize(UploadData),
+        &TextLayerGLBenchmark::setupVertex,
+        &TextLayerGLBenchmark::teardown);
 }
 
-constexpr Vector2i BenchmarkSize{2048, 2048};
+void TextLayerGLBenchmark::setupVertex() {
+    _color = GL::Texture2D{};
+    _color.setStorage(1, GL::TextureFormat::RGBA8, VertexBenchmarkSize);
+    _framebuffer = GL::Framebuffer{{{}, VertexBenchmarkSize}};
+    _framebuffer
+        .attachTexture(GL::Framebuffer::ColorAttachment{0}, _color, 0)
+        .clear(GL::FramebufferClear::Color)
+        .bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+    /* The RendererGL should enable these on its own if needed */
+    GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
+    GL::Renderer::disable(GL::Renderer::Feature::Blending);
+}
 
-void TextLayerGLBenchmark::setup() {
+void TextLayerGLBenchmark::setupFragment() {
     _color = GL::Texture2D{};
-    _color.setStorage(1, GL::TextureFormat::RGBA8, BenchmarkSize);
-    _framebuffer = GL::Framebuffer{{{}, BenchmarkSize}};
+    _color.setStorage(1, GL::TextureFormat::RGBA8, FragmentBenchmarkSize);
+    _framebuffer = GL::Framebuffer{{{}, FragmentBenchmarkSize}};
     _framebuffer
         .attachTexture(GL::Framebuffer::ColorAttachment{0}, _color, 0)
         .clear(GL::FramebufferClear::Color)
@@ -109,67 +176,66 @@ void TextLayerGLBenchmark::teardown() {
     GL::Renderer::disable(GL::Renderer::Feature::Blending);
 }
 
-void TextLayerGLBenchmark::fragment() {
-    auto&& data = FragmentData[testCaseInstanceId()];
-    setTestCaseDescription(data.name);
-
-    /* Renders a single quad over the whole size to benchmark mainly the
-       fragment shader invocation. The quad is either a glyph or a cursor. */
+/* Shapes each byte to glyph 0 at the same position, i.e. no advance and
+   thus all glyphs of a text drawn over each other */
+struct Shaper: Text::AbstractShaper {
+    using Text::AbstractShaper::AbstractShaper;
 
-    AbstractUserInterface ui{BenchmarkSize};
-    ui.setRendererInstance(Containers::pointer<RendererGL>());
-
-    struct Shaper: Text::AbstractShaper {
-        using Text::AbstractShaper::AbstractShaper;
-
-        UnsignedInt doShape(Containers::StringView string, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
-            return string.size();
-        }
-        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
-            ids[0] = 0;
-        }
-        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
-            offsets[0] = {};
-            advances[0] = {};
-        }
-        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>&) const override {
-            CORRADE_FAIL("This shouldn't be called.");
-        }
-    };
-
-    struct: Text::AbstractFont {
-        Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return _opened; }
-        Properties doOpenFile(Containers::StringView, Float size) override {
-            _opened = true;
-            return {size, 16.0f, -16.0f, 32.0f, 1};
+    UnsignedInt doShape(Containers::StringView string, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
+        return string.size();
+    }
+    void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+        for(std::size_t i = 0; i != ids.size(); ++i)
+            ids[i] = 0;
+    }
+    void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+        for(std::size_t i = 0; i != offsets.size(); ++i) {
+            offsets[i] = {};
+            advances[i] = {};
         }
-        void doClose() override { _opened = false; }
+    }
+    void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+        /* Just a trivial 1:1 mapping, used by editable texts */
+        for(std::size_t i = 0; i != clusters.size(); ++i)
+            clusters[i] = i;
+    }
+};
 
-        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
-        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
-        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<Shaper>(*this); }
+struct Font: Text::AbstractFont {
+    Text::FontFeatures doFeatures() const override { return {}; }
+    bool doIsOpened() const override { return _opened; }
+    Properties doOpenFile(Containers::StringView, Float size) override {
+        _opened = true;
+        return {size, 16.0f, -16.0f, 32.0f, 1};
+    }
+    void doClose() override { _opened = false; }
 
-        bool _opened = false;
-    } font;
-    font.openFile({}, 32.0f);
+    void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+    Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+    Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+    Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<Shaper>(*this); }
+
+    bool _opened = false;
+};
 
+/* Creates a shared state with a cache containing a single all-white glyph
+   covering the font's ascent and descent, optionally with a distance field */
+TextLayerGL::Shared createShared(Font& font, bool distanceField, bool addGlyph, UnsignedInt dynamicStyleCount) {
     Image2D white{PixelFormat::R8Unorm, {32, 32}, Containers::Array<char>{DirectInit, 32*32, '\xff'}};
 
     TextLayerGL::Shared shared{NoCreate};
-    if(!data.distanceField) {
+    if(!distanceField) {
         shared = TextLayerGL::Shared{
             Text::GlyphCacheArrayGL{PixelFormat::R8Unorm, {32, 32, 1}, {}},
             TextLayer::Shared::Configuration{1}
                 .setEditingStyleCount(1)
-                .setDynamicStyleCount(data.dynamicStyleCount)};
+                .setDynamicStyleCount(dynamicStyleCount)};
 
-        /* If not drawing the cursor, add a single all-white glyph spanning the
-           whole cache. Default padding is 1, reset it back to 0 to make this
-           work. */
+        /* If not drawing just the cursor, add a single all-white glyph
+           spanning the whole cache. Default padding is 1, reset it back to 0
+           to make this work. */
         UnsignedInt fontId = shared.glyphCache().addFont(font.glyphCount(), &font);
-        if(!data.drawCursor)
+        if(addGlyph)
             shared.glyphCache().addGlyph(fontId, 0, {-16, -16}, {{}, {32, 32}});
 
         Utility::copy(
@@ -182,17 +248,95 @@ void TextLayerGLBenchmark::fragment() {
             Text::DistanceFieldGlyphCacheArrayGL{{64, 64, 1}, {32, 32}, 2},
             TextLayer::Shared::Configuration{1}
                 .setEditingStyleCount(1)
-                .setDynamicStyleCount(data.dynamicStyleCount)};
+                .setDynamicStyleCount(dynamicStyleCount)};
 
         /* Here it needs to exclude padding. Assuming we don't test cursor
            drawing with distance field enabled because that makes no sense as
            no glyphs are drawn in that case. */
-        CORRADE_INTERNAL_ASSERT(!data.drawCursor);
+        CORRADE_INTERNAL_ASSERT(addGlyph);
         UnsignedInt fontId = shared.glyphCache().addFont(font.glyphCount(), &font);
         shared.glyphCache().addGlyph(fontId, 0, {-30, -30}, {{2, 2}, {60, 60}});
         shared.glyphCache().setProcessedImage({}, white);
     }
 
+    return shared;
+}
+
+void TextLayerGLBenchmark::vertex() {
+    auto&& data = VertexData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Renders one glyph or cursor quad for every pixel to benchmark mainly
+       the vertex shader invocation */
+
+    AbstractUserInterface ui{VertexBenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    Font font;
+    font.openFile({}, 32.0f);
+
+    TextLayerGL::Shared shared = createShared(font, data.distanceField, !data.drawCursor, data.dynamicStyleCount);
+
+    /* The glyph is scaled to a single pixel */
+    FontHandle fontHandle = shared.addFont(font, 1.0f);
+
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}
+            .setColor(0xff3366_rgbf)},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {},
+        {data.drawCursor ? 0 : -1}, {-1}, {});
+    /* The cursor spans the font ascent and descent, i.e. a single pixel
+       vertically, pad it horizontally to a single pixel as well */
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}
+            .setBackgroundColor(0xff3366_rgbf)},
+        {},
+        {{0.5f, 0.0f, 0.5f, 0.0f}});
+
+    TextLayerGL& layer = ui.setLayerInstance(Containers::pointer<TextLayerGL>(ui.createLayer(), shared));
+
+    NodeHandle root = ui.createNode({}, ui.size());
+    for(Int x = 0; x != VertexBenchmarkSize.x(); ++x)
+        for(Int y = 0; y != VertexBenchmarkSize.y(); ++y) {
+            NodeHandle node = ui.createNode(root, {Float(x), Float(y)}, Vector2{1.0f});
+            layer.create(0, data.text, {}, data.drawCursor ? TextDataFlag::Editable : TextDataFlags{}, node);
+        }
+
+    ui.update();
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+
+    CORRADE_BENCHMARK(20)
+        ui.draw();
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Verify just one pixel, the TextLayerGLTest does the rest */
+    Image2D out = _framebuffer.read({{}, VertexBenchmarkSize}, {PixelFormat::RGBA8Unorm});
+    CORRADE_COMPARE_WITH(
+        Math::unpack<Color4>(
+            out.pixels<Color4ub>()[std::size_t(VertexBenchmarkSize.y()/2)]
+                                  [std::size_t(VertexBenchmarkSize.x()/2)]),
+        0xff3366_rgbf,
+        TestSuite::Compare::around(Color4{1.0f/255.0f, 1.0f/255.0f}));
+}
+
+void TextLayerGLBenchmark::fragment() {
+    auto&& data = FragmentData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Renders a single quad over the whole size to benchmark mainly the
+       fragment shader invocation. The quad is either a glyph or a cursor. */
+
+    AbstractUserInterface ui{FragmentBenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    Font font;
+    font.openFile({}, 32.0f);
+
+    TextLayerGL::Shared shared = createShared(font, data.distanceField, !data.drawCursor, data.dynamicStyleCount);
+
     FontHandle fontHandle = shared.addFont(font, 2048.0f);
 
     shared.setStyle(TextLayerCommonStyleUniform{},
@@ -206,12 +350,12 @@ void TextLayerGLBenchmark::fragment() {
         {TextLayerEditingStyleUniform{}
             .setBackgroundColor(0xff3366_rgbf)},
         {},
-        {{BenchmarkSize.x()/2.0f, BenchmarkSize.y()/2.0f,
-          BenchmarkSize.x()/2.0f, BenchmarkSize.y()/2.0f}});
+        {{FragmentBenchmarkSize.x()/2.0f, FragmentBenchmarkSize.y()/2.0f,
+          FragmentBenchmarkSize.x()/2.0f, FragmentBenchmarkSize.y()/2.0f}});
 
     TextLayerGL& layer = ui.setLayerInstance(Containers::pointer<TextLayerGL>(ui.createLayer(), shared));
 
-    NodeHandle node = ui.createNode({}, Vector2{BenchmarkSize});
+    NodeHandle node = ui.createNode({}, Vector2{FragmentBenchmarkSize});
     layer.create(0, data.text, {}, data.drawCursor ? TextDataFlag::Editable : TextDataFlags{}, node);
 
     ui.update();
@@ -225,12 +369,12 @@ void TextLayerGLBenchmark::fragment() {
     /* Verify just a few pixels, the TextLayerGL test does the rest. However
        make sure that the whole area is filled, not just a part, to not have
        skewed benchmark results compared to other layers. */
-    Image2D out = _framebuffer.read({{}, BenchmarkSize}, {PixelFormat::RGBA8Unorm});
+    Image2D out = _framebuffer.read({{}, FragmentBenchmarkSize}, {PixelFormat::RGBA8Unorm});
     for(const Vector2i& coordinate: {Vector2i{0, 0},
-                                     Vector2i{BenchmarkSize.x() - 1, 0},
-                                     Vector2i{0, BenchmarkSize.y() - 1},
-                                     BenchmarkSize - Vector2i{1},
-                                     BenchmarkSize/2})
+                                     Vector2i{FragmentBenchmarkSize.x() - 1, 0},
+                                     Vector2i{0, FragmentBenchmarkSize.y() - 1},
+                                     FragmentBenchmarkSize - Vector2i{1},
+                                     FragmentBenchmarkSize/2})
     {
         CORRADE_ITERATION(coordinate);
         CORRADE_COMPARE_WITH(
@@ -242,6 +386,68 @@ void TextLayerGLBenchmark::fragment() {
     }
 }
 
+void TextLayerGLBenchmark::upload() {
+    auto&& data = UploadData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measures the CPU-side TextLayerGL::doUpdate(), including the vertex
+       and index data generation in TextLayer::doUpdate() and the upload to
+       the GPU buffers. The data change is done by alternating the per-data
+       color, which doesn't change the glyph run layout. For editable texts
+       the cursor and selection geometry is generated and uploaded as
+       well. */
+
+    AbstractUserInterface ui{VertexBenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    Font font;
+    font.openFile({}, 32.0f);
+
+    TextLayerGL::Shared shared = createShared(font, data.distanceField, true, 0);
+
+    FontHandle fontHandle = shared.addFont(font, 4.0f);
+
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {},
+        {data.editable ? 0 : -1}, {data.editable ? 0 : -1}, {});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}},
+        {},
+        {{}});
+
+    TextLayerGL& layer = ui.setLayerInstance(Containers::pointer<TextLayerGL>(ui.createLayer(), shared));
+
+    NodeHandle root = ui.createNode({}, ui.size());
+    Containers::Array<DataHandle> handles{NoInit, UploadTextCount};
+    for(UnsignedInt i = 0; i != UploadTextCount; ++i) {
+        const Vector2 offset{Float(i % (VertexBenchmarkSize.x()/4)),
+                             Float(i / (VertexBenchmarkSize.x()/4))};
+        NodeHandle node = ui.createNode(root, offset*4.0f, Vector2{4.0f});
+        handles[i] = layer.create(0, "abcd", {}, data.editable ? TextDataFlag::Editable : TextDataFlags{}, node);
+        /* Select the middle two glyphs */
+        if(data.editable)
+            layer.setCursor(handles[i], 1, 3);
+    }
+
+    ui.update();
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+
+    UnsignedInt iteration = 0;
+    CORRADE_BENCHMARK(20) {
+        const Color4 color = iteration++ & 1 ? 0xffffff_rgbf : 0xff3366_rgbf;
+        layer.setNeedsUpdate(LayerState::NeedsDataUpdate);
+        for(UnsignedInt i = 0; i != data.changedTextCount; ++i)
+            layer.setColor(handles[i], color);
+        ui.update();
+    }
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::TextLayerGLBenchmark)
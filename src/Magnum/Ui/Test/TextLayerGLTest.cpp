@@ -36,6 +36,8 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/DebugTools/CompareImage.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/OpenGLTester.h>
 #include <Magnum/GL/Texture.h>
@@ -73,6 +75,10 @@ struct TextLayerGLTest: GL::OpenGLTester {
     void sharedConstructCopy();
     void sharedConstructMove();
 
+    void sharedGrowGlyphCache();
+    void sharedGrowGlyphCacheDistanceField();
+    void sharedGrowGlyphCacheNotOwned();
+
     void construct();
     void constructDerived();
     void constructCopy();
@@ -1315,23 +1321,40 @@ const struct {
     bool clip;
     bool singleTopLevel;
     bool flipOrder;
+    TextLayerSharedFlags flags;
 } DrawClippingData[]{
     {"clipping disabled", "clipping-disabled.png",
-        false, false, false, false},
+        false, false, false, false, {}},
     {"clipping top-level nodes", "clipping-enabled.png",
-        false, true, false, false},
+        false, true, false, false, {}},
     {"clipping top-level nodes, different node order", "clipping-enabled.png",
-        false, true, false, true},
+        false, true, false, true, {}},
     {"single top-level node with clipping subnodes", "clipping-enabled.png",
-        false, true, true, false},
+        false, true, true, false, {}},
     {"editable, clipping disabled", "clipping-disabled-editable.png",
-        true, false, false, false},
+        true, false, false, false, {}},
     {"editable, clipping top-level nodes", "clipping-enabled-editable.png",
-        true, true, false, false},
+        true, true, false, false, {}},
     {"editable, clipping top-level nodes, different node order", "clipping-enabled-editable.png",
-        true, true, false, true},
+        true, true, false, true, {}},
     {"editable, single top-level node with clipping subnodes", "clipping-enabled-editable.png",
-        true, true, true, false},
+        true, true, true, false, {}},
+    {"clipping disabled, shader clipping", "clipping-disabled.png",
+        false, false, false, false, TextLayerSharedFlag::ShaderClipping},
+    {"clipping top-level nodes, different node order, shader clipping", "clipping-enabled.png",
+        false, true, false, true, TextLayerSharedFlag::ShaderClipping},
+    {"single top-level node with clipping subnodes, shader clipping", "clipping-enabled.png",
+        false, true, true, false, TextLayerSharedFlag::ShaderClipping},
+    {"editable, clipping top-level nodes, different node order, shader clipping", "clipping-enabled-editable.png",
+        true, true, false, true, TextLayerSharedFlag::ShaderClipping},
+    {"editable, single top-level node with clipping subnodes, shader clipping", "clipping-enabled-editable.png",
+        true, true, true, false, TextLayerSharedFlag::ShaderClipping},
+    {"clipping top-level nodes, different node order, instanced glyphs", "clipping-enabled.png",
+        false, true, false, true, TextLayerSharedFlag::InstancedGlyphs},
+    {"editable, single top-level node with clipping subnodes, instanced glyphs", "clipping-enabled-editable.png",
+        true, true, true, false, TextLayerSharedFlag::InstancedGlyphs},
+    {"editable, clipping top-level nodes, different node order, shader clipping, instanced glyphs", "clipping-enabled-editable.png",
+        true, true, false, true, TextLayerSharedFlag::ShaderClipping|TextLayerSharedFlag::InstancedGlyphs},
 };
 
 const struct {
@@ -1393,6 +1416,10 @@ TextLayerGLTest::TextLayerGLTest() {
               &TextLayerGLTest::sharedConstructCopy,
               &TextLayerGLTest::sharedConstructMove,
 
+              &TextLayerGLTest::sharedGrowGlyphCache,
+              &TextLayerGLTest::sharedGrowGlyphCacheDistanceField,
+              &TextLayerGLTest::sharedGrowGlyphCacheNotOwned,
+
               &TextLayerGLTest::construct,
               &TextLayerGLTest::constructDerived,
               &TextLayerGLTest::constructCopy,
@@ -1612,6 +1639,81 @@ void TextLayerGLTest::sharedConstructMove() {
     CORRADE_VERIFY(std::is_nothrow_move_assignable<TextLayerGL::Shared>::value);
 }
 
+void TextLayerGLTest::sharedGrowGlyphCache() {
+    /* Zero padding for simplicity */
+    Text::GlyphCacheArrayGL cache{PixelFormat::R8Unorm, {8, 8, 1}, {}};
+    UnsignedInt fontId = cache.addFont(5);
+    cache.addGlyph(fontId, 3, {1, 2}, 0, {{2, 2}, {6, 6}});
+    cache.image().pixels<UnsignedByte>()[0][3][4] = 0xcc;
+    cache.flushImage(0, {{2, 2}, {6, 6}});
+
+    TextLayerGL::Shared shared{Utility::move(cache), TextLayer::Shared::Configuration{1}};
+    Text::AbstractGlyphCache& glyphCache = shared.glyphCache();
+
+    CORRADE_VERIFY(shared.growGlyphCache(2));
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    /* The instance stays at the same location */
+    CORRADE_COMPARE(&shared.glyphCache(), &glyphCache);
+    CORRADE_COMPARE(glyphCache.size(), (Vector3i{8, 8, 3}));
+    CORRADE_COMPARE(glyphCache.format(), PixelFormat::R8Unorm);
+
+    /* Fonts and glyphs are preserved, including their IDs */
+    CORRADE_COMPARE(glyphCache.fontCount(), 1);
+    CORRADE_COMPARE(glyphCache.fontGlyphCount(0), 5);
+    CORRADE_COMPARE(glyphCache.glyphCount(), 2);
+    CORRADE_COMPARE(glyphCache.glyphId(0, 3), 1);
+    CORRADE_COMPARE(glyphCache.glyph(1).first(), (Vector2i{1, 2}));
+    CORRADE_COMPARE(glyphCache.glyph(1).second(), 0);
+    CORRADE_COMPARE(glyphCache.glyph(1).third(), (Range2Di{{2, 2}, {6, 6}}));
+
+    /* The image contents are preserved as well */
+    CORRADE_COMPARE(glyphCache.image().pixels<UnsignedByte>()[0][3][4], 0xcc);
+    #ifndef MAGNUM_TARGET_GLES
+    Image3D image = static_cast<Text::GlyphCacheArrayGL&>(glyphCache).texture().image(0, {PixelFormat::R8Unorm});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(image.size(), (Vector3i{8, 8, 3}));
+    CORRADE_COMPARE(image.pixels<UnsignedByte>()[0][3][4], 0xcc);
+    #endif
+
+    /* The original layer is treated as full, new glyphs go to the added
+       ones */
+    const Vector2i sizes[]{{2, 2}};
+    Vector3i offsets[1];
+    CORRADE_VERIFY(glyphCache.atlas().add(sizes, offsets));
+    CORRADE_COMPARE(offsets[0].z(), 1);
+}
+
+void TextLayerGLTest::sharedGrowGlyphCacheDistanceField() {
+    Text::DistanceFieldGlyphCacheArrayGL cache{{16, 16, 1}, {4, 4}, 4};
+    UnsignedInt fontId = cache.addFont(5);
+    cache.addGlyph(fontId, 3, {1, 2}, 0, {{4, 4}, {12, 12}});
+
+    TextLayerGL::Shared shared{Utility::move(cache), TextLayer::Shared::Configuration{1}};
+    Text::AbstractGlyphCache& glyphCache = shared.glyphCache();
+
+    CORRADE_VERIFY(shared.growGlyphCache(1));
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(&shared.glyphCache(), &glyphCache);
+    CORRADE_COMPARE(glyphCache.size(), (Vector3i{16, 16, 2}));
+    CORRADE_COMPARE(glyphCache.processedSize(), (Vector3i{4, 4, 2}));
+    CORRADE_COMPARE(static_cast<Text::DistanceFieldGlyphCacheArrayGL&>(glyphCache).radius(), 4);
+    CORRADE_COMPARE(shared.flags(), TextLayerSharedFlag::DistanceField);
+
+    CORRADE_COMPARE(glyphCache.glyphCount(), 2);
+    CORRADE_COMPARE(glyphCache.glyphId(0, 3), 1);
+    CORRADE_COMPARE(glyphCache.glyph(1).third(), (Range2Di{{4, 4}, {12, 12}}));
+}
+
+void TextLayerGLTest::sharedGrowGlyphCacheNotOwned() {
+    Text::GlyphCacheArrayGL cache{PixelFormat::R8Unorm, {8, 8, 1}};
+    TextLayerGL::Shared shared{cache, TextLayer::Shared::Configuration{1}};
+
+    /* A referenced cache can't be replaced */
+    CORRADE_VERIFY(!shared.growGlyphCache(1));
+    CORRADE_COMPARE(&shared.glyphCache(), &cache);
+    CORRADE_COMPARE(cache.size(), (Vector3i{8, 8, 1}));
+}
+
 void TextLayerGLTest::construct() {
     Text::GlyphCacheArrayGL cache{PixelFormat::R8Unorm, {8, 8, 2}};
     TextLayerGL::Shared shared{cache, TextLayer::Shared::Configuration{3}};
@@ -3018,6 +3120,11 @@ void TextLayerGLTest::drawClipping() {
     auto&& data = DrawClippingData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
+    #ifndef MAGNUM_TARGET_GLES
+    if(data.flags >= TextLayerSharedFlag::InstancedGlyphs && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #endif
+
     /* Based on BaseLayerGLTest::drawClipping(), with additional variability
        due to each text having a different size, and editing styles included.
 
@@ -3086,6 +3193,7 @@ void TextLayerGLTest::drawClipping() {
 
     TextLayerGL::Shared layerShared{cache, TextLayer::Shared::Configuration{3, 5}
         .setEditingStyleCount(6)
+        .setFlags(data.flags)
     };
 
     FontHandle fontHandleLarge = layerShared.addFont(font, 160.0f);
@@ -31,6 +31,7 @@
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/StridedBitArrayView.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringIterable.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
@@ -54,6 +55,7 @@
 #include "Magnum/Ui/NodeFlags.h"
 #include "Magnum/Ui/TextLayer.h"
 #include "Magnum/Ui/TextProperties.h"
+#include "Magnum/Ui/Implementation/runCompaction.h"
 /* for dynamicStyle(), createRemoveSetText(), updateCleanDataOrder(),
    updateAlignment(), updateAlignmentGlyph(), updatePadding() and
    updatePaddingGlyph() */
@@ -107,6 +109,7 @@ struct TextLayerTest: TestSuite::Tester {
     void sharedConfigurationSetters();
     void sharedConfigurationSettersSameEditingStyleUniformCount();
     void sharedConfigurationSettersInvalidEditingStyleOrUniformCount();
+    void sharedConfigurationSettersInvalidShaperCount();
 
     void sharedConstruct();
     void sharedConstructNoCreate();
@@ -123,6 +126,9 @@ struct TextLayerTest: TestSuite::Tester {
     void sharedFontInvalidHandle();
     void sharedFontNoInstance();
 
+    void sharedGrowGlyphCacheNotImplemented();
+    void sharedGrowGlyphCacheZeroLayers();
+
     void sharedSetStyle();
     void sharedSetStyleImplicitFeatures();
     void sharedSetStyleImplicitEditingStyles();
@@ -147,9 +153,14 @@ struct TextLayerTest: TestSuite::Tester {
     void sharedSetEditingStyleImplicitMappingImplicitTextUniforms();
     void sharedSetEditingStyleImplicitMappingInvalidSize();
 
+    void sharedSetStyleUniforms();
+    void sharedSetEditingStyleUniforms();
+    void sharedSetStyleUniformsInvalid();
+
     void construct();
     void constructCopy();
     void constructMove();
+    void constructGlyphCullingInvalid();
 
     void dynamicStyle();
     void dynamicStyleFeatureAllocation();
@@ -166,6 +177,7 @@ struct TextLayerTest: TestSuite::Tester {
     void setCursor();
     void setCursorInvalid();
     void updateText();
+    void updateTextMultiline();
     void updateTextInvalid();
     void editText();
     void editTextInvalid();
@@ -175,12 +187,25 @@ struct TextLayerTest: TestSuite::Tester {
     void createSetTextTextProperties();
     void createSetTextTextPropertiesEditable();
     void createSetTextTextPropertiesEditableInvalid();
+    void createSetTextShapeCache();
+    void createSetTextGlyphCacheFillOnDemand();
+    void createSetTextGlyphCacheFillDeferred();
+    void createSetTextGlyphCacheGrowOnDemand();
+    void createSetTextDeferShaping();
+    void createSetTextDeferShapingEditable();
+    void createSetTextWrapEditable();
+    void measure();
+    void measureInvalid();
+    void setTextMultiple();
+    void setTextMultipleInvalid();
+    void setTextMultipleConcurrent();
 
     void createSetUpdateTextFromLayerItself();
 
     void setColor();
     void setPadding();
     void setPaddingInvalid();
+    void setColorPaddingMultipleInvalid();
     void setTransformation();
     void setTransformationInvalid();
 
@@ -198,17 +223,21 @@ struct TextLayerTest: TestSuite::Tester {
 
     void updateEmpty();
     void updateCleanDataOrder();
+    void updateCompactionLargeData();
     void updateAlignment();
     void updateAlignmentGlyph();
     void updatePadding();
     void updatePaddingGlyph();
     void updateTransformation();
+    void updateWrap();
+    void updateGlyphCulling();
     void updateNoStyleSet();
     void updateNoEditingStyleSet();
 
     void sharedNeedsUpdateStatePropagatedToLayers();
 
     void keyTextEvent();
+    void pointerEventCursorSelection();
     void keyTextEventSynthesizedFromPointerPress();
 };
 
@@ -227,7 +256,8 @@ const struct {
     TextLayerFlags layerFlags;
 } ConstructData[]{
     {"", {}},
-    {"transformable", TextLayerFlag::Transformable}
+    {"transformable", TextLayerFlag::Transformable},
+    {"glyph culling", TextLayerFlag::GlyphCulling}
 };
 
 const struct {
@@ -619,6 +649,14 @@ const struct {
         "vertical shape direction for an editable text is not implemented yet, sorry"},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt shapeCacheSize;
+} MeasureData[]{
+    {"", 0},
+    {"shape cache", 4},
+};
+
 const struct {
     TestSuite::TestCaseDescriptionSourceLocation name;
     Text::ShapeDirection shapeDirection;
@@ -1002,6 +1040,18 @@ const struct {
         {1.0f, 2.0f}, {10.0f, 15.0f}, {}, {}, {},
         {}, {}, {-1, -1}, {-1, -1}, {-1, -1},
         LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsNodeOpacityUpdate, false, true, false},
+    {"shader node opacity", false, 6, 0, 0, false,
+        TextLayerSharedFlag::ShaderNodeOpacity, {},
+        {1.0f, 2.0f}, {10.0f, 15.0f}, {}, {}, {},
+        {}, {}, {-1, -1}, {-1, -1}, {-1, -1},
+        LayerState::NeedsDataUpdate, true, true, false},
+    /* With shader node opacity the opacity alone doesn't cause the vertex
+       data to be touched at all, so it can be tested in isolation */
+    {"shader node opacity, node opacity update only", false, 6, 0, 0, false,
+        TextLayerSharedFlag::ShaderNodeOpacity, {},
+        {1.0f, 2.0f}, {10.0f, 15.0f}, {}, {}, {},
+        {}, {}, {-1, -1}, {-1, -1}, {-1, -1},
+        LayerState::NeedsNodeOpacityUpdate, false, false, false},
     /* These two shouldn't cause anything to be done in update(), and also no
        crashes */
     {"shared data update only", false, 6, 0, 0, false, {}, {},
@@ -1088,6 +1138,13 @@ const struct {
         {2, 5}, {1, 1},
         {-1, 1}, {1, 0}, {2, 0},
         LayerState::NeedsDataUpdate, true, true, true},
+    /* The editing quads still have the opacity baked in */
+    {"editable, shader node opacity", false, 6, 3, 0, false,
+        TextLayerSharedFlag::ShaderNodeOpacity, {},
+        {1.0f, 2.0f}, {10.0f, 15.0f}, {}, {}, TextDataFlag::Editable,
+        {2, 5}, {1, 1},
+        {-1, 1}, {1, 0}, {2, 0},
+        LayerState::NeedsDataUpdate, true, true, true},
     {"editable, different selection direction", false, 6, 3, 0, false, {}, {},
         {1.0f, 2.0f}, {10.0f, 15.0f}, {}, {}, TextDataFlag::Editable,
         {5, 2}, {1, 1},
@@ -1281,6 +1338,86 @@ const struct {
         Matrix3::translation({2.5f, -15.0f})*
         Matrix3::rotation(35.0_degf)*
         Matrix3::scaling(Vector2{2.5f})},
+    {"instanced glyphs",
+        TextLayerSharedFlag::InstancedGlyphs, {},
+        {}, {}, 1.0f, Matrix3{Math::IdentityInit}},
+    {"instanced glyphs + distance field",
+        TextLayerSharedFlag::InstancedGlyphs|TextLayerSharedFlag::DistanceField, {},
+        {}, {}, 1.0f, Matrix3{Math::IdentityInit}},
+    {"instanced glyphs, transformable, translation + rotation + scaling",
+        TextLayerSharedFlag::InstancedGlyphs, TextLayerFlag::Transformable,
+        {2.5f, -15.0f}, 35.0_degf, 2.5f,
+        Matrix3::translation({2.5f, -15.0f})*
+        Matrix3::rotation(35.0_degf)*
+        Matrix3::scaling(Vector2{2.5f})},
+    {"instanced glyphs, transformable + distance field, translation + rotation + scaling",
+        TextLayerSharedFlag::InstancedGlyphs|TextLayerSharedFlag::DistanceField, TextLayerFlag::Transformable,
+        {2.5f, -15.0f}, 35.0_degf, 2.5f,
+        Matrix3::translation({2.5f, -15.0f})*
+        Matrix3::rotation(35.0_degf)*
+        Matrix3::scaling(Vector2{2.5f})},
+    {"shader transformation",
+        TextLayerSharedFlag::ShaderTransformation, {},
+        {}, {}, 1.0f, Matrix3{Math::IdentityInit}},
+    {"shader transformation, transformable, translation + rotation + scaling",
+        TextLayerSharedFlag::ShaderTransformation, TextLayerFlag::Transformable,
+        {2.5f, -15.0f}, 35.0_degf, 2.5f,
+        Matrix3::translation({2.5f, -15.0f})*
+        Matrix3::rotation(35.0_degf)*
+        Matrix3::scaling(Vector2{2.5f})},
+    {"shader transformation, transformable + distance field, translation + rotation + scaling",
+        TextLayerSharedFlag::ShaderTransformation|TextLayerSharedFlag::DistanceField, TextLayerFlag::Transformable,
+        {2.5f, -15.0f}, 35.0_degf, 2.5f,
+        Matrix3::translation({2.5f, -15.0f})*
+        Matrix3::rotation(35.0_degf)*
+        Matrix3::scaling(Vector2{2.5f})},
+    {"instanced glyphs, shader transformation, transformable + distance field, translation + rotation + scaling",
+        TextLayerSharedFlag::InstancedGlyphs|TextLayerSharedFlag::ShaderTransformation|TextLayerSharedFlag::DistanceField, TextLayerFlag::Transformable,
+        {2.5f, -15.0f}, 35.0_degf, 2.5f,
+        Matrix3::translation({2.5f, -15.0f})*
+        Matrix3::rotation(35.0_degf)*
+        Matrix3::scaling(Vector2{2.5f})},
+};
+
+const struct {
+    const char* name;
+    const char* text;
+    Text::Alignment alignment;
+    Float width;
+    /* Offset of each glyph compared to the same text without
+       TextDataFlag::Wrap, Y down. Each glyph is 1 unit wide and the line
+       advance is 4. */
+    Vector2 offsets[9];
+} UpdateWrapData[]{
+    {"fits", "ab cd ef", Text::Alignment::TopLeft, 100.0f,
+        {}},
+    {"top left", "ab cd ef", Text::Alignment::TopLeft, 5.5f,
+        {{}, {}, {}, {}, {}, {},
+         {-6.0f, 4.0f}, {-6.0f, 4.0f}}},
+    {"top right", "ab cd ef", Text::Alignment::TopRight, 5.5f,
+        /* The trailing space on the first line isn't counted into the line
+           width */
+        {{3.0f, 0.0f}, {3.0f, 0.0f}, {3.0f, 0.0f},
+         {3.0f, 0.0f}, {3.0f, 0.0f}, {3.0f, 0.0f},
+         {0.0f, 4.0f}, {0.0f, 4.0f}}},
+    {"bottom center", "ab cd ef", Text::Alignment::BottomCenter, 5.5f,
+        /* The block grows upwards */
+        {{1.5f, -4.0f}, {1.5f, -4.0f}, {1.5f, -4.0f},
+         {1.5f, -4.0f}, {1.5f, -4.0f}, {1.5f, -4.0f},
+         {-3.0f, 0.0f}, {-3.0f, 0.0f}}},
+    {"middle center", "ab cd ef", Text::Alignment::MiddleCenter, 5.5f,
+        {{1.5f, -2.0f}, {1.5f, -2.0f}, {1.5f, -2.0f},
+         {1.5f, -2.0f}, {1.5f, -2.0f}, {1.5f, -2.0f},
+         {-3.0f, 2.0f}, {-3.0f, 2.0f}}},
+    {"word longer than the width", "abcdef gh", Text::Alignment::TopLeft, 2.5f,
+        /* The word stays on a single line */
+        {{}, {}, {}, {}, {}, {}, {},
+         {-7.0f, 4.0f}, {-7.0f, 4.0f}}},
+    {"newline", "ab cd\nef", Text::Alignment::TopLeft, 3.5f,
+        /* The line after the newline is moved down as well */
+        {{}, {}, {},
+         {-3.0f, 4.0f}, {-3.0f, 4.0f},
+         {0.0f, 4.0f}, {0.0f, 4.0f}}},
 };
 
 const struct {
@@ -1362,6 +1499,7 @@ TextLayerTest::TextLayerTest() {
               &TextLayerTest::sharedConfigurationSetters,
               &TextLayerTest::sharedConfigurationSettersSameEditingStyleUniformCount,
               &TextLayerTest::sharedConfigurationSettersInvalidEditingStyleOrUniformCount,
+              &TextLayerTest::sharedConfigurationSettersInvalidShaperCount,
 
               &TextLayerTest::sharedConstruct,
               &TextLayerTest::sharedConstructNoCreate,
@@ -1376,7 +1514,10 @@ TextLayerTest::TextLayerTest() {
               &TextLayerTest::sharedAddFontNoHandlesLeft,
               &TextLayerTest::sharedAddInstancelessFontHasInstance,
               &TextLayerTest::sharedFontInvalidHandle,
-              &TextLayerTest::sharedFontNoInstance});
+              &TextLayerTest::sharedFontNoInstance,
+
+              &TextLayerTest::sharedGrowGlyphCacheNotImplemented,
+              &TextLayerTest::sharedGrowGlyphCacheZeroLayers});
 
     addInstancedTests({&TextLayerTest::sharedSetStyle,
                        &TextLayerTest::sharedSetStyleImplicitFeatures,
@@ -1408,11 +1549,18 @@ TextLayerTest::TextLayerTest() {
                        &TextLayerTest::sharedSetEditingStyleImplicitMappingInvalidSize},
         Containers::arraySize(SharedSetStyleData));
 
+    addInstancedTests({&TextLayerTest::sharedSetStyleUniforms,
+                       &TextLayerTest::sharedSetEditingStyleUniforms},
+        Containers::arraySize(SharedSetStyleData));
+
+    addTests({&TextLayerTest::sharedSetStyleUniformsInvalid});
+
     addInstancedTests({&TextLayerTest::construct},
         Containers::arraySize(ConstructData));
 
     addTests({&TextLayerTest::constructCopy,
-              &TextLayerTest::constructMove});
+              &TextLayerTest::constructMove,
+              &TextLayerTest::constructGlyphCullingInvalid});
 
     addInstancedTests({&TextLayerTest::dynamicStyle},
         Containers::arraySize(DynamicStyleData));
@@ -1444,6 +1592,7 @@ TextLayerTest::TextLayerTest() {
     addTests({&TextLayerTest::setCursor,
               &TextLayerTest::setCursorInvalid,
               &TextLayerTest::updateText,
+              &TextLayerTest::updateTextMultiline,
               &TextLayerTest::updateTextInvalid});
 
     addInstancedTests({&TextLayerTest::editText},
@@ -1462,11 +1611,28 @@ TextLayerTest::TextLayerTest() {
     addInstancedTests({&TextLayerTest::createSetTextTextPropertiesEditableInvalid},
         Containers::arraySize(CreateSetTextTextPropertiesEditableInvalidData));
 
+    addTests({&TextLayerTest::createSetTextShapeCache,
+              &TextLayerTest::createSetTextGlyphCacheFillOnDemand,
+              &TextLayerTest::createSetTextGlyphCacheFillDeferred,
+              &TextLayerTest::createSetTextGlyphCacheGrowOnDemand,
+              &TextLayerTest::createSetTextDeferShaping,
+              &TextLayerTest::createSetTextDeferShapingEditable,
+              &TextLayerTest::createSetTextWrapEditable});
+
+    addInstancedTests({&TextLayerTest::measure},
+        Containers::arraySize(MeasureData));
+
+    addTests({&TextLayerTest::measureInvalid,
+              &TextLayerTest::setTextMultiple,
+              &TextLayerTest::setTextMultipleInvalid,
+              &TextLayerTest::setTextMultipleConcurrent});
+
     addRepeatedTests({&TextLayerTest::createSetUpdateTextFromLayerItself}, 10);
 
     addTests({&TextLayerTest::setColor,
               &TextLayerTest::setPadding,
               &TextLayerTest::setPaddingInvalid,
+              &TextLayerTest::setColorPaddingMultipleInvalid,
               &TextLayerTest::setTransformation,
               &TextLayerTest::setTransformationInvalid,
 
@@ -1484,6 +1650,8 @@ TextLayerTest::TextLayerTest() {
     addInstancedTests({&TextLayerTest::updateCleanDataOrder},
         Containers::arraySize(UpdateCleanDataOrderData));
 
+    addTests({&TextLayerTest::updateCompactionLargeData});
+
     addInstancedTests({&TextLayerTest::updateAlignment,
                        &TextLayerTest::updateAlignmentGlyph,
                        &TextLayerTest::updatePadding,
@@ -1493,6 +1661,11 @@ TextLayerTest::TextLayerTest() {
     addInstancedTests({&TextLayerTest::updateTransformation},
         Containers::arraySize(UpdateTransformationData));
 
+    addInstancedTests({&TextLayerTest::updateWrap},
+        Containers::arraySize(UpdateWrapData));
+
+    addTests({&TextLayerTest::updateGlyphCulling});
+
     addInstancedTests({&TextLayerTest::updateNoStyleSet,
                        &TextLayerTest::updateNoEditingStyleSet},
         Containers::arraySize(CreateUpdateNoStyleSetData));
@@ -1500,7 +1673,8 @@ TextLayerTest::TextLayerTest() {
     addInstancedTests({&TextLayerTest::sharedNeedsUpdateStatePropagatedToLayers},
         Containers::arraySize(SharedNeedsUpdateStatePropagatedToLayersData));
 
-    addTests({&TextLayerTest::keyTextEvent});
+    addTests({&TextLayerTest::keyTextEvent,
+              &TextLayerTest::pointerEventCursorSelection});
 
     addInstancedTests({&TextLayerTest::keyTextEventSynthesizedFromPointerPress},
         Containers::arraySize(KeyTextEventSynthesizedFromPointerPressData));
@@ -1850,20 +2024,20 @@ void TextLayerTest::debugLayerFlag() {
 
 void TextLayerTest::debugLayerFlags() {
     Containers::String out;
-    Debug{&out} << (TextLayerFlag::Transformable|TextLayerFlag(0xa0)) << TextLayerFlags{};
-    CORRADE_COMPARE(out, "Ui::TextLayerFlag::Transformable|Ui::TextLayerFlag(0xa0) Ui::TextLayerFlags{}\n");
+    Debug{&out} << (TextLayerFlag::Transformable|TextLayerFlag::GlyphCulling|TextLayerFlag(0xa0)) << TextLayerFlags{};
+    CORRADE_COMPARE(out, "Ui::TextLayerFlag::Transformable|Ui::TextLayerFlag::GlyphCulling|Ui::TextLayerFlag(0xa0) Ui::TextLayerFlags{}\n");
 }
 
 void TextLayerTest::debugDataFlag() {
     Containers::String out;
-    Debug{&out} << TextDataFlag::Editable << TextDataFlag(0xbe);
-    CORRADE_COMPARE(out, "Ui::TextDataFlag::Editable Ui::TextDataFlag(0xbe)\n");
+    Debug{&out} << TextDataFlag::DeferShaping << TextDataFlag(0xbe);
+    CORRADE_COMPARE(out, "Ui::TextDataFlag::DeferShaping Ui::TextDataFlag(0xbe)\n");
 }
 
 void TextLayerTest::debugDataFlags() {
     Containers::String out;
-    Debug{&out} << (TextDataFlag::Editable|TextDataFlag(0xa0)) << TextDataFlags{};
-    CORRADE_COMPARE(out, "Ui::TextDataFlag::Editable|Ui::TextDataFlag(0xa0) Ui::TextDataFlags{}\n");
+    Debug{&out} << (TextDataFlag::Editable|TextDataFlag::DeferShaping|TextDataFlag::Wrap|TextDataFlag(0xa0)) << TextDataFlags{};
+    CORRADE_COMPARE(out, "Ui::TextDataFlag::Editable|Ui::TextDataFlag::DeferShaping|Ui::TextDataFlag::Wrap|Ui::TextDataFlag(0xa0) Ui::TextDataFlags{}\n");
 }
 
 void TextLayerTest::debugEdit() {
@@ -1880,8 +2054,8 @@ void TextLayerTest::sharedDebugFlag() {
 
 void TextLayerTest::sharedDebugFlags() {
     Containers::String out;
-    Debug{&out} << (TextLayerSharedFlag::DistanceField|TextLayerSharedFlag(0x80)) << TextLayerSharedFlags{};
-    CORRADE_COMPARE(out, "Ui::TextLayerSharedFlag::DistanceField|Ui::TextLayerSharedFlag(0x80) Ui::TextLayerSharedFlags{}\n");
+    Debug{&out} << (TextLayerSharedFlag::DistanceField|TextLayerSharedFlag::GlyphCacheGrowOnDemand) << TextLayerSharedFlags{};
+    CORRADE_COMPARE(out, "Ui::TextLayerSharedFlag::DistanceField|Ui::TextLayerSharedFlag::GlyphCacheGrowOnDemand Ui::TextLayerSharedFlags{}\n");
 }
 
 void TextLayerTest::sharedConfigurationConstruct() {
@@ -1939,10 +2113,14 @@ void TextLayerTest::sharedConfigurationSetters() {
     CORRADE_COMPARE(configuration.dynamicStyleCount(), 0);
     CORRADE_COMPARE(configuration.hasEditingStyles(), false);
     CORRADE_COMPARE(configuration.flags(), TextLayerSharedFlags{});
+    CORRADE_COMPARE(configuration.shapeCacheSize(), 0);
+    CORRADE_COMPARE(configuration.shaperCount(), 1);
 
     configuration
         .setEditingStyleCount(2, 7)
         .setDynamicStyleCount(9)
+        .setShapeCacheSize(256)
+        .setShaperCount(4)
         .setFlags(TextLayerSharedFlag::DistanceField)
         .addFlags(TextLayerSharedFlag(0xe0))
         .clearFlags(TextLayerSharedFlag(0x70));
@@ -1951,6 +2129,8 @@ void TextLayerTest::sharedConfigurationSetters() {
     CORRADE_COMPARE(configuration.dynamicStyleCount(), 9);
     CORRADE_COMPARE(configuration.hasEditingStyles(), true);
     CORRADE_COMPARE(configuration.flags(), TextLayerSharedFlag::DistanceField|TextLayerSharedFlag(0x80));
+    CORRADE_COMPARE(configuration.shapeCacheSize(), 256);
+    CORRADE_COMPARE(configuration.shaperCount(), 4);
 
     /* Disabling dynamic editing styles if there's non-zero editing style count
        is a no-op */
@@ -2031,6 +2211,17 @@ void TextLayerTest::sharedConfigurationSettersInvalidEditingStyleOrUniformCount(
         TestSuite::Compare::String);
 }
 
+void TextLayerTest::sharedConfigurationSettersInvalidShaperCount() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    TextLayer::Shared::Configuration configuration{2, 3};
+
+    Containers::String out;
+    Error redirectError{&out};
+    configuration.setShaperCount(0);
+    CORRADE_COMPARE(out, "Ui::TextLayer::Shared::Configuration::setShaperCount(): expected a non-zero count\n");
+}
+
 void TextLayerTest::sharedConstruct() {
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
@@ -2567,6 +2758,55 @@ void TextLayerTest::sharedFontNoInstance() {
     CORRADE_COMPARE(out, "Ui::TextLayer::Shared::font(): Ui::FontHandle(0x1, 0x1) is an instance-less font\n");
 }
 
+void TextLayerTest::sharedGrowGlyphCacheNotImplemented() {
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+
+    struct Shared: TextLayer::Shared {
+        explicit Shared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{3, 5}};
+
+    /* The default implementation doesn't support growing, the cache stays
+       as it was */
+    CORRADE_VERIFY(!shared.growGlyphCache(1));
+    CORRADE_COMPARE(&shared.glyphCache(), &cache);
+    CORRADE_COMPARE(cache.size(), (Vector3i{32, 32, 2}));
+}
+
+void TextLayerTest::sharedGrowGlyphCacheZeroLayers() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+
+    struct Shared: TextLayer::Shared {
+        explicit Shared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+        bool doGrowGlyphCache(UnsignedInt) override {
+            CORRADE_FAIL("This shouldn't get called.");
+            return {};
+        }
+    } shared{cache, TextLayer::Shared::Configuration{3, 5}};
+
+    Containers::String out;
+    Error redirectError{&out};
+    shared.growGlyphCache(0);
+    CORRADE_COMPARE(out, "Ui::TextLayer::Shared::growGlyphCache(): expected a non-zero layer count\n");
+}
+
 void TextLayerTest::sharedSetStyle() {
     auto&& data = SharedSetStyleData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -4847,6 +5087,220 @@ void TextLayerTest::sharedSetEditingStyleImplicitMappingInvalidSize() {
         "Ui::TextLayer::Shared::setEditingStyle(): there's 3 uniforms for 5 styles, provide an explicit mapping\n");
 }
 
+void TextLayerTest::sharedSetStyleUniforms() {
+    auto&& data = SharedSetStyleData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32}};
+
+    struct Shared: TextLayer::Shared {
+        explicit Shared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        State& state() { return static_cast<State&>(*_state); }
+
+        void doSetStyle(const TextLayerCommonStyleUniform& commonUniform, Containers::ArrayView<const TextLayerStyleUniform> uniforms) override {
+            CORRADE_COMPARE(uniforms.size(), 3);
+            lastSmoothness = commonUniform.smoothness;
+            lastColor = uniforms[1].color;
+            ++setStyleCalled;
+        }
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {
+            CORRADE_FAIL("This shouldn't be called.");
+        }
+
+        Int setStyleCalled = 0;
+        Float lastSmoothness{};
+        Color4 lastColor;
+    } shared{cache, TextLayer::Shared::Configuration{3, 5}
+        .setDynamicStyleCount(data.dynamicStyleCount)
+    };
+
+    shared.setStyle(
+        TextLayerCommonStyleUniform{}
+            .setSmoothness(3.14f),
+        {TextLayerStyleUniform{},
+         TextLayerStyleUniform{}
+            .setColor(0xc0ffee_rgbf),
+         TextLayerStyleUniform{}},
+        {2, 1, 0, 0, 1},
+        {FontHandle::Null, FontHandle::Null, FontHandle::Null, FontHandle::Null, FontHandle::Null},
+        {Text::Alignment::MiddleLeft,
+         Text::Alignment::TopRight,
+         Text::Alignment::BottomRight,
+         Text::Alignment::LineLeft,
+         Text::Alignment::LineCenterIntegral},
+        {}, {}, {}, {}, {}, {});
+    UnsignedShort styleUpdateStamp = shared.state().styleUpdateStamp;
+    UnsignedShort editingStyleUpdateStamp = shared.state().editingStyleUpdateStamp;
+
+    shared.setStyleUniforms(
+        TextLayerCommonStyleUniform{}
+            .setSmoothness(1.5f),
+        {TextLayerStyleUniform{},
+         TextLayerStyleUniform{}
+            .setColor(0xdeadbe_rgbf),
+         TextLayerStyleUniform{}});
+    if(data.dynamicStyleCount == 0) {
+        /* The uniforms get uploaded directly, the layers don't need to do
+           anything */
+        CORRADE_COMPARE(shared.setStyleCalled, 2);
+        CORRADE_COMPARE(shared.lastSmoothness, 1.5f);
+        CORRADE_COMPARE(shared.lastColor, 0xdeadbe_rgbf);
+        CORRADE_COMPARE(shared.state().styleUpdateStamp, styleUpdateStamp);
+    } else {
+        /* With dynamic styles the uniforms are copied to an internal array
+           and each layer has to combine them with dynamic styles again */
+        CORRADE_COMPARE(shared.setStyleCalled, 0);
+        CORRADE_COMPARE(shared.state().commonStyleUniform.smoothness, 1.5f);
+        CORRADE_COMPARE(shared.state().styleUniforms[1].color, 0xdeadbe_rgbf);
+        CORRADE_COMPARE(shared.state().styleUpdateStamp, UnsignedShort(styleUpdateStamp + 1));
+    }
+    CORRADE_COMPARE(shared.state().editingStyleUpdateStamp, editingStyleUpdateStamp);
+
+    /* The style mapping and alignments stay unchanged */
+    CORRADE_COMPARE_AS(stridedArrayView(shared.state().styles).slice(&Implementation::TextLayerStyle::uniform), Containers::stridedArrayView({
+        2u, 1u, 0u, 0u, 1u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(shared.state().styles).slice(&Implementation::TextLayerStyle::alignment), Containers::stridedArrayView({
+        Text::Alignment::MiddleLeft,
+        Text::Alignment::TopRight,
+        Text::Alignment::BottomRight,
+        Text::Alignment::LineLeft,
+        Text::Alignment::LineCenterIntegral
+    }), TestSuite::Compare::Container);
+}
+
+void TextLayerTest::sharedSetEditingStyleUniforms() {
+    auto&& data = SharedSetStyleData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32}};
+
+    struct Shared: TextLayer::Shared {
+        explicit Shared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        State& state() { return static_cast<State&>(*_state); }
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {
+            CORRADE_FAIL("This shouldn't be called.");
+        }
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform& commonUniform, Containers::ArrayView<const TextLayerEditingStyleUniform> uniforms) override {
+            CORRADE_COMPARE(uniforms.size(), 3);
+            lastSmoothness = commonUniform.smoothness;
+            lastBackgroundColor = uniforms[1].backgroundColor;
+            ++setEditingStyleCalled;
+        }
+
+        Int setEditingStyleCalled = 0;
+        Float lastSmoothness{};
+        Color4 lastBackgroundColor;
+    } shared{cache, TextLayer::Shared::Configuration{17, 52}
+        .setEditingStyleCount(3, 5)
+        .setDynamicStyleCount(data.dynamicStyleCount)
+    };
+
+    shared.setEditingStyle(
+        TextLayerCommonEditingStyleUniform{}
+            .setSmoothness(3.14f),
+        {TextLayerEditingStyleUniform{},
+         TextLayerEditingStyleUniform{}
+            .setBackgroundColor(0xc0ffee_rgbf),
+         TextLayerEditingStyleUniform{}},
+        {2, 1, 0, 0, 1},
+        {-1, 12, 6, -1, 15},
+        {});
+    UnsignedShort styleUpdateStamp = shared.state().styleUpdateStamp;
+    UnsignedShort editingStyleUpdateStamp = shared.state().editingStyleUpdateStamp;
+
+    shared.setEditingStyleUniforms(
+        TextLayerCommonEditingStyleUniform{}
+            .setSmoothness(1.5f),
+        {TextLayerEditingStyleUniform{},
+         TextLayerEditingStyleUniform{}
+            .setBackgroundColor(0xdeadbe_rgbf),
+         TextLayerEditingStyleUniform{}});
+    if(data.dynamicStyleCount == 0) {
+        /* The uniforms get uploaded directly, the layers don't need to do
+           anything */
+        CORRADE_COMPARE(shared.setEditingStyleCalled, 2);
+        CORRADE_COMPARE(shared.lastSmoothness, 1.5f);
+        CORRADE_COMPARE(shared.lastBackgroundColor, 0xdeadbe_rgbf);
+        CORRADE_COMPARE(shared.state().editingStyleUpdateStamp, editingStyleUpdateStamp);
+    } else {
+        /* With dynamic styles the uniforms are copied to an internal array
+           and each layer has to combine them with dynamic styles again */
+        CORRADE_COMPARE(shared.setEditingStyleCalled, 0);
+        CORRADE_COMPARE(shared.state().commonEditingStyleUniform.smoothness, 1.5f);
+        CORRADE_COMPARE(shared.state().editingStyleUniforms[1].backgroundColor, 0xdeadbe_rgbf);
+        CORRADE_COMPARE(shared.state().editingStyleUpdateStamp, UnsignedShort(editingStyleUpdateStamp + 1));
+    }
+    CORRADE_COMPARE(shared.state().styleUpdateStamp, styleUpdateStamp);
+
+    /* The style mapping and text uniforms stay unchanged */
+    CORRADE_COMPARE_AS(stridedArrayView(shared.state().editingStyles).slice(&Implementation::TextLayerEditingStyle::uniform), Containers::stridedArrayView({
+        2u, 1u, 0u, 0u, 1u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(shared.state().editingStyles).slice(&Implementation::TextLayerEditingStyle::textUniform), Containers::stridedArrayView({
+        -1, 12, 6, -1, 15
+    }), TestSuite::Compare::Container);
+}
+
+void TextLayerTest::sharedSetStyleUniformsInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32}};
+
+    struct Shared: TextLayer::Shared {
+        explicit Shared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{2}
+        .setEditingStyleCount(3)
+    };
+
+    Containers::String out;
+    Error redirectError{&out};
+    shared.setStyleUniforms(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}});
+    shared.setEditingStyleUniforms(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}});
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+        {FontHandle::Null, FontHandle::Null},
+        {Text::Alignment{}, Text::Alignment{}},
+        {}, {}, {}, {}, {}, {});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}},
+        {},
+        {});
+    shared.setStyleUniforms(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}});
+    shared.setEditingStyleUniforms(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}});
+    CORRADE_COMPARE_AS(out,
+        "Ui::TextLayer::Shared::setStyleUniforms(): no style data was set\n"
+        "Ui::TextLayer::Shared::setEditingStyleUniforms(): no editing style data was set\n"
+        "Ui::TextLayer::Shared::setStyleUniforms(): expected 2 uniforms, got 3\n"
+        "Ui::TextLayer::Shared::setEditingStyleUniforms(): expected 3 uniforms, got 2\n",
+        TestSuite::Compare::String);
+}
+
 void TextLayerTest::construct() {
     auto&& data = ConstructData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -4873,6 +5327,9 @@ void TextLayerTest::construct() {
     CORRADE_COMPARE(&layer.shared(), &shared);
     /* Const overload */
     CORRADE_COMPARE(&static_cast<const Layer&>(layer).shared(), &shared);
+    /* Compared to AbstractVisualLayer handles also key and text input events
+       for editing */
+    CORRADE_COMPARE(layer.events(), LayerEvent::Pointer|LayerEvent::PointerMove|LayerEvent::Focus|LayerEvent::Key|LayerEvent::TextInput);
     CORRADE_COMPARE(layer.flags(), data.layerFlags);
 }
 
@@ -4918,8 +5375,44 @@ void TextLayerTest::constructMove() {
     CORRADE_VERIFY(std::is_nothrow_move_assignable<TextLayer>::value);
 }
 
-void TextLayerTest::dynamicStyle() {
-    auto&& data = DynamicStyleData[testCaseInstanceId()];
+void TextLayerTest::constructGlyphCullingInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32}};
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    };
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, LayerShared& shared, TextLayerFlags flags): TextLayer{handle, shared, flags} {}
+    };
+
+    LayerShared sharedInstanced{cache, TextLayer::Shared::Configuration{1}
+        .setFlags(TextLayerSharedFlag::InstancedGlyphs)};
+    LayerShared sharedShaderTransformation{cache, TextLayer::Shared::Configuration{1}
+        .setFlags(TextLayerSharedFlag::ShaderTransformation)};
+
+    Containers::String out;
+    Error redirectError{&out};
+    Layer{layerHandle(0, 1), sharedInstanced, TextLayerFlag::GlyphCulling};
+    Layer{layerHandle(0, 1), sharedShaderTransformation, TextLayerFlag::GlyphCulling|TextLayerFlag::Transformable};
+    CORRADE_COMPARE_AS(out,
+        "Ui::TextLayer: Ui::TextLayerFlag::GlyphCulling can't be used with Ui::TextLayerSharedFlag::InstancedGlyphs\n"
+        "Ui::TextLayer: Ui::TextLayerFlag::GlyphCulling can't be used with Ui::TextLayerSharedFlag::ShaderTransformation\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::dynamicStyle() {
+    auto&& data = DynamicStyleData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
     struct: Text::AbstractFont {
@@ -6761,12 +7254,20 @@ void TextLayerTest::setCursor() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{cache, TextLayer::Shared::Configuration{1}};
+    } shared{cache, TextLayer::Shared::Configuration{3}
+        .setEditingStyleCount(1)};
+    /* Style 0 has a cursor style, style 1 just a selection style and style 2
+       neither */
+    FontHandle fontHandle = shared.addFont(font, 1.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
-        {TextLayerStyleUniform{}},
-        {shared.addFont(font, 1.0f)},
-        {Text::Alignment::MiddleCenter},
-        {}, {}, {}, {}, {}, {});
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+        {fontHandle, fontHandle, fontHandle},
+        {Text::Alignment::MiddleCenter, Text::Alignment::MiddleCenter, Text::Alignment::MiddleCenter},
+        {}, {}, {}, {0, -1, -1}, {-1, 0, -1}, {});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}},
+        {-1},
+        {Vector4{}});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
@@ -6843,9 +7344,45 @@ void TextLayerTest::setCursor() {
     CORRADE_COMPARE(layer.cursor(data), Containers::pair(0u, 0u));
     CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
 
-    /** @todo expand this test once there is internal state being set other
-        than what's publicly queryable, such as actual visible cursor position
-        caching */
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* With just a selection style, moving the cursor without any selection
+       doesn't need any update as nothing visible changes */
+    DataHandle dataSelection = layer.create(1, "hello!!", {}, TextDataFlag::Editable);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+    layer.setCursor(dataSelection, 3);
+    CORRADE_COMPARE(layer.cursor(dataSelection), Containers::pair(3u, 3u));
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Creating a selection does */
+    layer.setCursor(dataSelection, 3, 5);
+    CORRADE_COMPARE(layer.cursor(dataSelection), Containers::pair(3u, 5u));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* And removing it as well */
+    layer.setCursor(dataSelection, 4);
+    CORRADE_COMPARE(layer.cursor(dataSelection), Containers::pair(4u, 4u));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* With neither a cursor nor a selection style nothing needs an update,
+       but the cursor position is still remembered */
+    DataHandle dataNoEditingStyle = layer.create(2, "hello!!", {}, TextDataFlag::Editable);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+    layer.setCursor(dataNoEditingStyle, 2, 6);
+    CORRADE_COMPARE(layer.cursor(dataNoEditingStyle), Containers::pair(2u, 6u));
+    CORRADE_COMPARE(layer.state(), LayerStates{});
 }
 
 void TextLayerTest::setCursorInvalid() {
@@ -6924,12 +7461,19 @@ void TextLayerTest::updateText() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{cache, TextLayer::Shared::Configuration{3}};
+    } shared{cache, TextLayer::Shared::Configuration{3}
+        .setEditingStyleCount(1)};
+    /* Style 2 has a cursor style in order to have cursor-only changes
+       reflected in the layer state */
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}},
         {FontHandle::Null, FontHandle::Null, shared.addFont(font, 1.0f)},
         {Text::Alignment{}, Text::Alignment{}, Text::Alignment::MiddleCenter},
-        {}, {}, {}, {}, {}, {});
+        {}, {}, {}, {-1, -1, 0}, {}, {});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}},
+        {-1},
+        {Vector4{}});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
@@ -7057,6 +7601,148 @@ void TextLayerTest::updateText() {
         caching */
 }
 
+void TextLayerTest::updateTextMultiline() {
+    /* A shaper that counts how many times it was asked to shape, with the
+       output not depending on where in the text the line is, as with real
+       shapers */
+    struct Shaper: Text::AbstractShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled): Text::AbstractShaper{font}, shapeCalled(shapeCalled) {}
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange>) override {
+            ++shapeCalled;
+            _text = text;
+            _begin = begin;
+            return end - begin;
+        }
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+            for(std::size_t i = 0; i != ids.size(); ++i)
+                ids[i] = _text[_begin + i];
+        }
+        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+            for(std::size_t i = 0; i != offsets.size(); ++i) {
+                offsets[i] = {0.0f, Float(_text[_begin + i] - 'a')};
+                advances[i] = {1.0f + Float(_text[_begin + i] - 'a'), 0.0f};
+            }
+        }
+        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+            for(std::size_t i = 0; i != clusters.size(); ++i)
+                clusters[i] = _begin + i;
+        }
+
+        int& shapeCalled;
+        Containers::StringView _text;
+        UnsignedInt _begin;
+    };
+
+    struct Font: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 128};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
+
+        bool _opened = false;
+    } font;
+    font.openFile({}, 16.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(font.glyphCount(), &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 8.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    const auto glyphData = [&](DataHandle data) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(data)].glyphRun];
+        return layer.stateData().glyphData.sliceSize(run.glyphOffset, run.glyphCount);
+    };
+    /* Compares glyphs of a text with the same text shaped from scratch */
+    const auto compareWithFresh = [&](DataHandle data) {
+        DataHandle fresh = layer.create(0, layer.text(data), {}, TextDataFlag::Editable);
+        CORRADE_COMPARE_AS(stridedArrayView(glyphData(data)).slice(&Implementation::TextLayerGlyphData::position),
+            stridedArrayView(glyphData(fresh)).slice(&Implementation::TextLayerGlyphData::position),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(stridedArrayView(glyphData(data)).slice(&Implementation::TextLayerGlyphData::glyphId),
+            stridedArrayView(glyphData(fresh)).slice(&Implementation::TextLayerGlyphData::glyphId),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(stridedArrayView(glyphData(data)).slice(&Implementation::TextLayerGlyphData::glyphCluster),
+            stridedArrayView(glyphData(fresh)).slice(&Implementation::TextLayerGlyphData::glyphCluster),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(layer.size(data), layer.size(fresh));
+        layer.remove(fresh);
+    };
+
+    /* Initially all lines get shaped */
+    DataHandle text = layer.create(0, "hello\nwide\nworld", {}, TextDataFlag::Editable);
+    CORRADE_COMPARE(font.shapeCalled, 3);
+
+    /* Changing the middle line shapes just that line */
+    layer.updateText(text, 6, 4, 6, "narrow lines", 6);
+    CORRADE_COMPARE(layer.text(text), "hello\nnarrow lines\nworld");
+    CORRADE_COMPARE(font.shapeCalled, 4);
+
+    /* Splitting the line shapes just the two new lines, the last line is
+       moved to a different position in the text but reused as well */
+    layer.updateText(text, 12, 1, 12, "\n", 13);
+    CORRADE_COMPARE(layer.text(text), "hello\nnarrow\nlines\nworld");
+    CORRADE_COMPARE(font.shapeCalled, 6);
+
+    /* The output is the same as if shaped from scratch. That shapes all lines
+       once more. */
+    {
+        CORRADE_ITERATION(__LINE__);
+        compareWithFresh(text);
+    }
+    CORRADE_COMPARE(font.shapeCalled, 10);
+
+    /* The lines were recorded for the fresh text now and discarded when it
+       got removed, so the next edit shapes everything again */
+    layer.updateText(text, 0, 1, 0, "j", 1);
+    CORRADE_COMPARE(layer.text(text), "jello\nnarrow\nlines\nworld");
+    CORRADE_COMPARE(font.shapeCalled, 14);
+
+    /* Joining the lines shapes just the one resulting line */
+    layer.updateText(text, 12, 1, 12, " ", 13);
+    CORRADE_COMPARE(layer.text(text), "jello\nnarrow lines\nworld");
+    CORRADE_COMPARE(font.shapeCalled, 15);
+    {
+        CORRADE_ITERATION(__LINE__);
+        compareWithFresh(text);
+    }
+}
+
 void TextLayerTest::updateTextInvalid() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -7162,12 +7848,19 @@ void TextLayerTest::editText() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{cache, TextLayer::Shared::Configuration{3}};
+    } shared{cache, TextLayer::Shared::Configuration{3}
+        .setEditingStyleCount(1)};
+    /* Style 2 has a cursor style in order to have cursor-only changes
+       reflected in the layer state */
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}},
         {FontHandle::Null, FontHandle::Null, shared.addFont(font, 1.0f)},
         {Text::Alignment{}, Text::Alignment{}, Text::Alignment::MiddleCenter},
-        {}, {}, {}, {}, {}, {});
+        {}, {}, {}, {-1, -1, 0}, {}, {});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}},
+        {-1},
+        {Vector4{}});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
@@ -7491,6 +8184,10 @@ void TextLayerTest::createSetTextTextProperties() {
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
     } layer{layerHandle(0, 1), shared};
 
     if(data.dynamicStyleCount)
@@ -7532,6 +8229,12 @@ void TextLayerTest::createSetTextTextProperties() {
     CORRADE_COMPARE(font.setDirectionCalled, 2);
     CORRADE_COMPARE(font.shapeCalled, 2);
 
+    /* The merged feature list is put into a scratch arena, which got enlarged
+       to fit it on the second call and thus doesn't need to allocate
+       anymore */
+    CORRADE_VERIFY(layer.stateData().shapeStorage.capacity());
+    CORRADE_COMPARE(layer.stateData().shapeStorage.capacity(), layer.stateData().shapeStorage.highWaterMark());
+
     /* createGlyph() doesn't call shape() at all */
     DataHandle glyph = layer.createGlyph(0, 0, {});
     layer.setGlyph(glyph, 0, {});
@@ -7819,219 +8522,633 @@ void TextLayerTest::createSetTextTextPropertiesEditableInvalid() {
     data.expected), TestSuite::Compare::String);
 }
 
-void TextLayerTest::createSetUpdateTextFromLayerItself() {
-    struct: Text::AbstractFont {
+void TextLayerTest::createSetTextShapeCache() {
+    /* A font that counts how many times it was asked to shape */
+    struct Font: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return true; }
-        void doClose() override {}
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            struct Shaper: ThreeGlyphShaper {
+                explicit Shaper(Text::AbstractFont& font, int& shapeCalled): ThreeGlyphShaper{font}, shapeCalled(shapeCalled) {}
+
+                UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange> features) override {
+                    ++shapeCalled;
+                    return ThreeGlyphShaper::doShape(text, begin, end, features);
+                }
+
+                int& shapeCalled;
+            };
+
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
+
+        bool _opened = false;
     } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(98, &font);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
+    }
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{cache, TextLayer::Shared::Configuration{1}};
+    } shared{cache, TextLayer::Shared::Configuration{1}
+        .setShapeCacheSize(2)
+    };
+    CORRADE_COMPARE(shared.shapeCacheSize(), 2);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 0);
+
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {shared.addFont(font, 1.0f)},
+        {fontHandle},
         {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
     } layer{layerHandle(0, 1), shared};
 
-    /* Assuming the implementation stores all texts in one large array, this
-       working correctly relies on arrayAppend() detecting if the view being
-       copied is a slice of the array itself. If it wouldn't, inevitably it'd
-       happen that garbage gets copied, or it blows up due to invalid memory
-       access.
+    const auto glyphData = [&](DataHandle data) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(data)].glyphRun];
+        return layer.stateData().glyphData.sliceSize(run.glyphOffset, run.glyphCount);
+    };
 
-       To make sure this indeed gets hit, the test is repeated a few times with
-       varying string sizes to minimize the chance of realloc() growing
-       in-place every time. */
-    DataHandle first = layer.create(0, "hello there" + " how is everyone"_s*testCaseRepeatId(), {}, TextDataFlag::Editable);
-    DataHandle firstCopy = layer.create(0, layer.text(first), {}, TextDataFlag::Editable);
-    DataHandle second = layer.create(0, "hiya", {}, TextDataFlag::Editable);
-    DataHandle third = layer.create(0, "hey hey", {}, TextDataFlag::Editable);
-    layer.setText(second, layer.text(third), {});
-    layer.updateText(third, 0, 0, 7, layer.text(first).exceptPrefix(5), 0);
+    /* First shaping of a text goes to the shaper and is put into the cache */
+    DataHandle first = layer.create(0, "hello", {});
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 1);
 
-    CORRADE_COMPARE(layer.text(first), "hello there" + " how is everyone"_s*testCaseRepeatId());
-    CORRADE_COMPARE(layer.text(firstCopy), "hello there" + " how is everyone"_s*testCaseRepeatId());
-    CORRADE_COMPARE(layer.text(second), "hey hey");
-    CORRADE_COMPARE(layer.text(third), "hey hey there" + " how is everyone"_s*testCaseRepeatId());
+    /* Second shaping of the same text is taken from the cache, producing the
+       same output. Positions and glyph IDs are compared separately as the
+       clusters are unspecified for non-editable text. */
+    DataHandle second = layer.create(0, "hello", {});
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 1);
+    CORRADE_COMPARE(glyphData(second).size(), 5);
+    CORRADE_COMPARE_AS(stridedArrayView(glyphData(second)).slice(&Implementation::TextLayerGlyphData::position),
+        stridedArrayView(glyphData(first)).slice(&Implementation::TextLayerGlyphData::position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(glyphData(second)).slice(&Implementation::TextLayerGlyphData::glyphId),
+        stridedArrayView(glyphData(first)).slice(&Implementation::TextLayerGlyphData::glyphId),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(second)].rectangle, layer.stateData().data[dataHandleId(first)].rectangle);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(second)].alignment, layer.stateData().data[dataHandleId(first)].alignment);
+    CORRADE_COMPARE(layer.size(first), layer.size(second));
+
+    /* Different properties result in a different cache entry */
+    layer.create(0, "hello", TextProperties{}
+        .setAlignment(Text::Alignment::TopLeft));
+    CORRADE_COMPARE(font.shapeCalled, 2);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 2);
+
+    /* A different text replaces the least recently used entry, which is the
+       first one */
+    DataHandle third = layer.create(0, "hey", {});
+    CORRADE_COMPARE(font.shapeCalled, 3);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 2);
+
+    /* So setText() with it is shaped again, replacing the top-left aligned
+       text now */
+    layer.setText(second, "hello", {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+
+    /* While the other text is in the cache */
+    layer.setText(first, "hey", {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+    CORRADE_COMPARE_AS(stridedArrayView(glyphData(first)).slice(&Implementation::TextLayerGlyphData::glyphId),
+        stridedArrayView(glyphData(third)).slice(&Implementation::TextLayerGlyphData::glyphId),
+        TestSuite::Compare::Container);
+
+    /* Editable text is always shaped again and doesn't get put into the
+       cache */
+    layer.create(0, "hey", {}, TextDataFlag::Editable);
+    CORRADE_COMPARE(font.shapeCalled, 5);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 2);
+
+    /* Clearing the cache makes the texts shaped again */
+    shared.clearShapeCache();
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 0);
+    layer.create(0, "hey", {});
+    CORRADE_COMPARE(font.shapeCalled, 6);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 1);
 }
 
-void TextLayerTest::setColor() {
-    struct: Text::AbstractFont {
+void TextLayerTest::createSetTextGlyphCacheFillOnDemand() {
+    /* A font that counts how many times it was asked to fill the cache and
+       adds the glyphs to it, failing for glyph 50 */
+    struct Font: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return true; }
-        void doClose() override {}
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<ThreeGlyphShaper>(*this);
+        }
+        bool doFillGlyphCache(Text::AbstractGlyphCache& cache, const Containers::StridedArrayView1D<const UnsignedInt>& glyphs) override {
+            ++fillCalled;
+            lastFillCount = glyphs.size();
+            const UnsignedInt fontId = *cache.findFont(*this);
+            for(const UnsignedInt glyph: glyphs) {
+                if(glyph == 50) return false;
+                cache.addGlyph(fontId, glyph, {}, {});
+            }
+            return true;
+        }
+
+        int fillCalled = 0;
+        std::size_t lastFillCount = 0;
+
+        bool _opened = false;
     } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(67, &font);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    /* Only one of the three glyphs used by the shaper is there initially */
+    UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+    cache.addGlyph(fontId, 22, {}, {});
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{cache, TextLayer::Shared::Configuration{1}};
+    } shared{cache, TextLayer::Shared::Configuration{1}
+        .setFlags(TextLayerSharedFlag::GlyphCacheFillOnDemand)
+    };
+
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {shared.addFont(font, 1.0f)},
+        {fontHandle},
         {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
     } layer{layerHandle(0, 1), shared};
 
-    /* Required to be called before update() (because AbstractUserInterface
-       guarantees the same on a higher level), not needed for anything here */
-    layer.setSize({1, 1}, {1, 1});
+    const auto glyphData = [&](DataHandle data) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(data)].glyphRun];
+        return layer.stateData().glyphData.sliceSize(run.glyphOffset, run.glyphCount);
+    };
 
-    /* Just to be sure the setters aren't picking up the first ever data
-       always */
-    layer.create(0, "", {});
+    /* The two missing glyphs get filled with a single call, each just once
+       even though they're used twice, and the text references them */
+    DataHandle first = layer.create(0, "hello", {});
+    CORRADE_COMPARE(font.fillCalled, 1);
+    CORRADE_COMPARE(font.lastFillCount, 2);
+    CORRADE_COMPARE(cache.glyphCount(), 4);
+    CORRADE_COMPARE_AS(stridedArrayView(glyphData(first)).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView<UnsignedInt>({
+        cache.glyphId(fontId, 22),
+        cache.glyphId(fontId, 13),
+        cache.glyphId(fontId, 97),
+        cache.glyphId(fontId, 22),
+        cache.glyphId(fontId, 13),
+    }), TestSuite::Compare::Container);
+    CORRADE_VERIFY(cache.glyphId(fontId, 13));
+    CORRADE_VERIFY(cache.glyphId(fontId, 97));
+
+    /* A text with glyphs that are all in the cache already doesn't fill
+       anything */
+    layer.setText(first, "hey", {});
+    CORRADE_COMPARE(font.fillCalled, 1);
+
+    /* A single glyph gets filled as well */
+    DataHandle second = layer.createGlyph(0, 5, {});
+    CORRADE_COMPARE(font.fillCalled, 2);
+    CORRADE_COMPARE(font.lastFillCount, 1);
+    CORRADE_VERIFY(cache.glyphId(fontId, 5));
+    CORRADE_COMPARE(glyphData(second)[0].glyphId, cache.glyphId(fontId, 5));
+
+    /* If the fill fails, the glyph stays invalid, and fill isn't attempted
+       again for given font */
+    layer.setGlyph(second, 50, {});
+    CORRADE_COMPARE(font.fillCalled, 3);
+    CORRADE_COMPARE(glyphData(second)[0].glyphId, 0);
+    layer.setGlyph(second, 51, {});
+    CORRADE_COMPARE(font.fillCalled, 3);
+    CORRADE_COMPARE(glyphData(second)[0].glyphId, 0);
+}
 
-    /* There's nothing that would work differently for createGlyph() */
-    DataHandle data = layer.create(0, "", {});
-    CORRADE_COMPARE(layer.color(data), 0xffffffff_rgbaf);
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+void TextLayerTest::createSetTextGlyphCacheGrowOnDemand() {
+    /* A font that fails to fill the cache until it's grown to two layers, and
+       for glyph 50 always */
+    struct Font: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<ThreeGlyphShaper>(*this);
+        }
+        bool doFillGlyphCache(Text::AbstractGlyphCache& cache, const Containers::StridedArrayView1D<const UnsignedInt>& glyphs) override {
+            ++fillCalled;
+            if(layerCount < 2) return false;
+            const UnsignedInt fontId = *cache.findFont(*this);
+            for(const UnsignedInt glyph: glyphs) {
+                if(glyph == 50) return false;
+                cache.addGlyph(fontId, glyph, {}, {});
+            }
+            return true;
+        }
 
-    /* Setting a color marks the layer as dirty */
-    layer.setColor(data, 0xaabbccdd_rgbaf);
-    CORRADE_COMPARE(layer.color(data), 0xaabbccdd_rgbaf);
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+        int fillCalled = 0;
+        Int layerCount = 1;
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+        bool _opened = false;
+    } font;
+    font.openFile({}, 16.0f);
 
-    /* Testing also the other overload */
-    layer.setColor(dataHandleData(data), 0x11223344_rgbaf);
-    CORRADE_COMPARE(layer.color(dataHandleData(data)), 0x11223344_rgbaf);
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32, 1}, {}};
+    UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+
+    /* The cache can't be actually replaced here, so the growth is only
+       recorded in the font */
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, Font& font, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration}, font(font) {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+        bool doGrowGlyphCache(UnsignedInt layerCount) override {
+            ++growCalled;
+            CORRADE_COMPARE(layerCount, 1);
+            if(!growSucceeds) return false;
+            font.layerCount += layerCount;
+            return true;
+        }
+
+        Font& font;
+        int growCalled = 0;
+        bool growSucceeds = true;
+    } shared{cache, font, TextLayer::Shared::Configuration{1}
+        .setFlags(TextLayerSharedFlag::GlyphCacheGrowOnDemand)
+    };
+
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    const auto glyphData = [&](DataHandle data) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(data)].glyphRun];
+        return layer.stateData().glyphData.sliceSize(run.glyphOffset, run.glyphCount);
+    };
+
+    /* The first fill fails, the cache gets grown and the fill succeeds the
+       second time. No error is printed for the failed attempt. */
+    DataHandle first;
+    {
+        Containers::String out;
+        Error redirectError{&out};
+        first = layer.create(0, "hello", {});
+        CORRADE_COMPARE(out, "");
+    }
+    CORRADE_COMPARE(shared.growCalled, 1);
+    CORRADE_COMPARE(font.fillCalled, 2);
+    CORRADE_COMPARE_AS(stridedArrayView(glyphData(first)).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView<UnsignedInt>({
+        cache.glyphId(fontId, 22),
+        cache.glyphId(fontId, 13),
+        cache.glyphId(fontId, 97),
+        cache.glyphId(fontId, 22),
+        cache.glyphId(fontId, 13),
+    }), TestSuite::Compare::Container);
+    CORRADE_VERIFY(cache.glyphId(fontId, 22));
+    CORRADE_VERIFY(cache.glyphId(fontId, 13));
+    CORRADE_VERIFY(cache.glyphId(fontId, 97));
+
+    /* If the growth fails, the fill is attempted once more, and then not
+       anymore for given font */
+    shared.growSucceeds = false;
+    DataHandle second = layer.createGlyph(0, 50, {});
+    CORRADE_COMPARE(shared.growCalled, 2);
+    CORRADE_COMPARE(font.fillCalled, 4);
+    CORRADE_COMPARE(glyphData(second)[0].glyphId, 0);
+    layer.setGlyph(second, 51, {});
+    CORRADE_COMPARE(shared.growCalled, 2);
+    CORRADE_COMPARE(font.fillCalled, 4);
+    CORRADE_COMPARE(glyphData(second)[0].glyphId, 0);
 }
 
-void TextLayerTest::setPadding() {
-    struct: Text::AbstractFont {
+void TextLayerTest::createSetTextGlyphCacheFillDeferred() {
+    /* Like createSetTextGlyphCacheFillOnDemand(), but with the fill happening
+       only in update() */
+    struct Font: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return true; }
-        void doClose() override {}
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<ThreeGlyphShaper>(*this);
+        }
+        bool doFillGlyphCache(Text::AbstractGlyphCache& cache, const Containers::StridedArrayView1D<const UnsignedInt>& glyphs) override {
+            ++fillCalled;
+            lastFillCount = glyphs.size();
+            const UnsignedInt fontId = *cache.findFont(*this);
+            for(const UnsignedInt glyph: glyphs)
+                cache.addGlyph(fontId, glyph, {}, {});
+            return true;
+        }
+
+        int fillCalled = 0;
+        std::size_t lastFillCount = 0;
+
+        bool _opened = false;
     } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(67, &font);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+    cache.addGlyph(fontId, 22, {}, {});
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{cache, TextLayer::Shared::Configuration{1}};
+    } shared{cache, TextLayer::Shared::Configuration{1}
+        .setFlags(TextLayerSharedFlag::GlyphCacheFillDeferred)
+    };
+
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {shared.addFont(font, 1.0f)},
+        {fontHandle},
         {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
     } layer{layerHandle(0, 1), shared};
 
-    /* Required to be called before update() (because AbstractUserInterface
-       guarantees the same on a higher level), not needed for anything here */
-    layer.setSize({1, 1}, {1, 1});
+    const auto glyphData = [&](DataHandle data) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(data)].glyphRun];
+        return layer.stateData().glyphData.sliceSize(run.glyphOffset, run.glyphCount);
+    };
 
-    /* Just to be sure the setters aren't picking up the first ever data
-       always */
-    layer.create(0, "", {});
+    /* Nothing gets filled on creation, the missing glyphs are marked as
+       pending */
+    DataHandle first = layer.create(0, "hello", {});
+    DataHandle second = layer.create(0, "hey", {});
+    CORRADE_COMPARE(font.fillCalled, 0);
+    CORRADE_COMPARE(cache.glyphCount(), 2);
+    CORRADE_COMPARE(glyphData(first)[0].glyphId, cache.glyphId(fontId, 22));
+    CORRADE_COMPARE(glyphData(first)[1].glyphId, Implementation::TextLayerPendingGlyph|(fontId << 16)|13);
+    CORRADE_COMPARE(glyphData(second)[2].glyphId, Implementation::TextLayerPendingGlyph|(fontId << 16)|97);
+
+    /* The update fills glyphs of both texts in a single call and resolves
+       them */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(font.fillCalled, 1);
+    CORRADE_COMPARE(font.lastFillCount, 2);
+    CORRADE_COMPARE(cache.glyphCount(), 4);
+    CORRADE_COMPARE_AS(stridedArrayView(glyphData(first)).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView<UnsignedInt>({
+        cache.glyphId(fontId, 22),
+        cache.glyphId(fontId, 13),
+        cache.glyphId(fontId, 97),
+        cache.glyphId(fontId, 22),
+        cache.glyphId(fontId, 13),
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(glyphData(second)).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView<UnsignedInt>({
+        cache.glyphId(fontId, 22),
+        cache.glyphId(fontId, 13),
+        cache.glyphId(fontId, 97),
+    }), TestSuite::Compare::Container);
+
+    /* A text with all glyphs present doesn't fill anything in the next
+       update */
+    layer.setText(second, "hello", {});
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(font.fillCalled, 1);
+}
 
-    /* There's nothing that would work differently for createGlyph() */
-    DataHandle data = layer.create(0, "", {});
-    CORRADE_COMPARE(layer.padding(data), Vector4{0.0f});
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+void TextLayerTest::createSetTextDeferShaping() {
+    struct Shaper: ThreeGlyphShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled, Containers::Array<Text::FeatureRange>& lastFeatures): ThreeGlyphShaper{font}, shapeCalled(shapeCalled), lastFeatures(lastFeatures) {}
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange> features) override {
+            ++shapeCalled;
+            lastFeatures = Containers::Array<Text::FeatureRange>{InPlaceInit, features};
+            return ThreeGlyphShaper::doShape(text, begin, end, features);
+        }
 
-    /* Setting a padding marks the layer as dirty */
-    layer.setPadding(data, {2.0f, 4.0f, 3.0f, 1.0f});
-    CORRADE_COMPARE(layer.padding(data), (Vector4{2.0f, 4.0f, 3.0f, 1.0f}));
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+        int& shapeCalled;
+        Containers::Array<Text::FeatureRange>& lastFeatures;
+    };
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+    struct Font: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
-    /* Testing also the other overload */
-    layer.setPadding(dataHandleData(data), {1.0f, 2.0f, 3.0f, 4.0f});
-    CORRADE_COMPARE(layer.padding(dataHandleData(data)), (Vector4{1.0f, 2.0f, 3.0f, 4.0f}));
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, shapeCalled, lastFeatures);
+        }
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+        int shapeCalled = 0;
+        Containers::Array<Text::FeatureRange> lastFeatures;
 
-    /* Single-value padding */
-    layer.setPadding(data, 4.0f);
-    CORRADE_COMPARE(layer.padding(data), Vector4{4.0f});
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+        bool _opened = false;
+    } font;
+    font.openFile({}, 16.0f);
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
 
-    /* Testing also the other overload */
-    layer.setPadding(dataHandleData(data), 3.0f);
-    CORRADE_COMPARE(layer.padding(dataHandleData(data)), Vector4{3.0f});
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+    cache.addGlyph(fontId, 22, {}, {});
+    cache.addGlyph(fontId, 13, {}, {});
+    cache.addGlyph(fontId, 97, {}, {});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Nothing gets shaped for the deferred texts, only the non-deferred text
+       is */
+    DataHandle first = layer.create(0, "hello", {}, TextDataFlag::DeferShaping, nodeHandle(0, 1));
+    DataHandle second = layer.create(0, "hey", TextProperties{}.setFeatures({Text::Feature::Kerning}), TextDataFlag::DeferShaping, nodeHandle(1, 1));
+    DataHandle third = layer.create(0, "hi", {}, nodeHandle(2, 1));
+    DataHandle fourth = layer.create(0, "ahoy", {}, TextDataFlag::DeferShaping, nodeHandle(3, 1));
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(layer.flags(first), TextDataFlag::DeferShaping);
+    CORRADE_COMPARE(layer.glyphCount(first), 0);
+    CORRADE_COMPARE(layer.size(first), Vector2{});
+    CORRADE_COMPARE(layer.glyphCount(second), 0);
+    CORRADE_COMPARE(layer.glyphCount(third), 2);
+    CORRADE_COMPARE(layer.glyphCount(fourth), 0);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 2);
+
+    /* Setting a text again doesn't shape either */
+    layer.setText(fourth, "hiya", {});
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(layer.glyphCount(fourth), 0);
+
+    Vector2 nodeOffsets[4];
+    Vector2 nodeSizes[4];
+    Float nodeOpacities[4]{};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
+
+    /* Only the deferred texts that are among the updated data get shaped.
+       They're shaped with the saved features, and the vertex data are
+       updated even though only the node order update was requested. */
+    UnsignedInt dataIds1[]{dataHandleId(second), dataHandleId(third)};
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIds1, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 2);
+    CORRADE_COMPARE(font.lastFeatures.size(), 1);
+    CORRADE_COMPARE(font.lastFeatures[0].feature(), Text::Feature::Kerning);
+    CORRADE_COMPARE(layer.glyphCount(first), 0);
+    CORRADE_COMPARE(layer.glyphCount(second), 3);
+    CORRADE_COMPARE(layer.size(second), (Vector2{4.5f, 6.0f}));
+    CORRADE_COMPARE(layer.glyphCount(fourth), 0);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 5*4*sizeof(Implementation::TextLayerVertex));
+
+    /* Updating with the same data again doesn't shape anything */
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIds1, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 2);
+
+    /* Shaping the rest. The replaced text of the fourth data gets used. */
+    UnsignedInt dataIds2[]{dataHandleId(first), dataHandleId(fourth)};
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIds2, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+    CORRADE_COMPARE(layer.glyphCount(first), 5);
+    CORRADE_COMPARE(layer.glyphCount(fourth), 4);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 14);
+
+    /* All deferred texts are shaped now, so their storage got discarded */
+    CORRADE_COMPARE(layer.stateData().deferredTexts.size(), 0);
+    CORRADE_COMPARE(layer.stateData().deferredTextData.size(), 0);
+    CORRADE_COMPARE(layer.stateData().deferredFeatures.size(), 0);
+
+    /* Setting a text on shaped data defers the shaping again, the previous
+       glyphs are gone */
+    layer.setText(first, "hey", {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+    CORRADE_COMPARE(layer.glyphCount(first), 0);
+
+    /* Removing the data discards the deferred text as well */
+    layer.remove(first);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+    CORRADE_COMPARE(layer.stateData().deferredTexts.size(), 0);
 }
 
-void TextLayerTest::setPaddingInvalid() {
+void TextLayerTest::createSetTextDeferShapingEditable() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
     struct: Text::AbstractFont {
@@ -8062,34 +9179,28 @@ void TextLayerTest::setPaddingInvalid() {
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
         {shared.addFont(font, 1.0f)},
-        {Text::Alignment{}},
+        {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
-        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared, TextLayerFlag::Transformable} {}
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
     } layer{layerHandle(0, 1), shared};
 
-    DataHandle data = layer.create(0, "", {});
+    DataHandle data = layer.create(0, "hello", {}, TextDataFlag::DeferShaping);
 
     Containers::String out;
     Error redirectError{&out};
-    layer.padding(data);
-    layer.padding(dataHandleData(data));
-    layer.setPadding(data, Vector4{});
-    layer.setPadding(dataHandleData(data), Vector4{});
-    layer.setPadding(data, 0.0f);
-    layer.setPadding(dataHandleData(data), 0.0f);
+    layer.create(0, "hello", {}, TextDataFlag::Editable|TextDataFlag::DeferShaping);
+    layer.setText(data, "hey", {}, TextDataFlag::Editable|TextDataFlag::DeferShaping);
     CORRADE_COMPARE_AS(out,
-        "Ui::TextLayer::padding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
-        "Ui::TextLayer::padding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
-        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
-        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
-        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
-        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n",
+        "Ui::TextLayer::create(): cannot combine Ui::TextDataFlag::Editable and Ui::TextDataFlag::DeferShaping\n"
+        "Ui::TextLayer::setText(): cannot combine Ui::TextDataFlag::Editable and Ui::TextDataFlag::DeferShaping\n",
         TestSuite::Compare::String);
 }
 
-void TextLayerTest::setTransformation() {
+void TextLayerTest::createSetTextWrapEditable() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
         bool doIsOpened() const override { return true; }
@@ -8122,21 +9233,946 @@ void TextLayerTest::setTransformation() {
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
-        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared, TextLayerFlag::Transformable} {}
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
     } layer{layerHandle(0, 1), shared};
 
-    /* Required to be called before update() (because AbstractUserInterface
-       guarantees the same on a higher level), not needed for anything here */
-    layer.setSize({1, 1}, {1, 1});
+    DataHandle data = layer.create(0, "hello", {}, TextDataFlag::Wrap);
 
-    /* Just to be sure the setters aren't picking up the first ever data
-       always */
-    layer.create(0, "", {});
+    Containers::String out;
+    Error redirectError{&out};
+    layer.create(0, "hello", {}, TextDataFlag::Editable|TextDataFlag::Wrap);
+    layer.setText(data, "hey", {}, TextDataFlag::Editable|TextDataFlag::Wrap);
+    CORRADE_COMPARE_AS(out,
+        "Ui::TextLayer::create(): cannot combine Ui::TextDataFlag::Editable and Ui::TextDataFlag::Wrap\n"
+        "Ui::TextLayer::setText(): cannot combine Ui::TextDataFlag::Editable and Ui::TextDataFlag::Wrap\n",
+        TestSuite::Compare::String);
+}
 
-    /* There's nothing that would work differently for createGlyph() */
-    DataHandle data = layer.create(0, "", {});
-    CORRADE_COMPARE(layer.transformation(data), Containers::pair(Vector2{}, Complex{Math::IdentityInit}));
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+void TextLayerTest::measure() {
+    auto&& data = MeasureData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A font that counts how many times it was asked to shape */
+    struct Font: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            struct Shaper: ThreeGlyphShaper {
+                explicit Shaper(Text::AbstractFont& font, int& shapeCalled): ThreeGlyphShaper{font}, shapeCalled(shapeCalled) {}
+
+                UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange> features) override {
+                    ++shapeCalled;
+                    return ThreeGlyphShaper::doShape(text, begin, end, features);
+                }
+
+                int& shapeCalled;
+            };
+
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
+
+        bool _opened = false;
+    } font;
+    font.openFile({}, 16.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
+    }
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{2}
+        .setShapeCacheSize(data.shapeCacheSize)
+    };
+
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+        {fontHandle, fontHandle},
+        {Text::Alignment::MiddleCenter, Text::Alignment::TopLeft},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Measuring gives back the same size and glyph count as a created data,
+       but doesn't touch the layer in any way */
+    Containers::Pair<Range2D, UnsignedInt> measured = shared.measure(0, "hello", {});
+    CORRADE_COMPARE(measured.first().size(), (Vector2{10.0f, 6.0f}));
+    CORRADE_COMPARE(measured.second(), 5);
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 0);
+    CORRADE_COMPARE(layer.stateData().glyphRuns.size(), 0);
+    CORRADE_COMPARE(layer.capacity(), 0);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), data.shapeCacheSize ? 1 : 0);
+
+    /* Creating data with the same text then takes it from the shape cache, if
+       enabled */
+    DataHandle layerData = layer.create(0, "hello", {});
+    CORRADE_COMPARE(layer.size(layerData), measured.first().size());
+    CORRADE_COMPARE(layer.glyphCount(layerData), measured.second());
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(layerData)].rectangle, measured.first());
+    CORRADE_COMPARE(font.shapeCalled, data.shapeCacheSize ? 1 : 2);
+
+    /* The style alignment gets used, the properties override it */
+    Range2D topLeft = shared.measure(1, "hey", {}).first();
+    CORRADE_COMPARE(topLeft.size(), (Vector2{4.5f, 6.0f}));
+    CORRADE_COMPARE(topLeft.min().x(), 0.0f);
+    CORRADE_COMPARE(topLeft.max().y(), 0.0f);
+    CORRADE_COMPARE(shared.measure(1, "hey", TextProperties{}.setAlignment(Text::Alignment::MiddleCenter)).first().center(), Vector2{});
+
+    /* Measuring a text that was shaped by a layer takes it from the cache
+       as well, if enabled */
+    int shapeCalledBefore = font.shapeCalled;
+    layer.create(1, "ahoy", {});
+    CORRADE_COMPARE(shared.measure(1, "ahoy", {}).second(), 4);
+    CORRADE_COMPARE(font.shapeCalled, shapeCalledBefore + (data.shapeCacheSize ? 1 : 2));
+
+    /* Multiple texts at once */
+    const UnsignedInt styles[]{0, 1, 0};
+    const TextProperties properties[3]{};
+    Range2D rectangles[3];
+    UnsignedInt glyphCounts[3];
+    shared.measureInto(styles, {"hello", "hey", ""}, properties, rectangles, glyphCounts);
+    CORRADE_COMPARE_AS(Containers::arrayView(glyphCounts), Containers::arrayView({
+        5u, 3u, 0u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(rectangles[0], measured.first());
+    CORRADE_COMPARE(rectangles[1].size(), (Vector2{4.5f, 6.0f}));
+    CORRADE_COMPARE(rectangles[2].size().x(), 0.0f);
+
+    /* The layer still has just the two data */
+    CORRADE_COMPARE(layer.capacity(), 2);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 9);
+}
+
+void TextLayerTest::measureInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+    UnsignedInt glyphCacheInstanceLessFontId = cache.addFont(233);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{2}
+        .setDynamicStyleCount(1)
+    };
+
+    FontHandle fontHandle = shared.addFont(font, 1.0f);
+    FontHandle instancelessFontHandle = shared.addInstancelessFont(glyphCacheInstanceLessFontId, 0.1f);
+
+    const UnsignedInt styles[]{0, 2};
+    const TextProperties properties[2]{};
+    Range2D rectangles[2];
+    UnsignedInt glyphCounts[2];
+
+    Containers::String out;
+    Error redirectError{&out};
+    shared.measure(0, "", {});
+    shared.measureInto(styles, {"", ""}, properties, rectangles, glyphCounts);
+
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+        {fontHandle, FontHandle::Null},
+        {Text::Alignment{}, Text::Alignment{}},
+        {}, {}, {}, {}, {}, {});
+
+    /* Dynamic styles aren't accessible from the shared state */
+    shared.measure(2, "", {});
+    shared.measure(1, "", {});
+    shared.measure(0, "", FontHandle(0x12ab));
+    shared.measure(0, "", instancelessFontHandle);
+    shared.measureInto(styles, {"", ""}, properties, rectangles, glyphCounts);
+    shared.measureInto(styles, {"", "", ""}, properties, rectangles, glyphCounts);
+    shared.measureInto(styles, {"", ""}, properties, Containers::arrayView(rectangles).prefix(1), glyphCounts);
+    CORRADE_COMPARE_AS(out,
+        "Ui::TextLayer::Shared::measure(): no style data was set\n"
+        "Ui::TextLayer::Shared::measureInto(): no style data was set\n"
+        "Ui::TextLayer::Shared::measure(): style 2 out of range for 2 styles\n"
+        "Ui::TextLayer::Shared::measure(): style 1 has no font set and no custom font was supplied\n"
+        "Ui::TextLayer::Shared::measure(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
+        "Ui::TextLayer::Shared::measure(): Ui::FontHandle(0x1, 0x1) is an instance-less font\n"
+        "Ui::TextLayer::Shared::measureInto(): style 2 out of range for 2 styles at index 1\n"
+        "Ui::TextLayer::Shared::measureInto(): expected style, text, property, rectangle and glyph count views to have the same size but got 2, 3, 2, 2 and 2\n"
+        "Ui::TextLayer::Shared::measureInto(): expected style, text, property, rectangle and glyph count views to have the same size but got 2, 2, 2, 1 and 2\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::setTextMultiple() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+
+        bool _opened = false;
+    } font;
+    font.openFile({}, 16.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addFont(font.glyphCount(), &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    DataHandle first = layer.create(0, "hello", {});
+    DataHandle second = layer.create(0, "", {}, TextDataFlag::Editable);
+    DataHandle third = layer.create(0, "hi", {});
+
+    /* Clear the state flags to verify they get set again */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_VERIFY(!(layer.state() >= LayerState::NeedsDataUpdate));
+
+    /* The properties are applied to each text, flags are preserved */
+    DataHandle handles[]{third, first, second};
+    TextProperties properties[]{
+        TextProperties{}.setAlignment(Text::Alignment::TopLeft),
+        TextProperties{},
+        TextProperties{}.setAlignment(Text::Alignment::BottomRight),
+    };
+    layer.setText(handles, {"hey", "", "ahoy"}, properties);
+    CORRADE_VERIFY(layer.state() >= LayerState::NeedsDataUpdate);
+    CORRADE_COMPARE(layer.glyphCount(first), 0);
+    CORRADE_COMPARE(layer.glyphCount(second), 4);
+    CORRADE_COMPARE(layer.glyphCount(third), 3);
+    CORRADE_COMPARE(layer.flags(first), TextDataFlags{});
+    CORRADE_COMPARE(layer.flags(second), TextDataFlag::Editable);
+    CORRADE_COMPARE(layer.flags(third), TextDataFlags{});
+    CORRADE_COMPARE(layer.text(second), "ahoy");
+    CORRADE_COMPARE(layer.textProperties(second).alignment(), Text::Alignment::BottomRight);
+
+    /* Same properties for all texts broadcast from a single value, using the
+       LayerDataHandle overload */
+    LayerDataHandle layerHandles[]{
+        dataHandleData(first),
+        dataHandleData(third),
+    };
+    TextProperties sameProperties;
+    layer.setText(layerHandles, {"hello!", "a"}, Containers::stridedArrayView(&sameProperties, 1).broadcasted<0>(2));
+    CORRADE_COMPARE(layer.glyphCount(first), 6);
+    CORRADE_COMPARE(layer.glyphCount(third), 1);
+    CORRADE_COMPARE(layer.glyphCount(second), 4);
+}
+
+void TextLayerTest::setTextMultipleInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32}};
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle handles[]{DataHandle::Null, DataHandle::Null};
+    LayerDataHandle layerHandles[]{LayerDataHandle::Null, LayerDataHandle::Null};
+    TextProperties properties[2];
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.setText(handles, {"a", "b", "c"}, properties);
+    layer.setText(layerHandles, {"a", "b"}, Containers::arrayView(properties).prefix(1));
+    layer.setText(handles, {"a", "b"}, properties);
+    layer.setText(layerHandles, {"a", "b"}, properties);
+    CORRADE_COMPARE_AS(out,
+        "Ui::TextLayer::setText(): expected handle, text and property views to have the same size but got 2, 3 and 2\n"
+        "Ui::TextLayer::setText(): expected handle, text and property views to have the same size but got 2, 2 and 1\n"
+        "Ui::TextLayer::setText(): invalid handle Ui::DataHandle::Null at index 0\n"
+        "Ui::TextLayer::setText(): invalid handle Ui::LayerDataHandle::Null at index 0\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::setTextMultipleConcurrent() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            ++shaperCount;
+            return Containers::pointer<ThreeGlyphShaper>(*this);
+        }
+
+        bool _opened = false;
+        Int shaperCount = 0;
+    } font;
+    font.openFile({}, 16.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addFont(font.glyphCount(), &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    };
+
+    /* Both have more than one shaper, but only the second has an executor,
+       the first thus shapes serially */
+    LayerShared sharedSerial{cache, TextLayer::Shared::Configuration{1}
+        .setShaperCount(3)};
+    LayerShared sharedConcurrent{cache, TextLayer::Shared::Configuration{1}
+        .setShaperCount(3)};
+    CORRADE_COMPARE(sharedConcurrent.shaperCount(), 3);
+    CORRADE_VERIFY(!sharedConcurrent.hasShapeExecutor());
+
+    /* Call the tasks in reverse order to verify the result doesn't depend on
+       the order in which they execute */
+    Int executorTaskCount = 0;
+    sharedConcurrent.setShapeExecutor([&executorTaskCount](std::size_t count, void(*task)(void*, std::size_t), void* state) {
+        executorTaskCount += count;
+        for(std::size_t i = count; i != 0; --i)
+            task(state, i - 1);
+    });
+    CORRADE_VERIFY(sharedConcurrent.hasShapeExecutor());
+
+    for(LayerShared* shared: {&sharedSerial, &sharedConcurrent}) {
+        FontHandle fontHandle = shared->addFont(font, 8.0f);
+        shared->setStyle(TextLayerCommonStyleUniform{},
+            {TextLayerStyleUniform{}},
+            {fontHandle},
+            {Text::Alignment::MiddleCenter},
+            {}, {}, {}, {}, {}, {});
+    }
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
+    } serial{layerHandle(0, 1), sharedSerial},
+      concurrent{layerHandle(0, 1), sharedConcurrent};
+
+    for(Layer* layer: {&serial, &concurrent}) {
+        layer->create(0, "", {});
+        layer->create(0, "", {}, TextDataFlag::Editable);
+        layer->create(0, "", {});
+        layer->create(0, "", {});
+        layer->create(0, "", {});
+    }
+    /* Each shared instance created one shaper for non-concurrent use */
+    CORRADE_COMPARE(font.shaperCount, 2);
+
+    LayerDataHandle handles[]{
+        layerDataHandle(4, 1),
+        layerDataHandle(1, 1),
+        layerDataHandle(0, 1),
+        layerDataHandle(3, 1),
+        layerDataHandle(2, 1),
+    };
+    TextProperties properties[]{
+        TextProperties{}.setAlignment(Text::Alignment::TopLeft),
+        TextProperties{}.setShapeDirection(Text::ShapeDirection::RightToLeft),
+        TextProperties{},
+        TextProperties{}.setAlignment(Text::Alignment::BottomRight),
+        TextProperties{}.setAlignment(Text::Alignment::LineEnd),
+    };
+    const Containers::StringView texts[]{
+        "hello", "ahoy", "", "hey", "abcdefg"
+    };
+    serial.setText(handles, Containers::arrayView(texts), properties);
+    CORRADE_COMPARE(executorTaskCount, 0);
+    CORRADE_COMPARE(font.shaperCount, 2);
+
+    concurrent.setText(handles, Containers::arrayView(texts), properties);
+    CORRADE_COMPARE(executorTaskCount, 3);
+    /* A dedicated shaper got created for each task */
+    CORRADE_COMPARE(font.shaperCount, 5);
+
+    /* The results should be the same as when shaped serially */
+    const TextLayer::State& serialState = serial.stateData();
+    const TextLayer::State& concurrentState = concurrent.stateData();
+    CORRADE_COMPARE_AS(stridedArrayView(concurrentState.glyphData).slice(&Implementation::TextLayerGlyphData::glyphId),
+        stridedArrayView(serialState.glyphData).slice(&Implementation::TextLayerGlyphData::glyphId),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(concurrentState.glyphData).slice(&Implementation::TextLayerGlyphData::position),
+        stridedArrayView(serialState.glyphData).slice(&Implementation::TextLayerGlyphData::position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(concurrentState.glyphRuns.size(), serialState.glyphRuns.size());
+    for(std::size_t i = 0; i != serialState.glyphRuns.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(concurrentState.glyphRuns[i].glyphOffset, serialState.glyphRuns[i].glyphOffset);
+        CORRADE_COMPARE(concurrentState.glyphRuns[i].glyphCount, serialState.glyphRuns[i].glyphCount);
+        CORRADE_COMPARE(concurrentState.glyphRuns[i].data, serialState.glyphRuns[i].data);
+        CORRADE_COMPARE(concurrentState.glyphRuns[i].scale, serialState.glyphRuns[i].scale);
+    }
+    for(std::size_t i = 0; i != serialState.data.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(concurrentState.data[i].glyphRun, serialState.data[i].glyphRun);
+        CORRADE_COMPARE(concurrentState.data[i].rectangle, serialState.data[i].rectangle);
+        CORRADE_COMPARE(concurrentState.data[i].alignment, serialState.data[i].alignment);
+        CORRADE_COMPARE(concurrentState.data[i].usedDirection, serialState.data[i].usedDirection);
+    }
+
+    /* Glyph clusters are meaningful only for the editable text */
+    const Implementation::TextLayerGlyphRun& editableRun = serialState.glyphRuns[serialState.data[1].glyphRun];
+    CORRADE_COMPARE_AS(stridedArrayView(concurrentState.glyphData).sliceSize(editableRun.glyphOffset, editableRun.glyphCount).slice(&Implementation::TextLayerGlyphData::glyphCluster),
+        stridedArrayView(serialState.glyphData).sliceSize(editableRun.glyphOffset, editableRun.glyphCount).slice(&Implementation::TextLayerGlyphData::glyphCluster),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(concurrent.text(layerDataHandle(1, 1)), "ahoy");
+
+    /* Shaping again reuses the shapers created the first time */
+    concurrent.setText(handles, Containers::arrayView(texts), properties);
+    CORRADE_COMPARE(executorTaskCount, 6);
+    CORRADE_COMPARE(font.shaperCount, 5);
+
+    /* Resetting the executor makes it serial again */
+    sharedConcurrent.setShapeExecutor(nullptr);
+    CORRADE_VERIFY(!sharedConcurrent.hasShapeExecutor());
+    concurrent.setText(handles, Containers::arrayView(texts), properties);
+    CORRADE_COMPARE(executorTaskCount, 6);
+}
+
+void TextLayerTest::createSetUpdateTextFromLayerItself() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(98, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Assuming the implementation stores all texts in one large array, this
+       working correctly relies on arrayAppend() detecting if the view being
+       copied is a slice of the array itself. If it wouldn't, inevitably it'd
+       happen that garbage gets copied, or it blows up due to invalid memory
+       access.
+
+       To make sure this indeed gets hit, the test is repeated a few times with
+       varying string sizes to minimize the chance of realloc() growing
+       in-place every time. */
+    DataHandle first = layer.create(0, "hello there" + " how is everyone"_s*testCaseRepeatId(), {}, TextDataFlag::Editable);
+    DataHandle firstCopy = layer.create(0, layer.text(first), {}, TextDataFlag::Editable);
+    DataHandle second = layer.create(0, "hiya", {}, TextDataFlag::Editable);
+    DataHandle third = layer.create(0, "hey hey", {}, TextDataFlag::Editable);
+    layer.setText(second, layer.text(third), {});
+    layer.updateText(third, 0, 0, 7, layer.text(first).exceptPrefix(5), 0);
+
+    CORRADE_COMPARE(layer.text(first), "hello there" + " how is everyone"_s*testCaseRepeatId());
+    CORRADE_COMPARE(layer.text(firstCopy), "hello there" + " how is everyone"_s*testCaseRepeatId());
+    CORRADE_COMPARE(layer.text(second), "hey hey");
+    CORRADE_COMPARE(layer.text(third), "hey hey there" + " how is everyone"_s*testCaseRepeatId());
+}
+
+void TextLayerTest::setColor() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* Just to be sure the setters aren't picking up the first ever data
+       always */
+    layer.create(0, "", {});
+
+    /* There's nothing that would work differently for createGlyph() */
+    DataHandle data = layer.create(0, "", {});
+    CORRADE_COMPARE(layer.color(data), 0xffffffff_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting a color marks the layer as dirty */
+    layer.setColor(data, 0xaabbccdd_rgbaf);
+    CORRADE_COMPARE(layer.color(data), 0xaabbccdd_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    layer.setColor(dataHandleData(data), 0x11223344_rgbaf);
+    CORRADE_COMPARE(layer.color(dataHandleData(data)), 0x11223344_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    DataHandle data2 = layer.create(0, "", {});
+    DataHandle data3 = layer.create(0, "", {});
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting an empty list doesn't mark the layer as dirty */
+    layer.setColor(Containers::StridedArrayView1D<const DataHandle>{}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting multiple colors at once, data not in the list are left
+       untouched */
+    DataHandle handles[]{data3, data};
+    Color4 colors[]{0x99887766_rgbaf, 0x55443322_rgbaf};
+    layer.setColor(handles, colors);
+    CORRADE_COMPARE(layer.color(data), 0x55443322_rgbaf);
+    CORRADE_COMPARE(layer.color(data2), 0xffffffff_rgbaf);
+    CORRADE_COMPARE(layer.color(data3), 0x99887766_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    LayerDataHandle layerHandles[]{dataHandleData(data2)};
+    Color4 layerColors[]{0x12345678_rgbaf};
+    layer.setColor(layerHandles, layerColors);
+    CORRADE_COMPARE(layer.color(data2), 0x12345678_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void TextLayerTest::setPadding() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* Just to be sure the setters aren't picking up the first ever data
+       always */
+    layer.create(0, "", {});
+
+    /* There's nothing that would work differently for createGlyph() */
+    DataHandle data = layer.create(0, "", {});
+    CORRADE_COMPARE(layer.padding(data), Vector4{0.0f});
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting a padding marks the layer as dirty */
+    layer.setPadding(data, {2.0f, 4.0f, 3.0f, 1.0f});
+    CORRADE_COMPARE(layer.padding(data), (Vector4{2.0f, 4.0f, 3.0f, 1.0f}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    layer.setPadding(dataHandleData(data), {1.0f, 2.0f, 3.0f, 4.0f});
+    CORRADE_COMPARE(layer.padding(dataHandleData(data)), (Vector4{1.0f, 2.0f, 3.0f, 4.0f}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Single-value padding */
+    layer.setPadding(data, 4.0f);
+    CORRADE_COMPARE(layer.padding(data), Vector4{4.0f});
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    layer.setPadding(dataHandleData(data), 3.0f);
+    CORRADE_COMPARE(layer.padding(dataHandleData(data)), Vector4{3.0f});
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    DataHandle data2 = layer.create(0, "", {});
+    DataHandle data3 = layer.create(0, "", {});
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting an empty list doesn't mark the layer as dirty */
+    layer.setPadding(Containers::StridedArrayView1D<const DataHandle>{}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting multiple paddings at once, data not in the list are left
+       untouched */
+    DataHandle handles[]{data3, data};
+    Vector4 paddings[]{{5.0f, 6.0f, 7.0f, 8.0f}, {8.0f, 7.0f, 6.0f, 5.0f}};
+    layer.setPadding(handles, paddings);
+    CORRADE_COMPARE(layer.padding(data), (Vector4{8.0f, 7.0f, 6.0f, 5.0f}));
+    CORRADE_COMPARE(layer.padding(data2), Vector4{0.0f});
+    CORRADE_COMPARE(layer.padding(data3), (Vector4{5.0f, 6.0f, 7.0f, 8.0f}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    LayerDataHandle layerHandles[]{dataHandleData(data2)};
+    Vector4 layerPaddings[]{{0.5f, 1.5f, 2.5f, 3.5f}};
+    layer.setPadding(layerHandles, layerPaddings);
+    CORRADE_COMPARE(layer.padding(data2), (Vector4{0.5f, 1.5f, 2.5f, 3.5f}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void TextLayerTest::setPaddingInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment{}},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared, TextLayerFlag::Transformable} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle data = layer.create(0, "", {});
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.padding(data);
+    layer.padding(dataHandleData(data));
+    layer.setPadding(data, Vector4{});
+    layer.setPadding(dataHandleData(data), Vector4{});
+    layer.setPadding(data, 0.0f);
+    layer.setPadding(dataHandleData(data), 0.0f);
+    layer.setPadding(Containers::arrayView({data}), Containers::arrayView({Vector4{}}));
+    layer.setPadding(Containers::arrayView({dataHandleData(data)}), Containers::arrayView({Vector4{}}));
+    CORRADE_COMPARE_AS(out,
+        "Ui::TextLayer::padding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
+        "Ui::TextLayer::padding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
+        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
+        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
+        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
+        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
+        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n"
+        "Ui::TextLayer::setPadding(): per-data padding not available on a Ui::TextLayerFlag::Transformable layer\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::setColorPaddingMultipleInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32}};
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle handles[]{DataHandle::Null};
+    LayerDataHandle layerHandles[]{LayerDataHandle::Null};
+    Color4 colors[1];
+    Vector4 paddings[1];
+
+    Containers::String out;
+    Error redirectError{&out};
+    layer.setColor(handles, Containers::arrayView(colors).prefix(0));
+    layer.setColor(layerHandles, Containers::arrayView(colors).prefix(0));
+    layer.setColor(handles, colors);
+    layer.setColor(layerHandles, colors);
+    layer.setPadding(handles, Containers::arrayView(paddings).prefix(0));
+    layer.setPadding(layerHandles, Containers::arrayView(paddings).prefix(0));
+    layer.setPadding(handles, paddings);
+    layer.setPadding(layerHandles, paddings);
+    CORRADE_COMPARE_AS(out,
+        "Ui::TextLayer::setColor(): expected handle and color views to have the same size but got 1 and 0\n"
+        "Ui::TextLayer::setColor(): expected handle and color views to have the same size but got 1 and 0\n"
+        "Ui::TextLayer::setColor(): invalid handle Ui::DataHandle::Null at index 0\n"
+        "Ui::TextLayer::setColor(): invalid handle Ui::LayerDataHandle::Null at index 0\n"
+        "Ui::TextLayer::setPadding(): expected handle and padding views to have the same size but got 1 and 0\n"
+        "Ui::TextLayer::setPadding(): expected handle and padding views to have the same size but got 1 and 0\n"
+        "Ui::TextLayer::setPadding(): invalid handle Ui::DataHandle::Null at index 0\n"
+        "Ui::TextLayer::setPadding(): invalid handle Ui::LayerDataHandle::Null at index 0\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::setTransformation() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared, TextLayerFlag::Transformable} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* Just to be sure the setters aren't picking up the first ever data
+       always */
+    layer.create(0, "", {});
+
+    /* There's nothing that would work differently for createGlyph() */
+    DataHandle data = layer.create(0, "", {});
+    CORRADE_COMPARE(layer.transformation(data), Containers::pair(Vector2{}, Complex{Math::IdentityInit}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
 
     /* Clear the state flags */
     layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
@@ -9186,6 +11222,11 @@ void TextLayerTest::updateCleanDataOrder() {
     nodeOpacities[15] = 0.9f;
     nodesEnabled.set(15);
 
+    /* With shader node opacity the glyph vertex colors aren't multiplied with
+       the node opacity, the editing quads are */
+    const Float node6GlyphOpacity = data.sharedLayerFlags >= TextLayerSharedFlag::ShaderNodeOpacity ? 1.0f : 0.4f;
+    const Float node15GlyphOpacity = data.sharedLayerFlags >= TextLayerSharedFlag::ShaderNodeOpacity ? 1.0f : 0.9f;
+
     /* An empty update should generate an empty draw list */
     if(data.emptyUpdate) {
         layer.update(data.states, {}, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
@@ -9283,7 +11324,7 @@ void TextLayerTest::updateCleanDataOrder() {
         /* (Possibly editable) text 3, quads 2 to 6 */
         for(std::size_t i = 0; i != 5*4; ++i) {
             CORRADE_ITERATION(i);
-            CORRADE_COMPARE(vertices[2*4 + i].color, 0xff336699_rgbaf*0.4f);
+            CORRADE_COMPARE(vertices[2*4 + i].color, 0xff336699_rgbaf*node6GlyphOpacity);
             if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField)
                 CORRADE_COMPARE(invertedRunScales[2*4 + i], 1.0f/0.5f); /* threeGlyphFont */
         }
@@ -9314,7 +11355,7 @@ void TextLayerTest::updateCleanDataOrder() {
         /* Glyph 5, quad 8 */
         for(std::size_t i = 0; i != 1*4; ++i) {
             CORRADE_ITERATION(i);
-            CORRADE_COMPARE(vertices[8*4 + i].color, 0xcceeff00_rgbaf*0.4f);
+            CORRADE_COMPARE(vertices[8*4 + i].color, 0xcceeff00_rgbaf*node6GlyphOpacity);
             if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField)
                 CORRADE_COMPARE(invertedRunScales[8*4 + i], 1.0f/0.5f); /* threeGlyphFont */
             /* Created with style 4, which if not dynamic is mapped to uniform
@@ -9329,7 +11370,7 @@ void TextLayerTest::updateCleanDataOrder() {
         /* (Possibly editable) text 7, quad 9 */
         for(std::size_t i = 0; i != 1*4; ++i) {
             CORRADE_ITERATION(i);
-            CORRADE_COMPARE(vertices[9*4 + i].color, 0x11223344_rgbaf*0.9f);
+            CORRADE_COMPARE(vertices[9*4 + i].color, 0x11223344_rgbaf*node15GlyphOpacity);
             if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField)
                 CORRADE_COMPARE(invertedRunScales[9*4 + i], 1.0f/2.0f); /* oneGlyphFont */
             /* Created with style 1, which is mapped to uniform 2. The
@@ -9340,7 +11381,7 @@ void TextLayerTest::updateCleanDataOrder() {
         /* (Possibly editable) text 9, quads 11 to 12 */
         for(std::size_t i = 0; i != 2*4; ++i) {
             CORRADE_ITERATION(i);
-            CORRADE_COMPARE(vertices[11*4 + i].color, 0x663399ff_rgbaf*0.9f);
+            CORRADE_COMPARE(vertices[11*4 + i].color, 0x663399ff_rgbaf*node15GlyphOpacity);
             if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField)
                 CORRADE_COMPARE(invertedRunScales[11*4 + i], 1.0f/0.5f); /* threeGlyphFont */
             /* Created with style 3, which is mapped to uniform 1. There's only
@@ -9761,7 +11802,7 @@ void TextLayerTest::updateCleanDataOrder() {
     /* (Possibly editable) text 7, quad 3 */
     for(std::size_t i = 0; i != 1*4; ++i) {
         CORRADE_ITERATION(i);
-        CORRADE_COMPARE(vertices[3*4 + i].color, 0x11223344_rgbaf*0.9f);
+        CORRADE_COMPARE(vertices[3*4 + i].color, 0x11223344_rgbaf*node15GlyphOpacity);
         if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField)
             CORRADE_COMPARE(invertedRunScales[3*4 + i], 1.0f/2.0f); /* oneGlyphFont */
         /* Created with style 1, which is mapped to uniform 2. The selection
@@ -9771,7 +11812,7 @@ void TextLayerTest::updateCleanDataOrder() {
     /* (Possibly editable) text 9, quads 5 to 6 */
     for(std::size_t i = 0; i != 2*4; ++i) {
         CORRADE_ITERATION(i);
-        CORRADE_COMPARE(vertices[5*4 + i].color, 0x663399ff_rgbaf*0.9f);
+        CORRADE_COMPARE(vertices[5*4 + i].color, 0x663399ff_rgbaf*node15GlyphOpacity);
         if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField)
             CORRADE_COMPARE(invertedRunScales[5*4 + i], 1.0f/0.5f); /* threeGlyphFont */
         /* Created with style 3, which is mapped to uniform 1. There's only a
@@ -9969,7 +12010,7 @@ void TextLayerTest::updateCleanDataOrder() {
     /* (Possibly editable) text 9, quads 4 to 5 */
     for(std::size_t i = 0; i != 2*4; ++i) {
         CORRADE_ITERATION(i);
-        CORRADE_COMPARE(vertices[4*4 + i].color, 0x663399ff_rgbaf*0.9f);
+        CORRADE_COMPARE(vertices[4*4 + i].color, 0x663399ff_rgbaf*node15GlyphOpacity);
         if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField)
             CORRADE_COMPARE(invertedRunScales[4*4 + i], 1.0f/0.5f); /* threeGlyphFont */
         /* Created with style 3, which is mapped to uniform 1. There's only a
@@ -10036,6 +12077,131 @@ void TextLayerTest::updateCleanDataOrder() {
     }
 }
 
+void TextLayerTest::updateCompactionLargeData() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+
+        bool _opened = false;
+    } font;
+    font.openFile({}, 16.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addFont(font.glyphCount(), &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const TextLayer::State& stateData() const {
+            return static_cast<const TextLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* A large text at the front to get over the threshold where the data are
+       recompacted on every update, a text that's going to be changed and a
+       few more to not have the run count trigger the recompaction */
+    DataHandle large = layer.create(0, Containers::String{DirectInit, Implementation::RunCompactionMinSize, 'a'}, {});
+    DataHandle counter = layer.create(0, "12345", {});
+    for(std::size_t i = 0; i != 6; ++i)
+        layer.create(0, "a", {});
+    CORRADE_COMPARE(layer.stateData().glyphRuns.size(), 8);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), Implementation::RunCompactionMinSize + 5 + 6);
+
+    /* Setting a text of the same length reuses the run in place */
+    layer.setText(counter, "54321", {});
+    CORRADE_COMPARE(layer.stateData().glyphRuns.size(), 8);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), Implementation::RunCompactionMinSize + 5 + 6);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(counter)].glyphRun, 1);
+    CORRADE_COMPARE(layer.stateData().glyphRuns[1].glyphOffset, Implementation::RunCompactionMinSize);
+    CORRADE_COMPARE(layer.glyphCount(counter), 5);
+
+    /* A shorter text as well, leaving the rest unused */
+    layer.setText(counter, "99", {});
+    CORRADE_COMPARE(layer.stateData().glyphRuns.size(), 8);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), Implementation::RunCompactionMinSize + 5 + 6);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(counter)].glyphRun, 1);
+    CORRADE_COMPARE(layer.stateData().glyphRuns[1].glyphOffset, Implementation::RunCompactionMinSize);
+    CORRADE_COMPARE(layer.glyphCount(counter), 2);
+    CORRADE_COMPARE(layer.stateData().unusedGlyphRunCount, 0);
+    CORRADE_COMPARE(layer.stateData().unusedGlyphCount, 3);
+
+    /* A longer text doesn't fit, so it's put at the end */
+    layer.setText(counter, "1234567", {});
+    CORRADE_COMPARE(layer.stateData().glyphRuns.size(), 9);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), Implementation::RunCompactionMinSize + 5 + 6 + 7);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(counter)].glyphRun, 8);
+    CORRADE_COMPARE(layer.stateData().glyphRuns[1].glyphOffset, ~UnsignedInt{});
+    CORRADE_COMPARE(layer.glyphCount(counter), 7);
+    CORRADE_COMPARE(layer.stateData().unusedGlyphRunCount, 1);
+    CORRADE_COMPARE(layer.stateData().unusedGlyphCount, 5);
+
+    /* The unused portion is small, so update() doesn't recompact. The vertex
+       data include the unused space as well, as they're indexed by the glyph
+       offset. */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().glyphRuns.size(), 9);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), Implementation::RunCompactionMinSize + 5 + 6 + 7);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), (Implementation::RunCompactionMinSize + 5 + 6 + 7)*4*sizeof(Implementation::TextLayerVertex));
+    CORRADE_COMPARE(layer.stateData().unusedGlyphRunCount, 1);
+    CORRADE_COMPARE(layer.stateData().unusedGlyphCount, 5);
+
+    /* Removing the large text makes most of the data unused, so the next
+       update() recompacts everything */
+    layer.remove(large);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphOffset), Containers::arrayView({
+        0u, 1u, 2u, 3u, 4u, 5u, 6u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphCount), Containers::arrayView({
+        1u, 1u, 1u, 1u, 1u, 1u, 7u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 6 + 7);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(counter)].glyphRun, 6);
+    CORRADE_COMPARE(layer.glyphCount(counter), 7);
+    CORRADE_COMPARE(layer.stateData().unusedGlyphRunCount, 0);
+    CORRADE_COMPARE(layer.stateData().unusedGlyphCount, 0);
+
+    /* With the data being small again, same-length changes aren't done in
+       place anymore */
+    layer.setText(counter, "7654321", {});
+    CORRADE_COMPARE(layer.stateData().glyphRuns.size(), 8);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(counter)].glyphRun, 7);
+}
+
 void TextLayerTest::updateAlignment() {
     auto&& data = UpdateAlignmentPaddingData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -10349,16 +12515,271 @@ void TextLayerTest::updatePadding() {
 
                 Text::ShapeDirection _direction;
             };
-            return Containers::pointer<Shaper>(*this, direction);
+            return Containers::pointer<Shaper>(*this, direction);
+        }
+
+        Text::ShapeDirection direction;
+        bool _opened = false;
+    } font;
+    /* Direction returned from the shaper, direction passed through from
+       TextProperties tested in updateAlignment() above */
+    font.direction = data.shapeDirection;
+    font.openFile({}, 100.0f);
+
+    /* A trivial glyph cache. While font's ascent/descent goes both above and
+       below the line, this is just above. */
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addGlyph(cache.addFont(1, &font), 0, {}, {{}, {1, 2}});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}
+        .setEditingStyleCount(1)
+    };
+
+    /* Font scaled 2x, so all metrics coming from the font or the cache should
+       be scaled 2x */
+    FontHandle fontHandle = shared.addFont(font, 200.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        /* Alignment set to an arbitrary value, the one from TextProperties
+           should get used instead */
+        {Text::Alignment::BottomRight},
+        /* Features affect only create() / createGlyph() / setText() /
+           setGlyph(), not update(); tested in createSetTextTextProperties() */
+        {}, {}, {},
+        {0}, {0},
+        {{10.0f, 5.0f, 20.0f, 10.0f}});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}},
+        {},
+        /* The padding should be added to the selection / cursor rectangle but
+           without shifting the whole text in any way */
+        {{0.1f, 0.2f, 0.3f, 0.4f}});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    NodeHandle node3 = nodeHandle(3, 0);
+
+    /* 3 chars, size x2, so the bounding box is 9x11 */
+    DataHandle node3Data = layer.create(0, "hey", data.alignment, TextDataFlag::Editable, node3);
+    layer.setPadding(node3Data, {20.0f, 5.0f, 50.0f, 30.0f});
+    layer.setCursor(node3Data, 1, 3);
+
+    Vector2 nodeOffsets[4];
+    Vector2 nodeSizes[4];
+    Float nodeOpacities[4]{};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
+    nodeOffsets[3] = {20.5f, 10.5f};
+    nodeSizes[3] = {300.8f, 150.4f};
+    UnsignedInt dataIds[]{0};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* 2--3
+       |  |
+       0--1 */
+    CORRADE_COMPARE_AS(stridedArrayView(Containers::arrayCast<Implementation::TextLayerVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerVertex::position), Containers::arrayView<Vector2>({
+        Vector2{0.0f, 0.0f} + data.offset,
+        Vector2{2.0f, 0.0f} + data.offset,
+        Vector2{0.0f, -4.0f} + data.offset,
+        Vector2{2.0f, -4.0f} + data.offset,
+
+        Vector2{3.0f, 0.0f} + data.offset,
+        Vector2{5.0f, 0.0f} + data.offset,
+        Vector2{3.0f, -4.0f} + data.offset,
+        Vector2{5.0f, -4.0f} + data.offset,
+
+        Vector2{6.0f, 0.0f} + data.offset,
+        Vector2{8.0f, 0.0f} + data.offset,
+        Vector2{6.0f, -4.0f} + data.offset,
+        Vector2{8.0f, -4.0f} + data.offset,
+    }), TestSuite::Compare::Container);
+
+    /* 0--1
+       |  |
+       2--3 */
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::position), Containers::arrayView<Vector2>({
+        /* Selection containing glyph 1 and 2 (advance of 1.5*2), plus
+           padding; ascent 3.5*2, descent 2.0*2 */
+        Vector2{3.0f        - data.editingPaddingL, -7.0f - 0.2f} + data.offset,
+        Vector2{6.0f + 3.0f + data.editingPaddingR, -7.0f - 0.2f} + data.offset,
+        Vector2{3.0f        - data.editingPaddingL,  4.0f + 0.4f} + data.offset,
+        Vector2{6.0f + 3.0f + data.editingPaddingR,  4.0f + 0.4f} + data.offset,
+
+        /* Cursor before glyph 1, plus padding */
+        Vector2{3.0f        - data.editingPaddingL, -7.0f - 0.2f} + data.offset,
+        Vector2{3.0f        + data.editingPaddingR, -7.0f - 0.2f} + data.offset,
+        Vector2{3.0f        - data.editingPaddingL,  4.0f + 0.4f} + data.offset,
+        Vector2{3.0f        + data.editingPaddingR,  4.0f + 0.4f} + data.offset,
+    }), TestSuite::Compare::Container);
+}
+
+void TextLayerTest::updatePaddingGlyph() {
+    auto&& data = UpdateAlignmentPaddingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Same as updateAlignmentGlyph(), except that the node offset & size is
+       different and only matches the original if padding is applied
+       correctly from both the data and the style. Additionally, in comparison
+       to updateAlignmentGlyph(), the style-supplied alignment is a bogus value
+       and padding from the TextProperties is used instead. */
+
+    /* A trivial glyph cache. Goes both above and below the line to verify
+       vertical alignment. */
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+
+    UnsignedInt glyphCacheFontId = cache.addFont(18);
+    cache.addGlyph(glyphCacheFontId, 17, {-2, -3}, {{}, {3, 4}});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}};
+
+    /* Font scaled 2x, so all metrics coming from the the cache should be
+       scaled 2x */
+    FontHandle fontHandle = shared.addInstancelessFont(glyphCacheFontId, 2.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        /* Alignment set to an arbitrary value, the one from TextProperties
+           should get used instead */
+        {Text::Alignment::BottomRight},
+        /* Features affect only create() / createGlyph() / setText() /
+           setGlyph(), not update(); tested in createSetTextTextProperties() */
+        {}, {}, {},
+        /* Editing styles aren't used for single glyphs */
+        {}, {},
+        {{10.0f, 5.0f, 20.0f, 10.0f}});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    NodeHandle node3 = nodeHandle(3, 0);
+
+    /* Size x2, so the bounding box is 6x8 */
+    DataHandle node3Data = layer.createGlyph(0, 17,
+        TextProperties{}
+            .setAlignment(data.alignment)
+            /* There's no way to detect the direction as no shaper is used, so
+               compared to updateAlignment() / updatePadding() this is always
+               passed in via TextProperties */
+            .setShapeDirection(data.shapeDirection),
+        node3);
+    layer.setPadding(node3Data, {20.0f, 5.0f, 50.0f, 30.0f});
+
+    Vector2 nodeOffsets[4];
+    Vector2 nodeSizes[4];
+    Float nodeOpacities[4]{};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
+    nodeOffsets[3] = {20.5f, 10.5f};
+    nodeSizes[3] = {300.8f, 150.4f};
+    UnsignedInt dataIds[]{0};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* 2--3
+       |  |
+       0--1 */
+    CORRADE_COMPARE_AS(stridedArrayView(Containers::arrayCast<Implementation::TextLayerVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerVertex::position), Containers::arrayView<Vector2>({
+        Vector2{0.0f, 0.0f} + data.offsetGlyph,
+        Vector2{6.0f, 0.0f} + data.offsetGlyph,
+        Vector2{0.0f, -8.0f} + data.offsetGlyph,
+        Vector2{6.0f, -8.0f} + data.offsetGlyph
+    }), TestSuite::Compare::Container);
+}
+
+void TextLayerTest::updateTransformation() {
+    auto&& data = UpdateTransformationData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Trimmed-down variant of updatePadding() that checks transformations get
+       applied in correct order respective to node offset and padding coming
+       from style. Testing with multiple glyphs to verify they're all
+       transformed while preserving their relative position. Single-glyph
+       rendering has no specific behavior so it isn't tested. */
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            /* Line height shouldn't be used for anything */
+            return {size, 7.0f*size/100.0f, -4.0f*size/100.0f, 10000.0f, 1};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            struct Shaper: Text::AbstractShaper {
+                explicit Shaper(Text::AbstractFont& font): Text::AbstractShaper{font} {}
+
+                UnsignedInt doShape(Containers::StringView text, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
+                    return text.size();
+                }
+                void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+                    for(std::size_t i = 0; i != ids.size(); ++i)
+                        ids[i] = 0;
+                }
+                void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+                    for(std::size_t i = 0; i != offsets.size(); ++i) {
+                        offsets[i] = {};
+                        advances[i] = {3.0f*font().size()/100.0f, 0.0f};
+                    }
+                }
+                void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>&) const override {
+                    CORRADE_FAIL("This shouldn't be called.");
+                }
+            };
+            return Containers::pointer<Shaper>(*this);
         }
 
-        Text::ShapeDirection direction;
         bool _opened = false;
     } font;
-    /* Direction returned from the shaper, direction passed through from
-       TextProperties tested in updateAlignment() above */
-    font.direction = data.shapeDirection;
-    font.openFile({}, 100.0f);
+    /* Open the font at twice the size to then add it back at the original size
+       below, to verify this 0.5x scale gets correctly propagated to the
+       distance field attribute */
+    font.openFile({}, 200.0f);
 
     /* A trivial glyph cache. While font's ascent/descent goes both above and
        below the line, this is just above. */
@@ -10369,7 +12790,10 @@ void TextLayerTest::updatePadding() {
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
     /* Default padding is 1, resetting to 0 for simplicity */
     } cache{PixelFormat::R8Unorm, {32, 32}, {}};
-    cache.addGlyph(cache.addFont(1, &font), 0, {}, {{}, {1, 2}});
+    /* Y glyph offset to verify the transformation is relative to cursor
+       placement also on Y, not to bounding box edge. The offset and size gets
+       divided by 2. */
+    cache.addGlyph(cache.addFont(1, &font), 0, {0, -2}, {{}, {4, 8}});
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
@@ -10377,37 +12801,24 @@ void TextLayerTest::updatePadding() {
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
     } shared{cache, TextLayer::Shared::Configuration{1}
-        .setEditingStyleCount(1)
+        .setFlags(data.sharedLayerFlags)
     };
 
-    /* Font scaled 2x, so all metrics coming from the font or the cache should
-       be scaled 2x */
-    FontHandle fontHandle = shared.addFont(font, 200.0f);
+    FontHandle fontHandle = shared.addFont(font, 100.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
         {fontHandle},
-        /* Alignment set to an arbitrary value, the one from TextProperties
-           should get used instead */
         {Text::Alignment::BottomRight},
-        /* Features affect only create() / createGlyph() / setText() /
-           setGlyph(), not update(); tested in createSetTextTextProperties() */
-        {}, {}, {},
-        {0}, {0},
-        {{10.0f, 5.0f, 20.0f, 10.0f}});
-    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
-        {TextLayerEditingStyleUniform{}},
-        {},
-        /* The padding should be added to the selection / cursor rectangle but
-           without shifting the whole text in any way */
-        {{0.1f, 0.2f, 0.3f, 0.4f}});
+        {}, {}, {}, {}, {},
+        {{50.0f, 100.0f, 5.0f, 10.0f}});
 
     struct Layer: TextLayer {
-        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+        explicit Layer(LayerHandle handle, Shared& shared, TextLayerFlags flags): TextLayer{handle, shared, flags} {}
 
         const State& stateData() const {
             return static_cast<const State&>(*_state);
         }
-    } layer{layerHandle(0, 1), shared};
+    } layer{layerHandle(0, 1), shared, data.layerFlags};
 
     /* Required to be called before update() (because AbstractUserInterface
        guarantees the same on a higher level), not needed for anything here */
@@ -10415,72 +12826,236 @@ void TextLayerTest::updatePadding() {
 
     NodeHandle node3 = nodeHandle(3, 0);
 
-    /* 3 chars, size x2, so the bounding box is 9x11 */
-    DataHandle node3Data = layer.create(0, "hey", data.alignment, TextDataFlag::Editable, node3);
-    layer.setPadding(node3Data, {20.0f, 5.0f, 50.0f, 30.0f});
-    layer.setCursor(node3Data, 1, 3);
+    /* 3 chars, so the bounding box is 9x11. It's always that regardless of
+       transformation. */
+    DataHandle node3Data = layer.create(0, "hey", {}, node3);
+    if(data.layerFlags >= TextLayerFlag::Transformable)
+        layer.setTransformation(node3Data, data.translation, data.rotation, data.scaling);
+    CORRADE_COMPARE(layer.size(node3Data), (Vector2{9.0f, 11.0f}));
 
     Vector2 nodeOffsets[4];
     Vector2 nodeSizes[4];
     Float nodeOpacities[4]{};
     UnsignedByte nodesEnabledData[1]{};
     Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
-    nodeOffsets[3] = {20.5f, 10.5f};
-    nodeSizes[3] = {300.8f, 150.4f};
+    nodeOffsets[3] = {20.0f, 10.0f};
+    nodeSizes[3] = {300.0f, 150.0f};
     UnsignedInt dataIds[]{0};
     layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
 
+    /* As the alignment is bottom right, the text rendering cursor is at bottom
+       right of the 9x11 box, and it's placed to the bottom right corner of the
+       node. Then, while each glyph bounding box is 3x11, the actual glyph is
+       2x4, so it's 3 units from the bottom and after each there's 1 unit space
+       on the right.
+                       node    node    padding right
+                       offset  size    padding bottom */
+    Vector2 baseOffset{20.0f + 300.0f - 5.0f,
+                       10.0f + 150.0f - 10.0f};
+
     /* 2--3
        |  |
        0--1 */
-    CORRADE_COMPARE_AS(stridedArrayView(Containers::arrayCast<Implementation::TextLayerVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerVertex::position), Containers::arrayView<Vector2>({
-        Vector2{0.0f, 0.0f} + data.offset,
-        Vector2{2.0f, 0.0f} + data.offset,
-        Vector2{0.0f, -4.0f} + data.offset,
-        Vector2{2.0f, -4.0f} + data.offset,
+    Containers::StridedArrayView1D<const Vector2> positions;
+    Containers::StridedArrayView1D<const Float> invertedRunScales;
+
+    /* With instanced glyphs, expand the three corners stored for each glyph
+       to the four vertices the non-instanced variant has, in order to verify
+       both against the same expected values */
+    Vector2 instancedPositions[3*4];
+    Float instancedInvertedRunScales[3*4];
+    if(data.sharedLayerFlags >= TextLayerSharedFlag::InstancedGlyphs) {
+        /* There are no glyph indices */
+        CORRADE_COMPARE(layer.stateData().indices.size(), 0);
+
+        const std::size_t typeSize = data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField ?
+            sizeof(Implementation::TextLayerDistanceFieldGlyphInstance) :
+            sizeof(Implementation::TextLayerGlyphInstance);
+        Containers::StridedArrayView1D<const Implementation::TextLayerGlyphInstance> instances{
+            layer.stateData().vertices,
+            reinterpret_cast<const Implementation::TextLayerGlyphInstance*>(layer.stateData().vertices.data()),
+            layer.stateData().vertices.size()/typeSize,
+            std::ptrdiff_t(typeSize)};
+        CORRADE_COMPARE(instances.size(), 3);
+
+        for(std::size_t i = 0; i != instances.size(); ++i) {
+            instancedPositions[i*4 + 0] = instances[i].corner0;
+            instancedPositions[i*4 + 1] = instances[i].corner1;
+            instancedPositions[i*4 + 2] = instances[i].corner2;
+            instancedPositions[i*4 + 3] = instances[i].corner1 + instances[i].corner2 - instances[i].corner0;
+
+            /* The glyph is the whole 4x8 area at the origin of the 32x32
+               cache, in the first and only layer */
+            CORRADE_ITERATION(i);
+            CORRADE_COMPARE(instances[i].textureCoordinateMin, Vector3{});
+            CORRADE_COMPARE(instances[i].textureCoordinateMax, (Vector2{0.125f, 0.25f}));
+        }
+        positions = instancedPositions;
+
+        if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField) {
+            const Containers::StridedArrayView1D<const Implementation::TextLayerDistanceFieldGlyphInstance> distanceFieldInstances = Containers::arrayCast<const Implementation::TextLayerDistanceFieldGlyphInstance>(instances);
+            for(std::size_t i = 0; i != instances.size(); ++i)
+                for(std::size_t j = 0; j != 4; ++j)
+                    instancedInvertedRunScales[i*4 + j] = distanceFieldInstances[i].invertedRunScale;
+            invertedRunScales = instancedInvertedRunScales;
+        }
+    } else if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField) {
+        positions = stridedArrayView(Containers::arrayCast<Implementation::TextLayerDistanceFieldVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerDistanceFieldVertex::vertex).slice(&Implementation::TextLayerVertex::position);
+        invertedRunScales = stridedArrayView(Containers::arrayCast<Implementation::TextLayerDistanceFieldVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerDistanceFieldVertex::invertedRunScale);
+    } else {
+        positions = stridedArrayView(Containers::arrayCast<Implementation::TextLayerVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerVertex::position);
+    }
 
-        Vector2{3.0f, 0.0f} + data.offset,
-        Vector2{5.0f, 0.0f} + data.offset,
-        Vector2{3.0f, -4.0f} + data.offset,
-        Vector2{5.0f, -4.0f} + data.offset,
+    /* With shader transformation the positions are relative to the text
+       origin and the transformation is in a separate per-data array. Apply
+       it the same way as the shader does, then verify against the same
+       expected values. */
+    Vector2 shaderTransformedPositions[3*4];
+    Float shaderTransformedInvertedRunScales[3*4];
+    if(data.sharedLayerFlags >= TextLayerSharedFlag::ShaderTransformation) {
+        CORRADE_VERIFY(layer.stateData().dataTransformationsChanged);
+        CORRADE_COMPARE(layer.stateData().dataTransformations.size(), 1);
+        const Vector4 transformation = layer.stateData().dataTransformations[0];
+        const Complex rotationScaling{transformation.z(), transformation.w()};
+        CORRADE_COMPARE(positions.size(), 3*4);
+        for(std::size_t i = 0; i != positions.size(); ++i)
+            shaderTransformedPositions[i] = transformation.xy() + rotationScaling.transformVector(positions[i]);
+        positions = shaderTransformedPositions;
+
+        if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField) {
+            for(std::size_t i = 0; i != invertedRunScales.size(); ++i)
+                shaderTransformedInvertedRunScales[i] = invertedRunScales[i]/rotationScaling.length();
+            invertedRunScales = shaderTransformedInvertedRunScales;
+        }
+    }
 
-        Vector2{6.0f, 0.0f} + data.offset,
-        Vector2{8.0f, 0.0f} + data.offset,
-        Vector2{6.0f, -4.0f} + data.offset,
-        Vector2{8.0f, -4.0f} + data.offset,
-    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(positions, Containers::arrayView<Vector2>({
+        baseOffset + data.expected.transformPoint({-9.0f, -3.0f}),
+        baseOffset + data.expected.transformPoint({-7.0f, -3.0f}),
+        baseOffset + data.expected.transformPoint({-9.0f, -7.0f}),
+        baseOffset + data.expected.transformPoint({-7.0f, -7.0f}),
 
-    /* 0--1
-       |  |
-       2--3 */
-    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::position), Containers::arrayView<Vector2>({
-        /* Selection containing glyph 1 and 2 (advance of 1.5*2), plus
-           padding; ascent 3.5*2, descent 2.0*2 */
-        Vector2{3.0f        - data.editingPaddingL, -7.0f - 0.2f} + data.offset,
-        Vector2{6.0f + 3.0f + data.editingPaddingR, -7.0f - 0.2f} + data.offset,
-        Vector2{3.0f        - data.editingPaddingL,  4.0f + 0.4f} + data.offset,
-        Vector2{6.0f + 3.0f + data.editingPaddingR,  4.0f + 0.4f} + data.offset,
+        baseOffset + data.expected.transformPoint({-6.0f, -3.0f}),
+        baseOffset + data.expected.transformPoint({-4.0f, -3.0f}),
+        baseOffset + data.expected.transformPoint({-6.0f, -7.0f}),
+        baseOffset + data.expected.transformPoint({-4.0f, -7.0f}),
 
-        /* Cursor before glyph 1, plus padding */
-        Vector2{3.0f        - data.editingPaddingL, -7.0f - 0.2f} + data.offset,
-        Vector2{3.0f        + data.editingPaddingR, -7.0f - 0.2f} + data.offset,
-        Vector2{3.0f        - data.editingPaddingL,  4.0f + 0.4f} + data.offset,
-        Vector2{3.0f        + data.editingPaddingR,  4.0f + 0.4f} + data.offset,
+        baseOffset + data.expected.transformPoint({-3.0f, -3.0f}),
+        baseOffset + data.expected.transformPoint({-1.0f, -3.0f}),
+        baseOffset + data.expected.transformPoint({-3.0f, -7.0f}),
+        baseOffset + data.expected.transformPoint({-1.0f, -7.0f}),
     }), TestSuite::Compare::Container);
+
+    /* If there's a positive rotation, it should be clockwise, i.e. the next
+       quads being lower (i.e., Y larger with Y down) than the first, and vice
+       versa */
+    if(data.rotation > 0.0_radf) {
+        CORRADE_COMPARE_AS(positions[4].y(),
+                           positions[0].y(),
+                           TestSuite::Compare::Greater);
+        CORRADE_COMPARE_AS(positions[8].y(),
+                           positions[4].y(),
+                           TestSuite::Compare::Greater);
+    } else if(data.rotation < 0.0_radf) {
+        CORRADE_COMPARE_AS(positions[4].y(),
+                           positions[0].y(),
+                           TestSuite::Compare::Less);
+        CORRADE_COMPARE_AS(positions[8].y(),
+                           positions[4].y(),
+                           TestSuite::Compare::Less);
+    }
+
+    /* A transform scale should get reflected in the attribute for distance
+       field radius scaling, in addition to the font scale */
+    if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField) {
+        CORRADE_COMPARE_AS(invertedRunScales, Containers::arrayView({
+            1.0f/(0.5f*data.scaling),
+            1.0f/(0.5f*data.scaling),
+            1.0f/(0.5f*data.scaling),
+            1.0f/(0.5f*data.scaling),
+
+            1.0f/(0.5f*data.scaling),
+            1.0f/(0.5f*data.scaling),
+            1.0f/(0.5f*data.scaling),
+            1.0f/(0.5f*data.scaling),
+
+            1.0f/(0.5f*data.scaling),
+            1.0f/(0.5f*data.scaling),
+            1.0f/(0.5f*data.scaling),
+            1.0f/(0.5f*data.scaling),
+        }), TestSuite::Compare::Container);
+    }
+
+    /* With shader transformation, changing the transformation afterwards
+       only updates the per-data transformations, not the vertices */
+    if(data.sharedLayerFlags >= TextLayerSharedFlag::ShaderTransformation &&
+       data.layerFlags >= TextLayerFlag::Transformable) {
+        layer.translate(node3Data, {1.0f, 2.0f});
+        CORRADE_COMPARE(layer.state(), LayerState::NeedsCommonDataUpdate);
+
+        Containers::Array<char> verticesBefore{NoInit, layer.stateData().vertices.size()};
+        Utility::copy(layer.stateData().vertices, verticesBefore);
+        const Vector4 transformationBefore = layer.stateData().dataTransformations[0];
+        layer.update(LayerState::NeedsCommonDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+        CORRADE_COMPARE_AS(layer.stateData().vertices, verticesBefore,
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(layer.stateData().dataTransformations[0], transformationBefore + Vector4{1.0f, 2.0f, 0.0f, 0.0f});
+    }
 }
 
-void TextLayerTest::updatePaddingGlyph() {
-    auto&& data = UpdateAlignmentPaddingData[testCaseInstanceId()];
+void TextLayerTest::updateWrap() {
+    auto&& data = UpdateWrapData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
-    /* Same as updateAlignmentGlyph(), except that the node offset & size is
-       different and only matches the original if padding is applied
-       correctly from both the data and the style. Additionally, in comparison
-       to updateAlignmentGlyph(), the style-supplied alignment is a bogus value
-       and padding from the TextProperties is used instead. */
+    struct Shaper: Text::AbstractShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled): Text::AbstractShaper{font}, shapeCalled(shapeCalled) {}
 
-    /* A trivial glyph cache. Goes both above and below the line to verify
-       vertical alignment. */
+        UnsignedInt doShape(Containers::StringView, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange>) override {
+            ++shapeCalled;
+            _begin = begin;
+            return end - begin;
+        }
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+            for(std::size_t i = 0; i != ids.size(); ++i)
+                ids[i] = 0;
+        }
+        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+            for(std::size_t i = 0; i != offsets.size(); ++i) {
+                offsets[i] = {};
+                advances[i] = {1.0f, 0.0f};
+            }
+        }
+        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+            for(std::size_t i = 0; i != clusters.size(); ++i)
+                clusters[i] = _begin + i;
+        }
+
+        int& shapeCalled;
+        UnsignedInt _begin;
+    };
+
+    struct Font: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 3.0f, -1.0f, 4.0f, 1};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
+        bool _opened = false;
+    } font;
+    font.openFile({}, 10.0f);
+
+    /* The glyph quad is as wide as the advance */
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
@@ -10488,9 +13063,7 @@ void TextLayerTest::updatePaddingGlyph() {
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
     /* Default padding is 1, resetting to 0 for simplicity */
     } cache{PixelFormat::R8Unorm, {32, 32}, {}};
-
-    UnsignedInt glyphCacheFontId = cache.addFont(18);
-    cache.addGlyph(glyphCacheFontId, 17, {-2, -3}, {{}, {3, 4}});
+    cache.addGlyph(cache.addFont(1, &font), 0, {}, {{}, {1, 1}});
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
@@ -10499,21 +13072,11 @@ void TextLayerTest::updatePaddingGlyph() {
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
     } shared{cache, TextLayer::Shared::Configuration{1}};
 
-    /* Font scaled 2x, so all metrics coming from the the cache should be
-       scaled 2x */
-    FontHandle fontHandle = shared.addInstancelessFont(glyphCacheFontId, 2.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {fontHandle},
-        /* Alignment set to an arbitrary value, the one from TextProperties
-           should get used instead */
-        {Text::Alignment::BottomRight},
-        /* Features affect only create() / createGlyph() / setText() /
-           setGlyph(), not update(); tested in createSetTextTextProperties() */
-        {}, {}, {},
-        /* Editing styles aren't used for single glyphs */
-        {}, {},
-        {{10.0f, 5.0f, 20.0f, 10.0f}});
+        {shared.addFont(font, 10.0f)},
+        {data.alignment},
+        {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
@@ -10527,57 +13090,76 @@ void TextLayerTest::updatePaddingGlyph() {
        guarantees the same on a higher level), not needed for anything here */
     layer.setSize({1, 1}, {1, 1});
 
-    NodeHandle node3 = nodeHandle(3, 0);
-
-    /* Size x2, so the bounding box is 6x8 */
-    DataHandle node3Data = layer.createGlyph(0, 17,
-        TextProperties{}
-            .setAlignment(data.alignment)
-            /* There's no way to detect the direction as no shaper is used, so
-               compared to updateAlignment() / updatePadding() this is always
-               passed in via TextProperties */
-            .setShapeDirection(data.shapeDirection),
-        node3);
-    layer.setPadding(node3Data, {20.0f, 5.0f, 50.0f, 30.0f});
-
-    Vector2 nodeOffsets[4];
-    Vector2 nodeSizes[4];
-    Float nodeOpacities[4]{};
+    /* The same text with and without wrapping, attached to nodes of the same
+       offset and size */
+    DataHandle wrapped = layer.create(0, data.text, {}, TextDataFlag::Wrap, nodeHandle(0, 0));
+    layer.create(0, data.text, {}, nodeHandle(1, 0));
+    CORRADE_COMPARE(layer.flags(wrapped), TextDataFlag::Wrap);
+    const UnsignedInt glyphCount = layer.glyphCount(wrapped);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), glyphCount*2);
+
+    Vector2 nodeOffsets[2];
+    Vector2 nodeSizes[2];
+    Float nodeOpacities[2]{};
     UnsignedByte nodesEnabledData[1]{};
-    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
-    nodeOffsets[3] = {20.5f, 10.5f};
-    nodeSizes[3] = {300.8f, 150.4f};
-    UnsignedInt dataIds[]{0};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 2};
+    nodeOffsets[0] = nodeOffsets[1] = {10.0f, 20.0f};
+    nodeSizes[0] = nodeSizes[1] = {data.width, 50.0f};
+    UnsignedInt dataIds[]{0, 1};
     layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
 
-    /* 2--3
-       |  |
-       0--1 */
-    CORRADE_COMPARE_AS(stridedArrayView(Containers::arrayCast<Implementation::TextLayerVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerVertex::position), Containers::arrayView<Vector2>({
-        Vector2{0.0f, 0.0f} + data.offsetGlyph,
-        Vector2{6.0f, 0.0f} + data.offsetGlyph,
-        Vector2{0.0f, -8.0f} + data.offsetGlyph,
-        Vector2{6.0f, -8.0f} + data.offsetGlyph
-    }), TestSuite::Compare::Container);
+    const Containers::StridedArrayView1D<const Vector2> positions = stridedArrayView(Containers::arrayCast<const Implementation::TextLayerVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerVertex::position);
+    CORRADE_COMPARE(positions.size(), glyphCount*2*4);
+    Containers::Array<Vector2> expected{NoInit, glyphCount*4};
+    for(std::size_t i = 0; i != expected.size(); ++i)
+        expected[i] = positions[glyphCount*4 + i] + data.offsets[i/4];
+    CORRADE_COMPARE_AS(positions.prefix(glyphCount*4), expected,
+        TestSuite::Compare::Container);
+
+    /* Making the node large enough to fit the whole text breaks the lines
+       again, without shaping anything */
+    const int shapeCalled = font.shapeCalled;
+    nodeSizes[0] = nodeSizes[1] = {100.0f, 50.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, shapeCalled);
+    const Containers::StridedArrayView1D<const Vector2> positionsFit = stridedArrayView(Containers::arrayCast<const Implementation::TextLayerVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerVertex::position);
+    CORRADE_COMPARE_AS(positionsFit.prefix(glyphCount*4), positionsFit.exceptPrefix(glyphCount*4),
+        TestSuite::Compare::Container);
 }
 
-void TextLayerTest::updateTransformation() {
-    auto&& data = UpdateTransformationData[testCaseInstanceId()];
-    setTestCaseDescription(data.name);
+void TextLayerTest::updateGlyphCulling() {
+    /* Each glyph is a 1x1 quad advancing by 1 unit in X */
+    struct Shaper: Text::AbstractShaper {
+        using Text::AbstractShaper::AbstractShaper;
+
+        UnsignedInt doShape(Containers::StringView, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange>) override {
+            _begin = begin;
+            return end - begin;
+        }
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+            for(std::size_t i = 0; i != ids.size(); ++i)
+                ids[i] = 0;
+        }
+        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+            for(std::size_t i = 0; i != offsets.size(); ++i) {
+                offsets[i] = {};
+                advances[i] = {1.0f, 0.0f};
+            }
+        }
+        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+            for(std::size_t i = 0; i != clusters.size(); ++i)
+                clusters[i] = _begin + i;
+        }
 
-    /* Trimmed-down variant of updatePadding() that checks transformations get
-       applied in correct order respective to node offset and padding coming
-       from style. Testing with multiple glyphs to verify they're all
-       transformed while preserving their relative position. Single-glyph
-       rendering has no specific behavior so it isn't tested. */
+        UnsignedInt _begin;
+    };
 
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
         bool doIsOpened() const override { return _opened; }
         Properties doOpenFile(Containers::StringView, Float size) override {
             _opened = true;
-            /* Line height shouldn't be used for anything */
-            return {size, 7.0f*size/100.0f, -4.0f*size/100.0f, 10000.0f, 1};
+            return {size, 3.0f, -1.0f, 4.0f, 1};
         }
         void doClose() override { _opened = false; }
 
@@ -10585,38 +13167,13 @@ void TextLayerTest::updateTransformation() {
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
         Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
-            struct Shaper: Text::AbstractShaper {
-                explicit Shaper(Text::AbstractFont& font): Text::AbstractShaper{font} {}
-
-                UnsignedInt doShape(Containers::StringView text, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
-                    return text.size();
-                }
-                void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
-                    for(std::size_t i = 0; i != ids.size(); ++i)
-                        ids[i] = 0;
-                }
-                void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
-                    for(std::size_t i = 0; i != offsets.size(); ++i) {
-                        offsets[i] = {};
-                        advances[i] = {3.0f*font().size()/100.0f, 0.0f};
-                    }
-                }
-                void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>&) const override {
-                    CORRADE_FAIL("This shouldn't be called.");
-                }
-            };
             return Containers::pointer<Shaper>(*this);
         }
 
         bool _opened = false;
     } font;
-    /* Open the font at twice the size to then add it back at the original size
-       below, to verify this 0.5x scale gets correctly propagated to the
-       distance field attribute */
-    font.openFile({}, 200.0f);
+    font.openFile({}, 10.0f);
 
-    /* A trivial glyph cache. While font's ascent/descent goes both above and
-       below the line, this is just above. */
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
@@ -10624,27 +13181,20 @@ void TextLayerTest::updateTransformation() {
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
     /* Default padding is 1, resetting to 0 for simplicity */
     } cache{PixelFormat::R8Unorm, {32, 32}, {}};
-    /* Y glyph offset to verify the transformation is relative to cursor
-       placement also on Y, not to bounding box edge. The offset and size gets
-       divided by 2. */
-    cache.addGlyph(cache.addFont(1, &font), 0, {0, -2}, {{}, {4, 8}});
+    cache.addGlyph(cache.addFont(1, &font), 0, {}, {{}, {1, 1}});
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{cache, TextLayer::Shared::Configuration{1}
-        .setFlags(data.sharedLayerFlags)
-    };
+    } shared{cache, TextLayer::Shared::Configuration{1}};
 
-    FontHandle fontHandle = shared.addFont(font, 100.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {fontHandle},
-        {Text::Alignment::BottomRight},
-        {}, {}, {}, {}, {},
-        {{50.0f, 100.0f, 5.0f, 10.0f}});
+        {shared.addFont(font, 10.0f)},
+        {Text::Alignment::LineLeft},
+        {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared, TextLayerFlags flags): TextLayer{handle, shared, flags} {}
@@ -10652,104 +13202,93 @@ void TextLayerTest::updateTransformation() {
         const State& stateData() const {
             return static_cast<const State&>(*_state);
         }
-    } layer{layerHandle(0, 1), shared, data.layerFlags};
+    } layer{layerHandle(0, 1), shared, TextLayerFlag::GlyphCulling};
 
     /* Required to be called before update() (because AbstractUserInterface
        guarantees the same on a higher level), not needed for anything here */
     layer.setSize({1, 1}, {1, 1});
 
-    NodeHandle node3 = nodeHandle(3, 0);
-
-    /* 3 chars, so the bounding box is 9x11. It's always that regardless of
-       transformation. */
-    DataHandle node3Data = layer.create(0, "hey", {}, node3);
-    if(data.layerFlags >= TextLayerFlag::Transformable)
-        layer.setTransformation(node3Data, data.translation, data.rotation, data.scaling);
-    CORRADE_COMPARE(layer.size(node3Data), (Vector2{9.0f, 11.0f}));
+    /* A long text that's partially clipped, a short one that isn't clipped
+       at all and a short one that's fully outside of the clip rect */
+    layer.create(0, "abcdefgh", {}, nodeHandle(0, 0));
+    layer.create(0, "ab", {}, nodeHandle(1, 0));
+    layer.create(0, "ab", {}, nodeHandle(2, 0));
 
-    Vector2 nodeOffsets[4];
-    Vector2 nodeSizes[4];
-    Float nodeOpacities[4]{};
+    Vector2 nodeOffsets[]{
+        {10.0f, 20.0f},
+        {10.0f, 20.0f},
+        {50.0f, 20.0f},
+    };
+    Vector2 nodeSizes[]{
+        {100.0f, 50.0f},
+        {100.0f, 50.0f},
+        {100.0f, 50.0f},
+    };
+    Float nodeOpacities[3]{};
     UnsignedByte nodesEnabledData[1]{};
-    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
-    nodeOffsets[3] = {20.0f, 10.0f};
-    nodeSizes[3] = {300.0f, 150.0f};
-    UnsignedInt dataIds[]{0};
-    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
-
-    /* As the alignment is bottom right, the text rendering cursor is at bottom
-       right of the 9x11 box, and it's placed to the bottom right corner of the
-       node. Then, while each glyph bounding box is 3x11, the actual glyph is
-       2x4, so it's 3 units from the bottom and after each there's 1 unit space
-       on the right.
-                       node    node    padding right
-                       offset  size    padding bottom */
-    Vector2 baseOffset{20.0f + 300.0f - 5.0f,
-                       10.0f + 150.0f - 10.0f};
-
-    /* 2--3
-       |  |
-       0--1 */
-    Containers::StridedArrayView1D<const Vector2> positions =
-        data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField ?
-            stridedArrayView(Containers::arrayCast<Implementation::TextLayerDistanceFieldVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerDistanceFieldVertex::vertex).slice(&Implementation::TextLayerVertex::position) :
-            stridedArrayView(Containers::arrayCast<Implementation::TextLayerVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerVertex::position);
-    CORRADE_COMPARE_AS(positions, Containers::arrayView<Vector2>({
-        baseOffset + data.expected.transformPoint({-9.0f, -3.0f}),
-        baseOffset + data.expected.transformPoint({-7.0f, -3.0f}),
-        baseOffset + data.expected.transformPoint({-9.0f, -7.0f}),
-        baseOffset + data.expected.transformPoint({-7.0f, -7.0f}),
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 3};
+    /* The glyph quads of the first text span X from 10 to 18, the clip rect
+       covers glyphs 2 to 5. Zero size means no clipping. */
+    Vector2 clipRectOffsets[]{
+        {12.5f, 0.0f},
+        {},
+    };
+    Vector2 clipRectSizes[]{
+        {3.0f, 100.0f},
+        {},
+    };
+    UnsignedInt dataIds[]{0, 2, 1};
+    UnsignedInt clipRectIds[]{0, 1};
+    UnsignedInt clipRectDataCounts[]{2, 1};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, {}, {});
 
-        baseOffset + data.expected.transformPoint({-6.0f, -3.0f}),
-        baseOffset + data.expected.transformPoint({-4.0f, -3.0f}),
-        baseOffset + data.expected.transformPoint({-6.0f, -7.0f}),
-        baseOffset + data.expected.transformPoint({-4.0f, -7.0f}),
+    /* The vertex data contain all glyphs */
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 12*4*sizeof(Implementation::TextLayerVertex));
 
-        baseOffset + data.expected.transformPoint({-3.0f, -3.0f}),
-        baseOffset + data.expected.transformPoint({-1.0f, -3.0f}),
-        baseOffset + data.expected.transformPoint({-3.0f, -7.0f}),
-        baseOffset + data.expected.transformPoint({-1.0f, -7.0f}),
+    /* Indices only for the visible ones */
+    CORRADE_COMPARE_AS(layer.stateData().indices, Containers::arrayView<UnsignedInt>({
+        /* Text 0, "abcdefgh", quads 2 to 5 */
+        2*4 + 0, 2*4 + 1, 2*4 + 2, 2*4 + 2, 2*4 + 1, 2*4 + 3,
+        3*4 + 0, 3*4 + 1, 3*4 + 2, 3*4 + 2, 3*4 + 1, 3*4 + 3,
+        4*4 + 0, 4*4 + 1, 4*4 + 2, 4*4 + 2, 4*4 + 1, 4*4 + 3,
+        5*4 + 0, 5*4 + 1, 5*4 + 2, 5*4 + 2, 5*4 + 1, 5*4 + 3,
+        /* Text 2, "ab", is fully clipped */
+        /* Text 1, "ab", quads 8 to 9 */
+        8*4 + 0, 8*4 + 1, 8*4 + 2, 8*4 + 2, 8*4 + 1, 8*4 + 3,
+        9*4 + 0, 9*4 + 1, 9*4 + 2, 9*4 + 2, 9*4 + 1, 9*4 + 3,
     }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 0}, {4*6, 0}, {4*6, 0}, {6*6, 0}
+    })), TestSuite::Compare::Container);
 
-    /* If there's a positive rotation, it should be clockwise, i.e. the next
-       quads being lower (i.e., Y larger with Y down) than the first, and vice
-       versa */
-    if(data.rotation > 0.0_radf) {
-        CORRADE_COMPARE_AS(positions[4].y(),
-                           positions[0].y(),
-                           TestSuite::Compare::Greater);
-        CORRADE_COMPARE_AS(positions[8].y(),
-                           positions[4].y(),
-                           TestSuite::Compare::Greater);
-    } else if(data.rotation < 0.0_radf) {
-        CORRADE_COMPARE_AS(positions[4].y(),
-                           positions[0].y(),
-                           TestSuite::Compare::Less);
-        CORRADE_COMPARE_AS(positions[8].y(),
-                           positions[4].y(),
-                           TestSuite::Compare::Less);
-    }
-
-    /* A transform scale should get reflected in the attribute for distance
-       field radius scaling, in addition to the font scale */
-    if(data.sharedLayerFlags >= TextLayerSharedFlag::DistanceField) {
-        CORRADE_COMPARE_AS(stridedArrayView(Containers::arrayCast<Implementation::TextLayerDistanceFieldVertex>(layer.stateData().vertices)).slice(&Implementation::TextLayerDistanceFieldVertex::invertedRunScale), Containers::arrayView({
-            1.0f/(0.5f*data.scaling),
-            1.0f/(0.5f*data.scaling),
-            1.0f/(0.5f*data.scaling),
-            1.0f/(0.5f*data.scaling),
-
-            1.0f/(0.5f*data.scaling),
-            1.0f/(0.5f*data.scaling),
-            1.0f/(0.5f*data.scaling),
-            1.0f/(0.5f*data.scaling),
+    /* Scrolling the clip rect regenerates the indices with just a node order
+       update, without touching the vertices */
+    clipRectOffsets[0] = {16.5f, 0.0f};
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, {}, {});
+    CORRADE_COMPARE_AS(layer.stateData().indices, Containers::arrayView<UnsignedInt>({
+        /* Text 0, "abcdefgh", quads 6 to 7 */
+        6*4 + 0, 6*4 + 1, 6*4 + 2, 6*4 + 2, 6*4 + 1, 6*4 + 3,
+        7*4 + 0, 7*4 + 1, 7*4 + 2, 7*4 + 2, 7*4 + 1, 7*4 + 3,
+        /* Text 1, "ab", quads 8 to 9 */
+        8*4 + 0, 8*4 + 1, 8*4 + 2, 8*4 + 2, 8*4 + 1, 8*4 + 3,
+        9*4 + 0, 9*4 + 1, 9*4 + 2, 9*4 + 2, 9*4 + 1, 9*4 + 3,
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 0}, {2*6, 0}, {2*6, 0}, {4*6, 0}
+    })), TestSuite::Compare::Container);
 
-            1.0f/(0.5f*data.scaling),
-            1.0f/(0.5f*data.scaling),
-            1.0f/(0.5f*data.scaling),
-            1.0f/(0.5f*data.scaling),
-        }), TestSuite::Compare::Container);
-    }
+    /* Moving the node with the third text into the clip rect makes it
+       visible */
+    nodeOffsets[2] = {16.0f, 20.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsNodeOrderUpdate, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, {}, {});
+    CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 0}, {2*6, 0}, {4*6, 0}, {6*6, 0}
+    })), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.stateData().indices.sliceSize(2*6, 2*6), Containers::arrayView<UnsignedInt>({
+        /* Text 2, "ab", quads 10 to 11 */
+        10*4 + 0, 10*4 + 1, 10*4 + 2, 10*4 + 2, 10*4 + 1, 10*4 + 3,
+        11*4 + 0, 11*4 + 1, 11*4 + 2, 11*4 + 2, 11*4 + 1, 11*4 + 3,
+    }), TestSuite::Compare::Container);
 }
 
 void TextLayerTest::updateNoStyleSet() {
@@ -11012,12 +13551,19 @@ void TextLayerTest::keyTextEvent() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{cache, TextLayer::Shared::Configuration{1}};
+    } shared{cache, TextLayer::Shared::Configuration{1}
+        .setEditingStyleCount(1)};
+    /* The style has a cursor style in order to have cursor-only changes
+       reflected in the layer state */
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
         {shared.addFont(font, 1.0f)},
         {Text::Alignment::MiddleCenter},
-        {}, {}, {}, {}, {}, {});
+        {}, {}, {}, {0}, {}, {});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}},
+        {-1},
+        {Vector4{}});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
@@ -11275,6 +13821,154 @@ void TextLayerTest::keyTextEvent() {
     }
 }
 
+void TextLayerTest::pointerEventCursorSelection() {
+    /* Each glyph advances by 1 unit in X, so the glyph boundaries are at
+       integer positions */
+    struct Shaper: Text::AbstractShaper {
+        using Text::AbstractShaper::AbstractShaper;
+
+        UnsignedInt doShape(Containers::StringView, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange>) override {
+            _begin = begin;
+            return end - begin;
+        }
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+            for(std::size_t i = 0; i != ids.size(); ++i)
+                ids[i] = 0;
+        }
+        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+            for(std::size_t i = 0; i != offsets.size(); ++i) {
+                offsets[i] = {};
+                advances[i] = {1.0f, 0.0f};
+            }
+        }
+        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+            for(std::size_t i = 0; i != clusters.size(); ++i)
+                clusters[i] = _begin + i;
+        }
+
+        UnsignedInt _begin;
+    };
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 3.0f, -1.0f, 4.0f, 1};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this);
+        }
+
+        bool _opened = false;
+    } font;
+    font.openFile({}, 10.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addGlyph(cache.addFont(1, &font), 0, {}, {{}, {1, 1}});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): TextLayer::Shared{glyphCache, configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{cache, TextLayer::Shared::Configuration{1}
+        .setEditingStyleCount(1)};
+    /* The padding is taken into account when mapping the pointer position
+       back to the glyphs */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 10.0f)},
+        {Text::Alignment::LineLeft},
+        {}, {}, {}, {0}, {}, {Vector4{2.0f, 0.0f, 0.0f, 0.0f}});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}},
+        {-1},
+        {Vector4{}});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    };
+
+    AbstractUserInterface ui{{100, 100}};
+
+    Layer& layer = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer(), shared));
+    NodeHandle node = ui.createNode({10, 0}, {20, 10}, NodeFlag::Focusable);
+
+    /* The glyphs are at X from 12 to 17 in the UI */
+    DataHandle text = layer.create(0, "hello", {}, TextDataFlag::Editable, node);
+    CORRADE_COMPARE(layer.cursor(text), Containers::pair(5u, 5u));
+
+    /* The first press only focuses the node, a drag from it doesn't select
+       anything */
+    {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerPressEvent({14.4f, 5.0f}, event));
+        CORRADE_COMPARE(ui.currentFocusedNode(), node);
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(5u, 5u));
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({13.2f, 5.0f}, event));
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(5u, 5u));
+    } {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerReleaseEvent({13.2f, 5.0f}, event));
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(5u, 5u));
+
+    /* A press on a focused node places the cursor at the closest glyph
+       boundary */
+    } {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerPressEvent({14.4f, 5.0f}, event));
+        CORRADE_COMPARE(ui.currentFocusedNode(), node);
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(2u, 2u));
+        CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Dragging extends the selection */
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({15.6f, 5.0f}, event));
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(4u, 2u));
+
+    /* Also outside of the node, as it's captured. Positions past the last
+       glyph place the cursor at the end. */
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({80.0f, 5.0f}, event));
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(5u, 2u));
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({5.0f, 5.0f}, event));
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(0u, 2u));
+
+    /* After a release, moves don't change the selection anymore */
+    } {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerReleaseEvent({5.0f, 5.0f}, event));
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(0u, 2u));
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({16.0f, 5.0f}, event));
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(0u, 2u));
+
+    /* A press with a secondary button doesn't do anything */
+    } {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseRight, true, 0};
+        CORRADE_VERIFY(!ui.pointerPressEvent({16.0f, 5.0f}, event));
+        CORRADE_COMPARE(layer.cursor(text), Containers::pair(0u, 2u));
+    }
+}
+
 void TextLayerTest::keyTextEventSynthesizedFromPointerPress() {
     auto&& data = KeyTextEventSynthesizedFromPointerPressData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -0,0 +1,112 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/String.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Trace.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct TraceTest: TestSuite::Tester {
+    explicit TraceTest();
+
+    void callbacks();
+    void callbacksReset();
+    void callbacksInvalid();
+};
+
+TraceTest::TraceTest() {
+    addTests({&TraceTest::callbacks,
+              &TraceTest::callbacksReset,
+              &TraceTest::callbacksInvalid});
+}
+
+using namespace Containers::Literals;
+
+void traceBegin(Containers::StringView name, void* state) {
+    /* The name should be always a global null-terminated literal */
+    CORRADE_COMPARE(name.flags(), Containers::StringViewFlag::Global|Containers::StringViewFlag::NullTerminated);
+    Containers::String& out = *static_cast<Containers::String*>(state);
+    out = out + "begin "_s + name + "\n"_s;
+}
+
+void traceEnd(Containers::StringView name, void* state) {
+    Containers::String& out = *static_cast<Containers::String*>(state);
+    out = out + "end "_s + name + "\n"_s;
+}
+
+void TraceTest::callbacks() {
+    Containers::String out;
+    setTraceCallbacks(traceBegin, traceEnd, &out);
+
+    AbstractUserInterface ui{{100, 100}};
+    ui.update();
+
+    setTraceCallbacks(nullptr, nullptr, nullptr);
+
+    if(isTracingEnabled()) {
+        /* Other functions such as clean() may be called by update() as well,
+           so check just the outermost zone */
+        CORRADE_COMPARE_AS(out,
+            "begin Ui::AbstractUserInterface::update()\n",
+            TestSuite::Compare::StringHasPrefix);
+        CORRADE_COMPARE_AS(out,
+            "end Ui::AbstractUserInterface::update()\n",
+            TestSuite::Compare::StringHasSuffix);
+    } else CORRADE_COMPARE(out, "");
+}
+
+void TraceTest::callbacksReset() {
+    Containers::String out;
+    setTraceCallbacks(traceBegin, traceEnd, &out);
+    setTraceCallbacks(nullptr, nullptr, nullptr);
+
+    AbstractUserInterface ui{{100, 100}};
+    ui.update();
+
+    /* Nothing should be called after resetting the callbacks */
+    CORRADE_COMPARE(out, "");
+}
+
+void TraceTest::callbacksInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Containers::String out;
+    Error redirectError{&out};
+    setTraceCallbacks(traceBegin, nullptr, nullptr);
+    setTraceCallbacks(nullptr, traceEnd, nullptr);
+    CORRADE_COMPARE(out,
+        "Ui::setTraceCallbacks(): expected either both or none of the callbacks to be set\n"
+        "Ui::setTraceCallbacks(): expected either both or none of the callbacks to be set\n");
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::TraceTest)
@@ -26,6 +26,7 @@
 
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/PluginManager/Manager.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/GL/OpenGLTester.h>
@@ -69,6 +70,9 @@ struct UserInterfaceGLTest: GL::OpenGLTester {
     void setStyleEventLayerAlreadyPresent();
     void setStyleSnapLayouterAlreadyPresent();
 
+    void setStyleShared();
+    void setStyleSharedInvalid();
+
     private:
         PluginManager::Manager<Trade::AbstractImporter> _importerManager;
         PluginManager::Manager<Text::AbstractFont> _fontManager;
@@ -246,7 +250,10 @@ UserInterfaceGLTest::UserInterfaceGLTest() {
               &UserInterfaceGLTest::setStyleTextLayerAlreadyPresent,
               &UserInterfaceGLTest::setStyleTextLayerImagesTextLayerNotPresentNotApplied,
               &UserInterfaceGLTest::setStyleEventLayerAlreadyPresent,
-              &UserInterfaceGLTest::setStyleSnapLayouterAlreadyPresent});
+              &UserInterfaceGLTest::setStyleSnapLayouterAlreadyPresent,
+
+              &UserInterfaceGLTest::setStyleShared,
+              &UserInterfaceGLTest::setStyleSharedInvalid});
 }
 
 void UserInterfaceGLTest::construct() {
@@ -853,6 +860,109 @@ void UserInterfaceGLTest::setStyleSnapLayouterAlreadyPresent() {
     CORRADE_COMPARE(out, "Ui::UserInterfaceGL::trySetStyle(): snap layouter already present\n");
 }
 
+void UserInterfaceGLTest::setStyleShared() {
+    Int applyCalled = 0;
+    StyleFeatures actualFeatures;
+    struct Style: AbstractStyle {
+        Style(Int& applyCalled, StyleFeatures& actualFeatures): _applyCalled(applyCalled), _actualFeatures(actualFeatures) {}
+
+        StyleFeatures doFeatures() const override {
+            return StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::TextLayerImages|StyleFeature::EventLayer|StyleFeature::SnapLayouter;
+        }
+        UnsignedInt doBaseLayerStyleCount() const override { return 3; }
+        UnsignedInt doTextLayerStyleCount() const override { return 2; }
+        Vector3i doTextLayerGlyphCacheSize(StyleFeatures) const override {
+            return {16, 16, 1};
+        }
+        bool doApply(UserInterface&, StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*) const override {
+            _actualFeatures = features;
+            ++_applyCalled;
+            return true;
+        }
+
+        Int& _applyCalled;
+        StyleFeatures& _actualFeatures;
+    } style{applyCalled, actualFeatures};
+
+    UserInterfaceGL a{NoCreate};
+    a.setSize({200, 300});
+    CORRADE_VERIFY(a.trySetStyle(style, &_importerManager, &_fontManager));
+    CORRADE_COMPARE(applyCalled, 1);
+    CORRADE_COMPARE(actualFeatures, style.features());
+
+    UserInterfaceGL b{NoCreate};
+    b.setSize({400, 200});
+    CORRADE_VERIFY(!b.hasRenderer());
+    CORRADE_VERIFY(b.trySetStyle(style, style.features(), a));
+    CORRADE_VERIFY(b.hasRenderer());
+    CORRADE_COMPARE(b.layerUsedCount(), 3);
+    CORRADE_COMPARE(b.layouterUsedCount(), 1);
+    CORRADE_VERIFY(b.hasEventLayer());
+    CORRADE_VERIFY(b.hasSnapLayouter());
+
+    /* The style is applied only to what isn't shared */
+    CORRADE_COMPARE(applyCalled, 2);
+    CORRADE_COMPARE(actualFeatures, StyleFeature::EventLayer|StyleFeature::SnapLayouter);
+
+    /* The layers are different but the shared state is the same */
+    CORRADE_VERIFY(&b.baseLayer() != &a.baseLayer());
+    CORRADE_VERIFY(&b.textLayer() != &a.textLayer());
+    CORRADE_COMPARE(&b.baseLayer().shared(), &a.baseLayer().shared());
+    CORRADE_COMPARE(&b.textLayer().shared(), &a.textLayer().shared());
+    CORRADE_COMPARE(&b.textLayer().shared().glyphCache(), &a.textLayer().shared().glyphCache());
+
+    /* Sharing just the layers doesn't call apply() at all */
+    UserInterfaceGL c{NoCreate};
+    c.setSize({200, 300});
+    CORRADE_VERIFY(c.trySetStyle(style, StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::TextLayerImages, a));
+    CORRADE_COMPARE(applyCalled, 2);
+    CORRADE_COMPARE(c.layerUsedCount(), 2);
+    CORRADE_COMPARE(&c.textLayer().shared(), &a.textLayer().shared());
+}
+
+void UserInterfaceGLTest::setStyleSharedInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct Style: AbstractStyle {
+        StyleFeatures doFeatures() const override {
+            return StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::TextLayerImages|StyleFeature::EventLayer;
+        }
+        UnsignedInt doBaseLayerStyleCount() const override { return 3; }
+        UnsignedInt doTextLayerStyleCount() const override { return 2; }
+        Vector3i doTextLayerGlyphCacheSize(StyleFeatures) const override {
+            return {16, 16, 1};
+        }
+        bool doApply(UserInterface&, StyleFeatures, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*) const override {
+            return true;
+        }
+    } style;
+
+    UserInterfaceGL other{NoCreate};
+    other.setSize({200, 300});
+    other.setStyle(style, StyleFeature::EventLayer);
+
+    UserInterfaceGL ui{NoCreate};
+    ui.setSize({200, 300});
+
+    /* Capture correct function name */
+    CORRADE_VERIFY(true);
+
+    Containers::String out;
+    Error redirectError{&out};
+    ui.trySetStyle(style, {}, other);
+    ui.trySetStyle(style, StyleFeatures{0x80}, other);
+    ui.trySetStyle(style, StyleFeature::EventLayer, ui);
+    ui.trySetStyle(style, StyleFeature::BaseLayer, other);
+    ui.trySetStyle(style, StyleFeature::TextLayerImages, other);
+    CORRADE_COMPARE_AS(out,
+        "Ui::UserInterfaceGL::trySetStyle(): no features specified\n"
+        "Ui::UserInterfaceGL::trySetStyle(): Ui::StyleFeature(0x80) not a subset of supported Ui::StyleFeature::BaseLayer|Ui::StyleFeature::TextLayer|Ui::StyleFeature::TextLayerImages|Ui::StyleFeature::EventLayer\n"
+        "Ui::UserInterfaceGL::trySetStyle(): can't share the style with itself\n"
+        "Ui::UserInterfaceGL::trySetStyle(): base layer not present in the other user interface\n"
+        "Ui::UserInterfaceGL::trySetStyle(): text layer not present in the other user interface\n",
+        TestSuite::Compare::String);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::UserInterfaceGLTest)
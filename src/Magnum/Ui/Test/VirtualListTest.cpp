@@ -0,0 +1,281 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Anchor.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/NodeFlags.h"
+#include "Magnum/Ui/VirtualList.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct VirtualListTest: TestSuite::Tester {
+    explicit VirtualListTest();
+
+    void construct();
+    void constructFewRows();
+    void constructInvalid();
+    void constructNoCreate();
+
+    void scroll();
+    void scrollClamp();
+    void setRowCount();
+    void rebind();
+};
+
+VirtualListTest::VirtualListTest() {
+    addTests({&VirtualListTest::construct,
+              &VirtualListTest::constructFewRows,
+              &VirtualListTest::constructInvalid,
+              &VirtualListTest::constructNoCreate,
+
+              &VirtualListTest::scroll,
+              &VirtualListTest::scrollClamp,
+              &VirtualListTest::setRowCount,
+              &VirtualListTest::rebind});
+}
+
+void VirtualListTest::construct() {
+    AbstractUserInterface ui{{200, 200}};
+    NodeHandle parent = ui.createNode({}, {200, 200});
+
+    Containers::Array<Containers::Pair<NodeHandle, UnsignedInt>> called;
+    /* 100 units high with 30 units per row, so 4 nodes cover the area and
+       one more is needed for when both first and last row are partially
+       visible */
+    VirtualList list{AbstractAnchor{ui, parent, {10.0f, 20.0f}, {50.0f, 100.0f}}, 30.0f, 1000, [&called](NodeHandle node, UnsignedInt row) {
+        arrayAppend(called, InPlaceInit, node, row);
+    }};
+    CORRADE_COMPARE(list.rowHeight(), 30.0f);
+    CORRADE_COMPARE(list.rowCount(), 1000);
+    CORRADE_COMPARE(list.scrollOffset(), 0.0f);
+    CORRADE_COMPARE(list.poolSize(), 5);
+    CORRADE_COMPARE(ui.nodeUsedCount(), 7);
+    CORRADE_COMPARE(ui.nodeFlags(list), NodeFlag::Clip);
+
+    /* First five rows are assigned to the five nodes */
+    CORRADE_COMPARE_AS(called, (Containers::arrayView<Containers::Pair<NodeHandle, UnsignedInt>>({
+        {list.rowNode(0), 0},
+        {list.rowNode(1), 1},
+        {list.rowNode(2), 2},
+        {list.rowNode(3), 3},
+        {list.rowNode(4), 4},
+    })), TestSuite::Compare::Container);
+    CORRADE_COMPARE(list.rowNode(5), NodeHandle::Null);
+    CORRADE_COMPARE(list.rowNode(1000), NodeHandle::Null);
+
+    for(UnsignedInt i = 0; i != 5; ++i) {
+        CORRADE_ITERATION(i);
+        NodeHandle node = list.rowNode(i);
+        CORRADE_VERIFY(ui.isHandleValid(node));
+        CORRADE_COMPARE(ui.nodeParent(node), list.node());
+        CORRADE_COMPARE(ui.nodeOffset(node), (Vector2{0.0f, i*30.0f}));
+        CORRADE_COMPARE(ui.nodeSize(node), (Vector2{50.0f, 30.0f}));
+        CORRADE_COMPARE(ui.nodeFlags(node), NodeFlags{});
+    }
+}
+
+void VirtualListTest::constructFewRows() {
+    AbstractUserInterface ui{{200, 200}};
+
+    Containers::Array<Containers::Pair<NodeHandle, UnsignedInt>> called;
+    VirtualList list{AbstractAnchor{ui, NodeHandle::Null, {}, {50.0f, 100.0f}}, 30.0f, 2, [&called](NodeHandle node, UnsignedInt row) {
+        arrayAppend(called, InPlaceInit, node, row);
+    }};
+    CORRADE_COMPARE(list.poolSize(), 5);
+    CORRADE_COMPARE(ui.nodeUsedCount(), 6);
+
+    /* Only the first two nodes get bound, the rest stays hidden */
+    CORRADE_COMPARE_AS(called, (Containers::arrayView<Containers::Pair<NodeHandle, UnsignedInt>>({
+        {list.rowNode(0), 0},
+        {list.rowNode(1), 1},
+    })), TestSuite::Compare::Container);
+    CORRADE_COMPARE(list.rowNode(2), NodeHandle::Null);
+    CORRADE_COMPARE(ui.nodeFlags(list.rowNode(0)), NodeFlags{});
+    CORRADE_COMPARE(ui.nodeFlags(list.rowNode(1)), NodeFlags{});
+}
+
+void VirtualListTest::constructInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    AbstractUserInterface ui{{200, 200}};
+
+    Containers::String out;
+    Error redirectError{&out};
+    VirtualList{AbstractAnchor{ui, NodeHandle::Null, {}, {50.0f, 100.0f}}, 0.0f, 10, nullptr};
+    CORRADE_COMPARE(out, "Ui::VirtualList: expected a positive row height, got 0\n");
+}
+
+void VirtualListTest::constructNoCreate() {
+    AbstractUserInterface ui{{200, 200}};
+
+    VirtualList list{NoCreate, ui};
+    CORRADE_COMPARE(&list.ui(), &ui);
+    CORRADE_COMPARE(list.node(), NodeHandle::Null);
+    CORRADE_COMPARE(list.poolSize(), 0);
+    CORRADE_COMPARE(list.rowCount(), 0);
+    CORRADE_COMPARE(list.rowNode(0), NodeHandle::Null);
+}
+
+void VirtualListTest::scroll() {
+    AbstractUserInterface ui{{200, 200}};
+
+    Containers::Array<Containers::Pair<NodeHandle, UnsignedInt>> called;
+    VirtualList list{AbstractAnchor{ui, NodeHandle::Null, {}, {50.0f, 100.0f}}, 30.0f, 1000, [&called](NodeHandle node, UnsignedInt row) {
+        arrayAppend(called, InPlaceInit, node, row);
+    }};
+    NodeHandle nodes[5];
+    for(UnsignedInt i = 0; i != 5; ++i)
+        nodes[i] = list.rowNode(i);
+    arrayClear(called);
+
+    /* Scrolling by less than a row doesn't rebind anything, just moves the
+       nodes */
+    list.setScrollOffset(20.0f);
+    CORRADE_COMPARE(list.scrollOffset(), 20.0f);
+    CORRADE_COMPARE(called.size(), 0);
+    CORRADE_COMPARE(ui.nodeOffset(nodes[0]), (Vector2{0.0f, -20.0f}));
+    CORRADE_COMPARE(ui.nodeOffset(nodes[4]), (Vector2{0.0f, 100.0f}));
+
+    /* Scrolling past the first row reuses its node for the row after the
+       last */
+    list.setScrollOffset(45.0f);
+    CORRADE_COMPARE_AS(called, (Containers::arrayView<Containers::Pair<NodeHandle, UnsignedInt>>({
+        {nodes[0], 5},
+    })), TestSuite::Compare::Container);
+    CORRADE_COMPARE(list.rowNode(0), NodeHandle::Null);
+    CORRADE_COMPARE(list.rowNode(1), nodes[1]);
+    CORRADE_COMPARE(list.rowNode(5), nodes[0]);
+    CORRADE_COMPARE(ui.nodeOffset(nodes[1]), (Vector2{0.0f, -15.0f}));
+    CORRADE_COMPARE(ui.nodeOffset(nodes[4]), (Vector2{0.0f, 75.0f}));
+    CORRADE_COMPARE(ui.nodeOffset(nodes[0]), (Vector2{0.0f, 105.0f}));
+
+    /* Jumping far away rebinds all nodes, the count stays the same */
+    arrayClear(called);
+    list.setScrollOffset(30.0f*500);
+    CORRADE_COMPARE_AS(called, (Containers::arrayView<Containers::Pair<NodeHandle, UnsignedInt>>({
+        {nodes[0], 500},
+        {nodes[1], 501},
+        {nodes[2], 502},
+        {nodes[3], 503},
+        {nodes[4], 504},
+    })), TestSuite::Compare::Container);
+    CORRADE_COMPARE(ui.nodeOffset(nodes[0]), (Vector2{0.0f, 0.0f}));
+    CORRADE_COMPARE(ui.nodeOffset(nodes[4]), (Vector2{0.0f, 120.0f}));
+    CORRADE_COMPARE(ui.nodeUsedCount(), 6);
+}
+
+void VirtualListTest::scrollClamp() {
+    AbstractUserInterface ui{{200, 200}};
+
+    VirtualList list{AbstractAnchor{ui, NodeHandle::Null, {}, {50.0f, 100.0f}}, 30.0f, 100, nullptr};
+
+    /* The last row is at the bottom edge at most. The node that'd be after
+       it gets hidden. */
+    list.setScrollOffset(10000.0f);
+    CORRADE_COMPARE(list.scrollOffset(), 2900.0f);
+    CORRADE_VERIFY(list.rowNode(96) != NodeHandle::Null);
+    CORRADE_VERIFY(list.rowNode(99) != NodeHandle::Null);
+    CORRADE_COMPARE(ui.nodeOffset(list.rowNode(96)), (Vector2{0.0f, -20.0f}));
+    CORRADE_COMPARE(ui.nodeOffset(list.rowNode(99)), (Vector2{0.0f, 70.0f}));
+    CORRADE_COMPARE(list.rowNode(95), NodeHandle::Null);
+    CORRADE_COMPARE(ui.nodeFlags(list.rowNode(96)), NodeFlags{});
+
+    list.setScrollOffset(-5.0f);
+    CORRADE_COMPARE(list.scrollOffset(), 0.0f);
+    CORRADE_VERIFY(list.rowNode(0) != NodeHandle::Null);
+}
+
+void VirtualListTest::setRowCount() {
+    AbstractUserInterface ui{{200, 200}};
+
+    Containers::Array<Containers::Pair<NodeHandle, UnsignedInt>> called;
+    VirtualList list{AbstractAnchor{ui, NodeHandle::Null, {}, {50.0f, 100.0f}}, 30.0f, 100, [&called](NodeHandle node, UnsignedInt row) {
+        arrayAppend(called, InPlaceInit, node, row);
+    }};
+    NodeHandle nodes[5];
+    for(UnsignedInt i = 0; i != 5; ++i)
+        nodes[i] = list.rowNode(i);
+    list.setScrollOffset(500.0f);
+    arrayClear(called);
+
+    /* Shrinking clamps the scroll offset and hides nodes that are past the
+       end, the remaining ones get bound again */
+    list.setRowCount(2);
+    CORRADE_COMPARE(list.rowCount(), 2);
+    CORRADE_COMPARE(list.scrollOffset(), 0.0f);
+    CORRADE_COMPARE_AS(called, (Containers::arrayView<Containers::Pair<NodeHandle, UnsignedInt>>({
+        {nodes[0], 0},
+        {nodes[1], 1},
+    })), TestSuite::Compare::Container);
+    CORRADE_COMPARE(ui.nodeFlags(nodes[0]), NodeFlags{});
+    CORRADE_COMPARE(ui.nodeFlags(nodes[1]), NodeFlags{});
+    CORRADE_COMPARE(ui.nodeFlags(nodes[2]), NodeFlag::Hidden);
+    CORRADE_COMPARE(ui.nodeFlags(nodes[3]), NodeFlag::Hidden);
+    CORRADE_COMPARE(ui.nodeFlags(nodes[4]), NodeFlag::Hidden);
+
+    /* Growing shows them again */
+    arrayClear(called);
+    list.setRowCount(3);
+    CORRADE_COMPARE_AS(called, (Containers::arrayView<Containers::Pair<NodeHandle, UnsignedInt>>({
+        {nodes[0], 0},
+        {nodes[1], 1},
+        {nodes[2], 2},
+    })), TestSuite::Compare::Container);
+    CORRADE_COMPARE(ui.nodeFlags(nodes[2]), NodeFlags{});
+    CORRADE_COMPARE(ui.nodeFlags(nodes[3]), NodeFlag::Hidden);
+}
+
+void VirtualListTest::rebind() {
+    AbstractUserInterface ui{{200, 200}};
+
+    Containers::Array<Containers::Pair<NodeHandle, UnsignedInt>> called;
+    VirtualList list{AbstractAnchor{ui, NodeHandle::Null, {}, {50.0f, 100.0f}}, 30.0f, 1000, [&called](NodeHandle node, UnsignedInt row) {
+        arrayAppend(called, InPlaceInit, node, row);
+    }};
+    list.setScrollOffset(45.0f);
+    arrayClear(called);
+
+    list.rebind();
+    CORRADE_COMPARE_AS(called, (Containers::arrayView<Containers::Pair<NodeHandle, UnsignedInt>>({
+        {list.rowNode(1), 1},
+        {list.rowNode(2), 2},
+        {list.rowNode(3), 3},
+        {list.rowNode(4), 4},
+        {list.rowNode(5), 5},
+    })), TestSuite::Compare::Container);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::VirtualListTest)
@@ -0,0 +1,160 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <type_traits>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/NodeFlags.h"
+#include "Magnum/Ui/WidgetPool.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct WidgetPoolTest: TestSuite::Tester {
+    explicit WidgetPoolTest();
+
+    void construct();
+    void constructCopy();
+    void constructMove();
+
+    void recycleReuse();
+    void recycleNullNode();
+    void clear();
+};
+
+WidgetPoolTest::WidgetPoolTest() {
+    addTests({&WidgetPoolTest::construct,
+              &WidgetPoolTest::constructCopy,
+              &WidgetPoolTest::constructMove,
+
+              &WidgetPoolTest::recycleReuse,
+              &WidgetPoolTest::recycleNullNode,
+              &WidgetPoolTest::clear});
+}
+
+void WidgetPoolTest::construct() {
+    WidgetPool<AbstractWidget> pool;
+    CORRADE_COMPARE(pool.size(), 0);
+    CORRADE_VERIFY(pool.isEmpty());
+    CORRADE_VERIFY(!pool.reuse());
+}
+
+void WidgetPoolTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<WidgetPool<AbstractWidget>>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<WidgetPool<AbstractWidget>>{});
+}
+
+void WidgetPoolTest::constructMove() {
+    AbstractUserInterface ui{{100, 100}};
+
+    WidgetPool<AbstractWidget> a;
+    a.recycle(AbstractWidget{ui, ui.createNode({}, {})});
+
+    WidgetPool<AbstractWidget> b{Utility::move(a)};
+    CORRADE_COMPARE(b.size(), 1);
+
+    WidgetPool<AbstractWidget> c;
+    c = Utility::move(b);
+    CORRADE_COMPARE(c.size(), 1);
+
+    CORRADE_VERIFY(std::is_nothrow_move_constructible<WidgetPool<AbstractWidget>>::value);
+    CORRADE_VERIFY(std::is_nothrow_move_assignable<WidgetPool<AbstractWidget>>::value);
+}
+
+void WidgetPoolTest::recycleReuse() {
+    AbstractUserInterface ui{{100, 100}};
+    NodeHandle parent = ui.createNode({}, {100, 100});
+    NodeHandle node1 = ui.createNode(parent, {}, {10, 10});
+    NodeHandle node2 = ui.createNode(parent, {}, {10, 10});
+
+    WidgetPool<AbstractWidget> pool;
+    pool.recycle(AbstractWidget{ui, node1})
+        .recycle(AbstractWidget{ui, node2});
+    CORRADE_COMPARE(pool.size(), 2);
+    CORRADE_VERIFY(!pool.isEmpty());
+
+    /* The nodes stay valid and keep their parent, they're just hidden */
+    CORRADE_VERIFY(ui.isHandleValid(node1));
+    CORRADE_VERIFY(ui.isHandleValid(node2));
+    CORRADE_COMPARE(ui.nodeParent(node1), parent);
+    CORRADE_COMPARE(ui.nodeFlags(node1), NodeFlag::Hidden);
+    CORRADE_COMPARE(ui.nodeFlags(node2), NodeFlag::Hidden);
+
+    /* The most recently recycled widget is reused first, with the same node
+       handle and not hidden anymore */
+    {
+        Containers::Optional<AbstractWidget> widget = pool.reuse();
+        CORRADE_VERIFY(widget);
+        CORRADE_COMPARE(widget->node(), node2);
+        CORRADE_VERIFY(!widget->isHidden());
+        CORRADE_COMPARE(pool.size(), 1);
+    }
+
+    /* The reused widget was destroyed at the end of the scope, removing the
+       node */
+    CORRADE_VERIFY(!ui.isHandleValid(node2));
+
+    Containers::Optional<AbstractWidget> widget = pool.reuse();
+    CORRADE_VERIFY(widget);
+    CORRADE_COMPARE(widget->node(), node1);
+    CORRADE_VERIFY(pool.isEmpty());
+    CORRADE_VERIFY(!pool.reuse());
+}
+
+void WidgetPoolTest::recycleNullNode() {
+    AbstractUserInterface ui{{100, 100}};
+
+    AbstractWidget widget{ui, ui.createNode({}, {})};
+    widget.release();
+
+    /* Widgets with a null node are ignored */
+    WidgetPool<AbstractWidget> pool;
+    pool.recycle(Utility::move(widget))
+        .recycle(AbstractWidget{NoCreate, ui});
+    CORRADE_VERIFY(pool.isEmpty());
+}
+
+void WidgetPoolTest::clear() {
+    AbstractUserInterface ui{{100, 100}};
+    NodeHandle node = ui.createNode({}, {});
+
+    WidgetPool<AbstractWidget> pool;
+    pool.recycle(AbstractWidget{ui, node});
+    CORRADE_VERIFY(ui.isHandleValid(node));
+
+    /* Clearing destroys the widgets, removing their nodes */
+    pool.clear();
+    CORRADE_VERIFY(pool.isEmpty());
+    CORRADE_VERIFY(!ui.isHandleValid(node));
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::WidgetPoolTest)
@@ -51,10 +51,22 @@ flat in mediump vec2 halfQuadSize;
 NOPERSPECTIVE in mediump vec2 interpolatedCenterDistance;
 flat in lowp float interpolatedOpacity;
 flat in mediump uint interpolatedStyle;
+#ifdef SHADER_CLIPPING
+flat in highp vec4 interpolatedClipRect;
+#endif
 
 out lowp vec4 fragmentColor;
 
 void main() {
+    /* The clip rect is in whole framebuffer pixels and gl_FragCoord is at
+       pixel centers, so this discards exactly the pixels a scissor rectangle
+       of the same size would */
+    #ifdef SHADER_CLIPPING
+    if(any(lessThan(gl_FragCoord.xy, interpolatedClipRect.xy)) ||
+       any(greaterThan(gl_FragCoord.xy, interpolatedClipRect.zw)))
+        discard;
+    #endif
+
     mediump float radius = styles[interpolatedStyle].style_cornerRadius;
 
     /* Is (0, 0) in centers of corner radii, positive in corners, negative at
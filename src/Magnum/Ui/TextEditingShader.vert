@@ -50,11 +50,18 @@ layout(location = 0) in highp vec2 position;
 layout(location = 1) in mediump vec2 centerDistance;
 layout(location = 2) in lowp float opacity;
 layout(location = 3) in mediump uint style;
+#ifdef SHADER_CLIPPING
+/* Framebuffer-space clip rect min and max in pixels */
+layout(location = 4) in highp vec4 clipRect;
+#endif
 
 flat out mediump vec2 halfQuadSize;
 NOPERSPECTIVE out mediump vec2 interpolatedCenterDistance;
 flat out lowp float interpolatedOpacity;
 flat out mediump uint interpolatedStyle;
+#ifdef SHADER_CLIPPING
+flat out highp vec4 interpolatedClipRect;
+#endif
 
 void main() {
     /* Expand the quad by the smoothness radius to avoid the edges looking cut
@@ -66,6 +73,9 @@ void main() {
     interpolatedCenterDistance = centerDistance + smoothnessExpansion;
     interpolatedOpacity = opacity;
     interpolatedStyle = style;
+    #ifdef SHADER_CLIPPING
+    interpolatedClipRect = clipRect;
+    #endif
 
     /* The projection scales from UI size to the 2x2 unit square and Y-flips,
        the (-1, 1) then translates the origin from top left to center */
@@ -26,19 +26,24 @@
 
 #include "TextLayer.h"
 
+#include <cstring> /* std::memcmp() */
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/EnumSet.hpp>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringIterable.h>
 #include <Corrade/Containers/Triple.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Move.h>
 #include <Corrade/Utility/Unicode.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/Math/Time.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
@@ -50,7 +55,10 @@
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/TextProperties.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
+#include "Magnum/Ui/Implementation/runCompaction.h"
 #include "Magnum/Ui/Implementation/textLayerState.h"
+#include "Magnum/Ui/Implementation/trace.h"
 
 namespace Magnum { namespace Ui {
 
@@ -67,6 +75,7 @@ Debug& operator<<(Debug& debug, const TextLayerFlag value) {
         /* LCOV_EXCL_START */
         #define _c(value) case TextLayerFlag::value: return debug << "::" #value;
         _c(Transformable)
+        _c(GlyphCulling)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -76,7 +85,8 @@ Debug& operator<<(Debug& debug, const TextLayerFlag value) {
 
 Debug& operator<<(Debug& debug, const TextLayerFlags value) {
     return Containers::enumSetDebugOutput(debug, value, "Ui::TextLayerFlags{}", {
-        TextLayerFlag::Transformable
+        TextLayerFlag::Transformable,
+        TextLayerFlag::GlyphCulling
     });
 }
 
@@ -87,6 +97,8 @@ Debug& operator<<(Debug& debug, const TextDataFlag value) {
         /* LCOV_EXCL_START */
         #define _c(value) case TextDataFlag::value: return debug << "::" #value;
         _c(Editable)
+        _c(DeferShaping)
+        _c(Wrap)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -96,7 +108,9 @@ Debug& operator<<(Debug& debug, const TextDataFlag value) {
 
 Debug& operator<<(Debug& debug, const TextDataFlags value) {
     return Containers::enumSetDebugOutput(debug, value, "Ui::TextDataFlags{}", {
-        TextDataFlag::Editable
+        TextDataFlag::Editable,
+        TextDataFlag::DeferShaping,
+        TextDataFlag::Wrap
     });
 }
 
@@ -132,6 +146,13 @@ Debug& operator<<(Debug& debug, const TextLayerSharedFlag value) {
         /* LCOV_EXCL_START */
         #define _c(value) case TextLayerSharedFlag::value: return debug << "::" #value;
         _c(DistanceField)
+        _c(ShaderClipping)
+        _c(InstancedGlyphs)
+        _c(GlyphCacheFillOnDemand)
+        _c(GlyphCacheFillDeferred)
+        _c(ShaderTransformation)
+        _c(ShaderNodeOpacity)
+        _c(GlyphCacheGrowOnDemand)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -141,17 +162,26 @@ Debug& operator<<(Debug& debug, const TextLayerSharedFlag value) {
 
 Debug& operator<<(Debug& debug, const TextLayerSharedFlags value) {
     return Containers::enumSetDebugOutput(debug, value, "Ui::TextLayerSharedFlags{}", {
-        TextLayerSharedFlag::DistanceField
+        TextLayerSharedFlag::DistanceField,
+        TextLayerSharedFlag::ShaderClipping,
+        TextLayerSharedFlag::InstancedGlyphs,
+        TextLayerSharedFlag::GlyphCacheFillOnDemand,
+        TextLayerSharedFlag::GlyphCacheFillDeferred,
+        TextLayerSharedFlag::ShaderTransformation,
+        TextLayerSharedFlag::ShaderNodeOpacity,
+        TextLayerSharedFlag::GlyphCacheGrowOnDemand
     });
 }
 
-TextLayer::Shared::State::State(Shared& self, Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): AbstractVisualLayer::Shared::State{self, configuration.styleCount(), configuration.dynamicStyleCount()}, hasEditingStyles{configuration.hasEditingStyles()}, flags{configuration.flags()}, styleUniformCount{configuration.styleUniformCount()}, editingStyleUniformCount{configuration.editingStyleUniformCount()}, glyphCache(glyphCache) {
+TextLayer::Shared::State::State(Shared& self, Text::AbstractGlyphCache& glyphCache, const Configuration& configuration): AbstractVisualLayer::Shared::State{self, configuration.styleCount(), configuration.dynamicStyleCount()}, hasEditingStyles{configuration.hasEditingStyles()}, flags{configuration.flags()}, styleUniformCount{configuration.styleUniformCount()}, editingStyleUniformCount{configuration.editingStyleUniformCount()}, shaperCount{configuration.shaperCount()}, glyphCache(glyphCache) {
     styleStorage = Containers::ArrayTuple{
         {NoInit, configuration.styleCount(), styles},
         {NoInit, configuration.dynamicStyleCount() ? configuration.styleUniformCount() : 0, styleUniforms},
         {NoInit, configuration.editingStyleCount(), editingStyles},
         {NoInit, configuration.dynamicStyleCount() ? configuration.editingStyleUniformCount() : 0, editingStyleUniforms},
     };
+    if(configuration.shapeCacheSize())
+        shapeCache = Containers::Array<Implementation::TextLayerShapeCacheEntry>{ValueInit, configuration.shapeCacheSize()};
 }
 
 TextLayer::Shared::Shared(Containers::Pointer<State>&& state): AbstractVisualLayer::Shared{Utility::move(state)} {
@@ -186,6 +216,34 @@ TextLayerSharedFlags TextLayer::Shared::flags() const {
     return static_cast<const State&>(*_state).flags;
 }
 
+UnsignedInt TextLayer::Shared::shapeCacheSize() const {
+    return static_cast<const State&>(*_state).shapeCache.size();
+}
+
+UnsignedInt TextLayer::Shared::shapeCacheUsedCount() const {
+    return static_cast<const State&>(*_state).shapeCacheUsedCount;
+}
+
+TextLayer::Shared& TextLayer::Shared::clearShapeCache() {
+    State& state = static_cast<State&>(*_state);
+    /* The entries aren't freed, in order to reuse their allocations */
+    state.shapeCacheUsedCount = 0;
+    return *this;
+}
+
+UnsignedInt TextLayer::Shared::shaperCount() const {
+    return static_cast<const State&>(*_state).shaperCount;
+}
+
+bool TextLayer::Shared::hasShapeExecutor() const {
+    return !!static_cast<const State&>(*_state).shapeExecutor;
+}
+
+TextLayer::Shared& TextLayer::Shared::setShapeExecutor(Containers::Function<void(std::size_t, void(*)(void*, std::size_t), void*)>&& executor) {
+    static_cast<State&>(*_state).shapeExecutor = Utility::move(executor);
+    return *this;
+}
+
 Text::AbstractGlyphCache& TextLayer::Shared::glyphCache() {
     return const_cast<Text::AbstractGlyphCache&>(const_cast<const TextLayer::Shared&>(*this).glyphCache());
 }
@@ -194,6 +252,16 @@ const Text::AbstractGlyphCache& TextLayer::Shared::glyphCache() const {
     return static_cast<const State&>(*_state).glyphCache;
 }
 
+bool TextLayer::Shared::growGlyphCache(const UnsignedInt layerCount) {
+    CORRADE_ASSERT(layerCount,
+        "Ui::TextLayer::Shared::growGlyphCache(): expected a non-zero layer count", {});
+    return doGrowGlyphCache(layerCount);
+}
+
+bool TextLayer::Shared::doGrowGlyphCache(UnsignedInt) {
+    return false;
+}
+
 std::size_t TextLayer::Shared::fontCount() const {
     return static_cast<const State&>(*_state).fonts.size();
 }
@@ -484,6 +552,51 @@ TextLayer::Shared& TextLayer::Shared::setEditingStyle(const TextLayerCommonEditi
     return setEditingStyle(commonUniform, Containers::arrayView(uniforms), Containers::stridedArrayView(textUniforms), Containers::stridedArrayView(paddings));
 }
 
+TextLayer::Shared& TextLayer::Shared::setStyleUniforms(const TextLayerCommonStyleUniform& commonUniform, const Containers::ArrayView<const TextLayerStyleUniform> uniforms) {
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(state.setStyleCalled,
+        "Ui::TextLayer::Shared::setStyleUniforms(): no style data was set", *this);
+    CORRADE_ASSERT(uniforms.size() == state.styleUniformCount,
+        "Ui::TextLayer::Shared::setStyleUniforms(): expected" << state.styleUniformCount << "uniforms, got" << uniforms.size(), *this);
+
+    /* Nothing on the CPU side depends on the uniform contents, so without
+       dynamic styles it's just an upload to the shared uniform buffer. With
+       dynamic styles each layer uploads the static uniforms together with the
+       dynamic ones, so they have to be updated. */
+    if(state.dynamicStyleCount) {
+        state.commonStyleUniform = commonUniform;
+        Utility::copy(uniforms, state.styleUniforms);
+        ++state.styleUpdateStamp;
+    } else doSetStyle(commonUniform, uniforms);
+
+    return *this;
+}
+
+TextLayer::Shared& TextLayer::Shared::setStyleUniforms(const TextLayerCommonStyleUniform& commonUniform, const std::initializer_list<TextLayerStyleUniform> uniforms) {
+    return setStyleUniforms(commonUniform, Containers::arrayView(uniforms));
+}
+
+TextLayer::Shared& TextLayer::Shared::setEditingStyleUniforms(const TextLayerCommonEditingStyleUniform& commonUniform, const Containers::ArrayView<const TextLayerEditingStyleUniform> uniforms) {
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(state.setEditingStyleCalled,
+        "Ui::TextLayer::Shared::setEditingStyleUniforms(): no editing style data was set", *this);
+    CORRADE_ASSERT(uniforms.size() == state.editingStyleUniformCount,
+        "Ui::TextLayer::Shared::setEditingStyleUniforms(): expected" << state.editingStyleUniformCount << "uniforms, got" << uniforms.size(), *this);
+
+    /* Same as in setStyleUniforms() above */
+    if(state.dynamicStyleCount) {
+        state.commonEditingStyleUniform = commonUniform;
+        Utility::copy(uniforms, state.editingStyleUniforms);
+        ++state.editingStyleUpdateStamp;
+    } else doSetEditingStyle(commonUniform, uniforms);
+
+    return *this;
+}
+
+TextLayer::Shared& TextLayer::Shared::setEditingStyleUniforms(const TextLayerCommonEditingStyleUniform& commonUniform, const std::initializer_list<TextLayerEditingStyleUniform> uniforms) {
+    return setEditingStyleUniforms(commonUniform, Containers::arrayView(uniforms));
+}
+
 TextLayer::Shared::Configuration::Configuration(const UnsignedInt styleUniformCount, const UnsignedInt styleCount): _styleUniformCount{styleUniformCount}, _styleCount{styleCount} {
     CORRADE_ASSERT(!styleUniformCount == !styleCount,
         "Ui::TextLayer::Shared::Configuration: expected style uniform count and style count to be either both zero or both non-zero, got" << styleUniformCount << "and" << styleCount, );
@@ -507,13 +620,340 @@ TextLayer::Shared::Configuration& TextLayer::Shared::Configuration::setDynamicSt
     return *this;
 }
 
+TextLayer::Shared::Configuration& TextLayer::Shared::Configuration::setShaperCount(const UnsignedInt count) {
+    CORRADE_ASSERT(count,
+        "Ui::TextLayer::Shared::Configuration::setShaperCount(): expected a non-zero count", *this);
+    _shaperCount = count;
+    return *this;
+}
+
+namespace {
+
+/* Glyph and run allocators for Text::RendererCore, used with either
+   TextLayer::State or Implementation::TextLayerShapeWorker, which both have
+   `glyphData` and `glyphRuns` arrays */
+template<class T> void glyphAllocator(void* const state_, const UnsignedInt glyphCount, Containers::StridedArrayView1D<Vector2>& glyphPositions, Containers::StridedArrayView1D<UnsignedInt>& glyphIds, Containers::StridedArrayView1D<UnsignedInt>* const glyphClusters, Containers::StridedArrayView1D<Vector2>& glyphAdvances) {
+    T& state = *static_cast<T*>(state_);
+
+    /* Assumes that reserve() is never called on the renderer and as such
+       state.glyphData is full of existing data. Then the allocator is
+       either called from clear(), in which case both the views and the
+       requested count is empty, or the glyphPositions etc. views point to
+       its suffix and thus glyphCount is the size by which the array should
+       be grown. */
+    CORRADE_INTERNAL_ASSERT((glyphCount == 0 && glyphPositions.size() == 0) || glyphPositions.data() ==  reinterpret_cast<const char*>(state.glyphData.end() - glyphPositions.size()) + (glyphPositions.data() ? offsetof(Implementation::TextLayerGlyphData, position) : 0));
+    arrayAppend(state.glyphData, NoInit, glyphCount);
+
+    /* The returned views will thus be again suffixes of state.glyphData
+       with the size being a sum of the requested glyph count and existing
+       view size */
+    /** @todo change to suffix() once it takes suffix size and not prefix
+        size */
+    const Containers::StridedArrayView1D<Implementation::TextLayerGlyphData> glyphData = state.glyphData.exceptPrefix(state.glyphData.size() - (glyphCount + glyphPositions.size()));
+    glyphPositions = glyphData.slice(&Implementation::TextLayerGlyphData::position);
+    glyphIds = glyphData.slice(&Implementation::TextLayerGlyphData::glyphId);
+    /* The clusters are populated by just one renderer of the two */
+    if(glyphClusters)
+        *glyphClusters = glyphData.slice(&Implementation::TextLayerGlyphData::glyphCluster);
+    /* Advances alias the suffix of IDs and clusters */
+    glyphAdvances = Containers::arrayCast<Vector2>(glyphData.exceptPrefix(glyphData.size() - glyphCount).slice(&Implementation::TextLayerGlyphData::glyphId));
+}
+template<class T> void runAllocator(void* const state_, const UnsignedInt runCount, Containers::StridedArrayView1D<Float>& runScales, Containers::StridedArrayView1D<UnsignedInt>& runEnds) {
+    T& state = *static_cast<T*>(state_);
+
+    /* Like with the glyph allocator above assumes that reserve() is never
+       called on the renderer and as such state.glyphRuns is full of
+       existing data. Then the allocator is either called from clear(), in
+       which case both the views and the requested count is empty, or the
+       runScales etc. views point to its suffix and thus runCount is the
+       size by which the array should be grown. */
+    CORRADE_INTERNAL_ASSERT((runCount == 0 && runScales.size() == 0) || runScales.data() == reinterpret_cast<const char*>(state.glyphRuns.end() - runScales.size()) + (runScales.data() ? offsetof(Implementation::TextLayerGlyphRun, scale) : 0));
+    arrayAppend(state.glyphRuns, NoInit, runCount);
+
+    /* The returned views will thus be again suffixes of state.glyphRuns
+       with the size being a sum of the requested run count and existing
+       view size */
+    /** @todo change to suffix() once it takes suffix size and not prefix
+        size */
+    const Containers::StridedArrayView1D<Implementation::TextLayerGlyphRun> glyphRuns = state.glyphRuns.exceptPrefix(state.glyphRuns.size() - (runCount + runScales.size()));
+    runScales = glyphRuns.slice(&Implementation::TextLayerGlyphRun::scale);
+    /* The run end gets saved to the glyphCache field, after render() the
+       caller takes that value to populate glyphCount and glyphOffset
+       correctly */
+    runEnds = glyphRuns.slice(&Implementation::TextLayerGlyphRun::glyphCount);
+}
+
+/* Used with TextLayerSharedFlag::GlyphCacheFillOnDemand. Shapes the text line
+   by line the same way as RendererCore::render() does, putting the font glyph
+   IDs into `fontGlyphIds` in the same order as the renderer outputs them. The
+   shaper is expected to have the script, language and direction set
+   already. */
+void shapeFontGlyphIdsInto(Text::AbstractShaper& shaper, const Containers::StringView text, const Containers::ArrayView<const Text::FeatureRange> features, Containers::Array<UnsignedInt>& fontGlyphIds) {
+    arrayResize(fontGlyphIds, 0);
+    std::size_t lineBegin = 0;
+    for(;;) {
+        const Containers::StringView rest = text.exceptPrefix(lineBegin);
+        const std::size_t lineEnd = lineBegin + (rest.findOr('\n', rest.end()).begin() - rest.begin());
+
+        const UnsignedInt glyphCount = shaper.shape(text, lineBegin, lineEnd, features);
+        shaper.glyphIdsInto(arrayAppend(fontGlyphIds, NoInit, glyphCount));
+
+        if(lineEnd == text.size())
+            break;
+        lineBegin = lineEnd + 1;
+    }
+}
+
+/* Fills given glyphs into the glyph cache. With
+   TextLayerSharedFlag::GlyphCacheGrowOnDemand, if they don't fit, the cache
+   is grown by a layer and the fill is attempted again, until the layer count
+   doubles. Errors from the attempts that get followed by a growth are
+   silenced, so a message is printed only if the fill fails for good. */
+bool fillGlyphCache(TextLayer::Shared& shared, Implementation::TextLayerFont& fontState, const Containers::StridedArrayView1D<const UnsignedInt>& fontGlyphIds) {
+    if(shared.flags() >= TextLayerSharedFlag::GlyphCacheGrowOnDemand) {
+        for(Int growCount = shared.glyphCache().size().z(); growCount; --growCount) {
+            {
+                Error silenceError{nullptr};
+                if(fontState.font->fillGlyphCache(shared.glyphCache(), fontGlyphIds))
+                    return true;
+            }
+            if(!shared.growGlyphCache(1))
+                break;
+        }
+    }
+
+    return fontState.font->fillGlyphCache(shared.glyphCache(), fontGlyphIds);
+}
+
+/* Used with TextLayerSharedFlag::GlyphCacheFillOnDemand. Fills all glyphs from
+   `fontGlyphIds` that aren't in the glyph cache yet with a single
+   fillGlyphCache() call. Returns true if any glyphs were added, false if all
+   of them were present already or the fill failed, in which case it's not
+   attempted again for given font. */
+bool fillGlyphCacheOnDemand(TextLayer::Shared& shared, Implementation::TextLayerFont& fontState, Implementation::FrameArena& storage, const Containers::ArrayView<const UnsignedInt> fontGlyphIds, Containers::Array<UnsignedInt>& missingGlyphIds) {
+    const Text::AbstractGlyphCache& glyphCache = shared.glyphCache();
+    /* Each missing glyph gets added just once even if it's used multiple
+       times in the text */
+    const Containers::MutableBitArrayView seen = storage.allocateBits(ValueInit, glyphCache.fontGlyphCount(fontState.glyphCacheFontId));
+    arrayResize(missingGlyphIds, 0);
+    for(const UnsignedInt glyphId: fontGlyphIds) {
+        if(seen[glyphId] || glyphCache.glyphId(fontState.glyphCacheFontId, glyphId))
+            continue;
+        seen.set(glyphId);
+        arrayAppend(missingGlyphIds, glyphId);
+    }
+
+    if(missingGlyphIds.isEmpty())
+        return false;
+
+    /* The fill uploads just the updated part of the glyph cache */
+    if(!fillGlyphCache(shared, fontState, Containers::stridedArrayView(missingGlyphIds))) {
+        fontState.glyphCacheFillFailed = true;
+        return false;
+    }
+
+    return true;
+}
+
+/* Whether glyphs should be filled on demand for given font. Fonts with a
+   prepared glyph cache can't fill, and if a fill failed before, the cache is
+   likely full so it's not attempted again. */
+bool canFillGlyphCacheOnDemand(const TextLayerSharedFlags flags, const Implementation::TextLayerFont& fontState) {
+    return (flags & (TextLayerSharedFlag::GlyphCacheFillOnDemand|TextLayerSharedFlag::GlyphCacheFillDeferred|TextLayerSharedFlag::GlyphCacheGrowOnDemand)) &&
+        fontState.font &&
+        !(fontState.font->features() >= Text::FontFeature::PreparedGlyphCache) &&
+        !fontState.glyphCacheFillFailed;
+}
+
+/* Whether the glyph cache font ID and font glyph IDs fit into the bits next
+   to Implementation::TextLayerPendingGlyph */
+bool canDeferGlyphCacheFill(const Text::AbstractGlyphCache& glyphCache, const Implementation::TextLayerFont& fontState) {
+    return fontState.glyphCacheFontId < 32768 &&
+        glyphCache.fontGlyphCount(fontState.glyphCacheFontId) <= 65536;
+}
+
+/* Used with TextLayerSharedFlag::GlyphCacheFillDeferred. Marks glyphs that
+   aren't in the glyph cache as pending, and remembers them in the font to be
+   filled in the next doUpdate(). The `glyphIds` are cache-global IDs produced
+   by the renderer, `fontGlyphIds` the corresponding font glyph IDs. */
+void deferGlyphCacheFill(const Text::AbstractGlyphCache& glyphCache, Implementation::TextLayerFont& fontState, const Containers::ArrayView<const UnsignedInt> fontGlyphIds, const Containers::StridedArrayView1D<UnsignedInt>& glyphIds) {
+    CORRADE_INTERNAL_ASSERT(fontGlyphIds.size() == glyphIds.size());
+    if(fontState.pendingGlyphMask.isEmpty())
+        fontState.pendingGlyphMask = Containers::BitArray{ValueInit, glyphCache.fontGlyphCount(fontState.glyphCacheFontId)};
+
+    for(std::size_t i = 0; i != glyphIds.size(); ++i) {
+        if(glyphIds[i])
+            continue;
+
+        const UnsignedInt fontGlyphId = fontGlyphIds[i];
+        glyphIds[i] = Implementation::TextLayerPendingGlyph|(fontState.glyphCacheFontId << 16)|fontGlyphId;
+        if(!fontState.pendingGlyphMask[fontGlyphId]) {
+            fontState.pendingGlyphMask.set(fontGlyphId);
+            arrayAppend(fontState.pendingGlyphs, fontGlyphId);
+        }
+    }
+}
+
+/* Replaces glyph IDs marked with Implementation::TextLayerPendingGlyph with
+   cache-global glyph IDs. If the glyph failed to be filled, it becomes the
+   invalid glyph. */
+void resolvePendingGlyphs(const Text::AbstractGlyphCache& glyphCache, const Containers::StridedArrayView1D<UnsignedInt>& glyphIds) {
+    for(UnsignedInt& glyphId: glyphIds) {
+        if(glyphId & Implementation::TextLayerPendingGlyph)
+            glyphId = glyphCache.glyphId((glyphId >> 16) & 0x7fff, glyphId & 0xffff);
+    }
+}
+
+/* Used with TextLayerSharedFlag::GlyphCacheFillDeferred. Fills pending glyphs
+   of all fonts, with a single fillGlyphCache() call for each, and resolves
+   pending glyph IDs in the shape cache so they can be copied as-is. */
+void fillPendingGlyphs(TextLayer::Shared& shared, const Containers::ArrayView<Implementation::TextLayerFont> fonts, const Containers::ArrayView<Implementation::TextLayerShapeCacheEntry> shapeCache) {
+    for(Implementation::TextLayerFont& fontState: fonts) {
+        if(fontState.pendingGlyphs.isEmpty())
+            continue;
+
+        if(!fillGlyphCache(shared, fontState, Containers::stridedArrayView(fontState.pendingGlyphs)))
+            fontState.glyphCacheFillFailed = true;
+
+        for(const UnsignedInt glyphId: fontState.pendingGlyphs)
+            fontState.pendingGlyphMask.reset(glyphId);
+        arrayResize(fontState.pendingGlyphs, 0);
+    }
+
+    for(Implementation::TextLayerShapeCacheEntry& entry: shapeCache)
+        resolvePendingGlyphs(shared.glyphCache(), stridedArrayView(entry.glyphData).slice(&Implementation::TextLayerGlyphData::glyphId));
+}
+
+/* Shapes a multi-line text with the wrapped shaper, but reuses results of
+   lines that didn't change since the previous shaping of the same text,
+   recording all lines for the next time. Relies on RendererCore calling
+   shape() for each line separately. A line is reused if it has the same
+   contents as the line at the same index in the previous text, or at the same
+   index counted from the end, which covers all lines outside of a single
+   contiguous edit. */
+class LineShapeCacheShaper: public Text::AbstractShaper {
+    public:
+        explicit LineShapeCacheShaper(Text::AbstractShaper& shaper, const Implementation::TextLayerLineShapeCache& previous, Implementation::TextLayerLineShapeCache& next, const UnsignedInt lineCount): Text::AbstractShaper{shaper.font()}, _shaper(shaper), _previous(previous), _next(next), _lineCount{lineCount} {
+            reset();
+        }
+
+        /* Discards the lines recorded so far, called also if the text is
+           rendered again */
+        void reset() {
+            arrayResize(_next.lines, 0);
+            arrayResize(_next.text, 0);
+            arrayResize(_next.glyphIds, 0);
+            arrayResize(_next.glyphOffsets, 0);
+            arrayResize(_next.glyphAdvances, 0);
+            arrayResize(_next.glyphClusters, 0);
+            _line = 0;
+        }
+
+    private:
+        const Implementation::TextLayerLineShape* findPreviousLine(const Containers::StringView line) const {
+            const Containers::ArrayView<const Implementation::TextLayerLineShape> lines = _previous.lines;
+            const auto matches = [&](const Implementation::TextLayerLineShape& previousLine) {
+                return line == Containers::StringView{_previous.text.sliceSize(previousLine.textOffset, previousLine.textSize)};
+            };
+            if(_line < lines.size() && matches(lines[_line]))
+                return &lines[_line];
+            if(lines.size() + _line >= _lineCount) {
+                const std::size_t fromEnd = lines.size() + _line - _lineCount;
+                if(fromEnd < lines.size() && matches(lines[fromEnd]))
+                    return &lines[fromEnd];
+            }
+            return nullptr;
+        }
+
+        UnsignedInt doShape(const Containers::StringView text, const UnsignedInt begin, const UnsignedInt end, const Containers::ArrayView<const Text::FeatureRange> features) override {
+            const Containers::StringView line = text.slice(begin, end);
+            _begin = begin;
+            _glyphOffset = _next.glyphIds.size();
+
+            UnsignedInt glyphCount;
+            if(const Implementation::TextLayerLineShape* const previousLine = findPreviousLine(line)) {
+                glyphCount = previousLine->glyphCount;
+                arrayAppend(_next.glyphIds, _previous.glyphIds.sliceSize(previousLine->glyphOffset, glyphCount));
+                arrayAppend(_next.glyphOffsets, _previous.glyphOffsets.sliceSize(previousLine->glyphOffset, glyphCount));
+                arrayAppend(_next.glyphAdvances, _previous.glyphAdvances.sliceSize(previousLine->glyphOffset, glyphCount));
+                arrayAppend(_next.glyphClusters, _previous.glyphClusters.sliceSize(previousLine->glyphOffset, glyphCount));
+                _direction = previousLine->direction;
+            } else {
+                glyphCount = _shaper.shape(text, begin, end, features);
+                _shaper.glyphIdsInto(arrayAppend(_next.glyphIds, NoInit, glyphCount));
+                _shaper.glyphOffsetsAdvancesInto(
+                    arrayAppend(_next.glyphOffsets, NoInit, glyphCount),
+                    arrayAppend(_next.glyphAdvances, NoInit, glyphCount));
+                const Containers::ArrayView<UnsignedInt> clusters = arrayAppend(_next.glyphClusters, NoInit, glyphCount);
+                _shaper.glyphClustersInto(clusters);
+                for(UnsignedInt& cluster: clusters)
+                    cluster -= begin;
+                _direction = _shaper.direction();
+            }
+
+            arrayAppend(_next.lines, InPlaceInit,
+                UnsignedInt(_next.text.size()), UnsignedInt(line.size()),
+                _glyphOffset, glyphCount, _direction);
+            arrayAppend(_next.text, line);
+            ++_line;
+            return glyphCount;
+        }
+
+        Text::ShapeDirection doDirection() const override {
+            return _direction;
+        }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+            Utility::copy(_next.glyphIds.sliceSize(_glyphOffset, ids.size()), ids);
+        }
+
+        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+            Utility::copy(_next.glyphOffsets.sliceSize(_glyphOffset, offsets.size()), offsets);
+            Utility::copy(_next.glyphAdvances.sliceSize(_glyphOffset, advances.size()), advances);
+        }
+
+        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+            for(std::size_t i = 0; i != clusters.size(); ++i)
+                clusters[i] = _begin + _next.glyphClusters[_glyphOffset + i];
+        }
+
+        Text::AbstractShaper& _shaper;
+        const Implementation::TextLayerLineShapeCache& _previous;
+        Implementation::TextLayerLineShapeCache& _next;
+        UnsignedInt _lineCount;
+        UnsignedInt _line;
+        UnsignedInt _begin{};
+        UnsignedInt _glyphOffset{};
+        Text::ShapeDirection _direction = Text::ShapeDirection::Unspecified;
+};
+
+/* Whether all features apply to the whole text, in which case the shaping
+   result of a line doesn't depend on where the line is in the text */
+bool featuresCoverWholeText(const Containers::ArrayView<const Text::FeatureRange> features) {
+    for(const Text::FeatureRange& feature: features)
+        if(feature.begin() != 0 || feature.end() != ~UnsignedInt{})
+            return false;
+    return true;
+}
+
+bool featuresEqual(const Containers::ArrayView<const Text::FeatureRange> a, const Containers::ArrayView<const Text::FeatureRange> b) {
+    if(a.size() != b.size())
+        return false;
+    for(std::size_t i = 0; i != a.size(); ++i)
+        if(a[i].feature() != b[i].feature() || a[i].value() != b[i].value() || a[i].begin() != b[i].begin() || a[i].end() != b[i].end())
+            return false;
+    return true;
+}
+
+}
+
 TextLayer::State::State(Shared::State& shared, const TextLayerFlags flags):
     AbstractVisualLayer::State{shared},
     styleUpdateStamp{shared.styleUpdateStamp},
     editingStyleUpdateStamp{shared.editingStyleUpdateStamp},
     flags{flags},
     /* These get created below, just to not have to do nasty things to
-       deduplicate allocator lambda definitions */
+       pass the State pointer to the allocators */
     renderer{NoCreate},
     rendererGlyphClusters{NoCreate}
 {
@@ -531,63 +971,16 @@ TextLayer::State::State(Shared::State& shared, const TextLayerFlags flags):
         {ValueInit, shared.hasEditingStyles ? shared.dynamicStyleCount*2 : 0, dynamicEditingStylePaddings},
     };
 
-    const auto glyphAllocator = [](void* const state_, const UnsignedInt glyphCount, Containers::StridedArrayView1D<Vector2>& glyphPositions, Containers::StridedArrayView1D<UnsignedInt>& glyphIds, Containers::StridedArrayView1D<UnsignedInt>* const glyphClusters, Containers::StridedArrayView1D<Vector2>& glyphAdvances) {
-        State& state = *static_cast<TextLayer::State*>(state_);
-
-        /* Assumes that reserve() is never called on the renderer and as such
-           state.glyphData is full of existing data. Then the allocator is
-           either called from clear(), in which case both the views and the
-           requested count is empty, or the glyphPositions etc. views point to
-           its suffix and thus glyphCount is the size by which the array should
-           be grown. */
-        CORRADE_INTERNAL_ASSERT((glyphCount == 0 && glyphPositions.size() == 0) || glyphPositions.data() ==  reinterpret_cast<const char*>(state.glyphData.end() - glyphPositions.size()) + (glyphPositions.data() ? offsetof(Implementation::TextLayerGlyphData, position) : 0));
-        arrayAppend(state.glyphData, NoInit, glyphCount);
-
-        /* The returned views will thus be again suffixes of state.glyphData
-           with the size being a sum of the requested glyph count and existing
-           view size */
-        /** @todo change to suffix() once it takes suffix size and not prefix
-            size */
-        const Containers::StridedArrayView1D<Implementation::TextLayerGlyphData> glyphData = state.glyphData.exceptPrefix(state.glyphData.size() - (glyphCount + glyphPositions.size()));
-        glyphPositions = glyphData.slice(&Implementation::TextLayerGlyphData::position);
-        glyphIds = glyphData.slice(&Implementation::TextLayerGlyphData::glyphId);
-        /* The clusters are populated by just one renderer of the two */
-        if(glyphClusters)
-            *glyphClusters = glyphData.slice(&Implementation::TextLayerGlyphData::glyphCluster);
-        /* Advances alias the suffix of IDs and clusters */
-        glyphAdvances = Containers::arrayCast<Vector2>(glyphData.exceptPrefix(glyphData.size() - glyphCount).slice(&Implementation::TextLayerGlyphData::glyphId));
-    };
-    const auto runAllocator = [](void* const state_, const UnsignedInt runCount, Containers::StridedArrayView1D<Float>& runScales, Containers::StridedArrayView1D<UnsignedInt>& runEnds) {
-        State& state = *static_cast<TextLayer::State*>(state_);
-
-        /* Like with the glyph allocator above assumes that reserve() is never
-           called on the renderer and as such state.glyphRuns is full of
-           existing data. Then the allocator is either called from clear(), in
-           which case both the views and the requested count is empty, or the
-           runScales etc. views point to its suffix and thus runCount is the
-           size by which the array should be grown. */
-        CORRADE_INTERNAL_ASSERT((runCount == 0 && runScales.size() == 0) || runScales.data() == reinterpret_cast<const char*>(state.glyphRuns.end() - runScales.size()) + (runScales.data() ? offsetof(Implementation::TextLayerGlyphRun, scale) : 0));
-        arrayAppend(state.glyphRuns, NoInit, runCount);
-
-        /* The returned views will thus be again suffixes of state.glyphRuns
-           with the size being a sum of the requested run count and existing
-           view size */
-        /** @todo change to suffix() once it takes suffix size and not prefix
-            size */
-        const Containers::StridedArrayView1D<Implementation::TextLayerGlyphRun> glyphRuns = state.glyphRuns.exceptPrefix(state.glyphRuns.size() - (runCount + runScales.size()));
-        runScales = glyphRuns.slice(&Implementation::TextLayerGlyphRun::scale);
-        /* The run end gets saved to the glyphCache field, after render() the
-           caller takes that value to populate glyphCount and glyphOffset
-           correctly */
-        runEnds = glyphRuns.slice(&Implementation::TextLayerGlyphRun::glyphCount);
-    };
     renderer = Text::RendererCore{shared.glyphCache,
-        glyphAllocator, this,
-        runAllocator, this};
+        glyphAllocator<State>, this,
+        runAllocator<State>, this};
     rendererGlyphClusters = Text::RendererCore{shared.glyphCache,
-        glyphAllocator, this,
-        runAllocator, this,
+        glyphAllocator<State>, this,
+        runAllocator<State>, this,
         Text::RendererCoreFlag::GlyphClusters};
+
+    CORRADE_ASSERT(!(flags >= TextLayerFlag::GlyphCulling) || !(shared.flags & (TextLayerSharedFlag::InstancedGlyphs|TextLayerSharedFlag::ShaderTransformation)),
+        "Ui::TextLayer:" << TextLayerFlag::GlyphCulling << "can't be used with" << (shared.flags & (TextLayerSharedFlag::InstancedGlyphs|TextLayerSharedFlag::ShaderTransformation)), );
 }
 
 TextLayer::TextLayer(const LayerHandle handle, Containers::Pointer<State>&& state): AbstractVisualLayer{handle, Utility::move(state)} {}
@@ -939,29 +1332,244 @@ void TextLayer::setDynamicStyleWithSelection(const UnsignedInt id, const TextLay
     setDynamicStyleWithSelection(id, uniform, font, alignment, Containers::arrayView(features), padding, selectionUniform, selectionTextUniform, selectionPadding);
 }
 
-void TextLayer::shapeTextInternal(const UnsignedInt id, const UnsignedInt style, const Containers::StringView text, const TextProperties& properties, const FontHandle font, const TextDataFlags flags) {
+namespace {
+
+/* Appends raw bytes of `value` to a shape cache key */
+template<class T> void appendShapeCacheKey(Containers::Array<char>& key, const T& value) {
+    arrayAppend(key, Containers::arrayView(reinterpret_cast<const char*>(&value), sizeof(T)));
+}
+
+/* 64-bit FNV-1a. Used just to avoid comparing the whole key with every
+   entry, there's no need for anything stronger. */
+UnsignedLong shapeCacheKeyHash(const Containers::ArrayView<const char> key) {
+    UnsignedLong hash = 14695981039346656037ull;
+    for(const char c: key) {
+        hash ^= UnsignedByte(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/* Serializes a shape cache key into `key`, returning its hash. The font size
+   is implied by the font handle as fonts can't be removed or changed.
+   Language is stored as a null-terminated string with unspecified contents
+   after, so save just its actual size. */
+UnsignedLong shapeCacheKeyInto(Containers::Array<char>& key, const FontHandle font, const Text::Alignment alignment, const TextProperties& properties, const Containers::ArrayView<const Text::FeatureRange> features, const Containers::StringView text) {
+    arrayResize(key, 0);
+    appendShapeCacheKey(key, font);
+    appendShapeCacheKey(key, alignment);
+    appendShapeCacheKey(key, properties.layoutDirection());
+    appendShapeCacheKey(key, properties.shapeDirection());
+    appendShapeCacheKey(key, properties.script());
+    const Containers::StringView language = properties.language();
+    appendShapeCacheKey(key, UnsignedByte(language.size()));
+    arrayAppend(key, language);
+    appendShapeCacheKey(key, UnsignedInt(features.size()));
+    for(const Text::FeatureRange& feature: features) {
+        appendShapeCacheKey(key, feature.feature());
+        appendShapeCacheKey(key, feature.value());
+        appendShapeCacheKey(key, feature.begin());
+        appendShapeCacheKey(key, feature.end());
+    }
+    arrayAppend(key, text);
+    return shapeCacheKeyHash(key);
+}
+
+/* Returns a shape cache entry matching given key or null if there's none */
+Implementation::TextLayerShapeCacheEntry* findShapeCacheEntry(const Containers::ArrayView<Implementation::TextLayerShapeCacheEntry> entries, const UnsignedLong hash, const Containers::ArrayView<const char> key) {
+    for(Implementation::TextLayerShapeCacheEntry& entry: entries) {
+        if(entry.hash == hash && entry.key.size() == key.size() && std::memcmp(entry.key.data(), key.data(), key.size()) == 0)
+            return &entry;
+    }
+    return nullptr;
+}
+
+/* Returns a shape cache entry to save a newly shaped text to, either an unused
+   one or the least recently used one */
+Implementation::TextLayerShapeCacheEntry& shapeCacheEntryToReplace(const Containers::ArrayView<Implementation::TextLayerShapeCacheEntry> entries, UnsignedInt& usedCount) {
+    if(usedCount < entries.size())
+        return entries[usedCount++];
+
+    Implementation::TextLayerShapeCacheEntry* entry = &entries.front();
+    for(Implementation::TextLayerShapeCacheEntry& i: entries)
+        if(i.lastUsed < entry->lastUsed) entry = &i;
+    return *entry;
+}
+
+}
+
+Containers::Pair<Range2D, UnsignedInt> TextLayer::Shared::measure(const UnsignedInt style, const Containers::StringView text, const TextProperties& properties) {
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = static_cast<const State&>(*_state);
+    #endif
+    CORRADE_ASSERT(state.setStyleCalled,
+        "Ui::TextLayer::Shared::measure(): no style data was set", {});
+    CORRADE_ASSERT(style < state.styleCount,
+        "Ui::TextLayer::Shared::measure(): style" << style << "out of range for" << state.styleCount << "styles", {});
+    return measureInternal(
+        #ifndef CORRADE_NO_ASSERT
+        "Ui::TextLayer::Shared::measure():",
+        #endif
+        style, text, properties);
+}
+
+void TextLayer::Shared::measureInto(const Containers::StridedArrayView1D<const UnsignedInt>& styles, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& properties, const Containers::StridedArrayView1D<Range2D>& rectangles, const Containers::StridedArrayView1D<UnsignedInt>& glyphCounts) {
+    CORRADE_ASSERT(texts.size() == styles.size() && properties.size() == styles.size() && rectangles.size() == styles.size() && glyphCounts.size() == styles.size(),
+        "Ui::TextLayer::Shared::measureInto(): expected style, text, property, rectangle and glyph count views to have the same size but got" << styles.size() << Debug::nospace << "," << texts.size() << Debug::nospace << "," << properties.size() << Debug::nospace << "," << rectangles.size() << "and" << glyphCounts.size(), );
+    #ifndef CORRADE_NO_ASSERT
+    const State& state = static_cast<const State&>(*_state);
+    #endif
+    CORRADE_ASSERT(state.setStyleCalled,
+        "Ui::TextLayer::Shared::measureInto(): no style data was set", );
+
+    /* Check all styles first to not end up with just a part of the texts
+       measured */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != styles.size(); ++i)
+        CORRADE_ASSERT(styles[i] < state.styleCount,
+            "Ui::TextLayer::Shared::measureInto(): style" << styles[i] << "out of range for" << state.styleCount << "styles at index" << i, );
+    #endif
+
+    for(std::size_t i = 0; i != styles.size(); ++i) {
+        const Containers::Pair<Range2D, UnsignedInt> out = measureInternal(
+            #ifndef CORRADE_NO_ASSERT
+            "Ui::TextLayer::Shared::measureInto():",
+            #endif
+            styles[i], texts[i], properties[i]);
+        rectangles[i] = out.first();
+        glyphCounts[i] = out.second();
+    }
+}
+
+Containers::Pair<Range2D, UnsignedInt> TextLayer::Shared::measureInternal(
+    #ifndef CORRADE_NO_ASSERT
+    const char* const messagePrefix,
+    #endif
+    const UnsignedInt style, const Containers::StringView text, const TextProperties& properties)
+{
     State& state = static_cast<State&>(*_state);
-    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+    const Implementation::TextLayerStyle& styleData = state.styles[style];
 
-    /* The shapeRememberTextInternal() should originally have checked that the
-       font isn't null and has an instance, editShapeTextInternal() then just
-       passes what has been saved by shapeRememberTextInternal() */
-    Implementation::TextLayerFont& fontState = sharedState.fonts[fontHandleId(font)];
-    CORRADE_INTERNAL_ASSERT(font != FontHandle::Null && fontState.font);
+    /* Decide on a font, alignment and features the same way as
+       TextLayer::fontInternal(), alignmentInternal() and featuresInternal()
+       do, just restricted to the shared styles */
+    FontHandle font = properties.font();
+    if(font == FontHandle::Null) {
+        CORRADE_ASSERT(styleData.font != FontHandle::Null,
+            messagePrefix << "style" << style << "has no font set and no custom font was supplied", {});
+        font = styleData.font;
+    } else CORRADE_ASSERT(Ui::isHandleValid(state.fonts, font),
+        messagePrefix << "invalid handle" << font, {});
+    Implementation::TextLayerFont& fontState = state.fonts[fontHandleId(font)];
+    CORRADE_ASSERT(fontState.font,
+        messagePrefix << font << "is an instance-less font", {});
+
+    const Text::Alignment alignment = properties.alignment() ? *properties.alignment() : styleData.alignment;
+
+    Implementation::FrameArena& storage = state.measureStorage;
+    storage.reset();
+    const Containers::ArrayView<const TextFeatureValue> styleFeatures = state.styleFeatures.sliceSize(styleData.featureOffset, styleData.featureCount);
+    const Containers::ArrayView<Text::FeatureRange> features = storage.allocate<Text::FeatureRange>(NoInit, styleFeatures.size() + properties.features().size());
+    for(std::size_t i = 0; i != styleFeatures.size(); ++i)
+        features[i] = styleFeatures[i];
+    Utility::copy(properties.features(), features.exceptPrefix(styleFeatures.size()));
 
-    /* Decide on alignment */
-    Text::Alignment alignment;
-    if(!properties.alignment()) {
-        if(style < sharedState.styleCount)
-            alignment = sharedState.styles[style].alignment;
-        else
-            alignment = state.dynamicStyles[style - sharedState.styleCount].alignment;
-    } else
-        alignment = *properties.alignment();
+    /* If the shape cache is enabled, look up whether the same text was shaped
+       with the same properties recently, either by a layer or by a previous
+       measure() call */
+    const bool useShapeCache = !state.shapeCache.isEmpty();
+    UnsignedLong shapeCacheHash{};
+    if(useShapeCache) {
+        shapeCacheHash = shapeCacheKeyInto(state.shapeCacheKey, font, alignment, properties, features, text);
+
+        ++state.shapeCacheUsage;
+        if(Implementation::TextLayerShapeCacheEntry* const entry = findShapeCacheEntry(state.shapeCache.prefix(state.shapeCacheUsedCount), shapeCacheHash, state.shapeCacheKey)) {
+            entry->lastUsed = state.shapeCacheUsage;
+            return {entry->rectangle, UnsignedInt(entry->glyphData.size())};
+        }
+    }
+
+    /* Get a shaper instance, shared with all layers like the shape cache
+       is */
+    if(!fontState.shaper)
+        fontState.shaper = fontState.font->createShaper();
+    Text::AbstractShaper& shaper = *fontState.shaper;
+
+    /* Render into the measure worker, which is created on first use. Unlike
+       with the layers, the glyphs don't need to be kept, so the worker
+       arrays are cleared every time. The worker is placed in an Optional and
+       not moved anywhere afterwards, as the renderer references it. */
+    if(!state.measureWorker) {
+        state.measureWorker.emplace();
+        state.measureWorker->renderer = Text::RendererCore{state.glyphCache,
+            glyphAllocator<Implementation::TextLayerShapeWorker>, &*state.measureWorker,
+            runAllocator<Implementation::TextLayerShapeWorker>, &*state.measureWorker};
+    }
+    Implementation::TextLayerShapeWorker& worker = *state.measureWorker;
+    arrayResize(worker.glyphData, 0);
+    arrayResize(worker.glyphRuns, 0);
+    worker.renderer.reset();
+    shaper.setScript(properties.script());
+    shaper.setLanguage(properties.language());
+    shaper.setDirection(properties.shapeDirection());
+    const Containers::Pair<Range2D, Range1Dui> rectangleRunRange = worker.renderer
+        .setAlignment(alignment)
+        .setLayoutDirection(properties.layoutDirection())
+        .render(shaper, fontState.scale*fontState.font->size(), text, features);
+
+    /* Save the shaped text to the cache, so e.g. creating data with the same
+       text right after doesn't need to shape it again. If glyphs are filled
+       on demand and some aren't in the glyph cache, the glyph IDs would be
+       invalid, so it's not saved in that case. */
+    if(useShapeCache) {
+        bool hasMissingGlyphs = false;
+        if(canFillGlyphCacheOnDemand(state.flags, fontState)) {
+            for(const Implementation::TextLayerGlyphData& glyph: worker.glyphData) {
+                if(!glyph.glyphId) {
+                    hasMissingGlyphs = true;
+                    break;
+                }
+            }
+        }
+
+        /* Same as at the end of TextLayer::shapeTextInternal() */
+        if(!hasMissingGlyphs) {
+            CORRADE_INTERNAL_ASSERT(rectangleRunRange.second().size() <= 1);
+            Implementation::TextLayerShapeCacheEntry& entry = shapeCacheEntryToReplace(state.shapeCache, state.shapeCacheUsedCount);
+            arrayResize(entry.key, NoInit, state.shapeCacheKey.size());
+            Utility::copy(state.shapeCacheKey, entry.key);
+            arrayResize(entry.glyphData, NoInit, worker.glyphData.size());
+            Utility::copy(worker.glyphData, entry.glyphData);
+            entry.hash = shapeCacheHash;
+            entry.rectangle = rectangleRunRange.first();
+            entry.lastUsed = state.shapeCacheUsage;
+            entry.hasRun = rectangleRunRange.second().size();
+            entry.scale = entry.hasRun ? worker.glyphRuns.front().scale : 0.0f;
+            entry.alignment = Text::alignmentForDirection(alignment,
+                properties.layoutDirection(),
+                shaper.direction());
+        }
+    }
 
-    /* Put together features from the style and TextProperties. Style goes
-       first to make it possible to override it. */
-    /** @todo some bump allocator for this, ugh */
+    return {rectangleRunRange.first(), UnsignedInt(worker.glyphData.size())};
+}
+
+Text::Alignment TextLayer::alignmentInternal(const UnsignedInt style, const TextProperties& properties) const {
+    const State& state = static_cast<const State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+
+    if(properties.alignment())
+        return *properties.alignment();
+    if(style < sharedState.styleCount)
+        return sharedState.styles[style].alignment;
+    return state.dynamicStyles[style - sharedState.styleCount].alignment;
+}
+
+Containers::ArrayView<Text::FeatureRange> TextLayer::featuresInternal(Implementation::FrameArena& storage, const UnsignedInt style, const TextProperties& properties) const {
+    const State& state = static_cast<const State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+
+    /* Style goes first to make it possible to override it */
     Containers::ArrayView<const TextFeatureValue> styleFeatures;
     if(style < sharedState.styleCount)
         styleFeatures = sharedState.styleFeatures.sliceSize(
@@ -971,39 +1579,278 @@ void TextLayer::shapeTextInternal(const UnsignedInt id, const UnsignedInt style,
         styleFeatures = state.dynamicStyleFeatures.sliceSize(
             state.dynamicStyles[style - sharedState.styleCount].featureOffset,
             state.dynamicStyles[style - sharedState.styleCount].featureCount);
-    Containers::Array<Text::FeatureRange> features{NoInit, styleFeatures.size() + properties.features().size()};
+    const Containers::ArrayView<Text::FeatureRange> features = storage.allocate<Text::FeatureRange>(NoInit, styleFeatures.size() + properties.features().size());
     /* This performs a conversion from TextFeatureValue to Text::FeatureRange,
        so can't use Utility::copy() */
     for(std::size_t i = 0; i != styleFeatures.size(); ++i)
         features[i] = styleFeatures[i];
     Utility::copy(properties.features(), features.exceptPrefix(styleFeatures.size()));
+    return features;
+}
+
+namespace {
+
+/* Replaces glyph clusters of a TextDataFlag::Wrap text with break
+   opportunities and forced line breaks used by TextLayer::doUpdate(). As the
+   renderer doesn't produce any glyphs for newlines, a forced break is where
+   there's a newline between the clusters of two consecutive glyphs. */
+void wrapBreaksInto(const Containers::StringView text, const Containers::ArrayView<Implementation::TextLayerGlyphData> glyphs) {
+    UnsignedInt previousCluster = glyphs.isEmpty() ? 0 : glyphs.front().glyphCluster;
+    for(Implementation::TextLayerGlyphData& glyph: glyphs) {
+        const UnsignedInt cluster = glyph.glyphCluster;
+        UnsignedInt wrap = 0;
+        if(text[cluster] == ' ')
+            wrap |= Implementation::TextLayerGlyphWrapSpace;
+        for(UnsignedInt i = Math::min(previousCluster, cluster), end = Math::max(previousCluster, cluster); i != end; ++i) {
+            if(text[i] == '\n') {
+                wrap |= Implementation::TextLayerGlyphWrapLineBreak;
+                break;
+            }
+        }
+        glyph.glyphCluster = wrap;
+        previousCluster = cluster;
+    }
+}
+
+/* Offset of the aligned text origin relative to the top left corner of an
+   area of given size, which is the node area without padding. Used by
+   doUpdate() to position the glyphs and by the pointer event handlers to map
+   the event position back to glyph positions. */
+Vector2 alignmentOffset(const Text::Alignment alignment, const Vector2& size) {
+    Vector2 offset;
+    const UnsignedByte alignmentHorizontal = UnsignedByte(alignment) & Text::Implementation::AlignmentHorizontal;
+    if(alignmentHorizontal == Text::Implementation::AlignmentLeft) {
+        offset.x() = 0.0f;
+    } else if(alignmentHorizontal == Text::Implementation::AlignmentRight) {
+        offset.x() = size.x();
+    } else if(alignmentHorizontal == Text::Implementation::AlignmentCenter) {
+        if(UnsignedByte(alignment) & Text::Implementation::AlignmentIntegral)
+            offset.x() = Math::round(size.x()*0.5f);
+        else
+            offset.x() = size.x()*0.5f;
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    const UnsignedByte alignmentVertical = UnsignedByte(alignment) & Text::Implementation::AlignmentVertical;
+    /* For Line/Middle it's aligning either the line or bounding box middle
+       (which is already at y=0 by the Text::alignRenderedLine()) to node
+       middle */
+    if(alignmentVertical == Text::Implementation::AlignmentTop) {
+        offset.y() = 0.0f;
+    } else if(alignmentVertical == Text::Implementation::AlignmentBottom) {
+        offset.y() = size.y();
+    } else if(alignmentVertical == Text::Implementation::AlignmentLine ||
+              alignmentVertical == Text::Implementation::AlignmentMiddle) {
+        if(UnsignedByte(alignment) & Text::Implementation::AlignmentIntegral)
+            offset.y() = Math::round(size.y()*0.5f);
+        else
+            offset.y() = size.y()*0.5f;
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    return offset;
+}
+
+}
+
+void TextLayer::shapeTextInternal(const UnsignedInt id, const UnsignedInt style, const Containers::StringView text, const TextProperties& properties, const FontHandle font, const TextDataFlags flags, const Implementation::TextLayerShapeJob* job) {
+    MAGNUM_UI_TRACE_ZONE("Ui::TextLayer::shapeTextInternal()");
+    State& state = static_cast<State&>(*_state);
+    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+
+    /* The shapeRememberTextInternal() should originally have checked that the
+       font isn't null and has an instance, editShapeTextInternal() then just
+       passes what has been saved by shapeRememberTextInternal() */
+    Implementation::TextLayerFont& fontState = sharedState.fonts[fontHandleId(font)];
+    CORRADE_INTERNAL_ASSERT(font != FontHandle::Null && fontState.font);
+
+    /* If the text was already shaped concurrently in setTextsInternal(),
+       copy the glyphs from the worker that shaped it. The shape cache isn't
+       used in that case. If glyphs are filled on demand and some of them are
+       not in the glyph cache, the fill can't be done from the workers, so the
+       text is shaped again below. */
+    const Implementation::TextLayerShapeWorker* const worker = job ? &state.shapeWorkers[job->worker] : nullptr;
+    if(job && canFillGlyphCacheOnDemand(sharedState.flags, fontState)) {
+        for(const Implementation::TextLayerGlyphData& glyph: worker->glyphData.sliceSize(job->glyphOffset, job->glyphCount)) {
+            if(!glyph.glyphId) {
+                job = nullptr;
+                break;
+            }
+        }
+    }
+    if(job) {
+        CORRADE_INTERNAL_DEBUG_ASSERT(job->font == font);
+        Implementation::TextLayerData& data = state.data[id];
+        if(job->hasRun) {
+            data.glyphRun = state.glyphRuns.size();
+            Implementation::TextLayerGlyphRun& run = arrayAppend(state.glyphRuns, NoInit, 1).front();
+            run.glyphOffset = state.glyphData.size();
+            run.glyphCount = job->glyphCount;
+            run.data = id;
+            run.scale = job->scale;
+            arrayAppend(state.glyphData, worker->glyphData.sliceSize(job->glyphOffset, job->glyphCount));
+
+            /* The workers always fill in glyph clusters, so the break
+               opportunities can be calculated from them directly */
+            if(flags >= TextDataFlag::Wrap) {
+                run.lineAdvance = fontState.font->lineHeight()*fontState.scale;
+                wrapBreaksInto(text, state.glyphData.exceptPrefix(run.glyphOffset));
+            }
+        } else data.glyphRun = ~UnsignedInt{};
+        data.rectangle = job->rectangle;
+        data.alignment = Text::alignmentForDirection(job->alignment,
+            properties.layoutDirection(),
+            job->direction);
+        data.usedDirection = flags >= TextDataFlag::Editable ?
+            job->direction : Text::ShapeDirection::Unspecified;
+        return;
+    }
+
+    /* Decide on alignment */
+    const Text::Alignment alignment = alignmentInternal(style, properties);
+
+    /* Put together features from the style and TextProperties. The memory is
+       taken from a scratch arena that's reset on every call, so after the
+       first few calls it doesn't allocate anymore. */
+    Implementation::FrameArena& storage = state.shapeStorage;
+    storage.reset();
+    const Containers::ArrayView<const Text::FeatureRange> features = featuresInternal(storage, style, properties);
+
+    /* If the shape cache is enabled, look up whether the same text was shaped
+       with the same properties recently. Editable texts need glyph clusters
+       and the resolved shape direction, wrapped texts glyph clusters as well,
+       which aren't cached, so they're always shaped again. */
+    const bool useShapeCache = !sharedState.shapeCache.isEmpty() && !(flags >= TextDataFlag::Editable) && !(flags >= TextDataFlag::Wrap);
+    UnsignedLong shapeCacheHash{};
+    if(useShapeCache) {
+        shapeCacheHash = shapeCacheKeyInto(sharedState.shapeCacheKey, font, alignment, properties, features, text);
+
+        ++sharedState.shapeCacheUsage;
+        if(Implementation::TextLayerShapeCacheEntry* const entry = findShapeCacheEntry(sharedState.shapeCache.prefix(sharedState.shapeCacheUsedCount), shapeCacheHash, sharedState.shapeCacheKey)) {
+            /* Found, copy the glyphs and a run referencing them. Any previous
+               run for this data was marked as unused in previous remove(), or
+               gets reused or marked as unused in replaceGlyphRunInternal()
+               right after calling this function. */
+            entry->lastUsed = sharedState.shapeCacheUsage;
+            Implementation::TextLayerData& data = state.data[id];
+            if(entry->hasRun) {
+                data.glyphRun = state.glyphRuns.size();
+                Implementation::TextLayerGlyphRun& run = arrayAppend(state.glyphRuns, NoInit, 1).front();
+                run.glyphOffset = state.glyphData.size();
+                run.glyphCount = entry->glyphData.size();
+                run.data = id;
+                run.scale = entry->scale;
+                arrayAppend(state.glyphData, entry->glyphData);
+            } else data.glyphRun = ~UnsignedInt{};
+            /* The entry may contain glyphs that are still pending, which get
+               resolved in doUpdate() */
+            if(sharedState.hasPendingGlyphs)
+                state.hasPendingGlyphs = true;
+            data.rectangle = entry->rectangle;
+            data.alignment = entry->alignment;
+            data.usedDirection = Text::ShapeDirection::Unspecified;
+            return;
+        }
+    }
 
     /* Get a shaper instance */
     if(!fontState.shaper)
         fontState.shaper = fontState.font->createShaper();
     Text::AbstractShaper& shaper = *fontState.shaper;
 
+    /* For multi-line editable texts, reuse shaping results of lines that
+       didn't change since the last time this text was shaped, so editing a
+       large text shapes just the edited lines. The previously recorded lines
+       are usable only if they were shaped with the same properties. */
+    Containers::Optional<LineShapeCacheShaper> lineShapeCacheShaper;
+    if(flags >= TextDataFlag::Editable) {
+        UnsignedInt lineCount = 1;
+        for(const char c: text)
+            if(c == '\n') ++lineCount;
+
+        if(lineCount > 1 && featuresCoverWholeText(features)) {
+            Implementation::TextLayerLineShapeCache& previous = state.lineShapeCache;
+            if(previous.data != id ||
+               previous.font != font ||
+               previous.script != properties._script ||
+               previous.direction != properties._direction ||
+               Containers::StringView{previous.language} != properties.language() ||
+               !featuresEqual(previous.features, features))
+                arrayResize(previous.lines, 0);
+
+            Implementation::TextLayerLineShapeCache& next = state.lineShapeCacheNext;
+            next.data = id;
+            next.font = font;
+            next.script = properties._script;
+            next.direction = properties._direction;
+            Utility::copy(properties._language, next.language);
+            arrayResize(next.features, NoInit, features.size());
+            Utility::copy(features, next.features);
+            lineShapeCacheShaper.emplace(shaper, previous, next, lineCount);
+
+        /* Otherwise, if the lines were recorded for this data, they're not
+           needed anymore */
+        } else if(state.lineShapeCache.data == id)
+            state.lineShapeCache.data = ~UnsignedInt{};
+    }
+    Text::AbstractShaper& renderShaper = lineShapeCacheShaper ? static_cast<Text::AbstractShaper&>(*lineShapeCacheShaper) : shaper;
+
     /* Remember where the glyph run for this data will appear when allocated by
        the renderer. Any previous run for this data was marked as unused in
-       previous remove() or in setText() right before calling this function. */
+       previous remove(), or gets reused or marked as unused in
+       replaceGlyphRunInternal() right after calling this function. */
     const UnsignedInt glyphOffset = state.glyphData.size();
     const UnsignedInt glyphRunOffset = state.glyphRuns.size();
 
     /* Pick a renderer instance based on whether we want to populate glyph
-       cluster info and reset() it to make it append to the end of
-       `state.glyphData` and `state.glyphRuns` as well as discarding any
-       previously used alignment or direction. */
-    Text::RendererCore& renderer = flags >= TextDataFlag::Editable ? state.rendererGlyphClusters : state.renderer;
+       cluster info, which is needed for both editable and wrapped text, and
+       reset() it to make it append to the end of `state.glyphData` and
+       `state.glyphRuns` as well as discarding any previously used alignment
+       or direction. */
+    Text::RendererCore& renderer = flags >= TextDataFlag::Editable || flags >= TextDataFlag::Wrap ? state.rendererGlyphClusters : state.renderer;
     renderer.reset();
 
     /* Set shaper properties and render the text with it */
     shaper.setScript(properties.script());
     shaper.setLanguage(properties.language());
     shaper.setDirection(properties.shapeDirection());
-    const Containers::Pair<Range2D, Range1Dui> rectangleRunRange = renderer
+    Containers::Pair<Range2D, Range1Dui> rectangleRunRange = renderer
         .setAlignment(alignment)
         .setLayoutDirection(properties.layoutDirection())
-        .render(shaper, fontState.scale*fontState.font->size(), text, features);
+        .render(renderShaper, fontState.scale*fontState.font->size(), text, features);
+
+    /* If glyphs are filled on demand and some aren't in the glyph cache, fill
+       them and render again, as the glyph IDs and possibly also the rectangle
+       are different now. The glyphs and runs from the first rendering are
+       discarded, reset() makes the renderer append to the end again. */
+    if(canFillGlyphCacheOnDemand(sharedState.flags, fontState)) {
+        bool hasMissingGlyphs = false;
+        for(const Implementation::TextLayerGlyphData& glyph: state.glyphData.exceptPrefix(glyphOffset)) {
+            if(!glyph.glyphId) {
+                hasMissingGlyphs = true;
+                break;
+            }
+        }
+
+        if(hasMissingGlyphs) {
+            shapeFontGlyphIdsInto(shaper, text, features, sharedState.glyphCacheFillFontGlyphIds);
+
+            /* With deferred filling the glyphs only get marked as pending and
+               get resolved in doUpdate(), without having to render again */
+            if(sharedState.flags >= TextLayerSharedFlag::GlyphCacheFillDeferred && canDeferGlyphCacheFill(sharedState.glyphCache, fontState)) {
+                deferGlyphCacheFill(sharedState.glyphCache, fontState, sharedState.glyphCacheFillFontGlyphIds, stridedArrayView(state.glyphData).exceptPrefix(glyphOffset).slice(&Implementation::TextLayerGlyphData::glyphId));
+                state.hasPendingGlyphs = true;
+                sharedState.hasPendingGlyphs = true;
+
+            } else if(fillGlyphCacheOnDemand(shared(), fontState, storage, sharedState.glyphCacheFillFontGlyphIds, sharedState.glyphCacheFillIds)) {
+                arrayResize(state.glyphData, NoInit, glyphOffset);
+                arrayResize(state.glyphRuns, NoInit, glyphRunOffset);
+                renderer.reset();
+                if(lineShapeCacheShaper)
+                    lineShapeCacheShaper->reset();
+                rectangleRunRange = renderer
+                    .setAlignment(alignment)
+                    .setLayoutDirection(properties.layoutDirection())
+                    .render(renderShaper, fontState.scale*fontState.font->size(), text, features);
+            }
+        }
+    }
 
     /* Fill in remaining properties for all runs allocated by the renderer. So
        far assuming there's either one or none at all if the text has no
@@ -1023,59 +1870,153 @@ void TextLayer::shapeTextInternal(const UnsignedInt id, const UnsignedInt style,
         dataGlyphOffset += run.glyphCount;
     }
 
+    /* The lines recorded for this text become the previous lines for the next
+       shaping */
+    if(lineShapeCacheShaper)
+        Utility::swap(state.lineShapeCache, state.lineShapeCacheNext);
+
     /* Save scale, rectangle, alignment resolved based on direction */
     Implementation::TextLayerData& data = state.data[id];
     data.rectangle = rectangleRunRange.first();
     data.alignment = Text::alignmentForDirection(alignment,
         properties.layoutDirection(),
-        shaper.direction());
+        renderShaper.direction());
     /* If the rendering resulted in no glyphs, there's no glyph run to
        reference */
     data.glyphRun =  rectangleRunRange.second().size() ? glyphRunOffset : ~UnsignedInt{};
 
+    /* If the text is wrapped, turn the clusters filled by the
+       `rendererGlyphClusters` above into break opportunities and remember the
+       line advance to use for the wrapped lines */
+    if(flags >= TextDataFlag::Wrap && data.glyphRun != ~UnsignedInt{}) {
+        Implementation::TextLayerGlyphRun& run = state.glyphRuns[data.glyphRun];
+        run.lineAdvance = fontState.font->lineHeight()*fontState.scale;
+        wrapBreaksInto(text, state.glyphData.sliceSize(run.glyphOffset, run.glyphCount));
+    }
+
     /* If the text is editable, its cluster info was filled by the
        `rendererGlyphClusters` above already. Save also the resolved shaper
        direction. */
     if(flags >= TextDataFlag::Editable) {
-        data.usedDirection = shaper.direction();
+        data.usedDirection = renderShaper.direction();
 
     /* If the text is not editable, reset the direction to prevent other code
        accidentally relying on some random value. The clusters aren't reset
        though, as that is extra overhead. */
     } else data.usedDirection = Text::ShapeDirection::Unspecified;
+
+    /* Save the shaped text to the cache, either to an unused entry or by
+       replacing the least recently used one. The entry arrays are growable in
+       order to reuse their allocations when replaced. */
+    if(useShapeCache) {
+        Implementation::TextLayerShapeCacheEntry& entry = shapeCacheEntryToReplace(sharedState.shapeCache, sharedState.shapeCacheUsedCount);
+        arrayResize(entry.key, NoInit, sharedState.shapeCacheKey.size());
+        Utility::copy(sharedState.shapeCacheKey, entry.key);
+        arrayResize(entry.glyphData, NoInit, state.glyphData.size() - glyphOffset);
+        Utility::copy(state.glyphData.exceptPrefix(glyphOffset), entry.glyphData);
+        entry.hash = shapeCacheHash;
+        entry.rectangle = data.rectangle;
+        entry.lastUsed = sharedState.shapeCacheUsage;
+        entry.hasRun = rectangleRunRange.second().size();
+        entry.scale = entry.hasRun ? state.glyphRuns[glyphRunOffset].scale : 0.0f;
+        entry.alignment = data.alignment;
+    }
 }
 
-void TextLayer::shapeRememberTextInternal(
+FontHandle TextLayer::fontInternal(
     #ifndef CORRADE_NO_ASSERT
     const char* const messagePrefix,
     #endif
-    const UnsignedInt id, const UnsignedInt style, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags)
+    const UnsignedInt style, const TextProperties& properties) const
 {
-    State& state = static_cast<State&>(*_state);
-    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+    const State& state = static_cast<const State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
 
-    /* Decide on a font */
     FontHandle font = properties.font();
     if(font == FontHandle::Null) {
         if(style < sharedState.styleCount) {
             CORRADE_ASSERT(sharedState.styles[style].font != FontHandle::Null,
-                messagePrefix << "style" << style << "has no font set and no custom font was supplied", );
+                messagePrefix << "style" << style << "has no font set and no custom font was supplied", FontHandle::Null);
             font = sharedState.styles[style].font;
         } else {
             CORRADE_INTERNAL_DEBUG_ASSERT(style < sharedState.styleCount + sharedState.dynamicStyleCount);
             font = state.dynamicStyles[style - sharedState.styleCount].font;
             CORRADE_ASSERT(font != FontHandle::Null,
-                messagePrefix << "dynamic style" << style - sharedState.styleCount << "has no font set and no custom font was supplied", );
+                messagePrefix << "dynamic style" << style - sharedState.styleCount << "has no font set and no custom font was supplied", FontHandle::Null);
         }
     } else CORRADE_ASSERT(Ui::isHandleValid(sharedState.fonts, font),
-        messagePrefix << "invalid handle" << font, );
+        messagePrefix << "invalid handle" << font, FontHandle::Null);
 
     CORRADE_ASSERT(sharedState.fonts[fontHandleId(font)].font,
-        messagePrefix << font << "is an instance-less font", );
+        messagePrefix << font << "is an instance-less font", FontHandle::Null);
+
+    return font;
+}
+
+void TextLayer::shapeRememberTextInternal(
+    #ifndef CORRADE_NO_ASSERT
+    const char* const messagePrefix,
+    #endif
+    const UnsignedInt id, const UnsignedInt style, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags, const Implementation::TextLayerShapeJob* const job)
+{
+    State& state = static_cast<State&>(*_state);
+
+    /* Decide on a font. It's null only if the assertions in fontInternal()
+       are graceful. */
+    const FontHandle font = fontInternal(
+        #ifndef CORRADE_NO_ASSERT
+        messagePrefix,
+        #endif
+        style, properties);
+    if(font == FontHandle::Null)
+        return;
+
+    CORRADE_ASSERT(!(flags >= (TextDataFlag::Editable|TextDataFlag::Wrap)),
+        messagePrefix << "cannot combine" << TextDataFlag::Editable << "and" << TextDataFlag::Wrap, );
+
+    /* If shaping is deferred, remember the text and its properties for
+       doUpdate() and mark the data as having no glyphs until then */
+    if(flags >= TextDataFlag::DeferShaping) {
+        CORRADE_ASSERT(!(flags >= TextDataFlag::Editable),
+            messagePrefix << "cannot combine" << TextDataFlag::Editable << "and" << TextDataFlag::DeferShaping, );
 
-    shapeTextInternal(id, style, text, properties, font, flags);
+        /* Add a new deferred text. Any previous text for this data was marked
+           as unused in previous remove() or in setText() before calling this
+           function. */
+        const UnsignedInt deferredText = state.deferredTexts.size();
+        const UnsignedInt textOffset = state.deferredTextData.size();
+        const UnsignedInt featureOffset = state.deferredFeatures.size();
+        arrayAppend(state.deferredTextData, text);
+        arrayAppend(state.deferredFeatures, properties.features());
+        Implementation::TextLayerDeferredText& deferred = arrayAppend(state.deferredTexts, NoInit, 1).front();
+        deferred.textOffset = textOffset;
+        deferred.textSize = text.size();
+        deferred.featureOffset = featureOffset;
+        deferred.featureCount = properties.features().size();
+        deferred.data = id;
+
+        /* Same as with text runs below */
+        Utility::copy(properties._language, deferred.language);
+        deferred.script = properties._script;
+        deferred.font = font;
+        deferred.alignment = properties._alignment;
+        deferred.direction = properties._direction;
+
+        Implementation::TextLayerData& data = state.data[id];
+        data.glyphRun = ~UnsignedInt{};
+        data.textRun = ~UnsignedInt{};
+        data.deferredText = deferredText;
+        data.rectangle = {};
+        data.alignment = alignmentInternal(style, properties);
+        data.usedDirection = Text::ShapeDirection::Unspecified;
+        data.flags = flags;
+        return;
+    }
+
+    shapeTextInternal(id, style, text, properties, font, flags, job);
 
     Implementation::TextLayerData& data = state.data[id];
+    data.deferredText = ~UnsignedInt{};
     data.flags = flags;
 
     /* If the text is meant to be editable, remember the input string */
@@ -1156,16 +2097,21 @@ void TextLayer::shapeGlyphInternal(
        TextProperties */
     const Text::Alignment resolvedAlignment = Text::alignmentForDirection(alignment, properties.layoutDirection(), properties.shapeDirection());
 
-    const Implementation::TextLayerFont& fontState = sharedState.fonts[fontHandleId(font)];
-    const Text::AbstractGlyphCache& glyphCache = sharedState.glyphCache;
+    Implementation::TextLayerFont& fontState = sharedState.fonts[fontHandleId(font)];
+    Text::AbstractGlyphCache& glyphCache = sharedState.glyphCache;
 
     CORRADE_ASSERT(glyphId < glyphCache.fontGlyphCount(fontState.glyphCacheFontId),
         messagePrefix << "glyph" << glyphId << "out of range for" << glyphCache.fontGlyphCount(fontState.glyphCacheFontId) << "glyphs in glyph cache font" << fontState.glyphCacheFontId, );
 
-    /* Query the glyph rectangle in order to align it. Compared to a regular
-       text run, where the glyphs might not be present in the glyph cache yet
-       (and can thus be filled in on-demand), here we require those to be
-       present upfront. */
+    /* If glyphs are filled on demand and this one isn't in the glyph cache
+       yet, fill it. Otherwise it's required to be present upfront. */
+    if(canFillGlyphCacheOnDemand(sharedState.flags, fontState) && !glyphCache.glyphId(fontState.glyphCacheFontId, glyphId)) {
+        const UnsignedInt glyphIds[]{glyphId};
+        if(!fillGlyphCache(shared(), fontState, glyphIds))
+            fontState.glyphCacheFillFailed = true;
+    }
+
+    /* Query the glyph rectangle in order to align it */
     const UnsignedInt cacheGlobalGlyphId = glyphCache.glyphId(fontState.glyphCacheFontId, glyphId);
     const Containers::Triple<Vector2i, Int, Range2Di> glyph = glyphCache.glyph(cacheGlobalGlyphId);
     const Range2D glyphRectangle = Range2D{Range2Di::fromSize(glyph.first(), glyph.third().size())}
@@ -1190,8 +2136,9 @@ void TextLayer::shapeGlyphInternal(
     }
 
     /* Add a new run containing just that one glyph. Any previous run for this
-       data was marked as unused in previous remove(), or in setGlyph() right
-       before calling this function. */
+       data was marked as unused in previous remove(), or gets reused or
+       marked as unused in replaceGlyphRunInternal() right after calling this
+       function. */
     const UnsignedInt glyphRun = state.glyphRuns.size();
     const UnsignedInt glyphOffset = state.glyphData.size();
     arrayAppend(state.glyphData, InPlaceInit,
@@ -1205,6 +2152,7 @@ void TextLayer::shapeGlyphInternal(
     data.alignment = resolvedAlignment;
     data.glyphRun = glyphRun;
     data.textRun = ~UnsignedInt{};
+    data.deferredText = ~UnsignedInt{};
     data.flags = {};
 }
 
@@ -1253,11 +2201,14 @@ DataHandle TextLayer::create(const UnsignedInt style, const Containers::StringVi
         #ifndef CORRADE_NO_ASSERT
         "Ui::TextLayer::create():",
         #endif
-        id, style, text, properties, flags);
+        id, style, text, properties, flags, nullptr);
     Implementation::TextLayerData& data = state.data[id];
     /* glyphRun, textRun and flags is filled by shapeRememberTextInternal() */
     data.style = style;
-    /* calculatedStyle is filled by AbstractVisualLayer::doUpdate() */
+    /* calculatedStyle is filled by AbstractVisualLayer::doUpdate(), but
+       initialize it to the style already so setCursor() can look at the
+       editing styles before the first update happens */
+    data.calculatedStyle = style;
     data.color = Color4{1.0f};
 
     return handle;
@@ -1302,18 +2253,106 @@ void TextLayer::remove(const LayerDataHandle handle) {
     removeInternal(layerDataHandleId(handle));
 }
 
+void TextLayer::removeGlyphRunInternal(const UnsignedInt glyphRun) {
+    State& state = static_cast<State&>(*_state);
+
+    /* Mark the glyph run as unused and remember how much space it occupies so
+       doUpdate() can decide whether it's worth recompacting */
+    Implementation::TextLayerGlyphRun& run = state.glyphRuns[glyphRun];
+    CORRADE_INTERNAL_DEBUG_ASSERT(run.glyphOffset != ~UnsignedInt{});
+    run.glyphOffset = ~UnsignedInt{};
+    ++state.unusedGlyphRunCount;
+    state.unusedGlyphCount += run.glyphCount;
+}
+
+void TextLayer::removeTextRunInternal(const UnsignedInt textRun) {
+    State& state = static_cast<State&>(*_state);
+
+    /* Same as removeGlyphRunInternal() above */
+    Implementation::TextLayerTextRun& run = state.textRuns[textRun];
+    CORRADE_INTERNAL_DEBUG_ASSERT(run.textOffset != ~UnsignedInt{});
+    run.textOffset = ~UnsignedInt{};
+    ++state.unusedTextRunCount;
+    state.unusedTextSize += run.textSize;
+}
+
+void TextLayer::removeDeferredTextInternal(const UnsignedInt deferredText) {
+    State& state = static_cast<State&>(*_state);
+
+    /* Same as removeGlyphRunInternal() above, except that only the count is
+       tracked, which is what doUpdate() uses to decide about recompaction */
+    Implementation::TextLayerDeferredText& deferred = state.deferredTexts[deferredText];
+    CORRADE_INTERNAL_DEBUG_ASSERT(deferred.textOffset != ~UnsignedInt{});
+    deferred.textOffset = ~UnsignedInt{};
+    ++state.unusedDeferredTextCount;
+}
+
+void TextLayer::replaceGlyphRunInternal(const UnsignedInt id, const UnsignedInt previousGlyphRun) {
+    State& state = static_cast<State&>(*_state);
+
+    /* If the data had no glyphs before, there's nothing to do. The run can
+       also stay the same if the shaping bailed early due to a graceful
+       assertion. */
+    Implementation::TextLayerData& data = state.data[id];
+    if(previousGlyphRun == ~UnsignedInt{} || previousGlyphRun == data.glyphRun)
+        return;
+
+    /* If the glyph data are large enough to not be recompacted on every
+       update and the newly shaped glyphs fit into the previous run, copy them
+       there and discard the newly added run, which is always at the very end
+       of both arrays. This avoids fragmentation when a text is repeatedly
+       replaced with a string of the same length, such as with live counters
+       or clocks. For small data it's better to always put the new run at the
+       end instead, as the recompaction is cheap and this way the often
+       updated data get clustered at the end, allowing potential savings in
+       data upload. */
+    Implementation::TextLayerGlyphRun& previousRun = state.glyphRuns[previousGlyphRun];
+    if(data.glyphRun != ~UnsignedInt{} && state.glyphData.size() >= Implementation::RunCompactionMinSize) {
+        const Implementation::TextLayerGlyphRun run = state.glyphRuns[data.glyphRun];
+        CORRADE_INTERNAL_DEBUG_ASSERT(data.glyphRun == state.glyphRuns.size() - 1 && run.glyphOffset + run.glyphCount == state.glyphData.size());
+        if(run.glyphCount <= previousRun.glyphCount) {
+            Utility::copy(state.glyphData.sliceSize(run.glyphOffset, run.glyphCount),
+                          state.glyphData.sliceSize(previousRun.glyphOffset, run.glyphCount));
+            /* If the new text is shorter, the rest of the previous run becomes
+               unused space */
+            state.unusedGlyphCount += previousRun.glyphCount - run.glyphCount;
+            previousRun.glyphCount = run.glyphCount;
+            previousRun.scale = run.scale;
+            previousRun.lineAdvance = run.lineAdvance;
+            arrayResize(state.glyphData, run.glyphOffset);
+            arrayResize(state.glyphRuns, data.glyphRun);
+            data.glyphRun = previousGlyphRun;
+            return;
+        }
+    }
+
+    /* Otherwise mark the previous run as unused. It'll be removed during the
+       next recompaction in doUpdate(). */
+    removeGlyphRunInternal(previousGlyphRun);
+}
+
 void TextLayer::removeInternal(const UnsignedInt id) {
     State& state = static_cast<State&>(*_state);
 
     /* Mark the glyph run as unused. It'll be removed during the next
        recompaction in doUpdate(). */
     if(state.data[id].glyphRun != ~UnsignedInt{})
-        state.glyphRuns[state.data[id].glyphRun].glyphOffset = ~UnsignedInt{};
+        removeGlyphRunInternal(state.data[id].glyphRun);
 
     /* If there's a text run, mark it as unused as well; it'll be removed in
        doUpdate() too */
     if(state.data[id].textRun != ~UnsignedInt{})
-        state.textRuns[state.data[id].textRun].textOffset = ~UnsignedInt{};
+        removeTextRunInternal(state.data[id].textRun);
+
+    /* Same for a text that wasn't shaped yet */
+    if(state.data[id].deferredText != ~UnsignedInt{})
+        removeDeferredTextInternal(state.data[id].deferredText);
+
+    /* If the lines of the most recently shaped multi-line editable text are
+       for this data, discard them so they don't get used for a different text
+       that reuses the same ID */
+    if(state.lineShapeCache.data == id)
+        state.lineShapeCache.data = ~UnsignedInt{};
 
     /* Data removal doesn't need anything to be reuploaded to continue working
        correctly, thus setNeedsUpdate() isn't called.
@@ -1416,11 +2455,86 @@ void TextLayer::setCursorInternal(const UnsignedInt id, const UnsignedInt positi
     CORRADE_ASSERT(selection <= run.textSize,
         "Ui::TextLayer::setCursor(): selection" << selection << "out of range for a text of" << run.textSize << "bytes", );
 
-    if(position != run.cursor || selection != run.selection) {
-        run.cursor = position;
-        run.selection = selection;
+    if(position == run.cursor && selection == run.selection)
+        return;
+
+    /* If the currently used style has no cursor style and the selection is
+       either not visible at all or stays empty, the change doesn't affect
+       anything that's drawn. In that case skip the data update, which would
+       otherwise regenerate vertices of the whole layer on every cursor
+       movement. Any subsequent style or node state change regenerates the
+       editing quads from the current cursor state anyway, so nothing gets
+       lost. */
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+    bool hasCursorStyle, hasSelectionStyle;
+    if(data.calculatedStyle < sharedState.styleCount) {
+        const Implementation::TextLayerStyle& style = sharedState.styles[data.calculatedStyle];
+        hasCursorStyle = style.cursorStyle != -1;
+        hasSelectionStyle = style.selectionStyle != -1;
+    } else {
+        CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
+        const UnsignedInt dynamicStyleId = data.calculatedStyle - sharedState.styleCount;
+        hasCursorStyle = state.dynamicStyleCursorStyles[dynamicStyleId];
+        hasSelectionStyle = state.dynamicStyleSelectionStyles[dynamicStyleId];
+    }
+    const bool visible = hasCursorStyle || (hasSelectionStyle &&
+        (run.cursor != run.selection || position != selection));
+
+    run.cursor = position;
+    run.selection = selection;
+    if(visible)
         setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+UnsignedInt TextLayer::cursorForPositionInternal(const UnsignedInt id, const Vector2& position, const Vector2& nodeSize) const {
+    const State& state = static_cast<const State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+    const Implementation::TextLayerData& data = state.data[id];
+    CORRADE_INTERNAL_DEBUG_ASSERT(data.textRun != ~UnsignedInt{});
+    const Implementation::TextLayerTextRun& textRun = state.textRuns[data.textRun];
+    if(data.glyphRun == ~UnsignedInt{})
+        return textRun.textSize;
+
+    /* Calculate the aligned text origin the same way as doUpdate() does.
+       Editable text can't be on a Transformable layer, so there's always the
+       per-data padding. */
+    Vector4 padding = data.padding;
+    if(data.calculatedStyle < sharedState.styleCount)
+        padding += sharedState.styles[data.calculatedStyle].padding;
+    else {
+        CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
+        padding += state.dynamicStyles[data.calculatedStyle - sharedState.styleCount].padding;
     }
+    const Vector2 size = nodeSize - padding.xy() - Math::gather<'z', 'w'>(padding);
+    const Float x = position.x() - padding.x() - alignmentOffset(data.alignment, size).x();
+
+    /* Editable text is a single line and the cursor is drawn at the glyph
+       X position, or at the end of the text rectangle for a cursor after the
+       last glyph. As the positions are increasing, find the first glyph that
+       starts after the pointer with a binary search, and then pick the
+       closer of it and the glyph before. */
+    const Implementation::TextLayerGlyphRun& glyphRun = state.glyphRuns[data.glyphRun];
+    const Containers::ArrayView<const Implementation::TextLayerGlyphData> glyphData = state.glyphData.sliceSize(glyphRun.glyphOffset, glyphRun.glyphCount);
+    std::size_t begin = 0;
+    std::size_t end = glyphData.size();
+    while(begin < end) {
+        const std::size_t middle = begin + (end - begin)/2;
+        if(glyphData[middle].position.x() <= x)
+            begin = middle + 1;
+        else
+            end = middle;
+    }
+    std::size_t glyph = begin;
+    if(glyph != 0) {
+        const Float left = glyphData[glyph - 1].position.x();
+        const Float right = glyph == glyphData.size() ?
+            data.rectangle.max().x() : glyphData[glyph].position.x();
+        if(x - left < right - x)
+            --glyph;
+    }
+
+    return glyph == glyphData.size() ?
+        textRun.textSize : glyphData[glyph].glyphCluster;
 }
 
 TextProperties TextLayer::textProperties(const DataHandle handle) const {
@@ -1479,58 +2593,254 @@ Containers::StringView TextLayer::textInternal(const UnsignedInt id) const {
                                     state.textRuns[data.textRun].textSize);
 }
 
-void TextLayer::setText(const DataHandle handle, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags) {
-    CORRADE_ASSERT(isHandleValid(handle),
-        "Ui::TextLayer::setText(): invalid handle" << handle, );
-    setTextInternal(dataHandleId(handle), text, properties, flags);
-}
+void TextLayer::setText(const DataHandle handle, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::setText(): invalid handle" << handle, );
+    setTextInternal(dataHandleId(handle), text, properties, flags, nullptr);
+}
+
+void TextLayer::setText(const DataHandle handle, const Containers::StringView text, const TextProperties& properties) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::setText(): invalid handle" << handle, );
+    setTextInternal(dataHandleId(handle), text, properties, static_cast<const State&>(*_state).data[dataHandleId(handle)].flags, nullptr);
+}
+
+void TextLayer::setText(const LayerDataHandle handle, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::setText(): invalid handle" << handle, );
+    setTextInternal(layerDataHandleId(handle), text, properties, flags, nullptr);
+}
+
+void TextLayer::setText(const LayerDataHandle handle, const Containers::StringView text, const TextProperties& properties) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::setText(): invalid handle" << handle, );
+    setTextInternal(layerDataHandleId(handle), text, properties, static_cast<const State&>(*_state).data[layerDataHandleId(handle)].flags, nullptr);
+}
+
+void TextLayer::setTextInternal(const UnsignedInt id, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags, const Implementation::TextLayerShapeJob* const job) {
+    State& state = static_cast<State&>(*_state);
+    /* Can only get fired by the setText() overloads with an explicit flags
+       parameter, not when it's passed from the existing data itself. It's
+       however put here to avoid logic duplication. */
+    CORRADE_ASSERT(!(state.flags >= TextLayerFlag::Transformable) || !(flags >= TextDataFlag::Editable),
+        "Ui::TextLayer::setText(): cannot use" << TextDataFlag::Editable << "on a" << TextLayerFlag::Transformable << "layer", );
+
+    Implementation::TextLayerData& data = state.data[id];
+
+    /* If the text has any glyphs, remember the original glyph run. It either
+       gets reused for the new glyphs or marked as unused after shaping. */
+    const UnsignedInt previousGlyphRun = data.glyphRun;
+
+    /* If there's a text run, mark it as unused; it'll be removed during the
+       next recompaction in doUpdate() */
+    if(state.data[id].textRun != ~UnsignedInt{})
+        removeTextRunInternal(state.data[id].textRun);
+
+    /* Similarly for a text that's deferred to be shaped later */
+    if(state.data[id].deferredText != ~UnsignedInt{}) {
+        removeDeferredTextInternal(state.data[id].deferredText);
+        state.data[id].deferredText = ~UnsignedInt{};
+    }
+
+    /* Shape the text, save its properties and optionally also the source
+       string if it's editable or deferred; mark the layer as needing an
+       update */
+    shapeRememberTextInternal(
+        #ifndef CORRADE_NO_ASSERT
+        "Ui::TextLayer::setText():",
+        #endif
+        id, data.style, text, properties, flags, job);
+    replaceGlyphRunInternal(id, previousGlyphRun);
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void TextLayer::setText(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& properties) {
+    CORRADE_ASSERT(texts.size() == handles.size() && properties.size() == handles.size(),
+        "Ui::TextLayer::setText(): expected handle, text and property views to have the same size but got" << handles.size() << Debug::nospace << "," << texts.size() << "and" << properties.size(), );
+    State& state = static_cast<State&>(*_state);
+
+    /* Check all handles first to not end up with just a part of the texts
+       set */
+    arrayResize(state.shapeJobIds, NoInit, handles.size());
+    for(std::size_t i = 0; i != handles.size(); ++i) {
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::TextLayer::setText(): invalid handle" << handles[i] << "at index" << i, );
+        state.shapeJobIds[i] = dataHandleId(handles[i]);
+    }
+
+    setTextsInternal(state.shapeJobIds, texts, properties);
+}
+
+void TextLayer::setText(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& properties) {
+    CORRADE_ASSERT(texts.size() == handles.size() && properties.size() == handles.size(),
+        "Ui::TextLayer::setText(): expected handle, text and property views to have the same size but got" << handles.size() << Debug::nospace << "," << texts.size() << "and" << properties.size(), );
+    State& state = static_cast<State&>(*_state);
+
+    /* Same as above */
+    arrayResize(state.shapeJobIds, NoInit, handles.size());
+    for(std::size_t i = 0; i != handles.size(); ++i) {
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::TextLayer::setText(): invalid handle" << handles[i] << "at index" << i, );
+        state.shapeJobIds[i] = layerDataHandleId(handles[i]);
+    }
+
+    setTextsInternal(state.shapeJobIds, texts, properties);
+}
+
+void TextLayer::setTextsInternal(const Containers::ArrayView<const UnsignedInt> ids, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& properties) {
+    State& state = static_cast<State&>(*_state);
+    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+
+    /* Calculate how much to reserve */
+    std::size_t textSize = 0;
+    std::size_t editableCount = 0;
+    std::size_t editableTextSize = 0;
+    for(std::size_t i = 0; i != ids.size(); ++i) {
+        const std::size_t size = texts[i].size();
+        textSize += size;
+        if(state.data[ids[i]].flags >= TextDataFlag::Editable) {
+            ++editableCount;
+            editableTextSize += size;
+        }
+    }
+    reserveTextsInternal(ids.size(), textSize, editableCount, editableTextSize);
+
+    /* If there's no executor or just a single shaper, or there's nothing to
+       parallelize, shape everything serially */
+    if(!sharedState.shapeExecutor || sharedState.shaperCount == 1 || ids.size() < 2) {
+        for(std::size_t i = 0; i != ids.size(); ++i)
+            setTextInternal(ids[i], texts[i], properties[i], state.data[ids[i]].flags, nullptr);
+        return;
+    }
+
+    /* Otherwise, first resolve the font, alignment and features for all texts
+       serially. If the assertions in fontInternal() are graceful, bail before
+       anything is shaped. */
+    const UnsignedInt taskCount = UnsignedInt(Math::min(std::size_t{sharedState.shaperCount}, ids.size()));
+    arrayResize(state.shapeJobs, NoInit, ids.size());
+    state.shapeJobStorage.reset();
+    for(std::size_t i = 0; i != ids.size(); ++i) {
+        const UnsignedInt style = state.data[ids[i]].style;
+        Implementation::TextLayerShapeJob& job = state.shapeJobs[i];
+        job.font = fontInternal(
+            #ifndef CORRADE_NO_ASSERT
+            "Ui::TextLayer::setText():",
+            #endif
+            style, properties[i]);
+        if(job.font == FontHandle::Null)
+            return;
+        job.alignment = alignmentInternal(style, properties[i]);
+        job.features = featuresInternal(state.shapeJobStorage, style, properties[i]);
+        job.worker = i % taskCount;
+
+        /* Create a dedicated shaper instance for each task if not already */
+        Implementation::TextLayerFont& fontState = sharedState.fonts[fontHandleId(job.font)];
+        if(fontState.concurrentShapers.size() < taskCount) {
+            const std::size_t existingCount = fontState.concurrentShapers.size();
+            arrayResize(fontState.concurrentShapers, taskCount);
+            for(Containers::Pointer<Text::AbstractShaper>& shaper: fontState.concurrentShapers.exceptPrefix(existingCount))
+                shaper = fontState.font->createShaper();
+        }
+    }
 
-void TextLayer::setText(const DataHandle handle, const Containers::StringView text, const TextProperties& properties) {
-    CORRADE_ASSERT(isHandleValid(handle),
-        "Ui::TextLayer::setText(): invalid handle" << handle, );
-    setTextInternal(dataHandleId(handle), text, properties, static_cast<const State&>(*_state).data[dataHandleId(handle)].flags);
-}
+    /* Create the workers if not already. They're allocated all at once for
+       the max shaper count as the renderers reference them and thus they
+       can't be moved anymore. */
+    if(state.shapeWorkers.isEmpty()) {
+        state.shapeWorkers = Containers::Array<Implementation::TextLayerShapeWorker>{sharedState.shaperCount};
+        for(Implementation::TextLayerShapeWorker& worker: state.shapeWorkers)
+            worker.renderer = Text::RendererCore{sharedState.glyphCache,
+                glyphAllocator<Implementation::TextLayerShapeWorker>, &worker,
+                runAllocator<Implementation::TextLayerShapeWorker>, &worker,
+                Text::RendererCoreFlag::GlyphClusters};
+    }
+    for(Implementation::TextLayerShapeWorker& worker: state.shapeWorkers.prefix(taskCount)) {
+        arrayResize(worker.glyphData, 0);
+        arrayResize(worker.glyphRuns, 0);
+    }
 
-void TextLayer::setText(const LayerDataHandle handle, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags) {
-    CORRADE_ASSERT(isHandleValid(handle),
-        "Ui::TextLayer::setText(): invalid handle" << handle, );
-    setTextInternal(layerDataHandleId(handle), text, properties, flags);
-}
+    /* Shape the texts concurrently, each task with its own shaper instances,
+       renderer and output glyph data. Task `j` processes every `taskCount`th
+       text starting at `j`. */
+    struct TaskState {
+        State& state;
+        Containers::ArrayView<const UnsignedInt> ids;
+        const Containers::StringIterable& texts;
+        const Containers::StridedArrayView1D<const TextProperties>& properties;
+        UnsignedInt taskCount;
+    } taskState{state, ids, texts, properties, taskCount};
+    sharedState.shapeExecutor(taskCount, [](void* const data, const std::size_t task) {
+        const TaskState& taskState = *static_cast<const TaskState*>(data);
+        State& state = taskState.state;
+        Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+        Implementation::TextLayerShapeWorker& worker = state.shapeWorkers[task];
+        for(std::size_t i = task; i < taskState.ids.size(); i += taskState.taskCount) {
+            /* Texts with deferred shaping get only remembered in
+               setTextInternal() below, there's nothing to do for them here */
+            if(state.data[taskState.ids[i]].flags >= TextDataFlag::DeferShaping)
+                continue;
 
-void TextLayer::setText(const LayerDataHandle handle, const Containers::StringView text, const TextProperties& properties) {
-    CORRADE_ASSERT(isHandleValid(handle),
-        "Ui::TextLayer::setText(): invalid handle" << handle, );
-    setTextInternal(layerDataHandleId(handle), text, properties, static_cast<const State&>(*_state).data[layerDataHandleId(handle)].flags);
+            Implementation::TextLayerShapeJob& job = state.shapeJobs[i];
+            const TextProperties& properties = taskState.properties[i];
+            Implementation::TextLayerFont& fontState = sharedState.fonts[fontHandleId(job.font)];
+            Text::AbstractShaper& shaper = *fontState.concurrentShapers[task];
+
+            const UnsignedInt glyphOffset = worker.glyphData.size();
+            const UnsignedInt glyphRunOffset = worker.glyphRuns.size();
+            worker.renderer.reset();
+            shaper.setScript(properties.script());
+            shaper.setLanguage(properties.language());
+            shaper.setDirection(properties.shapeDirection());
+            const Containers::Pair<Range2D, Range1Dui> rectangleRunRange = worker.renderer
+                .setAlignment(job.alignment)
+                .setLayoutDirection(properties.layoutDirection())
+                .render(shaper, fontState.scale*fontState.font->size(), taskState.texts[i], job.features);
+
+            /* Same assumption as in shapeTextInternal(), there's either one
+               run or none */
+            CORRADE_INTERNAL_ASSERT(rectangleRunRange.second().size() <= 1);
+            job.direction = shaper.direction();
+            job.hasRun = rectangleRunRange.second().size();
+            job.rectangle = rectangleRunRange.first();
+            job.glyphOffset = glyphOffset;
+            job.glyphCount = worker.glyphData.size() - glyphOffset;
+            job.scale = job.hasRun ? worker.glyphRuns[glyphRunOffset].scale : 0.0f;
+        }
+    }, &taskState);
+
+    /* Merge the results serially in the order the texts were passed in, so
+       the outcome is the same as if shaped serially */
+    for(std::size_t i = 0; i != ids.size(); ++i)
+        setTextInternal(ids[i], texts[i], properties[i], state.data[ids[i]].flags, &state.shapeJobs[i]);
 }
 
-void TextLayer::setTextInternal(const UnsignedInt id, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags) {
+void TextLayer::reserveTextsInternal(const std::size_t count, const std::size_t textSize, const std::size_t editableCount, const std::size_t editableTextSize) {
     State& state = static_cast<State&>(*_state);
-    /* Can only get fired by the setText() overloads with an explicit flags
-       parameter, not when it's passed from the existing data itself. It's
-       however put here to avoid logic duplication. */
-    CORRADE_ASSERT(!(state.flags >= TextLayerFlag::Transformable) || !(flags >= TextDataFlag::Editable),
-        "Ui::TextLayer::setText(): cannot use" << TextDataFlag::Editable << "on a" << TextLayerFlag::Transformable << "layer", );
-
-    Implementation::TextLayerData& data = state.data[id];
 
-    /* If the text has any glyphs, mark the original glyph run as unused. It'll
-       be removed during the next recompaction in doUpdate(). */
-    if(data.glyphRun != ~UnsignedInt{})
-        state.glyphRuns[data.glyphRun].glyphOffset = ~UnsignedInt{};
+    /* The glyph count isn't known until the text is shaped, but the text size
+       in bytes is an upper bound for most scripts, with exceptions being for
+       example decomposed characters. The texts may also reuse their previous
+       runs in place, in which case this overestimates, but the reservation
+       only ever grows the capacity so it's done at most once for a stable
+       workload. */
+    arrayReserve(state.glyphData, state.glyphData.size() + textSize);
+    arrayReserve(state.glyphRuns, state.glyphRuns.size() + count);
+    if(editableCount) {
+        arrayReserve(state.textData, state.textData.size() + editableTextSize);
+        arrayReserve(state.textRuns, state.textRuns.size() + editableCount);
+    }
+}
 
-    /* If there's a text run, mark it as unused as well; it'll be removed in
-       doUpdate() too */
-    if(state.data[id].textRun != ~UnsignedInt{})
-        state.textRuns[state.data[id].textRun].textOffset = ~UnsignedInt{};
+void TextLayer::reserveGlyphs(const std::size_t glyphCount, const std::size_t runCount) {
+    State& state = static_cast<State&>(*_state);
+    arrayReserve(state.glyphData, state.glyphData.size() + glyphCount);
+    arrayReserve(state.glyphRuns, state.glyphRuns.size() + runCount);
+}
 
-    /* Shape the text, save its properties and optionally also the source
-       string if it's editable; mark the layer as needing an update */
-    shapeRememberTextInternal(
-        #ifndef CORRADE_NO_ASSERT
-        "Ui::TextLayer::setText():",
-        #endif
-        id, data.style, text, properties, flags);
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+void TextLayer::reserveText(const std::size_t textSize, const std::size_t runCount) {
+    State& state = static_cast<State&>(*_state);
+    arrayReserve(state.textData, state.textData.size() + textSize);
+    arrayReserve(state.textRuns, state.textRuns.size() + runCount);
 }
 
 void TextLayer::updateText(const DataHandle handle, const UnsignedInt removeOffset, const UnsignedInt removeSize, const UnsignedInt insertOffset, const Containers::StringView insertText, const UnsignedInt cursor, const UnsignedInt selection) {
@@ -1659,7 +2969,7 @@ void TextLayer::updateTextInternal(const UnsignedInt id, const UnsignedInt remov
     /* Mark the previous run (potentially reallocated somewhere) as unused.
        It'll be removed during the next recompaction run in doUpdate(). Save
        the new run reference. */
-    state.textRuns[data.textRun].textOffset = ~UnsignedInt{};
+    removeTextRunInternal(data.textRun);
     data.textRun = textRun;
 
     /* Shape the new text using properties saved in the run and mark the layer
@@ -1676,7 +2986,9 @@ void TextLayer::updateTextInternal(const UnsignedInt id, const UnsignedInt remov
     /* Similarly, the direction is both the layout and shape directions
        together, verbatim copy them back */
     properties._direction = run.direction;
-    shapeTextInternal(id, data.style, text, properties, run.font, data.flags);
+    const UnsignedInt previousGlyphRun = data.glyphRun;
+    shapeTextInternal(id, data.style, text, properties, run.font, data.flags, nullptr);
+    replaceGlyphRunInternal(id, previousGlyphRun);
 
     /* Update the cursor position and all related state */
     setCursorInternal(id, cursor, selection);
@@ -1847,19 +3159,21 @@ void TextLayer::setGlyphInternal(const UnsignedInt id, const UnsignedInt glyph,
     State& state = static_cast<State&>(*_state);
     Implementation::TextLayerData& data = state.data[id];
 
-    /* If the text has any glyphs, mark the original glyph run as unused. It'll
-       be removed during the next recompaction in doUpdate(). We could also
-       just reuse the offset in case the original run was 1 glyph or more (and
-       setTextInternal() could do that too), but this way makes the
-       often-updated data clustered to the end, allowing potential savings in
-       data upload. */
-    if(data.glyphRun != ~UnsignedInt{})
-        state.glyphRuns[data.glyphRun].glyphOffset = ~UnsignedInt{};
+    /* If the text has any glyphs, remember the original glyph run. Same as in
+       setTextInternal(), it either gets reused for the new glyph or marked as
+       unused after shaping. */
+    const UnsignedInt previousGlyphRun = data.glyphRun;
 
-    /* If there's a text run, mark it as unused as well; it'll be removed in
-       doUpdate() too */
+    /* If there's a text run, mark it as unused; it'll be removed during the
+       next recompaction in doUpdate() */
     if(state.data[id].textRun != ~UnsignedInt{})
-        state.textRuns[state.data[id].textRun].textOffset = ~UnsignedInt{};
+        removeTextRunInternal(state.data[id].textRun);
+
+    /* Similarly for a text that's deferred to be shaped later */
+    if(state.data[id].deferredText != ~UnsignedInt{}) {
+        removeDeferredTextInternal(state.data[id].deferredText);
+        state.data[id].deferredText = ~UnsignedInt{};
+    }
 
     /* Shape the glyph, mark the layer as needing an update */
     shapeGlyphInternal(
@@ -1867,6 +3181,7 @@ void TextLayer::setGlyphInternal(const UnsignedInt id, const UnsignedInt glyph,
         "Ui::TextLayer::setGlyph():",
         #endif
         id, data.style, glyph, properties);
+    replaceGlyphRunInternal(id, previousGlyphRun);
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
@@ -1899,6 +3214,45 @@ void TextLayer::setColorInternal(const UnsignedInt id, const Color4& color) {
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+void TextLayer::setColor(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors) {
+    CORRADE_ASSERT(colors.size() == handles.size(),
+        "Ui::TextLayer::setColor(): expected handle and color views to have the same size but got" << handles.size() << "and" << colors.size(), );
+    /* Check all handles first to not end up with just a part of the data
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::TextLayer::setColor(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[dataHandleId(handles[i])].color = colors[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void TextLayer::setColor(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors) {
+    CORRADE_ASSERT(colors.size() == handles.size(),
+        "Ui::TextLayer::setColor(): expected handle and color views to have the same size but got" << handles.size() << "and" << colors.size(), );
+    /* Same as above */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::TextLayer::setColor(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[layerDataHandleId(handles[i])].color = colors[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 Vector4 TextLayer::padding(const DataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::TextLayer::padding(): invalid handle" << handle, {});
@@ -1938,6 +3292,49 @@ void TextLayer::setPaddingInternal(const UnsignedInt id, const Vector4& padding)
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
+void TextLayer::setPadding(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& paddings) {
+    CORRADE_ASSERT(paddings.size() == handles.size(),
+        "Ui::TextLayer::setPadding(): expected handle and padding views to have the same size but got" << handles.size() << "and" << paddings.size(), );
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(!(state.flags >= TextLayerFlag::Transformable),
+        "Ui::TextLayer::setPadding(): per-data padding not available on a" << TextLayerFlag::Transformable << "layer", );
+    /* Check all handles first to not end up with just a part of the data
+       updated */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::TextLayer::setPadding(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[dataHandleId(handles[i])].padding = paddings[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void TextLayer::setPadding(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& paddings) {
+    CORRADE_ASSERT(paddings.size() == handles.size(),
+        "Ui::TextLayer::setPadding(): expected handle and padding views to have the same size but got" << handles.size() << "and" << paddings.size(), );
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(!(state.flags >= TextLayerFlag::Transformable),
+        "Ui::TextLayer::setPadding(): per-data padding not available on a" << TextLayerFlag::Transformable << "layer", );
+    /* Same as above */
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::TextLayer::setPadding(): invalid handle" << handles[i] << "at index" << i, );
+    #endif
+
+    if(handles.isEmpty())
+        return;
+
+    for(std::size_t i = 0; i != handles.size(); ++i)
+        state.data[layerDataHandleId(handles[i])].padding = paddings[i];
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
 Containers::Pair<Vector2, Complex> TextLayer::transformation(const DataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::TextLayer::transformation(): invalid handle" << handle, {});
@@ -1983,7 +3380,10 @@ void TextLayer::setTransformationInternal(const UnsignedInt id, const Vector2& t
     CORRADE_ASSERT(state.flags >= TextLayerFlag::Transformable,
         "Ui::TextLayer::setTransformation(): layer isn't" << TextLayerFlag::Transformable, );
     state.data[id].transformation = {translation, rotation*scaling};
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    /* With shader transformation the glyph vertices don't depend on the
+       transformation, so only the transformations get updated */
+    setNeedsUpdate(static_cast<const Shared::State&>(state.shared).flags >= TextLayerSharedFlag::ShaderTransformation ?
+        LayerState::NeedsCommonDataUpdate : LayerState::NeedsDataUpdate);
 }
 
 void TextLayer::translate(const DataHandle handle, const Vector2& translation) {
@@ -2003,7 +3403,8 @@ void TextLayer::translateInternal(const UnsignedInt id, const Vector2& translati
     CORRADE_ASSERT(state.flags >= TextLayerFlag::Transformable,
         "Ui::TextLayer::translate(): layer isn't" << TextLayerFlag::Transformable, );
     state.data[id].transformation.translation += translation;
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    setNeedsUpdate(static_cast<const Shared::State&>(state.shared).flags >= TextLayerSharedFlag::ShaderTransformation ?
+        LayerState::NeedsCommonDataUpdate : LayerState::NeedsDataUpdate);
 }
 
 void TextLayer::rotate(const DataHandle handle, const Complex& rotation) {
@@ -2032,7 +3433,8 @@ void TextLayer::rotateInternal(const UnsignedInt id, const Complex& rotation) {
         "Ui::TextLayer::rotate(): layer isn't" << TextLayerFlag::Transformable, );
     Implementation::TextLayerData::Transformation& transformation = state.data[id].transformation;
     transformation.rotationScaling = rotation*transformation.rotationScaling;
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    setNeedsUpdate(static_cast<const Shared::State&>(state.shared).flags >= TextLayerSharedFlag::ShaderTransformation ?
+        LayerState::NeedsCommonDataUpdate : LayerState::NeedsDataUpdate);
 }
 
 void TextLayer::scale(const DataHandle handle, const Float scaling) {
@@ -2052,13 +3454,109 @@ void TextLayer::scaleInternal(const UnsignedInt id, const Float scaling) {
     CORRADE_ASSERT(state.flags >= TextLayerFlag::Transformable,
         "Ui::TextLayer::scale(): layer isn't" << TextLayerFlag::Transformable, );
     state.data[id].transformation.rotationScaling *= scaling;
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    setNeedsUpdate(static_cast<const Shared::State&>(state.shared).flags >= TextLayerSharedFlag::ShaderTransformation ?
+        LayerState::NeedsCommonDataUpdate : LayerState::NeedsDataUpdate);
 }
 
 LayerFeatures TextLayer::doFeatures() const {
     return AbstractVisualLayer::doFeatures()|(static_cast<const Shared::State&>(_state->shared).dynamicStyleCount ? LayerFeature::AnimateStyles : LayerFeatures{})|LayerFeature::Draw;
 }
 
+LayerEvents TextLayer::doEvents() const {
+    return AbstractVisualLayer::doEvents()|LayerEvent::Key|LayerEvent::TextInput;
+}
+
+MemoryUsage TextLayer::doMemoryUsage() const {
+    const State& state = static_cast<const State&>(*_state);
+    MemoryUsage out = AbstractVisualLayer::doMemoryUsage();
+    Implementation::addArrayMemoryUsage(out, state.glyphData);
+    Implementation::addArrayMemoryUsage(out, state.textData);
+    Implementation::addArrayMemoryUsage(out, state.shapeStorage);
+    Implementation::addArrayMemoryUsage(out, state.shapeJobIds);
+    Implementation::addArrayMemoryUsage(out, state.shapeJobs);
+    Implementation::addArrayMemoryUsage(out, state.shapeJobStorage);
+    for(const Implementation::TextLayerShapeWorker& worker: state.shapeWorkers) {
+        Implementation::addArrayMemoryUsage(out, worker.glyphData);
+        Implementation::addArrayMemoryUsage(out, worker.glyphRuns);
+    }
+    Implementation::addArrayMemoryUsage(out, state.shapeWorkers);
+    for(const Implementation::TextLayerLineShapeCache* cache: {&state.lineShapeCache, &state.lineShapeCacheNext}) {
+        Implementation::addArrayMemoryUsage(out, cache->features);
+        Implementation::addArrayMemoryUsage(out, cache->lines);
+        Implementation::addArrayMemoryUsage(out, cache->text);
+        Implementation::addArrayMemoryUsage(out, cache->glyphIds);
+        Implementation::addArrayMemoryUsage(out, cache->glyphOffsets);
+        Implementation::addArrayMemoryUsage(out, cache->glyphAdvances);
+        Implementation::addArrayMemoryUsage(out, cache->glyphClusters);
+    }
+    Implementation::addArrayMemoryUsage(out, state.glyphRuns);
+    Implementation::addArrayMemoryUsage(out, state.textRuns);
+    Implementation::addArrayMemoryUsage(out, state.deferredTexts);
+    Implementation::addArrayMemoryUsage(out, state.deferredTextData);
+    Implementation::addArrayMemoryUsage(out, state.deferredFeatures);
+    Implementation::addArrayMemoryUsage(out, state.data);
+    Implementation::addArrayMemoryUsage(out, state.vertices);
+    Implementation::addArrayMemoryUsage(out, state.editingVertices);
+    Implementation::addArrayMemoryUsage(out, state.indices);
+    Implementation::addArrayMemoryUsage(out, state.editingIndices);
+    Implementation::addArrayMemoryUsage(out, state.indexDrawOffsets);
+    Implementation::addArrayMemoryUsage(out, state.dataOffsets);
+    Implementation::addArrayMemoryUsage(out, state.dataTransformations);
+    Implementation::addArrayMemoryUsage(out, state.wrappedGlyphPositions);
+    Implementation::addArrayMemoryUsage(out, state.dynamicStyleFeatures);
+    Implementation::addArrayMemoryUsage(out, state.dynamicStyleStorage);
+
+    /* Runs marked as unused, together with the glyphs and text they
+       reference, are waiting for the next recompaction in doUpdate() */
+    out.cpuUnused +=
+        state.unusedGlyphRunCount*sizeof(Implementation::TextLayerGlyphRun) +
+        state.unusedGlyphCount*sizeof(Implementation::TextLayerGlyphData) +
+        state.unusedTextRunCount*sizeof(Implementation::TextLayerTextRun) +
+        state.unusedTextSize +
+        state.unusedDeferredTextCount*sizeof(Implementation::TextLayerDeferredText) +
+        (state.data.size() - usedCount())*sizeof(Implementation::TextLayerData);
+    return out;
+}
+
+void TextLayer::doTrim(const std::size_t capacity) {
+    AbstractVisualLayer::doTrim(capacity);
+
+    auto& state = static_cast<State&>(*_state);
+    if(state.data.size() > capacity)
+        arrayResize(state.data, NoInit, capacity);
+    arrayShrink(state.data);
+    state.styles = stridedArrayView(state.data).slice(&Implementation::TextLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::TextLayerData::calculatedStyle);
+
+    /* Glyph and text runs are referenced by data and get recompacted in
+       doUpdate(), vertices and indices are sized for data that get drawn. In
+       both cases the contents may be still in use, so only the reserved
+       memory is released. */
+    arrayShrink(state.glyphData);
+    arrayShrink(state.glyphRuns);
+    arrayShrink(state.textData);
+    arrayShrink(state.textRuns);
+    arrayShrink(state.deferredTexts);
+    arrayShrink(state.deferredTextData);
+    arrayShrink(state.deferredFeatures);
+    arrayShrink(state.vertices);
+    arrayShrink(state.editingVertices);
+    arrayShrink(state.indices);
+    arrayShrink(state.editingIndices);
+    arrayShrink(state.indexDrawOffsets);
+    arrayShrink(state.dataOffsets);
+    arrayShrink(state.dataTransformations);
+    arrayShrink(state.wrappedGlyphPositions);
+}
+
+void TextLayer::doReserve(const std::size_t capacity) {
+    auto& state = static_cast<State&>(*_state);
+    arrayReserve(state.data, capacity);
+    /* The reallocation may have moved the data */
+    state.styles = stridedArrayView(state.data).slice(&Implementation::TextLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::TextLayerData::calculatedStyle);
+}
+
 LayerStates TextLayer::doState() const {
     LayerStates states = AbstractVisualLayer::doState();
 
@@ -2077,14 +3575,12 @@ LayerStates TextLayer::doState() const {
     return states;
 }
 
-void TextLayer::doClean(const Containers::BitArrayView dataIdsToRemove) {
+void TextLayer::doCleanSparse(Containers::BitArrayView, const Containers::ArrayView<const UnsignedInt> dataIds) {
     /* Mark glyph / text runs attached to removed data as unused, similarly as
        when calling remove(). They'll get actually removed during the next
        recompaction in doUpdate(). */
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != dataIdsToRemove.size(); ++i)
-        if(dataIdsToRemove[i])
-            removeInternal(i);
+    for(const UnsignedInt i: dataIds)
+        removeInternal(i);
 
     /* Data removal doesn't need anything to be reuploaded to continue working
        correctly, thus setNeedsUpdate() isn't called, and neither is in
@@ -2133,12 +3629,120 @@ void TextLayer::doAdvanceAnimations(const Nanoseconds time, const Containers::Mu
     }
 }
 
-void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
+namespace {
+
+/* Breaks glyphs of a TextDataFlag::Wrap text, shaped and aligned as a single
+   line (or several lines if the text contains newlines), into lines that fit
+   `width`. The lines are broken only after glyphs marked with
+   TextLayerGlyphWrapSpace, each new line is shifted so it's aligned the same
+   way as the line it came from, and the whole block is then shifted
+   vertically to stay aligned the same way. If the text fits, the output
+   positions are the same as the input. */
+void wrapGlyphPositionsInto(const Text::AbstractGlyphCache& glyphCache, const Float scale, const Float lineAdvance, const Text::Alignment alignment, const Float width, const Containers::StridedArrayView1D<const Implementation::TextLayerGlyphData>& glyphData, const Containers::StridedArrayView1D<Vector2>& positions) {
+    CORRADE_INTERNAL_DEBUG_ASSERT(positions.size() == glyphData.size());
+
+    /* Right edge of given glyph quad, used to measure the lines. Spaces are
+       excluded from the measurement so they can hang off the line end. */
+    const auto glyphRight = [&](const std::size_t i) {
+        const Containers::Triple<Vector2i, Int, Range2Di> glyph = glyphCache.glyph(glyphData[i].glyphId);
+        return glyphData[i].position.x() + Float(glyph.first().x() + glyph.third().sizeX())*scale;
+    };
+
+    const UnsignedByte alignmentHorizontal = UnsignedByte(alignment) & Text::Implementation::AlignmentHorizontal;
+    const bool integral = UnsignedByte(alignment) & Text::Implementation::AlignmentIntegral;
+    UnsignedInt wrapCount = 0;
+    for(std::size_t sourceBegin = 0; sourceBegin != glyphData.size(); ) {
+        /* Find where the line coming from the shaper ends and how wide it
+           is, to align the lines it gets broken into the same way */
+        std::size_t sourceEnd = sourceBegin + 1;
+        while(sourceEnd != glyphData.size() && !(glyphData[sourceEnd].glyphCluster & Implementation::TextLayerGlyphWrapLineBreak))
+            ++sourceEnd;
+        const Float sourceLeft = glyphData[sourceBegin].position.x();
+        Float sourceRight = sourceLeft;
+        for(std::size_t i = sourceBegin; i != sourceEnd; ++i)
+            if(!(glyphData[i].glyphCluster & Implementation::TextLayerGlyphWrapSpace))
+                sourceRight = Math::max(sourceRight, glyphRight(i));
+
+        /* Greedily put as many glyphs on each line as fit, breaking after
+           the last space before the first glyph that doesn't. If there's no
+           such space, the glyph stays on the line. */
+        for(std::size_t lineBegin = sourceBegin; lineBegin != sourceEnd; ) {
+            const Float left = glyphData[lineBegin].position.x();
+            std::size_t lineEnd = sourceEnd;
+            std::size_t lastBreak = ~std::size_t{};
+            Float right = left;
+            Float rightAtLastBreak = left;
+            for(std::size_t i = lineBegin; i != sourceEnd; ++i) {
+                if(glyphData[i].glyphCluster & Implementation::TextLayerGlyphWrapSpace) {
+                    if(i + 1 != sourceEnd) {
+                        lastBreak = i;
+                        rightAtLastBreak = right;
+                    }
+                    continue;
+                }
+
+                const Float glyphRightI = glyphRight(i);
+                if(glyphRightI - left > width && lastBreak != ~std::size_t{}) {
+                    lineEnd = lastBreak + 1;
+                    right = rightAtLastBreak;
+                    break;
+                }
+                right = Math::max(right, glyphRightI);
+            }
+
+            Float shift;
+            if(alignmentHorizontal == Text::Implementation::AlignmentLeft)
+                shift = sourceLeft - left;
+            else if(alignmentHorizontal == Text::Implementation::AlignmentRight)
+                shift = sourceRight - right;
+            else if(alignmentHorizontal == Text::Implementation::AlignmentCenter) {
+                shift = (sourceLeft + sourceRight - left - right)*0.5f;
+                if(integral)
+                    shift = Math::round(shift);
+            } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+            /* The glyph positions are Y up, so each next line goes down */
+            const Vector2 lineShift{shift, -Float(wrapCount)*lineAdvance};
+            for(std::size_t i = lineBegin; i != lineEnd; ++i)
+                positions[i] = glyphData[i].position + lineShift;
+
+            if(lineEnd != sourceEnd)
+                ++wrapCount;
+            lineBegin = lineEnd;
+        }
+
+        sourceBegin = sourceEnd;
+    }
+
+    /* The text grew by `wrapCount` lines downwards, shift it back up by all
+       or half of them if it's aligned to the bottom or the middle */
+    if(!wrapCount)
+        return;
+    const UnsignedByte alignmentVertical = UnsignedByte(alignment) & Text::Implementation::AlignmentVertical;
+    Float shift;
+    if(alignmentVertical == Text::Implementation::AlignmentTop)
+        shift = 0.0f;
+    else if(alignmentVertical == Text::Implementation::AlignmentBottom)
+        shift = wrapCount*lineAdvance;
+    else if(alignmentVertical == Text::Implementation::AlignmentLine ||
+            alignmentVertical == Text::Implementation::AlignmentMiddle) {
+        shift = wrapCount*lineAdvance*0.5f;
+        if(integral)
+            shift = Math::round(shift);
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    if(shift) for(Vector2& position: positions)
+        position.y() += shift;
+}
+
+}
+
+void TextLayer::doUpdate(const LayerStates requestedStates, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
     /* The base implementation populates data.calculatedStyle */
-    AbstractVisualLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
+    AbstractVisualLayer::doUpdate(requestedStates, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
 
     State& state = static_cast<State&>(*_state);
     Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+    LayerStates states = requestedStates;
     /* Technically needed only if there's any actual data to update, but
        require it always for consistency (and easier testing) */
     CORRADE_ASSERT(sharedState.setStyleCalled,
@@ -2148,15 +3752,111 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
     CORRADE_ASSERT(!sharedState.hasEditingStyles || sharedState.setEditingStyleCalled,
         "Ui::TextLayer::update(): no editing style data was set", );
 
+    /* Shape texts with TextDataFlag::DeferShaping that are visible for the
+       first time. This is done before everything else as it produces new
+       glyph runs and possibly also pending glyphs that are resolved right
+       below. As the glyphs are new, the data have to be updated even if it
+       wasn't requested. */
+    if(state.deferredTexts.size() != state.unusedDeferredTextCount) {
+        bool shaped = false;
+        for(const UnsignedInt id: dataIds) {
+            Implementation::TextLayerData& data = state.data[id];
+            if(data.deferredText == ~UnsignedInt{})
+                continue;
+
+            /* Copy the saved internals back to a TextProperties instance,
+               similarly to what's done in updateText() */
+            const Implementation::TextLayerDeferredText& deferred = state.deferredTexts[data.deferredText];
+            TextProperties properties{NoInit};
+            Utility::copy(deferred.language, properties._language);
+            properties._script = deferred.script;
+            /* The font is passed through an argument */
+            properties._font = FontHandle::Null;
+            properties._alignment = deferred.alignment;
+            properties._direction = deferred.direction;
+            if(deferred.featureCount)
+                properties.setFeatures(state.deferredFeatures.sliceSize(deferred.featureOffset, deferred.featureCount));
+
+            /* The text and feature views stay valid during the shaping, as
+               only glyph data get modified by it */
+            shapeTextInternal(id, data.style, state.deferredTextData.sliceSize(deferred.textOffset, deferred.textSize), properties, deferred.font, data.flags, nullptr);
+            removeDeferredTextInternal(data.deferredText);
+            data.deferredText = ~UnsignedInt{};
+            shaped = true;
+        }
+
+        /* TextLayerGL::doUpdate() resets the flag after it uploads the
+           data */
+        if(shaped) {
+            states |= LayerState::NeedsDataUpdate;
+            state.deferredTextsShaped = true;
+        }
+    }
+
+    /* Remove deferred texts that got shaped or replaced once at least half of
+       them is unused, making the amortized cost linear in the amount of
+       removed texts */
+    if(state.unusedDeferredTextCount && state.unusedDeferredTextCount*2 >= state.deferredTexts.size()) {
+        std::size_t outputTextDataOffset = 0;
+        std::size_t outputFeatureOffset = 0;
+        std::size_t outputDeferredTextOffset = 0;
+        for(std::size_t i = 0; i != state.deferredTexts.size(); ++i) {
+            Implementation::TextLayerDeferredText& deferred = state.deferredTexts[i];
+            if(deferred.textOffset == ~UnsignedInt{})
+                continue;
+
+            /* Move the text and feature data earlier if there were skipped
+               texts before, update the references to them */
+            Implementation::compactRunItems(arrayView(state.deferredTextData), deferred.textOffset, deferred.textSize, outputTextDataOffset);
+            Implementation::compactRunItems(arrayView(state.deferredFeatures), deferred.featureOffset, deferred.featureCount, outputFeatureOffset);
+
+            /* Move the deferred text info earlier if there were skipped texts
+               before, update the reference to it in the data */
+            if(i != outputDeferredTextOffset) {
+                CORRADE_INTERNAL_DEBUG_ASSERT(i > outputDeferredTextOffset);
+                CORRADE_INTERNAL_DEBUG_ASSERT(state.data[deferred.data].deferredText == i);
+                state.data[deferred.data].deferredText = outputDeferredTextOffset;
+                state.deferredTexts[outputDeferredTextOffset] = deferred;
+            }
+            ++outputDeferredTextOffset;
+        }
+
+        /* Remove the now-unused data from the end */
+        arrayResize(state.deferredTexts, outputDeferredTextOffset);
+        arrayResize(state.deferredTextData, outputTextDataOffset);
+        arrayResize(state.deferredFeatures, outputFeatureOffset);
+        state.unusedDeferredTextCount = 0;
+    }
+
+    /* Fill glyphs deferred with TextLayerSharedFlag::GlyphCacheFillDeferred
+       since the last update, unless that was done for another layer sharing
+       the same state already, and make the glyph data reference them. Only
+       glyphs in used runs are resolved, the rest may contain random
+       values. */
+    if(state.hasPendingGlyphs) {
+        if(sharedState.hasPendingGlyphs) {
+            fillPendingGlyphs(shared(), sharedState.fonts, sharedState.shapeCache.prefix(sharedState.shapeCacheUsedCount));
+            sharedState.hasPendingGlyphs = false;
+        }
+        for(const Implementation::TextLayerGlyphRun& run: state.glyphRuns) {
+            if(run.glyphOffset == ~UnsignedInt{})
+                continue;
+            resolvePendingGlyphs(sharedState.glyphCache, stridedArrayView(state.glyphData).sliceSize(run.glyphOffset, run.glyphCount).slice(&Implementation::TextLayerGlyphData::glyphId));
+        }
+        state.hasPendingGlyphs = false;
+    }
+
     /* Recompact the glyph / text data by removing unused runs. Do this only if
-       data actually change, this isn't affected by anything node-related */
+       data actually change, this isn't affected by anything node-related.
+       See Implementation::shouldCompactRuns() for the heuristic deciding
+       whether it's worth doing. */
     /** @todo further restrict this to just NeedsCommonDataUpdate which gets
         set by setText(), remove() etc that actually produces unused runs, but
         not setColor() and such? the recompaction however implies a need to
         update the actual index buffer etc anyway, so a dedicated state won't
         make that update any smaller, and we'd now trigger it from clean() and
         remove() as well, which we didn't need to before */
-    if(states >= LayerState::NeedsDataUpdate) {
+    if(states >= LayerState::NeedsDataUpdate && Implementation::shouldCompactRuns(state.glyphRuns.size(), state.unusedGlyphRunCount, state.glyphData.size(), state.unusedGlyphCount)) {
         std::size_t outputGlyphDataOffset = 0;
         std::size_t outputGlyphRunOffset = 0;
         for(std::size_t i = 0; i != state.glyphRuns.size(); ++i) {
@@ -2166,16 +3866,7 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
 
             /* Move the glyph data earlier if there were skipped runs before,
                update the reference to it in the run */
-            if(run.glyphOffset != outputGlyphDataOffset) {
-                CORRADE_INTERNAL_DEBUG_ASSERT(run.glyphOffset > outputGlyphDataOffset);
-                CORRADE_INTERNAL_DEBUG_ASSERT(i != outputGlyphRunOffset);
-
-                std::memmove(state.glyphData.data() + outputGlyphDataOffset,
-                             state.glyphData.data() + run.glyphOffset,
-                             run.glyphCount*sizeof(Implementation::TextLayerGlyphData));
-                run.glyphOffset = outputGlyphDataOffset;
-            }
-            outputGlyphDataOffset += run.glyphCount;
+            Implementation::compactRunItems(arrayView(state.glyphData), run.glyphOffset, run.glyphCount, outputGlyphDataOffset);
 
             /* Move the glyph run info earlier if there were skipped runs
                before, update the reference to it in the data */
@@ -2192,10 +3883,12 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         CORRADE_INTERNAL_ASSERT(outputGlyphRunOffset <= state.glyphRuns.size());
         arrayResize(state.glyphData, outputGlyphDataOffset);
         arrayResize(state.glyphRuns, outputGlyphRunOffset);
+        state.unusedGlyphRunCount = 0;
+        state.unusedGlyphCount = 0;
     }
     /* Another scope to avoid accidental variable reuse, flattening it to avoid
        excessive indentation */
-    if(states & LayerState::NeedsDataUpdate) {
+    if(states >= LayerState::NeedsDataUpdate && Implementation::shouldCompactRuns(state.textRuns.size(), state.unusedTextRunCount, state.textData.size(), state.unusedTextSize)) {
         std::size_t outputTextDataOffset = 0;
         std::size_t outputTextRunOffset = 0;
         for(std::size_t i = 0; i != state.textRuns.size(); ++i) {
@@ -2205,16 +3898,7 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
 
             /* Move the text data earlier if there were skipped runs before,
                update the reference to it in the run */
-            if(run.textOffset != outputTextDataOffset) {
-                CORRADE_INTERNAL_DEBUG_ASSERT(run.textOffset > outputTextDataOffset);
-                CORRADE_INTERNAL_DEBUG_ASSERT(i != outputTextRunOffset);
-
-                std::memmove(state.textData.data() + outputTextDataOffset,
-                             state.textData.data() + run.textOffset,
-                             run.textSize);
-                run.textOffset = outputTextDataOffset;
-            }
-            outputTextDataOffset += run.textSize;
+            Implementation::compactRunItems(arrayView(state.textData), run.textOffset, run.textSize, outputTextDataOffset);
 
             /* Move the text run info earlier if there were skipped runs
                before, update the reference to it in the data */
@@ -2232,11 +3916,19 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         CORRADE_INTERNAL_ASSERT(outputTextRunOffset <= state.textRuns.size());
         arrayResize(state.textData, outputTextDataOffset);
         arrayResize(state.textRuns, outputTextRunOffset);
+        state.unusedTextRunCount = 0;
+        state.unusedTextSize = 0;
     }
 
     /* Fill in indices in desired order if either the data themselves or the
        node order changed. Keep the checks in sync with
-       TextLayerGL::doUpdate(). */
+       TextLayerGL::doUpdate(). With InstancedGlyphs there are no glyph
+       indices, only the per-data offsets and the editing indices get
+       calculated here. With TextLayerFlag::GlyphCulling the glyph indices and
+       their offsets are generated only after the vertex data below, as the
+       glyph positions are needed for that. */
+    const bool instanced = sharedState.flags >= TextLayerSharedFlag::InstancedGlyphs;
+    const bool glyphCulling = state.flags >= TextLayerFlag::GlyphCulling;
     if(states >= LayerState::NeedsNodeOrderUpdate ||
        states >= LayerState::NeedsDataUpdate)
     {
@@ -2273,8 +3965,9 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             }
         }
 
-        /* Generate index data */
-        arrayResize(state.indices, NoInit, drawGlyphCount*6);
+        /* Generate index data. With glyph culling this is just an upper
+           bound, the array gets shrunk once the visible glyphs are known. */
+        arrayResize(state.indices, NoInit, instanced ? 0 : drawGlyphCount*6);
         arrayResize(state.editingIndices, NoInit, drawEditingRectCount*6);
         UnsignedInt indexOffset = 0;
         UnsignedInt editingRectOffset = 0;
@@ -2284,12 +3977,18 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             /* Remeber the offset for each data to draw from later */
             state.indexDrawOffsets[i] = {indexOffset, editingRectOffset*6};
 
-            /* If there are any glyphs, generate indices in draw order */
+            /* If there are any glyphs, generate indices in draw order. With
+               instanced glyphs the instances are already in draw order, so
+               just the offset is advanced. */
             if(data.glyphRun != ~UnsignedInt{}) {
                 const Implementation::TextLayerGlyphRun& glyphRun = state.glyphRuns[data.glyphRun];
-                const Containers::ArrayView<UnsignedInt> indexData = state.indices.sliceSize(indexOffset, glyphRun.glyphCount*6);
-                Text::renderGlyphQuadIndicesInto(glyphRun.glyphOffset, indexData);
-                indexOffset += indexData.size();
+                if(instanced) {
+                    indexOffset += glyphRun.glyphCount;
+                } else if(!glyphCulling) {
+                    const Containers::ArrayView<UnsignedInt> indexData = state.indices.sliceSize(indexOffset, glyphRun.glyphCount*6);
+                    Text::renderGlyphQuadIndicesInto(glyphRun.glyphOffset, indexData);
+                    indexOffset += indexData.size();
+                }
             }
 
             /* If the text is editable, generate indices for cursor and
@@ -2346,79 +4045,150 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             }
         }
 
-        CORRADE_INTERNAL_ASSERT(indexOffset == drawGlyphCount*6);
+        CORRADE_INTERNAL_ASSERT(indexOffset == (glyphCulling ? 0 : drawGlyphCount*(instanced ? 1 : 6)));
         CORRADE_INTERNAL_ASSERT(editingRectOffset == drawEditingRectCount);
         state.indexDrawOffsets[dataIds.size()] = {indexOffset, editingRectOffset*6};
     }
 
     /* Fill in vertex data if the data themselves, the node offset/size or node
        enablement (and thus calculated styles) or opacities (and thus
-       calculated colors) changed. Keep the checks in sync with
+       calculated colors) changed. Instanced glyphs are placed in draw order,
+       so they need to be updated also on a node order change. With shader
+       node opacity the opacity isn't a part of the glyph vertices, only of
+       the editing quads if there are any. Keep the checks in sync with
        TextLayerGL::doUpdate(). */
     /** @todo split this further to just position-related data update and other
         data if it shows to help with perf */
-    if(states >= LayerState::NeedsNodeOffsetSizeUpdate ||
-       states >= LayerState::NeedsNodeEnabledUpdate ||
-       states >= LayerState::NeedsNodeOpacityUpdate ||
-       states >= LayerState::NeedsDataUpdate)
-    {
-        /* Calculate how many glyphs there are in total */
-        UnsignedInt totalGlyphCount = 0;
-        for(const Implementation::TextLayerGlyphRun& run: state.glyphRuns)
-            totalGlyphCount += run.glyphCount;
+    const bool shaderNodeOpacity = sharedState.flags >= TextLayerSharedFlag::ShaderNodeOpacity;
+    const bool updateVertices =
+        (instanced && states >= LayerState::NeedsNodeOrderUpdate) ||
+        states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+        states >= LayerState::NeedsNodeEnabledUpdate ||
+        ((!shaderNodeOpacity || sharedState.hasEditingStyles) && states >= LayerState::NeedsNodeOpacityUpdate) ||
+        states >= LayerState::NeedsDataUpdate;
+    if(updateVertices) {
+        /* There's a quad for every glyph including unused space that isn't
+           recompacted yet, as the vertices are indexed by the glyph offset.
+           Instances are in draw order, so there's one for every drawn glyph
+           instead. */
+        std::size_t vertexCount;
+        if(instanced) {
+            vertexCount = 0;
+            for(const UnsignedInt dataId: dataIds) {
+                const UnsignedInt glyphRun = state.data[dataId].glyphRun;
+                if(glyphRun != ~UnsignedInt{})
+                    vertexCount += state.glyphRuns[glyphRun].glyphCount;
+            }
+        } else vertexCount = state.glyphData.size()*4;
 
         const Containers::StridedArrayView1D<const Ui::NodeHandle> nodes = this->nodes();
 
         /* Resize the vertex array to fit all data, make a view on the common
            type prefix */
-        const std::size_t typeSize = sharedState.flags >= TextLayerSharedFlag::DistanceField ?
-            sizeof(Implementation::TextLayerDistanceFieldVertex) :
-            sizeof(Implementation::TextLayerVertex);
-        arrayResize(state.vertices, NoInit, totalGlyphCount*4*typeSize);
-        const Containers::StridedArrayView1D<Implementation::TextLayerVertex> vertices{
+        const std::size_t typeSize = instanced ?
+            (sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+                sizeof(Implementation::TextLayerDistanceFieldGlyphInstance) :
+                sizeof(Implementation::TextLayerGlyphInstance)) :
+            (sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+                sizeof(Implementation::TextLayerDistanceFieldVertex) :
+                sizeof(Implementation::TextLayerVertex));
+        arrayResize(state.vertices, NoInit, vertexCount*typeSize);
+        const Containers::StridedArrayView1D<Implementation::TextLayerVertex> vertices = instanced ? nullptr : Containers::StridedArrayView1D<Implementation::TextLayerVertex>{
             state.vertices,
             reinterpret_cast<Implementation::TextLayerVertex*>(state.vertices.data()),
-            state.vertices.size()/typeSize,
+            vertexCount,
+            std::ptrdiff_t(typeSize)};
+        const Containers::StridedArrayView1D<Implementation::TextLayerGlyphInstance> instances = !instanced ? nullptr : Containers::StridedArrayView1D<Implementation::TextLayerGlyphInstance>{
+            state.vertices,
+            reinterpret_cast<Implementation::TextLayerGlyphInstance*>(state.vertices.data()),
+            vertexCount,
             std::ptrdiff_t(typeSize)};
 
-        /* View on the distance field vertices to fill in the run scales below,
-           if distance field is enabled. Doing it like this instead of casting
-           the typeless state.vertices array to ensure it's not accidentally in
-           some entirely different type. */
-        const Containers::ArrayView<Implementation::TextLayerDistanceFieldVertex> distanceFieldVertices = sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+        /* View on the distance field vertices or instances to fill in the run
+           scales below, if distance field is enabled. Doing it like this
+           instead of casting the typeless state.vertices array to ensure it's
+           not accidentally in some entirely different type. */
+        const Containers::ArrayView<Implementation::TextLayerDistanceFieldVertex> distanceFieldVertices = !instanced && sharedState.flags >= TextLayerSharedFlag::DistanceField ?
             Containers::arrayCast<Implementation::TextLayerDistanceFieldVertex>(vertices).asContiguous() :
             nullptr;
+        const Containers::ArrayView<Implementation::TextLayerDistanceFieldGlyphInstance> distanceFieldInstances = instanced && sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+            Containers::arrayCast<Implementation::TextLayerDistanceFieldGlyphInstance>(instances).asContiguous() :
+            nullptr;
 
         /* If any selection or cursor style is present, make room in the
            editing vertex array as well */
         if(sharedState.hasEditingStyles)
             arrayResize(state.editingVertices, NoInit, state.textRuns.size()*2*4);
 
+        /* With shader transformation the glyphs are positioned relative to
+           the aligned text origin, which is remembered for each data and
+           used to calculate the per-data transformation below */
+        const bool shaderTransformation = sharedState.flags >= TextLayerSharedFlag::ShaderTransformation;
+        if(shaderTransformation)
+            arrayResize(state.dataOffsets, NoInit, state.data.size());
+
         /* Generate vertex data */
+        std::size_t instanceOffset = 0;
         for(const UnsignedInt dataId: dataIds) {
             const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
             const Implementation::TextLayerData& data = state.data[dataId];
 
+            /* Align the glyph run relative to the node area, taking alignment
+               and padding into account. This is done even if there are no
+               glyphs, as the offset is subsequently used for editing cursor as
+               well.
+
+               Arbitrary transformation, in case it's enabled, replaces the
+               per-data padding and it's applied last, after all alignment. */
+            Vector4 padding = state.flags >= TextLayerFlag::Transformable ? Vector4{} : data.padding;
+            if(data.calculatedStyle < sharedState.styleCount)
+                padding += sharedState.styles[data.calculatedStyle].padding;
+            else {
+                CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
+                padding += state.dynamicStyles[data.calculatedStyle - sharedState.styleCount].padding;
+            }
+            const Vector2 size = nodeSizes[nodeId] - padding.xy() - Math::gather<'z', 'w'>(padding);
+            Vector2 offset = nodeOffsets[nodeId] + padding.xy() + alignmentOffset(data.alignment, size);
+
             /* If there are any glyphs, fill in quad vertices in the same order
-               as the original text runs. If there are not, the views stay
-               empty. They're subsequently used also for cursor placement and
-               selection highlighting, so they have to be in the outer
-               scope. */
+               as the original text runs, or take the next instances in draw
+               order. If there are not, the views stay empty. They're
+               subsequently used also for cursor placement and selection
+               highlighting, so they have to be in the outer scope. */
             Containers::StridedArrayView1D<const Implementation::TextLayerGlyphData> glyphData;
+            Containers::StridedArrayView1D<const Vector2> glyphPositions;
             Containers::StridedArrayView1D<Implementation::TextLayerVertex> vertexData;
+            Containers::StridedArrayView1D<Implementation::TextLayerGlyphInstance> instanceData;
             if(data.glyphRun != ~UnsignedInt{}) {
                 const Implementation::TextLayerGlyphRun& glyphRun = state.glyphRuns[data.glyphRun];
                 /** @todo ideally this would only be done if some text actually
                     changes, not on every visibility change */
                 glyphData = state.glyphData.sliceSize(glyphRun.glyphOffset, glyphRun.glyphCount);
-                vertexData = vertices.sliceSize(glyphRun.glyphOffset*4, glyphRun.glyphCount*4);
-                Text::renderGlyphQuadsInto(
-                    sharedState.glyphCache,
-                    glyphRun.scale,
-                    glyphData.slice(&Implementation::TextLayerGlyphData::position),
-                    glyphData.slice(&Implementation::TextLayerGlyphData::glyphId),
-                    vertexData.slice(&Implementation::TextLayerVertex::position),
-                    vertexData.slice(&Implementation::TextLayerVertex::textureCoordinates));
+
+                /* With TextDataFlag::Wrap the glyphs stay shaped as a single
+                   line, which gets broken into lines fitting the node width
+                   here. It's just a pass over the cached glyph positions and
+                   break opportunities, the text isn't shaped again. */
+                if(data.flags >= TextDataFlag::Wrap) {
+                    arrayResize(state.wrappedGlyphPositions, NoInit, glyphRun.glyphCount);
+                    wrapGlyphPositionsInto(sharedState.glyphCache, glyphRun.scale, glyphRun.lineAdvance, data.alignment, size.x(), glyphData, stridedArrayView(state.wrappedGlyphPositions));
+                    glyphPositions = stridedArrayView(state.wrappedGlyphPositions);
+                } else glyphPositions = glyphData.slice(&Implementation::TextLayerGlyphData::position);
+
+                /* The instances are filled in below, once the alignment
+                   offset is known */
+                if(instanced) {
+                    instanceData = instances.sliceSize(instanceOffset, glyphRun.glyphCount);
+                } else {
+                    vertexData = vertices.sliceSize(glyphRun.glyphOffset*4, glyphRun.glyphCount*4);
+                    Text::renderGlyphQuadsInto(
+                        sharedState.glyphCache,
+                        glyphRun.scale,
+                        glyphPositions,
+                        glyphData.slice(&Implementation::TextLayerGlyphData::glyphId),
+                        vertexData.slice(&Implementation::TextLayerVertex::position),
+                        vertexData.slice(&Implementation::TextLayerVertex::textureCoordinates));
+                }
 
                 /* Fill in also extra per-run properties needed for distance
                    field rendering if enabled */
@@ -2431,58 +4201,21 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                        to extract it back to appropriately scale the outlines
                        and smoothness, involving a square root. */
                     const Float invertedRunScale = 1.0f/(glyphRun.scale*
-                        (state.flags >= TextLayerFlag::Transformable ?
+                        (state.flags >= TextLayerFlag::Transformable && !shaderTransformation ?
                             data.transformation.rotationScaling.length() : 1.0f));
-                    for(Implementation::TextLayerDistanceFieldVertex& i: distanceFieldVertices.sliceSize(glyphRun.glyphOffset*4, glyphRun.glyphCount*4))
+                    if(instanced) for(Implementation::TextLayerDistanceFieldGlyphInstance& i: distanceFieldInstances.sliceSize(instanceOffset, glyphRun.glyphCount))
+                        i.invertedRunScale = invertedRunScale;
+                    else for(Implementation::TextLayerDistanceFieldVertex& i: distanceFieldVertices.sliceSize(glyphRun.glyphOffset*4, glyphRun.glyphCount*4))
                         i.invertedRunScale = invertedRunScale;
                 }
-            }
-
-            /* Align the glyph run relative to the node area, taking alignment
-               and padding into account. This is done even if there are no
-               glyphs, as the offset is subsequently used for editing cursor as
-               well.
 
-               Arbitrary transformation, in case it's enabled, replaces the
-               per-data padding and it's applied last, after all alignment. */
-            Vector4 padding = state.flags >= TextLayerFlag::Transformable ? Vector4{} : data.padding;
-            if(data.calculatedStyle < sharedState.styleCount)
-                padding += sharedState.styles[data.calculatedStyle].padding;
-            else {
-                CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
-                padding += state.dynamicStyles[data.calculatedStyle - sharedState.styleCount].padding;
+                if(instanced)
+                    instanceOffset += glyphRun.glyphCount;
             }
-            Vector2 offset = nodeOffsets[nodeId] + padding.xy();
-            const Vector2 size = nodeSizes[nodeId] - padding.xy() - Math::gather<'z', 'w'>(padding);
-            const UnsignedByte alignmentHorizontal = UnsignedByte(data.alignment) & Text::Implementation::AlignmentHorizontal;
-            if(alignmentHorizontal == Text::Implementation::AlignmentLeft) {
-                offset.x() += 0.0f;
-            } else if(alignmentHorizontal == Text::Implementation::AlignmentRight) {
-                offset.x() += size.x();
-            } else if(alignmentHorizontal == Text::Implementation::AlignmentCenter) {
-                if(UnsignedByte(data.alignment) & Text::Implementation::AlignmentIntegral)
-                    offset.x() += Math::round(size.x()*0.5f);
-                else
-                    offset.x() += size.x()*0.5f;
-            } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-            const UnsignedByte alignmentVertical = UnsignedByte(data.alignment) & Text::Implementation::AlignmentVertical;
-            /* For Line/Middle it's aligning either the line or bounding box
-               middle (which is already at y=0 by the Text::alignRenderedLine())
-               to node middle */
-            if(alignmentVertical == Text::Implementation::AlignmentTop) {
-                offset.y() += 0.0f;
-            } else if(alignmentVertical == Text::Implementation::AlignmentBottom) {
-                offset.y() += size.y();
-            } else if(alignmentVertical == Text::Implementation::AlignmentLine ||
-                      alignmentVertical == Text::Implementation::AlignmentMiddle) {
-                if(UnsignedByte(data.alignment) & Text::Implementation::AlignmentIntegral)
-                    offset.y() += Math::round(size.y()*0.5f);
-                else
-                    offset.y() += size.y()*0.5f;
-            } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 
-            /* Fill color and style */
-            const Float opacity = nodeOpacities[nodeId];
+            /* Fill color and style. With shader node opacity the glyph color
+               is multiplied with the opacity in the shader. */
+            const Float opacity = shaderNodeOpacity ? 1.0f : nodeOpacities[nodeId];
             for(Implementation::TextLayerVertex& vertex: vertexData) {
                 vertex.color = data.color*opacity;
                 /* For dynamic styles the uniform mapping is implicit and
@@ -2499,8 +4232,13 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                being Y down. In case of the transformation the Y flip is done
                even before rotation, which then causes positive rotation angle
                to be interpreted clockwise without needing to do any additional
-               sign flips. */
-            if(state.flags >= TextLayerFlag::Transformable) {
+               sign flips. With shader transformation the translation and
+               transformation is done in the shader, only the Y flip here. */
+            if(shaderTransformation) {
+                state.dataOffsets[dataId] = offset;
+                for(Implementation::TextLayerVertex& vertex: vertexData)
+                    vertex.position = vertex.position*Vector2::yScale(-1.0f);
+            } else if(state.flags >= TextLayerFlag::Transformable) {
                 /** @todo batch, SIMD-infused utility for this */
                 const Vector2 translation = offset + data.transformation.translation;
                 for(Implementation::TextLayerVertex& vertex: vertexData)
@@ -2510,6 +4248,44 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                     vertex.position = offset + vertex.position*Vector2::yScale(-1.0f);
             }
 
+            /* With instanced glyphs, fill all instance properties in a single
+               pass. The glyph quads are calculated the same way as
+               Text::renderGlyphQuadsInto() does above, and the three stored
+               corners then get the same alignment offset, Y flip and
+               transformation as the vertices. */
+            if(!instanceData.isEmpty()) {
+                const Float scale = state.glyphRuns[data.glyphRun].scale;
+                const Vector2 inverseCacheSize = 1.0f/Vector2{sharedState.glyphCache.size().xy()};
+                const Color4 color = data.color*opacity;
+                const UnsignedInt styleUniform = data.calculatedStyle < sharedState.styleCount ?
+                    sharedState.styles[data.calculatedStyle].uniform :
+                    sharedState.styleUniformCount + data.calculatedStyle - sharedState.styleCount;
+                const bool transformable = state.flags >= TextLayerFlag::Transformable && !shaderTransformation;
+                const Vector2 translation = shaderTransformation ? Vector2{} :
+                    transformable ? offset + data.transformation.translation : offset;
+                const auto transformPosition = [&data, &translation, transformable](const Vector2& position) {
+                    return transformable ?
+                        translation + data.transformation.rotationScaling.transformVector(position*Vector2::yScale(-1.0f)) :
+                        translation + position*Vector2::yScale(-1.0f);
+                };
+                for(std::size_t i = 0; i != instanceData.size(); ++i) {
+                    const Containers::Triple<Vector2i, Int, Range2Di> glyph = sharedState.glyphCache.glyph(glyphData[i].glyphId);
+                    const Range2D quad = Range2D::fromSize(
+                        glyphPositions[i] + Vector2{glyph.first()}*scale,
+                        Vector2{glyph.third().size()}*scale);
+                    const Range2D textureCoordinates = Range2D{glyph.third()}.scaled(inverseCacheSize);
+
+                    Implementation::TextLayerGlyphInstance& instance = instanceData[i];
+                    instance.corner0 = transformPosition(quad.bottomLeft());
+                    instance.corner1 = transformPosition(quad.bottomRight());
+                    instance.corner2 = transformPosition(quad.topLeft());
+                    instance.textureCoordinateMin = {textureCoordinates.min(), Float(glyph.second())};
+                    instance.textureCoordinateMax = textureCoordinates.max();
+                    instance.color = color;
+                    instance.styleUniform = styleUniform;
+                }
+            }
+
             /* If the text is editable, generate also the cursor and selection
                mesh, unless they don't have any style */
             if(data.textRun != ~UnsignedInt{}) {
@@ -2547,7 +4323,7 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                     return Vector2::xAxis(glyph == glyphData.size() ?
                         data.rectangle.max().x() : glyphData[glyph].position.x());
                 };
-                const auto createEditingQuad = [&state, &sharedState, &lineTop, &lineBottom, &cursorPositionForGlyph, &vertexData](const bool dynamicEditingStyle, const UnsignedInt editingStyleId, const UnsignedInt glyphBegin, const UnsignedInt glyphEnd, const UnsignedInt vertexOffset, Text::ShapeDirection direction, Float opacity) {
+                const auto createEditingQuad = [&state, &sharedState, &lineTop, &lineBottom, &cursorPositionForGlyph, instanced, &vertexData, &instanceData](const bool dynamicEditingStyle, const UnsignedInt editingStyleId, const UnsignedInt glyphBegin, const UnsignedInt glyphEnd, const UnsignedInt vertexOffset, Text::ShapeDirection direction, Float opacity) {
                     Vector4 padding{NoInit};
                     UnsignedInt uniform;
                     Int textUniform;
@@ -2600,7 +4376,9 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                     /* If the editing style has an override for the text
                        uniform, apply it to the selected range */
                     if(textUniform != -1) {
-                        for(Implementation::TextLayerVertex& vertex: vertexData.slice(glyphBegin*4, glyphEnd*4))
+                        if(instanced) for(Implementation::TextLayerGlyphInstance& instance: instanceData.slice(glyphBegin, glyphEnd))
+                            instance.styleUniform = textUniform;
+                        else for(Implementation::TextLayerVertex& vertex: vertexData.slice(glyphBegin*4, glyphEnd*4))
                             vertex.styleUniform = textUniform;
                     }
                 };
@@ -2635,6 +4413,108 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                 }
             }
         }
+
+        CORRADE_INTERNAL_ASSERT(!instanced || instanceOffset == vertexCount);
+    }
+
+    /* With glyph culling, generate indices only for glyphs whose quads
+       intersect the clip rect of their data, using the vertex positions
+       calculated above. Only glyphs that would be fully clipped anyway are
+       omitted, so the visual output is the same. Clip rects change with node
+       offsets and sizes, which implies NeedsNodeOrderUpdate, so it's done
+       under the same conditions as the index generation above. As the vertex
+       data are indexed by the glyph offset and the culling doesn't change
+       them, they don't need to be regenerated if just the clip rects
+       change. */
+    if(glyphCulling && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsDataUpdate))
+    {
+        const std::size_t typeSize = sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+            sizeof(Implementation::TextLayerDistanceFieldVertex) :
+            sizeof(Implementation::TextLayerVertex);
+        const Containers::StridedArrayView1D<const Vector2> positions = Containers::StridedArrayView1D<const Implementation::TextLayerVertex>{
+            state.vertices,
+            reinterpret_cast<const Implementation::TextLayerVertex*>(state.vertices.data()),
+            state.vertices.size()/typeSize,
+            std::ptrdiff_t(typeSize)}.slice(&Implementation::TextLayerVertex::position);
+
+        UnsignedInt indexOffset = 0;
+        std::size_t clipDataOffset = 0;
+        for(std::size_t i = 0; i != clipRectIds.size(); ++i) {
+            const UnsignedInt clipRectId = clipRectIds[i];
+            /* Zero clip rect size means no clipping */
+            const bool clip = !clipRectSizes[clipRectId].isZero();
+            const Range2D clipRect = Range2D::fromSize(clipRectOffsets[clipRectId], clipRectSizes[clipRectId]);
+
+            const std::size_t clipDataEnd = clipDataOffset + clipRectDataCounts[i];
+            for(std::size_t j = clipDataOffset; j != clipDataEnd; ++j) {
+                const Implementation::TextLayerData& data = state.data[dataIds[j]];
+                state.indexDrawOffsets[j].first() = indexOffset;
+                if(data.glyphRun == ~UnsignedInt{})
+                    continue;
+
+                /* Emit indices for each contiguous span of visible glyphs.
+                   For a text that's larger than its clip rect it's usually
+                   just a single span. The quads may be arbitrarily
+                   transformed, so their bounds are calculated from all four
+                   corners. */
+                const Implementation::TextLayerGlyphRun& glyphRun = state.glyphRuns[data.glyphRun];
+                UnsignedInt spanBegin = glyphRun.glyphOffset;
+                for(UnsignedInt k = glyphRun.glyphOffset, kEnd = glyphRun.glyphOffset + glyphRun.glyphCount; k <= kEnd; ++k) {
+                    bool visible = false;
+                    if(k != kEnd) {
+                        if(clip) {
+                            const Containers::StridedArrayView1D<const Vector2> quad = positions.sliceSize(k*4, 4);
+                            const Range2D bounds{
+                                Math::min(Math::min(quad[0], quad[1]), Math::min(quad[2], quad[3])),
+                                Math::max(Math::max(quad[0], quad[1]), Math::max(quad[2], quad[3]))};
+                            visible = Math::intersects(bounds, clipRect);
+                        } else visible = true;
+                    }
+                    if(visible)
+                        continue;
+
+                    if(k != spanBegin) {
+                        const Containers::ArrayView<UnsignedInt> indexData = state.indices.sliceSize(indexOffset, (k - spanBegin)*6);
+                        Text::renderGlyphQuadIndicesInto(spanBegin, indexData);
+                        indexOffset += indexData.size();
+                    }
+                    spanBegin = k + 1;
+                }
+            }
+
+            clipDataOffset = clipDataEnd;
+        }
+
+        CORRADE_INTERNAL_ASSERT(clipDataOffset == dataIds.size());
+        state.indexDrawOffsets[dataIds.size()].first() = indexOffset;
+        arrayResize(state.indices, indexOffset);
+    }
+
+    /* With shader transformation, combine the text origin offsets with the
+       per-data transformations if either of them changed. Transformation
+       changes alone are signalled with NeedsCommonDataUpdate, which doesn't
+       cause the vertex data to be touched at all. Layers without
+       TextLayerFlag::Transformable have just the offset. */
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderTransformation && (
+       updateVertices ||
+       states >= LayerState::NeedsCommonDataUpdate))
+    {
+        arrayResize(state.dataTransformations, NoInit, state.data.size());
+        const bool transformable = state.flags >= TextLayerFlag::Transformable;
+        for(const UnsignedInt dataId: dataIds) {
+            const Vector2 offset = state.dataOffsets[dataId];
+            if(transformable) {
+                const Implementation::TextLayerData::Transformation& transformation = state.data[dataId].transformation;
+                const Vector2 translation = offset + transformation.translation;
+                state.dataTransformations[dataId] = {
+                    translation.x(), translation.y(),
+                    transformation.rotationScaling.real(),
+                    transformation.rotationScaling.imaginary()};
+            } else state.dataTransformations[dataId] = {offset.x(), offset.y(), 1.0f, 0.0f};
+        }
+        state.dataTransformationsChanged = true;
     }
 
     /* Sync the style update stamp to not have doState() return NeedsDataUpdate
@@ -2646,6 +4526,59 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
     }
 }
 
+void TextLayer::doPointerPressEvent(const UnsignedInt dataId, PointerEvent& event) {
+    /* The base implementation handles style transitions and accepts the
+       event if it's a primary press */
+    AbstractVisualLayer::doPointerPressEvent(dataId, event);
+    if(!event.isAccepted())
+        return;
+
+    /* Similarly to key events, the cursor is placed only if the node is
+       focused already. The focus event for a focusable node is called only
+       after the press, so the first press only focuses it. */
+    State& state = static_cast<State&>(*_state);
+    state.pointerSelectionDataId = ~UnsignedInt{};
+    if(!(state.data[dataId].flags >= TextDataFlag::Editable) || !event.isNodeFocused())
+        return;
+
+    /* Place the cursor at the press position, discarding any selection */
+    const UnsignedInt cursor = cursorForPositionInternal(dataId, event.position(), event.nodeSize());
+    setCursorInternal(dataId, cursor, cursor);
+    state.pointerSelectionDataId = dataId;
+}
+
+void TextLayer::doPointerReleaseEvent(const UnsignedInt dataId, PointerEvent& event) {
+    AbstractVisualLayer::doPointerReleaseEvent(dataId, event);
+    if(!event.isAccepted())
+        return;
+
+    static_cast<State&>(*_state).pointerSelectionDataId = ~UnsignedInt{};
+}
+
+void TextLayer::doPointerMoveEvent(const UnsignedInt dataId, PointerMoveEvent& event) {
+    AbstractVisualLayer::doPointerMoveEvent(dataId, event);
+    if(!event.isAccepted())
+        return;
+
+    /* Extend the selection if the press that placed the cursor is still
+       active. The node is captured on press by default, so the move events
+       arrive even if the pointer leaves the node area. The text could have
+       been made non-editable in the meantime, check for that as well. */
+    const State& state = static_cast<const State&>(*_state);
+    const Implementation::TextLayerData& data = state.data[dataId];
+    if(state.pointerSelectionDataId != dataId || !event.isCaptured() ||
+       !(data.flags >= TextDataFlag::Editable))
+        return;
+
+    const UnsignedInt cursor = cursorForPositionInternal(dataId, event.position(), event.nodeSize());
+    setCursorInternal(dataId, cursor, state.textRuns[data.textRun].selection);
+}
+
+void TextLayer::doPointerCancelEvent(const UnsignedInt dataId, PointerCancelEvent& event) {
+    AbstractVisualLayer::doPointerCancelEvent(dataId, event);
+    static_cast<State&>(*_state).pointerSelectionDataId = ~UnsignedInt{};
+}
+
 void TextLayer::doKeyPressEvent(const UnsignedInt dataId, KeyEvent& event) {
     State& state = static_cast<State&>(*_state);
     Implementation::TextLayerData& data = state.data[dataId];
@@ -431,6 +431,9 @@ namespace Implementation {
         FontHandleIdBits = 15,
         FontHandleGenerationBits = 1
     };
+
+    class FrameArena;
+    struct TextLayerShapeJob;
 }
 
 /**
@@ -511,18 +514,41 @@ enum class TextLayerFlag: UnsignedByte {
      * as cursor placement with arbitrarily transformed text isn't implemented
      * yet.
      *
-     * Note that internally the glyph quad transformation is performed on the
+     * Note that by default the glyph quad transformation is performed on the
      * CPU side, which may have performance implications if enabled globally
      * and not just on text that actually needs arbitrary transformation ---
      * for that reason this is a per-layer flag and not a
      * @ref TextLayerSharedFlag so you can have a dedicated layer instance with
-     * all other state shared for just transformed texts alone.
+     * all other state shared for just transformed texts alone. Enable
+     * @ref TextLayerSharedFlag::ShaderTransformation to perform the
+     * transformation in the shader instead, making transformation changes not
+     * cause any update of the glyph vertices.
      *
      * For crisp rendering with arbitrary rotation and scaling it's recommended
      * to use this feature together with
      * @ref Ui-TextLayer-distancefield "distance field rendering".
      */
-    Transformable = 1 << 0
+    Transformable = 1 << 0,
+
+    /**
+     * Cull glyphs outside of the clip rect. Node culling done by
+     * @ref AbstractUserInterface works only with whole nodes, so a single
+     * large text inside a clipped scroll area, such as a long log, still
+     * draws all its glyphs. With this flag, glyph indices are generated in
+     * @ref TextLayer::update() only for glyphs that intersect the clip rect
+     * of their data, and the rest is neither uploaded nor drawn. As clip
+     * rects change with node offsets and sizes, scrolling then regenerates
+     * the index data for all visible data in the layer, so it's useful to
+     * have a dedicated layer instance for large texts alone. The vertex data
+     * still contain all glyphs, only the index data are reduced.
+     *
+     * Cannot be used together with @ref TextLayerSharedFlag::InstancedGlyphs,
+     * which has no glyph index data, or with
+     * @ref TextLayerSharedFlag::ShaderTransformation, where the final glyph
+     * positions aren't known on the CPU side.
+     * @m_since_latest
+     */
+    GlyphCulling = 1 << 1
 };
 
 /**
@@ -567,6 +593,44 @@ enum class TextDataFlag: UnsignedByte {
      *      @ref TextLayer::Shared::setEditingStyle()
      */
     Editable = 1 << 0,
+
+    /**
+     * Defer shaping of the text until the data first appear among the visible
+     * data in @ref TextLayer::update(). Until then, only the text and the
+     * properties passed to @ref TextLayer::create() or
+     * @ref TextLayer::setText() are stored, and @ref TextLayer::glyphCount()
+     * and @ref TextLayer::size() return zero. Useful for example for long
+     * lists where most of the items are culled, making the shaping cost and
+     * glyph memory use proportional to just the items that are actually
+     * shown. The font is decided already when the text is set, the
+     * alignment and features coming from the style are resolved only at the
+     * time the text is shaped. Shaped text isn't discarded again when the
+     * data become invisible.
+     *
+     * Can't be combined with @ref TextDataFlag::Editable.
+     * @m_since_latest
+     */
+    DeferShaping = 1 << 1,
+
+    /**
+     * Wrap the text to the width of the node it's attached to, minus padding.
+     * The text is shaped just once, the layer remembers glyph positions
+     * and break opportunities, which are at spaces, and on a node size change
+     * in @ref TextLayer::update() breaks the glyphs into lines again without
+     * having to shape the text again. A @cpp '
+' @ce in the text always
+     * starts a new line. Words that don't fit a line on their own are not
+     * broken further. Each line is aligned horizontally and the whole block
+     * vertically according to the alignment the text was shaped with.
+     *
+     * Only horizontal left-to-right text is supported at the moment. The
+     * @ref TextLayer::size() reports the size of the text before wrapping.
+     * Can't be combined with @ref TextDataFlag::Editable. Texts with this flag
+     * don't use the shape cache, as the break opportunities are calculated
+     * from glyph clusters which aren't cached.
+     * @m_since_latest
+     */
+    Wrap = 1 << 2,
 };
 
 /**
@@ -924,9 +988,16 @@ case.
 @m_class{m-note m-warning}
 
 @par
-    At the moment, there's no mechanism in place to automatically fill the
-    glyph cache based on what glyphs are used, you have to do it explicitly
-    using @ref Text::AbstractFont::fillGlyphCache().
+    By default, the glyph cache isn't filled automatically based on what
+    glyphs are used, you have to do it explicitly using
+    @ref Text::AbstractFont::fillGlyphCache(). Alternatively, with
+    @ref TextLayerSharedFlag::GlyphCacheFillOnDemand enabled, glyphs that
+    aren't in the cache yet are added to it when a text using them is shaped,
+    which is useful especially for fonts with large glyph sets where filling
+    all of them upfront would waste a lot of memory. Additionally enabling
+    @ref TextLayerSharedFlag::GlyphCacheGrowOnDemand makes the cache grow by
+    one layer whenever it gets full, so it doesn't need to be sized for the
+    worst case upfront.
 
 Assuming the UI size matches the framebuffer size, a good default is to use the
 same size in @ref Text::AbstractFont::openFile() /
@@ -1275,6 +1346,46 @@ behave the same as @ref create() and @ref createGlyph(). Internally there's no
 distinction between a text and a single glyph, so a text can be safely changed
 to just a glyph and vice versa.
 
+Text shaping is usually the most expensive part of @ref create() and
+@ref setText(). If the same strings get shaped often, such as numeric values
+in table cells, repeated labels or rows of a virtualized list being recycled,
+@ref Shared::Configuration::setShapeCacheSize() enables a cache of recently
+shaped texts, shared by all layers created from the same @ref Shared instance.
+If the same text is shaped again with the same font, alignment, direction,
+script, language and features, the already shaped glyphs are copied from the
+cache instead of going through the shaper again. Texts with
+@ref TextDataFlag::Editable or @ref TextDataFlag::Wrap don't use the cache.
+
+Changing or removing a text leaves its previous glyphs as unused space, which
+gets recompacted in the next @ref update(). For layers with a lot of glyphs
+the recompaction is done only once a significant portion of the glyph data is
+unused, and if a text is changed to one with the same or smaller glyph count,
+such as with live counters or clocks, the existing space is reused in place
+instead. Thus changing a single text in a large layer doesn't cause all
+following glyph data to be shifted.
+
+Multiple texts can be updated at once with
+@ref setText(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StringIterable&, const Containers::StridedArrayView1D<const TextProperties>&).
+If @ref Shared::Configuration::setShaperCount() is greater than @cpp 1 @ce
+and an executor is set with @ref Shared::setShapeExecutor(), the texts are
+shaped concurrently, each task using its own shaper instances, and the results
+are then merged in the order the texts were passed in, producing the same data
+as if the texts were shaped one after another. Such texts bypass the shape
+cache. A single text is always shaped by a single shaper, so with just one
+large text there's nothing to parallelize.
+
+For layers with a lot of glyphs, such as long documents, the vertex data size
+may become the bottleneck when the texts change or get scrolled. With
+@ref TextLayerSharedFlag::InstancedGlyphs each glyph is drawn as an instance of
+a single static quad instead of four vertices and six indices, and changing
+the draw order doesn't involve regenerating any index data.
+
+If a single text is larger than the area it's visible in, such as a long log
+inside a clipped scroll area, node culling doesn't help as the whole text is
+attached to a single node. Constructing the layer with
+@ref TextLayerFlag::GlyphCulling then makes it draw only glyphs that intersect
+the clip rect of given data.
+
 @section Ui-TextLayer-transformation Arbitrary text and glyph transformation
 
 By constructing the layer with @ref TextLayerFlag::Transformable, the text data
@@ -1463,13 +1574,11 @@ concrete actions described in the @ref TextEdit enum.
 
 @snippet Ui.cpp TextLayer-editing-focusable
 
-<b></b>
-
-@m_class{m-note m-warning}
-
-@par
-    Note that currently only cursor movement and selection via a keyboard is
-    implemented, not with a pointer yet.
+A press with a primary mouse button, finger or pen on an already focused node
+then places the cursor at the glyph boundary closest to the press position,
+and moving the pointer while it's pressed extends the selection from there.
+The press that focuses the node only focuses it. Same as with keyboard input,
+the cursor isn't affected by pointer events on nodes that aren't focused.
 
 For proper visual feedback on focus and blur of a particular widget containing
 the editable text it's recommended to implement also the `toFocusedOut` and
@@ -2240,7 +2349,9 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
          * descent and advances of individual glyphs, not from actual area of
          * the glyphs being drawn, as that may not be known at that time. For
          * @ref createGlyph() or @ref setGlyph() the size is based on the
-         * actual glyph size coming out of the glyph cache.
+         * actual glyph size coming out of the glyph cache. Text with
+         * @ref TextDataFlag::DeferShaping that wasn't shaped yet has a zero
+         * size.
          *
          * Text transformation, if @ref TextLayerFlag::Transformable is
          * enabled, is not taken into account in any way.
@@ -2302,7 +2413,10 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
          * Calling this function causes @ref LayerState::NeedsDataUpdate to be
          * set, unless the operation performed is a no-op, which is when both
          * @p removeSize and @p insertText size are both @cpp 0 @ce and
-         * @p cursor is equal to @ref cursor().
+         * @p cursor is equal to @ref cursor(). The flag isn't set also if the
+         * style currently used by @p handle has no cursor style and either no
+         * selection style or the selection is empty both before and after,
+         * as there's nothing visible to be updated in that case.
          * @see @ref isHandleValid(DataHandle) const,
          *      @ref flags(DataHandle) const
          */
@@ -2446,6 +2560,65 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
          */
         void setText(LayerDataHandle handle, Containers::StringView text, const TextProperties& properties, TextDataFlags flags);
 
+        /**
+         * @brief Set multiple texts at once
+         *
+         * Equivalent to calling @ref setText(DataHandle, Containers::StringView, const TextProperties&)
+         * for each item in @p handles, @p texts and @p properties, which are
+         * all expected to have the same size. Compared to doing that, the
+         * handles are all checked up front and the glyph and text storage is
+         * enlarged just once for all texts instead of growing gradually with
+         * each text, which is useful when refreshing many texts at once,
+         * such as cells in a table. To use the same @ref TextProperties for
+         * all texts, pass a view with a zero stride, for example
+         * @cpp Containers::stridedArrayView(&properties, 1).broadcasted<0>(handles.size()) @ce.
+         *
+         * Calling this function with a non-empty @p handles view causes
+         * @ref LayerState::NeedsDataUpdate to be set.
+         */
+        void setText(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& properties);
+
+        /**
+         * @brief Set multiple texts at once assuming they belong to this layer
+         *
+         * Like @ref setText(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StringIterable&, const Containers::StridedArrayView1D<const TextProperties>&)
+         * but without checking that @p handles indeed belong to this layer.
+         * See its documentation for more information.
+         */
+        void setText(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& properties);
+
+        /**
+         * @brief Reserve glyph storage
+         * @param glyphCount    Count of glyphs to reserve for
+         * @param runCount      Count of texts to reserve for
+         * @m_since_latest
+         *
+         * Reserves memory for at least @p glyphCount more glyphs in at least
+         * @p runCount more texts on top of what's currently stored, so
+         * subsequent @ref create(), @ref createGlyph(), @ref setText() and
+         * @ref setGlyph() calls don't need to reallocate until the reserved
+         * amount is used up. Useful before creating a large amount of text at
+         * once, together with @ref AbstractLayer::reserve() for the data
+         * storage. For most scripts the text size in bytes is an upper bound
+         * for the glyph count.
+         * @see @ref reserveText()
+         */
+        void reserveGlyphs(std::size_t glyphCount, std::size_t runCount);
+
+        /**
+         * @brief Reserve editable text storage
+         * @param textSize      Text size in bytes to reserve for
+         * @param runCount      Count of texts to reserve for
+         * @m_since_latest
+         *
+         * Reserves memory for at least @p textSize more bytes in at least
+         * @p runCount more texts with @ref TextDataFlag::Editable on top of
+         * what's currently stored. Only editable texts keep a copy of the
+         * input text, thus this has no effect on non-editable texts.
+         * @see @ref reserveGlyphs()
+         */
+        void reserveText(std::size_t textSize, std::size_t runCount);
+
         /**
          * @brief Update text, cursor position and selection in an editable text
          * @param handle        Handle which to update
@@ -2481,6 +2654,13 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
          * set, unless the operation performed is a no-op, which is when both
          * @p removeSize and @p insertText size are both @cpp 0 @ce and
          * @p cursor is equal to @ref cursor().
+         *
+         * If the text consists of multiple lines, only lines that changed
+         * since the text was last shaped are passed to the shaper again,
+         * shaping results of the other lines are reused. This is done only
+         * for the most recently shaped multi-line editable text in the layer,
+         * and only if all font features used by the text apply to the whole
+         * text. The same applies to @ref editText().
          * @see @ref isHandleValid(DataHandle) const,
          *      @ref flags(DataHandle) const, @ref setText()
          */
@@ -2662,6 +2842,29 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
          */
         void setColor(LayerDataHandle handle, const Color4& color);
 
+        /**
+         * @brief Set custom base colors of multiple texts
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setColor(DataHandle, const Color4&) for
+         * each item in @p handles and @p colors, but with the layer marked
+         * with @ref LayerState::NeedsDataUpdate just once and only if
+         * @p handles is non-empty. Expects that the @p handles and @p colors
+         * views have the same size and that all handles are valid. The handles
+         * are all checked before anything is updated.
+         */
+        void setColor(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors);
+
+        /**
+         * @brief Set custom base colors of multiple texts assuming they belong to this layer
+         * @m_since_latest
+         *
+         * Like @ref setColor(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StridedArrayView1D<const Color4>&)
+         * but without checking that @p handles indeed belong to this layer.
+         * See its documentation for more information.
+         */
+        void setColor(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Color4>& colors);
+
         /**
          * @brief Custom text padding
          *
@@ -2730,6 +2933,30 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
             setPadding(handle, Vector4{padding});
         }
 
+        /**
+         * @brief Set custom paddings of multiple texts
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setPadding(DataHandle, const Vector4&)
+         * for each item in @p handles and @p paddings, but with the layer
+         * marked with @ref LayerState::NeedsDataUpdate just once and only if
+         * @p handles is non-empty. Expects that the @p handles and @p paddings
+         * views have the same size, that the layer was *not* created with
+         * @ref TextLayerFlag::Transformable enabled and that all handles are
+         * valid. The handles are all checked before anything is updated.
+         */
+        void setPadding(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& paddings);
+
+        /**
+         * @brief Set custom paddings of multiple texts assuming they belong to this layer
+         * @m_since_latest
+         *
+         * Like @ref setPadding(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StridedArrayView1D<const Vector4>&)
+         * but without checking that @p handles indeed belong to this layer.
+         * See its documentation for more information.
+         */
+        void setPadding(const Containers::StridedArrayView1D<const LayerDataHandle>& handles, const Containers::StridedArrayView1D<const Vector4>& paddings);
+
         /**
          * @brief Custom text transformation
          *
@@ -2938,6 +3165,16 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
         /* Advertises LayerFeature::Draw but *does not* implement doDraw(),
            that's on the subclass */
         LayerFeatures doFeatures() const override;
+        /* Adds key and text input events for editing */
+        LayerEvents doEvents() const override;
+        /* Reports the CPU-side data, glyph, text, vertex and index storage,
+           GPU usage is on the subclass */
+        MemoryUsage doMemoryUsage() const override;
+        /* Shrinks the CPU-side data, glyph, text, vertex and index
+           storage */
+        void doTrim(std::size_t capacity) override;
+        /* Reserves the CPU-side data storage */
+        void doReserve(std::size_t capacity) override;
 
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
 
@@ -2958,23 +3195,37 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
             #endif
             UnsignedInt id, const TextLayerEditingStyleUniform& uniform, const Containers::Optional<TextLayerStyleUniform>& textUniform, const Vector4& padding);
         MAGNUM_UI_LOCAL DataHandle createInternal(NodeHandle node);
-        MAGNUM_UI_LOCAL void shapeTextInternal(UnsignedInt id, UnsignedInt style, Containers::StringView text, const TextProperties& properties, FontHandle font, TextDataFlags flags);
+        MAGNUM_UI_LOCAL FontHandle fontInternal(
+            #ifndef CORRADE_NO_ASSERT
+            const char* messagePrefix,
+            #endif
+            UnsignedInt style, const TextProperties& properties) const;
+        MAGNUM_UI_LOCAL Text::Alignment alignmentInternal(UnsignedInt style, const TextProperties& properties) const;
+        MAGNUM_UI_LOCAL Containers::ArrayView<Text::FeatureRange> featuresInternal(Implementation::FrameArena& storage, UnsignedInt style, const TextProperties& properties) const;
+        MAGNUM_UI_LOCAL void shapeTextInternal(UnsignedInt id, UnsignedInt style, Containers::StringView text, const TextProperties& properties, FontHandle font, TextDataFlags flags, const Implementation::TextLayerShapeJob* job);
         MAGNUM_UI_LOCAL void shapeRememberTextInternal(
             #ifndef CORRADE_NO_ASSERT
             const char* messagePrefix,
             #endif
-            UnsignedInt id, UnsignedInt style, Containers::StringView text, const TextProperties& properties, TextDataFlags flags);
+            UnsignedInt id, UnsignedInt style, Containers::StringView text, const TextProperties& properties, TextDataFlags flags, const Implementation::TextLayerShapeJob* job);
         MAGNUM_UI_LOCAL void shapeGlyphInternal(
             #ifndef CORRADE_NO_ASSERT
             const char* messagePrefix,
             #endif
             UnsignedInt id, UnsignedInt style, UnsignedInt glyphId, const TextProperties& properties);
+        MAGNUM_UI_LOCAL void removeGlyphRunInternal(UnsignedInt glyphRun);
+        MAGNUM_UI_LOCAL void removeTextRunInternal(UnsignedInt textRun);
+        MAGNUM_UI_LOCAL void removeDeferredTextInternal(UnsignedInt deferredText);
+        MAGNUM_UI_LOCAL void replaceGlyphRunInternal(UnsignedInt id, UnsignedInt previousGlyphRun);
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
         MAGNUM_UI_LOCAL Containers::Pair<UnsignedInt, UnsignedInt> cursorInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL void setCursorInternal(UnsignedInt id, UnsignedInt position, UnsignedInt selection);
+        MAGNUM_UI_LOCAL UnsignedInt cursorForPositionInternal(UnsignedInt id, const Vector2& position, const Vector2& nodeSize) const;
         MAGNUM_UI_LOCAL TextProperties textPropertiesInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL Containers::StringView textInternal(UnsignedInt id) const;
-        MAGNUM_UI_LOCAL void setTextInternal(UnsignedInt id, Containers::StringView text, const TextProperties& properties, TextDataFlags flags);
+        MAGNUM_UI_LOCAL void setTextInternal(UnsignedInt id, Containers::StringView text, const TextProperties& properties, TextDataFlags flags, const Implementation::TextLayerShapeJob* job);
+        MAGNUM_UI_LOCAL void setTextsInternal(Containers::ArrayView<const UnsignedInt> ids, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& properties);
+        MAGNUM_UI_LOCAL void reserveTextsInternal(std::size_t count, std::size_t textSize, std::size_t editableCount, std::size_t editableTextSize);
         MAGNUM_UI_LOCAL void updateTextInternal(UnsignedInt id, UnsignedInt removeOffset, UnsignedInt removeSize, UnsignedInt insertOffset, Containers::StringView text, UnsignedInt cursor, UnsignedInt selection);
         MAGNUM_UI_LOCAL void editTextInternal(UnsignedInt id, TextEdit edit, Containers::StringView text);
         MAGNUM_UI_LOCAL void setGlyphInternal(UnsignedInt id, UnsignedInt glyph, const TextProperties& properties);
@@ -2990,8 +3241,12 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
         /* Can't be MAGNUM_UI_LOCAL otherwise deriving from this class in
            tests causes linker errors */
         LayerStates doState() const override;
-        void doClean(Containers::BitArrayView dataIdsToRemove) override;
+        void doCleanSparse(Containers::BitArrayView dataIdsToRemove, Containers::ArrayView<const UnsignedInt> dataIds) override;
         void doAdvanceAnimations(Nanoseconds time, Containers::MutableBitArrayView activeStorage, const Containers::StridedArrayView1D<Float>& factorStorage, Containers::MutableBitArrayView removeStorage, const Containers::Iterable<AbstractStyleAnimator>& animators) override;
+        void doPointerPressEvent(UnsignedInt dataId, PointerEvent& event) override;
+        void doPointerReleaseEvent(UnsignedInt dataId, PointerEvent& event) override;
+        void doPointerMoveEvent(UnsignedInt dataId, PointerMoveEvent& event) override;
+        void doPointerCancelEvent(UnsignedInt dataId, PointerCancelEvent& event) override;
         void doKeyPressEvent(UnsignedInt dataId, KeyEvent& event) override;
         void doTextInputEvent(UnsignedInt dataId, TextInputEvent& event) override;
 };
@@ -3019,8 +3274,164 @@ enum class TextLayerSharedFlag: UnsignedByte {
      * @ref TextLayerGL::Shared::Shared(Text::GlyphCacheArrayGL&, const Configuration&)
      * or @ref TextLayerGL::Shared::Shared(Text::GlyphCacheArrayGL&&, const Configuration&)
      * constructors.
+     *
+     * The distance field conversion is done on the GPU by
+     * @ref Text::DistanceFieldGlyphCacheArrayGL in each
+     * @ref Text::AbstractGlyphCache::flushImage() call, and only for the
+     * flushed range, not the whole cache texture. Together with
+     * @ref TextLayerSharedFlag::GlyphCacheFillOnDemand that means only the
+     * area of the newly added glyphs gets processed, once for every text with
+     * missing glyphs. Enable @ref TextLayerSharedFlag::GlyphCacheFillDeferred
+     * to batch the conversion to a single pass per font in each
+     * @ref TextLayer::update() instead.
+     */
+    DistanceField = 1 << 0,
+
+    /**
+     * Perform clipping in the shader instead of using a scissor rectangle for
+     * each clip rect. The framebuffer-space clip rect is supplied together
+     * with each glyph and cursor or selection vertex and the fragment shader
+     * discards everything outside of it, which allows all data in a layer to
+     * be drawn with a single draw call regardless of how many clip rects
+     * there are. The visual output is exactly the same as with the default,
+     * on the other hand the clip rects have to be updated on every node
+     * offset or size change and on every framebuffer size change. See also
+     * @ref BaseLayerSharedFlag::ShaderClipping.
+     *
+     * In @ref TextLayerGL the layer then doesn't advertise
+     * @ref LayerFeature::DrawUsesScissor.
+     */
+    ShaderClipping = 1 << 1,
+
+    /**
+     * Render each glyph as a single instance of a static unit quad, with
+     * position, texture coordinates, color and style supplied just once per
+     * glyph instead of once per vertex. Compared to the default this uploads
+     * roughly three times less vertex data and no glyph index data at all,
+     * which is useful for layers with a large amount of text. The visual
+     * output is exactly the same as with the default, including
+     * @ref TextLayerFlag::Transformable. See also
+     * @ref BaseLayerSharedFlag::InstancedQuads.
+     *
+     * In @ref TextLayerGL requires @gl_extension{ARB,base_instance} on
+     * desktop GL, ANGLE_base_vertex_base_instance on OpenGL ES and
+     * @webgl_extension{WEBGL,draw_instanced_base_vertex_base_instance} on
+     * WebGL.
+     */
+    InstancedGlyphs = 1 << 2,
+
+    /**
+     * Fill the glyph cache on demand. When a text is shaped and any of its
+     * glyphs aren't in the glyph cache yet, all of them are rasterized and
+     * added to the cache with a single
+     * @ref Text::AbstractFont::fillGlyphCache() call, which uploads just the
+     * changed area of the cache. The text is then shaped again in order to
+     * reference the newly added glyphs. Thus the cost is paid only the first
+     * time given glyphs are used, there's no additional overhead if all
+     * glyphs are in the cache already. The same is done for single glyphs
+     * created with @ref TextLayer::createGlyph() and
+     * @relativeref{TextLayer,setGlyph()}.
+     *
+     * Can be used only with fonts that support glyph cache filling, fonts
+     * with @ref Text::FontFeature::PreparedGlyphCache and instance-less
+     * fonts are skipped. Glyphs aren't removed from the cache when no longer
+     * used, so if the cache gets full, the fill fails with a message printed
+     * by @ref Text::AbstractFont::fillGlyphCache() and no further glyphs are
+     * added for given font, with the missing glyphs rendering as invalid.
+     * Texts shaped concurrently with
+     * @ref TextLayer::Shared::setShapeExecutor() that use glyphs not present
+     * in the cache are shaped again serially.
+     * @see @ref TextLayerSharedFlag::GlyphCacheFillDeferred
+     */
+    GlyphCacheFillOnDemand = 1 << 3,
+
+    /**
+     * Defer on-demand glyph cache filling to @ref TextLayer::update().
+     * Implies @ref TextLayerSharedFlag::GlyphCacheFillOnDemand. Instead of
+     * filling the cache and shaping the text again every time a text with
+     * missing glyphs is created or changed, the missing glyphs are only
+     * remembered and rendered as invalid until the next
+     * @ref TextLayer::update(), which then fills all glyphs remembered since
+     * the last update with a single @ref Text::AbstractFont::fillGlyphCache()
+     * call for each font, and updates the texts to reference them without
+     * shaping them again. Useful especially when creating many texts at once,
+     * such as when populating a whole UI at startup, and with
+     * @ref TextLayerSharedFlag::DistanceField, where each fill is followed by
+     * a distance field conversion of the updated cache area.
+     *
+     * Single glyphs created with @ref TextLayer::createGlyph() or
+     * @relativeref{TextLayer,setGlyph()} need to be in the cache in order to
+     * be aligned and so are still filled right away. Glyphs are deferred only
+     * for glyph cache font IDs below @cpp 32768 @ce and fonts with at most
+     * @cpp 65536 @ce glyphs, otherwise the behavior is the same as with just
+     * @ref TextLayerSharedFlag::GlyphCacheFillOnDemand.
+     */
+    GlyphCacheFillDeferred = 1 << 4,
+
+    /**
+     * Apply the per-data transformation of layers with
+     * @ref TextLayerFlag::Transformable in the shader instead of transforming
+     * glyph vertices on the CPU. The glyph vertices are then produced relative
+     * to the aligned text origin and a single transformation for each data,
+     * consisting of the translation including the alignment offset and a
+     * combined rotation and scaling, is looked up in the vertex shader. A
+     * @ref TextLayer::setTransformation(), @relativeref{TextLayer,translate()},
+     * @relativeref{TextLayer,rotate()} or @relativeref{TextLayer,scale()}
+     * call thus updates and uploads only the transformations and not the glyph
+     * vertices, which is useful for example for texts that rotate every frame.
+     * Layers without @ref TextLayerFlag::Transformable use an identity
+     * transformation. The visual output is the same as with the default.
+     *
+     * In @ref TextLayerGL the transformations are stored in a floating-point
+     * texture, which is fetched from in the vertex shader.
+     * @m_since_latest
+     */
+    ShaderTransformation = 1 << 5,
+
+    /**
+     * Apply the node opacity in the shader instead of baking it into the
+     * glyph vertex colors. The glyph vertices then reference just the node
+     * they're attached to and the absolute node opacities are looked up in
+     * the vertex shader. A node opacity change, such as when fading in a
+     * whole top-level node with @ref AbstractUserInterface::setNodeOpacity(),
+     * then only uploads the changed opacities and doesn't regenerate and
+     * upload any vertex data. The visual output is the same as with the
+     * default.
+     *
+     * The cursor and selection quads of
+     * @ref TextLayer::Shared::hasEditingStyles() "layers with editing styles"
+     * still have the opacity baked in, so in that case a node opacity change
+     * regenerates the vertex data like without this flag. The node enabled
+     * state affects the style the data is drawn with and thus isn't handled
+     * in the shader.
+     *
+     * In @ref TextLayerGL the opacities are stored in a floating-point
+     * texture, which is fetched from in the vertex shader.
+     * @m_since_latest
+     */
+    ShaderNodeOpacity = 1 << 6,
+
+    /**
+     * Grow the glyph cache when it gets full. Implies
+     * @ref TextLayerSharedFlag::GlyphCacheFillOnDemand. If an on-demand or
+     * deferred glyph cache fill fails because the glyphs don't fit, the
+     * cache is grown by one layer with @ref TextLayer::Shared::growGlyphCache()
+     * and the fill is attempted again, until it succeeds or the growth fails.
+     * In a single fill the cache is grown to at most double its layer count,
+     * after that the behavior is the same as with just
+     * @ref TextLayerSharedFlag::GlyphCacheFillOnDemand. Existing glyphs stay
+     * where they are and only the newly added layers are used for packing new
+     * glyphs, so it's possible to start with a small cache and let it grow
+     * only if the application actually needs it, such as when many fonts or
+     * scripts get used.
+     *
+     * In @ref TextLayerGL the growth is possible only if the shared state
+     * owns the glyph cache, i.e. if it was constructed with
+     * @ref TextLayerGL::Shared::Shared(Text::GlyphCacheArrayGL&&, const Configuration&)
+     * or @ref TextLayerGL::Shared::Shared(Text::DistanceFieldGlyphCacheArrayGL&&, const Configuration&).
+     * @m_since_latest
      */
-    DistanceField = 1 << 0
+    GlyphCacheGrowOnDemand = 1 << 7
 };
 
 /**
@@ -3055,8 +3466,9 @@ In order to update or draw the layer it's expected that @ref setStyle() was
 called.
 
 Pre-filling the glyph cache with appropriate glyphs for a particular font is
-the user responsibility, the implementation currently won't perform that on its
-own, neither it does any on-demand cache filling.
+the user responsibility, unless @ref TextLayerSharedFlag::GlyphCacheFillOnDemand
+is enabled, in which case the glyphs are added to the cache the first time
+they're used.
 */
 class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
     public:
@@ -3117,6 +3529,82 @@ class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
          */
         TextLayerSharedFlags flags() const;
 
+        /**
+         * @brief Shape cache size
+         * @m_since_latest
+         *
+         * Max count of shaped texts kept in the cache, @cpp 0 @ce if the cache
+         * is disabled.
+         * @see @ref Configuration::setShapeCacheSize(),
+         *      @ref shapeCacheUsedCount()
+         */
+        UnsignedInt shapeCacheSize() const;
+
+        /**
+         * @brief Count of shaped texts currently in the cache
+         * @m_since_latest
+         *
+         * Is at most @ref shapeCacheSize().
+         * @see @ref clearShapeCache()
+         */
+        UnsignedInt shapeCacheUsedCount() const;
+
+        /**
+         * @brief Clear the shape cache
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * The cache assumes that the glyphs produced by shaping a text are
+         * already present in the @ref glyphCache() and that the fonts don't
+         * change afterwards. If the glyph cache gets filled only after the
+         * text was shaped, call this function to make the texts shaped again.
+         * Data that were already created aren't affected.
+         */
+        Shared& clearShapeCache();
+
+        /**
+         * @brief Shaper count per font
+         * @m_since_latest
+         *
+         * @see @ref Configuration::setShaperCount(),
+         *      @ref setShapeExecutor()
+         */
+        UnsignedInt shaperCount() const;
+
+        /**
+         * @brief Whether a shape executor is set
+         * @m_since_latest
+         *
+         * @see @ref setShapeExecutor()
+         */
+        bool hasShapeExecutor() const;
+
+        /**
+         * @brief Set an executor for concurrent text shaping
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * The @p executor has the same semantics as
+         * @ref AbstractUserInterface::setUpdateExecutor() --- it's called with
+         * a task count, a task function and a state pointer, and is expected
+         * to call the task function with the state pointer and all indices
+         * from @cpp 0 @ce to the task count (exclusive) exactly once,
+         * potentially from multiple threads concurrently, returning only once
+         * all tasks finish. The same executor can be used for both.
+         *
+         * If @ref shaperCount() is greater than @cpp 1 @ce, the executor is
+         * used by @ref TextLayer::setText(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StringIterable&, const Containers::StridedArrayView1D<const TextProperties>&)
+         * to shape multiple texts concurrently, with each task using its own
+         * shaper instance. The results are then merged in the order the texts
+         * were passed in, so the resulting data are the same as if the texts
+         * were shaped serially. The font plugins are expected to support
+         * multiple shaper instances being used from different threads at the
+         * same time. Pass an empty function to reset the executor. Default is
+         * no executor.
+         * @see @ref Ui-TextLayer-update
+         */
+        Shared& setShapeExecutor(Containers::Function<void(std::size_t count, void(*task)(void* state, std::size_t i), void* state)>&& executor);
+
         /**
          * @brief Glyph cache instance
          *
@@ -3128,6 +3616,30 @@ class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
         Text::AbstractGlyphCache& glyphCache();
         const Text::AbstractGlyphCache& glyphCache() const; /**< @overload */
 
+        /**
+         * @brief Grow the glyph cache
+         * @param layerCount    Count of layers to add
+         * @return Whether the cache was grown
+         * @m_since_latest
+         *
+         * Replaces the @ref glyphCache() with a cache that has @p layerCount
+         * more layers, preserving all fonts and glyphs including their
+         * locations. Layers already present in the cache are treated as fully
+         * occupied, new glyphs are then packed only into the added layers.
+         * Data created with the existing glyphs keep rendering the same way
+         * without any change. Returns @cpp false @ce if the implementation
+         * doesn't support growing the cache, in which case the cache is left
+         * untouched. Expects that @p layerCount is not zero. Called
+         * automatically if @ref TextLayerSharedFlag::GlyphCacheGrowOnDemand is
+         * enabled.
+         *
+         * In case of @ref TextLayerGL the growth is possible only if the
+         * shared state owns the glyph cache. The existing layers are copied
+         * on the GPU side, the reference returned from @ref glyphCache() stays
+         * the same.
+         */
+        bool growGlyphCache(UnsignedInt layerCount);
+
         /**
          * @brief Count of added fonts
          *
@@ -3239,6 +3751,57 @@ class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
         Text::AbstractFont& font(FontHandle handle);
         const Text::AbstractFont& font(FontHandle handle) const; /**< @overload */
 
+        /**
+         * @brief Measure a text
+         * @param style         Style index
+         * @param text          Text
+         * @param properties    Text properties
+         * @return Rectangle occupied by the text and its glyph count
+         * @m_since_latest
+         *
+         * Shapes the text the same way as @ref TextLayer::create() would,
+         * with the font, alignment and features resolved from @p style and
+         * @p properties, but without creating any layer data. The size of
+         * the returned rectangle is the same as @ref TextLayer::size() and
+         * the glyph count the same as @ref TextLayer::glyphCount() of data
+         * created with the same text and properties. Useful for example for
+         * sizing nodes before the data for them are created. Similarly to the
+         * Text library APIs the rectangle has Y up, relative to the origin
+         * used for alignment.
+         *
+         * If the shape cache is enabled, the text is looked up in it first
+         * and the shaping result is saved to it, so creating data with the same
+         * text and properties afterwards doesn't need to shape again. The
+         * result is however not saved if @ref TextLayerSharedFlag::GlyphCacheFillOnDemand
+         * is enabled and some glyphs aren't in the glyph cache yet, as the
+         * glyph cache isn't filled by this function.
+         *
+         * Expects that @ref setStyle() was called, @p style is less than
+         * @ref styleCount() and that either @p properties specify a valid
+         * font handle with a font instance or the style has a font assigned.
+         * Dynamic styles are specific to a particular layer and thus can't be
+         * used here.
+         * @see @ref measureInto()
+         */
+        Containers::Pair<Range2D, UnsignedInt> measure(UnsignedInt style, Containers::StringView text, const TextProperties& properties);
+
+        /**
+         * @brief Measure multiple texts
+         * @param[in] styles        Style indices
+         * @param[in] texts         Texts
+         * @param[in] properties    Text properties
+         * @param[out] rectangles   Where to put rectangles occupied by the
+         *      texts
+         * @param[out] glyphCounts  Where to put glyph counts of the texts
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref measure() for each item but with less
+         * overhead. Expects that all views have the same size. To measure
+         * multiple texts with the same style or properties, use a zero-stride
+         * view, for example with @relativeref{Corrade,Containers::StridedArrayView::broadcasted()}.
+         */
+        void measureInto(const Containers::StridedArrayView1D<const UnsignedInt>& styles, const Containers::StringIterable& texts, const Containers::StridedArrayView1D<const TextProperties>& properties, const Containers::StridedArrayView1D<Range2D>& rectangles, const Containers::StridedArrayView1D<UnsignedInt>& glyphCounts);
+
         /**
          * @brief Set style data with implicit mapping between styles and uniforms
          * @param commonUniform Common style uniform data
@@ -3486,6 +4049,55 @@ class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
         /** @overload */
         Shared& setEditingStyle(const TextLayerCommonEditingStyleUniform& commonUniform, std::initializer_list<TextLayerEditingStyleUniform> uniforms, std::initializer_list<UnsignedInt> styleToUniform, std::initializer_list<Int> styleTextUniforms, std::initializer_list<Vector4> stylePaddings);
 
+        /**
+         * @brief Update style uniform data
+         * @param commonUniform Common style uniform data
+         * @param uniforms      Style uniforms
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Compared to @ref setStyle(), replaces just the uniform data, keeping
+         * fonts, alignment, features, style to uniform mapping, cursor and
+         * selection styles and paddings unchanged. Useful for example for
+         * switching between a dark and a light variant of the same style at
+         * runtime. Expects that @ref setStyle() was called before and that
+         * the @p uniforms view has the same size as @ref styleUniformCount().
+         *
+         * If @ref dynamicStyleCount() is zero, the data are only uploaded to
+         * the uniform buffer, without causing any update in the layers, in
+         * particular no text gets reshaped and no glyph cache gets filled.
+         * Otherwise it causes the same layer state updates as
+         * @ref setStyle().
+         * @see @ref setEditingStyleUniforms(),
+         *      @ref AbstractStyle::applyUniforms()
+         */
+        Shared& setStyleUniforms(const TextLayerCommonStyleUniform& commonUniform, Containers::ArrayView<const TextLayerStyleUniform> uniforms);
+        /** @overload */
+        Shared& setStyleUniforms(const TextLayerCommonStyleUniform& commonUniform, std::initializer_list<TextLayerStyleUniform> uniforms);
+
+        /**
+         * @brief Update editing style uniform data
+         * @param commonUniform Common style uniform data
+         * @param uniforms      Style uniforms
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Compared to @ref setEditingStyle(), replaces just the uniform data,
+         * keeping the style to uniform mapping, text uniforms and paddings
+         * unchanged. Expects that @ref setEditingStyle() was called before
+         * and that the @p uniforms view has the same size as
+         * @ref editingStyleUniformCount().
+         *
+         * If @ref dynamicStyleCount() is zero, the data are only uploaded to
+         * the uniform buffer, without causing any update in the layers.
+         * Otherwise it causes the same layer state updates as
+         * @ref setEditingStyle().
+         * @see @ref setStyleUniforms()
+         */
+        Shared& setEditingStyleUniforms(const TextLayerCommonEditingStyleUniform& commonUniform, Containers::ArrayView<const TextLayerEditingStyleUniform> uniforms);
+        /** @overload */
+        Shared& setEditingStyleUniforms(const TextLayerCommonEditingStyleUniform& commonUniform, std::initializer_list<TextLayerEditingStyleUniform> uniforms);
+
         /* Overloads to remove a WTF factor from method chaining order */
         #ifndef DOXYGEN_GENERATING_OUTPUT
         MAGNUMEXTRAS_UI_ABSTRACTVISUALLAYER_SHARED_SUBCLASS_IMPLEMENTATION()
@@ -3511,6 +4123,11 @@ class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
     private:
         MAGNUM_UI_LOCAL void setStyleInternal(const TextLayerCommonStyleUniform& commonUniform, Containers::ArrayView<const TextLayerStyleUniform> uniforms, const Containers::StridedArrayView1D<const FontHandle>& styleFonts, const Containers::StridedArrayView1D<const Text::Alignment>& styleAlignments, Containers::ArrayView<const TextFeatureValue> styleFeatures, const Containers::StridedArrayView1D<const UnsignedInt>& styleFeatureOffsets, const Containers::StridedArrayView1D<const UnsignedInt>& styleFeatureCounts, const Containers::StridedArrayView1D<const Int>& styleCursorStyles, const Containers::StridedArrayView1D<const Int>& styleSelectionStyles, const Containers::StridedArrayView1D<const Vector4>& stylePaddings);
         MAGNUM_UI_LOCAL void setEditingStyleInternal(const TextLayerCommonEditingStyleUniform& commonUniform, Containers::ArrayView<const TextLayerEditingStyleUniform> uniforms, const Containers::StridedArrayView1D<const Int>& styleTextUniforms, const Containers::StridedArrayView1D<const Vector4>& stylePaddings);
+        MAGNUM_UI_LOCAL Containers::Pair<Range2D, UnsignedInt> measureInternal(
+            #ifndef CORRADE_NO_ASSERT
+            const char* messagePrefix,
+            #endif
+            UnsignedInt style, Containers::StringView text, const TextProperties& properties);
 
         /* The items are guaranteed to have the same size as
            styleUniformCount(). Called only if there are no dynamic styles,
@@ -3523,6 +4140,9 @@ class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
            subsequently combined with dynamic uniforms and uploaded together in
            doDraw(). */
         virtual void doSetEditingStyle(const TextLayerCommonEditingStyleUniform& commonUniform, Containers::ArrayView<const TextLayerEditingStyleUniform> uniforms) = 0;
+        /* Called from growGlyphCache(), the layer count is guaranteed to be
+           non-zero. Default implementation returns false. */
+        virtual bool doGrowGlyphCache(UnsignedInt layerCount);
 };
 
 /**
@@ -3688,10 +4308,59 @@ class MAGNUM_UI_EXPORT TextLayer::Shared::Configuration {
             return setFlags(_flags & ~flags);
         }
 
+        /**
+         * @brief Shape cache size
+         * @m_since_latest
+         */
+        UnsignedInt shapeCacheSize() const { return _shapeCacheSize; }
+
+        /**
+         * @brief Set shape cache size
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * If non-zero, up to @p size most recently shaped texts are kept in a
+         * cache together with their shaped glyphs, and shaping the same text
+         * again with the same font, alignment, script, language, direction
+         * and features copies the glyphs from the cache instead of calling
+         * into the shaper. When the cache is full, the least recently used
+         * text is replaced. The cache is looked up by a linear search, so
+         * the size is meant to be in the order of hundreds at most. Texts
+         * with @ref TextDataFlag::Editable or @ref TextDataFlag::Wrap aren't
+         * cached. Initial value is @cpp 0 @ce, i.e. no cache.
+         * @see @ref Shared::clearShapeCache()
+         */
+        Configuration& setShapeCacheSize(UnsignedInt size) {
+            _shapeCacheSize = size;
+            return *this;
+        }
+
+        /**
+         * @brief Shaper count per font
+         * @m_since_latest
+         */
+        UnsignedInt shaperCount() const { return _shaperCount; }
+
+        /**
+         * @brief Set shaper count per font
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * If greater than @cpp 1 @ce and @ref Shared::setShapeExecutor() is
+         * set, @ref TextLayer::setText(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StringIterable&, const Containers::StridedArrayView1D<const TextProperties>&)
+         * shapes the texts concurrently in up to @p count tasks, each using a
+         * dedicated shaper instance created from given font. Expects that
+         * @p count is at least @cpp 1 @ce. Initial value is @cpp 1 @ce, i.e.
+         * all shaping is done serially.
+         */
+        Configuration& setShaperCount(UnsignedInt count);
+
     private:
         UnsignedInt _styleUniformCount, _styleCount;
         UnsignedInt _editingStyleUniformCount = 0, _editingStyleCount = 0;
         UnsignedInt _dynamicStyleCount = 0;
+        UnsignedInt _shapeCacheSize = 0;
+        UnsignedInt _shaperCount = 1;
         TextLayerSharedFlags _flags;
         bool _dynamicEditingStyles = false;
 };
@@ -26,6 +26,7 @@
 
 #include "TextLayerAnimator.h"
 
+#include <cstddef> /* offsetof() */
 #include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/EnumSet.hpp>
@@ -37,6 +38,8 @@
 #include "Magnum/Ui/TextLayer.h"
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/Implementation/abstractVisualLayerAnimatorState.h"
+#include "Magnum/Ui/Implementation/forEachSetBit.h"
+#include "Magnum/Ui/Implementation/lerpFloats.h"
 #include "Magnum/Ui/Implementation/textLayerState.h"
 
 namespace Magnum { namespace Ui {
@@ -246,6 +249,14 @@ void TextLayerStyleAnimator::createInternal(const AnimationHandle handle, const
     } else animation.hasSelectionStyle = false;
 }
 
+void TextLayerStyleAnimator::doReserve(const std::size_t capacity) {
+    State& state = static_cast<State&>(*_state);
+    arrayReserve(state.animations, capacity);
+    /* The reallocation may have moved the data */
+    state.targetStyles = stridedArrayView(state.animations).slice(&Animation::targetStyle);
+    state.dynamicStyles = stridedArrayView(state.animations).slice(&Animation::dynamicStyle);
+}
+
 void TextLayerStyleAnimator::remove(const AnimationHandle handle) {
     AbstractAnimator::remove(handle);
     removeInternal(animationHandleId(handle));
@@ -393,22 +404,28 @@ Containers::Optional<Containers::Pair<TextLayerStyleUniform, TextLayerStyleUnifo
 
 namespace {
 
+/* The uniforms are interpolated as a single run of floats, excluding the
+   padding at the end */
+static_assert(
+    offsetof(TextLayerStyleUniform, color) == 0 &&
+    offsetof(TextLayerStyleUniform, smoothness) == 10*sizeof(Float),
+    "unexpected TextLayerStyleUniform layout");
+static_assert(
+    offsetof(TextLayerEditingStyleUniform, backgroundColor) == 0 &&
+    offsetof(TextLayerEditingStyleUniform, cornerRadius) == 4*sizeof(Float),
+    "unexpected TextLayerEditingStyleUniform layout");
+
 /* Used for both base and editing text uniforms and for both cursor and
    selection uniforms, extracted here. I feel like this is better than a lambda
    because it doesn't need any capture. */
 TextLayerStyleUniform interpolateUniform(const TextLayerStyleUniform& source, const TextLayerStyleUniform& target, Float factor) {
     TextLayerStyleUniform uniform{NoInit};
-    #define _c(member) uniform.member = Math::lerp(source.member, target.member, factor);
-    _c(color)
-    #undef _c
+    Implementation::lerpFloats(source.color.data(), target.color.data(), factor, uniform.color.data(), 11);
     return uniform;
 }
 TextLayerEditingStyleUniform interpolateUniform(const TextLayerEditingStyleUniform& source, const TextLayerEditingStyleUniform& target, Float factor) {
     TextLayerEditingStyleUniform uniform{NoInit};
-    #define _c(member) uniform.member = Math::lerp(source.member, target.member, factor);
-    _c(backgroundColor)
-    _c(cornerRadius)
-    #undef _c
+    Implementation::lerpFloats(source.backgroundColor.data(), target.backgroundColor.data(), factor, uniform.backgroundColor.data(), 5);
     return uniform;
 }
 
@@ -448,10 +465,7 @@ TextLayerStyleAnimations TextLayerStyleAnimator::advance(const Containers::BitAr
     const Containers::StridedArrayView1D<const LayerDataHandle> layerData = this->layerData();
 
     TextLayerStyleAnimations animations;
-    /** @todo some way to iterate set bits */
-    for(std::size_t i = 0; i != active.size(); ++i) {
-        if(!active[i]) continue;
-
+    Implementation::forEachSetBit(active, [&](const std::size_t i) {
         Animation& animation = state.animations[i];
         /* The handle is assumed to be valid if not null, i.e. that appropriate
            dataClean() got called before advance() */
@@ -467,7 +481,7 @@ TextLayerStyleAnimations TextLayerStyleAnimator::advance(const Containers::BitAr
                 dataStyles[layerDataHandleId(data)] = animation.targetStyle;
                 animations |= TextLayerStyleAnimation::Style;
             }
-            continue;
+            return;
         }
 
         /* The animation is running, allocate a dynamic style if it isn't yet
@@ -489,7 +503,7 @@ TextLayerStyleAnimations TextLayerStyleAnimator::advance(const Containers::BitAr
                it couldn't animate feels silly. */
             const Containers::Optional<UnsignedInt> style = state.layer->allocateDynamicStyle(animationHandle(handle(), i, generations()[i]));
             if(!style)
-                continue;
+                return;
 
             /* Initialize the dynamic style font, alignment and features from
                the source style. Those can't reasonably get animated in any
@@ -597,7 +611,7 @@ TextLayerStyleAnimations TextLayerStyleAnimator::advance(const Containers::BitAr
                 animations |= TextLayerStyleAnimation::Uniform;
             } else dynamicStyleUniforms[textStyleId] = animation.targetSelectionTextUniform;
         }
-    }
+    });
 
     return animations;
 }
@@ -627,6 +627,8 @@ class MAGNUM_UI_EXPORT TextLayerStyleAnimator: public AbstractVisualLayerStyleAn
 
         MAGNUM_UI_LOCAL void createInternal(AnimationHandle handle, UnsignedInt sourceStyle, UnsignedInt targetStyle, Float(*easing)(Float));
 
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
+
         /* used by foo(AnimationHandle) and foo(AnimatorDataHandle) */
         MAGNUM_UI_LOCAL Containers::Optional<Containers::Pair<TextLayerEditingStyleUniform, TextLayerEditingStyleUniform>> cursorUniformsInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL Containers::Optional<Containers::Pair<Vector4, Vector4>> cursorPaddingsInternal(UnsignedInt id) const;
@@ -28,9 +28,15 @@
 
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/Iterable.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/Triple.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Resource.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
 #include <Magnum/GL/Buffer.h>
@@ -38,14 +44,22 @@
 #ifndef MAGNUM_TARGET_GLES
 #include <Magnum/GL/Extensions.h>
 #endif
+#include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderer.h>
 #include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureArray.h>
+#include <Magnum/GL/TextureFormat.h>
 #include <Magnum/GL/Version.h>
 #include <Magnum/Text/DistanceFieldGlyphCacheGL.h>
+#include <Magnum/TextureTools/Atlas.h>
 
+#include "Magnum/Ui/Implementation/asyncShaderProgramGL.h"
+#include "Magnum/Ui/Implementation/framebufferClipRect.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 #include "Magnum/Ui/Implementation/textLayerState.h"
+#include "Magnum/Ui/Implementation/uploadChangedRangesGL.h"
 
 #ifdef MAGNUM_UI_BUILD_STATIC
 static void importShaderResources() {
@@ -59,16 +73,30 @@ using namespace Containers::Literals;
 
 namespace {
 
-class TextShaderGL: public GL::AbstractShaderProgram {
+/* With ShaderTransformation the per-data transformations are stored in rows
+   of this many items in the transformation texture */
+constexpr Int TransformationTextureWidth = 256;
+
+/* With ShaderNodeOpacity the absolute node opacities are stored in rows of
+   this many items in the node opacity texture */
+constexpr Int NodeOpacityTextureWidth = 256;
+
+class TextShaderGL: public Implementation::AsyncShaderProgramGL {
     private:
         enum: Int {
             GlyphTextureBinding = 0,
+            TransformationTextureBinding = 1,
+            NodeOpacityTextureBinding = 2,
             StyleBufferBinding = 0
         };
 
     public:
         enum Flag: UnsignedByte {
-            DistanceField = 1 << 0
+            DistanceField = 1 << 0,
+            ShaderClipping = 1 << 1,
+            InstancedGlyphs = 1 << 2,
+            Transformation = 1 << 3,
+            NodeOpacity = 1 << 4
         };
 
         typedef Containers::EnumSet<Flag> Flags;
@@ -78,31 +106,69 @@ class TextShaderGL: public GL::AbstractShaderProgram {
         typedef GL::Attribute<2, Vector4> Color4;
         typedef GL::Attribute<3, UnsignedInt> Style;
         typedef GL::Attribute<4, Float> Scale;
+        /* Only if ShaderClipping is set, in a separate buffer */
+        typedef GL::Attribute<5, Vector4> ClipRect;
+        /* Only if InstancedGlyphs are set, replacing Position.
+           TextureCoordinates are then the minimal coordinates and the glyph
+           cache layer. */
+        typedef GL::Attribute<0, Vector2> InstancedGlyphQuadCorner;
+        typedef GL::Attribute<6, Vector4> InstancedGlyphCorners01;
+        typedef GL::Attribute<7, Vector2> InstancedGlyphCorner2;
+        typedef GL::Attribute<8, Vector2> InstancedGlyphTextureCoordinateMax;
+        /* Only if Transformation is set, in a separate buffer */
+        typedef GL::Attribute<9, UnsignedInt> TransformationId;
+        /* Only if NodeOpacity is set, in a separate buffer */
+        typedef GL::Attribute<10, UnsignedInt> NodeId;
 
         explicit TextShaderGL(Flags flags, UnsignedInt styleCount);
 
+        /* Waits for the compilation submitted in the constructor to finish
+           and performs the post-link setup. Called implicitly from all
+           setters except setProjection(), which gets applied here if it was
+           called before. */
+        void finish();
+
         TextShaderGL& setProjection(const Vector2& scaling, const Float pixelScaling, const Float distanceFieldScaling) {
             /* XY is Y-flipped scale from the UI size to the 2x2 unit square,
                the shader then translates by (-1, 1) on its own to put the
                origin at center. Z and W is the distance field value delta
                corresponding to, when multiplied with per-text-run scale, one
                framebuffer pixel and one UI unit. */
-            setUniform(_projectionUniform, Vector4{2.0f/scaling.x(), -2.0f/scaling.y(), pixelScaling*distanceFieldScaling, distanceFieldScaling});
+            _projection = Vector4{2.0f/scaling.x(), -2.0f/scaling.y(), pixelScaling*distanceFieldScaling, distanceFieldScaling};
+            /* If the shader is still compiling, it's set in finish() */
+            if(!isCompilePending())
+                setUniform(_projectionUniform, _projection);
             return *this;
         }
 
         TextShaderGL& bindGlyphTexture(GL::Texture2DArray& texture) {
+            finish();
             texture.bind(GlyphTextureBinding);
             return *this;
         }
 
         TextShaderGL& bindStyleBuffer(GL::Buffer& buffer) {
+            finish();
             buffer.bind(GL::Buffer::Target::Uniform, StyleBufferBinding);
             return *this;
         }
 
+        TextShaderGL& bindTransformationTexture(GL::Texture2D& texture) {
+            finish();
+            texture.bind(TransformationTextureBinding);
+            return *this;
+        }
+
+        TextShaderGL& bindNodeOpacityTexture(GL::Texture2D& texture) {
+            finish();
+            texture.bind(NodeOpacityTextureBinding);
+            return *this;
+        }
+
     private:
+        Flags _flags;
         Int _projectionUniform = 0;
+        Vector4 _projection;
 };
 
 #ifdef CORRADE_TARGET_CLANG
@@ -114,10 +180,14 @@ CORRADE_ENUMSET_OPERATORS(TextShaderGL::Flags)
 #pragma clang diagnostic pop
 #endif
 
-TextShaderGL::TextShaderGL(const Flags flags, const UnsignedInt styleCount) {
+TextShaderGL::TextShaderGL(const Flags flags, const UnsignedInt styleCount): _flags{flags} {
     GL::Context& context = GL::Context::current();
     #ifndef MAGNUM_TARGET_GLES
     MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
+    /* Drawing a subset of the instances for each clip rect needs a base
+       instance */
+    if(flags >= Flag::InstancedGlyphs)
+        MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::base_instance);
     #endif
 
     #ifdef MAGNUM_UI_BUILD_STATIC
@@ -141,41 +211,44 @@ TextShaderGL::TextShaderGL(const Flags flags, const UnsignedInt styleCount) {
     GL::Shader vert{version, GL::Shader::Type::Vertex};
     vert.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
         .addSource(flags >= Flag::DistanceField ? "#define DISTANCE_FIELD\n"_s : ""_s)
+        .addSource(flags >= Flag::ShaderClipping ? "#define SHADER_CLIPPING\n"_s : ""_s)
+        .addSource(flags >= Flag::InstancedGlyphs ? "#define INSTANCED_GLYPHS\n"_s : ""_s)
+        .addSource(flags >= Flag::Transformation ? Utility::format("#define TRANSFORMATION\n#define TRANSFORMATION_TEXTURE_WIDTH {}\n", TransformationTextureWidth) : Containers::String{})
+        .addSource(flags >= Flag::NodeOpacity ? Utility::format("#define NODE_OPACITY\n#define NODE_OPACITY_TEXTURE_WIDTH {}\n", NodeOpacityTextureWidth) : Containers::String{})
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("TextShader.vert"_s));
 
     GL::Shader frag{version, GL::Shader::Type::Fragment};
     frag.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
         .addSource(flags >= Flag::DistanceField ? "#define DISTANCE_FIELD\n"_s : ""_s)
+        .addSource(flags >= Flag::ShaderClipping ? "#define SHADER_CLIPPING\n"_s : ""_s)
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("TextShader.frag"_s));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+    submitCompileLink(Utility::move(vert), Utility::move(frag), version);
+}
 
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+void TextShaderGL::finish() {
+    if(!checkCompileLink())
+        return;
 
-    #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
-    #endif
-    {
+    if(!hasExplicitUniformLocations()) {
         _projectionUniform = uniformLocation("projection"_s);
     }
 
-    #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::shading_language_420pack>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
-    #endif
-    {
+    if(!hasExplicitBindings()) {
         setUniform(uniformLocation("glyphTextureData"_s), GlyphTextureBinding);
+        if(_flags >= Flag::Transformation)
+            setUniform(uniformLocation("transformationTextureData"_s), TransformationTextureBinding);
+        if(_flags >= Flag::NodeOpacity)
+            setUniform(uniformLocation("nodeOpacityTextureData"_s), NodeOpacityTextureBinding);
         setUniformBlockBinding(uniformBlockIndex("Style"_s), StyleBufferBinding);
     }
+
+    setUniform(_projectionUniform, _projection);
 }
 
-class TextEditingShaderGL: public GL::AbstractShaderProgram {
+class TextEditingShaderGL: public Implementation::AsyncShaderProgramGL {
     private:
         enum: Int {
             /* The base shader uses binding 0, make it possible to bind both at
@@ -184,33 +257,61 @@ class TextEditingShaderGL: public GL::AbstractShaderProgram {
         };
 
     public:
+        enum Flag: UnsignedByte {
+            ShaderClipping = 1 << 0
+        };
+
+        typedef Containers::EnumSet<Flag> Flags;
+
         typedef GL::Attribute<0, Vector2> Position;
         typedef GL::Attribute<1, Vector2> CenterDistance;
         typedef GL::Attribute<2, Float> Opacity;
         typedef GL::Attribute<3, UnsignedInt> Style;
+        /* Only if ShaderClipping is set, in a separate buffer */
+        typedef GL::Attribute<4, Vector4> ClipRect;
+
+        explicit TextEditingShaderGL(NoCreateT): Implementation::AsyncShaderProgramGL{NoCreate} {}
+        explicit TextEditingShaderGL(Flags flags, UnsignedInt styleCount);
 
-        explicit TextEditingShaderGL(NoCreateT): GL::AbstractShaderProgram{NoCreate} {}
-        explicit TextEditingShaderGL(UnsignedInt styleCount);
+        /* Waits for the compilation submitted in the constructor to finish
+           and performs the post-link setup. Called implicitly from all
+           setters except setProjection(), which gets applied here if it was
+           called before. */
+        void finish();
 
         TextEditingShaderGL& setProjection(const Vector2& scaling, const Float pixelScaling) {
             /* XY is Y-flipped scale from the UI size to the 2x2 unit square,
                the shader then translates by (-1, 1) on its own to put the
                origin at center. Z is multiplied with the pixel smoothness
                value to get the smoothness in actual UI units. */
-            setUniform(_projectionUniform, Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling});
+            _projection = Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling};
+            /* If the shader is still compiling, it's set in finish() */
+            if(!isCompilePending())
+                setUniform(_projectionUniform, _projection);
             return *this;
         }
 
         TextEditingShaderGL& bindStyleBuffer(GL::Buffer& buffer) {
+            finish();
             buffer.bind(GL::Buffer::Target::Uniform, StyleBufferBinding);
             return *this;
         }
 
     private:
         Int _projectionUniform = 0;
+        Vector3 _projection;
 };
 
-TextEditingShaderGL::TextEditingShaderGL(const UnsignedInt styleCount) {
+#ifdef CORRADE_TARGET_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-function"
+#endif
+CORRADE_ENUMSET_OPERATORS(TextEditingShaderGL::Flags)
+#ifdef CORRADE_TARGET_CLANG
+#pragma clang diagnostic pop
+#endif
+
+TextEditingShaderGL::TextEditingShaderGL(const Flags flags, const UnsignedInt styleCount) {
     GL::Context& context = GL::Context::current();
     #ifndef MAGNUM_TARGET_GLES
     MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
@@ -236,36 +337,32 @@ TextEditingShaderGL::TextEditingShaderGL(const UnsignedInt styleCount) {
 
     GL::Shader vert{version, GL::Shader::Type::Vertex};
     vert.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
+        .addSource(flags >= Flag::ShaderClipping ? "#define SHADER_CLIPPING\n"_s : ""_s)
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("TextEditingShader.vert"_s));
 
     GL::Shader frag{version, GL::Shader::Type::Fragment};
     frag.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
+        .addSource(flags >= Flag::ShaderClipping ? "#define SHADER_CLIPPING\n"_s : ""_s)
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("TextEditingShader.frag"_s));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+    submitCompileLink(Utility::move(vert), Utility::move(frag), version);
+}
 
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+void TextEditingShaderGL::finish() {
+    if(!checkCompileLink())
+        return;
 
-    #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
-    #endif
-    {
+    if(!hasExplicitUniformLocations()) {
         _projectionUniform = uniformLocation("projection"_s);
     }
 
-    #ifndef MAGNUM_TARGET_GLES
-    if(!context.isExtensionSupported<GL::Extensions::ARB::shading_language_420pack>())
-    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
-    if(version < GL::Version::GLES310)
-    #endif
-    {
+    if(!hasExplicitBindings()) {
         setUniformBlockBinding(uniformBlockIndex("Style"_s), StyleBufferBinding);
     }
+
+    setUniform(_projectionUniform, _projection);
 }
 
 }
@@ -293,6 +390,9 @@ struct TextLayerGL::Shared::State: TextLayer::Shared::State {
        layer has its own copies instead */
     GL::Buffer styleBuffer{NoCreate};
     GL::Buffer editingStyleBuffer{NoCreate};
+    /* Created only if Flag::InstancedGlyphs is enabled, contains corners of
+       a unit quad shared by all layers */
+    GL::Buffer instancedGlyphCornerBuffer{NoCreate};
     /* If not zero, a distance field glyph cache is used and this describes a
        distance field value delta that corresponds to one UI unit if a glyph is
        rendered at exactly the size in UI units it has pixels in the cache.
@@ -305,7 +405,11 @@ struct TextLayerGL::Shared::State: TextLayer::Shared::State {
 TextLayerGL::Shared::State::State(Shared& self, Text::AbstractGlyphCache& glyphCache, const Configuration& configuration):
     TextLayer::Shared::State{self, glyphCache, configuration},
     shader{
-        configuration.flags() >= TextLayerSharedFlag::DistanceField ? TextShaderGL::Flag::DistanceField : TextShaderGL::Flags{},
+        (configuration.flags() >= TextLayerSharedFlag::DistanceField ? TextShaderGL::Flag::DistanceField : TextShaderGL::Flags{})|
+        (configuration.flags() >= TextLayerSharedFlag::ShaderClipping ? TextShaderGL::Flag::ShaderClipping : TextShaderGL::Flags{})|
+        (configuration.flags() >= TextLayerSharedFlag::InstancedGlyphs ? TextShaderGL::Flag::InstancedGlyphs : TextShaderGL::Flags{})|
+        (configuration.flags() >= TextLayerSharedFlag::ShaderTransformation ? TextShaderGL::Flag::Transformation : TextShaderGL::Flags{})|
+        (configuration.flags() >= TextLayerSharedFlag::ShaderNodeOpacity ? TextShaderGL::Flag::NodeOpacity : TextShaderGL::Flags{}),
         /* If dynamic editing styles are enabled, there's two extra styles for
            each dynamic style, one reserved for under-cursor text and one for
            selected text. If there are no dynamic styles, the editing styles
@@ -319,7 +423,27 @@ TextLayerGL::Shared::State::State(Shared& self, Text::AbstractGlyphCache& glyphC
     if(hasEditingStyles)
         /* Each dynamic style has two associated editing styles, one for cursor
            and one for selection */
-        editingShader = TextEditingShaderGL{configuration.editingStyleUniformCount() + 2*configuration.dynamicStyleCount()};
+        editingShader = TextEditingShaderGL{
+            configuration.flags() >= TextLayerSharedFlag::ShaderClipping ? TextEditingShaderGL::Flag::ShaderClipping : TextEditingShaderGL::Flags{},
+            configuration.editingStyleUniformCount() + 2*configuration.dynamicStyleCount()};
+    if(configuration.flags() >= TextLayerSharedFlag::InstancedGlyphs) {
+        /* Drawn as a triangle strip, the X and Y of the corner correspond to
+           the bits of the vertex index in the non-instanced glyph quads,
+           which are produced Y up
+
+           1---3
+           |\  |
+           | \ |
+           |  \|
+           0---2 */
+        const Vector2 corners[]{
+            {0.0f, 0.0f},
+            {0.0f, 1.0f},
+            {1.0f, 0.0f},
+            {1.0f, 1.0f}
+        };
+        instancedGlyphCornerBuffer = GL::Buffer{GL::Buffer::TargetHint::Array, corners};
+    }
 }
 
 TextLayerGL::Shared::State::State(Shared& self, Text::GlyphCacheArrayGL& glyphCache, const Configuration& configuration): State{self, static_cast<Text::AbstractGlyphCache&>(glyphCache), configuration} {
@@ -386,6 +510,14 @@ TextLayerGL::Shared::Shared(Text::DistanceFieldGlyphCacheArrayGL&& glyphCache, c
 
 TextLayerGL::Shared::Shared(NoCreateT) noexcept: TextLayer::Shared{NoCreate} {}
 
+bool TextLayerGL::Shared::isCompileFinished() {
+    auto& state = static_cast<State&>(*_state);
+    /* The editing shader is NoCreate'd if there are no editing styles and
+       reports the compilation as finished */
+    return state.shader.isCompileFinished() &&
+        state.editingShader.isCompileFinished();
+}
+
 TextLayerGL::Shared& TextLayerGL::Shared::setStyle(const TextLayerCommonStyleUniform& commonUniform, const Containers::ArrayView<const TextLayerStyleUniform> uniforms, const Containers::StridedArrayView1D<const FontHandle>& fonts, const Containers::StridedArrayView1D<const Text::Alignment>& alignments, const Containers::ArrayView<const TextFeatureValue> features, const Containers::StridedArrayView1D<const UnsignedInt>& featureOffsets, const Containers::StridedArrayView1D<const UnsignedInt>& featureCounts, const Containers::StridedArrayView1D<const Int>& cursorStyles, const Containers::StridedArrayView1D<const Int>& selectionStyles, const Containers::StridedArrayView1D<const Vector4>& paddings) {
     return static_cast<Shared&>(TextLayer::Shared::setStyle(commonUniform, uniforms, fonts, alignments, features, featureOffsets, featureCounts, cursorStyles, selectionStyles, paddings));
 }
@@ -422,6 +554,102 @@ void TextLayerGL::Shared::doSetEditingStyle(const TextLayerCommonEditingStyleUni
     state.editingStyleBuffer.setSubData(sizeof(TextLayerCommonEditingStyleUniform), uniforms);
 }
 
+namespace {
+
+/* Copies fonts, glyphs, atlas state and image contents of a glyph cache to a
+   new one that has more layers. The glyphs are added in the same order so
+   their cache-global IDs stay the same and data referencing them don't need
+   to be updated. The layers present in the original cache are marked as fully
+   occupied as there's no way to extract the actual free space from the atlas
+   packer, so new glyphs get packed only into the newly added layers. */
+void growGlyphCacheInto(Text::GlyphCacheArrayGL& from, Text::GlyphCacheArrayGL& to) {
+    const Vector3i size = from.size();
+    CORRADE_INTERNAL_ASSERT(to.size().xy() == size.xy() && to.size().z() > size.z());
+
+    /* Fonts, in the same order to have the same IDs */
+    for(UnsignedInt i = 0; i != from.fontCount(); ++i)
+        to.addFont(from.fontGlyphCount(i), from.fontPointer(i));
+
+    /* Glyph ID 0 is the invalid glyph, the others are added in the order of
+       their cache-global IDs, which have to be looked up from all fonts
+       first */
+    {
+        const Containers::Triple<Vector2i, Int, Range2Di> invalid = from.glyph(0);
+        to.setInvalidGlyph(invalid.first(), invalid.second(), invalid.third());
+    }
+    Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> glyphFonts{NoInit, from.glyphCount()};
+    for(UnsignedInt i = 0; i != from.fontCount(); ++i) {
+        for(UnsignedInt j = 0, jMax = from.fontGlyphCount(i); j != jMax; ++j) {
+            if(const UnsignedInt glyphId = from.glyphId(i, j))
+                glyphFonts[glyphId] = {i, j};
+        }
+    }
+    for(UnsignedInt i = 1; i != glyphFonts.size(); ++i) {
+        const Containers::Triple<Vector2i, Int, Range2Di> glyph = from.glyph(i);
+        CORRADE_INTERNAL_ASSERT_OUTPUT(to.addGlyph(glyphFonts[i].first(), glyphFonts[i].second(), glyph.first(), glyph.second(), glyph.third()) == i);
+    }
+
+    /* Occupy the original layers fully in the atlas. Has to be done with
+       padding and rotations disabled for the rectangles to fit exactly. */
+    {
+        TextureTools::AtlasLandfill& atlas = to.atlas();
+        const TextureTools::AtlasLandfillFlags flags = atlas.flags();
+        const Vector2i padding = atlas.padding();
+        atlas.setFlags({})
+             .setPadding({});
+        const Containers::Array<Vector2i> sizes{DirectInit, std::size_t(size.z()), size.xy()};
+        Containers::Array<Vector3i> offsets{NoInit, std::size_t(size.z())};
+        CORRADE_INTERNAL_ASSERT_OUTPUT(atlas.add(Containers::stridedArrayView(sizes), Containers::stridedArrayView(offsets)));
+        atlas.setFlags(flags)
+             .setPadding(padding);
+    }
+
+    /* Copy the CPU-side image and then the GPU texture contents, layer by
+       layer through a framebuffer. The processed size is what's in the
+       texture. */
+    Utility::copy(from.image().pixels(), to.image().pixels().prefix(size.z()));
+    const Vector2i processedSize = from.processedSize().xy();
+    GL::Framebuffer framebuffer{{{}, processedSize}};
+    for(Int layer = 0; layer != size.z(); ++layer) {
+        framebuffer.attachTextureLayer(GL::Framebuffer::ColorAttachment{0}, from.texture(), 0, layer);
+        framebuffer.copySubImage({{}, processedSize}, to.texture(), 0, {0, 0, layer});
+    }
+}
+
+}
+
+bool TextLayerGL::Shared::doGrowGlyphCache(const UnsignedInt layerCount) {
+    auto& state = static_cast<State&>(*_state);
+
+    /* Only an owned glyph cache can be replaced, as the base state and the
+       layers reference it. The new instance is move-assigned to the same
+       location so the references stay valid. */
+    if(state.glyphCacheStorage) {
+        Text::GlyphCacheArrayGL& glyphCache = *state.glyphCacheStorage;
+        /* Caches with a different processed format or size can't be
+           constructed through the public API, so there's no way to grow
+           them */
+        if(glyphCache.processedFormat() != glyphCache.format() ||
+           glyphCache.processedSize() != glyphCache.size())
+            return false;
+
+        Text::GlyphCacheArrayGL grown{glyphCache.format(), glyphCache.size() + Vector3i::zAxis(Int(layerCount)), glyphCache.padding()};
+        growGlyphCacheInto(glyphCache, grown);
+        glyphCache = Utility::move(grown);
+        return true;
+    }
+
+    if(state.distanceFieldGlyphCacheStorage) {
+        Text::DistanceFieldGlyphCacheArrayGL& glyphCache = *state.distanceFieldGlyphCacheStorage;
+        Text::DistanceFieldGlyphCacheArrayGL grown{glyphCache.size() + Vector3i::zAxis(Int(layerCount)), glyphCache.processedSize().xy(), glyphCache.radius()};
+        growGlyphCacheInto(glyphCache, grown);
+        glyphCache = Utility::move(grown);
+        return true;
+    }
+
+    return false;
+}
+
 struct TextLayerGL::State: TextLayer::State {
     explicit State(Shared::State& shared, const TextLayerFlags flags): TextLayer::State{shared, flags} {}
 
@@ -434,6 +662,44 @@ struct TextLayerGL::State: TextLayer::State {
     GL::Buffer editingVertexBuffer{NoCreate}, editingIndexBuffer{NoCreate};
     GL::Mesh editingMesh{NoCreate};
 
+    /* Used only if Flag::ShaderClipping is enabled, the editing variants only
+       if shared.hasEditingStyles is set as well. Framebuffer-space clip rect
+       min and max for each glyph and editing vertex. */
+    GL::Buffer clipRectBuffer{NoCreate}, editingClipRectBuffer{NoCreate};
+    Containers::Array<Vector4> clipRects, editingClipRects;
+
+    /* Used only if Flag::ShaderTransformation is enabled. Data ID for each
+       glyph vertex, used to index the transformation texture, which is
+       created during the first doUpdate() with any data and recreated with
+       more rows when the data count grows beyond its capacity. */
+    GL::Buffer transformationIdBuffer{NoCreate};
+    Containers::Array<UnsignedInt> transformationIds;
+    GL::Texture2D transformationTexture{NoCreate};
+    Int transformationTextureRows = 0;
+
+    /* Used only if Flag::ShaderNodeOpacity is enabled. Node ID for each glyph
+       vertex, used to index the node opacity texture, which is created and
+       recreated the same way as the transformation texture. The opacities
+       are copied to a contiguous array padded to whole texture rows, which
+       is then compared to what was uploaded last time. */
+    GL::Buffer nodeIdBuffer{NoCreate};
+    Containers::Array<UnsignedInt> nodeIds;
+    GL::Texture2D nodeOpacityTexture{NoCreate};
+    Int nodeOpacityTextureRows = 0;
+    Containers::Array<Float> nodeOpacities, uploadedNodeOpacities;
+
+    /* Copies of what was uploaded to each buffer above last time and the
+       buffer capacities, used to upload only the ranges that changed since
+       and to reallocate the buffers only when they need to grow */
+    Containers::Array<char> uploadedVertices, uploadedIndices,
+        uploadedEditingVertices, uploadedEditingIndices,
+        uploadedClipRects, uploadedEditingClipRects,
+        uploadedTransformationIds, uploadedNodeIds;
+    std::size_t vertexBufferCapacity = 0, indexBufferCapacity = 0,
+        editingVertexBufferCapacity = 0, editingIndexBufferCapacity = 0,
+        clipRectBufferCapacity = 0, editingClipRectBufferCapacity = 0,
+        transformationIdBufferCapacity = 0, nodeIdBufferCapacity = 0;
+
     /* Used only if shared.dynamicStyleCount is non-zero (and then also
        shared.hasEditingStyles is set in case of editingStyleBuffer), in which
        case it's created during the first doUpdate(). Even though the size is
@@ -447,20 +713,75 @@ struct TextLayerGL::State: TextLayer::State {
 TextLayerGL::TextLayerGL(const LayerHandle handle, Shared& sharedState_, const TextLayerFlags flags): TextLayer{handle, Containers::pointer<State>(static_cast<Shared::State&>(*sharedState_._state), flags)} {
     auto& state = static_cast<State&>(*_state);
     auto& sharedState = static_cast<Shared::State&>(state.shared);
-    if(sharedState.flags >= TextLayerSharedFlag::DistanceField)
-        state.mesh.addVertexBuffer(state.vertexBuffer, 0,
-            TextShaderGL::Position{},
-            TextShaderGL::TextureCoordinates{},
-            TextShaderGL::Color4{},
-            TextShaderGL::Style{},
-            TextShaderGL::Scale{});
-    else
-        state.mesh.addVertexBuffer(state.vertexBuffer, 0,
-            TextShaderGL::Position{},
-            TextShaderGL::TextureCoordinates{},
-            TextShaderGL::Color4{},
-            TextShaderGL::Style{});
-    state.mesh.setIndexBuffer(state.indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+    if(sharedState.flags >= TextLayerSharedFlag::InstancedGlyphs) {
+        state.mesh
+            .setPrimitive(GL::MeshPrimitive::TriangleStrip)
+            .setCount(4)
+            .addVertexBuffer(sharedState.instancedGlyphCornerBuffer, 0,
+                TextShaderGL::InstancedGlyphQuadCorner{});
+        if(sharedState.flags >= TextLayerSharedFlag::DistanceField)
+            state.mesh.addVertexBufferInstanced(state.vertexBuffer, 1, 0,
+                TextShaderGL::InstancedGlyphCorners01{},
+                TextShaderGL::InstancedGlyphCorner2{},
+                TextShaderGL::TextureCoordinates{},
+                TextShaderGL::InstancedGlyphTextureCoordinateMax{},
+                TextShaderGL::Color4{},
+                TextShaderGL::Style{},
+                TextShaderGL::Scale{});
+        else
+            state.mesh.addVertexBufferInstanced(state.vertexBuffer, 1, 0,
+                TextShaderGL::InstancedGlyphCorners01{},
+                TextShaderGL::InstancedGlyphCorner2{},
+                TextShaderGL::TextureCoordinates{},
+                TextShaderGL::InstancedGlyphTextureCoordinateMax{},
+                TextShaderGL::Color4{},
+                TextShaderGL::Style{});
+    } else {
+        if(sharedState.flags >= TextLayerSharedFlag::DistanceField)
+            state.mesh.addVertexBuffer(state.vertexBuffer, 0,
+                TextShaderGL::Position{},
+                TextShaderGL::TextureCoordinates{},
+                TextShaderGL::Color4{},
+                TextShaderGL::Style{},
+                TextShaderGL::Scale{});
+        else
+            state.mesh.addVertexBuffer(state.vertexBuffer, 0,
+                TextShaderGL::Position{},
+                TextShaderGL::TextureCoordinates{},
+                TextShaderGL::Color4{},
+                TextShaderGL::Style{});
+        state.mesh.setIndexBuffer(state.indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+    }
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderClipping) {
+        state.clipRectBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
+        /* With instanced glyphs there's one clip rect for each instance */
+        if(sharedState.flags >= TextLayerSharedFlag::InstancedGlyphs)
+            state.mesh.addVertexBufferInstanced(state.clipRectBuffer, 1, 0,
+                TextShaderGL::ClipRect{});
+        else
+            state.mesh.addVertexBuffer(state.clipRectBuffer, 0,
+                TextShaderGL::ClipRect{});
+    }
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderTransformation) {
+        state.transformationIdBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
+        /* Same as clip rects, with instanced glyphs there's one ID for each
+           instance */
+        if(sharedState.flags >= TextLayerSharedFlag::InstancedGlyphs)
+            state.mesh.addVertexBufferInstanced(state.transformationIdBuffer, 1, 0,
+                TextShaderGL::TransformationId{});
+        else
+            state.mesh.addVertexBuffer(state.transformationIdBuffer, 0,
+                TextShaderGL::TransformationId{});
+    }
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderNodeOpacity) {
+        state.nodeIdBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
+        if(sharedState.flags >= TextLayerSharedFlag::InstancedGlyphs)
+            state.mesh.addVertexBufferInstanced(state.nodeIdBuffer, 1, 0,
+                TextShaderGL::NodeId{});
+        else
+            state.mesh.addVertexBuffer(state.nodeIdBuffer, 0,
+                TextShaderGL::NodeId{});
+    }
 
     if(sharedState.hasEditingStyles) {
         state.editingVertexBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
@@ -472,29 +793,98 @@ TextLayerGL::TextLayerGL(const LayerHandle handle, Shared& sharedState_, const T
             TextEditingShaderGL::Opacity{},
             TextEditingShaderGL::Style{});
         state.editingMesh.setIndexBuffer(state.editingIndexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+        if(sharedState.flags >= TextLayerSharedFlag::ShaderClipping) {
+            state.editingClipRectBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
+            state.editingMesh.addVertexBuffer(state.editingClipRectBuffer, 0,
+                TextEditingShaderGL::ClipRect{});
+        }
     }
 }
 
+MemoryUsage TextLayerGL::doMemoryUsage() const {
+    const State& state = static_cast<const State&>(*_state);
+    MemoryUsage out = TextLayer::doMemoryUsage();
+    Implementation::addArrayMemoryUsage(out, state.clipRects);
+    Implementation::addArrayMemoryUsage(out, state.editingClipRects);
+    Implementation::addArrayMemoryUsage(out, state.transformationIds);
+    Implementation::addArrayMemoryUsage(out, state.nodeIds);
+    Implementation::addArrayMemoryUsage(out, state.nodeOpacities);
+    Implementation::addArrayMemoryUsage(out, state.uploadedVertices);
+    Implementation::addArrayMemoryUsage(out, state.uploadedIndices);
+    Implementation::addArrayMemoryUsage(out, state.uploadedEditingVertices);
+    Implementation::addArrayMemoryUsage(out, state.uploadedEditingIndices);
+    Implementation::addArrayMemoryUsage(out, state.uploadedClipRects);
+    Implementation::addArrayMemoryUsage(out, state.uploadedEditingClipRects);
+    Implementation::addArrayMemoryUsage(out, state.uploadedTransformationIds);
+    Implementation::addArrayMemoryUsage(out, state.uploadedNodeIds);
+    Implementation::addArrayMemoryUsage(out, state.uploadedNodeOpacities);
+
+    /* The buffers are reallocated only when they need to grow, so the
+       capacity is what's actually allocated. The glyph cache is shared among
+       layers and thus not included. */
+    out.gpu +=
+        state.vertexBufferCapacity +
+        state.indexBufferCapacity +
+        state.editingVertexBufferCapacity +
+        state.editingIndexBufferCapacity +
+        state.clipRectBufferCapacity +
+        state.editingClipRectBufferCapacity +
+        state.transformationIdBufferCapacity +
+        state.nodeIdBufferCapacity +
+        std::size_t(state.transformationTextureRows)*TransformationTextureWidth*sizeof(Vector4) +
+        std::size_t(state.nodeOpacityTextureRows)*NodeOpacityTextureWidth*sizeof(Float);
+    return out;
+}
+
+void TextLayerGL::doTrim(const std::size_t capacity) {
+    TextLayer::doTrim(capacity);
+
+    auto& state = static_cast<State&>(*_state);
+    arrayShrink(state.clipRects);
+    arrayShrink(state.editingClipRects);
+    arrayShrink(state.transformationIds);
+    arrayShrink(state.nodeIds);
+    arrayShrink(state.nodeOpacities);
+    arrayShrink(state.uploadedNodeOpacities);
+    Implementation::shrinkGrowable(state.vertexBuffer, state.vertexBufferCapacity, state.uploadedVertices);
+    Implementation::shrinkGrowable(state.indexBuffer, state.indexBufferCapacity, state.uploadedIndices);
+    Implementation::shrinkGrowable(state.editingVertexBuffer, state.editingVertexBufferCapacity, state.uploadedEditingVertices);
+    Implementation::shrinkGrowable(state.editingIndexBuffer, state.editingIndexBufferCapacity, state.uploadedEditingIndices);
+    Implementation::shrinkGrowable(state.clipRectBuffer, state.clipRectBufferCapacity, state.uploadedClipRects);
+    Implementation::shrinkGrowable(state.editingClipRectBuffer, state.editingClipRectBufferCapacity, state.uploadedEditingClipRects);
+    Implementation::shrinkGrowable(state.transformationIdBuffer, state.transformationIdBufferCapacity, state.uploadedTransformationIds);
+    Implementation::shrinkGrowable(state.nodeIdBuffer, state.nodeIdBufferCapacity, state.uploadedNodeIds);
+}
+
 LayerFeatures TextLayerGL::doFeatures() const {
-    return TextLayer::doFeatures()|LayerFeature::DrawUsesBlending|LayerFeature::DrawUsesScissor;
+    auto& sharedState = static_cast<const Shared::State&>(_state->shared);
+    /* With shader clipping the scissor is not used at all */
+    return TextLayer::doFeatures()|LayerFeature::DrawUsesBlending|(sharedState.flags >= TextLayerSharedFlag::ShaderClipping ? LayerFeatures{} : LayerFeature::DrawUsesScissor);
 }
 
 void TextLayerGL::doSetSize(const Vector2& size, const Vector2i& framebufferSize) {
     auto& state = static_cast<State&>(*_state);
     auto& sharedState = static_cast<Shared::State&>(state.shared);
 
+    /* With shader clipping the framebuffer-space clip rects are a part of the
+       vertex data, so if the framebuffer size or the scale changes and there
+       are any data already, trigger an update of those */
+    const Vector2 clipScale = Vector2{framebufferSize}/size;
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderClipping && (framebufferSize != state.framebufferSize || clipScale != state.clipScale) && !state.data.isEmpty())
+        setNeedsUpdate(LayerState::NeedsDataUpdate);
+
     /** @todo Max or min? Should I even bother with non-square scaling? */
     sharedState.shader.setProjection(size, (size/Vector2{framebufferSize}).max(), sharedState.distanceFieldScaling);
     if(sharedState.hasEditingStyles)
         /** @todo Max or min? Should I even bother with non-square scaling? */
         sharedState.editingShader.setProjection(size, (size/Vector2{framebufferSize}).max());
 
-    /* For scaling and Y-flipping the clip rects in doDraw() */
-    state.clipScale = Vector2{framebufferSize}/size;
+    /* For scaling and Y-flipping the clip rects in doUpdate() and doDraw() */
+    state.clipScale = clipScale;
     state.framebufferSize = framebufferSize;
 }
 
-void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
+void TextLayerGL::doUpdate(const LayerStates requestedStates, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
     State& state = static_cast<State&>(*_state);
     Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
 
@@ -504,30 +894,276 @@ void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
        order to be correctly handled below. */
     const bool sharedStyleChanged = sharedState.styleUpdateStamp != state.styleUpdateStamp;
     const bool sharedEditingStyleChanged = sharedState.editingStyleUpdateStamp != state.editingStyleUpdateStamp;
-    CORRADE_INTERNAL_ASSERT(!sharedState.dynamicStyleCount || (!sharedStyleChanged && !sharedEditingStyleChanged && !state.dynamicStyleChanged && !state.dynamicEditingStyleChanged) || states >= LayerState::NeedsCommonDataUpdate);
+    CORRADE_INTERNAL_ASSERT(!sharedState.dynamicStyleCount || (!sharedStyleChanged && !sharedEditingStyleChanged && !state.dynamicStyleChanged && !state.dynamicEditingStyleChanged) || requestedStates >= LayerState::NeedsCommonDataUpdate);
 
-    TextLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
+    TextLayer::doUpdate(requestedStates, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
+
+    /* If TextLayer::doUpdate() shaped texts with TextDataFlag::DeferShaping,
+       it updated the data even if not requested to, so upload them as
+       well */
+    LayerStates states = requestedStates;
+    if(state.deferredTextsShaped) {
+        states |= LayerState::NeedsDataUpdate;
+        state.deferredTextsShaped = false;
+    }
 
     /* The branching here mirrors how TextLayer::doUpdate() restricts the
-       updates. Keep in sync. */
+       updates. Keep in sync.
+
+       The glyph and editing geometry is uploaded separately, with only the
+       ranges that differ from what was uploaded last time, so for example a
+       cursor or selection change uploads just the affected editing quads and
+       a single changed text uploads just its glyphs. The buffers grow by at
+       least doubling their capacity, so a text changing its glyph count
+       doesn't cause a reallocation every time. */
+    const bool instanced = sharedState.flags >= TextLayerSharedFlag::InstancedGlyphs;
+    std::size_t uploadedSize = 0;
     if(states >= LayerState::NeedsNodeOrderUpdate ||
        states >= LayerState::NeedsDataUpdate)
     {
-        state.indexBuffer.setData(state.indices);
-        state.mesh.setCount(state.indices.size());
+        /* Indices are compared per glyph or per editing quad, which is 6
+           indices for both. Instanced glyphs have no indices, the editing
+           quads are indexed always. */
+        if(!instanced) {
+            uploadedSize += Implementation::uploadChangedRangesGrowable(state.indexBuffer, state.indexBufferCapacity, state.uploadedIndices,
+                Containers::arrayCast<const char>(Containers::arrayView(state.indices)),
+                6*sizeof(UnsignedInt));
+            state.mesh.setCount(state.indices.size());
+        }
         if(sharedState.hasEditingStyles) {
-            state.editingIndexBuffer.setData(state.editingIndices);
+            uploadedSize += Implementation::uploadChangedRangesGrowable(state.editingIndexBuffer, state.editingIndexBufferCapacity, state.uploadedEditingIndices,
+                Containers::arrayCast<const char>(Containers::arrayView(state.editingIndices)),
+                6*sizeof(UnsignedInt));
             state.editingMesh.setCount(state.editingIndices.size());
         }
     }
-    if(states >= LayerState::NeedsNodeOffsetSizeUpdate ||
+    if((instanced && states >= LayerState::NeedsNodeOrderUpdate) ||
+       states >= LayerState::NeedsNodeOffsetSizeUpdate ||
        states >= LayerState::NeedsNodeEnabledUpdate ||
-       states >= LayerState::NeedsNodeOpacityUpdate ||
+       ((!(sharedState.flags >= TextLayerSharedFlag::ShaderNodeOpacity) || sharedState.hasEditingStyles) && states >= LayerState::NeedsNodeOpacityUpdate) ||
        states >= LayerState::NeedsDataUpdate)
     {
-        state.vertexBuffer.setData(state.vertices);
+        /* Vertices are compared per glyph or editing quad as well. Instances
+           are in draw order, so they're compared per draw position and not
+           per glyph offset. */
+        uploadedSize += Implementation::uploadChangedRangesGrowable(state.vertexBuffer, state.vertexBufferCapacity, state.uploadedVertices, state.vertices,
+            instanced ?
+                (sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+                    sizeof(Implementation::TextLayerDistanceFieldGlyphInstance) :
+                    sizeof(Implementation::TextLayerGlyphInstance)) :
+                4*(sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+                    sizeof(Implementation::TextLayerDistanceFieldVertex) :
+                    sizeof(Implementation::TextLayerVertex)));
         if(sharedState.hasEditingStyles)
-            state.editingVertexBuffer.setData(state.editingVertices);
+            uploadedSize += Implementation::uploadChangedRangesGrowable(state.editingVertexBuffer, state.editingVertexBufferCapacity, state.uploadedEditingVertices,
+                Containers::arrayCast<const char>(Containers::arrayView(state.editingVertices)),
+                4*sizeof(Implementation::TextLayerEditingVertex));
+    }
+
+    /* With shader clipping, fill in the framebuffer-space clip rect for every
+       glyph and editing vertex. Clip rects change with node offsets and
+       sizes, which implies NeedsNodeOrderUpdate. The data update is for
+       newly added data, recompacted glyph runs and for framebuffer size
+       changes, which are triggered from doSetSize(). */
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderClipping && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsDataUpdate))
+    {
+        /* The vertex arrays are sized to contain all glyph runs and text
+           runs, which are indexed from the data. Instances are in draw order
+           instead, with the offset for each data in indexDrawOffsets. */
+        const std::size_t typeSize = instanced ?
+            (sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+                sizeof(Implementation::TextLayerDistanceFieldGlyphInstance) :
+                sizeof(Implementation::TextLayerGlyphInstance)) :
+            (sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+                sizeof(Implementation::TextLayerDistanceFieldVertex) :
+                sizeof(Implementation::TextLayerVertex));
+        arrayResize(state.clipRects, NoInit, state.vertices.size()/typeSize);
+        if(sharedState.hasEditingStyles)
+            arrayResize(state.editingClipRects, NoInit, state.editingVertices.size());
+
+        std::size_t clipDataOffset = 0;
+        for(std::size_t i = 0; i != clipRectIds.size(); ++i) {
+            const UnsignedInt clipRectId = clipRectIds[i];
+            const Range2Di rect = Implementation::framebufferClipRect(clipRectOffsets[clipRectId], clipRectSizes[clipRectId], state.clipScale, state.framebufferSize);
+            const Vector4 clipRect{Vector2{rect.min()}, Vector2{rect.max()}};
+
+            const std::size_t clipDataEnd = clipDataOffset + clipRectDataCounts[i];
+            for(std::size_t j = clipDataOffset; j != clipDataEnd; ++j) {
+                const Implementation::TextLayerData& data = state.data[dataIds[j]];
+                if(instanced) {
+                    for(std::size_t k = state.indexDrawOffsets[j].first(), kEnd = state.indexDrawOffsets[j + 1].first(); k != kEnd; ++k)
+                        state.clipRects[k] = clipRect;
+                } else if(data.glyphRun != ~UnsignedInt{}) {
+                    const Implementation::TextLayerGlyphRun& glyphRun = state.glyphRuns[data.glyphRun];
+                    for(std::size_t k = glyphRun.glyphOffset*4, kEnd = (glyphRun.glyphOffset + glyphRun.glyphCount)*4; k != kEnd; ++k)
+                        state.clipRects[k] = clipRect;
+                }
+                /* Each text run has a selection and a cursor quad */
+                if(sharedState.hasEditingStyles && data.textRun != ~UnsignedInt{}) {
+                    for(std::size_t k = data.textRun*8, kEnd = k + 8; k != kEnd; ++k)
+                        state.editingClipRects[k] = clipRect;
+                }
+            }
+
+            clipDataOffset = clipDataEnd;
+        }
+
+        CORRADE_INTERNAL_ASSERT(clipDataOffset == dataIds.size());
+
+        /* Compared per glyph or editing quad, same as the vertices */
+        uploadedSize += Implementation::uploadChangedRangesGrowable(state.clipRectBuffer, state.clipRectBufferCapacity, state.uploadedClipRects,
+            Containers::arrayCast<const char>(Containers::arrayView(state.clipRects)),
+            (instanced ? 1 : 4)*sizeof(Vector4));
+        if(sharedState.hasEditingStyles)
+            uploadedSize += Implementation::uploadChangedRangesGrowable(state.editingClipRectBuffer, state.editingClipRectBufferCapacity, state.uploadedEditingClipRects,
+                Containers::arrayCast<const char>(Containers::arrayView(state.editingClipRects)),
+                4*sizeof(Vector4));
+    }
+
+    /* With shader transformation and shader node opacity, fill in the data
+       and node ID for every glyph vertex or instance. Those change only if
+       the vertex layout or the node attachment changes, i.e. under the same
+       conditions as the indices. */
+    const bool shaderTransformation = sharedState.flags >= TextLayerSharedFlag::ShaderTransformation;
+    const bool shaderNodeOpacity = sharedState.flags >= TextLayerSharedFlag::ShaderNodeOpacity;
+    if((shaderTransformation || shaderNodeOpacity) && (
+       states >= LayerState::NeedsNodeOrderUpdate ||
+       states >= LayerState::NeedsDataUpdate))
+    {
+        const std::size_t typeSize = instanced ?
+            (sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+                sizeof(Implementation::TextLayerDistanceFieldGlyphInstance) :
+                sizeof(Implementation::TextLayerGlyphInstance)) :
+            (sharedState.flags >= TextLayerSharedFlag::DistanceField ?
+                sizeof(Implementation::TextLayerDistanceFieldVertex) :
+                sizeof(Implementation::TextLayerVertex));
+        const std::size_t count = state.vertices.size()/typeSize;
+        if(shaderTransformation)
+            arrayResize(state.transformationIds, NoInit, count);
+        if(shaderNodeOpacity)
+            arrayResize(state.nodeIds, NoInit, count);
+
+        const Containers::StridedArrayView1D<const Ui::NodeHandle> nodes = this->nodes();
+        for(std::size_t i = 0; i != dataIds.size(); ++i) {
+            const UnsignedInt dataId = dataIds[i];
+            const Implementation::TextLayerData& data = state.data[dataId];
+            std::size_t begin, end;
+            if(instanced) {
+                begin = state.indexDrawOffsets[i].first();
+                end = state.indexDrawOffsets[i + 1].first();
+            } else if(data.glyphRun != ~UnsignedInt{}) {
+                const Implementation::TextLayerGlyphRun& glyphRun = state.glyphRuns[data.glyphRun];
+                begin = glyphRun.glyphOffset*4;
+                end = (glyphRun.glyphOffset + glyphRun.glyphCount)*4;
+            } else continue;
+
+            if(shaderTransformation)
+                for(std::size_t k = begin; k != end; ++k)
+                    state.transformationIds[k] = dataId;
+            if(shaderNodeOpacity) {
+                const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
+                for(std::size_t k = begin; k != end; ++k)
+                    state.nodeIds[k] = nodeId;
+            }
+        }
+
+        /* Compared per glyph, same as the vertices */
+        if(shaderTransformation)
+            uploadedSize += Implementation::uploadChangedRangesGrowable(state.transformationIdBuffer, state.transformationIdBufferCapacity, state.uploadedTransformationIds,
+                Containers::arrayCast<const char>(Containers::arrayView(state.transformationIds)),
+                (instanced ? 1 : 4)*sizeof(UnsignedInt));
+        if(shaderNodeOpacity)
+            uploadedSize += Implementation::uploadChangedRangesGrowable(state.nodeIdBuffer, state.nodeIdBufferCapacity, state.uploadedNodeIds,
+                Containers::arrayCast<const char>(Containers::arrayView(state.nodeIds)),
+                (instanced ? 1 : 4)*sizeof(UnsignedInt));
+    }
+
+    /* Upload the per-data transformations calculated in TextLayer::doUpdate()
+       if they changed. That's just a single item per data, so the whole
+       texture is updated at once. If there's more data than the texture can
+       hold, it's recreated with twice the rows. */
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderTransformation && state.dataTransformationsChanged) {
+        const std::size_t count = state.dataTransformations.size();
+        const Int rows = Int((count + TransformationTextureWidth - 1)/TransformationTextureWidth);
+        if(rows > state.transformationTextureRows) {
+            const Int newRows = Math::max(rows, 2*state.transformationTextureRows);
+            /* The format isn't filterable, so the filtering has to be Nearest
+               for the texture to be complete, even though it's only ever
+               accessed with texelFetch() */
+            state.transformationTexture = GL::Texture2D{};
+            state.transformationTexture
+                .setMinificationFilter(GL::SamplerFilter::Nearest)
+                .setMagnificationFilter(GL::SamplerFilter::Nearest)
+                .setStorage(1, GL::TextureFormat::RGBA32F, {TransformationTextureWidth, newRows});
+            state.transformationTextureRows = newRows;
+        }
+
+        /* Full rows first, then the remainder as a partial row */
+        const std::size_t fullRows = count/TransformationTextureWidth;
+        if(fullRows)
+            state.transformationTexture.setSubImage(0, {}, ImageView2D{PixelFormat::RGBA32F, {TransformationTextureWidth, Int(fullRows)}, state.dataTransformations.prefix(fullRows*TransformationTextureWidth)});
+        if(const std::size_t remainder = count%TransformationTextureWidth)
+            state.transformationTexture.setSubImage(0, {0, Int(fullRows)}, ImageView2D{PixelFormat::RGBA32F, {Int(remainder), 1}, state.dataTransformations.exceptPrefix(fullRows*TransformationTextureWidth)});
+        uploadedSize += count*sizeof(Vector4);
+        state.dataTransformationsChanged = false;
+    }
+
+    /* With shader node opacity, upload the rows of absolute node opacities
+       that changed since the last upload. Done also if the node count grows
+       beyond what the texture can hold, in which case it's recreated with
+       twice the rows and uploaded whole. */
+    if(shaderNodeOpacity && (
+       states >= LayerState::NeedsNodeOpacityUpdate ||
+       nodeOpacities.size() > std::size_t(state.nodeOpacityTextureRows)*NodeOpacityTextureWidth))
+    {
+        const Int rows = Int((nodeOpacities.size() + NodeOpacityTextureWidth - 1)/NodeOpacityTextureWidth);
+        if(rows > state.nodeOpacityTextureRows) {
+            const Int newRows = Math::max(rows, 2*state.nodeOpacityTextureRows);
+            /* Same as with the transformation texture, the format isn't
+               filterable so the filtering has to be Nearest */
+            state.nodeOpacityTexture = GL::Texture2D{};
+            state.nodeOpacityTexture
+                .setMinificationFilter(GL::SamplerFilter::Nearest)
+                .setMagnificationFilter(GL::SamplerFilter::Nearest)
+                .setStorage(1, GL::TextureFormat::R32F, {NodeOpacityTextureWidth, newRows});
+            state.nodeOpacityTextureRows = newRows;
+            arrayResize(state.uploadedNodeOpacities, 0);
+        }
+
+        /* Opacities of nodes that aren't visible are left uninitialized by
+           the UI, they're not drawn so their contents don't matter. The
+           padding is cleared to not cause spurious uploads. */
+        arrayResize(state.nodeOpacities, NoInit, std::size_t(rows)*NodeOpacityTextureWidth);
+        Utility::copy(nodeOpacities, Containers::stridedArrayView(state.nodeOpacities).prefix(nodeOpacities.size()));
+        for(Float& i: state.nodeOpacities.exceptPrefix(nodeOpacities.size()))
+            i = 0.0f;
+
+        /* Compared per row, rows past what was uploaded last time are
+           uploaded always */
+        const Containers::ArrayView<const char> current = Containers::arrayCast<const char>(Containers::arrayView(state.nodeOpacities));
+        const auto uploadRows = [&state, &current](const std::size_t offset, const std::size_t size) {
+            constexpr std::size_t RowSize = NodeOpacityTextureWidth*sizeof(Float);
+            state.nodeOpacityTexture.setSubImage(0, {0, Int(offset/RowSize)}, ImageView2D{PixelFormat::R32F, {NodeOpacityTextureWidth, Int(size/RowSize)}, current.sliceSize(offset, size)});
+        };
+        const std::size_t commonSize = Math::min(state.uploadedNodeOpacities.size(), state.nodeOpacities.size())*sizeof(Float);
+        Containers::Pair<std::size_t, std::size_t> ranges[16];
+        const std::size_t rangeCount = Implementation::dirtyRangesInto(
+            Containers::arrayCast<const char>(Containers::arrayView(state.uploadedNodeOpacities)).prefix(commonSize),
+            current.prefix(commonSize),
+            NodeOpacityTextureWidth*sizeof(Float), ranges);
+        for(std::size_t i = 0; i != rangeCount; ++i) {
+            uploadRows(ranges[i].first(), ranges[i].second());
+            uploadedSize += ranges[i].second();
+        }
+        if(current.size() > commonSize) {
+            uploadRows(commonSize, current.size() - commonSize);
+            uploadedSize += current.size() - commonSize;
+        }
+
+        arrayResize(state.uploadedNodeOpacities, NoInit, state.nodeOpacities.size());
+        Utility::copy(state.nodeOpacities, state.uploadedNodeOpacities);
     }
 
     /* If we have dynamic styles and either NeedsCommonDataUpdate is set
@@ -550,9 +1186,11 @@ void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
                styles -- then skip the empty upload. */
             if(!sharedState.styleUniforms.isEmpty())
                 state.styleBuffer.setSubData(sizeof(TextLayerCommonStyleUniform), sharedState.styleUniforms);
+            uploadedSize += sizeof(TextLayerCommonStyleUniform) + sharedState.styleUniforms.size()*sizeof(TextLayerStyleUniform);
         }
         if(needsFirstUpload || state.dynamicStyleChanged) {
             state.styleBuffer.setSubData(sizeof(TextLayerCommonStyleUniform) + sizeof(TextLayerStyleUniform)*sharedState.styleUniformCount, state.dynamicStyleUniforms);
+            uploadedSize += state.dynamicStyleUniforms.size()*sizeof(TextLayerStyleUniform);
             state.dynamicStyleChanged = false;
         }
     }
@@ -573,12 +1211,16 @@ void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
             /* Skip empty upload if there are just dynamic styles */
             if(!sharedState.editingStyleUniforms.isEmpty())
                 state.editingStyleBuffer.setSubData(sizeof(TextLayerCommonEditingStyleUniform), sharedState.editingStyleUniforms);
+            uploadedSize += sizeof(TextLayerCommonEditingStyleUniform) + sharedState.editingStyleUniforms.size()*sizeof(TextLayerEditingStyleUniform);
         }
         if(needsFirstUpload || state.dynamicEditingStyleChanged) {
             state.editingStyleBuffer.setSubData(sizeof(TextLayerCommonEditingStyleUniform) + sizeof(TextLayerEditingStyleUniform)*sharedState.editingStyleUniformCount, state.dynamicEditingStyleUniforms);
+            uploadedSize += state.dynamicEditingStyleUniforms.size()*sizeof(TextLayerEditingStyleUniform);
             state.dynamicEditingStyleChanged = false;
         }
     }
+
+    addUploadedSize(uploadedSize);
 }
 
 void TextLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>&, const std::size_t offset, const std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const std::size_t clipRectOffset, const std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) {
@@ -602,50 +1244,75 @@ void TextLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>
     if(sharedState.hasEditingStyles)
         sharedState.editingShader.bindStyleBuffer(sharedState.dynamicStyleCount ?
             state.editingStyleBuffer : sharedState.editingStyleBuffer);
-
-    std::size_t clipDataOffset = offset;
-    for(std::size_t i = 0; i != clipRectCount; ++i) {
-        const UnsignedInt clipRectId = clipRectIds[clipRectOffset + i];
-        const UnsignedInt clipRectDataCount = clipRectDataCounts[clipRectOffset + i];
-        const Vector2i clipRectOffset_ = Vector2i{clipRectOffsets[clipRectId]*state.clipScale};
-        const Vector2i clipRectSize = clipRectSizes[clipRectId].isZero() ?
-            state.framebufferSize : Vector2i{clipRectSizes[clipRectId]*state.clipScale};
-
-        GL::Renderer::setScissor(Range2Di::fromSize(
-            {clipRectOffset_.x(), state.framebufferSize.y() - clipRectOffset_.y() - clipRectSize.y()},
-            clipRectSize));
-
-        /* If there are any selection / cursor quads for texts in this clip
-           rect, draw them before the actual text. The assumption is that
-           editable texts aren't overlapping in a single top-level node, so it
-           should be fine to render them all before the actual texts instead of
-           right before every piece of editable text. */
-        /** @todo Better would probably be outside of this loop to trade
-            expensive shader switching for a less expensive duplicated scissor
-            state update, but then would have to duplicate the scissor and all
-            the other logic. Or maybe let's just implement the clipping in the
-            shader instead and draw everything at once? */
-        if(const UnsignedInt indexCount = state.indexDrawOffsets[clipDataOffset + clipRectDataCount].second() - state.indexDrawOffsets[clipDataOffset].second()) {
+    /* The transformation texture is created on the first update with any
+       data, if there's none yet, there's also nothing drawn */
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderTransformation && state.transformationTexture.id())
+        sharedState.shader.bindTransformationTexture(state.transformationTexture);
+    /* Similarly, the node opacity texture is created on the first update
+       with any nodes */
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderNodeOpacity && state.nodeOpacityTexture.id())
+        sharedState.shader.bindNodeOpacityTexture(state.nodeOpacityTexture);
+
+    /* Draws given range of the draw order */
+    const auto drawRange = [&](const std::size_t drawOffset, const std::size_t drawCount) {
+        /* If there are any selection / cursor quads for texts in this range,
+           draw them before the actual text. The assumption is that editable
+           texts aren't overlapping in a single top-level node, so it should
+           be fine to render them all before the actual texts instead of right
+           before every piece of editable text. */
+        if(const UnsignedInt indexCount = state.indexDrawOffsets[drawOffset + drawCount].second() - state.indexDrawOffsets[drawOffset].second()) {
             state.editingMesh
-                .setIndexOffset(state.indexDrawOffsets[clipDataOffset].second())
+                .setIndexOffset(state.indexDrawOffsets[drawOffset].second())
                 .setCount(indexCount);
             sharedState.editingShader
                 .draw(state.editingMesh);
         }
 
-        state.mesh
-            .setIndexOffset(state.indexDrawOffsets[clipDataOffset].first())
-            .setCount(state.indexDrawOffsets[clipDataOffset + clipRectDataCount].first() - state.indexDrawOffsets[clipDataOffset].first());
+        /* With instanced glyphs the draw offsets are directly the first
+           instance to draw */
+        if(sharedState.flags >= TextLayerSharedFlag::InstancedGlyphs) state.mesh
+            .setInstanceCount(state.indexDrawOffsets[drawOffset + drawCount].first() - state.indexDrawOffsets[drawOffset].first())
+            .setBaseInstance(state.indexDrawOffsets[drawOffset].first());
+        else state.mesh
+            .setIndexOffset(state.indexDrawOffsets[drawOffset].first())
+            .setCount(state.indexDrawOffsets[drawOffset + drawCount].first() - state.indexDrawOffsets[drawOffset].first());
         sharedState.shader
             .draw(state.mesh);
+    };
+
+    /* With shader clipping the clip rects are a part of the vertex data, so
+       everything is drawn at once. Otherwise there's a scissor rectangle and a
+       separate draw for each clip rect. */
+    /** @todo in the scissor case, better would probably be to draw all
+        editing quads first to trade expensive shader switching for a less
+        expensive duplicated scissor state update, but then would have to
+        duplicate the scissor and all the other logic */
+    if(sharedState.flags >= TextLayerSharedFlag::ShaderClipping) {
+        drawRange(offset, count);
+    } else {
+        /* Consecutive clip rects can map to the same framebuffer rectangle,
+           for example if a clipping node is fully inside its clipping parent
+           or if both are unclipped. Set the scissor only if it differs from
+           what was set last, the first one is set always as the state from
+           outside isn't known. */
+        std::size_t clipDataOffset = offset;
+        Range2Di scissor;
+        for(std::size_t i = 0; i != clipRectCount; ++i) {
+            const UnsignedInt clipRectId = clipRectIds[clipRectOffset + i];
+            const UnsignedInt clipRectDataCount = clipRectDataCounts[clipRectOffset + i];
+            const Range2Di clipRect = Implementation::framebufferClipRect(clipRectOffsets[clipRectId], clipRectSizes[clipRectId], state.clipScale, state.framebufferSize);
+            if(!i || clipRect != scissor) {
+                GL::Renderer::setScissor(clipRect);
+                scissor = clipRect;
+            }
+
+            drawRange(clipDataOffset, clipRectDataCount);
+
+            clipDataOffset += clipRectDataCount;
+        }
 
-        clipDataOffset += clipRectDataCount;
+        CORRADE_INTERNAL_ASSERT(clipDataOffset == offset + count);
     }
-
-    CORRADE_INTERNAL_ASSERT(clipDataOffset == offset + count);
-    #ifdef CORRADE_NO_ASSERT
-    static_cast<void>(count);
-    #endif
 }
 
 }}
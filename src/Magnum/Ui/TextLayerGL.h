@@ -107,6 +107,8 @@ class MAGNUM_UI_EXPORT TextLayerGL: public TextLayer {
            causes linker errors. See BaseLayerGLTest::constructDerived() for a
            repro case. */
         LayerFeatures doFeatures() const override;
+        MemoryUsage doMemoryUsage() const override;
+        void doTrim(std::size_t capacity) override;
 
         void doSetSize(const Vector2& size, const Vector2i& framebufferSize) override;
 
@@ -181,6 +183,19 @@ class MAGNUM_UI_EXPORT TextLayerGL::Shared: public TextLayer::Shared {
          */
         explicit Shared(NoCreateT) noexcept;
 
+        /**
+         * @brief Whether shader compilation has finished
+         * @m_since_latest
+         *
+         * The shaders are compiled and linked asynchronously if
+         * @gl_extension{KHR,parallel_shader_compile} is supported, allowing
+         * the application to do other work in the meantime. This function
+         * doesn't block. If the extension isn't supported, always returns
+         * @cpp true @ce. Drawing the layer before the compilation finished
+         * waits for it.
+         */
+        bool isCompileFinished();
+
         /* Overloads to remove a WTF factor from method chaining order */
         #ifndef DOXYGEN_GENERATING_OUTPUT
         MAGNUMEXTRAS_UI_ABSTRACTVISUALLAYER_SHARED_SUBCLASS_IMPLEMENTATION()
@@ -188,6 +203,12 @@ class MAGNUM_UI_EXPORT TextLayerGL::Shared: public TextLayer::Shared {
         Shared& setStyle(const TextLayerCommonStyleUniform& commonUniform, std::initializer_list<TextLayerStyleUniform> uniforms, std::initializer_list<FontHandle> fonts, std::initializer_list<Text::Alignment> alignments, std::initializer_list<TextFeatureValue> features, std::initializer_list<UnsignedInt> featureOffsets, std::initializer_list<UnsignedInt> featureCounts, std::initializer_list<Int> cursorStyles, std::initializer_list<Int> selectionStyles, std::initializer_list<Vector4> paddings);
         Shared& setStyle(const TextLayerCommonStyleUniform& commonUniform, Containers::ArrayView<const TextLayerStyleUniform> uniforms, const Containers::StridedArrayView1D<const UnsignedInt>& styleToUniform, const Containers::StridedArrayView1D<const FontHandle>& styleFonts, const Containers::StridedArrayView1D<const Text::Alignment>& styleAlignments, Containers::ArrayView<const TextFeatureValue> styleFeatures, const Containers::StridedArrayView1D<const UnsignedInt>& styleFeatureOffsets, const Containers::StridedArrayView1D<const UnsignedInt>& styleFeatureCounts, const Containers::StridedArrayView1D<const Int>& styleCursorStyles, const Containers::StridedArrayView1D<const Int>& styleSelectionStyles, const Containers::StridedArrayView1D<const Vector4>& stylePaddings);
         Shared& setStyle(const TextLayerCommonStyleUniform& commonUniform, std::initializer_list<TextLayerStyleUniform> uniforms, std::initializer_list<UnsignedInt> styleToUniform, std::initializer_list<FontHandle> styleFonts, std::initializer_list<Text::Alignment> styleAlignments, std::initializer_list<TextFeatureValue> styleFeatures, std::initializer_list<UnsignedInt> styleFeatureOffsets, std::initializer_list<UnsignedInt> styleFeatureCounts, std::initializer_list<Int> styleCursorStyles, std::initializer_list<Int> styleSelectionStyles, std::initializer_list<Vector4> stylePaddings);
+        Shared& clearShapeCache() {
+            return static_cast<Shared&>(TextLayer::Shared::clearShapeCache());
+        }
+        Shared& setShapeExecutor(Containers::Function<void(std::size_t, void(*)(void*, std::size_t), void*)>&& executor) {
+            return static_cast<Shared&>(TextLayer::Shared::setShapeExecutor(Utility::move(executor)));
+        }
         #endif
 
     private:
@@ -196,6 +217,7 @@ class MAGNUM_UI_EXPORT TextLayerGL::Shared: public TextLayer::Shared {
 
         void doSetStyle(const TextLayerCommonStyleUniform& commonUniform, Containers::ArrayView<const TextLayerStyleUniform> uniforms) override;
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform& commonUniform, Containers::ArrayView<const TextLayerEditingStyleUniform> uniforms) override;
+        bool doGrowGlyphCache(UnsignedInt layerCount) override;
 };
 
 inline TextLayerGL::Shared& TextLayerGL::shared() {
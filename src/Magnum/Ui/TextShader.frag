@@ -64,10 +64,22 @@ flat in lowp vec4 interpolatedColor;
 flat in mediump uint interpolatedStyle;
 flat in mediump float interpolatedInvertedRunScale;
 #endif
+#ifdef SHADER_CLIPPING
+flat in highp vec4 interpolatedClipRect;
+#endif
 
 out lowp vec4 fragmentColor;
 
 void main() {
+    /* The clip rect is in whole framebuffer pixels and gl_FragCoord is at
+       pixel centers, so this discards exactly the pixels a scissor rectangle
+       of the same size would */
+    #ifdef SHADER_CLIPPING
+    if(any(lessThan(gl_FragCoord.xy, interpolatedClipRect.xy)) ||
+       any(greaterThan(gl_FragCoord.xy, interpolatedClipRect.zw)))
+        discard;
+    #endif
+
     lowp float factor = texture(glyphTextureData, interpolatedTextureCoordinates).r;
     #ifndef DISTANCE_FIELD
     fragmentColor = interpolatedColor*factor;
@@ -46,13 +46,51 @@ uniform highp vec4 projection; /* xy = UI size to unit square scaling,
                                   z = one pixel as a distance value delta,
                                   w = one UI unit as a distance value delta */
 
+#ifndef INSTANCED_GLYPHS
 layout(location = 0) in highp vec2 position;
 layout(location = 1) in mediump vec3 textureCoordinates;
+#else
+/* Corner of a static unit quad, and three corners of the glyph quad plus the
+   texture coordinate min and max per instance. The position and texture
+   coordinates are then calculated from these in main(). */
+layout(location = 0) in lowp vec2 quadCorner;
+layout(location = 6) in highp vec4 glyphCorners01;
+layout(location = 7) in highp vec2 glyphCorner2;
+layout(location = 1) in mediump vec3 textureCoordinateMin; /* z = layer */
+layout(location = 8) in mediump vec2 textureCoordinateMax;
+#endif
 layout(location = 2) in lowp vec4 color;
 layout(location = 3) in mediump uint style;
 #ifdef DISTANCE_FIELD
 layout(location = 4) in mediump float invertedRunScale;
 #endif
+#ifdef SHADER_CLIPPING
+/* Framebuffer-space clip rect min and max in pixels */
+layout(location = 5) in highp vec4 clipRect;
+#endif
+#ifdef TRANSFORMATION
+/* Index into the transformation texture */
+layout(location = 9) in highp uint transformationId;
+
+/* Transformation for each data, with xy being the translation and zw the
+   complex number with combined rotation and scaling. Laid out in rows of
+   TRANSFORMATION_TEXTURE_WIDTH items. */
+#ifdef EXPLICIT_BINDING
+layout(binding = 1)
+#endif
+uniform highp sampler2D transformationTextureData;
+#endif
+#ifdef NODE_OPACITY
+/* Index into the node opacity texture */
+layout(location = 10) in highp uint nodeId;
+
+/* Absolute opacity for each node, laid out in rows of
+   NODE_OPACITY_TEXTURE_WIDTH items */
+#ifdef EXPLICIT_BINDING
+layout(binding = 2)
+#endif
+uniform highp sampler2D nodeOpacityTextureData;
+#endif
 
 NOPERSPECTIVE out mediump vec3 interpolatedTextureCoordinates;
 flat out lowp vec4 interpolatedColor;
@@ -60,19 +98,59 @@ flat out lowp vec4 interpolatedColor;
 flat out mediump uint interpolatedStyle;
 flat out mediump float interpolatedInvertedRunScale;
 #endif
+#ifdef SHADER_CLIPPING
+flat out highp vec4 interpolatedClipRect;
+#endif
 
 void main() {
+    /* Expand the instance to the same per-vertex inputs as the non-instanced
+       case has. The glyph quad can be rotated and scaled, so the position is
+       interpolated along both edges going from the first corner instead of
+       just between a min and max. */
+    #ifdef INSTANCED_GLYPHS
+    highp vec2 glyphPosition = glyphCorners01.xy +
+        quadCorner.x*(glyphCorners01.zw - glyphCorners01.xy) +
+        quadCorner.y*(glyphCorner2 - glyphCorners01.xy);
+    mediump vec3 textureCoordinates = vec3(mix(textureCoordinateMin.xy, textureCoordinateMax, quadCorner), textureCoordinateMin.z);
+    #else
+    highp vec2 glyphPosition = position;
+    #endif
+
+    /* Rotate and scale the glyph position relative to the text origin by
+       multiplying it with the complex number, then translate */
+    #ifdef TRANSFORMATION
+    highp vec4 transformation = texelFetch(transformationTextureData, ivec2(
+        int(transformationId % uint(TRANSFORMATION_TEXTURE_WIDTH)),
+        int(transformationId / uint(TRANSFORMATION_TEXTURE_WIDTH))), 0);
+    glyphPosition = transformation.xy + vec2(
+        transformation.z*glyphPosition.x - transformation.w*glyphPosition.y,
+        transformation.w*glyphPosition.x + transformation.z*glyphPosition.y);
+    #endif
+
     interpolatedTextureCoordinates = textureCoordinates;
     /* Calculate the combined base color here already to save a vec4 load in
        each fragment shader invocation. Outline color, if used, is fetched in
        the fragment shader always alongside other properties. */
     interpolatedColor = styles[style].color*color;
+    #ifdef NODE_OPACITY
+    interpolatedColor *= texelFetch(nodeOpacityTextureData, ivec2(
+        int(nodeId % uint(NODE_OPACITY_TEXTURE_WIDTH)),
+        int(nodeId / uint(NODE_OPACITY_TEXTURE_WIDTH))), 0).x;
+    #endif
     #ifdef DISTANCE_FIELD
     interpolatedStyle = style;
+    #ifndef TRANSFORMATION
     interpolatedInvertedRunScale = invertedRunScale;
+    #else
+    /* The scaling is a part of the transformation in this case */
+    interpolatedInvertedRunScale = invertedRunScale/length(transformation.zw);
+    #endif
+    #endif
+    #ifdef SHADER_CLIPPING
+    interpolatedClipRect = clipRect;
     #endif
 
     /* The projection scales from UI size to the 2x2 unit square and Y-flips,
        the (-1, 1) then translates the origin from top left to center */
-    gl_Position = vec4(projection.xy*position + vec2(-1.0, 1.0), 0.0, 1.0);
+    gl_Position = vec4(projection.xy*glyphPosition + vec2(-1.0, 1.0), 0.0, 1.0);
 }
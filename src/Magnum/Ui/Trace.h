@@ -0,0 +1,89 @@
+#ifndef Magnum_Ui_Trace_h
+#define Magnum_Ui_Trace_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Function @ref Magnum::Ui::setTraceCallbacks(), @ref Magnum::Ui::isTracingEnabled()
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/Containers.h>
+
+#include "Magnum/Ui/Ui.h"
+#include "Magnum/Ui/visibility.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Set trace zone callbacks
+@param begin    Function called when a trace zone is entered
+@param end      Function called when a trace zone is exited
+@param state    State pointer passed to both functions
+@m_since_latest
+
+If the library is built with the `MAGNUM_UI_WITH_TRACING` CMake option
+enabled, hot paths such as @ref AbstractUserInterface::update(),
+@relativeref{AbstractUserInterface,clean()},
+@relativeref{AbstractUserInterface,draw()},
+@relativeref{AbstractUserInterface,advanceAnimations()}, event dispatch,
+@ref AbstractLayer::update(), @relativeref{AbstractLayer,draw()},
+@relativeref{AbstractLayer,composite()}, @ref AbstractLayouter::update()
+and text shaping in @ref TextLayer are enclosed in trace zones. On entering a
+zone, @p begin is called with the zone name and @p state, on exiting @p end
+is called with the same name and @p state. The zones are properly nested,
+with each @p end call matching the most recent @p begin on the same thread.
+The name is a global null-terminated string such as
+@cpp "Ui::AbstractUserInterface::update()" @ce, so it can be passed directly
+to profilers that expect string literals, such as
+[Tracy](https://github.com/wolfpld/tracy) or
+[Perfetto](https://perfetto.dev/).
+
+Pass @cpp nullptr @ce for both @p begin and @p end to disable the callbacks
+again, which is also the initial state. The callbacks are global and not
+synchronized in any way, set them before the UI is used. If
+@ref TextLayer::Shared::setShapeExecutor() is used, the shaping zones can be
+entered from multiple threads at once.
+
+If the library is built without `MAGNUM_UI_WITH_TRACING`, the zones are
+compiled out entirely and the callbacks are never called. Use
+@ref isTracingEnabled() to check.
+*/
+MAGNUM_UI_EXPORT void setTraceCallbacks(void(*begin)(Containers::StringView name, void* state), void(*end)(Containers::StringView name, void* state), void* state);
+
+/**
+@brief Whether tracing is enabled
+@m_since_latest
+
+Returns @cpp true @ce if the library is built with the
+`MAGNUM_UI_WITH_TRACING` CMake option enabled, @cpp false @ce otherwise.
+@see @ref setTraceCallbacks()
+*/
+MAGNUM_UI_EXPORT bool isTracingEnabled();
+
+}}
+
+#endif
@@ -55,6 +55,8 @@ class AbstractNodeAnimator;
 class AbstractDataAnimator;
 class AbstractStyleAnimator;
 class AbstractLayer;
+enum class LayerState: UnsignedShort;
+typedef Containers::EnumSet<LayerState> LayerStates;
 class AbstractLayouter;
 class AbstractRenderer;
 class AbstractUserInterface;
@@ -69,12 +71,19 @@ class BaseLayerStyleAnimator;
 #ifdef MAGNUM_TARGET_GL
 class BaseLayerGL;
 #endif
-enum class BaseLayerSharedFlag: UnsignedByte;
+enum class BaseLayerSharedFlag: UnsignedShort;
 typedef Containers::EnumSet<BaseLayerSharedFlag> BaseLayerSharedFlags;
+enum class BaseLayerBackgroundBlurAlgorithm: UnsignedByte;
 
 class EventConnection;
 class EventLayer;
 
+class FlexLayouter;
+enum class FlexDirection: UnsignedByte;
+enum class FlexAlignment: UnsignedByte;
+enum class FlexLayoutFlag: UnsignedByte;
+typedef Containers::EnumSet<FlexLayoutFlag> FlexLayoutFlags;
+
 class LineLayer;
 struct LineLayerCommonStyleUniform;
 struct LineLayerStyleUniform;
@@ -85,12 +94,16 @@ enum class LineCapStyle: UnsignedByte;
 enum class LineJoinStyle: UnsignedByte;
 enum class LineAlignment: UnsignedByte;
 
+struct MemoryUsage;
+
 enum class FontHandle: UnsignedShort;
 class TextLayer;
 struct TextLayerCommonStyleUniform;
 struct TextLayerStyleUniform;
 struct TextLayerCommonEditingStyleUniform;
 struct TextLayerEditingStyleUniform;
+enum class TextLayerSharedFlag: UnsignedByte;
+typedef Containers::EnumSet<TextLayerSharedFlag> TextLayerSharedFlags;
 class TextLayerStyleAnimator;
 #ifdef MAGNUM_TARGET_GL
 class TextLayerGL;
@@ -101,6 +114,8 @@ class TextProperties;
 class GenericAnimator;
 class GenericNodeAnimator;
 class GenericDataAnimator;
+class GenericBatchAnimator;
+class KeyframeNodeAnimator;
 
 class RendererGL;
 
@@ -119,6 +134,9 @@ typedef BasicAnchor<UserInterface> Anchor;
 class AbstractWidget;
 template<class> class BasicWidget;
 typedef BasicWidget<UserInterface> Widget;
+template<class> class WidgetPool;
+
+class VirtualList;
 
 class SnapLayouter;
 class AbstractSnapLayout;
@@ -144,6 +162,8 @@ class TextInputEvent;
 
 class VisibilityLostEvent;
 
+class EventQueue;
+
 }}
 #endif
 
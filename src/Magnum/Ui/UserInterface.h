@@ -213,6 +213,9 @@ class MAGNUM_UI_EXPORT UserInterface: public AbstractUserInterface {
         UserInterface& clean() {
             return static_cast<UserInterface&>(AbstractUserInterface::clean());
         }
+        UserInterface& trim() {
+            return static_cast<UserInterface&>(AbstractUserInterface::trim());
+        }
         UserInterface& advanceAnimations(Nanoseconds time);
         UserInterface& update() {
             return static_cast<UserInterface&>(AbstractUserInterface::update());
@@ -149,7 +149,8 @@ bool UserInterfaceGL::trySetStyle(const AbstractStyle& style, const StyleFeature
                                              style.textLayerStyleCount()}
                 .setEditingStyleCount(style.textLayerEditingStyleUniformCount(),
                                       style.textLayerEditingStyleCount())
-                .setDynamicStyleCount(style.textLayerDynamicStyleCount())};
+                .setDynamicStyleCount(style.textLayerDynamicStyleCount())
+                .addFlags(style.textLayerFlags())};
         setTextLayerInstance(Containers::pointer<TextLayerGL>(createLayer(), state.textLayerShared));
 
         /* Create a local font plugin manager if external wasn't passed. If the
@@ -210,6 +211,71 @@ UserInterfaceGL& UserInterfaceGL::setStyle(const AbstractStyle& style, PluginMan
     return setStyle(style, style.features(), importerManager, fontManager);
 }
 
+bool UserInterfaceGL::trySetStyle(const AbstractStyle& style, const StyleFeatures features, UserInterfaceGL& other) {
+    CORRADE_ASSERT(features,
+        "Ui::UserInterfaceGL::trySetStyle(): no features specified", {});
+    CORRADE_ASSERT(features <= style.features(),
+        "Ui::UserInterfaceGL::trySetStyle():" << features << "not a subset of supported" << style.features(), {});
+    CORRADE_ASSERT(!framebufferSize().isZero(),
+        "Ui::UserInterfaceGL::trySetStyle(): user interface size wasn't set",
+        /* Has to return true with CORRADE_GRACEFUL_ASSERT so when tested
+           through setStyle() it doesn't std::exit() the whole executable */
+        true);
+    CORRADE_ASSERT(&other != this,
+        "Ui::UserInterfaceGL::trySetStyle(): can't share the style with itself", {});
+    CORRADE_ASSERT(!(features >= StyleFeature::BaseLayer) || other.hasBaseLayer(),
+        "Ui::UserInterfaceGL::trySetStyle(): base layer not present in the other user interface", {});
+    CORRADE_ASSERT(!(features & (StyleFeature::TextLayer|StyleFeature::TextLayerImages)) || other.hasTextLayer(),
+        "Ui::UserInterfaceGL::trySetStyle(): text layer not present in the other user interface", {});
+
+    State& state = static_cast<State&>(*_state);
+
+    /* Create a renderer, if not already */
+    if(!hasRenderer())
+        setRendererInstance(Containers::pointer<RendererGL>());
+
+    /* Create the base and text layers with the shared state of the other
+       user interface. Layer instances set through UserInterfaceGL are always
+       the GL variants, so the casts are fine. The style was already applied
+       to the shared state, including the icons in the glyph cache, so it
+       isn't applied to these again. */
+    if(features >= StyleFeature::BaseLayer) {
+        CORRADE_ASSERT(!state.baseLayer,
+            "Ui::UserInterfaceGL::trySetStyle(): base layer already present", {});
+        setBaseLayerInstance(Containers::pointer<BaseLayerGL>(createLayer(), static_cast<BaseLayerGL&>(other.baseLayer()).shared()));
+    }
+    if(features >= StyleFeature::TextLayer) {
+        CORRADE_ASSERT(!state.textLayer,
+            "Ui::UserInterfaceGL::trySetStyle(): text layer already present", {});
+        setTextLayerInstance(Containers::pointer<TextLayerGL>(createLayer(), static_cast<TextLayerGL&>(other.textLayer()).shared()));
+    }
+    if(features >= StyleFeature::TextLayerImages) {
+        CORRADE_ASSERT(state.textLayer,
+            "Ui::UserInterfaceGL::trySetStyle(): text layer not present and" << StyleFeature::TextLayer << "isn't being applied as well", {});
+    }
+    if(features >= StyleFeature::EventLayer) {
+        CORRADE_ASSERT(!state.eventLayer,
+            "Ui::UserInterfaceGL::trySetStyle(): event layer already present", {});
+        setEventLayerInstance(Containers::pointer<EventLayer>(createLayer()));
+    }
+    if(features >= StyleFeature::SnapLayouter) {
+        CORRADE_ASSERT(!state.snapLayouter,
+            "Ui::UserInterfaceGL::trySetStyle(): snap layouter already present", {});
+        setSnapLayouterInstance(Containers::pointer<SnapLayouter>(createLayouter()));
+    }
+
+    /* Apply the style only to what isn't shared, if anything is left. None
+       of the remaining features need the plugin managers. */
+    const StyleFeatures remainingFeatures = features & ~(StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::TextLayerImages);
+    return !remainingFeatures || style.apply(*this, remainingFeatures, nullptr, nullptr);
+}
+
+UserInterfaceGL& UserInterfaceGL::setStyle(const AbstractStyle& style, const StyleFeatures features, UserInterfaceGL& other) {
+    if(!trySetStyle(style, features, other))
+        std::exit(1); /* LCOV_EXCL_LINE */
+    return *this;
+}
+
 UserInterfaceGL& UserInterfaceGL::setBaseLayerInstance(Containers::Pointer<BaseLayerGL>&& instance) {
     return static_cast<UserInterfaceGL&>(UserInterface::setBaseLayerInstance(Utility::move(instance)));
 }
@@ -218,6 +284,17 @@ UserInterfaceGL& UserInterfaceGL::setTextLayerInstance(Containers::Pointer<TextL
     return static_cast<UserInterfaceGL&>(UserInterface::setTextLayerInstance(Utility::move(instance)));
 }
 
+bool UserInterfaceGL::isCompileFinished() {
+    /* The base and text layers are always the GL variants here, as they're
+       set only through the setBaseLayerInstance() and setTextLayerInstance()
+       overloads above */
+    if(hasBaseLayer() && !static_cast<BaseLayerGL&>(baseLayer()).shared().isCompileFinished())
+        return false;
+    if(hasTextLayer() && !static_cast<TextLayerGL&>(textLayer()).shared().isCompileFinished())
+        return false;
+    return true;
+}
+
 UserInterfaceGL& UserInterfaceGL::advanceAnimations(const Nanoseconds time) {
     return static_cast<UserInterfaceGL&>(UserInterface::advanceAnimations(time));
 }
@@ -561,6 +561,45 @@ class MAGNUM_UI_EXPORT UserInterfaceGL: public UserInterface {
          */
         bool trySetStyle(const AbstractStyle& style, PluginManager::Manager<Trade::AbstractImporter>* importerManager = nullptr, PluginManager::Manager<Text::AbstractFont>* fontManager = nullptr);
 
+        /**
+         * @brief Set features from a style, sharing layer state with another user interface
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Compared to @ref setStyle(const AbstractStyle&, StyleFeatures, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*),
+         * the base and text layers are created with the
+         * @ref BaseLayerGL::Shared and @ref TextLayerGL::Shared instances of
+         * @p other instead of new ones. The style uniforms, fonts and the
+         * glyph cache aren't thus duplicated, and @p style is only applied to
+         * the remaining features such as @ref StyleFeature::SnapLayouter.
+         * @ref StyleFeature::TextLayerImages only verifies that the text layer
+         * is present, as the images are already in the shared glyph cache. If
+         * applying the style fails, the program exits, see
+         * @ref trySetStyle(const AbstractStyle&, StyleFeatures, UserInterfaceGL&)
+         * for an alternative.
+         *
+         * Expects the same as the above overload, and additionally that
+         * @p other isn't this instance and has a base layer and a text layer
+         * present if @p features contain @ref StyleFeature::BaseLayer and
+         * @ref StyleFeature::TextLayer or @relativeref{StyleFeature,TextLayerImages}.
+         * The @p other instance is expected to stay alive for as long as
+         * this instance exists. Text is rasterized into the glyph cache at the
+         * DPI scaling of @p other, so text in this instance will look the
+         * sharpest if it has the same ratio of framebuffer size and user
+         * interface size as @p other.
+         */
+        UserInterfaceGL& setStyle(const AbstractStyle& style, StyleFeatures features, UserInterfaceGL& other);
+
+        /**
+         * @brief Try to set features from a style, sharing layer state with another user interface
+         * @m_since_latest
+         *
+         * Unlike @ref setStyle(const AbstractStyle&, StyleFeatures, UserInterfaceGL&)
+         * returns @cpp false @ce if @ref AbstractStyle::apply() failed instead
+         * of exiting, @cpp true @ce otherwise.
+         */
+        bool trySetStyle(const AbstractStyle& style, StyleFeatures features, UserInterfaceGL& other);
+
         /**
          * @brief Set a base layer instance
          * @return Reference to self (for method chaining)
@@ -585,6 +624,19 @@ class MAGNUM_UI_EXPORT UserInterfaceGL: public UserInterface {
          */
         UserInterfaceGL& setTextLayerInstance(Containers::Pointer<TextLayerGL>&& instance);
 
+        /**
+         * @brief Whether shader compilation has finished
+         * @m_since_latest
+         *
+         * If @ref hasBaseLayer() or @ref hasTextLayer() is @cpp true @ce,
+         * delegates to @ref BaseLayerGL::Shared::isCompileFinished() and
+         * @ref TextLayerGL::Shared::isCompileFinished() of their shared
+         * instances. Doesn't block, useful for example to show a loading
+         * screen until the UI is ready to be drawn without stalling. Returns
+         * @cpp true @ce if neither layer is present.
+         */
+        bool isCompileFinished();
+
         /* Overloads to remove a WTF factor from method chaining order */
         #ifndef DOXYGEN_GENERATING_OUTPUT
         UserInterfaceGL& setSize(const Vector2& size, const Vector2& windowSize, const Vector2i& framebufferSize) {
@@ -605,6 +657,9 @@ class MAGNUM_UI_EXPORT UserInterfaceGL: public UserInterface {
         UserInterfaceGL& clean() {
             return static_cast<UserInterfaceGL&>(UserInterface::clean());
         }
+        UserInterfaceGL& trim() {
+            return static_cast<UserInterfaceGL&>(UserInterface::trim());
+        }
         UserInterfaceGL& advanceAnimations(Nanoseconds time);
         UserInterfaceGL& update() {
             return static_cast<UserInterfaceGL&>(UserInterface::update());
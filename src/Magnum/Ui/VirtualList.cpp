@@ -0,0 +1,125 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "VirtualList.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Anchor.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/NodeFlags.h"
+
+namespace Magnum { namespace Ui {
+
+VirtualList::VirtualList(const AbstractAnchor& anchor, const Float rowHeight, const UnsignedInt rowCount, Containers::Function<void(NodeHandle, UnsignedInt)>&& bind): AbstractWidget{anchor}, _rowHeight{rowHeight}, _scrollOffset{}, _rowCount{rowCount}, _bind{Utility::move(bind)} {
+    CORRADE_ASSERT(rowHeight > 0.0f,
+        "Ui::VirtualList: expected a positive row height, got" << rowHeight, );
+
+    AbstractUserInterface& ui = this->ui();
+    const Vector2 size = ui.nodeSize(node());
+
+    /* One more node than what fits into the area, to cover also the case
+       where the first and last row are both partially visible */
+    const std::size_t poolSize = std::size_t(Math::ceil(size.y()/rowHeight)) + 1;
+    _nodes = Containers::Array<NodeHandle>{NoInit, poolSize};
+    _rows = Containers::Array<UnsignedInt>{DirectInit, poolSize, ~UnsignedInt{}};
+
+    /* The nodes are initially hidden and unassigned, updateInternal() then
+       shows those that get assigned to a row */
+    for(NodeHandle& i: _nodes)
+        i = ui.createNode(node(), {}, {size.x(), rowHeight}, NodeFlag::Hidden);
+    ui.addNodeFlags(node(), NodeFlag::Clip);
+
+    updateInternal(false);
+}
+
+VirtualList& VirtualList::setRowCount(const UnsignedInt count) {
+    _rowCount = count;
+    updateInternal(true);
+    return *this;
+}
+
+VirtualList& VirtualList::setScrollOffset(const Float offset) {
+    _scrollOffset = offset;
+    updateInternal(false);
+    return *this;
+}
+
+NodeHandle VirtualList::rowNode(const UnsignedInt row) const {
+    if(row >= _rowCount || _nodes.isEmpty())
+        return NodeHandle::Null;
+    const std::size_t i = row % _nodes.size();
+    return _rows[i] == row ? _nodes[i] : NodeHandle::Null;
+}
+
+VirtualList& VirtualList::rebind() {
+    updateInternal(true);
+    return *this;
+}
+
+void VirtualList::updateInternal(const bool rebind) {
+    AbstractUserInterface& ui = this->ui();
+
+    /* Clamp the offset so the last row is at the bottom edge at most. If all
+       rows fit, the offset is always zero. */
+    const Float height = ui.nodeSize(node()).y();
+    _scrollOffset = Math::clamp(_scrollOffset, 0.0f, Math::max(Float(_rowCount)*_rowHeight - height, 0.0f));
+
+    /* Each row is always assigned to the same node, which means only nodes
+       for rows that got scrolled into view need to be bound again. Nodes get
+       positioned relative to the first visible row to have the node offsets
+       stay precise even with large row indices. */
+    const UnsignedInt first = UnsignedInt(_scrollOffset/_rowHeight);
+    const Float firstOffset = Float(first)*_rowHeight - _scrollOffset;
+    for(UnsignedInt row = first, end = first + _nodes.size(); row != end; ++row) {
+        const std::size_t i = row % _nodes.size();
+        const NodeHandle node = _nodes[i];
+
+        /* Nodes past the row count get hidden */
+        if(row >= _rowCount) {
+            if(_rows[i] != ~UnsignedInt{}) {
+                ui.addNodeFlags(node, NodeFlag::Hidden);
+                _rows[i] = ~UnsignedInt{};
+            }
+            continue;
+        }
+
+        if(_rows[i] == ~UnsignedInt{})
+            ui.clearNodeFlags(node, NodeFlag::Hidden);
+        ui.setNodeOffset(node, {0.0f, firstOffset + Float(row - first)*_rowHeight});
+
+        if(_rows[i] != row || rebind) {
+            _rows[i] = row;
+            if(_bind)
+                _bind(node, row);
+        }
+    }
+}
+
+}}
@@ -0,0 +1,165 @@
+#ifndef Magnum_Ui_VirtualList_h
+#define Magnum_Ui_VirtualList_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Ui::VirtualList
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Function.h>
+
+#include "Magnum/Ui/Widget.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Virtualized list
+@m_since_latest
+
+Displays a vertical list of an arbitrary amount of equally high rows using
+only as many nodes as is needed to fill the widget area. The nodes are created
+as children of the widget @ref node() upfront and on scroll they get
+repositioned with @ref AbstractUserInterface::setNodeOffset() and reassigned to
+different rows. Every time a node gets assigned to a different row, the
+callback passed to the constructor is called with the node handle and the new
+row index, which is where the application is expected to update the data
+attached to the node, such as calling @ref TextLayer::setText() or
+@ref BaseLayer::setColor(), instead of removing and creating new data. The cost
+of a list with million rows is thus the same as of a list with just enough rows
+to fill the visible area.
+
+The rows are as wide as the widget @ref node() and are ordered from the top.
+The widget node gets @ref NodeFlag::Clip added, so partially visible rows are
+clipped by it. Nodes that would be placed at row indices past
+@ref rowCount() get @ref NodeFlag::Hidden.
+
+The widget doesn't react to any events on its own, scrolling is expected to be
+performed by calling @ref setScrollOffset(), for example from an
+@ref EventLayer::onScroll() handler.
+*/
+class MAGNUM_UI_EXPORT VirtualList: public AbstractWidget {
+    public:
+        /**
+         * @brief Constructor
+         * @param anchor     Positioning anchor
+         * @param rowHeight  Row height
+         * @param rowCount   Initial row count
+         * @param bind       Callback called with a node and a row index
+         *      every time a node gets assigned to a different row
+         *
+         * Creates as many child nodes of @p anchor as is needed to cover its
+         * height with rows when scrolling, and calls @p bind for every node
+         * that's assigned to one of the initial @p rowCount rows. The
+         * @p rowHeight is expected to be positive.
+         */
+        explicit VirtualList(const AbstractAnchor& anchor, Float rowHeight, UnsignedInt rowCount, Containers::Function<void(NodeHandle, UnsignedInt)>&& bind);
+
+        /**
+         * @brief Construct with no underlying node
+         *
+         * The instance is equivalent to a moved-out state, i.e. not usable
+         * for anything. Move another instance over it to make it useful.
+         */
+        explicit VirtualList(NoCreateT, AbstractUserInterface& ui): AbstractWidget{NoCreate, ui}, _rowHeight{}, _scrollOffset{}, _rowCount{} {}
+
+        /** @brief Row height */
+        Float rowHeight() const { return _rowHeight; }
+
+        /**
+         * @brief Node pool size
+         *
+         * Count of nodes created for the rows. Doesn't change during the
+         * lifetime of the widget.
+         */
+        std::size_t poolSize() const { return _nodes.size(); }
+
+        /** @brief Row count */
+        UnsignedInt rowCount() const { return _rowCount; }
+
+        /**
+         * @brief Set row count
+         * @return Reference to self (for method chaining)
+         *
+         * Clamps @ref scrollOffset() to the new row count. As the contents of
+         * the rows are assumed to have changed as well, calls the bind
+         * callback for all nodes that are assigned to a row after.
+         */
+        VirtualList& setRowCount(UnsignedInt count);
+
+        /** @brief Scroll offset */
+        Float scrollOffset() const { return _scrollOffset; }
+
+        /**
+         * @brief Set scroll offset
+         * @return Reference to self (for method chaining)
+         *
+         * The @p offset is clamped to range between @cpp 0.0f @ce and the
+         * total height of all rows minus the widget height. Repositions all
+         * nodes and calls the bind callback only for nodes that are assigned
+         * to a different row than before.
+         */
+        VirtualList& setScrollOffset(Float offset);
+
+        /**
+         * @brief Node assigned to given row
+         *
+         * Returns @ref NodeHandle::Null if @p row isn't currently assigned to
+         * any node, i.e. if it's scrolled out of view or isn't less than
+         * @ref rowCount().
+         */
+        NodeHandle rowNode(UnsignedInt row) const;
+
+        /**
+         * @brief Rebind all rows
+         * @return Reference to self (for method chaining)
+         *
+         * Calls the bind callback for all nodes that are currently assigned
+         * to a row. Useful when the row contents change without a change in
+         * the row count.
+         */
+        VirtualList& rebind();
+
+        #ifndef DOXYGEN_GENERATING_OUTPUT
+        _MAGNUM_UI_WIDGET_SUBCLASS_IMPLEMENTATION(VirtualList) /* LCOV_EXCL_LINE */
+        #endif
+
+    private:
+        MAGNUM_UI_LOCAL void updateInternal(bool rebind);
+
+        Float _rowHeight, _scrollOffset;
+        UnsignedInt _rowCount;
+        Containers::Function<void(NodeHandle, UnsignedInt)> _bind;
+        Containers::Array<NodeHandle> _nodes;
+        /* Row assigned to each of `_nodes`, ~UnsignedInt{} if none */
+        Containers::Array<UnsignedInt> _rows;
+};
+
+}}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef Magnum_Ui_WidgetPool_h
+#define Magnum_Ui_WidgetPool_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024, 2025
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Ui::WidgetPool
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Move.h>
+
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/Widget.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Widget pool
+@m_since_latest
+
+Keeps hidden widgets around for reuse instead of destroying them. Destroying a
+widget calls @ref AbstractUserInterface::removeNode(), which removes all data
+attached to the node from all layers, and creating a new widget then allocates
+a new node and new layer data again. For user interfaces that frequently
+rebuild parts of the widget tree, @ref recycle() the widgets that are no
+longer needed instead, and @ref reuse() them next time a widget of the same
+type is needed, updating their contents with for example
+@ref Button::setText() or @ref Label::setStyle(). The node and data handles of
+a reused widget stay the same, so there's no handle generation churn and no
+layer data reallocation.
+
+Nodes can't be moved to a different parent, so a reused widget stays at the
+place in the node hierarchy where it was originally created. Thus a pool is
+meant to be used for widgets of a single parent node, such as items of a
+single list or a single form. The widget node position and size is kept as
+well and is expected to be updated by the application, if needed.
+
+When the pool is destroyed, all widgets in it are destroyed as well, which
+means the pool is expected to not outlive the user interface the widgets are
+part of.
+*/
+template<class T> class WidgetPool {
+    public:
+        /** @brief Constructor */
+        explicit WidgetPool() = default;
+
+        /** @brief Copying is not allowed */
+        WidgetPool(const WidgetPool<T>&) = delete;
+
+        /** @brief Move constructor */
+        WidgetPool(WidgetPool<T>&&) noexcept = default;
+
+        /** @brief Copying is not allowed */
+        WidgetPool<T>& operator=(const WidgetPool<T>&) = delete;
+
+        /** @brief Move assignment */
+        WidgetPool<T>& operator=(WidgetPool<T>&&) noexcept = default;
+
+        /** @brief Count of widgets available for reuse */
+        std::size_t size() const { return _widgets.size(); }
+
+        /** @brief Whether there are no widgets available for reuse */
+        bool isEmpty() const { return _widgets.isEmpty(); }
+
+        /**
+         * @brief Recycle a widget
+         * @return Reference to self (for method chaining)
+         *
+         * Sets the widget hidden and puts it into the pool. If @p widget has
+         * a @ref NodeHandle::Null node, for example because it was moved out
+         * or released, it's ignored.
+         * @see @ref AbstractWidget::setHidden()
+         */
+        WidgetPool<T>& recycle(T&& widget) {
+            if(widget.node() != NodeHandle::Null) {
+                widget.setHidden(true);
+                arrayAppend(_widgets, Utility::move(widget));
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Reuse a widget
+         *
+         * If the pool isn't empty, takes the most recently recycled widget
+         * out of it, clears its hidden state and returns it. Otherwise
+         * returns @relativeref{Corrade,Containers::NullOpt}, in which case
+         * the application is expected to create a new widget.
+         * @see @ref AbstractWidget::setHidden()
+         */
+        Containers::Optional<T> reuse() {
+            if(_widgets.isEmpty())
+                return {};
+            Containers::Optional<T> widget{InPlaceInit, Utility::move(_widgets.back())};
+            arrayRemoveSuffix(_widgets);
+            widget->setHidden(false);
+            return widget;
+        }
+
+        /**
+         * @brief Destroy all widgets in the pool
+         * @return Reference to self (for method chaining)
+         */
+        WidgetPool<T>& clear() {
+            _widgets = {};
+            return *this;
+        }
+
+    private:
+        Containers::Array<T> _widgets;
+};
+
+}}
+
+#endif
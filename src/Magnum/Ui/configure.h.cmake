@@ -25,3 +25,8 @@
 */
 
 #cmakedefine MAGNUM_UI_BUILD_STATIC
+#define MAGNUM_UI_NODE_HANDLE_GENERATION_BITS ${MAGNUM_UI_NODE_HANDLE_GENERATION_BITS}
+#cmakedefine MAGNUM_UI_WITH_TRACING
+#cmakedefine MAGNUM_UI_WITH_LAYOUTERS
+#cmakedefine MAGNUM_UI_WITH_NODE_ANIMATORS
+#cmakedefine MAGNUM_UI_WITH_COMPOSITE_LAYERS
@@ -24,9 +24,12 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <chrono>
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Utility/Arguments.h>
 #include <Magnum/DebugTools/FrameProfiler.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Time.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Renderer.h>
@@ -37,8 +40,10 @@
 #endif
 #include <Magnum/Text/Alignment.h>
 
+#include "Magnum/Ui/AbstractUserInterface.h"
 #include "Magnum/Ui/Anchor.h"
 #include "Magnum/Ui/Application.h"
+#include "Magnum/Ui/BaseLayer.h"
 #include "Magnum/Ui/Button.h"
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Input.h"
@@ -77,6 +82,7 @@ add_custom_command(OUTPUT ... COMMAND MagnumExtras::ui-gallery ...)
 
 @code{.sh}
 magnum-ui-gallery [--magnum-...] [-h|--help] [--style STYLE]
+    [--benchmark N]
 @endcode
 
 Arguments:
@@ -87,6 +93,12 @@ Arguments:
 -   `--profile` --- enable frame profiling using
     @ref DebugTools::FrameProfilerGL printed to the console
 -   `--no-vsync` --- disable VSync for frame profiling
+-   `--benchmark N` --- instantiate the gallery @p N times in a scrollable
+    grid, run a scripted interaction consisting of hover sweeps, scrolling,
+    text input and a dialog being shown and hidden, and print per-phase
+    averages of @ref Ui::UserInterfaceUpdateStatistics to the console before
+    exiting. Combine with `--profile` and `--no-vsync` to get GPU times as
+    well.
 -   `--magnum-...` --- engine-specific options (see
     @ref GL-Context-usage-command-line for details)
 */
@@ -96,6 +108,25 @@ namespace {
 using namespace Containers::Literals;
 using namespace Math::Literals;
 
+/* Benchmark script phases, each taking BenchmarkPhaseFrames frames */
+enum class BenchmarkPhase: UnsignedByte {
+    Idle,
+    HoverSweep,
+    Scroll,
+    TextInput,
+    Dialog
+};
+
+constexpr const char* BenchmarkPhaseNames[]{
+    "Idle",
+    "Hover sweep",
+    "Scroll",
+    "Text input",
+    "Dialog open/close"
+};
+
+constexpr UnsignedInt BenchmarkPhaseFrames = 240;
+
 class UiGallery: public Platform::Application {
     public:
         explicit UiGallery(const Arguments& arguments);
@@ -111,7 +142,25 @@ class UiGallery: public Platform::Application {
         void keyReleaseEvent(KeyEvent& event) override;
         void textInputEvent(TextInputEvent& event) override;
 
+        void scrollContent(const Vector2& offset);
+        void benchmarkEvents(BenchmarkPhase phase, UnsignedInt frame);
+        void benchmarkPrint();
+
         Ui::UserInterfaceGL _ui{NoCreate};
+        Ui::NodeHandle _content;
+
+        /* Benchmark state. Statistics are accumulated for each phase and
+           printed once the script finishes. */
+        UnsignedInt _benchmarkCount{};
+        UnsignedInt _benchmarkFrame{};
+        Ui::NodeHandle _benchmarkInput{}, _benchmarkDialog{};
+        struct {
+            Nanoseconds drawDuration{};
+            Nanoseconds stageDurations[7]{};
+            UnsignedLong drawCount{}, eventCount{}, hitTestNodeCount{};
+            UnsignedLong visibleNodeCount{}, culledNodeCount{};
+            std::size_t uploadedSize{};
+        } _benchmarkPhases[Containers::arraySize(BenchmarkPhaseNames)];
 
         DebugTools::FrameProfilerGL _profiler;
 };
@@ -120,10 +169,151 @@ constexpr const Float WidgetHeight = 36.0f;
 constexpr const Float LabelHeight = 24.0f;
 constexpr const Vector2 LabelSize{72.0f, LabelHeight};
 
+/* Size of a single gallery instance including spacing, used to lay out the
+   benchmark grid */
+constexpr const Vector2 GallerySize{784.0f, 304.0f};
+
+/* Creates the gallery content inside a node of GallerySize in the top left
+   corner of given parent, returns the first enabled input node */
+Ui::NodeHandle createGallery(Ui::UserInterface& ui, Ui::NodeHandle root) {
+    /* Buttons */
+    Ui::NodeHandle buttons = Ui::label(
+        Ui::snap(ui, Ui::Snap::TopLeft|Ui::Snap::Inside, root, LabelSize),
+        "Buttons", Text::Alignment::MiddleLeft, Ui::LabelStyle::Dim);
+
+    Ui::SnapLayout snap{ui,
+        Ui::Snap::BottomLeft|Ui::Snap::InsideX, buttons, Ui::Snap::Right};
+    Ui::NodeHandle buttonDefault = Ui::button(snap({80, WidgetHeight}),
+        "Default", Ui::ButtonStyle::Default);
+    Ui::button(snap({80, WidgetHeight}),
+        "Primary", Ui::ButtonStyle::Primary);
+    Ui::button(snap({96, WidgetHeight}),
+        Ui::Icon::Yes, "Success", Ui::ButtonStyle::Success);
+    Ui::button(snap({96, WidgetHeight}),
+        Ui::Icon::No, "Warning", Ui::ButtonStyle::Warning);
+    Ui::button(snap({96, WidgetHeight}),
+        Ui::Icon::No, "Danger", Ui::ButtonStyle::Danger);
+    Ui::button(snap({80, WidgetHeight}),
+        "Info", Ui::ButtonStyle::Info);
+    Ui::button(snap({80, WidgetHeight}),
+        "Dim", Ui::ButtonStyle::Dim);
+    Ui::button(snap({80, WidgetHeight}),
+        Ui::Icon::Yes, "Flat", Ui::ButtonStyle::Flat);
+
+    snap = Ui::SnapLayout{ui,
+        Ui::Snap::BottomLeft|Ui::Snap::InsideX, buttonDefault, Ui::Snap::Right};
+    Ui::NodeHandle buttonDefaultDisabled = Ui::button(
+        snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
+        "Default", Ui::ButtonStyle::Default);
+    Ui::button(snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
+        "Primary", Ui::ButtonStyle::Primary);
+    Ui::button(snap({96, WidgetHeight}, Ui::NodeFlag::Disabled),
+        Ui::Icon::Yes, "Success", Ui::ButtonStyle::Success);
+    Ui::button(snap({96, WidgetHeight}, Ui::NodeFlag::Disabled),
+        Ui::Icon::No, "Warning", Ui::ButtonStyle::Warning);
+    Ui::button(snap({96, WidgetHeight}, Ui::NodeFlag::Disabled),
+        Ui::Icon::No, "Danger", Ui::ButtonStyle::Danger);
+    Ui::button(snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
+        "Info", Ui::ButtonStyle::Info);
+    Ui::button(snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
+        "Dim", Ui::ButtonStyle::Dim);
+    Ui::button(snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
+        Ui::Icon::Yes, "Flat", Ui::ButtonStyle::Flat);
+
+    /* Labels */
+    Ui::NodeHandle labels = Ui::label(
+        Ui::snap(ui, Ui::Snap::BottomLeft|Ui::Snap::InsideX, buttonDefaultDisabled, {0, 8}, LabelSize),
+        "Labels", Text::Alignment::MiddleLeft, Ui::LabelStyle::Dim);
+
+    snap = Ui::SnapLayout{ui,
+        Ui::Snap::BottomLeft|Ui::Snap::InsideX, labels, Ui::Snap::Right};
+    Ui::NodeHandle labelDefault = Ui::label(snap(LabelSize),
+        "Default", Ui::LabelStyle::Default);
+    Ui::label(snap(LabelSize),
+        "Primary", Ui::LabelStyle::Primary);
+    Ui::label(snap(LabelSize),
+        "Success", Ui::LabelStyle::Success);
+    Ui::label(snap(LabelSize),
+        "Warning", Ui::LabelStyle::Warning);
+    Ui::label(snap(LabelSize),
+        "Danger", Ui::LabelStyle::Danger);
+    Ui::label(snap(LabelSize),
+        "Info", Ui::LabelStyle::Info);
+    Ui::label(snap(LabelSize),
+        "Dim", Ui::LabelStyle::Dim);
+
+    snap = Ui::SnapLayout{ui,
+        Ui::Snap::BottomLeft|Ui::Snap::InsideX, labelDefault, Ui::Snap::Right};
+    Ui::NodeHandle labelDefaultDisabled = Ui::label(
+        snap(LabelSize, Ui::NodeFlag::Disabled),
+        "Default", Ui::LabelStyle::Default);
+    Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
+        "Primary", Ui::LabelStyle::Primary);
+    Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
+        "Success", Ui::LabelStyle::Success);
+    Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
+        "Warning", Ui::LabelStyle::Warning);
+    Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
+        "Danger", Ui::LabelStyle::Danger);
+    Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
+        "Info", Ui::LabelStyle::Info);
+    Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
+        "Dim", Ui::LabelStyle::Dim);
+
+    /* Inputs */
+    Ui::NodeHandle inputs = Ui::label(
+        Ui::snap(ui, Ui::Snap::BottomLeft|Ui::Snap::InsideX, labelDefaultDisabled, {0, 8}, LabelSize),
+        "Inputs", Text::Alignment::MiddleLeft, Ui::LabelStyle::Dim);
+
+    snap = Ui::SnapLayout{ui,
+        Ui::Snap::BottomLeft|Ui::Snap::InsideX, inputs,
+        Ui::Snap::Right};
+    Ui::Input inputDefault{snap({128, WidgetHeight}),
+        "Default", Ui::InputStyle::Default};
+    Ui::Input inputSuccess{snap({128, WidgetHeight}),
+        "Success", Ui::InputStyle::Success};
+    Ui::Input inputWarning{snap({128, WidgetHeight}),
+        "Warning", Ui::InputStyle::Warning};
+    Ui::Input inputDanger{snap({128, WidgetHeight}),
+        "Danger", Ui::InputStyle::Danger};
+    Ui::Input inputFlat{snap({128, WidgetHeight}),
+        "Flat", Ui::InputStyle::Flat};
+
+    snap = Ui::SnapLayout{ui,
+        Ui::Snap::BottomLeft|Ui::Snap::InsideX, inputDefault,
+        Ui::Snap::Right};
+    Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
+        "Default", Ui::InputStyle::Default}.release();
+    Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
+        "Succes", Ui::InputStyle::Success}.release();
+    Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
+        "Warning", Ui::InputStyle::Warning}.release();
+    Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
+        "Danger", Ui::InputStyle::Danger}.release();
+    Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
+        "Flat", Ui::InputStyle::Flat}.release();
+
+    /** @todo provide some APIs on the Input directly */
+    ui.textLayer().setCursor(inputDefault.textData(), 7, 2);
+    ui.textLayer().setCursor(inputSuccess.textData(), 3, 6);
+    ui.textLayer().setCursor(inputWarning.textData(), 7, 0);
+    ui.textLayer().setCursor(inputDanger.textData(), 0, 3);
+    ui.textLayer().setCursor(inputFlat.textData(), 3, 1);
+    const Ui::NodeHandle input = inputDefault.node();
+    inputDefault.release();
+    inputSuccess.release();
+    inputWarning.release();
+    inputDanger.release();
+    inputFlat.release();
+
+    return input;
+}
+
 UiGallery::UiGallery(const Arguments& arguments): Platform::Application{arguments, NoCreate} {
     Utility::Arguments args;
     args.addBooleanOption("subdivided-quads").setHelp("subdivided-quads", "enable BaseLayerSharedFlag::SubdividedQuads")
         .addBooleanOption("profile").setHelp("profile", "enable frame profiling printed to the console")
+        .addOption("benchmark", "0").setHelp("benchmark", "instantiate the gallery N times in a grid and run a scripted benchmark", "N")
         #ifndef CORRADE_TARGET_EMSCRIPTEN
         .addBooleanOption("no-vsync").setHelp("no-vsync", "disable VSync for frame profiling")
         #endif
@@ -137,7 +327,15 @@ UiGallery::UiGallery(const Arguments& arguments): Platform::Application{argument
         .setTitle("Magnum::Ui Gallery"_s)
         .setWindowFlags(Configuration::WindowFlag::Resizable));
 
+    /* On WebGL every draw call is expensive, so clip in the shader to draw
+       each layer at once instead of once for every clip rect */
+    #ifndef MAGNUM_TARGET_WEBGL
     _ui.create(*this, Ui::McssDarkStyle{});
+    #else
+    _ui.create(*this, Ui::McssDarkStyle{}
+        .setBaseLayerFlags(Ui::BaseLayerSharedFlag::ShaderClipping, {})
+        .setTextLayerFlags(Ui::TextLayerSharedFlag::ShaderClipping));
+    #endif
 
     /* Set up the profiler, if enabled */
     if(args.isSet("profile")) {
@@ -156,137 +354,40 @@ UiGallery::UiGallery(const Arguments& arguments): Platform::Application{argument
             50);
     } else _profiler.disable(); /** @todo why this isn't a default? */
 
-    Ui::NodeHandle root = _ui.createNode({}, _ui.size());
-
-    {
-        /* Buttons */
-        Ui::NodeHandle buttons = Ui::label(
-            Ui::snap(_ui, Ui::Snap::TopLeft|Ui::Snap::Inside, root, LabelSize),
-            "Buttons", Text::Alignment::MiddleLeft, Ui::LabelStyle::Dim);
-
-        Ui::SnapLayout snap{_ui,
-            Ui::Snap::BottomLeft|Ui::Snap::InsideX, buttons, Ui::Snap::Right};
-        Ui::NodeHandle buttonDefault = Ui::button(snap({80, WidgetHeight}),
-            "Default", Ui::ButtonStyle::Default);
-        Ui::button(snap({80, WidgetHeight}),
-            "Primary", Ui::ButtonStyle::Primary);
-        Ui::button(snap({96, WidgetHeight}),
-            Ui::Icon::Yes, "Success", Ui::ButtonStyle::Success);
-        Ui::button(snap({96, WidgetHeight}),
-            Ui::Icon::No, "Warning", Ui::ButtonStyle::Warning);
-        Ui::button(snap({96, WidgetHeight}),
-            Ui::Icon::No, "Danger", Ui::ButtonStyle::Danger);
-        Ui::button(snap({80, WidgetHeight}),
-            "Info", Ui::ButtonStyle::Info);
-        Ui::button(snap({80, WidgetHeight}),
-            "Dim", Ui::ButtonStyle::Dim);
-        Ui::button(snap({80, WidgetHeight}),
-            Ui::Icon::Yes, "Flat", Ui::ButtonStyle::Flat);
-
-        snap = Ui::SnapLayout{_ui,
-            Ui::Snap::BottomLeft|Ui::Snap::InsideX, buttonDefault, Ui::Snap::Right};
-        Ui::NodeHandle buttonDefaultDisabled = Ui::button(
-            snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
-            "Default", Ui::ButtonStyle::Default);
-        Ui::button(snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
-            "Primary", Ui::ButtonStyle::Primary);
-        Ui::button(snap({96, WidgetHeight}, Ui::NodeFlag::Disabled),
-            Ui::Icon::Yes, "Success", Ui::ButtonStyle::Success);
-        Ui::button(snap({96, WidgetHeight}, Ui::NodeFlag::Disabled),
-            Ui::Icon::No, "Warning", Ui::ButtonStyle::Warning);
-        Ui::button(snap({96, WidgetHeight}, Ui::NodeFlag::Disabled),
-            Ui::Icon::No, "Danger", Ui::ButtonStyle::Danger);
-        Ui::button(snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
-            "Info", Ui::ButtonStyle::Info);
-        Ui::button(snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
-            "Dim", Ui::ButtonStyle::Dim);
-        Ui::button(snap({80, WidgetHeight}, Ui::NodeFlag::Disabled),
-            Ui::Icon::Yes, "Flat", Ui::ButtonStyle::Flat);
-
-        /* Labels */
-        Ui::NodeHandle labels = Ui::label(
-            Ui::snap(_ui, Ui::Snap::BottomLeft|Ui::Snap::InsideX, buttonDefaultDisabled, {0, 8}, LabelSize),
-            "Labels", Text::Alignment::MiddleLeft, Ui::LabelStyle::Dim);
-
-        snap = Ui::SnapLayout{_ui,
-            Ui::Snap::BottomLeft|Ui::Snap::InsideX, labels, Ui::Snap::Right};
-        Ui::NodeHandle labelDefault = Ui::label(snap(LabelSize),
-            "Default", Ui::LabelStyle::Default);
-        Ui::label(snap(LabelSize),
-            "Primary", Ui::LabelStyle::Primary);
-        Ui::label(snap(LabelSize),
-            "Success", Ui::LabelStyle::Success);
-        Ui::label(snap(LabelSize),
-            "Warning", Ui::LabelStyle::Warning);
-        Ui::label(snap(LabelSize),
-            "Danger", Ui::LabelStyle::Danger);
-        Ui::label(snap(LabelSize),
-            "Info", Ui::LabelStyle::Info);
-        Ui::label(snap(LabelSize),
-            "Dim", Ui::LabelStyle::Dim);
-
-        snap = Ui::SnapLayout{_ui,
-            Ui::Snap::BottomLeft|Ui::Snap::InsideX, labelDefault, Ui::Snap::Right};
-        Ui::NodeHandle labelDefaultDisabled = Ui::label(
-            snap(LabelSize, Ui::NodeFlag::Disabled),
-            "Default", Ui::LabelStyle::Default);
-        Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
-            "Primary", Ui::LabelStyle::Primary);
-        Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
-            "Success", Ui::LabelStyle::Success);
-        Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
-            "Warning", Ui::LabelStyle::Warning);
-        Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
-            "Danger", Ui::LabelStyle::Danger);
-        Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
-            "Info", Ui::LabelStyle::Info);
-        Ui::label(snap(LabelSize, Ui::NodeFlag::Disabled),
-            "Dim", Ui::LabelStyle::Dim);
-
-        /* Inputs */
-        Ui::NodeHandle inputs = Ui::label(
-            Ui::snap(_ui, Ui::Snap::BottomLeft|Ui::Snap::InsideX, labelDefaultDisabled, {0, 8}, LabelSize),
-            "Inputs", Text::Alignment::MiddleLeft, Ui::LabelStyle::Dim);
-
-        snap = Ui::SnapLayout{_ui,
-            Ui::Snap::BottomLeft|Ui::Snap::InsideX, inputs,
-            Ui::Snap::Right};
-        Ui::Input inputDefault{snap({128, WidgetHeight}),
-            "Default", Ui::InputStyle::Default};
-        Ui::Input inputSuccess{snap({128, WidgetHeight}),
-            "Success", Ui::InputStyle::Success};
-        Ui::Input inputWarning{snap({128, WidgetHeight}),
-            "Warning", Ui::InputStyle::Warning};
-        Ui::Input inputDanger{snap({128, WidgetHeight}),
-            "Danger", Ui::InputStyle::Danger};
-        Ui::Input inputFlat{snap({128, WidgetHeight}),
-            "Flat", Ui::InputStyle::Flat};
-
-        snap = Ui::SnapLayout{_ui,
-            Ui::Snap::BottomLeft|Ui::Snap::InsideX, inputDefault,
-            Ui::Snap::Right};
-        Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
-            "Default", Ui::InputStyle::Default}.release();
-        Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
-            "Succes", Ui::InputStyle::Success}.release();
-        Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
-            "Warning", Ui::InputStyle::Warning}.release();
-        Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
-            "Danger", Ui::InputStyle::Danger}.release();
-        Ui::Input{snap({128, WidgetHeight}, Ui::NodeFlag::Disabled),
-            "Flat", Ui::InputStyle::Flat}.release();
-
-        /** @todo provide some APIs on the Input directly */
-        _ui.textLayer().setCursor(inputDefault.textData(), 7, 2);
-        _ui.textLayer().setCursor(inputSuccess.textData(), 3, 6);
-        _ui.textLayer().setCursor(inputWarning.textData(), 7, 0);
-        _ui.textLayer().setCursor(inputDanger.textData(), 0, 3);
-        _ui.textLayer().setCursor(inputFlat.textData(), 3, 1);
-        inputDefault.release();
-        inputSuccess.release();
-        inputWarning.release();
-        inputDanger.release();
-        inputFlat.release();
+    /* In the benchmark mode put the gallery N times into a grid that's
+       scrolled by the script or by the mouse wheel. Nodes outside of the
+       window get culled. */
+    _benchmarkCount = args.value<UnsignedInt>("benchmark");
+    if(_benchmarkCount) {
+        const UnsignedInt columns = Math::max(UnsignedInt(Math::ceil(Math::sqrt(Float(_benchmarkCount)))), 1u);
+        const UnsignedInt rows = (_benchmarkCount + columns - 1)/columns;
+        _content = _ui.createNode({}, GallerySize*Vector2{Float(columns), Float(rows)});
+        for(UnsignedInt i = 0; i != _benchmarkCount; ++i) {
+            const Ui::NodeHandle instance = _ui.createNode(_content,
+                GallerySize*Vector2{Float(i%columns), Float(i/columns)},
+                GallerySize);
+            const Ui::NodeHandle input = createGallery(_ui, instance);
+            if(i == 0) _benchmarkInput = input;
+        }
+
+        /* A dialog with a few widgets on top, shown and hidden by the
+           script */
+        _benchmarkDialog = Ui::snap(_ui, Ui::Snaps{}, {320, 128}, Ui::NodeFlag::Hidden);
+        Ui::label(
+            Ui::snap(_ui, Ui::Snap::Top|Ui::Snap::Inside, _benchmarkDialog, {0, 16}, {288, LabelHeight}),
+            "Are you sure?", Ui::LabelStyle::Default);
+        Ui::button(
+            Ui::snap(_ui, Ui::Snap::BottomLeft|Ui::Snap::Inside, _benchmarkDialog, {48, -16}, {96, WidgetHeight}),
+            Ui::Icon::Yes, "Yes", Ui::ButtonStyle::Success);
+        Ui::button(
+            Ui::snap(_ui, Ui::Snap::BottomRight|Ui::Snap::Inside, _benchmarkDialog, {-48, -16}, {96, WidgetHeight}),
+            Ui::Icon::No, "No", Ui::ButtonStyle::Danger);
+
+        _ui.setUpdateStatistics(true);
+        Debug{} << "Running a benchmark with" << _benchmarkCount << "gallery instances," << BenchmarkPhaseFrames << "frames per phase";
+    } else {
+        _content = _ui.createNode({}, _ui.size());
+        createGallery(_ui, _content);
     }
 
     #ifdef CORRADE_TARGET_EMSCRIPTEN
@@ -314,16 +415,124 @@ void UiGallery::viewportEvent(ViewportEvent& event) {
 void UiGallery::drawEvent() {
     GL::defaultFramebuffer.clear(GL::FramebufferClear::Color|GL::FramebufferClear::Depth);
 
+    /* Feed the scripted events for this frame before drawing so their
+       processing is included in the update statistics */
+    const UnsignedInt phase = _benchmarkFrame/BenchmarkPhaseFrames;
+    if(_benchmarkCount)
+        benchmarkEvents(BenchmarkPhase(phase), _benchmarkFrame % BenchmarkPhaseFrames);
+
     _profiler.beginFrame();
 
+    const std::chrono::steady_clock::time_point drawBegin = std::chrono::steady_clock::now();
+
     _ui.draw();
 
+    if(_benchmarkCount) {
+        auto& out = _benchmarkPhases[phase];
+        out.drawDuration += Nanoseconds{std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - drawBegin).count()};
+
+        const Ui::UserInterfaceUpdateStatistics& statistics = _ui.updateStatistics();
+        for(std::size_t i = 0; i != Containers::arraySize(out.stageDurations); ++i)
+            out.stageDurations[i] += statistics.stageDurations[i];
+        out.drawCount += statistics.drawCount;
+        out.eventCount += statistics.eventCount;
+        out.hitTestNodeCount += statistics.hitTestNodeCount;
+        out.visibleNodeCount += statistics.visibleNodeCount;
+        out.culledNodeCount += statistics.culledNodeCount;
+        for(const std::size_t size: statistics.layerUploadedSizes)
+            out.uploadedSize += size;
+    }
+
     _profiler.endFrame();
 
     _profiler.printStatistics(50);
 
     swapBuffers();
-    if(_ui.state() || _profiler.isEnabled()) redraw();
+
+    /* Once all phases are done, print the statistics and exit */
+    if(_benchmarkCount && ++_benchmarkFrame == Containers::arraySize(_benchmarkPhases)*BenchmarkPhaseFrames) {
+        benchmarkPrint();
+        exit();
+        return;
+    }
+
+    if(_ui.state() || _profiler.isEnabled() || _benchmarkCount) redraw();
+}
+
+void UiGallery::scrollContent(const Vector2& offset) {
+    const Vector2 min = Math::min(_ui.size() - _ui.nodeSize(_content), Vector2{});
+    _ui.setNodeOffset(_content, Math::clamp(_ui.nodeOffset(_content) + offset, min, Vector2{}));
+}
+
+void UiGallery::benchmarkEvents(const BenchmarkPhase phase, const UnsignedInt frame) {
+    /* Pretend a fixed 60 FPS to have the event timestamps reproducible */
+    const Nanoseconds time{Long(_benchmarkFrame)*16666667ll};
+    const Vector2 size = _ui.size();
+
+    switch(phase) {
+        /* Nothing happening, measures the baseline cost of a redraw */
+        case BenchmarkPhase::Idle:
+            break;
+
+        /* Zig-zag the pointer across the window in eight rows, hovering over
+           the widgets along the way */
+        case BenchmarkPhase::HoverSweep: {
+            constexpr UnsignedInt RowFrames = BenchmarkPhaseFrames/8;
+            const UnsignedInt row = frame/RowFrames;
+            const Float x = Float(frame % RowFrames)/(RowFrames - 1);
+            Ui::PointerMoveEvent event{time, Ui::PointerEventSource::Mouse, {}, {}, true, 0};
+            _ui.pointerMoveEvent(size*Vector2{row % 2 ? 1.0f - x : x, (row + 0.5f)/8.0f}, event);
+        } break;
+
+        /* Scroll down over four gallery rows and back, the pointer staying
+           at where the hover sweep left it */
+        case BenchmarkPhase::Scroll: {
+            const Float step = GallerySize.y()*4.0f/(BenchmarkPhaseFrames/2);
+            scrollContent({0.0f, frame < BenchmarkPhaseFrames/2 ? -step : step});
+        } break;
+
+        /* Focus the first input, type into it with an occasional backspace
+           and then blur it again */
+        case BenchmarkPhase::TextInput: {
+            if(frame == 0) {
+                Ui::FocusEvent event{time};
+                _ui.focusEvent(_benchmarkInput, event);
+            } else if(frame == BenchmarkPhaseFrames - 1) {
+                Ui::FocusEvent event{time};
+                _ui.focusEvent(Ui::NodeHandle::Null, event);
+            } else if(frame % 8 == 7) {
+                Ui::KeyEvent event{time, Ui::Key::Backspace, {}};
+                _ui.keyPressEvent(event);
+            } else {
+                Ui::TextInputEvent event{time, "a"_s};
+                _ui.textInputEvent(event);
+            }
+        } break;
+
+        /* Show and hide the dialog every twelve frames */
+        case BenchmarkPhase::Dialog:
+            if(frame % 24 == 0)
+                _ui.clearNodeFlags(_benchmarkDialog, Ui::NodeFlag::Hidden);
+            else if(frame % 24 == 12)
+                _ui.addNodeFlags(_benchmarkDialog, Ui::NodeFlag::Hidden);
+            break;
+    }
+}
+
+void UiGallery::benchmarkPrint() {
+    const Float frames = BenchmarkPhaseFrames;
+    for(std::size_t i = 0; i != Containers::arraySize(_benchmarkPhases); ++i) {
+        const auto& phase = _benchmarkPhases[i];
+        Debug{} << BenchmarkPhaseNames[i] << Debug::nospace << ":";
+        Debug{} << "  Total draw():" << Long(phase.drawDuration)/frames/1.0e3f << "µs";
+        for(std::size_t j = 0; j != Containers::arraySize(phase.stageDurations); ++j)
+            Debug{} << "   " << Ui::UserInterfaceUpdateStage(j) << Debug::nospace << ":" << Long(phase.stageDurations[j])/frames/1.0e3f << "µs";
+        Debug{} << "  Draws:" << phase.drawCount/frames
+            << Debug::newline << "  Events:" << phase.eventCount/frames
+            << Debug::newline << "  Hit-tested nodes:" << phase.hitTestNodeCount/frames
+            << Debug::newline << "  Visible nodes:" << phase.visibleNodeCount/frames << Debug::nospace << "," << phase.culledNodeCount/frames << "culled"
+            << Debug::newline << "  Uploaded:" << phase.uploadedSize/frames/1024.0f << "kB";
+    }
 }
 
 void UiGallery::pointerPressEvent(PointerEvent& event) {
@@ -345,7 +554,12 @@ void UiGallery::pointerMoveEvent(PointerMoveEvent& event) {
 }
 
 void UiGallery::scrollEvent(ScrollEvent& event) {
-    _ui.scrollEvent(event);
+    /* In the benchmark mode scroll the grid if the UI doesn't use the
+       event */
+    if(!_ui.scrollEvent(event) && _benchmarkCount) {
+        scrollContent(event.offset()*WidgetHeight);
+        event.setAccepted();
+    }
 
     if(_ui.state()) redraw();
 }
@@ -26,6 +26,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/PluginManager/PluginManager.h>
 #include <Magnum/DebugTools/FrameProfiler.h>
 #ifdef CORRADE_TARGET_EMSCRIPTEN
 #include <Magnum/Platform/EmscriptenApplication.h>
@@ -48,10 +49,15 @@ class AbstractPlayer: public Platform::Screen {
         friend Player;
 
         virtual void load(Containers::StringView filename, Trade::AbstractImporter& importer, Int id) = 0;
+
+        /* Renders given count of frames, prints timing statistics and exits
+           the application. Returns false if the player doesn't support
+           benchmarking. */
+        virtual bool benchmark(UnsignedInt, bool) { return false; }
 };
 
 /* Extreme PIMPL. */
-Containers::Pointer<AbstractPlayer> createScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues);
+Containers::Pointer<AbstractPlayer> createScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues, PluginManager::Manager<Trade::AbstractImporter>& importerManager, Containers::StringView textureCacheDirectory, bool optimizeMeshes, Float animationBakeRate);
 Containers::Pointer<AbstractPlayer> createImagePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls);
 
 }}
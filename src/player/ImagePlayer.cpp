@@ -25,13 +25,17 @@
 */
 
 #include <sstream>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StringStl.h> /** @todo drop once Debug is stream-free */
 #include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/FormatStl.h> /** @todo drop once Debug is stream-free */
+#include <Corrade/Utility/Move.h>
 #include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderer.h>
@@ -44,6 +48,14 @@
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/MeshData.h>
 
+#ifdef MAGNUM_TARGET_WEBGL
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Shaders/GenericGL.h>
+#endif
+
 #include "Magnum/Ui/Anchor.h"
 #include "Magnum/Ui/Label.h"
 #include "Magnum/Ui/SnapLayouter.h"
@@ -60,6 +72,79 @@ namespace {
 constexpr const Float LabelHeight{36.0f};
 constexpr const Vector2 LabelSize{72.0f, LabelHeight};
 
+/* Images larger than this in any dimension, or larger than the max texture
+   size, are split into tiles. Only tiles that are visible get uploaded, at
+   most MaxTileUploadsPerFrame in a single frame to not stall the UI, and the
+   least recently used tiles are evicted when there's more than
+   MaxResidentTiles. */
+constexpr const Int TiledImageThreshold = 8192;
+constexpr const Int TileSize = 2048;
+constexpr const std::size_t MaxResidentTiles = 32;
+constexpr const std::size_t MaxTileUploadsPerFrame = 4;
+
+/* On WebGL there's no texture swizzle, so one- and two-channel images are
+   uploaded as-is and displayed through GrayscaleShader instead of expanding
+   them to RGB / RGBA on the CPU first */
+#ifdef MAGNUM_TARGET_WEBGL
+constexpr const bool ExpandChannels = false;
+
+class GrayscaleShader: public GL::AbstractShaderProgram {
+    public:
+        typedef Shaders::GenericGL2D::Position Position;
+        typedef Shaders::GenericGL2D::TextureCoordinates TextureCoordinates;
+
+        explicit GrayscaleShader(NoCreateT): GL::AbstractShaderProgram{NoCreate} {}
+        explicit GrayscaleShader();
+
+        GrayscaleShader& setTransformationProjectionMatrix(const Matrix3& matrix) {
+            setUniform(_transformationProjectionMatrixUniform, matrix);
+            return *this;
+        }
+
+        GrayscaleShader& setAlphaFromSecondChannel(bool value) {
+            setUniform(_alphaFromSecondChannelUniform, value ? 1.0f : 0.0f);
+            return *this;
+        }
+
+        GrayscaleShader& bindTexture(GL::Texture2D& texture) {
+            texture.bind(0);
+            return *this;
+        }
+
+    private:
+        Int _transformationProjectionMatrixUniform,
+            _alphaFromSecondChannelUniform;
+};
+
+GrayscaleShader::GrayscaleShader() {
+    GL::Shader vert{GL::Version::GLES300, GL::Shader::Type::Vertex};
+    GL::Shader frag{GL::Version::GLES300, GL::Shader::Type::Fragment};
+
+    Utility::Resource rs{"data"};
+    vert.addSource(rs.getString("GrayscaleShader.vert"));
+    frag.addSource(rs.getString("GrayscaleShader.frag"));
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
+
+    attachShaders({vert, frag});
+    bindAttributeLocation(Position::Location, "position");
+    bindAttributeLocation(TextureCoordinates::Location, "textureCoordinates");
+    CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+    _transformationProjectionMatrixUniform = uniformLocation("transformationProjectionMatrix");
+    _alphaFromSecondChannelUniform = uniformLocation("alphaFromSecondChannel");
+    setUniform(uniformLocation("imageTexture"), 0);
+}
+#else
+constexpr const bool ExpandChannels = true;
+#endif
+
+struct Tile {
+    Range2Di range;
+    GL::Texture2D texture{NoCreate};
+    UnsignedLong lastUsedFrame;
+};
+
 class ImagePlayer: public AbstractPlayer {
     public:
         explicit ImagePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls);
@@ -76,6 +161,10 @@ class ImagePlayer: public AbstractPlayer {
         Vector2 unproject(const Vector2& windowPosition) const;
         Vector2 unprojectRelative(const Vector2& relativeWindowPosition) const;
 
+        void drawSquare(GL::Texture2D& texture, const Matrix3& transformationProjectionMatrix);
+        void drawTiles();
+        void loadTile(Tile& tile);
+
         Shaders::FlatGL2D _coloredShader;
 
         /* UI */
@@ -92,7 +181,17 @@ class ImagePlayer: public AbstractPlayer {
         GL::Mesh _square;
         Shaders::FlatGL2D _shader{Shaders::FlatGL2D::Configuration{}
             .setFlags(Shaders::FlatGL2D::Flag::Textured)};
+        #ifdef MAGNUM_TARGET_WEBGL
+        GrayscaleShader _grayscaleShader{NoCreate};
+        UnsignedInt _channelCount{};
+        #endif
         Vector2i _imageSize;
+        /* Tiled mode. The image is kept in memory and uploaded only partially
+           to the tile textures, _texture is unused in that case. */
+        Containers::Optional<Trade::ImageData2D> _tiledImage;
+        Containers::Array<Tile> _tiles;
+        std::size_t _residentTileCount{};
+        UnsignedLong _frame{};
         Matrix3 _transformation;
         Matrix3 _projection;
 };
@@ -113,9 +212,6 @@ void ImagePlayer::drawEvent() {
     #endif
     GL::defaultFramebuffer.clear(GL::FramebufferClear::Color|GL::FramebufferClear::Depth);
 
-    _shader.bindTexture(_texture)
-        .setTransformationProjectionMatrix(_projection*_transformation);
-
     /* Enable blending, disable depth test */
     GL::Renderer::enable(GL::Renderer::Feature::Blending);
     GL::Renderer::disable(GL::Renderer::Feature::DepthTest);
@@ -123,12 +219,103 @@ void ImagePlayer::drawEvent() {
     /* Draw the image with non-premultiplied alpha blending as that's the
        common format */
     GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::SourceAlpha, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
-    _shader.draw(_square);
+    if(_tiledImage) drawTiles();
+    else drawSquare(_texture, _projection*_transformation);
 
     GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
     GL::Renderer::disable(GL::Renderer::Feature::Blending);
 }
 
+void ImagePlayer::drawSquare(GL::Texture2D& texture, const Matrix3& transformationProjectionMatrix) {
+    #ifdef MAGNUM_TARGET_WEBGL
+    if(_channelCount == 1 || _channelCount == 2) {
+        _grayscaleShader.bindTexture(texture)
+            .setTransformationProjectionMatrix(transformationProjectionMatrix)
+            .setAlphaFromSecondChannel(_channelCount == 2);
+        _grayscaleShader.draw(_square);
+        return;
+    }
+    #endif
+
+    _shader.bindTexture(texture)
+        .setTransformationProjectionMatrix(transformationProjectionMatrix);
+    _shader.draw(_square);
+}
+
+void ImagePlayer::drawTiles() {
+    ++_frame;
+
+    /* The square is [-1, 1] in both dimensions, calculate which part of it is
+       visible and convert that to a pixel range in the image */
+    const Matrix3 inverseTransformation = _transformation.inverted();
+    const Vector2 halfFramebufferSize = Vector2{application().framebufferSize()}*0.5f;
+    const Vector2 imageSize{_imageSize};
+    const Range2D visible{
+        (inverseTransformation.transformPoint(-halfFramebufferSize) + Vector2{1.0f})*0.5f*imageSize,
+        (inverseTransformation.transformPoint(halfFramebufferSize) + Vector2{1.0f})*0.5f*imageSize};
+
+    std::size_t uploadCount = 0;
+    bool uploadsPending = false;
+    for(Tile& tile: _tiles) {
+        if(!Math::intersects(visible, Range2D{tile.range}))
+            continue;
+
+        if(!tile.texture.id()) {
+            if(uploadCount == MaxTileUploadsPerFrame) {
+                uploadsPending = true;
+                continue;
+            }
+
+            loadTile(tile);
+            ++uploadCount;
+        }
+        tile.lastUsedFrame = _frame;
+
+        /* Map the square to the tile area */
+        const Range2D range{Vector2{tile.range.min()}/imageSize*2.0f - Vector2{1.0f},
+                            Vector2{tile.range.max()}/imageSize*2.0f - Vector2{1.0f}};
+        drawSquare(tile.texture, _projection*_transformation*
+            Matrix3::translation(range.center())*
+            Matrix3::scaling(range.size()*0.5f));
+    }
+
+    /* Evict least recently used tiles that weren't visible in this frame
+       until the resident count is within the budget */
+    while(_residentTileCount > MaxResidentTiles) {
+        Tile* leastRecentlyUsed = nullptr;
+        for(Tile& tile: _tiles) {
+            if(tile.texture.id() && tile.lastUsedFrame != _frame &&
+               (!leastRecentlyUsed || tile.lastUsedFrame < leastRecentlyUsed->lastUsedFrame))
+                leastRecentlyUsed = &tile;
+        }
+        if(!leastRecentlyUsed) break;
+
+        leastRecentlyUsed->texture = GL::Texture2D{NoCreate};
+        --_residentTileCount;
+    }
+
+    /* Continue with remaining uploads next frame */
+    if(uploadsPending) redraw();
+}
+
+void ImagePlayer::loadTile(Tile& tile) {
+    const Trade::ImageData2D& image = *_tiledImage;
+
+    tile.texture = GL::Texture2D{};
+    tile.texture
+        .setMagnificationFilter(GL::SamplerFilter::Nearest)
+        .setMinificationFilter(GL::SamplerFilter::Linear)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge);
+
+    /* View on the tile area in the original image data */
+    PixelStorage storage = image.storage();
+    storage
+        .setRowLength(storage.rowLength() ? storage.rowLength() : image.size().x())
+        .setSkip(storage.skip() + Vector3i{tile.range.min(), 0});
+    loadImage(tile.texture, ImageView2D{storage, image.format(), tile.range.size(), image.data()}, ExpandChannels);
+    ++_residentTileCount;
+}
+
 void ImagePlayer::viewportEvent(ViewportEvent& event) {
     _projection = Matrix3::projection(Vector2{event.framebufferSize()});
 }
@@ -196,13 +383,41 @@ void ImagePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
     Containers::Optional<Trade::ImageData2D> image = importer.image2D(id);
     if(!image) return;
 
-    _texture = GL::Texture2D{};
-    _texture
-        .setMagnificationFilter(GL::SamplerFilter::Nearest)
-        .setMinificationFilter(GL::SamplerFilter::Linear)
-        .setWrapping(GL::SamplerWrapping::ClampToEdge);
+    _tiledImage = Containers::NullOpt;
+    _tiles = {};
+    _residentTileCount = 0;
 
-    loadImage(_texture, *image);
+    #ifdef MAGNUM_TARGET_WEBGL
+    _channelCount = !image->isCompressed() && !isPixelFormatImplementationSpecific(image->format()) ? pixelFormatChannelCount(image->format()) : 0;
+    if((_channelCount == 1 || _channelCount == 2) && !_grayscaleShader.id())
+        _grayscaleShader = GrayscaleShader{};
+    #endif
+
+    /* Large uncompressed images are split into tiles that get uploaded on
+       demand in drawTiles() */
+    if(!image->isCompressed() && (image->size() > Math::min(GL::Texture2D::maxSize(), Vector2i{TiledImageThreshold})).any()) {
+        const Vector2i tileCount = (image->size() + Vector2i{TileSize - 1})/TileSize;
+        Debug{} << "Image too large, splitting into" << tileCount.x() << "x" << tileCount.y() << "tiles";
+
+        _tiles = Containers::Array<Tile>{std::size_t(tileCount.product())};
+        for(Int y = 0; y != tileCount.y(); ++y) {
+            for(Int x = 0; x != tileCount.x(); ++x) {
+                const Vector2i min = Vector2i{x, y}*TileSize;
+                _tiles[y*tileCount.x() + x].range = {min, Math::min(min + Vector2i{TileSize}, image->size())};
+            }
+        }
+
+        _texture = GL::Texture2D{NoCreate};
+
+    } else {
+        _texture = GL::Texture2D{};
+        _texture
+            .setMagnificationFilter(GL::SamplerFilter::Nearest)
+            .setMinificationFilter(GL::SamplerFilter::Linear)
+            .setWrapping(GL::SamplerWrapping::ClampToEdge);
+
+        loadImage(_texture, *image, ExpandChannels);
+    }
 
     /* Set up default transformation. Centered, 1:1 scale if more than 50% of
        the view, otherwise scaled up to 90% of the view. */
@@ -230,6 +445,8 @@ void ImagePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         /** @todo ugh, having to specify this every time is NASTY, what to do
             besides supplying extra style variants? */
         Text::Alignment::MiddleLeft);
+
+    if(!_tiles.isEmpty()) _tiledImage = Utility::move(*image);
 }
 
 }
@@ -26,11 +26,15 @@
 
 #include "LoadImage.h"
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Functions.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/BufferImage.h>
+#endif
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Texture.h>
@@ -39,103 +43,152 @@
 
 namespace Magnum { namespace Player {
 
-void loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image) {
-    if(!image.isCompressed()) {
-        /* Single-channel images are probably meant to represent grayscale,
-           two-channel grayscale + alpha. Probably, there's no way to know, but
-           given we're using them for *colors*, it makes more sense than
-           displaying them just red or red+green. */
-        Containers::Array<char> usedImageStorage;
-        ImageView2D usedImage = image;
-        const UnsignedInt channelCount = pixelFormatChannelCount(image.format());
-        if(channelCount == 1 || channelCount == 2) {
-            #ifndef MAGNUM_TARGET_WEBGL
-            #ifndef MAGNUM_TARGET_GLES
-            /* Available in GLES 3 always */
-            if(GL::Context::current().isExtensionSupported<GL::Extensions::ARB::texture_swizzle>())
-            #endif
-            {
-                if(channelCount == 1)
-                    texture.setSwizzle<'r', 'r', 'r', '1'>();
-                else if(channelCount == 2)
-                    texture.setSwizzle<'r', 'r', 'r', 'g'>();
-            }
-            #ifndef MAGNUM_TARGET_GLES
-            else
-            #endif
-            #endif
-            {
-                /* Without texture swizzle support, allocate a copy of the image
-                   and expand the channels manually */
-                /** @todo make this a utility in TextureTools, with the channel
-                    expansion being an optimized routine in Math/PackingBatch.h */
-                const PixelFormat imageFormat = pixelFormat(image.format(), channelCount == 2 ? 4 : 3, isPixelFormatSrgb(image.format()));
-                Debug{} << "Texture swizzle not supported, expanding a" << image.format() << "image to" << imageFormat;
-
-                /* Pad to four-byte rows to not have to use non-optimal
-                   alignment */
-                const std::size_t rowStride = 4*((pixelFormatSize(imageFormat)*image.size().x() + 3)/4);
-                usedImageStorage = Containers::Array<char>{NoInit, std::size_t(rowStride*image.size().y())};
-                const MutableImageView2D usedMutableImage{imageFormat, image.size(), usedImageStorage};
-                usedImage = usedMutableImage;
-
-                /* Create 4D pixel views (rows, pixels, channels, channel
-                   bytes) */
-                const std::size_t channelSize = pixelFormatSize(pixelFormatChannelFormat(imageFormat));
-                const std::size_t dstChannelCount = pixelFormatChannelCount(imageFormat);
-                const Containers::StridedArrayView4D<const char> src = image.pixels().expanded<2>(Containers::Size2D{channelCount, channelSize});
-                const Containers::StridedArrayView4D<char> dst = usedMutableImage.pixels().expanded<2>(Containers::Size2D{dstChannelCount, channelSize});
-
-                /* Broadcast the red channel of the input to RRR and copy to
-                   the RGB channels of the output */
-                Utility::copy(
-                    src.exceptSuffix({0, 0, channelCount == 2 ? 1 : 0, 0}).broadcasted<2>(3),
-                    dst.exceptSuffix({0, 0, channelCount == 2 ? 1 : 0, 0}));
-                /* If there's an alpha channel, copy it over as well */
-                if(channelCount == 2) Utility::copy(
-                    src.exceptPrefix({0, 0, 1, 0}),
-                    dst.exceptPrefix({0, 0, 3, 0}));
-            }
-        }
+bool hasTextureSwizzle() {
+    #ifdef MAGNUM_TARGET_WEBGL
+    return false;
+    #elif !defined(MAGNUM_TARGET_GLES)
+    return GL::Context::current().isExtensionSupported<GL::Extensions::ARB::texture_swizzle>();
+    #else
+    /* Available in GLES 3 always */
+    return true;
+    #endif
+}
 
-        /* Whitelist only things we *can* display */
-        /** @todo signed formats, exposure knob for float formats */
-        GL::TextureFormat format;
-        switch(usedImage.format()) {
-            case PixelFormat::R8Unorm:
-            case PixelFormat::RG8Unorm:
-            /* can't really do sRGB R/RG as there are no widely available
-               desktop extensions :( */
-            case PixelFormat::RGB8Unorm:
-            case PixelFormat::RGB8Srgb:
-            case PixelFormat::RGBA8Unorm:
-            case PixelFormat::RGBA8Srgb:
-            /* I guess we can try using 16-bit formats even though our displays
-               won't be able to show all the detail */
-            case PixelFormat::R16Unorm:
-            case PixelFormat::RG16Unorm:
-            case PixelFormat::RGB16Unorm:
-            case PixelFormat::RGBA16Unorm:
-            /* Floating point is fine too */
-            case PixelFormat::R16F:
-            case PixelFormat::RG16F:
-            case PixelFormat::RGB16F:
-            case PixelFormat::RGBA16F:
-            case PixelFormat::R32F:
-            case PixelFormat::RG32F:
-            case PixelFormat::RGB32F:
-            case PixelFormat::RGBA32F:
-                format = GL::textureFormat(usedImage.format());
-                break;
-            default:
-                Warning{} << "Cannot load an image of format" << usedImage.format();
-                return;
+bool loadImage(GL::Texture2D& texture, const ImageView2D& image, const bool expandChannels, const bool deferMipmaps) {
+    /* Single-channel images are probably meant to represent grayscale,
+       two-channel grayscale + alpha. Probably, there's no way to know, but
+       given we're using them for *colors*, it makes more sense than
+       displaying them just red or red+green. */
+    Containers::Array<char> usedImageStorage;
+    ImageView2D usedImage = image;
+    const UnsignedInt channelCount = pixelFormatChannelCount(image.format());
+    if(channelCount == 1 || channelCount == 2) {
+        #ifndef MAGNUM_TARGET_WEBGL
+        if(hasTextureSwizzle()) {
+            if(channelCount == 1)
+                texture.setSwizzle<'r', 'r', 'r', '1'>();
+            else if(channelCount == 2)
+                texture.setSwizzle<'r', 'r', 'r', 'g'>();
+        } else
+        #endif
+        /* Without texture swizzle support, allocate a copy of the image and
+           expand the channels manually, unless the caller swizzles the
+           channels in a shader */
+        if(expandChannels) {
+            /** @todo make this a utility in TextureTools, with the channel
+                expansion being an optimized routine in Math/PackingBatch.h */
+            const PixelFormat imageFormat = pixelFormat(image.format(), channelCount == 2 ? 4 : 3, isPixelFormatSrgb(image.format()));
+            Debug{} << "Texture swizzle not supported, expanding a" << image.format() << "image to" << imageFormat;
+
+            /* Pad to four-byte rows to not have to use non-optimal
+               alignment */
+            const std::size_t rowStride = 4*((pixelFormatSize(imageFormat)*image.size().x() + 3)/4);
+            usedImageStorage = Containers::Array<char>{NoInit, std::size_t(rowStride*image.size().y())};
+            const MutableImageView2D usedMutableImage{imageFormat, image.size(), usedImageStorage};
+            usedImage = usedMutableImage;
+
+            /* Create 4D pixel views (rows, pixels, channels, channel
+               bytes) */
+            const std::size_t channelSize = pixelFormatSize(pixelFormatChannelFormat(imageFormat));
+            const std::size_t dstChannelCount = pixelFormatChannelCount(imageFormat);
+            const Containers::StridedArrayView4D<const char> src = image.pixels().expanded<2>(Containers::Size2D{channelCount, channelSize});
+            const Containers::StridedArrayView4D<char> dst = usedMutableImage.pixels().expanded<2>(Containers::Size2D{dstChannelCount, channelSize});
+
+            /* Broadcast the red channel of the input to RRR and copy to
+               the RGB channels of the output */
+            Utility::copy(
+                src.exceptSuffix({0, 0, channelCount == 2 ? 1 : 0, 0}).broadcasted<2>(3),
+                dst.exceptSuffix({0, 0, channelCount == 2 ? 1 : 0, 0}));
+            /* If there's an alpha channel, copy it over as well */
+            if(channelCount == 2) Utility::copy(
+                src.exceptPrefix({0, 0, 1, 0}),
+                dst.exceptPrefix({0, 0, 3, 0}));
         }
+    }
+
+    /* Whitelist only things we *can* display */
+    /** @todo signed formats, exposure knob for float formats */
+    GL::TextureFormat format;
+    switch(usedImage.format()) {
+        case PixelFormat::R8Unorm:
+        case PixelFormat::RG8Unorm:
+        /* can't really do sRGB R/RG as there are no widely available
+           desktop extensions :( */
+        case PixelFormat::RGB8Unorm:
+        case PixelFormat::RGB8Srgb:
+        case PixelFormat::RGBA8Unorm:
+        case PixelFormat::RGBA8Srgb:
+        /* I guess we can try using 16-bit formats even though our displays
+           won't be able to show all the detail */
+        case PixelFormat::R16Unorm:
+        case PixelFormat::RG16Unorm:
+        case PixelFormat::RGB16Unorm:
+        case PixelFormat::RGBA16Unorm:
+        /* Floating point is fine too */
+        case PixelFormat::R16F:
+        case PixelFormat::RG16F:
+        case PixelFormat::RGB16F:
+        case PixelFormat::RGBA16F:
+        case PixelFormat::R32F:
+        case PixelFormat::RG32F:
+        case PixelFormat::RGB32F:
+        case PixelFormat::RGBA32F:
+            format = GL::textureFormat(usedImage.format());
+            break;
+        default:
+            Warning{} << "Cannot load an image of format" << usedImage.format();
+            return false;
+    }
+
+    texture.setStorage(Math::log2(usedImage.size().max()) + 1, format, usedImage.size());
+
+    /* On desktop, copy the data to a pixel buffer first. The copy is just a
+       memcpy() into driver memory, and the transfer to the texture itself
+       then doesn't stall on the data being read from client memory. */
+    #ifndef MAGNUM_TARGET_GLES
+    {
+        GL::BufferImage2D buffer{usedImage.storage(), usedImage.format(), usedImage.size(), usedImage.data(), GL::BufferUsage::StreamDraw};
+        texture.setSubImage(0, {}, buffer);
+    }
+    #else
+    texture.setSubImage(0, {}, usedImage);
+    #endif
+
+    /* Limiting the sampled levels isn't possible on ES2, generate the mips
+       directly there */
+    #ifndef MAGNUM_TARGET_GLES2
+    if(deferMipmaps) {
+        texture.setMaxLevel(0);
+        return true;
+    }
+    #else
+    static_cast<void>(deferMipmaps);
+    #endif
+
+    texture.generateMipmap();
+    return false;
+}
+
+void generateDeferredMipmap(GL::Texture2D& texture) {
+    #ifndef MAGNUM_TARGET_GLES2
+    /* 1000 is the GL default */
+    texture.setMaxLevel(1000);
+    #endif
+    texture.generateMipmap();
+}
 
-        texture
-            .setStorage(Math::log2(usedImage.size().max()) + 1, format, usedImage.size())
-            .setSubImage(0, {}, usedImage)
-            .generateMipmap();
+bool loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image, const bool expandChannels, const bool deferMipmaps) {
+    return loadImage(texture, Containers::arrayView(&image, 1), expandChannels, deferMipmaps);
+}
+
+bool loadImage(GL::Texture2D& texture, const Containers::ArrayView<const Trade::ImageData2D> levels, const bool expandChannels, const bool deferMipmaps) {
+    CORRADE_INTERNAL_ASSERT(!levels.isEmpty());
+    const Trade::ImageData2D& image = levels.front();
+
+    /* For uncompressed images the levels get generated on the GPU */
+    /** @todo upload the levels if there's more than one */
+    if(!image.isCompressed()) {
+        return loadImage(texture, ImageView2D{image}, expandChannels, deferMipmaps);
 
     } else {
         /* Blacklist things we *cannot* display */
@@ -163,16 +216,17 @@ void loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image) {
             case CompressedPixelFormat::Astc12x10RGBAF:
             case CompressedPixelFormat::Astc12x12RGBAF:
                 Warning{} << "Cannot load an image of format" << image.compressedFormat();
-                return;
+                return false;
 
             default: format = GL::textureFormat(image.compressedFormat());
         }
 
-        texture
-            .setStorage(1, format, image.size())
-            .setCompressedSubImage(0, {}, image);
-            /** @todo mip level loading */
+        texture.setStorage(Int(levels.size()), format, image.size());
+        for(std::size_t i = 0; i != levels.size(); ++i)
+            texture.setCompressedSubImage(Int(i), {}, levels[i]);
     }
+
+    return false;
 }
 
 }}
@@ -26,12 +26,34 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/Containers/Containers.h>
 #include <Magnum/GL/GL.h>
 #include <Magnum/Trade/Trade.h>
 
 namespace Magnum { namespace Player {
 
-void loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image);
+/* If deferMipmaps is true and it's possible on given GL version, the
+   generated mip levels of uncompressed images are left undefined, only the
+   base level is sampled from and true is returned. The caller is then
+   expected to call generateDeferredMipmap() at some point later. */
+bool loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image, bool expandChannels = true, bool deferMipmaps = false);
+
+/* Compressed levels are uploaded as-is, for uncompressed levels only the
+   first is used and the rest is generated */
+bool loadImage(GL::Texture2D& texture, Containers::ArrayView<const Trade::ImageData2D> levels, bool expandChannels = true, bool deferMipmaps = false);
+
+/* Used directly for uploading parts of large images. If expandChannels is
+   false and hasTextureSwizzle() is false, one- and two-channel images are
+   uploaded as-is and the caller is expected to swizzle them in a shader. */
+bool loadImage(GL::Texture2D& texture, const ImageView2D& image, bool expandChannels = true, bool deferMipmaps = false);
+
+/* Generates mip levels left out by loadImage() with deferMipmaps and makes
+   them used for sampling */
+void generateDeferredMipmap(GL::Texture2D& texture);
+
+/* Whether one- and two-channel images get swizzled to grayscale through
+   texture state */
+bool hasTextureSwizzle();
 
 }}
 
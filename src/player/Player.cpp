@@ -24,6 +24,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <chrono>
 #include <unordered_map>
 #include <Corrade/Containers/Function.h>
 #include <Corrade/Containers/Optional.h>
@@ -41,12 +42,23 @@
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Sampler.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Time.h>
+#include <Magnum/MeshTools/Compile.h>
 #include <Magnum/Platform/Screen.h>
 #include <Magnum/Platform/ScreenedApplication.h>
+#include <Magnum/Primitives/Square.h>
+#include <Magnum/Shaders/FlatGL.h>
 #include <Magnum/Text/AbstractFont.h> /** @todo remove once extra glyph cache fill is done better */
 #include <Magnum/Text/AbstractGlyphCache.h> /** @todo remove once extra glyph cache fill is done better */
 #include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/MeshData.h>
 
 #include "Magnum/Ui/Anchor.h"
 #include "Magnum/Ui/Application.h"
@@ -113,9 +125,22 @@ struct Overlay: public Platform::Screen {
         void pointerReleaseEvent(PointerEvent& event) override;
         void pointerMoveEvent(PointerMoveEvent& event) override;
 
+        void setupCache(const Vector2i& framebufferSize);
+
         #ifdef CORRADE_TARGET_EMSCRIPTEN
         bool _isFullsize = false;
         #endif
+
+        /* The UI is rendered into a texture only if its state says something
+           changed, otherwise just the texture is drawn over the scene. The
+           controls and labels change rarely, so this keeps the UI out of the
+           steady-state frame cost. */
+        GL::Texture2D _cacheTexture{NoCreate};
+        GL::Framebuffer _cacheFramebuffer{NoCreate};
+        GL::Mesh _cacheQuad;
+        Shaders::FlatGL2D _cacheShader{Shaders::FlatGL2D::Configuration{}
+            .setFlags(Shaders::FlatGL2D::Flag::Textured)};
+        bool _cacheDirty = true;
 };
 
 }
@@ -136,6 +161,10 @@ class Player: public Platform::ScreenedApplication {
         #endif
 
     private:
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        bool openFile(Trade::AbstractImporter& importer);
+        #endif
+
         void globalViewportEvent(ViewportEvent& size) override;
         void globalDrawEvent() override;
         #if !defined(CORRADE_TARGET_EMSCRIPTEN) && defined(CORRADE_IS_DEBUG_BUILD)
@@ -153,9 +182,15 @@ class Player: public Platform::ScreenedApplication {
         #endif
 
         #ifndef CORRADE_TARGET_EMSCRIPTEN
-        Containers::String _importer, _file;
+        Containers::String _importer, _file, _textureCacheDirectory;
+        bool _optimizeMeshes{};
+        Float _animationBakeRate{};
         #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        bool _map{};
         Containers::Array<const char, Utility::Path::MapDeleter> mapped;
+        /* Files referenced from the top-level file, such as glTF buffers or
+           images, mapped on request from the importer file callback */
+        std::unordered_map<Containers::String, Containers::Array<const char, Utility::Path::MapDeleter>> _mappedFiles;
         #endif
         Int _id{-1};
         #endif
@@ -207,6 +242,9 @@ Overlay::Overlay(Platform::ScreenedApplication& application):
 
     CORRADE_INTERNAL_ASSERT(ui.textLayer().shared().font(Ui::fontHandle(1, 1)).fillGlyphCache(ui.textLayer().shared().glyphCache(), "«»"));
 
+    _cacheQuad = MeshTools::compile(Primitives::squareSolid(Primitives::SquareFlag::TextureCoordinates));
+    setupCache(application.framebufferSize());
+
     #ifdef CORRADE_TARGET_EMSCRIPTEN
     fullSize = Ui::Button{
         Ui::snap(ui, Ui::Snap::Bottom, hideControls, ButtonSize),
@@ -277,19 +315,65 @@ void Overlay::drawEvent() {
     GL::defaultFramebuffer.bind();
     #endif
 
-    /* Draw the UI. Disable the depth buffer and enable premultiplied alpha
-       blending. */
+    /* Advance UI animations, such as style transitions. A redraw is scheduled
+       below only while there are any running, so an idle player doesn't
+       redraw at all. */
+    if(ui.state() & Ui::UserInterfaceState::NeedsAnimationAdvance)
+        ui.advanceAnimations(Nanoseconds{std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()});
+
+    /* Disable the depth buffer and enable premultiplied alpha blending for
+       both drawing the UI and compositing it */
     GL::Renderer::disable(GL::Renderer::Feature::DepthTest);
     GL::Renderer::enable(GL::Renderer::Feature::Blending);
     GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
-    ui.draw();
+
+    /* Redraw the cached UI if anything in it changed. With the cache cleared
+       to transparent black the blending results in premultiplied alpha as
+       well, so it can be composited with the same blend function. */
+    if(ui.state() || _cacheDirty) {
+        _cacheFramebuffer
+            .clearColor(0, Color4{0.0f})
+            .bind();
+        ui.draw();
+        GL::defaultFramebuffer.bind();
+        _cacheDirty = false;
+    }
+
+    _cacheShader
+        .bindTexture(_cacheTexture)
+        .draw(_cacheQuad);
+
     GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::Zero);
     GL::Renderer::disable(GL::Renderer::Feature::Blending);
     GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+
+    if(ui.state() & Ui::UserInterfaceState::NeedsAnimationAdvance)
+        redraw();
 }
 
 void Overlay::viewportEvent(ViewportEvent& event) {
     ui.setSize(Vector2(event.windowSize())/event.dpiScaling(), Vector2{event.windowSize()}, event.framebufferSize());
+    setupCache(event.framebufferSize());
+}
+
+void Overlay::setupCache(const Vector2i& framebufferSize) {
+    /* The storage is immutable, so the texture has to be recreated on every
+       resize */
+    _cacheTexture = GL::Texture2D{};
+    _cacheTexture
+        .setMinificationFilter(GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(GL::SamplerFilter::Nearest)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1,
+            #ifndef MAGNUM_TARGET_GLES2
+            GL::TextureFormat::RGBA8,
+            #else
+            GL::TextureFormat::RGBA,
+            #endif
+            framebufferSize);
+    _cacheFramebuffer = GL::Framebuffer{{{}, framebufferSize}};
+    _cacheFramebuffer.attachTexture(GL::Framebuffer::ColorAttachment{0}, _cacheTexture, 0);
+    _cacheDirty = true;
 }
 
 void Overlay::keyPressEvent(KeyEvent& event) {
@@ -344,9 +428,15 @@ Player::Player(const Arguments& arguments): Platform::ScreenedApplication{argume
         .addOption('I', "importer", "AnySceneImporter").setHelp("importer", "importer plugin to use")
         .addOption('i', "importer-options").setHelp("importer-options", "configuration options to pass to the importer", "key=val,key2=val2,…")
         #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
-        .addBooleanOption("map").setHelp("map", "memory-map the input for zero-copy import (works only for standalone files)")
+        .addBooleanOption("map").setHelp("map", "memory-map the input and all files it references for zero-copy import")
+        .addOption("texture-cache").setHelp("texture-cache", "directory to cache GPU-compressed textures in", "DIR")
         #endif
-        .addOption("id").setHelp("id", "image or scene ID to import");
+        .addOption("id").setHelp("id", "image or scene ID to import")
+        .addBooleanOption("optimize-meshes").setHelp("optimize-meshes", "pack vertex formats and optimize meshes for vertex cache on load")
+        .addOption("bake-animations", "0").setHelp("bake-animations", "resample animations at given rate on load for faster playback, 0 to play them directly", "FPS")
+        .addOption("benchmark").setHelp("benchmark", "render given count of frames offscreen, print timing statistics and exit", "N")
+        .addOption("benchmark-size", "1280 720").setHelp("benchmark-size", "framebuffer size to benchmark with", "\"X Y\"")
+        .addBooleanOption("benchmark-orbit").setHelp("benchmark-orbit", "orbit the camera around the scene while benchmarking");
     #endif
     args.addBooleanOption("no-merge-animations").setHelp("no-merge-animations", "don't merge glTF animations into a single clip")
         .addOption("msaa").setHelp("msaa", "MSAA level to use (if not set, defaults to 8x or 2x for HiDPI)", "N")
@@ -365,7 +455,12 @@ subgroups using a slash.
 
 The --profile option accepts a space-separated list of measured values.
 Available values are FrameTime, CpuDuration, GpuDuration, VertexFetchRatio and
-PrimitiveClipRatio.)")
+PrimitiveClipRatio.
+
+The --benchmark option renders the given count of frames into a hidden window
+with a fixed size, and then prints a single line of JSON with load phase
+durations and mean, 95th and 99th percentile and maximum of the values
+selected with --profile.)")
         .parse(arguments.argc, arguments.argv);
 
     /* Try 8x MSAA, fall back to zero samples if not possible. Enable only 2x
@@ -376,6 +471,13 @@ PrimitiveClipRatio.)")
         conf.setTitle("Magnum Player")
             .setWindowFlags(Configuration::WindowFlag::Resizable)
             .setSize(conf.size());
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        /* For a benchmark the window is hidden and with a fixed size,
+           independent of DPI scaling */
+        if(!args.value("benchmark").empty())
+            conf.setWindowFlags(Configuration::WindowFlag::Hidden)
+                .setSize(args.value<Vector2i>("benchmark-size"), Configuration::DpiScalingPolicy::Physical);
+        #endif
         GLConfiguration glConf;
         glConf.setSampleCount(args.value("msaa").empty() ? dpiScaling.max() < 2.0f ? 8 : 2 : args.value<Int>("msaa"));
         #ifdef MAGNUM_TARGET_WEBGL
@@ -393,7 +495,15 @@ PrimitiveClipRatio.)")
     _profilerValues = args.value<DebugTools::FrameProfilerGL::Values>("profile");
 
     #ifdef CORRADE_IS_DEBUG_BUILD
-    if(args.isSet("tweakable")) _tweakable.enable();
+    if(args.isSet("tweakable")) {
+        _tweakable.enable();
+        /* The tick event is called for checking file changes, which would
+           otherwise make the main loop spin without ever waiting for
+           events */
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        setMinimalLoopPeriod(50.0_msec);
+        #endif
+    }
     #endif
     if(args.isSet("verbose")) _importerFlags |= Trade::ImporterFlag::Verbose;
 
@@ -490,6 +600,8 @@ PrimitiveClipRatio.)")
 
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     _file = args.value("file");
+    _optimizeMeshes = args.isSet("optimize-meshes");
+    _animationBakeRate = args.value<Float>("bake-animations");
 
     /* Scene / image ID to load. If not specified, -1 is used. */
     if(!args.value("id").empty()) _id = args.value<Int>("id");
@@ -542,29 +654,31 @@ PrimitiveClipRatio.)")
     /* Load file. If fails and this was not a custom importer, try loading it
        as an image instead */
     /** @todo redo once canOpen*() is implemented */
-    bool success;
-    if(args.isSet("map")) {
-        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> maybeMapped;
-        success = importer && (maybeMapped = Utility::Path::mapRead(args.value("file"))) && importer->openMemory(*maybeMapped);
-        mapped = *Utility::move(maybeMapped);
-    } else {
-        success = importer && importer->openFile(_file);
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    _map = args.isSet("map");
+    if(!args.value<Containers::StringView>("texture-cache").isEmpty()) {
+        _textureCacheDirectory = args.value<Containers::StringView>("texture-cache");
+        if(!Utility::Path::make(_textureCacheDirectory)) {
+            Warning{} << "Cannot create texture cache directory" << _textureCacheDirectory << Debug::nospace << ", compressed texture caching will be unavailable";
+            _textureCacheDirectory = {};
+        }
     }
-    if(success) {
+    #endif
+    if(importer && openFile(*importer)) {
         /* If we passed a custom importer, try to figure out if it's an image
            or a scene */
         /** @todo ugh the importer should have an API for that */
         if(args.value("importer") != "AnySceneImporter" && !importer->objectCount() && !importer->meshCount() && importer->image2DCount() >= 1)
             _player = createImagePlayer(*this, _overlay->ui, _overlay->controls);
         else
-            _player = createScenePlayer(*this, _overlay->ui, _overlay->controls, _profilerValues);
+            _player = createScenePlayer(*this, _overlay->ui, _overlay->controls, _profilerValues, _manager, _textureCacheDirectory, _optimizeMeshes, _animationBakeRate);
         _player->load(_file, *importer, _id);
         _importer = args.value("importer");
     } else if(args.value("importer") == "AnySceneImporter") {
         Debug{} << "Opening as a scene failed, trying as an image...";
         Containers::Pointer<Trade::AbstractImporter> imageImporter = _manager.loadAndInstantiate("AnyImageImporter");
         if(imageImporter) imageImporter->addFlags(_importerFlags);
-        if(imageImporter && imageImporter->openFile(_file)) {
+        if(imageImporter && openFile(*imageImporter)) {
             if(!imageImporter->image2DCount()) {
                 Error{} << "No 2D images found in the file";
                 std::exit(3);
@@ -580,24 +694,77 @@ PrimitiveClipRatio.)")
     importer->addFlags(_importerFlags);
     Utility::Resource rs{"data"};
     importer->openData(rs.getRaw("artwork/default.glb"));
-    _player = createScenePlayer(*this, _overlay->ui, _overlay->controls, _profilerValues);
+    _player = createScenePlayer(*this, _overlay->ui, _overlay->controls, _profilerValues, _manager, {}, false, 0.0f);
     _player->load({}, *importer, -1);
     #endif
 
     #ifndef CORRADE_TARGET_EMSCRIPTEN
-    setSwapInterval(1);
+    /* Don't limit the framerate by VSync when benchmarking */
+    if(!args.value("benchmark").empty()) {
+        setSwapInterval(0);
+        if(!_player->benchmark(args.value<UnsignedInt>("benchmark"), args.isSet("benchmark-orbit"))) {
+            Error{} << "Only scenes can be benchmarked";
+            std::exit(4);
+        }
+    } else setSwapInterval(1);
     #endif
 
     #ifdef CORRADE_TARGET_EMSCRIPTEN
     app = this;
+
+    /* Let the page know loadFile() can be called now, for example to fetch
+       a file passed in the URL */
+    EM_ASM({
+        if(Module['playerReady']) Module['playerReady']();
+    });
     #endif
 }
 
 #ifndef CORRADE_TARGET_EMSCRIPTEN
+bool Player::openFile(Trade::AbstractImporter& importer) {
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    if(_map) {
+        /* Map also all files referenced from the top-level file. Files
+           loaded temporarily are unmapped once the importer is done with
+           them, the rest when the importer gets closed. */
+        importer.setFileCallback([](const std::string& filename,
+            InputFileCallbackPolicy policy, std::unordered_map<Containers::String, Containers::Array<const char, Utility::Path::MapDeleter>>& files)
+                -> Containers::Optional<Containers::ArrayView<const char>>
+            {
+                if(policy == InputFileCallbackPolicy::Close) {
+                    files.erase(filename);
+                    return {};
+                }
+
+                auto found = files.find(filename);
+                if(found == files.end()) {
+                    Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> file = Utility::Path::mapRead(filename);
+                    if(!file) return {};
+                    found = files.emplace(filename, *Utility::move(file)).first;
+                }
+                return Containers::ArrayView<const char>{found->second};
+            }, _mappedFiles);
+
+        /* The top-level file is opened as memory that's guaranteed to stay in
+           scope, so the importer doesn't need to make a copy */
+        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> maybeMapped = Utility::Path::mapRead(_file);
+        if(!maybeMapped || !importer.openMemory(*maybeMapped))
+            return false;
+        mapped = *Utility::move(maybeMapped);
+        return true;
+    }
+    #endif
+
+    return importer.openFile(_file);
+}
+
 void Player::reload() {
     Containers::Pointer<Trade::AbstractImporter> importer =
         _manager.loadAndInstantiate(_importer);
-    if(importer && importer->openFile(_file))
+    if(!importer) return;
+
+    importer->addFlags(_importerFlags);
+    if(openFile(*importer))
         _player->load(_file, *importer, _id);
 }
 #endif
@@ -673,7 +840,7 @@ void Player::loadFile(std::size_t totalCount, const char* filename, Containers::
             return;
         }
 
-        _player = createScenePlayer(*this, _overlay->ui, _overlay->controls, _profilerValues);
+        _player = createScenePlayer(*this, _overlay->ui, _overlay->controls, _profilerValues, _manager, {}, false, 0.0f);
         _player->load(topLevelFile, *importer, -1);
 
     /* If there's just one non-recognized file, try to load it as an image instead */
@@ -24,21 +24,32 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-#include <algorithm> /* std::sort() */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <queue>
 #include <unordered_map>
+#include <unordered_set>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/BitArray.h>
 #include <Corrade/Containers/Function.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/Reference.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Containers/Triple.h>
 #include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Arguments.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Move.h>
+#include <Corrade/Utility/MurmurHash2.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
@@ -47,11 +58,19 @@
 #include <Magnum/Animation/Player.h>
 #include <Magnum/DebugTools/ColorMap.h>
 #include <Magnum/DebugTools/FrameProfiler.h>
+#include <Magnum/GL/Buffer.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/BufferImage.h>
+#endif
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/MeshView.h>
+#ifndef MAGNUM_TARGET_GLES
+#include <Magnum/GL/OpenGL.h>
+#endif
 #include <Magnum/GL/PixelFormat.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
@@ -59,10 +78,16 @@
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Math/CubicHermite.h>
+#include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Math/Intersection.h>
+#include <Magnum/Math/PackingBatch.h>
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/MeshTools/Compile.h>
+#include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/GenerateIndices.h>
+#include <Magnum/MeshTools/GenerateNormals.h>
+#include <Magnum/MeshTools/Interleave.h>
 #include <Magnum/MeshTools/Transform.h>
 #include <Magnum/Primitives/Axis.h>
 #include <Magnum/Primitives/Crosshair.h>
@@ -78,7 +103,9 @@
 #include <Magnum/Shaders/PhongGL.h>
 #include <Magnum/Shaders/MeshVisualizerGL.h>
 #include <Magnum/Text/Alignment.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
 #include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/CameraData.h>
 #include <Magnum/Trade/ImageData.h>
@@ -100,6 +127,8 @@
 
 #ifdef CORRADE_TARGET_EMSCRIPTEN
 #include <emscripten/emscripten.h>
+#else
+#include <thread>
 #endif
 
 #ifdef MAGNUM_TARGET_WEBGL
@@ -169,6 +198,21 @@ constexpr const Vector2 ControlSize{56.0f, WidgetHeight};
 constexpr const Vector2 HalfControlSize{28.0f, WidgetHeight};
 constexpr const Vector2 LabelSize{72.0f, LabelHeight};
 
+/* A node of a point cloud octree. Points of each node are stored in a
+   contiguous range of the vertex buffer, and a node contains a subsample of
+   the points in its cell that aren't stored in any of its parents. Thus, to
+   draw a point cloud at a certain detail, all nodes on the path from the root
+   to the most detailed selected nodes get drawn. */
+struct PointCloudNode {
+    Range3D bounds;
+    UnsignedInt offset, count;
+    /* Approximate distance between points of the node, used to calculate
+       the screen-space error of stopping the refinement at this node */
+    Float spacing;
+    /* Child indices, ~UnsignedInt{} if given child is empty */
+    UnsignedInt children[8];
+};
+
 struct MeshInfo {
     Containers::Optional<GL::Mesh> mesh;
     UnsignedInt attributes;
@@ -178,7 +222,26 @@ struct MeshInfo {
     UnsignedInt perVertexJointCount, secondaryPerVertexJointCount;
     std::size_t size;
     Containers::String name;
-    bool hasTangents, hasSeparateBitangents;
+    /* Bounding box of vertex positions, used for frustum culling. Empty if
+       the mesh has no positions or no vertices. */
+    Containers::Optional<Range3D> bounds;
+    /* Additional, progressively coarser mesh levels used for distant
+       drawables. Empty if the mesh has just one level. */
+    Containers::Array<GL::Mesh> levels;
+    /* Octree for large point meshes, with the vertices reordered to match
+       it. Empty if the mesh isn't a point cloud. */
+    Containers::Array<PointCloudNode> pointCloud;
+    #if defined(MAGNUM_TARGET_WEBGL) || defined(MAGNUM_TARGET_GLES2)
+    /* Wireframe visualization without a geometry shader needs a non-indexed
+       mesh. Non-skinned indexed triangle meshes keep just their indices,
+       positions and object IDs around, the mesh is then compiled from those
+       once the object is selected and reused for subsequent selections. */
+    Containers::Array<UnsignedInt> wireframeIndices;
+    Containers::Array<Vector3> wireframePositions;
+    Containers::Array<UnsignedInt> wireframeObjectIds;
+    Containers::Optional<GL::Mesh> wireframeMesh;
+    #endif
+    bool hasTangents, hasSeparateBitangents, hasObjectIds;
 };
 
 struct LightInfo {
@@ -197,42 +260,175 @@ struct ObjectInfo {
     Containers::ArrayView<const Matrix4> skinJointMatrices;
 };
 
+/* Animation tracks write into these instead of updating the objects
+   directly, the values are then applied to all objects in a single pass
+   after the animation player is advanced */
+struct AnimatedObjectInfo {
+    Object3D* object;
+    Vector3 translation;
+    Quaternion rotation;
+    Vector3 scaling;
+};
+
+/* Animation resampled to a fixed rate at load, if requested. The values are
+   stored frame after frame, each frame having a value for every animated
+   object, so playback is just an interpolation between two contiguous rows
+   without any keyframe search. Objects that don't have a track for given
+   property have their original value repeated in every frame. */
+struct BakedAnimation {
+    Float begin, rate;
+    UnsignedInt frameCount;
+    Containers::Array<Vector3> translations;
+    Containers::Array<Quaternion> rotations;
+    Containers::Array<Vector3> scalings;
+    /* Keys for a track that drives the playback, with the time itself being
+       passed to the callback */
+    std::pair<Float, Float> time[2];
+};
+
 class MeshVisualizerDrawable;
 
+/* Objects that share the same non-skinned opaque mesh and material are drawn
+   with a single instanced draw call. Their drawables only record their
+   transformation into the group during SceneGraph::Camera::draw() and the
+   group then uploads and draws everything at once. */
+struct PhongInstance {
+    Matrix4 transformationMatrix;
+    Matrix3x3 normalMatrix;
+    UnsignedInt objectId;
+};
+
+/* Drawables of a group with their camera-relative transformations, drawn
+   with SceneGraph::Camera::draw() from the flat list instead of traversing
+   the object hierarchy every frame. Absolute transformations of objects that
+   aren't affected by any animation are baked at load time, only the
+   animated ones get calculated from the hierarchy. */
+struct FlatDrawableList {
+    std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>> drawableTransformations;
+    Containers::Array<Matrix4> absoluteTransformations;
+    Containers::BitArray animated;
+};
+
+class PhongInstanceGroup {
+    public:
+        explicit PhongInstanceGroup(Shaders::PhongGL& shader, GL::Mesh& mesh, const Color4& color, GL::Texture2D* diffuseTexture, GL::Texture2D* normalTexture, Float normalTextureScale, Float alphaMask, const Matrix3& textureMatrix, const bool& shadeless);
+
+        void add(const Matrix4& transformationMatrix, UnsignedInt objectId) {
+            arrayAppend(_instances, InPlaceInit, transformationMatrix, transformationMatrix.normalMatrix(), objectId);
+        }
+
+        /* Draws all instances added since the last call and clears them */
+        void draw(SceneGraph::Camera3D& camera);
+
+    private:
+        Shaders::PhongGL& _shader;
+        GL::Mesh& _mesh;
+        GL::Buffer _instanceBuffer;
+        Containers::Array<PhongInstance> _instances;
+        Color4 _color;
+        GL::Texture2D* _diffuseTexture;
+        GL::Texture2D* _normalTexture;
+        Float _normalTextureScale;
+        Float _alphaMask;
+        Matrix3 _textureMatrix;
+        const bool& _shadeless;
+};
+
 struct Data {
     Containers::Array<MeshInfo> meshes;
     Containers::Array<LightInfo> lights;
     Containers::Array<Containers::Optional<GL::Texture2D>> textures;
+    /* Textures with mip generation deferred by loadImage(), together with
+       the size of their base level. Generated in drawEvent() within
+       TextureMipmapBudget. */
+    Containers::Array<Containers::Pair<UnsignedInt, std::size_t>> texturesPendingMipmaps;
+    /* Referencing meshes and textures and referenced from drawables in the
+       scene, so has to be destroyed after the scene but before the others */
+    Containers::Array<Containers::Pointer<PhongInstanceGroup>> phongInstanceGroups;
 
     Scene3D scene;
     Object3D* cameraObject{};
     SceneGraph::Camera3D* camera;
-    /* Untransformed camera placed at scene root, for calculating absolute
-       joint transformations via JointDrawable */
-    Object3D* rootCameraObject{};
-    SceneGraph::Camera3D* rootCamera;
+    /* Opaque drawables are split by the shader they use, in order to draw
+       everything that uses the same shader together and minimize state
+       changes. The opaqueDrawables group contains just the instanced
+       drawables, which only collect their transformations. */
+    Containers::Array<Containers::Pair<UnsignedInt, Containers::Pointer<SceneGraph::DrawableGroup3D>>> opaqueDrawablesByShader;
     SceneGraph::DrawableGroup3D opaqueDrawables, transparentDrawables,
-        selectedObjectDrawables, objectVisualizationDrawables, lightDrawables,
-        jointDrawables;
+        selectedObjectDrawables, objectVisualizationDrawables, lightDrawables;
+    /* Flat lists for the opaqueDrawablesByShader groups, in the same order,
+       and for the opaqueDrawables group. Populated at the end of load(). */
+    Containers::Array<FlatDrawableList> opaqueFlatDrawablesByShader;
+    FlatDrawableList opaqueFlatDrawables;
+    /* Transparent drawables with their camera-relative transformations,
+       kept across frames and sorted incrementally, as the order usually
+       changes only a little between frames */
+    std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>> transparentDrawableTransformations;
     Vector3 previousPosition;
 
     Containers::Array<ObjectInfo> objects;
     bool visualizeObjects = false;
     MeshVisualizerDrawable* selectedObject{};
+    UnsignedInt hoveredObject = 0xffffffffu;
 
     Containers::Array<char> animationData;
+    /* Referenced from the player, so has to be destroyed after it (i.e.,
+       declared before) */
+    Containers::Array<AnimatedObjectInfo> animatedObjects;
+    BakedAnimation bakedAnimation{};
     Animation::Player<std::chrono::nanoseconds, Float> player;
 
     UnsignedInt lightCount{};
     UnsignedInt maxJointCount{};
     Containers::Array<Vector4> lightPositions;
     Containers::Array<Color3> lightColors;
+    /* Light positions last uploaded to the Phong shaders and how many
+       shaders there were at that point. If neither the positions nor the
+       shader count changes, the upload is skipped. */
+    Containers::Array<Vector4> uploadedLightPositions;
+    std::size_t uploadedLightPositionsShaderCount{};
 
     Containers::Array<Matrix4> skinJointMatrices;
+    /* Objects and inverse bind matrices of all skin joints that are part of
+       the hierarchy, together with their index in skinJointMatrices. Kept in
+       a flat layout so the joint matrices can be calculated in a single pass
+       over the hierarchy. */
+    std::vector<std::reference_wrapper<Object3D>> jointObjects;
+    Containers::Array<Matrix4> jointInverseBindMatrices;
+    Containers::Array<UnsignedInt> jointMatrixIds;
 
     Int elapsedTimeAnimationDestination = -1; /* So it gets updated with 0 as well */
 };
 
+/* CPU stages of ScenePlayer::drawEvent() that are measured separately */
+enum class ProfiledStage: UnsignedByte {
+    Animation,
+    Lights,
+    Joints,
+    Opaque,
+    Transparent,
+    Visualization,
+    Count
+};
+
+constexpr Containers::StringView ProfiledStageNames[]{
+    "Animation"_s,
+    "Light positions"_s,
+    "Joint matrices"_s,
+    "Opaque pass"_s,
+    "Transparent pass"_s,
+    "Visualization"_s
+};
+
+static_assert(Containers::arraySize(ProfiledStageNames) == UnsignedInt(ProfiledStage::Count), "");
+
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+struct ProfiledStageEvent {
+    ProfiledStage stage;
+    std::chrono::steady_clock::time_point begin, end;
+};
+#endif
+
 enum class Visualization: UnsignedByte {
     Begin = 0,
     Wireframe = 0,
@@ -254,7 +450,7 @@ enum class Visualization: UnsignedByte {
 
 class ScenePlayer: public AbstractPlayer {
     public:
-        explicit ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues);
+        explicit ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues, PluginManager::Manager<Trade::AbstractImporter>& importerManager, Containers::StringView textureCacheDirectory, bool optimizeMeshes, Float animationBakeRate);
 
     private:
         void drawEvent() override;
@@ -266,6 +462,18 @@ class ScenePlayer: public AbstractPlayer {
         void scrollEvent(ScrollEvent& event) override;
 
         void load(Containers::StringView filename, Trade::AbstractImporter& importer, Int id) override;
+        bool benchmark(UnsignedInt frameCount, bool orbit) override;
+        void endLoadPhase(Containers::StringView name, std::chrono::steady_clock::time_point& begin);
+        void advanceBenchmark();
+        void showLoadingProgress(Containers::StringView what, std::size_t done, std::size_t total);
+        void endProfiledStage(ProfiledStage stage, std::chrono::steady_clock::time_point& begin);
+        void printProfilerStatistics();
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        void saveProfilerTrace();
+        #endif
+        #if !defined(CORRADE_TARGET_EMSCRIPTEN) && (defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)))
+        bool loadCachedTexture(GL::Texture2D& texture, const Trade::ImageData2D& image);
+        #endif
 
         Shaders::MeshVisualizerGL3D::Flags setupVisualization(std::size_t meshId);
 
@@ -276,11 +484,27 @@ class ScenePlayer: public AbstractPlayer {
         void updateAnimationTime(Int deciseconds);
         void updateLightColorBrightness();
 
+        SceneGraph::DrawableGroup3D& opaqueDrawablesFor(GL::AbstractShaderProgram& shader);
+        void populateFlatDrawables(const std::unordered_set<const SceneGraph::AbstractObject3D*>& animatedObjects, SceneGraph::DrawableGroup3D& group, FlatDrawableList& list);
+        void drawFlatDrawables(FlatDrawableList& list);
+        void drawOpaque();
+        void drawTransparent();
+
+        Range2Di depthAreaAt(const Vector2& windowPosition);
         Float depthAt(const Vector2& windowPosition);
+        Range2Di drawObjectIdsAt(const Vector2& windowPosition);
+        UnsignedInt objectIdAt(const Vector2& windowPosition);
+        #ifndef MAGNUM_TARGET_GLES
+        void requestSelectionAt(const Vector2& windowPosition);
+        void resolveSelectionProbes();
+        #endif
+        void selectObject(UnsignedInt id);
         Vector3 unproject(const Vector2& windowPosition, Float depth) const;
 
         Shaders::FlatGL3D& flatShader(Shaders::FlatGL3D::Flags flags);
         Shaders::PhongGL& phongShader(Shaders::PhongGL::Flags flags);
+        void setupPhongShader(Shaders::PhongGL& shader);
+        void finishShaderCompilation();
         Shaders::MeshVisualizerGL3D& meshVisualizerShader(Shaders::MeshVisualizerGL3D::Flags flags);
 
         /* Global rendering stuff */
@@ -290,6 +514,12 @@ class ScenePlayer: public AbstractPlayer {
         std::unordered_map<UnsignedInt, Shaders::FlatGL3D> _flatShaders;
         std::unordered_map<UnsignedInt, Shaders::PhongGL> _phongShaders;
         std::unordered_map<UnsignedInt, Shaders::MeshVisualizerGL3D> _meshVisualizerShaders;
+        /* Flat and Phong shaders requested during load() are compiled
+           asynchronously, with placeholder NoCreate instances in the maps
+           above, and are finished all at once in finishShaderCompilation() */
+        bool _compileShadersAsync{};
+        Containers::Array<Containers::Pair<UnsignedInt, Shaders::FlatGL3D::CompileState>> _flatShaderCompileStates;
+        Containers::Array<Containers::Pair<UnsignedInt, Shaders::PhongGL::CompileState>> _phongShaderCompileStates;
         GL::Texture2D _colorMapTexture;
         /* Object and light visualization */
         GL::Mesh _lightCenterMesh, _lightInnerConeMesh, _lightOuterCircleMesh,
@@ -308,6 +538,9 @@ class ScenePlayer: public AbstractPlayer {
         /* UI. What's just a NodeHandle only needs to be hidden / disabled,
            don't need a whole widget for that. */
         Ui::UserInterface& _ui;
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        std::chrono::steady_clock::time_point _loadingProgressTime;
+        #endif
         /* Owning base node for all UI stuff here, child of the `controls` node
            from constructor. Gets removed when the screen is destructed, taking
            with itself everything parented to it, so when another screen is
@@ -316,7 +549,8 @@ class ScenePlayer: public AbstractPlayer {
             shaders etc., rethink the whole thing */
         Ui::Widget _screen;
         Ui::Label _modelInfo,
-            _objectInfo;
+            _objectInfo,
+            _hoveredObjectInfo;
         Ui::Button _toggleShadeless,
             _toggleObjectVisualization,
             _cycleMeshVisualization;
@@ -340,6 +574,41 @@ class ScenePlayer: public AbstractPlayer {
         Float _lastDepth;
         Vector2 _lastPosition{Constants::nan()};
         Vector3 _rotationPoint, _translationPoint;
+        #ifndef MAGNUM_TARGET_GLES
+        /* Depth around the last pointer position, read at the end of every
+           drawEvent() into a ring of buffers. The depthAt() then uses the
+           most recent one that's done instead of stalling the pipeline with
+           a synchronous read. */
+        struct DepthProbe {
+            explicit DepthProbe(): image{GL::PixelFormat::DepthComponent, GL::PixelType::Float} {}
+            DepthProbe(const DepthProbe&) = delete;
+            ~DepthProbe() {
+                if(fence) glDeleteSync(fence);
+            }
+            DepthProbe& operator=(const DepthProbe&) = delete;
+
+            GL::BufferImage2D image;
+            GLsync fence{};
+            Vector2 windowPosition;
+        } _depthProbes[3];
+        UnsignedInt _nextDepthProbe = 0;
+        /* Object ID under the pointer for selection, rendered into the
+           selection framebuffer and read into a ring of buffers as well. The
+           selection is then resolved in drawEvent() once the read is done
+           instead of stalling the pipeline with a synchronous read. */
+        struct SelectionProbe {
+            explicit SelectionProbe(): image{GL::PixelFormat::RedInteger, GL::PixelType::UnsignedInt} {}
+            SelectionProbe(const SelectionProbe&) = delete;
+            ~SelectionProbe() {
+                if(fence) glDeleteSync(fence);
+            }
+            SelectionProbe& operator=(const SelectionProbe&) = delete;
+
+            GL::BufferImage2D image;
+            GLsync fence{};
+        } _selectionProbes[3];
+        UnsignedInt _nextSelectionProbe = 0;
+        #endif
         #ifdef MAGNUM_TARGET_WEBGL
         GL::Framebuffer _depthResolveFramebuffer{NoCreate};
         GL::Texture2D _depthResolve{NoCreate};
@@ -349,15 +618,154 @@ class ScenePlayer: public AbstractPlayer {
         DepthReinterpretShader _reinterpretShader{NoCreate};
         #endif
 
-        /* Profiling */
+        /* Compressed texture cache */
+        PluginManager::Manager<Trade::AbstractImporter>& _importerManager;
+        #if !defined(CORRADE_TARGET_EMSCRIPTEN) && (defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)))
+        Containers::String _textureCacheDirectory;
+        Containers::Optional<PluginManager::Manager<Trade::AbstractImageConverter>> _imageConverterManager;
+        #endif
+
+        /* Vertex format packing and vertex cache optimization at load */
+        bool _optimizeMeshes;
+        Containers::Optional<PluginManager::Manager<Trade::AbstractSceneConverter>> _sceneConverterManager;
+
+        /* Rate at which animations are resampled at load, 0 if they're
+           played from the imported tracks directly */
+        Float _animationBakeRate;
+
+        /* Profiling. The stage profiler contains durations of individual
+           drawEvent() stages, filled by endProfiledStage(). While profiling,
+           the stages are also recorded for a trace that's saved once
+           profiling is disabled again. */
         DebugTools::FrameProfilerGL _profiler;
+        DebugTools::FrameProfiler _stageProfiler;
+        UnsignedLong _stageDurations[UnsignedInt(ProfiledStage::Count)]{};
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        std::chrono::steady_clock::time_point _traceBegin;
+        Containers::Array<ProfiledStageEvent> _traceEvents;
+        #endif
         Debug _profilerOut{Debug::Flag::NoNewlineAtTheEnd|
             (Debug::isTty() ? Debug::Flags{} : Debug::Flag::DisableColors)};
+
+        /* Durations of individual load() phases, reported in the benchmark
+           mode */
+        Containers::Array<Containers::Pair<Containers::StringView, std::chrono::steady_clock::duration>> _loadPhaseDurations;
+
+        /* Benchmark mode. If the frame count is non-zero, the player renders
+           given count of frames, prints the collected statistics and exits. */
+        UnsignedInt _benchmarkFrameCount{};
+        bool _benchmarkOrbit{};
 };
 
+/* Returns false if the bounding box is fully outside of the camera frustum.
+   The frustum is extracted from the projection matrix combined with the
+   object transformation, which puts it directly into the mesh space and so
+   the box doesn't need to be transformed. If there are no bounds, such as for
+   skinned meshes where the vertex positions don't correspond to the final
+   shape, the drawable is never culled. */
+bool isInsideFrustum(const Range3D* const bounds, const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
+    return !bounds || Math::Intersection::rangeFrustum(*bounds, Frustum::fromMatrix(camera.projectionMatrix()*transformationMatrix));
+}
+
+/* Picks a mesh level based on how much of the viewport height the bounding
+   sphere of the mesh covers. The original mesh is used down to
+   MeshLevelCoverage, each next level then once the coverage gets halved
+   again. If there are no bounds or no additional levels, the original mesh
+   is used always. */
+constexpr Float MeshLevelCoverage = 0.25f;
+
+/* Total size of base levels of textures that get their deferred mip levels
+   generated in a single frame */
+constexpr std::size_t TextureMipmapBudget = 16*1024*1024;
+
+GL::Mesh& selectMeshLevel(GL::Mesh& mesh, const Containers::ArrayView<GL::Mesh> levels, const Range3D* const bounds, const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
+    if(!bounds || levels.isEmpty()) return mesh;
+
+    const Float radius = 0.5f*bounds->size().length()*Math::sqrt(transformationMatrix.scalingSquared().max());
+    const Float distance = -transformationMatrix.transformPoint(bounds->center()).z();
+    if(distance <= radius) return mesh;
+
+    const Float coverage = radius*camera.projectionMatrix()[1][1]/distance;
+    GL::Mesh* level = &mesh;
+    Float threshold = MeshLevelCoverage;
+    for(GL::Mesh& next: levels) {
+        if(coverage >= threshold) break;
+        level = &next;
+        threshold *= 0.5f;
+    }
+    return *level;
+}
+
+/* Point cloud nodes are refined until the spacing of their points projected
+   to the screen is below PointCloudMaxScreenSpaceError pixels or until
+   PointCloudPointBudget points is selected, nodes with the largest error
+   first */
+constexpr Float PointCloudMaxScreenSpaceError = 2.0f;
+constexpr UnsignedInt PointCloudPointBudget = 4*1024*1024;
+
+/* Draws either the point cloud nodes selected for the current view, or a mesh
+   level picked with selectMeshLevel() if there's no point cloud */
+void drawMesh(GL::AbstractShaderProgram& shader, GL::Mesh& mesh, const Containers::ArrayView<GL::Mesh> levels, const Containers::ArrayView<const PointCloudNode> pointCloud, const Range3D* const bounds, const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
+    if(pointCloud.isEmpty()) {
+        shader.draw(selectMeshLevel(mesh, levels, bounds, transformationMatrix, camera));
+        return;
+    }
+
+    const Float scaling = Math::sqrt(transformationMatrix.scalingSquared().max());
+    const Float pixelsPerUnit = 0.5f*camera.projectionMatrix()[1][1]*camera.viewport().y();
+    const Frustum frustum = Frustum::fromMatrix(camera.projectionMatrix()*transformationMatrix);
+
+    /* Projected spacing of the node points in pixels, infinite if the camera
+       is inside the node */
+    const auto screenSpaceError = [&](const PointCloudNode& node) -> Float {
+        const Float distance = -transformationMatrix.transformPoint(node.bounds.center()).z();
+        if(distance <= 0.5f*node.bounds.size().length()*scaling)
+            return Constants::inf();
+        return node.spacing*scaling*pixelsPerUnit/distance;
+    };
+
+    std::priority_queue<std::pair<Float, UnsignedInt>> candidates;
+    Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> ranges;
+    if(Math::Intersection::rangeFrustum(pointCloud[0].bounds, frustum))
+        candidates.emplace(screenSpaceError(pointCloud[0]), 0);
+    UnsignedInt pointCount = 0;
+    while(!candidates.empty() && pointCount < PointCloudPointBudget) {
+        const std::pair<Float, UnsignedInt> candidate = candidates.top();
+        candidates.pop();
+
+        const PointCloudNode& node = pointCloud[candidate.second];
+        arrayAppend(ranges, InPlaceInit, node.offset, node.count);
+        pointCount += node.count;
+        if(candidate.first <= PointCloudMaxScreenSpaceError) continue;
+
+        for(const UnsignedInt child: node.children) {
+            if(child != ~UnsignedInt{} && Math::Intersection::rangeFrustum(pointCloud[child].bounds, frustum))
+                candidates.emplace(screenSpaceError(pointCloud[child]), child);
+        }
+    }
+
+    /* Nodes are stored in a depth-first order, so a node and its first
+       selected child are often next to each other in the vertex buffer. Merge
+       such ranges to have fewer draws. */
+    std::sort(ranges.begin(), ranges.end(), [](const Containers::Pair<UnsignedInt, UnsignedInt>& a, const Containers::Pair<UnsignedInt, UnsignedInt>& b) {
+        return a.first() < b.first();
+    });
+    for(std::size_t i = 0; i != ranges.size(); ) {
+        const UnsignedInt offset = ranges[i].first();
+        UnsignedInt count = ranges[i].second();
+        for(++i; i != ranges.size() && ranges[i].first() == offset + count; ++i)
+            count += ranges[i].second();
+
+        GL::MeshView view{mesh};
+        view.setBaseVertex(offset)
+            .setCount(count);
+        shader.draw(view);
+    }
+}
+
 class FlatDrawable: public SceneGraph::Drawable3D {
     public:
-        explicit FlatDrawable(Object3D& object, Shaders::FlatGL3D& shader, GL::Mesh& mesh, UnsignedInt objectId, const Color4& color, const Vector3& scale, Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _objectId{objectId}, _color{color}, _scale{scale}, _jointMatrices{jointMatrices}, _perVertexJointCount{perVertexJointCount}, _secondaryPerVertexJointCount{secondaryPerVertexJointCount} {}
+        explicit FlatDrawable(Object3D& object, Shaders::FlatGL3D& shader, GL::Mesh& mesh, UnsignedInt objectId, const Color4& color, const Vector3& scale, Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, Containers::ArrayView<GL::Mesh> levels, Containers::ArrayView<const PointCloudNode> pointCloud, const Range3D* bounds, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _objectId{objectId}, _color{color}, _scale{scale}, _jointMatrices{jointMatrices}, _perVertexJointCount{perVertexJointCount}, _secondaryPerVertexJointCount{secondaryPerVertexJointCount}, _levels{levels}, _pointCloud{pointCloud}, _bounds{bounds} {}
 
     private:
         void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
@@ -373,13 +781,16 @@ class FlatDrawable: public SceneGraph::Drawable3D {
             CORRADE_UNUSED /* See ScenePlayer::flatShader() for details */
             #endif
             _secondaryPerVertexJointCount;
+        Containers::ArrayView<GL::Mesh> _levels;
+        Containers::ArrayView<const PointCloudNode> _pointCloud;
+        const Range3D* _bounds;
 };
 
 class PhongDrawable: public SceneGraph::Drawable3D {
     public:
-        explicit PhongDrawable(Object3D& object, Shaders::PhongGL& shader, GL::Mesh& mesh, UnsignedInt objectId, const Color4& color, GL::Texture2D* diffuseTexture, GL::Texture2D* normalTexture, Float normalTextureScale, Float alphaMask, const Matrix3& textureMatrix, Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, const bool& shadeless, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _objectId{objectId}, _color{color}, _diffuseTexture{diffuseTexture}, _normalTexture{normalTexture}, _normalTextureScale{normalTextureScale}, _alphaMask{alphaMask}, _textureMatrix{textureMatrix}, _jointMatrices{jointMatrices}, _perVertexJointCount{perVertexJointCount}, _secondaryPerVertexJointCount{secondaryPerVertexJointCount}, _shadeless(shadeless) {}
+        explicit PhongDrawable(Object3D& object, Shaders::PhongGL& shader, GL::Mesh& mesh, UnsignedInt objectId, const Color4& color, GL::Texture2D* diffuseTexture, GL::Texture2D* normalTexture, Float normalTextureScale, Float alphaMask, const Matrix3& textureMatrix, Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, Containers::ArrayView<GL::Mesh> levels, Containers::ArrayView<const PointCloudNode> pointCloud, const Range3D* bounds, const bool& shadeless, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _objectId{objectId}, _color{color}, _diffuseTexture{diffuseTexture}, _normalTexture{normalTexture}, _normalTextureScale{normalTextureScale}, _alphaMask{alphaMask}, _textureMatrix{textureMatrix}, _jointMatrices{jointMatrices}, _perVertexJointCount{perVertexJointCount}, _secondaryPerVertexJointCount{secondaryPerVertexJointCount}, _levels{levels}, _pointCloud{pointCloud}, _bounds{bounds}, _shadeless(shadeless) {}
 
-        explicit PhongDrawable(Object3D& object, Shaders::PhongGL& shader, GL::Mesh& mesh, UnsignedInt objectId, const Color4& color, Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, const bool& shadeless, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _objectId{objectId}, _color{color}, _diffuseTexture{nullptr}, _normalTexture{nullptr}, _alphaMask{0.5f}, _jointMatrices{jointMatrices}, _perVertexJointCount{perVertexJointCount}, _secondaryPerVertexJointCount{secondaryPerVertexJointCount}, _shadeless{shadeless} {}
+        explicit PhongDrawable(Object3D& object, Shaders::PhongGL& shader, GL::Mesh& mesh, UnsignedInt objectId, const Color4& color, Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, Containers::ArrayView<GL::Mesh> levels, Containers::ArrayView<const PointCloudNode> pointCloud, const Range3D* bounds, const bool& shadeless, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _objectId{objectId}, _color{color}, _diffuseTexture{nullptr}, _normalTexture{nullptr}, _alphaMask{0.5f}, _jointMatrices{jointMatrices}, _perVertexJointCount{perVertexJointCount}, _secondaryPerVertexJointCount{secondaryPerVertexJointCount}, _levels{levels}, _pointCloud{pointCloud}, _bounds{bounds}, _shadeless{shadeless} {}
 
     private:
         void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
@@ -399,16 +810,34 @@ class PhongDrawable: public SceneGraph::Drawable3D {
             CORRADE_UNUSED /* See ScenePlayer::flatShader() for details */
             #endif
             _secondaryPerVertexJointCount;
+        Containers::ArrayView<GL::Mesh> _levels;
+        Containers::ArrayView<const PointCloudNode> _pointCloud;
+        const Range3D* _bounds;
         const bool& _shadeless;
 };
 
+class PhongInstanceDrawable: public SceneGraph::Drawable3D {
+    public:
+        explicit PhongInstanceDrawable(Object3D& object, PhongInstanceGroup& instanceGroup, UnsignedInt objectId, const Range3D* bounds, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _instanceGroup(instanceGroup), _objectId{objectId}, _bounds{bounds} {}
+
+    private:
+        void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override {
+            if(isInsideFrustum(_bounds, transformationMatrix, camera))
+                _instanceGroup.add(transformationMatrix, _objectId);
+        }
+
+        PhongInstanceGroup& _instanceGroup;
+        UnsignedInt _objectId;
+        const Range3D* _bounds;
+};
+
 class MeshVisualizerDrawable: public SceneGraph::Drawable3D {
     public:
-        explicit MeshVisualizerDrawable(Object3D& object, Shaders::MeshVisualizerGL3D& shader, GL::Mesh& mesh, std::size_t meshId, UnsignedInt objectIdCount, UnsignedInt vertexCount,
+        explicit MeshVisualizerDrawable(Object3D& object, Shaders::MeshVisualizerGL3D& shader, GL::Mesh& mesh, GL::Mesh* wireframeMesh, std::size_t meshId, UnsignedInt objectIdCount, UnsignedInt vertexCount,
             #ifndef MAGNUM_TARGET_GLES
             UnsignedInt primitiveCount,
             #endif
-        Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, const bool& shadeless, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _meshId{meshId}, _objectIdCount{objectIdCount}, _vertexCount{vertexCount},
+        Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, const bool& shadeless, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _wireframeMesh{wireframeMesh}, _meshId{meshId}, _objectIdCount{objectIdCount}, _vertexCount{vertexCount},
             #ifndef MAGNUM_TARGET_GLES
             _primitiveCount{primitiveCount},
             #endif
@@ -426,6 +855,9 @@ class MeshVisualizerDrawable: public SceneGraph::Drawable3D {
 
         Containers::Reference<Shaders::MeshVisualizerGL3D> _shader;
         GL::Mesh& _mesh;
+        /* Non-indexed variant of the mesh for wireframe visualization if the
+           shader can't use a geometry shader, null otherwise */
+        GL::Mesh* _wireframeMesh;
         std::size_t _meshId;
         UnsignedInt _objectIdCount, _vertexCount;
         #ifndef MAGNUM_TARGET_GLES
@@ -458,24 +890,7 @@ class LightDrawable: public SceneGraph::Drawable3D {
         Containers::Array<Vector4>& _positions;
 };
 
-class JointDrawable: public SceneGraph::Drawable3D {
-    public:
-        explicit JointDrawable(Object3D& object, const Matrix4& inverseBindMatrix, Matrix4& jointMatrix, SceneGraph::DrawableGroup3D& group):
-            SceneGraph::Drawable3D{object, &group},
-            _inverseBindMatrix{inverseBindMatrix},
-            /* GCC 4.8 can't handle {} here */
-            _jointMatrix(jointMatrix) {}
-
-    private:
-        void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D&) override {
-            _jointMatrix = transformationMatrix*_inverseBindMatrix;
-        }
-
-        Matrix4 _inverseBindMatrix;
-        Matrix4& _jointMatrix;
-};
-
-ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, DebugTools::FrameProfilerGL::Values profilerValues):
+ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, DebugTools::FrameProfilerGL::Values profilerValues, PluginManager::Manager<Trade::AbstractImporter>& importerManager, const Containers::StringView textureCacheDirectory, const bool optimizeMeshes, const Float animationBakeRate):
     AbstractPlayer{application, PropagatedEvent::Draw|PropagatedEvent::Input},
     _ui(ui),
     _screen{Ui::snap(ui, Ui::Snap::Fill|Ui::Snap::NoPad, controls, {})},
@@ -483,6 +898,8 @@ ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInt
         {}, Text::Alignment::LineLeft, Ui::LabelStyle::Dim},
     _objectInfo{Ui::snap(ui, Ui::Snap::TopLeft|Ui::Snap::Inside, _screen, LabelSize, Ui::NodeFlag::Hidden),
         {}, Text::Alignment::LineLeft, Ui::LabelStyle::Dim},
+    _hoveredObjectInfo{Ui::snap(ui, Ui::Snap::BottomLeft|Ui::Snap::InsideX, _modelInfo, LabelSize, Ui::NodeFlag::Hidden),
+        {}, Text::Alignment::LineLeft, Ui::LabelStyle::Dim},
     _toggleShadeless{Ui::snap(ui, Ui::Snap::TopRight|Ui::Snap::Inside, _screen, {0.0f,
         /* There's also the fullscreen toggle on Emscripten */
         /** @todo clean this up once there's a layouter that can snap relative
@@ -500,8 +917,17 @@ ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInt
     _animationPlayPause{Ui::snap(ui, Ui::Snap::Right, _animationBackward, ControlSize), "Pause"_s, Ui::ButtonStyle::Warning},
     _animationStop{Ui::button(Ui::snap(ui, Ui::Snap::Right, _animationPlayPause, ControlSize), "Stop"_s, Ui::ButtonStyle::Danger)},
     _animationForward{Ui::button(Ui::snap(ui, Ui::Snap::Right, _animationStop, HalfControlSize), "»"_s)},
-    _animationProgress{Ui::snap(ui, Ui::Snap::Right, _animationForward, LabelSize), {}}
+    _animationProgress{Ui::snap(ui, Ui::Snap::Right, _animationForward, LabelSize), {}},
+    _importerManager(importerManager),
+    _optimizeMeshes{optimizeMeshes},
+    _animationBakeRate{animationBakeRate}
 {
+    #if !defined(CORRADE_TARGET_EMSCRIPTEN) && (defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)))
+    _textureCacheDirectory = textureCacheDirectory;
+    #else
+    static_cast<void>(textureCacheDirectory);
+    #endif
+
     /* Color maps */
     _colorMapTexture
         .setMinificationFilter(SamplerFilter::Linear, SamplerMipmap::Linear)
@@ -569,7 +995,7 @@ ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInt
 
     /* Set up offscreen rendering for object ID retrieval */
     _selectionDepth.setStorage(GL::RenderbufferFormat::DepthComponent24, application.framebufferSize());
-    _selectionObjectId.setStorage(GL::RenderbufferFormat::R16UI, application.framebufferSize());
+    _selectionObjectId.setStorage(GL::RenderbufferFormat::R32UI, application.framebufferSize());
     _selectionFramebuffer = GL::Framebuffer{{{}, application.framebufferSize()}};
     _selectionFramebuffer
         .attachRenderbuffer(GL::Framebuffer::BufferAttachment::Depth, _selectionDepth)
@@ -637,9 +1063,21 @@ ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInt
     }
     #endif
 
+    /* Stage durations are measured directly in drawEvent(), the profiler
+       just picks them up at the end of each frame */
+    Containers::Array<DebugTools::FrameProfiler::Measurement> stageMeasurements;
+    for(UnsignedInt i = 0; i != UnsignedInt(ProfiledStage::Count); ++i)
+        arrayAppend(stageMeasurements, InPlaceInit, ProfiledStageNames[i],
+            DebugTools::FrameProfiler::Units::Nanoseconds,
+            [](void*) {},
+            [](void* state) { return *static_cast<UnsignedLong*>(state); },
+            &_stageDurations[i]);
+
     /* Disable profiler by default */
     _profiler = DebugTools::FrameProfilerGL{profilerValues, 50};
     _profiler.disable();
+    _stageProfiler = DebugTools::FrameProfiler{Utility::move(stageMeasurements), 50};
+    _stageProfiler.disable();
 }
 
 Shaders::FlatGL3D& ScenePlayer::flatShader(Shaders::FlatGL3D::Flags flags) {
@@ -669,7 +1107,13 @@ Shaders::FlatGL3D& ScenePlayer::flatShader(Shaders::FlatGL3D::Flags flags) {
                 0
                 #endif
             );
-        found = _flatShaders.emplace(enumCastUnderlyingType(flags),
+        if(_compileShadersAsync) {
+            arrayAppend(_flatShaderCompileStates, InPlaceInit,
+                enumCastUnderlyingType(flags),
+                Shaders::FlatGL3D::compile(configuration));
+            found = _flatShaders.emplace(enumCastUnderlyingType(flags),
+                Shaders::FlatGL3D{NoCreate}).first;
+        } else found = _flatShaders.emplace(enumCastUnderlyingType(flags),
             Shaders::FlatGL3D{configuration}).first;
     }
     return found->second;
@@ -696,16 +1140,46 @@ Shaders::PhongGL& ScenePlayer::phongShader(Shaders::PhongGL::Flags flags) {
                 0
                 #endif
             );
-        found = _phongShaders.emplace(enumCastUnderlyingType(flags),
-            Shaders::PhongGL{configuration}).first;
-
-        found->second
-            .setSpecularColor(0x11111100_rgbaf)
-            .setShininess(80.0f);
+        if(_compileShadersAsync) {
+            arrayAppend(_phongShaderCompileStates, InPlaceInit,
+                enumCastUnderlyingType(flags),
+                Shaders::PhongGL::compile(configuration));
+            found = _phongShaders.emplace(enumCastUnderlyingType(flags),
+                Shaders::PhongGL{NoCreate}).first;
+        } else {
+            found = _phongShaders.emplace(enumCastUnderlyingType(flags),
+                Shaders::PhongGL{configuration}).first;
+            setupPhongShader(found->second);
+        }
     }
     return found->second;
 }
 
+void ScenePlayer::setupPhongShader(Shaders::PhongGL& shader) {
+    shader
+        .setSpecularColor(0x11111100_rgbaf)
+        .setShininess(80.0f);
+}
+
+void ScenePlayer::finishShaderCompilation() {
+    /* The shaders got submitted for compilation all at once, so with
+       KHR_parallel_shader_compile the driver can compile them in parallel
+       instead of one after another. Here it waits for all of them to finish
+       as the drawables need them right after. The placeholders are replaced
+       in-place so the references the drawables have stay valid. */
+    for(Containers::Pair<UnsignedInt, Shaders::FlatGL3D::CompileState>& state: _flatShaderCompileStates)
+        _flatShaders.at(state.first()) = Shaders::FlatGL3D{Utility::move(state.second())};
+    for(Containers::Pair<UnsignedInt, Shaders::PhongGL::CompileState>& state: _phongShaderCompileStates) {
+        Shaders::PhongGL& shader = _phongShaders.at(state.first());
+        shader = Shaders::PhongGL{Utility::move(state.second())};
+        setupPhongShader(shader);
+    }
+
+    arrayClear(_flatShaderCompileStates);
+    arrayClear(_phongShaderCompileStates);
+    _compileShadersAsync = false;
+}
+
 Shaders::MeshVisualizerGL3D& ScenePlayer::meshVisualizerShader(Shaders::MeshVisualizerGL3D::Flags flags) {
     auto found = _meshVisualizerShaders.find(enumCastUnderlyingType(flags));
     if(found == _meshVisualizerShaders.end()) {
@@ -890,17 +1364,421 @@ void ScenePlayer::updateLightColorBrightness() {
         shader.second.setLightColors(lightColorsBrightness);
 }
 
+void ScenePlayer::showLoadingProgress(const Containers::StringView what, const std::size_t done, const std::size_t total) {
+    /* On the web the frame would get shown only after the control returns
+       back to the browser, so there's no point in doing anything */
+    #ifdef CORRADE_TARGET_EMSCRIPTEN
+    static_cast<void>(what);
+    static_cast<void>(done);
+    static_cast<void>(total);
+    #else
+    /* Update at most ten times a second to not have the loading slowed down
+       by the drawing */
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(now - _loadingProgressTime < std::chrono::milliseconds{100})
+        return;
+    _loadingProgressTime = now;
+
+    _modelInfo.setText(Containers::ArrayView<const char>{Utility::format(
+        "Loading {} {}/{}", what, done, total)},
+        Text::Alignment::MiddleLeft);
+
+    /* Draw just the UI, the same way as Overlay::drawEvent() does, and show
+       it right away as the application won't get to its draw event until the
+       loading finishes */
+    GL::defaultFramebuffer.clear(GL::FramebufferClear::Color|GL::FramebufferClear::Depth);
+    GL::Renderer::disable(GL::Renderer::Feature::DepthTest);
+    GL::Renderer::enable(GL::Renderer::Feature::Blending);
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+    _ui.draw();
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::Zero);
+    GL::Renderer::disable(GL::Renderer::Feature::Blending);
+    GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+    application().swapBuffers();
+    #endif
+}
+
+namespace {
+
+enum class NormalGeneration: UnsignedByte {
+    None,
+    Flat,
+    Smooth
+};
+
+/* CPU-side mesh processing that doesn't need the importer or a GL context and
+   thus can be done on a worker thread. Equivalent to what MeshTools::compile()
+   does with CompileFlag::GenerateFlatNormals / GenerateSmoothNormals, except
+   that triangle strips and fans are converted to indexed triangles first. */
+void processMesh(Trade::MeshData& meshData, const NormalGeneration normals) {
+    if(meshData.primitive() == MeshPrimitive::TriangleStrip ||
+       meshData.primitive() == MeshPrimitive::TriangleFan)
+        meshData = MeshTools::generateIndices(Utility::move(meshData));
+
+    /* Flat normals need each triangle to have its own vertices */
+    if(normals == NormalGeneration::Flat && meshData.isIndexed())
+        meshData = MeshTools::duplicate(meshData);
+
+    /* Add a placeholder normal attribute, which is then filled in */
+    meshData = MeshTools::interleave(Utility::move(meshData), {
+        Trade::MeshAttributeData{Trade::MeshAttribute::Normal, VertexFormat::Vector3, nullptr}
+    });
+    if(normals == NormalGeneration::Flat) {
+        MeshTools::generateFlatNormalsInto(
+            meshData.attribute<Vector3>(Trade::MeshAttribute::Position),
+            meshData.mutableAttribute<Vector3>(Trade::MeshAttribute::Normal));
+    } else {
+        const Containers::Array<UnsignedInt> indices = meshData.indicesAsArray();
+        MeshTools::generateSmoothNormalsInto(Containers::stridedArrayView(indices),
+            meshData.attribute<Vector3>(Trade::MeshAttribute::Position),
+            meshData.mutableAttribute<Vector3>(Trade::MeshAttribute::Normal));
+    }
+}
+
+/* Packs normals, tangents and bitangents to normalized shorts and texture
+   coordinates to half-floats, keeping the other attributes as they are. Each
+   attribute is kept four-byte aligned. */
+VertexFormat packedVertexFormat(const Trade::MeshAttribute name, const VertexFormat format) {
+    if((name == Trade::MeshAttribute::Normal ||
+        name == Trade::MeshAttribute::Tangent ||
+        name == Trade::MeshAttribute::Bitangent) && format == VertexFormat::Vector3)
+        return VertexFormat::Vector3sNormalized;
+    if(name == Trade::MeshAttribute::Tangent && format == VertexFormat::Vector4)
+        return VertexFormat::Vector4sNormalized;
+    /* Half-float vertex attributes are an extension on ES2 */
+    #ifndef MAGNUM_TARGET_GLES2
+    if(name == Trade::MeshAttribute::TextureCoordinates && format == VertexFormat::Vector2)
+        return VertexFormat::Vector2h;
+    #endif
+    return format;
+}
+
+void packMesh(Trade::MeshData& meshData) {
+    /* Calculate the packed layout. Implementation-specific formats have an
+       unknown size, leave such meshes as they are. */
+    Containers::Array<VertexFormat> formats{NoInit, meshData.attributeCount()};
+    Containers::Array<std::size_t> offsets{NoInit, meshData.attributeCount()};
+    std::size_t stride = 0;
+    bool packed = false;
+    for(UnsignedInt i = 0; i != meshData.attributeCount(); ++i) {
+        const VertexFormat format = meshData.attributeFormat(i);
+        if(isVertexFormatImplementationSpecific(format)) return;
+
+        formats[i] = meshData.attributeArraySize(i) ? format :
+            packedVertexFormat(meshData.attributeName(i), format);
+        if(formats[i] != format) packed = true;
+        offsets[i] = stride;
+        stride += (vertexFormatSize(formats[i])*Math::max(meshData.attributeArraySize(i), UnsignedShort{1}) + 3) & ~std::size_t{3};
+    }
+    if(!packed) return;
+
+    /* Copy the index data, as the original may not be owned */
+    Containers::Array<char> indexData;
+    Trade::MeshIndexData indices;
+    if(meshData.isIndexed()) {
+        indexData = Containers::Array<char>{NoInit, meshData.indexData().size()};
+        Utility::copy(meshData.indexData(), indexData);
+        const Containers::StridedArrayView2D<const char> originalIndices = meshData.indices();
+        indices = Trade::MeshIndexData{Containers::StridedArrayView2D<const char>{indexData,
+            indexData.data() + (static_cast<const char*>(originalIndices.data()) - meshData.indexData().data()),
+            originalIndices.size(), originalIndices.stride()}};
+    }
+
+    Containers::Array<char> vertexData{ValueInit, stride*meshData.vertexCount()};
+    Containers::Array<Trade::MeshAttributeData> attributes{meshData.attributeCount()};
+    for(UnsignedInt i = 0; i != meshData.attributeCount(); ++i)
+        attributes[i] = Trade::MeshAttributeData{meshData.attributeName(i), formats[i],
+            Containers::StridedArrayView1D<const void>{vertexData, vertexData.data() + offsets[i], meshData.vertexCount(), std::ptrdiff_t(stride)},
+            meshData.attributeArraySize(i)};
+
+    Trade::MeshData out{meshData.primitive(),
+        Utility::move(indexData), indices,
+        Utility::move(vertexData), Utility::move(attributes),
+        meshData.vertexCount()};
+    for(UnsignedInt i = 0; i != meshData.attributeCount(); ++i) {
+        const VertexFormat format = meshData.attributeFormat(i);
+        if(formats[i] == format)
+            Utility::copy(meshData.attribute(i), out.mutableAttribute(i));
+        else if(formats[i] == VertexFormat::Vector2h)
+            Math::packHalfInto(
+                Containers::arrayCast<2, const Float>(meshData.attribute(i)),
+                Containers::arrayCast<2, UnsignedShort>(out.mutableAttribute(i)));
+        else
+            Math::packInto(
+                Containers::arrayCast<2, const Float>(meshData.attribute(i)),
+                Containers::arrayCast<2, Short>(out.mutableAttribute(i)));
+    }
+
+    meshData = Utility::move(out);
+}
+
+/* Point meshes with at least PointCloudMinVertexCount vertices are organized
+   into an octree with at most PointCloudMaxDepth levels below the root. Each
+   node keeps a subsample of about PointCloudNodePointCount points, the rest
+   is passed to its children. */
+constexpr UnsignedInt PointCloudMinVertexCount = 256*1024;
+constexpr UnsignedInt PointCloudMaxDepth = 10;
+constexpr UnsignedInt PointCloudNodePointCount = 16*1024;
+
+/* Spreads the lower ten bits of the value to every third bit, for a Morton
+   code out of three of them */
+UnsignedInt spreadMortonBits(UnsignedInt value) {
+    value &= 0x3ff;
+    value = (value | (value << 16)) & 0x030000ff;
+    value = (value | (value << 8)) & 0x0300f00f;
+    value = (value | (value << 4)) & 0x030c30c3;
+    value = (value | (value << 2)) & 0x09249249;
+    return value;
+}
+
+/* The keys are Morton codes in the upper and vertex indices in the lower 32
+   bits, sorted. Points selected for the node are appended to the order, the
+   remaining ones are compacted to the front of the keys, which keeps them
+   sorted and thus each child gets a contiguous range. */
+UnsignedInt buildPointCloudNode(const Containers::ArrayView<UnsignedLong> keys, const UnsignedInt level, const Range3D& cell, Containers::Array<UnsignedInt>& order, Containers::Array<PointCloudNode>& nodes) {
+    const UnsignedInt id = nodes.size();
+    PointCloudNode& node = arrayAppend(nodes, PointCloudNode{});
+    node.bounds = cell;
+    node.offset = order.size();
+    for(UnsignedInt& child: node.children)
+        child = ~UnsignedInt{};
+
+    /* Leaf nodes take all remaining points, other take every n-th */
+    const std::size_t stride = level == PointCloudMaxDepth ? 1 :
+        (keys.size() + PointCloudNodePointCount - 1)/PointCloudNodePointCount;
+    std::size_t remaining = 0;
+    for(std::size_t i = 0; i != keys.size(); ++i) {
+        if(i % stride == 0)
+            arrayAppend(order, UnsignedInt(keys[i]));
+        else
+            keys[remaining++] = keys[i];
+    }
+    node.count = order.size() - node.offset;
+    node.spacing = cell.sizeX()/Math::sqrt(Float(node.count));
+
+    /* Split the rest among children by the next three bits of the Morton
+       code. The node reference is invalidated by the recursion, so it's
+       accessed through the ID. */
+    const UnsignedInt shift = 32 + 3*(PointCloudMaxDepth - level - 1);
+    const Vector3 childSize = cell.size()*0.5f;
+    for(std::size_t begin = 0, end; begin != remaining; begin = end) {
+        const UnsignedInt child = (keys[begin] >> shift) & 7;
+        for(end = begin + 1; end != remaining && ((keys[end] >> shift) & 7) == child; ++end);
+
+        const Vector3 childMin = cell.min() + childSize*Vector3{Float(child & 1), Float((child >> 1) & 1), Float((child >> 2) & 1)};
+        const UnsignedInt childId = buildPointCloudNode(keys.slice(begin, end), level + 1, Range3D::fromSize(childMin, childSize), order, nodes);
+        nodes[id].children[child] = childId;
+    }
+
+    return id;
+}
+
+/* Reorders vertices of a point mesh to match the octree. Done on a worker
+   thread together with processMesh(). */
+Containers::Array<PointCloudNode> buildPointCloud(Trade::MeshData& meshData) {
+    if(meshData.isIndexed())
+        meshData = MeshTools::duplicate(meshData);
+
+    /* The octree is a cube around the points */
+    const Containers::Array<Vector3> positions = meshData.positions3DAsArray();
+    const Containers::Pair<Vector3, Vector3> minmax = Math::minmax(positions);
+    const Float size = Math::max((minmax.second() - minmax.first()).max(), Math::TypeTraits<Float>::epsilon());
+    const Float scale = Float(1 << PointCloudMaxDepth)/size;
+
+    Containers::Array<UnsignedLong> keys{NoInit, positions.size()};
+    for(std::size_t i = 0; i != positions.size(); ++i) {
+        const Vector3ui cell{Math::clamp((positions[i] - minmax.first())*scale, Vector3{0.0f}, Vector3{Float((1 << PointCloudMaxDepth) - 1)})};
+        keys[i] = UnsignedLong(spreadMortonBits(cell.x())|
+            (spreadMortonBits(cell.y()) << 1)|
+            (spreadMortonBits(cell.z()) << 2)) << 32 | i;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    Containers::Array<UnsignedInt> order;
+    arrayReserve(order, positions.size());
+    Containers::Array<PointCloudNode> nodes;
+    buildPointCloudNode(keys, 0, Range3D::fromSize(minmax.first(), Vector3{size}), order, nodes);
+
+    /* Reorder the vertices by treating the order as an index buffer and
+       duplicating the vertices with it */
+    meshData = MeshTools::duplicate(Trade::MeshData{meshData.primitive(),
+        {}, Containers::arrayView(order), Trade::MeshIndexData{order},
+        {}, meshData.vertexData(), Trade::meshAttributeDataNonOwningArray(meshData.attributeData()),
+        meshData.vertexCount()});
+
+    return nodes;
+}
+
+/* Hash of the mesh vertex and index data, used to find duplicate meshes.
+   Meshes with the same hash are then compared with isSameMesh(). */
+std::size_t meshHash(const Trade::MeshData& meshData) {
+    const Utility::MurmurHash2::Digest vertexDigest = Utility::MurmurHash2{}(meshData.vertexData().data(), meshData.vertexData().size());
+    const Utility::MurmurHash2::Digest indexDigest = Utility::MurmurHash2{meshData.vertexCount()}(meshData.indexData().data(), meshData.indexData().size());
+    return *reinterpret_cast<const std::size_t*>(vertexDigest.byteArray()) ^
+        *reinterpret_cast<const std::size_t*>(indexDigest.byteArray());
+}
+
+bool isSameMesh(const Trade::MeshData& a, const Trade::MeshData& b) {
+    if(a.primitive() != b.primitive() ||
+       a.vertexCount() != b.vertexCount() ||
+       a.attributeCount() != b.attributeCount() ||
+       a.isIndexed() != b.isIndexed())
+        return false;
+    if(a.isIndexed() && (
+        a.indexType() != b.indexType() ||
+        a.indexCount() != b.indexCount() ||
+        a.indexOffset() != b.indexOffset()))
+        return false;
+    for(UnsignedInt i = 0; i != a.attributeCount(); ++i) {
+        if(a.attributeName(i) != b.attributeName(i) ||
+           a.attributeFormat(i) != b.attributeFormat(i) ||
+           a.attributeOffset(i) != b.attributeOffset(i) ||
+           a.attributeStride(i) != b.attributeStride(i) ||
+           a.attributeArraySize(i) != b.attributeArraySize(i))
+            return false;
+    }
+    return Containers::StringView{a.vertexData()} == Containers::StringView{b.vertexData()} &&
+        Containers::StringView{a.indexData()} == Containers::StringView{b.indexData()};
+}
+
+#if defined(MAGNUM_TARGET_WEBGL) || defined(MAGNUM_TARGET_GLES2)
+/* Compiles a non-indexed mesh with just the attributes needed for wireframe
+   visualization. On ES2 there's no gl_VertexID, so the shader needs the
+   vertex index as an attribute, and it has no integer attributes for the
+   object ID. */
+GL::Mesh compileWireframeMesh(const MeshInfo& info) {
+    const Containers::Array<Vector3> positions = MeshTools::duplicate(Containers::stridedArrayView(info.wireframeIndices), Containers::stridedArrayView(info.wireframePositions));
+
+    GL::Mesh mesh{GL::MeshPrimitive::Triangles};
+    mesh.setCount(positions.size())
+        .addVertexBuffer(GL::Buffer{positions}, 0, Shaders::MeshVisualizerGL3D::Position{});
+    #ifndef MAGNUM_TARGET_GLES2
+    if(!info.wireframeObjectIds.isEmpty())
+        mesh.addVertexBuffer(GL::Buffer{MeshTools::duplicate(Containers::stridedArrayView(info.wireframeIndices), Containers::stridedArrayView(info.wireframeObjectIds))}, 0, Shaders::MeshVisualizerGL3D::ObjectId{});
+    #else
+    Containers::Array<Float> vertexIndices{NoInit, positions.size()};
+    for(std::size_t i = 0; i != vertexIndices.size(); ++i)
+        vertexIndices[i] = Float(i);
+    mesh.addVertexBuffer(GL::Buffer{vertexIndices}, 0, Shaders::MeshVisualizerGL3D::VertexIndex{});
+    #endif
+    return mesh;
+}
+#endif
+
+/* If the animation is baked, samples the track into given column of the
+   baked values, otherwise adds it to the player directly */
+template<class V, class R> void addAnimationTrack(Animation::Player<std::chrono::nanoseconds, Float>& player, const Animation::TrackView<const Float, const V, R>& track, R& destination, const BakedAnimation& baked, const Containers::StridedArrayView1D<R>& bakedValues) {
+    if(!baked.frameCount) {
+        player.add(track, destination);
+        return;
+    }
+
+    /* The frames are sampled in order, so the hint makes each lookup just
+       a check of the next keyframe */
+    std::size_t hint = 0;
+    for(std::size_t i = 0; i != bakedValues.size(); ++i)
+        bakedValues[i] = track.at(baked.begin + i/baked.rate, hint);
+}
+
+void applyBakedAnimation(const BakedAnimation& baked, const Containers::ArrayView<AnimatedObjectInfo> objects, const Float time) {
+    const Float frame = Math::clamp((time - baked.begin)*baked.rate, 0.0f, Float(baked.frameCount - 1));
+    const UnsignedInt first = UnsignedInt(frame);
+    const UnsignedInt second = Math::min(first + 1, baked.frameCount - 1);
+    const Float factor = frame - first;
+
+    const std::size_t count = objects.size();
+    const Vector3* const translations0 = baked.translations.data() + first*count;
+    const Vector3* const translations1 = baked.translations.data() + second*count;
+    const Quaternion* const rotations0 = baked.rotations.data() + first*count;
+    const Quaternion* const rotations1 = baked.rotations.data() + second*count;
+    const Vector3* const scalings0 = baked.scalings.data() + first*count;
+    const Vector3* const scalings1 = baked.scalings.data() + second*count;
+    for(std::size_t i = 0; i != count; ++i) {
+        objects[i].translation = Math::lerp(translations0[i], translations1[i], factor);
+        objects[i].rotation = Math::lerpShortestPath(rotations0[i], rotations1[i], factor);
+        objects[i].scaling = Math::lerp(scalings0[i], scalings1[i], factor);
+    }
+}
+
+}
+
+#if !defined(CORRADE_TARGET_EMSCRIPTEN) && (defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)))
+bool ScenePlayer::loadCachedTexture(GL::Texture2D& texture, const Trade::ImageData2D& image) {
+    /* Only 8-bit RGB and RGBA images can be encoded */
+    if(image.isCompressed() || (
+       image.format() != PixelFormat::RGB8Unorm &&
+       image.format() != PixelFormat::RGB8Srgb &&
+       image.format() != PixelFormat::RGBA8Unorm &&
+       image.format() != PixelFormat::RGBA8Srgb))
+        return false;
+
+    /* The cached file is keyed by a hash of the pixel data together with the
+       size and format, so a changed source image results in a new entry */
+    const Utility::MurmurHash2::Digest digest = Utility::MurmurHash2{}(image.data().data(), image.data().size());
+    const Containers::String filename = Utility::Path::join(_textureCacheDirectory, Utility::format("{:x}-{}x{}-{}.ktx2",
+        *reinterpret_cast<const std::size_t*>(digest.byteArray()),
+        image.size().x(), image.size().y(),
+        UnsignedInt(image.format())));
+
+    /* On a cache miss encode the image into a Basis-compressed KTX2 file,
+       including a full mip chain */
+    Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> cached;
+    if(!Utility::Path::exists(filename)) {
+        if(!_imageConverterManager)
+            _imageConverterManager.emplace();
+        Containers::Pointer<Trade::AbstractImageConverter> converter = _imageConverterManager->loadAndInstantiate("BasisKtxImageConverter");
+        if(!converter) return false;
+
+        converter->configuration().setValue("mip_gen", true);
+        Debug{} << "Compressing a" << image.size().x() << Debug::nospace << "x" << Debug::nospace << image.size().y() << "texture to" << filename;
+        if(!converter->convertToFile(image, filename))
+            return false;
+    }
+    if(!(cached = Utility::Path::mapRead(filename)))
+        return false;
+
+    /* Transcode to the GPU format selected for BasisImporter on startup */
+    Containers::Pointer<Trade::AbstractImporter> importer = _importerManager.loadAndInstantiate("BasisImporter");
+    if(!importer || !importer->openMemory(*cached) || !importer->image2DCount())
+        return false;
+
+    Containers::Array<Trade::ImageData2D> levels;
+    for(UnsignedInt i = 0, count = importer->image2DLevelCount(0); i != count; ++i) {
+        Containers::Optional<Trade::ImageData2D> level = importer->image2D(0, i);
+        if(!level) return false;
+        arrayAppend(levels, Utility::move(*level));
+    }
+
+    loadImage(texture, levels);
+    return true;
+}
+#endif
+
 void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter& importer, Int id) {
     if(id >= 0 && UnsignedInt(id) >= importer.sceneCount()) {
         Fatal{} << "Cannot load a scene with ID" << id << "as there's only" << importer.sceneCount() << "scenes";
     }
 
     _data.emplace();
+    _ui.addNodeFlags(_hoveredObjectInfo, Ui::NodeFlag::Hidden);
+    /* Selections requested for the previous scene would refer to different
+       objects, drop them */
+    #ifndef MAGNUM_TARGET_GLES
+    for(SelectionProbe& probe: _selectionProbes) {
+        if(probe.fence) glDeleteSync(probe.fence);
+        probe.fence = {};
+    }
+    #endif
+    arrayClear(_loadPhaseDurations);
+    _compileShadersAsync = true;
+    std::chrono::steady_clock::time_point phaseBegin = std::chrono::steady_clock::now();
 
     /* Load all textures. Textures that fail to load will be NullOpt. */
     Debug{} << "Loading" << importer.textureCount() << "textures";
     _data->textures = Containers::Array<Containers::Optional<GL::Texture2D>>{importer.textureCount()};
     for(UnsignedInt i = 0; i != importer.textureCount(); ++i) {
+        showLoadingProgress("textures"_s, i, importer.textureCount());
+
         Containers::Optional<Trade::TextureData> textureData = importer.texture(i);
         if(!textureData || textureData->type() != Trade::TextureType::Texture2D) {
             Warning{} << "Cannot load texture" << i << importer.textureName(i);
@@ -920,11 +1798,19 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             .setMinificationFilter(textureData->minificationFilter(), textureData->mipmapFilter())
             .setWrapping(textureData->wrapping().xy());
 
-        loadImage(texture, *imageData);
+        #if !defined(CORRADE_TARGET_EMSCRIPTEN) && (defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)))
+        if(_textureCacheDirectory.isEmpty() || !loadCachedTexture(texture, *imageData))
+        #endif
+        {
+            if(loadImage(texture, *imageData, true, true))
+                arrayAppend(_data->texturesPendingMipmaps, InPlaceInit, i, imageData->data().size());
+        }
 
         _data->textures[i] = Utility::move(texture);
     }
 
+    endLoadPhase("textures"_s, phaseBegin);
+
     /* Load all lights. Lights that fail to load will be NullOpt, saving the
        whole imported data so we can populate the selection info later. */
     Debug{} << "Loading" << importer.lightCount() << "lights";
@@ -958,6 +1844,8 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         _data->lights[i].light = Utility::move(light);
     }
 
+    endLoadPhase("lights"_s, phaseBegin);
+
     /* Load all skins. Skins that fail to load will be NullOpt. The data will
        be stored directly in objects later, so save them only temporarily. */
     struct SkinInfo {
@@ -984,6 +1872,8 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
     /* Allocate an array where absolute joint matrices will be stored */
     _data->skinJointMatrices = Containers::Array<Matrix4>{NoInit, totalJointCount};
 
+    endLoadPhase("skins"_s, phaseBegin);
+
     /* Load all materials. Materials that fail to load will be NullOpt. The
        data will be stored directly in objects later, so save them only
        temporarily. */
@@ -999,13 +1889,28 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         materials[i] = Utility::move(*materialData).as<Trade::PhongMaterialData>();
     }
 
+    endLoadPhase("materials"_s, phaseBegin);
+
     /* Load all meshes. Meshes that fail to load will be NullOpt. Remember
        which have vertex colors, so in case there's no material we can use that
-       instead. */
+       instead.
+
+       The loading is done in three stages -- first all meshes are imported
+       and inspected, as the importer can be only used from a single thread.
+       Then the potentially expensive CPU-side processing such as normal
+       generation is done on a pool of worker threads, and finally the meshes
+       are uploaded to the GPU on the main thread again. */
     Debug{} << "Loading" << importer.meshCount() << "meshes";
     _data->meshes = Containers::Array<MeshInfo>{importer.meshCount()};
     Containers::BitArray hasVertexColors{ValueInit, importer.meshCount()};
+    Containers::Array<Containers::Optional<Trade::MeshData>> meshes{importer.meshCount()};
+    Containers::Array<NormalGeneration> meshNormals{ValueInit, importer.meshCount()};
+    Containers::Array<Containers::Array<Trade::MeshData>> meshLevelData{importer.meshCount()};
+    Containers::BitArray meshIsPointCloud{ValueInit, importer.meshCount()};
+    Containers::Array<Containers::Array<PointCloudNode>> meshPointClouds{importer.meshCount()};
     for(UnsignedInt i = 0; i != importer.meshCount(); ++i) {
+        showLoadingProgress("meshes"_s, i, importer.meshCount());
+
         Containers::Optional<Trade::MeshData> meshData = importer.mesh(i);
         if(!meshData) {
             Warning{} << "Cannot load mesh" << i << importer.meshName(i);
@@ -1015,45 +1920,50 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         Containers::String meshName = importer.meshName(i);
         if(!meshName) meshName = Utility::format("#{}", i);
 
-        /* Disable warnings on custom attributes, as we printed them with
-           actual string names below. Generate normals for triangle meshes
-           (and don't do anything for line/point meshes, there it makes no
-           sense). */
-        MeshTools::CompileFlags flags = MeshTools::CompileFlag::NoWarnOnCustomAttributes;
+        /* Generate normals for triangle meshes (and don't do anything for
+           line/point meshes, there it makes no sense). */
         if((meshData->primitive() == MeshPrimitive::Triangles ||
             meshData->primitive() == MeshPrimitive::TriangleStrip ||
             meshData->primitive() == MeshPrimitive::TriangleFan) &&
            !meshData->attributeCount(Trade::MeshAttribute::Normal) &&
             meshData->hasAttribute(Trade::MeshAttribute::Position) &&
             meshData->attributeFormat(Trade::MeshAttribute::Position) == VertexFormat::Vector3) {
-            /* If the mesh is a triangle strip/fan, convert to indexed
-               triangles first. If the strip/fan is indexed, we can attempt to
-               generate smooth normals. If it's not, generate flat ones as
-               otherwise the smoothing would be only along the strip and not at
-               the seams, looking weird. */
+            /* If the mesh is a triangle strip/fan, it gets converted to
+               indexed triangles first. If the strip/fan is indexed, we can
+               attempt to generate smooth normals. If it's not, generate flat
+               ones as otherwise the smoothing would be only along the strip
+               and not at the seams, looking weird. */
             if(meshData->primitive() == MeshPrimitive::TriangleStrip ||
                meshData->primitive() == MeshPrimitive::TriangleFan) {
                 if(meshData->isIndexed()) {
                     Debug{} << "Mesh" << meshName << "doesn't have normals, generating smooth ones using information from the index buffer for a" << meshData->primitive();
-                    flags |= MeshTools::CompileFlag::GenerateSmoothNormals;
+                    meshNormals[i] = NormalGeneration::Smooth;
                 } else {
                     Debug{} << "Mesh" << meshName << "doesn't have normals, generating flat ones for a" << meshData->primitive();
-                    flags |= MeshTools::CompileFlag::GenerateFlatNormals;
+                    meshNormals[i] = NormalGeneration::Flat;
                 }
 
-                meshData = MeshTools::generateIndices(*Utility::move(meshData));
-
             /* Otherwise prefer smooth normals, if we have an index buffer
                telling us neighboring faces */
             } else if(meshData->isIndexed()) {
                 Debug{} << "Mesh" << meshName << "doesn't have normals, generating smooth ones using information from the index buffer";
-                flags |= MeshTools::CompileFlag::GenerateSmoothNormals;
+                meshNormals[i] = NormalGeneration::Smooth;
             } else {
                 Debug{} << "Mesh" << meshName << "doesn't have normals, generating flat ones";
-                flags |= MeshTools::CompileFlag::GenerateFlatNormals;
+                meshNormals[i] = NormalGeneration::Flat;
             }
         }
 
+        /* Organize large point meshes into an octree so only the parts
+           relevant for the current view are drawn */
+        if(meshData->primitive() == MeshPrimitive::Points &&
+           meshData->vertexCount() >= PointCloudMinVertexCount &&
+           meshData->hasAttribute(Trade::MeshAttribute::Position) &&
+           !isVertexFormatImplementationSpecific(meshData->attributeFormat(Trade::MeshAttribute::Position))) {
+            Debug{} << "Mesh" << meshName << "has" << meshData->vertexCount() << "points, organizing them into an octree";
+            meshIsPointCloud.set(i);
+        }
+
         /* Print messages about ignored attributes / levels */
         for(UnsignedInt j = 0; j != meshData->attributeCount(); ++j) {
             const Trade::MeshAttribute name = meshData->attributeName(j);
@@ -1069,36 +1979,198 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             if(isVertexFormatImplementationSpecific(format))
                 Warning{} << "Mesh" << meshName << "has" << name << "of format" << format << Debug::nospace << ", ignoring";
         }
+
+        /* Additional levels are treated as progressively coarser versions of
+           the mesh. They're processed and compiled together with the mesh
+           itself below. */
         const UnsignedInt meshLevels = importer.meshLevelCount(i);
         if(meshLevels > 1)
-            Warning{} << "Mesh" << meshName << "has" << meshLevels - 1 << "additional mesh levels, ignoring";
-
-        hasVertexColors.set(i, meshData->hasAttribute(Trade::MeshAttribute::Color));
-        Containers::Pair<UnsignedInt, UnsignedInt> perVertexJointCount = MeshTools::compiledPerVertexJointCount(*meshData);
-
-        /* Save metadata, compile the mesh */
-        _data->meshes[i].attributes = meshData->attributeCount();
-        _data->meshes[i].vertices = meshData->vertexCount();
-        _data->meshes[i].size = meshData->vertexData().size();
-        if(meshData->isIndexed()) {
-            _data->meshes[i].primitives = MeshTools::primitiveCount(meshData->primitive(), meshData->indexCount());
-            _data->meshes[i].size += meshData->indexData().size();
-        } else _data->meshes[i].primitives = MeshTools::primitiveCount(meshData->primitive(), meshData->vertexCount());
+            Debug{} << "Mesh" << meshName << "has" << meshLevels - 1 << "additional mesh levels, using them for distant objects";
+        for(UnsignedInt level = 1; level < meshLevels; ++level) {
+            Containers::Optional<Trade::MeshData> levelData = importer.mesh(i, level);
+            if(!levelData || levelData->primitive() != meshData->primitive()) {
+                Warning{} << "Cannot load level" << level << "of mesh" << meshName << Debug::nospace << ", ignoring the remaining levels";
+                break;
+            }
+            arrayAppend(meshLevelData[i], Utility::move(*levelData));
+        }
+
+        _data->meshes[i].name = Utility::move(meshName);
+        meshes[i] = Utility::move(meshData);
+    }
+
+    /* Find duplicate meshes, which poorly exported files may contain many
+       of. Those aren't processed or compiled, and drawables referencing them
+       use the first occurrence instead. */
+    Containers::Array<UnsignedInt> meshDuplicates{NoInit, meshes.size()};
+    {
+        std::unordered_map<std::size_t, UnsignedInt> meshHashes;
+        std::size_t duplicateCount = 0;
+        for(UnsignedInt i = 0; i != meshes.size(); ++i) {
+            meshDuplicates[i] = i;
+            if(!meshes[i]) continue;
+
+            const std::pair<std::unordered_map<std::size_t, UnsignedInt>::iterator, bool> found = meshHashes.emplace(meshHash(*meshes[i]), i);
+            if(found.second || !isSameMesh(*meshes[found.first->second], *meshes[i]))
+                continue;
+
+            meshDuplicates[i] = found.first->second;
+            meshes[i] = Containers::NullOpt;
+            meshNormals[i] = NormalGeneration::None;
+            meshLevelData[i] = {};
+            ++duplicateCount;
+        }
+        if(duplicateCount)
+            Debug{} << "Found" << duplicateCount << "duplicate meshes, compiling only the first occurrences";
+    }
+
+    /* Process the meshes that need it. Without thread support, or if there's
+       just a single mesh to process, it's all done on the main thread. */
+    const bool optimizeMeshes = _optimizeMeshes;
+    {
+        std::size_t meshesToProcessCount = 0;
+        for(std::size_t i = 0; i != meshes.size(); ++i)
+            if(meshes[i] && (meshNormals[i] != NormalGeneration::None || meshIsPointCloud[i] || optimizeMeshes))
+                ++meshesToProcessCount;
+
+        /* Each thread picks the next unprocessed mesh until there's none
+           left */
+        std::atomic<std::size_t> next{0};
+        const auto processMeshes = [&meshes, &meshNormals, &meshIsPointCloud, &meshPointClouds, &next, optimizeMeshes]() {
+            for(std::size_t i; (i = next++) < meshes.size(); ) {
+                if(!meshes[i]) continue;
+                if(meshNormals[i] != NormalGeneration::None)
+                    processMesh(*meshes[i], meshNormals[i]);
+                if(meshIsPointCloud[i])
+                    meshPointClouds[i] = buildPointCloud(*meshes[i]);
+                if(optimizeMeshes)
+                    packMesh(*meshes[i]);
+            }
+        };
+
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        const std::size_t threadCount = Math::min(std::size_t(std::thread::hardware_concurrency()), meshesToProcessCount);
+        Containers::Array<std::thread> threads;
+        if(threadCount > 1) {
+            Debug{} << "Processing" << meshesToProcessCount << "meshes on" << threadCount << "threads";
+            arrayReserve(threads, threadCount - 1);
+            for(std::size_t i = 0; i != threadCount - 1; ++i)
+                arrayAppend(threads, InPlaceInit, processMeshes);
+        }
+        #endif
+
+        if(meshesToProcessCount)
+            processMeshes();
+
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        for(std::thread& thread: threads)
+            thread.join();
+        #endif
+    }
+
+    /* Optimize the index buffers for vertex cache, if requested. The plugin
+       is not thread-safe, so it's done on the main thread. */
+    Containers::Pointer<Trade::AbstractSceneConverter> meshOptimizer;
+    if(optimizeMeshes) {
+        if(!_sceneConverterManager)
+            _sceneConverterManager.emplace();
+        if(!(meshOptimizer = _sceneConverterManager->loadAndInstantiate("MeshOptimizerSceneConverter")))
+            Warning{} << "Vertex cache optimization will be unavailable";
+    }
+
+    /* Save metadata and compile the meshes */
+    for(UnsignedInt i = 0; i != meshes.size(); ++i) {
+        if(!meshes[i]) continue;
+
+        showLoadingProgress("compiled meshes"_s, i, meshes.size());
+
+        if(meshOptimizer && meshes[i]->isIndexed() && meshes[i]->primitive() == MeshPrimitive::Triangles) {
+            if(Containers::Optional<Trade::MeshData> optimized = meshOptimizer->convert(*meshes[i]))
+                meshes[i] = Utility::move(optimized);
+        }
+
+        Trade::MeshData& meshData = *meshes[i];
+        hasVertexColors.set(i, meshData.hasAttribute(Trade::MeshAttribute::Color));
+        Containers::Pair<UnsignedInt, UnsignedInt> perVertexJointCount = MeshTools::compiledPerVertexJointCount(meshData);
+
+        _data->meshes[i].attributes = meshData.attributeCount();
+        _data->meshes[i].vertices = meshData.vertexCount();
+        _data->meshes[i].size = meshData.vertexData().size();
+        if(meshData.isIndexed()) {
+            _data->meshes[i].primitives = MeshTools::primitiveCount(meshData.primitive(), meshData.indexCount());
+            _data->meshes[i].size += meshData.indexData().size();
+        } else _data->meshes[i].primitives = MeshTools::primitiveCount(meshData.primitive(), meshData.vertexCount());
         /* Needed for a warning when using a mesh with no tangents with a
            normal map (as, unlike with normals, we have no builtin way to
            generate tangents right now) */
-        _data->meshes[i].hasTangents = meshData->hasAttribute(Trade::MeshAttribute::Tangent);
+        _data->meshes[i].hasTangents = meshData.hasAttribute(Trade::MeshAttribute::Tangent);
         /* Needed to decide how to visualize tangent space */
-        _data->meshes[i].hasSeparateBitangents = meshData->hasAttribute(Trade::MeshAttribute::Bitangent);
-        if(meshData->hasAttribute(Trade::MeshAttribute::ObjectId)) {
-            _data->meshes[i].objectIdCount = Math::max(meshData->objectIdsAsArray());
+        _data->meshes[i].hasSeparateBitangents = meshData.hasAttribute(Trade::MeshAttribute::Bitangent);
+        _data->meshes[i].hasObjectIds = meshData.hasAttribute(Trade::MeshAttribute::ObjectId);
+        if(_data->meshes[i].hasObjectIds) {
+            _data->meshes[i].objectIdCount = Math::max(meshData.objectIdsAsArray());
         } else _data->meshes[i].objectIdCount = 0;
         _data->meshes[i].perVertexJointCount = perVertexJointCount.first();
         _data->meshes[i].secondaryPerVertexJointCount = perVertexJointCount.second();
-        _data->meshes[i].mesh = MeshTools::compile(*meshData, flags);
-        _data->meshes[i].name = Utility::move(meshName);
+        /* Needed for frustum culling */
+        if(meshData.hasAttribute(Trade::MeshAttribute::Position) && meshData.vertexCount()) {
+            Containers::Array<Vector3> positions = meshData.positions3DAsArray();
+            const Containers::Pair<Vector3, Vector3> minmax = Math::minmax(positions);
+            _data->meshes[i].bounds = Range3D{minmax.first(), minmax.second()};
+
+            #if defined(MAGNUM_TARGET_WEBGL) || defined(MAGNUM_TARGET_GLES2)
+            if(meshData.isIndexed() && meshData.primitive() == MeshPrimitive::Triangles && !perVertexJointCount.first() && !perVertexJointCount.second()) {
+                _data->meshes[i].wireframeIndices = meshData.indicesAsArray();
+                _data->meshes[i].wireframePositions = Utility::move(positions);
+                #ifndef MAGNUM_TARGET_GLES2
+                if(_data->meshes[i].hasObjectIds)
+                    _data->meshes[i].wireframeObjectIds = meshData.objectIdsAsArray();
+                #endif
+            }
+            #endif
+        }
+        /* Disable warnings on custom attributes, as we printed them with
+           actual string names above */
+        _data->meshes[i].mesh = MeshTools::compile(meshData, MeshTools::CompileFlag::NoWarnOnCustomAttributes);
+
+        /* Compile additional levels. Generate normals if the mesh has them
+           but the level doesn't and use the level only if it has all other
+           attributes the mesh has, as otherwise it'd render differently
+           with the shader picked for the mesh. */
+        for(Trade::MeshData& levelData: meshLevelData[i]) {
+            if(meshData.hasAttribute(Trade::MeshAttribute::Normal) &&
+               !levelData.hasAttribute(Trade::MeshAttribute::Normal) &&
+                levelData.hasAttribute(Trade::MeshAttribute::Position) &&
+                levelData.attributeFormat(Trade::MeshAttribute::Position) == VertexFormat::Vector3)
+                processMesh(levelData, levelData.isIndexed() ? NormalGeneration::Smooth : NormalGeneration::Flat);
+            if(optimizeMeshes)
+                packMesh(levelData);
+
+            bool compatible = true;
+            for(UnsignedInt j = 0; j != meshData.attributeCount(); ++j) {
+                if(!levelData.hasAttribute(meshData.attributeName(j))) {
+                    compatible = false;
+                    break;
+                }
+            }
+            if(!compatible) {
+                Warning{} << "Level" << _data->meshes[i].levels.size() + 1 << "of mesh" << _data->meshes[i].name << "doesn't have all attributes of the mesh, ignoring the remaining levels";
+                break;
+            }
+
+            arrayAppend(_data->meshes[i].levels, MeshTools::compile(levelData, MeshTools::CompileFlag::NoWarnOnCustomAttributes));
+        }
+        meshLevelData[i] = {};
+
+        _data->meshes[i].pointCloud = Utility::move(meshPointClouds[i]);
+
+        /* Free the CPU-side copy right after it's uploaded to not have all
+           of them in memory for longer than necessary */
+        meshes[i] = Containers::NullOpt;
     }
 
+    endLoadPhase("meshes"_s, phaseBegin);
+
     /* Load the scene. Save the object pointers in an array for easier mapping
        of animations later. */
     if((id < 0 && importer.sceneCount()) || id >= 0) {
@@ -1112,6 +2184,7 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
            !scene->is3D() ||
            !scene->hasField(Trade::SceneField::Parent)) {
             Error{} << "Cannot load the scene, aborting";
+            finishShaderCompilation();
             return;
         }
 
@@ -1188,7 +2261,7 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             arrayAppend(_data->lightColors, InPlaceInit, light->color()*light->intensity());
 
             /* Visualization of the center */
-            new FlatDrawable{*object, flatShader({}), _lightCenterMesh, objectId, light->color(), Vector3{0.25f}, nullptr, 0, 0, _data->objectVisualizationDrawables};
+            new FlatDrawable{*object, flatShader({}), _lightCenterMesh, objectId, light->color(), Vector3{0.25f}, nullptr, 0, 0, {}, {}, nullptr, _data->objectVisualizationDrawables};
 
             /* If the range is infinite, display it at distance = 5. It's not
                great as it's quite misleading, but better than nothing. */
@@ -1199,7 +2272,7 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
 
             /* Point light has a sphere around */
             if(light->type() == Trade::LightType::Point) {
-                new FlatDrawable{*object, flatShader({}), _lightSphereMesh, objectId, light->color(), Vector3{range}, nullptr, 0, 0, _data->objectVisualizationDrawables};
+                new FlatDrawable{*object, flatShader({}), _lightSphereMesh, objectId, light->color(), Vector3{range}, nullptr, 0, 0, {}, {}, nullptr, _data->objectVisualizationDrawables};
 
             /* Spotlight has a cone visualizing the inner angle and a circle at
                the end visualizing the outer angle */
@@ -1207,17 +2280,17 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
                 new FlatDrawable{*object, flatShader({}), _lightInnerConeMesh, objectId, light->color(),
                     Math::gather<'x', 'x', 'y'>(Vector2{
                         range*Math::tan(light->innerConeAngle()*0.5f), range
-                    }), nullptr, 0, 0, _data->objectVisualizationDrawables};
+                    }), nullptr, 0, 0, {}, {}, nullptr, _data->objectVisualizationDrawables};
                 new FlatDrawable{*object, flatShader({}), _lightOuterCircleMesh, objectId, light->color(),
                     Math::gather<'x', 'x', 'y'>(Vector2{
                         range*Math::tan(light->outerConeAngle()*0.5f), range
-                    }), nullptr, 0, 0, _data->objectVisualizationDrawables};
+                    }), nullptr, 0, 0, {}, {}, nullptr, _data->objectVisualizationDrawables};
 
             /* Directional has a circle and a line in its direction. The range
                is always infinite, so the line has always a length of 15. */
             } else if(light->type() == Trade::LightType::Directional) {
-                new FlatDrawable{*object, flatShader({}), _lightOuterCircleMesh, objectId, light->color(), Vector3{0.25f, 0.25f, 0.0f}, nullptr, 0, 0, _data->objectVisualizationDrawables};
-                new FlatDrawable{*object, flatShader({}), _lightDirectionMesh, objectId, light->color(), Vector3{5.0f}, nullptr, 0, 0, _data->objectVisualizationDrawables};
+                new FlatDrawable{*object, flatShader({}), _lightOuterCircleMesh, objectId, light->color(), Vector3{0.25f, 0.25f, 0.0f}, nullptr, 0, 0, {}, {}, nullptr, _data->objectVisualizationDrawables};
+                new FlatDrawable{*object, flatShader({}), _lightDirectionMesh, objectId, light->color(), Vector3{5.0f}, nullptr, 0, 0, {}, {}, nullptr, _data->objectVisualizationDrawables};
 
             /* Ambient lights are defined just by the center */
             } else if(light->type() == Trade::LightType::Ambient) {
@@ -1262,13 +2335,48 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
 
             if(_data->objects[i].lightId != 0xffffffffu) continue;
 
-            new FlatDrawable{*object, flatShader(Shaders::FlatGL3D::Flag::VertexColor), _axisMesh, UnsignedInt(i), 0xffffff_rgbf, Vector3{1.0f}, nullptr, 0, 0, _data->objectVisualizationDrawables};
+            new FlatDrawable{*object, flatShader(Shaders::FlatGL3D::Flag::VertexColor), _axisMesh, UnsignedInt(i), 0xffffff_rgbf, Vector3{1.0f}, nullptr, 0, 0, {}, {}, nullptr, _data->objectVisualizationDrawables};
+        }
+
+        /* Find meshes that are referenced only from non-skinned objects with
+           the same opaque material, or with no material at all. If there's
+           more than one such reference, the mesh is drawn instanced. Meshes
+           with per-vertex object IDs are excluded, as the instanced object ID
+           uses the same attribute. */
+        Containers::Array<Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>> meshesMaterials = scene->hasField(Trade::SceneField::Mesh) ? scene->meshesMaterialsAsArray() : Containers::Array<Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>>{};
+        for(Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial: meshesMaterials)
+            meshMaterial.second().first() = meshDuplicates[meshMaterial.second().first()];
+        constexpr Int MeshUnused = -2;
+        constexpr Int MeshNotInstanced = -3;
+        Containers::Array<Int> meshInstanceMaterials{DirectInit, _data->meshes.size(), MeshUnused};
+        Containers::Array<UnsignedInt> meshInstanceCounts{ValueInit, _data->meshes.size()};
+        Containers::Array<UnsignedInt> meshInstanceGroups{DirectInit, _data->meshes.size(), ~UnsignedInt{}};
+        for(const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial: meshesMaterials) {
+            const UnsignedInt objectId = meshMaterial.first();
+            const UnsignedInt meshId = meshMaterial.second().first();
+            Int materialId = meshMaterial.second().second();
+            const Containers::Optional<GL::Mesh>& mesh = _data->meshes[meshId].mesh;
+            if(!_data->objects[objectId].object || !mesh) continue;
+
+            if(materialId != -1 && !materials[materialId])
+                materialId = -1;
+            if(!_data->objects[objectId].skinJointMatrices.isEmpty() ||
+               _data->meshes[meshId].hasObjectIds ||
+               (mesh->primitive() != GL::MeshPrimitive::Triangles &&
+                mesh->primitive() != GL::MeshPrimitive::TriangleStrip &&
+                mesh->primitive() != GL::MeshPrimitive::TriangleFan) ||
+               (materialId != -1 && materials[materialId]->alphaMode() == Trade::MaterialAlphaMode::Blend) ||
+               (meshInstanceMaterials[meshId] != MeshUnused && meshInstanceMaterials[meshId] != materialId))
+                meshInstanceMaterials[meshId] = MeshNotInstanced;
+            else
+                meshInstanceMaterials[meshId] = materialId;
+            ++meshInstanceCounts[meshId];
         }
 
         /* Add drawables for objects that have a mesh, again ignoring objects
            that are not part of the hierarchy. There can be multiple mesh
            assignments for one object, simply add one drawable for each. */
-        if(scene->hasField(Trade::SceneField::Mesh)) for(const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial: scene->meshesMaterialsAsArray()) {
+        for(const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial: meshesMaterials) {
             const UnsignedInt objectId = meshMaterial.first();
             Object3D* const object = _data->objects[objectId].object;
             const UnsignedInt meshId = meshMaterial.second().first();
@@ -1282,22 +2390,43 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
 
             Containers::ArrayView<const Matrix4> skinJointMatrices = _data->objects[objectId].skinJointMatrices;
 
+            /* Skinned meshes get deformed by the joints, so their bounds
+               aren't known and they're never culled */
+            const Range3D* const bounds = skinJointMatrices.isEmpty() && _data->meshes[meshId].bounds ? &*_data->meshes[meshId].bounds : nullptr;
+
             Shaders::PhongGL::Flags flags;
             if(hasVertexColors[meshId])
                 flags |= Shaders::PhongGL::Flag::VertexColor;
             if(_data->meshes[meshId].hasSeparateBitangents)
                 flags |= Shaders::PhongGL::Flag::Bitangent;
 
+            /* If the mesh is drawn instanced, add just a drawable recording
+               the transformation to the instance group, creating the group on
+               first use */
+            const bool instanced = meshInstanceMaterials[meshId] != MeshNotInstanced && meshInstanceCounts[meshId] > 1;
+            const auto addPhongInstance = [&](const Shaders::PhongGL::Flags instanceFlags, const Color4& color, GL::Texture2D* const diffuseTexture, GL::Texture2D* const normalTexture, const Float normalTextureScale, const Float alphaMask, const Matrix3& textureMatrix) {
+                if(meshInstanceGroups[meshId] == ~UnsignedInt{}) {
+                    meshInstanceGroups[meshId] = _data->phongInstanceGroups.size();
+                    arrayAppend(_data->phongInstanceGroups, Containers::pointer<PhongInstanceGroup>(phongShader(instanceFlags|Shaders::PhongGL::Flag::InstancedTransformation|Shaders::PhongGL::Flag::InstancedObjectId), *mesh, color, diffuseTexture, normalTexture, normalTextureScale, alphaMask, textureMatrix, _shadeless));
+                }
+                new PhongInstanceDrawable{*object, *_data->phongInstanceGroups[meshInstanceGroups[meshId]], objectId, bounds, _data->opaqueDrawables};
+            };
+
             /* Material not available / not loaded. If the mesh has vertex
                colors, use that, otherwise apply a default material; use a flat
                shader for lines / points */
             if(materialId == -1 || !materials[materialId]) {
-                if(mesh->primitive() == GL::MeshPrimitive::Triangles ||
+                if(instanced)
+                    addPhongInstance(flags, 0xffffff_rgbf, nullptr, nullptr, 1.0f, 0.5f, {});
+                else if(mesh->primitive() == GL::MeshPrimitive::Triangles ||
                    mesh->primitive() == GL::MeshPrimitive::TriangleStrip ||
-                   mesh->primitive() == GL::MeshPrimitive::TriangleFan)
-                    new PhongDrawable{*object, phongShader(flags|(skinJointMatrices.isEmpty() ? Shaders::PhongGL::Flags{} : Shaders::PhongGL::Flag::DynamicPerVertexJointCount)), *mesh, objectId, 0xffffff_rgbf, skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount,  _shadeless, _data->opaqueDrawables};
-                else
-                    new FlatDrawable{*object, flatShader((hasVertexColors[meshId] ? Shaders::FlatGL3D::Flag::VertexColor : Shaders::FlatGL3D::Flags{})|(skinJointMatrices.isEmpty() ? Shaders::FlatGL3D::Flags{} : Shaders::FlatGL3D::Flag::DynamicPerVertexJointCount)), *mesh, objectId, 0xffffff_rgbf, Vector3{Constants::nan()}, skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount, _data->opaqueDrawables};
+                   mesh->primitive() == GL::MeshPrimitive::TriangleFan) {
+                    Shaders::PhongGL& shader = phongShader(flags|(skinJointMatrices.isEmpty() ? Shaders::PhongGL::Flags{} : Shaders::PhongGL::Flag::DynamicPerVertexJointCount));
+                    new PhongDrawable{*object, shader, *mesh, objectId, 0xffffff_rgbf, skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount, _data->meshes[meshId].levels, _data->meshes[meshId].pointCloud, bounds, _shadeless, opaqueDrawablesFor(shader)};
+                } else {
+                    Shaders::FlatGL3D& shader = flatShader((hasVertexColors[meshId] ? Shaders::FlatGL3D::Flag::VertexColor : Shaders::FlatGL3D::Flags{})|(skinJointMatrices.isEmpty() ? Shaders::FlatGL3D::Flags{} : Shaders::FlatGL3D::Flag::DynamicPerVertexJointCount));
+                    new FlatDrawable{*object, shader, *mesh, objectId, 0xffffff_rgbf, Vector3{Constants::nan()}, skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount, _data->meshes[meshId].levels, _data->meshes[meshId].pointCloud, bounds, opaqueDrawablesFor(shader)};
+                }
 
             /* Material available */
             } else {
@@ -1342,12 +2471,18 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
                     }
                 }
 
-                new PhongDrawable{*object, phongShader(flags|(skinJointMatrices.isEmpty() ? Shaders::PhongGL::Flags{} : Shaders::PhongGL::Flag::DynamicPerVertexJointCount)),
-                    *mesh, objectId,
+                if(instanced) addPhongInstance(flags,
                     material.diffuseColor(), diffuseTexture, normalTexture, normalTextureScale,
-                    material.alphaMask(), material.commonTextureMatrix(), skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount, _shadeless,
-                    material.alphaMode() == Trade::MaterialAlphaMode::Blend ?
-                        _data->transparentDrawables : _data->opaqueDrawables};
+                    material.alphaMask(), material.commonTextureMatrix());
+                else {
+                    Shaders::PhongGL& shader = phongShader(flags|(skinJointMatrices.isEmpty() ? Shaders::PhongGL::Flags{} : Shaders::PhongGL::Flag::DynamicPerVertexJointCount));
+                    new PhongDrawable{*object, shader,
+                        *mesh, objectId,
+                        material.diffuseColor(), diffuseTexture, normalTexture, normalTextureScale,
+                        material.alphaMask(), material.commonTextureMatrix(), skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount, _data->meshes[meshId].levels, _data->meshes[meshId].pointCloud, bounds, _shadeless,
+                        material.alphaMode() == Trade::MaterialAlphaMode::Blend ?
+                            _data->transparentDrawables : opaqueDrawablesFor(shader)};
+                }
             }
         }
 
@@ -1360,10 +2495,14 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         _data->objects[0].object = &_data->scene;
         _data->objects[0].meshId = 0;
         _data->objects[0].name = "object #0";
-        new PhongDrawable{_data->scene, phongShader(hasVertexColors[0] ? Shaders::PhongGL::Flag::VertexColor : Shaders::PhongGL::Flags{}), *_data->meshes[0].mesh, 0, 0xffffff_rgbf, nullptr, 0, 0, _shadeless, _data->opaqueDrawables};
+        Shaders::PhongGL& shader = phongShader(hasVertexColors[0] ? Shaders::PhongGL::Flag::VertexColor : Shaders::PhongGL::Flags{});
+        new PhongDrawable{_data->scene, shader, *_data->meshes[0].mesh, 0, 0xffffff_rgbf, nullptr, 0, 0, _data->meshes[0].levels, _data->meshes[0].pointCloud, _data->meshes[0].bounds ? &*_data->meshes[0].bounds : nullptr, _shadeless, opaqueDrawablesFor(shader)};
     }
 
-    /* Add joint drawables for all skins to fill the skinJointMatrices array */
+    /* Gather joints of all skins to fill the skinJointMatrices array */
+    _data->jointObjects.reserve(totalJointCount);
+    arrayReserve(_data->jointInverseBindMatrices, totalJointCount);
+    arrayReserve(_data->jointMatrixIds, totalJointCount);
     for(std::size_t i = 0; i != skins.size(); ++i) {
         if(!skins[i].skin) continue;
 
@@ -1377,7 +2516,9 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
                 continue;
             }
 
-            new JointDrawable{*objectInfo.object, skinInfo.skin->inverseBindMatrices()[j], _data->skinJointMatrices[skinInfo.offset + j], _data->jointDrawables};
+            _data->jointObjects.emplace_back(*objectInfo.object);
+            arrayAppend(_data->jointInverseBindMatrices, skinInfo.skin->inverseBindMatrices()[j]);
+            arrayAppend(_data->jointMatrixIds, UnsignedInt(skinInfo.offset + j));
         }
     }
 
@@ -1411,7 +2552,9 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         });
     }
 
-    /* Initialize light colors for all instantiated shaders */
+    /* All shaders needed by the scene are known at this point, wait for them
+       to get compiled and then initialize light colors for all of them */
+    finishShaderCompilation();
     updateLightColorBrightness();
 
     /* Basic camera setup */
@@ -1420,12 +2563,6 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         .setProjectionMatrix(Matrix4::perspectiveProjection(75.0_degf, 1.0f, 0.01f, 1000.0f))
         .setViewport(GL::defaultFramebuffer.viewport().size());
 
-    /* A second camera, positioned in the root, for "drawing" joint positions
-       that have to be relative to scene root */
-    /** @todo eugh, drop the whole scenegraph instead */
-    _data->rootCameraObject = new Object3D{&_data->scene};
-    _data->rootCamera = new SceneGraph::Camera3D{*_data->rootCameraObject};
-
     /* Use the settings with parameters of the camera in the model, if any,
        otherwise just used the hardcoded setup from above */
     if(importer.cameraCount()) {
@@ -1433,6 +2570,8 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         if(camera) _data->camera->setProjectionMatrix(Matrix4::perspectiveProjection(camera->fov(), 1.0f, camera->near(), camera->far()));
     }
 
+    endLoadPhase("scene"_s, phaseBegin);
+
     /* Import animations */
     if(importer.animationCount())
         Debug{} << "Importing the first animation out of" << importer.animationCount();
@@ -1443,56 +2582,125 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             continue;
         }
 
+        /* Assign a slot in the animated object array to every object that's
+           targeted by some track. The array has to be allocated upfront as
+           the player references its contents. */
+        Containers::Array<UnsignedInt> animatedObjectIds{DirectInit, _data->objects.size(), ~UnsignedInt{}};
+        std::size_t animatedObjectCount = 0;
+        for(UnsignedInt j = 0; j != animation->trackCount(); ++j) {
+            const UnsignedInt target = animation->trackTarget(j);
+            if(target >= _data->objects.size() || !_data->objects[target].object || animatedObjectIds[target] != ~UnsignedInt{})
+                continue;
+            animatedObjectIds[target] = animatedObjectCount++;
+        }
+        _data->animatedObjects = Containers::Array<AnimatedObjectInfo>{NoInit, animatedObjectCount};
+        for(std::size_t j = 0; j != animatedObjectIds.size(); ++j) {
+            if(animatedObjectIds[j] == ~UnsignedInt{}) continue;
+
+            /* Tracks that aren't present keep the original transformation */
+            Object3D& object = *_data->objects[j].object;
+            _data->animatedObjects[animatedObjectIds[j]] = {&object, object.translation(), object.rotation(), object.scaling()};
+        }
+
+        /* If requested, resample all tracks at a fixed rate. The frames are
+           first filled with the original transformation, then the tracks
+           overwrite the properties they animate. */
+        BakedAnimation& baked = _data->bakedAnimation;
+        if(_animationBakeRate > 0.0f && animatedObjectCount) {
+            baked.begin = animation->duration().min();
+            baked.rate = _animationBakeRate;
+            baked.frameCount = UnsignedInt(Math::ceil(animation->duration().size()*baked.rate)) + 1;
+            Debug{} << "Baking" << animation->trackCount() << "animation tracks into" << baked.frameCount << "frames at" << baked.rate << "FPS";
+
+            baked.translations = Containers::Array<Vector3>{NoInit, baked.frameCount*animatedObjectCount};
+            baked.rotations = Containers::Array<Quaternion>{NoInit, baked.frameCount*animatedObjectCount};
+            baked.scalings = Containers::Array<Vector3>{NoInit, baked.frameCount*animatedObjectCount};
+            for(std::size_t frame = 0; frame != baked.frameCount; ++frame) {
+                for(std::size_t j = 0; j != animatedObjectCount; ++j) {
+                    baked.translations[frame*animatedObjectCount + j] = _data->animatedObjects[j].translation;
+                    baked.rotations[frame*animatedObjectCount + j] = _data->animatedObjects[j].rotation;
+                    baked.scalings[frame*animatedObjectCount + j] = _data->animatedObjects[j].scaling;
+                }
+            }
+        }
+
         for(UnsignedInt j = 0; j != animation->trackCount(); ++j) {
             if(animation->trackTarget(j) >= _data->objects.size() || !_data->objects[animation->trackTarget(j)].object)
                 continue;
 
-            Object3D& animatedObject = *_data->objects[animation->trackTarget(j)].object;
+            const UnsignedInt animatedObjectId = animatedObjectIds[animation->trackTarget(j)];
+            AnimatedObjectInfo& animatedObject = _data->animatedObjects[animatedObjectId];
+
+            /* Column of the baked values corresponding to this object, empty
+               if not baking */
+            Containers::StridedArrayView1D<Vector3> bakedTranslations, bakedScalings;
+            Containers::StridedArrayView1D<Quaternion> bakedRotations;
+            if(baked.frameCount) {
+                bakedTranslations = Containers::stridedArrayView(baked.translations).exceptPrefix(animatedObjectId).every(animatedObjectCount);
+                bakedRotations = Containers::stridedArrayView(baked.rotations).exceptPrefix(animatedObjectId).every(animatedObjectCount);
+                bakedScalings = Containers::stridedArrayView(baked.scalings).exceptPrefix(animatedObjectId).every(animatedObjectCount);
+            }
 
             if(animation->trackTargetName(j) == Trade::AnimationTrackTarget::Translation3D) {
-                const auto callback = [](Float, const Vector3& translation, Object3D& object) {
-                    object.setTranslation(translation);
-                };
                 if(animation->trackType(j) == Trade::AnimationTrackType::CubicHermite3D) {
-                    _data->player.addWithCallback(animation->track<CubicHermite3D>(j),
-                        callback, animatedObject);
+                    addAnimationTrack(_data->player, animation->track<CubicHermite3D>(j),
+                        animatedObject.translation, baked, bakedTranslations);
                 } else {
                     CORRADE_INTERNAL_ASSERT(animation->trackType(j) == Trade::AnimationTrackType::Vector3);
-                    _data->player.addWithCallback(animation->track<Vector3>(j),
-                        callback, animatedObject);
+                    addAnimationTrack(_data->player, animation->track<Vector3>(j),
+                        animatedObject.translation, baked, bakedTranslations);
                 }
             } else if(animation->trackTargetName(j) == Trade::AnimationTrackTarget::Rotation3D) {
-                const auto callback = [](Float, const Quaternion& rotation, Object3D& object) {
-                    object.setRotation(rotation);
-                };
                 if(animation->trackType(j) == Trade::AnimationTrackType::CubicHermiteQuaternion) {
-                    _data->player.addWithCallback(animation->track<CubicHermiteQuaternion>(j),
-                        callback, animatedObject);
+                    addAnimationTrack(_data->player, animation->track<CubicHermiteQuaternion>(j),
+                        animatedObject.rotation, baked, bakedRotations);
                 } else {
                     CORRADE_INTERNAL_ASSERT(animation->trackType(j) == Trade::AnimationTrackType::Quaternion);
-                    _data->player.addWithCallback(animation->track<Quaternion>(j),
-                        callback, animatedObject);
+                    addAnimationTrack(_data->player, animation->track<Quaternion>(j),
+                        animatedObject.rotation, baked, bakedRotations);
                 }
             } else if(animation->trackTargetName(j) == Trade::AnimationTrackTarget::Scaling3D) {
-                const auto callback = [](Float, const Vector3& scaling, Object3D& object) {
-                    object.setScaling(scaling);
-                };
                 if(animation->trackType(j) == Trade::AnimationTrackType::CubicHermite3D) {
-                    _data->player.addWithCallback(animation->track<CubicHermite3D>(j),
-                        callback, animatedObject);
+                    addAnimationTrack(_data->player, animation->track<CubicHermite3D>(j),
+                        animatedObject.scaling, baked, bakedScalings);
                 } else {
                     CORRADE_INTERNAL_ASSERT(animation->trackType(j) == Trade::AnimationTrackType::Vector3);
-                    _data->player.addWithCallback(animation->track<Vector3>(j),
-                        callback, animatedObject);
+                    addAnimationTrack(_data->player, animation->track<Vector3>(j),
+                        animatedObject.scaling, baked, bakedScalings);
                 }
             } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
         }
-        _data->animationData = animation->release();
+
+        /* Baked animation is driven by a single track that passes the time
+           to the callback, the imported data aren't needed anymore */
+        if(baked.frameCount) {
+            baked.time[0] = {animation->duration().min(), animation->duration().min()};
+            baked.time[1] = {animation->duration().max(), animation->duration().max()};
+            _data->player.addWithCallback(Animation::TrackView<const Float, const Float>{baked.time, Math::lerp, Animation::Extrapolation::Constant}, [](Float time, const Float&, Data& data) {
+                applyBakedAnimation(data.bakedAnimation, data.animatedObjects, time);
+            }, *_data);
+        } else _data->animationData = animation->release();
 
         /* Load only the first animation at the moment */
         break;
     }
 
+    endLoadPhase("animations"_s, phaseBegin);
+
+    /* Bake absolute transformations of objects that aren't animated for
+       drawing the opaque drawables from flat lists */
+    {
+        std::unordered_set<const SceneGraph::AbstractObject3D*> animatedObjects;
+        for(const AnimatedObjectInfo& animatedObject: _data->animatedObjects)
+            animatedObjects.insert(animatedObject.object);
+        _data->opaqueFlatDrawablesByShader = Containers::Array<FlatDrawableList>{_data->opaqueDrawablesByShader.size()};
+        for(std::size_t i = 0; i != _data->opaqueDrawablesByShader.size(); ++i)
+            populateFlatDrawables(animatedObjects, *_data->opaqueDrawablesByShader[i].second(), _data->opaqueFlatDrawablesByShader[i]);
+        populateFlatDrawables(animatedObjects, _data->opaqueDrawables, _data->opaqueFlatDrawables);
+    }
+
+    endLoadPhase("flat drawables"_s, phaseBegin);
+
     /* Populate the model info */
     _modelInfo.setText(Containers::ArrayView<const char>{Utility::format(
         "{}: {} objs, {} cams, {} meshes, {} mats, {}/{} texs, {} anims",
@@ -1527,7 +2735,81 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
     }
 }
 
+void ScenePlayer::endLoadPhase(const Containers::StringView name, std::chrono::steady_clock::time_point& begin) {
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    arrayAppend(_loadPhaseDurations, InPlaceInit, name, end - begin);
+    begin = end;
+}
+
+bool ScenePlayer::benchmark(const UnsignedInt frameCount, const bool orbit) {
+    CORRADE_INTERNAL_ASSERT(_data && frameCount);
+    _benchmarkFrameCount = frameCount;
+    _benchmarkOrbit = orbit;
+
+    /* Keep all frames in the profiler to calculate percentiles from. The
+       stage profiler isn't needed for the benchmark output. */
+    _profiler = DebugTools::FrameProfilerGL{_profiler.values(), frameCount};
+
+    /* Restart the animation so each run covers the same time range */
+    if(!_data->player.isEmpty()) {
+        _data->player.stop();
+        _data->player.play(std::chrono::system_clock::now().time_since_epoch());
+    }
+
+    redraw();
+    return true;
+}
+
+void ScenePlayer::advanceBenchmark() {
+    /* Orbit the camera around the scene origin, doing a full revolution over
+       all benchmarked frames */
+    if(_benchmarkOrbit) {
+        const Quaternion rotation = Quaternion::rotation(Rad{Constants::tau()/_benchmarkFrameCount}, Vector3::yAxis());
+        (*_data->cameraObject)
+            .setRotation(rotation*_data->cameraObject->rotation())
+            .setTranslation(rotation.transformVector(_data->cameraObject->translation()));
+    }
+
+    /* Wait until all frames have their measurements available, GPU queries
+       are retrieved with a delay */
+    UnsignedInt maxDelay = 0;
+    for(UnsignedInt i = 0; i != _profiler.measurementCount(); ++i)
+        maxDelay = Math::max(maxDelay, _profiler.measurementDelay(i));
+    if(_profiler.measuredFrameCount() < _benchmarkFrameCount + maxDelay)
+        return;
+
+    /* Print the statistics as a single JSON line so it can be picked up by
+       scripts. Durations are in nanoseconds, ratios multiplied by 1000 as
+       stored by the profiler. */
+    Containers::String out = "{\"frames\":"_s + Utility::format("{}", _benchmarkFrameCount) + ",\"load\":{"_s;
+    for(std::size_t i = 0; i != _loadPhaseDurations.size(); ++i)
+        out = out + Utility::format("{}\"{}\":{}", i ? "," : "",
+            _loadPhaseDurations[i].first(),
+            UnsignedLong(std::chrono::duration_cast<std::chrono::nanoseconds>(_loadPhaseDurations[i].second()).count()));
+    out = out + "},\"measurements\":{"_s;
+    for(UnsignedInt i = 0; i != _profiler.measurementCount(); ++i) {
+        Containers::Array<UnsignedLong> data{NoInit, _benchmarkFrameCount};
+        UnsignedLong sum = 0;
+        for(UnsignedInt j = 0; j != _benchmarkFrameCount; ++j)
+            sum += data[j] = _profiler.measurementData(i, j);
+        std::sort(data.begin(), data.end());
+        out = out + Utility::format("{}\"{}\":{{\"mean\":{},\"p95\":{},\"p99\":{},\"max\":{}}}",
+            i ? "," : "",
+            _profiler.measurementName(i),
+            sum/_benchmarkFrameCount,
+            data[(_benchmarkFrameCount - 1)*95/100],
+            data[(_benchmarkFrameCount - 1)*99/100],
+            data.back());
+    }
+    out = out + "}}"_s;
+    Debug{} << out;
+
+    application().exit(0);
+}
+
 void FlatDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
+    if(!isInsideFrustum(_bounds, transformationMatrix, camera)) return;
+
     /* Override the inherited scale, if requested */
     Matrix4 transformation;
     if(_scale == _scale) transformation =
@@ -1551,10 +2833,48 @@ void FlatDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3
             #endif
         );
 
-    _shader.draw(_mesh);
+    drawMesh(_shader, _mesh, _levels, _pointCloud, _bounds, transformationMatrix, camera);
+}
+
+namespace {
+
+/* The draw is a function as it's either the whole mesh, a selected mesh level
+   or a set of point cloud nodes */
+template<class Draw> void drawPhongMaterial(Shaders::PhongGL& shader, const Draw& draw, const Color4& color, GL::Texture2D* const diffuseTexture, GL::Texture2D* const normalTexture, const Float normalTextureScale, const Float alphaMask, const Matrix3& textureMatrix, const bool shadeless) {
+    if(diffuseTexture) shader
+        .bindAmbientTexture(*diffuseTexture)
+        .bindDiffuseTexture(*diffuseTexture);
+    if(normalTexture) shader
+        .bindNormalTexture(*normalTexture)
+        .setNormalTextureScale(normalTextureScale);
+
+    if(shadeless) shader
+        .setAmbientColor(color)
+        .setDiffuseColor(0x00000000_rgbaf)
+        .setSpecularColor(0x00000000_rgbaf);
+    else shader
+        .setAmbientColor(color*0.06f)
+        .setDiffuseColor(color)
+        .setSpecularColor(0x11111100_rgbaf);
+
+    if(shader.flags() & Shaders::PhongGL::Flag::TextureTransformation)
+        shader.setTextureMatrix(textureMatrix);
+    if(shader.flags() & Shaders::PhongGL::Flag::AlphaMask)
+        shader.setAlphaMask(alphaMask);
+    if(shader.flags() & Shaders::PhongGL::Flag::DoubleSided)
+        GL::Renderer::disable(GL::Renderer::Feature::FaceCulling);
+
+    draw();
+
+    if(shader.flags() & Shaders::PhongGL::Flag::DoubleSided)
+        GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
+}
+
 }
 
 void PhongDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
+    if(!isInsideFrustum(_bounds, transformationMatrix, camera)) return;
+
     /* If the mesh is skinned, its root-relative transformation is coming fully
        from the joint transforms alone, thus we only need the camera-relative
        transform here. Transformation of the object is used only for
@@ -1584,33 +2904,41 @@ void PhongDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera
             #endif
         );
 
-    if(_diffuseTexture) _shader
-        .bindAmbientTexture(*_diffuseTexture)
-        .bindDiffuseTexture(*_diffuseTexture);
-    if(_normalTexture) _shader
-        .bindNormalTexture(*_normalTexture)
-        .setNormalTextureScale(_normalTextureScale);
-
-    if(_shadeless) _shader
-        .setAmbientColor(_color)
-        .setDiffuseColor(0x00000000_rgbaf)
-        .setSpecularColor(0x00000000_rgbaf);
-    else _shader
-        .setAmbientColor(_color*0.06f)
-        .setDiffuseColor(_color)
-        .setSpecularColor(0x11111100_rgbaf);
+    drawPhongMaterial(_shader, [&]() {
+        drawMesh(_shader, _mesh, _levels, _pointCloud, _bounds, transformationMatrix, camera);
+    }, _color, _diffuseTexture, _normalTexture, _normalTextureScale, _alphaMask, _textureMatrix, _shadeless);
+}
 
-    if(_shader.flags() & Shaders::PhongGL::Flag::TextureTransformation)
-        _shader.setTextureMatrix(_textureMatrix);
-    if(_shader.flags() & Shaders::PhongGL::Flag::AlphaMask)
-        _shader.setAlphaMask(_alphaMask);
-    if(_shader.flags() & Shaders::PhongGL::Flag::DoubleSided)
-        GL::Renderer::disable(GL::Renderer::Feature::FaceCulling);
+PhongInstanceGroup::PhongInstanceGroup(Shaders::PhongGL& shader, GL::Mesh& mesh, const Color4& color, GL::Texture2D* diffuseTexture, GL::Texture2D* normalTexture, Float normalTextureScale, Float alphaMask, const Matrix3& textureMatrix, const bool& shadeless): _shader(shader), _mesh(mesh), _color{color}, _diffuseTexture{diffuseTexture}, _normalTexture{normalTexture}, _normalTextureScale{normalTextureScale}, _alphaMask{alphaMask}, _textureMatrix{textureMatrix}, _shadeless(shadeless) {
+    _mesh.addVertexBufferInstanced(_instanceBuffer, 1, 0,
+        Shaders::PhongGL::TransformationMatrix{},
+        Shaders::PhongGL::NormalMatrix{},
+        Shaders::PhongGL::ObjectId{});
+}
 
-    _shader.draw(_mesh);
+void PhongInstanceGroup::draw(SceneGraph::Camera3D& camera) {
+    if(_instances.isEmpty()) return;
 
-    if(_shader.flags() & Shaders::PhongGL::Flag::DoubleSided)
-        GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
+    /* The per-instance transformations get multiplied with the uniforms and
+       the per-instance ID added to the uniform one, so reset them to an
+       identity */
+    _instanceBuffer.setData(_instances, GL::BufferUsage::DynamicDraw);
+    _shader
+        .setTransformationMatrix({})
+        .setNormalMatrix({})
+        .setProjectionMatrix(camera.projectionMatrix())
+        .setObjectId(0);
+
+    /* The mesh can be drawn non-instanced from elsewhere as well, such as
+       for the selected object visualization, so set the instance count only
+       for the duration of the draw */
+    _mesh.setInstanceCount(_instances.size());
+    drawPhongMaterial(_shader, [&]() {
+        _shader.draw(_mesh);
+    }, _color, _diffuseTexture, _normalTexture, _normalTextureScale, _alphaMask, _textureMatrix, _shadeless);
+    _mesh.setInstanceCount(1);
+
+    arrayClear(_instances);
 }
 
 void MeshVisualizerDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
@@ -1668,14 +2996,76 @@ void MeshVisualizerDrawable::draw(const Matrix4& transformationMatrix, SceneGrap
             #endif
         );
 
-    _shader->draw(_mesh);
+    /* Vertex ID visualization would show the IDs of the duplicated vertices
+       with the non-indexed mesh, so it uses the original one */
+    if(_wireframeMesh && (_shader->flags() & Shaders::MeshVisualizerGL3D::Flag::Wireframe) && !(_shader->flags() & Shaders::MeshVisualizerGL3D::Flag::VertexId))
+        _shader->draw(*_wireframeMesh);
+    else
+        _shader->draw(_mesh);
 
     GL::Renderer::setPolygonOffset(0.0f, 0.0f);
     GL::Renderer::disable(GL::Renderer::Feature::PolygonOffsetFill);
 }
 
+void ScenePlayer::endProfiledStage(const ProfiledStage stage, std::chrono::steady_clock::time_point& begin) {
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    _stageDurations[UnsignedInt(stage)] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    if(_stageProfiler.isEnabled())
+        arrayAppend(_traceEvents, InPlaceInit, stage, begin, end);
+    #endif
+    begin = end;
+}
+
+void ScenePlayer::printProfilerStatistics() {
+    if(!_profiler.isEnabled() || _profiler.measuredFrameCount() % 10 != 0)
+        return;
+
+    /* Not using FrameProfiler::printStatistics() as each of the two
+       profilers would scroll back just over its own output on a TTY,
+       print both at once instead */
+    if(Debug::isTty() && _profiler.measuredFrameCount() > 10)
+        _profilerOut << Debug::nospace << "\033[" << Debug::nospace << (_profiler.measurementCount() + _stageProfiler.measurementCount() + 2) << Debug::nospace << "A\033[J" << Debug::nospace;
+    _profilerOut << _profiler.statistics() << Debug::newline
+        << _stageProfiler.statistics() << Debug::newline;
+}
+
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void ScenePlayer::saveProfilerTrace() {
+    if(_traceEvents.isEmpty()) return;
+
+    /* Chrome trace event format, viewable in chrome://tracing or Perfetto,
+       with timestamps and durations in microseconds */
+    Containers::Array<char> out;
+    arrayAppend(out, "{\"traceEvents\":[\n"_s);
+    for(std::size_t i = 0; i != _traceEvents.size(); ++i) {
+        const ProfiledStageEvent& event = _traceEvents[i];
+        arrayAppend(out, Utility::format("{}{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":{},\"dur\":{}}}",
+            i ? ",\n" : "",
+            ProfiledStageNames[UnsignedInt(event.stage)],
+            UnsignedLong(std::chrono::duration_cast<std::chrono::microseconds>(event.begin - _traceBegin).count()),
+            UnsignedLong(std::chrono::duration_cast<std::chrono::microseconds>(event.end - event.begin).count())));
+    }
+    arrayAppend(out, "\n]}\n"_s);
+
+    const Containers::StringView filename = "magnum-player-trace.json"_s;
+    if(Utility::Path::write(filename, out))
+        Debug{} << "Saved a trace of" << _traceEvents.size() << "profiled stages to" << filename;
+    arrayClear(_traceEvents);
+}
+#endif
+
 void ScenePlayer::drawEvent() {
     _profiler.beginFrame();
+    _stageProfiler.beginFrame();
+    for(UnsignedLong& duration: _stageDurations) duration = 0;
+
+    /* Apply a selection requested in a previous frame if it's done already,
+       so it's drawn right in this frame */
+    #ifndef MAGNUM_TARGET_GLES
+    if(_data)
+        resolveSelectionProbes();
+    #endif
 
     /* Another FB could be bound from a depth / object ID read (moreover with
        color output disabled), set it back to the default framebuffer */
@@ -1687,25 +3077,54 @@ void ScenePlayer::drawEvent() {
     GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
 
     if(_data) {
+        std::chrono::steady_clock::time_point stageBegin = std::chrono::steady_clock::now();
+
         _data->player.advance(std::chrono::system_clock::now().time_since_epoch());
 
+        /* Apply the animated values to the objects */
+        for(const AnimatedObjectInfo& animatedObject: _data->animatedObjects)
+            animatedObject.object->setTranslation(animatedObject.translation)
+                .setRotation(animatedObject.rotation)
+                .setScaling(animatedObject.scaling);
+        endProfiledStage(ProfiledStage::Animation, stageBegin);
+
         /* Calculate light positions first, upload them to all shaders -- all
            of them are there only if they are actually used, so it's not doing
-           any wasteful work */
+           any wasteful work. If the camera and lights didn't move and no new
+           shader got created since the last time, there's nothing to
+           upload. */
         arrayClear(_data->lightPositions);
         _data->camera->draw(_data->lightDrawables);
         CORRADE_INTERNAL_ASSERT(_data->lightPositions.size() == _data->lightCount);
-        for(auto&& shader: _phongShaders)
-            shader.second.setLightPositions(_data->lightPositions);
+        bool lightPositionsChanged =
+            _data->uploadedLightPositionsShaderCount != _phongShaders.size() ||
+            _data->uploadedLightPositions.size() != _data->lightPositions.size();
+        for(std::size_t i = 0; !lightPositionsChanged && i != _data->lightPositions.size(); ++i)
+            lightPositionsChanged = _data->uploadedLightPositions[i] != _data->lightPositions[i];
+        if(lightPositionsChanged) {
+            for(auto&& shader: _phongShaders)
+                shader.second.setLightPositions(_data->lightPositions);
+            arrayResize(_data->uploadedLightPositions, NoInit, _data->lightPositions.size());
+            Utility::copy(_data->lightPositions, _data->uploadedLightPositions);
+            _data->uploadedLightPositionsShaderCount = _phongShaders.size();
+        }
+        endProfiledStage(ProfiledStage::Lights, stageBegin);
 
         /* Calculate animated joint positions, filling the
            _data->skinJointMatrices with them, which is then referenced by
-           skinned meshes. These should be relative to scene root so it's drawn
-           with a camera that has an identity transformation. */
-        _data->rootCamera->draw(_data->jointDrawables);
+           skinned meshes. These should be relative to scene root. The
+           hierarchy is traversed just once for all joints, with shared
+           parent transformations calculated only once. */
+        if(!_data->jointObjects.empty()) {
+            const std::vector<Matrix4> jointTransformations = _data->scene.transformationMatrices(_data->jointObjects);
+            for(std::size_t i = 0; i != jointTransformations.size(); ++i)
+                _data->skinJointMatrices[_data->jointMatrixIds[i]] = jointTransformations[i]*_data->jointInverseBindMatrices[i];
+        }
+        endProfiledStage(ProfiledStage::Joints, stageBegin);
 
         /* Draw opaque stuff as usual */
-        _data->camera->draw(_data->opaqueDrawables);
+        drawOpaque();
+        endProfiledStage(ProfiledStage::Opaque, stageBegin);
 
         /* Draw transparent stuff back-to-front with blending enabled */
         if(!_data->transparentDrawables.isEmpty()) {
@@ -1714,19 +3133,13 @@ void ScenePlayer::drawEvent() {
             /* Ugh non-premultiplied alpha */
             GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::SourceAlpha, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
 
-            std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>>
-                drawableTransformations = _data->camera->drawableTransformations(_data->transparentDrawables);
-            std::sort(drawableTransformations.begin(), drawableTransformations.end(),
-                [](const std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& a,
-                   const std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& b) {
-                    return a.second.translation().z() > b.second.translation().z();
-                });
-            _data->camera->draw(drawableTransformations);
+            drawTransparent();
 
             GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::Zero);
             GL::Renderer::disable(GL::Renderer::Feature::Blending);
             GL::Renderer::setDepthMask(true);
         }
+        endProfiledStage(ProfiledStage::Transparent, stageBegin);
 
         /* Draw selected object. This needs a depth buffer test again in order
            to correctly order the tangent space visualizers. */
@@ -1747,11 +3160,46 @@ void ScenePlayer::drawEvent() {
             _data->camera->draw(_data->objectVisualizationDrawables);
             GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
         }
+        endProfiledStage(ProfiledStage::Visualization, stageBegin);
+    }
+
+    /* Read the depth around the last pointer position for use by the next
+       depthAt() call, without waiting for it to finish */
+    #ifndef MAGNUM_TARGET_GLES
+    if(_data && !Math::isNan(_lastPosition).all()) {
+        DepthProbe& probe = _depthProbes[_nextDepthProbe];
+        _nextDepthProbe = (_nextDepthProbe + 1) % Containers::arraySize(_depthProbes);
+        if(probe.fence)
+            glDeleteSync(probe.fence);
+        GL::defaultFramebuffer.mapForRead(GL::DefaultFramebuffer::ReadAttachment::Back)
+            .read(depthAreaAt(_lastPosition), probe.image, GL::BufferUsage::StreamRead);
+        probe.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        probe.windowPosition = _lastPosition;
+    }
+    #endif
+
+    /* Generate deferred texture mip levels, at most TextureMipmapBudget bytes
+       of base levels per frame but at least one texture. Until then the
+       textures are sampled just from their base level. */
+    if(_data && !_data->texturesPendingMipmaps.isEmpty()) {
+        std::size_t size = 0;
+        while(!_data->texturesPendingMipmaps.isEmpty() && size < TextureMipmapBudget) {
+            const Containers::Pair<UnsignedInt, std::size_t>& pending = _data->texturesPendingMipmaps.back();
+            generateDeferredMipmap(*_data->textures[pending.first()]);
+            size += pending.second();
+            arrayRemoveSuffix(_data->texturesPendingMipmaps);
+        }
+        if(!_data->texturesPendingMipmaps.isEmpty())
+            redraw();
     }
 
     /* Don't profile UI drawing */
     _profiler.endFrame();
-    _profiler.printStatistics(_profilerOut, 10);
+    _stageProfiler.endFrame();
+    if(_benchmarkFrameCount) {
+        advanceBenchmark();
+        redraw();
+    } else printProfilerStatistics();
 
     /* Schedule a redraw only if profiling is enabled or the player is playing
        to avoid hogging the CPU */
@@ -1776,12 +3224,19 @@ void ScenePlayer::viewportEvent(ViewportEvent& event) {
     _selectionDepth = GL::Renderbuffer{};
     _selectionDepth.setStorage(GL::RenderbufferFormat::DepthComponent24, event.framebufferSize());
     _selectionObjectId = GL::Renderbuffer{};
-    _selectionObjectId.setStorage(GL::RenderbufferFormat::R16UI, event.framebufferSize());
+    _selectionObjectId.setStorage(GL::RenderbufferFormat::R32UI, event.framebufferSize());
     _selectionFramebuffer
         .attachRenderbuffer(GL::Framebuffer::BufferAttachment::Depth, _selectionDepth)
         .attachRenderbuffer(GL::Framebuffer::ColorAttachment{1}, _selectionObjectId)
         .setViewport({{}, event.framebufferSize()});
 
+    /* Depth probes were done for a different framebuffer size, don't use
+       them anymore */
+    #ifndef MAGNUM_TARGET_GLES
+    for(DepthProbe& probe: _depthProbes)
+        probe.windowPosition = Vector2{Constants::nan()};
+    #endif
+
     /* Recreate depth reading textures and renderbuffers that depend on
        viewport size */
     #ifdef MAGNUM_TARGET_WEBGL
@@ -1800,15 +3255,117 @@ void ScenePlayer::viewportEvent(ViewportEvent& event) {
     #endif
 }
 
-Float ScenePlayer::depthAt(const Vector2& windowPosition) {
+SceneGraph::DrawableGroup3D& ScenePlayer::opaqueDrawablesFor(GL::AbstractShaderProgram& shader) {
+    for(Containers::Pair<UnsignedInt, Containers::Pointer<SceneGraph::DrawableGroup3D>>& group: _data->opaqueDrawablesByShader)
+        if(group.first() == shader.id()) return *group.second();
+
+    return *arrayAppend(_data->opaqueDrawablesByShader, InPlaceInit, shader.id(), Containers::pointer<SceneGraph::DrawableGroup3D>()).second();
+}
+
+void ScenePlayer::populateFlatDrawables(const std::unordered_set<const SceneGraph::AbstractObject3D*>& animatedObjects, SceneGraph::DrawableGroup3D& group, FlatDrawableList& list) {
+    list.drawableTransformations.clear();
+    list.drawableTransformations.reserve(group.size());
+    list.absoluteTransformations = Containers::Array<Matrix4>{NoInit, group.size()};
+    list.animated = Containers::BitArray{ValueInit, group.size()};
+    for(std::size_t i = 0; i != group.size(); ++i) {
+        list.drawableTransformations.emplace_back(group[i], Matrix4{});
+
+        /* The object is animated if it or any of its parents is. Parents are
+           always Object3D, so the whole chain is checked. */
+        for(const SceneGraph::AbstractObject3D* object = &group[i].object(); object; object = object->parent()) {
+            if(animatedObjects.find(object) != animatedObjects.end()) {
+                list.animated.set(i);
+                break;
+            }
+        }
+
+        if(!list.animated[i])
+            list.absoluteTransformations[i] = group[i].object().absoluteTransformationMatrix();
+    }
+}
+
+void ScenePlayer::drawFlatDrawables(FlatDrawableList& list) {
+    const Matrix4 cameraMatrix = _data->camera->cameraMatrix();
+    for(std::size_t i = 0; i != list.drawableTransformations.size(); ++i) {
+        std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& drawableTransformation = list.drawableTransformations[i];
+        drawableTransformation.second = cameraMatrix*(list.animated[i] ?
+            drawableTransformation.first.get().object().absoluteTransformationMatrix() :
+            list.absoluteTransformations[i]);
+    }
+
+    _data->camera->draw(list.drawableTransformations);
+}
+
+void ScenePlayer::drawOpaque() {
+    for(FlatDrawableList& list: _data->opaqueFlatDrawablesByShader)
+        drawFlatDrawables(list);
+
+    /* Instanced drawables get only collected and then drawn at once */
+    drawFlatDrawables(_data->opaqueFlatDrawables);
+    for(Containers::Pointer<PhongInstanceGroup>& group: _data->phongInstanceGroups)
+        group->draw(*_data->camera);
+}
+
+void ScenePlayer::drawTransparent() {
+    std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>>& drawableTransformations = _data->transparentDrawableTransformations;
+
+    /* Populate the list on first use. Drawables are added only when a scene
+       is loaded, so a size mismatch means the list wasn't populated yet. */
+    if(drawableTransformations.size() != _data->transparentDrawables.size()) {
+        drawableTransformations.clear();
+        drawableTransformations.reserve(_data->transparentDrawables.size());
+        for(std::size_t i = 0; i != _data->transparentDrawables.size(); ++i)
+            drawableTransformations.emplace_back(_data->transparentDrawables[i], Matrix4{});
+    }
+
+    /* Update the transformations in place, keeping the order from the
+       previous frame */
+    const Matrix4 cameraMatrix = _data->camera->cameraMatrix();
+    for(std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& drawableTransformation: drawableTransformations)
+        drawableTransformation.second = cameraMatrix*drawableTransformation.first.get().object().absoluteTransformationMatrix();
+
+    /* Unless the camera moved a lot, the order from the previous frame is
+       nearly sorted already, and an insertion sort is close to linear for
+       such input */
+    for(std::size_t i = 1; i < drawableTransformations.size(); ++i) {
+        const Float depth = drawableTransformations[i].second.translation().z();
+        for(std::size_t j = i; j && drawableTransformations[j - 1].second.translation().z() < depth; --j)
+            Utility::swap(drawableTransformations[j - 1], drawableTransformations[j]);
+    }
+
+    _data->camera->draw(drawableTransformations);
+}
+
+Range2Di ScenePlayer::depthAreaAt(const Vector2& windowPosition) {
     /* First scale the position from being relative to window size to being
        relative to framebuffer size as those two can be different on HiDPI
        systems */
     const Vector2i position = windowPosition*application().framebufferSize()/Vector2{application().windowSize()};
     const Vector2i fbPosition{position.x(), GL::defaultFramebuffer.viewport().sizeY() - position.y() - 1};
-    const Range2Di area = Range2Di::fromSize(fbPosition, Vector2i{1}).padded(Vector2i{2});
+    return Range2Di::fromSize(fbPosition, Vector2i{1}).padded(Vector2i{2});
+}
+
+Float ScenePlayer::depthAt(const Vector2& windowPosition) {
+    /* If there's a depth probe for the same position that's done already,
+       use the most recent one */
+    #ifndef MAGNUM_TARGET_GLES
+    for(std::size_t i = 1; i <= Containers::arraySize(_depthProbes); ++i) {
+        DepthProbe& probe = _depthProbes[(_nextDepthProbe + Containers::arraySize(_depthProbes) - i) % Containers::arraySize(_depthProbes)];
+        if(!probe.fence || probe.windowPosition != windowPosition)
+            continue;
+        const GLenum status = glClientWaitSync(probe.fence, 0, 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            continue;
+
+        const Containers::Array<char> data = probe.image.buffer().data();
+        return Math::min<Float>(Containers::arrayCast<const Float>(data));
+    }
+    #endif
+
+    const Range2Di area = depthAreaAt(windowPosition);
 
-    /* Easy on sane platforms */
+    /* Easy on sane platforms. If there's no usable depth probe, read
+       synchronously. */
     #ifndef MAGNUM_TARGET_WEBGL
     GL::defaultFramebuffer.mapForRead(GL::DefaultFramebuffer::ReadAttachment::Front);
     Image2D image = GL::defaultFramebuffer.read(area, {GL::PixelFormat::DepthComponent, GL::PixelType::Float});
@@ -1821,13 +3378,15 @@ Float ScenePlayer::depthAt(const Vector2& windowPosition) {
        pack the 24 depth bits to a RGBA8 output. It's not possible to just
        glReadPixels() the depth, we need to read a color, moreover Firefox
        doesn't allow us to read anything else than RGBA8 so we can't just use
-       floatBitsToUint() and read R32UI back, we have to pack the values. */
+       floatBitsToUint() and read R32UI back, we have to pack the values. The
+       scissor is set up before the clear so only the small area that's read
+       back gets cleared and reinterpreted, not the whole framebuffer. */
     #else
+    GL::Renderer::enable(GL::Renderer::Feature::ScissorTest);
+    GL::Renderer::setScissor(area);
     _reinterpretFramebuffer.clearColor(0, Vector4{})
         .bind();
     _reinterpretShader.bindDepthTexture(_depthResolve);
-    GL::Renderer::enable(GL::Renderer::Feature::ScissorTest);
-    GL::Renderer::setScissor(area);
     _reinterpretShader.draw(_fullscreenTriangle);
     GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
 
@@ -1844,6 +3403,124 @@ Float ScenePlayer::depthAt(const Vector2& windowPosition) {
     #endif
 }
 
+Range2Di ScenePlayer::drawObjectIdsAt(const Vector2& windowPosition) {
+    /* First scale the position from being relative to window size to being
+       relative to framebuffer size as those two can be different on HiDPI
+       systems */
+    const Vector2i position = windowPosition*application().framebufferSize()/Vector2{application().windowSize()};
+    const Vector2i fbPosition{position.x(), _selectionFramebuffer.viewport().sizeY() - position.y() - 1};
+    const Range2Di area = Range2Di::fromSize(fbPosition, Vector2i{1});
+
+    /* Only the pixel under given position is needed, so limit all
+       rasterization to it. The vertex processing still happens for the whole
+       scene, but the fragment work and the clear is reduced to a single
+       pixel, which makes the readback cheap. */
+    GL::Renderer::enable(GL::Renderer::Feature::ScissorTest);
+    GL::Renderer::setScissor(area);
+
+    _selectionFramebuffer.bind(); /** @todo mapForDraw() should bind implicitly */
+    _selectionFramebuffer.mapForDraw({
+            {Shaders::GenericGL3D::ColorOutput, GL::Framebuffer::DrawAttachment::None},
+            {Shaders::GenericGL3D::ObjectIdOutput, GL::Framebuffer::ColorAttachment{1}}})
+        .clearDepth(1.0f)
+        .clearColor(1, Vector4ui{0xffffffffu});
+    CORRADE_INTERNAL_ASSERT(_selectionFramebuffer.checkStatus(GL::FramebufferTarget::Draw) == GL::Framebuffer::Status::Complete);
+
+    /** @todo reduce duplication in the below code */
+
+    /* Draw opaque stuff as usual */
+    drawOpaque();
+
+    /* Draw transparent stuff back-to-front with blending enabled */
+    if(!_data->transparentDrawables.isEmpty()) {
+        GL::Renderer::setDepthMask(false);
+        GL::Renderer::enable(GL::Renderer::Feature::Blending);
+        /* Ugh non-premultiplied alpha */
+        GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::SourceAlpha, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+
+        drawTransparent();
+
+        GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::Zero);
+        GL::Renderer::disable(GL::Renderer::Feature::Blending);
+        GL::Renderer::setDepthMask(true);
+    }
+
+    /* Draw object visualization w/o a depth buffer */
+    if(_data->visualizeObjects) {
+        GL::Renderer::disable(GL::Renderer::Feature::DepthTest);
+        _data->camera->draw(_data->objectVisualizationDrawables);
+        GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+    }
+
+    GL::Renderer::disable(GL::Renderer::Feature::ScissorTest);
+
+    /* Prepare for reading the ID back */
+    _selectionFramebuffer.mapForRead(GL::Framebuffer::ColorAttachment{1});
+    CORRADE_INTERNAL_ASSERT(_selectionFramebuffer.checkStatus(GL::FramebufferTarget::Read) == GL::Framebuffer::Status::Complete);
+
+    return area;
+}
+
+UnsignedInt ScenePlayer::objectIdAt(const Vector2& windowPosition) {
+    const Range2Di area = drawObjectIdsAt(windowPosition);
+
+    return
+        /* WebGL requires the read format to be RGBA and UNSIGNED_INT.
+           Okay, sure, but it feels extremely silly to do on all other
+           platforms. */
+        #ifndef MAGNUM_TARGET_WEBGL
+        _selectionFramebuffer.read(area, {PixelFormat::R32UI}).pixels<UnsignedInt>()[0][0];
+        #else
+        _selectionFramebuffer.read(area, {PixelFormat::RGBA32UI}).pixels<Vector4ui>()[0][0][0];
+        #endif
+}
+
+#ifndef MAGNUM_TARGET_GLES
+void ScenePlayer::requestSelectionAt(const Vector2& windowPosition) {
+    SelectionProbe& probe = _selectionProbes[_nextSelectionProbe];
+    _nextSelectionProbe = (_nextSelectionProbe + 1) % Containers::arraySize(_selectionProbes);
+    if(probe.fence)
+        glDeleteSync(probe.fence);
+    _selectionFramebuffer.read(drawObjectIdsAt(windowPosition), probe.image, GL::BufferUsage::StreamRead);
+    probe.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void ScenePlayer::resolveSelectionProbes() {
+    /* Use the most recent probe that's done, as any older ones would be
+       overridden by it anyway. If a more recent one is still pending, it'll
+       get picked up in a later frame. */
+    bool pending = false;
+    for(std::size_t i = 1; i <= Containers::arraySize(_selectionProbes); ++i) {
+        SelectionProbe& probe = _selectionProbes[(_nextSelectionProbe + Containers::arraySize(_selectionProbes) - i) % Containers::arraySize(_selectionProbes)];
+        if(!probe.fence)
+            continue;
+        /* Flush so the fence gets eventually signaled even if nothing else
+           was submitted since */
+        const GLenum status = glClientWaitSync(probe.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            pending = true;
+            continue;
+        }
+
+        const Containers::Array<char> data = probe.image.buffer().data();
+        selectObject(Containers::arrayCast<const UnsignedInt>(data)[0]);
+
+        /* Discard this and all older probes */
+        for(std::size_t j = i; j <= Containers::arraySize(_selectionProbes); ++j) {
+            SelectionProbe& older = _selectionProbes[(_nextSelectionProbe + Containers::arraySize(_selectionProbes) - j) % Containers::arraySize(_selectionProbes)];
+            if(older.fence)
+                glDeleteSync(older.fence);
+            older.fence = {};
+        }
+        break;
+    }
+
+    /* Poll again in the next frame */
+    if(pending)
+        redraw();
+}
+#endif
+
 Vector3 ScenePlayer::unproject(const Vector2& windowPosition, Float depth) const {
     /* We have to take window size, not framebuffer size, since the position is
        in window coordinates and the two can be different on HiDPI systems */
@@ -1906,7 +3583,19 @@ void ScenePlayer::keyPressEvent(KeyEvent& event) {
 
     /* Toggle profiling */
     } else if(event.key() == Key::P) {
-        _profiler.isEnabled() ? _profiler.disable() : _profiler.enable();
+        if(_profiler.isEnabled()) {
+            _profiler.disable();
+            _stageProfiler.disable();
+            #ifndef CORRADE_TARGET_EMSCRIPTEN
+            saveProfilerTrace();
+            #endif
+        } else {
+            _profiler.enable();
+            _stageProfiler.enable();
+            #ifndef CORRADE_TARGET_EMSCRIPTEN
+            _traceBegin = std::chrono::steady_clock::now();
+            #endif
+        }
 
     } else return;
 
@@ -1914,166 +3603,127 @@ void ScenePlayer::keyPressEvent(KeyEvent& event) {
     redraw();
 }
 
-void ScenePlayer::pointerPressEvent(PointerEvent& event) {
-    if(!event.isPrimary())
-        return;
-
-    /* RMB to select */
-    /** @todo what should be the touch behavior? some long press? or give up
-        and use LMB? */
-    if(event.pointer() == Pointer::MouseRight && _data) {
-        _selectionFramebuffer.bind(); /** @todo mapForDraw() should bind implicitly */
-        _selectionFramebuffer.mapForDraw({
-                {Shaders::GenericGL3D::ColorOutput, GL::Framebuffer::DrawAttachment::None},
-                {Shaders::GenericGL3D::ObjectIdOutput, GL::Framebuffer::ColorAttachment{1}}})
-            .clearDepth(1.0f)
-            .clearColor(1, Vector4ui{0xffff});
-        CORRADE_INTERNAL_ASSERT(_selectionFramebuffer.checkStatus(GL::FramebufferTarget::Draw) == GL::Framebuffer::Status::Complete);
-
-        /* If there's a selected object already, remove it */
-        if(_data->selectedObject) {
-            delete _data->selectedObject;
-            _data->selectedObject = nullptr;
-        }
-
-        /** @todo reduce duplication in the below code */
-
-        /* Draw opaque stuff as usual */
-        _data->camera->draw(_data->opaqueDrawables);
-
-        /* Draw transparent stuff back-to-front with blending enabled */
-        if(!_data->transparentDrawables.isEmpty()) {
-            GL::Renderer::setDepthMask(false);
-            GL::Renderer::enable(GL::Renderer::Feature::Blending);
-            /* Ugh non-premultiplied alpha */
-            GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::SourceAlpha, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+void ScenePlayer::selectObject(const UnsignedInt selectedId) {
+    /* If there's a selected object already, remove it */
+    if(_data->selectedObject) {
+        delete _data->selectedObject;
+        _data->selectedObject = nullptr;
+    }
 
-            std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>>
-                drawableTransformations = _data->camera->drawableTransformations(_data->transparentDrawables);
-            std::sort(drawableTransformations.begin(), drawableTransformations.end(),
-                [](const std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& a,
-                   const std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& b) {
-                    return a.second.translation().z() > b.second.translation().z();
-                });
-            _data->camera->draw(drawableTransformations);
+    /* Show either global or object-specific widgets */
+    if(selectedId < _data->objects.size()) {
+        _ui.clearNodeFlags(_objectInfo, Ui::NodeFlag::Hidden);
+        _ui.clearNodeFlags(_cycleMeshVisualization, Ui::NodeFlag::Hidden);
+        _ui.addNodeFlags(_modelInfo, Ui::NodeFlag::Hidden);
+        _ui.addNodeFlags(_toggleObjectVisualization, Ui::NodeFlag::Hidden);
+    } else {
+        _ui.addNodeFlags(_objectInfo, Ui::NodeFlag::Hidden);
+        _ui.addNodeFlags(_cycleMeshVisualization, Ui::NodeFlag::Hidden);
+        _ui.clearNodeFlags(_modelInfo, Ui::NodeFlag::Hidden);
+        _ui.clearNodeFlags(_toggleObjectVisualization, Ui::NodeFlag::Hidden);
+    }
 
-            GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::Zero);
-            GL::Renderer::disable(GL::Renderer::Feature::Blending);
-            GL::Renderer::setDepthMask(true);
-        }
+    /* If nothing is selected, the global info is shown */
+    if(selectedId >= _data->objects.size()) {
+        /* 0xffffffff is the background, but anything else is just wrong */
+        if(selectedId != 0xffffffffu)
+            Warning{} << "Selected ID" << selectedId << "out of range for" << _data->objects.size() << "objects, ignoring";
 
-        /* Draw object visualization w/o a depth buffer */
-        if(_data->visualizeObjects) {
-            GL::Renderer::disable(GL::Renderer::Feature::DepthTest);
-            _data->camera->draw(_data->objectVisualizationDrawables);
-            GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
-        }
-
-        /* Read the ID back */
-        _selectionFramebuffer.mapForRead(GL::Framebuffer::ColorAttachment{1});
-        CORRADE_INTERNAL_ASSERT(_selectionFramebuffer.checkStatus(GL::FramebufferTarget::Read) == GL::Framebuffer::Status::Complete);
-
-        /* First scale the position from being relative to window size to being
-           relative to framebuffer size as those two can be different on HiDPI
-           systems */
-        const Vector2i position = event.position()*application().framebufferSize()/Vector2{application().windowSize()};
-        const Vector2i fbPosition{position.x(), _selectionFramebuffer.viewport().sizeY() - position.y() - 1};
-        const Range2Di area = Range2Di::fromSize(fbPosition, Vector2i{1});
-
-        const UnsignedInt selectedId =
-            /* WebGL requires the read format to be RGBA and UNSIGNED_INT.
-               Okay, sure, but it feels extremely silly to do on all other
-               platforms. */
-            #ifndef MAGNUM_TARGET_WEBGL
-            _selectionFramebuffer.read(area, {PixelFormat::R16UI}).pixels<UnsignedShort>()[0][0];
-            #else
-            _selectionFramebuffer.read(area, {PixelFormat::RGBA32UI}).pixels<Vector4ui>()[0][0][0];
+    /* Otherwise add a visualizer and update the info */
+    } else {
+        CORRADE_INTERNAL_ASSERT(!_data->selectedObject);
+        CORRADE_INTERNAL_ASSERT(selectedId < _data->objects.size());
+        CORRADE_INTERNAL_ASSERT(_data->objects[selectedId].object);
+
+        const ObjectInfo& objectInfo = _data->objects[selectedId];
+
+        /* A mesh is selected */
+        Containers::String objectInfoString;
+        if(objectInfo.meshId != 0xffffffffu) {
+            CORRADE_INTERNAL_ASSERT(_data->meshes[objectInfo.meshId].mesh);
+            MeshInfo& meshInfo = _data->meshes[objectInfo.meshId];
+
+            /* Without a geometry shader, the wireframe needs a non-indexed
+               mesh. Create it right when the object gets selected so cycling
+               through the visualizations doesn't need to. */
+            GL::Mesh* wireframeMesh = nullptr;
+            #if defined(MAGNUM_TARGET_WEBGL) || defined(MAGNUM_TARGET_GLES2)
+            if(!meshInfo.wireframeIndices.isEmpty()) {
+                if(!meshInfo.wireframeMesh)
+                    meshInfo.wireframeMesh = compileWireframeMesh(meshInfo);
+                wireframeMesh = &*meshInfo.wireframeMesh;
+            }
             #endif
 
-        /* Show either global or object-specific widgets */
-        if(selectedId < _data->objects.size()) {
-            _ui.clearNodeFlags(_objectInfo, Ui::NodeFlag::Hidden);
-            _ui.clearNodeFlags(_cycleMeshVisualization, Ui::NodeFlag::Hidden);
-            _ui.addNodeFlags(_modelInfo, Ui::NodeFlag::Hidden);
-            _ui.addNodeFlags(_toggleObjectVisualization, Ui::NodeFlag::Hidden);
+            /* Create a visualizer for the selected object */
+            const Shaders::MeshVisualizerGL3D::Flags flags = setupVisualization(objectInfo.meshId);
+            _data->selectedObject = new MeshVisualizerDrawable{
+                *objectInfo.object, meshVisualizerShader(flags|(objectInfo.skinJointMatrices.isEmpty() ? Shaders::MeshVisualizerGL3D::Flags{} : Shaders::MeshVisualizerGL3D::Flag::DynamicPerVertexJointCount)),
+                *meshInfo.mesh, wireframeMesh, objectInfo.meshId,
+                meshInfo.objectIdCount, meshInfo.vertices,
+                #ifndef MAGNUM_TARGET_GLES
+                meshInfo.primitives,
+                #endif
+                objectInfo.skinJointMatrices, meshInfo.perVertexJointCount, meshInfo.secondaryPerVertexJointCount,
+                _shadeless, _data->selectedObjectDrawables};
+
+            /* Show mesh info */
+            objectInfoString = Utility::format(
+                /** @todo wait, what about non-indexed? */
+                "{}: mesh {}, indexed, {} attribs, {} verts, {} prims, {:.1f} kB",
+                objectInfo.name,
+                meshInfo.name,
+                meshInfo.attributes,
+                meshInfo.vertices,
+                meshInfo.primitives,
+                meshInfo.size/1024.0f);
+
+        /* A light is selected */
+        } else if(_data->objects[selectedId].lightId != 0xffffffffu) {
+            CORRADE_INTERNAL_ASSERT(_data->lights[_data->objects[selectedId].lightId].light);
+            LightInfo& lightInfo = _data->lights[_data->objects[selectedId].lightId];
+
+            objectInfoString = Utility::format(
+                "{}: {} {}, range {}, intensity {}",
+                objectInfo.name,
+                lightInfo.type,
+                lightInfo.name,
+                lightInfo.light->range(),
+                lightInfo.light->intensity());
+
+        /* Something else is selected from object visualization, display just
+           generic info */
         } else {
-            _ui.addNodeFlags(_objectInfo, Ui::NodeFlag::Hidden);
-            _ui.addNodeFlags(_cycleMeshVisualization, Ui::NodeFlag::Hidden);
-            _ui.clearNodeFlags(_modelInfo, Ui::NodeFlag::Hidden);
-            _ui.clearNodeFlags(_toggleObjectVisualization, Ui::NodeFlag::Hidden);
+            objectInfoString = Utility::format(
+                "{}: {}, {} children",
+                objectInfo.name,
+                objectInfo.type,
+                objectInfo.childCount);
         }
 
-        /* If nothing is selected, the global info is shown */
-        if(selectedId >= _data->objects.size()) {
-            /* 0xffff is the background, but anything else is just wrong */
-            if(selectedId != 0xffff)
-                Warning{} << "Selected ID" << selectedId << "out of range for" << _data->objects.size() << "objects, ignoring";
+        _objectInfo.setText(objectInfoString,
+            /** @todo ugh, having to specify this every time is NASTY, what
+                to do besides supplying extra style variants? */
+            Text::Alignment::MiddleLeft);
+    }
+}
 
-        /* Otherwise add a visualizer and update the info */
-        } else {
-            CORRADE_INTERNAL_ASSERT(!_data->selectedObject);
-            CORRADE_INTERNAL_ASSERT(selectedId < _data->objects.size());
-            CORRADE_INTERNAL_ASSERT(_data->objects[selectedId].object);
-
-            const ObjectInfo& objectInfo = _data->objects[selectedId];
-
-            /* A mesh is selected */
-            Containers::String objectInfoString;
-            if(objectInfo.meshId != 0xffffffffu) {
-                CORRADE_INTERNAL_ASSERT(_data->meshes[objectInfo.meshId].mesh);
-                MeshInfo& meshInfo = _data->meshes[objectInfo.meshId];
-
-                /* Create a visualizer for the selected object */
-                const Shaders::MeshVisualizerGL3D::Flags flags = setupVisualization(objectInfo.meshId);
-                _data->selectedObject = new MeshVisualizerDrawable{
-                    *objectInfo.object, meshVisualizerShader(flags|(objectInfo.skinJointMatrices.isEmpty() ? Shaders::MeshVisualizerGL3D::Flags{} : Shaders::MeshVisualizerGL3D::Flag::DynamicPerVertexJointCount)),
-                    *meshInfo.mesh, objectInfo.meshId,
-                    meshInfo.objectIdCount, meshInfo.vertices,
-                    #ifndef MAGNUM_TARGET_GLES
-                    meshInfo.primitives,
-                    #endif
-                    objectInfo.skinJointMatrices, meshInfo.perVertexJointCount, meshInfo.secondaryPerVertexJointCount,
-                    _shadeless, _data->selectedObjectDrawables};
-
-                /* Show mesh info */
-                objectInfoString = Utility::format(
-                    /** @todo wait, what about non-indexed? */
-                    "{}: mesh {}, indexed, {} attribs, {} verts, {} prims, {:.1f} kB",
-                    objectInfo.name,
-                    meshInfo.name,
-                    meshInfo.attributes,
-                    meshInfo.vertices,
-                    meshInfo.primitives,
-                    meshInfo.size/1024.0f);
-
-            /* A light is selected */
-            } else if(_data->objects[selectedId].lightId != 0xffffffffu) {
-                CORRADE_INTERNAL_ASSERT(_data->lights[_data->objects[selectedId].lightId].light);
-                LightInfo& lightInfo = _data->lights[_data->objects[selectedId].lightId];
-
-                objectInfoString = Utility::format(
-                    "{}: {} {}, range {}, intensity {}",
-                    objectInfo.name,
-                    lightInfo.type,
-                    lightInfo.name,
-                    lightInfo.light->range(),
-                    lightInfo.light->intensity());
-
-            /* Something else is selected from object visualization, display
-               just generic info */
-            } else {
-                objectInfoString = Utility::format(
-                    "{}: {}, {} children",
-                    objectInfo.name,
-                    objectInfo.type,
-                    objectInfo.childCount);
-            }
+void ScenePlayer::pointerPressEvent(PointerEvent& event) {
+    if(!event.isPrimary())
+        return;
 
-            _objectInfo.setText(objectInfoString,
-                /** @todo ugh, having to specify this every time is NASTY, what
-                    to do besides supplying extra style variants? */
-                Text::Alignment::MiddleLeft);
-        }
+    /* RMB to select */
+    /** @todo what should be the touch behavior? some long press? or give up
+        and use LMB? */
+    if(event.pointer() == Pointer::MouseRight && _data) {
+        /* On desktop GL the selection is resolved in a later drawEvent(),
+           once the GPU is done rendering the object ID, elsewhere it's read
+           back synchronously */
+        #ifndef MAGNUM_TARGET_GLES
+        requestSelectionAt(event.position());
+        #else
+        selectObject(objectIdAt(event.position()));
+        #endif
 
         event.setAccepted();
         redraw();
@@ -2106,6 +3756,25 @@ void ScenePlayer::pointerMoveEvent(PointerMoveEvent& event) {
     const Vector2 delta = event.position() - _lastPosition;
     _lastPosition = event.position();
 
+    /* If no buttons are pressed, show the name of the object under the
+       cursor. Re-rendering the single pixel is cheap enough to be done on
+       every move, the UI gets updated only if the hovered object changes. */
+    if(event.isPrimary() && !event.pointers() && _data) {
+        const UnsignedInt hoveredId = objectIdAt(event.position());
+        const UnsignedInt hoveredObject = hoveredId < _data->objects.size() ? hoveredId : 0xffffffffu;
+        if(hoveredObject != _data->hoveredObject) {
+            _data->hoveredObject = hoveredObject;
+            if(hoveredObject != 0xffffffffu) {
+                _hoveredObjectInfo.setText(_data->objects[hoveredObject].name,
+                    /** @todo ugh, having to specify this every time is NASTY,
+                        what to do besides supplying extra style variants? */
+                    Text::Alignment::MiddleLeft);
+                _ui.clearNodeFlags(_hoveredObjectInfo, Ui::NodeFlag::Hidden);
+            } else _ui.addNodeFlags(_hoveredObjectInfo, Ui::NodeFlag::Hidden);
+            redraw();
+        }
+    }
+
     if(!event.isPrimary() ||
        !(event.pointers() & (Pointer::MouseLeft|Pointer::MouseMiddle|Pointer::Finger)) ||
        !_data)
@@ -2169,8 +3838,8 @@ void ScenePlayer::scrollEvent(ScrollEvent& event) {
 
 }
 
-Containers::Pointer<AbstractPlayer> createScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues) {
-    return Containers::Pointer<ScenePlayer>{InPlaceInit, application, ui, controls, profilerValues};
+Containers::Pointer<AbstractPlayer> createScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues, PluginManager::Manager<Trade::AbstractImporter>& importerManager, const Containers::StringView textureCacheDirectory, const bool optimizeMeshes, const Float animationBakeRate) {
+    return Containers::Pointer<ScenePlayer>{InPlaceInit, application, ui, controls, profilerValues, importerManager, textureCacheDirectory, optimizeMeshes, animationBakeRate};
 }
 
 }}
@@ -0,0 +1,192 @@
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023, 2024, 2025
+#             Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Runs benchmark executables and collects their results into a single JSON
+# file. Executed in script mode by the magnum-ui-benchmarks target, see
+# src/CMakeLists.txt. Inputs:
+#
+#   BENCHMARKS      |-separated list of TestSuite benchmark executables
+#   PLAYER          Optional magnum-player executable, run with --benchmark
+#   PLAYER_FILE     Scene file to load in the player, the player step is
+#                   skipped if empty
+#   PLAYER_FRAMES   Frame count for the player, 1000 if not set
+#   OUTPUT          Output JSON file
+#   GIT_EXECUTABLE  Optional Git executable for the revision
+#   SOURCE_DIR      Source directory to query the revision in
+#   SYSTEM          Target system name
+#   COMPILER        Compiler ID and version
+#   CONFIG          Build configuration
+#
+# The output schema is versioned with the top-level "schema" field, which gets
+# incremented on every incompatible change. Benchmark values are in the units
+# printed by TestSuite, listed in the "unit" field. The "gpu" field is null if
+# no GL benchmark ran successfully.
+
+if(NOT PLAYER_FRAMES)
+    set(PLAYER_FRAMES 1000)
+endif()
+
+# Escapes a string for use in a JSON string literal. Only the characters that
+# can appear in the collected values are handled.
+function(_json_escape out string)
+    string(REPLACE "\\" "\\\\" string "${string}")
+    string(REPLACE "\"" "\\\"" string "${string}")
+    string(REPLACE "\t" "\\t" string "${string}")
+    string(REPLACE "\r" "" string "${string}")
+    string(REPLACE "\n" "\\n" string "${string}")
+    set(${out} "\"${string}\"" PARENT_SCOPE)
+endfunction()
+
+# Extracts GPU and driver information from the context creation message that
+# GL::Context prints to the standard output
+function(_extract_gpu_info out output)
+    if(NOT output MATCHES "Renderer: ([^\n]+) by ([^\n]+)\n")
+        return()
+    endif()
+    _json_escape(renderer "${CMAKE_MATCH_1}")
+    _json_escape(vendor "${CMAKE_MATCH_2}")
+    set(version null)
+    if(output MATCHES "[A-Za-z ]+ version: ([^\n]+)\n")
+        _json_escape(version "${CMAKE_MATCH_1}")
+    endif()
+    set(${out} "{\"renderer\":${renderer},\"vendor\":${vendor},\"version\":${version}}" PARENT_SCOPE)
+endfunction()
+
+set(revision null)
+if(GIT_EXECUTABLE)
+    execute_process(COMMAND ${GIT_EXECUTABLE} describe --always --dirty --abbrev=12
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_QUIET
+        OUTPUT_STRIP_TRAILING_WHITESPACE)
+    if(result EQUAL 0)
+        _json_escape(revision "${output}")
+    endif()
+endif()
+
+set(gpu null)
+set(results )
+set(failed )
+string(REPLACE "|" ";" BENCHMARKS "${BENCHMARKS}")
+foreach(benchmark ${BENCHMARKS})
+    get_filename_component(name ${benchmark} NAME_WE)
+    message(STATUS "Running ${name}")
+    execute_process(COMMAND ${benchmark} --only-benchmarks --color off
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE error)
+    if(NOT result EQUAL 0)
+        message(WARNING "${name} failed:\n${output}${error}")
+        _json_escape(name_json "${name}")
+        list(APPEND failed "${name_json}")
+    endif()
+
+    # Failed benchmarks may still have some usable results, so parse the
+    # output in any case. The lines look like
+    #   BENCH [02]   1.54 ± 0.03   ns name(data)@9x1000 (wall time)
+    string(REPLACE ";" "\\;" output "${output}")
+    string(REPLACE "\n" ";" lines "${output}")
+    foreach(line ${lines})
+        if(NOT line MATCHES "BENCH \\[ *([0-9]+)\\] +([0-9.]+) ± +([0-9.]+) +([^ ]+) +(.+)@([0-9]+)x([0-9]+) \\((.+)\\)$")
+            continue()
+        endif()
+        set(id ${CMAKE_MATCH_1})
+        set(value ${CMAKE_MATCH_2})
+        set(uncertainty ${CMAKE_MATCH_3})
+        _json_escape(unit "${CMAKE_MATCH_4}")
+        _json_escape(test "${CMAKE_MATCH_5}")
+        set(repeats ${CMAKE_MATCH_6})
+        set(iterations ${CMAKE_MATCH_7})
+        _json_escape(type "${CMAKE_MATCH_8}")
+        _json_escape(name_json "${name}")
+        # JSON doesn't allow leading zeros in numbers
+        math(EXPR id "${id}")
+        # Appending to a string and not a list, as test names can contain
+        # semicolons
+        if(results)
+            string(APPEND results ",\n    ")
+        endif()
+        string(APPEND results "{\"suite\":${name_json},\"id\":${id},\"test\":${test},\"type\":${type},\"value\":${value},\"uncertainty\":${uncertainty},\"unit\":${unit},\"repeats\":${repeats},\"iterations\":${iterations}}")
+    endforeach()
+
+    if(gpu STREQUAL "null" AND result EQUAL 0)
+        _extract_gpu_info(gpu_info "${output}")
+        if(gpu_info)
+            set(gpu "${gpu_info}")
+        endif()
+    endif()
+endforeach()
+
+set(player null)
+if(PLAYER AND PLAYER_FILE)
+    message(STATUS "Running magnum-player")
+    execute_process(COMMAND ${PLAYER} --benchmark ${PLAYER_FRAMES} ${PLAYER_FILE}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE error)
+    # The player prints its results as a single JSON line that's embedded
+    # as-is
+    if(result EQUAL 0 AND output MATCHES "(^|\n)({\"frames\":[^\n]+)")
+        set(player "${CMAKE_MATCH_2}")
+        if(gpu STREQUAL "null")
+            _extract_gpu_info(gpu_info "${output}")
+            if(gpu_info)
+                set(gpu "${gpu_info}")
+            endif()
+        endif()
+    else()
+        message(WARNING "magnum-player failed:\n${output}${error}")
+        list(APPEND failed "\"magnum-player\"")
+    endif()
+endif()
+
+string(TIMESTAMP timestamp "%Y-%m-%dT%H:%M:%SZ" UTC)
+_json_escape(system "${SYSTEM}")
+_json_escape(compiler "${COMPILER}")
+_json_escape(config "${CONFIG}")
+string(REPLACE ";" "," failed "${failed}")
+file(WRITE ${OUTPUT} "{
+  \"schema\": 1,
+  \"revision\": ${revision},
+  \"timestamp\": \"${timestamp}\",
+  \"system\": ${system},
+  \"compiler\": ${compiler},
+  \"config\": ${config},
+  \"gpu\": ${gpu},
+  \"benchmarks\": [
+    ${results}
+  ],
+  \"player\": ${player},
+  \"failed\": [${failed}]
+}
+")
+message(STATUS "Benchmark results written to ${OUTPUT}")
+
+list(LENGTH failed failed_count)
+if(failed_count)
+    message(FATAL_ERROR "${failed_count} benchmark executable(s) failed")
+endif()